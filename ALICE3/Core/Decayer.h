@@ -48,6 +48,15 @@ class Decayer
 
   template <typename TDatabase>
   std::vector<o2::upgrade::OTFParticle> decayParticle(const TDatabase& pdgDB, const o2::track::TrackParCov& track, const int pdgCode)
+  {
+    std::vector<o2::upgrade::OTFParticle> decayProducts;
+    decayParticle(pdgDB, track, pdgCode, decayProducts);
+    return decayProducts;
+  }
+
+  // Same as above, the decay products are appended to a buffer owned by the caller, so that no vector is allocated per decay
+  template <typename TDatabase>
+  void decayParticle(const TDatabase& pdgDB, const o2::track::TrackParCov& track, const int pdgCode, std::vector<o2::upgrade::OTFParticle>& decayProducts)
   {
     const auto& particleInfo = pdgDB->GetParticle(pdgCode);
     const int charge = particleInfo->Charge() / 3;
@@ -92,8 +101,10 @@ class Decayer
     }
 
     double brSum = 0.;
-    std::vector<double> dauMasses;
-    std::vector<int> pdgCodesDaughters;
+    std::vector<double>& dauMasses = mDauMasses;
+    std::vector<int>& pdgCodesDaughters = mPdgCodesDaughters;
+    dauMasses.clear();
+    pdgCodesDaughters.clear();
     const double randomChannel = mRand3.Uniform(0., brTotal);
     for (int ch = 0; ch < particleInfo->NDecayChannels(); ++ch) {
       brSum += particleInfo->DecayChannel(ch)->BranchingRatio();
@@ -113,7 +124,6 @@ class Decayer
     decay.SetDecay(tlv, dauMasses.size(), dauMasses.data());
     decay.Generate();
 
-    std::vector<o2::upgrade::OTFParticle> decayProducts;
     for (size_t i = 0; i < dauMasses.size(); ++i) {
       o2::upgrade::OTFParticle particle;
       TLorentzVector dau = *decay.GetDecay(i);
@@ -122,8 +132,6 @@ class Decayer
       particle.setPxPyPzE(dau.Px(), dau.Py(), dau.Pz(), dau.E());
       decayProducts.push_back(particle);
     }
-
-    return decayProducts;
   }
 
   void setSeed(const int seed)
@@ -137,6 +145,8 @@ class Decayer
  private:
   TRandom3 mRand3;
   double mBz;
+  std::vector<double> mDauMasses;      // masses of the daughters of the current decay
+  std::vector<int> mPdgCodesDaughters; // PDG codes of the daughters of the current decay
 };
 
 } // namespace upgrade
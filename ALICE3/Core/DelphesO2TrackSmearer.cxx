@@ -41,8 +41,16 @@
 #include <CommonConstants/PhysicsConstants.h>
 #include <Framework/Logger.h>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cmath>
+#include <cstddef>
 #include <map>
 #include <string>
+#include <vector>
 
 namespace o2
 {
@@ -51,6 +59,59 @@ namespace delphes
 
 /*****************************************************************/
 
+// the entries are accessed in place after the header of the memory-mapped file
+static_assert(sizeof(lutHeader_t) % alignof(lutEntry_t) == 0, "LUT entries following the header are misaligned");
+
+void TrackSmearer::lutAxis_t::set(const map_t& map)
+{
+  nbins = map.nbins;
+  min = map.min;
+  max = map.max;
+  log = map.log;
+  invWidth = nbins / (max - min);
+}
+
+int TrackSmearer::lutAxis_t::find(float val) const
+{
+  const int bin = static_cast<int>(((log ? std::log10(val) : val) - min) * invWidth);
+  if (bin < 0)
+    return 0;
+  if (bin > nbins - 1)
+    return nbins - 1;
+  return bin;
+}
+
+float TrackSmearer::lutAxis_t::fracPositionWithinBin(float val) const
+{
+  if (log) {
+    const float position = (std::log10(val) - min) * invWidth;
+    return position - static_cast<int>(position);
+  }
+  return val * invWidth - static_cast<int>((val - min) * invWidth);
+}
+
+/*****************************************************************/
+
+TrackSmearer::~TrackSmearer()
+{
+  for (unsigned int ipdg = 0; ipdg < nLUTs; ++ipdg) {
+    releaseTable(ipdg);
+  }
+}
+
+void TrackSmearer::releaseTable(int ipdg)
+{
+  auto& table = mLUTEntry[ipdg];
+  if (table.mappedFile) {
+    ::munmap(table.mappedFile, table.mappedSize);
+  }
+  table = lutTable_t{};
+  delete mLUTHeader[ipdg];
+  mLUTHeader[ipdg] = nullptr;
+}
+
+/*****************************************************************/
+
 bool TrackSmearer::loadTable(int pdg, const char* filename, bool forceReload)
 {
   if (!filename || filename[0] == '\0') {
@@ -63,6 +124,7 @@ bool TrackSmearer::loadTable(int pdg, const char* filename, bool forceReload)
     LOG(info) << " --- LUT table for PDG " << pdg << " has been already loaded with index " << ipdg << std::endl;
     return false;
   }
+  releaseTable(ipdg);
 
   const std::string localFilename = o2::fastsim::GeometryEntry::accessFile(filename, "./.ALICE3/LUTs/", mCcdbManager, 10);
   mLUTHeader[ipdg] = new lutHeader_t;
@@ -109,26 +171,44 @@ bool TrackSmearer::loadTable(int pdg, const char* filename, bool forceReload)
   const int nrad = mLUTHeader[ipdg]->radmap.nbins;
   const int neta = mLUTHeader[ipdg]->etamap.nbins;
   const int npt = mLUTHeader[ipdg]->ptmap.nbins;
-  mLUTEntry[ipdg] = new lutEntry_t****[nnch];
-  for (int inch = 0; inch < nnch; ++inch) {
-    mLUTEntry[ipdg][inch] = new lutEntry_t***[nrad];
-    for (int irad = 0; irad < nrad; ++irad) {
-      mLUTEntry[ipdg][inch][irad] = new lutEntry_t**[neta];
-      for (int ieta = 0; ieta < neta; ++ieta) {
-        mLUTEntry[ipdg][inch][irad][ieta] = new lutEntry_t*[npt];
-        for (int ipt = 0; ipt < npt; ++ipt) {
-          mLUTEntry[ipdg][inch][irad][ieta][ipt] = new lutEntry_t;
-          lutFile.read(reinterpret_cast<char*>(mLUTEntry[ipdg][inch][irad][ieta][ipt]), sizeof(lutEntry_t));
-          if (lutFile.gcount() != sizeof(lutEntry_t)) {
-            LOG(info) << " --- troubles reading covariance matrix entry for PDG " << pdg << ": " << localFilename << std::endl;
-            LOG(info) << " --- expected/detected " << sizeof(lutHeader_t) << "/" << lutFile.gcount() << std::endl;
-            return false;
-          }
-        }
+  const std::size_t nEntries = static_cast<std::size_t>(nnch) * nrad * neta * npt;
+  const std::size_t tableSize = sizeof(lutHeader_t) + nEntries * sizeof(lutEntry_t);
+
+  // the entries follow the header in the order [inch][irad][ieta][ipt]: the file is mapped as it is, read-only and shared,
+  // so that the page cache holds a single copy of the table for all the processes using it
+  auto& table = mLUTEntry[ipdg];
+  const int fd = ::open(localFilename.c_str(), O_RDONLY);
+  if (fd >= 0) {
+    struct stat fileStat{};
+    if (::fstat(fd, &fileStat) == 0 && static_cast<std::size_t>(fileStat.st_size) >= tableSize) {
+      void* address = ::mmap(nullptr, tableSize, PROT_READ, MAP_SHARED, fd, 0);
+      if (address != MAP_FAILED) {
+        table.mappedFile = address;
+        table.mappedSize = tableSize;
+        table.entries = reinterpret_cast<const lutEntry_t*>(static_cast<const char*>(address) + sizeof(lutHeader_t));
       }
     }
+    ::close(fd);
+  }
+  if (!table.entries) { // cannot be mapped, read all the entries at once
+    table.buffer.resize(nEntries);
+    lutFile.read(reinterpret_cast<char*>(table.buffer.data()), nEntries * sizeof(lutEntry_t));
+    if (static_cast<std::size_t>(lutFile.gcount()) != nEntries * sizeof(lutEntry_t)) {
+      LOG(info) << " --- troubles reading covariance matrix entries for PDG " << pdg << ": " << localFilename << std::endl;
+      LOG(info) << " --- expected/detected " << nEntries * sizeof(lutEntry_t) << "/" << lutFile.gcount() << std::endl;
+      releaseTable(ipdg);
+      return false;
+    }
+    table.entries = table.buffer.data();
   }
-  LOG(info) << " --- read covariance matrix table for PDG " << pdg << ": " << filename << std::endl;
+  table.strideEta = npt;
+  table.strideRad = table.strideEta * neta;
+  table.strideNch = table.strideRad * nrad;
+  table.nch.set(mLUTHeader[ipdg]->nchmap);
+  table.rad.set(mLUTHeader[ipdg]->radmap);
+  table.eta.set(mLUTHeader[ipdg]->etamap);
+  table.pt.set(mLUTHeader[ipdg]->ptmap);
+  LOG(info) << " --- read covariance matrix table for PDG " << pdg << ": " << filename << (table.mappedFile ? " (memory-mapped)" : "") << std::endl;
   mLUTHeader[ipdg]->print();
 
   lutFile.close();
@@ -137,56 +217,58 @@ bool TrackSmearer::loadTable(int pdg, const char* filename, bool forceReload)
 
 /*****************************************************************/
 
-lutEntry_t* TrackSmearer::getLUTEntry(const int pdg, const float nch, const float radius, const float eta, const float pt, float& interpolatedEff)
+const lutEntry_t* TrackSmearer::getLUTEntry(const int pdg, const float nch, const float radius, const float eta, const float pt, float& interpolatedEff)
 {
   const int ipdg = getIndexPDG(pdg);
   if (!mLUTHeader[ipdg]) {
     return nullptr;
   }
+  const auto& table = mLUTEntry[ipdg];
 
-  auto inch = mLUTHeader[ipdg]->nchmap.find(nch);
-  auto irad = mLUTHeader[ipdg]->radmap.find(radius);
-  auto ieta = mLUTHeader[ipdg]->etamap.find(eta);
-  auto ipt = mLUTHeader[ipdg]->ptmap.find(pt);
+  auto inch = table.nch.find(nch);
+  auto irad = table.rad.find(radius);
+  auto ieta = table.eta.find(eta);
+  auto ipt = table.pt.find(pt);
+  const lutEntry_t* lutEntry = table.at(inch, irad, ieta, ipt);
 
   // Interpolate if requested
-  auto fraction = mLUTHeader[ipdg]->nchmap.fracPositionWithinBin(nch);
+  auto fraction = table.nch.fracPositionWithinBin(nch);
   if (mInterpolateEfficiency) {
     static constexpr float kFractionThreshold = 0.5f;
     if (fraction > kFractionThreshold) {
       switch (mWhatEfficiency) {
         case 1:
-          if (inch < mLUTHeader[ipdg]->nchmap.nbins - 1) {
-            interpolatedEff = (1.5f - fraction) * mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff + (-0.5f + fraction) * mLUTEntry[ipdg][inch + 1][irad][ieta][ipt]->eff;
+          if (inch < table.nch.nbins - 1) {
+            interpolatedEff = (1.5f - fraction) * lutEntry->eff + (-0.5f + fraction) * table.at(inch + 1, irad, ieta, ipt)->eff;
           } else {
-            interpolatedEff = mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff;
+            interpolatedEff = lutEntry->eff;
           }
           break;
         case 2:
-          if (inch < mLUTHeader[ipdg]->nchmap.nbins - 1) {
-            interpolatedEff = (1.5f - fraction) * mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff2 + (-0.5f + fraction) * mLUTEntry[ipdg][inch + 1][irad][ieta][ipt]->eff2;
+          if (inch < table.nch.nbins - 1) {
+            interpolatedEff = (1.5f - fraction) * lutEntry->eff2 + (-0.5f + fraction) * table.at(inch + 1, irad, ieta, ipt)->eff2;
           } else {
-            interpolatedEff = mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff2;
+            interpolatedEff = lutEntry->eff2;
           }
           break;
         default:
           LOG(fatal) << " --- getLUTEntry: unknown efficiency type " << mWhatEfficiency;
       }
     } else {
-      float comparisonValue = mLUTHeader[ipdg]->nchmap.log ? std::log10(nch) : nch;
+      float comparisonValue = table.nch.log ? std::log10(nch) : nch;
       switch (mWhatEfficiency) {
         case 1:
-          if (inch > 0 && comparisonValue < mLUTHeader[ipdg]->nchmap.max) {
-            interpolatedEff = (0.5f + fraction) * mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff + (0.5f - fraction) * mLUTEntry[ipdg][inch - 1][irad][ieta][ipt]->eff;
+          if (inch > 0 && comparisonValue < table.nch.max) {
+            interpolatedEff = (0.5f + fraction) * lutEntry->eff + (0.5f - fraction) * table.at(inch - 1, irad, ieta, ipt)->eff;
           } else {
-            interpolatedEff = mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff;
+            interpolatedEff = lutEntry->eff;
           }
           break;
         case 2:
-          if (inch > 0 && comparisonValue < mLUTHeader[ipdg]->nchmap.max) {
-            interpolatedEff = (0.5f + fraction) * mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff2 + (0.5f - fraction) * mLUTEntry[ipdg][inch - 1][irad][ieta][ipt]->eff2;
+          if (inch > 0 && comparisonValue < table.nch.max) {
+            interpolatedEff = (0.5f + fraction) * lutEntry->eff2 + (0.5f - fraction) * table.at(inch - 1, irad, ieta, ipt)->eff2;
           } else {
-            interpolatedEff = mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff2;
+            interpolatedEff = lutEntry->eff2;
           }
           break;
         default:
@@ -196,21 +278,21 @@ lutEntry_t* TrackSmearer::getLUTEntry(const int pdg, const float nch, const floa
   } else {
     switch (mWhatEfficiency) {
       case 1:
-        interpolatedEff = mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff;
+        interpolatedEff = lutEntry->eff;
         break;
       case 2:
-        interpolatedEff = mLUTEntry[ipdg][inch][irad][ieta][ipt]->eff2;
+        interpolatedEff = lutEntry->eff2;
         break;
       default:
         LOG(fatal) << " --- getLUTEntry: unknown efficiency type " << mWhatEfficiency;
     }
   }
-  return mLUTEntry[ipdg][inch][irad][ieta][ipt];
+  return lutEntry;
 } //;
 
 /*****************************************************************/
 
-bool TrackSmearer::smearTrack(O2Track& o2track, lutEntry_t* lutEntry, float interpolatedEff)
+bool TrackSmearer::smearTrack(O2Track& o2track, const lutEntry_t* lutEntry, float interpolatedEff)
 {
   bool isReconstructed = true;
   // generate efficiency
@@ -274,7 +356,7 @@ bool TrackSmearer::smearTrack(O2Track& o2track, int pdg, float nch)
   }
   auto eta = o2track.getEta();
   float interpolatedEff = 0.0f;
-  lutEntry_t* lutEntry = getLUTEntry(pdg, nch, 0., eta, pt, interpolatedEff);
+  const lutEntry_t* lutEntry = getLUTEntry(pdg, nch, 0., eta, pt, interpolatedEff);
   if (!lutEntry || !lutEntry->valid)
     return false;
   return smearTrack(o2track, lutEntry, interpolatedEff);
@@ -285,7 +367,7 @@ bool TrackSmearer::smearTrack(O2Track& o2track, int pdg, float nch)
 double TrackSmearer::getPtRes(const int pdg, const float nch, const float eta, const float pt)
 {
   float dummy = 0.0f;
-  lutEntry_t* lutEntry = getLUTEntry(pdg, nch, 0., eta, pt, dummy);
+  const lutEntry_t* lutEntry = getLUTEntry(pdg, nch, 0., eta, pt, dummy);
   auto val = std::sqrt(lutEntry->covm[14]) * lutEntry->pt;
   return val;
 }
@@ -295,7 +377,7 @@ double TrackSmearer::getPtRes(const int pdg, const float nch, const float eta, c
 double TrackSmearer::getEtaRes(const int pdg, const float nch, const float eta, const float pt)
 {
   float dummy = 0.0f;
-  lutEntry_t* lutEntry = getLUTEntry(pdg, nch, 0., eta, pt, dummy);
+  const lutEntry_t* lutEntry = getLUTEntry(pdg, nch, 0., eta, pt, dummy);
   auto sigmatgl = std::sqrt(lutEntry->covm[9]);                                  // sigmatgl2
   auto etaRes = std::fabs(std::sin(2.0 * std::atan(std::exp(-eta)))) * sigmatgl; // propagate tgl to eta uncertainty
   etaRes /= lutEntry->eta;                                                       // relative uncertainty
@@ -306,7 +388,7 @@ double TrackSmearer::getEtaRes(const int pdg, const float nch, const float eta,
 double TrackSmearer::getAbsPtRes(const int pdg, const float nch, const float eta, const float pt)
 {
   float dummy = 0.0f;
-  lutEntry_t* lutEntry = getLUTEntry(pdg, nch, 0., eta, pt, dummy);
+  const lutEntry_t* lutEntry = getLUTEntry(pdg, nch, 0., eta, pt, dummy);
   auto val = std::sqrt(lutEntry->covm[14]) * lutEntry->pt * lutEntry->pt;
   return val;
 }
@@ -316,7 +398,7 @@ double TrackSmearer::getAbsPtRes(const int pdg, const float nch, const float eta
 double TrackSmearer::getAbsEtaRes(const int pdg, const float nch, const float eta, const float pt)
 {
   float dummy = 0.0f;
-  lutEntry_t* lutEntry = getLUTEntry(pdg, nch, 0., eta, pt, dummy);
+  const lutEntry_t* lutEntry = getLUTEntry(pdg, nch, 0., eta, pt, dummy);
   auto sigmatgl = std::sqrt(lutEntry->covm[9]);                                  // sigmatgl2
   auto etaRes = std::fabs(std::sin(2.0 * std::atan(std::exp(-eta)))) * sigmatgl; // propagate tgl to eta uncertainty
   return etaRes;
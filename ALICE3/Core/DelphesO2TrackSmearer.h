@@ -29,11 +29,13 @@
 
 #include <TRandom.h>
 
+#include <cstddef>
 #include <cstdio>
 #include <fstream>
 #include <iostream>
 #include <map>
 #include <string>
+#include <vector>
 
 ///////////////////////////////
 /// DelphesO2/src/lutCovm.hh //
@@ -177,9 +179,12 @@ class TrackSmearer
 
  public:
   TrackSmearer() = default;
-  ~TrackSmearer() = default;
+  ~TrackSmearer();
+  TrackSmearer(const TrackSmearer&) = delete;
+  TrackSmearer& operator=(const TrackSmearer&) = delete;
 
   /** LUT methods **/
+  /// The entries of the LUT file are memory-mapped read-only, so that the processes of a node using the same file share one copy of the table
   bool loadTable(int pdg, const char* filename, bool forceReload = false);
   bool hasTable(int pdg) { return (mLUTHeader[getIndexPDG(pdg)] != nullptr); } //;
   void useEfficiency(bool val) { mUseEfficiency = val; }                       //;
@@ -187,9 +192,9 @@ class TrackSmearer
   void skipUnreconstructed(bool val) { mSkipUnreconstructed = val; }           //;
   void setWhatEfficiency(int val) { mWhatEfficiency = val; }                   //;
   lutHeader_t* getLUTHeader(int pdg) { return mLUTHeader[getIndexPDG(pdg)]; }  //;
-  lutEntry_t* getLUTEntry(const int pdg, const float nch, const float radius, const float eta, const float pt, float& interpolatedEff);
+  const lutEntry_t* getLUTEntry(const int pdg, const float nch, const float radius, const float eta, const float pt, float& interpolatedEff);
 
-  bool smearTrack(O2Track& o2track, lutEntry_t* lutEntry, float interpolatedEff);
+  bool smearTrack(O2Track& o2track, const lutEntry_t* lutEntry, float interpolatedEff);
   bool smearTrack(O2Track& o2track, int pdg, float nch);
   // bool smearTrack(Track& track, bool atDCA = true); // Only in DelphesO2
   double getPtRes(const int pdg, const float nch, const float eta, const float pt);
@@ -253,9 +258,39 @@ class TrackSmearer
   void setCcdbManager(o2::ccdb::BasicCCDBManager* mgr) { mCcdbManager = mgr; } //;
 
  protected:
+  /// bin lookup along one of the LUT maps, with the reciprocal of the bin width computed once
+  struct lutAxis_t {
+    int nbins = 1;
+    float min = 0.;
+    float max = 1.e6;
+    float invWidth = 1.e-6;
+    bool log = false;
+    void set(const map_t& map);
+    int find(float val) const;
+    float fracPositionWithinBin(float val) const;
+  };
+
+  /// entries of the LUT of one species, stored in a single block as [inch][irad][ieta][ipt]
+  struct lutTable_t {
+    const lutEntry_t* entries = nullptr;
+    void* mappedFile = nullptr; // start of the memory-mapped LUT file, nullptr if the entries are held in `buffer`
+    std::size_t mappedSize = 0;
+    std::vector<lutEntry_t> buffer; // used if the file cannot be memory-mapped
+    std::size_t strideNch = 0;
+    std::size_t strideRad = 0;
+    std::size_t strideEta = 0;
+    lutAxis_t nch;
+    lutAxis_t rad;
+    lutAxis_t eta;
+    lutAxis_t pt;
+    const lutEntry_t* at(int inch, int irad, int ieta, int ipt) const { return entries + inch * strideNch + irad * strideRad + ieta * strideEta + ipt; }
+  };
+
+  void releaseTable(int ipdg);
+
   static constexpr unsigned int nLUTs = 9; // Number of LUT available
   lutHeader_t* mLUTHeader[nLUTs] = {nullptr};
-  lutEntry_t***** mLUTEntry[nLUTs] = {nullptr};
+  lutTable_t mLUTEntry[nLUTs];
   bool mUseEfficiency = true;
   bool mInterpolateEfficiency = false;
   bool mSkipUnreconstructed = true; // don't smear tracks that are not reco'ed
@@ -22,11 +22,18 @@
 #include <TMatrixDSymEigen.h>
 #include <TObject.h>
 #include <TRandom.h>
+#include <TRandom3.h>
 #include <TSystem.h>
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cmath>
 #include <fstream>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <span>
 #include <string>
 #include <thread>
 #include <vector>
@@ -58,6 +65,7 @@ DetLayer* FastTracker::AddLayer(TString name, float r, float z, float x0, float
   }
   // Add the new layer to the layers vector
   layers.push_back(newLayer);
+  ResetLUT();
   // Return the last added layer
   return &layers.back();
 }
@@ -70,6 +78,7 @@ void FastTracker::addDeadPhiRegionInLayer(const std::string& layerName, float ph
     return;
   }
   layers[layerIdx].addDeadPhiRegion(phiStart, phiEnd);
+  ResetLUT();
 }
 
 int FastTracker::GetLayerIndex(const std::string& name) const
@@ -176,6 +185,7 @@ void FastTracker::AddGenericDetector(o2::fastsim::GeometryEntry configMap, o2::c
         }
         TGraph* g = ccdbManager->getForTimeStamp<TGraph>(ccdbPath, -1);
         addedLayer->setDeadPhiRegions(g);
+        ResetLUT();
       } else {
         // Taking it as local file
         TFile infile(deadPhiRegions.c_str(), "READ");
@@ -186,6 +196,7 @@ void FastTracker::AddGenericDetector(o2::fastsim::GeometryEntry configMap, o2::c
         TGraph* g = reinterpret_cast<TGraph*>(infile.Get(infile.GetListOfKeys()->At(0)->GetName()));
         infile.Close();
         addedLayer->setDeadPhiRegions(g);
+        ResetLUT();
       }
     } else {
       LOG(debug) << " No dead phi regions for layer " << layer;
@@ -291,10 +302,96 @@ float FastTracker::ProbGoodChiSqHit(float radius, float searchRadiusRPhi, float
 int FastTracker::FastTrack(o2::track::TrackParCov inputTrack, o2::track::TrackParCov& outputTrack, const float nch)
 {
   dNdEtaCent = nch; // set the number of charged particles per unit rapidity
-  hits.clear();
-  nIntercepts = 0;
-  nSiliconPoints = 0;
-  nGasPoints = 0;
+  if (mUseLUT && !mLUTInitialized) {
+    initLUT();
+  }
+  hits.resize(layers.size());
+  goodHitProbability.resize(layers.size());
+  TrackContext context;
+  context.hits = hits.data();
+  context.goodHitProbability = goodHitProbability.data();
+  const int status = fastTrack(inputTrack, outputTrack, context, *gRandom);
+  hits.resize(context.nHits);
+  nIntercepts = context.nIntercepts;
+  nSiliconPoints = context.nSiliconPoints;
+  nGasPoints = context.nGasPoints;
+  covMatOK += context.covMatOK;
+  covMatNotOK += context.covMatNotOK;
+  return status;
+}
+
+// batched version of FastTrack: the tracks are split in contiguous chunks, one per thread,
+// and all buffers are allocated once per batch
+void FastTracker::FastTrack(std::span<const o2::track::TrackParCov> inputTracks, std::span<o2::track::TrackParCov> outputTracks, const float nch)
+{
+  if (outputTracks.size() < inputTracks.size()) {
+    LOG(fatal) << "FastTracker: " << outputTracks.size() << " output tracks for a batch of " << inputTracks.size() << " input tracks";
+  }
+  dNdEtaCent = nch; // set the number of charged particles per unit rapidity
+  if (mUseLUT && !mLUTInitialized) {
+    initLUT(); // before the threads, which only fill the nodes
+  }
+  const size_t nTracks = inputTracks.size();
+  const size_t nLayers = layers.size();
+  const int nThreads = std::max(1, std::min<int>(mNThreads, nTracks));
+  while (mBatchRandom.size() < static_cast<size_t>(nThreads)) {
+    mBatchRandom.emplace_back(std::make_unique<TRandom3>(mRandomSeed + static_cast<uint32_t>(mBatchRandom.size())));
+  }
+  mBatchContexts.assign(nTracks, TrackContext{});
+  mBatchStatus.resize(nTracks);
+  mBatchHits.resize(nTracks * nLayers);
+  mBatchGoodHitProbability.resize(nThreads * nLayers);
+
+  auto worker = [&](const int iThread) {
+    const size_t first = nTracks * iThread / nThreads;
+    const size_t last = nTracks * (iThread + 1) / nThreads;
+    for (size_t iTrack = first; iTrack < last; iTrack++) {
+      TrackContext& context = mBatchContexts[iTrack];
+      context.hits = mBatchHits.data() + iTrack * nLayers;
+      context.goodHitProbability = mBatchGoodHitProbability.data() + iThread * nLayers;
+      mBatchStatus[iTrack] = fastTrack(inputTracks[iTrack], outputTracks[iTrack], context, *mBatchRandom[iThread]);
+    }
+  };
+  std::vector<std::thread> threads;
+  threads.reserve(nThreads - 1);
+  for (int iThread = 1; iThread < nThreads; iThread++) {
+    threads.emplace_back(worker, iThread);
+  }
+  worker(0);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (const auto& context : mBatchContexts) {
+    covMatOK += context.covMatOK;
+    covMatNotOK += context.covMatNotOK;
+  }
+}
+
+int FastTracker::fastTrack(o2::track::TrackParCov inputTrack, o2::track::TrackParCov& outputTrack, TrackContext& context, TRandom& random)
+{
+  context.nIntercepts = 0;
+  context.nSiliconPoints = 0;
+  context.nGasPoints = 0;
+  context.nHits = 0;
+
+  std::array<float, o2::track::kCovMatSize> cov;
+  if (!mLUTUsable || !lookUpTrack(inputTrack, outputTrack, cov, context)) {
+    o2::track::TrackParCov inwardTrack;
+    const int status = propagateTrack(inputTrack, outputTrack, inwardTrack, context);
+    // only attempt to continue if intercepts are at least four
+    if (status < 4) {
+      return status;
+    }
+    cov = inwardTrack.getCov();
+  }
+  return smearTrackParameters(outputTrack, cov, context, random);
+}
+
+// propagation through the layers: fills the context and returns the track at the original radius with its final covariance
+// in inwardTrack; returns the number of intercepts or a negative value if the track is lost
+int FastTracker::propagateTrack(o2::track::TrackParCov inputTrack, o2::track::TrackParCov& outputTrack, o2::track::TrackParCov& inwardTrack, TrackContext& context)
+{
   std::array<float, 3> posIni; // provision for != PV
   inputTrack.getXYZGlo(posIni);
   const float initialRadius = std::hypot(posIni[0], posIni[1]);
@@ -318,11 +415,8 @@ int FastTracker::FastTrack(o2::track::TrackParCov inputTrack, o2::track::TrackPa
   // but does not count all points in the tpc as layers which we do here
   // Loop over all the added layers to prevent crash when adding the tpc
   // Should not affect efficiency calculation
-  goodHitProbability.clear();
-  for (size_t i = 0; i < layers.size(); ++i) {
-    goodHitProbability.push_back(-1.);
-  }
-  goodHitProbability[0] = 1.; // we use layer zero to accumulate
+  std::fill_n(context.goodHitProbability, layers.size(), -1.f);
+  context.goodHitProbability[0] = 1.; // we use layer zero to accumulate
 
   // +-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+
   // Outward pass to find intercepts
@@ -389,12 +483,12 @@ int FastTracker::FastTrack(o2::track::TrackParCov inputTrack, o2::track::TrackPa
       firstLayerReached = il;
     }
     lastLayerReached = il;
-    nIntercepts++;
+    context.nIntercepts++;
   }
 
   // +-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+
   // initialize track at outer point
-  o2::track::TrackParCov inwardTrack(inputTrack);
+  inwardTrack = inputTrack;
 
   // Enlarge covariance matrix
   std::array<float, o2::track::kNParams> trPars = {0.};
@@ -434,7 +528,6 @@ int FastTracker::FastTrack(o2::track::TrackParCov inputTrack, o2::track::TrackPa
     // get perfect data point position
     std::array<float, 3> spacePoint;
     inputTrack.getXYZGlo(spacePoint);
-    std::vector<float> thisHit = {spacePoint[0], spacePoint[1], spacePoint[2]};
 
     // towards adding cluster: move to track alpha
     float alpha = inwardTrack.getAlpha();
@@ -475,17 +568,20 @@ int FastTracker::FastTrack(o2::track::TrackParCov inputTrack, o2::track::TrackPa
     }
 
     if (layers[il].isSilicon())
-      nSiliconPoints++; // count silicon hits
+      context.nSiliconPoints++; // count silicon hits
     if (layers[il].isGas())
-      nGasPoints++; // count TPC/gas hits
+      context.nGasPoints++; // count TPC/gas hits
 
-    hits.push_back(thisHit);
+    context.hits[context.nHits++] = spacePoint;
 
     if (!layers[il].isInert()) { // good hit probability calculation
       float sigYCmb = o2::math_utils::sqrt(inwardTrack.getSigmaY2() + layers[il].getResolutionRPhi() * layers[il].getResolutionRPhi());
       float sigZCmb = o2::math_utils::sqrt(inwardTrack.getSigmaZ2() + layers[il].getResolutionZ() * layers[il].getResolutionZ());
-      goodHitProbability[il] = ProbGoodChiSqHit(layers[il].getRadius() * 100, sigYCmb * 100, sigZCmb * 100);
-      goodHitProbability[0] *= goodHitProbability[il];
+      if (context.resolutions != nullptr) {
+        context.resolutions[il] = {sigYCmb, sigZCmb};
+      }
+      context.goodHitProbability[il] = ProbGoodChiSqHit(layers[il].getRadius() * 100, sigYCmb * 100, sigZCmb * 100);
+      context.goodHitProbability[0] *= context.goodHitProbability[il];
     }
   }
 
@@ -501,25 +597,27 @@ int FastTracker::FastTrack(o2::track::TrackParCov inputTrack, o2::track::TrackPa
     return -4; // failed to propagate
   }
 
-  // only attempt to continue if intercepts are at least four
-  if (nIntercepts < 4)
-    return nIntercepts;
+  return context.nIntercepts;
+}
 
+// efficiency and smearing of the output track according to the given covariance matrix
+int FastTracker::smearTrackParameters(o2::track::TrackParCov& outputTrack, const std::array<float, o2::track::kCovMatSize>& cov, TrackContext& context, TRandom& random)
+{
   // generate efficiency
   float eff = 1.;
   for (size_t i = 0; i < layers.size(); i++) {
-    float iGoodHit = goodHitProbability[i];
+    float iGoodHit = context.goodHitProbability[i];
     if (iGoodHit <= 0)
       continue;
 
     eff *= iGoodHit;
   }
   if (mApplyEffCorrection) {
-    if (gRandom->Uniform() > eff)
+    if (random.Uniform() > eff)
       return -8;
   }
 
-  outputTrack.setCov(inwardTrack.getCov());
+  outputTrack.setCov(cov);
   outputTrack.checkCovariance();
 
   // Use covariance matrix based smearing
@@ -565,17 +663,17 @@ int FastTracker::FastTrack(o2::track::TrackParCov inputTrack, o2::track::TrackPa
 
   if (negEigVal && rubenConditional && makePositiveDefinite) {
     if (mVerboseLevel > 0) {
-      LOG(info) << "WARNING: this diagonalization (at pt = " << inputTrack.getPt() << ") has negative eigenvalues despite Ruben's fix! Please be careful!";
+      LOG(info) << "WARNING: this diagonalization (at pt = " << outputTrack.getPt() << ") has negative eigenvalues despite Ruben's fix! Please be careful!";
       LOG(info) << "Printing info:";
-      LOG(info) << "Kalman updates: " << nIntercepts;
+      LOG(info) << "Kalman updates: " << context.nIntercepts;
       LOG(info) << "Cov matrix: ";
       m.Print();
     }
-    covMatNotOK++;
-    nIntercepts = -1; // mark as problematic so that it isn't used
+    context.covMatNotOK++;
+    context.nIntercepts = -1; // mark as problematic so that it isn't used
     return -1;
   }
-  covMatOK++;
+  context.covMatOK++;
 
   // transform parameter vector and smear
   float params_[5];
@@ -584,7 +682,7 @@ int FastTracker::FastTrack(o2::track::TrackParCov inputTrack, o2::track::TrackPa
     for (int j = 0; j < 5; ++j)
       val += eigVec[j][ii] * outputTrack.getParam(j);
     // smear parameters according to eigenvalues
-    params_[ii] = gRandom->Gaus(val, sqrt(eigVal[ii]));
+    params_[ii] = random.Gaus(val, sqrt(eigVal[ii]));
   }
 
   // invert eigenvector matrix
@@ -602,8 +700,166 @@ int FastTracker::FastTrack(o2::track::TrackParCov inputTrack, o2::track::TrackPa
     return -2;
   }
 
-  return nIntercepts;
+  return context.nIntercepts;
+}
+void FastTracker::SetLUTGrid(int nPt, float ptMin, float ptMax, int nEta, float etaMax)
+{
+  if (nPt < 2 || nEta < 2 || ptMin <= 0.f || ptMax <= ptMin || etaMax <= 0.f) {
+    LOG(fatal) << "FastTracker: invalid LUT grid with " << nPt << " nodes in [" << ptMin << ", " << ptMax << "] GeV/c and " << nEta << " nodes in |eta| < " << etaMax;
+  }
+  mLUTNPt = nPt;
+  mLUTPtMin = ptMin;
+  mLUTPtMax = ptMax;
+  mLUTNEta = nEta;
+  mLUTEtaMax = etaMax;
+  ResetLUT();
+}
+
+void FastTracker::ResetLUT()
+{
+  mLUTInitialized = false;
+  mLUTUsable = false;
+  mLUTBlockPointers.reset();
+  mLUTBlocks.clear();
+}
+
+void FastTracker::initLUT()
+{
+  mLUTInitialized = true;
+  for (const auto& layer : layers) {
+    if (layer.getDeadPhiRegions() != nullptr) {
+      LOG(warning) << "FastTracker: layer " << layer.getName() << " has dead phi regions, the LUT is not used for this geometry";
+      return;
+    }
+  }
+  LOG(info) << "FastTracker: LUT with " << mLUTNPt << " nodes in [" << mLUTPtMin << ", " << mLUTPtMax << "] GeV/c and " << mLUTNEta << " nodes in |eta| < " << mLUTEtaMax << ", filled at first use";
+  mLUTBlockPointers = std::make_unique<std::atomic<LUTNode*>[]>(2 * o2::track::PID::NIDs);
+  for (int iBlock = 0; iBlock < 2 * o2::track::PID::NIDs; iBlock++) {
+    mLUTBlockPointers[iBlock].store(nullptr, std::memory_order_relaxed);
+  }
+  mLUTUsable = true;
+}
+
+// node of the LUT for the species and charge of the track, computed at the first request.
+// The nodes are computed under a lock, so that the batch FastTrack can fill the LUT from several threads
+const FastTracker::LUTNode& FastTracker::getLUTNode(const o2::track::TrackParCov& inputTrack, const int iBlock, const int iPt, const int iEta)
+{
+  LUTNode* nodes = mLUTBlockPointers[iBlock].load(std::memory_order_acquire);
+  if (nodes == nullptr) {
+    std::lock_guard<std::mutex> lock(mLUTMutex);
+    nodes = mLUTBlockPointers[iBlock].load(std::memory_order_relaxed);
+    if (nodes == nullptr) {
+      nodes = mLUTBlocks.emplace_back(std::make_unique<LUTNode[]>(mLUTNPt * mLUTNEta)).get();
+      mLUTBlockPointers[iBlock].store(nodes, std::memory_order_release);
+    }
+  }
+  LUTNode& node = nodes[iPt * mLUTNEta + iEta];
+  if (node.ready.load(std::memory_order_acquire)) {
+    return node;
+  }
+
+  std::lock_guard<std::mutex> lock(mLUTMutex);
+  if (!node.ready.load(std::memory_order_relaxed)) {
+    // reference track from the nominal vertex, with the species and charge of the input track
+    const float pt = mLUTPtMin * std::pow(mLUTPtMax / mLUTPtMin, static_cast<float>(iPt) / (mLUTNPt - 1));
+    const float eta = -mLUTEtaMax + 2.f * mLUTEtaMax * iEta / (mLUTNEta - 1);
+    o2::track::TrackParCov refTrack(inputTrack);
+    refTrack.setX(0.f);
+    refTrack.setAlpha(0.f);
+    refTrack.setY(0.f);
+    refTrack.setZ(0.f);
+    refTrack.setSnp(0.f);
+    refTrack.setTgl(std::sinh(eta));
+    refTrack.setQ2Pt((inputTrack.getQ2Pt() > 0.f ? 1.f : -1.f) / pt);
+
+    std::vector<std::array<float, 3>> hitsBuffer(layers.size());
+    std::vector<float> goodHitProbabilityBuffer(layers.size());
+    node.resolutions.assign(layers.size(), {-1.f, -1.f});
+    TrackContext context;
+    context.hits = hitsBuffer.data();
+    context.goodHitProbability = goodHitProbabilityBuffer.data();
+    context.resolutions = node.resolutions.data();
+    o2::track::TrackParCov outputTrack, inwardTrack;
+    node.status = propagateTrack(refTrack, outputTrack, inwardTrack, context);
+    node.nIntercepts = context.nIntercepts;
+    node.nSiliconPoints = context.nSiliconPoints;
+    node.nGasPoints = context.nGasPoints;
+    node.cov = inwardTrack.getCov();
+    node.ready.store(true, std::memory_order_release);
+  }
+  return node;
+}
+
+// interpolation of the LUT for the track; returns false if the track has to be propagated through the layers
+bool FastTracker::lookUpTrack(const o2::track::TrackParCov& inputTrack, o2::track::TrackParCov& outputTrack, std::array<float, o2::track::kCovMatSize>& cov, TrackContext& context)
+{
+  // only tracks from the nominal vertex with alpha = phi, as the ones of the nodes
+  if (std::abs(inputTrack.getSnp()) > kLUTMaxSnp || std::hypot(inputTrack.getX(), inputTrack.getY()) > kLUTMaxRadius || inputTrack.getQ2Pt() == 0.f) {
+    return false;
+  }
+  if (mApplyZacceptance && std::abs(inputTrack.getZ()) > kLUTMaxRadius) {
+    return false;
+  }
+  const float pt = 1.f / std::abs(inputTrack.getQ2Pt());
+  const float eta = inputTrack.getEta();
+  if (pt < mLUTPtMin || pt > mLUTPtMax || std::abs(eta) > mLUTEtaMax) {
+    return false;
+  }
+
+  // bilinear interpolation in log(pt) and eta
+  const float xPt = std::log(pt / mLUTPtMin) / std::log(mLUTPtMax / mLUTPtMin) * (mLUTNPt - 1);
+  const float xEta = (eta + mLUTEtaMax) / (2.f * mLUTEtaMax) * (mLUTNEta - 1);
+  const int iPt = std::min(static_cast<int>(xPt), mLUTNPt - 2);
+  const int iEta = std::min(static_cast<int>(xEta), mLUTNEta - 2);
+  const float fPt = xPt - iPt;
+  const float fEta = xEta - iEta;
+  const int iBlock = 2 * inputTrack.getPID().getID() + (inputTrack.getQ2Pt() > 0.f ? 1 : 0);
+  const std::array<const LUTNode*, 4> nodes = {&getLUTNode(inputTrack, iBlock, iPt, iEta), &getLUTNode(inputTrack, iBlock, iPt + 1, iEta),
+                                               &getLUTNode(inputTrack, iBlock, iPt, iEta + 1), &getLUTNode(inputTrack, iBlock, iPt + 1, iEta + 1)};
+  const std::array<float, 4> weights = {(1.f - fPt) * (1.f - fEta), fPt * (1.f - fEta), (1.f - fPt) * fEta, fPt * fEta};
+
+  // next to the acceptance edges the nodes see different layers: no interpolation
+  const LUTNode& first = *nodes[0];
+  for (const auto* node : nodes) {
+    if (node->status < 4 || node->nIntercepts != first.nIntercepts || node->nSiliconPoints != first.nSiliconPoints || node->nGasPoints != first.nGasPoints) {
+      return false;
+    }
+    for (size_t il = 0; il < layers.size(); il++) {
+      if ((node->resolutions[il][0] < 0.f) != (first.resolutions[il][0] < 0.f)) {
+        return false;
+      }
+    }
+  }
+
+  new (&outputTrack)(o2::track::TrackParCov)(inputTrack);
+  context.nIntercepts = first.nIntercepts;
+  context.nSiliconPoints = first.nSiliconPoints;
+  context.nGasPoints = first.nGasPoints;
+  cov.fill(0.f);
+  for (int in = 0; in < 4; in++) {
+    for (int ic = 0; ic < o2::track::kCovMatSize; ic++) {
+      cov[ic] += weights[in] * nodes[in]->cov[ic];
+    }
+  }
+
+  // good hit probabilities for the current occupancy, in the order of the inward pass
+  std::fill_n(context.goodHitProbability, layers.size(), -1.f);
+  context.goodHitProbability[0] = 1.; // we use layer zero to accumulate
+  for (int il = layers.size() - 1; il >= 0; il--) {
+    if (first.resolutions[il][0] < 0.f) {
+      continue;
+    }
+    float sigYCmb = 0.f, sigZCmb = 0.f;
+    for (int in = 0; in < 4; in++) {
+      sigYCmb += weights[in] * nodes[in]->resolutions[il][0];
+      sigZCmb += weights[in] * nodes[in]->resolutions[il][1];
+    }
+    context.goodHitProbability[il] = ProbGoodChiSqHit(layers[il].getRadius() * 100, sigYCmb * 100, sigZCmb * 100);
+    context.goodHitProbability[0] *= context.goodHitProbability[il];
+  }
+  return true;
 }
+
 // +-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+
 
 } /* namespace fastsim */
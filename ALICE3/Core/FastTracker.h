@@ -20,7 +20,15 @@
 #include <Framework/Logger.h>
 #include <ReconstructionDataFormats/Track.h>
 
+#include <TRandom3.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -55,11 +63,31 @@ class FastTracker
   int GetLayerIndex(const std::string& name) const;
   size_t GetNLayers() const { return layers.size(); }
   bool IsLayerInert(const int layer) const { return layers[layer].isInert(); }
-  void ClearLayers() { layers.clear(); }
-  void SetRadiationLength(const std::string layerName, float x0) { layers[GetLayerIndex(layerName)].setRadiationLength(x0); }
-  void SetRadius(const std::string layerName, float r) { layers[GetLayerIndex(layerName)].setRadius(r); }
-  void SetResolutionRPhi(const std::string layerName, float resRPhi) { layers[GetLayerIndex(layerName)].setResolutionRPhi(resRPhi); }
-  void SetResolutionZ(const std::string layerName, float resZ) { layers[GetLayerIndex(layerName)].setResolutionZ(resZ); }
+  void ClearLayers()
+  {
+    layers.clear();
+    ResetLUT();
+  }
+  void SetRadiationLength(const std::string layerName, float x0)
+  {
+    layers[GetLayerIndex(layerName)].setRadiationLength(x0);
+    ResetLUT();
+  }
+  void SetRadius(const std::string layerName, float r)
+  {
+    layers[GetLayerIndex(layerName)].setRadius(r);
+    ResetLUT();
+  }
+  void SetResolutionRPhi(const std::string layerName, float resRPhi)
+  {
+    layers[GetLayerIndex(layerName)].setResolutionRPhi(resRPhi);
+    ResetLUT();
+  }
+  void SetResolutionZ(const std::string layerName, float resZ)
+  {
+    layers[GetLayerIndex(layerName)].setResolutionZ(resZ);
+    ResetLUT();
+  }
   void SetResolution(const std::string layerName, float resRPhi, float resZ)
   {
     SetResolutionRPhi(layerName, resRPhi);
@@ -94,6 +122,43 @@ class FastTracker
    */
   int FastTrack(o2::track::TrackParCov inputTrack, o2::track::TrackParCov& outputTrack, const float nch);
 
+  /**
+   * @brief Performs fast tracking on a batch of input tracks of the same event.
+   *
+   * Each track is processed as in the single-track FastTrack. The batch is split in
+   * SetNThreads() contiguous chunks, each processed by its own thread with its own random
+   * generator (seeded once from SetRandomSeed() and the thread index), so that the result
+   * is reproducible for a given number of threads but differs from the gRandom sequence.
+   * The status, the point counters and the hits of each track are available via the
+   * GetBatch* getters until the next call.
+   *
+   * @param inputTracks The input track parameters and covariances.
+   * @param outputTracks The output tracks, at least as many as the input ones.
+   * @param nch Charged particle multiplicity (used for hit density calculations).
+   */
+  void FastTrack(std::span<const o2::track::TrackParCov> inputTracks, std::span<o2::track::TrackParCov> outputTracks, const float nch);
+
+  /**
+   * @brief Enables the look-up table (LUT) of the tracking performance.
+   *
+   * The covariance matrix, the point counters and the per-layer resolutions entering the
+   * good-hit probability are computed once per node of a grid in pT, eta, species and charge,
+   * at the first track next to the node, and are interpolated bilinearly in log(pT) and eta.
+   * The efficiency is then evaluated for the dN/deta of the event, so that the LUT does not
+   * depend on the occupancy. Only tracks starting at the nominal vertex with alpha = phi are
+   * looked up. Other tracks, tracks outside the grid or next to the acceptance edges (nodes
+   * with different layers) and all the tracks of a geometry with dead phi regions are propagated
+   * through the layers as usual. Looked-up tracks have no hits.
+   * pT is 1/|q/pT|, i.e. the transverse momentum of unit-charge tracks.
+   */
+  void SetUseLUT(bool b)
+  {
+    mUseLUT = b;
+    ResetLUT();
+  }
+  void SetLUTGrid(int nPt, float ptMin, float ptMax, int nEta, float etaMax);
+  void ResetLUT(); /// to be called if layers are modified via the pointer returned by AddLayer, not during a batch FastTrack
+
   // For efficiency calculation
   float Dist(float z, float radius);
   float OneEventHitDensity(float multiplicity, float radius);
@@ -108,13 +173,39 @@ class FastTracker
   void SetAvgRapidity(float y) { avgRapidity = y; }
   void SetdNdEtaCent(int d) { dNdEtaCent = d; }
   void SetLhcUPCscale(float s) { lhcUPCScale = s; }
-  void SetBField(float b) { magneticField = b; }
-  void SetMinRadTrack(float r) { fMinRadTrack = r; }
-  void SetMagneticField(float b) { magneticField = b; }
-  void SetApplyZacceptance(bool b) { mApplyZacceptance = b; }
-  void SetApplyMSCorrection(bool b) { mApplyMSCorrection = b; }
-  void SetApplyElossCorrection(bool b) { mApplyElossCorrection = b; }
+  void SetBField(float b) { SetMagneticField(b); }
+  void SetMinRadTrack(float r)
+  {
+    fMinRadTrack = r;
+    ResetLUT();
+  }
+  void SetMagneticField(float b)
+  {
+    magneticField = b;
+    ResetLUT();
+  }
+  void SetApplyZacceptance(bool b)
+  {
+    mApplyZacceptance = b;
+    ResetLUT();
+  }
+  void SetApplyMSCorrection(bool b)
+  {
+    mApplyMSCorrection = b;
+    ResetLUT();
+  }
+  void SetApplyElossCorrection(bool b)
+  {
+    mApplyElossCorrection = b;
+    ResetLUT();
+  }
   void SetApplyEffCorrection(bool b) { mApplyEffCorrection = b; }
+  void SetNThreads(int n) { mNThreads = n > 0 ? n : 1; }
+  void SetRandomSeed(uint32_t seed)
+  {
+    mRandomSeed = seed;
+    mBatchRandom.clear(); // regenerated with the new seed at the next batch
+  }
 
   // Getters for the last track
   int GetNIntercepts() const { return nIntercepts; }
@@ -131,10 +222,54 @@ class FastTracker
   uint64_t GetCovMatOK() const { return covMatOK; }
   uint64_t GetCovMatNotOK() const { return covMatNotOK; }
 
+  // Getters for the tracks of the last batch
+  int GetBatchStatus(const size_t iTrack) const { return mBatchStatus[iTrack]; }
+  int GetBatchNSiliconPoints(const size_t iTrack) const { return mBatchContexts[iTrack].nSiliconPoints; }
+  int GetBatchNGasPoints(const size_t iTrack) const { return mBatchContexts[iTrack].nGasPoints; }
+  int GetBatchNHits(const size_t iTrack) const { return mBatchContexts[iTrack].nHits; }
+  float GetBatchHitX(const size_t iTrack, const int i) const { return mBatchContexts[iTrack].hits[i][0]; }
+  float GetBatchHitY(const size_t iTrack, const int i) const { return mBatchContexts[iTrack].hits[i][1]; }
+  float GetBatchHitZ(const size_t iTrack, const int i) const { return mBatchContexts[iTrack].hits[i][2]; }
+
  private:
   // Definition of detector layers
   std::vector<DetLayer> layers;
-  std::vector<std::vector<float>> hits; // bookkeep last added hits
+  std::vector<std::array<float, 3>> hits; // bookkeep last added hits
+
+  /// bookkeeping of the track being processed, filled by fastTrack
+  struct TrackContext {
+    int nIntercepts = 0;
+    int nSiliconPoints = 0;
+    int nGasPoints = 0;
+    int nHits = 0;
+    std::array<float, 3>* hits = nullptr;        // room for one hit per layer
+    float* goodHitProbability = nullptr;         // one entry per layer
+    std::array<float, 2>* resolutions = nullptr; // if set, combined rphi and z resolutions of the layers with good-hit probability
+    uint64_t covMatOK = 0;
+    uint64_t covMatNotOK = 0;
+  };
+
+  /// fast tracking of one track, only modifies the context, the output track, the random generator and the nodes of the LUT
+  int fastTrack(o2::track::TrackParCov inputTrack, o2::track::TrackParCov& outputTrack, TrackContext& context, TRandom& random);
+  int propagateTrack(o2::track::TrackParCov inputTrack, o2::track::TrackParCov& outputTrack, o2::track::TrackParCov& inwardTrack, TrackContext& context);
+  int smearTrackParameters(o2::track::TrackParCov& outputTrack, const std::array<float, o2::track::kCovMatSize>& cov, TrackContext& context, TRandom& random);
+
+  /// node of the LUT, i.e. the result of the propagation of a reference track
+  struct LUTNode {
+    std::atomic<bool> ready{false};
+    int status = 0;
+    int nIntercepts = 0;
+    int nSiliconPoints = 0;
+    int nGasPoints = 0;
+    std::array<float, o2::track::kCovMatSize> cov{};
+    std::vector<std::array<float, 2>> resolutions; // per layer, negative for layers without good-hit probability
+  };
+  static constexpr float kLUTMaxRadius = 0.01f; /// maximum distance (cm) of a looked-up track from the nominal vertex
+  static constexpr float kLUTMaxSnp = 1.e-4f;   /// maximum snp of a looked-up track
+
+  void initLUT();
+  const LUTNode& getLUTNode(const o2::track::TrackParCov& inputTrack, const int iBlock, const int iPt, const int iEta);
+  bool lookUpTrack(const o2::track::TrackParCov& inputTrack, o2::track::TrackParCov& outputTrack, std::array<float, o2::track::kCovMatSize>& cov, TrackContext& context);
 
   /// configuration parameters
   bool mApplyZacceptance = false;       /// check z acceptance or not
@@ -167,7 +302,29 @@ class FastTracker
   int nGasPoints = 0;     /// tpc-based space points added to track
   std::vector<float> goodHitProbability;
 
-  ClassDef(FastTracker, 1);
+  /// batch processing
+  int mNThreads = 1;                                   /// number of threads of the batch FastTrack
+  uint32_t mRandomSeed = 12345;                        /// seed of the random generators of the batch FastTrack
+  std::vector<std::unique_ptr<TRandom3>> mBatchRandom; //! one generator per thread
+  std::vector<TrackContext> mBatchContexts;            //! one context per track of the last batch
+  std::vector<int> mBatchStatus;                       //! one status per track of the last batch
+  std::vector<std::array<float, 3>> mBatchHits;        //! hits of the last batch, one slot per track and layer
+  std::vector<float> mBatchGoodHitProbability;         //! scratch of the good hit probabilities, one set per thread
+
+  /// look-up table
+  bool mUseLUT = false;                                       /// use the LUT or not
+  int mLUTNPt = 100;                                          /// number of LUT nodes in pT (log spaced)
+  float mLUTPtMin = 0.05f;                                    /// minimum pT of the LUT
+  float mLUTPtMax = 50.f;                                     /// maximum pT of the LUT
+  int mLUTNEta = 81;                                          /// number of LUT nodes in eta
+  float mLUTEtaMax = 4.f;                                     /// maximum |eta| of the LUT
+  bool mLUTInitialized = false;                               //! LUT checked against the geometry
+  bool mLUTUsable = false;                                    //! LUT enabled and supported by the geometry
+  std::unique_ptr<std::atomic<LUTNode*>[]> mLUTBlockPointers; //! nodes of each species and charge, allocated at first use
+  std::vector<std::unique_ptr<LUTNode[]>> mLUTBlocks;         //! owner of the nodes
+  std::mutex mLUTMutex;                                       //! computation of the nodes
+
+  ClassDef(FastTracker, 3);
 };
 
 // +-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+
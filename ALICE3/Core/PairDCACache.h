@@ -0,0 +1,95 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   PairDCACache.h
+/// \brief  Cache of the distance of closest approach of track pairs, used by the ALICE 3 decay finders
+///         to preselect the combinations before the full multi-prong vertex fit
+///
+
+#ifndef ALICE3_CORE_PAIRDCACACHE_H_
+#define ALICE3_CORE_PAIRDCACACHE_H_
+
+#include "ReconstructionDataFormats/Track.h"
+
+#include <cmath>
+#include <vector>
+
+namespace o2
+{
+namespace upgrade
+{
+
+/// DCA between the tracks of two lists (rows and columns, possibly the same list), computed at the first request and
+/// reused by all the combinations containing the pair, e.g. by all the Xi candidates of a collision for a pair of pions.
+/// With an unweighted (absolute DCA) fit, the DCA of any pair of prongs is not larger than the DCA of the N-prong
+/// candidate containing them, so that a cut on the pairs at the N-prong DCA cut does not remove any candidate.
+class PairDCACache
+{
+ public:
+  static constexpr float NotComputed = -1.f;
+  static constexpr float FitFailed = -2.f;
+
+  /// Clears the cache for nRows x nColumns pairs, the memory is kept
+  void reset(int nRows, int nColumns)
+  {
+    mNColumns = nColumns;
+    mValues.assign(static_cast<size_t>(nRows) * nColumns, NotComputed);
+  }
+
+  /// DCA of the pair (row, column), FitFailed if the fit did not converge
+  /// \param fit callable returning the DCA of the pair, called only at the first request
+  template <typename TFit>
+  float get(int row, int column, TFit fit)
+  {
+    float& value = mValues[static_cast<size_t>(row) * mNColumns + column];
+    if (value == NotComputed) {
+      value = fit();
+    }
+    return value;
+  }
+
+  /// Returns false only if the fit of the pair converged with a DCA above maxDCA, a negative maxDCA disables the check
+  template <typename TFit>
+  bool isCompatible(int row, int column, float maxDCA, TFit fit)
+  {
+    if (maxDCA < 0.f) {
+      return true;
+    }
+    const float dca = get(row, column, fit);
+    return dca == FitFailed || dca <= maxDCA;
+  }
+
+ private:
+  int mNColumns = 0;
+  std::vector<float> mValues; // DCA of each pair, row-major
+};
+
+/// DCA of a track pair from a two-prong DCA fitter, FitFailed if no candidate is found
+template <typename TFitter>
+float fitPairDCA(TFitter& fitter, o2::track::TrackParCov const& track0, o2::track::TrackParCov const& track1)
+{
+  int nCand = 0;
+  try {
+    nCand = fitter.process(track0, track1);
+  } catch (...) {
+    return PairDCACache::FitFailed;
+  }
+  if (nCand == 0) {
+    return PairDCACache::FitFailed;
+  }
+  return std::sqrt(fitter.getChi2AtPCACandidate());
+}
+
+} // namespace upgrade
+} // namespace o2
+
+#endif // ALICE3_CORE_PAIRDCACACHE_H_
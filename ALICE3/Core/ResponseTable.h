@@ -0,0 +1,105 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file ResponseTable.h
+/// \brief Lookup table of detector response values on a (p, eta) grid with bilinear interpolation,
+///        used by the on-the-fly PID tasks to replace the per-track analytic response of a mass hypothesis
+
+#ifndef ALICE3_CORE_RESPONSETABLE_H_
+#define ALICE3_CORE_RESPONSETABLE_H_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace o2::fastsim
+{
+
+/// NValues response values per node of a regular grid in log(p) and eta, for one detector configuration and one mass hypothesis.
+/// The table is filled once from the analytic response and interpolated bilinearly afterwards.
+/// Nodes where the response is not defined (e.g. below the Cherenkov threshold) hold NaN: the points of the cells touching them,
+/// as well as the points outside the grid, are not interpolated and the caller falls back to the analytic response.
+template <int NValues>
+class ResponseTable
+{
+ public:
+  using Values = std::array<float, NValues>;
+
+  /// \param nP number of nodes in log(p) between pMin and pMax (GeV/c)
+  /// \param nEta number of nodes in eta between -etaMax and etaMax
+  void setGrid(int nP, float pMin, float pMax, int nEta, float etaMax)
+  {
+    mNP = nP;
+    mNEta = nEta;
+    mLogPMin = std::log(pMin);
+    mInvStepLogP = (nP - 1) / (std::log(pMax) - mLogPMin);
+    mEtaMin = -etaMax;
+    mInvStepEta = (nEta - 1) / (2.f * etaMax);
+    mNodes.clear();
+  }
+
+  /// Fills all the nodes with response(p, eta), a callable returning the Values at the given momentum and pseudorapidity
+  template <typename TResponse>
+  void fill(TResponse response)
+  {
+    mNodes.resize(mNP * mNEta);
+    for (int iP = 0; iP < mNP; ++iP) {
+      const float p = std::exp(mLogPMin + iP / mInvStepLogP);
+      for (int iEta = 0; iEta < mNEta; ++iEta) {
+        mNodes[iP * mNEta + iEta] = response(p, mEtaMin + iEta / mInvStepEta);
+      }
+    }
+  }
+
+  bool isFilled() const { return !mNodes.empty(); }
+
+  /// Interpolates the values at (p, eta), returns false if the point is outside the grid or next to an undefined node
+  bool interpolate(float p, float eta, Values& values) const
+  {
+    if (p <= 0.f) {
+      return false;
+    }
+    const float u = (std::log(p) - mLogPMin) * mInvStepLogP;
+    const float v = (eta - mEtaMin) * mInvStepEta;
+    if (!(u >= 0.f && u <= mNP - 1) || !(v >= 0.f && v <= mNEta - 1)) {
+      return false;
+    }
+    const int iP = std::min(static_cast<int>(u), mNP - 2);
+    const int iEta = std::min(static_cast<int>(v), mNEta - 2);
+    const float fP = u - iP;
+    const float fEta = v - iEta;
+    const Values& n00 = mNodes[iP * mNEta + iEta];
+    const Values& n01 = mNodes[iP * mNEta + iEta + 1];
+    const Values& n10 = mNodes[(iP + 1) * mNEta + iEta];
+    const Values& n11 = mNodes[(iP + 1) * mNEta + iEta + 1];
+    for (int i = 0; i < NValues; ++i) {
+      values[i] = (1.f - fP) * ((1.f - fEta) * n00[i] + fEta * n01[i]) + fP * ((1.f - fEta) * n10[i] + fEta * n11[i]);
+      if (!std::isfinite(values[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+ private:
+  int mNP = 0;
+  int mNEta = 0;
+  float mLogPMin = 0.f;
+  float mInvStepLogP = 0.f;
+  float mEtaMin = 0.f;
+  float mInvStepEta = 0.f;
+  std::vector<Values> mNodes; // node values, p-major
+};
+
+} // namespace o2::fastsim
+
+#endif // ALICE3_CORE_RESPONSETABLE_H_
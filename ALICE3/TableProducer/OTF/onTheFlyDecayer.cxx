@@ -173,6 +173,7 @@ struct OnTheFlyDecayer {
   }
 
   std::vector<McParticleAlice3> mcParticlesAlice3;
+  std::vector<o2::upgrade::OTFParticle> decayStack; // particles still to be decayed, reused across particles
   void process(aod::McCollision const&, aod::McParticles const& mcParticles)
   {
     mDecayDaughters.clear();
@@ -180,11 +181,12 @@ struct OnTheFlyDecayer {
     u_int64_t nStoredDaughters = 0;
     for (int index{0}; index < static_cast<int>(mcParticles.size()); ++index) {
       const auto& particle = mcParticles.rawIteratorAt(index);
-      std::vector<o2::upgrade::OTFParticle> decayDaughters, decayStack;
+      std::vector<o2::upgrade::OTFParticle> decayDaughters;
+      decayStack.clear();
       if (canDecay(particle.pdgCode()) && std::abs(particle.eta()) < maxEta) {
         o2::track::TrackParCov o2track;
         o2::upgrade::convertMCParticleToO2Track(particle, o2track, pdgDB);
-        decayStack = decayer.decayParticle(pdgDB, o2track, particle.pdgCode());
+        decayer.decayParticle(pdgDB, o2track, particle.pdgCode(), decayStack);
         while (!decayStack.empty()) {
           o2::upgrade::OTFParticle otfParticle = decayStack.back();
           decayStack.pop_back();
@@ -199,10 +201,7 @@ struct OnTheFlyDecayer {
 
           o2::track::TrackParCov dauTrack;
           o2::upgrade::convertOTFParticleToO2Track(otfParticle, dauTrack, pdgDB);
-          std::vector<o2::upgrade::OTFParticle> daughters = decayer.decayParticle(pdgDB, dauTrack, otfParticle.pdgCode());
-          for (o2::upgrade::OTFParticle dau : daughters) {
-            decayStack.push_back(dau);
-          }
+          decayer.decayParticle(pdgDB, dauTrack, otfParticle.pdgCode(), decayStack);
         }
 
         if (decayDaughters.empty()) {
@@ -32,6 +32,7 @@
 
 #include "ALICE3/Core/DelphesO2TrackSmearer.h"
 #include "ALICE3/Core/FastTracker.h"
+#include "ALICE3/Core/ResponseTable.h"
 #include "ALICE3/Core/TrackUtilities.h"
 #include "ALICE3/DataModel/OTFCollision.h"
 #include "ALICE3/DataModel/OTFRICH.h"
@@ -64,6 +65,8 @@
 #include <TString.h>
 #include <TVector3.h>
 
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <map>
 #include <string>
@@ -129,6 +132,12 @@ struct OnTheFlyRichPid {
   Configurable<float> bRichRefractiveIndexSector20{"bRichRefractiveIndexSector20", 1.03, "barrel RICH refractive index central(s)-20 and central(s)+20"}; // central(s)-20 and central(s)+20
   Configurable<float> bRICHPixelSize{"bRICHPixelSize", 0.1, "barrel RICH pixel size (cm)"};
   Configurable<float> bRichGapRefractiveIndex{"bRichGapRefractiveIndex", 1.000283, "barrel RICH gap refractive index"};
+  Configurable<bool> useResponseTables{"useResponseTables", false, "use the (p, eta) tables for the track angular resolution"};
+  Configurable<int> responseTableNodesP{"responseTableNodesP", 400, "number of nodes in log(p) of the response tables"};
+  Configurable<float> responseTableMinP{"responseTableMinP", 0.02f, "lower momentum limit of the response tables (GeV/c)"};
+  Configurable<float> responseTableMaxP{"responseTableMaxP", 100.f, "upper momentum limit of the response tables (GeV/c)"};
+  Configurable<int> responseTableNodesEta{"responseTableNodesEta", 200, "number of nodes in eta of the response tables"};
+  Configurable<float> responseTableMaxEta{"responseTableMaxEta", 4.f, "eta limit of the response tables"};
 
   o2::base::Propagator::MatCorrType matCorr = o2::base::Propagator::MatCorrType::USEMatCorrNONE;
 
@@ -144,6 +153,14 @@ struct OnTheFlyRichPid {
   /// Flag unphysical and unavailable values (must be negative)
   static constexpr float kErrorValue = -1000;
 
+  static constexpr int kNspecies = 9;
+
+  // |dtheta/dpt| and |dtheta/deta| per radiator refractive index and mass hypothesis, filled at the first use.
+  // The sectors with the same aerogel share the tables
+  std::vector<std::array<o2::fastsim::ResponseTable<2>, kNspecies>> mTrackAngularTables;
+  std::vector<float> mTrackAngularTableRindex; // refractive index of each set of tables
+  std::vector<int> sectorTrackAngularTable;    // set of tables of each sector
+
   // Variables projective/hybrid layout
   std::vector<TVector3> detCenters;
   std::vector<TVector3> radCenters;
@@ -283,6 +300,27 @@ struct OnTheFlyRichPid {
     // std::cout << std::endl << std::endl;
   }
 
+  // Assign the response tables of the track angular resolution to the sectors, one set per distinct refractive index
+  void updateResponseTables()
+  {
+    mTrackAngularTables.clear();
+    mTrackAngularTableRindex.clear();
+    sectorTrackAngularTable.assign(aerogelRindex.size(), -1);
+    for (size_t iSector = 0; iSector < aerogelRindex.size(); iSector++) {
+      const auto known = std::find(mTrackAngularTableRindex.begin(), mTrackAngularTableRindex.end(), aerogelRindex[iSector]);
+      if (known != mTrackAngularTableRindex.end()) {
+        sectorTrackAngularTable[iSector] = known - mTrackAngularTableRindex.begin();
+        continue;
+      }
+      sectorTrackAngularTable[iSector] = mTrackAngularTableRindex.size();
+      mTrackAngularTableRindex.push_back(aerogelRindex[iSector]);
+      auto& tables = mTrackAngularTables.emplace_back();
+      for (auto& table : tables) {
+        table.setGrid(responseTableNodesP, responseTableMinP, responseTableMaxP, responseTableNodesEta, responseTableMaxEta);
+      }
+    }
+  }
+
   // Configuration defined at init time
   o2::fastsim::GeometryContainer mGeoContainer;
   float mMagneticField = 0.0f;
@@ -428,6 +466,7 @@ struct OnTheFlyRichPid {
 
     // Update projective parameters
     updateProjectiveParameters();
+    updateResponseTables();
   }
 
   /// check if particle reaches radiator
@@ -701,6 +740,13 @@ struct OnTheFlyRichPid {
   /// \param mass the mass of the particle
   /// \param refractiveIndex the refractive index of the radiator
   double calculateTrackAngularResolutionAdvanced(const float pt, const float eta, const float trackPtResolution, const float trackEtaResolution, const float mass, const float refractiveIndex)
+  {
+    const auto derivatives = calculateTrackAngularDerivatives(pt, eta, mass, refractiveIndex);
+    return std::hypot(derivatives[0] * trackPtResolution, derivatives[1] * trackEtaResolution);
+  }
+
+  /// returns |dtheta/dpt| and |dtheta/deta|, the parameters are the ones of calculateTrackAngularResolutionAdvanced
+  std::array<float, 2> calculateTrackAngularDerivatives(const float pt, const float eta, const float mass, const float refractiveIndex)
   {
     // Compute tracking contribution to timing using the error propagation formula
     // Uses light speed in m/ps, magnetic field in T (*0.1 for conversion kGauss -> T)
@@ -711,8 +757,27 @@ struct OnTheFlyRichPid {
     const float ptCoshEtaSquared = ptCoshEta * ptCoshEta;
     const double dThetaOndPt = a0 / (pt * std::sqrt(a0 + ptCoshEtaSquared) * std::sqrt(ptCoshEtaSquared * (a1Squared - 1.0) - a0));
     const double dThetaOndEta = (a0 * std::tanh(eta)) / (std::sqrt(a0 + ptCoshEtaSquared) * std::sqrt(ptCoshEtaSquared * (a1Squared - 1.0) - a0));
-    const double trackAngularResolution = std::hypot(std::fabs(dThetaOndPt) * trackPtResolution, std::fabs(dThetaOndEta) * trackEtaResolution);
-    return trackAngularResolution;
+    return {static_cast<float>(std::fabs(dThetaOndPt)), static_cast<float>(std::fabs(dThetaOndEta))};
+  }
+
+  /// returns the track angular resolution of the mass hypothesis iSpecies in the sector iSector,
+  /// interpolated in the response table if enabled and computed analytically otherwise or outside the table
+  /// \param momentum the momentum of the track
+  double trackAngularResolution(const int iSector, const int iSpecies, const float momentum, const float eta, const float trackPtResolution, const float trackEtaResolution, const float mass)
+  {
+    if (useResponseTables) {
+      const int iTable = sectorTrackAngularTable[iSector];
+      auto& table = mTrackAngularTables[iTable][iSpecies];
+      if (!table.isFilled()) {
+        const float refractiveIndex = mTrackAngularTableRindex[iTable];
+        table.fill([&](float p, float tableEta) { return calculateTrackAngularDerivatives(p / std::cosh(tableEta), tableEta, mass, refractiveIndex); });
+      }
+      std::array<float, 2> derivatives;
+      if (table.interpolate(momentum, eta, derivatives)) {
+        return std::hypot(derivatives[0] * trackPtResolution, derivatives[1] * trackEtaResolution);
+      }
+    }
+    return calculateTrackAngularResolutionAdvanced(momentum / std::cosh(eta), eta, trackPtResolution, trackEtaResolution, mass, aerogelRindex[iSector]);
   }
 
   void process(soa::Join<aod::Collisions, aod::McCollisionLabels, aod::OTFLUTConfigId>::iterator const& collision,
@@ -822,7 +887,6 @@ struct OnTheFlyRichPid {
       }
 
       // Straight to Nsigma
-      static constexpr int kNspecies = 9;
       static constexpr int kEl = 0;
       static constexpr int kMu = 1;
       static constexpr int kPi = 2;
@@ -873,7 +937,7 @@ struct OnTheFlyRichPid {
             }
           }
           // cout << endl <<  "Pt resolution: " << ptResolution << ", Eta resolution: " << etaResolution << endl << endl;
-          const float barrelTrackAngularReso = calculateTrackAngularResolutionAdvanced(recoTrack.getP() / std::cosh(recoTrack.getEta()), recoTrack.getEta(), ptResolution, etaResolution, kParticleMasses[ii], aerogelRindex[iSecor]);
+          const float barrelTrackAngularReso = trackAngularResolution(iSecor, ii, recoTrack.getP(), recoTrack.getEta(), ptResolution, etaResolution, kParticleMasses[ii]);
           barrelTotalAngularReso = std::hypot(barrelRICHAngularResolution, barrelTrackAngularReso);
           if (doQAplots &&
               hypothesisAngleBarrelRich > kErrorValue + 1. &&
@@ -26,6 +26,7 @@
 
 #include "ALICE3/Core/DelphesO2TrackSmearer.h"
 #include "ALICE3/Core/FastTracker.h"
+#include "ALICE3/Core/ResponseTable.h"
 #include "ALICE3/Core/TrackUtilities.h"
 #include "ALICE3/DataModel/OTFCollision.h"
 #include "ALICE3/DataModel/OTFTOF.h"
@@ -57,6 +58,7 @@
 #include <TPDGCode.h>
 #include <TRandom3.h>
 
+#include <array>
 #include <map>
 #include <string>
 #include <utility>
@@ -106,6 +108,17 @@ struct OnTheFlyTofPid {
     Configurable<bool> flagTOFLoadDelphesLUTs{"flagTOFLoadDelphesLUTs", false, "flag to load Delphes LUTs for tracking correction (use recoTrack parameters if false)"};
   } simConfig;
 
+  // tabulated track time resolution: the derivatives of the time of flight with respect to pt and eta are
+  // interpolated on a (p, eta) grid per TOF layer and mass hypothesis instead of being computed for each track
+  struct : ConfigurableGroup {
+    Configurable<bool> useResponseTables{"useResponseTables", false, "use the (p, eta) tables for the track time resolution"};
+    Configurable<int> nNodesP{"nNodesP", 400, "number of nodes in log(p) of the response tables"};
+    Configurable<float> minP{"minP", 0.02f, "lower momentum limit of the response tables (GeV/c)"};
+    Configurable<float> maxP{"maxP", 100.f, "upper momentum limit of the response tables (GeV/c)"};
+    Configurable<int> nNodesEta{"nNodesEta", 200, "number of nodes in eta of the response tables"};
+    Configurable<float> maxEta{"maxEta", 4.f, "eta limit of the response tables"};
+  } responseTableConfig;
+
   struct : ConfigurableGroup {
     Configurable<bool> doQAplots{"doQAplots", true, "do basic velocity plot qa"};
     Configurable<bool> doSeparationVsPt{"doSeparationVsPt", true, "Produce plots vs pt or p"};
@@ -141,6 +154,10 @@ struct OnTheFlyTofPid {
   HistogramRegistry histos{"Histos", {}, OutputObjHandlingPolicy::AnalysisObject};
   OutputObj<THashList> listEfficiency{"efficiency"};
   static constexpr int kParticles = 9;
+  static constexpr int kTOFLayers = 2; // inner and outer TOF
+
+  // |dtof/dpt| and |dtof/deta| per TOF layer and mass hypothesis, filled at the first use
+  std::array<std::array<o2::fastsim::ResponseTable<2>, kParticles>, kTOFLayers> mTrackTimeTables;
 
   // Configuration defined at init time
   o2::fastsim::GeometryContainer mGeoContainer;
@@ -151,6 +168,11 @@ struct OnTheFlyTofPid {
 
     const int nGeometries = mGeoContainer.getNumberOfConfigurations();
     mMagneticField = mGeoContainer.getFloatValue(0, "global", "magneticfield");
+    for (auto& layerTables : mTrackTimeTables) {
+      for (auto& table : layerTables) {
+        table.setGrid(responseTableConfig.nNodesP, responseTableConfig.minP, responseTableConfig.maxP, responseTableConfig.nNodesEta, responseTableConfig.maxEta);
+      }
+    }
 
     pRandomNumberGenerator.SetSeed(0); // fully randomize
     if (simConfig.flagTOFLoadDelphesLUTs) {
@@ -610,6 +632,17 @@ struct OnTheFlyTofPid {
                                               const float mass,
                                               const float detRadius,
                                               const float magneticField)
+  {
+    const auto derivatives = calculateTrackTimeDerivatives(pt, eta, mass, detRadius, magneticField);
+    return std::hypot(derivatives[0] * trackPtResolution, derivatives[1] * trackEtaResolution);
+  }
+
+  /// returns |dtof/dpt| and |dtof/deta|, the parameters are the ones of calculateTrackTimeResolutionAdvanced
+  std::array<float, 2> calculateTrackTimeDerivatives(const float pt,
+                                                      const float eta,
+                                                      const float mass,
+                                                      const float detRadius,
+                                                      const float magneticField)
   {
     // Compute tracking contribution to timing using the error propagation formula
     // Uses light speed in m/ps, magnetic field in T (*0.1 for conversion kGauss -> T)
@@ -618,8 +651,32 @@ struct OnTheFlyTofPid {
     double a2 = (detRadius * 0.01) * (detRadius * 0.01) * (0.299792458) * (0.299792458) * (0.1 * magneticField) * (0.1 * magneticField) / 2.0;
     double dtofOndPt = (std::pow(pt, 4) * std::pow(std::cosh(eta), 2) * std::acos(1.0 - a2 / std::pow(pt, 2)) - 2.0 * a2 * std::pow(pt, 2) * (a0 + std::pow(pt * std::cosh(eta), 2)) / std::sqrt(a2 * (2.0 * std::pow(pt, 2) - a2))) / (a1 * std::pow(pt, 3) * std::sqrt(a0 + std::pow(pt * std::cosh(eta), 2)));
     double dtofOndEta = std::pow(pt, 2) * std::sinh(eta) * std::cosh(eta) * std::acos(1.0 - a2 / std::pow(pt, 2)) / (a1 * std::sqrt(a0 + std::pow(pt * std::cosh(eta), 2)));
-    double trackTimeResolution = std::hypot(std::fabs(dtofOndPt) * trackPtResolution, std::fabs(dtofOndEta) * trackEtaResolution);
-    return trackTimeResolution;
+    return {static_cast<float>(std::fabs(dtofOndPt)), static_cast<float>(std::fabs(dtofOndEta))};
+  }
+
+  /// returns the track time resolution of the mass hypothesis iParticle at the TOF layer iLayer (0: inner, 1: outer),
+  /// interpolated in the response table if enabled and computed analytically otherwise or outside the table
+  /// \param momentum the momentum of the track for this hypothesis
+  double trackTimeResolution(const int iLayer,
+                             const int iParticle,
+                             const float momentum,
+                             const float eta,
+                             const float trackPtResolution,
+                             const float trackEtaResolution,
+                             const float mass)
+  {
+    const float detRadius = iLayer == 0 ? simConfig.innerTOFRadius : simConfig.outerTOFRadius;
+    if (responseTableConfig.useResponseTables) {
+      auto& table = mTrackTimeTables[iLayer][iParticle];
+      if (!table.isFilled()) {
+        table.fill([&](float p, float tableEta) { return calculateTrackTimeDerivatives(p / std::cosh(tableEta), tableEta, mass, detRadius, mMagneticField); });
+      }
+      std::array<float, 2> derivatives;
+      if (table.interpolate(momentum, eta, derivatives)) {
+        return std::hypot(derivatives[0] * trackPtResolution, derivatives[1] * trackEtaResolution);
+      }
+    }
+    return calculateTrackTimeResolutionAdvanced(momentum / std::cosh(eta), eta, trackPtResolution, trackEtaResolution, mass, detRadius, mMagneticField);
   }
 
   void process(soa::Join<aod::Collisions, aod::McCollisionLabels, aod::OTFLUTConfigId>::iterator const& collision,
@@ -880,8 +937,8 @@ struct OnTheFlyTofPid {
               etaResolution = mSmearer[collision.lutConfigId()]->getAbsEtaRes(kParticlePdgs[ii], dNdEta, pseudorapidity, transverseMomentum);
             }
           }
-          const float innerTrackTimeReso = calculateTrackTimeResolutionAdvanced(transverseMomentum, pseudorapidity, ptResolution, etaResolution, kParticleMasses[ii], simConfig.innerTOFRadius, mMagneticField);
-          const float outerTrackTimeReso = calculateTrackTimeResolutionAdvanced(transverseMomentum, pseudorapidity, ptResolution, etaResolution, kParticleMasses[ii], simConfig.outerTOFRadius, mMagneticField);
+          const float innerTrackTimeReso = trackTimeResolution(0, ii, momentumHypotheses[ii], pseudorapidity, ptResolution, etaResolution, kParticleMasses[ii]);
+          const float outerTrackTimeReso = trackTimeResolution(1, ii, momentumHypotheses[ii], pseudorapidity, ptResolution, etaResolution, kParticleMasses[ii]);
           innerTotalTimeReso = std::hypot(simConfig.innerTOFTimeReso, innerTrackTimeReso);
           outerTotalTimeReso = std::hypot(simConfig.outerTOFTimeReso, outerTrackTimeReso);
 
@@ -153,6 +153,8 @@ struct OnTheFlyTracker {
     Configurable<bool> applyZacceptance{"applyZacceptance", false, "apply z limits to detector layers or not"};
     Configurable<bool> applyMSCorrection{"applyMSCorrection", true, "apply ms corrections for secondaries or not"};
     Configurable<bool> applyElossCorrection{"applyElossCorrection", true, "apply eloss corrections for secondaries or not"};
+    Configurable<bool> useLUT{"useLUT", false, "interpolate the performance of tracks from the primary vertex in a pT x eta x species grid computed at first use"};
+    Configurable<int> nThreads{"nThreads", 1, "threads for the secondary fast tracking of the dev configuration: above 1 the particles of an event are fast-tracked in one batch, with per-thread random generators seeded from the seed (reproducible for a given number of threads)"};
   } fastTrackerSettings; // allows for gap between peak and bg in case someone wants to
 
   struct : ConfigurableGroup {
@@ -298,6 +300,8 @@ struct OnTheFlyTracker {
 
   // For processing and vertexing
   std::vector<TrackAlice3> tracksAlice3;
+  std::vector<o2::track::TrackParCov> batchInputTracks;  // particles of the event fast-tracked in one batch
+  std::vector<o2::track::TrackParCov> batchOutputTracks; // their fast-tracked tracks
   std::vector<TrackAlice3> ghostTracksAlice3;
   std::vector<o2::InteractionRecord> bcData;
   o2::steer::InteractionSampler irSampler;
@@ -418,6 +422,9 @@ struct OnTheFlyTracker {
         fastTracker[icfg]->SetApplyMSCorrection(fastTrackerSettings.applyMSCorrection);
         fastTracker[icfg]->SetApplyElossCorrection(fastTrackerSettings.applyElossCorrection);
         fastTracker[icfg]->AddGenericDetector(mGeoContainer.getEntry(icfg), ccdb.operator->());
+        fastTracker[icfg]->SetUseLUT(fastTrackerSettings.useLUT);
+        fastTracker[icfg]->SetNThreads(fastTrackerSettings.nThreads);
+        fastTracker[icfg]->SetRandomSeed(static_cast<uint32_t>(seed.value) + icfg);
         fastTracker[icfg]->Print(); // print fastTracker settings
 
         if (cascadeDecaySettings.doXiQA) {
@@ -1819,20 +1826,35 @@ struct OnTheFlyTracker {
     uint32_t multiplicityCounter = 0;
     getHist(TH1, histPath + "hLUTMultiplicity")->Fill(dNdEta);
 
-    // Now that the multiplicity is known, we can process the particles to smear them
-    for (const auto& mcParticle : mcParticles) {
+    auto isParticleToBeProcessed = [&](const auto& mcParticle) {
       const bool longLivedToBeHandled = std::find(longLivedHandledPDGs.begin(), longLivedHandledPDGs.end(), std::abs(mcParticle.pdgCode())) != longLivedHandledPDGs.end();
       const bool nucleiToBeHandled = std::find(nucleiPDGs.begin(), nucleiPDGs.end(), std::abs(mcParticle.pdgCode())) != nucleiPDGs.end();
       const bool pdgsToBeHandled = longLivedToBeHandled || (enableNucleiSmearing && nucleiToBeHandled);
-      if (!pdgsToBeHandled) {
-        continue;
-      }
-
-      if (std::fabs(mcParticle.eta()) > maxEta) {
-        continue;
+      return pdgsToBeHandled && std::fabs(mcParticle.eta()) <= maxEta && mcParticle.pt() >= minPt;
+    };
+    auto isFastTracked = [&](const auto& mcParticle) {
+      return !(enablePrimarySmearing && mcParticle.isPrimary()) && enableSecondarySmearing;
+    };
+
+    // With more than one thread, all the fast-tracked particles of the event go through the fast tracker in one batch,
+    // the results are then picked in particle order
+    const bool batchFastTracking = enableSecondarySmearing && fastTrackerSettings.nThreads > 1;
+    size_t iBatchTrack = 0;
+    if (batchFastTracking) {
+      batchInputTracks.clear();
+      for (const auto& mcParticle : mcParticles) {
+        if (isParticleToBeProcessed(mcParticle) && isFastTracked(mcParticle)) {
+          o2::upgrade::convertMCParticleToO2Track(mcParticle, batchInputTracks.emplace_back(), pdgDB);
+          batchInputTracks.back().setPID(pdgCodeToPID(mcParticle.pdgCode()));
+        }
       }
+      batchOutputTracks.resize(batchInputTracks.size());
+      fastTracker[icfg]->FastTrack(batchInputTracks, batchOutputTracks, dNdEta);
+    }
 
-      if (mcParticle.pt() < minPt) {
+    // Now that the multiplicity is known, we can process the particles to smear them
+    for (const auto& mcParticle : mcParticles) {
+      if (!isParticleToBeProcessed(mcParticle)) {
         continue;
       }
 
@@ -1868,10 +1890,16 @@ struct OnTheFlyTracker {
         o2::upgrade::convertMCParticleToO2Track(mcParticle, trackParCov, pdgDB);
         reconstructed = mSmearer[icfg]->smearTrack(trackParCov, mcParticle.pdgCode(), dNdEta);
       } else if (enableSecondarySmearing) {
-        o2::track::TrackParCov perfectTrackParCov;
-        o2::upgrade::convertMCParticleToO2Track(mcParticle, perfectTrackParCov, pdgDB);
-        perfectTrackParCov.setPID(pdgCodeToPID(mcParticle.pdgCode()));
-        const int nHits = fastTracker[icfg]->FastTrack(perfectTrackParCov, trackParCov, dNdEta);
+        int nHits = 0;
+        if (batchFastTracking) {
+          trackParCov = batchOutputTracks[iBatchTrack];
+          nHits = fastTracker[icfg]->GetBatchStatus(iBatchTrack++);
+        } else {
+          o2::track::TrackParCov perfectTrackParCov;
+          o2::upgrade::convertMCParticleToO2Track(mcParticle, perfectTrackParCov, pdgDB);
+          perfectTrackParCov.setPID(pdgCodeToPID(mcParticle.pdgCode()));
+          nHits = fastTracker[icfg]->FastTrack(perfectTrackParCov, trackParCov, dNdEta);
+        }
         if (nHits < fastTrackerSettings.minSiliconHits) {
           reconstructed = false;
         } else {
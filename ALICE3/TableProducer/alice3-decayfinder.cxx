@@ -17,6 +17,7 @@
 //    HF decays. Work in progress: use at your own risk!
 //
 
+#include "ALICE3/Core/PairDCACache.h"
 #include "ALICE3/DataModel/A3DecayFinderTables.h"
 #include "ALICE3/DataModel/OTFPIDTrk.h"
 #include "ALICE3/DataModel/OTFRICH.h"
@@ -97,6 +98,8 @@ struct alice3decayFinder {
   Configurable<bool> doTopoPlotsForSAndB{"doTopoPlotsForSAndB", true, "do topological variable distributions for S and B separately"};
   Configurable<bool> mcSameMotherCheck{"mcSameMotherCheck", true, "check if tracks come from the same MC mother"};
   Configurable<float> dcaDaughtersSelection{"dcaDaughtersSelection", 1000.0f, "DCA between daughters (cm)"};
+  Configurable<float> massPreselWindow3Prong{"massPreselWindow3Prong", -1.f, "Mass window around the 3-prong mother mass with the momenta before the vertex fit (GeV/c), negative: no preselection"};
+  Configurable<bool> usePairDCAPreselection{"usePairDCAPreselection", false, "reject the 3-prong combinations with a pair of daughters further than dcaDaughtersSelection before the three-body fit (exact with useAbsDCA)"};
 
   Configurable<float> piFromD_dcaXYconstant{"piFromD_dcaXYconstant", -1.0f, "[0] in |DCAxy| > [0]+[1]/pT"};
   Configurable<float> piFromD_dcaXYpTdep{"piFromD_dcaXYpTdep", 0.0, "[1] in |DCAxy| > [0]+[1]/pT"};
@@ -143,10 +146,19 @@ struct alice3decayFinder {
 
   o2::vertexing::DCAFitterN<2> fitter2prongs;
   o2::vertexing::DCAFitterN<3> fitter3prongs;
+  o2::vertexing::DCAFitterN<2> pairFitter; // DCA of the 3-prong daughter pairs only, the tracks are not propagated
+
+  // track parameters and momenta of the 3-prong daughter candidates of the current collision, shared by all the combinations
+  std::array<std::vector<o2::track::TrackParCov>, 3> prongTrackPars;
+  std::array<std::vector<std::array<float, 3>>, 3> prongMomenta;
+  o2::upgrade::PairDCACache dcasProngs01;
+  o2::upgrade::PairDCACache dcasProngs02;
+  o2::upgrade::PairDCACache dcasProngs12;
 
   std::array<int, 3> daugsPdgCodes3Prong{{-1, -1, -1}};
   std::array<float, 3> daughtersMasses3Prong{{-1.f, -1.f, -1.f}};
   int motherPdgCode{-1};
+  float motherMass3Prong{-1.f};
   int charmHadFlag{0};
 
   HistogramRegistry histos{"histos", {}, OutputObjHandlingPolicy::AnalysisObject};
@@ -492,6 +504,17 @@ struct alice3decayFinder {
     fitter3prongs.setBz(dcaFitterSettings.magneticField);
     fitter3prongs.setMatCorrType(o2::base::Propagator::MatCorrType::USEMatCorrNONE);
 
+    pairFitter.setPropagateToPCA(false);
+    pairFitter.setMaxR(dcaFitterSettings.maxR);
+    pairFitter.setMinParamChange(dcaFitterSettings.minParamChange);
+    pairFitter.setMinRelChi2Change(dcaFitterSettings.minRelChi2Change);
+    pairFitter.setMaxDZIni(dcaFitterSettings.maxDZIni);
+    pairFitter.setMaxChi2(dcaFitterSettings.maxVtxChi2);
+    pairFitter.setUseAbsDCA(dcaFitterSettings.useAbsDCA);
+    pairFitter.setWeightedFinalPCA(dcaFitterSettings.useWeightedFinalPCA);
+    pairFitter.setBz(dcaFitterSettings.magneticField);
+    pairFitter.setMatCorrType(o2::base::Propagator::MatCorrType::USEMatCorrNONE);
+
     const o2::framework::AxisSpec axisPt{binsPt, "#it{p}_{T} (GeV/#it{c})"};
     const o2::framework::AxisSpec axisEta{binsEta, "#eta"};
     const o2::framework::AxisSpec axisY{binsY, "y"};
@@ -611,6 +634,7 @@ struct alice3decayFinder {
     if (doprocessFindLc) {
       daugsPdgCodes3Prong = {+kProton, -kKPlus, +kPiPlus};
       motherPdgCode = o2::constants::physics::Pdg::kLambdaCPlus;
+      motherMass3Prong = o2::constants::physics::MassLambdaCPlus;
       daughtersMasses3Prong = {o2::constants::physics::MassProton,
                                o2::constants::physics::MassKaonCharged,
                                o2::constants::physics::MassPionCharged};
@@ -1009,18 +1033,59 @@ struct alice3decayFinder {
     }
   }
 
+  template <typename TProng>
+  void cacheProngs(TProng const& prongs, int iProng)
+  {
+    prongTrackPars[iProng].clear();
+    prongMomenta[iProng].clear();
+    for (auto const& prong : prongs) {
+      prongTrackPars[iProng].push_back(getTrackParCov(prong));
+      prongTrackPars[iProng].back().getPxPyPzGlo(prongMomenta[iProng].emplace_back());
+    }
+  }
+
   //*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*
   template <typename TProng>
   void fill3ProngTable(aod::Collision const& collision, TProng const& prongs0, TProng const& prongs1, TProng const& prongs2, aod::McParticles const& mcParticles)
   {
+    // The combinations are preselected before the three-body fit with the invariant mass from the momenta before the fit
+    // and with the DCA of the daughter pairs, cached as each pair enters many combinations
+    cacheProngs(prongs0, 0);
+    cacheProngs(prongs1, 1);
+    cacheProngs(prongs2, 2);
+    dcasProngs01.reset(prongs0.size(), prongs1.size());
+    dcasProngs02.reset(prongs0.size(), prongs2.size());
+    dcasProngs12.reset(prongs1.size(), prongs2.size());
+    const float maxPairDCA = usePairDCAPreselection ? dcaDaughtersSelection.value : -1.f;
+    const auto& [mass0, mass1, mass2] = daughtersMasses3Prong;
+
+    int i0 = -1;
     for (auto const& prong0 : prongs0) {
+      i0++;
+      int i2 = -1;
       for (auto const& prong2 : prongs2) {
+        i2++;
         if (prong2.globalIndex() == prong0.globalIndex())
           continue; // avoid self
+        if (massPreselWindow3Prong >= 0 && RecoDecay::m(std::array{prongMomenta[0][i0], prongMomenta[2][i2]}, std::array{mass0, mass2}) > motherMass3Prong + massPreselWindow3Prong - mass1) {
+          continue; // no third prong can give the mother
+        }
+        if (!dcasProngs02.isCompatible(i0, i2, maxPairDCA, [&] { return o2::upgrade::fitPairDCA(pairFitter, prongTrackPars[0][i0], prongTrackPars[2][i2]); })) {
+          continue;
+        }
+        int i1 = -1;
         for (auto const& prong1 : prongs1) {
+          i1++;
           if (mcSameMotherCheck && (!checkSameMother(prong0, prong1) || !checkSameMother(prong0, prong1))) {
             continue;
           }
+          if (massPreselWindow3Prong >= 0 && std::fabs(RecoDecay::m(std::array{prongMomenta[0][i0], prongMomenta[1][i1], prongMomenta[2][i2]}, daughtersMasses3Prong) - motherMass3Prong) > massPreselWindow3Prong) {
+            continue;
+          }
+          if (!dcasProngs01.isCompatible(i0, i1, maxPairDCA, [&] { return o2::upgrade::fitPairDCA(pairFitter, prongTrackPars[0][i0], prongTrackPars[1][i1]); }) ||
+              !dcasProngs12.isCompatible(i1, i2, maxPairDCA, [&] { return o2::upgrade::fitPairDCA(pairFitter, prongTrackPars[1][i1], prongTrackPars[2][i2]); })) {
+            continue;
+          }
           if (!buildDecayCandidateThreeBody(collision, prong0, prong1, prong2, mcParticles)) {
             continue;
           }
@@ -20,6 +20,7 @@
 //    Uses specific ALICE 3 PID and performance for studying
 //    HF decays. Work in progress: use at your own risk!
 
+#include "ALICE3/Core/PairDCACache.h"
 #include "ALICE3/DataModel/A3DecayFinderTables.h"
 #include "ALICE3/DataModel/OTFCollision.h"
 #include "ALICE3/DataModel/OTFMulticharm.h"
@@ -109,6 +110,8 @@ struct Alice3MulticharmFinder {
   Configurable<float> xicMinProperLength{"xicMinProperLength", 0.002, "Minimum proper length for XiC decay (cm)"};
   Configurable<float> xicMaxProperLength{"xicMaxProperLength", 0.1, "Minimum proper length for XiC decay (cm)"};
   Configurable<float> xicMassWindow{"xicMassWindow", 0.012, "Mass window around XiC peak (GeV/c)"};
+  Configurable<float> xicPreselMassWindow{"xicPreselMassWindow", 0.1, "Mass window around XiC peak with the momenta before the vertex fit (GeV/c), negative: no preselection"};
+  Configurable<float> xicMaxPairDauDCA{"xicMaxPairDauDCA", 0.01f, "DCA between each pair of XiC daughters before the three-body fit (cm), negative: no preselection"};
 
   Configurable<float> piccTofDiffInner{"piccTofDiffInner", 99999, "|signal - expected| (ps)"};
   Configurable<float> piccMinConstDCAxy{"piccMinConstDCAxy", 0.0005f, "[0] in |DCAxy| > [0]+[1]/pT"};
@@ -125,6 +128,7 @@ struct Alice3MulticharmFinder {
   Configurable<float> xiccMinProperLength{"xiccMinProperLength", -1, "Minimum proper length for XiCC decay (cm)"};
   Configurable<float> xiccMaxProperLength{"xiccMaxProperLength", 999, "Minimum proper length for XiCC decay (cm)"};
   Configurable<float> xiccMassWindow{"xiccMassWindow", 0.25, "Mass window around XiCC peak (GeV/c). Make sure that bkg region is included in this window"};
+  Configurable<float> xiccPreselMassWindow{"xiccPreselMassWindow", 0.5, "Mass window around XiCC peak with the momenta before the vertex fit (GeV/c), negative: no preselection"};
 
   ConfigurableAxis axisEta{"axisEta", {80, -4.0f, +4.0f}, "#eta"};
   ConfigurableAxis axisPt{"axisPt", {VARIABLE_WIDTH, 0.0f, 0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f, 0.7f, 0.8f, 0.9f, 1.0f, 1.1f, 1.2f, 1.3f, 1.4f, 1.5f, 1.6f, 1.7f, 1.8f, 1.9f, 2.0f, 2.2f, 2.4f, 2.6f, 2.8f, 3.0f, 3.2f, 3.4f, 3.6f, 3.8f, 4.0f, 4.4f, 4.8f, 5.2f, 5.6f, 6.0f, 6.5f, 7.0f, 7.5f, 8.0f, 9.0f, 10.0f, 11.0f, 12.0f, 13.0f, 14.0f, 15.0f, 17.0f, 19.0f, 21.0f, 23.0f, 25.0f, 30.0f, 35.0f, 40.0f, 50.0f}, "pt axis for QA histograms"};
@@ -147,6 +151,15 @@ struct Alice3MulticharmFinder {
 
   o2::vertexing::DCAFitterN<2> fitter;
   o2::vertexing::DCAFitterN<3> fitter3;
+  o2::vertexing::DCAFitterN<2> pairFitter; // DCA of the daughter pairs only, the tracks are not propagated
+
+  // track parameters and momenta of the pion candidates of the current collision, shared by all the combinations
+  std::vector<o2::track::TrackParCov> picTrackPars;
+  std::vector<o2::track::TrackParCov> piccTrackPars;
+  std::vector<std::array<float, 3>> picMomenta;
+  std::vector<std::array<float, 3>> piccMomenta;
+  o2::upgrade::PairDCACache xiPionDCAs;   // DCA of the current Xi with each XiC pion candidate
+  o2::upgrade::PairDCACache pionPairDCAs; // DCA of the pairs of XiC pion candidates, shared by all the Xi of the collision
 
   HistogramRegistry histos{"histos", {}, OutputObjHandlingPolicy::AnalysisObject};
   std::map<std::string, HistPtr> histPointers;
@@ -274,18 +287,13 @@ struct Alice3MulticharmFinder {
     return true;
   }
 
-  template <typename TTrackType1, typename TTrackType2, typename TTrackType3>
-  bool buildDecayCandidateThreeBody(TTrackType1 const& prong0, TTrackType2 const& prong1, TTrackType3 const& prong2, float p0mass, float p1mass, float p2mass)
+  bool buildDecayCandidateThreeBody(o2::track::TrackParCov const& prong0, o2::track::TrackParCov const& prong1, o2::track::TrackParCov const& prong2, float p0mass, float p1mass, float p2mass)
   {
-    o2::track::TrackParCov t0 = getTrackParCov(prong0);
-    o2::track::TrackParCov t1 = getTrackParCov(prong1);
-    o2::track::TrackParCov t2 = getTrackParCov(prong2);
-
     //}-{}-{}-{}-{}-{}-{}-{}-{}-{}
     // Move close to minima
     int nCand = 0;
     try {
-      nCand = fitter3.process(t0, t1, t2);
+      nCand = fitter3.process(prong0, prong1, prong2);
     } catch (...) {
       return false;
     }
@@ -294,9 +302,9 @@ struct Alice3MulticharmFinder {
     }
     //}-{}-{}-{}-{}-{}-{}-{}-{}-{}
 
-    t0 = fitter3.getTrack(0);
-    t1 = fitter3.getTrack(1);
-    t2 = fitter3.getTrack(2);
+    o2::track::TrackParCov t0 = fitter3.getTrack(0);
+    o2::track::TrackParCov t1 = fitter3.getTrack(1);
+    o2::track::TrackParCov t2 = fitter3.getTrack(2);
     t0.getPxPyPzGlo(thisXiCcandidate.prong0mom);
     t1.getPxPyPzGlo(thisXiCcandidate.prong1mom);
     t2.getPxPyPzGlo(thisXiCcandidate.prong2mom);
@@ -425,6 +433,17 @@ struct Alice3MulticharmFinder {
     fitter3.setBz(magneticField);
     fitter3.setMatCorrType(o2::base::Propagator::MatCorrType::USEMatCorrNONE);
 
+    pairFitter.setPropagateToPCA(false);
+    pairFitter.setMaxR(200.);
+    pairFitter.setMinParamChange(1e-3);
+    pairFitter.setMinRelChi2Change(0.9);
+    pairFitter.setMaxDZIni(1e9);
+    pairFitter.setMaxChi2(1e9);
+    pairFitter.setUseAbsDCA(true);
+    pairFitter.setWeightedFinalPCA(false);
+    pairFitter.setBz(magneticField);
+    pairFitter.setMatCorrType(o2::base::Propagator::MatCorrType::USEMatCorrNONE);
+
     INSERT_HIST(std::string("h2dGenXi"), "h2dGenXi", {kTH2D, {{axisPt, axisEta}}});
     INSERT_HIST(std::string("h2dGenXiC"), "h2dGenXiC", {kTH2D, {{axisPt, axisEta}}});
     INSERT_HIST(std::string("h2dGenXiCC"), "h2dGenXiCC", {kTH2D, {{axisPt, axisEta}}});
@@ -542,6 +561,23 @@ struct Alice3MulticharmFinder {
     auto picTracksGrouped = picTracks->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache);
     auto piccTracksGrouped = piccTracks->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache);
 
+    // The combinations are built in stages, from the cheapest to the most expensive selection:
+    // invariant mass with the momenta before the fit, DCA of the daughter pairs (cached), and only then the vertex fits
+    picTrackPars.clear();
+    picMomenta.clear();
+    for (auto const& pic : picTracksGrouped) {
+      picTrackPars.push_back(getTrackParCov(pic));
+      picTrackPars.back().getPxPyPzGlo(picMomenta.emplace_back());
+    }
+    piccTrackPars.clear();
+    piccMomenta.clear();
+    for (auto const& picc : piccTracksGrouped) {
+      piccTrackPars.push_back(getTrackParCov(picc));
+      piccTrackPars.back().getPxPyPzGlo(piccMomenta.emplace_back());
+    }
+    const int nPic = picTrackPars.size();
+    pionPairDCAs.reset(nPic, nPic);
+
     for (auto const& track : tracks) {
       if (BIT_CHECK(track.decayMap(), kTruePiFromXiC)) {
         GET_HIST(TH2, histPath + "h2dDCAxyVsPtPiFromXiC")->Fill(track.pt(), track.dcaXY() * toMicrons);
@@ -579,7 +615,15 @@ struct Alice3MulticharmFinder {
       }
 
       GET_HIST(TH1, histPath + "hMinXiDecayRadius")->Fill(xiCand.cascRadius());
+      const o2::track::TrackParCov xiTrack = getTrackParCov(xi);
+      std::array<float, 3> xiMomentum;
+      xiTrack.getPxPyPzGlo(xiMomentum);
+      xiPionDCAs.reset(1, nPic);
+      const auto xiPionDCA = [&](int iPi) { return o2::upgrade::fitPairDCA(pairFitter, xiTrack, picTrackPars[iPi]); };
+
+      int iPi1 = -1;
       for (auto const& pi1c : picTracksGrouped) {
+        iPi1++;
         if (mcSameMotherCheck && !checkSameMother(xi, pi1c)) {
           continue;
         }
@@ -600,8 +644,18 @@ struct Alice3MulticharmFinder {
         }
 
         GET_HIST(TH1, histPath + "hInnerTOFTrackTimeRecoPi1c")->Fill(pi1cTOFDiffInner);
+        // the Xi-pi pair must be below the XiC mass minus the mass of the second pion and close enough
+        if (xicPreselMassWindow >= 0 && RecoDecay::m(std::array{xiMomentum, picMomenta[iPi1]}, std::array{o2::constants::physics::MassXiMinus, o2::constants::physics::MassPionCharged}) > o2::constants::physics::MassXiCPlus + xicPreselMassWindow - o2::constants::physics::MassPionCharged) {
+          continue; // no second pion can give a XiC
+        }
+        if (!xiPionDCAs.isCompatible(0, iPi1, xicMaxPairDauDCA, [&] { return xiPionDCA(iPi1); })) {
+          continue; // Xi and pion too far apart
+        }
+
         // second pion from XiC decay for starts here
+        int iPi2 = -1;
         for (auto const& pi2c : picTracksGrouped) {
+          iPi2++;
           if (mcSameMotherCheck && !checkSameMother(xi, pi2c)) {
             continue; // keep only if same mother
           }
@@ -626,12 +680,20 @@ struct Alice3MulticharmFinder {
           }
 
           GET_HIST(TH1, histPath + "hInnerTOFTrackTimeRecoPi2c")->Fill(pi2cTOFDiffInner);
+          if (xicPreselMassWindow >= 0 && std::fabs(RecoDecay::m(std::array{xiMomentum, picMomenta[iPi1], picMomenta[iPi2]}, std::array{o2::constants::physics::MassXiMinus, o2::constants::physics::MassPionCharged, o2::constants::physics::MassPionCharged}) - o2::constants::physics::MassXiCPlus) > xicPreselMassWindow) {
+            continue; // out of the mass preselection window
+          }
+          if (!xiPionDCAs.isCompatible(0, iPi2, xicMaxPairDauDCA, [&] { return xiPionDCA(iPi2); }) ||
+              !pionPairDCAs.isCompatible(iPi1, iPi2, xicMaxPairDauDCA, [&] { return o2::upgrade::fitPairDCA(pairFitter, picTrackPars[iPi1], picTrackPars[iPi2]); })) {
+            continue; // daughters too far apart for the three-body DCA cut
+          }
+
           // if I am here, it means this is a triplet to be considered for XiC vertexing.
           // will now attempt to build a three-body decay candidate with these three track rows.
 
           nCombinationsC++;
           GET_HIST(TH1, histPath + "hCharmBuilding")->Fill(0.0f);
-          if (!buildDecayCandidateThreeBody(xi, pi1c, pi2c, o2::constants::physics::MassXiMinus, o2::constants::physics::MassPionCharged, o2::constants::physics::MassPionCharged)) {
+          if (!buildDecayCandidateThreeBody(xiTrack, picTrackPars[iPi1], picTrackPars[iPi2], o2::constants::physics::MassXiMinus, o2::constants::physics::MassPionCharged, o2::constants::physics::MassPionCharged)) {
             continue; // failed at building candidate
           }
 
@@ -678,7 +740,9 @@ struct Alice3MulticharmFinder {
 
           // attempt XiCC finding
           uint32_t nCombinationsCC = 0;
+          int iPicc = -1;
           for (auto const& picc : piccTracksGrouped) {
+            iPicc++;
             if (mcSameMotherCheck && !checkSameMotherExtra(xi, picc)) {
               continue;
             }
@@ -699,10 +763,13 @@ struct Alice3MulticharmFinder {
             }
 
             GET_HIST(TH1, histPath + "hInnerTOFTrackTimeRecoPicc")->Fill(piccTOFDiffInner);
-            o2::track::TrackParCov piccTrack = getTrackParCov(picc);
+            if (xiccPreselMassWindow >= 0 && std::fabs(RecoDecay::m(std::array{momentumC, piccMomenta[iPicc]}, std::array{o2::constants::physics::MassXiCPlus, o2::constants::physics::MassPionCharged}) - o2::constants::physics::MassXiCCPlusPlus) > xiccPreselMassWindow) {
+              continue; // out of the mass preselection window
+            }
+
             nCombinationsCC++;
             GET_HIST(TH1, histPath + "hCharmBuilding")->Fill(2.0f);
-            if (!buildDecayCandidateTwoBody(xicTrack, piccTrack, o2::constants::physics::MassXiCPlus, o2::constants::physics::MassPionCharged)) {
+            if (!buildDecayCandidateTwoBody(xicTrack, piccTrackPars[iPicc], o2::constants::physics::MassXiCPlus, o2::constants::physics::MassPionCharged)) {
               continue; // failed at building candidate
             }
 
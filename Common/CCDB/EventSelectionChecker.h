@@ -0,0 +1,132 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file EventSelectionChecker.h
+/// \brief Combination of event selection bits checked with a single mask-compare against the selection bitmap column of the EvSels tables
+
+#ifndef COMMON_CCDB_EVENTSELECTIONCHECKER_H_
+#define COMMON_CCDB_EVENTSELECTIONCHECKER_H_
+
+#include "Common/CCDB/EventSelectionParams.h"
+
+#include <concepts>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace o2::aod::evsel
+{
+
+template <typename T>
+concept HasSelectionBits = requires(T a) {
+  { a.selection_raw() } -> std::convertible_to<uint64_t>;
+};
+
+// The required selection bits are compiled once into a mask, the check of an event is then (selection & mask) == mask.
+// The same mask can be used in a framework Filter: Filter evSelFilter = ncheckbit(aod::evsel::selection, checker.mask());
+class EventSelectionChecker
+{
+ public:
+  EventSelectionChecker() = default;
+
+  // Construct the object from a list of flags, like this:
+  // EventSelectionChecker checker{kIsTriggerTVX, kNoSameBunchPileup, kIsGoodZvtxFT0vsPV};
+  EventSelectionChecker(std::initializer_list<EventSelectionFlags> flags)
+  {
+    for (const auto flag : flags) {
+      set(flag);
+    }
+  }
+
+  // Construct the object from an expression, see init(const std::string&)
+  explicit EventSelectionChecker(const std::string& expression) { init(expression); }
+
+  // Initialize the object from an expression: flags separated by commas, spaces or '&',
+  // with or without the leading 'k' of the EventSelectionFlags name (e.g. "sel8, kNoSameBunchPileup & IsGoodZvtxFT0vsPV").
+  // "sel8" is a shorthand for the bits of the Run 3 sel8 decision: kIsTriggerTVX, kNoTimeFrameBorder and kNoITSROFrameBorder.
+  // Throws std::invalid_argument for an unknown flag
+  void init(const std::string& expression)
+  {
+    reset();
+    std::string token;
+    for (size_t i = 0; i <= expression.size(); ++i) {
+      const char c = i < expression.size() ? expression[i] : ' ';
+      if (c == ',' || c == ' ' || c == '&' || c == '\t') {
+        if (!token.empty()) {
+          set(token);
+          token.clear();
+        }
+      } else {
+        token += c;
+      }
+    }
+  }
+
+  void reset() { mMask = 0; }
+  void set(EventSelectionFlags flag) { mMask |= uint64_t{1} << flag; }
+  // Set a flag from its name, or the sel8 bits for "sel8"
+  void set(const std::string& name)
+  {
+    if (name == "sel8") {
+      set(kIsTriggerTVX);
+      set(kNoTimeFrameBorder);
+      set(kNoITSROFrameBorder);
+      return;
+    }
+    for (int iBit = 0; iBit < kNsel; ++iBit) {
+      const std::string label = selectionLabels[iBit];
+      if (name == label || "k" + name == label) {
+        set(static_cast<EventSelectionFlags>(iBit));
+        return;
+      }
+    }
+    throw std::invalid_argument("EventSelectionChecker: unknown event selection flag " + name);
+  }
+  // Set the flag only if the configuration asks for it, e.g. checker.setIf(kNoSameBunchPileup, cfgNoSameBunchPileup)
+  void setIf(EventSelectionFlags flag, bool required)
+  {
+    if (required) {
+      set(flag);
+    }
+  }
+
+  uint64_t mask() const { return mMask; }
+  bool any() const { return mMask != 0; }
+
+  // The function returns true if all the required bits are set in the selection bitmap
+  bool checkRaw(uint64_t selection) const { return (selection & mMask) == mMask; }
+  bool checkTable(const HasSelectionBits auto& collision) const { return checkRaw(collision.selection_raw()); }
+  bool operator()(const HasSelectionBits auto& collision) const { return checkTable(collision); }
+
+  // Indices (positions in the table) of the selected rows, e.g. to run the expensive part of a task only on the selected collisions.
+  // The index is written unconditionally and the write position advanced by the check result, so the loop has no branch
+  template <typename TCollisions>
+  void selectedIndices(TCollisions const& collisions, std::vector<int64_t>& indices) const
+  {
+    indices.resize(collisions.size());
+    int64_t nSelected = 0;
+    int64_t index = 0;
+    for (const auto& collision : collisions) {
+      indices[nSelected] = index++;
+      nSelected += checkRaw(collision.selection_raw());
+    }
+    indices.resize(nSelected);
+  }
+
+ private:
+  uint64_t mMask = 0;
+};
+
+} // namespace o2::aod::evsel
+
+#endif // COMMON_CCDB_EVENTSELECTIONCHECKER_H_
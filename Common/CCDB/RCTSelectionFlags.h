@@ -21,10 +21,13 @@
 
 #include <algorithm>
 #include <concepts>
+#include <cstddef>
 #include <cstdint>
 #include <initializer_list>
+#include <iterator>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 namespace o2::aod::rctsel
 {
@@ -215,13 +218,18 @@ class RCTFlagsChecker : public o2::utils::EnumFlags<RCTSelectionFlags>
       throw std::out_of_range("RCTFlagsChecker has empty RCTSelectionFlags bits mask");
     }
 
-    // bitmask of the current table
-    uint64_t tableBits = table.rct_raw();
+    return checkRaw(table.rct_raw());
+  }
+
+  // Check a raw RCT bitmask, e.g. the flags resolved by an RCTFlagsTimeline.
+  // The function returns true if none of the checked flags is set in the bitmask.
+  bool checkRaw(uint64_t rctBits) const
+  {
     // bitmask of flags to be checked
     uint64_t flagsBits = value();
 
     // return true if none of the checked bits is set in the table bitmask
-    return ((tableBits & flagsBits) == 0);
+    return ((rctBits & flagsBits) == 0);
   }
 
   // Check the validity of the RCT column of a given event selection table.
@@ -237,5 +245,69 @@ class RCTFlagsChecker : public o2::utils::EnumFlags<RCTSelectionFlags>
   }
 };
 
+// RCT flags of a run (CCDB object RCT/Flags/RunFlags, a map from the start timestamp of each interval to its flags)
+// stored as a sorted flat array of intervals.
+// The last interval found is remembered, so that the lookups of increasing timestamps, as within a data frame,
+// are resolved without a search in most cases
+class RCTFlagsTimeline
+{
+ public:
+  RCTFlagsTimeline() = default;
+
+  // Fill the intervals from the map of the CCDB object
+  template <typename TMap>
+  void set(TMap const& mapRCT)
+  {
+    clear();
+    mStarts.reserve(mapRCT.size());
+    mFlags.reserve(mapRCT.size());
+    for (const auto& [start, flags] : mapRCT) {
+      mStarts.push_back(start);
+      mFlags.push_back(flags);
+    }
+  }
+
+  // Single interval with the given flags, e.g. when the CCDB object is missing
+  void set(uint64_t start, uint32_t flags)
+  {
+    clear();
+    mStarts.push_back(start);
+    mFlags.push_back(flags);
+  }
+
+  void clear()
+  {
+    mStarts.clear();
+    mFlags.clear();
+    mCursor = 0;
+  }
+
+  bool empty() const { return mStarts.empty(); }
+
+  // Flags of the last interval starting at or before the timestamp (of the first interval for earlier timestamps)
+  uint32_t get(uint64_t timestamp)
+  {
+    const std::size_t nIntervals = mStarts.size();
+    if (nIntervals == 0) {
+      return 0;
+    }
+    // same or next interval as in the previous call
+    for (std::size_t interval = mCursor; interval < std::min(mCursor + 2, nIntervals); interval++) {
+      if (timestamp >= mStarts[interval] && (interval + 1 == nIntervals || timestamp < mStarts[interval + 1])) {
+        mCursor = interval;
+        return mFlags[interval];
+      }
+    }
+    auto it = std::upper_bound(mStarts.begin(), mStarts.end(), timestamp);
+    mCursor = (it == mStarts.begin()) ? 0 : std::distance(mStarts.begin(), it) - 1;
+    return mFlags[mCursor];
+  }
+
+ private:
+  std::vector<uint64_t> mStarts; // start timestamps of the intervals, in increasing order
+  std::vector<uint32_t> mFlags;  // flags of the intervals
+  std::size_t mCursor = 0;       // interval of the last lookup
+};
+
 } // namespace o2::aod::rctsel
 #endif // COMMON_CCDB_RCTSELECTIONFLAGS_H_
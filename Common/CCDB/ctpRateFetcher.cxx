@@ -11,6 +11,8 @@
 
 #include "ctpRateFetcher.h"
 
+#include "Common/Core/RunConditionsCache.h"
+
 #include <CCDB/BasicCCDBManager.h>
 #include <CommonConstants/LHCConstants.h>
 #include <DataFormatsCTP/Configuration.h>
@@ -22,6 +24,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <map>
+#include <memory>
 #include <ostream>
 #include <string>
 #include <vector>
@@ -103,6 +106,37 @@ double ctpRateFetcher::pileUpCorrection(double triggerRate)
   return mu * nbc * constants::lhc::LHCRevFreq;
 }
 
+namespace
+{
+using o2::common::core::RunConditionsCache;
+
+RunConditionsCache::Loader lhcifLoader(o2::ccdb::BasicCCDBManager* ccdb, uint64_t timeStamp)
+{
+  return RunConditionsCache::makeLoader<parameters::GRPLHCIFData>(ccdb, "GLO/Config/GRPLHCIF", timeStamp, {});
+}
+
+RunConditionsCache::Loader configLoader(o2::ccdb::BasicCCDBManager* ccdb, uint64_t timeStamp, int runNumber)
+{
+  return RunConditionsCache::makeLoader<ctp::CTPConfiguration>(ccdb, "CTP/Config/Config", timeStamp, {{"runNumber", std::to_string(runNumber)}});
+}
+
+RunConditionsCache::Loader scalersLoader(o2::ccdb::BasicCCDBManager* ccdb, uint64_t timeStamp, int runNumber)
+{
+  return RunConditionsCache::makeLoader<ctp::CTPRunScalers>(ccdb, "CTP/Calib/Scalers", timeStamp, {{"runNumber", std::to_string(runNumber)}}, [](std::shared_ptr<ctp::CTPRunScalers> scalers, const RunConditionsCache::Metadata&) {
+    scalers->convertRawToO2(); /// done once, the converted scalers are shared
+    return std::shared_ptr<void>{scalers};
+  });
+}
+} // namespace
+
+void ctpRateFetcher::prefetch(o2::ccdb::BasicCCDBManager* ccdb, uint64_t timeStamp, int runNumber)
+{
+  auto& cache = RunConditionsCache::instance();
+  cache.prefetch("GLO/Config/GRPLHCIF", runNumber, lhcifLoader(ccdb, timeStamp));
+  cache.prefetch("CTP/Config/Config", runNumber, configLoader(ccdb, timeStamp, runNumber));
+  cache.prefetch("CTP/Calib/Scalers", runNumber, scalersLoader(ccdb, timeStamp, runNumber));
+}
+
 void ctpRateFetcher::setupRun(int runNumber, o2::ccdb::BasicCCDBManager* ccdb, uint64_t timeStamp)
 {
   if (runNumber == mRunNumber) {
@@ -110,26 +144,20 @@ void ctpRateFetcher::setupRun(int runNumber, o2::ccdb::BasicCCDBManager* ccdb, u
   }
   mRunNumber = runNumber;
   LOG(debug) << "Setting up CTP scalers for run " << mRunNumber;
-  if (mManualCleanup) {
-    delete mConfig;
-    delete mScalers;
-    delete mLHCIFdata;
-  }
-  std::map<std::string, std::string> metadata;
-  mLHCIFdata = ccdb->getSpecific<parameters::GRPLHCIFData>("GLO/Config/GRPLHCIF", timeStamp, metadata);
+  prefetch(ccdb, timeStamp, runNumber); /// the three objects are fetched concurrently, no-op if they are already in the cache
+  auto& cache = RunConditionsCache::instance();
+  mLHCIFdata = cache.get<parameters::GRPLHCIFData>("GLO/Config/GRPLHCIF", runNumber, lhcifLoader(ccdb, timeStamp));
   if (mLHCIFdata == nullptr) {
     LOG(fatal) << "GRPLHCIFData not in database, timestamp:" << timeStamp;
   }
-  metadata["runNumber"] = std::to_string(mRunNumber);
-  mConfig = ccdb->getSpecific<ctp::CTPConfiguration>("CTP/Config/Config", timeStamp, metadata);
+  mConfig = cache.get<ctp::CTPConfiguration>("CTP/Config/Config", runNumber, configLoader(ccdb, timeStamp, runNumber));
   if (mConfig == nullptr) {
     LOG(fatal) << "CTPRunConfig not in database, timestamp:" << timeStamp;
   }
-  mScalers = ccdb->getSpecific<ctp::CTPRunScalers>("CTP/Calib/Scalers", timeStamp, metadata);
+  mScalers = cache.get<ctp::CTPRunScalers>("CTP/Calib/Scalers", runNumber, scalersLoader(ccdb, timeStamp, runNumber));
   if (mScalers == nullptr) {
     LOG(fatal) << "CTPRunScalers not in database, timestamp:" << timeStamp;
   }
-  mScalers->convertRawToO2();
 }
 
 } // namespace o2
@@ -15,6 +15,7 @@
 #include <CCDB/BasicCCDBManager.h>
 
 #include <cstdint>
+#include <memory>
 #include <string>
 
 namespace o2
@@ -37,7 +38,8 @@ class ctpRateFetcher
   ctpRateFetcher() = default;
   double fetch(o2::ccdb::BasicCCDBManager* ccdb, uint64_t timeStamp, int runNumber, const std::string& sourceName, bool fCrashOnNull = true);
 
-  void setManualCleanup(bool manualCleanup = true) { mManualCleanup = manualCleanup; }
+  /// Start fetching in the background the CTP objects of a run (e.g. the next one to be processed), shared by all the fetchers in the process
+  static void prefetch(o2::ccdb::BasicCCDBManager* ccdb, uint64_t timeStamp, int runNumber);
 
  private:
   double fetchCTPratesInputs(o2::ccdb::BasicCCDBManager* ccdb, uint64_t timeStamp, int runNumber, int input);
@@ -45,11 +47,10 @@ class ctpRateFetcher
   double pileUpCorrection(double rate);
   void setupRun(int runNumber, o2::ccdb::BasicCCDBManager* ccdb, uint64_t timeStamp);
 
-  bool mManualCleanup = false;
   int mRunNumber = -1;
-  ctp::CTPConfiguration* mConfig = nullptr;
-  ctp::CTPRunScalers* mScalers = nullptr;
-  parameters::GRPLHCIFData* mLHCIFdata = nullptr;
+  std::shared_ptr<ctp::CTPConfiguration> mConfig;       /// Owned by the RunConditionsCache
+  std::shared_ptr<ctp::CTPRunScalers> mScalers;         /// Owned by the RunConditionsCache
+  std::shared_ptr<parameters::GRPLHCIFData> mLHCIFdata; /// Owned by the RunConditionsCache
 };
 } // namespace o2
 
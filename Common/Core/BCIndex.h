@@ -0,0 +1,184 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file BCIndex.h
+/// \brief Per data frame index of the BC and collision tables by global BC, built once and shared by the helpers which look up neighbouring BCs or collisions
+///        (svPoolCreator, udhelpers::compatibleBCs, ...)
+
+#ifndef COMMON_CORE_BCINDEX_H_
+#define COMMON_CORE_BCINDEX_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace o2::common::core
+{
+
+/// Flat arrays with the global BC of each BC row, the global BC of each collision, the collisions sorted by global BC
+/// and the dense (CSR) list of the collisions of each BC row.
+/// All the lookups are binary searches on contiguous arrays and the neighbours of a BC or of a collision are the adjacent entries,
+/// so that the tasks do not walk the tables with iterators nor dereference the BC of each collision again.
+/// The BC table must be the unfiltered one, as the bcId() of the collisions are row indices in it.
+class BCIndex
+{
+ public:
+  static constexpr uint64_t BcInvalid = std::numeric_limits<uint64_t>::max();
+
+  void clear()
+  {
+    mBCGlobalBCs.clear();
+    mSortedBCRows.clear();
+    mSortedBCGlobalBCs.clear();
+    mCollisionGlobalBCs.clear();
+    mSortedCollisions.clear();
+    mSortedCollisionGlobalBCs.clear();
+    mBCCollisionOffsets.clear();
+    mBCCollisions.clear();
+    mBCsSorted = true;
+  }
+
+  /// Reads the global BC of each BC row, to be called once per data frame before setCollisions()
+  template <typename TBCs>
+  void setBCs(TBCs const& bcs)
+  {
+    clear();
+    const int64_t nBCs = bcs.size();
+    mBCGlobalBCs.reserve(nBCs);
+    for (const auto& bc : bcs) {
+      mBCGlobalBCs.push_back(bc.globalBC());
+    }
+    mBCsSorted = std::is_sorted(mBCGlobalBCs.begin(), mBCGlobalBCs.end());
+    mSortedBCRows.resize(nBCs);
+    std::iota(mSortedBCRows.begin(), mSortedBCRows.end(), 0);
+    if (!mBCsSorted) {
+      std::stable_sort(mSortedBCRows.begin(), mSortedBCRows.end(), [this](int64_t a, int64_t b) { return mBCGlobalBCs[a] < mBCGlobalBCs[b]; });
+    }
+    mSortedBCGlobalBCs.resize(nBCs);
+    for (int64_t i = 0; i < nBCs; ++i) {
+      mSortedBCGlobalBCs[i] = mBCGlobalBCs[mSortedBCRows[i]];
+    }
+  }
+
+  /// Reads the BC of each collision, collisions without BC get BcInvalid and are neither in the sorted list nor in the per-BC lists
+  template <typename TCollisions>
+  void setCollisions(TCollisions const& collisions)
+  {
+    const int64_t nBCs = mBCGlobalBCs.size();
+    const int64_t nCollisions = collisions.size();
+    mCollisionGlobalBCs.assign(nCollisions, BcInvalid);
+    mSortedCollisions.clear();
+    mSortedCollisions.reserve(nCollisions);
+    mBCCollisionOffsets.assign(nBCs + 1, 0);
+    std::vector<int64_t> bcRows(nCollisions, -1);
+    int64_t index{0};
+    for (const auto& collision : collisions) {
+      const int64_t bcRow = collision.bcId();
+      if (bcRow >= 0 && bcRow < nBCs) {
+        bcRows[index] = bcRow;
+        mCollisionGlobalBCs[index] = mBCGlobalBCs[bcRow];
+        mSortedCollisions.push_back(index);
+        mBCCollisionOffsets[bcRow + 1]++;
+      }
+      index++;
+    }
+    std::stable_sort(mSortedCollisions.begin(), mSortedCollisions.end(), [this](int64_t a, int64_t b) { return mCollisionGlobalBCs[a] < mCollisionGlobalBCs[b]; });
+    mSortedCollisionGlobalBCs.resize(mSortedCollisions.size());
+    for (size_t i = 0; i < mSortedCollisions.size(); ++i) {
+      mSortedCollisionGlobalBCs[i] = mCollisionGlobalBCs[mSortedCollisions[i]];
+    }
+
+    std::partial_sum(mBCCollisionOffsets.begin(), mBCCollisionOffsets.end(), mBCCollisionOffsets.begin());
+    mBCCollisions.resize(mBCCollisionOffsets[nBCs]);
+    std::vector<int64_t> fill(mBCCollisionOffsets.begin(), mBCCollisionOffsets.end() - 1);
+    for (int64_t i = 0; i < nCollisions; ++i) {
+      if (bcRows[i] >= 0) {
+        mBCCollisions[fill[bcRows[i]]++] = i;
+      }
+    }
+  }
+
+  // BCs
+  int64_t nBCs() const { return mBCGlobalBCs.size(); }
+  bool bcsSorted() const { return mBCsSorted; }
+  uint64_t globalBC(int64_t bcRow) const { return mBCGlobalBCs[bcRow]; }
+
+  /// Row of the BC with the given global BC, -1 if not in the table
+  int64_t findBC(uint64_t globalBC) const
+  {
+    const int64_t pos = lowerBoundBC(globalBC);
+    return (pos < nBCs() && mSortedBCGlobalBCs[pos] == globalBC) ? mSortedBCRows[pos] : -1;
+  }
+
+  /// Position, in global BC order, of the first BC with global BC >= globalBC (nBCs() if none).
+  /// The neighbours of a BC are the positions pos - 1 and pos + 1, see sortedBCRow() and sortedBCGlobalBC()
+  int64_t lowerBoundBC(uint64_t globalBC) const
+  {
+    return std::lower_bound(mSortedBCGlobalBCs.begin(), mSortedBCGlobalBCs.end(), globalBC) - mSortedBCGlobalBCs.begin();
+  }
+  int64_t sortedBCRow(int64_t pos) const { return mSortedBCRows[pos]; }
+  uint64_t sortedBCGlobalBC(int64_t pos) const { return mSortedBCGlobalBCs[pos]; }
+
+  /// Positions [first, last) in global BC order of the BCs with minBC <= global BC <= maxBC.
+  /// If bcsSorted() the positions are also the rows of the BC table, i.e. the range can be used to slice it
+  std::pair<int64_t, int64_t> bcRange(uint64_t minBC, uint64_t maxBC) const
+  {
+    const int64_t first = lowerBoundBC(minBC);
+    const int64_t last = std::upper_bound(mSortedBCGlobalBCs.begin() + first, mSortedBCGlobalBCs.end(), maxBC) - mSortedBCGlobalBCs.begin();
+    return {first, std::max(first, last)};
+  }
+
+  // collisions
+  int64_t nCollisions() const { return mCollisionGlobalBCs.size(); }
+  /// Global BC of the collision with the given index, BcInvalid if it has no BC
+  uint64_t collisionGlobalBC(int64_t collisionIndex) const { return mCollisionGlobalBCs[collisionIndex]; }
+
+  /// Number of collisions with a BC, i.e. of positions in the sorted collision list
+  int64_t nSortedCollisions() const { return mSortedCollisions.size(); }
+  /// Position, in global BC order, of the first collision with global BC >= globalBC (nSortedCollisions() if none)
+  int64_t lowerBoundCollision(uint64_t globalBC) const
+  {
+    return std::lower_bound(mSortedCollisionGlobalBCs.begin(), mSortedCollisionGlobalBCs.end(), globalBC) - mSortedCollisionGlobalBCs.begin();
+  }
+  int64_t sortedCollision(int64_t pos) const { return mSortedCollisions[pos]; }
+  uint64_t sortedCollisionGlobalBC(int64_t pos) const { return mSortedCollisionGlobalBCs[pos]; }
+
+  /// Positions [first, last) in global BC order of the collisions with minBC <= global BC <= maxBC
+  std::pair<int64_t, int64_t> collisionRange(uint64_t minBC, uint64_t maxBC) const
+  {
+    const int64_t first = lowerBoundCollision(minBC);
+    const int64_t last = std::upper_bound(mSortedCollisionGlobalBCs.begin() + first, mSortedCollisionGlobalBCs.end(), maxBC) - mSortedCollisionGlobalBCs.begin();
+    return {first, std::max(first, last)};
+  }
+
+  /// Collisions of the BC row bcRow are bcCollision(i) for i in [bcCollisionsBegin(bcRow), bcCollisionsEnd(bcRow)), in table order
+  int64_t bcCollisionsBegin(int64_t bcRow) const { return mBCCollisionOffsets[bcRow]; }
+  int64_t bcCollisionsEnd(int64_t bcRow) const { return mBCCollisionOffsets[bcRow + 1]; }
+  int64_t bcCollision(int64_t i) const { return mBCCollisions[i]; }
+
+ private:
+  std::vector<uint64_t> mBCGlobalBCs;              // global BC of each BC row
+  std::vector<int64_t> mSortedBCRows;              // BC rows sorted by global BC (identity if the table is sorted)
+  std::vector<uint64_t> mSortedBCGlobalBCs;        // global BCs in sorted order
+  bool mBCsSorted = true;                          // BC table already in global BC order
+  std::vector<uint64_t> mCollisionGlobalBCs;       // global BC of each collision, BcInvalid without BC
+  std::vector<int64_t> mSortedCollisions;          // collisions with a BC sorted by global BC
+  std::vector<uint64_t> mSortedCollisionGlobalBCs; // global BCs of mSortedCollisions
+  std::vector<int64_t> mBCCollisionOffsets;        // offsets in mBCCollisions of the collisions of each BC row, size nBCs + 1
+  std::vector<int64_t> mBCCollisions;              // collisions grouped by BC row
+};
+
+} // namespace o2::common::core
+
+#endif // COMMON_CORE_BCINDEX_H_
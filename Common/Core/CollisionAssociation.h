@@ -20,6 +20,8 @@
 #ifndef COMMON_CORE_COLLISIONASSOCIATION_H_
 #define COMMON_CORE_COLLISIONASSOCIATION_H_
 
+#include "Common/Core/IndexGrouping.h"
+
 #include <CommonConstants/LHCConstants.h>
 #include <Framework/AnalysisDataModel.h>
 #include <Framework/DataTypes.h>
@@ -27,10 +29,12 @@
 
 #include <Rtypes.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <cstdlib>
-#include <memory>
+#include <functional>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -63,6 +67,7 @@ class CollisionAssociation
   void setIncludeUnassigned(bool enable = true) { mIncludeUnassigned = enable; }
   void setFillTableOfCollIdsPerTrack(bool fill = true) { mFillTableOfCollIdsPerTrack = fill; }
   void setBcWindow(int bcWindow = 115) { mBcWindowForOneSigma = bcWindow; }
+  void setNumThreads(int nThreads = 1) { mNumThreads = nThreads; }
 
   template <typename TTracks, typename Slice, typename Assoc, typename RevIndices>
   void runStandardAssoc(o2::aod::Collisions const& collisions,
@@ -132,177 +137,221 @@ class CollisionAssociation
                         Assoc& association,
                         RevIndices& reverseIndices)
   {
-    // cache globalBC and track time in BC for optimization
-    std::vector<int64_t> globalBC;
-    std::vector<int64_t> trackBCCache;
-    std::vector<std::pair<typename TTracks::iterator, typename TTracks::iterator>> trackIterationWindows; // continous regions in which we can count on increasing globalBC numbers
-    globalBC.reserve(tracks.size());
-    trackBCCache.reserve(tracks.size());
-    auto trackBegin = tracks.begin();
-    int lastCollisionId = 0;
-    if (tracks.size() > 0) {
-      lastCollisionId = trackBegin.collisionId();
+    // BC of the first ambiguous-track entry of each track not assigned to a collision, indexed by track global index
+    std::vector<int64_t> ambiguousBC;
+    if (mIncludeUnassigned) {
+      ambiguousBC.assign(tracksUnfiltered.size(), -1);
+      std::vector<bool> isAmbiguousFound(tracksUnfiltered.size(), false);
+      for (const auto& ambTrack : ambiguousTracks) {
+        int64_t trackId = -1;
+        if constexpr (isCentralBarrel) { // FIXME: to be removed as soon as it is possible to use getId<Table>() for joined tables
+          trackId = ambTrack.trackId();
+        } else {
+          trackId = ambTrack.template getId<TTracks>();
+        }
+        if (trackId < 0 || trackId >= static_cast<int64_t>(ambiguousBC.size()) || isAmbiguousFound[trackId]) {
+          continue;
+        }
+        isAmbiguousFound[trackId] = true; // only the first entry of a track is considered
+        if constexpr (isCentralBarrel) {
+          // special check to avoid crashes (in particular on some MC datasets)
+          // related to shifts in ambiguous tracks association to bc slices (off by 1) - see https://mattermost.web.cern.ch/alice/pl/g9yaaf3tn3g4pgn7c1yex9copy
+          if (ambTrack.bcIds()[0] >= bcs.size() || ambTrack.bcIds()[1] >= bcs.size()) {
+            continue;
+          }
+          if (!ambTrack.has_bc() || ambTrack.bc().size() == 0) {
+            continue;
+          }
+        }
+        ambiguousBC[trackId] = ambTrack.bc().begin().globalBC();
+      }
     }
-    auto track = trackBegin;
-    for (; track != tracks.end(); ++track) {
+
+    // cache the track quantities needed for the time compatibility, indexed by the position in the (filtered) track table
+    const std::size_t nTracks = tracks.size();
+    mTrackBC.assign(nTracks, -1);
+    mTrackTimeBC.assign(nTracks, 0);
+    mTrackTime.assign(nTracks, 0.f);
+    mTrackTimeRes.assign(nTracks, 0.f);
+    mTrackTimeResMode.assign(nTracks, TimeResNone);
+    mTrackGlobalIndex.assign(nTracks, -1);
+    std::size_t iTrack = 0;
+    for (const auto& track : tracks) {
       int64_t trackBC = -1;
       if (track.has_collision()) {
         trackBC = track.collision().bc().globalBC();
       } else if (mIncludeUnassigned) {
-        for (const auto& ambTrack : ambiguousTracks) {
-          if constexpr (isCentralBarrel) { // FIXME: to be removed as soon as it is possible to use getId<Table>() for joined tables
-            if (ambTrack.trackId() == track.globalIndex()) {
-              // special check to avoid crashes (in particular on some MC datasets)
-              // related to shifts in ambiguous tracks association to bc slices (off by 1) - see https://mattermost.web.cern.ch/alice/pl/g9yaaf3tn3g4pgn7c1yex9copy
-              if (ambTrack.bcIds()[0] >= bcs.size() || ambTrack.bcIds()[1] >= bcs.size()) {
-                break;
-              }
-              if (!ambTrack.has_bc() || ambTrack.bc().size() == 0) {
-                break;
-              }
-              trackBC = ambTrack.bc().begin().globalBC();
-              break;
-            }
-          } else {
-            if (ambTrack.template getId<TTracks>() == track.globalIndex()) {
-              trackBC = ambTrack.bc().begin().globalBC();
-              break;
-            }
-          }
-        }
+        trackBC = ambiguousBC[track.globalIndex()];
       }
-      globalBC.push_back(trackBC);
-      trackBCCache.push_back(trackBC + track.trackTime() / o2::constants::lhc::LHCBunchSpacingNS);
-      // find uniform blocks
-      if ((track.collisionId() < lastCollisionId) || (lastCollisionId < 0 && track.collisionId() >= 0)) {
-        if (lastCollisionId >= 0 || mIncludeUnassigned) {
-          LOGP(debug, "Found track block from {} to {}, current id {}, last id {}", trackBegin.filteredIndex(), track.filteredIndex() - 1, track.collisionId(), lastCollisionId);
-          trackIterationWindows.push_back(std::make_pair(trackBegin, track));
+      mTrackBC[iTrack] = trackBC;
+      mTrackTimeBC[iTrack] = trackBC + track.trackTime() / o2::constants::lhc::LHCBunchSpacingNS;
+      mTrackGlobalIndex[iTrack] = track.globalIndex();
+      mTrackTime[iTrack] = track.trackTime();
+      mTrackTimeRes[iTrack] = track.trackTimeRes();
+      if constexpr (isCentralBarrel) {
+        if (mUsePvAssociation && track.isPVContributor()) {
+          mTrackTime[iTrack] = track.collision().collisionTime(); // if PV contributor, we assume the time to be the one of the collision
+          mTrackTimeRes[iTrack] = o2::constants::lhc::LHCBunchSpacingNS; // 1 BC
+          mTrackTimeResMode[iTrack] = TimeResPvContributor;
+        } else if (TESTBIT(track.flags(), o2::aod::track::TrackTimeResIsRange)) {
+          // the track time resolution is a range, not a gaussian resolution
+          mTrackTimeResMode[iTrack] = TimeResRange;
+        } else {
+          mTrackTimeResMode[iTrack] = TimeResGaussian;
+        }
+      } else {
+        // the track is not a central track
+        if constexpr (TTracks::template contains<o2::aod::MFTTracks>()) {
+          // then the track is an MFT track, or an MFT track with additionnal joined info
+          // in this case TrackTimeResIsRange
+          mTrackTimeResMode[iTrack] = TimeResRange;
+        } else if constexpr (TTracks::template contains<o2::aod::FwdTracks>()) {
+          // the track is a fwd track, with a gaussian time resolution
+          mTrackTimeResMode[iTrack] = TimeResGaussian;
         }
-        trackBegin = track;
       }
-      lastCollisionId = track.collisionId();
-    }
-    // trackIterationWindows.push_back(std::make_pair(trackBegin, tracks.end()));
-    if (lastCollisionId >= 0 || mIncludeUnassigned) {
-      LOGP(debug, "Found track block from {} to {}", trackBegin.filteredIndex(), tracks.size() - 1);
-      trackIterationWindows.push_back(std::make_pair(trackBegin, track));
+      ++iTrack;
     }
 
-    // define vector of vectors to store indices of compatible collisions per track
-    std::vector<std::unique_ptr<std::vector<int>>> collsPerTrack(tracksUnfiltered.size());
+    // index of the tracks sorted in time: each collision only queries the tracks inside its BC window
+    mTracksSortedInTime.clear();
+    for (std::size_t i = 0; i < nTracks; ++i) {
+      if (mTrackBC[i] >= 0) {
+        mTracksSortedInTime.push_back(i);
+      }
+    }
+    std::stable_sort(mTracksSortedInTime.begin(), mTracksSortedInTime.end(), [this](int a, int b) { return mTrackTimeBC[a] < mTrackTimeBC[b]; });
 
-    // loop over collisions to find time-compatible tracks
-    int64_t bcOffsetMax = mBcWindowForOneSigma * mNumSigmaForTimeCompat + mTimeMargin / o2::constants::lhc::LHCBunchSpacingNS;
+    // cache the collision quantities
+    mCollBC.clear();
+    mCollTime.clear();
+    mCollTimeRes2.clear();
+    mCollGlobalIndex.clear();
     for (const auto& collision : collisions) {
-      const float collTime = collision.collisionTime();
-      const float collTimeRes2 = collision.collisionTimeRes() * collision.collisionTimeRes();
-      uint64_t collBC = collision.bc().globalBC();
-
-      // This is done per block to allow optimization below. Within each block the globalBC increase continously
-      for (auto& iterationWindow : trackIterationWindows) { // o2-linter: disable=const-ref-in-for-loop (iterationWindow is modified)
-        bool iteratorMoved = false;
-        const bool isAssignedTrackWindow = (iterationWindow.first != iterationWindow.second) ? iterationWindow.first.has_collision() : false;
-        for (auto trackInWindow = iterationWindow.first; trackInWindow != iterationWindow.second; ++trackInWindow) {
-          int64_t trackBC = globalBC[trackInWindow.filteredIndex()];
-          if (trackBC < 0) {
-            continue;
-          }
-
-          // Optimization to avoid looping over the full track list each time. This builds on that tracks are sorted by BCs (which they should be because collisions are sorted by BCs)
-          const int64_t bcOffset = trackBC - static_cast<int64_t>(collBC);
-          if constexpr (isCentralBarrel) {
-            // only for blocks with collision association
-            if (isAssignedTrackWindow) {
-              constexpr int margin = 200;
-              if (!iteratorMoved && bcOffset > -bcOffsetMax - margin) {
-                iterationWindow.first.setCursor(trackInWindow.filteredIndex());
-                iteratorMoved = true;
-                LOGP(debug, "Moving iterator begin {}", trackInWindow.filteredIndex());
-              } else if (bcOffset > bcOffsetMax + margin) {
-                LOGP(debug, "Stopping iterator {}", trackInWindow.filteredIndex());
-                break;
-              }
-            }
-          }
-
-          int64_t bcOffsetWindow = trackBCCache[trackInWindow.filteredIndex()] - static_cast<int64_t>(collBC);
-          if (std::abs(bcOffsetWindow) > bcOffsetMax) {
-            continue;
-          }
-
-          float trackTime = 0;
-          float trackTimeRes = 0;
-          if constexpr (isCentralBarrel) {
-            if (mUsePvAssociation && trackInWindow.isPVContributor()) {
-              trackTime = trackInWindow.collision().collisionTime(); // if PV contributor, we assume the time to be the one of the collision
-              trackTimeRes = o2::constants::lhc::LHCBunchSpacingNS;  // 1 BC
-            } else {
-              trackTime = trackInWindow.trackTime();
-              trackTimeRes = trackInWindow.trackTimeRes();
-            }
-          } else {
-            trackTime = trackInWindow.trackTime();
-            trackTimeRes = trackInWindow.trackTimeRes();
-          }
-
-          const float deltaTime = trackTime - collTime + bcOffset * o2::constants::lhc::LHCBunchSpacingNS;
-          float sigmaTimeRes2 = collTimeRes2 + trackTimeRes * trackTimeRes;
-          LOGP(debug, "collision time={}, collision time res={}, track time={}, track time res={}, bc collision={}, bc track={}, delta time={}", collTime, collision.collisionTimeRes(), trackInWindow.trackTime(), trackInWindow.trackTimeRes(), collBC, trackBC, deltaTime);
-
-          float thresholdTime = 0.;
-          if constexpr (isCentralBarrel) {
-            if (mUsePvAssociation && trackInWindow.isPVContributor()) {
-              thresholdTime = trackTimeRes;
-            } else if (TESTBIT(trackInWindow.flags(), o2::aod::track::TrackTimeResIsRange)) {
-              // the track time resolution is a range, not a gaussian resolution
-              thresholdTime = trackTimeRes + mNumSigmaForTimeCompat * std::sqrt(collTimeRes2) + mTimeMargin;
-            } else {
-              thresholdTime = mNumSigmaForTimeCompat * std::sqrt(sigmaTimeRes2) + mTimeMargin;
-            }
-          } else {
-            // the track is not a central track
-            if constexpr (TTracks::template contains<o2::aod::MFTTracks>()) {
-              // then the track is an MFT track, or an MFT track with additionnal joined info
-              // in this case TrackTimeResIsRange
-              thresholdTime = trackTimeRes + mNumSigmaForTimeCompat * std::sqrt(collTimeRes2) + mTimeMargin;
-            } else if constexpr (TTracks::template contains<o2::aod::FwdTracks>()) {
-              // the track is a fwd track, with a gaussian time resolution
-              thresholdTime = mNumSigmaForTimeCompat * std::sqrt(sigmaTimeRes2) + mTimeMargin;
-            }
-          }
+      mCollBC.push_back(collision.bc().globalBC());
+      mCollTime.push_back(collision.collisionTime());
+      mCollTimeRes2.push_back(collision.collisionTimeRes() * collision.collisionTimeRes());
+      mCollGlobalIndex.push_back(collision.globalIndex());
+    }
 
-          if (std::abs(deltaTime) < thresholdTime) {
-            const auto collIdx = collision.globalIndex();
-            const auto trackIdx = trackInWindow.globalIndex();
-            LOGP(debug, "Filling track id {} for coll id {}", trackIdx, collIdx);
-            association(collIdx, trackIdx);
-            if (mFillTableOfCollIdsPerTrack) {
-              if (collsPerTrack[trackIdx] == nullptr) {
-                collsPerTrack[trackIdx] = std::make_unique<std::vector<int>>();
-              }
-              collsPerTrack[trackIdx].get()->push_back(collIdx);
-            }
-          }
-        }
+    // find the compatible (collision, track) pairs, optionally sharding the collisions among threads
+    const int nCollisions = mCollBC.size();
+    const int nThreads = std::max(1, std::min(mNumThreads, nCollisions / mMinCollisionsPerThread));
+    std::vector<std::vector<std::pair<int, int>>> compatiblePairs(nThreads);
+    if (nThreads == 1) {
+      findCompatibleTracks(0, nCollisions, compatiblePairs[0]);
+    } else {
+      std::vector<std::thread> threads;
+      const int nCollisionsPerThread = (nCollisions + nThreads - 1) / nThreads;
+      for (int iThread = 0; iThread < nThreads; ++iThread) {
+        const int first = iThread * nCollisionsPerThread;
+        const int last = std::min(nCollisions, first + nCollisionsPerThread);
+        threads.emplace_back(&CollisionAssociation::findCompatibleTracks, this, first, last, std::ref(compatiblePairs[iThread]));
+      }
+      for (auto& thread : threads) {
+        thread.join();
       }
     }
+
+    // fill the tables in collision order (shards are contiguous in collisions)
+    auto& pairs = compatiblePairs[0];
+    for (int iThread = 1; iThread < nThreads; ++iThread) {
+      pairs.insert(pairs.end(), compatiblePairs[iThread].begin(), compatiblePairs[iThread].end());
+    }
+    for (const auto& [iColl, iTrackFound] : pairs) {
+      LOGP(debug, "Filling track id {} for coll id {}", mTrackGlobalIndex[iTrackFound], mCollGlobalIndex[iColl]);
+      association(mCollGlobalIndex[iColl], mTrackGlobalIndex[iTrackFound]);
+    }
     // create reverse index track to collisions if enabled
     if (mFillTableOfCollIdsPerTrack) {
-      std::vector<int> empty{};
+      // the pairs grouped by track keep the collision order, as the compatible collisions of each track
+      mPairsPerTrack.build(pairs.size(), [&](std::size_t i) { return static_cast<int64_t>(mTrackGlobalIndex[pairs[i].second]); });
+      const auto& pairsPerTrack = mPairsPerTrack.rows();
       for (const auto& trackUnfiltered : tracksUnfiltered) {
-
         const auto trackId = trackUnfiltered.globalIndex();
-        if (collsPerTrack[trackId] == nullptr) {
-          reverseIndices(empty);
-        } else {
-          reverseIndices(*collsPerTrack[trackId].get());
+        mCollsOfTrack.clear();
+        if (trackId < mPairsPerTrack.nParents()) {
+          for (auto i = mPairsPerTrack.begin(trackId); i < mPairsPerTrack.end(trackId); ++i) {
+            mCollsOfTrack.push_back(mCollGlobalIndex[pairs[pairsPerTrack[i]].first]);
+          }
         }
+        reverseIndices(mCollsOfTrack);
       }
     }
   }
 
  private:
+  enum TimeResMode : uint8_t {
+    TimeResNone = 0,     // no time compatibility possible
+    TimeResGaussian,     // gaussian time resolution
+    TimeResRange,        // the track time resolution is a range
+    TimeResPvContributor // PV contributor, the collision time is used
+  };
+
+  /// Finds the time-compatible tracks for the cached collisions [first, last)
+  /// Only the tracks with time BC within the maximum BC window of the collision are tested. The window is swept over the
+  /// time-sorted tracks with two pointers, which only move forward as long as the collisions are ordered in BC
+  /// \param compatiblePairs is filled with (collision position, track position) pairs, ordered by collision and then by track position
+  void findCompatibleTracks(int first, int last, std::vector<std::pair<int, int>>& compatiblePairs) const
+  {
+    const int64_t bcOffsetMax = mBcWindowForOneSigma * mNumSigmaForTimeCompat + mTimeMargin / o2::constants::lhc::LHCBunchSpacingNS;
+    std::vector<int> tracksFound;
+    const auto itLast = mTracksSortedInTime.end();
+    auto itBegin = mTracksSortedInTime.begin();
+    auto itEnd = itBegin;
+    for (int iColl = first; iColl < last; ++iColl) {
+      const int64_t collBC = mCollBC[iColl];
+      const float collTime = mCollTime[iColl];
+      const float collTimeRes2 = mCollTimeRes2[iColl];
+      const float collTimeRes = std::sqrt(collTimeRes2);
+
+      if (iColl == first || collBC < mCollBC[iColl - 1]) {
+        // first collision or collision earlier than the previous one: restart the sweep with a binary search
+        itBegin = std::lower_bound(mTracksSortedInTime.begin(), itLast, collBC - bcOffsetMax, [this](int i, int64_t bc) { return mTrackTimeBC[i] < bc; });
+        itEnd = itBegin;
+      }
+      while (itBegin != itLast && mTrackTimeBC[*itBegin] < collBC - bcOffsetMax) {
+        ++itBegin;
+      }
+      if (itEnd < itBegin) {
+        itEnd = itBegin;
+      }
+      while (itEnd != itLast && mTrackTimeBC[*itEnd] <= collBC + bcOffsetMax) {
+        ++itEnd;
+      }
+      tracksFound.clear();
+      for (auto it = itBegin; it != itEnd; ++it) {
+        const int i = *it;
+        const int64_t bcOffset = mTrackBC[i] - collBC;
+        const float trackTimeRes = mTrackTimeRes[i];
+        const float deltaTime = mTrackTime[i] - collTime + bcOffset * o2::constants::lhc::LHCBunchSpacingNS;
+
+        float thresholdTime = 0.;
+        switch (mTrackTimeResMode[i]) {
+          case TimeResPvContributor:
+            thresholdTime = trackTimeRes;
+            break;
+          case TimeResRange:
+            thresholdTime = trackTimeRes + mNumSigmaForTimeCompat * collTimeRes + mTimeMargin;
+            break;
+          case TimeResGaussian:
+            thresholdTime = mNumSigmaForTimeCompat * std::sqrt(collTimeRes2 + trackTimeRes * trackTimeRes) + mTimeMargin;
+            break;
+          default:
+            break;
+        }
+        if (std::abs(deltaTime) < thresholdTime) {
+          tracksFound.push_back(i);
+        }
+      }
+      // keep the order of the track table within each collision
+      std::sort(tracksFound.begin(), tracksFound.end());
+      for (const auto& i : tracksFound) {
+        compatiblePairs.emplace_back(iColl, i);
+      }
+    }
+  }
+
   float mNumSigmaForTimeCompat{4.};                                                  // number of sigma for time compatibility
   float mTimeMargin{500.};                                                           // additional time margin in ns
   int mTrackSelection{o2::aod::track_association::TrackSelection::GlobalTrackWoDCA}; // track selection for central barrel tracks (standard association only)
@@ -310,6 +359,25 @@ class CollisionAssociation
   bool mIncludeUnassigned{true};                                                     // include tracks that were originally not assigned to any collision
   bool mFillTableOfCollIdsPerTrack{false};                                           // fill additional table with vectors of compatible collisions per track
   int mBcWindowForOneSigma{115};                                                     // BC window to be multiplied by the number of sigmas to define maximum window to be considered
+  int mNumThreads{1};                                                                // number of threads used to find the time-compatible tracks
+  int mMinCollisionsPerThread{100};                                                  // minimum number of collisions per thread
+
+  // per data frame caches (time-based association), kept as members to reuse the allocations
+  std::vector<int64_t> mTrackBC;          // BC of the collision (or ambiguous track) the track time refers to, -1 if none
+  std::vector<int64_t> mTrackTimeBC;      // BC of the track time
+  std::vector<float> mTrackTime;          // track time (collision time for PV contributors)
+  std::vector<float> mTrackTimeRes;       // track time resolution
+  std::vector<uint8_t> mTrackTimeResMode; // how the time resolution is used, see TimeResMode
+  std::vector<int> mTrackGlobalIndex;     // track global index
+  std::vector<int> mTracksSortedInTime;   // track positions with a valid BC, sorted in mTrackTimeBC
+  std::vector<int64_t> mCollBC;           // collision BC
+  std::vector<float> mCollTime;           // collision time
+  std::vector<float> mCollTimeRes2;       // collision time resolution squared
+  std::vector<int> mCollGlobalIndex;      // collision global index
+
+  // reverse indices track to collisions (time-based association)
+  o2::common::core::IndexGrouping mPairsPerTrack; // compatible pairs grouped by track global index
+  std::vector<int> mCollsOfTrack;                 // compatible collisions of the track being written
 };
 
 #endif // COMMON_CORE_COLLISIONASSOCIATION_H_
@@ -16,3 +16,6 @@
 #pragma link C++ class ZorroHelper + ;
 #pragma link C++ class ZorroSummary + ;
 #pragma link C++ class std::vector < ZorroHelper> + ;
+
+// Version 1 of ZorroSummary stored the counters in per-run maps
+#pragma read sourceClass = "ZorroSummary" targetClass = "ZorroSummary" version = "[1]" source = "std::unordered_map<int, std::vector<ULong64_t>> mAnalysedTOIcounters; std::unordered_map<int, std::vector<double>> mTOIcounters; std::unordered_map<int, double> mTVXcounters" target = "mRunNumbers, mRunTVXcounters, mRunTOIcounters, mRunAnalysedTOIcounters" code = "{ newObj->fillFromMaps(onfile.mTVXcounters, onfile.mTOIcounters, onfile.mAnalysedTOIcounters); }"
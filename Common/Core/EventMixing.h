@@ -12,6 +12,15 @@
 #ifndef ANALYSIS_CORE_EVENTMIXING_H_
 #define ANALYSIS_CORE_EVENTMIXING_H_
 
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <numeric>
+#include <random>
+#include <span>
+#include <utility>
+#include <vector>
+
 namespace eventmixing
 {
 /// Calculate hash for an element based on 2 properties and their bins.
@@ -45,6 +54,186 @@ static int getMixingBin(const T1& vtxBins, const T1& multBins, const T2& vtx, co
   // overflow
   return -1;
 }
+
+/// Pool of past events for event mixing, organised as one ring buffer of `depth` events per mixing bin.
+/// \tparam TBinKey key of the mixing bin (e.g. the value of getMixingBin() or a tuple of bin indices)
+/// \tparam TEventKey identifier of an event (e.g. pair<data frame index, collision index>)
+/// \tparam TPayload object stored per event and per track (or candidate), copied into the pool
+/// The payloads of an event are staged with startEvent()/addPayload() and moved into its bin by commitEvent(),
+/// after the current event has been mixed with the pool, so that an event is never mixed with itself.
+/// The payload buffers of overwritten events are reused, so that a filled pool does not allocate anymore.
+template <typename TBinKey, typename TEventKey, typename TPayload>
+class MixingPool
+{
+ public:
+  MixingPool() = default;
+  explicit MixingPool(int depth) : mDepth(depth) {}
+
+  /// Number of events kept per bin, to be set before the first commitEvent()
+  void setDepth(int depth) { mDepth = depth; }
+  /// Maximum number of payloads kept in the pool, 0 = no limit. When exceeded, the oldest events of the bin being filled are released
+  void setMaxPayloads(int64_t maxPayloads) { mMaxPayloads = maxPayloads; }
+  /// Keep the pool across data frames, otherwise startDataFrame() empties it
+  void setPersistent(bool persistent) { mPersistent = persistent; }
+  /// Seed of the generator used by selectPartners(), for reproducible partner choices
+  void setSeed(uint64_t seed) { mGenerator.seed(seed); }
+
+  /// To be called at the beginning of each data frame
+  void startDataFrame()
+  {
+    mStaged.clear();
+    if (!mPersistent) {
+      clear();
+    }
+  }
+
+  void clear()
+  {
+    mBins.clear();
+    mPools.clear();
+    mStaged.clear();
+    mNPayloads = 0;
+  }
+
+  /// Starts staging the payloads of a new event, the payloads staged for a previous event which was not committed are dropped
+  void startEvent(TEventKey const& eventKey)
+  {
+    mStagedKey = eventKey;
+    mStaged.clear();
+  }
+  void addPayload(TPayload const& payload) { mStaged.push_back(payload); }
+  std::span<const TPayload> stagedPayloads() const { return {mStaged.data(), mStaged.size()}; }
+
+  /// Moves the staged event into the pool of its bin, overwriting the oldest event if the ring is full
+  void commitEvent(TBinKey const& bin)
+  {
+    if (mDepth <= 0) {
+      mStaged.clear();
+      return;
+    }
+    auto it = mBins.find(bin);
+    if (it == mBins.end()) {
+      it = mBins.emplace(bin, static_cast<int>(mPools.size())).first;
+      mPools.emplace_back();
+      mPools.back().events.reserve(mDepth);
+      mPools.back().payloads.reserve(mDepth);
+    }
+    auto& pool = mPools[it->second];
+    int slot = 0;
+    if (static_cast<int>(pool.events.size()) < mDepth) {
+      slot = pool.events.size();
+      pool.events.push_back(mStagedKey);
+      pool.payloads.emplace_back();
+    } else {
+      slot = pool.next;
+      pool.next = (pool.next + 1) % mDepth;
+      mNPayloads -= pool.payloads[slot].size();
+      pool.events[slot] = mStagedKey;
+      mNReleasedEvents++;
+    }
+    pool.payloads[slot].swap(mStaged); // the released buffer is reused for the next event
+    mStaged.clear();
+    mNPayloads += pool.payloads[slot].size();
+    if (mMaxPayloads > 0) {
+      releaseOldest(pool, slot);
+    }
+  }
+
+  /// Events of a bin in the order of the ring buffer slots, the position in the span is the slot for payloads()
+  std::span<const TEventKey> events(TBinKey const& bin) const
+  {
+    auto it = mBins.find(bin);
+    if (it == mBins.end()) {
+      return {};
+    }
+    const auto& pool = mPools[it->second];
+    return {pool.events.data(), pool.events.size()};
+  }
+  std::span<const TPayload> payloads(TBinKey const& bin, int slot) const
+  {
+    auto it = mBins.find(bin);
+    if (it == mBins.end() || slot < 0 || slot >= static_cast<int>(mPools[it->second].payloads.size())) {
+      return {};
+    }
+    const auto& payloads = mPools[it->second].payloads[slot];
+    return {payloads.data(), payloads.size()};
+  }
+
+  /// Random choice of at most nPartners distinct slots of a bin (all of them if nPartners <= 0), drawn with the seeded generator.
+  /// The span is valid until the next call
+  std::span<const int> selectPartners(TBinKey const& bin, int nPartners)
+  {
+    const int nEvents = events(bin).size();
+    mPartners.resize(nEvents);
+    std::iota(mPartners.begin(), mPartners.end(), 0);
+    if (nPartners <= 0 || nPartners >= nEvents) {
+      return {mPartners.data(), mPartners.size()};
+    }
+    for (int i = 0; i < nPartners; ++i) { // partial Fisher-Yates shuffle
+      std::uniform_int_distribution<int> pick(i, nEvents - 1);
+      std::swap(mPartners[i], mPartners[pick(mGenerator)]);
+    }
+    return {mPartners.data(), static_cast<size_t>(nPartners)};
+  }
+
+  // metrics
+  int nBins() const { return mPools.size(); }
+  int64_t nPayloads() const { return mNPayloads; }
+  int64_t nReleasedEvents() const { return mNReleasedEvents; }
+  int64_t nEvents() const
+  {
+    int64_t n = 0;
+    for (const auto& pool : mPools) {
+      n += pool.events.size();
+    }
+    return n;
+  }
+  /// Memory held by the payload buffers, including the capacity kept for reuse
+  int64_t payloadBytes() const
+  {
+    int64_t bytes = mStaged.capacity() * sizeof(TPayload);
+    for (const auto& pool : mPools) {
+      for (const auto& payloads : pool.payloads) {
+        bytes += payloads.capacity() * sizeof(TPayload);
+      }
+    }
+    return bytes;
+  }
+
+ private:
+  struct Pool {
+    std::vector<TEventKey> events;               // one per slot
+    std::vector<std::vector<TPayload>> payloads; // one contiguous array per slot
+    int next = 0;                                // slot to be overwritten (the oldest one) once the ring is full
+  };
+
+  // release the payloads of the oldest events of this bin until the ceiling is respected; the newest event is always kept
+  void releaseOldest(Pool& pool, int newest)
+  {
+    const int n = pool.events.size();
+    const int oldest = static_cast<int>(pool.events.size()) < mDepth ? 0 : pool.next;
+    for (int i = 0; i < n && mNPayloads > mMaxPayloads; ++i) {
+      const int slot = (oldest + i) % n;
+      if (slot == newest) {
+        continue;
+      }
+      mNPayloads -= pool.payloads[slot].size();
+      std::vector<TPayload>().swap(pool.payloads[slot]);
+    }
+  }
+
+  int mDepth = 0;                // number of events kept per bin
+  int64_t mMaxPayloads = 0;      // maximum number of payloads in the pool (0 = no limit)
+  bool mPersistent = false;      // keep the pool across data frames
+  std::map<TBinKey, int> mBins;  // bin -> index of its pool
+  std::vector<Pool> mPools;      // one ring buffer per bin
+  TEventKey mStagedKey{};        // event being staged
+  std::vector<TPayload> mStaged; // payloads of the event being staged
+  std::vector<int> mPartners;    // slots returned by selectPartners()
+  std::mt19937_64 mGenerator{0}; // generator of selectPartners()
+  int64_t mNPayloads = 0;        // payloads stored in the pool
+  int64_t mNReleasedEvents = 0;  // events overwritten in the rings
+};
 }; // namespace eventmixing
 
 #endif /* ANALYSIS_CORE_EVENTMIXING_H_ */
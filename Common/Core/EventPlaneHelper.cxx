@@ -61,11 +61,19 @@ double EventPlaneHelper::GetPhiFV0(int chno, o2::fv0::Geometry* fv0geom)
   return TMath::ATan2(chPos.y + offsetY, chPos.x + offsetX);
 }
 
-double EventPlaneHelper::GetPhiFT0(int chno, o2::ft0::Geometry ft0geom)
+double EventPlaneHelper::GetPhiFT0(int chno, o2::ft0::Geometry& ft0geom)
 {
   /* Calculate the azimuthal angle in FT0 for the channel number 'chno'. The offset
     of FT0-A is taken into account if chno is between 0 and 95. */
 
+  ft0geom.calculateChannelCenter();
+  return GetPhiFT0Channel(chno, ft0geom);
+}
+
+double EventPlaneHelper::GetPhiFT0Channel(int chno, o2::ft0::Geometry& ft0geom)
+{
+  /* Same as GetPhiFT0, the channel centers must have been calculated. */
+
   float offsetX = 0.;
   float offsetY = 0.; // No offset for FT0-C (default case).
 
@@ -74,14 +82,13 @@ double EventPlaneHelper::GetPhiFT0(int chno, o2::ft0::Geometry ft0geom)
     offsetY = mOffsetFT0AY;
   }
 
-  ft0geom.calculateChannelCenter();
   auto chPos = ft0geom.getChannelCenter(chno);
   /// printf("Channel id: %d X: %.3f Y: %.3f\n", chno, chPos.X(), chPos.Y());
 
   return TMath::ATan2(chPos.Y() + offsetY, chPos.X() + offsetX);
 }
 
-void EventPlaneHelper::SumQvectors(int det, int chno, float ampl, int nmod, TComplex& Qvec, float& sum, o2::ft0::Geometry ft0geom, o2::fv0::Geometry* fv0geom)
+void EventPlaneHelper::SumQvectors(int det, int chno, float ampl, int nmod, TComplex& Qvec, float& sum, o2::ft0::Geometry& ft0geom, o2::fv0::Geometry* fv0geom)
 {
   /* Calculate the complex Q-vector for the provided detector and channel number,
     before adding it to the total Q-vector given as argument. */
@@ -109,6 +116,34 @@ void EventPlaneHelper::SumQvectors(int det, int chno, float ampl, int nmod, TCom
   sum += ampl;
 }
 
+void EventPlaneHelper::GetChannelHarmonics(int det, int nChannels, int nmod, std::vector<double>& cosPhi, std::vector<double>& sinPhi, o2::ft0::Geometry& ft0geom, o2::fv0::Geometry* fv0geom)
+{
+  /* Fill the cos(n*phi) and sin(n*phi) of each channel of the provided detector, as
+    computed in SumQvectors, for the Q-vectors to be summed without geometry lookups. */
+  cosPhi.assign(nChannels, 0.);
+  sinPhi.assign(nChannels, 0.);
+  if (det == 0) {
+    ft0geom.calculateChannelCenter();
+  }
+
+  for (int chno = 0; chno < nChannels; chno++) {
+    double phi = -999.;
+    switch (det) {
+      case 0: // FT0.
+        phi = GetPhiFT0Channel(chno, ft0geom);
+        break;
+      case 1: // FV0.
+        phi = GetPhiFV0(chno, fv0geom);
+        break;
+      default:
+        printf("'int det' value does not correspond to any accepted case.\n");
+        return;
+    }
+    cosPhi[chno] = TMath::Cos(phi * nmod);
+    sinPhi[chno] = TMath::Sin(phi * nmod);
+  }
+}
+
 int EventPlaneHelper::GetCentBin(float cent)
 {
   const float centClasses[] = {0., 5., 10., 20., 30., 40., 50., 60., 80.};
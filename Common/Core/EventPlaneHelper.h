@@ -60,12 +60,18 @@ class EventPlaneHelper
   }
 
   // Methods to calculate the azimuthal angles for each part of FIT, given the channel number.
-  double GetPhiFT0(int chno, o2::ft0::Geometry ft0geom);
+  // The FT0 geometry is passed by reference, its channel centers are (re)calculated in place.
+  double GetPhiFT0(int chno, o2::ft0::Geometry& ft0geom);
   double GetPhiFV0(int chno, o2::fv0::Geometry* fv0geom);
 
   // Method to get the Q-vector and sum of amplitudes for any channel in FIT, given
   // the detector and amplitude.
-  void SumQvectors(int det, int chno, float ampl, int nmod, TComplex& Qvec, float& sum, o2::ft0::Geometry ft0geom, o2::fv0::Geometry* fv0geom);
+  void SumQvectors(int det, int chno, float ampl, int nmod, TComplex& Qvec, float& sum, o2::ft0::Geometry& ft0geom, o2::fv0::Geometry* fv0geom);
+
+  // Method to fill the cos(n*phi) and sin(n*phi) of the channels [0, nChannels) of FIT,
+  // with the azimuthal angles used in SumQvectors, so that they can be computed once per run.
+  // The FT0 channel centers are calculated once for all the channels.
+  void GetChannelHarmonics(int det, int nChannels, int nmod, std::vector<double>& cosPhi, std::vector<double>& sinPhi, o2::ft0::Geometry& ft0geom, o2::fv0::Geometry* fv0geom);
 
   // Method to get the bin corresponding to a centrality percentile, according to the
   // centClasses[] array defined in Tasks/qVectorsQA.cxx.
@@ -98,6 +104,9 @@ class EventPlaneHelper
   float GetResolution(const float RefA, const float RefB, int nmode = 2);
 
  private:
+  // Azimuthal angle of an FT0 channel, with the channel centers already calculated.
+  double GetPhiFT0Channel(int chno, o2::ft0::Geometry& ft0geom);
+
   double mOffsetFT0AX = 0.;     // X-coordinate of the offset of FT0-A.
   double mOffsetFT0AY = 0.;     // Y-coordinate of the offset of FT0-A.
   double mOffsetFT0CX = 0.;     // X-coordinate of the offset of FT0-C.
@@ -247,3 +247,51 @@ float FFitWeights::evalPt(float centr, const float& mpt)
 {
   return internalEval(centr, mpt, "sp_mpt_%i");
 };
+
+void FFitWeights::cacheQnTypes(const std::vector<std::pair<int, std::string>>& qnTypes)
+{
+  cachedQnTypes = qnTypes;
+  qnHistCache.assign(qnTypes.size(), nullptr);
+  splineCache.assign(qnTypes.size() * (NumberSp + 1), nullptr);
+  if (!fW_data) {
+    return;
+  }
+  for (std::size_t iType{0}; iType < qnTypes.size(); iType++) {
+    const auto& [nh, pf] = qnTypes[iType];
+    qnHistCache[iType] = dynamic_cast<TH2D*>(fW_data->FindObject(this->getQName(nh, pf.c_str())));
+    for (int isp{0}; isp <= NumberSp; isp++) {
+      splineCache[iType * (NumberSp + 1) + isp] = dynamic_cast<TGraph*>(fW_data->FindObject(Form("sp_q%i%s_%i", nh, pf.c_str(), isp)));
+    }
+  }
+};
+
+void FFitWeights::fillCachedWeights(int iType, float centrality, float qn)
+{
+  TH2D* th2{qnHistCache[iType]};
+  if (!th2) {
+    // the histogram is created by the filling by name
+    const auto& [nh, pf] = cachedQnTypes[iType];
+    fillWeights(centrality, qn, nh, pf.c_str());
+    if (fW_data) {
+      qnHistCache[iType] = dynamic_cast<TH2D*>(fW_data->FindObject(this->getQName(nh, pf.c_str())));
+    }
+    return;
+  }
+  th2->Fill(centrality, qn);
+};
+
+float FFitWeights::evalCached(int iType, float centr, const float& dqn)
+{
+  int isp = static_cast<int>(centr);
+  if (isp < 0 || isp > NumberSp) {
+    return -1;
+  }
+
+  auto* spline = splineCache[iType * (NumberSp + 1) + isp];
+  if (!spline) {
+    return -1;
+  }
+
+  float perc = 100.f * spline->Eval(dqn);
+  return (perc < 0 || perc > MaxTol) ? -1 : perc;
+};
@@ -19,6 +19,7 @@
 
 #include <TAxis.h>
 #include <TCollection.h>
+#include <TGraph.h>
 #include <TH2.h>
 #include <TNamed.h>
 #include <TObjArray.h>
@@ -67,6 +68,12 @@ class FFitWeights : public TNamed
   int getResolution() const { return nResolution; }
   void setQnType(const std::vector<std::pair<int, std::string>>& qninp) { qnTYPE = qninp; }
 
+  // Cache the qn histograms and splines of the given (harmonic, detector) types, to be filled and evaluated
+  // per event by their position in qnTypes instead of a lookup by name in the data array
+  void cacheQnTypes(const std::vector<std::pair<int, std::string>>& qnTypes);
+  void fillCachedWeights(int iType, float centrality, float qn);
+  float evalCached(int iType, float centr, const float& dqn);
+
   void mptSel();
 
  private:
@@ -97,6 +104,10 @@ class FFitWeights : public TNamed
 
   float internalEval(float centr, const float& val, const char* name);
 
+  std::vector<std::pair<int, std::string>> cachedQnTypes; //! (harmonic, detector) of each cached type
+  std::vector<TH2D*> qnHistCache;                         //! qn histogram of each cached type
+  std::vector<TGraph*> splineCache;                       //! spline of each cached type and centrality bin, (NumberSp + 1) per type
+
   ClassDef(FFitWeights, 1); // calibration class
 };
 #endif // COMMON_CORE_FFITWEIGHTS_H_
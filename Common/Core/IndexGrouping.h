@@ -0,0 +1,87 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file IndexGrouping.h
+/// \brief Linear-time grouping of child rows by parent index (counting sort), with the groups as offset arrays (CSR)
+
+#ifndef COMMON_CORE_INDEXGROUPING_H_
+#define COMMON_CORE_INDEXGROUPING_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace o2::common::core
+{
+
+/// Groups n child rows by their parent index (e.g. the V0s or cascades of a data frame by collisionId) in two linear passes.
+/// The rows of the parent p are rows()[i] for i in [begin(p), end(p)), in increasing row order, i.e. the grouping is stable.
+/// The rows with a negative parent index (not assigned) are grouped before parent 0, see unassignedEnd().
+/// The memory is kept across data frames.
+class IndexGrouping
+{
+ public:
+  /// \param keyOf callable returning the parent index of the row i
+  template <typename TKeyOf>
+  void build(size_t n, TKeyOf keyOf)
+  {
+    mKeys.resize(n);
+    int64_t maxKey = -1;
+    for (size_t i = 0; i < n; ++i) {
+      const int64_t key = keyOf(i);
+      mKeys[i] = key < 0 ? 0 : key + 1; // bucket 0 holds the unassigned rows
+      maxKey = std::max(maxKey, key);
+    }
+    mNParents = maxKey + 1;
+    mOffsets.assign(mNParents + 2, 0);
+    for (const auto bucket : mKeys) {
+      mOffsets[bucket + 1]++;
+    }
+    for (int64_t b = 0; b <= mNParents; ++b) {
+      mOffsets[b + 1] += mOffsets[b];
+    }
+    mRows.resize(n);
+    mFill.assign(mOffsets.begin(), mOffsets.end() - 1);
+    for (size_t i = 0; i < n; ++i) {
+      mRows[mFill[mKeys[i]]++] = i;
+    }
+  }
+
+  /// Groups the rows of a vector of structs with a collisionId member
+  template <typename T>
+  void buildByCollision(const std::vector<T>& v)
+  {
+    build(v.size(), [&v](size_t i) { return static_cast<int64_t>(v[i].collisionId); });
+  }
+
+  /// Number of parents: one past the largest parent index
+  int64_t nParents() const { return mNParents; }
+  int64_t begin(int64_t parent) const { return mOffsets[parent + 1]; }
+  int64_t end(int64_t parent) const { return mOffsets[parent + 2]; }
+  int64_t size(int64_t parent) const { return end(parent) - begin(parent); }
+  /// The unassigned rows are rows()[i] for i in [0, unassignedEnd())
+  int64_t unassignedEnd() const { return mOffsets.empty() ? 0 : mOffsets[1]; }
+
+  /// All the rows ordered by parent index, same order as a stable sort on the parent index
+  const std::vector<size_t>& rows() const { return mRows; }
+
+ private:
+  int64_t mNParents = 0;
+  std::vector<int64_t> mKeys;    // bucket of each row, parent index + 1
+  std::vector<int64_t> mOffsets; // offsets of the buckets in mRows, size nParents + 2
+  std::vector<int64_t> mFill;    // write position of each bucket while filling
+  std::vector<size_t> mRows;     // rows grouped by bucket
+};
+
+} // namespace o2::common::core
+
+#endif // COMMON_CORE_INDEXGROUPING_H_
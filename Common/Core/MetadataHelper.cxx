@@ -24,7 +24,9 @@
 #include <TSystem.h>
 
 #include <array>
+#include <map>
 #include <string>
+#include <utility>
 
 using namespace o2::common::core;
 
@@ -143,6 +145,28 @@ std::string MetadataHelper::makeMetadataLabel() const
   return label;
 }
 
+std::string MetadataHelper::resolveReconstructionPass(const std::string& reconstructionPass, bool useAnchorPassForMC) const
+{
+  if (reconstructionPass != "metadata") {
+    return reconstructionPass;
+  }
+  return get(useAnchorPassForMC && isMC() ? "AnchorPassName" : "RecoPassName");
+}
+
+const std::map<std::string, std::string>& MetadataHelper::getCcdbMetadataForPass(const std::string& reconstructionPass) const
+{
+  auto cached = mCcdbMetadataForPass.find(reconstructionPass);
+  if (cached != mCcdbMetadataForPass.end()) {
+    return cached->second;
+  }
+  std::map<std::string, std::string> metadata;
+  if (!reconstructionPass.empty()) {
+    metadata["RecoPassName"] = resolveReconstructionPass(reconstructionPass);
+    LOG(info) << "Loading CCDB for reconstruction pass (" << (reconstructionPass == "metadata" ? "from metadata" : "from provided argument") << "): " << metadata["RecoPassName"];
+  }
+  return mCcdbMetadataForPass.emplace(reconstructionPass, std::move(metadata)).first->second;
+}
+
 std::string MetadataHelper::getO2Version() const
 {
   if (!mIsInitialized) {
@@ -74,6 +74,16 @@ struct MetadataHelper {
   /// @brief Function to create a label with the metadata information, useful e.g. for histogram naming
   std::string makeMetadataLabel() const;
 
+  /// @brief Function to resolve a reconstructionPass configurable: empty stays empty, "metadata" is replaced by the pass of the metadata, anything else is kept
+  /// @param reconstructionPass the value of the configurable
+  /// @param useAnchorPassForMC if true, for MC the anchor pass is taken from the metadata instead of the reconstruction pass name
+  std::string resolveReconstructionPass(const std::string& reconstructionPass, bool useAnchorPassForMC = false) const;
+
+  /// @brief Function to get the CCDB metadata (RecoPassName) for a reconstructionPass configurable, resolved once and cached for the following runs
+  /// @param reconstructionPass the value of the configurable, see resolveReconstructionPass
+  /// @return the metadata map to pass to getSpecific/getSpecificForRun, empty if the configurable is empty
+  const std::map<std::string, std::string>& getCcdbMetadataForPass(const std::string& reconstructionPass) const;
+
   /// Function to check if a commit is included in the software tag
   /// @param commitHash the commit hash to check
   /// @return true if the commit is included in the software tag, false otherwise
@@ -82,6 +92,8 @@ struct MetadataHelper {
  private:
   std::map<std::string, std::string> mMetadata; /// < The metadata map
   bool mIsInitialized = false;                  /// < Flag to check if the metadata has been initialized
+
+  mutable std::map<std::string, std::map<std::string, std::string>> mCcdbMetadataForPass; /// < CCDB metadata for each reconstructionPass configurable asked for
 };
 
 } // namespace o2::common::core
@@ -520,6 +520,40 @@ class ExpTimes
     return GetExpectedSigma(parameters, track, track.tofSignal(), track.tofEvTimeErr());
   }
 
+  /// Coefficients of the parametrisation of the expected resolution for this mass hypothesis, constant within a run
+  struct SigmaCoefficients {
+    float dpp0 = 0.f;      /// constant term of the relative momentum resolution
+    float dpp1 = 0.f;      /// term linear in momentum
+    float dpp2MassZ = 0.f; /// term in 1/p, multiplied by M/z
+    float tofRes2 = 0.f;   /// squared multiple scattering term
+    float timeRes2 = 0.f;  /// squared intrinsic time resolution
+  };
+
+  /// Gets the coefficients of the parametrisation used by GetExpectedSigma for this mass hypothesis
+  /// \param parameters Detector response parameters
+  template <typename ParamType>
+  static SigmaCoefficients GetSigmaCoefficients(const ParamType& parameters)
+  {
+    constexpr int offset = id <= o2::track::PID::Pion ? 0 : (id == o2::track::PID::Kaon ? 5 : 9);
+    return SigmaCoefficients{parameters[offset], parameters[offset + 1], parameters[offset + 2] * mMassZ,
+                             parameters[offset + 3] * parameters[offset + 3], parameters[4] * parameters[4]};
+  }
+
+  /// Gets the expected resolution of the t-texp-t0 from the precomputed coefficients, same as GetExpectedSigma without branches, to be used in loops on track columns
+  /// \param coefficients Coefficients of the parametrisation, from GetSigmaCoefficients
+  /// \param reso Resolution from the parametrisation in momentum and eta (getResolution), used if positive
+  /// \param mom Momentum of the track
+  /// \param tofSignal TOF signal of the track of interest
+  /// \param collisionTimeRes Collision time resolution of the track of interest
+  static float GetExpectedSigma(const SigmaCoefficients& coefficients, const float reso, const float mom, const float tofSignal, const float collisionTimeRes)
+  {
+    const float dpp = coefficients.dpp0 + coefficients.dpp1 * mom + coefficients.dpp2MassZ / mom;
+    const float sigma = dpp * tofSignal / (1. + mom * mom / (mMassZSqared));
+    const float sigmaParam = std::sqrt(sigma * sigma + coefficients.tofRes2 / mom / mom + coefficients.timeRes2 + collisionTimeRes * collisionTimeRes);
+    const float sigmaReso = std::sqrt(reso * reso + coefficients.timeRes2 + collisionTimeRes * collisionTimeRes);
+    return mom <= 0 ? -999.f : (reso > 0 ? sigmaReso : sigmaParam);
+  }
+
   /// Gets the expected resolution of the time measurement, uses the expected time and no event time resolution
   /// \param parameters Parameters to use to compute the expected resolution
   /// \param track Track of interest
@@ -79,11 +79,7 @@ void o2::pid::tof::TOFResponseImpl::initSetup(o2::ccdb::BasicCCDBManager* ccdb,
   // Then the information about the metadata
   if (mReconstructionPass == "metadata") {
     LOG(info) << "Getting pass from metadata";
-    if (metadataInfo.isMC()) {
-      mReconstructionPass = metadataInfo.get("AnchorPassName");
-    } else {
-      mReconstructionPass = metadataInfo.get("RecoPassName");
-    }
+    mReconstructionPass = metadataInfo.resolveReconstructionPass(mReconstructionPass, true);
     LOG(info) << "Passed autodetect mode for pass. Taking '" << mReconstructionPass << "'";
   }
   LOG(info) << "Using parameter collection, starting from pass '" << mReconstructionPass << "'";
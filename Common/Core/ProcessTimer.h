@@ -0,0 +1,109 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file ProcessTimer.h
+/// \brief Scoped wall and CPU time measurement of the process functions of a task, accumulated in histograms
+///        of the task registry and written with the task output at the end of the stream
+
+#ifndef COMMON_CORE_PROCESSTIMER_H_
+#define COMMON_CORE_PROCESSTIMER_H_
+
+#include <Framework/HistogramRegistry.h>
+#include <Framework/HistogramSpec.h>
+
+#include <TH1.h>
+
+#include <chrono>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace o2::common::core
+{
+
+/// Timing of named sections of a task, e.g. its process functions, with one bin per section in three histograms:
+/// the number of calls and the total wall and CPU times in microseconds, the mean time per call being the ratio of the bins.
+/// The CPU time is the one of the whole process (std::clock), i.e. of the task for a single-threaded device.
+/// Usage:
+///   o2::common::core::ProcessTimer timer;             // task member
+///   timer.init(histos, {"processData", "processMc"}); // in init(), e.g. only if a configurable asks for it
+///   auto timerScope = timer.scope(0);                 // first line of processData(), stops at any return
+/// The scopes of a timer without init() do not read the clocks.
+class ProcessTimer
+{
+ public:
+  /// Measures the time between its construction and its destruction
+  class Scope
+  {
+   public:
+    Scope(ProcessTimer& timer, int section) : mTimer(timer), mSection(section)
+    {
+      if (mTimer.isEnabled()) {
+        mWallStart = std::chrono::steady_clock::now();
+        mCpuStart = std::clock();
+      }
+    }
+    ~Scope()
+    {
+      if (mTimer.isEnabled()) {
+        const double wallTime = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - mWallStart).count();
+        const double cpuTime = 1.e6 * (std::clock() - mCpuStart) / CLOCKS_PER_SEC;
+        mTimer.add(mSection, wallTime, cpuTime);
+      }
+    }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    ProcessTimer& mTimer;
+    int mSection;
+    std::chrono::steady_clock::time_point mWallStart;
+    std::clock_t mCpuStart{0};
+  };
+
+  /// Adds the histograms folder/hCalls, folder/hWallTime and folder/hCpuTime with one bin per section name
+  void init(o2::framework::HistogramRegistry& registry, std::vector<std::string> const& sections, std::string const& folder = "processTimer")
+  {
+    const int nSections = sections.size();
+    const o2::framework::AxisSpec axisSections{nSections, 0, static_cast<double>(nSections), ""};
+    mCalls = registry.add<TH1>((folder + "/hCalls").c_str(), "number of calls;;calls", o2::framework::HistType::kTH1D, {axisSections});
+    mWallTime = registry.add<TH1>((folder + "/hWallTime").c_str(), "total wall time;;time (#mus)", o2::framework::HistType::kTH1D, {axisSections});
+    mCpuTime = registry.add<TH1>((folder + "/hCpuTime").c_str(), "total CPU time;;time (#mus)", o2::framework::HistType::kTH1D, {axisSections});
+    for (int iSection = 0; iSection < nSections; ++iSection) {
+      for (const auto& histogram : {mCalls, mWallTime, mCpuTime}) {
+        histogram->GetXaxis()->SetBinLabel(iSection + 1, sections[iSection].c_str());
+      }
+    }
+  }
+
+  bool isEnabled() const { return mCalls != nullptr; }
+
+  /// Timer of the section, to be kept in a local variable until the end of the measured scope
+  [[nodiscard]] Scope scope(int section) { return Scope(*this, section); }
+
+  /// Adds a measurement of the section, in microseconds
+  void add(int section, double wallTime, double cpuTime)
+  {
+    mCalls->Fill(section + 0.5);
+    mWallTime->Fill(section + 0.5, wallTime);
+    mCpuTime->Fill(section + 0.5, cpuTime);
+  }
+
+ private:
+  std::shared_ptr<TH1> mCalls;    // number of calls of each section
+  std::shared_ptr<TH1> mWallTime; // total wall time of each section
+  std::shared_ptr<TH1> mCpuTime;  // total CPU time of each section
+};
+
+} // namespace o2::common::core
+
+#endif // COMMON_CORE_PROCESSTIMER_H_
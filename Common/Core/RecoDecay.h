@@ -22,15 +22,17 @@
 #include <TMCProcess.h> // for VMC Particle Production Process
 #include <TPDGCode.h>   // for PDG codes
 
-#include <algorithm>   // std::find
-#include <array>       // std::array
-#include <cmath>       // std::abs, std::sqrt
-#include <cstddef>     // std::size_t
-#include <cstdint>     // intX_t
-#include <tuple>       // std::apply
-#include <type_traits> // std::decay_t
-#include <utility>     // std::move
-#include <vector>      // std::vector
+#include <algorithm>     // std::find
+#include <array>         // std::array
+#include <cmath>         // std::abs, std::sqrt
+#include <cstddef>       // std::size_t
+#include <cstdint>       // intX_t
+#include <functional>    // std::hash
+#include <tuple>         // std::apply
+#include <type_traits>   // std::decay_t
+#include <unordered_map> // std::unordered_map
+#include <utility>       // std::move, std::pair
+#include <vector>        // std::vector
 
 /// Base class for calculating properties of reconstructed decays
 ///
@@ -540,6 +542,207 @@ struct RecoDecay {
     return maxNormDeltaIP;
   }
 
+  /// Flattened MC particle tree of a data frame, for the MC matching functions
+  ///
+  /// It is built once per data frame from the McParticles table and passed to getMother, getMatchedMCRec and isMatchedMCGen,
+  /// which then walk plain arrays of PDG codes and mother/daughter index ranges instead of creating table iterators.
+  /// The results of the mother search are memoised per particle and searched PDG code,
+  /// since the same MC particle is matched for many candidates and mass hypotheses.
+  /// \note The index has to be rebuilt (build) for each new McParticles table.
+  class McAncestryIndex
+  {
+   public:
+    /// Fills the index from a table of MC particles
+    /// \param particlesMC  table with MC particles
+    template <typename T>
+    void build(const T& particlesMC)
+    {
+      clear();
+      mOffset = particlesMC.offset();
+      const auto nParticles = particlesMC.size();
+      mPdg.reserve(nParticles);
+      mProcess.reserve(nParticles);
+      mMotherFirst.reserve(nParticles);
+      mMotherLast.reserve(nParticles);
+      mHasDaughters.reserve(nParticles);
+      mDaughterFirst.reserve(nParticles);
+      mDaughterLast.reserve(nParticles);
+      for (const auto& particle : particlesMC) {
+        mPdg.push_back(particle.pdgCode());
+        mProcess.push_back(particle.getProcess());
+        if (particle.has_mothers()) {
+          mMotherFirst.push_back(particle.mothersIds().front());
+          mMotherLast.push_back(particle.mothersIds().back());
+        } else { // empty range
+          mMotherFirst.push_back(0);
+          mMotherLast.push_back(-1);
+        }
+        mHasDaughters.push_back(particle.has_daughters());
+        mDaughterFirst.push_back(particle.has_daughters() ? particle.daughtersIds().front() : 0);
+        mDaughterLast.push_back(particle.has_daughters() ? particle.daughtersIds().back() : -1);
+      }
+    }
+
+    void clear()
+    {
+      mOffset = 0;
+      mPdg.clear();
+      mProcess.clear();
+      mMotherFirst.clear();
+      mMotherLast.clear();
+      mHasDaughters.clear();
+      mDaughterFirst.clear();
+      mDaughterLast.clear();
+      mMothers.clear();
+    }
+
+    std::size_t size() const { return mPdg.size(); }
+    int pdgCode(int64_t index) const { return mPdg[index - mOffset]; }
+    bool hasDaughters(int64_t index) const { return mHasDaughters[index - mOffset]; }
+    int64_t daughterFirst(int64_t index) const { return mDaughterFirst[index - mOffset]; }
+    int64_t daughterLast(int64_t index) const { return mDaughterLast[index - mOffset]; }
+
+    /// Same as RecoDecay::getMother, without the flavour-oscillation correction of the sign, which depends on the original particle
+    /// \param indexParticle  global index of the MC particle
+    /// \param pdgMother  expected mother PDG code
+    /// \param acceptAntiParticles  switch to accept the antiparticle of the expected mother
+    /// \param sign  antiparticle indicator of the found mother w.r.t. pdgMother; 1 if particle, -1 if antiparticle, 0 if mother not found
+    /// \param depthMax  maximum decay tree level to check; Mothers up to this level will be considered. If -1, all levels are considered.
+    /// \return index of the mother particle if found, -1 otherwise
+    int getMother(int64_t indexParticle, int pdgMother, bool acceptAntiParticles = false, int8_t* sign = nullptr, int8_t depthMax = -1)
+    {
+      const MotherKey key{indexParticle, pdgMother, acceptAntiParticles, depthMax};
+      auto itMother = mMothers.find(key);
+      if (itMother == mMothers.end()) {
+        itMother = mMothers.emplace(key, findMother(indexParticle, pdgMother, acceptAntiParticles, depthMax)).first;
+      }
+      if (sign) {
+        *sign = itMother->second.second;
+      }
+      return itMother->second.first;
+    }
+
+    /// Same as RecoDecay::getDaughters
+    /// \param indexParticle  global index of the MC particle
+    /// \param list  vector where the indices of final-state daughters will be added
+    /// \param arrPdgFinal  array of PDG codes of particles to be considered final if found
+    /// \param depthMax  maximum decay tree level; Daughters at this level (or beyond) will be considered final. If -1, all levels are considered.
+    /// \param stage  decay tree level; If different from 0, the particle itself will be added in the list in case it has no daughters.
+    template <bool checkProcess = false, std::size_t N>
+    void getDaughters(int64_t indexParticle,
+                      std::vector<int>* list,
+                      const std::array<int, N>& arrPdgFinal,
+                      int8_t depthMax = -1,
+                      int8_t stage = 0) const
+    {
+      if (!list) {
+        return;
+      }
+      const int64_t iLocal = indexParticle - mOffset;
+      if constexpr (checkProcess) {
+        if (stage != 0 && mProcess[iLocal] != TMCProcess::kPDecay && mProcess[iLocal] != TMCProcess::kPPrimary) {
+          return;
+        }
+      }
+      bool isFinal = depthMax > -1 && stage >= depthMax;
+      if (!isFinal && !mHasDaughters[iLocal]) {
+        if (stage == 0) {
+          return;
+        }
+        isFinal = true;
+      }
+      if (!isFinal && stage > 0) {
+        const int pdgParticle = std::abs(mPdg[iLocal]);
+        for (auto pdgI : arrPdgFinal) { // o2-linter: disable=const-ref-in-for-loop (int elements)
+          if (pdgParticle == std::abs(pdgI)) {
+            isFinal = true;
+            break;
+          }
+        }
+      }
+      if (isFinal) {
+        list->push_back(indexParticle);
+        return;
+      }
+      stage++;
+      for (int64_t iDaughter = mDaughterFirst[iLocal]; iDaughter <= mDaughterLast[iLocal]; ++iDaughter) {
+        getDaughters<checkProcess>(iDaughter, list, arrPdgFinal, depthMax, stage);
+      }
+    }
+
+   private:
+    struct MotherKey {
+      int64_t index;
+      int pdgMother;
+      bool acceptAntiParticles;
+      int8_t depthMax;
+      bool operator==(const MotherKey& other) const { return index == other.index && pdgMother == other.pdgMother && acceptAntiParticles == other.acceptAntiParticles && depthMax == other.depthMax; }
+    };
+    struct MotherKeyHash {
+      std::size_t operator()(const MotherKey& key) const
+      {
+        return std::hash<int64_t>{}(key.index) ^ (std::hash<int>{}(key.pdgMother) << 1) ^ (static_cast<std::size_t>(key.acceptAntiParticles) << 2) ^ (static_cast<std::size_t>(static_cast<uint8_t>(key.depthMax)) << 3);
+      }
+    };
+
+    // breadth-first search of the mother chain, as in RecoDecay::getMother
+    std::pair<int, int8_t> findMother(int64_t indexParticle, int pdgMother, bool acceptAntiParticles, int8_t depthMax)
+    {
+      int8_t sgn = 0;
+      int indexMother = -1;
+      int stage = 0;
+      bool motherFound = false;
+      mStage.assign(1, indexParticle);
+      while (!motherFound && !mStage.empty() && (depthMax < 0 || stage < depthMax)) {
+        mNextStage.clear();
+        for (auto iPart : mStage) { // o2-linter: disable=const-ref-in-for-loop (int elements)
+          const int64_t iLocal = iPart - mOffset;
+          for (auto iMother = mMotherFirst[iLocal]; iMother <= mMotherLast[iLocal]; ++iMother) {
+            if (std::find(mNextStage.begin(), mNextStage.end(), iMother) != mNextStage.end()) {
+              continue;
+            }
+            const int pdgParticleIMother = mPdg[iMother - mOffset];
+            if (pdgParticleIMother == pdgMother) {
+              sgn = 1;
+              indexMother = iMother;
+              motherFound = true;
+              break;
+            } else if (acceptAntiParticles && pdgParticleIMother == -pdgMother) {
+              sgn = -1;
+              indexMother = iMother;
+              motherFound = true;
+              break;
+            }
+            mNextStage.push_back(iMother);
+          }
+        }
+        mStage.swap(mNextStage);
+        stage++;
+      }
+      return {indexMother, sgn};
+    }
+
+    int64_t mOffset = 0;                 // offset of the MC particle table
+    std::vector<int> mPdg;               // PDG code
+    std::vector<int> mProcess;           // production process
+    std::vector<int64_t> mMotherFirst;   // first mother (empty range if no mothers)
+    std::vector<int64_t> mMotherLast;    // last mother
+    std::vector<bool> mHasDaughters;     // whether the particle has daughters
+    std::vector<int64_t> mDaughterFirst; // first daughter
+    std::vector<int64_t> mDaughterLast;  // last daughter
+    std::vector<int64_t> mStage;         // mothers of the current stage in the mother search
+    std::vector<int64_t> mNextStage;     // mothers of the next stage in the mother search
+    std::unordered_map<MotherKey, std::pair<int, int8_t>, MotherKeyHash> mMothers; // memoised results of getMother: index and sign of the mother
+  };
+
+  /// Buffers reused by the MC matching functions, to avoid allocating them at each call
+  /// One instance per task (and per thread) is enough, the buffers are only used during a call.
+  struct McMatchingScratch {
+    std::vector<int64_t> mothersStage;     // mother indices of the current stage of the mother search
+    std::vector<int64_t> mothersNextStage; // mother indices of the next stage of the mother search
+    std::vector<int> daughters;            // indices of the final daughters
+  };
+
   /// Finds the mother of an MC particle by looking for the expected PDG code in the mother chain.
   /// \tparam acceptFlavourOscillation  switch to accept decays where the mother oscillated (e.g. B0 -> B0bar)
   /// \param particlesMC  table with MC particles
@@ -548,6 +751,8 @@ struct RecoDecay {
   /// \param acceptAntiParticles  switch to accept the antiparticle of the expected mother
   /// \param sign  antiparticle indicator of the found mother w.r.t. pdgMother; 1 if particle, -1 if antiparticle, 0 if mother not found
   /// \param depthMax  maximum decay tree level to check; Mothers up to this level will be considered. If -1, all levels are considered.
+  /// \param ancestry  optional MC ancestry index of particlesMC, used instead of walking the table
+  /// \param scratch  optional buffers reused between calls
   /// \return index of the mother particle if found, -1 otherwise
   template <bool acceptFlavourOscillation = false, typename T>
   static int getMother(const T& particlesMC,
@@ -555,8 +760,23 @@ struct RecoDecay {
                        int pdgMother,
                        bool acceptAntiParticles = false,
                        int8_t* sign = nullptr,
-                       int8_t depthMax = -1)
-  {
+                       int8_t depthMax = -1,
+                       McAncestryIndex* ancestry = nullptr,
+                       McMatchingScratch* scratch = nullptr)
+  {
+    if (ancestry) {
+      int8_t sgn = 0;
+      const int indexMother = ancestry->getMother(particle.globalIndex(), pdgMother, acceptAntiParticles, &sgn, depthMax);
+      if (sign) {
+        if constexpr (acceptFlavourOscillation) {
+          if (std::abs(particle.getGenStatusCode()) == StatusCodeAfterFlavourOscillation) { // take possible flavour oscillation of B0(s) mother into account
+            sgn *= -1;
+          }
+        }
+        *sign = sgn;
+      }
+      return indexMother;
+    }
     int8_t sgn = 0;           // 1 if the expected mother is particle, -1 if antiparticle (w.r.t. pdgMother)
     int indexMother = -1;     // index of the final matched mother, if found
     int stage = 0;            // mother tree level (just for debugging)
@@ -565,15 +785,17 @@ struct RecoDecay {
       *sign = sgn;
     }
 
-    // vector of vectors with mother indices; each line corresponds to a "stage"
-    std::vector<std::vector<int64_t>> arrayIds{};
-    std::vector<int64_t> initVec{particle.globalIndex()};
-    arrayIds.push_back(initVec); // the first vector contains the index of the original particle
+    // vectors with mother indices of the previous and of the current "stage"
+    std::vector<int64_t> arrayIdsLocal{};
+    std::vector<int64_t> arrayIdsStageLocal{};
+    std::vector<int64_t>& arrayIds = scratch ? scratch->mothersStage : arrayIdsLocal;
+    std::vector<int64_t>& arrayIdsStage = scratch ? scratch->mothersNextStage : arrayIdsStageLocal;
+    arrayIds.assign(1, particle.globalIndex()); // the first stage contains the index of the original particle
 
-    while (!motherFound && arrayIds[-stage].size() > 0 && (depthMax < 0 || -stage < depthMax)) {
+    while (!motherFound && arrayIds.size() > 0 && (depthMax < 0 || -stage < depthMax)) {
       // vector of mother indices for the current stage
-      std::vector<int64_t> arrayIdsStage{};
-      for (auto iPart : arrayIds[-stage]) { // check all the particles that were the mothers at the previous stage, o2-linter: disable=const-ref-in-for-loop (int elements)
+      arrayIdsStage.clear();
+      for (auto iPart : arrayIds) { // check all the particles that were the mothers at the previous stage, o2-linter: disable=const-ref-in-for-loop (int elements)
         auto particleMother = particlesMC.rawIteratorAt(iPart - particlesMC.offset());
         if (particleMother.has_mothers()) {
           for (auto iMother = particleMother.mothersIds().front(); iMother <= particleMother.mothersIds().back(); ++iMother) { // loop over the mother particles of the analysed particle
@@ -603,8 +825,8 @@ struct RecoDecay {
           }
         }
       }
-      // add vector of mother indices for the current stage
-      arrayIds.push_back(arrayIdsStage);
+      // the mothers of the current stage are checked at the next one
+      arrayIds.swap(arrayIdsStage);
       stage--;
     }
     if (sign) {
@@ -708,6 +930,8 @@ struct RecoDecay {
   /// \param nPiToMu  number of pion prongs decayed to a muon
   /// \param nKaToPi  number of kaon prongs decayed to a pion
   /// \param nInteractionsWithMaterial  number of daughter particles that interacted with material
+  /// \param ancestry  optional MC ancestry index of particlesMC, used instead of walking the table
+  /// \param scratch  optional buffers reused between calls
   /// \return index of the mother particle if the mother and daughters are correct, -1 otherwise
   template <bool acceptFlavourOscillation = false, bool checkProcess = false, bool acceptIncompleteReco = false, bool acceptTrackDecay = false, bool acceptTrackIntWithMaterial = false, std::size_t N, typename T, typename U>
   static int getMatchedMCRec(const T& particlesMC,
@@ -719,7 +943,9 @@ struct RecoDecay {
                              int depthMax = 1,
                              int8_t* nPiToMu = nullptr,
                              int8_t* nKaToPi = nullptr,
-                             int8_t* nInteractionsWithMaterial = nullptr)
+                             int8_t* nInteractionsWithMaterial = nullptr,
+                             McAncestryIndex* ancestry = nullptr,
+                             McMatchingScratch* scratch = nullptr)
   {
     // Printf("MC Rec: Expected mother PDG: %d", pdgMother);
     int8_t coefFlavourOscillation = 1;         // 1 if no B0(s) flavour oscillation occured, -1 else
@@ -728,7 +954,9 @@ struct RecoDecay {
     int8_t nKaToPiLocal = 0;                   // number of kaon prongs decayed to a pion
     int8_t nInteractionsWithMaterialLocal = 0; // number of interactions with material
     int indexMother = -1;                      // index of the mother particle
-    std::vector<int> arrAllDaughtersIndex;     // vector of indices of all daughters of the mother of the first provided daughter
+    std::vector<int> arrAllDaughtersIndexLocal;
+    std::vector<int>& arrAllDaughtersIndex = scratch ? scratch->daughters : arrAllDaughtersIndexLocal; // vector of indices of all daughters of the mother of the first provided daughter
+    arrAllDaughtersIndex.clear();
     std::array<int, N> arrDaughtersIndex;      // array of indices of provided daughters
     if (sign) {
       *sign = sgn;
@@ -794,7 +1022,7 @@ struct RecoDecay {
       if (iProng == 0) {
         // Get the mother index and its sign.
         // PDG code of the first daughter's mother determines whether the expected mother is a particle or antiparticle.
-        indexMother = getMother(particlesMC, particleI, pdgMother, acceptAntiParticles, &sgn, depthMax);
+        indexMother = getMother(particlesMC, particleI, pdgMother, acceptAntiParticles, &sgn, depthMax, ancestry, scratch);
         // Check whether mother was found.
         if (indexMother <= -1) {
           // Printf("MC Rec: Rejected: bad mother index or PDG");
@@ -815,7 +1043,11 @@ struct RecoDecay {
           }
         }
         // Get the list of actual final daughters.
-        getDaughters<checkProcess>(particleMother, &arrAllDaughtersIndex, arrPdgDaughters, depthMax);
+        if (ancestry) {
+          ancestry->getDaughters<checkProcess>(indexMother, &arrAllDaughtersIndex, arrPdgDaughters, depthMax);
+        } else {
+          getDaughters<checkProcess>(particleMother, &arrAllDaughtersIndex, arrPdgDaughters, depthMax);
+        }
         // printf("MC Rec: Mother %d has %d final daughters:", indexMother, arrAllDaughtersIndex.size());
         // for (auto i : arrAllDaughtersIndex) {
         //   printf(" %d", i);
@@ -908,6 +1140,8 @@ struct RecoDecay {
   /// \param sign  antiparticle indicator of the candidate w.r.t. pdgParticle; 1 if particle, -1 if antiparticle, 0 if not matched
   /// \param depthMax  maximum decay tree level to check; Daughters up to this level will be considered. If -1, all levels are considered.
   /// \param listIndexDaughters  vector of indices of found daughter
+  /// \param ancestry  optional MC ancestry index of particlesMC, used instead of walking the table
+  /// \param scratch  optional buffers reused between calls
   /// \return true if PDG codes of the particle and its daughters are correct, false otherwise
   template <bool acceptFlavourOscillation = false, bool checkProcess = false, std::size_t N, typename T, typename U>
   static bool isMatchedMCGen(const T& particlesMC,
@@ -917,7 +1151,9 @@ struct RecoDecay {
                              bool acceptAntiParticles = false,
                              int8_t* sign = nullptr,
                              int depthMax = 1,
-                             std::vector<int>* listIndexDaughters = nullptr)
+                             std::vector<int>* listIndexDaughters = nullptr,
+                             McAncestryIndex* ancestry = nullptr,
+                             McMatchingScratch* scratch = nullptr)
   {
     // Printf("MC Gen: Expected particle PDG: %d", pdgParticle);
     int8_t coefFlavourOscillation = 1; // 1 if no B0(s) flavour oscillation occured, -1 else
@@ -939,7 +1175,9 @@ struct RecoDecay {
     // Check the PDG codes of the decay products.
     if (N > 0) {
       // Printf("MC Gen: Checking %d daughters", N);
-      std::vector<int> arrAllDaughtersIndex; // vector of indices of all daughters
+      std::vector<int> arrAllDaughtersIndexLocal;
+      std::vector<int>& arrAllDaughtersIndex = scratch ? scratch->daughters : arrAllDaughtersIndexLocal; // vector of indices of all daughters
+      arrAllDaughtersIndex.clear();
       // Check the daughter indices.
       if (!candidate.has_daughters()) {
         // Printf("MC Gen: Rejected: bad daughter index range: %d-%d", candidate.daughtersIds().front(), candidate.daughtersIds().back());
@@ -953,7 +1191,11 @@ struct RecoDecay {
         }
       }
       // Get the list of actual final daughters.
-      getDaughters<checkProcess>(candidate, &arrAllDaughtersIndex, arrPdgDaughters, depthMax);
+      if (ancestry) {
+        ancestry->getDaughters<checkProcess>(candidate.globalIndex(), &arrAllDaughtersIndex, arrPdgDaughters, depthMax);
+      } else {
+        getDaughters<checkProcess>(candidate, &arrAllDaughtersIndex, arrPdgDaughters, depthMax);
+      }
       // printf("MC Gen: Mother %ld has %ld final daughters:", candidate.globalIndex(), arrAllDaughtersIndex.size());
       // for (auto i : arrAllDaughtersIndex) {
       //   printf(" %d", i);
@@ -975,9 +1217,9 @@ struct RecoDecay {
         }
       }
       // Check daughters' PDG codes.
-      for (auto indexDaughterI : arrAllDaughtersIndex) {                                            // o2-linter: disable=const-ref-in-for-loop (int elements)
-        auto candidateDaughterI = particlesMC.rawIteratorAt(indexDaughterI - particlesMC.offset()); // ith daughter particle
-        auto pdgCandidateDaughterI = candidateDaughterI.pdgCode();                                  // PDG code of the ith daughter
+      for (auto indexDaughterI : arrAllDaughtersIndex) { // o2-linter: disable=const-ref-in-for-loop (int elements)
+        // PDG code of the ith daughter
+        auto pdgCandidateDaughterI = ancestry ? ancestry->pdgCode(indexDaughterI) : particlesMC.rawIteratorAt(indexDaughterI - particlesMC.offset()).pdgCode();
         // Printf("MC Gen: Daughter %d PDG: %d", indexDaughterI, pdgCandidateDaughterI);
         bool isPdgFound = false; // Is the PDG code of this daughter among the remaining expected PDG codes?
         for (std::size_t iProngCp = 0; iProngCp < N; ++iProngCp) {
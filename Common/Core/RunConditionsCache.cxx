@@ -0,0 +1,111 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   RunConditionsCache.cxx
+/// \brief  Process-wide cache of the per-run CCDB objects
+///
+
+#include "Common/Core/RunConditionsCache.h"
+
+#include <CCDB/BasicCCDBManager.h>
+#include <Framework/Logger.h>
+
+#include <TROOT.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace o2::common::core;
+
+RunConditionsCache& RunConditionsCache::instance()
+{
+  static RunConditionsCache cache;
+  return cache;
+}
+
+std::shared_future<std::shared_ptr<void>> RunConditionsCache::request(const std::string& key, int runNumber, Loader loader, std::launch policy)
+{
+  std::vector<std::shared_future<std::shared_ptr<void>>> evicted; // released outside of the lock, as it may wait for a running prefetch
+  std::shared_future<std::shared_ptr<void>> result;
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto it = mObjects.find({runNumber, key});
+    if (it != mObjects.end()) {
+      return it->second;
+    }
+    if (std::find(mRuns.begin(), mRuns.end(), runNumber) == mRuns.end()) {
+      mRuns.push_back(runNumber);
+      evictOldRuns(evicted);
+    }
+    if (policy == std::launch::async) {
+      static std::once_flag rootThreadSafety;
+      std::call_once(rootThreadSafety, []() { ROOT::EnableThreadSafety(); }); // objects are deserialised in the background threads
+    }
+    LOG(debug) << "RunConditionsCache: " << (policy == std::launch::async ? "prefetching " : "loading ") << key << " for run " << runNumber;
+    result = std::async(policy, std::move(loader)).share();
+    mObjects.emplace(std::make_pair(runNumber, key), result);
+  }
+  return result;
+}
+
+bool RunConditionsCache::contains(const std::string& key, int runNumber)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mObjects.find({runNumber, key}) != mObjects.end();
+}
+
+void RunConditionsCache::setMaxRuns(int maxRuns)
+{
+  std::vector<std::shared_future<std::shared_ptr<void>>> evicted;
+  std::lock_guard<std::mutex> lock(mMutex);
+  mMaxRuns = std::max(maxRuns, 1);
+  evictOldRuns(evicted);
+}
+
+void RunConditionsCache::clear()
+{
+  std::vector<std::shared_future<std::shared_ptr<void>>> evicted;
+  std::lock_guard<std::mutex> lock(mMutex);
+  for (auto& [id, object] : mObjects) {
+    evicted.push_back(std::move(object));
+  }
+  mObjects.clear();
+  mRuns.clear();
+}
+
+void RunConditionsCache::evictOldRuns(std::vector<std::shared_future<std::shared_ptr<void>>>& evicted)
+{
+  while (static_cast<int>(mRuns.size()) > mMaxRuns) {
+    int run = mRuns.front();
+    mRuns.pop_front();
+    for (auto it = mObjects.begin(); it != mObjects.end();) {
+      if (it->first.first == run) {
+        evicted.push_back(std::move(it->second));
+        it = mObjects.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    LOG(debug) << "RunConditionsCache: released the objects of run " << run;
+  }
+}
+
+std::pair<std::string, int64_t> RunConditionsCache::getSettings(o2::ccdb::BasicCCDBManager* ccdb)
+{
+  return {ccdb->getURL(), ccdb->getCreatedNotAfter()};
+}
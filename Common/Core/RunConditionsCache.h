@@ -0,0 +1,106 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file RunConditionsCache.h
+/// \brief Process-wide cache of the per-run CCDB objects shared by the helpers of different tasks (Zorro, ctpRateFetcher, ...)
+
+#ifndef COMMON_CORE_RUNCONDITIONSCACHE_H_
+#define COMMON_CORE_RUNCONDITIONSCACHE_H_
+
+#include <CCDB/CcdbApi.h>
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace o2::ccdb
+{
+class BasicCCDBManager;
+} // namespace o2::ccdb
+
+namespace o2::common::core
+{
+
+/// Objects are keyed by (key, run number) and owned by the cache, so that all tasks of the same process share one deserialised copy.
+/// A load is either deferred (run by the first task asking for the object, the others wait for it) or started in the background by prefetch(),
+/// so that the CCDB round-trips of a new run are done concurrently instead of one after the other.
+/// Loaders use their own CcdbApi instance and do not touch the BasicCCDBManager of the caller, which is not thread safe.
+class RunConditionsCache
+{
+ public:
+  using Loader = std::function<std::shared_ptr<void>()>;
+  using Metadata = std::map<std::string, std::string>;
+
+  static RunConditionsCache& instance();
+
+  /// @brief Get the object for the given key and run, loading it on the calling thread if it was neither cached nor prefetched
+  /// @return the cached object, nullptr if the loader did not find it. The object is shared with the other users and must not be modified
+  template <typename T>
+  std::shared_ptr<T> get(const std::string& key, int runNumber, Loader loader)
+  {
+    return std::static_pointer_cast<T>(request(key, runNumber, std::move(loader), std::launch::deferred).get());
+  }
+
+  /// @brief Start loading the object for the given key and run in the background, if not cached already
+  void prefetch(const std::string& key, int runNumber, Loader loader) { request(key, runNumber, std::move(loader), std::launch::async); }
+
+  /// @brief Check whether an object is in the cache (loaded or being loaded)
+  bool contains(const std::string& key, int runNumber);
+
+  /// @brief Number of runs kept in memory, objects of older runs are released (default 4)
+  void setMaxRuns(int maxRuns);
+  void clear();
+
+  /// @brief Build a loader retrieving the object from the CCDB with the settings (URL, creation time limit) of the given manager
+  /// @param transform optional function applied once to the retrieved object, receiving the headers of the CCDB entry (e.g. its validity).
+  /// Its result is what is stored in the cache, which allows to share derived objects instead of the raw CCDB one
+  template <typename T>
+  static Loader makeLoader(o2::ccdb::BasicCCDBManager* ccdb, const std::string& path, int64_t timestamp, const Metadata& metadata,
+                           std::function<std::shared_ptr<void>(std::shared_ptr<T>, const Metadata&)> transform = nullptr)
+  {
+    auto [url, createdNotAfter] = getSettings(ccdb);
+    return [=]() -> std::shared_ptr<void> {
+      o2::ccdb::CcdbApi api;
+      api.init(url);
+      Metadata meta{metadata};
+      Metadata headers;
+      T* obj = api.retrieveFromTFileAny<T>(path, meta, timestamp, &headers, "", createdNotAfter > 0 ? std::to_string(createdNotAfter) : "");
+      if (obj == nullptr) {
+        return nullptr;
+      }
+      std::shared_ptr<T> ptr{obj};
+      return transform ? transform(std::move(ptr), headers) : ptr;
+    };
+  }
+
+ private:
+  RunConditionsCache() = default;
+
+  std::shared_future<std::shared_ptr<void>> request(const std::string& key, int runNumber, Loader loader, std::launch policy);
+  void evictOldRuns(std::vector<std::shared_future<std::shared_ptr<void>>>& evicted);
+  static std::pair<std::string, int64_t> getSettings(o2::ccdb::BasicCCDBManager* ccdb);
+
+  std::mutex mMutex;
+  int mMaxRuns = 4;
+  std::deque<int> mRuns; /// runs in the cache, in order of first use
+  std::map<std::pair<int, std::string>, std::shared_future<std::shared_ptr<void>>> mObjects;
+};
+
+} // namespace o2::common::core
+
+#endif // COMMON_CORE_RUNCONDITIONSCACHE_H_
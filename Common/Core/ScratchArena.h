@@ -0,0 +1,110 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file ScratchArena.h
+/// \brief Per-task scratch memory for the temporary arrays sized to a table length which are needed only within one data frame
+
+#ifndef COMMON_CORE_SCRATCHARENA_H_
+#define COMMON_CORE_SCRATCHARENA_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace o2::common::core
+{
+
+/// Bump allocator handing out typed spans of trivially copyable elements.
+/// reset() invalidates all the spans handed out since the previous reset() and keeps the memory: if a data frame needed more
+/// than the current block, the block is regrown once to the high-water mark, so that the following data frames of similar size
+/// do not allocate (nor page fault) at all.
+/// Typical use, with the arena a member of the task:
+///   scratch.reset();
+///   auto bestCollision = scratch.allocate<int>(mcCollisions.size(), -1);
+class ScratchArena
+{
+ public:
+  explicit ScratchArena(size_t initialBytes = 0)
+  {
+    if (initialBytes > 0) {
+      grow(initialBytes);
+    }
+  }
+
+  /// Releases all the spans, to be called at the beginning of each data frame
+  void reset()
+  {
+    if (!mOverflow.empty()) {
+      mOverflow.clear();
+      grow(mHighWater);
+    }
+    mUsed = 0;
+    mOverflowUsed = 0;
+  }
+
+  /// Span of n uninitialised elements, valid until the next reset()
+  template <typename T>
+  std::span<T> allocate(size_t n)
+  {
+    static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>, "ScratchArena only holds trivial types");
+    const size_t bytes = n * sizeof(T);
+    size_t offset = alignUp(mUsed, alignof(T));
+    T* data = nullptr;
+    if (offset + bytes <= mCapacity) {
+      data = reinterpret_cast<T*>(mBlock.get() + offset);
+      mUsed = offset + bytes;
+    } else {
+      // does not fit: serve it from a dedicated block, the main block is regrown at the next reset()
+      mOverflow.emplace_back(new std::byte[bytes + alignof(T)]);
+      auto address = reinterpret_cast<std::uintptr_t>(mOverflow.back().get());
+      data = reinterpret_cast<T*>(alignUp(address, alignof(T)));
+      mOverflowUsed += bytes + alignof(T);
+    }
+    mHighWater = std::max(mHighWater, mUsed + mOverflowUsed);
+    return {data, n};
+  }
+
+  /// Span of n elements set to value, valid until the next reset()
+  template <typename T>
+  std::span<T> allocate(size_t n, T const& value)
+  {
+    auto span = allocate<T>(n);
+    std::fill(span.begin(), span.end(), value);
+    return span;
+  }
+
+  size_t capacity() const { return mCapacity; }
+  size_t highWater() const { return mHighWater; }
+
+ private:
+  static constexpr size_t alignUp(size_t value, size_t alignment) { return (value + alignment - 1) / alignment * alignment; }
+
+  void grow(size_t bytes)
+  {
+    mCapacity = alignUp(bytes, alignof(std::max_align_t));
+    mBlock.reset(new std::byte[mCapacity]);
+  }
+
+  std::unique_ptr<std::byte[]> mBlock;                 // main block, new std::byte[] is aligned to max_align_t
+  size_t mCapacity = 0;                                // size of the main block
+  size_t mUsed = 0;                                    // bytes of the main block handed out since the last reset()
+  std::vector<std::unique_ptr<std::byte[]>> mOverflow; // blocks of the allocations which did not fit since the last reset()
+  size_t mOverflowUsed = 0;                            // bytes of the overflow blocks
+  size_t mHighWater = 0;                               // largest total since construction, the size of the main block after reset()
+};
+
+} // namespace o2::common::core
+
+#endif // COMMON_CORE_SCRATCHARENA_H_
@@ -20,8 +20,12 @@
 #include <ReconstructionDataFormats/Track.h>
 #include <ReconstructionDataFormats/TrackParametrization.h>
 
+#include <cstddef>
 #include <cstdint>
+#include <span>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 namespace o2::aod::common
 {
@@ -39,14 +43,23 @@ class TPCVDriftManager
 
   void update(uint64_t timestamp) noexcept
   {
-    // Check validity of already present obj, otherwise update
-    if (mVD != nullptr && (timestamp > static_cast<uint64_t>(mVD->firstTime) || timestamp < static_cast<uint64_t>(mVD->lastTime))) {
+    // Check validity of the current drift velocity, then of the ones already fetched, otherwise update
+    const auto time = static_cast<int64_t>(timestamp);
+    if (mValid && time >= mCurrent.firstTime && time <= mCurrent.lastTime) {
       return;
     }
+    for (const auto& entry : mCache) {
+      if (time >= entry.firstTime && time <= entry.lastTime) {
+        mCurrent = entry;
+        mTPCVDriftNS = entry.vdrift;
+        mValid = true;
+        return;
+      }
+    }
 
     // Update Obj
-    mVD = mCCDB->getForTimeStamp<o2::tpc::VDriftCorrFact>("TPC/Calib/VDriftTgl", timestamp);
-    if (mVD == nullptr || mVD->firstTime < 0 || mVD->lastTime < 0) {
+    const auto* vd = mCCDB->getForTimeStamp<o2::tpc::VDriftCorrFact>("TPC/Calib/VDriftTgl", timestamp);
+    if (vd == nullptr || vd->firstTime < 0 || vd->lastTime < 0) {
       LOGP(error, "Got invalid VDriftCorrFact for {}", timestamp);
       mValid = false;
       return;
@@ -55,43 +68,56 @@ class TPCVDriftManager
     // TODO account for laser calib
 
     // Update factors
-    mTPCVDriftNS = mVD->refVDrift * mVD->corrFact * 1e-3;
+    mTPCVDriftNS = vd->refVDrift * vd->corrFact * 1e-3;
+    mCurrent = {vd->firstTime, vd->lastTime, mTPCVDriftNS};
+    mCache.push_back(mCurrent);
 
     mValid = true;
-    LOGP(info, "Updated VDrift for timestamp {} with vdrift={:.7f} (cm/ns)", mVD->creationTime, mTPCVDriftNS);
+    LOGP(info, "Updated VDrift for timestamp {} with vdrift={:.7f} (cm/ns)", vd->creationTime, mTPCVDriftNS);
   }
 
+  // Times of a TPC track and of the collision it is moved to, in ns relative to the BC of the collision the track is associated to
+  struct TrackTime {
+    float trackTime{0.f};     // TPC time of the track
+    float targetTime{0.f};    // time of the collision under assumption
+    float targetTimeErr{0.f}; // uncertainty of the target time
+  };
+
   template <typename BCs, typename Collisions, typename Collision, typename TrackExtra, typename Track>
   [[nodiscard]] bool moveTPCTrack(const Collision& col, const TrackExtra& trackExtra, Track& track) noexcept
   {
     ++mCalls;
 
     // Check if there is a good object available otherwise pretend everything is fine
-    if (!mValid) {
-      if (mInvalid < mWarningLimit) {
-        LOGP(warn, "No VDrift object available, pretending track to be correct");
-        if (mInvalid == mWarningLimit - 1) {
-          LOGP(warn, "Silencing further warnings!");
-        }
-      }
-      ++mInvalid;
+    if (!checkValid()) {
       return true;
     }
 
-    // track is fine, or cannot be moved has information is not available
+    TrackTime time;
+    if (!getTrackTime<BCs, Collisions>(col, trackExtra, time)) {
+      return true;
+    }
+    return applyDrift(time, track, mTPCVDriftNS);
+  }
+
+  // Times of the track under the assumption of the collision col, false if the track is fine or cannot be moved
+  // as the information is not available
+  template <typename BCs, typename Collisions, typename Collision, typename TrackExtra>
+  [[nodiscard]] bool getTrackTime(const Collision& col, const TrackExtra& trackExtra, TrackTime& time) noexcept
+  {
     if (!(trackExtra.flags() & o2::aod::track::TrackFlags::TrackTimeAsym)) {
       ++mNoFlag;
-      return true;
+      return false;
     }
 
     // TPC time is given relative to the closest BC in ns
-    float tTB, tTBErr;
+    time.trackTime = trackExtra.trackTime();
     if (col.collisionTimeRes() < 0.f) { // use track data
       ++mColResNeg;
-      tTB = trackExtra.trackTime();
+      time.targetTime = trackExtra.trackTime();
       o2::aod::track::extensions::TPCTimeErrEncoding enc;
       enc.encoding.timeErr = trackExtra.trackTimeRes();
-      tTBErr = 0.5f * (enc.getDeltaTFwd() + enc.getDeltaTBwd());
+      time.targetTimeErr = 0.5f * (enc.getDeltaTFwd() + enc.getDeltaTBwd());
     } else {
       ++mColResPos;
       // The TPC track can be associated to a different BC than the one the collision under assumption is;
@@ -107,19 +133,60 @@ class TPCVDriftManager
         diffBC = (colBC - trackBC);
       }
       float diffBCNS = sign * static_cast<float>(diffBC) * static_cast<float>(o2::constants::lhc::LHCBunchSpacingNS);
-      tTB = col.collisionTime() + diffBCNS;
-      tTBErr = col.collisionTimeRes();
+      time.targetTime = col.collisionTime() + diffBCNS;
+      time.targetTimeErr = col.collisionTimeRes();
     }
-    float dTime = tTB - trackExtra.trackTime();
-    float dDrift = dTime * mTPCVDriftNS;
-    float dDriftErr = tTBErr * mTPCVDriftNS;
+    return true;
+  }
+
+  // Batched correction of tracks[i] to times[i], e.g. of all the TPC-only tracks of a data frame, the times are taken from getTrackTime().
+  // The validity of the drift velocity is checked once for the whole batch; ok[i] is false if the track cannot be moved
+  template <typename Track>
+  void moveTPCTracks(std::span<const TrackTime> times, std::span<Track> tracks, std::vector<uint8_t>& ok) noexcept
+  {
+    mCalls += times.size();
+    ok.assign(times.size(), 1);
+    if (!checkValid(times.size())) {
+      return;
+    }
+    const float vdrift = mTPCVDriftNS;
+    for (size_t i = 0; i < times.size(); ++i) {
+      ok[i] = applyDrift(times[i], tracks[i], vdrift);
+    }
+  }
+
+  void print() noexcept
+  {
+    LOGP(info, "TPC corrections called: {}; Moved Tracks: {}; Constrained Tracks={}; No Flag: {}; NULL: {}; Outside: {}; ColResPos {}; ColResNeg {};", mCalls, mMovedTrks, mConstrained, mNoFlag, mInvalid, mOutside, mColResPos, mColResNeg);
+  }
+
+ private:
+  // Check if there is a good object available, nTracks are counted as not corrected otherwise
+  bool checkValid(size_t nTracks = 1) noexcept
+  {
+    if (mValid) {
+      return true;
+    }
+    if (mInvalid < mWarningLimit) {
+      LOGP(warn, "No VDrift object available, pretending track to be correct");
+      if (mInvalid + nTracks >= mWarningLimit) {
+        LOGP(warn, "Silencing further warnings!");
+      }
+    }
+    mInvalid += nTracks;
+    return false;
+  }
+
+  template <typename Track>
+  bool applyDrift(const TrackTime& time, Track& track, float vdrift) noexcept
+  {
+    float dTime = time.targetTime - time.trackTime;
+    float dDrift = dTime * vdrift;
+    float dDriftErr = time.targetTimeErr * vdrift;
     if (dDriftErr < 0.f || dDrift > 250.f) { // we cannot move a track outside the drift volume
       if (mOutside < mWarningLimit) {
         LOGP(warn, "Skipping correction outside of tpc volume with dDrift={} +- {}", dDrift, dDriftErr);
-        const auto trackBC = trackExtra.template collision_as<Collisions>().template foundBC_as<BCs>().globalBC();
-        const auto colBC = col.template foundBC_as<BCs>().globalBC();
-        int diffBC = colBC - trackBC;
-        LOGP(info, "ct={}; ctr={}; tTB={}; t0={}; dTime={}; dDrift={}; tgl={}:   colBC={}   trackBC={}  diffBC={}", col.collisionTime(), col.collisionTimeRes(), tTB, trackExtra.trackTime(), dTime, dDrift, track.getTgl(), colBC, trackBC, diffBC);
+        LOGP(info, "tTB={}; tTBErr={}; t0={}; dTime={}; dDrift={}; tgl={}", time.targetTime, time.targetTimeErr, time.trackTime, dTime, dDrift, track.getTgl());
         if (mOutside == mWarningLimit - 1) {
           LOGP(warn, "Silencing further warnings!");
         }
@@ -139,19 +206,21 @@ class TPCVDriftManager
     return true;
   }
 
-  void print() noexcept
-  {
-    LOGP(info, "TPC corrections called: {}; Moved Tracks: {}; Constrained Tracks={}; No Flag: {}; NULL: {}; Outside: {}; ColResPos {}; ColResNeg {};", mCalls, mMovedTrks, mConstrained, mNoFlag, mInvalid, mOutside, mColResPos, mColResNeg);
-  }
-
- private:
   bool mValid{false};
   // Factors
   float mTPCVDriftNS{0.f}; // drift velocity in cm/ns
 
+  // Drift velocity of a validity interval of the VDriftCorrFact objects
+  struct VDriftEntry {
+    int64_t firstTime{0}; // start of validity (ms)
+    int64_t lastTime{-1}; // end of validity (ms)
+    float vdrift{0.f};    // drift velocity in cm/ns
+  };
+  VDriftEntry mCurrent;            // entry in use
+  std::vector<VDriftEntry> mCache; // entries of all the objects fetched so far, e.g. of the runs of the input
+
   // CCDB
-  const o2::tpc::VDriftCorrFact* mVD{}; // reference to drift correction
-  o2::ccdb::BasicCCDBManager* mCCDB{};  // reference to initialized ccdb manager
+  o2::ccdb::BasicCCDBManager* mCCDB{}; // reference to initialized ccdb manager
 
   static constexpr unsigned int mWarningLimit{10};
 
@@ -17,10 +17,12 @@
 
 #include "Common/Core/TableHelper.h"
 
+#include <Framework/DataSpecUtils.h>
 #include <Framework/InitContext.h>
 #include <Framework/Logger.h>
 #include <Framework/RunningWorkflowInfo.h>
 
+#include <set>
 #include <string>
 
 /// Function to print the table required in the full workflow
@@ -54,6 +56,53 @@ bool o2::common::core::isTableRequiredInWorkflow(o2::framework::InitContext& ini
   return tableNeeded;
 }
 
+/// Function to print the AOD tables produced in the workflow that no device consumes.
+/// For the devices none of whose tables is consumed, the configuration switching off their enabled process functions is printed too
+/// @param initContext initContext of the init function
+void o2::common::core::printUnconsumedTablesInWorkflow(o2::framework::InitContext& initContext)
+{
+  const auto& workflows = initContext.services().get<o2::framework::RunningWorkflowInfo const>();
+  std::set<std::string> consumedTables;
+  for (auto const& device : workflows.devices) {
+    for (auto const& input : device.inputs) {
+      consumedTables.insert(input.matcher.binding);
+    }
+  }
+  std::string configuration;
+  for (auto const& device : workflows.devices) {
+    int nTables = 0;
+    int nUnconsumedTables = 0;
+    for (auto const& output : device.outputs) {
+      if (!o2::framework::DataSpecUtils::partialMatch(output.matcher, o2::header::DataOrigin("AOD"))) {
+        continue; // histograms and other non-table outputs
+      }
+      nTables++;
+      if (consumedTables.count(output.matcher.binding.value) > 0) {
+        continue;
+      }
+      nUnconsumedTables++;
+      LOG(info) << "Table: " << output.matcher.binding.value << " produced by device: " << device.name << " is not consumed in the workflow";
+    }
+    if (nTables == 0 || nUnconsumedTables < nTables) {
+      continue;
+    }
+    // None of the tables of the device is consumed: its enabled process functions can be switched off
+    std::string processSwitches;
+    for (const o2::framework::ConfigParamSpec& option : device.options) {
+      if (option.type != o2::framework::VariantType::Bool || option.name.rfind("process", 0) != 0 || !option.defaultValue.get<bool>()) {
+        continue;
+      }
+      processSwitches += (processSwitches.empty() ? "" : ", ") + ("\"" + option.name + "\": \"false\"");
+    }
+    if (!processSwitches.empty()) {
+      configuration += (configuration.empty() ? "\n  \"" : ",\n  \"") + device.name + "\": {" + processSwitches + "}";
+    }
+  }
+  if (!configuration.empty()) {
+    LOG(info) << "Configuration switching off the devices without consumed tables:\n{" << configuration << "\n}";
+  }
+}
+
 /// Function to enable or disable a configurable flag, depending on the fact that a table is needed or not
 /// @param initContext initContext of the init function
 /// @param table name of the table to check for
@@ -39,6 +39,11 @@ void printTablesInWorkflow(o2::framework::InitContext& initContext);
 /// @param table name of the table to check for
 bool isTableRequiredInWorkflow(o2::framework::InitContext& initContext, const std::string& table);
 
+/// Function to print the AOD tables produced in the workflow that no device consumes.
+/// For the devices none of whose tables is consumed, the configuration switching off their enabled process functions is printed too
+/// @param initContext initContext of the init function
+void printUnconsumedTablesInWorkflow(o2::framework::InitContext& initContext);
+
 /// Function to enable or disable a configurable flag, depending on the fact that a table is needed or not
 /// @param initContext initContext of the init function
 /// @param table name of the table to check for
@@ -125,5 +130,6 @@ using o2::common::core::enableFlagIfTableRequired;
 using o2::common::core::getTaskOptionValue;
 using o2::common::core::isTableRequiredInWorkflow;
 using o2::common::core::printTablesInWorkflow;
+using o2::common::core::printUnconsumedTablesInWorkflow;
 
 #endif // COMMON_CORE_TABLEHELPER_H_
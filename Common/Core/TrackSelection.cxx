@@ -19,6 +19,7 @@
 #include <Framework/Logger.h>
 
 #include <algorithm>
+#include <bit>
 #include <cstdint>
 #include <functional>
 #include <set>
@@ -27,18 +28,33 @@
 
 bool TrackSelection::FulfillsITSHitRequirements(uint8_t itsClusterMap) const
 {
-  constexpr uint8_t bit = 1;
-  for (auto& itsRequirement : mRequiredITSHits) {
-    auto hits = std::count_if(itsRequirement.second.begin(), itsRequirement.second.end(), [&](auto&& requiredLayer) { return itsClusterMap & (bit << requiredLayer); });
-    if ((itsRequirement.first == -1) && (hits > 0)) {
+  if (mRequiredITSHitMasks.size() != mRequiredITSHits.size()) { // e.g. object read from file
+    BuildITSHitMasks();
+  }
+  for (const auto& [minNRequiredHits, layerMask] : mRequiredITSHitMasks) {
+    const int hits = std::popcount(static_cast<uint8_t>(itsClusterMap & layerMask));
+    if ((minNRequiredHits == -1) && (hits > 0)) {
       return false; // no hits were required in specified layers
-    } else if (hits < itsRequirement.first) {
+    } else if (hits < minNRequiredHits) {
       return false; // not enough hits found in specified layers
     }
   }
   return true;
 }
 
+void TrackSelection::BuildITSHitMasks() const
+{
+  constexpr uint8_t bit = 1;
+  mRequiredITSHitMasks.clear();
+  for (const auto& itsRequirement : mRequiredITSHits) {
+    uint8_t layerMask = 0;
+    for (const auto requiredLayer : itsRequirement.second) {
+      layerMask |= bit << requiredLayer;
+    }
+    mRequiredITSHitMasks.emplace_back(itsRequirement.first, layerMask);
+  }
+}
+
 const std::string TrackSelection::mCutNames[static_cast<int>(TrackSelection::TrackCuts::kNCuts)] = {"TrackType", "PtRange", "EtaRange", "TPCNCls", "TPCCrossedRows", "TPCCrossedRowsOverNCls", "TPCChi2NDF", "TPCRefit", "ITSNCls", "ITSChi2NDF", "ITSRefit", "ITSHits", "GoldenChi2", "DCAxy", "DCAz", "TPCFracSharedCls"};
 
 void TrackSelection::SetTrackType(o2::aod::track::TrackTypeEnum trackType)
@@ -122,18 +138,30 @@ void TrackSelection::SetMaxDcaZ(float maxDcaZ)
 void TrackSelection::SetMaxDcaXYPtDep(std::function<float(float)> ptDepCut)
 {
   mMaxDcaXYPtDep = ptDepCut;
+  mUseMaxDcaXYPtDepPars = false;
   LOG(info) << "Track selection, set max DCA xy pt dep: " << mMaxDcaXYPtDep(1.0);
 }
+void TrackSelection::SetMaxDcaXYPtDep(float p0, float p1, float p2)
+{
+  mMaxDcaXYPtDepPars[0] = p0;
+  mMaxDcaXYPtDepPars[1] = p1;
+  mMaxDcaXYPtDepPars[2] = p2;
+  mUseMaxDcaXYPtDepPars = true;
+  mMaxDcaXYPtDep = nullptr;
+  LOG(info) << "Track selection, set max DCA xy pt dep: " << p0 << " + " << p1 << " / pt^" << p2;
+}
 
 void TrackSelection::SetRequireHitsInITSLayers(int8_t minNRequiredHits, std::set<uint8_t> requiredLayers)
 {
   // layer 0 corresponds to the the innermost ITS layer
   mRequiredITSHits.push_back(std::make_pair(minNRequiredHits, requiredLayers));
+  BuildITSHitMasks();
   LOG(info) << "Track selection, set require hits in ITS layers: " << static_cast<int>(minNRequiredHits);
 }
 void TrackSelection::SetRequireNoHitsInITSLayers(std::set<uint8_t> excludedLayers)
 {
   mRequiredITSHits.push_back(std::make_pair(-1, excludedLayers));
+  BuildITSHitMasks();
   LOG(info) << "Track selection, set require no hits in ITS layers";
 }
 
@@ -184,7 +212,11 @@ void TrackSelection::print() const
         LOG(info) << mCutNames[i] << " == " << mRequireGoldenChi2;
         break;
       case TrackCuts::kDCAxy:
-        LOG(info) << mCutNames[i] << " < " << mMaxDcaXY;
+        if (mUseMaxDcaXYPtDepPars) {
+          LOG(info) << mCutNames[i] << " < " << mMaxDcaXYPtDepPars[0] << " + " << mMaxDcaXYPtDepPars[1] << " / pt^" << mMaxDcaXYPtDepPars[2];
+        } else {
+          LOG(info) << mCutNames[i] << " < " << mMaxDcaXY;
+        }
         break;
       case TrackCuts::kDCAz:
         LOG(info) << mCutNames[i] << " < " << mMaxDcaZ;
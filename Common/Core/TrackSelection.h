@@ -69,6 +69,80 @@ class TrackSelection
   };
 
   static const std::string mCutNames[static_cast<int>(TrackCuts::kNCuts)];
+  static constexpr uint16_t kAllCutsMask = (1u << static_cast<int>(TrackCuts::kNCuts)) - 1u;
+
+  // Track quantities used by the cuts, read once per track and shared by all the selections evaluated on it
+  struct TrackInputs {
+    uint8_t trackType;
+    bool isRun2;
+    uint32_t flags;
+    float pt;
+    float eta;
+    int tpcNClsFound;
+    int tpcNClsCrossedRows;
+    float tpcCrossedRowsOverFindableCls;
+    float tpcChi2NCl;
+    bool hasTPC;
+    int itsNCls;
+    float itsChi2NCl;
+    bool hasITS;
+    uint8_t itsClusterMap;
+    float dcaXY;
+    float dcaZ;
+    float tpcFractionSharedCls;
+  };
+
+  template <typename T>
+  static TrackInputs readInputs(T const& track)
+  {
+    TrackInputs in;
+    in.trackType = track.trackType();
+    in.isRun2 = in.trackType == o2::aod::track::Run2Track || in.trackType == o2::aod::track::Run2Tracklet;
+    in.flags = track.flags();
+    in.pt = track.pt();
+    in.eta = track.eta();
+    in.tpcNClsFound = track.tpcNClsFound();
+    in.tpcNClsCrossedRows = track.tpcNClsCrossedRows();
+    in.tpcCrossedRowsOverFindableCls = track.tpcCrossedRowsOverFindableCls();
+    in.tpcChi2NCl = track.tpcChi2NCl();
+    in.hasTPC = track.hasTPC();
+    in.itsNCls = track.itsNCls();
+    in.itsChi2NCl = track.itsChi2NCl();
+    in.hasITS = track.hasITS();
+    in.itsClusterMap = track.itsClusterMap();
+    in.dcaXY = track.dcaXY();
+    in.dcaZ = track.dcaZ();
+    in.tpcFractionSharedCls = track.tpcFractionSharedCls();
+    return in;
+  }
+
+  // Same as IsSelectedMask(track), on the quantities read once with readInputs(), so that several selections can be evaluated on the same track without reading the columns again
+  uint16_t IsSelectedMask(TrackInputs const& in) const
+  {
+    uint16_t flag = 0;
+    auto setFlag = [&](const TrackCuts& cut, bool selected) {
+      flag |= static_cast<uint16_t>(selected) << static_cast<int>(cut);
+    };
+    setFlag(TrackCuts::kTrackType, in.trackType == mTrackType);
+    setFlag(TrackCuts::kPtRange, in.pt >= mMinPt && in.pt <= mMaxPt);
+    setFlag(TrackCuts::kEtaRange, in.eta >= mMinEta && in.eta <= mMaxEta);
+    setFlag(TrackCuts::kTPCNCls, in.tpcNClsFound >= mMinNClustersTPC);
+    setFlag(TrackCuts::kTPCCrossedRows, in.tpcNClsCrossedRows >= mMinNCrossedRowsTPC);
+    setFlag(TrackCuts::kTPCCrossedRowsOverNCls, in.tpcCrossedRowsOverFindableCls >= mMinNCrossedRowsOverFindableClustersTPC);
+    setFlag(TrackCuts::kTPCChi2NDF, in.tpcChi2NCl <= mMaxChi2PerClusterTPC);
+    setFlag(TrackCuts::kTPCRefit, mRequireTPCRefit ? (in.isRun2 ? (in.flags & o2::aod::track::TPCrefit) != 0 : in.hasTPC) : true);
+    setFlag(TrackCuts::kITSNCls, in.itsNCls >= mMinNClustersITS);
+    setFlag(TrackCuts::kITSChi2NDF, in.itsChi2NCl <= mMaxChi2PerClusterITS);
+    setFlag(TrackCuts::kITSRefit, mRequireITSRefit ? (in.isRun2 ? (in.flags & o2::aod::track::ITSrefit) != 0 : in.hasITS) : true);
+    setFlag(TrackCuts::kITSHits, FulfillsITSHitRequirements(in.itsClusterMap));
+    setFlag(TrackCuts::kGoldenChi2, (in.isRun2 && mRequireGoldenChi2) ? (in.flags & o2::aod::track::GoldenChi2) != 0 : true);
+    setFlag(TrackCuts::kDCAxy, std::fabs(in.dcaXY) <= MaxDcaXY(in.pt));
+    setFlag(TrackCuts::kDCAz, std::fabs(in.dcaZ) <= mMaxDcaZ);
+    setFlag(TrackCuts::kTPCFracSharedCls, in.tpcFractionSharedCls <= mMaxTPCFractionSharedCls);
+    return flag;
+  }
+
+  bool IsSelected(TrackInputs const& in) const { return IsSelectedMask(in) == kAllCutsMask; }
 
   // Temporary function to check if track passes selection criteria. To be replaced by framework filters.
   template <typename T>
@@ -204,7 +278,7 @@ class TrackSelection
         return (isRun2 && mRequireGoldenChi2) ? (track.flags() & o2::aod::track::GoldenChi2) : true;
 
       case TrackCuts::kDCAxy:
-        return std::fabs(track.dcaXY()) <= ((mMaxDcaXYPtDep) ? mMaxDcaXYPtDep(track.pt()) : mMaxDcaXY);
+        return std::fabs(track.dcaXY()) <= MaxDcaXY(track.pt());
 
       case TrackCuts::kDCAz:
         return std::fabs(track.dcaZ()) <= mMaxDcaZ;
@@ -232,10 +306,16 @@ class TrackSelection
   void SetMaxDcaXY(float maxDcaXY);
   void SetMaxDcaZ(float maxDcaZ);
   void SetMaxDcaXYPtDep(std::function<float(float)> ptDepCut);
+  /// @brief Set a pT dependent max DCAxy of the form p0 + p1 / pT^p2, evaluated inline instead of through a std::function
+  void SetMaxDcaXYPtDep(float p0, float p1, float p2);
   void SetRequireHitsInITSLayers(int8_t minNRequiredHits, std::set<uint8_t> requiredLayers);
   void SetRequireNoHitsInITSLayers(std::set<uint8_t> excludedLayers);
   /// @brief Reset ITS requirements
-  void ResetITSRequirements() { mRequiredITSHits.clear(); }
+  void ResetITSRequirements()
+  {
+    mRequiredITSHits.clear();
+    mRequiredITSHitMasks.clear();
+  }
   void SetMaxTPCFractionSharedCls(float maxTPCFractionSharedCls);
 
   /// @brief Print the track selection
@@ -243,6 +323,15 @@ class TrackSelection
 
  private:
   bool FulfillsITSHitRequirements(uint8_t itsClusterMap) const;
+  // max DCAxy at this pT: parametric form if set, otherwise user function if set, otherwise constant
+  float MaxDcaXY(float pt) const
+  {
+    if (mUseMaxDcaXYPtDepPars) {
+      return mMaxDcaXYPtDepPars[0] + mMaxDcaXYPtDepPars[1] / (mMaxDcaXYPtDepPars[2] == 1.f ? pt : std::pow(pt, mMaxDcaXYPtDepPars[2]));
+    }
+    return (mMaxDcaXYPtDep) ? mMaxDcaXYPtDep(pt) : mMaxDcaXY;
+  }
+  void BuildITSHitMasks() const;
 
   o2::aod::track::TrackTypeEnum mTrackType{o2::aod::track::TrackTypeEnum::Track};
 
@@ -261,6 +350,8 @@ class TrackSelection
   float mMaxDcaXY{1e10f};                       // max dca in xy plane
   float mMaxDcaZ{1e10f};                        // max dca in z direction
   std::function<float(float)> mMaxDcaXYPtDep{}; // max dca in xy plane as function of pT
+  float mMaxDcaXYPtDepPars[3]{0.f, 0.f, 1.f};   // max dca in xy plane as p0 + p1 / pT^p2
+  bool mUseMaxDcaXYPtDepPars{false};            // use mMaxDcaXYPtDepPars instead of mMaxDcaXYPtDep
 
   float mMaxTPCFractionSharedCls{1e10f}; // max fraction of shared TPC clusters
 
@@ -270,8 +361,10 @@ class TrackSelection
 
   // vector of ITS requirements (minNRequiredHits in specific requiredLayers)
   std::vector<std::pair<int8_t, std::set<uint8_t>>> mRequiredITSHits{};
+  // same requirements with the layers as a bit mask of the ITS cluster map, built from mRequiredITSHits
+  mutable std::vector<std::pair<int8_t, uint8_t>> mRequiredITSHitMasks{}; //!
 
-  ClassDefNV(TrackSelection, 1);
+  ClassDefNV(TrackSelection, 2);
 };
 
 #endif // COMMON_CORE_TRACKSELECTION_H_
@@ -39,7 +39,7 @@ TrackSelection getGlobalTrackSelection()
   selectedTracks.SetMaxChi2PerClusterTPC(4.f);
   selectedTracks.SetRequireHitsInITSLayers(1, {0, 1}); // one hit in any SPD layer
   selectedTracks.SetMaxChi2PerClusterITS(36.f);
-  selectedTracks.SetMaxDcaXYPtDep([](float pt) { return 0.0105f + 0.0350f / pow(pt, 1.1f); });
+  selectedTracks.SetMaxDcaXYPtDep(0.0105f, 0.0350f, 1.1f);
   selectedTracks.SetMaxDcaZ(2.f);
   return selectedTracks;
 }
@@ -73,8 +73,8 @@ TrackSelection getGlobalTrackSelectionRun3ITSMatch(int matching, int passFlag)
   switch (passFlag) {
     case TrackSelection::GlobalTrackRun3DCAxyCut::Default:
       break;
-    case TrackSelection::GlobalTrackRun3DCAxyCut::ppPass3:                            // Pass3 pp parameters
-      selectedTracks.SetMaxDcaXYPtDep([](float pt) { return 0.004f + 0.013f / pt; }); // Tuned on the LHC22f anchored MC LHC23d1d on primary pions. 7 Sigmas of the resolution
+    case TrackSelection::GlobalTrackRun3DCAxyCut::ppPass3: // Pass3 pp parameters
+      selectedTracks.SetMaxDcaXYPtDep(0.004f, 0.013f, 1.f);  // Tuned on the LHC22f anchored MC LHC23d1d on primary pions. 7 Sigmas of the resolution
       break;
     default:
       LOG(fatal) << "getGlobalTrackSelectionRun3ITSMatch with undefined DCA cut";
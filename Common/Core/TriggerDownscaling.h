@@ -0,0 +1,102 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file TriggerDownscaling.h
+/// \brief Downscaling of the software trigger channels compiled into flat tables, used by the central event filter
+///        and usable offline to emulate the selection of the skimmed data on the trigger masks (e.g. the ones read by Zorro)
+
+#ifndef COMMON_CORE_TRIGGERDOWNSCALING_H_
+#define COMMON_CORE_TRIGGERDOWNSCALING_H_
+
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace o2::common::core
+{
+
+/// The channels are the bits of a 128-bit trigger mask (two 64-bit words, as in the CefpDecisions table).
+/// The downscaling factor of each channel is stored as a 64-bit acceptance threshold: a fired channel is kept if a uniform
+/// 64-bit random number is below it, channels without downscaling are kept without drawing a number.
+class TriggerDownscaling
+{
+ public:
+  static constexpr int NWords = 2;
+  static constexpr int NChannels = 64 * NWords;
+  using Mask = std::array<uint64_t, NWords>;
+
+  explicit TriggerDownscaling(uint64_t seed = 0x9e3779b97f4a7c15ull) { setSeed(seed); }
+
+  void setSeed(uint64_t seed) { mState = seed ? seed : 0x9e3779b97f4a7c15ull; }
+
+  /// Fraction of the fired events kept for the channel, factors >= 1 (or disabled downscalings) keep all of them
+  void setDownscaling(int channel, double factor)
+  {
+    const int word = channel / 64;
+    const uint64_t bit = uint64_t{1} << (channel % 64);
+    if (factor >= 1.) {
+      mDownscaled[word] &= ~bit;
+      mThresholds[channel] = ~uint64_t{0};
+    } else {
+      mDownscaled[word] |= bit;
+      mThresholds[channel] = factor > 0. ? static_cast<uint64_t>(std::ldexp(factor, 64)) : 0;
+    }
+  }
+  void disableDownscalings() { mDownscaled.fill(0); }
+
+  bool isDownscaled(int channel) const { return mDownscaled[channel / 64] >> (channel % 64) & 1; }
+
+  /// Selection mask of an event with the given trigger mask: the channels without downscaling pass as they are,
+  /// a random number is drawn only for each fired downscaled channel
+  Mask apply(Mask const& triggers)
+  {
+    Mask decision;
+    for (int iW{0}; iW < NWords; ++iW) {
+      decision[iW] = triggers[iW] & ~mDownscaled[iW];
+      for (uint64_t fired = triggers[iW] & mDownscaled[iW]; fired; fired &= fired - 1) {
+        const int bit = std::countr_zero(fired);
+        if (next() < mThresholds[64 * iW + bit]) {
+          decision[iW] |= uint64_t{1} << bit;
+        }
+      }
+    }
+    return decision;
+  }
+
+  /// Applies the downscaling to the trigger masks of a whole data frame
+  void apply(std::vector<Mask> const& triggers, std::vector<Mask>& decisions)
+  {
+    decisions.resize(triggers.size());
+    for (size_t iE{0}; iE < triggers.size(); ++iE) {
+      decisions[iE] = apply(triggers[iE]);
+    }
+  }
+
+ private:
+  /// xorshift64* generator
+  uint64_t next()
+  {
+    mState ^= mState >> 12;
+    mState ^= mState << 25;
+    mState ^= mState >> 27;
+    return mState * 0x2545f4914f6cdd1dull;
+  }
+
+  Mask mDownscaled{0ull, 0ull};                  // channels with a downscaling factor below 1
+  std::array<uint64_t, NChannels> mThresholds{}; // acceptance threshold of each channel, factor * 2^64
+  uint64_t mState;                               // state of the random number generator
+};
+
+} // namespace o2::common::core
+
+#endif // COMMON_CORE_TRIGGERDOWNSCALING_H_
@@ -12,12 +12,11 @@
 
 #include "Zorro.h"
 
+#include "Common/Core/RunConditionsCache.h"
 #include "Common/Core/ZorroHelper.h"
 
 #include <CCDB/BasicCCDBManager.h>
 #include <CommonConstants/LHCConstants.h>
-#include <CommonDataFormat/IRFrame.h>
-#include <CommonDataFormat/InteractionRecord.h>
 #include <CommonUtils/StringUtils.h>
 #include <Framework/HistogramRegistry.h>
 #include <Framework/HistogramSpec.h>
@@ -36,9 +35,10 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
-using o2::InteractionRecord;
+using o2::common::core::RunConditionsCache;
 
 namespace
 {
@@ -51,6 +51,32 @@ int findBin(TH1* hist, const std::string& label)
   }
   return -1;
 }
+
+int64_t getValidity(const RunConditionsCache::Metadata& headers, const std::string& key, int64_t defaultValue)
+{
+  auto it = headers.find(key);
+  return it == headers.end() || it->second.empty() ? defaultValue : std::stoll(it->second);
+}
+
+RunConditionsCache::Loader helpersLoader(o2::ccdb::BasicCCDBManager* ccdb, const std::string& path, int runNumber, int64_t timestamp)
+{
+  return RunConditionsCache::makeLoader<std::vector<ZorroHelper>>(ccdb, path, timestamp, {{"runNumber", std::to_string(runNumber)}}, [](std::shared_ptr<std::vector<ZorroHelper>> helpers, const RunConditionsCache::Metadata& headers) {
+    auto map = std::make_shared<ZorroTriggerMap>();
+    map->helpers = std::move(*helpers);
+    std::sort(map->helpers.begin(), map->helpers.end(), [](const auto& a, const auto& b) { return std::min(a.bcAOD, a.bcEvSel) < std::min(b.bcAOD, b.bcEvSel); });
+    map->bcMin.reserve(map->helpers.size());
+    map->bcMax.reserve(map->helpers.size());
+    map->bcMaxPrefix.reserve(map->helpers.size());
+    for (const auto& helper : map->helpers) {
+      map->bcMin.push_back(std::min(helper.bcAOD, helper.bcEvSel));
+      map->bcMax.push_back(std::max(helper.bcAOD, helper.bcEvSel));
+      map->bcMaxPrefix.push_back(map->bcMaxPrefix.empty() ? map->bcMax.back() : std::max(map->bcMaxPrefix.back(), map->bcMax.back()));
+    }
+    map->validFrom = getValidity(headers, "Valid-From", 0);
+    map->validUntil = getValidity(headers, "Valid-Until", INT64_MAX);
+    return std::shared_ptr<void>{map};
+  });
+}
 } // namespace
 
 void Zorro::populateHistRegistry(o2::framework::HistogramRegistry& histRegistry, int runNumber, std::string folderName)
@@ -177,6 +203,17 @@ void Zorro::populateExternalHists(int runNumber, TH2* ZorroHisto, TH2* ToiHisto)
   mRunNumberHistos.push_back(runNumber);
 }
 
+void Zorro::prefetch(o2::ccdb::BasicCCDBManager* ccdb, int runNumber, uint64_t timestamp)
+{
+  auto& cache = RunConditionsCache::instance();
+  const RunConditionsCache::Metadata runMetadata{{"runNumber", std::to_string(runNumber)}};
+  cache.prefetch("CTP/Calib/OrbitReset", runNumber, RunConditionsCache::makeLoader<std::vector<Long64_t>>(ccdb, "CTP/Calib/OrbitReset", timestamp, {}));
+  for (const auto& object : {"FilterCounters", "SelectionCounters", "InspectedTVX"}) {
+    cache.prefetch(mBaseCCDBPath + object, runNumber, RunConditionsCache::makeLoader<TH1D>(ccdb, mBaseCCDBPath + object, timestamp, runMetadata));
+  }
+  cache.prefetch(mBaseCCDBPath + "ZorroHelpers", runNumber, helpersLoader(ccdb, mBaseCCDBPath + "ZorroHelpers", runNumber, timestamp));
+}
+
 std::vector<int> Zorro::initCCDB(o2::ccdb::BasicCCDBManager* ccdb, int runNumber, uint64_t timestamp, std::string tois, int bcRange)
 {
   if (mRunNumber == runNumber) {
@@ -185,14 +222,30 @@ std::vector<int> Zorro::initCCDB(o2::ccdb::BasicCCDBManager* ccdb, int runNumber
   mCCDB = ccdb;
   mRunNumber = runNumber;
   mBCtolerance = bcRange;
-  auto ctp = ccdb->getForRun<std::vector<Long64_t>>("CTP/Calib/OrbitReset", runNumber, false);
+  prefetch(ccdb, runNumber, timestamp); /// all the objects of the run are fetched concurrently, no-op for the ones already in the cache
+  auto& cache = RunConditionsCache::instance();
+  auto get = [&](const std::string& object) {
+    auto hist = cache.get<TH1D>(mBaseCCDBPath + object, runNumber, RunConditionsCache::makeLoader<TH1D>(ccdb, mBaseCCDBPath + object, timestamp, {{"runNumber", std::to_string(runNumber)}}));
+    if (!hist) {
+      LOGF(fatal, "Zorro: %s not found for run %d", (mBaseCCDBPath + object).data(), runNumber);
+    }
+    return hist;
+  };
+  auto ctp = cache.get<std::vector<Long64_t>>("CTP/Calib/OrbitReset", runNumber, RunConditionsCache::makeLoader<std::vector<Long64_t>>(ccdb, "CTP/Calib/OrbitReset", timestamp, {}));
+  if (!ctp) {
+    LOGF(fatal, "Zorro: CTP/Calib/OrbitReset not found for run %d", runNumber);
+  }
   mOrbitResetTimestamp = (*ctp)[0];
-  mScalers = mCCDB->getForRun<TH1D>(mBaseCCDBPath + "FilterCounters", runNumber, true);
-  mSelections = mCCDB->getForRun<TH1D>(mBaseCCDBPath + "SelectionCounters", runNumber, true);
-  mInspectedTVX = mCCDB->getForRun<TH1D>(mBaseCCDBPath + "InspectedTVX", runNumber, true);
+  mScalersPtr = get("FilterCounters");
+  mSelectionsPtr = get("SelectionCounters");
+  mInspectedTVXPtr = get("InspectedTVX");
+  mScalers = mScalersPtr.get();
+  mSelections = mSelectionsPtr.get();
+  mInspectedTVX = mInspectedTVXPtr.get();
+  mTriggerMap.reset();
   setupHelpers(timestamp);
   mLastBCglobalId = 0;
-  mLastSelectedIdx = 0;
+  mLastSelectedIdx = UINT64_MAX;
   mTOIs.clear();
   mTOIidx.clear();
   std::vector<std::string> tokens = o2::utils::Str::tokenize(tois, ','); // tokens are trimmed
@@ -207,6 +260,7 @@ std::vector<int> Zorro::initCCDB(o2::ccdb::BasicCCDBManager* ccdb, int runNumber
   for (size_t i{0}; i < mTOIs.size(); ++i) {
     LOGF(info, ">>> %s : %i", mTOIs[i].data(), mTOIidx[i]);
   }
+  setupTOImasks();
   mZorroSummary.setupTOIs(mTOIs.size(), mTOIs);
   std::vector<double> toiCounters(mTOIs.size(), 0.);
   for (size_t i{0}; i < mTOIs.size(); ++i) {
@@ -217,40 +271,54 @@ std::vector<int> Zorro::initCCDB(o2::ccdb::BasicCCDBManager* ccdb, int runNumber
   return mTOIidx;
 }
 
+bool Zorro::isCovered(uint64_t bcGlobalId, uint64_t tolerance) const
+{
+  return !mTriggerMap->bcMin.empty() && bcGlobalId + tolerance >= mTriggerMap->bcMin.front() && bcGlobalId <= mTriggerMap->bcMaxPrefix.back() + tolerance;
+}
+
+std::pair<size_t, size_t> Zorro::findCandidateRanges(uint64_t bcGlobalId, uint64_t tolerance) const
+{
+  /// Ranges are sorted in their first BC, the ones in [first, last) are the only ones that can overlap with [bc - tolerance, bc + tolerance]
+  const uint64_t bcLow = bcGlobalId > tolerance ? bcGlobalId - tolerance : 0;
+  const auto& bcMin = mTriggerMap->bcMin;
+  const auto& bcMaxPrefix = mTriggerMap->bcMaxPrefix;
+  size_t last = std::upper_bound(bcMin.begin(), bcMin.end(), bcGlobalId + tolerance) - bcMin.begin();
+  size_t first = std::lower_bound(bcMaxPrefix.begin(), bcMaxPrefix.begin() + last, bcLow) - bcMaxPrefix.begin();
+  return {first, last};
+}
+
 std::bitset<128> Zorro::fetch(uint64_t bcGlobalId, uint64_t tolerance)
 {
   mLastResult.reset();
-  if (bcGlobalId < mBCranges.front().getMin().toLong() - tolerance || bcGlobalId > mBCranges.back().getMax().toLong() + tolerance) {
+  if (!isCovered(bcGlobalId, tolerance)) {
     setupHelpers((mOrbitResetTimestamp + static_cast<int64_t>(bcGlobalId * o2::constants::lhc::LHCBunchSpacingNS * 1e-3)) / 1000);
   }
-
-  o2::dataformats::IRFrame bcFrame{InteractionRecord::long2IR(bcGlobalId) - tolerance, InteractionRecord::long2IR(bcGlobalId) + tolerance};
-  if (bcGlobalId < mLastBCglobalId) { /// Handle the possible discontinuity in the BC processed by the analyses
-    mLastSelectedIdx = 0;
-  }
-  uint64_t lastSelectedIdx = mLastSelectedIdx;
+  const auto& helpers = mTriggerMap->helpers;
+  const uint64_t bcLow = bcGlobalId > tolerance ? bcGlobalId - tolerance : 0;
   mLastBCglobalId = bcGlobalId;
-  for (size_t i = mLastSelectedIdx; i < mBCranges.size(); i++) {
-    if (!mBCranges[i].isOutside(bcFrame)) {
-      for (int iMask{0}; iMask < 2; ++iMask) {
-        for (int iTOI{0}; iTOI < 64; ++iTOI) {
-          if (mZorroHelpers->at(i).selMask[iMask] & (1ull << iTOI)) {
-            mLastResult.set(iMask * 64 + iTOI, 1);
-            if (!mAccountedBCranges[i]) {
-              mATcounts[iMask * 64 + iTOI]++;
-              if (mAnalysedTriggers) {
-                mAnalysedTriggers->Fill(iMask * 64 + iTOI);
-              }
+  bool first{true};
+  auto [firstRange, lastRange] = findCandidateRanges(bcGlobalId, tolerance);
+  for (size_t i = firstRange; i < lastRange; i++) {
+    if (mTriggerMap->bcMax[i] < bcLow) {
+      continue;
+    }
+    for (int iMask{0}; iMask < 2; ++iMask) {
+      for (int iTOI{0}; iTOI < 64; ++iTOI) {
+        if (helpers[i].selMask[iMask] & (1ull << iTOI)) {
+          mLastResult.set(iMask * 64 + iTOI, 1);
+          if (!mAccountedBCranges[i]) {
+            mATcounts[iMask * 64 + iTOI]++;
+            if (mAnalysedTriggers) {
+              mAnalysedTriggers->Fill(iMask * 64 + iTOI);
             }
           }
         }
       }
-      mAccountedBCranges[i] = true;
-      mLastSelectedIdx = mLastSelectedIdx == lastSelectedIdx-- ? i : mLastSelectedIdx; /// Decrease lastSelectedIdx to make sure this check is valid only in its first instance
-    } else if (mBCranges[i].getMax() < bcFrame.getMin()) {
+    }
+    mAccountedBCranges[i] = true;
+    if (first) { /// The first overlapping range identifies the triggered event, used to avoid double counting the triggers of interest
       mLastSelectedIdx = i;
-    } else if (mBCranges[i].getMin() > bcFrame.getMax()) {
-      break;
+      first = false;
     }
   }
   return mLastResult;
@@ -309,17 +377,78 @@ bool Zorro::isNotSelectedByAny(uint64_t bcGlobalId, uint64_t tolerance)
   return mLastResult.none();
 }
 
+uint64_t Zorro::getTOImask(uint64_t bcGlobalId, uint64_t tolerance)
+{
+  if (!isCovered(bcGlobalId, tolerance)) {
+    setupHelpers((mOrbitResetTimestamp + static_cast<int64_t>(bcGlobalId * o2::constants::lhc::LHCBunchSpacingNS * 1e-3)) / 1000);
+  }
+  const uint64_t bcLow = bcGlobalId > tolerance ? bcGlobalId - tolerance : 0;
+  uint64_t mask{0};
+  auto [firstRange, lastRange] = findCandidateRanges(bcGlobalId, tolerance);
+  for (size_t i = firstRange; i < lastRange; i++) {
+    mask |= mTriggerMap->bcMax[i] < bcLow ? 0ull : mTOImasks[i];
+  }
+  return mask;
+}
+
+void Zorro::getTOImasks(const std::vector<uint64_t>& sortedBCs, std::vector<uint64_t>& masks, uint64_t tolerance)
+{
+  masks.assign(sortedBCs.size(), 0);
+  if (sortedBCs.empty()) {
+    return;
+  }
+  if (!isCovered(sortedBCs.front(), tolerance)) {
+    setupHelpers((mOrbitResetTimestamp + static_cast<int64_t>(sortedBCs.front() * o2::constants::lhc::LHCBunchSpacingNS * 1e-3)) / 1000);
+  }
+  /// Both ends of the candidate ranges only move forward with sorted BCs, so the whole data frame is a single sweep over the map
+  const auto& bcMin = mTriggerMap->bcMin;
+  const auto& bcMax = mTriggerMap->bcMax;
+  const auto& bcMaxPrefix = mTriggerMap->bcMaxPrefix;
+  size_t firstRange{0}, lastRange{0};
+  for (size_t iBC{0}; iBC < sortedBCs.size(); ++iBC) {
+    const uint64_t bcLow = sortedBCs[iBC] > tolerance ? sortedBCs[iBC] - tolerance : 0;
+    const uint64_t bcHigh = sortedBCs[iBC] + tolerance;
+    while (lastRange < bcMin.size() && bcMin[lastRange] <= bcHigh) {
+      ++lastRange;
+    }
+    while (firstRange < lastRange && bcMaxPrefix[firstRange] < bcLow) {
+      ++firstRange;
+    }
+    for (size_t i = firstRange; i < lastRange; i++) {
+      masks[iBC] |= bcMax[i] < bcLow ? 0ull : mTOImasks[i];
+    }
+  }
+}
+
 void Zorro::setupHelpers(int64_t timestamp)
 {
-  if (mCCDB->isCachedObjectValid(mBaseCCDBPath + "ZorroHelpers", timestamp)) {
+  if (mTriggerMap && timestamp >= mTriggerMap->validFrom && timestamp < mTriggerMap->validUntil) {
     return;
   }
-  mZorroHelpers = mCCDB->getSpecific<std::vector<ZorroHelper>>(mBaseCCDBPath + "ZorroHelpers", timestamp, {{"runNumber", std::to_string(mRunNumber)}});
-  std::sort(mZorroHelpers->begin(), mZorroHelpers->end(), [](const auto& a, const auto& b) { return std::min(a.bcAOD, a.bcEvSel) < std::min(b.bcAOD, b.bcEvSel); });
-  mBCranges.clear();
+  std::string key{mBaseCCDBPath + "ZorroHelpers"};
+  if (mTriggerMap) { /// the run has more than one trigger-BC map, the one valid at this timestamp is cached separately
+    key += "/" + std::to_string(timestamp);
+  }
+  mTriggerMap = RunConditionsCache::instance().get<const ZorroTriggerMap>(key, mRunNumber, helpersLoader(mCCDB, mBaseCCDBPath + "ZorroHelpers", mRunNumber, timestamp));
+  if (!mTriggerMap) {
+    LOGF(fatal, "Zorro: %sZorroHelpers not found for run %d, timestamp %lld", mBaseCCDBPath.data(), mRunNumber, static_cast<long long>(timestamp));
+  }
   mAccountedBCranges.clear();
-  for (const auto& helper : *mZorroHelpers) {
-    mBCranges.emplace_back(InteractionRecord::long2IR(std::min(helper.bcAOD, helper.bcEvSel)), InteractionRecord::long2IR(std::max(helper.bcAOD, helper.bcEvSel)));
+  mAccountedBCranges.resize(mTriggerMap->helpers.size(), false);
+  setupTOImasks();
+}
+
+void Zorro::setupTOImasks()
+{
+  if (mTOIidx.size() > 64) {
+    LOGF(fatal, "Zorro: at most 64 triggers of interest are supported, %zu requested", mTOIidx.size());
+  }
+  mTOImasks.assign(mTriggerMap->helpers.size(), 0);
+  for (size_t iRange{0}; iRange < mTriggerMap->helpers.size(); ++iRange) {
+    for (size_t iTOI{0}; iTOI < mTOIidx.size(); ++iTOI) {
+      if (mTOIidx[iTOI] >= 0 && mTOIidx[iTOI] < 128 && (mTriggerMap->helpers[iRange].selMask[mTOIidx[iTOI] / 64] & (1ull << (mTOIidx[iTOI] % 64)))) {
+        mTOImasks[iRange] |= 1ull << iTOI;
+      }
+    }
   }
-  mAccountedBCranges.resize(mBCranges.size(), false);
 }
@@ -22,7 +22,6 @@
 #include "ZorroHelper.h"
 #include "ZorroSummary.h"
 
-#include <CommonDataFormat/IRFrame.h>
 #include <Framework/HistogramRegistry.h>
 
 #include <TH1.h>
@@ -30,6 +29,7 @@
 
 #include <bitset>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -42,14 +42,30 @@ class BasicCCDBManager;
 };
 }; // namespace o2
 
+/// Trigger-BC map of a run, sorted in BC. Shared between the Zorro instances of the same process through the RunConditionsCache
+struct ZorroTriggerMap {
+  std::vector<ZorroHelper> helpers;
+  std::vector<uint64_t> bcMin;       /// first BC of each range, sorted
+  std::vector<uint64_t> bcMax;       /// last BC of each range
+  std::vector<uint64_t> bcMaxPrefix; /// running maximum of bcMax, to binary search the first range that can overlap with a BC
+  int64_t validFrom = 0;          /// validity of the CCDB object (ms)
+  int64_t validUntil = INT64_MAX; /// validity of the CCDB object (ms)
+};
+
 class Zorro
 {
  public:
   Zorro() = default;
   std::vector<int> initCCDB(o2::ccdb::BasicCCDBManager* ccdb, int runNumber, uint64_t timestamp, std::string tois, int bcTolerance = 500);
+  /// Start fetching in the background the objects of a run (e.g. the next one to be processed), shared by all Zorro instances in the process
+  void prefetch(o2::ccdb::BasicCCDBManager* ccdb, int runNumber, uint64_t timestamp);
   std::bitset<128> fetch(uint64_t bcGlobalId, uint64_t tolerance = 100);
   bool isSelected(uint64_t bcGlobalId, uint64_t tolerance = 100, TH2* toiHisto = nullptr);
   bool isNotSelectedByAny(uint64_t bcGlobalId, uint64_t tolerance = 100);
+  /// Bit i is set if the i-th trigger of interest fired within +-tolerance of the BC. Lookup only: no trigger accounting is done
+  uint64_t getTOImask(uint64_t bcGlobalId, uint64_t tolerance = 100);
+  /// Same as getTOImask for all the BCs of a data frame, which have to be sorted
+  void getTOImasks(const std::vector<uint64_t>& sortedBCs, std::vector<uint64_t>& masks, uint64_t tolerance = 100);
 
   void populateHistRegistry(o2::framework::HistogramRegistry& histRegistry, int runNumber, std::string folderName = "Zorro");
   void populateExternalHists(int runNumber, TH2* zorroHisto = nullptr, TH2* toiHisto = nullptr);
@@ -72,6 +88,9 @@ class Zorro
 
  private:
   void setupHelpers(int64_t timestamp);
+  void setupTOImasks();
+  bool isCovered(uint64_t bcGlobalId, uint64_t tolerance) const;
+  std::pair<size_t, size_t> findCandidateRanges(uint64_t bcGlobalId, uint64_t tolerance) const;
 
   ZorroSummary mZorroSummary{"ZorroSummary", "ZorroSummary"};
 
@@ -88,14 +107,17 @@ class Zorro
 
   int mBCtolerance = 100;
   uint64_t mLastBCglobalId = 0;
-  uint64_t mLastSelectedIdx = 0;
+  uint64_t mLastSelectedIdx = UINT64_MAX; /// First BC range overlapping with the last selected BC
   TH1D* mScalers = nullptr;
   TH1D* mSelections = nullptr;
   TH1D* mInspectedTVX = nullptr;
+  std::shared_ptr<TH1D> mScalersPtr;      /// Ownership shared with the RunConditionsCache
+  std::shared_ptr<TH1D> mSelectionsPtr;   /// Ownership shared with the RunConditionsCache
+  std::shared_ptr<TH1D> mInspectedTVXPtr; /// Ownership shared with the RunConditionsCache
   std::bitset<128> mLastResult;
   std::vector<bool> mAccountedBCranges; /// Avoid double accounting of inspected BC ranges
-  std::vector<o2::dataformats::IRFrame> mBCranges;
-  std::vector<ZorroHelper>* mZorroHelpers = nullptr;
+  std::vector<uint64_t> mTOImasks;      /// Triggers of interest fired in each BC range
+  std::shared_ptr<const ZorroTriggerMap> mTriggerMap;
   std::vector<std::string> mTOIs;
   std::vector<int> mTOIidx;
   std::vector<int> mTOIcounts;
@@ -11,12 +11,20 @@
 
 #include "ZorroSummary.h"
 
+#include <CommonUtils/StringUtils.h>
+
 #include <TCollection.h>
+#include <TH2.h>
 #include <TObject.h>
+#include <TString.h>
 
 #include <RtypesCore.h>
 
+#include <algorithm>
 #include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 void ZorroSummary::Copy(TObject& c) const
 {
@@ -39,36 +47,111 @@ Long64_t ZorroSummary::Merge(TCollection* list)
       continue;
     }
     n++;
-    auto& analysedToiCounters = entry->getAnalysedTOIcounters();
-    for (const auto& [runNumber, currentAnalysedToiCounters] : analysedToiCounters) {
-      if (mAnalysedTOIcounters.find(runNumber) == mAnalysedTOIcounters.end()) {
-        mAnalysedTOIcounters[runNumber] = currentAnalysedToiCounters;
-        mTVXcounters[runNumber] = entry->getTVXcounters().at(runNumber);
-        mTOIcounters[runNumber] = entry->getTOIcounters().at(runNumber);
-      } else {
-        auto& thisCounters = mAnalysedTOIcounters[runNumber];
-        for (std::size_t i = 0; i < thisCounters.size(); ++i) {
-          thisCounters[i] += currentAnalysedToiCounters[i];
-        }
-      }
-    }
+    mergeRuns(*entry);
   }
   return n;
 }
 
+int ZorroSummary::findOrInsertRun(int runNumber)
+{
+  auto it = std::lower_bound(mRunNumbers.begin(), mRunNumbers.end(), runNumber);
+  const int iRun = it - mRunNumbers.begin();
+  if (it != mRunNumbers.end() && *it == runNumber) {
+    return iRun;
+  }
+  mRunNumbers.insert(it, runNumber);
+  mRunTVXcounters.insert(mRunTVXcounters.begin() + iRun, 0.);
+  mRunTOIcounters.insert(mRunTOIcounters.begin() + iRun * mNtois, mNtois, 0.);
+  mRunAnalysedTOIcounters.insert(mRunAnalysedTOIcounters.begin() + iRun * mNtois, mNtois, 0ull);
+  return iRun;
+}
+
+void ZorroSummary::mergeRuns(const ZorroSummary& other)
+{
+  // both blocks are sorted by run number: one linear pass, the analysed counters of the common runs are summed
+  // and the TVX and TOI counters (the same for all the jobs of a run) are taken from the first object having the run
+  const auto& otherRuns = other.getRunNumbers();
+  std::vector<int> runNumbers;
+  std::vector<double> tvxCounters, toiCounters;
+  std::vector<ULong64_t> analysedToiCounters;
+  const size_t nRuns = mRunNumbers.size() + otherRuns.size();
+  runNumbers.reserve(nRuns);
+  tvxCounters.reserve(nRuns);
+  toiCounters.reserve(nRuns * mNtois);
+  analysedToiCounters.reserve(nRuns * mNtois);
+  size_t iThis{0}, iOther{0};
+  while (iThis < mRunNumbers.size() || iOther < otherRuns.size()) {
+    const bool takeThis = iOther == otherRuns.size() || (iThis < mRunNumbers.size() && mRunNumbers[iThis] <= otherRuns[iOther]);
+    const bool common = takeThis && iOther < otherRuns.size() && mRunNumbers[iThis] == otherRuns[iOther];
+    const auto& source = takeThis ? *this : other;
+    const size_t iSource = takeThis ? iThis : iOther;
+    runNumbers.push_back(source.mRunNumbers[iSource]);
+    tvxCounters.push_back(source.mRunTVXcounters[iSource]);
+    for (int i = 0; i < mNtois; ++i) {
+      toiCounters.push_back(source.mRunTOIcounters[iSource * mNtois + i]);
+      analysedToiCounters.push_back(source.mRunAnalysedTOIcounters[iSource * mNtois + i] + (common ? other.mRunAnalysedTOIcounters[iOther * mNtois + i] : 0ull));
+    }
+    iThis += takeThis;
+    iOther += !takeThis || common;
+  }
+  mRunNumbers.swap(runNumbers);
+  mRunTVXcounters.swap(tvxCounters);
+  mRunTOIcounters.swap(toiCounters);
+  mRunAnalysedTOIcounters.swap(analysedToiCounters);
+  mCurrentRunIndex = -1;
+}
+
+void ZorroSummary::fillFromMaps(const std::unordered_map<int, double>& tvxCounters, const std::unordered_map<int, std::vector<double>>& toiCounters, const std::unordered_map<int, std::vector<ULong64_t>>& analysedToiCounters)
+{
+  mRunNumbers.clear();
+  mRunTVXcounters.clear();
+  mRunTOIcounters.clear();
+  mRunAnalysedTOIcounters.clear();
+  for (const auto& [runNumber, counters] : analysedToiCounters) {
+    const int iRun = findOrInsertRun(runNumber);
+    auto tvx = tvxCounters.find(runNumber);
+    auto toi = toiCounters.find(runNumber);
+    mRunTVXcounters[iRun] = tvx != tvxCounters.end() ? tvx->second : 0.;
+    for (int i = 0; i < mNtois; ++i) {
+      mRunTOIcounters[iRun * mNtois + i] = (toi != toiCounters.end() && i < static_cast<int>(toi->second.size())) ? toi->second[i] : 0.;
+      mRunAnalysedTOIcounters[iRun * mNtois + i] = i < static_cast<int>(counters.size()) ? counters[i] : 0ull;
+    }
+  }
+  mCurrentRunIndex = -1;
+}
+
 double ZorroSummary::getNormalisationFactor(int toiId) const
 {
   double totalTOI{0.}, totalTVX{0.};
   ULong64_t totalAnalysedTOI{0};
-  for (const auto& [runNumber, toiCounters] : mTOIcounters) {
-    totalTOI += toiCounters.at(toiId);
-  }
-  for (const auto& [runNumber, tvxCounters] : mTVXcounters) {
-    totalTVX += tvxCounters;
-  }
-  for (const auto& [runNumber, analysedTOIcounters] : mAnalysedTOIcounters) {
-    totalAnalysedTOI += analysedTOIcounters.at(toiId);
+  for (size_t iRun{0}; iRun < mRunNumbers.size(); ++iRun) {
+    totalTOI += mRunTOIcounters[iRun * mNtois + toiId];
+    totalTVX += mRunTVXcounters[iRun];
+    totalAnalysedTOI += mRunAnalysedTOIcounters[iRun * mNtois + toiId];
   }
 
   return totalTVX * totalAnalysedTOI / totalTOI;
 }
+
+TH2D* ZorroSummary::createRunHistogram(const char* name) const
+{
+  const int nRuns = mRunNumbers.size();
+  const std::vector<std::string> toiNames = o2::utils::Str::tokenize(mTOInames, ',');
+  auto* histo = new TH2D(name, GetTitle(), std::max(nRuns, 1), -0.5, std::max(nRuns, 1) - 0.5, 1 + 2 * mNtois, -0.5, 2 * mNtois + 0.5);
+  histo->SetDirectory(nullptr);
+  histo->GetYaxis()->SetBinLabel(1, "inspected TVX");
+  for (int i = 0; i < mNtois; ++i) {
+    const char* toiName = i < static_cast<int>(toiNames.size()) ? toiNames[i].data() : "";
+    histo->GetYaxis()->SetBinLabel(i + 2, Form("%s selections", toiName));
+    histo->GetYaxis()->SetBinLabel(i + 2 + mNtois, Form("%s analysed", toiName));
+  }
+  for (int iRun = 0; iRun < nRuns; ++iRun) {
+    histo->GetXaxis()->SetBinLabel(iRun + 1, Form("%d", mRunNumbers[iRun]));
+    histo->SetBinContent(iRun + 1, 1, mRunTVXcounters[iRun]);
+    for (int i = 0; i < mNtois; ++i) {
+      histo->SetBinContent(iRun + 1, i + 2, mRunTOIcounters[iRun * mNtois + i]);
+      histo->SetBinContent(iRun + 1, i + 2 + mNtois, mRunAnalysedTOIcounters[iRun * mNtois + i]);
+    }
+  }
+  return histo;
+}
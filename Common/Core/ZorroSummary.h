@@ -22,6 +22,8 @@
 #include <unordered_map>
 #include <vector>
 
+class TH2D;
+
 class ZorroSummary : public TNamed
 {
  public:
@@ -44,40 +46,56 @@ class ZorroSummary : public TNamed
   }
   void setupRun(int runNumber, double tvxCountes, const std::vector<double>& toiCounters)
   {
-    if (mRunNumber == runNumber) {
+    if (mRunNumber == runNumber && mCurrentRunIndex >= 0) {
       return;
     }
     mRunNumber = runNumber;
-    mTVXcounters[runNumber] = tvxCountes;
-    mTOIcounters[runNumber] = toiCounters;
-    mAnalysedTOIcounters.try_emplace(runNumber, std::vector<ULong64_t>(mNtois, 0ull));
-    mCurrentAnalysedTOIcounters = &mAnalysedTOIcounters[runNumber];
+    mCurrentRunIndex = findOrInsertRun(runNumber);
+    mRunTVXcounters[mCurrentRunIndex] = tvxCountes;
+    for (int i = 0; i < mNtois; ++i) {
+      mRunTOIcounters[mCurrentRunIndex * mNtois + i] = i < static_cast<int>(toiCounters.size()) ? toiCounters[i] : 0.;
+    }
   }
   double getNormalisationFactor(int toiId) const;
   void increaseTOIcounter(int runNumber, int toiId)
   {
-    if (runNumber != mRunNumber) {
+    if (runNumber != mRunNumber || mCurrentRunIndex < 0) {
       return;
     }
-    mCurrentAnalysedTOIcounters->at(toiId)++;
+    mRunAnalysedTOIcounters[mCurrentRunIndex * mNtois + toiId]++;
   }
 
+  /// Histogram of the counters, one column per run (in run number order) and, along y, the inspected TVX
+  /// followed by the TOI and analysed TOI counters of each TOI. The caller owns the histogram
+  TH2D* createRunHistogram(const char* name = "ZorroSummaryRuns") const;
+
+  /// Fills the counter block from the per-run maps of the first version of the class
+  void fillFromMaps(const std::unordered_map<int, double>& tvxCounters, const std::unordered_map<int, std::vector<double>>& toiCounters, const std::unordered_map<int, std::vector<ULong64_t>>& analysedToiCounters);
+
   const auto& getTOInames() const { return mTOInames; }
-  const auto& getTOIcounters() const { return mTOIcounters; }
-  const auto& getTVXcounters() const { return mTVXcounters; }
-  const auto& getAnalysedTOIcounters() const { return mAnalysedTOIcounters; }
+  int getNtois() const { return mNtois; }
+  /// The counters are stored in one block per kind, ordered by run number: run iRun is getRunNumbers()[iRun],
+  /// its TVX counter is getTVXcounters()[iRun] and its counter of the TOI i is getTOIcounters()[iRun * getNtois() + i]
+  const auto& getRunNumbers() const { return mRunNumbers; }
+  const auto& getTOIcounters() const { return mRunTOIcounters; }
+  const auto& getTVXcounters() const { return mRunTVXcounters; }
+  const auto& getAnalysedTOIcounters() const { return mRunAnalysedTOIcounters; }
 
  private:
-  int mRunNumber = 0;                                            //! Run currently being analysed
-  std::vector<ULong64_t>* mCurrentAnalysedTOIcounters = nullptr; //! Analysed TOI counters for the current run
+  int findOrInsertRun(int runNumber);
+  void mergeRuns(const ZorroSummary& other);
+
+  int mRunNumber = 0;        //! Run currently being analysed
+  int mCurrentRunIndex = -1; //! Position of the current run in the counter block
 
   int mNtois = 0;
   std::string mTOInames;
-  std::unordered_map<int, std::vector<ULong64_t>> mAnalysedTOIcounters;
-  std::unordered_map<int, std::vector<double>> mTOIcounters;
-  std::unordered_map<int, double> mTVXcounters;
+  std::vector<int> mRunNumbers;                   // sorted run numbers
+  std::vector<double> mRunTVXcounters;            // inspected TVX of each run
+  std::vector<double> mRunTOIcounters;            // TOI counters, mNtois per run
+  std::vector<ULong64_t> mRunAnalysedTOIcounters; // analysed TOI counters, mNtois per run
 
-  ClassDef(ZorroSummary, 1);
+  ClassDef(ZorroSummary, 2);
 };
 
 #endif // EVENTFILTERING_ZORROSUMMARY_H_
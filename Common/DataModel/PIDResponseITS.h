@@ -31,8 +31,10 @@
 #include <Framework/Logger.h>
 #include <ReconstructionDataFormats/PID.h>
 
+#include <array>
 #include <cmath>
 #include <cstdint>
+#include <utility>
 
 namespace o2::aod
 {
@@ -66,10 +68,12 @@ struct ITSResponse {
     static constexpr float inverseMass = 1. / o2::track::pid_constants::sMasses[id];
     // static constexpr float charge = static_cast<float>(o2::track::pid_constants::sCharges[id]);
     const float bg = momentum * inverseMass;
-    if (id == o2::track::PID::Helium3 || id == o2::track::PID::Alpha) {
-      return (mITSRespParamsZ2[0] / (std::pow(bg, mITSRespParamsZ2[1])) + mITSRespParamsZ2[2]);
+    constexpr bool isZ2 = (id == o2::track::PID::Helium3 || id == o2::track::PID::Alpha);
+    float value;
+    if (mUseResponseTables && interpolate(mExpSignalTables[isZ2], bg, value)) {
+      return value;
     }
-    return (mITSRespParams[0] / (std::pow(bg, mITSRespParams[1])) + mITSRespParams[2]);
+    return expSignalFromBetaGamma(bg, isZ2);
   }
 
   template <o2::track::PID::ID id>
@@ -78,24 +82,42 @@ struct ITSResponse {
     static constexpr float inverseMass = 1. / o2::track::pid_constants::sMasses[id];
     // static constexpr float charge = static_cast<float>(o2::track::pid_constants::sCharges[id]);
     const float bg = momentum * inverseMass;
-    if (id == o2::track::PID::Helium3 || id == o2::track::PID::Alpha) {
-      return mResolutionParamsZ2[1] > -999.0 ? mResolutionParamsZ2[0] * std::erf((bg - mResolutionParamsZ2[1]) / mResolutionParamsZ2[2]) : mResolutionParamsZ2[0];
+    constexpr bool isZ2 = (id == o2::track::PID::Helium3 || id == o2::track::PID::Alpha);
+    float value;
+    if (mUseResponseTables && interpolate(mExpResolutionTables[isZ2], bg, value)) {
+      return value;
     }
-    return mResolutionParams[1] > -999.0 ? mResolutionParams[0] * std::erf((bg - mResolutionParams[1]) / mResolutionParams[2]) : mResolutionParams[0];
+    return expResolutionFromBetaGamma(bg, isZ2);
   }
 
+  /// Nsigma for a track with the average cluster size and the cos(lambda) already computed
   template <o2::track::PID::ID id>
-  static float nSigmaITS(uint32_t itsClusterSizes, float momentum, float eta)
+  static float nSigmaITS(float averageCoslInv, float momentum)
   {
     unsigned int charge = (id == o2::track::PID::Helium3 || id == o2::track::PID::Alpha) ? 2 : 1;
     momentum *= charge;
     const float exp = expSignal<id>(momentum);
+    const float resolution = expResolution<id>(momentum) * exp;
+    return (averageCoslInv - exp) / resolution;
+  }
+
+  template <o2::track::PID::ID id>
+  static float nSigmaITS(uint32_t itsClusterSizes, float momentum, float eta)
+  {
     const float average = averageClusterSize(itsClusterSizes);
     const float coslInv = 1. / std::cosh(eta);
-    const float resolution = expResolution<id>(momentum) * exp;
-    return (average * coslInv - exp) / resolution;
+    return nSigmaITS<id>(average * coslInv, momentum);
   };
 
+  /// Nsigma of all the mass hypotheses of a track, the cluster sizes and the track angle are unpacked only once
+  static void nSigmaITSAllSpecies(uint32_t itsClusterSizes, float momentum, float eta, std::array<float, o2::track::PID::NIDs>& nSigmas)
+  {
+    const float averageCoslInv = averageClusterSize(itsClusterSizes) / std::cosh(eta);
+    [&]<std::size_t... ids>(std::index_sequence<ids...>) {
+      ((nSigmas[ids] = nSigmaITS<static_cast<o2::track::PID::ID>(ids)>(averageCoslInv, momentum)), ...);
+    }(std::make_index_sequence<o2::track::PID::NIDs>{});
+  }
+
   template <o2::track::PID::ID id, typename T>
   static float nSigmaITS(const T& track)
   {
@@ -123,6 +145,19 @@ struct ITSResponse {
     mResolutionParamsZ2[0] = p0_res_Z2;
     mResolutionParamsZ2[1] = p1_res_Z2;
     mResolutionParamsZ2[2] = p2_res_Z2;
+    if (mUseResponseTables) {
+      fillResponseTables();
+    }
+  }
+
+  /// Evaluate the expected signal and resolution by interpolation in tables on a log(beta gamma) grid, filled from the current parameters.
+  /// Outside of the grid the parametrisation is evaluated directly
+  static void setUseResponseTables(bool useTables)
+  {
+    mUseResponseTables = useTables;
+    if (useTables) {
+      fillResponseTables();
+    }
   }
 
   static void setMCDefaultParameters()
@@ -165,14 +200,66 @@ struct ITSResponse {
                   p0_Z2, p1_Z2, p2_Z2,
                   p0_res, p1_res, p2_res,
                   p0_res_Z2, p1_res_Z2, p2_res_Z2);
+    bool useResponseTables = false;
+    if (getTaskOptionValue(initContext, "its-pid", "useResponseTables", useResponseTables, false)) {
+      setUseResponseTables(useResponseTables);
+    }
   }
 
  private:
+  static float expSignalFromBetaGamma(float bg, bool isZ2)
+  {
+    const auto& params = isZ2 ? mITSRespParamsZ2 : mITSRespParams;
+    return (params[0] / (std::pow(bg, params[1])) + params[2]);
+  }
+
+  static float expResolutionFromBetaGamma(float bg, bool isZ2)
+  {
+    const auto& params = isZ2 ? mResolutionParamsZ2 : mResolutionParams;
+    return params[1] > -999.0 ? params[0] * std::erf((bg - params[1]) / params[2]) : params[0];
+  }
+
+  // Grid of the response tables, regular in log(beta gamma)
+  static constexpr int NNodesBetaGamma = 3000;
+  static constexpr float MinBetaGamma = 0.01f;
+  static constexpr float MaxBetaGamma = 1.e4f;
+  using ResponseTable = std::array<float, NNodesBetaGamma>;
+
+  static void fillResponseTables()
+  {
+    const float logMin = std::log(MinBetaGamma);
+    const float step = (std::log(MaxBetaGamma) - logMin) / (NNodesBetaGamma - 1);
+    for (int isZ2 = 0; isZ2 < 2; isZ2++) {
+      for (int i = 0; i < NNodesBetaGamma; i++) {
+        const float bg = std::exp(logMin + i * step);
+        mExpSignalTables[isZ2][i] = expSignalFromBetaGamma(bg, isZ2);
+        mExpResolutionTables[isZ2][i] = expResolutionFromBetaGamma(bg, isZ2);
+      }
+    }
+  }
+
+  static bool interpolate(const ResponseTable& table, float bg, float& value)
+  {
+    static const float logMin = std::log(MinBetaGamma);
+    static const float invStep = (NNodesBetaGamma - 1) / (std::log(MaxBetaGamma) - logMin);
+    const float u = (std::log(bg) - logMin) * invStep;
+    if (!(u >= 0.f && u < NNodesBetaGamma - 1)) {
+      return false;
+    }
+    const int i = static_cast<int>(u);
+    const float f = u - i;
+    value = table[i] + f * (table[i + 1] - table[i]);
+    return true;
+  }
+
   static std::array<float, 3> mITSRespParams;
   static std::array<float, 3> mITSRespParamsZ2;
   static std::array<float, 3> mResolutionParams;
   static std::array<float, 3> mResolutionParamsZ2;
   static bool mIsInitialized;
+  static bool mUseResponseTables;
+  static std::array<ResponseTable, 2> mExpSignalTables;     // expected signal for charge 1 and 2
+  static std::array<ResponseTable, 2> mExpResolutionTables; // relative resolution for charge 1 and 2
 };
 
 std::array<float, 3> ITSResponse::mITSRespParams = {1.18941, 1.53792, 1.69961};
@@ -181,6 +268,9 @@ std::array<float, 3> ITSResponse::mITSRespParamsZ2 = {2.35117, 1.80347, 5.14355}
 std::array<float, 3> ITSResponse::mResolutionParams = {1.94669e-01, -2.08616e-01, 1.30753};
 std::array<float, 3> ITSResponse::mResolutionParamsZ2 = {0.09, -999., -999.};
 bool ITSResponse::mIsInitialized = false;
+bool ITSResponse::mUseResponseTables = false;
+std::array<ITSResponse::ResponseTable, 2> ITSResponse::mExpSignalTables{};
+std::array<ITSResponse::ResponseTable, 2> ITSResponse::mExpResolutionTables{};
 
 namespace pidits
 {
@@ -131,8 +131,11 @@ struct bayesPid {
   Configurable<int> pidHe{"pid-he", -1, {"Produce PID information for the Helium3 mass hypothesis, overrides the automatic setup: the corresponding table can be set off (0) or on (1)"}};
   Configurable<int> pidAl{"pid-al", -1, {"Produce PID information for the Alpha mass hypothesis, overrides the automatic setup: the corresponding table can be set off (0) or on (1)"}};
 
-  std::array<std::array<float, PID::NIDs>, kNProb> Probability; /// Probabilities for all the cases defined in ProbType
-  std::vector<PID::ID> enabledSpecies;                          /// Enabled species
+  std::array<std::array<float, PID::NIDs>, kNProb> Probability;  /// Probabilities for all the cases defined in ProbType
+  std::vector<PID::ID> enabledSpecies;                           /// Enabled species
+  std::array<bool, PID::NIDs> isEnabledSpecies{false};           /// Enabled species, indexed by PID::ID
+  std::array<std::vector<float>, PID::NIDs> mergedProbabilities; /// Merged probabilities of the tracks of the data frame, one column per enabled species
+  std::vector<float> bayesNormalisations;                        /// Sum over the enabled species of the merged probability times the prior, per track
 
   /// Checker of the species that are enabled and initializer of the probabilities
   template <ProbType detIndex, o2::track::PID::ID pid>
@@ -143,15 +146,9 @@ struct bayesPid {
       LOG(debug) << "Detector " << detectorName[detIndex] << " disabled";
       return false; // Setting the probability to 1 if the detector is disabled
     }
-    LOG(debug) << "Detector " << detectorName[detIndex] << " enabled with " << enabledSpecies.size() << " species";
-
-    for (const auto enabledPid : enabledSpecies) { // Checking that the species is enabled
-      LOG(debug) << "Testing " << PID::getName(enabledPid) << " " << static_cast<int>(enabledPid) << " vs " << static_cast<int>(pid);
-      if (enabledPid == pid) {
-        LOG(debug) << "Particle " << PID::getName(enabledPid) << " enabled";
-        Probability[detIndex][pid] = 1.f / enabledSpecies.size(); // set flat distribution (no decision yet)
-        return true;
-      }
+    if (isEnabledSpecies[pid]) { // Checking that the species is enabled
+      Probability[detIndex][pid] = 1.f / enabledSpecies.size(); // set flat distribution (no decision yet)
+      return true;
     }
     return false;
   }
@@ -242,6 +239,9 @@ struct bayesPid {
     } else { // All ok
       LOG(info) << enabledSpecies.size() << " species enabled for the Bayesian PID computation";
     }
+    for (const auto enabledPid : enabledSpecies) {
+      isEnabledSpecies[enabledPid] = true;
+    }
     // Getting the parametrization parameters
     ccdb->setURL(url.value);
     ccdb->setTimestamp(timestamp.value);
@@ -402,46 +402,37 @@ struct bayesPid {
     LOG(debug) << "For " << pid_constants::sNames[pid] << " with signal " << track.tofSignal() << " computing exp time " << expTime << " and sigma " << sig << " and nsigma " << nsigmas << " probability " << Probability[kTOF][pid];
   }
 
-  /// Calculate probabilities from all enabled detectors and species
-  void MergeProbabilities()
+  /// Calculate probabilities from all enabled detectors and species, stored for the track iTrack of the data frame
+  void MergeProbabilities(int64_t iTrack)
   {
-    LOG(debug) << "Merging probabilities";
-
-    float probSum[kNDet + 1] = {0.f}; /// Summed probabilities for all detectors + 1 for the sum of all detectors
-
     for (const auto enabledPid : enabledSpecies) {
-      Probability[kMerged][enabledPid] = 1.f;
+      float merged = 1.f;
       for (int det = 0; det < kNDet; det++) {
-        probSum[det] += Probability[det][enabledPid];
-        Probability[kMerged][enabledPid] *= Probability[det][enabledPid];
+        merged *= Probability[det][enabledPid];
       }
-      probSum[kNDet] += Probability[kMerged][enabledPid];
-      LOG(debug) << "For " << PID::getName(enabledPid);
-      for (int det = 0; det < kNDet; det++) {
-        if (enabledDet[det]) {
-          LOG(debug) << "\t" << detectorName[det] << " Probability " << Probability[det][enabledPid];
-        }
-      }
-      LOG(debug) << "\tCombined: " << Probability[kMerged][enabledPid];
+      mergedProbabilities[enabledPid][iTrack] = merged;
+      LOG(debug) << "For " << PID::getName(enabledPid) << " combined probability " << merged;
     }
-    for (int det = 0; det < kNDet; det++) {
-      if (enabledDet[det]) {
-        LOG(debug) << "\tSum " << detectorName[det] << " Probability " << probSum[det];
-      }
-    }
-    LOG(debug) << "\tSum combined: " << probSum[kNDet];
   }
 
-  /// Calculate Bayesian probabilities
-  void ComputeBayesProbabilities()
+  /// Calculate the normalisations of the Bayesian probabilities of all the tracks of the data frame, one species at a time
+  void ComputeBayesNormalisations(int64_t nTracks)
   {
-    LOG(debug) << "Computing bayes probabilities";
-
-    float sum = 0.;
+    bayesNormalisations.assign(nTracks, 0.f);
+    float* normalisations = bayesNormalisations.data();
     for (const auto enabledPid : enabledSpecies) {
-      LOG(debug) << "Adding " << Probability[kMerged][enabledPid] << " with prior " << Probability[kPrior][enabledPid];
-      sum += Probability[kMerged][enabledPid] * Probability[kPrior][enabledPid];
+      const float prior = Probability[kPrior][enabledPid];
+      const float* merged = mergedProbabilities[enabledPid].data();
+      for (int64_t iTrack = 0; iTrack < nTracks; iTrack++) {
+        normalisations[iTrack] += merged[iTrack] * prior;
+      }
     }
+  }
+
+  /// Calculate Bayesian probabilities of the track iTrack of the data frame
+  void ComputeBayesProbabilities(int64_t iTrack)
+  {
+    const float sum = bayesNormalisations[iTrack];
     if (sum <= 0) {
       // LOG(warning) << "Invalid probability densities or prior probabilities";
       for (uint64_t i = 0; i < Probability[kBayesian].size(); i++) {
@@ -450,11 +441,8 @@ struct bayesPid {
       return;
     }
     for (const auto enabledPid : enabledSpecies) {
-      Probability[kBayesian][enabledPid] = Probability[kMerged][enabledPid] * Probability[kPrior][enabledPid] / sum;
-      // if (probDensityMism) {
-      //   probDensityMism[enabledPid] *= Probability[kPrior][enabledPid] / sum;
-      // }
-      LOG(debug) << "For " << PID::getName(enabledPid) << " merged prob. " << Probability[kMerged][enabledPid] << " prior " << Probability[kPrior][enabledPid] << " sum " << sum << " bayesian Probability: " << Probability[kBayesian][enabledPid];
+      Probability[kBayesian][enabledPid] = mergedProbabilities[enabledPid][iTrack] * Probability[kPrior][enabledPid] / sum;
+      LOG(debug) << "For " << PID::getName(enabledPid) << " prior " << Probability[kPrior][enabledPid] << " sum " << sum << " bayesian Probability: " << Probability[kBayesian][enabledPid];
     }
   }
 
@@ -480,7 +468,12 @@ struct bayesPid {
     makeTable(pidHe, tablePIDHe);
     makeTable(pidAl, tablePIDAl);
 
-    for (auto const& trk : tracks) { // Loop on Tracks
+    for (const auto enabledPid : enabledSpecies) {
+      mergedProbabilities[enabledPid].resize(tracks.size());
+    }
+
+    int64_t iTrack = 0;
+    for (auto const& trk : tracks) { // Loop on Tracks computing the detector probabilities
 
       auto collision = collisions.iteratorAt(trk.collisionId());
       ComputeTPCProbability<PID::Electron>(collision, trk);
@@ -503,9 +496,14 @@ struct bayesPid {
       ComputeTOFProbability<PID::Helium3>(trk);
       ComputeTOFProbability<PID::Alpha>(trk);
 
-      MergeProbabilities();
+      MergeProbabilities(iTrack++);
+    }
+
+    // Normalisations for all the tracks at once, then the tables in the order of the tracks
+    ComputeBayesNormalisations(tracks.size());
 
-      ComputeBayesProbabilities();
+    for (iTrack = 0; iTrack < tracks.size(); iTrack++) {
+      ComputeBayesProbabilities(iTrack);
 
       if (pidEl == 1) {
         tablePIDEl(Probability[kBayesian][PID::Electron] * 100.f);
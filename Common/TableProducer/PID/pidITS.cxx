@@ -65,6 +65,7 @@ struct itsPid {
                                               {defaultParameters[0], nCases, nParameters, casesNames, parameterNames},
                                               "Response parameters"};
   Configurable<bool> getFromCCDB{"getFromCCDB", false, "Get the parameters from CCDB"};
+  Configurable<bool> useResponseTables{"useResponseTables", false, "Interpolate the expected signal and resolution in tables on a beta gamma grid instead of evaluating the parametrisation for each track"};
 
   Service<o2::ccdb::BasicCCDBManager> ccdb;
   Configurable<std::string> paramfile{"param-file", "", "Path to the parametrization object, if empty the parametrization is not taken from file"};
@@ -96,6 +97,7 @@ struct itsPid {
                                           itsParams->get(dataType, "ResolutionPar2_Z2"),
                                           itsParams->get(dataType, "ResolutionPar3_Z2"));
     }
+    o2::aod::ITSResponse::setUseResponseTables(useResponseTables);
   }
 
   /// Dummy process function for BCs, needed in case both Run2 and Run3 process functions are disabled
@@ -612,6 +612,8 @@ struct tofPidMerge {
 
   Configurable<bool> enableQaHistograms{"enableQaHistograms", false, "Flag to enable the QA histograms"};
   Configurable<bool> enableTOFParamsForBetaMass{"enableTOFParamsForBetaMass", false, "Flag to use TOF parameters for TOF Beta and Mass"};
+  Configurable<bool> fillBetaMassWithNsigma{"fillBetaMassWithNsigma", false, "Fill the Run 3 beta and mass tables in the same pass on the tracks as the nsigma tables, instead of processRun3BetaM"};
+  bool fillBetaMassInRun3 = false; // beta and mass tables filled by processRun3
 
   // Configuration flags to include and exclude particle hypotheses
   Configurable<LabeledArray<int>> enableParticle{"enableParticle",
@@ -627,6 +629,35 @@ struct tofPidMerge {
   // Running variables
   std::vector<int> mEnabledParticles;     // Vector of enabled PID hypotheses to loop on when making tables
   std::vector<int> mEnabledParticlesFull; // Vector of enabled PID hypotheses to loop on when making full tables
+  std::array<bool, nSpecies> mIsEnabled{};     // Enabled PID hypotheses for tables, by index
+  std::array<bool, nSpecies> mIsEnabledFull{}; // Enabled PID hypotheses for full tables, by index
+
+  // Track columns used in the Run 3 nsigma computation, filled once per data frame and shared by all mass hypotheses
+  struct TrackColumns {
+    std::vector<uint8_t> hasCollision;
+    std::vector<uint8_t> hasTOF;
+    std::vector<float> p;
+    std::vector<float> eta;
+    std::vector<float> length;
+    std::vector<float> tofSignal;
+    std::vector<float> evTime;
+    std::vector<float> evTimeErr;
+    std::vector<float> expMom;     // TOF expected momentum corrected for the charge dependent shift
+    std::vector<float> timeShift;  // Eta dependent time shift of the expected time
+    std::vector<float> reso;       // Output of the resolution parametrisation of the current hypothesis
+    std::vector<float> resolution; // Expected resolution of the current hypothesis
+    std::vector<float> nsigma;     // Nsigma of the current hypothesis
+
+    void resize(const size_t n)
+    {
+      for (auto* v : {&hasCollision, &hasTOF}) {
+        v->resize(n);
+      }
+      for (auto* v : {&p, &eta, &length, &tofSignal, &evTime, &evTimeErr, &expMom, &timeShift, &reso, &resolution, &nsigma}) {
+        v->resize(n);
+      }
+    }
+  } mColumns;
   void init(o2::framework::InitContext& initContext)
   {
     LOG(debug) << "Initializing the TOF PID Merge task";
@@ -638,6 +669,7 @@ struct tofPidMerge {
       enableFlagIfTableRequired(initContext, "pidTOF" + particleNames[i], f);
       if (f == 1) {
         mEnabledParticles.push_back(i);
+        mIsEnabled[i] = true;
       }
 
       // Then checking full tables
@@ -645,6 +677,7 @@ struct tofPidMerge {
       enableFlagIfTableRequired(initContext, "pidTOFFull" + particleNames[i], f);
       if (f == 1) {
         mEnabledParticlesFull.push_back(i);
+        mIsEnabledFull[i] = true;
       }
     }
     if (mEnabledParticlesFull.size() == 0 && mEnabledParticles.size() == 0) {
@@ -723,6 +756,11 @@ struct tofPidMerge {
       if (!doprocessRun2BetaM && !doprocessRun3BetaM) {
         LOG(fatal) << "Neither processRun2BetaM nor processRun3BetaM are enabled. Pick one of the two";
       }
+      if (fillBetaMassWithNsigma && doprocessRun3 && doprocessRun3BetaM) {
+        LOG(info) << "Filling the beta and mass tables in processRun3, disabling processRun3BetaM";
+        doprocessRun3BetaM.value = false;
+        fillBetaMassInRun3 = true;
+      }
     }
   }
 
@@ -885,20 +923,70 @@ struct tofPidMerge {
 
   template <o2::track::PID::ID pid>
   using ResponseImplementation = o2::pid::tof::ExpTimes<Run3TrksWtofWevTime::iterator, pid>;
+
+  /// Computes the expected resolution and nsigma of one mass hypothesis on the track columns and fills its tables
+  /// The loop on the tracks uses the coefficients of the parametrisation of the current run and has no branches, only the resolution function is evaluated track by track
+  template <o2::track::PID::ID pid, typename TableType, typename TableFullType>
+  void fillTablesFromColumns(const int pidId, TableType& table, TableFullType& tableFull)
+  {
+    using Response = ResponseImplementation<pid>;
+    const auto& parameters = tofResponse->parameters;
+    const auto coefficients = Response::GetSigmaCoefficients(parameters);
+    const int64_t nTracks = mColumns.p.size();
+    const uint8_t* hasCollision = mColumns.hasCollision.data();
+    const uint8_t* hasTOF = mColumns.hasTOF.data();
+    const float* p = mColumns.p.data();
+    const float* eta = mColumns.eta.data();
+    const float* length = mColumns.length.data();
+    const float* tofSignal = mColumns.tofSignal.data();
+    const float* evTime = mColumns.evTime.data();
+    const float* evTimeErr = mColumns.evTimeErr.data();
+    const float* expMom = mColumns.expMom.data();
+    const float* timeShift = mColumns.timeShift.data();
+    float* reso = mColumns.reso.data();
+    float* resolution = mColumns.resolution.data();
+    float* nsigma = mColumns.nsigma.data();
+
+    for (int64_t i = 0; i < nTracks; i++) {
+      reso[i] = (hasCollision[i] && p[i] > 0) ? parameters.template getResolution<pid>(p[i], eta[i]) : -1.f;
+    }
+    for (int64_t i = 0; i < nTracks; i++) {
+      const float sigma = Response::GetExpectedSigma(coefficients, reso[i], p[i], tofSignal[i], evTimeErr[i]);
+      const float expTime = Response::ComputeExpectedTime(expMom[i], length[i]) + timeShift[i];
+      resolution[i] = sigma;
+      nsigma[i] = hasTOF[i] ? (tofSignal[i] - evTime[i] - expTime) / sigma : o2::pid::tof::defaultReturnValue;
+    }
+
+    // Tracks without collision have no event time, their tables are filled with the default values
+    if (mIsEnabled[pidId]) {
+      for (int64_t i = 0; i < nTracks; i++) {
+        if (!hasCollision[i]) {
+          aod::pidtof_tiny::binning::packInTable(-999.f, table);
+          continue;
+        }
+        aod::pidtof_tiny::binning::packInTable(nsigma[i], table);
+        if (enableQaHistograms) {
+          hnsigma[pidId]->Fill(p[i], nsigma[i]);
+        }
+      }
+    }
+    if (mIsEnabledFull[pidId]) {
+      for (int64_t i = 0; i < nTracks; i++) {
+        if (!hasCollision[i]) {
+          tableFull(-999.f, -999.f);
+          continue;
+        }
+        tableFull(resolution[i], nsigma[i]);
+        if (enableQaHistograms) {
+          hnsigmaFull[pidId]->Fill(p[i], nsigma[i]);
+        }
+      }
+    }
+  }
   void processRun3(Run3TrksWtofWevTime const& tracks,
                    aod::Collisions const&,
                    aod::BCsWithTimestamps const& bcs)
   {
-    constexpr auto responseEl = ResponseImplementation<PID::Electron>();
-    constexpr auto responseMu = ResponseImplementation<PID::Muon>();
-    constexpr auto responsePi = ResponseImplementation<PID::Pion>();
-    constexpr auto responseKa = ResponseImplementation<PID::Kaon>();
-    constexpr auto responsePr = ResponseImplementation<PID::Proton>();
-    constexpr auto responseDe = ResponseImplementation<PID::Deuteron>();
-    constexpr auto responseTr = ResponseImplementation<PID::Triton>();
-    constexpr auto responseHe = ResponseImplementation<PID::Helium3>();
-    constexpr auto responseAl = ResponseImplementation<PID::Alpha>();
-
     tofResponse->processSetup(bcs.iteratorAt(0)); // Update the calibration parameters
 
     for (auto const& pidId : mEnabledParticles) {
@@ -909,137 +997,74 @@ struct tofPidMerge {
       reserveTable(pidId, tracks.size(), true);
     }
 
-    float resolution = 1.f; // Last resolution assigned
-    float nsigma = 0;
-    for (auto const& trk : tracks) { // Loop on all tracks
-      if (!trk.has_collision()) {    // Track was not assigned, cannot compute NSigma (no event time) -> filling with empty table
-        for (auto const& pidId : mEnabledParticles) {
-          makeTableEmpty(pidId, false);
-        }
-        for (auto const& pidId : mEnabledParticlesFull) {
-          makeTableEmpty(pidId, true);
+    // Species independent columns, read once for all the mass hypotheses
+    const auto& parameters = tofResponse->parameters;
+    mColumns.resize(tracks.size());
+    if (fillBetaMassInRun3) {
+      tablePIDBeta.reserve(tracks.size());
+    }
+    int64_t iTrack = 0;
+    for (auto const& trk : tracks) {
+      if (fillBetaMassInRun3) {
+        fillBetaMass(responseBeta, trk);
+      }
+      mColumns.hasCollision[iTrack] = trk.has_collision();
+      mColumns.hasTOF[iTrack] = trk.hasTOF();
+      mColumns.p[iTrack] = trk.p();
+      mColumns.eta[iTrack] = trk.eta();
+      mColumns.length[iTrack] = trk.length();
+      mColumns.tofSignal[iTrack] = trk.tofSignal();
+      mColumns.evTime[iTrack] = trk.tofEvTime();
+      mColumns.evTimeErr[iTrack] = trk.tofEvTimeErr();
+      mColumns.expMom[iTrack] = 0.f;
+      mColumns.timeShift[iTrack] = 0.f;
+      if (trk.has_collision() && trk.hasTOF()) { // Same corrections as in GetCorrectedExpectedSignal
+        const float shift = 1.f + trk.sign() * parameters.getMomentumChargeShift(trk.eta());
+        if (trk.trackType() == o2::aod::track::Run2Track) {
+          mColumns.expMom[iTrack] = trk.tofExpMom() * o2::constants::physics::invLightSpeedCm2PS / shift;
+        } else {
+          mColumns.expMom[iTrack] = trk.tofExpMom() / shift;
+          mColumns.timeShift[iTrack] = parameters.getTimeShift(trk.eta(), trk.sign());
         }
-        continue;
       }
+      iTrack++;
+    }
 
-      for (auto const& pidId : mEnabledParticles) { // Loop on enabled particle hypotheses
-        switch (pidId) {
-          case kIdxEl: {
-            nsigma = responseEl.GetSeparation(tofResponse->parameters, trk);
-            aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDEl);
-            break;
-          }
-          case kIdxMu: {
-            nsigma = responseMu.GetSeparation(tofResponse->parameters, trk);
-            aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDMu);
-            break;
-          }
-          case kIdxPi: {
-            nsigma = responsePi.GetSeparation(tofResponse->parameters, trk);
-            aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDPi);
-            break;
-          }
-          case kIdxKa: {
-            nsigma = responseKa.GetSeparation(tofResponse->parameters, trk);
-            aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDKa);
-            break;
-          }
-          case kIdxPr: {
-            nsigma = responsePr.GetSeparation(tofResponse->parameters, trk);
-            aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDPr);
-            break;
-          }
-          case kIdxDe: {
-            nsigma = responseDe.GetSeparation(tofResponse->parameters, trk);
-            aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDDe);
-            break;
-          }
-          case kIdxTr: {
-            nsigma = responseTr.GetSeparation(tofResponse->parameters, trk);
-            aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDTr);
-            break;
-          }
-          case kIdxHe: {
-            nsigma = responseHe.GetSeparation(tofResponse->parameters, trk);
-            aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDHe);
-            break;
-          }
-          case kIdxAl: {
-            nsigma = responseAl.GetSeparation(tofResponse->parameters, trk);
-            aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDAl);
-            break;
-          }
-          default:
-            LOG(fatal) << "Wrong particle ID for standard tables";
-            break;
-        }
-        if (enableQaHistograms) {
-          hnsigma[pidId]->Fill(trk.p(), nsigma);
-        }
+    for (int pidId = 0; pidId < nSpecies; pidId++) { // Loop on enabled particle hypotheses, each table is filled in one go
+      if (!mIsEnabled[pidId] && !mIsEnabledFull[pidId]) {
+        continue;
       }
-      for (auto const& pidId : mEnabledParticlesFull) { // Loop on enabled particle hypotheses with full tables
-        switch (pidId) {
-          case kIdxEl: {
-            resolution = responseEl.GetExpectedSigma(tofResponse->parameters, trk);
-            nsigma = responseEl.GetSeparation(tofResponse->parameters, trk, resolution);
-            tablePIDFullEl(resolution, nsigma);
-            break;
-          }
-          case kIdxMu: {
-            resolution = responseMu.GetExpectedSigma(tofResponse->parameters, trk);
-            nsigma = responseMu.GetSeparation(tofResponse->parameters, trk, resolution);
-            tablePIDFullMu(resolution, nsigma);
-            break;
-          }
-          case kIdxPi: {
-            resolution = responsePi.GetExpectedSigma(tofResponse->parameters, trk);
-            nsigma = responsePi.GetSeparation(tofResponse->parameters, trk);
-            tablePIDFullPi(resolution, nsigma);
-            break;
-          }
-          case kIdxKa: {
-            resolution = responseKa.GetExpectedSigma(tofResponse->parameters, trk);
-            nsigma = responseKa.GetSeparation(tofResponse->parameters, trk, resolution);
-            tablePIDFullKa(resolution, nsigma);
-            break;
-          }
-          case kIdxPr: {
-            resolution = responsePr.GetExpectedSigma(tofResponse->parameters, trk);
-            nsigma = responsePr.GetSeparation(tofResponse->parameters, trk, resolution);
-            tablePIDFullPr(resolution, nsigma);
-            break;
-          }
-          case kIdxDe: {
-            resolution = responseDe.GetExpectedSigma(tofResponse->parameters, trk);
-            nsigma = responseDe.GetSeparation(tofResponse->parameters, trk, resolution);
-            tablePIDFullDe(resolution, nsigma);
-            break;
-          }
-          case kIdxTr: {
-            resolution = responseTr.GetExpectedSigma(tofResponse->parameters, trk);
-            nsigma = responseTr.GetSeparation(tofResponse->parameters, trk, resolution);
-            tablePIDFullTr(resolution, nsigma);
-            break;
-          }
-          case kIdxHe: {
-            resolution = responseHe.GetExpectedSigma(tofResponse->parameters, trk);
-            nsigma = responseHe.GetSeparation(tofResponse->parameters, trk, resolution);
-            tablePIDFullHe(resolution, nsigma);
-            break;
-          }
-          case kIdxAl: {
-            resolution = responseAl.GetExpectedSigma(tofResponse->parameters, trk);
-            nsigma = responseAl.GetSeparation(tofResponse->parameters, trk, resolution);
-            tablePIDFullAl(resolution, nsigma);
-            break;
-          }
-          default:
-            LOG(fatal) << "Wrong particle ID for full tables";
-            break;
-        }
-        if (enableQaHistograms) {
-          hnsigmaFull[pidId]->Fill(trk.p(), nsigma);
-        }
+      switch (pidId) {
+        case kIdxEl:
+          fillTablesFromColumns<PID::Electron>(pidId, tablePIDEl, tablePIDFullEl);
+          break;
+        case kIdxMu:
+          fillTablesFromColumns<PID::Muon>(pidId, tablePIDMu, tablePIDFullMu);
+          break;
+        case kIdxPi:
+          fillTablesFromColumns<PID::Pion>(pidId, tablePIDPi, tablePIDFullPi);
+          break;
+        case kIdxKa:
+          fillTablesFromColumns<PID::Kaon>(pidId, tablePIDKa, tablePIDFullKa);
+          break;
+        case kIdxPr:
+          fillTablesFromColumns<PID::Proton>(pidId, tablePIDPr, tablePIDFullPr);
+          break;
+        case kIdxDe:
+          fillTablesFromColumns<PID::Deuteron>(pidId, tablePIDDe, tablePIDFullDe);
+          break;
+        case kIdxTr:
+          fillTablesFromColumns<PID::Triton>(pidId, tablePIDTr, tablePIDFullTr);
+          break;
+        case kIdxHe:
+          fillTablesFromColumns<PID::Helium3>(pidId, tablePIDHe, tablePIDFullHe);
+          break;
+        case kIdxAl:
+          fillTablesFromColumns<PID::Alpha>(pidId, tablePIDAl, tablePIDFullAl);
+          break;
+        default:
+          LOG(fatal) << "Wrong particle ID for standard tables";
+          break;
       }
     }
   }
@@ -1207,26 +1232,32 @@ struct tofPidMerge {
   }
   PROCESS_SWITCH(tofPidMerge, processRun2, "Produce Run 2 Nsigma table. Set to off if the tables are not required, or autoset is on", false);
 
+  /// Fills the beta and mass tables for one track
+  template <typename TrackType>
+  void fillBetaMass(const o2::pid::tof::Beta& response, const TrackType& trk)
+  {
+    const float beta = response.GetBeta(trk);
+    if (enableTableBeta) {
+      tablePIDBeta(beta, response.GetExpectedSigma(trk));
+    }
+    if (enableTableMass) {
+      if (enableTOFParamsForBetaMass) {
+        tablePIDTOFMass(o2::pid::tof::TOFMass::GetTOFMass(trk.tofExpMom() / (1.f + trk.sign() * tofResponse->parameters.getMomentumChargeShift(trk.eta())), beta));
+      } else {
+        tablePIDTOFMass(o2::pid::tof::TOFMass::GetTOFMass(trk, beta));
+      }
+    }
+  }
+
   o2::pid::tof::Beta responseBetaRun2;
   void processRun2BetaM(Run2TrksWtofWevTime const& tracks)
   {
     if (!enableTableBeta && !enableTableMass) {
       return;
     }
-    float beta = 0.f;
     tablePIDBeta.reserve(tracks.size());
     for (auto const& trk : tracks) {
-      beta = responseBetaRun2.GetBeta(trk);
-      if (enableTableBeta) {
-        tablePIDBeta(beta, responseBetaRun2.GetExpectedSigma(trk));
-      }
-      if (enableTableMass) {
-        if (enableTOFParamsForBetaMass) {
-          tablePIDTOFMass(o2::pid::tof::TOFMass::GetTOFMass(trk.tofExpMom() / (1.f + trk.sign() * tofResponse->parameters.getMomentumChargeShift(trk.eta())), beta));
-        } else {
-          tablePIDTOFMass(o2::pid::tof::TOFMass::GetTOFMass(trk, beta));
-        }
-      }
+      fillBetaMass(responseBetaRun2, trk);
     }
   }
   PROCESS_SWITCH(tofPidMerge, processRun2BetaM, "Produce Run 2 Beta and Mass table. Set to off if the tables are not required, or autoset is on", false);
@@ -1237,21 +1268,9 @@ struct tofPidMerge {
     if (!enableTableBeta && !enableTableMass) {
       return;
     }
-    float beta = 0.f;
     tablePIDBeta.reserve(tracks.size());
     for (auto const& trk : tracks) {
-      beta = responseBeta.GetBeta(trk);
-      if (enableTableBeta) {
-        tablePIDBeta(beta,
-                     responseBeta.GetExpectedSigma(trk));
-      }
-      if (enableTableMass) {
-        if (enableTOFParamsForBetaMass) {
-          tablePIDTOFMass(o2::pid::tof::TOFMass::GetTOFMass(trk.tofExpMom() / (1.f + trk.sign() * tofResponse->parameters.getMomentumChargeShift(trk.eta())), beta));
-        } else {
-          tablePIDTOFMass(o2::pid::tof::TOFMass::GetTOFMass(trk, beta));
-        }
-      }
+      fillBetaMass(responseBeta, trk);
     }
   }
   PROCESS_SWITCH(tofPidMerge, processRun3BetaM, "Produce Run 3 Beta and Mass table. Set to off if the tables are not required, or autoset is on", false);
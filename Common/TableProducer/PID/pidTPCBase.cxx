@@ -96,6 +96,7 @@ struct DeDxCorrection {
   ctpRateFetcher mRateFetcher;
 
   Str_dEdx_correction str_dedx_correction;
+  std::vector<double> hadronicRatePerCollision;
 
   // void init(InitContext& initContext)
   void init(o2::framework::InitContext&)
@@ -114,21 +115,29 @@ struct DeDxCorrection {
     const uint64_t outTable_size = tracks.size();
     dEdxCorrected.reserve(outTable_size);
 
+    // the hadronic rate is fetched once per collision (and once for the tracks without collision), not for each track
+    hadronicRatePerCollision.resize(cols.size());
+    for (auto const& collision : cols) {
+      auto bc = collision.bc_as<aod::BCsWithTimestamps>();
+      hadronicRatePerCollision[collision.globalIndex()] = mRateFetcher.fetch(ccdb.service, bc.timestamp(), bc.runNumber(), "ZNC hadronic") * 1.e-3; // kHz
+    }
+    double hadronicRateNoCollision = -1.;
+
     for (auto const& trk : tracks) {
       double hadronicRate;
       int multTPC;
       int occupancy;
       if (trk.has_collision()) {
         auto collision = cols.iteratorAt(trk.collisionId());
-        auto bc = collision.bc_as<aod::BCsWithTimestamps>();
-        const int runnumber = bc.runNumber();
-        hadronicRate = mRateFetcher.fetch(ccdb.service, bc.timestamp(), runnumber, "ZNC hadronic") * 1.e-3; // kHz
+        hadronicRate = hadronicRatePerCollision[trk.collisionId()];
         multTPC = collision.multTPC();
         occupancy = collision.trackOccupancyInTimeRange();
       } else {
-        auto bc = bcs.begin();
-        const int runnumber = bc.runNumber();
-        hadronicRate = mRateFetcher.fetch(ccdb.service, bc.timestamp(), runnumber, "ZNC hadronic") * 1.e-3; // kHz
+        if (hadronicRateNoCollision < 0.) {
+          auto bc = bcs.begin();
+          hadronicRateNoCollision = mRateFetcher.fetch(ccdb.service, bc.timestamp(), bc.runNumber(), "ZNC hadronic") * 1.e-3; // kHz
+        }
+        hadronicRate = hadronicRateNoCollision;
         multTPC = 0;
         occupancy = 0;
       }
@@ -285,16 +285,8 @@ struct CentralityTable {
       TList* callst = nullptr;
       if (ccdbConfig.reconstructionPass.value == "") {
         callst = ccdb->getForRun<TList>(ccdbConfig.ccdbPath, bc.runNumber());
-      } else if (ccdbConfig.reconstructionPass.value == "metadata") {
-        std::map<std::string, std::string> metadata;
-        metadata["RecoPassName"] = metadataInfo.get("RecoPassName");
-        LOGF(info, "Loading CCDB for reconstruction pass (from metadata): %s", metadataInfo.get("RecoPassName"));
-        callst = ccdb->getSpecificForRun<TList>(ccdbConfig.ccdbPath, bc.runNumber(), metadata);
       } else {
-        std::map<std::string, std::string> metadata;
-        metadata["RecoPassName"] = ccdbConfig.reconstructionPass.value;
-        LOGF(info, "Loading CCDB for reconstruction pass (from provided argument): %s", ccdbConfig.reconstructionPass.value);
-        callst = ccdb->getSpecificForRun<TList>(ccdbConfig.ccdbPath, bc.runNumber(), metadata);
+        callst = ccdb->getSpecificForRun<TList>(ccdbConfig.ccdbPath, bc.runNumber(), metadataInfo.getCcdbMetadataForPass(ccdbConfig.reconstructionPass.value));
       }
 
       Run2V0MInfo.mCalibrationStored = false;
@@ -556,16 +548,8 @@ struct CentralityTable {
         } else {
           if (ccdbConfig.reconstructionPass.value == "") {
             callst = ccdb->getForRun<TList>(ccdbConfig.ccdbPath, bc.runNumber());
-          } else if (ccdbConfig.reconstructionPass.value == "metadata") {
-            std::map<std::string, std::string> metadata;
-            metadata["RecoPassName"] = metadataInfo.get("RecoPassName");
-            LOGF(info, "Loading CCDB for reconstruction pass (from metadata): %s", metadataInfo.get("RecoPassName"));
-            callst = ccdb->getSpecificForRun<TList>(ccdbConfig.ccdbPath, bc.runNumber(), metadata);
           } else {
-            std::map<std::string, std::string> metadata;
-            metadata["RecoPassName"] = ccdbConfig.reconstructionPass.value;
-            LOGF(info, "Loading CCDB for reconstruction pass (from provided argument): %s", ccdbConfig.reconstructionPass.value);
-            callst = ccdb->getSpecificForRun<TList>(ccdbConfig.ccdbPath, bc.runNumber(), metadata);
+            callst = ccdb->getSpecificForRun<TList>(ccdbConfig.ccdbPath, bc.runNumber(), metadataInfo.getCcdbMetadataForPass(ccdbConfig.reconstructionPass.value));
           }
         }
 
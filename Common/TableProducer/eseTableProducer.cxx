@@ -39,9 +39,12 @@
 #include <TF1.h>
 #include <TMath.h>
 
+#include <algorithm>
+#include <array>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <iterator>
 #include <string>
 #include <tuple>
 #include <unordered_map>
@@ -104,6 +107,15 @@ struct EseTableProducer {
 
   FFitWeights* eventShape{nullptr};
 
+  // (harmonic, detector) qn types, harmonic-major, and the configured detectors resolved once in init
+  struct DetectorConfig {
+    bool isKnown{false};   // detector found in detMap
+    DetID id{DetID::FT0C}; // detector of the Q-vector columns
+    int output{-1};        // position of the qn-percentile table of the detector in calculateESE, -1 if none
+  };
+  std::vector<std::pair<int, std::string>> qnTypes;
+  std::vector<DetectorConfig> detConfigs;
+
   Service<o2::ccdb::BasicCCDBManager> ccdb;
 
   struct Config {
@@ -210,16 +222,32 @@ struct EseTableProducer {
     int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
     ccdb->setCreatedNotAfter(now);
 
-    std::vector<std::pair<int, std::string>> veccfg;
+    qnTypes.clear();
     for (std::size_t i{0}; i < cfgLoopHarmonics->size(); i++) {
       for (std::size_t j{0}; j < cfgDetectors->size(); j++) {
-        veccfg.push_back({cfgLoopHarmonics->at(i), cfgDetectors->at(j)});
+        qnTypes.push_back({cfgLoopHarmonics->at(i), cfgDetectors->at(j)});
       }
     }
     weightsFFit->setBinAxis(cfgaxisqn->at(0), cfgaxisqn->at(1), cfgaxisqn->at(2));
     weightsFFit->setResolution(cfgnResolution);
-    weightsFFit->setQnType(veccfg);
+    weightsFFit->setQnType(qnTypes);
     weightsFFit->init();
+    weightsFFit->cacheQnTypes(qnTypes);
+
+    const std::vector<std::string> outputNames{"FT0C", "FT0A", "FV0A", "TPCall", "TPCneg", "TPCpos"};
+    detConfigs.assign(cfgDetectors->size(), DetectorConfig{});
+    for (std::size_t j{0}; j < cfgDetectors->size(); j++) {
+      const auto iter{detMap.find(cfgDetectors->at(j))};
+      if (iter == detMap.end()) {
+        continue;
+      }
+      detConfigs[j].isKnown = true;
+      detConfigs[j].id = iter->second;
+      const auto itOutput{std::find(outputNames.begin(), outputNames.end(), cfgDetectors->at(j))};
+      if (itOutput != outputNames.end()) {
+        detConfigs[j].output = std::distance(outputNames.begin(), itOutput);
+      }
+    }
 
     fPtDepDCAxy = new TF1("ptDepDCAxy", Form("[0]*%s", cfgDCAxy->c_str()), 0.001, 100);
     fPtDepDCAxy->SetParameter(0, cfgDCAxyNSigma);
@@ -278,6 +306,7 @@ struct EseTableProducer {
       if (!eventShape)
         LOGF(fatal, "failed loading qSelection with ese flag");
       LOGF(info, "successfully loaded qSelection");
+      eventShape->cacheQnTypes(qnTypes);
     }
     if (!cfgEfficiency.value.empty()) {
       cfg.mEfficiency = ccdb->getForTimeStamp<TH1D>(cfgEfficiency, timestamp);
@@ -320,13 +349,13 @@ struct EseTableProducer {
     return -1;
   }
 
-  void doSpline(float& splineVal, const float& centr, const float& nHarm, const char* pf, const auto& QX, const auto& QY, const auto& sumAmpl)
+  void doSpline(float& splineVal, const float& centr, const int iType, const auto& QX, const auto& QY, const auto& sumAmpl)
   {
     if (sumAmpl > ThresholdAmplitude) {
       float qnval = calcRedqn(QX * sumAmpl, QY * sumAmpl, sumAmpl);
-      weightsFFit->fillWeights(centr, qnval, nHarm, pf);
+      weightsFFit->fillCachedWeights(iType, centr, qnval);
       if (cfgESE) {
-        splineVal = eventShape->eval(centr, qnval, nHarm, pf);
+        splineVal = eventShape->evalCached(iType, centr, qnval);
       }
     }
   }
@@ -355,29 +384,24 @@ struct EseTableProducer {
     float counter{0.5};
     registry.fill(HIST("hESEstat"), counter++);
 
-    std::unordered_map<std::string, std::vector<float>*> vMap{
-      {"FT0C", &qnpFT0C},
-      {"FT0A", &qnpFT0A},
-      {"FV0A", &qnpFV0A},
-      {"TPCall", &qnpTPCall},
-      {"TPCneg", &qnpTPCneg},
-      {"TPCpos", &qnpTPCpos}};
+    // same order as the outputNames in init
+    const std::array<std::vector<float>*, 6> outputs{&qnpFT0C, &qnpFT0A, &qnpFV0A, &qnpTPCall, &qnpTPCneg, &qnpTPCpos};
 
-    for (std::size_t j{0}; j < cfgDetectors->size(); j++) {
-      const auto det{cfgDetectors->at(j)};
-      const auto iter{detMap.find(det)};
+    const std::size_t nDetectors{detConfigs.size()};
+    for (std::size_t j{0}; j < nDetectors; j++) {
+      const auto& det{detConfigs[j]};
       float splineVal{-1.0};
 
-      if (iter != detMap.end()) {
+      if (det.isKnown) {
         for (std::size_t i{0}; i < cfgLoopHarmonics->size(); i++) {
           const int nHarm{cfgLoopHarmonics->at(i)};
-          const auto [qxt, qyt, st] = getVectors(collision, nHarm, iter->second);
-          doSpline(splineVal, centrality, nHarm, det.c_str(), qxt, qyt, st);
+          const auto [qxt, qyt, st] = getVectors(collision, nHarm, det.id);
+          doSpline(splineVal, centrality, i * nDetectors + j, qxt, qyt, st);
           if (i == 0)
             registry.fill(HIST("hESEstat"), counter++);
 
-          if (vMap.find(det) != vMap.end()) {
-            vMap[det]->push_back(splineVal);
+          if (det.output >= 0) {
+            outputs[det.output]->push_back(splineVal);
           }
         }
       }
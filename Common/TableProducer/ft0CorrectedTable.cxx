@@ -33,6 +33,7 @@
 #include <chrono>
 #include <cstdint>
 #include <string>
+#include <vector>
 
 using namespace o2;
 using namespace o2::framework;
@@ -54,6 +55,15 @@ struct ft0CorrectedTable {
   using BCsWithMatchings = soa::Join<aod::BCs, aod::Run3MatchedToBCSparse>;
   using CollisionEvSel = soa::Join<aod::Collisions, aod::EvSels>::iterator;
   static constexpr float invLightSpeedCm2NS = 1.f / o2::constants::physics::LightSpeedCm2NS;
+  static constexpr float dummyTime = 30.; // Due to HW limitations time can be only within range (-25,25) ns, dummy time is around 32 ns
+  static constexpr float noTime = 1e10f;  // time of collisions without a valid FT0 signal
+
+  // Per data frame columns of the standard processing, kept across data frames
+  std::vector<float> vertexCorr; // vertex correction of each collision
+  std::vector<float> rawT0A;     // FT0A time of each collision, noTime if not valid
+  std::vector<float> rawT0C;     // FT0C time of each collision, noTime if not valid
+  std::vector<float> corrT0A;    // corrected FT0A time of each collision
+  std::vector<float> corrT0C;    // corrected FT0C time of each collision
 
   HistogramRegistry histos{"Histos", {}, OutputObjHandlingPolicy::AnalysisObject};
   void init(o2::framework::InitContext&)
@@ -95,34 +105,48 @@ struct ft0CorrectedTable {
                        BCsWithMatchings const&,
                        aod::FT0s const&)
   {
-    table.reserve(collisions.size());
-    float t0A = 1e10f;
-    float t0C = 1e10f;
+    // gather the vertex correction and the valid FT0 times of all collisions
+    const auto nCollisions = collisions.size();
+    vertexCorr.resize(nCollisions);
+    rawT0A.assign(nCollisions, noTime);
+    rawT0C.assign(nCollisions, noTime);
+    int64_t iColl = 0;
     for (const auto& collision : collisions) {
-      t0A = 1e10f;
-      t0C = 1e10f;
-      const float vertexPV = collision.posZ();
-      const float vertex_corr = vertexPV * invLightSpeedCm2NS;
-      constexpr float dummyTime = 30.; // Due to HW limitations time can be only within range (-25,25) ns, dummy time is around 32 ns
+      vertexCorr[iColl] = collision.posZ() * invLightSpeedCm2NS;
       if (collision.has_foundFT0()) {
         const auto& ft0 = collision.foundFT0();
         const std::bitset<8>& triggers = ft0.triggerMask();
         const bool ora = triggers[o2::ft0::Triggers::bitA];
         const bool orc = triggers[o2::ft0::Triggers::bitC];
         LOGF(debug, "triggers OrA %i OrC %i ", ora, orc);
-        LOGF(debug, " T0A = %f, T0C %f, vertex_corr %f", ft0.timeA(), ft0.timeC(), vertex_corr);
+        LOGF(debug, " T0A = %f, T0C %f, vertex_corr %f", ft0.timeA(), ft0.timeC(), vertexCorr[iColl]);
         if (ora && ft0.timeA() < dummyTime) {
-          t0A = ft0.timeA() + vertex_corr;
+          rawT0A[iColl] = ft0.timeA();
         }
         if (orc && ft0.timeC() < dummyTime) {
-          t0C = ft0.timeC() - vertex_corr;
+          rawT0C[iColl] = ft0.timeC();
         }
       }
+      iColl++;
+    }
+
+    // apply the vertex correction, branch-free over the arrays
+    corrT0A.resize(nCollisions);
+    corrT0C.resize(nCollisions);
+    for (int64_t i = 0; i < nCollisions; i++) {
+      corrT0A[i] = rawT0A[i] < dummyTime ? rawT0A[i] + vertexCorr[i] : noTime;
+      corrT0C[i] = rawT0C[i] < dummyTime ? rawT0C[i] - vertexCorr[i] : noTime;
+    }
+
+    table.reserve(nCollisions);
+    for (int64_t i = 0; i < nCollisions; i++) {
+      const float t0A = corrT0A[i];
+      const float t0C = corrT0C[i];
       LOGF(debug, " T0 collision time T0A = %f, T0C = %f", t0A, t0C);
       if (addHistograms) {
         histos.fill(HIST("t0A"), t0A);
         histos.fill(HIST("t0C"), t0C);
-        if (t0A < 1e10f && t0C < 1e10f) {
+        if (t0A < noTime && t0C < noTime) {
           histos.fill(HIST("t0AC"), (t0A + t0C) * 0.5f);
           histos.fill(HIST("deltat0AC"), (t0A - t0C) * 0.5f);
           histos.fill(HIST("deltat0ACps"), (t0A - t0C) * 500.f);
@@ -173,7 +197,6 @@ struct ft0CorrectedTable {
       posZMC = 0;
       const float vertexPV = collision.posZ();
       const float vertex_corr = vertexPV * invLightSpeedCm2NS;
-      constexpr float dummyTime = 30.; // Due to HW limitations time can be only within range (-25,25) ns, dummy time is around 32 ns
       if (collision.has_mcCollision()) {
         hasMCcoll = true;
         const auto& collisionMC = collision.mcCollision();
@@ -272,11 +272,33 @@ struct matchmftft0 {
      {"DiffInBCINDIV", "; indivBC-firstBC (globalBC); #count", {HistType::kTH1I, {{199, 0, 199}}}},
      {"DiffInBC", "; goodBC-firstBC (globalBC); #count", {HistType::kTH1I, {{199, 0, 199}}}}}};
 
+  // FT0 signals of each BC, indexed by BC global index and filled once per data frame
+  std::vector<uint8_t> bcHasFT0A;
+  std::vector<uint8_t> bcHasFT0C;
+  std::vector<int> bcChannelCOffsets; // offsets of the channels of each BC in firedChannelsC, size nBCs + 1
+  std::vector<int> firedChannelsC;    // FT0-C channels with signal, grouped by BC
+
+  // FT0-C channel positions in cm as used in the distance to the propagated track, and distances to the current track
+  std::vector<double> channelX;
+  std::vector<double> channelY;
+  std::vector<double> channelZ;
+  std::vector<double> channelDist; // computed at the first request for each track
+  std::vector<int> channelStamp;   // track for which channelDist was computed
+  int trackStamp = 0;
+
   void init(InitContext const&)
   {
     ccdb->setURL(ccdburl);
     ccdb->setCaching(true);
     ccdb->setLocalObjectValidityChecking();
+
+    for (const auto& Xc : channelCoord) {
+      channelX.push_back(Xc[0] * 0.1);
+      channelY.push_back(Xc[1] * 0.1);
+      channelZ.push_back(Xc[2] * 0.1 - 1.87);
+    }
+    channelDist.assign(channelCoord.size(), 0.);
+    channelStamp.assign(channelCoord.size(), -1);
   }
 
   void initCCDB(ExtBCs::iterator const& bc)
@@ -320,14 +342,48 @@ struct matchmftft0 {
     return true;
   }
 
+  // distance in cm between the FT0-C channel and the track propagated to FT0-C, computed once per track and channel
+  double getChannelDistance(int channelId, o2::track::TrackParCovFwd const& trackPar)
+  {
+    if (channelStamp[channelId] != trackStamp) {
+      channelStamp[channelId] = trackStamp;
+      const double dx = channelX[channelId] - trackPar.getX();
+      const double dy = channelY[channelId] - trackPar.getY();
+      const double dz = channelZ[channelId] - trackPar.getZ();
+      channelDist[channelId] = std::sqrt(dx * dx + dy * dy + dz * dz);
+    }
+    return channelDist[channelId];
+  }
+
   void processMFT(aod::MFTTracks const& mfttracks,
                   aod::Collisions const&, ExtBCs const& bcs,
                   aod::FT0s const&)
   {
     initCCDB(bcs.begin());
 
-    int i = 0; // counts the number of channels having non-zero amplitude
-    // for a particular BC
+    // FT0 signals of all the BCs, instead of reading the FT0s of each compatible BC of each track
+    bcHasFT0A.assign(bcs.size(), 0);
+    bcHasFT0C.assign(bcs.size(), 0);
+    bcChannelCOffsets.assign(bcs.size() + 1, 0);
+    firedChannelsC.clear();
+    for (const auto& bc : bcs) {
+      const auto iBC = bc.globalIndex();
+      if (bc.has_ft0s()) {
+        for (auto const& ft0 : bc.ft0s()) {
+          if (ft0.channelA().size() > 0) {
+            bcHasFT0A[iBC] = 1;
+          }
+          if (ft0.channelC().size() > 0) {
+            bcHasFT0C[iBC] = 1;
+          }
+          for (auto channelId : ft0.channelC()) {
+            firedChannelsC.push_back(channelId);
+          }
+        }
+      }
+      bcChannelCOffsets[iBC + 1] = firedChannelsC.size();
+    }
+
     double D = 0.0; // distance between (xe,ye,ze) and (xc,yc,zc)
     double minD;
     double globalMinD;
@@ -367,6 +423,7 @@ struct matchmftft0 {
         BcMft(track.globalIndex(), filler.BCids); // empty
         continue;
       }
+      trackStamp++; // new track for the channel distances
 
       std::vector<ExtBCs::iterator> goodBC; // contains the BCs matched with the current MFT track
       int nCompBCwft0C = 0;
@@ -375,44 +432,30 @@ struct matchmftft0 {
       bool hasft0A = false;
       bool hasft0C = false;
       for (auto& bc : bcSlice) {
-        hasft0C = false;
-        hasft0A = false;
         // printf("----------bcId %lld\n", bc.globalIndex());
         if (!bc.has_ft0s()) {
+          hasft0C = false;
+          hasft0A = false;
           continue;
         }
 
-        auto ft0s = bc.ft0s();
-        i = 0; // reinitialise
+        const auto iBC = bc.globalIndex();
+        hasft0A = bcHasFT0A[iBC]; // BC with signals in FT0A
+        hasft0C = bcHasFT0C[iBC];
         D = 0.0;
         minD = 999.9;
-        for (auto const& ft0 : ft0s) {
-          // printf("---------ft0.bcId %d\n", ft0.bcId());
-          if (ft0.channelA().size() > 0) {
-            // BC with signals in FT0A
-            hasft0A = true;
-          }
-
-          if (ft0.channelC().size() > 0) {
-            hasft0C = true;
-          }
-          for (auto channelId : ft0.channelC()) {
-
-            std::vector<float> Xc = channelCoord[channelId]; //(xc,yc,zc) coordinates
-            // D in cm
-            D = sqrt(pow(Xc[0] * 0.1 - trackPar.getX(), 2) + pow(Xc[1] * 0.1 - trackPar.getY(), 2) + pow(Xc[2] * 0.1 - 1.87 - trackPar.getZ(), 2));
-            // printf("----channelId %u, D %f, n %d\n", channelId, D, n);//should be between 96 and 207
-            if (D < minD) {
-              minD = D;
-            }
-
-            registry.fill(HIST("DistChannelToProp"), D);
+        for (int iChannel = bcChannelCOffsets[iBC]; iChannel < bcChannelCOffsets[iBC + 1]; iChannel++) {
+          // D in cm
+          D = getChannelDistance(firedChannelsC[iChannel], trackPar);
+          if (D < minD) {
+            minD = D;
           }
 
-          i += ft0.channelC().size();
+          registry.fill(HIST("DistChannelToProp"), D);
         }
 
-        registry.fill(HIST("NchannelsPerBC"), i);
+        // number of channels having non-zero amplitude
+        registry.fill(HIST("NchannelsPerBC"), bcChannelCOffsets[iBC + 1] - bcChannelCOffsets[iBC]);
         if (hasft0C) {
           nCompBCwft0C++; // number of compatible BCs that have ft0-C signal
         }
@@ -87,127 +87,118 @@ struct mftmchMatchingML {
   std::shared_ptr<Ort::Session> onnx_session = nullptr;
   OnnxModel model;
 
-  template <typename F, typename M>
-  std::vector<float> getVariables(F const& fwdtrack, M const& mfttrack)
+  static constexpr Double_t MatchingPlaneZ = -77.5;
+  static constexpr int NInputs = 17;
+
+  // track parameters at the matching plane, computed once per track
+  struct PlaneParams {
+    Float_t x, y, phi, tanl;
+  };
+
+  std::vector<std::string> input_names;
+  std::vector<std::vector<int64_t>> input_shapes;
+  std::vector<std::string> output_names;
+  std::vector<const char*> inputNamesChar;
+  std::vector<const char*> outputNamesChar;
+  bool batchedInference = false; // the first dimension of the model input is dynamic
+
+  std::vector<PlaneParams> mftPlaneParams; // MFT tracks at the matching plane
+  std::vector<uint64_t> mftCellKeys;       // (collision, XY cell) of the MFT tracks with a collision, sorted
+  std::vector<int> mftCellTracks;          // MFT track index of each entry of mftCellKeys
+  std::vector<int> candidates;             // MFT tracks compatible with the current muon
+  std::vector<float> inputValues;          // model inputs of the candidates, NInputs per candidate
+  std::vector<float> scores;               // model outputs of the candidates
+
+  template <typename T>
+  static PlaneParams propagateToMatchingPlane(T const& track)
   {
+    double chi2 = track.chi2();
+    SMatrix5 pars(track.x(), track.y(), track.phi(), track.tgl(), track.signed1Pt());
+    std::vector<double> v1;
+    SMatrix55 covs(v1.begin(), v1.end());
+    o2::track::TrackParCovFwd pars1{track.z(), pars, covs, chi2};
+    pars1.propagateToZlinear(MatchingPlaneZ);
+    return {static_cast<Float_t>(pars1.getX()), static_cast<Float_t>(pars1.getY()), static_cast<Float_t>(pars1.getPhi()), static_cast<Float_t>(pars1.getTanl())};
+  }
 
-    static constexpr Double_t MatchingPlaneZ = -77.5;
-
-    // propagate muontrack to matching position
-    double muonchi2 = fwdtrack.chi2();
-    SMatrix5 muonpars(fwdtrack.x(), fwdtrack.y(), fwdtrack.phi(), fwdtrack.tgl(), fwdtrack.signed1Pt());
-    std::vector<double> muonv1;
-    SMatrix55 muoncovs(muonv1.begin(), muonv1.end());
-    o2::track::TrackParCovFwd muonpars1{fwdtrack.z(), muonpars, muoncovs, muonchi2};
-    muonpars1.propagateToZlinear(MatchingPlaneZ);
-
-    // propagate mfttrack to matching position
-    double mftchi2 = mfttrack.chi2();
-    SMatrix5 mftpars(mfttrack.x(), mfttrack.y(), mfttrack.phi(), mfttrack.tgl(), mfttrack.signed1Pt());
-    std::vector<double> mftv1;
-    SMatrix55 mftcovs(mftv1.begin(), mftv1.end());
-    o2::track::TrackParCovFwd mftpars1{mfttrack.z(), mftpars, mftcovs, mftchi2};
-    mftpars1.propagateToZlinear(MatchingPlaneZ);
-
-    Float_t MFT_X = mftpars1.getX();
-    Float_t MFT_Y = mftpars1.getY();
-    Float_t MFT_Phi = mftpars1.getPhi();
-    Float_t MFT_Tanl = mftpars1.getTanl();
-
-    Float_t MCH_X = muonpars1.getX();
-    Float_t MCH_Y = muonpars1.getY();
-    Float_t MCH_Phi = muonpars1.getPhi();
-    Float_t MCH_Tanl = muonpars1.getTanl();
-
-    Float_t Ratio_X = MFT_X / MCH_X;
-    Float_t Ratio_Y = MFT_Y / MCH_Y;
-    Float_t Ratio_Phi = MFT_Phi / MCH_Phi;
-    Float_t Ratio_Tanl = MFT_Tanl / MCH_Tanl;
-
-    Float_t Delta_X = MFT_X - MCH_X;
-    Float_t Delta_Y = MFT_Y - MCH_Y;
-    Float_t Delta_Phi = MFT_Phi - MCH_Phi;
-    Float_t Delta_Tanl = MFT_Tanl - MCH_Tanl;
-
-    Float_t Delta_XY = sqrt(Delta_X * Delta_X + Delta_Y * Delta_Y);
-
-    std::vector<float> input_tensor_values{
-      MFT_X,
-      MFT_Y,
-      MFT_Phi,
-      MFT_Tanl,
-      MCH_X,
-      MCH_Y,
-      MCH_Phi,
-      MCH_Tanl,
-      Delta_XY,
+  static void getVariables(PlaneParams const& muon, PlaneParams const& mft, float* values)
+  {
+    Float_t Delta_X = mft.x - muon.x;
+    Float_t Delta_Y = mft.y - muon.y;
+    const float input_tensor_values[NInputs]{
+      mft.x,
+      mft.y,
+      mft.phi,
+      mft.tanl,
+      muon.x,
+      muon.y,
+      muon.phi,
+      muon.tanl,
+      std::sqrt(Delta_X * Delta_X + Delta_Y * Delta_Y),
       Delta_X,
       Delta_Y,
-      Delta_Phi,
-      Delta_Tanl,
-      Ratio_X,
-      Ratio_Y,
-      Ratio_Phi,
-      Ratio_Tanl,
+      mft.phi - muon.phi,
+      mft.tanl - muon.tanl,
+      mft.x / muon.x,
+      mft.y / muon.y,
+      mft.phi / muon.phi,
+      mft.tanl / muon.tanl,
     };
-    return input_tensor_values;
+    std::copy(input_tensor_values, input_tensor_values + NInputs, values);
   }
 
-  template <typename F, typename M>
-  double matchONNX(F const& fwdtrack, M const& mfttrack)
+  static float deltaXY(PlaneParams const& muon, PlaneParams const& mft)
   {
-    std::vector<std::string> input_names;
-    std::vector<std::vector<int64_t>> input_shapes;
-    std::vector<std::string> output_names;
-    std::vector<std::vector<int64_t>> output_shapes;
+    Float_t Delta_X = mft.x - muon.x;
+    Float_t Delta_Y = mft.y - muon.y;
+    return std::sqrt(Delta_X * Delta_X + Delta_Y * Delta_Y);
+  }
+
+  // cells of cfgXYWindow size: a pair closer than the window is in the same or in an adjacent cell
+  uint32_t cellIndex(float coordinate) const { return static_cast<uint32_t>(static_cast<int32_t>(std::floor(coordinate / cfgXYWindow)) + (1 << 15)) & 0xffff; }
+  static uint64_t cellKey(int collisionId, uint32_t cellX, uint32_t cellY) { return (static_cast<uint64_t>(collisionId) << 32) | (cellX << 16) | cellY; }
 
+  // scores of nPairs pairs whose inputs are in inputValues, in one model call if the model input has a dynamic batch size
+  void matchONNX(size_t nPairs)
+  {
+    scores.resize(nPairs);
+    if (nPairs == 0) {
+      return;
+    }
+    const size_t batchSize = batchedInference ? nPairs : 1;
+    auto input_shape = input_shapes[0];
+    input_shape[0] = batchSize;
+    Ort::MemoryInfo mem_info =
+      Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
+    Ort::RunOptions runOptions;
+    for (size_t first = 0; first < nPairs; first += batchSize) {
+      std::vector<Ort::Value> input_tensors;
+      input_tensors.push_back(Ort::Value::CreateTensor<float>(mem_info, inputValues.data() + first * NInputs, batchSize * NInputs, input_shape.data(), input_shape.size()));
+      std::vector<Ort::Value> output_tensors = onnx_session->Run(runOptions, inputNamesChar.data(), input_tensors.data(), input_tensors.size(), outputNamesChar.data(), outputNamesChar.size());
+      const float* output_value = output_tensors[0].GetTensorData<float>();
+      std::copy(output_value, output_value + batchSize, scores.begin() + first);
+    }
+  }
+
+  // the names and shapes of the model do not change, they are read once
+  void readModelInfo()
+  {
     Ort::AllocatorWithDefaultOptions tmpAllocator;
     for (size_t i = 0; i < onnx_session->GetInputCount(); ++i) {
       input_names.push_back(onnx_session->GetInputNameAllocated(i, tmpAllocator).get());
-    }
-    for (size_t i = 0; i < onnx_session->GetInputCount(); ++i) {
       input_shapes.emplace_back(onnx_session->GetInputTypeInfo(i).GetTensorTypeAndShapeInfo().GetShape());
     }
     for (size_t i = 0; i < onnx_session->GetOutputCount(); ++i) {
       output_names.push_back(onnx_session->GetOutputNameAllocated(i, tmpAllocator).get());
     }
-    for (size_t i = 0; i < onnx_session->GetOutputCount(); ++i) {
-      output_shapes.emplace_back(onnx_session->GetOutputTypeInfo(i).GetTensorTypeAndShapeInfo().GetShape());
+    for (const auto& name : input_names) {
+      inputNamesChar.push_back(name.c_str());
     }
-
-    auto input_shape = input_shapes[0];
-    input_shape[0] = 1;
-
-    std::vector<float> input_tensor_values;
-    input_tensor_values = getVariables(fwdtrack, mfttrack);
-
-    if (input_tensor_values[8] < cfgXYWindow) {
-      std::vector<Ort::Value> input_tensors;
-      Ort::MemoryInfo mem_info =
-        Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
-      input_tensors.push_back(Ort::Value::CreateTensor<float>(mem_info, input_tensor_values.data(), input_tensor_values.size(), input_shape.data(), input_shape.size()));
-
-      Ort::RunOptions runOptions;
-      std::vector<const char*> inputNamesChar(input_names.size(), nullptr);
-      std::transform(std::begin(input_names), std::end(input_names), std::begin(inputNamesChar),
-                     [&](const std::string& str) { return str.c_str(); });
-
-      std::vector<const char*> outputNamesChar(output_names.size(), nullptr);
-      std::transform(std::begin(output_names), std::end(output_names), std::begin(outputNamesChar),
-                     [&](const std::string& str) { return str.c_str(); });
-
-      std::vector<Ort::Value> output_tensors = onnx_session->Run(runOptions, inputNamesChar.data(), input_tensors.data(), input_tensors.size(), outputNamesChar.data(), outputNamesChar.size());
-
-      const float* output_value = output_tensors[0].GetTensorData<float>();
-
-      auto score = output_value[0];
-
-      return score;
-    } else {
-      auto score = 0;
-      return score;
+    for (const auto& name : output_names) {
+      outputNamesChar.push_back(name.c_str());
     }
-  };
+    batchedInference = !input_shapes.empty() && !input_shapes[0].empty() && input_shapes[0][0] < 0;
+  }
 
   void init(o2::framework::InitContext&)
   {
@@ -227,6 +218,7 @@ struct mftmchMatchingML {
                 << "/" << cfgModelName.value;
       model.initModel(cfgModelName, false, 1, strtoul(headers["Valid-From"].c_str(), NULL, 0), strtoul(headers["Valid-Until"].c_str(), NULL, 0));
       onnx_session = model.getSession();
+      readModelInfo();
     } else {
       LOG(info) << "Failed to retrieve Network file";
     }
@@ -234,40 +226,99 @@ struct mftmchMatchingML {
 
   void process(aod::Collisions const&, soa::Filtered<aod::FwdTracks> const& fwdtracks, aod::MFTTracks const& mfttracks)
   {
+    // MFT tracks are propagated once and indexed by (collision, XY cell) at the matching plane
+    mftPlaneParams.resize(mfttracks.size());
+    std::vector<std::pair<uint64_t, int>> keyedTracks;
+    keyedTracks.reserve(mfttracks.size());
+    int mftIndex = 0;
+    for (const auto& mfttrack : mfttracks) {
+      const auto& params = mftPlaneParams[mftIndex] = propagateToMatchingPlane(mfttrack);
+      if (mfttrack.has_collision()) {
+        keyedTracks.emplace_back(cellKey(mfttrack.collisionId(), cellIndex(params.x), cellIndex(params.y)), mftIndex);
+      }
+      mftIndex++;
+    }
+    std::sort(keyedTracks.begin(), keyedTracks.end());
+    mftCellKeys.resize(keyedTracks.size());
+    mftCellTracks.resize(keyedTracks.size());
+    for (size_t i = 0; i < keyedTracks.size(); ++i) {
+      mftCellKeys[i] = keyedTracks[i].first;
+      mftCellTracks[i] = keyedTracks[i].second;
+    }
+
     for (auto& fwdtrack : fwdtracks) {
       if (fwdtrack.trackType() == aod::fwdtrack::ForwardTrackTypeEnum::MuonStandaloneTrack) {
         double bestscore = 0;
         int bestmfttrackid = -1;
-        for (auto& mfttrack : mfttracks) {
-          if (fwdtrack.has_collision() && mfttrack.has_collision()) {
-            if (0 <= fwdtrack.collisionId() - mfttrack.collisionId() && fwdtrack.collisionId() - mfttrack.collisionId() < cfgColWindow) {
-              double result = matchONNX(fwdtrack, mfttrack);
-              if (result > cfgThrScore) {
-                bestscore = result;
-                bestmfttrackid = mfttrack.globalIndex();
+        if (!fwdtrack.has_collision()) {
+          continue;
+        }
+        const auto muonParams = propagateToMatchingPlane(fwdtrack);
+
+        // MFT tracks with 0 <= muon collision - MFT collision < window and closer than the XY window at the matching plane,
+        // the others have score 0 and can only pass a negative threshold
+        candidates.clear();
+        const uint32_t cellX = cellIndex(muonParams.x);
+        const uint32_t cellY = cellIndex(muonParams.y);
+        for (int collisionId = fwdtrack.collisionId(); collisionId > fwdtrack.collisionId() - cfgColWindow && collisionId >= 0; collisionId--) {
+          if (cfgThrScore < 0) {
+            auto first = std::lower_bound(mftCellKeys.begin(), mftCellKeys.end(), cellKey(collisionId, 0, 0));
+            auto last = std::lower_bound(first, mftCellKeys.end(), cellKey(collisionId + 1, 0, 0));
+            for (auto it = first; it != last; ++it) {
+              candidates.push_back(mftCellTracks[it - mftCellKeys.begin()]);
+            }
+            continue;
+          }
+          for (int dX = -1; dX <= 1; dX++) {
+            for (int dY = -1; dY <= 1; dY++) {
+              auto range = std::equal_range(mftCellKeys.begin(), mftCellKeys.end(), cellKey(collisionId, (cellX + dX) & 0xffff, (cellY + dY) & 0xffff));
+              for (auto it = range.first; it != range.second; ++it) {
+                candidates.push_back(mftCellTracks[it - mftCellKeys.begin()]);
               }
             }
           }
         }
-        if (bestmfttrackid != -1) {
-          for (auto& mfttrack : mfttracks) {
-            if (mfttrack.globalIndex() == bestmfttrackid) {
-              double mftchi2 = mfttrack.chi2();
-              SMatrix5 mftpars(mfttrack.x(), mfttrack.y(), mfttrack.phi(), mfttrack.tgl(), mfttrack.signed1Pt());
-              std::vector<double> mftv1;
-              SMatrix55 mftcovs(mftv1.begin(), mftv1.end());
-              o2::track::TrackParCovFwd mftpars1{mfttrack.z(), mftpars, mftcovs, mftchi2};
-              mftpars1.propagateToZlinear(mfttrack.collision().posZ());
-
-              float dcaX = (mftpars1.getX() - mfttrack.collision().posX());
-              float dcaY = (mftpars1.getY() - mfttrack.collision().posY());
-              double px = fwdtrack.p() * sin(M_PI / 2 - atan(mfttrack.tgl())) * cos(mfttrack.phi());
-              double py = fwdtrack.p() * sin(M_PI / 2 - atan(mfttrack.tgl())) * sin(mfttrack.phi());
-              double pz = fwdtrack.p() * cos(M_PI / 2 - atan(mfttrack.tgl()));
-              fwdtrackml(fwdtrack.collisionId(), 0, mfttrack.x(), mfttrack.y(), mfttrack.z(), mfttrack.phi(), mfttrack.tgl(), fwdtrack.sign() / std::sqrt(std::pow(px, 2) + std::pow(py, 2)), fwdtrack.nClusters(), fwdtrack.pDca(), fwdtrack.rAtAbsorberEnd(), 0, 0, 0, bestscore, mfttrack.globalIndex(), fwdtrack.globalIndex(), fwdtrack.mchBitMap(), fwdtrack.midBitMap(), fwdtrack.midBoards(), mfttrack.trackTime(), mfttrack.trackTimeRes(), mfttrack.eta(), std::sqrt(std::pow(px, 2) + std::pow(py, 2)), std::sqrt(std::pow(px, 2) + std::pow(py, 2) + std::pow(pz, 2)), dcaX, dcaY);
-            }
+        // same order as a loop over the MFT table, the last candidate above threshold is kept
+        std::sort(candidates.begin(), candidates.end());
+
+        inputValues.resize(candidates.size() * NInputs);
+        size_t nPairs = 0;
+        int lastOutOfWindow = -1; // score 0 without model evaluation
+        for (const auto candidate : candidates) {
+          if (deltaXY(muonParams, mftPlaneParams[candidate]) < cfgXYWindow) {
+            getVariables(muonParams, mftPlaneParams[candidate], inputValues.data() + nPairs * NInputs);
+            candidates[nPairs++] = candidate;
+          } else {
+            lastOutOfWindow = candidate;
+          }
+        }
+        matchONNX(nPairs);
+        for (size_t iPair = 0; iPair < nPairs; ++iPair) {
+          if (scores[iPair] > cfgThrScore) {
+            bestscore = scores[iPair];
+            bestmfttrackid = candidates[iPair];
           }
         }
+        if (cfgThrScore < 0 && lastOutOfWindow > bestmfttrackid) {
+          bestscore = 0;
+          bestmfttrackid = lastOutOfWindow;
+        }
+        if (bestmfttrackid != -1) {
+          auto mfttrack = mfttracks.rawIteratorAt(bestmfttrackid);
+          double mftchi2 = mfttrack.chi2();
+          SMatrix5 mftpars(mfttrack.x(), mfttrack.y(), mfttrack.phi(), mfttrack.tgl(), mfttrack.signed1Pt());
+          std::vector<double> mftv1;
+          SMatrix55 mftcovs(mftv1.begin(), mftv1.end());
+          o2::track::TrackParCovFwd mftpars1{mfttrack.z(), mftpars, mftcovs, mftchi2};
+          mftpars1.propagateToZlinear(mfttrack.collision().posZ());
+
+          float dcaX = (mftpars1.getX() - mfttrack.collision().posX());
+          float dcaY = (mftpars1.getY() - mfttrack.collision().posY());
+          double px = fwdtrack.p() * sin(M_PI / 2 - atan(mfttrack.tgl())) * cos(mfttrack.phi());
+          double py = fwdtrack.p() * sin(M_PI / 2 - atan(mfttrack.tgl())) * sin(mfttrack.phi());
+          double pz = fwdtrack.p() * cos(M_PI / 2 - atan(mfttrack.tgl()));
+          fwdtrackml(fwdtrack.collisionId(), 0, mfttrack.x(), mfttrack.y(), mfttrack.z(), mfttrack.phi(), mfttrack.tgl(), fwdtrack.sign() / std::sqrt(std::pow(px, 2) + std::pow(py, 2)), fwdtrack.nClusters(), fwdtrack.pDca(), fwdtrack.rAtAbsorberEnd(), 0, 0, 0, bestscore, mfttrack.globalIndex(), fwdtrack.globalIndex(), fwdtrack.mchBitMap(), fwdtrack.midBitMap(), fwdtrack.midBoards(), mfttrack.trackTime(), mfttrack.trackTimeRes(), mfttrack.eta(), std::sqrt(std::pow(px, 2) + std::pow(py, 2)), std::sqrt(std::pow(px, 2) + std::pow(py, 2) + std::pow(pz, 2)), dcaX, dcaY);
+        }
       }
     }
   }
@@ -63,6 +63,17 @@ struct MultiplicityExtraTable {
     return bcTableFloatPrecision * std::round(value / bcTableFloatPrecision) + 0.5f * bcTableFloatPrecision;
   };
 
+  // sum of the amplitudes of the fired channels of a FIT detector, in a single pass over the amplitude array
+  template <typename TAmplitudes>
+  static float sumAmplitudes(const TAmplitudes& amplitudes)
+  {
+    float sum = 0.f;
+    for (const auto amplitude : amplitudes) {
+      sum += amplitude;
+    }
+    return sum;
+  }
+
   // needed for downscale
   unsigned int randomSeed = 0;
 
@@ -89,15 +100,11 @@ struct MultiplicityExtraTable {
   {
     //+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+
     // determine saved BCs and corresponding new BC table index
-    std::vector<int> bcHasCollision(bcs.size());
-    std::vector<int> newBCindex(bcs.size());
-    std::vector<int> bc2multArray(bcs.size());
+    std::vector<int> bcHasCollision(bcs.size(), false);
+    std::vector<int> newBCindex(bcs.size(), -1);
+    std::vector<int> bc2multArray(bcs.size(), -1);
+    std::vector<float> multFT0CArray(bcs.size(), -999.0f); // FT0C amplitude of the BCs, reused when filling the saved ones
     int atIndex = 0;
-    for (const auto& bc : bcs) {
-      bcHasCollision[bc.globalIndex()] = false;
-      newBCindex[bc.globalIndex()] = -1;
-      bc2multArray[bc.globalIndex()] = -1;
-    }
 
     //+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+
     // tag BCs that have a collision (from evsel foundBC)
@@ -112,15 +119,10 @@ struct MultiplicityExtraTable {
         continue;
       }
 
-      float multFT0C = 0.f;
       if (bc.has_ft0()) {
-        auto ft0 = bc.ft0();
-        for (auto amplitude : ft0.amplitudeC()) {
-          multFT0C += amplitude;
-        }
-      } else {
-        multFT0C = -999.0f;
+        multFT0CArray[bc.globalIndex()] = sumAmplitudes(bc.ft0().amplitudeC());
       }
+      const float multFT0C = multFT0CArray[bc.globalIndex()];
 
       if (multFT0C < minFT0CforBCTable) {
         continue; // skip this event
@@ -136,12 +138,15 @@ struct MultiplicityExtraTable {
 
     //+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+
     // interlink: collision -> valid BC, BC -> collision
+    mult2bc.reserve(collisions.size());
     for (const auto& collision : collisions) {
       mult2bc(newBCindex[collision.foundBCId()]);
       bc2multArray[collision.foundBCId()] = collision.globalIndex();
     }
     //+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+
 
+    bc2mult.reserve(atIndex);
+    multBC.reserve(atIndex);
     for (const auto& bc : bcs) {
       if (newBCindex[bc.globalIndex()] < 0) {
         continue; // don't keep if low mult or downsampled out
@@ -149,7 +154,7 @@ struct MultiplicityExtraTable {
 
       bool Tvx = false;
       bool isFV0OrA = false;
-      float multFT0C = 0.f;
+      float multFT0C = multFT0CArray[bc.globalIndex()];
       float multFT0A = 0.f;
       float multFV0A = 0.f;
       float multFDDA = 0.f;
@@ -193,27 +198,19 @@ struct MultiplicityExtraTable {
         Tvx = triggers[o2::fit::Triggers::bitVertex];
         multFT0TriggerBits = static_cast<uint8_t>(triggers.to_ulong());
 
-        // calculate T0 charge
-        for (auto amplitude : ft0.amplitudeA()) {
-          multFT0A += amplitude;
-        }
-        for (auto amplitude : ft0.amplitudeC()) {
-          multFT0C += amplitude;
-        }
+        // calculate T0 charge, the FT0C one is already known
+        multFT0A = sumAmplitudes(ft0.amplitudeA());
         posZFT0 = ft0.posZ();
         posZFT0valid = ft0.isValidTime();
       } else {
         multFT0A = -999.0f;
-        multFT0C = -999.0f;
       }
       if (bc.has_fv0a()) {
         auto fv0 = bc.fv0a();
         std::bitset<8> fV0Triggers = fv0.triggerMask();
         multFV0TriggerBits = static_cast<uint8_t>(fV0Triggers.to_ulong());
 
-        for (auto amplitude : fv0.amplitude()) {
-          multFV0A += amplitude;
-        }
+        multFV0A = sumAmplitudes(fv0.amplitude());
         isFV0OrA = fV0Triggers[o2::fit::Triggers::bitA];
       } else {
         multFV0A = -999.0f;
@@ -224,24 +221,21 @@ struct MultiplicityExtraTable {
         std::bitset<8> fFDDTriggers = fdd.triggerMask();
         multFDDTriggerBits = static_cast<uint8_t>(fFDDTriggers.to_ulong());
 
-        for (auto amplitude : fdd.chargeA()) {
-          multFDDA += amplitude;
-        }
-        for (auto amplitude : fdd.chargeC()) {
-          multFDDC += amplitude;
-        }
+        multFDDA = sumAmplitudes(fdd.chargeA());
+        multFDDC = sumAmplitudes(fdd.chargeC());
       } else {
         multFDDA = -999.0f;
         multFDDC = -999.0f;
       }
 
       if (bc.has_zdc()) {
-        multZNA = bc.zdc().amplitudeZNA();
-        multZNC = bc.zdc().amplitudeZNC();
-        multZEM1 = bc.zdc().amplitudeZEM1();
-        multZEM2 = bc.zdc().amplitudeZEM2();
-        multZPA = bc.zdc().amplitudeZPA();
-        multZPC = bc.zdc().amplitudeZPC();
+        const auto& zdc = bc.zdc();
+        multZNA = zdc.amplitudeZNA();
+        multZNC = zdc.amplitudeZNC();
+        multZEM1 = zdc.amplitudeZEM1();
+        multZEM2 = zdc.amplitudeZEM2();
+        multZPA = zdc.amplitudeZPA();
+        multZPC = zdc.amplitudeZPC();
       } else {
         multZNA = -999.f;
         multZNC = -999.f;
@@ -267,6 +261,7 @@ struct MultiplicityExtraTable {
   {
     std::vector<float> timeArray;
     timeArray.resize(collisions.size(), 1e+3);
+    multNeigh.reserve(collisions.size());
 
     for (const auto& collision : collisions) {
       timeArray[collision.globalIndex()] = collision.collisionTime();
@@ -434,16 +434,8 @@ struct MultiplicityTable {
           mRunNumber = bc.runNumber(); // mark this run as at least tried
           if (ccdbConfig.reconstructionPass.value == "") {
             lCalibObjects = ccdb->getForRun<TList>(ccdbConfig.ccdbPath, mRunNumber);
-          } else if (ccdbConfig.reconstructionPass.value == "metadata") {
-            std::map<std::string, std::string> metadata;
-            metadata["RecoPassName"] = metadataInfo.get("RecoPassName");
-            LOGF(info, "Loading CCDB for reconstruction pass (from metadata): %s", metadataInfo.get("RecoPassName"));
-            lCalibObjects = ccdb->getSpecificForRun<TList>(ccdbConfig.ccdbPath, mRunNumber, metadata);
           } else {
-            std::map<std::string, std::string> metadata;
-            metadata["RecoPassName"] = ccdbConfig.reconstructionPass.value;
-            LOGF(info, "Loading CCDB for reconstruction pass (from provided argument): %s", ccdbConfig.reconstructionPass.value);
-            lCalibObjects = ccdb->getSpecificForRun<TList>(ccdbConfig.ccdbPath, mRunNumber, metadata);
+            lCalibObjects = ccdb->getSpecificForRun<TList>(ccdbConfig.ccdbPath, mRunNumber, metadataInfo.getCcdbMetadataForPass(ccdbConfig.reconstructionPass.value));
           }
 
           if (lCalibObjects) {
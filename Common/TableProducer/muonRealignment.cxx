@@ -45,8 +45,8 @@
 #include <cstdint>
 #include <exception>
 #include <iterator>
-#include <map>
 #include <string>
+#include <vector>
 
 using namespace std;
 using namespace o2;
@@ -58,6 +58,7 @@ using MyMuonsWithCov = soa::Join<aod::FwdTracks, aod::FwdTracksCov>;
 
 const int fgNDetElemCh[10] = {4, 4, 4, 4, 18, 18, 26, 26, 26, 26};
 const int fgSNDetElemCh[11] = {0, 4, 8, 12, 16, 34, 52, 78, 104, 130, 156};
+const int NDetElem = fgSNDetElemCh[10];
 
 struct FwdTrkCovRealignInfo {
   float sigX = 0.f;
@@ -95,8 +96,10 @@ struct MuonRealignment {
   base::MatLayerCylSet* lut = nullptr;
   TrackFitter trackFitter; // Track fitter from MCH tracking library
   geo::TransformationCreator transformation;
-  map<int, math_utils::Transform3D> transformRef; // reference geometry w.r.t track data
-  map<int, math_utils::Transform3D> transformNew; // new geometry
+  vector<math_utils::Transform3D> transformRef; // reference geometry w.r.t track data, per detection element number
+  vector<double> realignMatrices;               // new geometry local to master times reference master to local, 3x4 components per detection element number
+  vector<int> detElemNumbers;                   // detection element number of each detection element id, the identity matrix for unknown ids
+  vector<mch::Cluster> realignedClusters;       // re-aligned clusters of the data frame, per cluster row. The track parameters keep pointers to them
   globaltracking::MatchGlobalFwd mMatching;
   int fCurrentRun;        // needed to detect if the run changed and trigger update of calibrations etc.
   double mImproveCutChi2; // Chi2 cut for track improvement.
@@ -223,6 +226,49 @@ struct MuonRealignment {
     trackFitter.smoothTracks(true);
     trackFitter.useChamberResolution();
     mImproveCutChi2 = 2. * cfgSigmaCutImprove.value * cfgSigmaCutImprove.value;
+
+    // Flat lookup of the transformation of each detection element, the last entry is the identity
+    detElemNumbers.assign(GetDetElemId(NDetElem - 1) + 1, NDetElem);
+    for (int i = 0; i < NDetElem; i++) {
+      detElemNumbers[GetDetElemId(i)] = i;
+    }
+    transformRef.resize(NDetElem);
+    realignMatrices.assign(12 * (NDetElem + 1), 0.);
+    for (int i = 0; i <= NDetElem; i++) {
+      realignMatrices[12 * i] = realignMatrices[12 * i + 5] = realignMatrices[12 * i + 10] = 1.;
+    }
+  }
+
+  const double* realignMatrix(int deId) const
+  {
+    return &realignMatrices[12 * ((deId >= 0 && deId < static_cast<int>(detElemNumbers.size())) ? detElemNumbers[deId] : NDetElem)];
+  }
+
+  // Re-aligned position of all the clusters of the data frame in one pass over the cluster table, before the refits
+  template <typename TMuonCls>
+  void realignClusters(TMuonCls const& clusters)
+  {
+    realignedClusters.resize(clusters.size());
+    int clIndex = -1; // index of the cluster within its track
+    int64_t previousTrackId = -1;
+    size_t iCluster = 0;
+    for (auto const& cluster : clusters) {
+      clIndex = (cluster.fwdtrackId() == previousTrackId) ? clIndex + 1 : 0;
+      previousTrackId = cluster.fwdtrackId();
+      const double* m = realignMatrix(cluster.deId());
+      const double x = cluster.x();
+      const double y = cluster.y();
+      const double z = cluster.z();
+
+      mch::Cluster& clusterMCH = realignedClusters[iCluster++];
+      clusterMCH = mch::Cluster();
+      clusterMCH.x = m[0] * x + m[1] * y + m[2] * z + m[3];
+      clusterMCH.y = m[4] * x + m[5] * y + m[6] * z + m[7];
+      clusterMCH.z = m[8] * x + m[9] * y + m[10] * z + m[11];
+      clusterMCH.uid = mch::Cluster::buildUniqueId(static_cast<int>(cluster.deId() / 100) - 1, cluster.deId(), clIndex);
+      clusterMCH.ex = cluster.isGoodX() ? 0.2 : 10.0;
+      clusterMCH.ey = cluster.isGoodY() ? 0.2 : 10.0;
+    }
   }
 
   template <typename TMuons, typename TMuonCls>
@@ -232,6 +278,8 @@ struct MuonRealignment {
     realignFwdTrks.reserve(muons.size());
     realignFwdTrksCov.reserve(muons.size());
 
+    realignClusters(clusters);
+
     // Loop over forward tracks using association indices
     FwdTrkCovRealignInfo fwdTrkCovRealignInfo;
     for (auto const& muon : muons) {
@@ -240,34 +288,14 @@ struct MuonRealignment {
 
         auto clustersSliced = clusters.sliceBy(perMuon, muon.globalIndex()); // Slice clusters by muon id
         mch::Track convertedTrack = mch::Track();                            // Temporary variable to store re-aligned clusters
-        int clIndex = -1;
         // Get re-aligned clusters associated to current track
         for (auto const& cluster : clustersSliced) {
-          clIndex += 1;
-
-          mch::Cluster* clusterMCH = new mch::Cluster();
-
-          math_utils::Point3D<double> local;
-          math_utils::Point3D<double> master;
-          master.SetXYZ(cluster.x(), cluster.y(), cluster.z());
-
-          // Transformation from reference geometry frame to new geometry frame
-          transformRef[cluster.deId()].MasterToLocal(master, local);
-          transformNew[cluster.deId()].LocalToMaster(local, master);
-
-          clusterMCH->x = master.x();
-          clusterMCH->y = master.y();
-          clusterMCH->z = master.z();
-
-          uint32_t ClUId = mch::Cluster::buildUniqueId(static_cast<int>(cluster.deId() / 100) - 1, cluster.deId(), clIndex);
-          clusterMCH->uid = ClUId;
-          clusterMCH->ex = cluster.isGoodX() ? 0.2 : 10.0;
-          clusterMCH->ey = cluster.isGoodY() ? 0.2 : 10.0;
+          const mch::Cluster& clusterMCH = realignedClusters[cluster.globalIndex()];
 
           // Add transformed cluster into temporary variable
-          convertedTrack.createParamAtCluster(*clusterMCH);
+          convertedTrack.createParamAtCluster(clusterMCH);
           LOGF(debug, "Track %d, cluster DE%d:  x:%g  y:%g  z:%g", muon.globalIndex(), cluster.deId(), cluster.x(), cluster.y(), cluster.z());
-          LOGF(debug, "Track %d, re-aligned cluster DE%d:  x:%g  y:%g  z:%g", muonRealignId, cluster.deId(), clusterMCH->getX(), clusterMCH->getY(), clusterMCH->getZ());
+          LOGF(debug, "Track %d, re-aligned cluster DE%d:  x:%g  y:%g  z:%g", muonRealignId, cluster.deId(), clusterMCH.getX(), clusterMCH.getY(), clusterMCH.getZ());
         }
 
         // Refit the re-aligned track
@@ -355,9 +383,8 @@ struct MuonRealignment {
         } else {
           LOGF(fatal, "Reference aligned geometry object is not available in CCDB at timestamp=%llu", bc.timestamp());
         }
-        for (int i = 0; i < 156; i++) {
-          int iDEN = GetDetElemId(i);
-          transformRef[iDEN] = transformation(iDEN);
+        for (int i = 0; i < NDetElem; i++) {
+          transformRef[i] = transformation(GetDetElemId(i));
         }
 
         LOGF(info, "Loading new aligned geometry from CCDB no later than %d", nolaterthanNew.value);
@@ -369,9 +396,10 @@ struct MuonRealignment {
         } else {
           LOGF(fatal, "New aligned geometry object is not available in CCDB at timestamp=%llu", bc.timestamp());
         }
-        for (int i = 0; i < 156; i++) {
-          int iDEN = GetDetElemId(i);
-          transformNew[iDEN] = transformation(iDEN);
+        // Transformation from reference geometry frame to new geometry frame: reference master to local, then new local to master
+        for (int i = 0; i < NDetElem; i++) {
+          const ROOT::Math::Transform3D transformRealign = transformation(GetDetElemId(i)) * transformRef[i].Inverse();
+          transformRealign.GetComponents(&realignMatrices[12 * i]);
         }
 
         fCurrentRun = bc.runNumber();
@@ -1325,6 +1325,42 @@ struct TrackMeanOccTableProducer {
   std::vector<float> occRobustNtrackDetUnfm80;
   std::vector<float> occRobustMultTableUnfm80;
 
+  // prefix sums of the occupancy vectors, updated at each new time frame, for the mean occupancy over a range of bins
+  std::vector<double> occPrimUnfm80Sum;
+
+  std::vector<double> occFV0AUnfm80Sum;
+  std::vector<double> occFV0CUnfm80Sum;
+  std::vector<double> occFT0AUnfm80Sum;
+  std::vector<double> occFT0CUnfm80Sum;
+
+  std::vector<double> occFDDAUnfm80Sum;
+  std::vector<double> occFDDCUnfm80Sum;
+
+  std::vector<double> occNTrackITSUnfm80Sum;
+  std::vector<double> occNTrackTPCUnfm80Sum;
+  std::vector<double> occNTrackTRDUnfm80Sum;
+  std::vector<double> occNTrackTOFUnfm80Sum;
+  std::vector<double> occNTrackSizeUnfm80Sum;
+  std::vector<double> occNTrackTPCAUnfm80Sum;
+  std::vector<double> occNTrackTPCCUnfm80Sum;
+  std::vector<double> occNTrackITSTPCUnfm80Sum;
+  std::vector<double> occNTrackITSTPCAUnfm80Sum;
+  std::vector<double> occNTrackITSTPCCUnfm80Sum;
+
+  std::vector<double> occMultNTracksHasITSUnfm80Sum;
+  std::vector<double> occMultNTracksHasTPCUnfm80Sum;
+  std::vector<double> occMultNTracksHasTOFUnfm80Sum;
+  std::vector<double> occMultNTracksHasTRDUnfm80Sum;
+  std::vector<double> occMultNTracksITSOnlyUnfm80Sum;
+  std::vector<double> occMultNTracksTPCOnlyUnfm80Sum;
+  std::vector<double> occMultNTracksITSTPCUnfm80Sum;
+  std::vector<double> occMultAllTracksTPCOnlyUnfm80Sum;
+
+  std::vector<double> occRobustT0V0PrimUnfm80Sum;
+  std::vector<double> occRobustFDDT0V0PrimUnfm80Sum;
+  std::vector<double> occRobustNtrackDetUnfm80Sum;
+  std::vector<double> occRobustMultTableUnfm80Sum;
+
   std::vector<bool> processStatus;
   std::vector<bool> processInThisBlock;
   void init(InitContext const&)
@@ -1340,52 +1376,81 @@ struct TrackMeanOccTableProducer {
 
     if (buildFullOccTableProducer || buildOnlyOccsPrim) {
       occPrimUnfm80.resize(nBCinTF / bcGrouping);
+      occPrimUnfm80Sum.resize(nBCinTF / bcGrouping + 1);
     }
     if (buildFullOccTableProducer || buildOnlyOccsT0V0) {
       occFV0AUnfm80.resize(nBCinTF / bcGrouping);
+      occFV0AUnfm80Sum.resize(nBCinTF / bcGrouping + 1);
       occFV0CUnfm80.resize(nBCinTF / bcGrouping);
+      occFV0CUnfm80Sum.resize(nBCinTF / bcGrouping + 1);
       occFT0AUnfm80.resize(nBCinTF / bcGrouping);
+      occFT0AUnfm80Sum.resize(nBCinTF / bcGrouping + 1);
       occFT0CUnfm80.resize(nBCinTF / bcGrouping);
+      occFT0CUnfm80Sum.resize(nBCinTF / bcGrouping + 1);
     }
     if (buildFullOccTableProducer || buildOnlyOccsFDD) {
       occFDDAUnfm80.resize(nBCinTF / bcGrouping);
+      occFDDAUnfm80Sum.resize(nBCinTF / bcGrouping + 1);
       occFDDCUnfm80.resize(nBCinTF / bcGrouping);
+      occFDDCUnfm80Sum.resize(nBCinTF / bcGrouping + 1);
     }
     if (buildFullOccTableProducer || buildOnlyOccsNtrackDet) {
       occNTrackITSUnfm80.resize(nBCinTF / bcGrouping);
+      occNTrackITSUnfm80Sum.resize(nBCinTF / bcGrouping + 1);
       occNTrackTPCUnfm80.resize(nBCinTF / bcGrouping);
+      occNTrackTPCUnfm80Sum.resize(nBCinTF / bcGrouping + 1);
       occNTrackTRDUnfm80.resize(nBCinTF / bcGrouping);
+      occNTrackTRDUnfm80Sum.resize(nBCinTF / bcGrouping + 1);
       occNTrackTOFUnfm80.resize(nBCinTF / bcGrouping);
+      occNTrackTOFUnfm80Sum.resize(nBCinTF / bcGrouping + 1);
       occNTrackSizeUnfm80.resize(nBCinTF / bcGrouping);
+      occNTrackSizeUnfm80Sum.resize(nBCinTF / bcGrouping + 1);
       occNTrackTPCAUnfm80.resize(nBCinTF / bcGrouping);
+      occNTrackTPCAUnfm80Sum.resize(nBCinTF / bcGrouping + 1);
       occNTrackTPCCUnfm80.resize(nBCinTF / bcGrouping);
+      occNTrackTPCCUnfm80Sum.resize(nBCinTF / bcGrouping + 1);
       occNTrackITSTPCUnfm80.resize(nBCinTF / bcGrouping);
+      occNTrackITSTPCUnfm80Sum.resize(nBCinTF / bcGrouping + 1);
       occNTrackITSTPCAUnfm80.resize(nBCinTF / bcGrouping);
+      occNTrackITSTPCAUnfm80Sum.resize(nBCinTF / bcGrouping + 1);
       occNTrackITSTPCCUnfm80.resize(nBCinTF / bcGrouping);
+      occNTrackITSTPCCUnfm80Sum.resize(nBCinTF / bcGrouping + 1);
     }
 
     if (buildFullOccTableProducer || buildOnlyOccsMultExtra) {
       occMultNTracksHasITSUnfm80.resize(nBCinTF / bcGrouping);
+      occMultNTracksHasITSUnfm80Sum.resize(nBCinTF / bcGrouping + 1);
       occMultNTracksHasTPCUnfm80.resize(nBCinTF / bcGrouping);
+      occMultNTracksHasTPCUnfm80Sum.resize(nBCinTF / bcGrouping + 1);
       occMultNTracksHasTOFUnfm80.resize(nBCinTF / bcGrouping);
+      occMultNTracksHasTOFUnfm80Sum.resize(nBCinTF / bcGrouping + 1);
       occMultNTracksHasTRDUnfm80.resize(nBCinTF / bcGrouping);
+      occMultNTracksHasTRDUnfm80Sum.resize(nBCinTF / bcGrouping + 1);
       occMultNTracksITSOnlyUnfm80.resize(nBCinTF / bcGrouping);
+      occMultNTracksITSOnlyUnfm80Sum.resize(nBCinTF / bcGrouping + 1);
       occMultNTracksTPCOnlyUnfm80.resize(nBCinTF / bcGrouping);
+      occMultNTracksTPCOnlyUnfm80Sum.resize(nBCinTF / bcGrouping + 1);
       occMultNTracksITSTPCUnfm80.resize(nBCinTF / bcGrouping);
+      occMultNTracksITSTPCUnfm80Sum.resize(nBCinTF / bcGrouping + 1);
       occMultAllTracksTPCOnlyUnfm80.resize(nBCinTF / bcGrouping);
+      occMultAllTracksTPCOnlyUnfm80Sum.resize(nBCinTF / bcGrouping + 1);
     }
 
     if (buildFullOccTableProducer || buildOnlyOccsRobustT0V0Prim || fillQA1 || fillQA2) {
       occRobustT0V0PrimUnfm80.resize(nBCinTF / bcGrouping);
+      occRobustT0V0PrimUnfm80Sum.resize(nBCinTF / bcGrouping + 1);
     }
     if (buildFullOccTableProducer || buildOnlyOccsRobustFDDT0V0Prim) {
       occRobustFDDT0V0PrimUnfm80.resize(nBCinTF / bcGrouping);
+      occRobustFDDT0V0PrimUnfm80Sum.resize(nBCinTF / bcGrouping + 1);
     }
     if (buildFullOccTableProducer || buildOnlyOccsRobustNtrackDet) {
       occRobustNtrackDetUnfm80.resize(nBCinTF / bcGrouping);
+      occRobustNtrackDetUnfm80Sum.resize(nBCinTF / bcGrouping + 1);
     }
     if (buildFullOccTableProducer || buildOnlyOccsRobustMultExtra) {
       occRobustMultTableUnfm80.resize(nBCinTF / bcGrouping);
+      occRobustMultTableUnfm80Sum.resize(nBCinTF / bcGrouping + 1);
     }
 
     const AxisSpec axisQA1 = {500, 0, 50000};
@@ -1633,9 +1698,16 @@ struct TrackMeanOccTableProducer {
     bcInTF = (bc.globalBC() - bcSOR) % nBCsPerTF;
   }
 
-  float getMeanOccupancy(int bcBegin, int bcEnd, const std::vector<float>& OccVector)
+  void fillPrefixSum(const std::vector<float>& OccVector, std::vector<double>& sumVector)
+  {
+    sumVector[0] = 0.;
+    for (std::size_t i = 0; i < OccVector.size(); i++) {
+      sumVector[i + 1] = sumVector[i] + OccVector[i];
+    }
+  }
+
+  float getMeanOccupancy(int bcBegin, int bcEnd, const std::vector<double>& sumVector)
   {
-    float sumOfBins = 0;
     int binStart, binEnd;
     if (bcBegin <= bcEnd) {
       binStart = bcBegin;
@@ -1644,10 +1716,7 @@ struct TrackMeanOccTableProducer {
       binStart = bcEnd;
       binEnd = bcBegin;
     }
-    for (int i = binStart; i <= binEnd; i++) {
-      sumOfBins += OccVector[i];
-    }
-    float meanOccupancy = sumOfBins / static_cast<double>(binEnd - binStart + 1);
+    float meanOccupancy = (sumVector[binEnd + 1] - sumVector[binStart]) / static_cast<double>(binEnd - binStart + 1);
     return meanOccupancy;
   }
 
@@ -1978,56 +2047,86 @@ struct TrackMeanOccTableProducer {
 
           if constexpr (qaMode == fillOccRobustT0V0dependentQA) {
             std::copy(occsRobustT0V0Prim.iteratorAt(bc.occId()).occRobustT0V0PrimUnfm80().begin(), occsRobustT0V0Prim.iteratorAt(bc.occId()).occRobustT0V0PrimUnfm80().end(), occRobustT0V0PrimUnfm80.begin());
+            fillPrefixSum(occRobustT0V0PrimUnfm80, occRobustT0V0PrimUnfm80Sum);
           }
 
           if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccPrim) {
             std::copy(occsList.occPrimUnfm80().begin(), occsList.occPrimUnfm80().end(), occPrimUnfm80.begin());
+            fillPrefixSum(occPrimUnfm80, occPrimUnfm80Sum);
           }
           if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccT0V0) {
             std::copy(occsList.occFV0AUnfm80().begin(), occsList.occFV0AUnfm80().end(), occFV0AUnfm80.begin());
+            fillPrefixSum(occFV0AUnfm80, occFV0AUnfm80Sum);
             std::copy(occsList.occFV0CUnfm80().begin(), occsList.occFV0CUnfm80().end(), occFV0CUnfm80.begin());
+            fillPrefixSum(occFV0CUnfm80, occFV0CUnfm80Sum);
             std::copy(occsList.occFT0AUnfm80().begin(), occsList.occFT0AUnfm80().end(), occFT0AUnfm80.begin());
+            fillPrefixSum(occFT0AUnfm80, occFT0AUnfm80Sum);
             std::copy(occsList.occFT0CUnfm80().begin(), occsList.occFT0CUnfm80().end(), occFT0CUnfm80.begin());
+            fillPrefixSum(occFT0CUnfm80, occFT0CUnfm80Sum);
           }
           if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccFDD) {
             std::copy(occsList.occFDDAUnfm80().begin(), occsList.occFDDAUnfm80().end(), occFDDAUnfm80.begin());
+            fillPrefixSum(occFDDAUnfm80, occFDDAUnfm80Sum);
             std::copy(occsList.occFDDCUnfm80().begin(), occsList.occFDDCUnfm80().end(), occFDDCUnfm80.begin());
+            fillPrefixSum(occFDDCUnfm80, occFDDCUnfm80Sum);
           }
 
           if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccNtrackDet) {
             std::copy(occsList.occNTrackITSUnfm80().begin(), occsList.occNTrackITSUnfm80().end(), occNTrackITSUnfm80.begin());
+            fillPrefixSum(occNTrackITSUnfm80, occNTrackITSUnfm80Sum);
             std::copy(occsList.occNTrackTPCUnfm80().begin(), occsList.occNTrackTPCUnfm80().end(), occNTrackTPCUnfm80.begin());
+            fillPrefixSum(occNTrackTPCUnfm80, occNTrackTPCUnfm80Sum);
             std::copy(occsList.occNTrackTRDUnfm80().begin(), occsList.occNTrackTRDUnfm80().end(), occNTrackTRDUnfm80.begin());
+            fillPrefixSum(occNTrackTRDUnfm80, occNTrackTRDUnfm80Sum);
             std::copy(occsList.occNTrackTOFUnfm80().begin(), occsList.occNTrackTOFUnfm80().end(), occNTrackTOFUnfm80.begin());
+            fillPrefixSum(occNTrackTOFUnfm80, occNTrackTOFUnfm80Sum);
             std::copy(occsList.occNTrackSizeUnfm80().begin(), occsList.occNTrackSizeUnfm80().end(), occNTrackSizeUnfm80.begin());
+            fillPrefixSum(occNTrackSizeUnfm80, occNTrackSizeUnfm80Sum);
             std::copy(occsList.occNTrackTPCAUnfm80().begin(), occsList.occNTrackTPCAUnfm80().end(), occNTrackTPCAUnfm80.begin());
+            fillPrefixSum(occNTrackTPCAUnfm80, occNTrackTPCAUnfm80Sum);
             std::copy(occsList.occNTrackTPCCUnfm80().begin(), occsList.occNTrackTPCCUnfm80().end(), occNTrackTPCCUnfm80.begin());
+            fillPrefixSum(occNTrackTPCCUnfm80, occNTrackTPCCUnfm80Sum);
             std::copy(occsList.occNTrackITSTPCUnfm80().begin(), occsList.occNTrackITSTPCUnfm80().end(), occNTrackITSTPCUnfm80.begin());
+            fillPrefixSum(occNTrackITSTPCUnfm80, occNTrackITSTPCUnfm80Sum);
             std::copy(occsList.occNTrackITSTPCAUnfm80().begin(), occsList.occNTrackITSTPCAUnfm80().end(), occNTrackITSTPCAUnfm80.begin());
+            fillPrefixSum(occNTrackITSTPCAUnfm80, occNTrackITSTPCAUnfm80Sum);
             std::copy(occsList.occNTrackITSTPCCUnfm80().begin(), occsList.occNTrackITSTPCCUnfm80().end(), occNTrackITSTPCCUnfm80.begin());
+            fillPrefixSum(occNTrackITSTPCCUnfm80, occNTrackITSTPCCUnfm80Sum);
           }
 
           if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccMultExtra) {
             std::copy(occsList.occMultNTracksHasITSUnfm80().begin(), occsList.occMultNTracksHasITSUnfm80().end(), occMultNTracksHasITSUnfm80.begin());
+            fillPrefixSum(occMultNTracksHasITSUnfm80, occMultNTracksHasITSUnfm80Sum);
             std::copy(occsList.occMultNTracksHasTPCUnfm80().begin(), occsList.occMultNTracksHasTPCUnfm80().end(), occMultNTracksHasTPCUnfm80.begin());
+            fillPrefixSum(occMultNTracksHasTPCUnfm80, occMultNTracksHasTPCUnfm80Sum);
             std::copy(occsList.occMultNTracksHasTOFUnfm80().begin(), occsList.occMultNTracksHasTOFUnfm80().end(), occMultNTracksHasTOFUnfm80.begin());
+            fillPrefixSum(occMultNTracksHasTOFUnfm80, occMultNTracksHasTOFUnfm80Sum);
             std::copy(occsList.occMultNTracksHasTRDUnfm80().begin(), occsList.occMultNTracksHasTRDUnfm80().end(), occMultNTracksHasTRDUnfm80.begin());
+            fillPrefixSum(occMultNTracksHasTRDUnfm80, occMultNTracksHasTRDUnfm80Sum);
             std::copy(occsList.occMultNTracksITSOnlyUnfm80().begin(), occsList.occMultNTracksITSOnlyUnfm80().end(), occMultNTracksITSOnlyUnfm80.begin());
+            fillPrefixSum(occMultNTracksITSOnlyUnfm80, occMultNTracksITSOnlyUnfm80Sum);
             std::copy(occsList.occMultNTracksTPCOnlyUnfm80().begin(), occsList.occMultNTracksTPCOnlyUnfm80().end(), occMultNTracksTPCOnlyUnfm80.begin());
+            fillPrefixSum(occMultNTracksTPCOnlyUnfm80, occMultNTracksTPCOnlyUnfm80Sum);
             std::copy(occsList.occMultNTracksITSTPCUnfm80().begin(), occsList.occMultNTracksITSTPCUnfm80().end(), occMultNTracksITSTPCUnfm80.begin());
+            fillPrefixSum(occMultNTracksITSTPCUnfm80, occMultNTracksITSTPCUnfm80Sum);
             std::copy(occsList.occMultAllTracksTPCOnlyUnfm80().begin(), occsList.occMultAllTracksTPCOnlyUnfm80().end(), occMultAllTracksTPCOnlyUnfm80.begin());
+            fillPrefixSum(occMultAllTracksTPCOnlyUnfm80, occMultAllTracksTPCOnlyUnfm80Sum);
           }
           if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyRobustT0V0Prim) {
             std::copy(occsList.occRobustT0V0PrimUnfm80().begin(), occsList.occRobustT0V0PrimUnfm80().end(), occRobustT0V0PrimUnfm80.begin());
+            fillPrefixSum(occRobustT0V0PrimUnfm80, occRobustT0V0PrimUnfm80Sum);
           }
           if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyRobustFDDT0V0Prim) {
             std::copy(occsList.occRobustFDDT0V0PrimUnfm80().begin(), occsList.occRobustFDDT0V0PrimUnfm80().end(), occRobustFDDT0V0PrimUnfm80.begin());
+            fillPrefixSum(occRobustFDDT0V0PrimUnfm80, occRobustFDDT0V0PrimUnfm80Sum);
           }
           if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyRobustNtrackDet) {
             std::copy(occsList.occRobustNtrackDetUnfm80().begin(), occsList.occRobustNtrackDetUnfm80().end(), occRobustNtrackDetUnfm80.begin());
+            fillPrefixSum(occRobustNtrackDetUnfm80, occRobustNtrackDetUnfm80Sum);
           }
           if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyRobustMultExtra) {
             std::copy(occsList.occRobustMultExtraTableUnfm80().begin(), occsList.occRobustMultExtraTableUnfm80().end(), occRobustMultTableUnfm80.begin());
+            fillPrefixSum(occRobustMultTableUnfm80, occRobustMultTableUnfm80Sum);
           }
         }
 
@@ -2072,7 +2171,7 @@ struct TrackMeanOccTableProducer {
 
         if constexpr (qaMode == fillOccRobustT0V0dependentQA) {
           if constexpr (meanTableMode == fillMeanOccTable) {
-            meanOccRobustT0V0PrimUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occRobustT0V0PrimUnfm80);
+            meanOccRobustT0V0PrimUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occRobustT0V0PrimUnfm80Sum);
           }
           if constexpr (weightMeanTableMode == fillWeightMeanOccTable) {
             weightMeanOccRobustT0V0PrimUnfm80 = getWeightedMeanOccupancy(binBCbegin, binBCend, occRobustT0V0PrimUnfm80);
@@ -2081,7 +2180,7 @@ struct TrackMeanOccTableProducer {
 
         if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccPrim) {
           if constexpr (meanTableMode == fillMeanOccTable) {
-            meanOccPrimUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occPrimUnfm80);
+            meanOccPrimUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occPrimUnfm80Sum);
             genTmoPrim(meanOccPrimUnfm80);
             fillQAInfo<kMean, kRobustT0V0Prim, kOccPrimUnfm80>(meanOccPrimUnfm80, meanOccRobustT0V0PrimUnfm80);
           }
@@ -2095,10 +2194,10 @@ struct TrackMeanOccTableProducer {
 
         if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccT0V0) {
           if constexpr (meanTableMode == fillMeanOccTable) {
-            meanOccFV0AUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occFV0AUnfm80);
-            meanOccFV0CUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occFV0CUnfm80);
-            meanOccFT0AUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occFT0AUnfm80);
-            meanOccFT0CUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occFT0CUnfm80);
+            meanOccFV0AUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occFV0AUnfm80Sum);
+            meanOccFV0CUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occFV0CUnfm80Sum);
+            meanOccFT0AUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occFT0AUnfm80Sum);
+            meanOccFT0CUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occFT0CUnfm80Sum);
             genTmoT0V0(meanOccFV0AUnfm80,
                        meanOccFV0CUnfm80,
                        meanOccFT0AUnfm80,
@@ -2131,8 +2230,8 @@ struct TrackMeanOccTableProducer {
 
         if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccFDD) {
           if constexpr (meanTableMode == fillMeanOccTable) {
-            meanOccFDDAUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occFDDAUnfm80);
-            meanOccFDDCUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occFDDCUnfm80);
+            meanOccFDDAUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occFDDAUnfm80Sum);
+            meanOccFDDCUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occFDDCUnfm80Sum);
             genTmoFDD(meanOccFDDAUnfm80,
                       meanOccFDDCUnfm80);
             fillQAInfo<kMean, kRobustT0V0Prim, kOccFDDAUnfm80>(meanOccFDDAUnfm80, meanOccRobustT0V0PrimUnfm80);
@@ -2153,16 +2252,16 @@ struct TrackMeanOccTableProducer {
 
         if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccNtrackDet) {
           if constexpr (meanTableMode == fillMeanOccTable) {
-            meanOccNTrackITSUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occNTrackITSUnfm80);
-            meanOccNTrackTPCUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occNTrackTPCUnfm80);
-            meanOccNTrackTRDUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occNTrackTRDUnfm80);
-            meanOccNTrackTOFUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occNTrackTOFUnfm80);
-            meanOccNTrackSizeUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occNTrackSizeUnfm80);
-            meanOccNTrackTPCAUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occNTrackTPCAUnfm80);
-            meanOccNTrackTPCCUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occNTrackTPCCUnfm80);
-            meanOccNTrackITSTPCUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occNTrackITSTPCUnfm80);
-            meanOccNTrackITSTPCAUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occNTrackITSTPCAUnfm80);
-            meanOccNTrackITSTPCCUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occNTrackITSTPCCUnfm80);
+            meanOccNTrackITSUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occNTrackITSUnfm80Sum);
+            meanOccNTrackTPCUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occNTrackTPCUnfm80Sum);
+            meanOccNTrackTRDUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occNTrackTRDUnfm80Sum);
+            meanOccNTrackTOFUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occNTrackTOFUnfm80Sum);
+            meanOccNTrackSizeUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occNTrackSizeUnfm80Sum);
+            meanOccNTrackTPCAUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occNTrackTPCAUnfm80Sum);
+            meanOccNTrackTPCCUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occNTrackTPCCUnfm80Sum);
+            meanOccNTrackITSTPCUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occNTrackITSTPCUnfm80Sum);
+            meanOccNTrackITSTPCAUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occNTrackITSTPCAUnfm80Sum);
+            meanOccNTrackITSTPCCUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occNTrackITSTPCCUnfm80Sum);
             genTmoNTrackDet(meanOccNTrackITSUnfm80,
                             meanOccNTrackTPCUnfm80,
                             meanOccNTrackTRDUnfm80,
@@ -2233,14 +2332,14 @@ struct TrackMeanOccTableProducer {
 
         if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccMultExtra) {
           if constexpr (meanTableMode == fillMeanOccTable) {
-            meanOccMultNTracksHasITSUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occMultNTracksHasITSUnfm80);
-            meanOccMultNTracksHasTPCUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occMultNTracksHasTPCUnfm80);
-            meanOccMultNTracksHasTOFUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occMultNTracksHasTOFUnfm80);
-            meanOccMultNTracksHasTRDUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occMultNTracksHasTRDUnfm80);
-            meanOccMultNTracksITSOnlyUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occMultNTracksITSOnlyUnfm80);
-            meanOccMultNTracksTPCOnlyUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occMultNTracksTPCOnlyUnfm80);
-            meanOccMultNTracksITSTPCUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occMultNTracksITSTPCUnfm80);
-            meanOccMultAllTracksTPCOnlyUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occMultAllTracksTPCOnlyUnfm80);
+            meanOccMultNTracksHasITSUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occMultNTracksHasITSUnfm80Sum);
+            meanOccMultNTracksHasTPCUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occMultNTracksHasTPCUnfm80Sum);
+            meanOccMultNTracksHasTOFUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occMultNTracksHasTOFUnfm80Sum);
+            meanOccMultNTracksHasTRDUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occMultNTracksHasTRDUnfm80Sum);
+            meanOccMultNTracksITSOnlyUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occMultNTracksITSOnlyUnfm80Sum);
+            meanOccMultNTracksTPCOnlyUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occMultNTracksTPCOnlyUnfm80Sum);
+            meanOccMultNTracksITSTPCUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occMultNTracksITSTPCUnfm80Sum);
+            meanOccMultAllTracksTPCOnlyUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occMultAllTracksTPCOnlyUnfm80Sum);
             genTmoMultExtra(meanOccMultNTracksHasITSUnfm80,
                             meanOccMultNTracksHasTPCUnfm80,
                             meanOccMultNTracksHasTOFUnfm80,
@@ -2299,7 +2398,7 @@ struct TrackMeanOccTableProducer {
 
         if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyRobustT0V0Prim) {
           if constexpr (meanTableMode == fillMeanOccTable) {
-            meanOccRobustT0V0PrimUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occRobustT0V0PrimUnfm80);
+            meanOccRobustT0V0PrimUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occRobustT0V0PrimUnfm80Sum);
             genTmoRT0V0Prim(meanOccRobustT0V0PrimUnfm80);
             fillQAInfo<kMean, kRobustT0V0Prim, kOccRobustT0V0PrimUnfm80>(meanOccRobustT0V0PrimUnfm80, meanOccRobustT0V0PrimUnfm80);
           }
@@ -2313,7 +2412,7 @@ struct TrackMeanOccTableProducer {
 
         if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyRobustFDDT0V0Prim) {
           if constexpr (meanTableMode == fillMeanOccTable) {
-            meanOccRobustFDDT0V0PrimUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occRobustFDDT0V0PrimUnfm80);
+            meanOccRobustFDDT0V0PrimUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occRobustFDDT0V0PrimUnfm80Sum);
             genTmoRFDDT0V0Prim(meanOccRobustFDDT0V0PrimUnfm80);
             fillQAInfo<kMean, kRobustT0V0Prim, kOccRobustFDDT0V0PrimUnfm80>(meanOccRobustFDDT0V0PrimUnfm80, meanOccRobustT0V0PrimUnfm80);
           }
@@ -2327,7 +2426,7 @@ struct TrackMeanOccTableProducer {
 
         if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyRobustNtrackDet) {
           if constexpr (meanTableMode == fillMeanOccTable) {
-            meanOccRobustNtrackDetUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occRobustNtrackDetUnfm80);
+            meanOccRobustNtrackDetUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occRobustNtrackDetUnfm80Sum);
             genTmoRNtrackDet(meanOccRobustNtrackDetUnfm80);
             fillQAInfo<kMean, kRobustT0V0Prim, kOccRobustNtrackDetUnfm80>(meanOccRobustNtrackDetUnfm80, meanOccRobustT0V0PrimUnfm80);
           }
@@ -2341,7 +2440,7 @@ struct TrackMeanOccTableProducer {
 
         if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyRobustMultExtra) {
           if constexpr (meanTableMode == fillMeanOccTable) {
-            meanOccRobustMultTableUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occRobustMultTableUnfm80);
+            meanOccRobustMultTableUnfm80 = getMeanOccupancy(binBCbegin, binBCend, occRobustMultTableUnfm80Sum);
             genTmoRMultExtra(meanOccRobustMultTableUnfm80);
             fillQAInfo<kMean, kRobustT0V0Prim, kOccRobustMultTableUnfm80>(meanOccRobustMultTableUnfm80, meanOccRobustT0V0PrimUnfm80);
           }
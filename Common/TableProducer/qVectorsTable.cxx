@@ -45,8 +45,10 @@
 
 #include <TComplex.h>
 #include <TH3.h>
+#include <TProfile3D.h>
 #include <TString.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
@@ -151,6 +153,33 @@ struct qVectorsTable {
   std::vector<TH3F*> objQvec{};
   std::vector<TProfile3D*> shiftprofile{};
 
+  static constexpr int NChannelsFT0 = 208;
+  static constexpr int NChannelsFV0 = 48;
+  static constexpr int NCorrConstants = 6; // recentering, twist and rescale constants of objQvec
+  static constexpr int NShifts = 10;       // orders of the shift correction
+
+  // Correction constants of objQvec, flattened at each new run: [(centrality bin * (kTPCall + 1) + detector) * NCorrConstants + constant].
+  struct QvecCorrection {
+    int nCentBins = 0; // including under- and overflow
+    std::vector<float> constants{};
+    const float* get(int centBin, int det) const { return &constants[(centBin * (kTPCall + 1) + det) * NCorrConstants]; }
+  };
+  std::vector<QvecCorrection> qvecCorrections{};
+
+  // Coefficients of shiftprofile, flattened at each new run: [(centrality bin * 2 * (kTPCall + 1) + 2 * detector + x/y) * NShifts + order - 1].
+  struct ShiftCorrection {
+    TProfile3D* profile = nullptr; // for the centrality axis
+    std::vector<double> coefficients{};
+    double get(int centBin, int component, int order) const { return coefficients[(centBin * 2 * (kTPCall + 1) + component) * NShifts + order - 1]; }
+  };
+  std::vector<ShiftCorrection> shiftCorrections{};
+
+  // cos(n*phi) and sin(n*phi) of the FIT channels for each harmonic of cfgnMods, filled at each new run.
+  std::vector<std::vector<double>> FT0CosPhi{};
+  std::vector<std::vector<double>> FT0SinPhi{};
+  std::vector<std::vector<double>> FV0CosPhi{};
+  std::vector<std::vector<double>> FV0SinPhi{};
+
   // Deprecated, will be removed in future after transition time //
   Configurable<bool> cfgUseBPos{"cfgUseBPos", false, "Initial value for using BPos. By default obtained from DataModel."};
   Configurable<bool> cfgUseBNeg{"cfgUseBNeg", false, "Initial value for using BNeg. By default obtained from DataModel."};
@@ -177,6 +206,18 @@ struct qVectorsTable {
     {"QvectorFT0As", cfgUseFT0A},
     {"QvectorFT0Cs", cfgUseFT0C}};
 
+  // Detectors in use, copied from useDetector at init to avoid the map lookups for each collision.
+  bool useFT0C = false;
+  bool useFT0A = false;
+  bool useFT0M = false;
+  bool useFV0A = false;
+  bool useTPCpos = false;
+  bool useTPCneg = false;
+  bool useTPCall = false;
+  bool useBPos = false;
+  bool useBNeg = false;
+  bool useBTot = false;
+
   void init(InitContext& initContext)
   {
     // Check the sub-detector used
@@ -224,6 +265,17 @@ struct qVectorsTable {
     histosQA.add("FT0AmpCor", "", {HistType::kTH2F, {axisFITamp, axisChID}});
     histosQA.add("FV0Amp", "", {HistType::kTH2F, {axisFITamp, axisChID}});
     histosQA.add("FV0AmpCor", "", {HistType::kTH2F, {axisFITamp, axisChID}});
+
+    useFT0C = useDetector["QvectorFT0Cs"];
+    useFT0A = useDetector["QvectorFT0As"];
+    useFT0M = useDetector["QvectorFT0Ms"];
+    useFV0A = useDetector["QvectorFV0As"];
+    useTPCpos = useDetector["QvectorTPCposs"];
+    useTPCneg = useDetector["QvectorTPCnegs"];
+    useTPCall = useDetector["QvectorTPCalls"];
+    useBPos = useDetector["QvectorBPoss"];
+    useBNeg = useDetector["QvectorBNegs"];
+    useBTot = useDetector["QvectorBTots"];
   }
 
   void initCCDB(aod::BCsWithTimestamps::iterator const& bc)
@@ -270,6 +322,32 @@ struct qVectorsTable {
       objQvec.push_back(objqvec);
     }
 
+    qvecCorrections.clear();
+    for (std::size_t i = 0; i < objQvec.size(); i++) {
+      if (objQvec[i] == nullptr) {
+        LOGF(fatal, "Could not get the Q-vector calibration constants for n = %d.", cfgnMods->at(i));
+      }
+      auto& corr = qvecCorrections.emplace_back();
+      corr.nCentBins = objQvec[i]->GetNbinsX() + 2;
+      corr.constants.resize(corr.nCentBins * (kTPCall + 1) * NCorrConstants);
+      for (int ix = 0; ix < corr.nCentBins; ix++) {
+        for (int det = 0; det < kTPCall + 1; det++) {
+          for (int ic = 0; ic < NCorrConstants; ic++) {
+            corr.constants[(ix * (kTPCall + 1) + det) * NCorrConstants + ic] = objQvec[i]->GetBinContent(ix, ic + 1, det + 1);
+          }
+        }
+      }
+    }
+
+    FT0CosPhi.resize(cfgnMods->size());
+    FT0SinPhi.resize(cfgnMods->size());
+    FV0CosPhi.resize(cfgnMods->size());
+    FV0SinPhi.resize(cfgnMods->size());
+    for (std::size_t i = 0; i < cfgnMods->size(); i++) {
+      helperEP.GetChannelHarmonics(0, NChannelsFT0, cfgnMods->at(i), FT0CosPhi[i], FT0SinPhi[i], ft0geom, fv0geom);
+      helperEP.GetChannelHarmonics(1, NChannelsFV0, cfgnMods->at(i), FV0CosPhi[i], FV0SinPhi[i], ft0geom, fv0geom);
+    }
+
     if (cfgShiftCorr) {
       shiftprofile.clear();
       for (std::size_t i = 0; i < cfgnMods->size(); i++) {
@@ -280,6 +358,26 @@ struct qVectorsTable {
         auto objshift = getForTsOrRun<TProfile3D>(fullPath, timestamp, runnumber);
         shiftprofile.push_back(objshift);
       }
+
+      shiftCorrections.clear();
+      for (std::size_t i = 0; i < shiftprofile.size(); i++) {
+        auto* objshift = shiftprofile[i];
+        if (objshift == nullptr) {
+          LOGF(fatal, "Could not get the shift correction for n = %d.", cfgnMods->at(i));
+        }
+        auto& shift = shiftCorrections.emplace_back();
+        shift.profile = objshift;
+        const int nCentBins = objshift->GetNbinsX() + 2;
+        shift.coefficients.resize(nCentBins * 2 * (kTPCall + 1) * NShifts);
+        for (int ix = 0; ix < nCentBins; ix++) {
+          for (int comp = 0; comp < 2 * (kTPCall + 1); comp++) {
+            for (int ishift = 1; ishift <= NShifts; ishift++) {
+              const int bin = objshift->GetBin(ix, objshift->GetYaxis()->FindBin(comp), objshift->GetZaxis()->FindBin(ishift - 0.5));
+              shift.coefficients[(ix * 2 * (kTPCall + 1) + comp) * NShifts + ishift - 1] = objshift->GetBinContent(bin);
+            }
+          }
+        }
+      }
     }
 
     fullPath = cfgGainEqPath;
@@ -345,116 +443,85 @@ struct qVectorsTable {
     }
   }
 
-  template <typename Nmode, typename CollType, typename TrackType>
-  void CalQvec(const Nmode nmode, const CollType& coll, const TrackType& track, std::vector<float>& QvecRe, std::vector<float>& QvecIm, std::vector<float>& QvecAmp, std::vector<int>& TrkTPCposLabel, std::vector<int>& TrkTPCnegLabel, std::vector<int>& TrkTPCallLabel)
+  // Q-vectors of all the harmonics of cfgnMods, computed in a single pass over the FIT channels and the tracks.
+  // The vectors are filled as if the harmonics were processed one after the other (the track labels are repeated for each harmonic).
+  template <typename CollType, typename TrackType>
+  void CalQvec(const CollType& coll, const TrackType& track, std::vector<float>& QvecRe, std::vector<float>& QvecIm, std::vector<float>& QvecAmp, std::vector<int>& TrkTPCposLabel, std::vector<int>& TrkTPCnegLabel, std::vector<int>& TrkTPCallLabel)
   {
-    float qVectFT0A[2] = {0.};
-    float qVectFT0C[2] = {0.};
-    float qVectFT0M[2] = {0.};
-    float qVectFV0A[2] = {0.};
-    float qVectTPCpos[2] = {0.};
-    float qVectTPCneg[2] = {0.};
-    float qVectTPCall[2] = {0.};
-
-    TComplex QvecDet(0);
-    TComplex QvecFT0M(0);
+    const std::size_t nMods = cfgnMods->size();
+
+    std::vector<TComplex> QvecFT0A(nMods, TComplex(0.));
+    std::vector<TComplex> QvecFT0C(nMods, TComplex(0.));
+    std::vector<TComplex> QvecFT0M(nMods, TComplex(0.));
+    std::vector<TComplex> QvecFV0A(nMods, TComplex(0.));
+    std::vector<float> qVectTPCposSum(2 * nMods, 0.);
+    std::vector<float> qVectTPCnegSum(2 * nMods, 0.);
+    std::vector<float> qVectTPCallSum(2 * nMods, 0.);
     float sumAmplFT0A = 0.;
     float sumAmplFT0C = 0.;
     float sumAmplFT0M = 0.;
     float sumAmplFV0A = 0.;
 
-    if (coll.has_foundFT0() && (useDetector["QvectorFT0As"] || useDetector["QvectorFT0Cs"] || useDetector["QvectorFT0Ms"])) {
+    const bool hasFT0 = coll.has_foundFT0() && (useFT0A || useFT0C || useFT0M);
+    if (hasFT0) {
       auto ft0 = coll.foundFT0();
 
-      if (useDetector["QvectorFT0As"]) {
+      if (useFT0A) {
         for (std::size_t iChA = 0; iChA < ft0.channelA().size(); iChA++) {
           float ampl = ft0.amplitudeA()[iChA];
           int FT0AchId = ft0.channelA()[iChA];
+          float amplCor = ampl / FT0RelGainConst[FT0AchId];
 
-          histosQA.fill(HIST("FT0Amp"), ampl, FT0AchId);
-          histosQA.fill(HIST("FT0AmpCor"), ampl / FT0RelGainConst[FT0AchId], FT0AchId);
+          for (std::size_t id = 0; id < nMods; id++) {
+            histosQA.fill(HIST("FT0Amp"), ampl, FT0AchId);
+            histosQA.fill(HIST("FT0AmpCor"), amplCor, FT0AchId);
 
-          helperEP.SumQvectors(0, FT0AchId, ampl / FT0RelGainConst[FT0AchId], nmode, QvecDet, sumAmplFT0A, ft0geom, fv0geom);
-          helperEP.SumQvectors(0, FT0AchId, ampl / FT0RelGainConst[FT0AchId], nmode, QvecFT0M, sumAmplFT0M, ft0geom, fv0geom);
-        }
-        if (sumAmplFT0A > 1e-8) {
-          QvecDet /= sumAmplFT0A;
-          qVectFT0A[0] = QvecDet.Re();
-          qVectFT0A[1] = QvecDet.Im();
+            const TComplex qvecCh(amplCor * FT0CosPhi[id][FT0AchId], amplCor * FT0SinPhi[id][FT0AchId]);
+            QvecFT0A[id] += qvecCh;
+            QvecFT0M[id] += qvecCh;
+          }
+          sumAmplFT0A += amplCor;
+          sumAmplFT0M += amplCor;
         }
-      } else {
-        qVectFT0A[0] = 999.;
-        qVectFT0A[1] = 999.;
       }
 
-      if (useDetector["QvectorFT0Cs"]) {
-        QvecDet = TComplex(0., 0.);
+      if (useFT0C) {
         for (std::size_t iChC = 0; iChC < ft0.channelC().size(); iChC++) {
           float ampl = ft0.amplitudeC()[iChC];
           int FT0CchId = ft0.channelC()[iChC] + 96;
+          float amplCor = ampl / FT0RelGainConst[FT0CchId];
 
-          histosQA.fill(HIST("FT0Amp"), ampl, FT0CchId);
-          histosQA.fill(HIST("FT0AmpCor"), ampl / FT0RelGainConst[FT0CchId], FT0CchId);
-
-          helperEP.SumQvectors(0, FT0CchId, ampl / FT0RelGainConst[FT0CchId], nmode, QvecDet, sumAmplFT0C, ft0geom, fv0geom);
-          helperEP.SumQvectors(0, FT0CchId, ampl / FT0RelGainConst[FT0CchId], nmode, QvecFT0M, sumAmplFT0M, ft0geom, fv0geom);
-        }
+          for (std::size_t id = 0; id < nMods; id++) {
+            histosQA.fill(HIST("FT0Amp"), ampl, FT0CchId);
+            histosQA.fill(HIST("FT0AmpCor"), amplCor, FT0CchId);
 
-        if (sumAmplFT0C > 1e-8) {
-          QvecDet /= sumAmplFT0C;
-          qVectFT0C[0] = QvecDet.Re();
-          qVectFT0C[1] = QvecDet.Im();
-        } else {
-          qVectFT0C[0] = 999.;
-          qVectFT0C[1] = 999.;
+            const TComplex qvecCh(amplCor * FT0CosPhi[id][FT0CchId], amplCor * FT0SinPhi[id][FT0CchId]);
+            QvecFT0C[id] += qvecCh;
+            QvecFT0M[id] += qvecCh;
+          }
+          sumAmplFT0C += amplCor;
+          sumAmplFT0M += amplCor;
         }
-      } else {
-        qVectFT0C[0] = -999.;
-        qVectFT0C[1] = -999.;
-      }
-
-      if (sumAmplFT0M > 1e-8 && useDetector["QvectorFT0Ms"]) {
-        QvecFT0M /= sumAmplFT0M;
-        qVectFT0M[0] = QvecFT0M.Re();
-        qVectFT0M[1] = QvecFT0M.Im();
-      } else {
-        qVectFT0M[0] = 999.;
-        qVectFT0M[1] = 999.;
       }
-    } else {
-      qVectFT0A[0] = -999.;
-      qVectFT0A[1] = -999.;
-      qVectFT0C[0] = -999.;
-      qVectFT0C[1] = -999.;
-      qVectFT0M[0] = -999.;
-      qVectFT0M[1] = -999.;
     }
 
-    QvecDet = TComplex(0., 0.);
-    sumAmplFV0A = 0;
-    if (coll.has_foundFV0() && useDetector["QvectorFV0As"]) {
+    const bool hasFV0 = coll.has_foundFV0() && useFV0A;
+    if (hasFV0) {
       auto fv0 = coll.foundFV0();
 
       for (std::size_t iCh = 0; iCh < fv0.channel().size(); iCh++) {
         float ampl = fv0.amplitude()[iCh];
         int FV0AchId = fv0.channel()[iCh];
-        histosQA.fill(HIST("FV0Amp"), ampl, FV0AchId);
-        histosQA.fill(HIST("FV0AmpCor"), ampl / FV0RelGainConst[FV0AchId], FV0AchId);
+        float amplCor = ampl / FV0RelGainConst[FV0AchId];
 
-        helperEP.SumQvectors(1, FV0AchId, ampl / FV0RelGainConst[FV0AchId], nmode, QvecDet, sumAmplFV0A, ft0geom, fv0geom);
-      }
+        for (std::size_t id = 0; id < nMods; id++) {
+          histosQA.fill(HIST("FV0Amp"), ampl, FV0AchId);
+          histosQA.fill(HIST("FV0AmpCor"), amplCor, FV0AchId);
 
-      if (sumAmplFV0A > 1e-8) {
-        QvecDet /= sumAmplFV0A;
-        qVectFV0A[0] = QvecDet.Re();
-        qVectFV0A[1] = QvecDet.Im();
-      } else {
-        qVectFV0A[0] = 999.;
-        qVectFV0A[1] = 999.;
+          QvecFV0A[id] += TComplex(amplCor * FV0CosPhi[id][FV0AchId], amplCor * FV0SinPhi[id][FV0AchId]);
+        }
+        sumAmplFV0A += amplCor;
       }
-    } else {
-      qVectFV0A[0] = -999.;
-      qVectFV0A[1] = -999.;
     }
 
     int nTrkTPCpos = 0;
@@ -465,92 +532,161 @@ struct qVectorsTable {
       if (!SelTrack(trk)) {
         continue;
       }
-      histosQA.fill(HIST("ChTracks"), trk.pt(), trk.eta(), trk.phi(), cent);
+      for (std::size_t id = 0; id < nMods; id++) {
+        histosQA.fill(HIST("ChTracks"), trk.pt(), trk.eta(), trk.phi(), cent);
+      }
       if (trk.eta() > cfgEtaMax) {
         continue;
       }
       if (trk.eta() < cfgEtaMin) {
         continue;
       }
-      qVectTPCall[0] += trk.pt() * std::cos(trk.phi() * nmode);
-      qVectTPCall[1] += trk.pt() * std::sin(trk.phi() * nmode);
+      for (std::size_t id = 0; id < nMods; id++) {
+        int nmode = cfgnMods->at(id);
+        qVectTPCallSum[2 * id] += trk.pt() * std::cos(trk.phi() * nmode);
+        qVectTPCallSum[2 * id + 1] += trk.pt() * std::sin(trk.phi() * nmode);
+      }
       TrkTPCallLabel.push_back(trk.globalIndex());
       nTrkTPCall++;
       if (std::abs(trk.eta()) < 0.1) {
         continue;
       }
-      if (trk.eta() > 0 && (useDetector["QvectorTPCposs"] || useDetector["QvectorBPoss"])) {
-        qVectTPCpos[0] += trk.pt() * std::cos(trk.phi() * nmode);
-        qVectTPCpos[1] += trk.pt() * std::sin(trk.phi() * nmode);
+      if (trk.eta() > 0 && (useTPCpos || useBPos)) {
+        for (std::size_t id = 0; id < nMods; id++) {
+          int nmode = cfgnMods->at(id);
+          qVectTPCposSum[2 * id] += trk.pt() * std::cos(trk.phi() * nmode);
+          qVectTPCposSum[2 * id + 1] += trk.pt() * std::sin(trk.phi() * nmode);
+        }
         TrkTPCposLabel.push_back(trk.globalIndex());
         nTrkTPCpos++;
-      } else if (trk.eta() < 0 && (useDetector["QvectorTPCnegs"] || useDetector["QvectorBNegs"])) {
-        qVectTPCneg[0] += trk.pt() * std::cos(trk.phi() * nmode);
-        qVectTPCneg[1] += trk.pt() * std::sin(trk.phi() * nmode);
+      } else if (trk.eta() < 0 && (useTPCneg || useBNeg)) {
+        for (std::size_t id = 0; id < nMods; id++) {
+          int nmode = cfgnMods->at(id);
+          qVectTPCnegSum[2 * id] += trk.pt() * std::cos(trk.phi() * nmode);
+          qVectTPCnegSum[2 * id + 1] += trk.pt() * std::sin(trk.phi() * nmode);
+        }
         TrkTPCnegLabel.push_back(trk.globalIndex());
         nTrkTPCneg++;
       }
     }
-    if (nTrkTPCpos > 0) {
-      qVectTPCpos[0] /= nTrkTPCpos;
-      qVectTPCpos[1] /= nTrkTPCpos;
-    } else {
-      qVectTPCpos[0] = 999.;
-      qVectTPCpos[1] = 999.;
-    }
 
-    if (nTrkTPCneg > 0) {
-      qVectTPCneg[0] /= nTrkTPCneg;
-      qVectTPCneg[1] /= nTrkTPCneg;
-    } else {
-      qVectTPCneg[0] = 999.;
-      qVectTPCneg[1] = 999.;
+    for (auto* labels : {&TrkTPCposLabel, &TrkTPCnegLabel, &TrkTPCallLabel}) {
+      const std::size_t nLabels = labels->size();
+      labels->reserve(nLabels * nMods);
+      for (std::size_t id = 1; id < nMods; id++) {
+        for (std::size_t i = 0; i < nLabels; i++) {
+          labels->push_back((*labels)[i]);
+        }
+      }
     }
 
-    if (nTrkTPCall > 0) {
-      qVectTPCall[0] /= nTrkTPCall;
-      qVectTPCall[1] /= nTrkTPCall;
-    } else {
-      qVectTPCall[0] = 999.;
-      qVectTPCall[1] = 999.;
-    }
+    for (std::size_t id = 0; id < nMods; id++) {
+      float qVectFT0A[2] = {0.};
+      float qVectFT0C[2] = {0.};
+      float qVectFT0M[2] = {0.};
+      float qVectFV0A[2] = {0.};
+      float qVectTPCpos[2] = {qVectTPCposSum[2 * id], qVectTPCposSum[2 * id + 1]};
+      float qVectTPCneg[2] = {qVectTPCnegSum[2 * id], qVectTPCnegSum[2 * id + 1]};
+      float qVectTPCall[2] = {qVectTPCallSum[2 * id], qVectTPCallSum[2 * id + 1]};
+
+      if (hasFT0) {
+        if (useFT0A) {
+          if (sumAmplFT0A > 1e-8) {
+            QvecFT0A[id] /= sumAmplFT0A;
+            qVectFT0A[0] = QvecFT0A[id].Re();
+            qVectFT0A[1] = QvecFT0A[id].Im();
+          }
+        } else {
+          qVectFT0A[0] = 999.;
+          qVectFT0A[1] = 999.;
+        }
 
-    for (auto i{0u}; i < 4; i++) {
-      QvecRe.push_back(qVectFT0C[0]);
-      QvecIm.push_back(qVectFT0C[1]);
-    }
-    for (auto i{0u}; i < 4; i++) {
-      QvecRe.push_back(qVectFT0A[0]);
-      QvecIm.push_back(qVectFT0A[1]);
-    }
-    for (auto i{0u}; i < 4; i++) {
-      QvecRe.push_back(qVectFT0M[0]);
-      QvecIm.push_back(qVectFT0M[1]);
-    }
-    for (auto i{0u}; i < 4; i++) {
-      QvecRe.push_back(qVectFV0A[0]);
-      QvecIm.push_back(qVectFV0A[1]);
-    }
-    for (auto i{0u}; i < 4; i++) {
-      QvecRe.push_back(qVectTPCpos[0]);
-      QvecIm.push_back(qVectTPCpos[1]);
-    }
-    for (auto i{0u}; i < 4; i++) {
-      QvecRe.push_back(qVectTPCneg[0]);
-      QvecIm.push_back(qVectTPCneg[1]);
-    }
-    for (auto i{0u}; i < 4; i++) {
-      QvecRe.push_back(qVectTPCall[0]);
-      QvecIm.push_back(qVectTPCall[1]);
-    }
+        if (useFT0C) {
+          if (sumAmplFT0C > 1e-8) {
+            QvecFT0C[id] /= sumAmplFT0C;
+            qVectFT0C[0] = QvecFT0C[id].Re();
+            qVectFT0C[1] = QvecFT0C[id].Im();
+          } else {
+            qVectFT0C[0] = 999.;
+            qVectFT0C[1] = 999.;
+          }
+        } else {
+          qVectFT0C[0] = -999.;
+          qVectFT0C[1] = -999.;
+        }
+
+        if (sumAmplFT0M > 1e-8 && useFT0M) {
+          QvecFT0M[id] /= sumAmplFT0M;
+          qVectFT0M[0] = QvecFT0M[id].Re();
+          qVectFT0M[1] = QvecFT0M[id].Im();
+        } else {
+          qVectFT0M[0] = 999.;
+          qVectFT0M[1] = 999.;
+        }
+      } else {
+        qVectFT0A[0] = -999.;
+        qVectFT0A[1] = -999.;
+        qVectFT0C[0] = -999.;
+        qVectFT0C[1] = -999.;
+        qVectFT0M[0] = -999.;
+        qVectFT0M[1] = -999.;
+      }
+
+      if (hasFV0) {
+        if (sumAmplFV0A > 1e-8) {
+          QvecFV0A[id] /= sumAmplFV0A;
+          qVectFV0A[0] = QvecFV0A[id].Re();
+          qVectFV0A[1] = QvecFV0A[id].Im();
+        } else {
+          qVectFV0A[0] = 999.;
+          qVectFV0A[1] = 999.;
+        }
+      } else {
+        qVectFV0A[0] = -999.;
+        qVectFV0A[1] = -999.;
+      }
+
+      if (nTrkTPCpos > 0) {
+        qVectTPCpos[0] /= nTrkTPCpos;
+        qVectTPCpos[1] /= nTrkTPCpos;
+      } else {
+        qVectTPCpos[0] = 999.;
+        qVectTPCpos[1] = 999.;
+      }
 
-    QvecAmp.push_back(sumAmplFT0C);
-    QvecAmp.push_back(sumAmplFT0A);
-    QvecAmp.push_back(sumAmplFT0M);
-    QvecAmp.push_back(sumAmplFV0A);
-    QvecAmp.push_back(static_cast<float>(nTrkTPCpos));
-    QvecAmp.push_back(static_cast<float>(nTrkTPCneg));
-    QvecAmp.push_back(static_cast<float>(nTrkTPCall));
+      if (nTrkTPCneg > 0) {
+        qVectTPCneg[0] /= nTrkTPCneg;
+        qVectTPCneg[1] /= nTrkTPCneg;
+      } else {
+        qVectTPCneg[0] = 999.;
+        qVectTPCneg[1] = 999.;
+      }
+
+      if (nTrkTPCall > 0) {
+        qVectTPCall[0] /= nTrkTPCall;
+        qVectTPCall[1] /= nTrkTPCall;
+      } else {
+        qVectTPCall[0] = 999.;
+        qVectTPCall[1] = 999.;
+      }
+
+      // Same value for the four correction steps, which are applied in process().
+      const float* qVects[kTPCall + 1] = {qVectFT0C, qVectFT0A, qVectFT0M, qVectFV0A, qVectTPCpos, qVectTPCneg, qVectTPCall};
+      for (const auto* qVect : qVects) {
+        for (auto i{0u}; i < 4; i++) {
+          QvecRe.push_back(qVect[0]);
+          QvecIm.push_back(qVect[1]);
+        }
+      }
+
+      QvecAmp.push_back(sumAmplFT0C);
+      QvecAmp.push_back(sumAmplFT0A);
+      QvecAmp.push_back(sumAmplFT0M);
+      QvecAmp.push_back(sumAmplFV0A);
+      QvecAmp.push_back(static_cast<float>(nTrkTPCpos));
+      QvecAmp.push_back(static_cast<float>(nTrkTPCneg));
+      QvecAmp.push_back(static_cast<float>(nTrkTPCall));
+    }
   }
 
   void process(MyCollisions::iterator const& coll, aod::BCsWithTimestamps const&, aod::FT0s const&, aod::FV0As const&, MyTracks const& tracks)
@@ -593,105 +729,42 @@ struct qVectorsTable {
       cent = 110.;
       IsCalibrated = false;
     }
+    CalQvec(coll, tracks, qvecRe, qvecIm, qvecAmp, TrkTPCposLabel, TrkTPCnegLabel, TrkTPCallLabel);
     for (std::size_t id = 0; id < cfgnMods->size(); id++) {
       int nmode = cfgnMods->at(id);
-      CalQvec(nmode, coll, tracks, qvecRe, qvecIm, qvecAmp, TrkTPCposLabel, TrkTPCnegLabel, TrkTPCallLabel);
+      const int offset = (kTPCall + 1) * 4 * id;
       if (cent < cfgMaxCentrality) {
+        const auto& corr = qvecCorrections[id];
+        const int centBin = std::min(static_cast<int>(cent) + 1, corr.nCentBins - 1);
         for (auto i{0u}; i < kTPCall + 1; i++) {
-          helperEP.DoRecenter(qvecRe[(kTPCall + 1) * 4 * id + i * 4 + 1], qvecIm[(kTPCall + 1) * 4 * id + i * 4 + 1],
-                              objQvec.at(id)->GetBinContent(static_cast<int>(cent) + 1, 1, i + 1), objQvec.at(id)->GetBinContent(static_cast<int>(cent) + 1, 2, i + 1));
-
-          helperEP.DoRecenter(qvecRe[(kTPCall + 1) * 4 * id + i * 4 + 2], qvecIm[(kTPCall + 1) * 4 * id + i * 4 + 2],
-                              objQvec.at(id)->GetBinContent(static_cast<int>(cent) + 1, 1, i + 1), objQvec.at(id)->GetBinContent(static_cast<int>(cent) + 1, 2, i + 1));
-          helperEP.DoTwist(qvecRe[(kTPCall + 1) * 4 * id + i * 4 + 2], qvecIm[(kTPCall + 1) * 4 * id + i * 4 + 2],
-                           objQvec.at(id)->GetBinContent(static_cast<int>(cent) + 1, 3, i + 1), objQvec.at(id)->GetBinContent(static_cast<int>(cent) + 1, 4, i + 1));
-
-          helperEP.DoRecenter(qvecRe[(kTPCall + 1) * 4 * id + i * 4 + 3], qvecIm[(kTPCall + 1) * 4 * id + i * 4 + 3],
-                              objQvec.at(id)->GetBinContent(static_cast<int>(cent) + 1, 1, i + 1), objQvec.at(id)->GetBinContent(static_cast<int>(cent) + 1, 2, i + 1));
-          helperEP.DoTwist(qvecRe[(kTPCall + 1) * 4 * id + i * 4 + 3], qvecIm[(kTPCall + 1) * 4 * id + i * 4 + 3],
-                           objQvec.at(id)->GetBinContent(static_cast<int>(cent) + 1, 3, i + 1), objQvec.at(id)->GetBinContent(static_cast<int>(cent) + 1, 4, i + 1));
-          helperEP.DoRescale(qvecRe[(kTPCall + 1) * 4 * id + i * 4 + 3], qvecIm[(kTPCall + 1) * 4 * id + i * 4 + 3],
-                             objQvec.at(id)->GetBinContent(static_cast<int>(cent) + 1, 5, i + 1), objQvec.at(id)->GetBinContent(static_cast<int>(cent) + 1, 6, i + 1));
+          const float* constants = corr.get(centBin, i);
+          helperEP.DoRecenter(qvecRe[offset + i * 4 + 1], qvecIm[offset + i * 4 + 1], constants[0], constants[1]);
+
+          helperEP.DoRecenter(qvecRe[offset + i * 4 + 2], qvecIm[offset + i * 4 + 2], constants[0], constants[1]);
+          helperEP.DoTwist(qvecRe[offset + i * 4 + 2], qvecIm[offset + i * 4 + 2], constants[2], constants[3]);
+
+          helperEP.DoRecenter(qvecRe[offset + i * 4 + 3], qvecIm[offset + i * 4 + 3], constants[0], constants[1]);
+          helperEP.DoTwist(qvecRe[offset + i * 4 + 3], qvecIm[offset + i * 4 + 3], constants[2], constants[3]);
+          helperEP.DoRescale(qvecRe[offset + i * 4 + 3], qvecIm[offset + i * 4 + 3], constants[4], constants[5]);
         }
         if (cfgShiftCorr) {
-          auto deltapsiFT0C = 0.0;
-          auto deltapsiFT0A = 0.0;
-          auto deltapsiFT0M = 0.0;
-          auto deltapsiFV0A = 0.0;
-          auto deltapsiTPCpos = 0.0;
-          auto deltapsiTPCneg = 0.0;
-          auto deltapsiTPCall = 0.0;
-
-          auto psidefFT0C = TMath::ATan2(qvecIm[(kTPCall + 1) * 4 * id + kFT0C * 4 + 3], qvecRe[(kTPCall + 1) * 4 * id + kFT0C * 4 + 3]) / static_cast<float>(nmode);
-          auto psidefFT0A = TMath::ATan2(qvecIm[(kTPCall + 1) * 4 * id + kFT0A * 4 + 3], qvecRe[(kTPCall + 1) * 4 * id + kFT0A * 4 + 3]) / static_cast<float>(nmode);
-          auto psidefFT0M = TMath::ATan2(qvecIm[(kTPCall + 1) * 4 * id + kFT0M * 4 + 3], qvecRe[(kTPCall + 1) * 4 * id + kFT0M * 4 + 3]) / static_cast<float>(nmode);
-          auto psidefFV0A = TMath::ATan2(qvecIm[(kTPCall + 1) * 4 * id + kFV0A * 4 + 3], qvecRe[(kTPCall + 1) * 4 * id + kFV0A * 4 + 3]) / static_cast<float>(nmode);
-          auto psidefTPCpos = TMath::ATan2(qvecIm[(kTPCall + 1) * 4 * id + kTPCpos * 4 + 3], qvecRe[(kTPCall + 1) * 4 * id + kTPCpos * 4 + 3]) / static_cast<float>(nmode);
-          auto psidefTPCneg = TMath::ATan2(qvecIm[(kTPCall + 1) * 4 * id + kTPCneg * 4 + 3], qvecRe[(kTPCall + 1) * 4 * id + kTPCneg * 4 + 3]) / static_cast<float>(nmode);
-          auto psidefTPCall = TMath::ATan2(qvecIm[(kTPCall + 1) * 4 * id + kTPCall * 4 + 3], qvecRe[(kTPCall + 1) * 4 * id + kTPCall * 4 + 3]) / static_cast<float>(nmode);
-
-          for (int ishift = 1; ishift <= 10; ishift++) {
-            auto coeffshiftxFT0C = shiftprofile.at(nmode - 2)->GetBinContent(shiftprofile.at(nmode - 2)->FindBin(cent, 2 * kFT0C, ishift - 0.5));
-            auto coeffshiftyFT0C = shiftprofile.at(nmode - 2)->GetBinContent(shiftprofile.at(nmode - 2)->FindBin(cent, 2 * kFT0C + 1, ishift - 0.5));
-            auto coeffshiftxFT0A = shiftprofile.at(nmode - 2)->GetBinContent(shiftprofile.at(nmode - 2)->FindBin(cent, 2 * kFT0A, ishift - 0.5));
-            auto coeffshiftyFT0A = shiftprofile.at(nmode - 2)->GetBinContent(shiftprofile.at(nmode - 2)->FindBin(cent, 2 * kFT0A + 1, ishift - 0.5));
-            auto coeffshiftxFT0M = shiftprofile.at(nmode - 2)->GetBinContent(shiftprofile.at(nmode - 2)->FindBin(cent, 2 * kFT0M, ishift - 0.5));
-            auto coeffshiftyFT0M = shiftprofile.at(nmode - 2)->GetBinContent(shiftprofile.at(nmode - 2)->FindBin(cent, 2 * kFT0M + 1, ishift - 0.5));
-            auto coeffshiftxFV0A = shiftprofile.at(nmode - 2)->GetBinContent(shiftprofile.at(nmode - 2)->FindBin(cent, 2 * kFV0A, ishift - 0.5));
-            auto coeffshiftyFV0A = shiftprofile.at(nmode - 2)->GetBinContent(shiftprofile.at(nmode - 2)->FindBin(cent, 2 * kFV0A + 1, ishift - 0.5));
-            auto coeffshiftxTPCpos = shiftprofile.at(nmode - 2)->GetBinContent(shiftprofile.at(nmode - 2)->FindBin(cent, 2 * kTPCpos, ishift - 0.5));
-            auto coeffshiftyTPCpos = shiftprofile.at(nmode - 2)->GetBinContent(shiftprofile.at(nmode - 2)->FindBin(cent, 2 * kTPCpos + 1, ishift - 0.5));
-            auto coeffshiftxTPCneg = shiftprofile.at(nmode - 2)->GetBinContent(shiftprofile.at(nmode - 2)->FindBin(cent, 2 * kTPCneg, ishift - 0.5));
-            auto coeffshiftyTPCneg = shiftprofile.at(nmode - 2)->GetBinContent(shiftprofile.at(nmode - 2)->FindBin(cent, 2 * kTPCneg + 1, ishift - 0.5));
-            auto coeffshiftxTPCall = shiftprofile.at(nmode - 2)->GetBinContent(shiftprofile.at(nmode - 2)->FindBin(cent, 2 * kTPCall, ishift - 0.5));
-            auto coeffshiftyTPCall = shiftprofile.at(nmode - 2)->GetBinContent(shiftprofile.at(nmode - 2)->FindBin(cent, 2 * kTPCall + 1, ishift - 0.5));
-
-            deltapsiFT0C += ((2. / (1.0 * ishift)) * (-coeffshiftxFT0C * TMath::Cos(ishift * static_cast<float>(nmode) * psidefFT0C) + coeffshiftyFT0C * TMath::Sin(ishift * static_cast<float>(nmode) * psidefFT0C))) / static_cast<float>(nmode);
-            deltapsiFT0A += ((2. / (1.0 * ishift)) * (-coeffshiftxFT0A * TMath::Cos(ishift * static_cast<float>(nmode) * psidefFT0A) + coeffshiftyFT0A * TMath::Sin(ishift * static_cast<float>(nmode) * psidefFT0A))) / static_cast<float>(nmode);
-            deltapsiFT0M += ((2. / (1.0 * ishift)) * (-coeffshiftxFT0M * TMath::Cos(ishift * static_cast<float>(nmode) * psidefFT0M) + coeffshiftyFT0M * TMath::Sin(ishift * static_cast<float>(nmode) * psidefFT0M))) / static_cast<float>(nmode);
-            deltapsiFV0A += ((2. / (1.0 * ishift)) * (-coeffshiftxFV0A * TMath::Cos(ishift * static_cast<float>(nmode) * psidefFV0A) + coeffshiftyFV0A * TMath::Sin(ishift * static_cast<float>(nmode) * psidefFV0A))) / static_cast<float>(nmode);
-            deltapsiTPCpos += ((2. / (1.0 * ishift)) * (-coeffshiftxTPCpos * TMath::Cos(ishift * static_cast<float>(nmode) * psidefTPCpos) + coeffshiftyTPCpos * TMath::Sin(ishift * static_cast<float>(nmode) * psidefTPCpos))) / static_cast<float>(nmode);
-            deltapsiTPCneg += ((2. / (1.0 * ishift)) * (-coeffshiftxTPCneg * TMath::Cos(ishift * static_cast<float>(nmode) * psidefTPCneg) + coeffshiftyTPCneg * TMath::Sin(ishift * static_cast<float>(nmode) * psidefTPCneg))) / static_cast<float>(nmode);
-            deltapsiTPCall += ((2. / (1.0 * ishift)) * (-coeffshiftxTPCall * TMath::Cos(ishift * static_cast<float>(nmode) * psidefTPCall) + coeffshiftyTPCall * TMath::Sin(ishift * static_cast<float>(nmode) * psidefTPCall))) / static_cast<float>(nmode);
+          const auto& shift = shiftCorrections.at(nmode - 2);
+          const int centBin = shift.profile->GetXaxis()->FindBin(cent);
+          for (auto i{0u}; i < kTPCall + 1; i++) {
+            auto deltapsi = 0.0;
+            auto psidef = TMath::ATan2(qvecIm[offset + i * 4 + 3], qvecRe[offset + i * 4 + 3]) / static_cast<float>(nmode);
+            for (int ishift = 1; ishift <= NShifts; ishift++) {
+              auto coeffshiftx = shift.get(centBin, 2 * i, ishift);
+              auto coeffshifty = shift.get(centBin, 2 * i + 1, ishift);
+              deltapsi += ((2. / (1.0 * ishift)) * (-coeffshiftx * TMath::Cos(ishift * static_cast<float>(nmode) * psidef) + coeffshifty * TMath::Sin(ishift * static_cast<float>(nmode) * psidef))) / static_cast<float>(nmode);
+            }
+            deltapsi *= static_cast<float>(nmode);
+
+            float qvecReShifted = qvecRe[offset + i * 4 + 3] * TMath::Cos(deltapsi) - qvecIm[offset + i * 4 + 3] * TMath::Sin(deltapsi);
+            float qvecImShifted = qvecRe[offset + i * 4 + 3] * TMath::Sin(deltapsi) + qvecIm[offset + i * 4 + 3] * TMath::Cos(deltapsi);
+            qvecRe[offset + i * 4 + 3] = qvecReShifted;
+            qvecIm[offset + i * 4 + 3] = qvecImShifted;
           }
-
-          deltapsiFT0C *= static_cast<float>(nmode);
-          deltapsiFT0A *= static_cast<float>(nmode);
-          deltapsiFT0M *= static_cast<float>(nmode);
-          deltapsiFV0A *= static_cast<float>(nmode);
-          deltapsiTPCpos *= static_cast<float>(nmode);
-          deltapsiTPCneg *= static_cast<float>(nmode);
-          deltapsiTPCall *= static_cast<float>(nmode);
-
-          float qvecReShiftedFT0C = qvecRe[(kTPCall + 1) * 4 * id + kFT0C * 4 + 3] * TMath::Cos(deltapsiFT0C) - qvecIm[(kTPCall + 1) * 4 * id + kFT0C * 4 + 3] * TMath::Sin(deltapsiFT0C);
-          float qvecImShiftedFT0C = qvecRe[(kTPCall + 1) * 4 * id + kFT0C * 4 + 3] * TMath::Sin(deltapsiFT0C) + qvecIm[(kTPCall + 1) * 4 * id + kFT0C * 4 + 3] * TMath::Cos(deltapsiFT0C);
-          float qvecReShiftedFT0A = qvecRe[(kTPCall + 1) * 4 * id + kFT0A * 4 + 3] * TMath::Cos(deltapsiFT0A) - qvecIm[(kTPCall + 1) * 4 * id + kFT0A * 4 + 3] * TMath::Sin(deltapsiFT0A);
-          float qvecImShiftedFT0A = qvecRe[(kTPCall + 1) * 4 * id + kFT0A * 4 + 3] * TMath::Sin(deltapsiFT0A) + qvecIm[(kTPCall + 1) * 4 * id + kFT0A * 4 + 3] * TMath::Cos(deltapsiFT0A);
-          float qvecReShiftedFT0M = qvecRe[(kTPCall + 1) * 4 * id + kFT0M * 4 + 3] * TMath::Cos(deltapsiFT0M) - qvecIm[(kTPCall + 1) * 4 * id + kFT0M * 4 + 3] * TMath::Sin(deltapsiFT0M);
-          float qvecImShiftedFT0M = qvecRe[(kTPCall + 1) * 4 * id + kFT0M * 4 + 3] * TMath::Sin(deltapsiFT0M) + qvecIm[(kTPCall + 1) * 4 * id + kFT0M * 4 + 3] * TMath::Cos(deltapsiFT0M);
-          float qvecReShiftedFV0A = qvecRe[(kTPCall + 1) * 4 * id + kFV0A * 4 + 3] * TMath::Cos(deltapsiFV0A) - qvecIm[(kTPCall + 1) * 4 * id + kFV0A * 4 + 3] * TMath::Sin(deltapsiFV0A);
-          float qvecImShiftedFV0A = qvecRe[(kTPCall + 1) * 4 * id + kFV0A * 4 + 3] * TMath::Sin(deltapsiFV0A) + qvecIm[(kTPCall + 1) * 4 * id + kFV0A * 4 + 3] * TMath::Cos(deltapsiFV0A);
-          float qvecReShiftedTPCpos = qvecRe[(kTPCall + 1) * 4 * id + kTPCpos * 4 + 3] * TMath::Cos(deltapsiTPCpos) - qvecIm[(kTPCall + 1) * 4 * id + kTPCpos * 4 + 3] * TMath::Sin(deltapsiTPCpos);
-          float qvecImShiftedTPCpos = qvecRe[(kTPCall + 1) * 4 * id + kTPCpos * 4 + 3] * TMath::Sin(deltapsiTPCpos) + qvecIm[(kTPCall + 1) * 4 * id + kTPCpos * 4 + 3] * TMath::Cos(deltapsiTPCpos);
-          float qvecReShiftedTPCneg = qvecRe[(kTPCall + 1) * 4 * id + kTPCneg * 4 + 3] * TMath::Cos(deltapsiTPCneg) - qvecIm[(kTPCall + 1) * 4 * id + kTPCneg * 4 + 3] * TMath::Sin(deltapsiTPCneg);
-          float qvecImShiftedTPCneg = qvecRe[(kTPCall + 1) * 4 * id + kTPCneg * 4 + 3] * TMath::Sin(deltapsiTPCneg) + qvecIm[(kTPCall + 1) * 4 * id + kTPCneg * 4 + 3] * TMath::Cos(deltapsiTPCneg);
-          float qvecReShiftedTPCall = qvecRe[(kTPCall + 1) * 4 * id + kTPCall * 4 + 3] * TMath::Cos(deltapsiTPCall) - qvecIm[(kTPCall + 1) * 4 * id + kTPCall * 4 + 3] * TMath::Sin(deltapsiTPCall);
-          float qvecImShiftedTPCall = qvecRe[(kTPCall + 1) * 4 * id + kTPCall * 4 + 3] * TMath::Sin(deltapsiTPCall) + qvecIm[(kTPCall + 1) * 4 * id + kTPCall * 4 + 3] * TMath::Cos(deltapsiTPCall);
-
-          qvecRe[(kTPCall + 1) * 4 * id + kFT0C * 4 + 3] = qvecReShiftedFT0C;
-          qvecIm[(kTPCall + 1) * 4 * id + kFT0C * 4 + 3] = qvecImShiftedFT0C;
-          qvecRe[(kTPCall + 1) * 4 * id + kFT0A * 4 + 3] = qvecReShiftedFT0A;
-          qvecIm[(kTPCall + 1) * 4 * id + kFT0A * 4 + 3] = qvecImShiftedFT0A;
-          qvecRe[(kTPCall + 1) * 4 * id + kFT0M * 4 + 3] = qvecReShiftedFT0M;
-          qvecIm[(kTPCall + 1) * 4 * id + kFT0M * 4 + 3] = qvecImShiftedFT0M;
-          qvecRe[(kTPCall + 1) * 4 * id + kFV0A * 4 + 3] = qvecReShiftedFV0A;
-          qvecIm[(kTPCall + 1) * 4 * id + kFV0A * 4 + 3] = qvecImShiftedFV0A;
-          qvecRe[(kTPCall + 1) * 4 * id + kTPCpos * 4 + 3] = qvecReShiftedTPCpos;
-          qvecIm[(kTPCall + 1) * 4 * id + kTPCpos * 4 + 3] = qvecImShiftedTPCpos;
-          qvecRe[(kTPCall + 1) * 4 * id + kTPCneg * 4 + 3] = qvecReShiftedTPCneg;
-          qvecIm[(kTPCall + 1) * 4 * id + kTPCneg * 4 + 3] = qvecImShiftedTPCneg;
-          qvecRe[(kTPCall + 1) * 4 * id + kTPCall * 4 + 3] = qvecReShiftedTPCall;
-          qvecIm[(kTPCall + 1) * 4 * id + kTPCall * 4 + 3] = qvecImShiftedTPCall;
         }
       }
       int CorrLevel = cfgCorrLevel == 0 ? 0 : cfgCorrLevel - 1;
@@ -713,19 +786,19 @@ struct qVectorsTable {
 
     // Fill the columns of the Qvectors table.
     qVector(cent, IsCalibrated, qvecRe, qvecIm, qvecAmp);
-    if (useDetector["QvectorFT0Cs"])
+    if (useFT0C)
       qVectorFT0C(IsCalibrated, qvecReFT0C.at(0), qvecImFT0C.at(0), qvecAmp[kFT0C]);
-    if (useDetector["QvectorFT0As"])
+    if (useFT0A)
       qVectorFT0A(IsCalibrated, qvecReFT0A.at(0), qvecImFT0A.at(0), qvecAmp[kFT0A]);
-    if (useDetector["QvectorFT0Ms"])
+    if (useFT0M)
       qVectorFT0M(IsCalibrated, qvecReFT0M.at(0), qvecImFT0M.at(0), qvecAmp[kFT0M]);
-    if (useDetector["QvectorFV0As"])
+    if (useFV0A)
       qVectorFV0A(IsCalibrated, qvecReFV0A.at(0), qvecImFV0A.at(0), qvecAmp[kFV0A]);
-    if (useDetector["QvectorTPCposs"])
+    if (useTPCpos)
       qVectorTPCpos(IsCalibrated, qvecReTPCpos.at(0), qvecImTPCpos.at(0), qvecAmp[kTPCpos], TrkTPCposLabel);
-    if (useDetector["QvectorTPCnegs"])
+    if (useTPCneg)
       qVectorTPCneg(IsCalibrated, qvecReTPCneg.at(0), qvecImTPCneg.at(0), qvecAmp[kTPCneg], TrkTPCnegLabel);
-    if (useDetector["QvectorTPCalls"])
+    if (useTPCall)
       qVectorTPCall(IsCalibrated, qvecReTPCall.at(0), qvecImTPCall.at(0), qvecAmp[kTPCall], TrkTPCallLabel);
 
     qVectorFT0CVec(IsCalibrated, qvecReFT0C, qvecImFT0C, qvecAmp[kFT0C]);
@@ -737,11 +810,11 @@ struct qVectorsTable {
     qVectorTPCallVec(IsCalibrated, qvecReTPCall, qvecImTPCall, qvecAmp[kTPCall], TrkTPCallLabel);
 
     // Deprecated, will be removed in future after transition time //
-    if (useDetector["QvectorBPoss"])
+    if (useBPos)
       qVectorBPos(IsCalibrated, qvecReTPCpos.at(0), qvecImTPCpos.at(0), qvecAmp[kTPCpos], TrkTPCposLabel);
-    if (useDetector["QvectorBNegs"])
+    if (useBNeg)
       qVectorBNeg(IsCalibrated, qvecReTPCneg.at(0), qvecImTPCneg.at(0), qvecAmp[kTPCneg], TrkTPCnegLabel);
-    if (useDetector["QvectorBTots"])
+    if (useBTot)
       qVectorBTot(IsCalibrated, qvecReTPCall.at(0), qvecImTPCall.at(0), qvecAmp[kTPCall], TrkTPCallLabel);
 
     qVectorBPosVec(IsCalibrated, qvecReTPCpos, qvecImTPCpos, qvecAmp[kTPCpos], TrkTPCposLabel);
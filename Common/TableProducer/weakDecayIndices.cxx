@@ -13,22 +13,44 @@
 #include <Framework/AnalysisTask.h>
 #include <Framework/runDataProcessing.h>
 
+#include <vector>
+
 using namespace o2;
 using namespace o2::framework;
 
 // Converts V0 and cascade version 000 to 001
 // Build indices to group V0s and cascades to collisions
+// The collision of each track is read once into a dense array, the daughters are then looked up by index without dereferencing the tracks
+
+namespace
+{
+template <typename TTracks>
+void fillTrackCollisionIds(TTracks const& tracks, std::vector<int>& trackCollisionIds)
+{
+  trackCollisionIds.resize(tracks.size());
+  size_t iTrack = 0;
+  for (const auto& track : tracks) {
+    trackCollisionIds[iTrack++] = track.collisionId();
+  }
+}
+} // namespace
 
 struct WeakDecayIndicesV0 {
   Produces<aod::V0s_001> v0s_001;
 
-  void process(aod::V0s_000 const& v0s, aod::Tracks const&)
+  std::vector<int> trackCollisionIds;
+
+  void process(aod::V0s_000 const& v0s, aod::Tracks const& tracks)
   {
-    for (auto& v0 : v0s) {
-      if (v0.posTrack().collisionId() != v0.negTrack().collisionId()) {
-        LOGF(fatal, "V0 %d has inconsistent collision information (%d, %d)", v0.globalIndex(), v0.posTrack().collisionId(), v0.negTrack().collisionId());
+    fillTrackCollisionIds(tracks, trackCollisionIds);
+    v0s_001.reserve(v0s.size());
+    for (const auto& v0 : v0s) {
+      const int posCollisionId = trackCollisionIds[v0.posTrackId()];
+      const int negCollisionId = trackCollisionIds[v0.negTrackId()];
+      if (posCollisionId != negCollisionId) {
+        LOGF(fatal, "V0 %d has inconsistent collision information (%d, %d)", v0.globalIndex(), posCollisionId, negCollisionId);
       }
-      v0s_001(v0.posTrack().collisionId(), v0.posTrackId(), v0.negTrackId());
+      v0s_001(posCollisionId, v0.posTrackId(), v0.negTrackId());
     }
   }
 };
@@ -37,14 +59,30 @@ struct WeakDecayIndicesV0 {
 struct WeakDecayIndicesCascades {
   Produces<aod::Cascades_001> cascades_001;
 
-  void process(aod::V0s const&, aod::Cascades_000 const& cascades, aod::Tracks const&)
+  std::vector<int> trackCollisionIds;
+  std::vector<int> v0PosTrackIds;
+  std::vector<int> v0NegTrackIds;
+
+  void process(aod::V0s const& v0s, aod::Cascades_000 const& cascades, aod::Tracks const& tracks)
   {
-    for (auto& cascade : cascades) {
-      if (cascade.bachelor().collisionId() != cascade.v0().posTrack().collisionId() || cascade.v0().posTrack().collisionId() != cascade.v0().negTrack().collisionId()) {
-        LOGF(fatal, "Cascade %d has inconsistent collision information (%d, %d, %d) track ids %d %d %d", cascade.globalIndex(), cascade.bachelor().collisionId(),
-             cascade.v0().posTrack().collisionId(), cascade.v0().negTrack().collisionId(), cascade.bachelorId(), cascade.v0().posTrackId(), cascade.v0().negTrackId());
+    fillTrackCollisionIds(tracks, trackCollisionIds);
+    v0PosTrackIds.resize(v0s.size());
+    v0NegTrackIds.resize(v0s.size());
+    size_t iV0 = 0;
+    for (const auto& v0 : v0s) {
+      v0PosTrackIds[iV0] = v0.posTrackId();
+      v0NegTrackIds[iV0++] = v0.negTrackId();
+    }
+    cascades_001.reserve(cascades.size());
+    for (const auto& cascade : cascades) {
+      const int bachelorCollisionId = trackCollisionIds[cascade.bachelorId()];
+      const int posCollisionId = trackCollisionIds[v0PosTrackIds[cascade.v0Id()]];
+      const int negCollisionId = trackCollisionIds[v0NegTrackIds[cascade.v0Id()]];
+      if (bachelorCollisionId != posCollisionId || posCollisionId != negCollisionId) {
+        LOGF(fatal, "Cascade %d has inconsistent collision information (%d, %d, %d) track ids %d %d %d", cascade.globalIndex(), bachelorCollisionId,
+             posCollisionId, negCollisionId, cascade.bachelorId(), v0PosTrackIds[cascade.v0Id()], v0NegTrackIds[cascade.v0Id()]);
       }
-      cascades_001(cascade.bachelor().collisionId(), cascade.v0Id(), cascade.bachelorId());
+      cascades_001(bachelorCollisionId, cascade.v0Id(), cascade.bachelorId());
     }
   }
 };
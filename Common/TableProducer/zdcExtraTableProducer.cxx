@@ -33,6 +33,8 @@
 #include <TH2.h>
 #include <TRandom3.h>
 
+#include <array>
+#include <cmath>
 #include <cstdint>
 
 using namespace o2;
@@ -70,6 +72,14 @@ struct ZdcExtraTableProducer {
 
   HistogramRegistry registry{"Histos", {}, OutputObjHandlingPolicy::AnalysisObject};
 
+  static constexpr int kNTowers = 4; // number of ZDC towers
+  // kBeamEne --  LHC Run 3 Pb-Pb collision energy (5.36 TeV per nucleon pair)
+  static constexpr float kBeamEne = 5.36 * 0.5;
+  // Provide coordinates of centroid over ZN (side C) front face
+  static constexpr std::array<float, kNTowers> X = {-1.75, 1.75, -1.75, 1.75};
+  static constexpr std::array<float, kNTowers> Y = {-1.75, -1.75, 1.75, 1.75};
+  static constexpr float kAlpha = 0.395; // saturation correction
+
   enum SelectionCriteria {
     evSel_zvtx,
     evSel_sel8,
@@ -173,11 +183,29 @@ struct ZdcExtraTableProducer {
     return selectionBits;
   }
 
+  // Centroid coordinates (in cm) from the weighted sums of the x and y coordinates of the towers, with correction factor c
+  // depending on the number of spectator nucleons (nSpec); signX is -1 for ZNC due to its opposite orientation.
+  // The towers without signal have zero weight, so that the sums run over all the towers without branches
+  static std::array<float, 2> centroid(const std::array<double, kNTowers>& pmq, float common, float signX)
+  {
+    float numX = 0., numY = 0., den = 0.;
+    for (int i = 0; i < kNTowers; i++) {
+      const float w = pmq[i] > 0. ? std::pow(pmq[i], kAlpha) : 0.f;
+      numX += X[i] * w; // numerator x
+      numY += Y[i] * w; // numerator y
+      den += w;         // denominator
+    }
+    if (den == 0.) {
+      return {999., 999.};
+    }
+    const float nSpec = common / kBeamEne;
+    const float c = 1.89358 - 0.71262 / (nSpec + 0.71789);
+    return {signX * c * numX / den, c * numY / den};
+  }
+
   void process(ColEvSels const& cols, BCsRun3 const& /*bcs*/, aod::Zdcs const& /*zdcs*/)
   {
     // collision-based event selection
-    int nTowers = 4; // number of ZDC towers
-
     for (auto const& collision : cols) {
       const auto& foundBC = collision.foundBC_as<BCsRun3>();
       if (foundBC.has_zdc()) {
@@ -215,12 +243,13 @@ struct ZdcExtraTableProducer {
         //
         double sumZNC = 0;
         double sumZNA = 0;
-        double pmqZNC[4] = {};
-        double pmqZNA[4] = {};
+        std::array<double, kNTowers> pmqZNC = {};
+        std::array<double, kNTowers> pmqZNA = {};
         //
         if (isZNChit) {
-          for (int it = 0; it < nTowers; it++) {
-            pmqZNC[it] = (zdc.energySectorZNC())[it];
+          const auto energySectorZNC = zdc.energySectorZNC();
+          for (int it = 0; it < kNTowers; it++) {
+            pmqZNC[it] = energySectorZNC[it];
             sumZNC += pmqZNC[it];
           }
           registry.get<TH1>(HIST("ZNCpmc"))->Fill(pmcZNC);
@@ -231,8 +260,9 @@ struct ZdcExtraTableProducer {
           registry.get<TH1>(HIST("ZNCsumq"))->Fill(sumZNC);
         }
         if (isZNAhit) {
-          for (int it = 0; it < nTowers; it++) {
-            pmqZNA[it] = (zdc.energySectorZNA())[it];
+          const auto energySectorZNA = zdc.energySectorZNA();
+          for (int it = 0; it < kNTowers; it++) {
+            pmqZNA[it] = energySectorZNA[it];
             sumZNA += pmqZNA[it];
           }
           //
@@ -245,35 +275,6 @@ struct ZdcExtraTableProducer {
         }
 
         // Q-vectors (centroid) calculation
-        // kBeamEne --  LHC Run 3 Pb-Pb collision energy (5.36 TeV per nucleon pair)
-        constexpr float kBeamEne = 5.36 * 0.5;
-
-        // Provide coordinates of centroid over ZN (side C) front face
-        constexpr float X[4] = {-1.75, 1.75, -1.75, 1.75};
-        constexpr float Y[4] = {-1.75, -1.75, 1.75, 1.75};
-        constexpr float kAlpha = 0.395; // saturation correction
-
-        float numXZNC = 0., numYZNC = 0., denZNC = 0.;
-        float numXZNA = 0., numYZNA = 0., denZNA = 0.;
-
-        // Calculate weighted sums of the x and y coordinates
-        constexpr int kNTowers = 4; // number of ZDC towers
-        for (int i = 0; i < kNTowers; i++) {
-          if (pmqZNC[i] > 0.) {
-            float wZNC = std::pow(pmqZNC[i], kAlpha);
-            numXZNC -= X[i] * wZNC; // numerator x (minus sign due to opposite orientation of ZNC)
-            numYZNC += Y[i] * wZNC; // numerator y
-            denZNC += wZNC;         // denominator
-          }
-          if (pmqZNA[i] > 0.) {
-            float wZNA = std::pow(pmqZNA[i], kAlpha);
-            numXZNA += X[i] * wZNA; // numerator x
-            numYZNA += Y[i] * wZNA; // numerator y
-            denZNA += wZNA;         // denominator
-          }
-        }
-        // Calculate centroid coordinates (in cm) with correction factor c depending on the number of spectator nucleons (nSpec)
-
         float zncCommon = 0;
         float znaCommon = 0;
 
@@ -286,27 +287,8 @@ struct ZdcExtraTableProducer {
           znaCommon = sumZNA;
         }
 
-        float centroidZNC[2], centroidZNA[2];
-
-        if (denZNC != 0.) {
-          float nSpecnC = zncCommon / kBeamEne;
-          float cZNC = 1.89358 - 0.71262 / (nSpecnC + 0.71789);
-          centroidZNC[0] = cZNC * numXZNC / denZNC;
-          centroidZNC[1] = cZNC * numYZNC / denZNC;
-        } else {
-          centroidZNC[0] = 999.;
-          centroidZNC[1] = 999.;
-        }
-        //
-        if (denZNA != 0.) {
-          float nSpecnA = znaCommon / kBeamEne;
-          float cZNA = 1.89358 - 0.71262 / (nSpecnA + 0.71789);
-          centroidZNA[0] = cZNA * numXZNA / denZNA;
-          centroidZNA[1] = cZNA * numYZNA / denZNA;
-        } else {
-          centroidZNA[0] = 999.;
-          centroidZNA[1] = 999.;
-        }
+        const auto centroidZNC = centroid(pmqZNC, zncCommon, -1.f);
+        const auto centroidZNA = centroid(pmqZNA, znaCommon, 1.f);
         registry.get<TH2>(HIST("ZNCCentroid"))->Fill(centroidZNC[0], centroidZNC[1]);
         registry.get<TH2>(HIST("ZNACentroid"))->Fill(centroidZNA[0], centroidZNA[1]);
 
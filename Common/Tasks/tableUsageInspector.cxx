@@ -0,0 +1,40 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   tableUsageInspector.cxx
+/// \brief  Task reporting the tables produced in the workflow and consumed by no device, to be attached to a workflow
+///         to find the producers (and their process functions) which can be switched off
+///
+
+#include "Common/Core/TableHelper.h"
+
+#include <Framework/AnalysisDataModel.h>
+#include <Framework/AnalysisTask.h>
+#include <Framework/InitContext.h>
+#include <Framework/runDataProcessing.h>
+
+using namespace o2;
+using namespace o2::framework;
+
+struct TableUsageInspector {
+  void init(InitContext& initContext)
+  {
+    printUnconsumedTablesInWorkflow(initContext);
+  }
+
+  void process(aod::BCs const&) {}
+};
+
+WorkflowSpec defineDataProcessing(ConfigContext const& cfgc)
+{
+  return WorkflowSpec{adaptAnalysisTask<TableUsageInspector>(cfgc)};
+}
@@ -47,6 +47,7 @@
 #include <RtypesCore.h>
 
 #include <algorithm>
+#include <array>
 #include <bitset>
 #include <cmath>
 #include <cstdint>
@@ -163,7 +164,7 @@ class BcSelectionModule
 
   TriggerAliases* aliases = nullptr;
   EventSelectionParams* par = nullptr;
-  std::map<uint64_t, uint32_t>* mapRCT = nullptr;
+  o2::aod::rctsel::RCTFlagsTimeline rctFlags;               // rct flags of the current run
   std::map<int64_t, std::vector<int16_t>> mapInactiveChips; // number of inactive chips vs orbit per layer
   int64_t prevOrbitForInactiveChips = 0;                    // cached next stored orbit in the inactive chip map
   int64_t nextOrbitForInactiveChips = 0;                    // cached previous stored orbit in the inactive chip map
@@ -171,6 +172,32 @@ class BcSelectionModule
   bool isGoodITSLayer0123 = true;                           // default value
   bool isGoodITSLayersAll = true;                           // default value
 
+  // per-run (alias bit, trigger class mask) pairs, so that the alias map is not traversed for every BC
+  std::vector<std::pair<uint32_t, uint64_t>> mAliasMasks;
+
+  // column buffers of processRun3, reused across data frames
+  enum BcTimes { kTimeZNA = 0,
+                 kTimeZNC,
+                 kTimeV0A,
+                 kTimeT0A,
+                 kTimeT0C,
+                 kTimeFDA,
+                 kTimeFDC,
+                 kTimeV0ABG,
+                 kTimeT0ABG,
+                 kTimeT0CBG,
+                 kTimeFDABG,
+                 kTimeFDCBG,
+                 kNBcTimes };
+  std::array<std::vector<float>, kNBcTimes> mTimes;
+  std::vector<uint64_t> mGlobalBCs;
+  std::vector<std::pair<uint64_t, int32_t>> mSortedGlobalBCs;
+  std::vector<uint64_t> mTriggerMasks;
+  std::vector<uint8_t> mIsTriggerTVX;
+  std::vector<std::array<int32_t, 4>> mFoundIds; // FT0, FV0, FDD, ZDC
+  std::vector<uint32_t> mAliases;
+  std::vector<uint64_t> mSelections;
+
   template <typename TContext, typename TBcSelOpts, typename THistoRegistry, typename TMetadataInfo>
   void init(TContext& context, TBcSelOpts const& external_bcselopts, THistoRegistry& histos, TMetadataInfo const& metadataInfo)
   {
@@ -252,6 +279,12 @@ class BcSelectionModule
       rofLength = alppar->roFrameLengthInBC;
       // Trigger aliases
       aliases = ccdb->template getForTimeStamp<TriggerAliases>("EventSelection/TriggerAliases", ts);
+      mAliasMasks.clear();
+      if (aliases) {
+        for (const auto& [aliasId, triggerMask] : aliases->GetAliasToTriggerMaskMap()) {
+          mAliasMasks.emplace_back(BIT(aliasId), triggerMask);
+        }
+      }
 
       // prepare map of inactive chips
       auto itsDeadMap = ccdb->template getForTimeStamp<o2::itsmft::TimeDeadMap>("ITS/Calib/TimeDeadMap", ts);
@@ -280,13 +313,14 @@ class BcSelectionModule
       std::map<std::string, std::string> metadata;
       metadata["run"] = Form("%d", run);
       ccdb->setFatalWhenNull(0);
-      mapRCT = ccdb->template getSpecific<std::map<uint64_t, uint32_t>>("RCT/Flags/RunFlags", ts, metadata);
+      auto mapRCT = ccdb->template getSpecific<std::map<uint64_t, uint32_t>>("RCT/Flags/RunFlags", ts, metadata);
       ccdb->setFatalWhenNull(1);
       if (mapRCT == nullptr) {
         LOGP(info, "rct object missing... inserting dummy rct flags");
-        mapRCT = new std::map<uint64_t, uint32_t>;
         uint32_t dummyValue = 1u << 31; // setting bit 31 to indicate that rct object is missing
-        mapRCT->insert(std::pair<uint64_t, uint32_t>(sorTimestamp, dummyValue));
+        rctFlags.set(sorTimestamp, dummyValue);
+      } else {
+        rctFlags.set(*mapRCT);
       }
     }
     return true;
@@ -443,10 +477,34 @@ class BcSelectionModule
       return; // don't do anything in case configuration reported not ok
 
     int run = bcs.iteratorAt(0).runNumber();
-    // map from GlobalBC to BcId needed to find triggerBc
-    std::map<uint64_t, int32_t> mapGlobalBCtoBcId;
+    const int64_t nBCs = bcs.size();
+
+    // columnar pass: the BC columns needed by the selections are extracted once,
+    // then each group of selection bits is evaluated over the whole arrays
+    mGlobalBCs.resize(nBCs);
+    mTriggerMasks.resize(nBCs);
+    mIsTriggerTVX.resize(nBCs);
+    mFoundIds.resize(nBCs);
+    for (auto& times : mTimes) {
+      times.resize(nBCs);
+    }
+    int64_t iBC = 0;
     for (const auto& bc : bcs) {
-      mapGlobalBCtoBcId[bc.globalBC()] = bc.globalIndex();
+      mGlobalBCs[iBC] = bc.globalBC();
+      mTriggerMasks[iBC] = bc.triggerMask();
+      mTimes[kTimeZNA][iBC] = bc.has_zdc() ? bc.zdc().timeZNA() : -999.f;
+      mTimes[kTimeZNC][iBC] = bc.has_zdc() ? bc.zdc().timeZNC() : -999.f;
+      mTimes[kTimeV0A][iBC] = bc.has_fv0a() ? bc.fv0a().time() : -999.f;
+      mTimes[kTimeT0A][iBC] = bc.has_ft0() ? bc.ft0().timeA() : -999.f;
+      mTimes[kTimeT0C][iBC] = bc.has_ft0() ? bc.ft0().timeC() : -999.f;
+      mTimes[kTimeFDA][iBC] = bc.has_fdd() ? bc.fdd().timeA() : -999.f;
+      mTimes[kTimeFDC][iBC] = bc.has_fdd() ? bc.fdd().timeC() : -999.f;
+      mIsTriggerTVX[iBC] = bc.has_ft0() && (bc.ft0().triggerMask() & BIT(o2::ft0::Triggers::bitVertex)) > 0;
+      mFoundIds[iBC] = {bc.has_ft0() ? static_cast<int32_t>(bc.ft0().globalIndex()) : -1,
+                      bc.has_fv0a() ? static_cast<int32_t>(bc.fv0a().globalIndex()) : -1,
+                      bc.has_fdd() ? static_cast<int32_t>(bc.fdd().globalIndex()) : -1,
+                      bc.has_zdc() ? static_cast<int32_t>(bc.zdc().globalIndex()) : -1};
+      iBC++;
     }
 
     int triggerBcShift = bcselOpts.confTriggerBcShift;
@@ -454,166 +512,186 @@ class BcSelectionModule
       triggerBcShift = (run <= 526766 || (run >= 526886 && run <= 527237) || (run >= 527259 && run <= 527518) || run == 527523 || run == 527734 || run >= 534091) ? 0 : 294; // o2-linter: disable=magic-number (magic list of runs)
     }
 
-    // bc loop
-    for (auto bc : bcs) { // o2-linter: disable=const-ref-in-for-loop (use bc as nonconst iterator)
-      uint64_t timestamp = timestamps[bc.globalIndex()];
-      // store rct flags
-      uint32_t rct = lastRCT;
-      int64_t thisTF = (bc.globalBC() - bcSOR) / nBCsPerTF;
-      if (mapRCT != nullptr && thisTF != lastTF) { // skip for unanchored runs; do it once per TF
-        auto itrct = mapRCT->upper_bound(timestamp);
-        if (itrct != mapRCT->begin())
-          itrct--;
-        rct = itrct->second;
-        LOGP(debug, "sor={} eor={} ts={} rct={}", sorTimestamp, eorTimestamp, timestamp, rct);
-        lastRCT = rct;
-        lastTF = thisTF;
-      }
-
+    // trigger aliases, from the per-run alias masks. The trigger mask rarely changes from one BC to the next, so the last result is reused
+    // workaround for pp2022 (trigger info is shifted by -294 bcs): the trigger bc is searched among the bcs sorted in globalBC,
+    // where for repeated globalBCs the last one is taken. As before, the first bc of the data frame never provides a trigger
+    mSortedGlobalBCs.resize(nBCs);
+    for (int64_t i = 0; i < nBCs; i++) {
+      mSortedGlobalBCs[i] = {mGlobalBCs[i], static_cast<int32_t>(i)};
+    }
+    std::stable_sort(mSortedGlobalBCs.begin(), mSortedGlobalBCs.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    mAliases.resize(nBCs);
+    uint64_t lastTriggerMask = 0;
+    uint32_t lastAlias = 0;
+    for (int64_t i = 0; i < nBCs; i++) {
       uint32_t alias{0};
-      // workaround for pp2022 (trigger info is shifted by -294 bcs)
-      int32_t triggerBcId = mapGlobalBCtoBcId[bc.globalBC() + triggerBcShift];
+      int32_t triggerBcId = 0;
+      const uint64_t triggerGlobalBC = mGlobalBCs[i] + triggerBcShift;
+      auto itTrigger = std::upper_bound(mSortedGlobalBCs.begin(), mSortedGlobalBCs.end(), triggerGlobalBC, [](uint64_t value, const auto& element) { return value < element.first; });
+      if (itTrigger != mSortedGlobalBCs.begin() && (--itTrigger)->first == triggerGlobalBC) {
+        triggerBcId = itTrigger->second;
+      }
       if (triggerBcId && aliases) {
-        auto triggerBc = bcs.iteratorAt(triggerBcId);
-        uint64_t triggerMask = triggerBc.triggerMask();
-        for (const auto& al : aliases->GetAliasToTriggerMaskMap()) {
-          if (triggerMask & al.second) {
-            alias |= BIT(al.first);
+        const uint64_t triggerMask = mTriggerMasks[triggerBcId];
+        if (triggerMask != lastTriggerMask) {
+          lastAlias = 0;
+          for (const auto& [aliasBit, aliasMask] : mAliasMasks) {
+            if (triggerMask & aliasMask) {
+              lastAlias |= aliasBit;
+            }
           }
+          lastTriggerMask = triggerMask;
         }
+        alias = lastAlias;
       }
-      alias |= BIT(kALL);
+      mAliases[i] = alias | BIT(kALL);
+    }
 
-      // get timing info from ZDC, FV0, FT0 and FDD
-      float timeZNA = bc.has_zdc() ? bc.zdc().timeZNA() : -999.f;
-      float timeZNC = bc.has_zdc() ? bc.zdc().timeZNC() : -999.f;
-      float timeV0A = bc.has_fv0a() ? bc.fv0a().time() : -999.f;
-      float timeT0A = bc.has_ft0() ? bc.ft0().timeA() : -999.f;
-      float timeT0C = bc.has_ft0() ? bc.ft0().timeC() : -999.f;
-      float timeFDA = bc.has_fdd() ? bc.fdd().timeA() : -999.f;
-      float timeFDC = bc.has_fdd() ? bc.fdd().timeC() : -999.f;
-      float timeV0ABG = -999.f;
-      float timeT0ABG = -999.f;
-      float timeT0CBG = -999.f;
-      float timeFDABG = -999.f;
-      float timeFDCBG = -999.f;
-
-      uint64_t globalBC = bc.globalBC();
-      // move to previous bcs to check beam-gas in FT0, FV0 and FDD
-      int64_t backwardMoveCount = 0;
-      int64_t deltaBC = 6; // up to 6 bcs back
-      while (bc.globalBC() + deltaBC >= globalBC) {
-        if (bc == bcs.begin()) {
-          break;
+    // beam-gas timing from the previous bcs: FT0 and FV0 one bc before, FDD five bcs before (up to 6 bcs back)
+    for (auto timesBG : {kTimeV0ABG, kTimeT0ABG, kTimeT0CBG, kTimeFDABG, kTimeFDCBG}) {
+      std::fill(mTimes[timesBG].begin(), mTimes[timesBG].end(), -999.f);
+    }
+    const int64_t deltaBC = 6;
+    const int bcDistanceToBeamGasForFT0 = 1;
+    const int bcDistanceToBeamGasForFDD = 5;
+    for (int64_t i = 1; i < nBCs; i++) {
+      const uint64_t globalBC = mGlobalBCs[i];
+      for (int64_t j = i - 1; j >= 0; j--) {
+        if (mGlobalBCs[j] + bcDistanceToBeamGasForFT0 == globalBC) {
+          mTimes[kTimeV0ABG][i] = mTimes[kTimeV0A][j];
+          mTimes[kTimeT0ABG][i] = mTimes[kTimeT0A][j];
+          mTimes[kTimeT0CBG][i] = mTimes[kTimeT0C][j];
         }
-        --bc;
-        backwardMoveCount++;
-        int bcDistanceToBeamGasForFT0 = 1;
-        int bcDistanceToBeamGasForFDD = 5;
-        if (bc.globalBC() + bcDistanceToBeamGasForFT0 == globalBC) {
-          timeV0ABG = bc.has_fv0a() ? bc.fv0a().time() : -999.f;
-          timeT0ABG = bc.has_ft0() ? bc.ft0().timeA() : -999.f;
-          timeT0CBG = bc.has_ft0() ? bc.ft0().timeC() : -999.f;
+        if (mGlobalBCs[j] + bcDistanceToBeamGasForFDD == globalBC) {
+          mTimes[kTimeFDABG][i] = mTimes[kTimeFDA][j];
+          mTimes[kTimeFDCBG][i] = mTimes[kTimeFDC][j];
         }
-        if (bc.globalBC() + bcDistanceToBeamGasForFDD == globalBC) {
-          timeFDABG = bc.has_fdd() ? bc.fdd().timeA() : -999.f;
-          timeFDCBG = bc.has_fdd() ? bc.fdd().timeC() : -999.f;
+        if (mGlobalBCs[j] + deltaBC < globalBC) {
+          break;
         }
       }
-      // move back to initial position
-      bc.moveByIndex(backwardMoveCount);
-
-      // fill time-based selection criteria
-      uint64_t selection{0};
-      selection |= timeV0A > par->fV0ABBlower && timeV0A < par->fV0ABBupper ? BIT(aod::evsel::kIsBBV0A) : 0;
-      selection |= timeFDA > par->fFDABBlower && timeFDA < par->fFDABBupper ? BIT(aod::evsel::kIsBBFDA) : 0;
-      selection |= timeFDC > par->fFDCBBlower && timeFDC < par->fFDCBBupper ? BIT(aod::evsel::kIsBBFDC) : 0;
-      selection |= !(timeV0ABG > par->fV0ABGlower && timeV0ABG < par->fV0ABGupper) ? BIT(aod::evsel::kNoBGV0A) : 0;
-      selection |= !(timeFDABG > par->fFDABGlower && timeFDABG < par->fFDABGupper) ? BIT(aod::evsel::kNoBGFDA) : 0;
-      selection |= !(timeFDCBG > par->fFDCBGlower && timeFDCBG < par->fFDCBGupper) ? BIT(aod::evsel::kNoBGFDC) : 0;
-      selection |= !(timeT0ABG > par->fT0ABGlower && timeT0ABG < par->fT0ABGupper) ? BIT(aod::evsel::kNoBGT0A) : 0;
-      selection |= !(timeT0CBG > par->fT0CBGlower && timeT0CBG < par->fT0CBGupper) ? BIT(aod::evsel::kNoBGT0C) : 0;
-      selection |= (timeT0A > par->fT0ABBlower && timeT0A < par->fT0ABBupper) ? BIT(aod::evsel::kIsBBT0A) : 0;
-      selection |= (timeT0C > par->fT0CBBlower && timeT0C < par->fT0CBBupper) ? BIT(aod::evsel::kIsBBT0C) : 0;
-      selection |= (timeZNA > par->fZNABBlower && timeZNA < par->fZNABBupper) ? BIT(aod::evsel::kIsBBZNA) : 0;
-      selection |= (timeZNC > par->fZNCBBlower && timeZNC < par->fZNCBBupper) ? BIT(aod::evsel::kIsBBZNC) : 0;
-      selection |= (std::pow((timeZNA + timeZNC - par->fZNSumMean) / par->fZNSumSigma, 2) + std::pow((timeZNA - timeZNC - par->fZNDifMean) / par->fZNDifSigma, 2) < 1) ? BIT(aod::evsel::kIsBBZAC) : 0;
-      selection |= !(std::fabs(timeZNA) > par->fZNABGlower && std::fabs(timeZNA) < par->fZNABGupper) ? BIT(aod::evsel::kNoBGZNA) : 0;
-      selection |= !(std::fabs(timeZNC) > par->fZNCBGlower && std::fabs(timeZNC) < par->fZNCBGupper) ? BIT(aod::evsel::kNoBGZNC) : 0;
-      selection |= (bc.has_ft0() ? (bc.ft0().triggerMask() & BIT(o2::ft0::Triggers::bitVertex)) > 0 : 0) ? BIT(aod::evsel::kIsTriggerTVX) : 0;
+    }
 
-      // check if bc is far from start and end of the ITS RO Frame border
-      uint16_t bcInITSROF = (globalBC + nBCsPerOrbit - rofOffset) % rofLength;
-      LOGP(debug, "bcInITSROF={}", bcInITSROF);
-      selection |= bcInITSROF > mITSROFrameStartBorderMargin && bcInITSROF < rofLength - mITSROFrameEndBorderMargin ? BIT(aod::evsel::kNoITSROFrameBorder) : 0;
+    // fill time-based selection criteria
+    mSelections.assign(nBCs, 0);
+    const float* timeZNA = mTimes[kTimeZNA].data();
+    const float* timeZNC = mTimes[kTimeZNC].data();
+    const float* timeV0A = mTimes[kTimeV0A].data();
+    const float* timeT0A = mTimes[kTimeT0A].data();
+    const float* timeT0C = mTimes[kTimeT0C].data();
+    const float* timeFDA = mTimes[kTimeFDA].data();
+    const float* timeFDC = mTimes[kTimeFDC].data();
+    const float* timeV0ABG = mTimes[kTimeV0ABG].data();
+    const float* timeT0ABG = mTimes[kTimeT0ABG].data();
+    const float* timeT0CBG = mTimes[kTimeT0CBG].data();
+    const float* timeFDABG = mTimes[kTimeFDABG].data();
+    const float* timeFDCBG = mTimes[kTimeFDCBG].data();
+    uint64_t* selection = mSelections.data();
+    const EventSelectionParams& p = *par;
+    for (int64_t i = 0; i < nBCs; i++) {
+      selection[i] |= timeV0A[i] > p.fV0ABBlower && timeV0A[i] < p.fV0ABBupper ? BIT(aod::evsel::kIsBBV0A) : 0;
+      selection[i] |= timeFDA[i] > p.fFDABBlower && timeFDA[i] < p.fFDABBupper ? BIT(aod::evsel::kIsBBFDA) : 0;
+      selection[i] |= timeFDC[i] > p.fFDCBBlower && timeFDC[i] < p.fFDCBBupper ? BIT(aod::evsel::kIsBBFDC) : 0;
+      selection[i] |= (timeT0A[i] > p.fT0ABBlower && timeT0A[i] < p.fT0ABBupper) ? BIT(aod::evsel::kIsBBT0A) : 0;
+      selection[i] |= (timeT0C[i] > p.fT0CBBlower && timeT0C[i] < p.fT0CBBupper) ? BIT(aod::evsel::kIsBBT0C) : 0;
+      selection[i] |= (timeZNA[i] > p.fZNABBlower && timeZNA[i] < p.fZNABBupper) ? BIT(aod::evsel::kIsBBZNA) : 0;
+      selection[i] |= (timeZNC[i] > p.fZNCBBlower && timeZNC[i] < p.fZNCBBupper) ? BIT(aod::evsel::kIsBBZNC) : 0;
+    }
+    for (int64_t i = 0; i < nBCs; i++) {
+      selection[i] |= !(timeV0ABG[i] > p.fV0ABGlower && timeV0ABG[i] < p.fV0ABGupper) ? BIT(aod::evsel::kNoBGV0A) : 0;
+      selection[i] |= !(timeFDABG[i] > p.fFDABGlower && timeFDABG[i] < p.fFDABGupper) ? BIT(aod::evsel::kNoBGFDA) : 0;
+      selection[i] |= !(timeFDCBG[i] > p.fFDCBGlower && timeFDCBG[i] < p.fFDCBGupper) ? BIT(aod::evsel::kNoBGFDC) : 0;
+      selection[i] |= !(timeT0ABG[i] > p.fT0ABGlower && timeT0ABG[i] < p.fT0ABGupper) ? BIT(aod::evsel::kNoBGT0A) : 0;
+      selection[i] |= !(timeT0CBG[i] > p.fT0CBGlower && timeT0CBG[i] < p.fT0CBGupper) ? BIT(aod::evsel::kNoBGT0C) : 0;
+      selection[i] |= !(std::fabs(timeZNA[i]) > p.fZNABGlower && std::fabs(timeZNA[i]) < p.fZNABGupper) ? BIT(aod::evsel::kNoBGZNA) : 0;
+      selection[i] |= !(std::fabs(timeZNC[i]) > p.fZNCBGlower && std::fabs(timeZNC[i]) < p.fZNCBGupper) ? BIT(aod::evsel::kNoBGZNC) : 0;
+    }
+    for (int64_t i = 0; i < nBCs; i++) {
+      const double sum = (timeZNA[i] + timeZNC[i] - p.fZNSumMean) / p.fZNSumSigma;
+      const double dif = (timeZNA[i] - timeZNC[i] - p.fZNDifMean) / p.fZNDifSigma;
+      selection[i] |= (sum * sum + dif * dif < 1) ? BIT(aod::evsel::kIsBBZAC) : 0;
+      selection[i] |= mIsTriggerTVX[i] ? BIT(aod::evsel::kIsTriggerTVX) : 0;
+    }
 
-      // check if bc is far from the Time Frame borders
-      int64_t bcInTF = (globalBC - bcSOR) % nBCsPerTF;
-      LOGP(debug, "bcInTF={}", bcInTF);
-      selection |= bcInTF > mTimeFrameStartBorderMargin && bcInTF < nBCsPerTF - mTimeFrameEndBorderMargin ? BIT(aod::evsel::kNoTimeFrameBorder) : 0;
+    // check if bc is far from start and end of the ITS RO Frame border and from the Time Frame borders
+    for (int64_t i = 0; i < nBCs; i++) {
+      uint16_t bcInITSROF = (mGlobalBCs[i] + nBCsPerOrbit - rofOffset) % rofLength;
+      selection[i] |= bcInITSROF > mITSROFrameStartBorderMargin && bcInITSROF < rofLength - mITSROFrameEndBorderMargin ? BIT(aod::evsel::kNoITSROFrameBorder) : 0;
+      int64_t bcInTF = (mGlobalBCs[i] - bcSOR) % nBCsPerTF;
+      selection[i] |= bcInTF > mTimeFrameStartBorderMargin && bcInTF < nBCsPerTF - mTimeFrameEndBorderMargin ? BIT(aod::evsel::kNoTimeFrameBorder) : 0;
+    }
 
-      // check number of inactive chips and set kIsGoodITSLayer3, kIsGoodITSLayer0123, kIsGoodITSLayersAll flags
-      int64_t orbit = globalBC / nBCsPerOrbit;
+    // check number of inactive chips and set kIsGoodITSLayer3, kIsGoodITSLayer0123, kIsGoodITSLayersAll flags
+    // the flags are only recomputed when the orbit leaves the current range of the dead map
+    for (int64_t i = 0; i < nBCs; i++) {
+      int64_t orbit = mGlobalBCs[i] / nBCsPerOrbit;
       if (mapInactiveChips.size() > 0 && (orbit < prevOrbitForInactiveChips || orbit > nextOrbitForInactiveChips)) {
         auto it = mapInactiveChips.upper_bound(orbit);
         bool isEnd = (it == mapInactiveChips.end());
         if (isEnd)
           it--;
         nextOrbitForInactiveChips = isEnd ? orbit : it->first; // setting current orbit in case we reached the end of mapInactiveChips
-        auto vNextInactiveChips = it->second;
+        const auto& vNextInactiveChips = it->second;
         if (it != mapInactiveChips.begin() && !isEnd)
           it--;
         prevOrbitForInactiveChips = it->first;
-        auto vPrevInactiveChips = it->second;
+        const auto& vPrevInactiveChips = it->second;
         LOGP(debug, "orbit: {}, previous orbit: {}, next orbit: {} ", orbit, prevOrbitForInactiveChips, nextOrbitForInactiveChips);
-        LOGP(debug, "next inactive chips: {} {} {} {} {} {} {}", vNextInactiveChips[0], vNextInactiveChips[1], vNextInactiveChips[2], vNextInactiveChips[3], vNextInactiveChips[4], vNextInactiveChips[5], vNextInactiveChips[6]);
-        LOGP(debug, "prev inactive chips: {} {} {} {} {} {} {}", vPrevInactiveChips[0], vPrevInactiveChips[1], vPrevInactiveChips[2], vPrevInactiveChips[3], vPrevInactiveChips[4], vPrevInactiveChips[5], vPrevInactiveChips[6]);
         isGoodITSLayer3 = vPrevInactiveChips[3] <= bcselOpts.confMaxInactiveChipsPerLayer->at(3) && vNextInactiveChips[3] <= bcselOpts.confMaxInactiveChipsPerLayer->at(3);
         isGoodITSLayer0123 = true;
-        for (int i = 0; i < 4; i++) { // o2-linter: disable=magic-number (counting first 4 ITS layers)
-          isGoodITSLayer0123 &= vPrevInactiveChips[i] <= bcselOpts.confMaxInactiveChipsPerLayer->at(i) && vNextInactiveChips[i] <= bcselOpts.confMaxInactiveChipsPerLayer->at(i);
+        for (int il = 0; il < 4; il++) { // o2-linter: disable=magic-number (counting first 4 ITS layers)
+          isGoodITSLayer0123 &= vPrevInactiveChips[il] <= bcselOpts.confMaxInactiveChipsPerLayer->at(il) && vNextInactiveChips[il] <= bcselOpts.confMaxInactiveChipsPerLayer->at(il);
         }
         isGoodITSLayersAll = true;
-        for (int i = 0; i < o2::itsmft::ChipMappingITS::NLayers; i++) {
-          isGoodITSLayersAll &= vPrevInactiveChips[i] <= bcselOpts.confMaxInactiveChipsPerLayer->at(i) && vNextInactiveChips[i] <= bcselOpts.confMaxInactiveChipsPerLayer->at(i);
+        for (int il = 0; il < o2::itsmft::ChipMappingITS::NLayers; il++) {
+          isGoodITSLayersAll &= vPrevInactiveChips[il] <= bcselOpts.confMaxInactiveChipsPerLayer->at(il) && vNextInactiveChips[il] <= bcselOpts.confMaxInactiveChipsPerLayer->at(il);
         }
       }
+      selection[i] |= isGoodITSLayer3 ? BIT(aod::evsel::kIsGoodITSLayer3) : 0;
+      selection[i] |= isGoodITSLayer0123 ? BIT(aod::evsel::kIsGoodITSLayer0123) : 0;
+      selection[i] |= isGoodITSLayersAll ? BIT(aod::evsel::kIsGoodITSLayersAll) : 0;
+    }
 
-      selection |= isGoodITSLayer3 ? BIT(aod::evsel::kIsGoodITSLayer3) : 0;
-      selection |= isGoodITSLayer0123 ? BIT(aod::evsel::kIsGoodITSLayer0123) : 0;
-      selection |= isGoodITSLayersAll ? BIT(aod::evsel::kIsGoodITSLayersAll) : 0;
-
-      // fill found indices
-      int32_t foundFT0 = bc.has_ft0() ? bc.ft0().globalIndex() : -1;
-      int32_t foundFV0 = bc.has_fv0a() ? bc.fv0a().globalIndex() : -1;
-      int32_t foundFDD = bc.has_fdd() ? bc.fdd().globalIndex() : -1;
-      int32_t foundZDC = bc.has_zdc() ? bc.zdc().globalIndex() : -1;
-      LOGP(debug, "foundFT0={}", foundFT0);
+    // pack the results, with the rct flags looked up once per TF
+    const std::string srun = std::to_string(run);
+    bcselbuffer.reserve(nBCs);
+    bcsel.reserve(nBCs);
+    for (int64_t i = 0; i < nBCs; i++) {
+      uint64_t timestamp = timestamps[i];
+      // store rct flags
+      uint32_t rct = lastRCT;
+      int64_t thisTF = (mGlobalBCs[i] - bcSOR) / nBCsPerTF;
+      if (!rctFlags.empty() && thisTF != lastTF) { // skip for unanchored runs; do it once per TF
+        rct = rctFlags.get(timestamp);
+        LOGP(debug, "sor={} eor={} ts={} rct={}", sorTimestamp, eorTimestamp, timestamp, rct);
+        lastRCT = rct;
+        lastTF = thisTF;
+      }
 
-      const char* srun = Form("%d", run);
+      uint32_t alias = mAliases[i];
       if (timestamp < sorTimestamp || timestamp > eorTimestamp) {
-        histos.template get<TH1>(HIST("bcselection/hCounterInvalidBCTimestamp"))->Fill(srun, 1);
+        histos.template get<TH1>(HIST("bcselection/hCounterInvalidBCTimestamp"))->Fill(srun.c_str(), 1);
         if (bcselOpts.confCheckRunDurationLimits.value) {
           LOGF(warn, "Invalid BC timestamp: %d, run: %d, sor: %d, eor: %d", timestamp, run, sorTimestamp, eorTimestamp);
           alias = 0u;
-          selection = 0u;
+          selection[i] = 0u;
         }
       }
 
       // initialize properties
       o2::common::eventselection::bcselEntry entry;
       entry.alias = alias;
-      entry.selection = selection;
+      entry.selection = selection[i];
       entry.rct = rct;
-      entry.foundFT0Id = foundFT0;
-      entry.foundFV0Id = foundFV0;
-      entry.foundFDDId = foundFDD;
-      entry.foundZDCId = foundZDC;
+      entry.foundFT0Id = mFoundIds[i][0];
+      entry.foundFV0Id = mFoundIds[i][1];
+      entry.foundFDDId = mFoundIds[i][2];
+      entry.foundZDCId = mFoundIds[i][3];
       bcselbuffer.push_back(entry);
 
       // Fill bc selection columns
-      bcsel(alias, selection, rct, foundFT0, foundFV0, foundFDD, foundZDC);
-    } // end bc loop
+      bcsel(alias, selection[i], rct, mFoundIds[i][0], mFoundIds[i][1], mFoundIds[i][2], mFoundIds[i][3]);
+    }
   } // end processRun3
 }; // end BcSelectionModule
 
@@ -29,6 +29,7 @@
 #include <Framework/Logger.h>
 #include <Framework/RunningWorkflowInfo.h>
 
+#include <TAxis.h>
 #include <TFile.h>
 #include <TFormula.h>
 #include <TH1.h>
@@ -36,6 +37,7 @@
 #include <TProfile.h>
 #include <TString.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <cstdlib>
@@ -295,6 +297,59 @@ struct multEntry {
   uint16_t spdClustersL1 = 0;
 };
 
+// flat copy of a 1D calibration histogram, converted once per run
+// lookup() returns the same as h->GetBinContent(h->FindFixBin(x)), without going through ROOT
+struct flatCalibration {
+  bool uniform = true;
+  int nBins = 0;
+  double xMin = 0.0;
+  double xMax = 0.0;
+  std::vector<double> lowEdges; // nBins + 1 edges, only for variable binning
+  std::vector<float> contents;  // underflow, nBins bins, overflow
+
+  void reset()
+  {
+    nBins = 0;
+    lowEdges.clear();
+    contents.clear();
+  }
+
+  void set(const TH1* h)
+  {
+    reset();
+    if (!h) {
+      return;
+    }
+    const TAxis* axis = h->GetXaxis();
+    nBins = axis->GetNbins();
+    xMin = axis->GetXmin();
+    xMax = axis->GetXmax();
+    uniform = axis->GetXbins()->GetSize() == 0;
+    if (!uniform) {
+      lowEdges.assign(axis->GetXbins()->GetArray(), axis->GetXbins()->GetArray() + nBins + 1);
+    }
+    contents.resize(nBins + 2);
+    for (int iBin = 0; iBin < nBins + 2; iBin++) {
+      contents[iBin] = h->GetBinContent(iBin);
+    }
+  }
+
+  float lookup(double x) const
+  {
+    int bin = 0;
+    if (x < xMin) {
+      bin = 0;
+    } else if (!(x < xMax)) {
+      bin = nBins + 1;
+    } else if (uniform) {
+      bin = 1 + static_cast<int>(nBins * (x - xMin) / (xMax - xMin));
+    } else {
+      bin = static_cast<int>(std::upper_bound(lowEdges.begin(), lowEdges.end(), x) - lowEdges.begin());
+    }
+    return contents[bin];
+  }
+};
+
 // strangenessBuilder: 1st-order configurables
 struct standardConfigurables : o2::framework::ConfigurableGroup {
   // self-configuration configurables
@@ -403,6 +458,7 @@ class MultModule
     std::string name = "";
     bool mCalibrationStored = false;
     TH1* mhMultSelCalib = nullptr;
+    flatCalibration mMultSelCalib; // flat copy of mhMultSelCalib used per collision
     float mMCScalePars[6] = {0.0};
     TFormula* mMCScale = nullptr;
     explicit CalibrationInfo(std::string name)
@@ -647,16 +703,8 @@ class MultModule
         mRunNumber = bc.runNumber(); // mark this run as at least tried
         if (internalOpts.reconstructionPass.value == "") {
           lCalibObjects = ccdb->template getForRun<TList>(internalOpts.ccdbPathVtxZ, mRunNumber);
-        } else if (internalOpts.reconstructionPass.value == "metadata") {
-          std::map<std::string, std::string> metadata;
-          metadata["RecoPassName"] = metadataInfo.get("RecoPassName");
-          LOGF(info, "Loading CCDB for reconstruction pass (from metadata): %s", metadataInfo.get("RecoPassName"));
-          lCalibObjects = ccdb->template getSpecificForRun<TList>(internalOpts.ccdbPathVtxZ, mRunNumber, metadata);
         } else {
-          std::map<std::string, std::string> metadata;
-          metadata["RecoPassName"] = internalOpts.reconstructionPass.value;
-          LOGF(info, "Loading CCDB for reconstruction pass (from provided argument): %s", internalOpts.reconstructionPass.value);
-          lCalibObjects = ccdb->template getSpecificForRun<TList>(internalOpts.ccdbPathVtxZ, mRunNumber, metadata);
+          lCalibObjects = ccdb->template getSpecificForRun<TList>(internalOpts.ccdbPathVtxZ, mRunNumber, metadataInfo.getCcdbMetadataForPass(internalOpts.reconstructionPass.value));
         }
 
         if (lCalibObjects) {
@@ -1032,16 +1080,8 @@ class MultModule
       } else {
         if (internalOpts.reconstructionPass.value == "") {
           callst = ccdb->template getForRun<TList>(internalOpts.ccdbPathCentrality, bc.runNumber());
-        } else if (internalOpts.reconstructionPass.value == "metadata") {
-          std::map<std::string, std::string> metadata;
-          metadata["RecoPassName"] = metadataInfo.get("RecoPassName");
-          LOGF(info, "Loading CCDB for reconstruction pass (from metadata): %s", metadataInfo.get("RecoPassName"));
-          callst = ccdb->template getSpecificForRun<TList>(internalOpts.ccdbPathCentrality, bc.runNumber(), metadata);
         } else {
-          std::map<std::string, std::string> metadata;
-          metadata["RecoPassName"] = internalOpts.reconstructionPass.value;
-          LOGF(info, "Loading CCDB for reconstruction pass (from provided argument): %s", internalOpts.reconstructionPass.value);
-          callst = ccdb->template getSpecificForRun<TList>(internalOpts.ccdbPathCentrality, bc.runNumber(), metadata);
+          callst = ccdb->template getSpecificForRun<TList>(internalOpts.ccdbPathCentrality, bc.runNumber(), metadataInfo.getCcdbMetadataForPass(internalOpts.reconstructionPass.value));
         }
       }
 
@@ -1179,16 +1219,8 @@ class MultModule
       } else {
         if (internalOpts.reconstructionPass.value == "") {
           callst = ccdb->template getForRun<TList>(internalOpts.ccdbPathCentrality, bc.runNumber());
-        } else if (internalOpts.reconstructionPass.value == "metadata") {
-          std::map<std::string, std::string> metadata;
-          metadata["RecoPassName"] = metadataInfo.get("RecoPassName");
-          LOGF(info, "Loading CCDB for reconstruction pass (from metadata): %s", metadataInfo.get("RecoPassName"));
-          callst = ccdb->template getSpecificForRun<TList>(internalOpts.ccdbPathCentrality, bc.runNumber(), metadata);
         } else {
-          std::map<std::string, std::string> metadata;
-          metadata["RecoPassName"] = internalOpts.reconstructionPass.value;
-          LOGF(info, "Loading CCDB for reconstruction pass (from provided argument): %s", internalOpts.reconstructionPass.value);
-          callst = ccdb->template getSpecificForRun<TList>(internalOpts.ccdbPathCentrality, bc.runNumber(), metadata);
+          callst = ccdb->template getSpecificForRun<TList>(internalOpts.ccdbPathCentrality, bc.runNumber(), metadataInfo.getCcdbMetadataForPass(internalOpts.reconstructionPass.value));
         }
       }
 
@@ -1219,6 +1251,7 @@ class MultModule
                 LOGF(warning, "MC Scale information from %s for run %d not available", estimator.name.c_str(), bc.runNumber());
               }
             }
+            estimator.mMultSelCalib.set(estimator.mhMultSelCalib);
             estimator.mCalibrationStored = true;
             estimator.isSane();
           } else {
@@ -1298,7 +1331,7 @@ class MultModule
             scaledMultiplicity = scaleMC(multiplicity, estimator.mMCScalePars);
             LOGF(debug, "Unscaled %s multiplicity: %f, scaled %s multiplicity: %f", estimator.name.c_str(), multiplicity, estimator.name.c_str(), scaledMultiplicity);
           }
-          percentile = estimator.mhMultSelCalib->GetBinContent(estimator.mhMultSelCalib->FindFixBin(scaledMultiplicity));
+          percentile = estimator.mMultSelCalib.lookup(scaledMultiplicity);
           if (assignOutOfRange)
             percentile = 100.5f;
         }
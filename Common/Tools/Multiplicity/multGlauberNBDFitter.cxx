@@ -45,6 +45,7 @@
 #include <RtypesCore.h>
 
 #include <iostream> // FIXME
+#include <vector>
 
 using namespace std;
 
@@ -57,6 +58,10 @@ multGlauberNBDFitter::multGlauberNBDFitter() : TNamed(),
                                                fhV0M(0x0),
                                                ffChanged(kTRUE),
                                                fCurrentf(-1),
+                                               fNBDCacheValid(kFALSE),
+                                               fCurrentMu(-1),
+                                               fCurrentk(-1),
+                                               fCurrentdMu(0),
                                                fAncestorMode(2),
                                                fNpart(0x0),
                                                fNcoll(0x0),
@@ -105,6 +110,14 @@ multGlauberNBDFitter::multGlauberNBDFitter(const char* name, const char* title)
                                                                                   fhV0M(0x0),
                                                                                   ffChanged(kTRUE),
                                                                                   fCurrentf(-1),
+                                                                                  fNBDCacheValid(kFALSE),
+                                                                                  fCurrentMu(-1),
+                                                                                  fCurrentk(-1),
+                                                                                  fCurrentdMu(0),
+                                               fNBDCacheValid(kFALSE),
+                                               fCurrentMu(-1),
+                                               fCurrentk(-1),
+                                               fCurrentdMu(0),
                                                                                   fAncestorMode(2),
                                                                                   fNpart(0x0),
                                                                                   fNcoll(0x0),
@@ -186,6 +199,9 @@ Double_t multGlauberNBDFitter::ProbDistrib(Double_t* x, Double_t* par)
   if (ffChanged) {
     fCurrentf = par[2];
     fhNanc->Reset();
+    fAncestorN.clear();
+    fAncestorWeight.clear();
+    fNBDCacheValid = kFALSE;
 
     for (int ibin = 0; ibin < fNNpNcPairs; ibin++) {
       Double_t lOption0 = (Int_t)(fNpart[ibin] * par[2] + fNcoll[ibin] * (1.0 - par[2]));
@@ -204,30 +220,64 @@ Double_t multGlauberNBDFitter::ProbDistrib(Double_t* x, Double_t* par)
       return 0;
     }
     fhNanc->Scale(1. / fhNanc->Integral());
+
+    // keep only the populated bins above 0 ancestors, the others do not contribute
+    Int_t lStartBin = fhNanc->FindBin(0.0) + 1;
+    for (Long_t iNanc = lStartBin; iNanc < fhNanc->GetNbinsX() + 1; iNanc++) {
+      if (fhNanc->GetBinContent(iNanc) != 0) {
+        fAncestorN.push_back(fhNanc->GetBinCenter(iNanc));
+        fAncestorWeight.push_back(fhNanc->GetBinContent(iNanc));
+      }
+    }
   }
+  if (fAncestorN.empty() || lMultValue <= 1e-6)
+    return 0;
+
   //______________________________________________________
   // Actually evaluate function
-  Int_t lStartBin = fhNanc->FindBin(0.0) + 1;
-  for (Long_t iNanc = lStartBin; iNanc < fhNanc->GetNbinsX() + 1; iNanc++) {
-    Double_t lNancestors = fhNanc->GetBinCenter(iNanc);
-    Double_t lNancestorCount = fhNanc->GetBinContent(iNanc);
-    // if(lNancestorCount<1e-12&&lNancestors>10) break;
-
-    // allow for variable mu in case requested
-    Double_t lThisMu = (((Double_t)lNancestors)) * (par[0] + par[4] * lNancestors);
-    Double_t lThisk = (((Double_t)lNancestors)) * par[1];
-    Double_t lpval = TMath::Power(1.0 + lThisMu / lThisk, -1);
-    fNBD->SetParameter(1, lThisk);
-    fNBD->SetParameter(0, lpval);
-    Double_t lMult = 0.0;
-    if (lMultValue > 1e-6)
-      lMult = fAncestorMode != 2 ? fNBD->Eval(lMultValue) : ContinuousNBD(lMultValue, lThisMu, lThisk);
-    lProbability += lNancestorCount * lMult;
+  UpdateNBDCache(par[0], par[1], par[4]);
+
+  // analytical NBD in log form, truncating the multiplicity as the integer NBD does
+  const Double_t n = fAncestorMode != 2 ? TMath::Floor(lMultValue) : lMultValue;
+  const Double_t lLnGammaN1 = TMath::LnGamma(n + 1.);
+  const Long_t lNAncestorBins = fAncestorN.size();
+  for (Long_t iNanc = 0; iNanc < lNAncestorBins; iNanc++) {
+    const Double_t k = fNBDk[iNanc];
+    const Double_t lLogNBD = TMath::LnGamma(n + k) - lLnGammaN1 - fNBDLnGammak[iNanc] + n * fNBDLogMuOverk[iNanc] - (n + k) * fNBDLog1pMuOverk[iNanc];
+    lProbability += fAncestorWeight[iNanc] * TMath::Exp(lLogNBD);
   }
   //______________________________________________________
   return par[3] * lProbability;
 }
 
+//______________________________________________________
+void multGlauberNBDFitter::UpdateNBDCache(Double_t lMu, Double_t lk, Double_t ldMu)
+{
+  // the terms depending only on the number of ancestors and on (mu, k, dmu) are
+  // recomputed only when one of them changes, not for each multiplicity value
+  if (fNBDCacheValid && lMu == fCurrentMu && lk == fCurrentk && ldMu == fCurrentdMu)
+    return;
+  const size_t lNAncestorBins = fAncestorN.size();
+  fNBDk.resize(lNAncestorBins);
+  fNBDLnGammak.resize(lNAncestorBins);
+  fNBDLogMuOverk.resize(lNAncestorBins);
+  fNBDLog1pMuOverk.resize(lNAncestorBins);
+  for (size_t iNanc = 0; iNanc < lNAncestorBins; iNanc++) {
+    const Double_t lNancestors = fAncestorN[iNanc];
+    // allow for variable mu in case requested
+    const Double_t lThisMu = lNancestors * (lMu + ldMu * lNancestors);
+    const Double_t lThisk = lNancestors * lk;
+    fNBDk[iNanc] = lThisk;
+    fNBDLnGammak[iNanc] = TMath::LnGamma(lThisk);
+    fNBDLogMuOverk[iNanc] = TMath::Log(lThisMu / lThisk);
+    fNBDLog1pMuOverk[iNanc] = TMath::Log(1.0 + lThisMu / lThisk);
+  }
+  fCurrentMu = lMu;
+  fCurrentk = lk;
+  fCurrentdMu = ldMu;
+  fNBDCacheValid = kTRUE;
+}
+
 //________________________________________________________________
 Bool_t multGlauberNBDFitter::SetNpartNcollCorrelation(TH2* hNpNc)
 {
@@ -328,6 +378,98 @@ Bool_t multGlauberNBDFitter::DoFit()
   return fitptr.Get()->IsValid();
 }
 
+//________________________________________________________________
+Bool_t multGlauberNBDFitter::DoGridScan(Int_t lNMu, Double_t lMuMin, Double_t lMuMax,
+                                        Int_t lNk, Double_t lkMin, Double_t lkMax,
+                                        Int_t lNf, Double_t lfMin, Double_t lfMax)
+{
+  // Evaluates the chi2 of the Glauber+NBD function at the centers of the bins of the
+  // fit range for a grid of (mu, k, f), with the best normalisation for each grid point.
+  // Use lNf = 1 to keep f at lfMin (e.g. when it is fixed in the fit).
+  InitAncestor();
+  if (!InitializeNpNc()) {
+    cout << "---> Initialization of Npart x Ncoll correlation info failed!" << endl;
+    return kFALSE;
+  }
+  if (!fhV0M || lNMu < 1 || lNk < 1 || lNf < 1) {
+    cout << "---> Grid scan needs the input V0M histogram and at least one point per parameter" << endl;
+    return kFALSE;
+  }
+
+  TStopwatch* timer = new TStopwatch();
+  timer->Start(kTRUE);
+
+  Double_t lLoRange = 0, lHiRange = 0;
+  fGlauberNBD->GetRange(lLoRange, lHiRange);
+  const Int_t lFirstBin = TMath::Max(1, fhV0M->FindBin(lLoRange));
+  const Int_t lLastBin = TMath::Min(fhV0M->GetNbinsX(), fhV0M->FindBin(lHiRange));
+
+  auto gridValue = [](Int_t i, Int_t n, Double_t lMin, Double_t lMax) {
+    return n > 1 ? lMin + (lMax - lMin) * i / (n - 1) : lMin;
+  };
+
+  Double_t lPar[5] = {fMu, fk, ff, 1.0, fGlauberNBD->GetParameter(4)};
+  Double_t lBestChi2 = -1, lBestMu = fMu, lBestk = fk, lBestf = ff, lBestNorm = fnorm;
+  std::vector<Double_t> lModel(lLastBin - lFirstBin + 1);
+  // f outermost: the ancestor distribution is rebuilt only once per f value
+  for (Int_t iF = 0; iF < lNf; iF++) {
+    lPar[2] = gridValue(iF, lNf, lfMin, lfMax);
+    for (Int_t iMu = 0; iMu < lNMu; iMu++) {
+      lPar[0] = gridValue(iMu, lNMu, lMuMin, lMuMax);
+      for (Int_t iK = 0; iK < lNk; iK++) {
+        lPar[1] = gridValue(iK, lNk, lkMin, lkMax);
+        Double_t lSumDataModel = 0, lSumModelModel = 0;
+        for (Int_t iBin = lFirstBin; iBin <= lLastBin; iBin++) {
+          Double_t lX = fhV0M->GetBinCenter(iBin);
+          const Double_t lError = fhV0M->GetBinError(iBin);
+          lModel[iBin - lFirstBin] = ProbDistrib(&lX, lPar);
+          if (lError > 0) {
+            lSumDataModel += fhV0M->GetBinContent(iBin) * lModel[iBin - lFirstBin] / (lError * lError);
+            lSumModelModel += lModel[iBin - lFirstBin] * lModel[iBin - lFirstBin] / (lError * lError);
+          }
+        }
+        if (lSumModelModel <= 0)
+          continue;
+        const Double_t lNorm = lSumDataModel / lSumModelModel;
+        Double_t lChi2 = 0;
+        for (Int_t iBin = lFirstBin; iBin <= lLastBin; iBin++) {
+          const Double_t lError = fhV0M->GetBinError(iBin);
+          if (lError > 0) {
+            const Double_t lResidual = (fhV0M->GetBinContent(iBin) - lNorm * lModel[iBin - lFirstBin]) / lError;
+            lChi2 += lResidual * lResidual;
+          }
+        }
+        if (lBestChi2 < 0 || lChi2 < lBestChi2) {
+          lBestChi2 = lChi2;
+          lBestMu = lPar[0];
+          lBestk = lPar[1];
+          lBestf = lPar[2];
+          lBestNorm = lNorm;
+        }
+      }
+    }
+  }
+
+  timer->Stop();
+  cout << "---> Grid scan of " << lNMu * lNk * lNf << " points took " << timer->RealTime() << " seconds" << endl;
+  delete timer;
+  if (lBestChi2 < 0) {
+    cout << "---> Grid scan failed: no grid point could be evaluated" << endl;
+    return kFALSE;
+  }
+  cout << "---> Best grid point: mu = " << lBestMu << ", k = " << lBestk << ", f = " << lBestf << ", norm = " << lBestNorm << ", chi2 = " << lBestChi2 << endl;
+
+  fMu = lBestMu;
+  fk = lBestk;
+  ff = lBestf;
+  fnorm = lBestNorm;
+  fGlauberNBD->SetParameter(0, fMu);
+  fGlauberNBD->SetParameter(1, fk);
+  fGlauberNBD->SetParameter(2, ff);
+  fGlauberNBD->SetParameter(3, fnorm);
+  return kTRUE;
+}
+
 //________________________________________________________________
 Bool_t multGlauberNBDFitter::InitializeNpNc()
 {
@@ -413,6 +555,14 @@ void multGlauberNBDFitter::CalculateAvNpNc(TProfile* lNPartProf, TProfile* lNCol
   if (lLoRange < -1 && lHiRange < -1) {
     fGlauberNBD->GetRange(lLoRange, lHiRange);
   }
+
+  // terms that depend only on the multiplicity value, shared by all the NpNc pairs
+  std::vector<Double_t> lLnGammaN1;
+  std::vector<Double_t> lMultValuesToFill;
+  for (Long_t lMultValue = 1; lMultValue < lHiRange; lMultValue++) {
+    lLnGammaN1.push_back(TMath::LnGamma(lMultValue + 1.));
+    lMultValuesToFill.push_back(hPercentileMap ? hPercentileMap->GetBinContent(hPercentileMap->FindBin(lMultValue)) : lMultValue);
+  }
   // bypass to zero
   for (int ibin = 0; ibin < fNNpNcPairs; ibin++) {
     if (ibin % 2000 == 0)
@@ -431,25 +581,24 @@ void multGlauberNBDFitter::CalculateAvNpNc(TProfile* lNPartProf, TProfile* lNCol
       hEccentricity->SetName(Form("hEccentricity_%i", ibin));
     }
 
-    for (Long_t lMultValue = 1; lMultValue < lHiRange; lMultValue++) {
-      Double_t lNancestors = lNAncestors0;
-      if (fAncestorMode == 1)
-        lNancestors = lNAncestors1;
-      if (fAncestorMode == 2)
-        lNancestors = lNAncestors2;
-      Double_t lNancestorCount = fContent[ibin];
-      Double_t lThisMu = (((Double_t)lNancestors)) * fMu;
-      Double_t lThisk = (((Double_t)lNancestors)) * fk;
-      Double_t lpval = TMath::Power(1 + lThisMu / lThisk, -1);
-      fNBD->SetParameter(1, lThisk);
-      fNBD->SetParameter(0, lpval);
-      Double_t lMult = 0.0;
-      if (lMultValue > 1e-6)
-        lMult = fAncestorMode != 2 ? fNBD->Eval(lMultValue) : ContinuousNBD(lMultValue, lThisMu, lThisk);
-      Double_t lProbability = lNancestorCount * lMult;
-      Double_t lMultValueToFill = lMultValue;
-      if (hPercentileMap)
-        lMultValueToFill = hPercentileMap->GetBinContent(hPercentileMap->FindBin(lMultValue));
+    Double_t lNancestors = lNAncestors0;
+    if (fAncestorMode == 1)
+      lNancestors = lNAncestors1;
+    if (fAncestorMode == 2)
+      lNancestors = lNAncestors2;
+    const Double_t lNancestorCount = fContent[ibin];
+    const Double_t lThisMu = lNancestors * fMu;
+    const Double_t lThisk = lNancestors * fk;
+    const Double_t lLnGammak = TMath::LnGamma(lThisk);
+    const Double_t lLogMuOverk = TMath::Log(lThisMu / lThisk);
+    const Double_t lLog1pMuOverk = TMath::Log(1.0 + lThisMu / lThisk);
+
+    for (size_t iMult = 0; iMult < lLnGammaN1.size(); iMult++) {
+      // integer multiplicity values: the NBD and its analytical continuation coincide
+      const Double_t lMultValue = iMult + 1;
+      const Double_t lMult = TMath::Exp(TMath::LnGamma(lMultValue + lThisk) - lLnGammaN1[iMult] - lLnGammak + lMultValue * lLogMuOverk - (lMultValue + lThisk) * lLog1pMuOverk);
+      const Double_t lProbability = lNancestorCount * lMult;
+      const Double_t lMultValueToFill = lMultValuesToFill[iMult];
       lNPartProf->Fill(lMultValueToFill, fNpart[ibin], lProbability);
       lNCollProf->Fill(lMultValueToFill, fNcoll[ibin], lProbability);
       if (lNPart2DPlot)
@@ -23,6 +23,8 @@
 #include <Rtypes.h>
 #include <RtypesCore.h>
 
+#include <vector>
+
 class multGlauberNBDFitter : public TNamed
 {
 
@@ -40,6 +42,12 @@ class multGlauberNBDFitter : public TNamed
   // Do Fit: where everything happens
   Bool_t DoFit();
 
+  // Coarse scan of (mu, k, f) with the best normalisation for each point,
+  // sets the minimum chi2 point as starting values for DoFit
+  Bool_t DoGridScan(Int_t lNMu, Double_t lMuMin, Double_t lMuMax,
+                    Int_t lNk, Double_t lkMin, Double_t lkMax,
+                    Int_t lNf, Double_t lfMin, Double_t lfMax);
+
   // Set input characteristics: the 2D plot with Npart, Nanc
   Bool_t SetNpartNcollCorrelation(TH2* hNpNc);
 
@@ -98,6 +106,19 @@ class multGlauberNBDFitter : public TNamed
   Bool_t ffChanged;
   Double_t fCurrentf;
 
+  // Cache of the populated ancestor bins and of their NBD terms that do not depend on the multiplicity
+  void UpdateNBDCache(Double_t lMu, Double_t lk, Double_t ldMu);
+  Bool_t fNBDCacheValid;                  //!
+  Double_t fCurrentMu;                    //!
+  Double_t fCurrentk;                     //!
+  Double_t fCurrentdMu;                   //!
+  std::vector<Double_t> fAncestorWeight;  //! normalised ancestor counts
+  std::vector<Double_t> fAncestorN;       //! number of ancestors
+  std::vector<Double_t> fNBDk;            //! k of the NBD
+  std::vector<Double_t> fNBDLnGammak;     //! ln(Gamma(k))
+  std::vector<Double_t> fNBDLogMuOverk;   //! ln(mu/k)
+  std::vector<Double_t> fNBDLog1pMuOverk; //! ln(1+mu/k)
+
   // 0: truncation, 1: rounding, 2: analytical continuation
   Int_t fAncestorMode;
 
@@ -41,6 +41,7 @@
 #include <TMatrixDfwd.h>
 #include <TRandom.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
@@ -213,6 +214,9 @@ class pidTPCModule
   std::map<std::string, std::string> headers;
   std::vector<int> speciesNetworkFlags = std::vector<int>(9);
   std::string networkVersion;
+  std::vector<float> networkInput;      // features of all the tracks of the data frame, one block per enabled mass hypothesis
+  std::vector<float> networkOutput;     // output of the batched inference, kept to reuse the buffer between data frames
+  std::vector<float> networkPrediction; // network output, one block per mass hypothesis, indexed as [track + nTracks * pid]
 
   // To get automatically the proper Hadronic Rate
   std::string irSource = "";
@@ -440,11 +444,8 @@ class pidTPCModule
 
   //__________________________________________________
   template <typename TCCDB, typename TCCDBApi, typename M, typename T, typename B>
-  std::vector<float> createNetworkPrediction(TCCDB& ccdb, TCCDBApi& ccdbApi, soa::Join<aod::Collisions, aod::EvSels> const& collisions, M const& mults, T const& tracks, B const& bcs, const size_t size)
+  const std::vector<float>& createNetworkPrediction(TCCDB& ccdb, TCCDBApi& ccdbApi, soa::Join<aod::Collisions, aod::EvSels> const& collisions, M const& mults, T const& tracks, B const& bcs, const size_t size)
   {
-
-    std::vector<float> network_prediction;
-
     auto start_network_total = std::chrono::high_resolution_clock::now();
     if (pidTPCopts.autofetchNetworks) {
       const auto& bc = bcs.begin();
@@ -500,18 +501,14 @@ class pidTPCModule
     }
 
     // Defining some network parameters
-    int input_dimensions = network.getNumInputNodes();
-    int output_dimensions = network.getNumOutputNodes();
-    const uint64_t track_prop_size = input_dimensions * size;
+    const int input_dimensions = network.getNumInputNodes();
+    const int output_dimensions = network.getNumOutputNodes();
     const uint64_t prediction_size = output_dimensions * size;
+    static constexpr int NParticleTypes = 9;
 
-    network_prediction = std::vector<float>(prediction_size * 9); // For each mass hypotheses
+    // Layout kept as one block of prediction_size per mass hypothesis; blocks of hypotheses without network correction are not filled
+    networkPrediction.assign(prediction_size * NParticleTypes, 0.f);
     const float nNclNormalization = response->GetNClNormalization();
-    float duration_network = 0;
-
-    std::vector<float> track_properties(track_prop_size);
-    uint64_t counter_track_props = 0;
-    int loop_counter = 0;
 
     // To load the Hadronic rate once for each collision
     float hadronicRateBegin = 0.;
@@ -533,93 +530,92 @@ class pidTPCModule
       hadronicRateBegin = 0.0f;
     }
 
-    // Filling a std::vector<float> to be evaluated by the network
-    // Evaluation on single tracks brings huge overhead: Thus evaluation is done on one large vector
-    static constexpr int NParticleTypes = 9;
+    // Mass hypotheses evaluated by the network, stacked one after the other in a single feature matrix
+    std::vector<int> enabledSpecies;
+    for (int j = 0; j < NParticleTypes; j++) {
+      if (speciesNetworkFlags[j]) {
+        enabledSpecies.push_back(j);
+      }
+    }
+    if (enabledSpecies.empty() || size == 0) {
+      return networkPrediction;
+    }
+
+    // Filling the features of the first hypothesis: they only depend on the track, apart from the mass
+    // Evaluation on single tracks brings huge overhead: Thus evaluation is done on one large matrix for the whole data frame
     constexpr int ExpectedInputDimensionsNNV2 = 7;
     constexpr int ExpectedInputDimensionsNNV3 = 8;
     constexpr int ExpectedInputDimensionsNNV4 = 9;
+    constexpr int MassFeatureIndex = 3;
     constexpr auto NetworkVersionV2 = "2";
     constexpr auto NetworkVersionV3 = "3";
     constexpr auto NetworkVersionV4 = "4";
-    for (int j = 0; j < NParticleTypes; j++) { // Loop over particle number for which network correction is used
-      for (auto const& trk : tracks) {
-        if (!trk.hasTPC()) {
+    const uint64_t track_prop_size = input_dimensions * size;
+    networkInput.resize(track_prop_size * enabledSpecies.size());
+    uint64_t counter_track_props = 0;
+    for (auto const& trk : tracks) {
+      if (!trk.hasTPC()) {
+        continue;
+      }
+      if (pidTPCopts.skipTPCOnly) {
+        if (!trk.hasITS() && !trk.hasTRD() && !trk.hasTOF()) {
           continue;
         }
-        if (pidTPCopts.skipTPCOnly) {
-          if (!trk.hasITS() && !trk.hasTRD() && !trk.hasTOF()) {
-            continue;
-          }
-        }
-        track_properties[counter_track_props] = trk.tpcInnerParam();
-        track_properties[counter_track_props + 1] = trk.tgl();
-        track_properties[counter_track_props + 2] = trk.signed1Pt();
-        track_properties[counter_track_props + 3] = o2::track::pid_constants::sMasses[j];
-        track_properties[counter_track_props + 4] = trk.has_collision() ? mults[trk.collisionId()] / 11000. : 1.;
-        track_properties[counter_track_props + 5] = std::sqrt(nNclNormalization / trk.tpcNClsFound());
-        if (input_dimensions == ExpectedInputDimensionsNNV2 && networkVersion == NetworkVersionV2) {
-          track_properties[counter_track_props + 6] = trk.has_collision() ? collisions.iteratorAt(trk.collisionId()).ft0cOccupancyInTimeRange() / 60000. : 1.;
-        }
-        if (input_dimensions == ExpectedInputDimensionsNNV3 && networkVersion == NetworkVersionV3) {
-          track_properties[counter_track_props + 6] = trk.has_collision() ? collisions.iteratorAt(trk.collisionId()).ft0cOccupancyInTimeRange() / 60000. : 1.;
-          if (trk.has_collision()) {
-            if (collsys == CollisionSystemType::kCollSyspp) {
-              track_properties[counter_track_props + 7] = hadronicRateForCollision[trk.collisionId()] / 1500.;
-            } else {
-              track_properties[counter_track_props + 7] = hadronicRateForCollision[trk.collisionId()] / 50.;
-            }
-          } else {
-            // asign Hadronic Rate at beginning of run  if track does not belong to a collision
-            if (collsys == CollisionSystemType::kCollSyspp) {
-              track_properties[counter_track_props + 7] = hadronicRateBegin / 1500.;
-            } else {
-              track_properties[counter_track_props + 7] = hadronicRateBegin / 50.;
-            }
-          }
-        }
-
-        if (input_dimensions == ExpectedInputDimensionsNNV4 && networkVersion == NetworkVersionV4) {
-          track_properties[counter_track_props + 6] = trk.has_collision() ? collisions.iteratorAt(trk.collisionId()).ft0cOccupancyInTimeRange() / 60000. : 1.;
-          if (trk.has_collision()) {
-            if (collsys == CollisionSystemType::kCollSyspp) {
-              track_properties[counter_track_props + 7] = hadronicRateForCollision[trk.collisionId()] / 1500.;
-            } else {
-              track_properties[counter_track_props + 7] = hadronicRateForCollision[trk.collisionId()] / 50.;
-            }
-          } else {
-            // asign Hadronic Rate at beginning of run  if track does not belong to a collision
-            if (collsys == CollisionSystemType::kCollSyspp) {
-              track_properties[counter_track_props + 7] = hadronicRateBegin / 1500.;
-            } else {
-              track_properties[counter_track_props + 7] = hadronicRateBegin / 50.;
-            }
-          }
-          track_properties[counter_track_props + 8] = std::fmod(std::fmod(trk.phi(), 2 * M_PI) + 2 * M_PI, M_PI / 9.0);
+      }
+      float* track_properties = networkInput.data() + counter_track_props;
+      track_properties[0] = trk.tpcInnerParam();
+      track_properties[1] = trk.tgl();
+      track_properties[2] = trk.signed1Pt();
+      track_properties[MassFeatureIndex] = o2::track::pid_constants::sMasses[enabledSpecies[0]];
+      track_properties[4] = trk.has_collision() ? mults[trk.collisionId()] / 11000. : 1.;
+      track_properties[5] = std::sqrt(nNclNormalization / trk.tpcNClsFound());
+      if (input_dimensions == ExpectedInputDimensionsNNV2 && networkVersion == NetworkVersionV2) {
+        track_properties[6] = trk.has_collision() ? collisions.iteratorAt(trk.collisionId()).ft0cOccupancyInTimeRange() / 60000. : 1.;
+      }
+      if ((input_dimensions == ExpectedInputDimensionsNNV3 && networkVersion == NetworkVersionV3) || (input_dimensions == ExpectedInputDimensionsNNV4 && networkVersion == NetworkVersionV4)) {
+        track_properties[6] = trk.has_collision() ? collisions.iteratorAt(trk.collisionId()).ft0cOccupancyInTimeRange() / 60000. : 1.;
+        // asign Hadronic Rate at beginning of run if track does not belong to a collision
+        const float hadronicRate = trk.has_collision() ? hadronicRateForCollision[trk.collisionId()] : hadronicRateBegin;
+        if (collsys == CollisionSystemType::kCollSyspp) {
+          track_properties[7] = hadronicRate / 1500.;
+        } else {
+          track_properties[7] = hadronicRate / 50.;
         }
-        counter_track_props += input_dimensions;
       }
+      if (input_dimensions == ExpectedInputDimensionsNNV4 && networkVersion == NetworkVersionV4) {
+        track_properties[8] = std::fmod(std::fmod(trk.phi(), 2 * M_PI) + 2 * M_PI, M_PI / 9.0);
+      }
+      counter_track_props += input_dimensions;
+    }
 
-      auto start_network_eval = std::chrono::high_resolution_clock::now();
-      float* output_network = network.evalModel(track_properties);
-      auto stop_network_eval = std::chrono::high_resolution_clock::now();
-      duration_network += std::chrono::duration<float, std::ratio<1, 1000000000>>(stop_network_eval - start_network_eval).count();
-      for (uint64_t k = 0; k < prediction_size; k += output_dimensions) {
-        for (int l = 0; l < output_dimensions; l++) {
-          network_prediction[k + l + prediction_size * loop_counter] = output_network[k + l];
-        }
+    // Other hypotheses: copy of the first block with the mass replaced
+    for (size_t k = 1; k < enabledSpecies.size(); k++) {
+      float* block = networkInput.data() + k * track_prop_size;
+      std::copy(networkInput.begin(), networkInput.begin() + track_prop_size, block);
+      const float mass = o2::track::pid_constants::sMasses[enabledSpecies[k]];
+      for (uint64_t row = 0; row < size; row++) {
+        block[row * input_dimensions + MassFeatureIndex] = mass;
       }
+    }
 
-      counter_track_props = 0;
-      loop_counter += 1;
+    auto start_network_eval = std::chrono::high_resolution_clock::now();
+    const int64_t outputRowSize = network.evalModelBatch(networkInput.data(), static_cast<int64_t>(size * enabledSpecies.size()), networkOutput);
+    auto stop_network_eval = std::chrono::high_resolution_clock::now();
+    const float duration_network = std::chrono::duration<float, std::ratio<1, 1000000000>>(stop_network_eval - start_network_eval).count();
+    if (outputRowSize != output_dimensions) {
+      LOG(fatal) << "Batched inference of the TPC PID network failed or returned " << outputRowSize << " values per track instead of " << output_dimensions;
+    }
+
+    // Scattering the results into the block of each hypothesis
+    for (size_t k = 0; k < enabledSpecies.size(); k++) {
+      std::copy(networkOutput.begin() + k * prediction_size, networkOutput.begin() + (k + 1) * prediction_size, networkPrediction.begin() + enabledSpecies[k] * prediction_size);
     }
-    track_properties.clear();
 
     auto stop_network_total = std::chrono::high_resolution_clock::now();
-    LOG(debug) << "Neural Network for the TPC PID response correction: Time per track (eval ONNX): " << duration_network / (size * 9) << "ns ; Total time (eval ONNX): " << duration_network / 1000000000 << " s";
-    LOG(debug) << "Neural Network for the TPC PID response correction: Time per track (eval + overhead): " << std::chrono::duration<float, std::ratio<1, 1000000000>>(stop_network_total - start_network_total).count() / (size * 9) << "ns ; Total time (eval + overhead): " << std::chrono::duration<float, std::ratio<1, 1000000000>>(stop_network_total - start_network_total).count() / 1000000000 << " s";
+    LOG(debug) << "Neural Network for the TPC PID response correction: Time per track (eval ONNX): " << duration_network / (size * enabledSpecies.size()) << "ns ; Total time (eval ONNX): " << duration_network / 1000000000 << " s";
+    LOG(debug) << "Neural Network for the TPC PID response correction: Time per track (eval + overhead): " << std::chrono::duration<float, std::ratio<1, 1000000000>>(stop_network_total - start_network_total).count() / (size * enabledSpecies.size()) << "ns ; Total time (eval + overhead): " << std::chrono::duration<float, std::ratio<1, 1000000000>>(stop_network_total - start_network_total).count() / 1000000000 << " s";
 
-    return network_prediction;
+    return networkPrediction;
   }
 
   //__________________________________________________
@@ -750,11 +746,10 @@ class pidTPCModule
     reserveTable(pidTPCopts.pidTinyAl, products.tablePIDTinyAl);
 
     const uint64_t tracksForNet_size = (pidTPCopts.skipTPCOnly) ? totalTPCnotStandalone : totalTPCtracks;
-    std::vector<float> network_prediction;
-
     if (pidTPCopts.useNetworkCorrection) {
-      network_prediction = createNetworkPrediction(ccdb, ccdbApi, cols, pidmults, tracks, bcs, tracksForNet_size);
+      createNetworkPrediction(ccdb, ccdbApi, cols, pidmults, tracks, bcs, tracksForNet_size);
     }
+    const std::vector<float>& network_prediction = networkPrediction;
 
     uint64_t count_tracks = 0;
 
@@ -26,7 +26,13 @@
 
 #include <cmath>
 #include <cstdlib>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <utility>
+#include <vector>
 
 //__________________________________________
 // Standard class to load stuff
@@ -48,16 +54,121 @@ struct StandardCCDBLoaderConfigurables : o2::framework::ConfigurableGroup {
   o2::framework::Configurable<std::string> mVtxPath{"mVtxPath", "GLO/Calib/MeanVertex", "Path of the mean vertex file"};
 };
 
+// Run conditions shared by all the StandardCCDBLoader instances of a process
+// The propagator is a process-wide singleton: its magnetic field is set once per run and
+// the material LUT is retrieved and rectified only once, whatever the number of tasks using it.
+// The object is released when the last loader holding it is destroyed.
+class StandardCCDBConditions
+{
+ public:
+  using RunChangeCallback = std::function<void(int)>;
+
+  static std::shared_ptr<StandardCCDBConditions> acquire()
+  {
+    static std::mutex instanceMutex;
+    static std::weak_ptr<StandardCCDBConditions> instance;
+    std::lock_guard<std::mutex> lock(instanceMutex);
+    auto conditions = instance.lock();
+    if (!conditions) {
+      conditions = std::make_shared<StandardCCDBConditions>();
+      instance = conditions;
+    }
+    return conditions;
+  }
+
+  // callback called once per run change of the process, after the magnetic field has been set
+  int subscribe(RunChangeCallback callback)
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mCallbacks.emplace(++mLastCallbackId, std::move(callback));
+    return mLastCallbackId;
+  }
+  void unsubscribe(int id)
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mCallbacks.erase(id);
+  }
+
+  template <typename TConfigurableGroup, typename TCCDB>
+  o2::parameters::GRPMagField* setMagneticField(TConfigurableGroup const& cGroup, TCCDB& ccdb, int currentRunNumber)
+  {
+    std::vector<RunChangeCallback> callbacks;
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      if (mRunNumber == currentRunNumber) {
+        return mGrpMag;
+      }
+      mGrpMag = ccdb->template getForRun<o2::parameters::GRPMagField>(cGroup.grpmagPath.value, currentRunNumber);
+      if (mGrpMag) {
+        LOG(info) << "Setting global propagator magnetic field to current " << mGrpMag->getL3Current() << " A for run " << currentRunNumber << " from its GRPMagField CCDB object";
+        o2::base::Propagator::initFieldFromGRP(mGrpMag);
+      } else {
+        LOGF(info, "GRPMagField object returned nullptr, will attempt alternate method");
+
+        o2::parameters::GRPObject* grpo = 0x0;
+        grpo = ccdb->template getForRun<o2::parameters::GRPObject>(cGroup.grpPath.value, currentRunNumber);
+        if (!grpo) {
+          LOG(fatal) << "Alternate path failed! Got nullptr from CCDB for path " << cGroup.grpPath << " of object GRPObject for run " << currentRunNumber;
+        }
+        o2::base::Propagator::initFieldFromGRP(grpo);
+      }
+      mRunNumber = currentRunNumber;
+      for (const auto& [id, callback] : mCallbacks) {
+        callbacks.push_back(callback);
+      }
+    }
+    for (const auto& callback : callbacks) { // called outside of the lock, they may use the loader again
+      callback(currentRunNumber);
+    }
+    return mGrpMag;
+  }
+
+  template <typename TConfigurableGroup, typename TCCDB>
+  o2::base::MatLayerCylSet* getMatLUT(TConfigurableGroup const& cGroup, TCCDB& ccdb, int currentRunNumber)
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (!mLut) {
+      LOG(info) << "Loading material look-up table for timestamp: " << currentRunNumber;
+      mLut = o2::base::MatLayerCylSet::rectifyPtrFromFile(ccdb->template getForRun<o2::base::MatLayerCylSet>(cGroup.lutPath.value, currentRunNumber));
+    } else {
+      LOG(info) << "Material look-up table already in place. Not reloading.";
+    }
+    return mLut;
+  }
+
+ private:
+  std::mutex mMutex;
+  int mRunNumber = -1;                            // run of the current magnetic field
+  o2::parameters::GRPMagField* mGrpMag = nullptr; // owned by the CCDB manager
+  o2::base::MatLayerCylSet* mLut = nullptr;       // owned by the CCDB manager
+  int mLastCallbackId = 0;
+  std::map<int, RunChangeCallback> mCallbacks;
+};
+
 class StandardCCDBLoader
 {
  public:
-  StandardCCDBLoader()
+  StandardCCDBLoader() : mConditions(StandardCCDBConditions::acquire())
   {
     // constructor - null pointers
     mMeanVtx = nullptr;
     grpmag = nullptr;
     lut = nullptr;
   };
+  ~StandardCCDBLoader()
+  {
+    for (const auto& id : mCallbackIds) {
+      mConditions->unsubscribe(id);
+    }
+  }
+  StandardCCDBLoader(const StandardCCDBLoader&) = delete;
+  StandardCCDBLoader& operator=(const StandardCCDBLoader&) = delete;
+
+  // function called at each run change of the process, e.g. to update objects depending on the magnetic field
+  void onRunChange(StandardCCDBConditions::RunChangeCallback callback)
+  {
+    mCallbackIds.push_back(mConditions->subscribe(std::move(callback)));
+  }
 
   // commonly needed objects
   const o2::dataformats::MeanVertexObject* mMeanVtx = nullptr;
@@ -83,20 +194,8 @@ class StandardCCDBLoader
       return;
     }
 
-    grpmag = ccdb->template getForRun<o2::parameters::GRPMagField>(cGroup.grpmagPath.value, currentRunNumber);
-    if (grpmag) {
-      LOG(info) << "Setting global propagator magnetic field to current " << grpmag->getL3Current() << " A for run " << currentRunNumber << " from its GRPMagField CCDB object";
-      o2::base::Propagator::initFieldFromGRP(grpmag);
-    } else {
-      LOGF(info, "GRPMagField object returned nullptr, will attempt alternate method");
-
-      o2::parameters::GRPObject* grpo = 0x0;
-      grpo = ccdb->template getForRun<o2::parameters::GRPObject>(cGroup.grpPath.value, currentRunNumber);
-      if (!grpo) {
-        LOG(fatal) << "Alternate path failed! Got nullptr from CCDB for path " << cGroup.grpPath << " of object GRPObject for run " << currentRunNumber;
-      }
-      o2::base::Propagator::initFieldFromGRP(grpo);
-    }
+    // magnetic field and material LUT are shared with the other loaders of the process
+    grpmag = mConditions->setMagneticField(cGroup, ccdb, currentRunNumber);
     if (getMeanVertex) {
       // only try this if explicitly requested
       mMeanVtx = ccdb->template getForRun<o2::dataformats::MeanVertexObject>(cGroup.mVtxPath.value, currentRunNumber);
@@ -106,16 +205,17 @@ class StandardCCDBLoader
 
     // load matLUT for this timestamp
     if (!lut) {
-      LOG(info) << "Loading material look-up table for timestamp: " << currentRunNumber;
-      lut = o2::base::MatLayerCylSet::rectifyPtrFromFile(ccdb->template getForRun<o2::base::MatLayerCylSet>(cGroup.lutPath.value, currentRunNumber));
-    } else {
-      LOG(info) << "Material look-up table already in place. Not reloading.";
+      lut = mConditions->getMatLUT(cGroup, ccdb, currentRunNumber);
     }
     LOG(info) << "Setting global propagator material propagation LUT";
     o2::base::Propagator::Instance()->setMatLUT(lut);
 
     runNumber = currentRunNumber;
   }
+
+ private:
+  std::shared_ptr<StandardCCDBConditions> mConditions; // held by all loaders of the process
+  std::vector<int> mCallbackIds;                       // run change callbacks registered by this loader
 };
 
 } // namespace common
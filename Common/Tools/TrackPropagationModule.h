@@ -38,11 +38,16 @@
 #include <TH1.h>
 #include <TH2.h>
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cmath>
+#include <cstdint>
 #include <cstdlib>
 #include <memory>
 #include <string>
+#include <thread>
+#include <vector>
 
 //__________________________________________
 // track propagation module
@@ -78,6 +83,12 @@ struct TrackPropagationConfigurables : o2::framework::ConfigurableGroup {
   o2::framework::Configurable<bool> fillTrackTunerTable{"fillTrackTunerTable", false, "flag to fill track tuner table"};
   o2::framework::Configurable<int> trackTunerConfigSource{"trackTunerConfigSource", aod::track_tuner::InputString, "1: input string; 2: TrackTuner Configurables"};
   o2::framework::Configurable<std::string> trackTunerParams{"trackTunerParams", "debugInfo=0|updateTrackDCAs=1|updateTrackCovMat=1|updateCurvature=0|updateCurvatureIU=0|updatePulls=0|isInputFileFromCCDB=1|pathInputFile=Users/m/mfaggin/test/inputsTrackTuner/PbPb2022|nameInputFile=trackTuner_DataLHC22sPass5_McLHC22l1b2_run529397.root|pathFileQoverPt=Users/h/hsharma/qOverPtGraphs|nameFileQoverPt=D0sigma_Data_removal_itstps_MC_LHC22b1b.root|usePvRefitCorrections=0|qOverPtMC=-1.|qOverPtData=-1.", "TrackTuner parameter initialization (format: <name>=<value>|<name>=<value>)"};
+  // chunked propagation on a pool of threads
+  o2::framework::Configurable<int> nThreads{"nThreads", 1, "number of threads propagating the tracks (1: serial, not used with the TrackTuner or the TGeo material correction)"};
+  o2::framework::Configurable<int> chunkSize{"chunkSize", 512, "number of consecutive tracks propagated by a thread at a time"};
+  // cheap prefilter at the innermost update, tracks failing it fill unpropagated
+  o2::framework::Configurable<float> minPtPropagation{"minPtPropagation", 0.f, "tracks with a smaller pT at the innermost update are not propagated (<= 0: no cut)"};
+  o2::framework::Configurable<float> maxAbsEtaPropagation{"maxAbsEtaPropagation", -1.f, "tracks with a larger |eta| at the innermost update are not propagated (< 0: no cut)"};
   o2::framework::ConfigurableAxis axisPtQA{"axisPtQA", {o2::framework::VARIABLE_WIDTH, 0.0f, 0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f, 0.7f, 0.8f, 0.9f, 1.0f, 1.1f, 1.2f, 1.3f, 1.4f, 1.5f, 1.6f, 1.7f, 1.8f, 1.9f, 2.0f, 2.2f, 2.4f, 2.6f, 2.8f, 3.0f, 3.2f, 3.4f, 3.6f, 3.8f, 4.0f, 4.4f, 4.8f, 5.2f, 5.6f, 6.0f, 6.5f, 7.0f, 7.5f, 8.0f, 9.0f, 10.0f, 11.0f, 12.0f, 13.0f, 14.0f, 15.0f, 17.0f, 19.0f, 21.0f, 23.0f, 25.0f, 30.0f, 35.0f, 40.0f, 50.0f}, "pt axis for QA histograms"};
 };
 
@@ -247,32 +258,40 @@ class TrackPropagationModule
       }
     }
 
+    // The TrackTuner and the TGeo material correction are not thread safe: these configurations are always propagated serially
+    const int nThreads = (cGroup.useTrackTuner.value || matCorr == o2::base::Propagator::MatCorrType::USEMatCorrTGeo) ? 1 : cGroup.nThreads.value;
+    if (nThreads > 1) {
+      propagateTracksInChunks(cGroup, ccdbLoader, collisions, tracks, nThreads);
+      // tables are filled in the order of the input tracks
+      int64_t iTrack = 0;
+      for (const auto& track : tracks) {
+        if (fillTracksCov) {
+          if constexpr (isMc) {
+            if (mChunkPropagationOK[iTrack]) {
+              fillDcaQA(track, mChunkTrackParCov[iTrack], mChunkDcaInfoCov[iTrack], registry);
+            }
+          }
+          fillTrackRow(track, mChunkTrackTypes[iTrack], mChunkTrackParCov[iTrack], mChunkDcaInfoCov[iTrack], cursors);
+        } else {
+          fillTrackRow(track, mChunkTrackTypes[iTrack], mChunkTrackPar[iTrack], mChunkDcaInfo[iTrack], cursors);
+        }
+        iTrack++;
+      }
+      return;
+    }
+
     for (const auto& track : tracks) {
       if (fillTracksCov) {
-        if (fillTracksDCA || fillTracksDCACov) {
-          mDcaInfoCov.set(999, 999, 999, 999, 999);
-        }
-        setTrackParCov(track, mTrackParCov);
-        if (cGroup.useTrkPid.value) {
-          mTrackParCov.setPID(track.pidForTracking());
-        }
+        initTrack(cGroup, track, mTrackParCov, mDcaInfoCov);
       } else {
-        if (fillTracksDCA) {
-          mDcaInfo[0] = 999;
-          mDcaInfo[1] = 999;
-        }
-        setTrackPar(track, mTrackPar);
-        if (cGroup.useTrkPid.value) {
-          mTrackPar.setPID(track.pidForTracking());
-        }
+        initTrack(cGroup, track, mTrackPar, mDcaInfo);
       }
       // auto trackParCov = getTrackParCov(track);
       o2::aod::track::TrackTypeEnum trackType = (o2::aod::track::TrackTypeEnum)track.trackType();
       // std::array<float, 3> trackPxPyPz;
       // std::array<float, 3> trackPxPyPzTuned = {0.0, 0.0, 0.0};
       double q2OverPtNew = -9999.;
-      // Only propagate tracks which have passed the innermost wall of the TPC (e.g. skipping loopers etc). Others fill unpropagated.
-      if (track.trackType() == o2::aod::track::TrackIU && track.x() < cGroup.minPropagationRadius.value) {
+      if (isPropagationRequired(cGroup, track)) {
         if (fillTracksCov) {
           if constexpr (isMc) { // checking MC and fillCovMat block begins
             // bool hasMcParticle = track.has_mcParticle();
@@ -287,41 +306,15 @@ class TrackPropagationModule
             }
           } // MC and fillCovMat block ends
         }
-        bool isPropagationOK = true;
-
-        if (track.has_collision()) {
-          auto const& collision = collisions.rawIteratorAt(track.collisionId());
-          if (fillTracksCov) {
-            mVtx.setPos({collision.posX(), collision.posY(), collision.posZ()});
-            mVtx.setCov(collision.covXX(), collision.covXY(), collision.covYY(), collision.covXZ(), collision.covYZ(), collision.covZZ());
-            isPropagationOK = o2::base::Propagator::Instance()->propagateToDCABxByBz(mVtx, mTrackParCov, 2.f, matCorr, &mDcaInfoCov);
-          } else {
-            isPropagationOK = o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, mTrackPar, 2.f, matCorr, &mDcaInfo);
-          }
-        } else {
-          if (fillTracksCov) {
-            mVtx.setPos({ccdbLoader.mMeanVtx->getX(), ccdbLoader.mMeanVtx->getY(), ccdbLoader.mMeanVtx->getZ()});
-            mVtx.setCov(ccdbLoader.mMeanVtx->getSigmaX() * ccdbLoader.mMeanVtx->getSigmaX(), 0.0f, ccdbLoader.mMeanVtx->getSigmaY() * ccdbLoader.mMeanVtx->getSigmaY(), 0.0f, 0.0f, ccdbLoader.mMeanVtx->getSigmaZ() * ccdbLoader.mMeanVtx->getSigmaZ());
-            isPropagationOK = o2::base::Propagator::Instance()->propagateToDCABxByBz(mVtx, mTrackParCov, 2.f, matCorr, &mDcaInfoCov);
-          } else {
-            isPropagationOK = o2::base::Propagator::Instance()->propagateToDCABxByBz({ccdbLoader.mMeanVtx->getX(), ccdbLoader.mMeanVtx->getY(), ccdbLoader.mMeanVtx->getZ()}, mTrackPar, 2.f, matCorr, &mDcaInfo);
-          }
-        }
+        bool isPropagationOK = fillTracksCov ? propagateToVertex(ccdbLoader, collisions, track, mTrackParCov, mDcaInfoCov, mVtx) : propagateToVertex(ccdbLoader, collisions, track, mTrackPar, mDcaInfo);
         if (isPropagationOK) {
           trackType = o2::aod::track::Track;
         }
         // filling some QA histograms for track tuner test purpose
         if (fillTracksCov) {
           if constexpr (isMc) { // checking MC and fillCovMat block begins
-            if (track.has_mcParticle() && isPropagationOK) {
-              auto mcParticle1 = track.mcParticle();
-              // && abs(mcParticle1.pdgCode())==211
-              if (mcParticle1.isPhysicalPrimary()) {
-                registry.fill(HIST("hDCAxyVsPtRec"), mDcaInfoCov.getY(), mTrackParCov.getPt());
-                registry.fill(HIST("hDCAxyVsPtMC"), mDcaInfoCov.getY(), mcParticle1.pt());
-                registry.fill(HIST("hDCAzVsPtRec"), mDcaInfoCov.getZ(), mTrackParCov.getPt());
-                registry.fill(HIST("hDCAzVsPtMC"), mDcaInfoCov.getZ(), mcParticle1.pt());
-              }
+            if (isPropagationOK) {
+              fillDcaQA(track, mTrackParCov, mDcaInfoCov, registry);
             }
           } // MC and fillCovMat block ends
         }
@@ -332,28 +325,178 @@ class TrackPropagationModule
       }
       // LOG(info) <<  " trackPropagation (this value filled in tuner table)--> "  << q2OverPtNew;
       if (fillTracksCov) {
-        cursors.tracksParPropagated(track.collisionId(), trackType, mTrackParCov.getX(), mTrackParCov.getAlpha(), mTrackParCov.getY(), mTrackParCov.getZ(), mTrackParCov.getSnp(), mTrackParCov.getTgl(), mTrackParCov.getQ2Pt());
-        cursors.tracksParExtensionPropagated(mTrackParCov.getPt(), mTrackParCov.getP(), mTrackParCov.getEta(), mTrackParCov.getPhi());
-        // TODO do we keep the rho as 0? Also the sigma's are duplicated information
-        cursors.tracksParCovPropagated(std::sqrt(mTrackParCov.getSigmaY2()), std::sqrt(mTrackParCov.getSigmaZ2()), std::sqrt(mTrackParCov.getSigmaSnp2()),
-                                       std::sqrt(mTrackParCov.getSigmaTgl2()), std::sqrt(mTrackParCov.getSigma1Pt2()), 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
-        cursors.tracksParCovExtensionPropagated(mTrackParCov.getSigmaY2(), mTrackParCov.getSigmaZY(), mTrackParCov.getSigmaZ2(), mTrackParCov.getSigmaSnpY(),
-                                                mTrackParCov.getSigmaSnpZ(), mTrackParCov.getSigmaSnp2(), mTrackParCov.getSigmaTglY(), mTrackParCov.getSigmaTglZ(), mTrackParCov.getSigmaTglSnp(),
-                                                mTrackParCov.getSigmaTgl2(), mTrackParCov.getSigma1PtY(), mTrackParCov.getSigma1PtZ(), mTrackParCov.getSigma1PtSnp(), mTrackParCov.getSigma1PtTgl(),
-                                                mTrackParCov.getSigma1Pt2());
-        if (fillTracksDCA) {
-          cursors.tracksDCA(mDcaInfoCov.getY(), mDcaInfoCov.getZ());
-        }
-        if (fillTracksDCACov) {
-          cursors.tracksDCACov(mDcaInfoCov.getSigmaY2(), mDcaInfoCov.getSigmaZ2());
-        }
+        fillTrackRow(track, trackType, mTrackParCov, mDcaInfoCov, cursors);
       } else {
-        cursors.tracksParPropagated(track.collisionId(), trackType, mTrackPar.getX(), mTrackPar.getAlpha(), mTrackPar.getY(), mTrackPar.getZ(), mTrackPar.getSnp(), mTrackPar.getTgl(), mTrackPar.getQ2Pt());
-        cursors.tracksParExtensionPropagated(mTrackPar.getPt(), mTrackPar.getP(), mTrackPar.getEta(), mTrackPar.getPhi());
-        if (fillTracksDCA) {
-          cursors.tracksDCA(mDcaInfo[0], mDcaInfo[1]);
+        fillTrackRow(track, trackType, mTrackPar, mDcaInfo, cursors);
+      }
+    }
+  }
+
+ private:
+  // buffers of the chunked propagation, reused across time frames
+  std::vector<o2::track::TrackParametrization<float>> mChunkTrackPar;
+  std::vector<o2::track::TrackParametrizationWithError<float>> mChunkTrackParCov;
+  std::vector<std::array<float, 2>> mChunkDcaInfo;
+  std::vector<o2::dataformats::DCA> mChunkDcaInfoCov;
+  std::vector<o2::aod::track::TrackTypeEnum> mChunkTrackTypes;
+  std::vector<uint8_t> mChunkPropagationOK;
+
+  template <typename TConfigurableGroup, typename TTrack>
+  static bool isPropagationRequired(TConfigurableGroup const& cGroup, TTrack const& track)
+  {
+    // Only propagate tracks which have passed the innermost wall of the TPC (e.g. skipping loopers etc). Others fill unpropagated.
+    if (track.trackType() != o2::aod::track::TrackIU || track.x() >= cGroup.minPropagationRadius.value) {
+      return false;
+    }
+    // optional prefilter on the parameters at the innermost update: tracks failing it skip the propagation as well
+    if (cGroup.minPtPropagation.value > 0.f && track.pt() < cGroup.minPtPropagation.value) {
+      return false;
+    }
+    if (cGroup.maxAbsEtaPropagation.value >= 0.f && std::abs(track.eta()) > cGroup.maxAbsEtaPropagation.value) {
+      return false;
+    }
+    return true;
+  }
+
+  template <typename TConfigurableGroup, typename TTrack>
+  static void initTrack(TConfigurableGroup const& cGroup, TTrack const& track, o2::track::TrackParametrizationWithError<float>& trackParCov, o2::dataformats::DCA& dcaInfoCov)
+  {
+    dcaInfoCov.set(999, 999, 999, 999, 999);
+    setTrackParCov(track, trackParCov);
+    if (cGroup.useTrkPid.value) {
+      trackParCov.setPID(track.pidForTracking());
+    }
+  }
+
+  template <typename TConfigurableGroup, typename TTrack>
+  static void initTrack(TConfigurableGroup const& cGroup, TTrack const& track, o2::track::TrackParametrization<float>& trackPar, std::array<float, 2>& dcaInfo)
+  {
+    dcaInfo[0] = 999;
+    dcaInfo[1] = 999;
+    setTrackPar(track, trackPar);
+    if (cGroup.useTrkPid.value) {
+      trackPar.setPID(track.pidForTracking());
+    }
+  }
+
+  // propagation to the collision of the track, or to the mean vertex if the track is not assigned to a collision
+  template <typename TCCDBLoader, typename TCollisions, typename TTrack>
+  bool propagateToVertex(TCCDBLoader const& ccdbLoader, TCollisions const& collisions, TTrack const& track, o2::track::TrackParametrizationWithError<float>& trackParCov, o2::dataformats::DCA& dcaInfoCov, o2::dataformats::VertexBase& vtx) const
+  {
+    if (track.has_collision()) {
+      auto const& collision = collisions.rawIteratorAt(track.collisionId());
+      vtx.setPos({collision.posX(), collision.posY(), collision.posZ()});
+      vtx.setCov(collision.covXX(), collision.covXY(), collision.covYY(), collision.covXZ(), collision.covYZ(), collision.covZZ());
+    } else {
+      vtx.setPos({ccdbLoader.mMeanVtx->getX(), ccdbLoader.mMeanVtx->getY(), ccdbLoader.mMeanVtx->getZ()});
+      vtx.setCov(ccdbLoader.mMeanVtx->getSigmaX() * ccdbLoader.mMeanVtx->getSigmaX(), 0.0f, ccdbLoader.mMeanVtx->getSigmaY() * ccdbLoader.mMeanVtx->getSigmaY(), 0.0f, 0.0f, ccdbLoader.mMeanVtx->getSigmaZ() * ccdbLoader.mMeanVtx->getSigmaZ());
+    }
+    return o2::base::Propagator::Instance()->propagateToDCABxByBz(vtx, trackParCov, 2.f, matCorr, &dcaInfoCov);
+  }
+
+  template <typename TCCDBLoader, typename TCollisions, typename TTrack>
+  bool propagateToVertex(TCCDBLoader const& ccdbLoader, TCollisions const& collisions, TTrack const& track, o2::track::TrackParametrization<float>& trackPar, std::array<float, 2>& dcaInfo) const
+  {
+    if (track.has_collision()) {
+      auto const& collision = collisions.rawIteratorAt(track.collisionId());
+      return o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackPar, 2.f, matCorr, &dcaInfo);
+    }
+    return o2::base::Propagator::Instance()->propagateToDCABxByBz({ccdbLoader.mMeanVtx->getX(), ccdbLoader.mMeanVtx->getY(), ccdbLoader.mMeanVtx->getZ()}, trackPar, 2.f, matCorr, &dcaInfo);
+  }
+
+  // The tracks are split in chunks of consecutive tracks, handed out to the workers one at a time.
+  // The workers share the propagator (propagateToDCABxByBz is const and the material LUT is read-only) and have their own vertex;
+  // results are written at the index of the track, so that the tables can be filled in order afterwards
+  template <typename TConfigurableGroup, typename TCCDBLoader, typename TCollisions, typename TTracks>
+  void propagateTracksInChunks(TConfigurableGroup const& cGroup, TCCDBLoader const& ccdbLoader, TCollisions const& collisions, TTracks const& tracks, int nThreads)
+  {
+    const int64_t nTracks = tracks.size();
+    const int64_t chunkSize = std::max(1, cGroup.chunkSize.value);
+    mChunkTrackTypes.resize(nTracks);
+    mChunkPropagationOK.resize(nTracks);
+    if (fillTracksCov) {
+      mChunkTrackParCov.resize(nTracks);
+      mChunkDcaInfoCov.resize(nTracks);
+    } else {
+      mChunkTrackPar.resize(nTracks);
+      mChunkDcaInfo.resize(nTracks);
+    }
+
+    std::atomic<int64_t> nextChunk{0};
+    auto worker = [&]() {
+      o2::dataformats::VertexBase vtx;
+      for (int64_t first = nextChunk++ * chunkSize; first < nTracks; first = nextChunk++ * chunkSize) {
+        const int64_t last = std::min(first + chunkSize, nTracks);
+        for (int64_t iTrack = first; iTrack < last; iTrack++) {
+          auto track = tracks.rawIteratorAt(iTrack);
+          bool isPropagationOK = false;
+          if (fillTracksCov) {
+            initTrack(cGroup, track, mChunkTrackParCov[iTrack], mChunkDcaInfoCov[iTrack]);
+            isPropagationOK = isPropagationRequired(cGroup, track) && propagateToVertex(ccdbLoader, collisions, track, mChunkTrackParCov[iTrack], mChunkDcaInfoCov[iTrack], vtx);
+          } else {
+            initTrack(cGroup, track, mChunkTrackPar[iTrack], mChunkDcaInfo[iTrack]);
+            isPropagationOK = isPropagationRequired(cGroup, track) && propagateToVertex(ccdbLoader, collisions, track, mChunkTrackPar[iTrack], mChunkDcaInfo[iTrack]);
+          }
+          mChunkPropagationOK[iTrack] = isPropagationOK;
+          mChunkTrackTypes[iTrack] = isPropagationOK ? o2::aod::track::Track : (o2::aod::track::TrackTypeEnum)track.trackType();
         }
       }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(nThreads - 1);
+    for (int iThread = 1; iThread < nThreads; iThread++) {
+      threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  // filling some QA histograms for track tuner test purpose
+  template <typename TTrack, typename THistoRegistry>
+  static void fillDcaQA(TTrack const& track, o2::track::TrackParametrizationWithError<float> const& trackParCov, o2::dataformats::DCA const& dcaInfoCov, THistoRegistry& registry)
+  {
+    if (!track.has_mcParticle()) {
+      return;
+    }
+    auto mcParticle1 = track.mcParticle();
+    // && abs(mcParticle1.pdgCode())==211
+    if (mcParticle1.isPhysicalPrimary()) {
+      registry.fill(HIST("hDCAxyVsPtRec"), dcaInfoCov.getY(), trackParCov.getPt());
+      registry.fill(HIST("hDCAxyVsPtMC"), dcaInfoCov.getY(), mcParticle1.pt());
+      registry.fill(HIST("hDCAzVsPtRec"), dcaInfoCov.getZ(), trackParCov.getPt());
+      registry.fill(HIST("hDCAzVsPtMC"), dcaInfoCov.getZ(), mcParticle1.pt());
+    }
+  }
+
+  template <typename TTrack, typename TOutputGroup>
+  void fillTrackRow(TTrack const& track, o2::aod::track::TrackTypeEnum trackType, o2::track::TrackParametrizationWithError<float> const& trackParCov, o2::dataformats::DCA const& dcaInfoCov, TOutputGroup& cursors) const
+  {
+    cursors.tracksParPropagated(track.collisionId(), trackType, trackParCov.getX(), trackParCov.getAlpha(), trackParCov.getY(), trackParCov.getZ(), trackParCov.getSnp(), trackParCov.getTgl(), trackParCov.getQ2Pt());
+    cursors.tracksParExtensionPropagated(trackParCov.getPt(), trackParCov.getP(), trackParCov.getEta(), trackParCov.getPhi());
+    // TODO do we keep the rho as 0? Also the sigma's are duplicated information
+    cursors.tracksParCovPropagated(std::sqrt(trackParCov.getSigmaY2()), std::sqrt(trackParCov.getSigmaZ2()), std::sqrt(trackParCov.getSigmaSnp2()),
+                                   std::sqrt(trackParCov.getSigmaTgl2()), std::sqrt(trackParCov.getSigma1Pt2()), 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    cursors.tracksParCovExtensionPropagated(trackParCov.getSigmaY2(), trackParCov.getSigmaZY(), trackParCov.getSigmaZ2(), trackParCov.getSigmaSnpY(),
+                                            trackParCov.getSigmaSnpZ(), trackParCov.getSigmaSnp2(), trackParCov.getSigmaTglY(), trackParCov.getSigmaTglZ(), trackParCov.getSigmaTglSnp(),
+                                            trackParCov.getSigmaTgl2(), trackParCov.getSigma1PtY(), trackParCov.getSigma1PtZ(), trackParCov.getSigma1PtSnp(), trackParCov.getSigma1PtTgl(),
+                                            trackParCov.getSigma1Pt2());
+    if (fillTracksDCA) {
+      cursors.tracksDCA(dcaInfoCov.getY(), dcaInfoCov.getZ());
+    }
+    if (fillTracksDCACov) {
+      cursors.tracksDCACov(dcaInfoCov.getSigmaY2(), dcaInfoCov.getSigmaZ2());
+    }
+  }
+
+  template <typename TTrack, typename TOutputGroup>
+  void fillTrackRow(TTrack const& track, o2::aod::track::TrackTypeEnum trackType, o2::track::TrackParametrization<float> const& trackPar, std::array<float, 2> const& dcaInfo, TOutputGroup& cursors) const
+  {
+    cursors.tracksParPropagated(track.collisionId(), trackType, trackPar.getX(), trackPar.getAlpha(), trackPar.getY(), trackPar.getZ(), trackPar.getSnp(), trackPar.getTgl(), trackPar.getQ2Pt());
+    cursors.tracksParExtensionPropagated(trackPar.getPt(), trackPar.getP(), trackPar.getEta(), trackPar.getPhi());
+    if (fillTracksDCA) {
+      cursors.tracksDCA(dcaInfo[0], dcaInfo[1]);
     }
   }
 };
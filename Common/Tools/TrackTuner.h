@@ -37,6 +37,7 @@
 #include <fmt/format.h>
 
 #include <algorithm>
+#include <array>
 #include <cstdint>
 #include <map>
 #include <memory>
@@ -59,6 +60,53 @@ DECLARE_SOA_TABLE(TrackTunerTable, "AOD", "TRACKTUNERTABLE", //!
                   track_tuner::TunedQOverPt);
 } // namespace o2::aod
 
+/// Piecewise-linear copy of a calibration graph, filled once when the graphs are loaded.
+/// eval() gives the same as TrackTuner::evalGraph(): linear interpolation between the points,
+/// value of the first (last) point below (above) the graph range
+struct TrackTunerFlatGraph {
+  std::vector<double> x;
+  std::vector<double> y;
+  std::vector<double> slope; // slope of the segment starting at each point
+
+  void set(const TGraphErrors* graph)
+  {
+    x.clear();
+    y.clear();
+    slope.clear();
+    if (!graph || graph->GetN() == 0) {
+      return;
+    }
+    const int nPoints = graph->GetN();
+    std::vector<int> order(nPoints);
+    for (int i = 0; i < nPoints; ++i) {
+      order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [graph](int a, int b) { return graph->GetX()[a] < graph->GetX()[b]; });
+    for (const int i : order) {
+      x.push_back(graph->GetX()[i]);
+      y.push_back(graph->GetY()[i]);
+    }
+    slope.resize(nPoints, 0.);
+    for (int i = 0; i < nPoints - 1; ++i) {
+      if (x[i + 1] > x[i]) {
+        slope[i] = (y[i + 1] - y[i]) / (x[i + 1] - x[i]);
+      }
+    }
+  }
+
+  double eval(double xValue) const
+  {
+    if (x.empty()) {
+      LOG(fatal) << "\t TrackTunerFlatGraph::eval fails, the graph is not set !\n";
+      return 0.;
+    }
+    const double xClamped = std::clamp(xValue, x.front(), x.back());
+    // first point of the segment containing xClamped, the last point is reached only for a single-point graph
+    const size_t i = x.size() > 1 ? std::upper_bound(x.begin() + 1, x.end() - 1, xClamped) - x.begin() - 1 : 0;
+    return y[i] + (xClamped - x[i]) * slope[i];
+  }
+};
+
 struct TrackTuner : o2::framework::ConfigurableGroup {
 
   std::string prefix = "trackTuner"; // JSON group name
@@ -126,6 +174,22 @@ struct TrackTuner : o2::framework::ConfigurableGroup {
   std::vector<std::unique_ptr<TGraphErrors>> grDcaZPullVsPtPionMC;
   std::vector<std::unique_ptr<TGraphErrors>> grDcaZPullVsPtPionData;
 
+  /// flat copies of the graphs above, evaluated per track
+  enum DcaGraphTable : int { DcaXYResMC = 0,
+                             DcaXYResData,
+                             DcaZResMC,
+                             DcaZResData,
+                             DcaXYMeanMC,
+                             DcaXYMeanData,
+                             DcaXYPullMC,
+                             DcaXYPullData,
+                             DcaZPullMC,
+                             DcaZPullData,
+                             NDcaGraphTables };
+  std::vector<std::array<TrackTunerFlatGraph, NDcaGraphTables>> dcaGraphTables; // [phi bin][graph]
+  TrackTunerFlatGraph oneOverPtPionMCTable;
+  TrackTunerFlatGraph oneOverPtPionDataTable;
+
   /// @brief Function to initialize the run number to that of the 1st considered bunch crossing (useful only if autoDetectDcaCalib = true)
   void setRunNumber(int n)
   {
@@ -694,6 +758,24 @@ struct TrackTuner : o2::framework::ConfigurableGroup {
       grOneOverPtPionData.reset(dynamic_cast<TGraphErrors*>(ccdb_object_qoverpt->FindObject(grOneOverPtPionNameData.c_str())));
     }
 
+    /// convert the graphs into flat tables once, the TGraph::Eval linear search is avoided per track
+    dcaGraphTables.resize(nPhiBins);
+    for (int iPhiBin = 0; iPhiBin < nPhiBins; ++iPhiBin) {
+      auto& tables = dcaGraphTables[iPhiBin];
+      tables[DcaXYResMC].set(grDcaXYResVsPtPionMC[iPhiBin].get());
+      tables[DcaXYResData].set(grDcaXYResVsPtPionData[iPhiBin].get());
+      tables[DcaZResMC].set(grDcaZResVsPtPionMC[iPhiBin].get());
+      tables[DcaZResData].set(grDcaZResVsPtPionData[iPhiBin].get());
+      tables[DcaXYMeanMC].set(grDcaXYMeanVsPtPionMC[iPhiBin].get());
+      tables[DcaXYMeanData].set(grDcaXYMeanVsPtPionData[iPhiBin].get());
+      tables[DcaXYPullMC].set(grDcaXYPullVsPtPionMC[iPhiBin].get());
+      tables[DcaXYPullData].set(grDcaXYPullVsPtPionData[iPhiBin].get());
+      tables[DcaZPullMC].set(grDcaZPullVsPtPionMC[iPhiBin].get());
+      tables[DcaZPullData].set(grDcaZPullVsPtPionData[iPhiBin].get());
+    }
+    oneOverPtPionMCTable.set(grOneOverPtPionMC.get());
+    oneOverPtPionDataTable.set(grOneOverPtPionData.get());
+
     /// if we arrive here, it means that the graphs are all set
     areGraphsConfigured = true;
 
@@ -729,11 +811,12 @@ struct TrackTuner : o2::framework::ConfigurableGroup {
       phiMC += o2::constants::math::TwoPI;                                    // 2 * std::numbers::pi;//
     int phiBin = phiMC / (o2::constants::math::TwoPI + 0.0000001) * nPhiBins; // 0.0000001 just a numerical protection
 
-    dcaXYResMC = evalGraph(ptMC, grDcaXYResVsPtPionMC[phiBin].get());
-    dcaXYResData = evalGraph(ptMC, grDcaXYResVsPtPionData[phiBin].get());
+    const auto& tables = dcaGraphTables[phiBin];
+    dcaXYResMC = tables[DcaXYResMC].eval(ptMC);
+    dcaXYResData = tables[DcaXYResData].eval(ptMC);
 
-    dcaZResMC = evalGraph(ptMC, grDcaZResVsPtPionMC[phiBin].get());
-    dcaZResData = evalGraph(ptMC, grDcaZResVsPtPionData[phiBin].get());
+    dcaZResMC = tables[DcaZResMC].eval(ptMC);
+    dcaZResData = tables[DcaZResData].eval(ptMC);
 
     // For Q/Pt corrections, files on CCDB will be used if both qOverPtMC and qOverPtData are null
     if (updateCurvature || updateCurvatureIU) {
@@ -745,21 +828,21 @@ struct TrackTuner : o2::framework::ConfigurableGroup {
         if (!grOneOverPtPionData.get() || !grOneOverPtPionMC.get()) {
           LOG(fatal) << "### q/pt smearing: input graphs not correctly retrieved. Aborting.";
         }
-        qOverPtMC = std::max(0.0, evalGraph(ptMC, grOneOverPtPionMC.get()));
-        qOverPtData = std::max(0.0, evalGraph(ptMC, grOneOverPtPionData.get()));
+        qOverPtMC = std::max(0.0, oneOverPtPionMCTable.eval(ptMC));
+        qOverPtData = std::max(0.0, oneOverPtPionDataTable.eval(ptMC));
       } // qOverPtMC, qOverPtData block ends here
     } // updateCurvature, updateCurvatureIU block ends here
 
     if (updateTrackDCAs) {
 
-      dcaXYMeanMC = evalGraph(ptMC, grDcaXYMeanVsPtPionMC[phiBin].get());
-      dcaXYMeanData = evalGraph(ptMC, grDcaXYMeanVsPtPionData[phiBin].get());
+      dcaXYMeanMC = tables[DcaXYMeanMC].eval(ptMC);
+      dcaXYMeanData = tables[DcaXYMeanData].eval(ptMC);
 
-      dcaXYPullMC = evalGraph(ptMC, grDcaXYPullVsPtPionMC[phiBin].get());
-      dcaXYPullData = evalGraph(ptMC, grDcaXYPullVsPtPionData[phiBin].get());
+      dcaXYPullMC = tables[DcaXYPullMC].eval(ptMC);
+      dcaXYPullData = tables[DcaXYPullData].eval(ptMC);
 
-      dcaZPullMC = evalGraph(ptMC, grDcaZPullVsPtPionMC[phiBin].get());
-      dcaZPullData = evalGraph(ptMC, grDcaZPullVsPtPionData[phiBin].get());
+      dcaZPullMC = tables[DcaZPullMC].eval(ptMC);
+      dcaZPullData = tables[DcaZPullData].eval(ptMC);
     }
     //  Unit conversion, is it required ??
     dcaXYResMC *= 1.e-4;
@@ -31,6 +31,7 @@
 #include "Common/Core/TrackSelection.h"
 #include "Common/Core/TrackSelectionDefaults.h"
 #include "Common/DataModel/TrackSelectionTables.h"
+#include "Common/TableProducer/PID/pidTPCBase.h"
 #include "Common/DataModel/Multiplicity.h"
 #include "Common/DataModel/Centrality.h"
 #include "DataFormatsParameters/AggregatedRunInfo.h"
@@ -167,12 +168,14 @@ struct dEdxVsOccupancyWithTrackQAinfoTask {
   {
     return ((0.017012 * mbb0R1) + (-0.0018469 * a1pt) + (-0.0052177 * atgl) + (-0.0035655 * atglmbb0R1) + (0.0017846 * a1ptmbb0R1) + (0.0019127 * side) + (-0.00012964 * a1pt2) + (0.013066)) * fTrackOccN + ((0.0055592 * mbb0R1) + (-0.0010618 * a1pt) + (-0.0016134 * atgl) + (-0.0059098 * atglmbb0R1) + (0.0013335 * a1ptmbb0R1) + (0.00052133 * side) + (3.1119e-05 * a1pt2) + (0.0049428)) * fOccTPCN + ((0.00077317 * mbb0R1) + (-0.0013827 * a1pt) + (0.003249 * atgl) + (-0.00063689 * atglmbb0R1) + (0.0016218 * a1ptmbb0R1) + (-0.00045215 * side) + (-1.5815e-05 * a1pt2) + (-0.004882)) * fTrackOccMeanN + ((-0.015053 * mbb0R1) + (0.0018912 * a1pt) + (-0.012305 * atgl) + (0.081387 * atglmbb0R1) + (0.003205 * a1ptmbb0R1) + (-0.0087404 * side) + (-0.0028608 * a1pt2) + (0.99091));
   };
-  void processRun3(
+  // the occupancy corrected dE/dx is either computed here or taken from the DEdxsCorrected table of the TPC PID base task
+  template <bool useDeDxCorrectedTable, typename TTracks, typename TPreslice>
+  void runOccupancyVsDeDxQa(
     ColEvSels const& cols,
-    FullTracksIU const& tracks,
+    TTracks const& tracks,
     BCsRun3 const& bcs,
     aod::TracksQA_002 const& tracksQA,
-    aod::FT0s const&)
+    TPreslice const& perCollisionTracks)
   {
     int runNumber = bcs.iteratorAt(0).runNumber();
     if (runNumber != lastRunNumber) {
@@ -206,12 +209,12 @@ struct dEdxVsOccupancyWithTrackQAinfoTask {
       // check hadronic rate
       auto bc = col.foundBC_as<BCsRun3>();
       int64_t ts = bc.timestamp();
-      double hadronicRate = mRateFetcher.fetch(ccdb.service, ts, runNumber, "ZNC hadronic") * 1.e-3; // kHz
-      const int multTPC = col.multTPC();
+      [[maybe_unused]] double hadronicRate = useDeDxCorrectedTable ? 0. : mRateFetcher.fetch(ccdb.service, ts, runNumber, "ZNC hadronic") * 1.e-3; // kHz, only needed by the dE/dx correction
+      [[maybe_unused]] const int multTPC = col.multTPC();
 
       int occupancy = col.trackOccupancyInTimeRange();
 
-      auto tracksGrouped = tracks.sliceBy(perCollision, col.globalIndex());
+      auto tracksGrouped = tracks.sliceBy(perCollisionTracks, col.globalIndex());
 
       // pre-calc nPV
       int nPV = 0;
@@ -377,72 +380,77 @@ struct dEdxVsOccupancyWithTrackQAinfoTask {
 
         // ### dE/dx by Marian:
         float fTPCSignal = track.tpcSignal();
-        float fNormMultTPC = multTPC / 11000.; // IA: my guess: it's https://github.com/AliceO2Group/O2Physics/blob/f681d9cc71214c4eb5613a3f473cbea41e48a61f/DPG/Tasks/TPC/tpcSkimsTableCreator.cxx#L575C30-L575C47
-
-        // df["mdEdx"]=(50/df["fTPCSignal"]).clip(0.05,1.1)
-        // df["fTPCSignalN"]=(df["fTPCSignal"]/df["bb0"]/50.).clip(0.5,1.5)
-        // df["fTrackOccN"]=df.eval("fTrackOcc/1000.")
-        // df["mdEdxExp"]=df.eval("1./bb0")
-        // df["fFt0OccN"]=df["fFt0Occ"]*df.eval("fFt0Occ/fTrackOcc").median()
-        // df["mdEdxExpOcc"]=df.eval("mdEdxExp*fTrackOccN")
-        // df["fTrackOccMeanN"]=(df["fHadronicRate"]/5)                 # normalization 5 - 10 bins
-        // df["fTrackOccN2"]=df.eval("fTrackOccN*fTrackOccN")
-        // df["fOccTPCN"]=(df["fNormMultTPC"]*10).clip(0,12)           # normalization 10 - 12 bins
-        // df["mdEdxOccTPCN"]=df.eval("mdEdx*fOccTPCN")
-        // df["mdEdxMeanOccTPCN"]=df.eval("mdEdx*fTrackOccMeanN")
-
-        float fTrackOccN = occupancy / 1000.;
-        float fOccTPCN = fNormMultTPC * 10; //(fNormMultTPC*10).clip(0,12)
-        if (fOccTPCN > 12)
-          fOccTPCN = 12;
-        else if (fOccTPCN < 0)
-          fOccTPCN = 0;
-
-        float fTrackOccMeanN = hadronicRate / 5;
-
-        float side = track.tgl() > 0 ? 1 : 0;
-        float a1pt = std::abs(track.signed1Pt());
-        float a1pt2 = a1pt * a1pt;
-        float atgl = std::abs(track.tgl());
-        float mbb0R = 50 / fTPCSignal;
-        if (mbb0R > 1.05)
-          mbb0R = 1.05;
-        else if (mbb0R < 0.05)
-          mbb0R = 0.05;
-        // float mbb0R =  max(0.05,  min(50 / fTPCSignal, 1.05));
-        float a1ptmbb0R = a1pt * mbb0R;
-        float atglmbb0R = atgl * mbb0R;
-
-        // tree->SetAlias("side","fTgl>0");
-        // tree->SetAlias("a1pt","abs(fSigned1Pt)");
-        // tree->SetAlias("a1pt2","abs(fSigned1Pt**2)");
-        // tree->SetAlias("atgl","abs(fTgl)");
-        // tree->SetAlias("mbb0R","max(0.05,min(50/fTPCSignal,1.05))");
-        // tree->SetAlias("a1ptmbb0R","a1pt*mbb0R");
-        // tree->SetAlias("atglmbb0R","atgl*mbb0R");
-
-        // ### iteration 1 correction
-        // float fTPCSignalN_CBB = fReal_fTPCSignalN(mbb0,a1pt,atgl,atglmbb0,a1ptmbb0,side,a1pt2,fTrackOccN,fOccTPCN,fTrackOccMeanN+0); // atglmbb0 is != atglmbb0R!!! etc.
-        float fTPCSignalN_CR0 = fReal_fTPCSignalN(mbb0R, a1pt, atgl, atglmbb0R, a1ptmbb0R, side, a1pt2, fTrackOccN, fOccTPCN, fTrackOccMeanN + 0);
-
-        // tree->SetAlias("fTPCSignalN_CBB","fReal_fTPCSignalN(mbb0,a1pt,atgl,atglmbb0,a1ptmbb0,side,a1pt2,fTrackOccN,fOccTPCN,fTrackOccMeanN+0)");
-        // tree->SetAlias("fTPCSignalN_CR0","fReal_fTPCSignalN(mbb0R,a1pt,atgl,atglmbb0R,a1ptmbb0R,side,a1pt2,fTrackOccN,fOccTPCN,fTrackOccMeanN+0)");
-
-        float mbb0R1 = 50 / (fTPCSignal / fTPCSignalN_CR0);
-        if (mbb0R1 > 1.05)
-          mbb0R1 = 1.05;
-        else if (mbb0R1 < 0.05)
-          mbb0R1 = 0.05;
-        // float mbb0R1 = max(0.05, min(50 / (fTPCSignal / fTPCSignalN_CR0), 1.05 + 0));
-        // tree->SetAlias("mbb0R1","max(0.05,min(50/(fTPCSignal/fTPCSignalN_CR0),1.05+0))");
-        float fTPCSignalN_CR1 = fReal_fTPCSignalN(mbb0R1, a1pt, atgl, atgl * mbb0R1, a1pt * mbb0R1, side, a1pt2, fTrackOccN, fOccTPCN, fTrackOccMeanN + 0);
-        // tree->SetAlias("fTPCSignalN_CR1","fReal_fTPCSignalN(mbb0R1,a1pt,atgl,atgl*mbb0R1,a1pt*mbb0R1,side,a1pt2,fTrackOccN,fOccTPCN,fTrackOccMeanN+0)");
-        //
-        // tree->SetAlias("fTPCSignalN_mad_BB","fReal_fTPCSignalN_mad(mbb0,a1pt,atgl,atglmbb0,a1ptmbb0,side,a1pt2,fTrackOccN,fOccTPCN,fTrackOccMeanN+0)");
-        // tree->SetAlias("fTPCSignalN_mad_R0","fReal_fTPCSignalN_mad(mbb0R1,a1pt,atgl,atgl*mbb0R1,a1pt*mbb0R1,side,a1pt2,fTrackOccN,fOccTPCN,fTrackOccMeanN+0)");
-        //
-        // tree->SetAlias("fTPCSignal_CorrR1","fTPCSignal/fTPCSignalN_CR1");
-        // tree->SetAlias("fTPCSignal_CorrBB","fTPCSignal/fTPCSignalN_CBB");
+        float fTPCSignalN_CR1 = 1.f;
+        if constexpr (useDeDxCorrectedTable) {
+          fTPCSignalN_CR1 = fTPCSignal / track.tpcSignalCorrected();
+        } else {
+          float fNormMultTPC = multTPC / 11000.; // IA: my guess: it's https://github.com/AliceO2Group/O2Physics/blob/f681d9cc71214c4eb5613a3f473cbea41e48a61f/DPG/Tasks/TPC/tpcSkimsTableCreator.cxx#L575C30-L575C47
+
+          // df["mdEdx"]=(50/df["fTPCSignal"]).clip(0.05,1.1)
+          // df["fTPCSignalN"]=(df["fTPCSignal"]/df["bb0"]/50.).clip(0.5,1.5)
+          // df["fTrackOccN"]=df.eval("fTrackOcc/1000.")
+          // df["mdEdxExp"]=df.eval("1./bb0")
+          // df["fFt0OccN"]=df["fFt0Occ"]*df.eval("fFt0Occ/fTrackOcc").median()
+          // df["mdEdxExpOcc"]=df.eval("mdEdxExp*fTrackOccN")
+          // df["fTrackOccMeanN"]=(df["fHadronicRate"]/5)                 # normalization 5 - 10 bins
+          // df["fTrackOccN2"]=df.eval("fTrackOccN*fTrackOccN")
+          // df["fOccTPCN"]=(df["fNormMultTPC"]*10).clip(0,12)           # normalization 10 - 12 bins
+          // df["mdEdxOccTPCN"]=df.eval("mdEdx*fOccTPCN")
+          // df["mdEdxMeanOccTPCN"]=df.eval("mdEdx*fTrackOccMeanN")
+
+          float fTrackOccN = occupancy / 1000.;
+          float fOccTPCN = fNormMultTPC * 10; //(fNormMultTPC*10).clip(0,12)
+          if (fOccTPCN > 12)
+            fOccTPCN = 12;
+          else if (fOccTPCN < 0)
+            fOccTPCN = 0;
+
+          float fTrackOccMeanN = hadronicRate / 5;
+
+          float side = track.tgl() > 0 ? 1 : 0;
+          float a1pt = std::abs(track.signed1Pt());
+          float a1pt2 = a1pt * a1pt;
+          float atgl = std::abs(track.tgl());
+          float mbb0R = 50 / fTPCSignal;
+          if (mbb0R > 1.05)
+            mbb0R = 1.05;
+          else if (mbb0R < 0.05)
+            mbb0R = 0.05;
+          // float mbb0R =  max(0.05,  min(50 / fTPCSignal, 1.05));
+          float a1ptmbb0R = a1pt * mbb0R;
+          float atglmbb0R = atgl * mbb0R;
+
+          // tree->SetAlias("side","fTgl>0");
+          // tree->SetAlias("a1pt","abs(fSigned1Pt)");
+          // tree->SetAlias("a1pt2","abs(fSigned1Pt**2)");
+          // tree->SetAlias("atgl","abs(fTgl)");
+          // tree->SetAlias("mbb0R","max(0.05,min(50/fTPCSignal,1.05))");
+          // tree->SetAlias("a1ptmbb0R","a1pt*mbb0R");
+          // tree->SetAlias("atglmbb0R","atgl*mbb0R");
+
+          // ### iteration 1 correction
+          // float fTPCSignalN_CBB = fReal_fTPCSignalN(mbb0,a1pt,atgl,atglmbb0,a1ptmbb0,side,a1pt2,fTrackOccN,fOccTPCN,fTrackOccMeanN+0); // atglmbb0 is != atglmbb0R!!! etc.
+          float fTPCSignalN_CR0 = fReal_fTPCSignalN(mbb0R, a1pt, atgl, atglmbb0R, a1ptmbb0R, side, a1pt2, fTrackOccN, fOccTPCN, fTrackOccMeanN + 0);
+
+          // tree->SetAlias("fTPCSignalN_CBB","fReal_fTPCSignalN(mbb0,a1pt,atgl,atglmbb0,a1ptmbb0,side,a1pt2,fTrackOccN,fOccTPCN,fTrackOccMeanN+0)");
+          // tree->SetAlias("fTPCSignalN_CR0","fReal_fTPCSignalN(mbb0R,a1pt,atgl,atglmbb0R,a1ptmbb0R,side,a1pt2,fTrackOccN,fOccTPCN,fTrackOccMeanN+0)");
+
+          float mbb0R1 = 50 / (fTPCSignal / fTPCSignalN_CR0);
+          if (mbb0R1 > 1.05)
+            mbb0R1 = 1.05;
+          else if (mbb0R1 < 0.05)
+            mbb0R1 = 0.05;
+          // float mbb0R1 = max(0.05, min(50 / (fTPCSignal / fTPCSignalN_CR0), 1.05 + 0));
+          // tree->SetAlias("mbb0R1","max(0.05,min(50/(fTPCSignal/fTPCSignalN_CR0),1.05+0))");
+          fTPCSignalN_CR1 = fReal_fTPCSignalN(mbb0R1, a1pt, atgl, atgl * mbb0R1, a1pt * mbb0R1, side, a1pt2, fTrackOccN, fOccTPCN, fTrackOccMeanN + 0);
+          // tree->SetAlias("fTPCSignalN_CR1","fReal_fTPCSignalN(mbb0R1,a1pt,atgl,atgl*mbb0R1,a1pt*mbb0R1,side,a1pt2,fTrackOccN,fOccTPCN,fTrackOccMeanN+0)");
+          //
+          // tree->SetAlias("fTPCSignalN_mad_BB","fReal_fTPCSignalN_mad(mbb0,a1pt,atgl,atglmbb0,a1ptmbb0,side,a1pt2,fTrackOccN,fOccTPCN,fTrackOccMeanN+0)");
+          // tree->SetAlias("fTPCSignalN_mad_R0","fReal_fTPCSignalN_mad(mbb0R1,a1pt,atgl,atgl*mbb0R1,a1pt*mbb0R1,side,a1pt2,fTrackOccN,fOccTPCN,fTrackOccMeanN+0)");
+          //
+          // tree->SetAlias("fTPCSignal_CorrR1","fTPCSignal/fTPCSignalN_CR1");
+          // tree->SetAlias("fTPCSignal_CorrBB","fTPCSignal/fTPCSignalN_CBB");
+        }
 
         histos.fill(HIST("dEdx_vs_Momentum"), signedP, fTPCSignal);
 
@@ -461,7 +469,30 @@ struct dEdxVsOccupancyWithTrackQAinfoTask {
       } // end of track loop
     } // end of collision loop
   }
+
+  void processRun3(
+    ColEvSels const& cols,
+    FullTracksIU const& tracks,
+    BCsRun3 const& bcs,
+    aod::TracksQA_002 const& tracksQA,
+    aod::FT0s const&)
+  {
+    runOccupancyVsDeDxQa<false>(cols, tracks, bcs, tracksQA, perCollision);
+  }
   PROCESS_SWITCH(dEdxVsOccupancyWithTrackQAinfoTask, processRun3, "Process Run3 tracking vs detector occupancy QA", true);
+
+  using FullTracksIUWithDeDxCorrected = soa::Join<FullTracksIU, aod::DEdxsCorrected>;
+  Preslice<FullTracksIUWithDeDxCorrected> perCollisionWithDeDxCorrected = aod::track::collisionId;
+  void processRun3WithDeDxCorrected(
+    ColEvSels const& cols,
+    FullTracksIUWithDeDxCorrected const& tracks,
+    BCsRun3 const& bcs,
+    aod::TracksQA_002 const& tracksQA,
+    aod::FT0s const&)
+  {
+    runOccupancyVsDeDxQa<true>(cols, tracks, bcs, tracksQA, perCollisionWithDeDxCorrected);
+  }
+  PROCESS_SWITCH(dEdxVsOccupancyWithTrackQAinfoTask, processRun3WithDeDxCorrected, "Process Run3 tracking vs detector occupancy QA, with the corrected dE/dx of the TPC PID base task", false);
 };
 
 WorkflowSpec defineDataProcessing(ConfigContext const& cfgc)
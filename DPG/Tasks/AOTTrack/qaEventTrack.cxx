@@ -45,6 +45,7 @@
 
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <cmath>
 #include <cstdint>
 #include <numeric>
@@ -76,6 +77,7 @@ struct qaEventTrack {
   Configurable<bool> isRun3{"isRun3", true, "Is Run3 dataset"}; // TODO: derive this from metadata once possible to get rid of the flag
   Configurable<bool> overwriteAxisRangeForPbPb{"overwriteAxisRangeForPbPb", false, "Global switch to easily set the most relaxed default axis ranges of multiplicity and PVcontribs for PbPb"};
   Configurable<bool> doDebug{"doDebug", false, "Bool to enable debug outputs"};
+  Configurable<int> sampleOneDFEvery{"sampleOneDFEvery", 1, "Online-style QA: fill the histograms only for one data frame every N (1 means all the data frames)"};
 
   // options to select specific events
   Configurable<bool> selectGoodEvents{"selectGoodEvents", true, "select good events"};
@@ -747,11 +749,23 @@ struct qaEventTrack {
   template <bool IS_MC, typename C, typename T, typename T_UNF>
   void fillRecoHistogramsGroupedTracks(const C& collision, const T& tracks, const T_UNF& tracksUnfiltered);
 
+  // per data frame sampling, the process function is executed for each data frame before the others
+  int64_t nDataFrames = 0;
+  bool isSampledDF = true;
+  void process(aod::BCs const&)
+  {
+    isSampledDF = sampleOneDFEvery <= 1 || (nDataFrames % sampleOneDFEvery) == 0;
+    nDataFrames++;
+  }
+
   // Process function for data
   using CollisionTableData = soa::Join<aod::Collisions, aod::EvSels>;
   // using TrackTableData = soa::Join<aod::FullTracks, aod::TracksCov, aod::TracksDCA, aod::TrackSelection>;
   void processData(CollisionTableData::iterator const& collision, soa::Filtered<TrackTableData> const& tracks, aod::FullTracks const& tracksUnfiltered)
   {
+    if (!isSampledDF) {
+      return;
+    }
     /// work with collision grouping
     fillRecoHistogramsGroupedTracks<false>(collision, tracks, tracksUnfiltered);
   }
@@ -760,6 +774,9 @@ struct qaEventTrack {
   // process function for all tracks, w/o requiring the collision grouping
   void processTrackMatch(soa::Filtered<TrackTableData> const& tracks, aod::FullTracks const& tracksUnfiltered, aod::AmbiguousTracks const& ambitracks)
   {
+    if (!isSampledDF) {
+      return;
+    }
     if (doDebug) {
       LOG(info) << "================================";
       LOG(info) << "=== soa::Filtered<TrackTableData> const& tracks, size=" << tracks.size();
@@ -796,6 +813,9 @@ struct qaEventTrack {
   // Process function for Run2 converted data
   void processRun2ConvertedData(CollisionTableData const& collisions, soa::Filtered<TrackTableData> const& tracks, aod::FullTracks const& tracksUnfiltered)
   {
+    if (!isSampledDF) {
+      return;
+    }
     /// work with collision grouping
     for (auto const& collision : collisions) {
       const auto& tracksColl = tracks.sliceBy(perRecoCollision, collision.globalIndex());
@@ -811,6 +831,9 @@ struct qaEventTrack {
                      soa::Join<aod::FullTracks, aod::TracksDCA> const& tracksUnfiltered,
                      FullTracksIU const& tracksIU)
   {
+    if (!isSampledDF) {
+      return;
+    }
     if (!isSelectedCollision<false>(collision)) {
       return;
     }
@@ -1034,6 +1057,9 @@ struct qaEventTrack {
   // Process function for filtered IU
   void processDataIUFiltered(CollisionTableData::iterator const& collision, TrackTableData const&, TrackIUTable const&)
   {
+    if (!isSampledDF) {
+      return;
+    }
     if (!isSelectedCollision<false>(collision)) {
       return;
     }
@@ -1080,6 +1106,9 @@ struct qaEventTrack {
                  aod::AmbiguousTracks const& ambitracks,
                  aod::McParticles const&, aod::McCollisions const&)
   {
+    if (!isSampledDF) {
+      return;
+    }
     /// work with all filtered tracks
     fillRecoHistogramsAllTracks<true, true>(tracks, ambitracks);
     /// work with all unfiltered tracks
@@ -1167,6 +1196,9 @@ struct qaEventTrack {
   void processRun2ConvertedMC(CollisionTableMC const& collisions, soa::Filtered<TrackTableMC> const& tracks, soa::Join<aod::FullTracks, aod::McTrackLabels> const& tracksUnfiltered,
                               aod::McParticles const&, aod::McCollisions const&)
   {
+    if (!isSampledDF) {
+      return;
+    }
     /// work with collision grouping
     for (auto const& collision : collisions) {
       const auto& tracksColl = tracks.sliceBy(perRecoCollision, collision.globalIndex());
@@ -1561,34 +1593,41 @@ void qaEventTrack::fillRecoHistogramsGroupedTracks(const C& collision, const T&
         continue;
       }
     }
+    // derived track quantities, computed once and shared by all the histogram groups
+    const float pt = track.pt();
+    const float eta = track.eta();
+    const float phi = track.phi();
+    const float sigma1Pt = std::sqrt(track.c1Pt21Pt2());
+    const float relativeResoPt = pt * sigma1Pt;
+    const int itsNhits = std::popcount(static_cast<uint32_t>(track.itsClusterMap() & 0x7F));
+
     // fill kinematic variables
-    histos.fill(HIST("Tracks/Kine/pt"), track.pt());
+    histos.fill(HIST("Tracks/Kine/pt"), pt);
     if (track.sign() > 0) {
-      histos.fill(HIST("Tracks/Kine/ptFilteredPositive"), track.pt());
+      histos.fill(HIST("Tracks/Kine/ptFilteredPositive"), pt);
     } else {
-      histos.fill(HIST("Tracks/Kine/ptFilteredNegative"), track.pt());
-    }
-    histos.fill(HIST("Tracks/Kine/eta"), track.eta());
-    histos.fill(HIST("Tracks/Kine/phi"), track.phi());
-    histos.fill(HIST("Tracks/Kine/etavsphi"), track.eta(), track.phi());
-    histos.fill(HIST("Tracks/Kine/etavspt"), track.pt(), track.eta());
-    histos.fill(HIST("Tracks/Kine/phivspt"), track.pt(), track.phi());
-    histos.fill(HIST("Tracks/Kine/relativeResoPt"), track.pt(), track.pt() * std::sqrt(track.c1Pt21Pt2()));
-    histos.fill(HIST("Tracks/Kine/relativeResoPtMean"), track.pt(), track.pt() * std::sqrt(track.c1Pt21Pt2()));
-    auto eta = track.eta();
+      histos.fill(HIST("Tracks/Kine/ptFilteredNegative"), pt);
+    }
+    histos.fill(HIST("Tracks/Kine/eta"), eta);
+    histos.fill(HIST("Tracks/Kine/phi"), phi);
+    histos.fill(HIST("Tracks/Kine/etavsphi"), eta, phi);
+    histos.fill(HIST("Tracks/Kine/etavspt"), pt, eta);
+    histos.fill(HIST("Tracks/Kine/phivspt"), pt, phi);
+    histos.fill(HIST("Tracks/Kine/relativeResoPt"), pt, relativeResoPt);
+    histos.fill(HIST("Tracks/Kine/relativeResoPtMean"), pt, relativeResoPt);
     if (eta > 0) { /// positive eta
-      histos.fill(HIST("Tracks/Kine/relativeResoPtEtaPlus"), track.pt(), track.pt() * std::sqrt(track.c1Pt21Pt2()));
+      histos.fill(HIST("Tracks/Kine/relativeResoPtEtaPlus"), pt, relativeResoPt);
       if (eta < 0.4) { /// |eta| < 0.4
-        histos.fill(HIST("Tracks/Kine/relativeResoPtEtaWithin04"), track.pt(), track.pt() * std::sqrt(track.c1Pt21Pt2()));
+        histos.fill(HIST("Tracks/Kine/relativeResoPtEtaWithin04"), pt, relativeResoPt);
       } else { /// |eta| > 0.4
-        histos.fill(HIST("Tracks/Kine/relativeResoPtEtaAbove04"), track.pt(), track.pt() * std::sqrt(track.c1Pt21Pt2()));
+        histos.fill(HIST("Tracks/Kine/relativeResoPtEtaAbove04"), pt, relativeResoPt);
       }
     } else { /// negative eta
-      histos.fill(HIST("Tracks/Kine/relativeResoPtEtaMinus"), track.pt(), track.pt() * std::sqrt(track.c1Pt21Pt2()));
+      histos.fill(HIST("Tracks/Kine/relativeResoPtEtaMinus"), pt, relativeResoPt);
       if (eta > -0.4) { /// |eta| < 0.4
-        histos.fill(HIST("Tracks/Kine/relativeResoPtEtaWithin04"), track.pt(), track.pt() * std::sqrt(track.c1Pt21Pt2()));
+        histos.fill(HIST("Tracks/Kine/relativeResoPtEtaWithin04"), pt, relativeResoPt);
       } else { /// |eta| > 0.4
-        histos.fill(HIST("Tracks/Kine/relativeResoPtEtaAbove04"), track.pt(), track.pt() * std::sqrt(track.c1Pt21Pt2()));
+        histos.fill(HIST("Tracks/Kine/relativeResoPtEtaAbove04"), pt, relativeResoPt);
       }
     }
 
@@ -1607,38 +1646,31 @@ void qaEventTrack::fillRecoHistogramsGroupedTracks(const C& collision, const T&
     }
     histos.fill(HIST("Tracks/dcaXY"), track.dcaXY());
     histos.fill(HIST("Tracks/dcaZ"), track.dcaZ());
-    histos.fill(HIST("Tracks/dcaXYvsPt"), track.dcaXY(), track.pt());
-    histos.fill(HIST("Tracks/dcaZvsPt"), track.dcaZ(), track.pt());
-    histos.fill(HIST("Tracks/dcaZvsEta"), track.dcaZ(), track.eta());
+    histos.fill(HIST("Tracks/dcaXYvsPt"), track.dcaXY(), pt);
+    histos.fill(HIST("Tracks/dcaZvsPt"), track.dcaZ(), pt);
+    histos.fill(HIST("Tracks/dcaZvsEta"), track.dcaZ(), eta);
     histos.fill(HIST("Tracks/length"), track.length());
 
     // fill ITS variables
     histos.fill(HIST("Tracks/ITS/itsNCls"), track.itsNCls());
     histos.fill(HIST("Tracks/ITS/itsChi2NCl"), track.itsChi2NCl());
-    int itsNhits = 0;
     for (unsigned int i = 0; i < 7; i++) {
       if (track.itsClusterMap() & (1 << i)) {
-        itsNhits += 1;
-      }
-    }
-    bool trkHasITS = false;
-    for (unsigned int i = 0; i < 7; i++) {
-      if (track.itsClusterMap() & (1 << i)) {
-        trkHasITS = true;
         histos.fill(HIST("Tracks/ITS/itsHits"), i, itsNhits);
       }
     }
-    if (!trkHasITS) {
+    if (itsNhits == 0) {
       histos.fill(HIST("Tracks/ITS/itsHits"), -1, itsNhits);
     }
 
     // fill TPC variables
+    const int tpcNClsFound = track.tpcNClsFound();
     histos.fill(HIST("Tracks/TPC/tpcNClsFindable"), track.tpcNClsFindable());
-    histos.fill(HIST("Tracks/TPC/tpcNClsFound"), track.tpcNClsFound());
-    histos.fill(HIST("Tracks/TPC/tpcNClsFoundVsEta"), track.eta(), track.tpcNClsFound());
-    histos.fill(HIST("Tracks/TPC/tpcNClsFoundVsEtaVtxZ"), track.eta(), track.tpcNClsFound(), collision.posZ());
-    histos.fill(HIST("Tracks/TPC/tpcNClsFoundVsEtaPhi"), track.eta(), track.tpcNClsFound(), track.phi());
-    histos.fill(HIST("Tracks/TPC/tpcNClsFoundVsEtaVsPt"), track.eta(), track.tpcNClsFound(), track.pt());
+    histos.fill(HIST("Tracks/TPC/tpcNClsFound"), tpcNClsFound);
+    histos.fill(HIST("Tracks/TPC/tpcNClsFoundVsEta"), eta, tpcNClsFound);
+    histos.fill(HIST("Tracks/TPC/tpcNClsFoundVsEtaVtxZ"), eta, tpcNClsFound, collision.posZ());
+    histos.fill(HIST("Tracks/TPC/tpcNClsFoundVsEtaPhi"), eta, tpcNClsFound, phi);
+    histos.fill(HIST("Tracks/TPC/tpcNClsFoundVsEtaVsPt"), eta, tpcNClsFound, pt);
     histos.fill(HIST("Tracks/TPC/tpcNClsShared"), track.tpcNClsShared());
     histos.fill(HIST("Tracks/TPC/tpcCrossedRows"), track.tpcNClsCrossedRows());
     histos.fill(HIST("Tracks/TPC/tpcCrossedRowsOverFindableCls"), track.tpcCrossedRowsOverFindableCls());
@@ -1655,36 +1687,40 @@ void qaEventTrack::fillRecoHistogramsGroupedTracks(const C& collision, const T&
         if (pdgInfo != nullptr) {
           sign = pdgInfo->Charge() / abs(pdgInfo->Charge());
         }
+        const float ptMC = particle.pt();
+        const float invPtMC = 1.f / ptMC;
+        const float signed1Pt = track.signed1Pt();
+        const float pullInvPt = (std::abs(signed1Pt) - invPtMC) / sigma1Pt;
         // resolution plots
         if (doExtraPIDqa && track.pidForTracking() != static_cast<unsigned int>(std::abs(PartIdentifier))) {
           // full eta range
-          histos.fill(HIST("Tracks/Kine/resoPtVsptmcWrongPIDinTrk"), track.pt() - particle.pt(), particle.pt());
-          histos.fill(HIST("Tracks/Kine/resoPtVsptmcScaledWrongPIDinTrk"), (track.pt() - particle.pt()) / particle.pt(), particle.pt());
-          histos.fill(HIST("Tracks/Kine/pullInvPtVsInvPtmcWrongPIDinTrk"), (std::abs(track.signed1Pt()) - 1.f / particle.pt()) / std::sqrt(track.c1Pt21Pt2()), 1.f / particle.pt());
-          histos.fill(HIST("Tracks/Kine/pullInvPtVsPtmcWrongPIDinTrk"), (std::abs(track.signed1Pt()) - 1.f / particle.pt()) / std::sqrt(track.c1Pt21Pt2()), particle.pt());
-          if (particle.pt() > 0.f) {
-            histos.fill(HIST("Tracks/Kine/resoInvPtWrongPIDinTrk"), std::abs(track.signed1Pt()) - 1.f / particle.pt(), 1.f / particle.pt());
+          histos.fill(HIST("Tracks/Kine/resoPtVsptmcWrongPIDinTrk"), pt - ptMC, ptMC);
+          histos.fill(HIST("Tracks/Kine/resoPtVsptmcScaledWrongPIDinTrk"), (pt - ptMC) / ptMC, ptMC);
+          histos.fill(HIST("Tracks/Kine/pullInvPtVsInvPtmcWrongPIDinTrk"), pullInvPt, invPtMC);
+          histos.fill(HIST("Tracks/Kine/pullInvPtVsPtmcWrongPIDinTrk"), pullInvPt, ptMC);
+          if (ptMC > 0.f) {
+            histos.fill(HIST("Tracks/Kine/resoInvPtWrongPIDinTrk"), std::abs(signed1Pt) - invPtMC, invPtMC);
           }
-          histos.fill(HIST("Tracks/Kine/resoInvPtVsPtWrongPIDinTrk"), track.signed1Pt() - 1.f / particle.pt(), particle.pt());
+          histos.fill(HIST("Tracks/Kine/resoInvPtVsPtWrongPIDinTrk"), signed1Pt - invPtMC, ptMC);
           // split eta range
           if (eta > 0) { // positive eta
-            histos.fill(HIST("Tracks/Kine/resoPtVsptmcEtaPlusWrongPIDinTrk"), track.pt() - particle.pt(), particle.pt());
-            histos.fill(HIST("Tracks/Kine/resoPtVsptmcScaledEtaPlusWrongPIDinTrk"), (track.pt() - particle.pt()) / particle.pt(), particle.pt());
-            histos.fill(HIST("Tracks/Kine/pullInvPtVsInvPtmcEtaPlusWrongPIDinTrk"), (std::abs(track.signed1Pt()) - 1.f / particle.pt()) / std::sqrt(track.c1Pt21Pt2()), 1.f / particle.pt());
-            histos.fill(HIST("Tracks/Kine/pullInvPtVsPtmcEtaPlusWrongPIDinTrk"), (std::abs(track.signed1Pt()) - 1.f / particle.pt()) / std::sqrt(track.c1Pt21Pt2()), particle.pt());
-            if (particle.pt() > 0.f) {
-              histos.fill(HIST("Tracks/Kine/resoInvPtEtaPlusWrongPIDinTrk"), std::abs(track.signed1Pt()) - 1.f / particle.pt(), 1.f / particle.pt());
+            histos.fill(HIST("Tracks/Kine/resoPtVsptmcEtaPlusWrongPIDinTrk"), pt - ptMC, ptMC);
+            histos.fill(HIST("Tracks/Kine/resoPtVsptmcScaledEtaPlusWrongPIDinTrk"), (pt - ptMC) / ptMC, ptMC);
+            histos.fill(HIST("Tracks/Kine/pullInvPtVsInvPtmcEtaPlusWrongPIDinTrk"), pullInvPt, invPtMC);
+            histos.fill(HIST("Tracks/Kine/pullInvPtVsPtmcEtaPlusWrongPIDinTrk"), pullInvPt, ptMC);
+            if (ptMC > 0.f) {
+              histos.fill(HIST("Tracks/Kine/resoInvPtEtaPlusWrongPIDinTrk"), std::abs(signed1Pt) - invPtMC, invPtMC);
             }
-            histos.fill(HIST("Tracks/Kine/resoInvPtVsPtEtaPlusWrongPIDinTrk"), track.signed1Pt() - 1.f / particle.pt(), particle.pt());
+            histos.fill(HIST("Tracks/Kine/resoInvPtVsPtEtaPlusWrongPIDinTrk"), signed1Pt - invPtMC, ptMC);
           } else { // negative eta
-            histos.fill(HIST("Tracks/Kine/resoPtVsptmcEtaMinusWrongPIDinTrk"), track.pt() - particle.pt(), particle.pt());
-            histos.fill(HIST("Tracks/Kine/resoPtVsptmcScaledEtaMinusWrongPIDinTrk"), (track.pt() - particle.pt()) / particle.pt(), particle.pt());
-            histos.fill(HIST("Tracks/Kine/pullInvPtVsInvPtmcEtaMinusWrongPIDinTrk"), (std::abs(track.signed1Pt()) - 1.f / particle.pt()) / std::sqrt(track.c1Pt21Pt2()), 1.f / particle.pt());
-            histos.fill(HIST("Tracks/Kine/pullInvPtVsPtmcEtaMinusWrongPIDinTrk"), (std::abs(track.signed1Pt()) - 1.f / particle.pt()) / std::sqrt(track.c1Pt21Pt2()), particle.pt());
-            if (particle.pt() > 0.f) {
-              histos.fill(HIST("Tracks/Kine/resoInvPtEtaMinusWrongPIDinTrk"), std::abs(track.signed1Pt()) - 1.f / particle.pt(), 1.f / particle.pt());
+            histos.fill(HIST("Tracks/Kine/resoPtVsptmcEtaMinusWrongPIDinTrk"), pt - ptMC, ptMC);
+            histos.fill(HIST("Tracks/Kine/resoPtVsptmcScaledEtaMinusWrongPIDinTrk"), (pt - ptMC) / ptMC, ptMC);
+            histos.fill(HIST("Tracks/Kine/pullInvPtVsInvPtmcEtaMinusWrongPIDinTrk"), pullInvPt, invPtMC);
+            histos.fill(HIST("Tracks/Kine/pullInvPtVsPtmcEtaMinusWrongPIDinTrk"), pullInvPt, ptMC);
+            if (ptMC > 0.f) {
+              histos.fill(HIST("Tracks/Kine/resoInvPtEtaMinusWrongPIDinTrk"), std::abs(signed1Pt) - invPtMC, invPtMC);
             }
-            histos.fill(HIST("Tracks/Kine/resoInvPtVsPtEtaMinusWrongPIDinTrk"), track.signed1Pt() - 1.f / particle.pt(), particle.pt());
+            histos.fill(HIST("Tracks/Kine/resoInvPtVsPtEtaMinusWrongPIDinTrk"), signed1Pt - invPtMC, ptMC);
           }
         }
 
@@ -1712,60 +1748,60 @@ void qaEventTrack::fillRecoHistogramsGroupedTracks(const C& collision, const T&
 
         // Kine plots
         // full eta range
-        histos.fill(HIST("Tracks/Kine/resoPt"), track.pt() - particle.pt(), track.pt(), track.sign());
-        histos.fill(HIST("Tracks/Kine/resoPtVsptmc"), track.pt() - particle.pt(), particle.pt(), track.sign());
-        histos.fill(HIST("Tracks/Kine/resoPtVsptmcScaled"), (track.pt() - particle.pt()) / particle.pt(), particle.pt(), track.sign());
-        if (particle.pt() > 0.f) {
-          histos.fill(HIST("Tracks/Kine/resoInvPt"), std::abs(track.signed1Pt()) - 1.f / particle.pt(), 1.f / particle.pt(), track.sign());
-          histos.fill(HIST("Tracks/Kine/resoInvPtVsPt"), std::abs(track.signed1Pt()) - 1.f / particle.pt(), particle.pt(), track.sign());
-          histos.fill(HIST("Tracks/Kine/resoInvPtVsPtScaled"), (std::abs(track.signed1Pt()) - 1.f / particle.pt()) / (1.f / particle.pt()), particle.pt(), track.sign());
-          histos.fill(HIST("Tracks/Kine/resoSigned1Pt"), track.signed1Pt() - sign / particle.pt(), sign / particle.pt(), track.sign());
-          histos.fill(HIST("Tracks/Kine/resoSigned1PtVsPt"), track.signed1Pt() - sign / particle.pt(), particle.pt(), track.sign());
-          histos.fill(HIST("Tracks/Kine/resoSigned1PtScaled"), (track.signed1Pt() - sign / particle.pt()) / (sign / particle.pt()), sign / particle.pt(), track.sign());
-          histos.fill(HIST("Tracks/Kine/resoSigned1PtVsPtScaled"), (track.signed1Pt() - sign / particle.pt()) / (sign / particle.pt()), particle.pt(), track.sign());
+        histos.fill(HIST("Tracks/Kine/resoPt"), pt - ptMC, pt, track.sign());
+        histos.fill(HIST("Tracks/Kine/resoPtVsptmc"), pt - ptMC, ptMC, track.sign());
+        histos.fill(HIST("Tracks/Kine/resoPtVsptmcScaled"), (pt - ptMC) / ptMC, ptMC, track.sign());
+        if (ptMC > 0.f) {
+          histos.fill(HIST("Tracks/Kine/resoInvPt"), std::abs(signed1Pt) - invPtMC, invPtMC, track.sign());
+          histos.fill(HIST("Tracks/Kine/resoInvPtVsPt"), std::abs(signed1Pt) - invPtMC, ptMC, track.sign());
+          histos.fill(HIST("Tracks/Kine/resoInvPtVsPtScaled"), (std::abs(signed1Pt) - invPtMC) / invPtMC, ptMC, track.sign());
+          histos.fill(HIST("Tracks/Kine/resoSigned1Pt"), signed1Pt - sign / ptMC, sign / ptMC, track.sign());
+          histos.fill(HIST("Tracks/Kine/resoSigned1PtVsPt"), signed1Pt - sign / ptMC, ptMC, track.sign());
+          histos.fill(HIST("Tracks/Kine/resoSigned1PtScaled"), (signed1Pt - sign / ptMC) / (sign / ptMC), sign / ptMC, track.sign());
+          histos.fill(HIST("Tracks/Kine/resoSigned1PtVsPtScaled"), (signed1Pt - sign / ptMC) / (sign / ptMC), ptMC, track.sign());
         }
-        histos.fill(HIST("Tracks/Kine/pullInvPtVsInvPtmc"), (std::abs(track.signed1Pt()) - 1.f / particle.pt()) / std::sqrt(track.c1Pt21Pt2()), 1.f / particle.pt(), track.sign());
-        histos.fill(HIST("Tracks/Kine/pullInvPtVsPtmc"), (std::abs(track.signed1Pt()) - 1.f / particle.pt()) / std::sqrt(track.c1Pt21Pt2()), particle.pt(), track.sign());
+        histos.fill(HIST("Tracks/Kine/pullInvPtVsInvPtmc"), pullInvPt, invPtMC, track.sign());
+        histos.fill(HIST("Tracks/Kine/pullInvPtVsPtmc"), pullInvPt, ptMC, track.sign());
 
-        histos.fill(HIST("Tracks/Kine/ptVsptmc"), particle.pt(), track.pt());
-        histos.fill(HIST("Tracks/Kine/Signed1PtVsSigned1Ptmc"), sign / particle.pt(), track.signed1Pt());
-        histos.fill(HIST("Tracks/Kine/resoEta"), track.eta() - particle.eta(), track.eta());
-        histos.fill(HIST("Tracks/Kine/resoPhi"), track.phi() - particle.phi(), track.phi());
+        histos.fill(HIST("Tracks/Kine/ptVsptmc"), ptMC, pt);
+        histos.fill(HIST("Tracks/Kine/Signed1PtVsSigned1Ptmc"), sign / ptMC, signed1Pt);
+        histos.fill(HIST("Tracks/Kine/resoEta"), eta - particle.eta(), eta);
+        histos.fill(HIST("Tracks/Kine/resoPhi"), phi - particle.phi(), phi);
 
         // split eta range
         if (eta > 0) { // positive eta
-          histos.fill(HIST("Tracks/Kine/resoPtEtaPlus"), track.pt() - particle.pt(), track.pt());
-          histos.fill(HIST("Tracks/Kine/resoPtVsptmcEtaPlus"), track.pt() - particle.pt(), particle.pt());
-          histos.fill(HIST("Tracks/Kine/resoPtVsptmcScaledEtaPlus"), (track.pt() - particle.pt()) / particle.pt(), particle.pt());
-          histos.fill(HIST("Tracks/Kine/pullInvPtVsInvPtmcEtaPlus"), (std::abs(track.signed1Pt()) - 1.f / particle.pt()) / std::sqrt(track.c1Pt21Pt2()), 1.f / particle.pt());
-          histos.fill(HIST("Tracks/Kine/pullInvPtVsPtmcEtaPlus"), (std::abs(track.signed1Pt()) - 1.f / particle.pt()) / std::sqrt(track.c1Pt21Pt2()), particle.pt());
-          if (particle.pt() > 0.f) {
-            histos.fill(HIST("Tracks/Kine/resoInvPtEtaPlus"), std::abs(track.signed1Pt()) - 1.f / particle.pt(), 1.f / particle.pt());
+          histos.fill(HIST("Tracks/Kine/resoPtEtaPlus"), pt - ptMC, pt);
+          histos.fill(HIST("Tracks/Kine/resoPtVsptmcEtaPlus"), pt - ptMC, ptMC);
+          histos.fill(HIST("Tracks/Kine/resoPtVsptmcScaledEtaPlus"), (pt - ptMC) / ptMC, ptMC);
+          histos.fill(HIST("Tracks/Kine/pullInvPtVsInvPtmcEtaPlus"), pullInvPt, invPtMC);
+          histos.fill(HIST("Tracks/Kine/pullInvPtVsPtmcEtaPlus"), pullInvPt, ptMC);
+          if (ptMC > 0.f) {
+            histos.fill(HIST("Tracks/Kine/resoInvPtEtaPlus"), std::abs(signed1Pt) - invPtMC, invPtMC);
           }
-          histos.fill(HIST("Tracks/Kine/resoInvPtVsPtEtaPlus"), track.signed1Pt() - 1.f / particle.pt(), particle.pt());
+          histos.fill(HIST("Tracks/Kine/resoInvPtVsPtEtaPlus"), signed1Pt - invPtMC, ptMC);
         } else { // negative eta
-          histos.fill(HIST("Tracks/Kine/resoPtEtaMinus"), track.pt() - particle.pt(), track.pt());
-          histos.fill(HIST("Tracks/Kine/resoPtVsptmcEtaMinus"), track.pt() - particle.pt(), particle.pt());
-          histos.fill(HIST("Tracks/Kine/resoPtVsptmcScaledEtaMinus"), (track.pt() - particle.pt()) / particle.pt(), particle.pt());
-          histos.fill(HIST("Tracks/Kine/pullInvPtVsInvPtmcEtaMinus"), (std::abs(track.signed1Pt()) - 1.f / particle.pt()) / std::sqrt(track.c1Pt21Pt2()), 1.f / particle.pt());
-          histos.fill(HIST("Tracks/Kine/pullInvPtVsPtmcEtaMinus"), (std::abs(track.signed1Pt()) - 1.f / particle.pt()) / std::sqrt(track.c1Pt21Pt2()), particle.pt());
-          if (particle.pt() > 0.f) {
-            histos.fill(HIST("Tracks/Kine/resoInvPtEtaMinus"), std::abs(track.signed1Pt()) - 1.f / particle.pt(), 1.f / particle.pt());
+          histos.fill(HIST("Tracks/Kine/resoPtEtaMinus"), pt - ptMC, pt);
+          histos.fill(HIST("Tracks/Kine/resoPtVsptmcEtaMinus"), pt - ptMC, ptMC);
+          histos.fill(HIST("Tracks/Kine/resoPtVsptmcScaledEtaMinus"), (pt - ptMC) / ptMC, ptMC);
+          histos.fill(HIST("Tracks/Kine/pullInvPtVsInvPtmcEtaMinus"), pullInvPt, invPtMC);
+          histos.fill(HIST("Tracks/Kine/pullInvPtVsPtmcEtaMinus"), pullInvPt, ptMC);
+          if (ptMC > 0.f) {
+            histos.fill(HIST("Tracks/Kine/resoInvPtEtaMinus"), std::abs(signed1Pt) - invPtMC, invPtMC);
           }
-          histos.fill(HIST("Tracks/Kine/resoInvPtVsPtEtaMinus"), track.signed1Pt() - 1.f / particle.pt(), particle.pt());
+          histos.fill(HIST("Tracks/Kine/resoInvPtVsPtEtaMinus"), signed1Pt - invPtMC, ptMC);
         }
       }
     }
 
     // ITS-TPC matching pt-distributions
     if (track.hasITS()) {
-      histos.fill(HIST("Tracks/ITS/hasITS"), track.pt());
+      histos.fill(HIST("Tracks/ITS/hasITS"), pt);
     }
     if (track.hasTPC()) {
-      histos.fill(HIST("Tracks/TPC/hasTPC"), track.pt());
+      histos.fill(HIST("Tracks/TPC/hasTPC"), pt);
     }
     if (track.hasITS() && track.hasTPC()) {
-      histos.fill(HIST("Tracks/ITS/hasITSANDhasTPC"), track.pt());
+      histos.fill(HIST("Tracks/ITS/hasITSANDhasTPC"), pt);
     }
   }
 }
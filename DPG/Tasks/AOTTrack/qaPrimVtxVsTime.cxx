@@ -22,6 +22,10 @@
 #include "DataFormatsParameters/GRPECSObject.h"
 #include "TH1F.h"
 #include "TH2F.h"
+#include "TProfile.h"
+
+#include <algorithm>
+#include <cmath>
 
 using namespace o2::framework;
 using namespace o2;
@@ -33,8 +37,13 @@ struct QaPrimVtxVsTime {
 
   Configurable<std::string> ccdburl{"ccdburl", "http://alice-ccdb.cern.ch", "url of the ccdb repository"};
   ConfigurableAxis binsVertexPosZ{"binsVertexPosZ", {100, -20., 20.}, ""};
+  Configurable<float> timeBinWidthInSec{"timeBinWidthInSec", 1., "Width of the time bins in seconds"};
+  Configurable<bool> doPosZvsTimeTH2{"doPosZvsTimeTH2", true, "Fill the full posZ vs. time TH2"};
+  Configurable<bool> doPosZvsTimeProfile{"doPosZvsTimeProfile", false, "Fill the mean (and spread) of posZ vs. time in a TProfile, much smaller than the TH2"};
+  Configurable<int> downsampling{"downsampling", 1, "Fill only one collision every N (online-style downsampling)"};
 
   AxisSpec axisVertexPosZ{binsVertexPosZ, "Primary vertex Z (cm)"};
+  int64_t nCollisionsSeen = 0;
   HistogramRegistry histos{"Histos", {}, OutputObjHandlingPolicy::AnalysisObject};
 
   /// @brief init function
@@ -75,8 +84,15 @@ struct QaPrimVtxVsTime {
 
       double minSec = floor(tsSOR / 1000.); /// round tsSOR to the highest integer lower than tsSOR
       double maxSec = ceil(tsEOR / 1000.);  /// round tsEOR to the lowest integer higher than tsEOR
-      const AxisSpec axisSeconds{static_cast<int>(maxSec - minSec), minSec, maxSec, "seconds (from January 1st, 1970 at UTC)"};
-      histos.add("hPosZvsTime", "", kTH2F, {axisSeconds, axisVertexPosZ});
+      const int nTimeBins = std::max(1, static_cast<int>(std::ceil((maxSec - minSec) / timeBinWidthInSec)));
+      const AxisSpec axisSeconds{nTimeBins, minSec, minSec + nTimeBins * timeBinWidthInSec, "seconds (from January 1st, 1970 at UTC)"};
+      if (doPosZvsTimeTH2) {
+        histos.add("hPosZvsTime", "", kTH2F, {axisSeconds, axisVertexPosZ});
+      }
+      if (doPosZvsTimeProfile) {
+        histos.add("hPosZvsTimeProfile", ";;mean primary vertex Z (cm)", kTProfile, {axisSeconds});
+        histos.get<TProfile>(HIST("hPosZvsTimeProfile"))->SetErrorOption("s"); // the error is the spread of posZ in the time bin
+      }
     }
 
     /// The rest of the code is always run
@@ -87,8 +103,18 @@ struct QaPrimVtxVsTime {
         continue;
       }
 
+      /// online-style downsampling of the collisions
+      if (downsampling > 1 && (nCollisionsSeen++ % downsampling) != 0) {
+        continue;
+      }
+
       const auto timestamp = collision.bc_as<BCsWithTimeStamp>().timestamp(); /// NB: in ms
-      histos.fill(HIST("hPosZvsTime"), timestamp / 1000., collision.posZ());
+      if (doPosZvsTimeTH2) {
+        histos.fill(HIST("hPosZvsTime"), timestamp / 1000., collision.posZ());
+      }
+      if (doPosZvsTimeProfile) {
+        histos.fill(HIST("hPosZvsTimeProfile"), timestamp / 1000., collision.posZ());
+      }
     }
   }
 };
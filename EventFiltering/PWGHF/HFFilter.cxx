@@ -68,6 +68,7 @@
 #include <array>
 #include <chrono>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <memory>
@@ -234,6 +235,8 @@ struct HfFilter { // Main struct for HF triggers
   o2::vertexing::DCAFitterN<2> dfStrangeness;  // fitter for V0s and cascades (2-prong vertex fitter)
   o2::vertexing::DCAFitterN<3> dfStrangeness3; // fitter for Xic+ -> XiPiPi
 
+  V0CandsCollision v0CandsThisColl; // V0s of the current collision, shared by the 2-prong and 3-prong candidates
+
   std::shared_ptr<TH1> hProcessedEvents;
 
   // QA histos
@@ -528,6 +531,7 @@ struct HfFilter { // Main struct for HF triggers
       }
 
       hProcessedEvents->Fill(0);
+      v0CandsThisColl.clear();
 
       std::vector<std::vector<int64_t>> indicesDau2Prong{}, indicesDau2ProngPrompt{};
 
@@ -564,15 +568,9 @@ struct HfFilter { // Main struct for HF triggers
 
         // apply ML models for D0
         bool isD0CharmTagged{false}, isD0BeautyTagged{false}, isD0SignalTagged{false};
-        std::vector<float> scores{};
+        std::array<float, 3> scores{};
         if (preselD0) {
-          scores.insert(scores.end(), cand2Prong.mlProbSkimD0ToKPi().begin(), cand2Prong.mlProbSkimD0ToKPi().end());
-          if (scores.size() != 3) {
-            scores.resize(3);
-            scores[0] = 2.;
-            scores[1] = -1.;
-            scores[2] = -1.;
-          }
+          scores = helper.getSkimBdtScores(cand2Prong.mlProbSkimD0ToKPi());
           auto tagBDT = helper.isBDTSelected(scores, thresholdBDTScores[kD0]);
           isD0CharmTagged = TESTBIT(tagBDT, RecoDecay::OriginType::Prompt);
           isD0BeautyTagged = TESTBIT(tagBDT, RecoDecay::OriginType::NonPrompt);
@@ -1007,12 +1005,15 @@ struct HfFilter { // Main struct for HF triggers
 
         // 2-prong with K0S or Lambda
         if (!keepEvent[kV0Charm2P] && isD0SignalTagged && (TESTBIT(selD0InMass, 0) || TESTBIT(selD0InMass, 1))) {
-          auto v0sThisCollision = v0s.sliceBy(v0sPerCollision, thisCollId);
-          for (const auto& v0 : v0sThisCollision) {
-            V0Cand v0Cand;
-            if (!helper.buildV0(v0, tracksIU, collision, dfStrangeness, std::vector{cand2Prong.prong0Id(), cand2Prong.prong1Id()}, v0Cand)) {
+          if (!v0CandsThisColl.isFilled) {
+            helper.buildV0s(v0s.sliceBy(v0sPerCollision, thisCollId), tracksIU, collision, dfStrangeness, v0CandsThisColl);
+          }
+          const std::vector<int> vetoedTrackIds{cand2Prong.prong0Id(), cand2Prong.prong1Id()};
+          for (std::size_t iV0{0}; iV0 < v0CandsThisColl.size(); ++iV0) {
+            if (!v0CandsThisColl.isBuilt[iV0] || v0CandsThisColl.isVetoed(iV0, vetoedTrackIds)) {
               continue;
             }
+            const auto& v0Cand = v0CandsThisColl.cands[iV0];
             auto selV0 = helper.isSelectedV0(v0Cand, activateQA, hV0Selected, hArmPod);
             if (!selV0) {
               continue;
@@ -1023,7 +1024,7 @@ struct HfFilter { // Main struct for HF triggers
               // we first look for a D*+
               for (const auto& trackBachelorId : trackIdsThisCollision) { // start loop over tracks
                 auto trackBachelor = tracks.rawIteratorAt(trackBachelorId.trackId());
-                if (trackBachelor.globalIndex() == trackPos.globalIndex() || trackBachelor.globalIndex() == trackNeg.globalIndex() || trackBachelor.globalIndex() == v0.posTrackId() || trackBachelor.globalIndex() == v0.negTrackId()) {
+                if (trackBachelor.globalIndex() == trackPos.globalIndex() || trackBachelor.globalIndex() == trackNeg.globalIndex() || trackBachelor.globalIndex() == v0CandsThisColl.posTrackIds[iV0] || trackBachelor.globalIndex() == v0CandsThisColl.negTrackIds[iV0]) {
                   continue;
                 }
 
@@ -1308,43 +1309,24 @@ struct HfFilter { // Main struct for HF triggers
           getPxPyPz(trackParThird, pVecThird);
         }
 
-        if (is3Prong[0]) { // D+ preselections
-          is3Prong[0] = helper.isDplusPreselected(trackSecond);
-        }
-        if (is3Prong[1]) { // Ds preselections
-          is3Prong[1] = helper.isDsPreselected(pVecFirst, pVecThird, pVecSecond, trackSecond);
-        }
-        if (is3Prong[2] || is3Prong[3]) { // charm baryon preselections
-          auto presel = helper.isCharmBaryonPreselected(trackFirst, trackThird, trackSecond);
-          if (is3Prong[2]) {
-            is3Prong[2] = presel;
-          }
-          if (is3Prong[3]) {
-            is3Prong[3] = presel;
-          }
-        }
+        // D+, Ds and charm baryon preselections
+        helper.is3ProngPreselected(is3Prong, pVecFirst, pVecThird, pVecSecond, trackFirst, trackThird, trackSecond);
 
         std::array<int8_t, kNCharmParticles - 1> isSignalTagged = is3Prong;
         std::array<int8_t, kNCharmParticles - 1> isCharmTagged = is3Prong;
         std::array<int8_t, kNCharmParticles - 1> isBeautyTagged = is3Prong;
 
-        std::array<std::vector<float>, kNCharmParticles - 1> scores{};
-        scores[0].insert(scores[0].end(), cand3Prong.mlProbSkimDplusToPiKPi().begin(), cand3Prong.mlProbSkimDplusToPiKPi().end());
-        scores[1].insert(scores[1].end(), cand3Prong.mlProbSkimDsToKKPi().begin(), cand3Prong.mlProbSkimDsToKKPi().end());
-        scores[2].insert(scores[2].end(), cand3Prong.mlProbSkimLcToPKPi().begin(), cand3Prong.mlProbSkimLcToPKPi().end());
-        scores[3].insert(scores[3].end(), cand3Prong.mlProbSkimXicToPKPi().begin(), cand3Prong.mlProbSkimXicToPKPi().end());
+        std::array<std::array<float, 3>, kNCharmParticles - 1> scores{};
+        scores[0] = helper.getSkimBdtScores(cand3Prong.mlProbSkimDplusToPiKPi());
+        scores[1] = helper.getSkimBdtScores(cand3Prong.mlProbSkimDsToKKPi());
+        scores[2] = helper.getSkimBdtScores(cand3Prong.mlProbSkimLcToPKPi());
+        scores[3] = helper.getSkimBdtScores(cand3Prong.mlProbSkimXicToPKPi());
 
         for (auto iCharmPart{0}; iCharmPart < kNCharmParticles - 1; ++iCharmPart) {
           if (!is3Prong[iCharmPart]) { // we immediately skip if it was not selected for a given 3-prong species
             continue;
           }
 
-          if (scores[iCharmPart].size() != 3) {
-            scores[iCharmPart].resize(3);
-            scores[iCharmPart][0] = 2.;
-            scores[iCharmPart][1] = -1.;
-            scores[iCharmPart][2] = -1.;
-          }
           auto tagBDT = helper.isBDTSelected(scores[iCharmPart], thresholdBDTScores[iCharmPart + 1]);
 
           isCharmTagged[iCharmPart] = TESTBIT(tagBDT, RecoDecay::OriginType::Prompt);
@@ -1718,18 +1700,21 @@ struct HfFilter { // Main struct for HF triggers
         }
 
         // D+ with K0S or Lambda and SigmaC0 with K0S
-        auto v0sThisCollision = v0s.sliceBy(v0sPerCollision, thisCollId);
         bool isGoodDPlus = (isSignalTagged[kDplus - 1]) && is3ProngInMass[kDplus - 1];
         bool isGoodLcToPKPi = (isSignalTagged[kLc - 1]) && TESTBIT(is3ProngInMass[kLc - 1], 0);
         bool isGoodLcToPiKP = (isSignalTagged[kLc - 1]) && TESTBIT(is3ProngInMass[kLc - 1], 1);
         auto massDPlusCand = RecoDecay::m(std::array{pVecFirst, pVecSecond, pVecThird}, std::array{massPi, massKa, massPi});
 
         if ((!keepEvent[kV0Charm3P] && isGoodDPlus) || (!keepEvent[kSigmaC0K0] && (isGoodLcToPKPi || isGoodLcToPiKP))) {
-          for (const auto& v0 : v0sThisCollision) {
-            V0Cand v0Cand;
-            if (!helper.buildV0(v0, tracksIU, collision, dfStrangeness, std::vector{cand3Prong.prong0Id(), cand3Prong.prong1Id(), cand3Prong.prong2Id()}, v0Cand)) {
+          if (!v0CandsThisColl.isFilled) {
+            helper.buildV0s(v0s.sliceBy(v0sPerCollision, thisCollId), tracksIU, collision, dfStrangeness, v0CandsThisColl);
+          }
+          const std::vector<int> vetoedTrackIds{cand3Prong.prong0Id(), cand3Prong.prong1Id(), cand3Prong.prong2Id()};
+          for (std::size_t iV0{0}; iV0 < v0CandsThisColl.size(); ++iV0) {
+            if (!v0CandsThisColl.isBuilt[iV0] || v0CandsThisColl.isVetoed(iV0, vetoedTrackIds)) {
               continue;
             }
+            const auto& v0Cand = v0CandsThisColl.cands[iV0];
             auto selV0 = helper.isSelectedV0(v0Cand, activateQA, hV0Selected, hArmPod);
             if (!selV0) {
               continue;
@@ -1784,7 +1769,7 @@ struct HfFilter { // Main struct for HF triggers
                 auto globalIndexSoftPi = trackSoftPi.globalIndex();
 
                 // exclude tracks already used to build the 3-prong candidate
-                if (globalIndexSoftPi == trackFirst.globalIndex() || globalIndexSoftPi == trackSecond.globalIndex() || globalIndexSoftPi == trackThird.globalIndex() || globalIndexSoftPi == v0.posTrackId() || globalIndexSoftPi == v0.negTrackId()) {
+                if (globalIndexSoftPi == trackFirst.globalIndex() || globalIndexSoftPi == trackSecond.globalIndex() || globalIndexSoftPi == trackThird.globalIndex() || globalIndexSoftPi == v0CandsThisColl.posTrackIds[iV0] || globalIndexSoftPi == v0CandsThisColl.negTrackIds[iV0]) {
                   // do not consider as candidate soft pion a track already used to build the current 3-prong candidate / V0 candidate
                   continue;
                 }
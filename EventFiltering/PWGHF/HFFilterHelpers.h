@@ -242,6 +242,32 @@ struct CascCand {
   int sign;
 };
 
+// Helper struct to keep the V0 candidates of a collision, reconstructed once and shared by all the charm-hadron candidates
+struct V0CandsCollision {
+  std::vector<V0Cand> cands{};    // reconstructed V0s, valid only if isBuilt
+  std::vector<int> posTrackIds{}; // index of the positive daughter track
+  std::vector<int> negTrackIds{}; // index of the negative daughter track
+  std::vector<uint8_t> isBuilt{}; // V0 passing the minimal track cuts and with a reconstructed vertex
+  bool isFilled{false};           // V0s of the current collision already reconstructed
+
+  void clear()
+  {
+    cands.clear();
+    posTrackIds.clear();
+    negTrackIds.clear();
+    isBuilt.clear();
+    isFilled = false;
+  }
+
+  std::size_t size() const { return cands.size(); }
+
+  /// \return true if one of the daughters of the i-th V0 is among the vetoed tracks
+  bool isVetoed(std::size_t i, const std::vector<int>& vetoedTrackIds) const
+  {
+    return std::find(vetoedTrackIds.begin(), vetoedTrackIds.end(), posTrackIds[i]) != vetoedTrackIds.end() || std::find(vetoedTrackIds.begin(), vetoedTrackIds.end(), negTrackIds[i]) != vetoedTrackIds.end();
+  }
+};
+
 static const std::array<std::string, kNCharmParticles> charmParticleNames{"D0", "Dplus", "Ds", "Lc", "Xic"};
 static const int nTotBeautyParts = static_cast<int>(kNBeautyParticles) + static_cast<int>(kNBeautyParticlesToJPsi);
 static const std::array<std::string, nTotBeautyParts> beautyParticleNames{"Bplus", "B0toDStar", "Bc", "B0", "Bs", "Lb", "Xib", "BplusToJPsi", "B0ToJPsi", "BsToJPsi", "LbToJPsi", "BcToJPsi"};
@@ -670,6 +696,8 @@ class HfFilterHelper
   int8_t isDsPreselected(const P& pTrackSameChargeFirst, const P& pTrackSameChargeSecond, const P& pTrackOppositeCharge, const T& trackOppositeCharge);
   template <typename T>
   int8_t isCharmBaryonPreselected(const T& trackSameChargeFirst, const T& trackSameChargeSecond, const T& trackOppositeCharge);
+  template <std::size_t N, typename P, typename T>
+  void is3ProngPreselected(std::array<int8_t, N>& is3Prong, const P& pTrackSameChargeFirst, const P& pTrackSameChargeSecond, const P& pTrackOppositeCharge, const T& trackSameChargeFirst, const T& trackSameChargeSecond, const T& trackOppositeCharge);
   template <typename T, typename H2>
   int8_t isSelectedD0InMassRange(const T& pTrackPos, const T& pTrackNeg, const float& ptD, int8_t isSelected, const int& activateQA, H2 hMassVsPt);
   template <typename T, typename H2>
@@ -694,6 +722,8 @@ class HfFilterHelper
   bool isSelectedProton4CharmOrBeautyBaryons(const T& track);
   template <typename T, typename U>
   int8_t isBDTSelected(const T& scores, const U& thresholdBDTScores);
+  template <typename T>
+  std::array<float, 3> getSkimBdtScores(const T& mlProbSkim);
   template <bool isKaonTrack, typename T>
   bool isSelectedKaonFromXicResoToSigmaC(const T& track);
   template <typename T1, typename T2, typename T3, typename T4>
@@ -720,7 +750,9 @@ class HfFilterHelper
   template <typename T1>
   int setVtxConfiguration(T1& vertexer, bool useAbsDCA);
   template <typename V, typename T, typename C>
-  bool buildV0(V const& v0Indices, T const& tracks, C const& collision, o2::vertexing::DCAFitterN<2>& dcaFitter, const std::vector<int>& vetoedTrackIds, V0Cand& v0Cand);
+  bool buildV0(V const& v0Indices, T const& tracks, C const& collision, o2::vertexing::DCAFitterN<2>& dcaFitter, const std::vector<int>& vetoedTrackIds, V0Cand& v0Cand, bool fillCov = true);
+  template <typename V, typename T, typename C>
+  void buildV0s(V const& v0sThisCollision, T const& tracks, C const& collision, o2::vertexing::DCAFitterN<2>& dcaFitter, V0CandsCollision& v0Cands);
   template <typename Casc, typename T, typename C, typename V>
   bool buildCascade(Casc const& cascIndices, V const& v0Indices, T const& tracks, C const& collision, o2::vertexing::DCAFitterN<2>& dcaFitter, const std::vector<int>& vetoedTrackIds, CascCand& cascCand);
 
@@ -732,6 +764,8 @@ class HfFilterHelper
   // selections
   template <bool is4beauty = false, typename T>
   bool isSelectedKaon4Charm3ProngOrBeautyToJPsi(const T& track);
+  template <typename P>
+  int8_t isSelectedKaKaInPhiMassRange(const P& pTrackSameChargeFirst, const P& pTrackSameChargeSecond, const P& pTrackOppositeCharge);
 
   // PID
   float getTPCSplineCalib(const float tpcPin, const float dEdx, const int& pidSpecies);
@@ -1145,6 +1179,19 @@ inline int8_t HfFilterHelper::isDsPreselected(const P& pTrackSameChargeFirst, co
     return retValue;
   }
 
+  return isSelectedKaKaInPhiMassRange(pTrackSameChargeFirst, pTrackSameChargeSecond, pTrackOppositeCharge);
+}
+
+/// Delta-mass selection of the phi resonance for Ds candidates
+/// \param pTrackSameChargeFirst is the first same-charge track momentum
+/// \param pTrackSameChargeSecond is the second same-charge track momentum
+/// \param pTrackOppositeCharge is the opposite charge track momentum
+/// \return BIT(0) for KKpi, BIT(1) for piKK
+template <typename P>
+inline int8_t HfFilterHelper::isSelectedKaKaInPhiMassRange(const P& pTrackSameChargeFirst, const P& pTrackSameChargeSecond, const P& pTrackOppositeCharge)
+{
+  int8_t retValue = 0;
+
   // check delta-mass for phi resonance
   auto ptDs = RecoDecay::pt(pTrackSameChargeFirst, pTrackSameChargeSecond, pTrackOppositeCharge);
   auto ptBinDs = findBin(mPtBinsPreselDsToKKPi, ptDs);
@@ -1189,6 +1236,52 @@ inline int8_t HfFilterHelper::isCharmBaryonPreselected(const T& trackSameChargeF
   return retValue;
 }
 
+/// Basic additional selections of the D+, Ds+, Lc+ and Xic+ hypotheses of a 3-prong candidate in a single pass,
+/// with the kaon PID of the opposite charge track, common to all of them, checked only once
+/// \param is3Prong are the flags of the hypotheses from the skim, replaced by the results of the corresponding preselections
+/// \param pTrackSameChargeFirst is the first same-charge track momentum
+/// \param pTrackSameChargeSecond is the second same-charge track momentum
+/// \param pTrackOppositeCharge is the opposite charge track momentum
+/// \param trackSameChargeFirst is the first same-charge track
+/// \param trackSameChargeSecond is the second same-charge track
+/// \param trackOppositeCharge is the opposite charge track
+template <std::size_t N, typename P, typename T>
+inline void HfFilterHelper::is3ProngPreselected(std::array<int8_t, N>& is3Prong, const P& pTrackSameChargeFirst, const P& pTrackSameChargeSecond, const P& pTrackOppositeCharge, const T& trackSameChargeFirst, const T& trackSameChargeSecond, const T& trackOppositeCharge)
+{
+  static_assert(N == static_cast<std::size_t>(kNCharmParticles - 1), "one flag per 3-prong charm hadron is expected");
+  if (std::none_of(is3Prong.begin(), is3Prong.end(), [](int8_t flag) { return flag != 0; })) {
+    return;
+  }
+
+  // check PID of opposite charge track
+  if (!isSelectedKaon4Charm3ProngOrBeautyToJPsi(trackOppositeCharge)) {
+    is3Prong.fill(0);
+    return;
+  }
+
+  if (is3Prong[kDplus - 1]) {
+    is3Prong[kDplus - 1] = BIT(0);
+  }
+  if (is3Prong[kDs - 1]) {
+    is3Prong[kDs - 1] = isSelectedKaKaInPhiMassRange(pTrackSameChargeFirst, pTrackSameChargeSecond, pTrackOppositeCharge);
+  }
+  if (is3Prong[kLc - 1] || is3Prong[kXic - 1]) {
+    int8_t presel = 0;
+    if (isSelectedProton4CharmOrBeautyBaryons(trackSameChargeFirst)) {
+      presel |= BIT(0);
+    }
+    if (isSelectedProton4CharmOrBeautyBaryons(trackSameChargeSecond)) {
+      presel |= BIT(1);
+    }
+    if (is3Prong[kLc - 1]) {
+      is3Prong[kLc - 1] = presel;
+    }
+    if (is3Prong[kXic - 1]) {
+      is3Prong[kXic - 1] = presel;
+    }
+  }
+}
+
 /// Basic additional selection of D0 candidates
 /// \param trackPos is the positive track
 /// \param trackNeg is the negative track
@@ -1886,6 +1979,19 @@ inline int8_t HfFilterHelper::isBDTSelected(const T& scores, const U& thresholdB
   return retValue;
 }
 
+/// BDT output scores of a candidate computed in the skimming
+/// \param mlProbSkim are the scores stored in the skimmed candidate table
+/// \return the background, prompt and non-prompt scores, or (2, -1, -1), failing the BDT selections, if they are not available
+template <typename T>
+inline std::array<float, 3> HfFilterHelper::getSkimBdtScores(const T& mlProbSkim)
+{
+  std::array<float, 3> scores{2., -1., -1.};
+  if (mlProbSkim.size() == scores.size()) {
+    std::copy(mlProbSkim.begin(), mlProbSkim.end(), scores.begin());
+  }
+  return scores;
+}
+
 /// Computation of the relative momentum between particle pairs
 /// \param pTrack is the track momentum array
 /// \param ProtonMass is the mass of a proton
@@ -2736,8 +2842,9 @@ inline std::array<T, 2> HfFilterHelper::alphaAndQtAP(std::array<T, 3> const& mom
 /// \param collision collision
 /// \param dcaFitter DCA fitter to be used
 /// \param vetoedTrackIds vector with forbidden track indices, if any
+/// \param fillCov fill the covariance matrix of the V0, needed only to build a track out of it
 template <typename V, typename T, typename C>
-inline bool HfFilterHelper::buildV0(V const& v0Indices, T const& tracks, C const& collision, o2::vertexing::DCAFitterN<2>& dcaFitter, const std::vector<int>& vetoedTrackIds, V0Cand& v0Cand)
+inline bool HfFilterHelper::buildV0(V const& v0Indices, T const& tracks, C const& collision, o2::vertexing::DCAFitterN<2>& dcaFitter, const std::vector<int>& vetoedTrackIds, V0Cand& v0Cand, bool fillCov)
 {
   auto trackPos = tracks.rawIteratorAt(v0Indices.posTrackId());
   auto trackNeg = tracks.rawIteratorAt(v0Indices.negTrackId());
@@ -2805,21 +2912,23 @@ inline bool HfFilterHelper::buildV0(V const& v0Indices, T const& tracks, C const
   for (int iCoord{0}; iCoord < 3; ++iCoord) {
     v0Cand.vtx[iCoord] = vtx[iCoord];
   }
-  auto covVtxV = dcaFitter.calcPCACovMatrix(0);
   v0Cand.cov = {};
-  v0Cand.cov[0] = covVtxV(0, 0);
-  v0Cand.cov[1] = covVtxV(1, 0);
-  v0Cand.cov[2] = covVtxV(1, 1);
-  v0Cand.cov[3] = covVtxV(2, 0);
-  v0Cand.cov[4] = covVtxV(2, 1);
-  v0Cand.cov[5] = covVtxV(2, 2);
-  std::array<float, 21> covTpositive = {0.};
-  std::array<float, 21> covTnegative = {0.};
-  trackPosProp.getCovXYZPxPyPzGlo(covTpositive);
-  trackNegProp.getCovXYZPxPyPzGlo(covTnegative);
-  constexpr int MomInd[6] = {9, 13, 14, 18, 19, 20}; // cov matrix elements for momentum component
-  for (int iCoord{0}; iCoord < 6; ++iCoord) {
-    v0Cand.cov[MomInd[iCoord]] = covTpositive[MomInd[iCoord]] + covTnegative[MomInd[iCoord]];
+  if (fillCov) {
+    auto covVtxV = dcaFitter.calcPCACovMatrix(0);
+    v0Cand.cov[0] = covVtxV(0, 0);
+    v0Cand.cov[1] = covVtxV(1, 0);
+    v0Cand.cov[2] = covVtxV(1, 1);
+    v0Cand.cov[3] = covVtxV(2, 0);
+    v0Cand.cov[4] = covVtxV(2, 1);
+    v0Cand.cov[5] = covVtxV(2, 2);
+    std::array<float, 21> covTpositive = {0.};
+    std::array<float, 21> covTnegative = {0.};
+    trackPosProp.getCovXYZPxPyPzGlo(covTpositive);
+    trackNegProp.getCovXYZPxPyPzGlo(covTnegative);
+    constexpr int MomInd[6] = {9, 13, 14, 18, 19, 20}; // cov matrix elements for momentum component
+    for (int iCoord{0}; iCoord < 6; ++iCoord) {
+      v0Cand.cov[MomInd[iCoord]] = covTpositive[MomInd[iCoord]] + covTnegative[MomInd[iCoord]];
+    }
   }
   v0Cand.v0radius = std::hypot(vtx[0], vtx[1]);
   v0Cand.v0cosPA = RecoDecay::cpa(primVtx, vtx, v0Cand.mom);
@@ -2853,6 +2962,27 @@ inline bool HfFilterHelper::buildV0(V const& v0Indices, T const& tracks, C const
   return true;
 }
 
+/// build all the V0 candidates of a collision, without covariance matrix, to be shared by all the charm-hadron candidates
+/// the daughters of the charm-hadron candidates are vetoed afterwards with V0CandsCollision::isVetoed
+/// \param v0sThisCollision V0 candidates of the collision from AO2D table (track indices)
+/// \param tracks track table
+/// \param collision collision
+/// \param dcaFitter DCA fitter to be used
+/// \param v0Cands reconstructed V0s, at the positions of the V0s of the table
+template <typename V, typename T, typename C>
+inline void HfFilterHelper::buildV0s(V const& v0sThisCollision, T const& tracks, C const& collision, o2::vertexing::DCAFitterN<2>& dcaFitter, V0CandsCollision& v0Cands)
+{
+  v0Cands.clear();
+  const std::vector<int> noVetoedTrackIds{};
+  for (const auto& v0 : v0sThisCollision) {
+    V0Cand& v0Cand = v0Cands.cands.emplace_back();
+    v0Cands.posTrackIds.push_back(v0.posTrackId());
+    v0Cands.negTrackIds.push_back(v0.negTrackId());
+    v0Cands.isBuilt.push_back(buildV0(v0, tracks, collision, dcaFitter, noVetoedTrackIds, v0Cand, false));
+  }
+  v0Cands.isFilled = true;
+}
+
 /// build cascade candidate from table with track indices
 /// \param cascIndices cascade candidate from AO2D table (track indices)
 /// \param v0Indices V0 candidate from AO2D table (track indices)
@@ -14,8 +14,9 @@
 #include <rapidjson/document.h>
 #include <rapidjson/filereadstream.h>
 
+#include <array>
+#include <bit>
 #include <cstdio>
-#include <random>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -28,6 +29,7 @@
 #include "Framework/AnalysisDataModel.h"
 #include "Framework/ASoAHelpers.h"
 #include "Framework/HistogramRegistry.h"
+#include "Common/Core/TriggerDownscaling.h"
 #include "Common/DataModel/EventSelection.h"
 #include "Common/DataModel/TrackSelectionTables.h"
 #include "CommonConstants/LHCConstants.h"
@@ -230,13 +232,27 @@ struct centralEventFilterTask {
   FILTER_CONFIGURABLE(PhotonFilters);
   FILTER_CONFIGURABLE(HeavyNeutralMesonFilters);
 
+  using TriggerMask = o2::common::core::TriggerDownscaling::Mask;
+
+  // trigger channel (bit in the CEFP masks) of each column of the filter tables, compiled at init
+  struct FilterTableChannels {
+    std::string tableName;
+    std::vector<std::pair<std::string, int>> columns;
+  };
+  std::vector<FilterTableChannels> mChannels;
+  o2::common::core::TriggerDownscaling mDownscaler;
+  int nCols{0};
+
   void init(o2::framework::InitContext& initc)
   {
     LOG(debug) << "Start init";
-    int nCols{0};
+    nCols = 0;
     for (auto& table : mDownscaling) {
       nCols += table.second.size();
     }
+    if (nCols > o2::common::core::TriggerDownscaling::NChannels) {
+      LOGF(fatal, "Too many trigger columns: %d, at most %d are supported", nCols, o2::common::core::TriggerDownscaling::NChannels);
+    }
     LOG(debug) << "Middle init, total number of columns " << nCols;
 
     auto mScalers = std::get<std::shared_ptr<TH1>>(scalers.add("mScalers", ";;Number of events", HistType::kTH1D, {{nCols + 2, -0.5, 1.5 + nCols}}));
@@ -249,25 +265,31 @@ struct centralEventFilterTask {
     mFiltered->GetXaxis()->SetBinLabel(nCols + 2, "Filtered events");
     int bin{2};
 
+    mChannels.clear();
     for (auto& table : mDownscaling) {
       LOG(info) << "Setting downscalings for table " << table.first;
+      auto& channels = mChannels.emplace_back(FilterTableChannels{table.first, {}});
       for (auto& column : table.second) {
         mCovariance->GetXaxis()->SetBinLabel(bin - 1, column.first.data());
         mCovariance->GetYaxis()->SetBinLabel(bin - 1, column.first.data());
         mScalers->GetXaxis()->SetBinLabel(bin, column.first.data());
+        channels.columns.emplace_back(column.first, bin - 2);
         mFiltered->GetXaxis()->SetBinLabel(bin++, column.first.data());
       }
-      if (!initc.options().isSet(table.first.data())) {
-        continue;
+      if (initc.options().isSet(table.first.data())) {
+        auto filterOpt = initc.mOptions.get<LabeledArray<float>>(table.first.data());
+        for (auto& col : table.second) {
+          LOG(info) << "- Channel " << col.first << ": " << filterOpt.get(col.first.data(), 0u);
+          col.second = filterOpt.get(col.first.data(), 0u);
+        }
       }
-      auto filterOpt = initc.mOptions.get<LabeledArray<float>>(table.first.data());
-      for (auto& col : table.second) {
-        LOG(info) << "- Channel " << col.first << ": " << filterOpt.get(col.first.data(), 0u);
-        col.second = filterOpt.get(col.first.data(), 0u);
+      for (auto& [colName, channel] : channels.columns) {
+        mDownscaler.setDownscaling(channel, table.second[colName]);
       }
     }
     if (cfgDisableDownscalings.value) {
       LOG(info) << "Downscalings are disabled for all channels.";
+      mDownscaler.disableDownscalings();
     }
   }
 
@@ -311,16 +333,16 @@ struct centralEventFilterTask {
     auto mCovariance{scalers.get<TH2>(HIST("mCovariance"))};
 
     int64_t nEvents{collTabPtr->num_rows()};
-    std::vector<std::array<uint64_t, 2>> outTrigger, outDecision;
-    for (auto& tableName : mDownscaling) {
-      if (!pc.inputs().isValid(tableName.first)) {
-        LOG(fatal) << tableName.first << " table is not valid.";
+    std::vector<TriggerMask> outTrigger, outDecision;
+    for (auto& table : mChannels) {
+      if (!pc.inputs().isValid(table.tableName)) {
+        LOG(fatal) << table.tableName << " table is not valid.";
       }
-      auto tableConsumer = pc.inputs().get<TableConsumer>(tableName.first);
+      auto tableConsumer = pc.inputs().get<TableConsumer>(table.tableName);
       auto tablePtr{tableConsumer->asArrowTable()};
       int64_t nRows{tablePtr->num_rows()};
       if (nEvents != nRows) {
-        LOGF(fatal, "Inconsistent number of rows in the trigger table %s: %lld but it should be %lld", tableName.first.data(), nRows, nEvents);
+        LOGF(fatal, "Inconsistent number of rows in the trigger table %s: %lld but it should be %lld", table.tableName.data(), nRows, nEvents);
       }
 
       if (outDecision.size() == 0) {
@@ -328,65 +350,67 @@ struct centralEventFilterTask {
         outTrigger.resize(nEvents, {0ull, 0ull});
       }
 
-      auto schema{tablePtr->schema()};
-      for (auto& colName : tableName.second) {
-        uint64_t bin{static_cast<uint64_t>(mScalers->GetXaxis()->FindBin(colName.first.data()))};
-        double binCenter{mScalers->GetXaxis()->GetBinCenter(bin)};
-        uint64_t decisionBin{(bin - 2) / 64};
-        uint64_t triggerBit{BIT((bin - 2) % 64)};
-        auto column{tablePtr->GetColumnByName(colName.first)};
-        double downscaling{cfgDisableDownscalings.value ? 1. : colName.second};
+      // the columns are or-ed into the trigger masks without branching on the values
+      for (auto& [colName, channel] : table.columns) {
+        const int decisionWord{channel / 64};
+        const int triggerShift{channel % 64};
+        auto column{tablePtr->GetColumnByName(colName)};
         if (column) {
           int entry = 0;
           for (int64_t iC{0}; iC < column->num_chunks(); ++iC) {
             auto chunk{column->chunk(iC)};
             auto boolArray = std::static_pointer_cast<arrow::BooleanArray>(chunk);
             for (int64_t iS{startCollision}; iS < chunk->length(); ++iS) {
-              if (boolArray->Value(iS)) {
-                mScalers->Fill(binCenter);
-                outTrigger[entry][decisionBin] |= triggerBit;
-                if (mUniformGenerator(mGeneratorEngine) < downscaling) {
-                  mFiltered->Fill(binCenter);
-                  outDecision[entry][decisionBin] |= triggerBit;
-                }
-              }
-              entry++;
+              outTrigger[entry++][decisionWord] |= static_cast<uint64_t>(boolArray->Value(iS)) << triggerShift;
             }
           }
         }
       }
     }
+    mDownscaler.apply(outTrigger, outDecision);
     mScalers->SetBinContent(1, mScalers->GetBinContent(1) + nEvents - startCollision);
     mFiltered->SetBinContent(1, mFiltered->GetBinContent(1) + nEvents - startCollision);
 
+    // the counters of the data frame are accumulated looping on the set bits only, and added to the histograms at the end
+    std::vector<uint64_t> triggerCounts(nCols, 0ull), filterCounts(nCols, 0ull), covarianceCounts(nCols * nCols, 0ull);
+    uint64_t nTriggered{0ull}, nSelected{0ull};
+    std::vector<int> firedChannels;
+    firedChannels.reserve(nCols);
     for (uint64_t iE{0}; iE < outTrigger.size(); ++iE) {
       const auto& triggerWord{outTrigger[iE]};
-      bool triggered{false}, selected{false};
-      for (uint64_t iD{0}; iD < triggerWord.size(); ++iD) {
-        for (int iB{0}; iB < 64; ++iB) {
-          if (!(triggerWord[iD] & BIT(iB))) {
-            continue;
-          }
-          uint64_t xIndex{iD * 64 + iB};
-          for (uint64_t jD{0}; jD < triggerWord.size(); ++jD) {
-            for (int jB{0}; jB < 64; ++jB) {
-              uint64_t yIndex{jD * 64 + jB};
-              if (xIndex <= yIndex && triggerWord[jD] & BIT(jB)) {
-                mCovariance->Fill(iD * 64 + iB, jD * 64 + jB);
-              }
-            }
-          }
+      firedChannels.clear();
+      for (int iD{0}; iD < static_cast<int>(triggerWord.size()); ++iD) {
+        for (uint64_t fired{triggerWord[iD]}; fired; fired &= fired - 1) {
+          firedChannels.push_back(iD * 64 + std::countr_zero(fired));
+        }
+        for (uint64_t selected{outDecision[iE][iD]}; selected; selected &= selected - 1) {
+          filterCounts[iD * 64 + std::countr_zero(selected)]++;
         }
-        triggered = triggered || triggerWord[iD];
-        selected = selected || outDecision[iE][iD];
       }
-      if (triggered) {
-        mScalers->Fill(mScalers->GetNbinsX() - 1);
+      for (size_t iF{0}; iF < firedChannels.size(); ++iF) {
+        triggerCounts[firedChannels[iF]]++;
+        for (size_t jF{iF}; jF < firedChannels.size(); ++jF) {
+          covarianceCounts[firedChannels[iF] * nCols + firedChannels[jF]]++;
+        }
       }
-      if (selected) {
-        mFiltered->Fill(mFiltered->GetNbinsX() - 1);
+      nTriggered += !firedChannels.empty();
+      nSelected += (outDecision[iE][0] | outDecision[iE][1]) != 0;
+    }
+    for (int iCol{0}; iCol < nCols; ++iCol) {
+      if (triggerCounts[iCol]) {
+        mScalers->SetBinContent(iCol + 2, mScalers->GetBinContent(iCol + 2) + triggerCounts[iCol]);
+      }
+      if (filterCounts[iCol]) {
+        mFiltered->SetBinContent(iCol + 2, mFiltered->GetBinContent(iCol + 2) + filterCounts[iCol]);
+      }
+      for (int jCol{iCol}; jCol < nCols; ++jCol) {
+        if (covarianceCounts[iCol * nCols + jCol]) {
+          mCovariance->SetBinContent(iCol + 1, jCol + 1, mCovariance->GetBinContent(iCol + 1, jCol + 1) + covarianceCounts[iCol * nCols + jCol]);
+        }
       }
     }
+    mScalers->SetBinContent(nCols + 2, mScalers->GetBinContent(nCols + 2) + nTriggered);
+    mFiltered->SetBinContent(nCols + 2, mFiltered->GetBinContent(nCols + 2) + nSelected);
 
     if (outDecision.size() != static_cast<uint64_t>(nEvents)) {
       LOGF(fatal, "Inconsistent number of rows across Collision table and CEFP decision vector.");
@@ -411,8 +435,6 @@ struct centralEventFilterTask {
   {
   }
 
-  std::mt19937_64 mGeneratorEngine;
-  std::uniform_real_distribution<double> mUniformGenerator = std::uniform_real_distribution<double>(0., 1.);
 };
 
 WorkflowSpec defineDataProcessing(ConfigContext const& cfg)
@@ -0,0 +1,322 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#ifndef O2_ANALYSIS_BINNEDCORRELATOR_H
+#define O2_ANALYSIS_BINNEDCORRELATOR_H
+
+#include "Framework/Logger.h"
+#include "CommonConstants/MathConstants.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Two-particle correlations from binned single-particle distributions
+//
+// The trigger and associated particles of an event are filled in eta-phi occupancy grids per pT bin, whose cells
+// have the widths of the delta eta and delta phi bins of the pair histogram. The pair distribution is the cross-correlation
+// of the grids: two cells separated by k cells in eta give a triangular delta eta distribution between (k-1) and (k+1) cell widths,
+// of which one half is filled in each of the two adjacent delta eta bins (same in phi). The pair histogram is then filled once
+// per non-empty (pT trigger, pT associated, delta eta, delta phi) bin instead of once per pair.
+// The pT bins for which the pT ordering of the pair can not be decided from the bin limits are correlated pair by pair.
+
+class BinnedCorrelator
+{
+ public:
+  /// \param edgesDeltaEta and edgesDeltaPhi are the bin limits of the pair histogram, which must be of fixed width (the delta phi axis covering 2 pi)
+  /// \param edgesPtAssoc and edgesPtTrigger are the pT bin limits of the pair histogram
+  /// \param etaCut is the eta range of the particles
+  /// \param ptOrder only the pairs with pT,assoc < pT,trigger are correlated
+  void Init(const std::vector<double>& edgesDeltaEta, const std::vector<double>& edgesDeltaPhi, const std::vector<double>& edgesPtAssoc, const std::vector<double>& edgesPtTrigger, float etaCut, bool ptOrder)
+  {
+    mDeltaEta = MakeAxis(edgesDeltaEta, "delta eta");
+    mDeltaPhi = MakeAxis(edgesDeltaPhi, "delta phi");
+    if (std::abs(mDeltaPhi.n * mDeltaPhi.width - o2::constants::math::TwoPI) > 1e-3 * mDeltaPhi.width) {
+      LOGF(fatal, "BinnedCorrelator: the delta phi axis must cover 2 pi, got %d bins of width %f", mDeltaPhi.n, mDeltaPhi.width);
+    }
+    mEdgesPtAssoc = edgesPtAssoc;
+    mEdgesPtTrigger = edgesPtTrigger;
+    mNPtAssoc = static_cast<int>(mEdgesPtAssoc.size()) - 1;
+    mNPtTrigger = static_cast<int>(mEdgesPtTrigger.size()) - 1;
+    mEtaCut = etaCut;
+    mNEta = std::max(1, static_cast<int>(std::ceil(2 * etaCut / mDeltaEta.width - 1e-6)));
+    mNPhi = mDeltaPhi.n;
+    mPtOrder = ptOrder;
+
+    // the two delta eta (phi) bins filled by the cells separated by k cells
+    mDeltaEtaBins.resize(2 * mNEta - 1);
+    for (int k = -(mNEta - 1); k < mNEta; k++) {
+      mDeltaEtaBins[k + mNEta - 1] = {mDeltaEta.FindBin((k - 0.5) * mDeltaEta.width), mDeltaEta.FindBin((k + 0.5) * mDeltaEta.width)};
+    }
+    mDeltaPhiBins.resize(mNPhi);
+    for (int l = 0; l < mNPhi; l++) {
+      mDeltaPhiBins[l] = {mDeltaPhi.FindBin(WrapDeltaPhi((l - 0.5) * mDeltaPhi.width)), mDeltaPhi.FindBin(WrapDeltaPhi((l + 0.5) * mDeltaPhi.width))};
+    }
+
+    mTriggerGrids.assign(mNPtTrigger, Grid{});
+    mAssociatedGrids.assign(mNPtAssoc, Grid{});
+    for (auto& grid : mTriggerGrids) {
+      grid.weights.assign(mNEta * mNPhi, 0.f);
+    }
+    for (auto& grid : mAssociatedGrids) {
+      grid.weights.assign(mNEta * mNPhi, 0.f);
+    }
+    mPairs.assign(static_cast<std::size_t>(mNPtTrigger) * mNPtAssoc * mDeltaEta.n * mDeltaPhi.n, 0.f);
+
+    LOGF(info, "BinnedCorrelator: %d x %d eta-phi cells, %d trigger and %d associated pT bins", mNEta, mNPhi, mNPtTrigger, mNPtAssoc);
+  }
+
+  /// Removes the particles of the previous event
+  void Clear()
+  {
+    ClearGrids(mTriggerGrids);
+    ClearGrids(mAssociatedGrids);
+  }
+
+  void AddTrigger(float eta, float phi, float pt, float weight, int64_t index)
+  {
+    AddParticle(mTriggerGrids, mEdgesPtTrigger, eta, phi, pt, weight, index);
+  }
+
+  void AddAssociated(float eta, float phi, float pt, float weight, int64_t index)
+  {
+    AddParticle(mAssociatedGrids, mEdgesPtAssoc, eta, phi, pt, weight, index);
+  }
+
+  /// Fills the pair histogram with the pairs of the added particles
+  /// \param pairHist is the StepTHn of the pairs, with the axes delta eta, pT assoc, pT trigger, multiplicity, delta phi, z-vtx
+  /// \param sameEvent the trigger and associated particles are from the same event, the pairs of a particle with itself are removed
+  template <typename THist>
+  void Fill(THist* pairHist, int step, float multiplicity, float posZ, bool sameEvent)
+  {
+    std::fill(mPairs.begin(), mPairs.end(), 0.f);
+    bool anyPair = false;
+
+    for (int iPtTrigger = 0; iPtTrigger < mNPtTrigger; iPtTrigger++) {
+      const Grid& trigger = mTriggerGrids[iPtTrigger];
+      if (trigger.particles.empty()) {
+        continue;
+      }
+      for (int iPtAssoc = 0; iPtAssoc < mNPtAssoc; iPtAssoc++) {
+        const Grid& associated = mAssociatedGrids[iPtAssoc];
+        if (associated.particles.empty()) {
+          continue;
+        }
+        if (mPtOrder) {
+          if (mEdgesPtAssoc[iPtAssoc] >= mEdgesPtTrigger[iPtTrigger + 1]) {
+            continue; // pT,assoc >= pT,trigger for all the pairs
+          }
+          if (mEdgesPtAssoc[iPtAssoc + 1] > mEdgesPtTrigger[iPtTrigger]) {
+            FillPairByPair(pairHist, step, multiplicity, posZ, sameEvent, trigger, associated);
+            continue;
+          }
+        }
+        CorrelateGrids(iPtTrigger, iPtAssoc, trigger, associated, sameEvent);
+        anyPair = true;
+      }
+    }
+
+    if (!anyPair) {
+      return;
+    }
+    std::size_t iPair = 0;
+    for (int iPtTrigger = 0; iPtTrigger < mNPtTrigger; iPtTrigger++) {
+      const float ptTrigger = 0.5 * (mEdgesPtTrigger[iPtTrigger] + mEdgesPtTrigger[iPtTrigger + 1]);
+      for (int iPtAssoc = 0; iPtAssoc < mNPtAssoc; iPtAssoc++) {
+        const float ptAssoc = 0.5 * (mEdgesPtAssoc[iPtAssoc] + mEdgesPtAssoc[iPtAssoc + 1]);
+        for (int iDeltaEta = 0; iDeltaEta < mDeltaEta.n; iDeltaEta++) {
+          for (int iDeltaPhi = 0; iDeltaPhi < mDeltaPhi.n; iDeltaPhi++, iPair++) {
+            if (mPairs[iPair] != 0.f) {
+              pairHist->Fill(step, mDeltaEta.Center(iDeltaEta), ptAssoc, ptTrigger, multiplicity, mDeltaPhi.Center(iDeltaPhi), posZ, mPairs[iPair]);
+            }
+          }
+        }
+      }
+    }
+  }
+
+ protected:
+  struct Axis {
+    double low = 0;
+    double width = 1;
+    int n = 0;
+
+    int FindBin(double value) const
+    {
+      const int bin = static_cast<int>(std::floor((value - low) / width + 1e-6));
+      return (bin >= 0 && bin < n) ? bin : -1;
+    }
+    double Center(int bin) const { return low + (bin + 0.5) * width; }
+  };
+
+  struct Particle {
+    float eta;
+    float phi;
+    float pt;
+    float weight;
+    int64_t index;
+    int cell;
+  };
+
+  struct Grid {
+    std::vector<float> weights;      // summed weights of the particles per eta-phi cell
+    std::vector<int> cells;          // non-empty cells
+    std::vector<Particle> particles; // particles of the event
+  };
+
+  static Axis MakeAxis(const std::vector<double>& edges, const char* name)
+  {
+    if (edges.size() < 2) {
+      LOGF(fatal, "BinnedCorrelator: no bins for the %s axis", name);
+    }
+    Axis axis;
+    axis.low = edges.front();
+    axis.n = static_cast<int>(edges.size()) - 1;
+    axis.width = (edges.back() - edges.front()) / axis.n;
+    for (int i = 1; i <= axis.n; i++) {
+      if (std::abs(edges[i] - edges[i - 1] - axis.width) > 1e-3 * axis.width) {
+        LOGF(fatal, "BinnedCorrelator: the %s axis must have bins of fixed width", name);
+      }
+    }
+    // the differences of cells are multiples of the width, which must fall on bin edges
+    const double offset = axis.low / axis.width;
+    if (std::abs(offset - std::round(offset)) > 1e-3) {
+      LOGF(fatal, "BinnedCorrelator: the edges of the %s axis must be multiples of its bin width %f", name, axis.width);
+    }
+    return axis;
+  }
+
+  double WrapDeltaPhi(double deltaPhi) const
+  {
+    while (deltaPhi < mDeltaPhi.low) {
+      deltaPhi += o2::constants::math::TwoPI;
+    }
+    while (deltaPhi >= mDeltaPhi.low + o2::constants::math::TwoPI) {
+      deltaPhi -= o2::constants::math::TwoPI;
+    }
+    return deltaPhi;
+  }
+
+  void ClearGrids(std::vector<Grid>& grids)
+  {
+    for (auto& grid : grids) {
+      for (const int cell : grid.cells) {
+        grid.weights[cell] = 0.f;
+      }
+      grid.cells.clear();
+      grid.particles.clear();
+    }
+  }
+
+  void AddParticle(std::vector<Grid>& grids, const std::vector<double>& edgesPt, float eta, float phi, float pt, float weight, int64_t index)
+  {
+    if (pt < edgesPt.front() || pt >= edgesPt.back()) {
+      return;
+    }
+    const int iPt = static_cast<int>(std::upper_bound(edgesPt.begin(), edgesPt.end(), pt) - edgesPt.begin()) - 1;
+    const int iEta = std::clamp(static_cast<int>(std::floor((eta + mEtaCut) / mDeltaEta.width)), 0, mNEta - 1);
+    float phiInRange = std::fmod(phi, o2::constants::math::TwoPI);
+    if (phiInRange < 0) {
+      phiInRange += o2::constants::math::TwoPI;
+    }
+    const int iPhi = std::min(static_cast<int>(phiInRange / mDeltaPhi.width), mNPhi - 1);
+    const int cell = iEta * mNPhi + iPhi;
+    Grid& grid = grids[iPt];
+    if (grid.weights[cell] == 0.f) {
+      grid.cells.push_back(cell);
+    }
+    grid.weights[cell] += weight;
+    grid.particles.push_back({eta, phi, pt, weight, index, cell});
+  }
+
+  void CorrelateGrids(int iPtTrigger, int iPtAssoc, const Grid& trigger, const Grid& associated, bool sameEvent)
+  {
+    float* pairs = &mPairs[(static_cast<std::size_t>(iPtTrigger) * mNPtAssoc + iPtAssoc) * mDeltaEta.n * mDeltaPhi.n];
+    auto addCells = [&](int cellTrigger, int cellAssoc, float weight) {
+      const int k = cellTrigger / mNPhi - cellAssoc / mNPhi;
+      const int l = (cellTrigger % mNPhi - cellAssoc % mNPhi + mNPhi) % mNPhi;
+      const auto& binsEta = mDeltaEtaBins[k + mNEta - 1];
+      const auto& binsPhi = mDeltaPhiBins[l];
+      for (const int binEta : binsEta) {
+        if (binEta < 0) {
+          continue;
+        }
+        for (const int binPhi : binsPhi) {
+          if (binPhi >= 0) {
+            pairs[binEta * mDeltaPhi.n + binPhi] += 0.25f * weight;
+          }
+        }
+      }
+    };
+
+    for (const int cellTrigger : trigger.cells) {
+      const float weightTrigger = trigger.weights[cellTrigger];
+      for (const int cellAssoc : associated.cells) {
+        addCells(cellTrigger, cellAssoc, weightTrigger * associated.weights[cellAssoc]);
+      }
+    }
+
+    // pairs of a particle with itself, which is both trigger and associated
+    if (sameEvent && mEdgesPtTrigger[iPtTrigger] == mEdgesPtAssoc[iPtAssoc] && mEdgesPtTrigger[iPtTrigger + 1] == mEdgesPtAssoc[iPtAssoc + 1]) {
+      mAssociatedWeights.clear();
+      for (const auto& particle : associated.particles) {
+        mAssociatedWeights[particle.index] = particle.weight;
+      }
+      for (const auto& particle : trigger.particles) {
+        if (auto it = mAssociatedWeights.find(particle.index); it != mAssociatedWeights.end()) {
+          addCells(particle.cell, particle.cell, -particle.weight * it->second);
+        }
+      }
+    }
+  }
+
+  template <typename THist>
+  void FillPairByPair(THist* pairHist, int step, float multiplicity, float posZ, bool sameEvent, const Grid& trigger, const Grid& associated)
+  {
+    for (const auto& particle1 : trigger.particles) {
+      for (const auto& particle2 : associated.particles) {
+        if (sameEvent && particle1.index == particle2.index) {
+          continue;
+        }
+        if (mPtOrder && particle2.pt >= particle1.pt) {
+          continue;
+        }
+        const float deltaPhi = WrapDeltaPhi(particle1.phi - particle2.phi);
+        pairHist->Fill(step, particle1.eta - particle2.eta, particle2.pt, particle1.pt, multiplicity, deltaPhi, posZ, particle1.weight * particle2.weight);
+      }
+    }
+  }
+
+  Axis mDeltaEta;
+  Axis mDeltaPhi;
+  std::vector<double> mEdgesPtAssoc;
+  std::vector<double> mEdgesPtTrigger;
+  int mNPtAssoc = 0;
+  int mNPtTrigger = 0;
+  float mEtaCut = 0.8f;
+  int mNEta = 1; // number of eta cells
+  int mNPhi = 1; // number of phi cells
+  bool mPtOrder = false;
+
+  std::vector<std::array<int, 2>> mDeltaEtaBins; // delta eta bins filled by a difference of eta cells
+  std::vector<std::array<int, 2>> mDeltaPhiBins; // delta phi bins filled by a difference of phi cells
+
+  std::vector<Grid> mTriggerGrids;    // per trigger pT bin
+  std::vector<Grid> mAssociatedGrids; // per associated pT bin
+  std::vector<float> mPairs;          // pairs per (pT trigger, pT assoc, delta eta, delta phi) bin
+  std::unordered_map<int64_t, float> mAssociatedWeights;
+};
+
+#endif // O2_ANALYSIS_BINNEDCORRELATOR_H
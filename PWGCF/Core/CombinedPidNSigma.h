@@ -0,0 +1,95 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#ifndef O2_ANALYSIS_COMBINEDPIDNSIGMA_H
+#define O2_ANALYSIS_COMBINEDPIDNSIGMA_H
+
+#include "Common/DataModel/PIDResponseTOF.h"
+#include "Common/DataModel/PIDResponseTPC.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// TPC, TOF and combined n_sigma of the tracks of a data frame (or of a collision) for a set of species
+//
+// The n_sigma are read and combined, sqrt(n_sigma_TPC^2 + n_sigma_TOF^2), once per track and species and stored
+// as columns indexed by the global index of the track, together with the TOF availability of the track,
+// such that the selections of a producer do not repeat the same lookups and arithmetic for every use.
+// The combined n_sigma is computed also for the tracks without TOF, as the CF producers do: use hasTOF() to branch.
+
+class CombinedPidNSigma
+{
+ public:
+  /// \param species are the PID indices (o2::track::PID) of the species to be computed
+  void Init(const std::vector<int>& species)
+  {
+    mSpecies = species;
+  }
+
+  /// Computes the n_sigma of all the tracks, which must be sorted by global index as the tables and their slices are
+  template <typename TTracks>
+  void Fill(TTracks const& tracks)
+  {
+    mFirstIndex = 0;
+    mNTracks = 0;
+    if (tracks.size() == 0) {
+      return;
+    }
+    int64_t lastIndex = 0;
+    bool first = true;
+    for (auto const& track : tracks) {
+      if (first) {
+        mFirstIndex = track.globalIndex();
+        first = false;
+      }
+      lastIndex = track.globalIndex();
+    }
+    mNTracks = static_cast<std::size_t>(lastIndex - mFirstIndex + 1);
+    mHasTOF.assign(mNTracks, 0);
+    mTPC.resize(mNTracks * mSpecies.size());
+    mTOF.resize(mNTracks * mSpecies.size());
+    mCombined.resize(mNTracks * mSpecies.size());
+    for (auto const& track : tracks) {
+      const std::size_t row = track.globalIndex() - mFirstIndex;
+      mHasTOF[row] = track.hasTOF();
+      for (std::size_t iSpecies = 0; iSpecies < mSpecies.size(); iSpecies++) {
+        const float nSigmaTPC = o2::aod::pidutils::tpcNSigma(mSpecies[iSpecies], track);
+        const float nSigmaTOF = o2::aod::pidutils::tofNSigma(mSpecies[iSpecies], track);
+        const std::size_t cell = iSpecies * mNTracks + row;
+        mTPC[cell] = nSigmaTPC;
+        mTOF[cell] = nSigmaTOF;
+        mCombined[cell] = std::sqrt(nSigmaTPC * nSigmaTPC + nSigmaTOF * nSigmaTOF);
+      }
+    }
+  }
+
+  /// \param iSpecies is the position of the species in the list given to Init
+  /// \param trackIndex is the global index of the track
+  float TPC(std::size_t iSpecies, int64_t trackIndex) const { return mTPC[cell(iSpecies, trackIndex)]; }
+  float TOF(std::size_t iSpecies, int64_t trackIndex) const { return mTOF[cell(iSpecies, trackIndex)]; }
+  float Combined(std::size_t iSpecies, int64_t trackIndex) const { return mCombined[cell(iSpecies, trackIndex)]; }
+  bool HasTOF(int64_t trackIndex) const { return mHasTOF[trackIndex - mFirstIndex]; }
+
+ private:
+  std::size_t cell(std::size_t iSpecies, int64_t trackIndex) const { return iSpecies * mNTracks + (trackIndex - mFirstIndex); }
+
+  std::vector<int> mSpecies{};
+  int64_t mFirstIndex = 0;
+  std::size_t mNTracks = 0;
+  std::vector<uint8_t> mHasTOF{}; // TOF availability per track
+  std::vector<float> mTPC{};      // per species, then per track
+  std::vector<float> mTOF{};      // per species, then per track
+  std::vector<float> mCombined{}; // per species, then per track
+};
+
+#endif // O2_ANALYSIS_COMBINEDPIDNSIGMA_H
@@ -0,0 +1,212 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#ifndef O2_ANALYSIS_EVENTMIXINGPOOL_H
+#define O2_ANALYSIS_EVENTMIXINGPOOL_H
+
+#include "Framework/HistogramSpec.h"
+#include "Framework/Logger.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <utility>
+#include <vector>
+
+// Pool of the associated particles of the last events of each mixing bin, kept across data frames
+//
+// The events are binned in z-vertex and multiplicity. Each bin keeps up to depth events; when the bin is full a new event
+// replaces either the oldest one or a random one. The particles are stored as columns (pt, eta, phi, charge) whose capacity
+// is kept when an event is replaced, and the stored events are returned as spans on the columns for the pair loops.
+// The total number of stored particles can be bounded: above the limit the new events are only stored if they replace older ones.
+
+class EventMixingPool
+{
+ public:
+  enum Eviction {
+    kOldest = 0, // the new event replaces the oldest event of the bin
+    kRandom      // the new event replaces a random event of the bin
+  };
+
+  /// Stored event, as spans on the columns of the pool
+  struct EventView {
+    std::span<const float> pt;
+    std::span<const float> eta;
+    std::span<const float> phi;
+    std::span<const int8_t> sign;
+    float posZ;
+    std::size_t size() const { return pt.size(); }
+  };
+
+  /// \param edgesVtx and edgesMult are the bin limits of the mixing bins
+  /// \param depth is the number of events kept per bin
+  /// \param eviction is the event replaced when the bin is full
+  /// \param maxParticles is the maximum number of stored particles (no limit if <= 0)
+  void Init(const std::vector<double>& edgesVtx, const std::vector<double>& edgesMult, int depth, Eviction eviction = kOldest, int64_t maxParticles = -1, uint64_t seed = 0)
+  {
+    if (depth < 1) {
+      LOGF(fatal, "EventMixingPool: the depth of the pool must be at least 1, got %d", depth);
+    }
+    if (edgesVtx.size() < 2 || edgesMult.size() < 2) {
+      LOGF(fatal, "EventMixingPool: the mixing bins need at least two limits in z-vertex and multiplicity");
+    }
+    mEdgesVtx = edgesVtx;
+    mEdgesMult = edgesMult;
+    mDepth = depth;
+    mEviction = eviction;
+    mMaxParticles = maxParticles;
+    mRandom.seed(seed);
+    mBins.assign((mEdgesVtx.size() - 1) * (mEdgesMult.size() - 1), Bin{});
+    mNStoredParticles = 0;
+    mWarnedMaxParticles = false;
+  }
+
+  /// \return the limits of a ConfigurableAxis, given with VARIABLE_WIDTH or as {nBins, min, max}
+  static std::vector<double> GetAxisEdges(const std::vector<double>& axis)
+  {
+    if (axis[0] == o2::framework::VARIABLE_WIDTH) {
+      return std::vector<double>(axis.begin() + 1, axis.end());
+    }
+    const int nBins = static_cast<int>(axis[0]);
+    std::vector<double> edges(nBins + 1);
+    for (int i = 0; i <= nBins; i++) {
+      edges[i] = axis[1] + (axis[2] - axis[1]) * i / nBins;
+    }
+    return edges;
+  }
+
+  /// \return the mixing bin of the event, -1 outside of the bins
+  int GetBin(float posZ, float mult) const
+  {
+    const int binVtx = FindBin(mEdgesVtx, posZ);
+    const int binMult = FindBin(mEdgesMult, mult);
+    if (binVtx < 0 || binMult < 0) {
+      return -1;
+    }
+    return binMult * (static_cast<int>(mEdgesVtx.size()) - 1) + binVtx;
+  }
+
+  /// Starts the staging of the particles of a new event, to be mixed with the stored events of its bin before being stored with FinishEvent()
+  void StartEvent(int bin, float posZ)
+  {
+    mCurrentBin = bin;
+    mCurrent.clear();
+    mCurrent.posZ = posZ;
+  }
+
+  void AddParticle(float pt, float eta, float phi, int sign)
+  {
+    mCurrent.pt.push_back(pt);
+    mCurrent.eta.push_back(eta);
+    mCurrent.phi.push_back(phi);
+    mCurrent.sign.push_back(static_cast<int8_t>(sign));
+  }
+
+  /// Stores the staged event in its bin
+  void FinishEvent()
+  {
+    if (mCurrentBin < 0 || mCurrent.pt.empty()) {
+      return;
+    }
+    Bin& bin = mBins[mCurrentBin];
+    if (bin.events.empty()) {
+      bin.events.resize(mDepth);
+    }
+    int slot = bin.n;
+    if (bin.n == mDepth) {
+      slot = (mEviction == kRandom) ? static_cast<int>(mRandom() % mDepth) : bin.oldest;
+    }
+    Event& stored = bin.events[slot];
+    const int64_t nReplaced = (bin.n == mDepth) ? static_cast<int64_t>(stored.pt.size()) : 0;
+    const int64_t nAdded = static_cast<int64_t>(mCurrent.pt.size());
+    if (mMaxParticles > 0 && mNStoredParticles - nReplaced + nAdded > mMaxParticles) {
+      if (!mWarnedMaxParticles) {
+        LOGF(warning, "EventMixingPool: the maximum number of stored particles (%ld) is reached, the next events are only stored if they replace older ones", mMaxParticles);
+        mWarnedMaxParticles = true;
+      }
+      return;
+    }
+    mNStoredParticles += nAdded - nReplaced;
+    std::swap(stored, mCurrent);
+    if (bin.n < mDepth) {
+      bin.n++;
+    } else if (mEviction == kOldest) {
+      bin.oldest = (bin.oldest + 1) % mDepth;
+    }
+    mCurrent.clear();
+  }
+
+  /// \return the number of stored events of the bin
+  int GetNEvents(int bin) const
+  {
+    if (bin < 0 || bin >= static_cast<int>(mBins.size())) {
+      return 0;
+    }
+    return mBins[bin].n;
+  }
+
+  /// \return the i-th stored event of the bin
+  EventView GetEvent(int bin, int i) const
+  {
+    const Event& event = mBins[bin].events[i];
+    return EventView{event.pt, event.eta, event.phi, event.sign, event.posZ};
+  }
+
+  int64_t GetNStoredParticles() const { return mNStoredParticles; }
+
+ private:
+  struct Event {
+    std::vector<float> pt{};
+    std::vector<float> eta{};
+    std::vector<float> phi{};
+    std::vector<int8_t> sign{};
+    float posZ{0.f};
+
+    void clear()
+    {
+      pt.clear();
+      eta.clear();
+      phi.clear();
+      sign.clear();
+    }
+  };
+
+  struct Bin {
+    std::vector<Event> events{};
+    int n{0};      // number of stored events
+    int oldest{0}; // slot of the oldest event once the bin is full
+  };
+
+  static int FindBin(const std::vector<double>& edges, float value)
+  {
+    if (value < edges.front() || value >= edges.back()) {
+      return -1;
+    }
+    return static_cast<int>(std::upper_bound(edges.begin(), edges.end(), value) - edges.begin()) - 1;
+  }
+
+  std::vector<double> mEdgesVtx{};
+  std::vector<double> mEdgesMult{};
+  int mDepth{1};
+  Eviction mEviction{kOldest};
+  int64_t mMaxParticles{-1};
+  int64_t mNStoredParticles{0};
+  bool mWarnedMaxParticles{false};
+  std::mt19937_64 mRandom{};
+
+  std::vector<Bin> mBins{}; // indexed by the mixing bin
+  int mCurrentBin{-1};
+  Event mCurrent{}; // staging event
+};
+
+#endif // O2_ANALYSIS_EVENTMIXINGPOOL_H
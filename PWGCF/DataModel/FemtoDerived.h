@@ -743,11 +743,22 @@ DECLARE_SOA_TABLE(FDHfCandMCGen, "AOD", "FDHFCANDMCGEN", //! Table for generated
 /// Hash
 namespace hash
 {
-DECLARE_SOA_COLUMN(Bin, bin, int); //! Hash for the event mixing
+DECLARE_SOA_COLUMN(Bin, bin, int);                  //! Hash for the event mixing
+DECLARE_SOA_INDEX_COLUMN(FDCollision, fdCollision); //! Collision of the hash-sorted collision index
+DECLARE_SOA_COLUMN(FirstSorted, firstSorted, int);  //! First row of the bucket in the hash-sorted collision index
+DECLARE_SOA_COLUMN(NCollisions, nCollisions, int);  //! Number of collisions of the bucket
 } // namespace hash
 DECLARE_SOA_TABLE(MixingHashes, "AOD", "HASH", hash::Bin);
 using MixingHash = MixingHashes::iterator;
 
+/// collisions of the data frame sorted by hash, in the order of the collision table within a hash
+DECLARE_SOA_TABLE(MixingHashSorted, "AOD", "HASHSORTED", hash::Bin, hash::FDCollisionId);
+using MixingHashSortedRow = MixingHashSorted::iterator;
+
+/// non-empty hash buckets of the data frame, as ranges of the hash-sorted collision index
+DECLARE_SOA_TABLE(MixingHashBuckets, "AOD", "HASHBUCKETS", hash::Bin, hash::FirstSorted, hash::NCollisions);
+using MixingHashBucket = MixingHashBuckets::iterator;
+
 } // namespace o2::aod
 
 #endif // PWGCF_DATAMODEL_FEMTODERIVED_H_
@@ -28,10 +28,12 @@
 #include <chrono>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <map>
 #include <numeric>
 #include <random>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace o2::analysis::femto
@@ -226,7 +228,25 @@ class CloseTrackRejection
     }
   }
 
-  void setMagField(float magField) { mMagField = magField; }
+  void setMagField(float magField)
+  {
+    if (mUseCache && magField != mMagField) {
+      resetCache();
+    }
+    mMagField = magField;
+  }
+
+  // phi* only depends on the track, so it is computed once per track and stored in a table (one row per radius and a validity mask)
+  // the table is only used once activated by resetCache(), which has to be called each time the pairs are built from new collision(s)
+  void resetCache()
+  {
+    mUseCache = true;
+    mCacheRows.clear();
+    mCacheValid.clear();
+    for (auto& row : mCachePhistar) {
+      row.clear();
+    }
+  }
 
   template <typename T1, typename T2>
   void compute(T1 const& track1, T2 const& track2)
@@ -251,13 +271,27 @@ class CloseTrackRejection
 
     mDeta = t1.eta() - t2.eta();
 
-    for (size_t i = 0; i < TpcRadii.size(); i++) {
-      auto phistar1 = phistar(mMagField, TpcRadii[i], mChargeAbsTrack1 * t1.signedPt(), t1.phi());
-      auto phistar2 = phistar(mMagField, TpcRadii[i], mChargeAbsTrack2 * t2.signedPt(), t2.phi());
-      if (phistar1 && phistar2) {
-        mDphistar.at(i) = RecoDecay::constrainAngle(phistar1.value() - phistar2.value(), -o2::constants::math::PI); // constrain angular difference between -pi and pi
-        mDphistarMask.at(i) = true;
-        count++;
+    if (mUseCache) {
+      // tracks with the same charge factor share their row, e.g. identical particles
+      const std::size_t row1 = getCacheRow(t1, mChargeAbsTrack1, 0);
+      const std::size_t row2 = getCacheRow(t2, mChargeAbsTrack2, mChargeAbsTrack1 == mChargeAbsTrack2 ? 0 : 1);
+      const uint16_t valid = mCacheValid[row1] & mCacheValid[row2];
+      for (size_t i = 0; i < TpcRadii.size(); i++) {
+        if (valid & (1u << i)) {
+          mDphistar[i] = RecoDecay::constrainAngle(mCachePhistar[i][row1] - mCachePhistar[i][row2], -o2::constants::math::PI); // constrain angular difference between -pi and pi
+          mDphistarMask[i] = true;
+          count++;
+        }
+      }
+    } else {
+      for (size_t i = 0; i < TpcRadii.size(); i++) {
+        auto phistar1 = phistar(mMagField, TpcRadii[i], mChargeAbsTrack1 * t1.signedPt(), t1.phi());
+        auto phistar2 = phistar(mMagField, TpcRadii[i], mChargeAbsTrack2 * t2.signedPt(), t2.phi());
+        if (phistar1 && phistar2) {
+          mDphistar.at(i) = RecoDecay::constrainAngle(phistar1.value() - phistar2.value(), -o2::constants::math::PI); // constrain angular difference between -pi and pi
+          mDphistarMask.at(i) = true;
+          count++;
+        }
       }
     }
     // for small momemeta the calculation of phistar might fail, if the particle did not reach one or more of the outer radii
@@ -369,6 +403,22 @@ class CloseTrackRejection
     return std::nullopt;
   }
 
+  template <typename T>
+  std::size_t getCacheRow(T const& track, int chargeAbs, int slot)
+  {
+    auto [it, isNew] = mCacheRows.try_emplace(2 * static_cast<int64_t>(track.globalIndex()) + slot, mCacheValid.size());
+    if (isNew) {
+      uint16_t valid = 0;
+      for (size_t i = 0; i < TpcRadii.size(); i++) {
+        auto value = phistar(mMagField, TpcRadii[i], chargeAbs * track.signedPt(), track.phi());
+        mCachePhistar[i].push_back(value.value_or(0.f));
+        valid |= static_cast<uint16_t>(value.has_value()) << i;
+      }
+      mCacheValid.push_back(valid);
+    }
+    return it->second;
+  }
+
   o2::framework::HistogramRegistry* mHistogramRegistry = nullptr;
   bool mPlotAllRadii = false;
   bool mPlotAverage = false;
@@ -404,6 +454,11 @@ class CloseTrackRejection
   bool mRandomizeTracks = false;
   std::mt19937 mRng;
   std::uniform_int_distribution<int> mSwapDist{0, 1};
+
+  bool mUseCache = false;
+  std::unordered_map<int64_t, std::size_t> mCacheRows;  // (track index, charge slot) -> row in the table
+  std::array<std::vector<float>, Nradii> mCachePhistar; // phi* at each radius
+  std::vector<uint16_t> mCacheValid;                    // bit i set if phi* could be computed at radius i
 };
 
 template <const char* prefix>
@@ -421,6 +476,7 @@ class ClosePairRejectionTrackTrack
   }
 
   void setMagField(float magField) { mCtr.setMagField(magField); }
+  void resetCache() { mCtr.resetCache(); }
   template <typename T1, typename T2, typename T3>
   void setPair(T1 const& track1, T2 const& track2, T3 const& /*tracks*/)
   {
@@ -454,6 +510,12 @@ class ClosePairRejectionV0V0
     mCtrNeg.setMagField(magField);
   }
 
+  void resetCache()
+  {
+    mCtrPos.resetCache();
+    mCtrNeg.resetCache();
+  }
+
   template <typename T1, typename T2, typename T3>
   void setPair(T1 const& v01, T2 const& v02, T3 const& tracks)
   {
@@ -493,6 +555,7 @@ class ClosePairRejectionTrackV0 // can also be used for any particle type that h
   }
 
   void setMagField(float magField) { mCtr.setMagField(magField); }
+  void resetCache() { mCtr.resetCache(); }
 
   template <typename T1, typename T2, typename T3>
   void setPair(T1 const& track, T2 const& v0, T3 const& trackTable)
@@ -536,6 +599,12 @@ class ClosePairRejectionTrackCascade
     mCtrV0Daughter.setMagField(magField);
   }
 
+  void resetCache()
+  {
+    mCtrBachelor.resetCache();
+    mCtrV0Daughter.resetCache();
+  }
+
   template <typename T1, typename T2, typename T3>
   void setPair(T1 const& track, T2 const& cascade, T3 const& trackTable)
   {
@@ -586,6 +655,8 @@ class ClosePairRejectionTrackKink
     mCtr.setMagField(magField);
   }
 
+  void resetCache() { mCtr.resetCache(); }
+
   template <typename T1, typename T2, typename T3>
   void setPair(T1 const& track, T2 const& kink, T3 const& trackTable)
   {
@@ -24,14 +24,17 @@
 #include "Framework/HistogramRegistry.h"
 #include "Framework/HistogramSpec.h"
 
-#include <Math/GenVector/Boost.h>
 #include <Math/Vector4D.h>
 
+#include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <map>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 namespace o2::analysis::femto
@@ -266,6 +269,34 @@ constexpr std::string_view AnalysisDir = "Analysis/";
 constexpr std::string_view QaDir = "QA/";
 constexpr std::string_view McDir = "MC/";
 
+// four-momenta of the particles of a slice in contiguous arrays
+struct ParticleKinematics {
+  std::vector<double> px;
+  std::vector<double> py;
+  std::vector<double> pz;
+  std::vector<double> e;
+  std::vector<float> pt;
+
+  template <typename T>
+  void fill(T const& slice, int absCharge, double mass)
+  {
+    px.clear();
+    py.clear();
+    pz.clear();
+    e.clear();
+    pt.clear();
+    for (auto const& particle : slice) {
+      const double ptScaled = absCharge * particle.pt();
+      const double p = ptScaled * std::cosh(particle.eta());
+      px.push_back(ptScaled * std::cos(particle.phi()));
+      py.push_back(ptScaled * std::sin(particle.phi()));
+      pz.push_back(ptScaled * std::sinh(particle.eta()));
+      e.push_back(std::sqrt(p * p + mass * mass));
+      pt.push_back(static_cast<float>(ptScaled));
+    }
+  }
+};
+
 template <const char* prefix,
           modes::Particle particleType1,
           modes::Particle particleType2>
@@ -350,18 +381,70 @@ class PairHistManager
     // set kstar
     mKstar = getKstar(mParticle1, mParticle2);
 
-    // if one of the particles has a mass getter (like lambda), we cache the value for the filling later
-    // otherwise we continue to use the pdg mass
-    mMass1 = mPdgMass1;
-    if constexpr (modes::hasMass(particleType1)) {
-      mMass1 = particle1.mass();
-    }
-    mMass2 = mPdgMass2;
-    if constexpr (modes::hasMass(particleType2)) {
-      mMass2 = particle2.mass();
+    mPt1 = mParticle1.Pt();
+    mPt2 = mParticle2.Pt();
+    setMasses(particle1, particle2);
+  }
+
+  // gather the particles of the slices entering a combination loop, so that the pair quantities are computed for all partners of a particle at once
+  // identical = true for the strictly upper combinations of a slice with itself, false for the full combinations of two slices
+  template <typename T1, typename T2>
+  void setParticles(const T1& slice1, const T2& slice2, bool identical)
+  {
+    mIdentical = identical;
+    mKinematics1.fill(slice1, mAbsCharge1, mPdgMass1);
+    if (!mIdentical) {
+      mKinematics2.fill(slice2, mAbsCharge2, mPdgMass2);
+    }
+    mRow = 0;
+    mRowId = -1;
+    mColumn = 0;
+    const std::size_t n = secondKinematics().px.size();
+    mRowKstar.resize(n);
+    mRowKt.resize(n);
+    mRowMt.resize(n);
+  }
+
+  // to be called for every pair of the combination loop (in its order) before any selection, so that the pair index stays in sync
+  template <typename T1>
+  void nextPair(const T1& particle1)
+  {
+    if (particle1.globalIndex() != mRowId) {
+      mRow = mRowId < 0 ? 0 : mRow + 1;
+      mRowId = particle1.globalIndex();
+      mColumn = mIdentical ? mRow + 1 : 0;
+      computeRow();
+    } else {
+      mColumn++;
     }
   }
 
+  // set the current pair of the combination loop from the precomputed quantities
+  // swapped = true if the particles are passed in the opposite order (particle1 from the second slice), only allowed for identical particles
+  template <typename T1, typename T2, typename T3>
+  void setCurrentPair(const T1& particle1, const T2& particle2, const T3& col, bool swapped = false)
+  {
+    mKstar = mRowKstar[mColumn];
+    mKt = mRowKt[mColumn];
+    mMt = mRowMt[mColumn];
+    mPt1 = mKinematics1.pt[mRow];
+    mPt2 = secondKinematics().pt[mColumn];
+    if (swapped) {
+      std::swap(mPt1, mPt2);
+    }
+    setMasses(particle1, particle2);
+    mMult = col.mult();
+    mCent = col.cent();
+  }
+
+  template <typename T1, typename T2, typename T3, typename T4>
+  void setCurrentPair(const T1& particle1, const T2& particle2, const T3& col1, const T4& col2)
+  {
+    setCurrentPair(particle1, particle2, col1);
+    mMult = 0.5f * (col1.mult() + col2.mult()); // if mixing with multiplicity, should be in the same mixing bin
+    mCent = 0.5f * (col1.cent() + col2.cent()); // if mixing with centrality, should be in the same mixing bin
+  }
+
   template <typename T1, typename T2, typename T3>
   void setPair(const T1& particle1, const T2& particle2, const T3& col)
   {
@@ -547,13 +630,13 @@ class PairHistManager
       mHistogramRegistry->fill(HIST(prefix) + HIST(AnalysisDir) + HIST(getHistName(kKt, HistTable)), mKt);
     }
     if (mPlot2d) {
-      mHistogramRegistry->fill(HIST(prefix) + HIST(AnalysisDir) + HIST(getHistName(kPt1VsPt2, HistTable)), mParticle1.Pt(), mParticle2.Pt());
-      mHistogramRegistry->fill(HIST(prefix) + HIST(AnalysisDir) + HIST(getHistName(kPt1VsKstar, HistTable)), mParticle1.Pt(), mKstar);
-      mHistogramRegistry->fill(HIST(prefix) + HIST(AnalysisDir) + HIST(getHistName(kPt1VsMt, HistTable)), mParticle1.Pt(), mMt);
-      mHistogramRegistry->fill(HIST(prefix) + HIST(AnalysisDir) + HIST(getHistName(kPt1VsKt, HistTable)), mParticle1.Pt(), mKt);
-      mHistogramRegistry->fill(HIST(prefix) + HIST(AnalysisDir) + HIST(getHistName(kPt2VsKstar, HistTable)), mParticle2.Pt(), mKstar);
-      mHistogramRegistry->fill(HIST(prefix) + HIST(AnalysisDir) + HIST(getHistName(kPt2VsMt, HistTable)), mParticle2.Pt(), mMt);
-      mHistogramRegistry->fill(HIST(prefix) + HIST(AnalysisDir) + HIST(getHistName(kPt2VsKt, HistTable)), mParticle2.Pt(), mKt);
+      mHistogramRegistry->fill(HIST(prefix) + HIST(AnalysisDir) + HIST(getHistName(kPt1VsPt2, HistTable)), mPt1, mPt2);
+      mHistogramRegistry->fill(HIST(prefix) + HIST(AnalysisDir) + HIST(getHistName(kPt1VsKstar, HistTable)), mPt1, mKstar);
+      mHistogramRegistry->fill(HIST(prefix) + HIST(AnalysisDir) + HIST(getHistName(kPt1VsMt, HistTable)), mPt1, mMt);
+      mHistogramRegistry->fill(HIST(prefix) + HIST(AnalysisDir) + HIST(getHistName(kPt1VsKt, HistTable)), mPt1, mKt);
+      mHistogramRegistry->fill(HIST(prefix) + HIST(AnalysisDir) + HIST(getHistName(kPt2VsKstar, HistTable)), mPt2, mKstar);
+      mHistogramRegistry->fill(HIST(prefix) + HIST(AnalysisDir) + HIST(getHistName(kPt2VsMt, HistTable)), mPt2, mMt);
+      mHistogramRegistry->fill(HIST(prefix) + HIST(AnalysisDir) + HIST(getHistName(kPt2VsKt, HistTable)), mPt2, mKt);
       mHistogramRegistry->fill(HIST(prefix) + HIST(AnalysisDir) + HIST(getHistName(kKstarVsKt, HistTable)), mKstar, mKt);
       mHistogramRegistry->fill(HIST(prefix) + HIST(AnalysisDir) + HIST(getHistName(kKstarVsMt, HistTable)), mKstar, mMt);
       mHistogramRegistry->fill(HIST(prefix) + HIST(AnalysisDir) + HIST(getHistName(kKstarVsMult, HistTable)), mKstar, mMult);
@@ -581,13 +664,13 @@ class PairHistManager
       mHistogramRegistry->fill(HIST(prefix) + HIST(AnalysisDir) + HIST(getHistName(kKstarVsMtVsMultVsCent, HistTable)), mKstar, mMt, mMult, mCent);
     }
     if (mPlotKstarVsMtVsPt1VsPt2) {
-      mHistogramRegistry->fill(HIST(prefix) + HIST(AnalysisDir) + HIST(getHistName(kKstarVsMtVsPt1VsPt2, HistTable)), mKstar, mMt, mParticle1.Pt(), mParticle2.Pt());
+      mHistogramRegistry->fill(HIST(prefix) + HIST(AnalysisDir) + HIST(getHistName(kKstarVsMtVsPt1VsPt2, HistTable)), mKstar, mMt, mPt1, mPt2);
     }
     if (mPlotKstarVsMtVsPt1VsPt2VsMult) {
-      mHistogramRegistry->fill(HIST(prefix) + HIST(AnalysisDir) + HIST(getHistName(kKstarVsMtVsPt1VsPt2VsMult, HistTable)), mKstar, mMt, mParticle1.Pt(), mParticle2.Pt(), mMult);
+      mHistogramRegistry->fill(HIST(prefix) + HIST(AnalysisDir) + HIST(getHistName(kKstarVsMtVsPt1VsPt2VsMult, HistTable)), mKstar, mMt, mPt1, mPt2, mMult);
     }
     if (mPlotKstarVsMtVsPt1VsPt2VsMultVsCent) {
-      mHistogramRegistry->fill(HIST(prefix) + HIST(AnalysisDir) + HIST(getHistName(kKstarVsMtVsPt1VsPt2VsMultVsCent, HistTable)), mKstar, mMt, mParticle1.Pt(), mParticle2.Pt(), mMult, mCent);
+      mHistogramRegistry->fill(HIST(prefix) + HIST(AnalysisDir) + HIST(getHistName(kKstarVsMtVsPt1VsPt2VsMultVsCent, HistTable)), mKstar, mMt, mPt1, mPt2, mMult, mCent);
     }
     if (mPlotKstarVsMtVsMass1VsMass2) {
       mHistogramRegistry->fill(HIST(prefix) + HIST(AnalysisDir) + HIST(getHistName(kKstarVsMtVsMass1VsMass2, HistTable)), mKstar, mMt, mMass1, mMass2);
@@ -599,13 +682,13 @@ class PairHistManager
       mHistogramRegistry->fill(HIST(prefix) + HIST(AnalysisDir) + HIST(getHistName(kKstarVsMtVsMass1VsMass2VsMultVsCent, HistTable)), mKstar, mMt, mMass1, mMass2, mMult, mCent);
     }
     if (mPlotKstarVsMtVsMass1VsMass2VsPt1VsPt2) {
-      mHistogramRegistry->fill(HIST(prefix) + HIST(AnalysisDir) + HIST(getHistName(kKstarVsMtVsMass1VsMass2VsPt1VsPt2, HistTable)), mKstar, mMt, mMass1, mMass2, mParticle1.Pt(), mParticle2.Pt());
+      mHistogramRegistry->fill(HIST(prefix) + HIST(AnalysisDir) + HIST(getHistName(kKstarVsMtVsMass1VsMass2VsPt1VsPt2, HistTable)), mKstar, mMt, mMass1, mMass2, mPt1, mPt2);
     }
     if (mPlotKstarVsMtVsMass1VsMass2VsPt1VsPt2VsMult) {
-      mHistogramRegistry->fill(HIST(prefix) + HIST(AnalysisDir) + HIST(getHistName(kKstarVsMtVsMass1VsMass2VsPt1VsPt2VsMult, HistTable)), mKstar, mMt, mMass1, mMass2, mParticle1.Pt(), mParticle2.Pt(), mMult);
+      mHistogramRegistry->fill(HIST(prefix) + HIST(AnalysisDir) + HIST(getHistName(kKstarVsMtVsMass1VsMass2VsPt1VsPt2VsMult, HistTable)), mKstar, mMt, mMass1, mMass2, mPt1, mPt2, mMult);
     }
     if (mPlotKstarVsMtVsMass1VsMass2VsPt1VsPt2VsMultVsCent) {
-      mHistogramRegistry->fill(HIST(prefix) + HIST(AnalysisDir) + HIST(getHistName(kKstarVsMtVsMass1VsMass2VsPt1VsPt2VsMultVsCent, HistTable)), mKstar, mMt, mMass1, mMass2, mParticle1.Pt(), mParticle2.Pt(), mMult, mCent);
+      mHistogramRegistry->fill(HIST(prefix) + HIST(AnalysisDir) + HIST(getHistName(kKstarVsMtVsMass1VsMass2VsPt1VsPt2VsMultVsCent, HistTable)), mKstar, mMt, mMass1, mMass2, mPt1, mPt2, mMult, mCent);
     }
   }
 
@@ -653,17 +736,82 @@ class PairHistManager
     return static_cast<float>(mt);
   }
 
+  // momentum of the particles in the pair rest frame, given by the invariant mass squared s of the pair and the masses of the particles
+  // k* = sqrt((s - (m1 + m2)^2) * (s - (m1 - m2)^2) / 4s), equivalent to boosting particle 1 into the pair rest frame
+  static double kstar(double s, double massSumSq, double massDiffSq)
+  {
+    return 0.5 * std::sqrt(std::max(0., (s - massSumSq) * (s - massDiffSq) / s));
+  }
+
   float getKstar(ROOT::Math::PtEtaPhiMVector const& part1, ROOT::Math::PtEtaPhiMVector const& part2)
   {
-    // compute pair momentum
     auto sum = part1 + part2;
-    // Boost particle 1 to the pair rest frame (Prf) and calculate k* (would be equivalent using particle 2)
-    // make a copy of particle 1
-    auto particle1Prf = ROOT::Math::PtEtaPhiMVector(mParticle1);
-    // get lorentz boost into pair rest frame
-    ROOT::Math::Boost boostPrf(sum.BoostToCM());
-    // boost particle 1 into pair rest frame and calculate its momentum, which has the same value as k*
-    return static_cast<float>(boostPrf(particle1Prf).P());
+    return static_cast<float>(kstar(sum.M2(), std::pow(part1.M() + part2.M(), 2), std::pow(part1.M() - part2.M(), 2)));
+  }
+
+  template <typename T1, typename T2>
+  void setMasses(const T1& particle1, const T2& particle2)
+  {
+    // if one of the particles has a mass getter (like lambda), we cache the value for the filling later
+    // otherwise we continue to use the pdg mass
+    mMass1 = mPdgMass1;
+    if constexpr (modes::hasMass(particleType1)) {
+      mMass1 = particle1.mass();
+    }
+    mMass2 = mPdgMass2;
+    if constexpr (modes::hasMass(particleType2)) {
+      mMass2 = particle2.mass();
+    }
+  }
+
+  const ParticleKinematics& secondKinematics() const { return mIdentical ? mKinematics1 : mKinematics2; }
+
+  // k*, kT and mT of particle mRow of the first slice with all particles from mColumn on of the second slice
+  // plain loop over contiguous arrays without branches, so that it can be vectorised by the compiler
+  void computeRow()
+  {
+    const double px1 = mKinematics1.px[mRow];
+    const double py1 = mKinematics1.py[mRow];
+    const double pz1 = mKinematics1.pz[mRow];
+    const double e1 = mKinematics1.e[mRow];
+    const double massSumSq = (mPdgMass1 + mPdgMass2) * (mPdgMass1 + mPdgMass2);
+    const double massDiffSq = (mPdgMass1 - mPdgMass2) * (mPdgMass1 - mPdgMass2);
+
+    double mtMassSq = 0.;
+    const bool useMt4Vector = mMtType == modes::TransverseMassType::kMt4Vector;
+    switch (mMtType) {
+      case modes::TransverseMassType::kAveragePdgMass:
+        mtMassSq = std::pow(0.5 * (mPdgMass1 + mPdgMass2), 2);
+        break;
+      case modes::TransverseMassType::kReducedPdgMass:
+        mtMassSq = std::pow(2. * (mPdgMass1 * mPdgMass2) / (mPdgMass1 + mPdgMass2), 2);
+        break;
+      case modes::TransverseMassType::kMt4Vector:
+        break;
+      default:
+        LOG(fatal) << "Invalid transverse mass type, breaking...";
+    }
+
+    const ParticleKinematics& kinematics2 = secondKinematics();
+    const double* px2 = kinematics2.px.data();
+    const double* py2 = kinematics2.py.data();
+    const double* pz2 = kinematics2.pz.data();
+    const double* e2 = kinematics2.e.data();
+    float* kstarOut = mRowKstar.data();
+    float* ktOut = mRowKt.data();
+    float* mtOut = mRowMt.data();
+    const std::size_t n = kinematics2.px.size();
+    for (std::size_t j = mColumn; j < n; j++) {
+      const double sx = px1 + px2[j];
+      const double sy = py1 + py2[j];
+      const double sz = pz1 + pz2[j];
+      const double se = e1 + e2[j];
+      const double ptSq = sx * sx + sy * sy;
+      const double mtSq = useMt4Vector ? 0.25 * (se * se - sz * sz) : 0.25 * ptSq + mtMassSq;
+      kstarOut[j] = static_cast<float>(kstar(se * se - ptSq - sz * sz, massSumSq, massDiffSq));
+      ktOut[j] = static_cast<float>(0.5 * std::sqrt(ptSq));
+      mtOut[j] = static_cast<float>(std::sqrt(std::max(0., mtSq)));
+    }
   }
 
   o2::framework::HistogramRegistry* mHistogramRegistry = nullptr;
@@ -676,6 +824,8 @@ class PairHistManager
   int mAbsCharge2 = 1;
   ROOT::Math::PtEtaPhiMVector mParticle1{};
   ROOT::Math::PtEtaPhiMVector mParticle2{};
+  float mPt1 = 0.f;
+  float mPt2 = 0.f;
   float mMass1 = 0.f;
   float mMass2 = 0.f;
   float mKstar = 0.f;
@@ -684,6 +834,17 @@ class PairHistManager
   float mMult = 0.f;
   float mCent = 0.f;
 
+  // pair quantities of the current combination loop
+  ParticleKinematics mKinematics1;
+  ParticleKinematics mKinematics2;
+  bool mIdentical = false;
+  std::size_t mRow = 0;     // index of the first particle of the current pair in its slice
+  std::size_t mColumn = 0;  // index of the second particle of the current pair in its slice
+  int64_t mRowId = -1;      // global index of the first particle of the current pair
+  std::vector<float> mRowKstar;
+  std::vector<float> mRowKt;
+  std::vector<float> mRowMt;
+
   // mc
   ROOT::Math::PtEtaPhiMVector mTrueParticle1{};
   ROOT::Math::PtEtaPhiMVector mTrueParticle2{};
@@ -49,10 +49,15 @@ void processSameEvent(T1 const& SliceParticle,
                       T7& PcManager,
                       PairOrder pairOrder)
 {
+  // phi* of the tracks of this collision are computed once and reused for all pairs
+  CprManager.resetCache();
   for (auto const& part : SliceParticle) {
     ParticleHistManager.template fill<mode>(part, TrackTable);
   }
+  // kinematics of all pairs of a particle are computed at once from contiguous arrays
+  PairHistManager.setParticles(SliceParticle, SliceParticle, true);
   for (auto const& [p1, p2] : o2::soa::combinations(o2::soa::CombinationsStrictlyUpperIndexPolicy(SliceParticle, SliceParticle))) {
+    PairHistManager.nextPair(p1);
     // check if pair is clean
     if (!PcManager.isCleanPair(p1, p2, TrackTable)) {
       continue;
@@ -65,13 +70,13 @@ void processSameEvent(T1 const& SliceParticle,
     // Randomize pair order if enabled
     switch (pairOrder) {
       case kOrder12:
-        PairHistManager.setPair(p1, p2, Collision);
+        PairHistManager.setCurrentPair(p1, p2, Collision);
         break;
       case kOrder21:
-        PairHistManager.setPair(p2, p1, Collision);
+        PairHistManager.setCurrentPair(p2, p1, Collision, true);
         break;
       default:
-        PairHistManager.setPair(p1, p2, Collision);
+        PairHistManager.setCurrentPair(p1, p2, Collision);
     }
     // fill deta-dphi histograms with kstar cutoff
     CprManager.fill(PairHistManager.getKstar());
@@ -110,6 +115,7 @@ void processSameEvent(T1 const& SliceParticle,
                       T12& PcManager,
                       PairOrder pairOrder)
 {
+  CprManager.resetCache();
   for (auto const& part : SliceParticle) {
     if (!ParticleCleaner.isClean(part, mcParticles, mcMothers, mcPartonicMothers)) {
       continue;
@@ -172,6 +178,7 @@ void processSameEvent(T1 const& SliceParticle1,
                       T8& CprManager,
                       T9& PcManager)
 {
+  CprManager.resetCache();
   // Fill single particle histograms
   for (auto const& part : SliceParticle1) {
     ParticleHistManager1.template fill<mode>(part, TrackTable);
@@ -179,7 +186,9 @@ void processSameEvent(T1 const& SliceParticle1,
   for (auto const& part : SliceParticle2) {
     ParticleHistManager2.template fill<mode>(part, TrackTable);
   }
+  PairHistManager.setParticles(SliceParticle1, SliceParticle2, false);
   for (auto const& [p1, p2] : o2::soa::combinations(o2::soa::CombinationsFullIndexPolicy(SliceParticle1, SliceParticle2))) {
+    PairHistManager.nextPair(p1);
     // pair cleaning
     if (!PcManager.isCleanPair(p1, p2, TrackTable)) {
       continue;
@@ -189,7 +198,7 @@ void processSameEvent(T1 const& SliceParticle1,
     if (CprManager.isClosePair()) {
       continue;
     }
-    PairHistManager.setPair(p1, p2, Collision);
+    PairHistManager.setCurrentPair(p1, p2, Collision);
     CprManager.fill(PairHistManager.getKstar());
     if (PairHistManager.checkPairCuts()) {
       PairHistManager.template fill<mode>();
@@ -230,6 +239,7 @@ void processSameEvent(T1 const& SliceParticle1,
                       T14& CprManager,
                       T15& PcManager)
 {
+  CprManager.resetCache();
   // Fill single particle histograms
   for (auto const& part : SliceParticle1) {
     if (!ParticleCleaner1.isClean(part, mcParticles, mcMothers, mcPartonicMothers)) {
@@ -294,12 +304,15 @@ void processMixedEvent(T1 const& Collisions,
       continue;
     }
     CprManager.setMagField(collision1.magField());
+    CprManager.resetCache();
     auto sliceParticle1 = Partition1->sliceByCached(o2::aod::femtobase::stored::fColId, collision1.globalIndex(), cache);
     auto sliceParticle2 = Partition2->sliceByCached(o2::aod::femtobase::stored::fColId, collision2.globalIndex(), cache);
     if (sliceParticle1.size() == 0 || sliceParticle2.size() == 0) {
       continue;
     }
+    PairHistManager.setParticles(sliceParticle1, sliceParticle2, false);
     for (auto const& [p1, p2] : o2::soa::combinations(o2::soa::CombinationsFullIndexPolicy(sliceParticle1, sliceParticle2))) {
+      PairHistManager.nextPair(p1);
       // pair cleaning
       if (!PcManager.isCleanPair(p1, p2, TrackTable)) {
         continue;
@@ -309,7 +322,7 @@ void processMixedEvent(T1 const& Collisions,
       if (CprManager.isClosePair()) {
         continue;
       }
-      PairHistManager.setPair(p1, p2, collision1, collision2);
+      PairHistManager.setCurrentPair(p1, p2, collision1, collision2);
       CprManager.fill(PairHistManager.getKstar());
       if (PairHistManager.checkPairCuts()) {
         PairHistManager.template fill<mode>();
@@ -358,6 +371,7 @@ void processMixedEvent(T1 const& Collisions,
       continue;
     }
     CprManager.setMagField(collision1.magField());
+    CprManager.resetCache();
     auto sliceParticle1 = Partition1->sliceByCached(o2::aod::femtobase::stored::fColId, collision1.globalIndex(), cache);
     auto sliceParticle2 = Partition2->sliceByCached(o2::aod::femtobase::stored::fColId, collision2.globalIndex(), cache);
     if (sliceParticle1.size() == 0 || sliceParticle2.size() == 0) {
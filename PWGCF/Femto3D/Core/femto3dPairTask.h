@@ -27,9 +27,12 @@
 #include "CommonConstants/PhysicsConstants.h"
 
 #include "TDatabasePDG.h"
+#include "TH3.h"
 #include "TLorentzVector.h"
 #include "TVector3.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -117,6 +120,20 @@ Type getBinIndex(float const& value, std::vector<float> const& binning, int cons
   return res;
 }
 
+template <typename Type>
+Type getSubBinIndex(float const& value, std::vector<float> const& binning, int const& NsubBins = 1)
+{ // integer index (i * NsubBins + subBin) of the same (sub)bin as given by getBinIndex; -1 if outside the binning
+  const int nSub = std::max(NsubBins, 1);
+  for (unsigned int i = 0; i < binning.size() - 1; i++) {
+    if (value >= binning[i] && binning[i + 1] > value) {
+      const float subBinWidth = (binning[i + 1] - binning[i]) / nSub;
+      const int subBin = std::min(static_cast<int>(std::floor((value - binning[i]) / subBinWidth)), nSub - 1);
+      return static_cast<Type>(i * nSub + subBin);
+    }
+  }
+  return static_cast<Type>(-1);
+}
+
 //====================================================================================
 
 float GetKstarFrom4vectors(TLorentzVector& first4momentum, TLorentzVector& second4momentum, bool isIdentical)
@@ -432,6 +449,173 @@ float FemtoPair<TrackType>::GetGammaOut() const
 
   return fourmomentasum.Gamma();
 }
+
+//====================================================================================
+
+struct FemtoTrack { // kinematics of a selected track with the accessors used by FemtoPair; same definitions as the dynamic columns of the SingleTrackSels
+  float p = 0.f;
+  float eta = 0.f;
+  float phiValue = 0.f;
+  float ptValue = 0.f;
+  int8_t sign = 0;
+
+  FemtoTrack() = default;
+  FemtoTrack(float const& p_, float const& eta_, float const& phi_, int8_t const& sign_) : p(p_), eta(eta_), phiValue(phi_), ptValue(p_ / std::cosh(eta_)), sign(sign_) {}
+
+  float pt() const { return ptValue; }
+  float phi() const { return phiValue; }
+  float px() const { return ptValue * std::sin(phiValue); }
+  float py() const { return ptValue * std::cos(phiValue); }
+  float phiStar(float const& magfield = 0.0, float const& radius = 1.6) const
+  {
+    if (magfield == 0.0)
+      return -1000.0;
+    return phiValue + std::asin(-0.3 * magfield * sign * radius / (2.0 * ptValue));
+  }
+};
+
+struct FemtoTrackRange { // contiguous tracks of one event in the mixing pool
+  const FemtoTrack* first = nullptr;
+  const FemtoTrack* last = nullptr;
+
+  const FemtoTrack* begin() const { return first; }
+  const FemtoTrack* end() const { return last; }
+  std::size_t size() const { return last - first; }
+  const FemtoTrack& operator[](std::size_t i) const { return first[i]; }
+};
+
+//====================================================================================
+
+class FemtoMixingPool
+{ // selected tracks of the events of a DF stored contiguously per event (one arena per particle of the pair), and events grouped per integer vertex&mult bin
+ public:
+  struct Event {
+    int64_t collisionId = -1;
+    float magField = 0.f;
+    float mult = 0.f;
+    unsigned int multBin = 0; // mult/cent bin of the histograms
+    FemtoTrackRange tracks[2];
+  };
+
+  void init(const int& nBins)
+  {
+    bins.assign(nBins, std::vector<Event>{});
+  }
+
+  void clear()
+  {
+    for (int i = 0; i < 2; i++) {
+      collisionIds[i].clear();
+      tracks[i].clear();
+    }
+    for (auto& bin : bins)
+      bin.clear();
+  }
+
+  void addTrack(const int& particle, const int64_t& collisionId, FemtoTrack const& track)
+  {
+    collisionIds[particle].push_back(collisionId);
+    tracks[particle].push_back(track);
+  }
+
+  void finishTracks() // the tracks of each event must be contiguous: sort them by collision (keeping the table order within each collision) unless they already are
+  {
+    for (int i = 0; i < 2; i++) {
+      if (std::is_sorted(collisionIds[i].begin(), collisionIds[i].end()))
+        continue;
+      std::vector<std::size_t> order(collisionIds[i].size());
+      for (std::size_t j = 0; j < order.size(); j++)
+        order[j] = j;
+      std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return collisionIds[i][a] < collisionIds[i][b]; });
+      std::vector<int64_t> sortedIds(order.size());
+      std::vector<FemtoTrack> sortedTracks(order.size());
+      for (std::size_t j = 0; j < order.size(); j++) {
+        sortedIds[j] = collisionIds[i][order[j]];
+        sortedTracks[j] = tracks[i][order[j]];
+      }
+      collisionIds[i].swap(sortedIds);
+      tracks[i].swap(sortedTracks);
+    }
+  }
+
+  FemtoTrackRange getTracks(const int& particle, const int64_t& collisionId) const // to be called after finishTracks()
+  {
+    auto range = std::equal_range(collisionIds[particle].begin(), collisionIds[particle].end(), collisionId);
+    const FemtoTrack* first = tracks[particle].data() + (range.first - collisionIds[particle].begin());
+    return FemtoTrackRange{first, first + (range.second - range.first)};
+  }
+
+  void addEvent(const int& bin, Event const& event) { bins[bin].push_back(event); }
+
+  int getNbins() const { return bins.size(); }
+  std::vector<Event> const& getEvents(const int& bin) const { return bins[bin]; }
+
+ private:
+  std::vector<int64_t> collisionIds[2];
+  std::vector<FemtoTrack> tracks[2];
+  std::vector<std::vector<Event>> bins; // index: vertexBin * nMultSubBins + multSubBin
+};
+
+//====================================================================================
+
+class Femto3DAccumulator
+{ // block buffer of the (cell, weight) of the pairs filling a TH3; flush() sorts and compresses the buffer and adds it to the histogram
+  // the buffer scales with the number of pairs instead of the number of (mostly empty) cells; accumulators of different histograms can be flushed concurrently
+ public:
+  void init(std::shared_ptr<TH3> const& hist, const std::size_t& maxBuffered = 1 << 22)
+  {
+    histo = hist;
+    maxEntries = maxBuffered;
+    buffer.clear();
+    buffer.reserve(std::min<std::size_t>(maxEntries, 1 << 12));
+    unitWeights = true;
+  }
+
+  void fill(const double& x, const double& y, const double& z, const float& weight = 1.f)
+  {
+    buffer.push_back(Entry{histo->GetBin(histo->GetXaxis()->FindFixBin(x), histo->GetYaxis()->FindFixBin(y), histo->GetZaxis()->FindFixBin(z)), weight});
+    unitWeights = unitWeights && weight == 1.f;
+    if (buffer.size() >= maxEntries)
+      flush();
+  }
+
+  void flush()
+  {
+    if (buffer.empty())
+      return;
+    std::sort(buffer.begin(), buffer.end(), [](Entry const& a, Entry const& b) { return a.cell < b.cell; });
+    const bool hasSumw2 = histo->GetSumw2N() > 0 || !unitWeights;
+    if (hasSumw2 && histo->GetSumw2N() == 0)
+      histo->Sumw2(); // as TH1::Fill does for the first non-unit weight
+    for (std::size_t first = 0; first < buffer.size();) {
+      const int cell = buffer[first].cell;
+      double sumw = 0., sumw2 = 0.;
+      std::size_t last = first;
+      for (; last < buffer.size() && buffer[last].cell == cell; last++) {
+        sumw += buffer[last].weight;
+        sumw2 += static_cast<double>(buffer[last].weight) * buffer[last].weight;
+      }
+      histo->AddBinContent(cell, sumw);
+      if (hasSumw2)
+        histo->GetSumw2()->fArray[cell] += sumw2;
+      first = last;
+    }
+    histo->SetEntries(histo->GetEntries() + buffer.size());
+    buffer.clear();
+    unitWeights = true;
+  }
+
+ private:
+  struct Entry {
+    int cell;
+    float weight;
+  };
+
+  std::shared_ptr<TH3> histo;
+  std::vector<Entry> buffer;
+  std::size_t maxEntries = 1 << 22;
+  bool unitWeights = true;
+};
 } // namespace o2::aod::singletrackselector
 
 #endif // PWGCF_FEMTO3D_CORE_FEMTO3DPAIRTASK_H_
@@ -22,6 +22,7 @@
 #include "Common/DataModel/Multiplicity.h"
 #include "Common/DataModel/PIDResponseITS.h"
 
+#include "CommonConstants/MathConstants.h"
 #include "Framework/ASoA.h"
 #include "Framework/AnalysisDataModel.h"
 #include "Framework/Logger.h"
@@ -120,6 +121,11 @@ using dca = dca_v2;
 using chi2 = binningParent<std::pair<float, float>(0.f, 10.f)>;
 using rowsOverFindable = binningParent<std::pair<float, float>(0.f, 3.f)>;
 
+// binnings of the kinematics of the compact track table
+using p = binningParent<std::pair<float, float>(0.f, 10.f), int16_t>;                         // Width 0.00015 GeV/c
+using eta = binningParent<std::pair<float, float>(-1.5f, 1.5f), int16_t>;                     // Width 0.00005
+using phi = binningParent<std::pair<float, float>(0.f, o2::constants::math::TwoPI), int16_t>; // Width 0.0001 rad
+
 } // namespace binning
 
 //==================================== base event characteristics ====================================
@@ -312,6 +318,20 @@ DECLARE_SOA_DYNAMIC_COLUMN(PhiStar, phiStar,
                              }
                            });
 
+//==================================== Compact kinematics ====================================
+
+DECLARE_SOA_COLUMN(StoredP, storedP, binning::p::binned_t); // Momentum of the track with 16 bits
+DECLARE_SOA_DYNAMIC_COLUMN(PUnpacked, p,
+                           [](binning::p::binned_t p_binned) -> float { return singletrackselector::unPack<binning::p>(p_binned); });
+
+DECLARE_SOA_COLUMN(StoredEta, storedEta, binning::eta::binned_t); // Pseudorapidity of the track with 16 bits
+DECLARE_SOA_DYNAMIC_COLUMN(EtaUnpacked, eta,
+                           [](binning::eta::binned_t eta_binned) -> float { return singletrackselector::unPack<binning::eta>(eta_binned); });
+
+DECLARE_SOA_COLUMN(StoredPhi, storedPhi, binning::phi::binned_t); // Azimuthal angle of the track with 16 bits
+DECLARE_SOA_DYNAMIC_COLUMN(PhiUnpacked, phi,
+                           [](binning::phi::binned_t phi_binned) -> float { return singletrackselector::unPack<binning::phi>(phi_binned); });
+
 //==================================== EXtra info ====================================
 
 DECLARE_SOA_COLUMN(TPCInnerParam, tpcInnerParam, float); // Momentum at inner wall of the TPC
@@ -419,6 +439,33 @@ DECLARE_SOA_TABLE_VERSIONED(SingleTrackSels_v2, "AOD", "SINGLETRACKSEL2", 2, //
                             singletrackselector::Pz<singletrackselector::P, singletrackselector::Eta>,
                             singletrackselector::PhiStar<singletrackselector::P, singletrackselector::Eta, singletrackselector::Sign, singletrackselector::Phi>);
 
+// Same content as SingleTrackSels_v3 with the kinematics quantized in 16 bits, to be decoded with single-track-selector-converter-compact
+DECLARE_SOA_TABLE(SingleTrackSelsCompact, "AOD", "SINGLETRACKSELC",
+                  o2::soa::Index<>,
+                  singletrackselector::SingleCollSelId,
+                  singletrackselector::StoredP,
+                  singletrackselector::StoredEta,
+                  singletrackselector::StoredPhi,
+                  singletrackselector::Sign,
+                  singletrackselector::TPCNClsFound,
+                  singletrackselector::TPCNClsShared,
+                  singletrackselector::ITSclsMap,
+                  singletrackselector::ITSclusterSizes,
+                  singletrackselector::StoredDcaXY,
+                  singletrackselector::StoredDcaZ,
+                  singletrackselector::StoredTPCChi2NCl,
+                  singletrackselector::StoredITSChi2NCl,
+                  singletrackselector::StoredTPCCrossedRowsOverFindableCls,
+
+                  singletrackselector::PUnpacked<singletrackselector::StoredP>,
+                  singletrackselector::EtaUnpacked<singletrackselector::StoredEta>,
+                  singletrackselector::PhiUnpacked<singletrackselector::StoredPhi>,
+                  singletrackselector::DcaXY<singletrackselector::StoredDcaXY>,
+                  singletrackselector::DcaZ<singletrackselector::StoredDcaZ>,
+                  singletrackselector::TPCChi2NCl<singletrackselector::StoredTPCChi2NCl>,
+                  singletrackselector::ITSChi2NCl<singletrackselector::StoredITSChi2NCl>,
+                  singletrackselector::TPCCrossedRowsOverFindableCls<singletrackselector::StoredTPCCrossedRowsOverFindableCls>);
+
 using SingleTrackSels = SingleTrackSels_v3;
 
 DECLARE_SOA_TABLE(SinglePIDEls_v0, "AOD", "SINGLEPIDEL0",
@@ -0,0 +1,54 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//
+/// \brief Converter of the compact singletrackselector track table to the standard one
+/// \since 14 October 2026
+
+#include <fairlogger/Logger.h>
+#include "PWGCF/Femto3D/DataModel/singletrackselector.h"
+#include "Framework/AnalysisTask.h"
+#include "Framework/runDataProcessing.h"
+
+using namespace o2;
+using namespace o2::framework;
+using namespace o2::aod;
+
+struct singleTrackSelectorConverterCompact {
+  Produces<o2::aod::SingleTrackSels> tableRow;
+
+  void init(InitContext&) {}
+
+  void process(o2::aod::SingleTrackSelsCompact const& tracks)
+  {
+    tableRow.reserve(tracks.size());
+    for (auto const& track : tracks) {
+      tableRow(track.singleCollSelId(),
+               track.p(),
+               track.eta(),
+               track.phi(),
+               track.sign(),
+               track.tpcNClsFound(),
+               track.tpcNClsShared(),
+               track.itsClsMap(),
+               track.itsClusterSizes(),
+               track.storedDcaXY(),
+               track.storedDcaZ(),
+               track.storedTpcChi2NCl(),
+               track.storedItsChi2NCl(),
+               track.storedTpcCrossedRowsOverFindableCls());
+    }
+  }
+};
+
+WorkflowSpec defineDataProcessing(ConfigContext const& cfgc)
+{
+  return WorkflowSpec{adaptAnalysisTask<singleTrackSelectorConverterCompact>(cfgc)};
+}
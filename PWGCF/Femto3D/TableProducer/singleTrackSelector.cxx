@@ -67,6 +67,7 @@ struct singleTrackSelector {
   Configurable<bool> rejectNotPropagatedTrks{"rejectNotPropagatedTrks", true, "rejects tracks that are not propagated to the primary vertex"};
   Configurable<bool> enable_gen_info{"enable_gen_info", false, "Enable MC true info"};
   Configurable<bool> fetchRate{"fetchRate", true, "Fetch the hadronic rate from the CCDB"};
+  Configurable<bool> storeCompact{"storeCompact", false, "Store the tracks in the compact table with the kinematics quantized in 16 bits, to be decoded with single-track-selector-converter-compact"};
 
   Configurable<std::vector<int>> _particlesToKeep{"particlesToKeepPDGs", std::vector<int>{2212, 1000010020}, "PDG codes of perticles for which the 'singletrackselector' tables will be created (only proton and deurton are supported now)"};
   Configurable<std::vector<float>> keepWithinNsigmaTPC{"keepWithinNsigmaTPC", std::vector<float>{-4.0f, 4.0f}, "TPC range for preselection of particles specified with PDG"};
@@ -103,6 +104,7 @@ struct singleTrackSelector {
   Produces<o2::aod::SingleCollSels> tableRowColl;
   Produces<o2::aod::SingleCollExtras> tableRowCollExtra;
   Produces<o2::aod::SingleTrackSels> tableRow;
+  Produces<o2::aod::SingleTrackSelsCompact> tableRowCompact;
   Produces<o2::aod::SingleTrkExtras> tableRowExtra;
 
   Produces<o2::aod::SinglePIDEls> tableRowPIDEl;
@@ -245,20 +247,37 @@ struct singleTrackSelector {
           if (track.pt() > _ptRemoveTofOutOfRange.value[0] && !o2::aod::singletrackselector::TOFselection(track, std::make_pair(ii, std::vector<float>{_ptRemoveTofOutOfRange.value[1], _ptRemoveTofOutOfRange.value[2]}), std::vector<float>{-10.f, +10.f}))
             continue;
 
-          tableRow(tableRowColl.lastIndex(),
-                   track.p(),
-                   track.eta(),
-                   track.phi(),
-                   track.sign(),
-                   track.tpcNClsFound(),
-                   track.tpcNClsShared(),
-                   track.itsClusterMap(),
-                   track.itsClusterSizes(),
-                   singletrackselector::packSymmetric<singletrackselector::binning::dca>(track.dcaXY()),
-                   singletrackselector::packSymmetric<singletrackselector::binning::dca>(track.dcaZ()),
-                   singletrackselector::packInTable<singletrackselector::binning::chi2>(track.tpcChi2NCl()),
-                   singletrackselector::packInTable<singletrackselector::binning::chi2>(track.itsChi2NCl()),
-                   singletrackselector::packInTable<singletrackselector::binning::rowsOverFindable>(track.tpcCrossedRowsOverFindableCls()));
+          if (storeCompact) {
+            tableRowCompact(tableRowColl.lastIndex(),
+                            singletrackselector::packInTable<singletrackselector::binning::p>(track.p()),
+                            singletrackselector::packInTable<singletrackselector::binning::eta>(track.eta()),
+                            singletrackselector::packInTable<singletrackselector::binning::phi>(track.phi()),
+                            track.sign(),
+                            track.tpcNClsFound(),
+                            track.tpcNClsShared(),
+                            track.itsClusterMap(),
+                            track.itsClusterSizes(),
+                            singletrackselector::packSymmetric<singletrackselector::binning::dca>(track.dcaXY()),
+                            singletrackselector::packSymmetric<singletrackselector::binning::dca>(track.dcaZ()),
+                            singletrackselector::packInTable<singletrackselector::binning::chi2>(track.tpcChi2NCl()),
+                            singletrackselector::packInTable<singletrackselector::binning::chi2>(track.itsChi2NCl()),
+                            singletrackselector::packInTable<singletrackselector::binning::rowsOverFindable>(track.tpcCrossedRowsOverFindableCls()));
+          } else {
+            tableRow(tableRowColl.lastIndex(),
+                     track.p(),
+                     track.eta(),
+                     track.phi(),
+                     track.sign(),
+                     track.tpcNClsFound(),
+                     track.tpcNClsShared(),
+                     track.itsClusterMap(),
+                     track.itsClusterSizes(),
+                     singletrackselector::packSymmetric<singletrackselector::binning::dca>(track.dcaXY()),
+                     singletrackselector::packSymmetric<singletrackselector::binning::dca>(track.dcaZ()),
+                     singletrackselector::packInTable<singletrackselector::binning::chi2>(track.tpcChi2NCl()),
+                     singletrackselector::packInTable<singletrackselector::binning::chi2>(track.itsChi2NCl()),
+                     singletrackselector::packInTable<singletrackselector::binning::rowsOverFindable>(track.tpcCrossedRowsOverFindableCls()));
+          }
 
           tableRowExtra(track.tpcInnerParam(),
                         track.tpcSignal(),
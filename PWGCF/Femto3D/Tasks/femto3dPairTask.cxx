@@ -18,8 +18,8 @@
 #include <random>
 #include <chrono>
 #include <vector>
-#include <map>
 #include <memory>
+#include <thread>
 #include <utility>
 #include <TParameter.h>
 #include <TH1F.h>
@@ -107,14 +107,8 @@ struct FemtoCorrelations {
   Configurable<int> _fill3dAddHistos{"fill3dAddHistos", 1, "flag for filling additional 3D histos: 0 -- nothing; 1 -- Q_LCMS vs. k*; 2 -- Q_LCMS vs. Gamma_out (currently testing)"};
   Configurable<int> _fillDetaDphi{"fillDetaDphi", -1, "flag for filling dEta(dPhi*) histos: '-1' -- don't fill; '0' -- fill before the cut; '1' -- fill after the cut; '2' -- fill before & after the cut"};
   ConfigurableAxis CF3DqLCMSBinning{"CF3DqLCMSBinning", {60, -0.3, 0.3}, "q_out/side/long binning of the CF 3D in LCMS (Nbins, lowlimit, uplimit)"};
-  // the next configarable is responsible for skipping (pseudo)randomly chosen ($value -1) pairs of events in the mixing process
-  // migth be useful (for the sake of execution time and the output file size ...) in case of too many events per DF since in the SE thacks are mixed in N_ev and in the ME 0.5*N_ev*(N_ev - 1)
-  // note that in the SE number of pairs per event = 0.5*N_trks*(N_trks - 1) BUT in the ME its = N_trks^2 so final differense in the SE & ME pairs histos will be more
-  // P.S.: the explanation might be not very clear (sorry for that) as well as the name of the variable so, feel free to change it!
-  // P.P.S. the chosen way of optimizing the mixing midgt not be the correct one -- feel free to propose the right one!
-  // P.P.P.S. choose wisely....
-  // P.P.P.P.S this way is still being testing i might be reconsidered; might change in the future, keep looking at the source code
-  Configurable<unsigned int> _MEreductionFactor{"MEreductionFactor", 1, "only one (pseudo)randomly choosen event out per pair $value events will be processed and contribute to the final mixing (if < 2 -> all the possible event pairs (per vertex&cent bin) will be processed); implemented for the sake of efficiency; look at the source code;"};
+  Configurable<bool> _parallelFill3D{"parallelFill3D", false, "flag for adding the buffered 3D pairs to the histos with one thread per kT bin at the end of each DF"};
+  Configurable<int> _mixingDepth{"mixingDepth", -1, "number of following events of the same vertex&mult bin (within the DF) each event is mixed with; if < 1 -> all the events of the bin are mixed"};
 
   bool IsIdentical;
 
@@ -128,15 +122,14 @@ struct FemtoCorrelations {
   // using FilteredTracks = soa::Join<aod::SingleTrackSels, aod::SinglePIDPis, aod::SinglePIDKas, aod::SinglePIDPrs, aod::SinglePIDDes, aod::SinglePIDTrs, aod::SinglePIDHes>; // main
   using FilteredTracks = soa::Join<aod::SingleTrackSels, aod::SinglePIDPrs, aod::SinglePIDDes>; // tmp solution till the HL is fixed
 
-  typedef std::shared_ptr<soa::Filtered<FilteredTracks>::iterator> trkType;
-  typedef std::shared_ptr<soa::Filtered<FilteredCollisions>::iterator> colType;
+  typedef const o2::aod::singletrackselector::FemtoTrack* trkType;
 
-  std::map<int64_t, std::vector<trkType>> selectedtracks_1;
-  std::map<int64_t, std::vector<trkType>> selectedtracks_2;
-  std::map<std::pair<int, float>, std::vector<colType>> mixbins;
+  o2::aod::singletrackselector::FemtoMixingPool mixingPool; // selected tracks (0 -- first particle; 1 -- second particle) and events per vertex&mult bin of the DF
 
   std::unique_ptr<o2::aod::singletrackselector::FemtoPair<trkType>> Pair = std::make_unique<o2::aod::singletrackselector::FemtoPair<trkType>>();
 
+  std::mt19937 randomSign; // randomizes the pair order in the 3D histos
+
   Filter pFilter = o2::aod::singletrackselector::p > _min_P&& o2::aod::singletrackselector::p < _max_P;
   Filter etaFilter = nabs(o2::aod::singletrackselector::eta) < _eta;
 
@@ -168,6 +161,10 @@ struct FemtoCorrelations {
   std::vector<std::vector<std::shared_ptr<TH3>>> MEhistos_3D;
   std::vector<std::vector<std::shared_ptr<TH3>>> Add3dHistos;
 
+  std::vector<std::vector<o2::aod::singletrackselector::Femto3DAccumulator>> SEaccumulators_3D; // flat counts of the SE/ME 3D histos, added to them at the end of each DF
+  std::vector<std::vector<o2::aod::singletrackselector::Femto3DAccumulator>> MEaccumulators_3D;
+  std::vector<std::vector<o2::aod::singletrackselector::Femto3DAccumulator>> Add3dAccumulators;
+
   std::vector<std::vector<std::shared_ptr<TH2>>> DoubleTrack_SE_histos_BC; // BC -- before cutting
   std::vector<std::vector<std::shared_ptr<TH2>>> DoubleTrack_ME_histos_BC; // BC -- before cutting
 
@@ -195,6 +192,9 @@ struct FemtoCorrelations {
     TPCcuts_2 = std::make_pair(_particlePDG_2, _tpcNSigma_2);
     TOFcuts_2 = std::make_pair(_particlePDG_2, _tofNSigma_2);
 
+    mixingPool.init(_vertexNbinsToMix * (_centBins.value.size() - 1) * std::max(_multNsubBins.value, 1));
+    randomSign.seed(std::chrono::steady_clock::now().time_since_epoch().count());
+
     for (unsigned int i = 0; i < _centBins.value.size() - 1; i++) {
       std::vector<std::shared_ptr<TH1>> SEperMult_1D;
       std::vector<std::shared_ptr<TH1>> MEperMult_1D;
@@ -239,10 +239,23 @@ struct FemtoCorrelations {
             Add3dHistosperMult.push_back(std::move(hAdd3dHistos));
           }
         }
+        std::vector<o2::aod::singletrackselector::Femto3DAccumulator> SEaccperMult_3D(SEperMult_3D.size());
+        std::vector<o2::aod::singletrackselector::Femto3DAccumulator> MEaccperMult_3D(MEperMult_3D.size());
+        for (unsigned int j = 0; j < SEperMult_3D.size(); j++) {
+          SEaccperMult_3D[j].init(SEperMult_3D[j]);
+          MEaccperMult_3D[j].init(MEperMult_3D[j]);
+        }
+        SEaccumulators_3D.push_back(std::move(SEaccperMult_3D));
+        MEaccumulators_3D.push_back(std::move(MEaccperMult_3D));
         SEhistos_3D.push_back(std::move(SEperMult_3D));
         MEhistos_3D.push_back(std::move(MEperMult_3D));
-        if (_fill3dAddHistos != 0)
+        if (_fill3dAddHistos != 0) {
+          std::vector<o2::aod::singletrackselector::Femto3DAccumulator> Add3dAccperMult(Add3dHistosperMult.size());
+          for (unsigned int j = 0; j < Add3dHistosperMult.size(); j++)
+            Add3dAccperMult[j].init(Add3dHistosperMult[j]);
+          Add3dAccumulators.push_back(std::move(Add3dAccperMult));
           Add3dHistos.push_back(std::move(Add3dHistosperMult));
+        }
       }
 
       if (_fillDetaDphi > -1) {
@@ -299,7 +312,7 @@ struct FemtoCorrelations {
     for (unsigned int ii = 0; ii < tracks.size(); ii++) { // nested loop for all the combinations
       for (unsigned int iii = ii + 1; iii < tracks.size(); iii++) {
 
-        Pair->SetPair(tracks[ii], tracks[iii]);
+        Pair->SetPair(&tracks[ii], &tracks[iii]);
         float pair_kT = Pair->GetKt();
 
         if (pair_kT < *_kTbins.value.begin() || pair_kT >= *(_kTbins.value.end() - 1))
@@ -327,9 +340,8 @@ struct FemtoCorrelations {
         SEhistos_1D[multBin][kTbin]->Fill(Pair->GetKstar()); // close pair rejection and fillig the SE histo
 
         if (_fill3dCF) {
-          std::mt19937 mt(std::chrono::steady_clock::now().time_since_epoch().count());
-          TVector3 qLCMS = std::pow(-1, (mt() % 2)) * Pair->GetQLCMS(); // introducing randomness to the pair order ([first, second]); important only for 3D because if there are any sudden order/correlation in the tables, it could couse unwanted asymmetries in the final 3d rel. momentum distributions; irrelevant in 1D case because the absolute value of the rel.momentum is taken
-          SEhistos_3D[multBin][kTbin]->Fill(qLCMS.X(), qLCMS.Y(), qLCMS.Z());
+          TVector3 qLCMS = (randomSign() % 2 ? -1. : 1.) * Pair->GetQLCMS(); // introducing randomness to the pair order ([first, second]); important only for 3D because if there are any sudden order/correlation in the tables, it could couse unwanted asymmetries in the final 3d rel. momentum distributions; irrelevant in 1D case because the absolute value of the rel.momentum is taken
+          SEaccumulators_3D[multBin][kTbin].fill(qLCMS.X(), qLCMS.Y(), qLCMS.Z());
         }
         Pair->ResetPair();
       }
@@ -344,10 +356,10 @@ struct FemtoCorrelations {
     if (_fill3dCF && multBin > SEhistos_3D.size())
       LOGF(fatal, "multBin value passed to the mixTracks function exceeds the configured number of Cent. bins (3D)");
 
-    for (auto ii : tracks1) {
-      for (auto iii : tracks2) {
+    for (const auto& ii : tracks1) {
+      for (const auto& iii : tracks2) {
 
-        Pair->SetPair(ii, iii);
+        Pair->SetPair(&ii, &iii);
         float pair_kT = Pair->GetKt();
 
         if (pair_kT < *_kTbins.value.begin() || pair_kT >= *(_kTbins.value.end() - 1))
@@ -384,21 +396,19 @@ struct FemtoCorrelations {
           mThistos[multBin][kTbin]->Fill(Pair->GetMt()); // test
 
           if (_fill3dCF) {
-            std::mt19937 mt(std::chrono::steady_clock::now().time_since_epoch().count());
-            TVector3 qLCMS = std::pow(-1, (mt() % 2)) * Pair->GetQLCMS(); // introducing randomness to the pair order ([first, second]); important only for 3D because if there are any sudden order/correlation in the tables, it could couse unwanted asymmetries in the final 3d rel. momentum distributions; irrelevant in 1D case because the absolute value of the rel.momentum is taken
-            SEhistos_3D[multBin][kTbin]->Fill(qLCMS.X(), qLCMS.Y(), qLCMS.Z());
+            TVector3 qLCMS = (randomSign() % 2 ? -1. : 1.) * Pair->GetQLCMS(); // introducing randomness to the pair order ([first, second]); important only for 3D because if there are any sudden order/correlation in the tables, it could couse unwanted asymmetries in the final 3d rel. momentum distributions; irrelevant in 1D case because the absolute value of the rel.momentum is taken
+            SEaccumulators_3D[multBin][kTbin].fill(qLCMS.X(), qLCMS.Y(), qLCMS.Z());
           }
         } else {
           MEhistos_1D[multBin][kTbin]->Fill(Pair->GetKstar());
 
           if (_fill3dCF) {
-            std::mt19937 mt(std::chrono::steady_clock::now().time_since_epoch().count());
-            TVector3 qLCMS = std::pow(-1, (mt() % 2)) * Pair->GetQLCMS(); // introducing randomness to the pair order ([first, second]); important only for 3D because if there are any sudden order/correlation in the tables, it could couse unwanted asymmetries in the final 3d rel. momentum distributions; irrelevant in 1D case because the absolute value of the rel.momentum is taken
-            MEhistos_3D[multBin][kTbin]->Fill(qLCMS.X(), qLCMS.Y(), qLCMS.Z());
+            TVector3 qLCMS = (randomSign() % 2 ? -1. : 1.) * Pair->GetQLCMS(); // introducing randomness to the pair order ([first, second]); important only for 3D because if there are any sudden order/correlation in the tables, it could couse unwanted asymmetries in the final 3d rel. momentum distributions; irrelevant in 1D case because the absolute value of the rel.momentum is taken
+            MEaccumulators_3D[multBin][kTbin].fill(qLCMS.X(), qLCMS.Y(), qLCMS.Z());
             if (_fill3dAddHistos == 1)
-              Add3dHistos[multBin][kTbin]->Fill(qLCMS.X(), qLCMS.Y(), qLCMS.Z(), Pair->GetKstar());
+              Add3dAccumulators[multBin][kTbin].fill(qLCMS.X(), qLCMS.Y(), qLCMS.Z(), Pair->GetKstar());
             else if (_fill3dAddHistos == 2)
-              Add3dHistos[multBin][kTbin]->Fill(qLCMS.X(), qLCMS.Y(), qLCMS.Z(), Pair->GetGammaOut());
+              Add3dAccumulators[multBin][kTbin].fill(qLCMS.X(), qLCMS.Y(), qLCMS.Z(), Pair->GetGammaOut());
           }
         }
         Pair->ResetPair();
@@ -406,6 +416,31 @@ struct FemtoCorrelations {
     }
   }
 
+  void flush3dAccumulators()
+  { // the 3D histos of different kT bins are independent -> one worker per kT bin, no locking needed
+    auto flushkTbin = [this](unsigned int kTbin) {
+      for (auto* accumulators : {&SEaccumulators_3D, &MEaccumulators_3D, &Add3dAccumulators}) {
+        for (auto& accPerMult : *accumulators) {
+          if (kTbin < accPerMult.size())
+            accPerMult[kTbin].flush();
+        }
+      }
+    };
+
+    const unsigned int nkTbins = _kTbins.value.size() - 1;
+    if (!_parallelFill3D || nkTbins < 2) {
+      for (unsigned int kTbin = 0; kTbin < nkTbins; kTbin++)
+        flushkTbin(kTbin);
+      return;
+    }
+    std::vector<std::thread> workers;
+    workers.reserve(nkTbins);
+    for (unsigned int kTbin = 0; kTbin < nkTbins; kTbin++)
+      workers.emplace_back(flushkTbin, kTbin);
+    for (auto& worker : workers)
+      worker.join();
+  }
+
   void process(soa::Filtered<FilteredCollisions> const& collisions, soa::Filtered<FilteredTracks> const& tracks)
   {
     if (_particlePDG_1 == 0 || _particlePDG_2 == 0)
@@ -438,7 +473,7 @@ struct FemtoCorrelations {
         continue;
 
       if (track.sign() == _sign_1 && (track.p() < _PIDtrshld_1 ? o2::aod::singletrackselector::TPCselection<true>(track, TPCcuts_1, _itsNSigma_1.value) : o2::aod::singletrackselector::TOFselection(track, TOFcuts_1, _tpcNSigmaResidual_1.value))) { // filling the map: eventID <-> selected particles1
-        selectedtracks_1[track.singleCollSelId()].push_back(std::make_shared<soa::Filtered<FilteredTracks>::iterator>(track));
+        mixingPool.addTrack(0, track.singleCollSelId(), o2::aod::singletrackselector::FemtoTrack(track.p(), track.eta(), track.phi(), track.sign()));
 
         pHisto_first->Fill(track.p());
         ITShisto_first->Fill(track.p(), o2::aod::singletrackselector::getITSNsigma(track, _particlePDG_1));
@@ -449,7 +484,7 @@ struct FemtoCorrelations {
       if (IsIdentical) {
         continue;
       } else if (track.sign() != _sign_2 && !TOFselection(track, std::make_pair(_particlePDGtoReject, _rejectWithinNsigmaTOF)) && (track.p() < _PIDtrshld_2 ? o2::aod::singletrackselector::TPCselection<true>(track, TPCcuts_2, _itsNSigma_2.value) : o2::aod::singletrackselector::TOFselection(track, TOFcuts_2, _tpcNSigmaResidual_2.value))) { // filling the map: eventID <-> selected particles2 if (see condition above ^)
-        selectedtracks_2[track.singleCollSelId()].push_back(std::make_shared<soa::Filtered<FilteredTracks>::iterator>(track));
+        mixingPool.addTrack(1, track.singleCollSelId(), o2::aod::singletrackselector::FemtoTrack(track.p(), track.eta(), track.phi(), track.sign()));
 
         pHisto_second->Fill(track.p());
         ITShisto_second->Fill(track.p(), o2::aod::singletrackselector::getITSNsigma(track, _particlePDG_2));
@@ -458,6 +493,8 @@ struct FemtoCorrelations {
       }
     }
 
+    mixingPool.finishTracks();
+
     for (const auto& collision : collisions) {
       if (collision.multPerc() < *_centBins.value.begin() || collision.multPerc() >= *(_centBins.value.end() - 1))
         continue;
@@ -478,100 +515,59 @@ struct FemtoCorrelations {
         continue;
       if (_requestIsGoodITSLayersAll && !collision.isGoodITSLayersAll())
         continue;
-      if (selectedtracks_1.find(collision.globalIndex()) == selectedtracks_1.end()) {
-        if (IsIdentical)
-          continue;
-        else if (selectedtracks_2.find(collision.globalIndex()) == selectedtracks_2.end())
-          continue;
-      }
-      int vertexBinToMix = std::floor((collision.posZ() + _vertexZ) / (2 * _vertexZ / _vertexNbinsToMix));
-      float centBinToMix = o2::aod::singletrackselector::getBinIndex<float>(collision.multPerc(), _centBins, _multNsubBins);
+      o2::aod::singletrackselector::FemtoMixingPool::Event event;
+      event.tracks[0] = mixingPool.getTracks(0, collision.globalIndex());
+      event.tracks[1] = IsIdentical ? event.tracks[0] : mixingPool.getTracks(1, collision.globalIndex());
+      if (event.tracks[0].size() == 0 && event.tracks[1].size() == 0)
+        continue;
 
-      mixbins[std::pair<int, float>{vertexBinToMix, centBinToMix}].push_back(std::make_shared<soa::Filtered<FilteredCollisions>::iterator>(collision));
+      int vertexBinToMix = std::floor((collision.posZ() + _vertexZ) / (2 * _vertexZ / _vertexNbinsToMix));
+      vertexBinToMix = std::clamp(vertexBinToMix, 0, _vertexNbinsToMix - 1);
+      int centBinToMix = o2::aod::singletrackselector::getSubBinIndex<int>(collision.multPerc(), _centBins, _multNsubBins);
+
+      event.collisionId = collision.globalIndex();
+      event.magField = collision.magField();
+      event.mult = collision.mult();
+      event.multBin = centBinToMix / std::max(_multNsubBins.value, 1);
+      mixingPool.addEvent(vertexBinToMix * (_centBins.value.size() - 1) * std::max(_multNsubBins.value, 1) + centBinToMix, event);
     }
 
     //====================================== mixing starts here ======================================
 
-    if (IsIdentical) { //====================================== mixing identical ======================================
-
-      for (auto i = mixbins.begin(); i != mixbins.end(); i++) { // iterating over all vertex&mult bins
-        unsigned int EvPerBin = (i->second).size();
-
-        for (unsigned int indx1 = 0; indx1 < EvPerBin; indx1++) { // loop over all the events in each vertex&mult bin
+    for (int bin = 0; bin < mixingPool.getNbins(); bin++) { // iterating over all vertex&mult bins
+      const auto& events = mixingPool.getEvents(bin);
+      unsigned int EvPerBin = events.size();
 
-          auto col1 = (i->second)[indx1];
+      for (unsigned int indx1 = 0; indx1 < EvPerBin; indx1++) { // loop over all the events in each vertex&mult bin
 
-          Pair->SetMagField1(col1->magField());
-          Pair->SetMagField2(col1->magField());
+        const auto& col1 = events[indx1];
 
-          unsigned int centBin = std::floor((i->first).second);
-          MultHistos[centBin]->Fill(col1->mult());
+        Pair->SetMagField1(col1.magField);
+        Pair->SetMagField2(col1.magField);
 
-          mixTracks(selectedtracks_1[col1->index()], centBin); // mixing SE identical
+        unsigned int centBin = col1.multBin;
+        MultHistos[centBin]->Fill(col1.mult);
 
-          for (unsigned int indx2 = indx1 + 1; indx2 < EvPerBin; indx2++) { // nested loop for all the combinations of collisions in a chosen mult/vertex bin
-            if (_MEreductionFactor.value > 1) {
-              std::mt19937 mt(std::chrono::steady_clock::now().time_since_epoch().count());
-              if ((mt() % (_MEreductionFactor.value + 1)) < _MEreductionFactor.value)
-                continue;
-            }
-
-            auto col2 = (i->second)[indx2];
-
-            Pair->SetMagField2(col2->magField());
-            mixTracks<1>(selectedtracks_1[col1->index()], selectedtracks_1[col2->index()], centBin); // mixing ME identical, in <> brackets: 0 -- SE; 1 -- ME
-          }
-        }
-      }
-
-    } else { //====================================== mixing non-identical ======================================
-
-      for (auto i = mixbins.begin(); i != mixbins.end(); i++) { // iterating over all vertex&mult bins
-        unsigned int EvPerBin = (i->second).size();
-
-        for (unsigned int indx1 = 0; indx1 < EvPerBin; indx1++) { // loop over all the events in each vertex&mult bin
-
-          auto col1 = (i->second)[indx1];
-
-          Pair->SetMagField1(col1->magField());
-          Pair->SetMagField2(col1->magField());
-
-          unsigned int centBin = std::floor((i->first).second);
-          MultHistos[centBin]->Fill(col1->mult());
-
-          mixTracks<0>(selectedtracks_1[col1->index()], selectedtracks_2[col1->index()], centBin); // mixing SE non-identical, in <> brackets: 0 -- SE; 1 -- ME
-
-          for (unsigned int indx2 = indx1 + 1; indx2 < EvPerBin; indx2++) { // nested loop for all the combinations of collisions in a chosen mult/vertex bin
-            if (_MEreductionFactor.value > 1) {
-              std::mt19937 mt(std::chrono::steady_clock::now().time_since_epoch().count());
-              if (mt() % (_MEreductionFactor.value + 1) < _MEreductionFactor.value)
-                continue;
-            }
+        if (IsIdentical)
+          mixTracks(col1.tracks[0], centBin); // mixing SE identical
+        else
+          mixTracks<0>(col1.tracks[0], col1.tracks[1], centBin); // mixing SE non-identical, in <> brackets: 0 -- SE; 1 -- ME
 
-            auto col2 = (i->second)[indx2];
+        unsigned int lastIndx2 = _mixingDepth > 0 ? std::min(EvPerBin, indx1 + 1 + _mixingDepth) : EvPerBin; // deterministic depth: only the following events of the bin
+        for (unsigned int indx2 = indx1 + 1; indx2 < lastIndx2; indx2++) { // nested loop for all the combinations of collisions in a chosen mult/vertex bin
+          const auto& col2 = events[indx2];
 
-            Pair->SetMagField2(col2->magField());
-            mixTracks<1>(selectedtracks_1[col1->index()], selectedtracks_2[col2->index()], centBin); // mixing ME non-identical, in <> brackets: 0 -- SE; 1 -- ME
-          }
+          Pair->SetMagField2(col2.magField);
+          mixTracks<1>(col1.tracks[0], col2.tracks[1], centBin); // mixing ME (for identical the second tracks are the first ones), in <> brackets: 0 -- SE; 1 -- ME
         }
       }
-
-    } //====================================== end of mixing non-identical ======================================
-
-    // clearing up
-    for (auto i = selectedtracks_1.begin(); i != selectedtracks_1.end(); i++)
-      (i->second).clear();
-    selectedtracks_1.clear();
-
-    if (!IsIdentical) {
-      for (auto i = selectedtracks_2.begin(); i != selectedtracks_2.end(); i++)
-        (i->second).clear();
-      selectedtracks_2.clear();
     }
 
-    for (auto i = mixbins.begin(); i != mixbins.end(); i++)
-      (i->second).clear();
-    mixbins.clear();
+    // filling the 3D histos and clearing up
+    if (_fill3dCF)
+      flush3dAccumulators();
+
+    mixingPool.clear();
   }
 };
 
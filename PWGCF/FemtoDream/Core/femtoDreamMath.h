@@ -284,6 +284,49 @@ class FemtoDreamMath
   }
 };
 
+/// \class FemtoDreamQ3PairTerms
+/// \brief Pair terms -q_ij^2 of the Q3 between the particles of two groups, computed once per event
+/// Q3^2 is the sum of the three non-negative pair terms of the triplet, so the triplets can be pruned with the pair terms before Q3 is computed
+class FemtoDreamQ3PairTerms
+{
+ public:
+  /// \param parts1 particles of the rows of the table
+  /// \param mass1 mass of the particles of the rows
+  /// \param parts2 particles of the columns of the table
+  /// \param mass2 mass of the particles of the columns
+  template <typename T1, typename T2>
+  void fill(const T1& parts1, const float mass1, const T2& parts2, const float mass2)
+  {
+    fillVectors(parts1, mass1, mVectors1);
+    fillVectors(parts2, mass2, mVectors2);
+    mNColumns = mVectors2.size();
+    mTerms.resize(mVectors1.size() * mNColumns);
+    for (size_t i = 0; i < mVectors1.size(); i++) {
+      for (size_t j = 0; j < mNColumns; j++) {
+        mTerms[i * mNColumns + j] = -FemtoDreamMath::getqij(mVectors1[i], mVectors2[j]).M2();
+      }
+    }
+  }
+
+  /// \return the pair term of the i-th particle of the rows and the j-th particle of the columns
+  float get(size_t i, size_t j) const { return mTerms[i * mNColumns + j]; }
+
+ private:
+  template <typename T>
+  static void fillVectors(const T& parts, const float mass, std::vector<ROOT::Math::PxPyPzEVector>& vectors)
+  {
+    vectors.clear();
+    for (auto const& part : parts) {
+      vectors.emplace_back(ROOT::Math::PtEtaPhiMVector(part.pt(), part.eta(), part.phi(), mass));
+    }
+  }
+
+  std::vector<ROOT::Math::PxPyPzEVector> mVectors1;
+  std::vector<ROOT::Math::PxPyPzEVector> mVectors2;
+  std::vector<float> mTerms; ///< row-major table of the pair terms
+  size_t mNColumns = 0;
+};
+
 } // namespace o2::analysis::femtoDream
 
 #endif // PWGCF_FEMTODREAM_CORE_FEMTODREAMMATH_H_
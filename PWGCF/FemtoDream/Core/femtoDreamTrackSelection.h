@@ -28,6 +28,7 @@
 #include "Framework/HistogramRegistry.h"
 #include "ReconstructionDataFormats/PID.h"
 
+#include <array>
 #include <cmath>
 #include <string>
 #include <vector>
@@ -257,6 +258,9 @@ class FemtoDreamTrackSelection : public FemtoDreamObjectSelection<float, femtoDr
   float nSigmaPIDOffsetTPC;
   float nSigmaPIDOffsetTOF;
   std::vector<o2::track::PID> mPIDspecies; ///< All the particle species for which the n_sigma values need to be stored
+  std::vector<float> mPIDTPCValues;        ///< TPC n_sigma of the species for the current track, kept to avoid allocations per track
+  std::vector<float> mPIDTOFValues;        ///< TOF n_sigma of the species for the current track
+  std::vector<float> mPIDITSValues;        ///< ITS n_sigma of the species for the current track
   static constexpr int kNtrackSelection = 14;
   static constexpr std::string_view mSelectionNames[kNtrackSelection] = {"Sign",
                                                                          "PtMin",
@@ -503,88 +507,50 @@ std::array<cutContainerType, 2> FemtoDreamTrackSelection::getCutContainer(T cons
   cutContainerType output = 0;
   size_t counter = 0;
   cutContainerType outputPID = 0;
-  const auto sign = track.sign();
-  const auto pt = Pt;
-  const auto eta = Eta;
-  const auto tpcNClsF = track.tpcNClsFound();
-  const auto tpcRClsC = track.tpcCrossedRowsOverFindableCls();
-  const auto tpcNClsC = track.tpcNClsCrossedRows();
-  const auto tpcNClsS = track.tpcNClsShared();
-  const auto itsNCls = track.itsNCls();
-  const auto itsNClsIB = track.itsNClsInnerBarrel();
-  const auto dcaXY = track.dcaXY();
-  const auto dcaZ = track.dcaZ();
-  const auto dca = Dca;
-
-  std::vector<float> pidTPC, pidTOF, pidITS;
+  /// the observables are looked up once per track and the selections then only index them
+  std::array<float, kNtrackSelection> observables{};
+  observables[femtoDreamTrackSelection::kSign] = track.sign();
+  observables[femtoDreamTrackSelection::kpTMin] = Pt;
+  observables[femtoDreamTrackSelection::kpTMax] = Pt;
+  observables[femtoDreamTrackSelection::kEtaMax] = Eta;
+  observables[femtoDreamTrackSelection::kTPCnClsMin] = track.tpcNClsFound();
+  observables[femtoDreamTrackSelection::kTPCfClsMin] = track.tpcCrossedRowsOverFindableCls();
+  observables[femtoDreamTrackSelection::kTPCcRowsMin] = track.tpcNClsCrossedRows();
+  observables[femtoDreamTrackSelection::kTPCsClsMax] = track.tpcNClsShared();
+  observables[femtoDreamTrackSelection::kITSnClsMin] = track.itsNCls();
+  observables[femtoDreamTrackSelection::kITSnClsIbMin] = track.itsNClsInnerBarrel();
+  observables[femtoDreamTrackSelection::kDCAxyMax] = track.dcaXY();
+  observables[femtoDreamTrackSelection::kDCAzMax] = track.dcaZ();
+  observables[femtoDreamTrackSelection::kDCAMin] = Dca;
+
+  mPIDTPCValues.clear();
+  mPIDTOFValues.clear();
+  mPIDITSValues.clear();
   for (const auto& it : mPIDspecies) {
-    pidTPC.push_back(getNsigmaTPC(track, it));
-    pidTOF.push_back(getNsigmaTOF(track, it));
+    mPIDTPCValues.push_back(getNsigmaTPC(track, it) - nSigmaPIDOffsetTPC);
+    mPIDTOFValues.push_back(getNsigmaTOF(track, it) - nSigmaPIDOffsetTOF);
     if constexpr (useItsPid) {
-      pidITS.push_back(getNsigmaITS(track, it));
+      mPIDITSValues.push_back(getNsigmaITS(track, it));
     }
   }
 
-  float observable = 0.;
   for (auto& sel : mSelections) {
     auto selVariable = sel.getSelectionVariable();
     if (selVariable == femtoDreamTrackSelection::kPIDnSigmaMax) {
-      /// PID needsgetNsigmaITSto be handled a bit differently since we may need more than one species
+      /// PID needs to be handled a bit differently since we may need more than one species
       for (size_t i = 0; i < mPIDspecies.size(); ++i) {
-        auto pidTPCVal = pidTPC.at(i) - nSigmaPIDOffsetTPC;
-        auto pidTOFVal = pidTOF.at(i) - nSigmaPIDOffsetTOF;
+        auto pidTPCVal = mPIDTPCValues[i];
+        auto pidTOFVal = mPIDTOFValues[i];
         auto pidComb = std::sqrt(pidTPCVal * pidTPCVal + pidTOFVal * pidTOFVal);
         sel.checkSelectionSetBitPID(pidTPCVal, outputPID);
         sel.checkSelectionSetBitPID(pidComb, outputPID);
         if constexpr (useItsPid) {
-          auto pidITSVal = pidITS.at(i);
-          sel.checkSelectionSetBitPID(pidITSVal, outputPID);
+          sel.checkSelectionSetBitPID(mPIDITSValues[i], outputPID);
         }
       }
     } else {
       /// for the rest it's all the same
-      switch (selVariable) {
-        case (femtoDreamTrackSelection::kSign):
-          observable = sign;
-          break;
-        case (femtoDreamTrackSelection::kpTMin):
-        case (femtoDreamTrackSelection::kpTMax):
-          observable = pt;
-          break;
-        case (femtoDreamTrackSelection::kEtaMax):
-          observable = eta;
-          break;
-        case (femtoDreamTrackSelection::kTPCnClsMin):
-          observable = tpcNClsF;
-          break;
-        case (femtoDreamTrackSelection::kTPCfClsMin):
-          observable = tpcRClsC;
-          break;
-        case (femtoDreamTrackSelection::kTPCcRowsMin):
-          observable = tpcNClsC;
-          break;
-        case (femtoDreamTrackSelection::kTPCsClsMax):
-          observable = tpcNClsS;
-          break;
-        case (femtoDreamTrackSelection::kITSnClsMin):
-          observable = itsNCls;
-          break;
-        case (femtoDreamTrackSelection::kITSnClsIbMin):
-          observable = itsNClsIB;
-          break;
-        case (femtoDreamTrackSelection::kDCAxyMax):
-          observable = dcaXY;
-          break;
-        case (femtoDreamTrackSelection::kDCAzMax):
-          observable = dcaZ;
-          break;
-        case (femtoDreamTrackSelection::kDCAMin):
-          observable = dca;
-          break;
-        case (femtoDreamTrackSelection::kPIDnSigmaMax):
-          break;
-      }
-      sel.checkSelectionSetBit(observable, output, counter, mHistogramRegistry);
+      sel.checkSelectionSetBit(observables[selVariable], output, counter, mHistogramRegistry);
     }
   }
   return {output, outputPID};
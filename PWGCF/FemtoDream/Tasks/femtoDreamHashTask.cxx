@@ -20,6 +20,8 @@
 #include "Framework/runDataProcessing.h"
 #include "Framework/ASoAHelpers.h"
 
+#include <vector>
+
 using namespace o2;
 using namespace o2::framework;
 
@@ -32,6 +34,12 @@ struct femtoDreamPairHashTask {
   std::vector<float> CastCfgVtxBins, CastCfgMultBins;
 
   Produces<aod::MixingHashes> hashes;
+  Produces<aod::MixingHashSorted> hashSorted;
+  Produces<aod::MixingHashBuckets> hashBuckets;
+
+  std::vector<int> collisionHashes;  // hash of each collision of the data frame
+  std::vector<int> bucketCounts;     // number of collisions per hash, then first row in the sorted index
+  std::vector<int> sortedCollisions; // rows of the collisions sorted by hash
 
   void init(InitContext&)
   {
@@ -40,10 +48,41 @@ struct femtoDreamPairHashTask {
     CastCfgMultBins = (std::vector<float>)CfgMultBins;
   }
 
-  void process(o2::aod::FDCollision const& col)
+  void process(o2::aod::FDCollisions const& cols)
   {
-    /// the hash of the collision is computed and written to table
-    hashes(eventmixing::getMixingBin(CastCfgVtxBins, CastCfgMultBins, col.posZ(), col.multV0M()));
+    /// the hash of each collision is computed and written to table
+    collisionHashes.clear();
+    for (auto const& col : cols) {
+      collisionHashes.push_back(eventmixing::getMixingBin(CastCfgVtxBins, CastCfgMultBins, col.posZ(), col.multV0M()));
+      hashes(collisionHashes.back());
+    }
+
+    /// the collisions are sorted by hash with a counting sort, such that the mixing partners of a collision are a contiguous range of the sorted index
+    /// the hashes of the collisions outside of the bins (-1) are not indexed
+    bucketCounts.assign(CastCfgVtxBins.size() + CastCfgMultBins.size() * (CastCfgVtxBins.size() + 1), 0);
+    for (auto const& hash : collisionHashes) {
+      if (hash >= 0) {
+        bucketCounts[hash]++;
+      }
+    }
+    int firstSorted = 0;
+    for (size_t hash = 0; hash < bucketCounts.size(); hash++) {
+      if (bucketCounts[hash] > 0) {
+        hashBuckets(hash, firstSorted, bucketCounts[hash]);
+      }
+      const int count = bucketCounts[hash];
+      bucketCounts[hash] = firstSorted;
+      firstSorted += count;
+    }
+    sortedCollisions.resize(firstSorted);
+    for (size_t iCol = 0; iCol < collisionHashes.size(); iCol++) {
+      if (collisionHashes[iCol] >= 0) {
+        sortedCollisions[bucketCounts[collisionHashes[iCol]]++] = iCol;
+      }
+    }
+    for (auto const& iCol : sortedCollisions) {
+      hashSorted(collisionHashes[iCol], iCol + cols.offset());
+    }
   }
 };
 
@@ -464,21 +464,37 @@ struct femtoDreamPairTaskTrackTrack {
   }
   PROCESS_SWITCH(femtoDreamPairTaskTrackTrack, processSameEvent, "Enable processing same event", true);
 
-  void processSameEventMasked(FilteredMaskedCollision& col, o2::aod::FDParticles& parts)
+  /// loops only over the collisions whose bitmasks mark them as relevant for this task, selected once per data frame on the mask columns
+  /// @param requireBoth: for different species, require both particles in the collision instead of at least one of them
+  template <bool isMC, typename CollisionType, typename PartType, typename PartitionType>
+  void doSameEvent_Masked(CollisionType& cols, PartType& parts, PartitionType& part1, PartitionType& part2, bool requireBoth)
   {
-    if (Option.SameSpecies.value) {
-      if ((col.bitmaskTrackOne() & BitMask) != BitMask) {
-        return;
+    auto SameEventMasked = [&part1, &part2, &parts, this](auto& partition) {
+      for (auto const& col : *partition.mFiltered) {
+        fillCollision<isMC>(col);
+        auto SliceTrk1 = part1->sliceByCached(aod::femtodreamparticle::fdCollisionId, col.globalIndex(), cache);
+        auto SliceTrk2 = part2->sliceByCached(aod::femtodreamparticle::fdCollisionId, col.globalIndex(), cache);
+        doSameEvent<isMC>(SliceTrk1, SliceTrk2, parts, col);
       }
+    };
+    if (Option.SameSpecies.value) {
+      Partition<CollisionType> PartitionMaskedCol = ncheckbit(aod::femtodreamcollision::bitmaskTrackOne, BitMask);
+      PartitionMaskedCol.bindTable(cols);
+      SameEventMasked(PartitionMaskedCol);
+    } else if (requireBoth) {
+      Partition<CollisionType> PartitionMaskedCol = ncheckbit(aod::femtodreamcollision::bitmaskTrackOne, BitMask) && ncheckbit(aod::femtodreamcollision::bitmaskTrackTwo, BitMask);
+      PartitionMaskedCol.bindTable(cols);
+      SameEventMasked(PartitionMaskedCol);
     } else {
-      if ((col.bitmaskTrackOne() & BitMask) != BitMask || (col.bitmaskTrackTwo() & BitMask) != BitMask) {
-        return;
-      }
+      Partition<CollisionType> PartitionMaskedCol = ncheckbit(aod::femtodreamcollision::bitmaskTrackOne, BitMask) || ncheckbit(aod::femtodreamcollision::bitmaskTrackTwo, BitMask);
+      PartitionMaskedCol.bindTable(cols);
+      SameEventMasked(PartitionMaskedCol);
     }
-    fillCollision<false>(col);
-    auto SliceTrk1 = PartitionTrk1->sliceByCached(aod::femtodreamparticle::fdCollisionId, col.globalIndex(), cache);
-    auto SliceTrk2 = PartitionTrk2->sliceByCached(aod::femtodreamparticle::fdCollisionId, col.globalIndex(), cache);
-    doSameEvent<false>(SliceTrk1, SliceTrk2, parts, col);
+  }
+
+  void processSameEventMasked(FilteredMaskedCollisions& cols, o2::aod::FDParticles& parts)
+  {
+    doSameEvent_Masked<false>(cols, parts, PartitionTrk1, PartitionTrk2, true);
   }
   PROCESS_SWITCH(femtoDreamPairTaskTrackTrack, processSameEventMasked, "Enable processing same event with masks", false);
 
@@ -501,22 +517,10 @@ struct femtoDreamPairTaskTrackTrack {
   }
   PROCESS_SWITCH(femtoDreamPairTaskTrackTrack, processSameEventMC, "Enable processing same event for Monte Carlo", false);
 
-  void processSameEventMCMasked(FilteredMaskedMCCollision& col, o2::aod::FDMCCollisions&, soa::Join<o2::aod::FDParticles, o2::aod::FDMCLabels>& parts,
+  void processSameEventMCMasked(FilteredMaskedMCCollisions& cols, o2::aod::FDMCCollisions&, soa::Join<o2::aod::FDParticles, o2::aod::FDMCLabels>& parts,
                                 o2::aod::FDMCParticles&)
   {
-    if (Option.SameSpecies.value) {
-      if ((col.bitmaskTrackOne() & BitMask) != BitMask) {
-        return;
-      }
-    } else {
-      if ((col.bitmaskTrackOne() & BitMask) != BitMask && (col.bitmaskTrackTwo() & BitMask) != BitMask) {
-        return;
-      }
-    }
-    fillCollision<true>(col);
-    auto SliceMCTrk1 = PartitionMCTrk1->sliceByCached(aod::femtodreamparticle::fdCollisionId, col.globalIndex(), cache);
-    auto SliceMCTrk2 = PartitionMCTrk2->sliceByCached(aod::femtodreamparticle::fdCollisionId, col.globalIndex(), cache);
-    doSameEvent<true>(SliceMCTrk1, SliceMCTrk2, parts, col);
+    doSameEvent_Masked<true>(cols, parts, PartitionMCTrk1, PartitionMCTrk2, false);
   }
   PROCESS_SWITCH(femtoDreamPairTaskTrackTrack, processSameEventMCMasked, "Enable processing same event for Monte Carlo with masked collisions", false);
 
@@ -119,10 +119,12 @@ struct femtoDreamTripletTaskTrackTrackTrack {
   Configurable<float> ConfCPRdeltaPhiMax{"ConfCPRdeltaPhiMax", 0.01, "Max. Delta Phi for Close Pair Rejection"};
   Configurable<float> ConfCPRdeltaEtaMax{"ConfCPRdeltaEtaMax", 0.01, "Max. Delta Eta for Close Pair Rejection"};
   Configurable<float> ConfMaxQ3IncludedInCPRPlots{"ConfMaxQ3IncludedInCPRPlots", 8., "Maximum Q3, for which the pair CPR is included in plots"};
+  Configurable<float> ConfQ3Max{"ConfQ3Max", -1., "Maximum Q3 of the triplets, the triplets above are pruned with the pair terms of Q3 before Q3 and the close pair rejection are computed. Deactivate with negative value"};
   ConfigurableAxis ConfDummy{"ConfDummy", {1, 0, 1}, "Dummy axis"};
 
   FemtoDreamContainerThreeBody<femtoDreamContainerThreeBody::EventType::same, femtoDreamContainerThreeBody::Observable::Q3> sameEventCont;
   FemtoDreamContainerThreeBody<femtoDreamContainerThreeBody::EventType::mixed, femtoDreamContainerThreeBody::Observable::Q3> mixedEventCont;
+  FemtoDreamQ3PairTerms q3Terms12, q3Terms13, q3Terms23;
   FemtoDreamPairCleaner<aod::femtodreamparticle::ParticleType::kTrack, aod::femtodreamparticle::ParticleType::kTrack> pairCleaner;
   FemtoDreamDetaDphiStar<aod::femtodreamparticle::ParticleType::kTrack, aod::femtodreamparticle::ParticleType::kTrack> pairCloseRejectionSE;
   FemtoDreamDetaDphiStar<aod::femtodreamparticle::ParticleType::kTrack, aod::femtodreamparticle::ParticleType::kTrack> pairCloseRejectionME;
@@ -231,30 +233,30 @@ struct femtoDreamTripletTaskTrackTrackTrack {
 
     /// Now build the combinations
     int numberOfTriplets = 0;
-    for (auto& [p1, p2, p3] : combinations(CombinationsStrictlyUpperIndexPolicy(groupSelectedParts, groupSelectedParts, groupSelectedParts))) {
+    auto fillTriplet = [&](auto& p1, auto& p2, auto& p3) {
       auto Q3 = FemtoDreamMath::getQ3(p1, mMassOne, p2, mMassTwo, p3, mMassThree);
 
       if (ConfIsCPR.value) {
         if (pairCloseRejectionSE.isClosePair(p1, p2, parts, magFieldTesla, Q3)) {
-          continue;
+          return;
         }
         if (pairCloseRejectionSE.isClosePair(p2, p3, parts, magFieldTesla, Q3)) {
-          continue;
+          return;
         }
         if (pairCloseRejectionSE.isClosePair(p1, p3, parts, magFieldTesla, Q3)) {
-          continue;
+          return;
         }
       }
 
       // track cleaning
       if (!pairCleaner.isCleanPair(p1, p2, parts)) {
-        continue;
+        return;
       }
       if (!pairCleaner.isCleanPair(p2, p3, parts)) {
-        continue;
+        return;
       }
       if (!pairCleaner.isCleanPair(p1, p3, parts)) {
-        continue;
+        return;
       }
 
       // fill pT of all three particles as a function of Q3 for lambda calculations
@@ -264,6 +266,32 @@ struct femtoDreamTripletTaskTrackTrackTrack {
       ThreeBodyQARegistry.fill(HIST("TripletTaskQA/particle_pT_in_Triplet_SE"), p1.pt(), p2.pt(), p3.pt(), Q3);
       sameEventCont.setTriplet<isMC>(p1, p2, p3, multCol, Q3);
       ThreeBodyQARegistry.fill(HIST("TripletTaskQA/hCentrality"), centCol, Q3);
+    };
+    if (ConfQ3Max.value < 0.f) {
+      for (auto& [p1, p2, p3] : combinations(CombinationsStrictlyUpperIndexPolicy(groupSelectedParts, groupSelectedParts, groupSelectedParts))) {
+        fillTriplet(p1, p2, p3);
+      }
+    } else {
+      // same triplets and order as the strictly upper combinations, but a pair above the maximum Q3 skips all the triplets built on top of it
+      std::vector<typename PartitionType::iterator> selectedParts;
+      for (auto& part : groupSelectedParts) {
+        selectedParts.push_back(part);
+      }
+      q3Terms12.fill(groupSelectedParts, mMassOne, groupSelectedParts, mMassTwo);
+      const float maxQ3Squared = ConfQ3Max.value * ConfQ3Max.value;
+      for (size_t i = 0; i < selectedParts.size(); i++) {
+        for (size_t j = i + 1; j < selectedParts.size(); j++) {
+          if (q3Terms12.get(i, j) > maxQ3Squared) {
+            continue;
+          }
+          for (size_t k = j + 1; k < selectedParts.size(); k++) {
+            if (q3Terms12.get(i, j) + q3Terms12.get(j, k) + q3Terms12.get(i, k) > maxQ3Squared) {
+              continue;
+            }
+            fillTriplet(selectedParts[i], selectedParts[j], selectedParts[k]);
+          }
+        }
+      }
     }
     ThreeBodyQARegistry.fill(HIST("TripletTaskQA/hTripletsPerEventBelow14"), numberOfTriplets);
   }
@@ -359,24 +387,56 @@ struct femtoDreamTripletTaskTrackTrackTrack {
   template <bool isMC, typename PartitionType, typename PartType>
   void doMixedEvent(PartitionType groupPartsOne, PartitionType groupPartsTwo, PartitionType groupPartsThree, PartType parts, float magFieldTesla, int multCol)
   {
-    for (auto& [p1, p2, p3] : combinations(CombinationsFullIndexPolicy(groupPartsOne, groupPartsTwo, groupPartsThree))) {
-
+    auto fillTriplet = [&](auto& p1, auto& p2, auto& p3) {
       auto Q3 = FemtoDreamMath::getQ3(p1, mMassOne, p2, mMassTwo, p3, mMassThree);
       if (ConfIsCPR.value) {
         if (pairCloseRejectionME.isClosePair(p1, p2, parts, magFieldTesla, Q3)) {
-          continue;
+          return;
         }
         if (pairCloseRejectionME.isClosePair(p2, p3, parts, magFieldTesla, Q3)) {
-          continue;
+          return;
         }
 
         if (pairCloseRejectionME.isClosePair(p1, p3, parts, magFieldTesla, Q3)) {
-          continue;
+          return;
         }
       }
       // fill pT of all three particles as a function of Q3 for lambda calculations
       ThreeBodyQARegistry.fill(HIST("TripletTaskQA/particle_pT_in_Triplet_ME"), p1.pt(), p2.pt(), p3.pt(), Q3);
       mixedEventCont.setTriplet<isMC>(p1, p2, p3, multCol, Q3);
+    };
+    if (ConfQ3Max.value < 0.f) {
+      for (auto& [p1, p2, p3] : combinations(CombinationsFullIndexPolicy(groupPartsOne, groupPartsTwo, groupPartsThree))) {
+        fillTriplet(p1, p2, p3);
+      }
+    } else {
+      std::vector<typename PartitionType::iterator> partsOne, partsTwo, partsThree;
+      for (auto& part : groupPartsOne) {
+        partsOne.push_back(part);
+      }
+      for (auto& part : groupPartsTwo) {
+        partsTwo.push_back(part);
+      }
+      for (auto& part : groupPartsThree) {
+        partsThree.push_back(part);
+      }
+      q3Terms12.fill(groupPartsOne, mMassOne, groupPartsTwo, mMassTwo);
+      q3Terms13.fill(groupPartsOne, mMassOne, groupPartsThree, mMassThree);
+      q3Terms23.fill(groupPartsTwo, mMassTwo, groupPartsThree, mMassThree);
+      const float maxQ3Squared = ConfQ3Max.value * ConfQ3Max.value;
+      for (size_t i = 0; i < partsOne.size(); i++) {
+        for (size_t j = 0; j < partsTwo.size(); j++) {
+          if (q3Terms12.get(i, j) > maxQ3Squared) {
+            continue;
+          }
+          for (size_t k = 0; k < partsThree.size(); k++) {
+            if (q3Terms12.get(i, j) + q3Terms23.get(j, k) + q3Terms13.get(i, k) > maxQ3Squared) {
+              continue;
+            }
+            fillTriplet(partsOne[i], partsTwo[j], partsThree[k]);
+          }
+        }
+      }
     }
   }
 
@@ -24,10 +24,15 @@
 #include <Framework/Logger.h>
 
 #include "Math/Vector4D.h"
+#include "TAxis.h"
 #include "TDatabasePDG.h"
 #include "TMath.h"
 
+#include <array>
+#include <cmath>
 #include <complex>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -128,6 +133,14 @@ class FemtoUniverseSHContainer
 
     fbinctn = new TH1D(TString("BinCountNum"), "Bin Occupation (Numerator)", static_cast<int>(kStarBins[0]), kStarBins[1], kStarBins[2]);
     fbinctd = new TH1D(TString("BinCountDen"), "Bin Occupation (Denominator)", static_cast<int>(kStarBins[0]), kStarBins[1], kStarBins[2]);
+
+    // Flat accumulators of the Ylm components, including the under- and overflow bins, exported to the histograms by packCov()
+    const std::shared_ptr<TH1>& ylmHist = (kFolderSuffix[kEventType] == kFolderSuffix[0]) ? fnumsreal[0] : fdensreal[0];
+    fYlmAxis = ylmHist->GetXaxis();
+    const std::size_t nYlmBins = static_cast<std::size_t>(fYlmAxis->GetNbins() + 2);
+    fYlmSums.assign(nYlmBins * kMaxJM * 2, 0.);
+    fYlmSums2.assign(nYlmBins * kMaxJM * 2, 0.);
+    fYlmPairs.assign(nYlmBins, 0);
   }
 
   /// Set the PDG codes of the two particles involved
@@ -161,7 +174,6 @@ class FemtoUniverseSHContainer
   template <bool isMC, typename T>
   void addEventPair(T const& part1, T const& part2, uint8_t ChosenEventType, int /*maxl*/, bool isiden)
   {
-    std::vector<std::complex<double>> fYlmBuffer(kMaxJM);
     std::vector<double> f3d;
     f3d = FemtoUniverseMath::newpairfunc(part1, kMassOne, part2, kMassTwo, isiden);
 
@@ -172,40 +184,67 @@ class FemtoUniverseSHContainer
 
     int nqbin = fbinctn->GetXaxis()->FindFixBin(kv) - 1;
 
-    FemtoUniverseSpherHarMath kYlm;
-    kYlm.doYlmUpToL(kMaxL, qout, qside, qlong, fYlmBuffer.data());
+    fYlmMath.doYlmUpToL(kMaxL, qout, qside, qlong, fYlmBuffer.data());
 
-    if (ChosenEventType == femto_universe_sh_container::EventType::same) {
-      for (int ihist = 0; ihist < kMaxJM; ihist++) {
-        fnumsreal[ihist]->Fill(kv, real(fYlmBuffer[ihist]));
-        fnumsimag[ihist]->Fill(kv, -imag(fYlmBuffer[ihist]));
-        fbinctn->Fill(kv, 1.0);
-      }
+    // Real and imaginary components of the pair, in the order of the covariance matrix
+    for (int ilm = 0; ilm < kMaxJM; ilm++) {
+      fYlmComponents[ilm * 2] = real(fYlmBuffer[ilm]);
+      fYlmComponents[ilm * 2 + 1] = -imag(fYlmBuffer[ilm]);
+    }
 
-      if (nqbin < fbinctn->GetNbinsX()) {
-        for (int ilmzero = 0; ilmzero < kMaxJM; ilmzero++) {
-          for (int ilmprim = 0; ilmprim < kMaxJM; ilmprim++) {
-            fcovmnum[getBin(nqbin, ilmzero, 0, ilmprim, 0)] += (real(fYlmBuffer[ilmzero]) * real(fYlmBuffer[ilmprim]));
-            fcovmnum[getBin(nqbin, ilmzero, 0, ilmprim, 1)] += (real(fYlmBuffer[ilmzero]) * -imag(fYlmBuffer[ilmprim]));
-            fcovmnum[getBin(nqbin, ilmzero, 1, ilmprim, 0)] += (-imag(fYlmBuffer[ilmzero]) * real(fYlmBuffer[ilmprim]));
-            fcovmnum[getBin(nqbin, ilmzero, 1, ilmprim, 1)] += (-imag(fYlmBuffer[ilmzero]) * -imag(fYlmBuffer[ilmprim]));
-          }
+    const std::size_t ylmBin = static_cast<std::size_t>(fYlmAxis->FindFixBin(kv));
+    double* sums = &fYlmSums[ylmBin * kMaxJM * 2];
+    double* sums2 = &fYlmSums2[ylmBin * kMaxJM * 2];
+    for (int icomp = 0; icomp < kMaxJM * 2; icomp++) {
+      sums[icomp] += fYlmComponents[icomp];
+      sums2[icomp] += fYlmComponents[icomp] * fYlmComponents[icomp];
+    }
+    fYlmPairs[ylmBin]++;
+
+    if (nqbin >= 0 && nqbin < fbinctn->GetNbinsX()) {
+      // Rank-1 update of the covariance matrix of the q bin: cov[p][z] += c[z] * c[p], contiguous in z
+      auto& fcovm = (ChosenEventType == femto_universe_sh_container::EventType::same) ? fcovmnum : fcovmden;
+      float* cov = &fcovm[getBin(nqbin, 0, 0, 0, 0)];
+      for (int ilmprim = 0; ilmprim < kMaxJM * 2; ilmprim++) {
+        const double cprim = fYlmComponents[ilmprim];
+        float* covRow = cov + ilmprim * kMaxJM * 2;
+        for (int ilmzero = 0; ilmzero < kMaxJM * 2; ilmzero++) {
+          covRow[ilmzero] += fYlmComponents[ilmzero] * cprim;
         }
       }
-    } else if (ChosenEventType == femto_universe_sh_container::EventType::mixed) {
-      for (int ihist = 0; ihist < kMaxJM; ihist++) {
-        fdensreal[ihist]->Fill(kv, real(fYlmBuffer[ihist]));
-        fdensimag[ihist]->Fill(kv, -imag(fYlmBuffer[ihist]));
-      }
-      if (nqbin < fbinctn->GetNbinsX()) {
-        for (int ilmzero = 0; ilmzero < kMaxJM; ilmzero++) {
-          for (int ilmprim = 0; ilmprim < kMaxJM; ilmprim++) {
-            fcovmden[getBin(nqbin, ilmzero, 0, ilmprim, 0)] += (real(fYlmBuffer[ilmzero]) * real(fYlmBuffer[ilmprim]));
-            fcovmden[getBin(nqbin, ilmzero, 0, ilmprim, 1)] += (real(fYlmBuffer[ilmzero]) * -imag(fYlmBuffer[ilmprim]));
-            fcovmden[getBin(nqbin, ilmzero, 1, ilmprim, 0)] += (-imag(fYlmBuffer[ilmzero]) * real(fYlmBuffer[ilmprim]));
-            fcovmden[getBin(nqbin, ilmzero, 1, ilmprim, 1)] += (-imag(fYlmBuffer[ilmzero]) * -imag(fYlmBuffer[ilmprim]));
+    }
+  }
+
+  /// Function to export the accumulated Ylm components to the numerator or denominator histograms
+  /// \param ChosenEventType same or mixed event
+  void packYlms(uint8_t ChosenEventType)
+  {
+    const bool isSame = (ChosenEventType == femto_universe_sh_container::EventType::same);
+    auto& hreal = isSame ? fnumsreal : fdensreal;
+    auto& himag = isSame ? fnumsimag : fdensimag;
+    const int nYlmBins = static_cast<int>(fYlmPairs.size());
+    double nPairs = 0.;
+    for (int ibin = 0; ibin < nYlmBins; ibin++) {
+      nPairs += fYlmPairs[ibin];
+    }
+    for (int ihist = 0; ihist < kMaxJM; ihist++) {
+      for (int reim = 0; reim < 2; reim++) {
+        const std::shared_ptr<TH1>& hist = reim ? himag[ihist] : hreal[ihist];
+        for (int ibin = 0; ibin < nYlmBins; ibin++) {
+          const std::size_t icomp = (static_cast<std::size_t>(ibin) * kMaxJM + ihist) * 2 + reim;
+          hist->SetBinContent(ibin, fYlmSums[icomp]);
+          if (hist->GetSumw2N() > 0) {
+            hist->SetBinError(ibin, std::sqrt(fYlmSums2[icomp]));
           }
         }
+        hist->ResetStats();
+        hist->SetEntries(nPairs);
+      }
+    }
+    if (isSame) {
+      // the bin occupation counts each pair once per Ylm component
+      for (int ibin = 0; ibin < nYlmBins && ibin <= fbinctn->GetNbinsX() + 1; ibin++) {
+        fbinctn->SetBinContent(ibin, static_cast<double>(fYlmPairs[ibin]) * kMaxJM);
       }
     }
   }
@@ -215,6 +254,7 @@ class FemtoUniverseSHContainer
   /// \param MaxJM Maximum value of J
   void packCov(uint8_t ChosenEventType, int /*MaxJM*/)
   {
+    packYlms(ChosenEventType);
     if (ChosenEventType == femto_universe_sh_container::EventType::same) {
       for (int ibin = 1; ibin <= fcovnum->GetNbinsX(); ibin++) {
         for (int ilmz = 0; ilmz < kMaxJM * 2; ilmz++) {
@@ -256,6 +296,14 @@ class FemtoUniverseSHContainer
   std::array<float, (kMaxJM * kMaxJM * 4 * 100)> fcovmnum{}; ///< Covariance matrix for the numerator
   std::array<float, (kMaxJM * kMaxJM * 4 * 100)> fcovmden{}; ///< Covariance matrix for the numerator
 
+  FemtoUniverseSpherHarMath fYlmMath;                    ///< Ylm kernel, with the prefactors computed once
+  std::array<std::complex<double>, kMaxJM> fYlmBuffer{}; ///< Ylms of the current pair
+  std::array<double, kMaxJM * 2> fYlmComponents{};       ///< Real and -imaginary parts of the Ylms of the current pair
+  TAxis* fYlmAxis = nullptr;                             ///< q axis of the Ylm histograms
+  std::vector<double> fYlmSums;                          ///< Sum of the Ylm components per q bin, [bin][ilm][re/im]
+  std::vector<double> fYlmSums2;                         ///< Sum of the squared Ylm components per q bin
+  std::vector<int64_t> fYlmPairs;                        ///< Number of pairs per q bin
+
  protected:
   HistogramRegistry* kHistogramRegistry = nullptr;                                  ///< For QA output
   static constexpr std::string_view kFolderSuffix[2] = {"SameEvent", "MixedEvent"}; ///< Folder naming for the output according to kEventType
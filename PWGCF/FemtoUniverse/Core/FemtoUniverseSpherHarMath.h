@@ -33,6 +33,8 @@ namespace o2::analysis::femto_universe
 class FemtoUniverseSpherHarMath
 {
  public:
+  FemtoUniverseSpherHarMath() { initializeYlms(); }
+
   /// Values of various coefficients
   void initializeYlms()
   {
@@ -165,36 +167,49 @@ class FemtoUniverseSpherHarMath
   }
 
   /// Function to calculate a set of Ylms up to a given l with cartesian input
+  /// The azimuthal phase is taken from (x, y) directly and its powers are built by recursion, without atan2 and trigonometric calls
   void doYlmUpToL(int lmax, double x, double y, double z, std::complex<double>* ylms)
   {
-    double ctheta, phi;
+    double ctheta;
 
     double r = std::sqrt(x * x + y * y + z * z);
     if (r < 1e-10 || std::fabs(z) < 1e-10)
       ctheta = 0.0;
     else
       ctheta = z / r;
-    phi = std::atan2(y, x);
-    doYlmUpToL(lmax, ctheta, phi, ylms);
+    double rxy = std::sqrt(x * x + y * y);
+    std::complex<double> eiphi = (rxy > 0.) ? std::complex<double>(x / rxy, y / rxy) : std::complex<double>(1.0, 0.0); // atan2(0, 0) = 0
+    double coss[6];
+    double sins[6];
+    std::complex<double> eimphi = eiphi;
+    for (int iter = 1; iter <= lmax; iter++) {
+      coss[iter - 1] = eimphi.real();
+      sins[iter - 1] = eimphi.imag();
+      eimphi *= eiphi;
+    }
+    doYlmUpToL(lmax, ctheta, coss, sins, ylms);
   }
 
   /// Function to calculate a set of Ylms up to a given l with spherical input
   void doYlmUpToL(int lmax, double ctheta, double phi, std::complex<double>* ylms)
   {
-    int lcur = 0;
-    double lpol;
-
     double coss[6];
     double sins[6];
-
-    double lbuf[36];
-    legendreUpToYlm(lmax, ctheta, lbuf);
-    initializeYlms();
-
     for (int iter = 1; iter <= lmax; iter++) {
       coss[iter - 1] = std::cos(iter * phi);
       sins[iter - 1] = std::sin(iter * phi);
     }
+    doYlmUpToL(lmax, ctheta, coss, sins, ylms);
+  }
+
+  /// Function to calculate a set of Ylms up to a given l from cos(theta) and the cos(m phi), sin(m phi) of m = 1..lmax
+  void doYlmUpToL(int lmax, double ctheta, const double* coss, const double* sins, std::complex<double>* ylms)
+  {
+    int lcur = 0;
+    double lpol;
+
+    double lbuf[36];
+    legendreUpToYlm(lmax, ctheta, lbuf);
 
     ylms[lcur++] = fgPrefactors[0] * lbuf[0] * std::complex<double>(1, 0);
 
@@ -234,7 +234,7 @@ struct FlowPtEfficiency {
       }
     }
     if (cfgCutDCAxyppPass3Enabled) {
-      myTrackSel.SetMaxDcaXYPtDep([](float pt) { return 0.004f + 0.013f / pt; });
+      myTrackSel.SetMaxDcaXYPtDep(0.004f, 0.013f, 1.f);
     } else {
       if (cfgCutDCAxy != 0.0) {
         myTrackSel.SetMaxDcaXY(cfgCutDCAxy);
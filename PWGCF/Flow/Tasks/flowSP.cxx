@@ -228,6 +228,17 @@ struct FlowSP {
     double psiA = 0;
     double psiC = 0;
     double psiFull = 0;
+    // cos(n psi) and sin(n psi), evaluated once per event such that cos(n (phi - psi)) follows per track from the angle-addition identity
+    double cosPsiA = 1;
+    double sinPsiA = 0;
+    double cosPsiC = 1;
+    double sinPsiC = 0;
+    double cosPsiFull = 1;
+    double sinPsiFull = 0;
+    // sqrt(|<QQ>|) normalisations, evaluated once per event
+    double sqrtCorrQQ = 1;
+    double sqrtCorrQQx = 1;
+    double sqrtCorrQQy = 1;
     double trackPxA = 0;
     double trackPxC = 0;
   } spm;
@@ -1050,8 +1061,8 @@ struct FlowSP {
     double weight = spm.wacc[ct][pt] * spm.weff[ct][pt] * spm.centWeight;
 
     if (cfgFillGeneralV1Histos) {
-      registry.fill(HIST(Charge[ct]) + HIST(Species[pt]) + HIST("vnA"), track.pt(), track.eta(), spm.centrality, (spm.uy * spm.qyA + spm.ux * spm.qxA) / std::sqrt(std::fabs(spm.corrQQ)), weight);
-      registry.fill(HIST(Charge[ct]) + HIST(Species[pt]) + HIST("vnC"), track.pt(), track.eta(), spm.centrality, (spm.uy * spm.qyC + spm.ux * spm.qxC) / std::sqrt(std::fabs(spm.corrQQ)), weight);
+      registry.fill(HIST(Charge[ct]) + HIST(Species[pt]) + HIST("vnA"), track.pt(), track.eta(), spm.centrality, (spm.uy * spm.qyA + spm.ux * spm.qxA) / spm.sqrtCorrQQ, weight);
+      registry.fill(HIST(Charge[ct]) + HIST(Species[pt]) + HIST("vnC"), track.pt(), track.eta(), spm.centrality, (spm.uy * spm.qyC + spm.ux * spm.qxC) / spm.sqrtCorrQQ, weight);
     }
 
     if (cfgFillMixedHarmonics) {
@@ -1062,10 +1073,10 @@ struct FlowSP {
     }
 
     if (cfgFillXandYterms) {
-      registry.fill(HIST(Charge[ct]) + HIST(Species[pt]) + HIST("vnAx"), track.pt(), track.eta(), spm.centrality, (spm.ux * spm.qxA) / std::sqrt(std::fabs(spm.corrQQx)), weight);
-      registry.fill(HIST(Charge[ct]) + HIST(Species[pt]) + HIST("vnAy"), track.pt(), track.eta(), spm.centrality, (spm.uy * spm.qyA) / std::sqrt(std::fabs(spm.corrQQy)), weight);
-      registry.fill(HIST(Charge[ct]) + HIST(Species[pt]) + HIST("vnCx"), track.pt(), track.eta(), spm.centrality, (spm.ux * spm.qxC) / std::sqrt(std::fabs(spm.corrQQx)), weight);
-      registry.fill(HIST(Charge[ct]) + HIST(Species[pt]) + HIST("vnCy"), track.pt(), track.eta(), spm.centrality, (spm.uy * spm.qyC) / std::sqrt(std::fabs(spm.corrQQy)), weight);
+      registry.fill(HIST(Charge[ct]) + HIST(Species[pt]) + HIST("vnAx"), track.pt(), track.eta(), spm.centrality, (spm.ux * spm.qxA) / spm.sqrtCorrQQx, weight);
+      registry.fill(HIST(Charge[ct]) + HIST(Species[pt]) + HIST("vnAy"), track.pt(), track.eta(), spm.centrality, (spm.uy * spm.qyA) / spm.sqrtCorrQQy, weight);
+      registry.fill(HIST(Charge[ct]) + HIST(Species[pt]) + HIST("vnCx"), track.pt(), track.eta(), spm.centrality, (spm.ux * spm.qxC) / spm.sqrtCorrQQx, weight);
+      registry.fill(HIST(Charge[ct]) + HIST(Species[pt]) + HIST("vnCy"), track.pt(), track.eta(), spm.centrality, (spm.uy * spm.qyC) / spm.sqrtCorrQQy, weight);
     }
 
     if (cfgFillEventPlane) { // only fill for inclusive!
@@ -1077,8 +1088,8 @@ struct FlowSP {
     if (cfgFillMeanPT) {
       registry.fill(HIST(Charge[ct]) + HIST(Species[pt]) + HIST("meanPT/hMeanPtEtaCent"), track.eta(), spm.centrality, track.pt(), weight);
       registry.fill(HIST(Charge[ct]) + HIST(Species[pt]) + HIST("meanPT/hMeanPtCent"), spm.centrality, track.pt(), weight);
-      registry.fill(HIST(Charge[ct]) + HIST(Species[pt]) + HIST("meanPT/ptV1A"), track.eta(), spm.centrality, track.pt() * ((spm.uy * spm.qyA + spm.ux * spm.qxA) / (std::sqrt(std::fabs(spm.corrQQ)) * spm.meanPtWeight)), weight);
-      registry.fill(HIST(Charge[ct]) + HIST(Species[pt]) + HIST("meanPT/ptV1C"), track.eta(), spm.centrality, track.pt() * ((spm.uy * spm.qyC + spm.ux * spm.qxC) / (std::sqrt(std::fabs(spm.corrQQ)) * spm.meanPtWeight)), weight);
+      registry.fill(HIST(Charge[ct]) + HIST(Species[pt]) + HIST("meanPT/ptV1A"), track.eta(), spm.centrality, track.pt() * ((spm.uy * spm.qyA + spm.ux * spm.qxA) / (spm.sqrtCorrQQ * spm.meanPtWeight)), weight);
+      registry.fill(HIST(Charge[ct]) + HIST(Species[pt]) + HIST("meanPT/ptV1C"), track.eta(), spm.centrality, track.pt() * ((spm.uy * spm.qyC + spm.ux * spm.qxC) / (spm.sqrtCorrQQ * spm.meanPtWeight)), weight);
     }
   }
 
@@ -1253,6 +1264,13 @@ struct FlowSP {
     // https://twiki.cern.ch/twiki/pub/ALICE/DirectedFlowAnalysisNote/vn_ZDC_ALICE_INT_NOTE_version02.pdf
     spm.psiFull = 1.0 * std::atan2(spm.qyA + spm.qyC, spm.qxA + spm.qxC);
 
+    spm.cosPsiA = std::cos(cfgHarm * spm.psiA);
+    spm.sinPsiA = std::sin(cfgHarm * spm.psiA);
+    spm.cosPsiC = std::cos(cfgHarm * spm.psiC);
+    spm.sinPsiC = std::sin(cfgHarm * spm.psiC);
+    spm.cosPsiFull = std::cos(cfgHarm * spm.psiFull);
+    spm.sinPsiFull = std::sin(cfgHarm * spm.psiFull);
+
     // always fill these histograms!
     registry.fill(HIST("QQCorrelations/qAqCXY"), spm.centrality, spm.qxA * spm.qxC + spm.qyA * spm.qyC);
     registry.fill(HIST("QQCorrelations/qAXqCY"), spm.centrality, spm.qxA * spm.qyC);
@@ -1296,6 +1314,9 @@ struct FlowSP {
       spm.corrQQx = cfg.hcorrQQx->GetBinContent(cfg.hcorrQQx->FindBin(spm.centrality));
       spm.corrQQy = cfg.hcorrQQy->GetBinContent(cfg.hcorrQQy->FindBin(spm.centrality));
     }
+    spm.sqrtCorrQQ = std::sqrt(std::fabs(spm.corrQQ));
+    spm.sqrtCorrQQx = std::sqrt(std::fabs(spm.corrQQx));
+    spm.sqrtCorrQQy = std::sqrt(std::fabs(spm.corrQQy));
 
     double evPlaneRes = 1.;
     if (cfgCCDBdir_SP.value.empty() == false) {
@@ -1443,9 +1464,10 @@ struct FlowSP {
       spm.uyMH = std::sin(cfgHarmMixed * phi);
       // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
-      spm.vnA = std::cos(cfgHarm * (phi - spm.psiA)) / evPlaneRes;
-      spm.vnC = std::cos(cfgHarm * (phi - spm.psiC)) / evPlaneRes;
-      spm.vnFull = std::cos(cfgHarm * (phi - spm.psiFull)) / evPlaneRes;
+      // cos(n (phi - psi)) = cos(n phi) cos(n psi) + sin(n phi) sin(n psi)
+      spm.vnA = (spm.ux * spm.cosPsiA + spm.uy * spm.sinPsiA) / evPlaneRes;
+      spm.vnC = (spm.ux * spm.cosPsiC + spm.uy * spm.sinPsiC) / evPlaneRes;
+      spm.vnFull = (spm.ux * spm.cosPsiFull + spm.uy * spm.sinPsiFull) / evPlaneRes;
 
       // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
@@ -1514,8 +1536,8 @@ struct FlowSP {
         }
       } // end of fillPID
 
-      double drelPxA = track.pt() * ((spm.uy * spm.qyA + spm.ux * spm.qxA) / std::sqrt(std::fabs(spm.corrQQ)));
-      double drelPxC = track.pt() * ((spm.uy * spm.qyC + spm.ux * spm.qxC) / std::sqrt(std::fabs(spm.corrQQ)));
+      double drelPxA = track.pt() * ((spm.uy * spm.qyA + spm.ux * spm.qxA) / spm.sqrtCorrQQ);
+      double drelPxC = track.pt() * ((spm.uy * spm.qyC + spm.ux * spm.qxC) / spm.sqrtCorrQQ);
 
       meanPTMap->Fill(track.eta(), track.pt(), spm.wacc[kInclusive][kUnidentified] * spm.weff[kInclusive][kUnidentified] * spm.centWeight);
       relPxA->Fill(track.eta(), drelPxA, spm.wacc[kInclusive][kUnidentified] * spm.weff[kInclusive][kUnidentified] * spm.centWeight);
@@ -43,6 +43,7 @@ void BootstrapProfile::InitializeSubsamples(Int_t nSub)
   }
   if (fListOfEntries)
     delete fListOfEntries;
+  fSubProfiles.clear();
   fListOfEntries = new TList();
   fListOfEntries->SetOwner(kTRUE);
   TProfile* dummyPF = reinterpret_cast<TProfile*>(this);
@@ -52,15 +53,67 @@ void BootstrapProfile::InitializeSubsamples(Int_t nSub)
   }
   fNSubs = nSub;
 }
-void BootstrapProfile::FillProfile(const Double_t& xv, const Double_t& yv, const Double_t& w, const Double_t& rn)
+void BootstrapProfile::FillSubAtBin(Int_t bin, const Double_t& xv, const Double_t& yv, const Double_t& w, const Double_t& rn)
 {
-  TProfile::Fill(xv, yv, w);
   if (!fNSubs)
     return;
   Int_t targetInd = rn * fNSubs;
   if (targetInd >= fNSubs)
     targetInd = 0;
-  reinterpret_cast<TProfile*>(fListOfEntries->At(targetInd))->Fill(xv, yv, w);
+  if (static_cast<Int_t>(fSubProfiles.size()) != fListOfEntries->GetEntries()) {
+    fSubProfiles.clear();
+    for (TObject* obj : *fListOfEntries)
+      fSubProfiles.push_back(dynamic_cast<BootstrapProfile*>(obj)); // subprofiles are clones of this, sharing its binning
+  }
+  if (fSubProfiles[targetInd])
+    fSubProfiles[targetInd]->FillAtBin(bin, xv, yv, w);
+  else
+    reinterpret_cast<TProfile*>(fListOfEntries->At(targetInd))->Fill(xv, yv, w);
+}
+void BootstrapProfile::FillAtBin(Int_t bin, const Double_t& xv, const Double_t& yv, const Double_t& w)
+{
+  // Same as TProfile::Fill, with the bin already found. Buffered or extendable profiles, and the first non-unit weight creating the Sumw2 structure, go through TProfile::Fill
+  if (fBuffer || CanExtendAllAxes() || (!fBinSumw2.fN && w != 1.0 && !TestBit(TH1::kIsNotW))) {
+    TProfile::Fill(xv, yv, w);
+    return;
+  }
+  if (fYmin != fYmax && (yv < fYmin || yv > fYmax || TMath::IsNaN(yv)))
+    return;
+  fEntries++;
+  fArray[bin] += w * yv;
+  fSumw2.fArray[bin] += w * yv * yv;
+  if (fBinSumw2.fN)
+    fBinSumw2.fArray[bin] += w * w;
+  fBinEntries.fArray[bin] += w;
+  if ((bin == 0 || bin > fXaxis.GetNbins()) && !GetStatOverflowsBehaviour())
+    return;
+  fTsumw += w;
+  fTsumw2 += w * w;
+  fTsumwx += w * xv;
+  fTsumwx2 += w * xv * xv;
+  fTsumwy += w * yv;
+  fTsumwy2 += w * yv * yv;
+}
+void BootstrapProfile::FillProfile(const Double_t& xv, const Double_t& yv, const Double_t& w, const Double_t& rn)
+{
+  Int_t bin = fXaxis.FindBin(xv);
+  FillAtBin(bin, xv, yv, w);
+  FillSubAtBin(bin, xv, yv, w, rn);
+}
+void BootstrapProfile::FillProfiles(std::span<BootstrapProfile* const> profiles, const Double_t& xv, std::span<const Double_t> yv, std::span<const Double_t> w, const Double_t& rn)
+{
+  if (profiles.empty())
+    return;
+  // The profiles of one container share the multiplicity binning, the bin is only searched again if it differs
+  TAxis* refAxis = profiles[0]->GetXaxis();
+  Int_t refBin = refAxis->FindBin(xv);
+  for (size_t i = 0; i < profiles.size(); ++i) {
+    BootstrapProfile* prof = profiles[i];
+    TAxis* axis = prof->GetXaxis();
+    Int_t bin = (axis->GetNbins() == refAxis->GetNbins() && axis->GetXmin() == refAxis->GetXmin() && axis->GetXmax() == refAxis->GetXmax()) ? refBin : axis->FindBin(xv);
+    prof->FillAtBin(bin, xv, yv[i], w[i]);
+    prof->FillSubAtBin(bin, xv, yv[i], w[i], rn);
+  }
 }
 void BootstrapProfile::FillProfile(const Double_t& xv, const Double_t& yv, const Double_t& w)
 {
@@ -22,6 +22,9 @@
 #include "TCollection.h"
 #include "TMath.h"
 
+#include <span>
+#include <vector>
+
 class BootstrapProfile : public TProfile
 {
  public:
@@ -34,6 +37,7 @@ class BootstrapProfile : public TProfile
   void InitializeSubsamples(Int_t nSub);
   void FillProfile(const Double_t& xv, const Double_t& yv, const Double_t& w, const Double_t& rn);
   void FillProfile(const Double_t& xv, const Double_t& yv, const Double_t& w);
+  static void FillProfiles(std::span<BootstrapProfile* const> profiles, const Double_t& xv, std::span<const Double_t> yv, std::span<const Double_t> w, const Double_t& rn); // All correlators of one event, in the same subsample
   Long64_t Merge(TCollection* collist);
   void RebinMulti(Int_t nbins);
   void RebinMulti(Int_t nbins, Double_t* binedges);
@@ -56,9 +60,12 @@ class BootstrapProfile : public TProfile
   TH1* getWeightBasedRebin(Int_t ind = -1);
   Bool_t fProfInitialized;
   Int_t fNSubs;
-  Int_t fMultiRebin;                //! externaly set runtime, no need to store
-  Double_t* fMultiRebinEdges;       //! externaly set runtime, no need to store
-  BootstrapProfile* fPresetWeights; //! BootstrapProfile whose weights we should copy
+  Int_t fMultiRebin;                           //! externaly set runtime, no need to store
+  Double_t* fMultiRebinEdges;                  //! externaly set runtime, no need to store
+  BootstrapProfile* fPresetWeights;            //! BootstrapProfile whose weights we should copy
+  std::vector<BootstrapProfile*> fSubProfiles; //! subprofiles of fListOfEntries, indexed without walking the list
+  void FillAtBin(Int_t bin, const Double_t& xv, const Double_t& yv, const Double_t& w);
+  void FillSubAtBin(Int_t bin, const Double_t& xv, const Double_t& yv, const Double_t& w, const Double_t& rn);
   void ResetBin(TProfile* tpf, Int_t nbin)
   {
     tpf->SetBinEntries(nbin, 0);
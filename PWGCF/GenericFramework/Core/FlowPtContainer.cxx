@@ -44,6 +44,9 @@ FlowPtContainer::FlowPtContainer() : fCMTermList(0),
                                      cmDenSub(),
                                      arr(),
                                      warr(),
+                                     wPow(),
+                                     ptPow(),
+                                     fCovProfiles(),
                                      subevents() {}
 FlowPtContainer::~FlowPtContainer()
 {
@@ -81,6 +84,9 @@ FlowPtContainer::FlowPtContainer(const char* name) : TNamed(name, name),
                                                      cmDenSub(),
                                                      arr(),
                                                      warr(),
+                                                     wPow(),
+                                                     ptPow(),
+                                                     fCovProfiles(),
                                                      subevents() {}
 FlowPtContainer::FlowPtContainer(const char* name, const char* title) : TNamed(name, title),
                                                                         fCMTermList(0),
@@ -108,6 +114,9 @@ FlowPtContainer::FlowPtContainer(const char* name, const char* title) : TNamed(n
                                                                         cmDenSub(),
                                                                         arr(),
                                                                         warr(),
+                                                                        wPow(),
+                                                                        ptPow(),
+                                                                        fCovProfiles(),
                                                                         subevents() {}
 void FlowPtContainer::initialise(const o2::framework::AxisSpec axis, const int& m, const GFWCorrConfigs& configs, const int& nsub)
 {
@@ -134,6 +143,7 @@ void FlowPtContainer::initialise(const o2::framework::AxisSpec axis, const int&
   if (fCovList)
     delete fCovList;
   fCovList = new TList();
+  fCovProfiles.clear();
   fCovList->SetOwner(kTRUE);
   for (int m = 0; m < mpar; ++m) {
     fCorrList->Add(new BootstrapProfile(Form("mpt%i", m + 1), Form("mpt%i", m + 1), nMultiBins, &multiBins[0]));
@@ -202,7 +212,7 @@ void FlowPtContainer::initialise(const o2::framework::AxisSpec axis, const int&
     for (int i = 0; i < fCMTermList->GetEntries(); ++i)
       dynamic_cast<BootstrapProfile*>(fCMTermList->At(i))->InitializeSubsamples(nsub);
     for (int i = 0; i < fCovList->GetEntries(); ++i)
-      dynamic_cast<BootstrapProfile*>(fCovList->At(i))->InitializeSubsamples(nsub);
+      getCovProfile(i)->InitializeSubsamples(nsub);
   }
   LOGF(info, "Container %s initialized with m = %i\n and %i subsamples", this->GetName(), mpar, nsub);
   return;
@@ -224,6 +234,7 @@ void FlowPtContainer::initialise(int nbinsx, double* xbins, const int& m, const
   if (fCovList)
     delete fCovList;
   fCovList = new TList();
+  fCovProfiles.clear();
   fCovList->SetOwner(kTRUE);
   for (int m = 0; m < mpar; ++m) {
     fCorrList->Add(new BootstrapProfile(Form("mpt%i", m + 1), Form("mpt%i", m + 1), nbinsx, xbins));
@@ -291,7 +302,7 @@ void FlowPtContainer::initialise(int nbinsx, double* xbins, const int& m, const
     for (int i = 0; i < fCMTermList->GetEntries(); ++i)
       dynamic_cast<BootstrapProfile*>(fCMTermList->At(i))->InitializeSubsamples(nsub);
     for (int i = 0; i < fCovList->GetEntries(); ++i)
-      dynamic_cast<BootstrapProfile*>(fCovList->At(i))->InitializeSubsamples(nsub);
+      getCovProfile(i)->InitializeSubsamples(nsub);
   }
   LOGF(info, "Container %s initialized with m = %i\n", this->GetName(), mpar);
 };
@@ -312,6 +323,7 @@ void FlowPtContainer::initialise(int nbinsx, double xlow, double xhigh, const in
   if (fCovList)
     delete fCovList;
   fCovList = new TList();
+  fCovProfiles.clear();
   fCovList->SetOwner(kTRUE);
   for (int m = 0; m < mpar; ++m) {
     fCorrList->Add(new BootstrapProfile(Form("mpt%i", m + 1), Form("mpt%i", m + 1), nbinsx, xlow, xhigh));
@@ -379,7 +391,7 @@ void FlowPtContainer::initialise(int nbinsx, double xlow, double xhigh, const in
     for (int i = 0; i < fCMTermList->GetEntries(); ++i)
       dynamic_cast<BootstrapProfile*>(fCMTermList->At(i))->InitializeSubsamples(nsub);
     for (int i = 0; i < fCovList->GetEntries(); ++i)
-      dynamic_cast<BootstrapProfile*>(fCovList->At(i))->InitializeSubsamples(nsub);
+      getCovProfile(i)->InitializeSubsamples(nsub);
   }
   LOGF(info, "Container %s initialized with m = %i\n", this->GetName(), mpar);
 };
@@ -604,16 +616,39 @@ void FlowPtContainer::initialiseSubevent(int nbinsx, double xlow, double xhigh,
 }
 void FlowPtContainer::fill(const double& w, const double& pt)
 {
-  for (size_t i = 0; i < sumP.size(); ++i) {
-    sumP[i] += std::pow(w, i % (mpar + 1)) * std::pow(pt, i / (mpar + 1));
-  }
+  accumulatePowerSums(sumP, w, pt);
   return;
 }
 void FlowPtContainer::fillSub(const double& w, const double& pt, int subIndex)
 {
-  for (size_t i = 0; i < insub[subIndex].size(); ++i) {
-    insub[subIndex][i] += std::pow(w, i % (mpar + 1)) * std::pow(pt, i / (mpar + 1));
+  accumulatePowerSums(insub[subIndex], w, pt);
+}
+void FlowPtContainer::accumulatePowerSums(std::vector<double>& sums, const double& w, const double& pt)
+{
+  // sums[j * (mpar + 1) + i] += w^i * pt^j, with the powers built once by recursion instead of two std::pow calls for each term
+  wPow.resize(mpar + 1);
+  ptPow.resize(mpar + 1);
+  wPow[0] = 1.0;
+  ptPow[0] = 1.0;
+  for (int i = 1; i <= mpar; ++i) {
+    wPow[i] = wPow[i - 1] * w;
+    ptPow[i] = ptPow[i - 1] * pt;
+  }
+  for (size_t i = 0; i < sums.size(); ++i) {
+    sums[i] += wPow[i % (mpar + 1)] * ptPow[i / (mpar + 1)];
   }
+  return;
+}
+BootstrapProfile* FlowPtContainer::getCovProfile(int index)
+{
+  if (static_cast<int>(fCovProfiles.size()) != fCovList->GetEntries()) {
+    fCovProfiles.clear();
+    TIter nextProfile(fCovList);
+    while (TObject* obj = nextProfile()) {
+      fCovProfiles.push_back(dynamic_cast<BootstrapProfile*>(obj));
+    }
+  }
+  return fCovProfiles[index];
 }
 void FlowPtContainer::calculateCorrelations()
 {
@@ -674,11 +709,19 @@ void FlowPtContainer::calculateSubeventCorrelations()
 }
 void FlowPtContainer::fillPtProfiles(const double& centmult, const double& rn)
 {
+  std::vector<BootstrapProfile*> profiles;
+  std::vector<double> values;
+  std::vector<double> weights;
+  TIter nextProfile(fCorrList);
   for (int m = 1; m <= mpar; ++m) {
+    BootstrapProfile* prof = dynamic_cast<BootstrapProfile*>(nextProfile());
     if (corrDen[m] != 0) {
-      dynamic_cast<BootstrapProfile*>(fCorrList->At(m - 1))->FillProfile(centmult, corrNum[m] / corrDen[m], (fEventWeight == EventWeight::UnityWeight) ? 1.0 : corrDen[m], rn);
+      profiles.push_back(prof);
+      values.push_back(corrNum[m] / corrDen[m]);
+      weights.push_back((fEventWeight == EventWeight::UnityWeight) ? 1.0 : corrDen[m]);
     }
   }
+  BootstrapProfile::FillProfiles(profiles, centmult, values, weights, rn);
   return;
 }
 void FlowPtContainer::fillSubeventPtProfiles(const double& centmult, const double& rn)
@@ -715,7 +758,7 @@ void FlowPtContainer::fillVnPtCorrProfiles(const double& centmult, const double&
       continue;
     }
     if (corrDen[m] != 0) {
-      dynamic_cast<BootstrapProfile*>(fCovList->At(fillCounter))->FillProfile(centmult, flowval * corrNum[m] / corrDen[m], (fEventWeight == UnityWeight) ? 1.0 : flowtuples * corrDen[m], rn);
+      getCovProfile(fillCounter)->FillProfile(centmult, flowval * corrNum[m] / corrDen[m], (fEventWeight == UnityWeight) ? 1.0 : flowtuples * corrDen[m], rn);
     }
     ++fillCounter;
   }
@@ -731,7 +774,7 @@ void FlowPtContainer::fillVnDeltaPtProfiles(const double& centmult, const double
       continue;
     for (auto i = 0; i <= m; ++i) {
       if (cmDen[m] != 0) {
-        dynamic_cast<BootstrapProfile*>(fCovList->At(fillCounter))->FillProfile(centmult, flowval * ((i == m) ? cmVal[0] : cmVal[m * (m - 1) / 2 + i + 1]), (fEventWeight == UnityWeight) ? 1.0 : flowtuples * cmDen[m], rn);
+        getCovProfile(fillCounter)->FillProfile(centmult, flowval * ((i == m) ? cmVal[0] : cmVal[m * (m - 1) / 2 + i + 1]), (fEventWeight == UnityWeight) ? 1.0 : flowtuples * cmDen[m], rn);
       }
       ++fillCounter;
     }
@@ -749,7 +792,7 @@ void FlowPtContainer::fillVnPtCorrProfiles(const int configIndex, const double&
       continue;
     }
     if (corrDen[m] != 0) {
-      dynamic_cast<BootstrapProfile*>(fCovList->At(startIndex))->FillProfile(centmult, flowval * corrNum[m] / corrDen[m], (fEventWeight == UnityWeight) ? 1.0 : flowtuples * corrDen[m], rn);
+      getCovProfile(startIndex)->FillProfile(centmult, flowval * corrNum[m] / corrDen[m], (fEventWeight == UnityWeight) ? 1.0 : flowtuples * corrDen[m], rn);
     }
     ++startIndex;
   }
@@ -766,7 +809,7 @@ void FlowPtContainer::fillVnDeltaPtProfiles(const int configIndex, const double&
       continue;
     for (auto i = 0; i <= m; ++i) {
       if (cmDen[m] != 0) {
-        dynamic_cast<BootstrapProfile*>(fCovList->At(startIndex))->FillProfile(centmult, flowval * ((i == m) ? cmVal[0] : cmVal[m * (m - 1) / 2 + i + 1]), (fEventWeight == UnityWeight) ? 1.0 : flowtuples * cmDen[m], rn);
+        getCovProfile(startIndex)->FillProfile(centmult, flowval * ((i == m) ? cmVal[0] : cmVal[m * (m - 1) / 2 + i + 1]), (fEventWeight == UnityWeight) ? 1.0 : flowtuples * cmDen[m], rn);
       }
       ++startIndex;
     }
@@ -777,80 +820,80 @@ void FlowPtContainer::fillVnPtCorrStdProfiles(const double& centmult, const doub
 {
   double wAABBCC = getStdAABBCC(warr);
   if (wAABBCC != 0)
-    dynamic_cast<BootstrapProfile*>(fCovList->At(0))->FillProfile(centmult, getStdAABBCC(arr) / wAABBCC, (fEventWeight == UnityWeight) ? 1.0 : wAABBCC, rn);
+    getCovProfile(0)->FillProfile(centmult, getStdAABBCC(arr) / wAABBCC, (fEventWeight == UnityWeight) ? 1.0 : wAABBCC, rn);
   double wAABBC = getStdAABBC(warr);
   if (wAABBC != 0)
-    dynamic_cast<BootstrapProfile*>(fCovList->At(1))->FillProfile(centmult, getStdAABBCC(arr) / wAABBC, (fEventWeight == UnityWeight) ? 1.0 : wAABBC, rn);
+    getCovProfile(1)->FillProfile(centmult, getStdAABBCC(arr) / wAABBC, (fEventWeight == UnityWeight) ? 1.0 : wAABBC, rn);
   double wABCC = getStdAABBC(warr);
   if (wABCC != 0)
-    dynamic_cast<BootstrapProfile*>(fCovList->At(2))->FillProfile(centmult, getStdABCC(arr) / wABCC, (fEventWeight == UnityWeight) ? 1.0 : wABCC, rn);
+    getCovProfile(2)->FillProfile(centmult, getStdABCC(arr) / wABCC, (fEventWeight == UnityWeight) ? 1.0 : wABCC, rn);
   double wABC = getStdABC(warr);
   if (wABC != 0)
-    dynamic_cast<BootstrapProfile*>(fCovList->At(3))->FillProfile(centmult, getStdABC(arr) / wABC, (fEventWeight == UnityWeight) ? 1.0 : wABC, rn);
+    getCovProfile(3)->FillProfile(centmult, getStdABC(arr) / wABC, (fEventWeight == UnityWeight) ? 1.0 : wABC, rn);
   return;
 }
 void FlowPtContainer::fillVnDeltaPtStdProfiles(const double& centmult, const double& rn)
 {
   double wAABBCC = getStdAABBCC(warr);
   if (wAABBCC != 0)
-    dynamic_cast<BootstrapProfile*>(fCovList->At(0))->FillProfile(centmult, getStdAABBCC(arr) / wAABBCC, (fEventWeight == UnityWeight) ? 1.0 : wAABBCC, rn);
+    getCovProfile(0)->FillProfile(centmult, getStdAABBCC(arr) / wAABBCC, (fEventWeight == UnityWeight) ? 1.0 : wAABBCC, rn);
   double wAABBCD = getStdAABBCD(warr);
   if (wAABBCD != 0)
-    dynamic_cast<BootstrapProfile*>(fCovList->At(1))->FillProfile(centmult, getStdAABBCD(arr) / wAABBCD, (fEventWeight == UnityWeight) ? 1.0 : wAABBCD, rn);
+    getCovProfile(1)->FillProfile(centmult, getStdAABBCD(arr) / wAABBCD, (fEventWeight == UnityWeight) ? 1.0 : wAABBCD, rn);
   double wAABBDD = getStdAABBDD(warr);
   if (wAABBDD != 0)
-    dynamic_cast<BootstrapProfile*>(fCovList->At(2))->FillProfile(centmult, getStdAABBDD(arr) / wAABBDD, (fEventWeight == UnityWeight) ? 1.0 : wAABBDD, rn);
+    getCovProfile(2)->FillProfile(centmult, getStdAABBDD(arr) / wAABBDD, (fEventWeight == UnityWeight) ? 1.0 : wAABBDD, rn);
 
   double wAABBC = getStdAABBC(warr);
   if (wAABBC != 0)
-    dynamic_cast<BootstrapProfile*>(fCovList->At(3))->FillProfile(centmult, getStdAABBC(arr) / wAABBC, (fEventWeight == UnityWeight) ? 1.0 : wAABBC, rn);
+    getCovProfile(3)->FillProfile(centmult, getStdAABBC(arr) / wAABBC, (fEventWeight == UnityWeight) ? 1.0 : wAABBC, rn);
   double wAABBD = getStdAABBD(warr);
   if (wAABBD != 0)
-    dynamic_cast<BootstrapProfile*>(fCovList->At(4))->FillProfile(centmult, getStdAABBD(arr) / wAABBD, (fEventWeight == UnityWeight) ? 1.0 : wAABBD, rn);
+    getCovProfile(4)->FillProfile(centmult, getStdAABBD(arr) / wAABBD, (fEventWeight == UnityWeight) ? 1.0 : wAABBD, rn);
 
   double wABCC = getStdABCC(warr);
   if (wABCC != 0)
-    dynamic_cast<BootstrapProfile*>(fCovList->At(5))->FillProfile(centmult, getStdABCC(arr) / wABCC, (fEventWeight == UnityWeight) ? 1.0 : wABCC, rn);
+    getCovProfile(5)->FillProfile(centmult, getStdABCC(arr) / wABCC, (fEventWeight == UnityWeight) ? 1.0 : wABCC, rn);
   double wABCD = getStdABCD(warr);
   if (wABCD != 0)
-    dynamic_cast<BootstrapProfile*>(fCovList->At(6))->FillProfile(centmult, getStdABCD(arr) / wABCD, (fEventWeight == UnityWeight) ? 1.0 : wABCD, rn);
+    getCovProfile(6)->FillProfile(centmult, getStdABCD(arr) / wABCD, (fEventWeight == UnityWeight) ? 1.0 : wABCD, rn);
   double wABDD = getStdABDD(warr);
   if (wABDD != 0)
-    dynamic_cast<BootstrapProfile*>(fCovList->At(7))->FillProfile(centmult, getStdABDD(arr) / wABDD, (fEventWeight == UnityWeight) ? 1.0 : wABDD, rn);
+    getCovProfile(7)->FillProfile(centmult, getStdABDD(arr) / wABDD, (fEventWeight == UnityWeight) ? 1.0 : wABDD, rn);
 
   double wABC = getStdABC(warr);
   if (wABC != 0)
-    dynamic_cast<BootstrapProfile*>(fCovList->At(8))->FillProfile(centmult, getStdABC(arr) / wABC, (fEventWeight == UnityWeight) ? 1.0 : wABC, rn);
+    getCovProfile(8)->FillProfile(centmult, getStdABC(arr) / wABC, (fEventWeight == UnityWeight) ? 1.0 : wABC, rn);
   double wABD = getStdABD(warr);
   if (wABD != 0)
-    dynamic_cast<BootstrapProfile*>(fCovList->At(9))->FillProfile(centmult, getStdABD(arr) / wABD, (fEventWeight == UnityWeight) ? 1.0 : wABD, rn);
+    getCovProfile(9)->FillProfile(centmult, getStdABD(arr) / wABD, (fEventWeight == UnityWeight) ? 1.0 : wABD, rn);
   double wABCCCC = getStdABCCCC(warr);
   if (wABCCCC != 0.)
-    dynamic_cast<BootstrapProfile*>(fCovList->At(14))->FillProfile(centmult, getStdABCCCC(arr) / wABCCCC, (fEventWeight == UnityWeight) ? 1. : wABCCCC, rn);
+    getCovProfile(14)->FillProfile(centmult, getStdABCCCC(arr) / wABCCCC, (fEventWeight == UnityWeight) ? 1. : wABCCCC, rn);
   double wABCCCD = getStdABCCCD(warr);
   if (wABCCCD != 0.)
-    dynamic_cast<BootstrapProfile*>(fCovList->At(15))->FillProfile(centmult, getStdABCCCD(arr) / wABCCCD, (fEventWeight == UnityWeight) ? 1. : wABCCCD, rn);
+    getCovProfile(15)->FillProfile(centmult, getStdABCCCD(arr) / wABCCCD, (fEventWeight == UnityWeight) ? 1. : wABCCCD, rn);
   double wABCCDD = getStdABCCDD(warr);
   if (wABCCDD != 0.)
-    dynamic_cast<BootstrapProfile*>(fCovList->At(16))->FillProfile(centmult, getStdABCCDD(arr) / wABCCDD, (fEventWeight == UnityWeight) ? 1. : wABCCDD, rn);
+    getCovProfile(16)->FillProfile(centmult, getStdABCCDD(arr) / wABCCDD, (fEventWeight == UnityWeight) ? 1. : wABCCDD, rn);
   double wABCDDD = getStdABCDDD(warr);
   if (wABCDDD != 0.)
-    dynamic_cast<BootstrapProfile*>(fCovList->At(17))->FillProfile(centmult, getStdABCDDD(arr) / wABCDDD, (fEventWeight == UnityWeight) ? 1. : wABCDDD, rn);
+    getCovProfile(17)->FillProfile(centmult, getStdABCDDD(arr) / wABCDDD, (fEventWeight == UnityWeight) ? 1. : wABCDDD, rn);
   double wABDDDD = getStdABDDDD(warr);
   if (wABDDDD != 0.)
-    dynamic_cast<BootstrapProfile*>(fCovList->At(18))->FillProfile(centmult, getStdABDDDD(arr) / wABDDDD, (fEventWeight == UnityWeight) ? 1. : wABDDDD, rn);
+    getCovProfile(18)->FillProfile(centmult, getStdABDDDD(arr) / wABDDDD, (fEventWeight == UnityWeight) ? 1. : wABDDDD, rn);
   double wABCCC = getStdABCCC(warr);
   if (wABCCC != 0.)
-    dynamic_cast<BootstrapProfile*>(fCovList->At(10))->FillProfile(centmult, getStdABCCC(arr) / wABCCC, (fEventWeight == UnityWeight) ? 1. : wABCCC, rn);
+    getCovProfile(10)->FillProfile(centmult, getStdABCCC(arr) / wABCCC, (fEventWeight == UnityWeight) ? 1. : wABCCC, rn);
   double wABCCD = getStdABCCD(warr);
   if (wABCCD != 0.)
-    dynamic_cast<BootstrapProfile*>(fCovList->At(11))->FillProfile(centmult, getStdABCCD(arr) / wABCCD, (fEventWeight == UnityWeight) ? 1. : wABCCD, rn);
+    getCovProfile(11)->FillProfile(centmult, getStdABCCD(arr) / wABCCD, (fEventWeight == UnityWeight) ? 1. : wABCCD, rn);
   double wABCDD = getStdABCDD(warr);
   if (wABCDD != 0.)
-    dynamic_cast<BootstrapProfile*>(fCovList->At(12))->FillProfile(centmult, getStdABCDD(arr) / wABCDD, (fEventWeight == UnityWeight) ? 1. : wABCDD, rn);
+    getCovProfile(12)->FillProfile(centmult, getStdABCDD(arr) / wABCDD, (fEventWeight == UnityWeight) ? 1. : wABCDD, rn);
   double wABDDD = getStdABDDD(warr);
   if (wABDDD != 0.)
-    dynamic_cast<BootstrapProfile*>(fCovList->At(13))->FillProfile(centmult, getStdABDDD(arr) / wABDDD, (fEventWeight == UnityWeight) ? 1. : wABDDD, rn);
+    getCovProfile(13)->FillProfile(centmult, getStdABDDD(arr) / wABDDD, (fEventWeight == UnityWeight) ? 1. : wABDDD, rn);
   return;
 }
 void FlowPtContainer::fillCMProfiles(const double& centmult, const double& rn)
@@ -1009,17 +1052,38 @@ void FlowPtContainer::fillCMSubeventProfiles(const double& centmult, const doubl
 }
 void FlowPtContainer::fillArray(FillType a, FillType b, double c, double d)
 {
-  for (int idx = 0; idx < 225; ++idx) {
-    int i = idx % 3;
-    int j = ((idx - i) / 3) % 3;
-    int k = ((idx - j * 3 - i) / 9) % 5;
-    int l = ((idx - k * 9 - j * 3 - i) / 45) % 5;
-    if (std::holds_alternative<std::complex<double>>(a) && std::holds_alternative<std::complex<double>>(b)) {
-      arr[idx] += std::pow(std::get<0>(a), i) * std::pow(std::get<0>(b), j) * std::pow(c, k) * std::pow(d, l);
-    } else if (std::holds_alternative<double>(a) && std::holds_alternative<double>(b)) {
-      warr[idx] += std::pow(std::get<1>(a), i) * std::pow(std::get<1>(b), j) * std::pow(c, k) * std::pow(d, l);
-    } else {
-      LOGF(error, "FillType variant should hold same type for a and b during single function c");
+  // powers are built once by recursion, instead of four std::pow calls for each of the 3x3x5x5 terms
+  double cPow[5] = {1.0};
+  double dPow[5] = {1.0};
+  for (int k = 1; k < 5; ++k) {
+    cPow[k] = cPow[k - 1] * c;
+    dPow[k] = dPow[k - 1] * d;
+  }
+  if (std::holds_alternative<std::complex<double>>(a) && std::holds_alternative<std::complex<double>>(b)) {
+    const std::complex<double> aPow[3] = {1.0, std::get<0>(a), std::get<0>(a) * std::get<0>(a)};
+    const std::complex<double> bPow[3] = {1.0, std::get<0>(b), std::get<0>(b) * std::get<0>(b)};
+    fillArrayTerms(arr, aPow, bPow, cPow, dPow);
+  } else if (std::holds_alternative<double>(a) && std::holds_alternative<double>(b)) {
+    const double aPow[3] = {1.0, std::get<1>(a), std::get<1>(a) * std::get<1>(a)};
+    const double bPow[3] = {1.0, std::get<1>(b), std::get<1>(b) * std::get<1>(b)};
+    fillArrayTerms(warr, aPow, bPow, cPow, dPow);
+  } else {
+    LOGF(error, "FillType variant should hold same type for a and b during single function c");
+  }
+  return;
+}
+template <typename T>
+void FlowPtContainer::fillArrayTerms(std::vector<T>& target, const T* aPow, const T* bPow, const double* cPow, const double* dPow)
+{
+  // same layout as getVectorIndex(i, j, k, l)
+  int idx = 0;
+  for (int l = 0; l < 5; ++l) {
+    for (int k = 0; k < 5; ++k) {
+      for (int j = 0; j < 3; ++j) {
+        for (int i = 0; i < 3; ++i) {
+          target[idx++] += aPow[i] * bPow[j] * cPow[k] * dPow[l];
+        }
+      }
     }
   }
   return;
@@ -1658,7 +1722,7 @@ void FlowPtContainer::rebinMulti(int nbins)
   }
   if (fCovList) {
     for (int i = 0; i < fCovList->GetEntries(); i++)
-      dynamic_cast<BootstrapProfile*>(fCovList->At(i))->RebinMulti(nbins);
+      getCovProfile(i)->RebinMulti(nbins);
   }
   if (fSubList) {
     for (int i = 0; i < fSubList->GetEntries(); i++)
@@ -1682,7 +1746,7 @@ void FlowPtContainer::rebinMulti(int nbins, double* binedges)
   }
   if (fCovList) {
     for (int i = 0; i < fCovList->GetEntries(); i++)
-      dynamic_cast<BootstrapProfile*>(fCovList->At(i))->RebinMulti(nbins, binedges);
+      getCovProfile(i)->RebinMulti(nbins, binedges);
   }
   if (fSubList) {
     for (int i = 0; i < fSubList->GetEntries(); i++)
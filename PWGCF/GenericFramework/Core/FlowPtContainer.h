@@ -182,6 +182,13 @@ class FlowPtContainer : public TNamed
   std::vector<std::complex<double>> arr;       //!
   std::vector<double> warr;                    //!
   std::vector<int> fCovFirstIndex;             //!
+  std::vector<double> wPow;                    //! powers of the particle weight, built once per particle in fill()
+  std::vector<double> ptPow;                   //! powers of the particle pt, built once per particle in fill()
+  std::vector<BootstrapProfile*> fCovProfiles; //! fCovList entries, to avoid the linear TList::At lookup for each fill
+  void accumulatePowerSums(std::vector<double>& sums, const double& w, const double& pt);
+  BootstrapProfile* getCovProfile(int index);
+  template <typename T>
+  void fillArrayTerms(std::vector<T>& target, const T* aPow, const T* bPow, const double* cPow, const double* dPow);
   template <typename T>
   double getStdAABBCC(T& inarr);
   template <typename T>
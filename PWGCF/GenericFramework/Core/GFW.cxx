@@ -11,6 +11,8 @@
 
 #include "GFW.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstdio>
 #include <string>
 #include <utility>
@@ -98,11 +100,75 @@ int GFW::CreateRegions()
 void GFW::Fill(double eta, int ptin, double phi, double weight, int mask, double SecondWeight)
 {
   // if(!fInitialized) return;
+  InvalidateCorrCache();
   for (int i = 0; i < static_cast<int>(fRegions.size()); ++i) {
     if (fRegions.at(i).EtaMin < eta && fRegions.at(i).EtaMax > eta && (fRegions.at(i).BitMask & mask))
       fCumulants.at(i).FillArray(ptin, phi, weight, SecondWeight);
   }
 };
+void GFW::FillBatch(const double* eta, const int* ptin, const double* phi, const double* weight, const int* mask, int n, const double* SecondWeight)
+{
+  if (n < 1)
+    return;
+  if (!fInitialized)
+    CreateRegions();
+  InvalidateCorrCache();
+  int maxHar = 1;
+  int maxPow = 1;
+  for (auto& lCumulant : fCumulants) {
+    maxHar = std::max(maxHar, lCumulant.GetNhar());
+    maxPow = std::max(maxPow, lCumulant.GetMaxPower());
+  }
+  fBatchCos.resize(maxHar * n);
+  fBatchSin.resize(maxHar * n);
+  fBatchWPow.resize(maxPow * n);
+  fBatchSel.resize(n);
+  double* lCos = fBatchCos.data();
+  double* lSin = fBatchSin.data();
+  double* lWPow = fBatchWPow.data();
+  // Harmonics: cos((k+1)phi) = 2cos(phi)cos(k phi) - cos((k-1)phi), same for sin. Inner loops run over particles
+  for (int i = 0; i < n; i++) {
+    lCos[i] = 1.;
+    lSin[i] = 0.;
+  }
+  if (maxHar > 1) {
+    for (int i = 0; i < n; i++) {
+      lCos[n + i] = cos(phi[i]);
+      lSin[n + i] = sin(phi[i]);
+    }
+  }
+  for (int k = 2; k < maxHar; k++) {
+    const double* c1 = lCos + (k - 1) * n;
+    const double* c2 = lCos + (k - 2) * n;
+    const double* s1 = lSin + (k - 1) * n;
+    const double* s2 = lSin + (k - 2) * n;
+    double* c = lCos + k * n;
+    double* s = lSin + k * n;
+    for (int i = 0; i < n; i++) {
+      c[i] = 2. * lCos[n + i] * c1[i] - c2[i];
+      s[i] = 2. * lCos[n + i] * s1[i] - s2[i];
+    }
+  }
+  // Weight prefactors, same convention as GFWCumulant::FillArray: w^p, or w*w2^(p-1) if the second weight is given
+  for (int i = 0; i < n; i++)
+    lWPow[i] = 1.;
+  for (int p = 1; p < maxPow; p++) {
+    const double* prev = lWPow + (p - 1) * n;
+    double* cur = lWPow + p * n;
+    for (int i = 0; i < n; i++)
+      cur[i] = prev[i] * ((p > 1 && SecondWeight && SecondWeight[i] > 0) ? SecondWeight[i] : weight[i]);
+  }
+  // Select particles per region and fill
+  for (int r = 0; r < static_cast<int>(fRegions.size()); ++r) {
+    const Region& lRegion = fRegions[r];
+    int nSel = 0;
+    for (int i = 0; i < n; i++) {
+      if (lRegion.EtaMin < eta[i] && lRegion.EtaMax > eta[i] && (lRegion.BitMask & mask[i]))
+        fBatchSel[nSel++] = i;
+    }
+    fCumulants[r].FillArrayBatch(nSel, fBatchSel.data(), ptin, lCos, lSin, lWPow, n);
+  }
+};
 complex<double> GFW::TwoRec(int n1, int n2, int p1, int p2, int ptbin, GFWCumulant* r1, GFWCumulant* r2, GFWCumulant* r3)
 {
   complex<double> part1 = r1->Vec(n1, p1, ptbin);
@@ -128,6 +194,12 @@ complex<double> GFW::RecursiveCorr(GFWCumulant* qpoi, GFWCumulant* qref, GFWCumu
     return qpoi->Vec(hars.at(0), pows.at(0), ptbin);
   if (hars.size() < 3)
     return TwoRec(hars.at(0), hars.at(1), pows.at(0), pows.at(1), ptbin, qpoi, qref, qol);
+  if (fUseCorrCache) {
+    BuildCorrKey(qpoi, qref, qol, ptbin, hars, pows);
+    auto cached = fCorrCache.find(fCorrKey);
+    if (cached != fCorrCache.end())
+      return cached->second;
+  }
   int harlast = hars.at(hars.size() - 1);
   int powlast = pows.at(pows.size() - 1);
   hars.erase(hars.end() - 1);
@@ -157,14 +229,30 @@ complex<double> GFW::RecursiveCorr(GFWCumulant* qpoi, GFWCumulant* qref, GFWCumu
   }
   hars.push_back(harlast);
   pows.push_back(powlast);
+  if (fUseCorrCache) {
+    BuildCorrKey(qpoi, qref, qol, ptbin, hars, pows); // key buffer was overwritten by the recursion
+    fCorrCache.emplace(fCorrKey, formula);
+  }
   return formula;
 };
+void GFW::BuildCorrKey(GFWCumulant* qpoi, GFWCumulant* qref, GFWCumulant* qol, int ptbin, const vector<int>& hars, const vector<int>& pows)
+{
+  GFWCumulant* first = fCumulants.data();
+  fCorrKey.clear();
+  fCorrKey.push_back(static_cast<int>(qpoi - first));
+  fCorrKey.push_back(static_cast<int>(qref - first));
+  fCorrKey.push_back(qol ? static_cast<int>(qol - first) : -1);
+  fCorrKey.push_back(ptbin);
+  fCorrKey.insert(fCorrKey.end(), hars.begin(), hars.end());
+  fCorrKey.insert(fCorrKey.end(), pows.begin(), pows.end());
+};
 void GFW::Clear()
 {
   if (!fInitialized)
     CreateRegions();
   for (auto ptr = fCumulants.begin(); ptr != fCumulants.end(); ++ptr)
     ptr->ResetQs();
+  fCorrCache.clear();
 };
 GFW::CorrConfig GFW::GetCorrelatorConfig(string config, string head, bool ptdif)
 {
@@ -302,6 +390,13 @@ complex<double> GFW::Calculate(CorrConfig corconf, int ptbin, bool SetHarmsToZer
   }
   return retval;
 };
+void GFW::CalculateAll(vector<complex<double>>& results, int ptbin, bool SetHarmsToZero)
+{
+  // All configurations share the per-event cache, so common sub-correlators are evaluated only once
+  results.resize(fListOfCFGs.size());
+  for (int i = 0; i < static_cast<int>(fListOfCFGs.size()); i++)
+    results[i] = Calculate(fListOfCFGs[i], ptbin, SetHarmsToZero);
+};
 vector<pair<int, vector<int>>> GFW::GetHarmonicsSingleConfig(const CorrConfig& incfg)
 {
   vector<pair<int, vector<int>>> retPair;
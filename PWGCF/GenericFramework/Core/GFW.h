@@ -22,6 +22,7 @@
 #include <algorithm>
 #include <complex>
 #include <cstdio>
+#include <map>
 #include <string>
 #include <utility>
 #include <vector>
@@ -61,15 +62,42 @@ class GFW
   void AddRegion(std::string refName, int lNhar, int* lNparVec, double lEtaMin, double lEtaMax, int lNpT, int BitMask);  // Legacy support, array instead of a vector
   int CreateRegions();
   void Fill(double eta, int ptin, double phi, double weight, int mask, double secondWeight = -1);
+  // Fill n particles given as SoA arrays. Equivalent to calling Fill() for each particle, but the harmonics are
+  // obtained with the Chebyshev recursion from cos(phi), sin(phi) once per particle and shared among all regions
+  void FillBatch(const double* eta, const int* ptin, const double* phi, const double* weight, const int* mask, int n, const double* secondWeight = nullptr);
   void Clear();
   GFWCumulant GetCumulant(int index) { return fCumulants.at(index); }
   CorrConfig GetCorrelatorConfig(std::string config, std::string head = "", bool ptdif = false);
   std::complex<double> Calculate(CorrConfig corconf, int ptbin, bool SetHarmsToZero);
+  // Evaluate all configurations obtained with GetCorrelatorConfig() in one pass, in the order they were created
+  void CalculateAll(std::vector<std::complex<double>>& results, int ptbin, bool SetHarmsToZero = false);
+  int GetNConfigs() { return static_cast<int>(fListOfCFGs.size()); }
+  // Sub-correlators with 3 or more harmonics are memoized within the event (until the next Clear() or Fill())
+  void SetUseCorrelatorCache(bool use)
+  {
+    fUseCorrCache = use;
+    fCorrCache.clear();
+  }
   void InitializePowerArrays();
 
  protected:
   bool fInitialized;
   std::vector<CorrConfig> fListOfCFGs;
+  // Work arrays of FillBatch, kept to avoid reallocations
+  std::vector<double> fBatchCos;
+  std::vector<double> fBatchSin;
+  std::vector<double> fBatchWPow;
+  std::vector<int> fBatchSel;
+  // Per-event cache of sub-correlators, key = (POI, ref, overlap, pT bin, harmonics, powers)
+  bool fUseCorrCache = true;
+  std::map<std::vector<int>, std::complex<double>> fCorrCache;
+  std::vector<int> fCorrKey;
+  void BuildCorrKey(GFWCumulant* qpoi, GFWCumulant* qref, GFWCumulant* qol, int ptbin, const std::vector<int>& hars, const std::vector<int>& pows);
+  void InvalidateCorrCache()
+  {
+    if (!fCorrCache.empty())
+      fCorrCache.clear();
+  }
   std::complex<double> TwoRec(int n1, int n2, int p1, int p2, int ptbin, GFWCumulant*, GFWCumulant*, GFWCumulant*);
   std::complex<double> RecursiveCorr(GFWCumulant* qpoi, GFWCumulant* qref, GFWCumulant* qol, int ptbin, std::vector<int>& hars, std::vector<int>& pows); // POI, Ref. flow, overlapping region
   std::complex<double> RecursiveCorr(GFWCumulant* qpoi, GFWCumulant* qref, GFWCumulant* qol, int ptbin, std::vector<int>& hars);                         // POI, Ref. flow, overlapping region
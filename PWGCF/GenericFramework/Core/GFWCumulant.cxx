@@ -11,6 +11,7 @@
 
 #include "GFWCumulant.h"
 
+#include <algorithm>
 #include <vector>
 
 using std::complex;
@@ -54,6 +55,58 @@ void GFWCumulant::FillArray(int ptin, double phi, double weight, double SecondWe
   }
   Inc();
 };
+void GFWCumulant::FillArrayBatch(int nSel, const int* sel, const int* ptin, const double* cosN, const double* sinN, const double* wPow, int stride)
+{
+  if (!fInitialized)
+    CreateComplexVectorArray(1, 1, 1);
+  if (nSel < 1)
+    return;
+  if (fPt == 1) {
+    // Integrated case: every (harmonic, power) is a plain reduction over the selected particles
+    fFilledPts[0] = true;
+    for (int lN = 0; lN < fN; lN++) {
+      const double* lCos = cosN + lN * stride;
+      const double* lSin = sinN + lN * stride;
+      for (int lPow = 0; lPow < PW(lN); lPow++) {
+        const double* lPrefactor = wPow + lPow * stride;
+        double qcos = 0;
+        double qsin = 0;
+        for (int j = 0; j < nSel; j++) {
+          qcos += lPrefactor[sel[j]] * lCos[sel[j]];
+          qsin += lPrefactor[sel[j]] * lSin[sel[j]];
+        }
+        fQvector[0][lN][lPow] += complex<double>(qcos, qsin);
+      }
+    }
+    fNEntries += nSel;
+    return;
+  }
+  for (int j = 0; j < nSel; j++) {
+    int i = sel[j];
+    int lPt = ptin[i];
+    if (lPt < 0 || lPt >= fPt)
+      continue; // out-of-range pT bins are not filled, as in FillArray
+    fFilledPts[lPt] = true;
+    for (int lN = 0; lN < fN; lN++) {
+      double lCos = cosN[lN * stride + i];
+      double lSin = sinN[lN * stride + i];
+      for (int lPow = 0; lPow < PW(lN); lPow++) {
+        double lPrefactor = wPow[lPow * stride + i];
+        fQvector[lPt][lN][lPow] += complex<double>(lPrefactor * lCos, lPrefactor * lSin);
+      }
+    }
+    Inc();
+  }
+};
+int GFWCumulant::GetMaxPower()
+{
+  if (fPowVec.empty())
+    return 1;
+  int maxPow = 0;
+  for (int lN = 0; lN < fN; lN++)
+    maxPow = std::max(maxPow, PW(lN));
+  return maxPow;
+};
 void GFWCumulant::ResetQs()
 {
   if (!fNEntries)
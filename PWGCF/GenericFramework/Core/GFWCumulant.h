@@ -27,6 +27,9 @@ class GFWCumulant
   ~GFWCumulant();
   void ResetQs();
   void FillArray(int ptin, double phi, double weight = 1, double SecondWeight = -1);
+  // Fill nSel particles (indices sel) from precomputed SoA arrays with row stride "stride":
+  // cosN/sinN[n*stride + i] = cos/sin(n*phi_i), wPow[p*stride + i] = weight prefactor of power p
+  void FillArrayBatch(int nSel, const int* sel, const int* ptin, const double* cosN, const double* sinN, const double* wPow, int stride);
   enum UsedFlags_t { kBlank = 0,
                      kFull = 1,
                      kPt = 2 };
@@ -41,6 +44,8 @@ class GFWCumulant
   void CreateComplexVectorArray(int N = 1, int P = 1, int Pt = 1);
   void CreateComplexVectorArrayVarPower(int N = 1, std::vector<int> Pvec = {1}, int Pt = 1);
   int PW(int ind) { return fPowVec.at(ind); }; // No checks to speed up, be carefull!!!
+  int GetNhar() { return fN; }
+  int GetMaxPower();
   void DestroyComplexVectorArray();
   std::complex<double> Vec(int, int, int ptbin = 0); // envelope class to summarize pt-dif. Q-vec getter
  protected:
@@ -11,6 +11,7 @@
 
 #include "GFWWeights.h"
 #include "TMath.h"
+#include <algorithm>
 #include <cstdio>
 
 GFWWeights::GFWWeights() : TNamed("", ""),
@@ -143,29 +144,73 @@ double GFWWeights::getWeight(double phi, double eta, double vz, double pt, doubl
     return 1. / weight;
   return 1;
 };
-double GFWWeights::getNUA(double phi, double eta, double vz)
+void GFWWeights::FlatGrid::build(TH3D* h)
+{
+  TAxis* axes[3] = {h->GetXaxis(), h->GetYaxis(), h->GetZaxis()};
+  Axis* flatAxes[3] = {&x, &y, &z};
+  for (int i = 0; i < 3; ++i) {
+    flatAxes[i]->nBins = axes[i]->GetNbins();
+    flatAxes[i]->min = axes[i]->GetXmin();
+    flatAxes[i]->max = axes[i]->GetXmax();
+    flatAxes[i]->edges.clear();
+    if (axes[i]->GetXbins()->GetSize() > 0)
+      flatAxes[i]->edges.assign(axes[i]->GetXbins()->GetArray(), axes[i]->GetXbins()->GetArray() + axes[i]->GetXbins()->GetSize());
+  }
+  values.resize((x.nBins + 2) * (y.nBins + 2) * (z.nBins + 2));
+  for (size_t bin = 0; bin < values.size(); ++bin) {
+    double weight = h->GetBinContent(static_cast<int>(bin));
+    values[bin] = (weight != 0) ? 1. / weight : 1.;
+  }
+}
+bool GFWWeights::createNUAGrid()
 {
   if (!fAccInt)
     createNUA();
-  int xind = fAccInt->GetXaxis()->FindBin(phi);
-  int etaind = fAccInt->GetYaxis()->FindBin(eta);
-  int vzind = fAccInt->GetZaxis()->FindBin(vz);
-  double weight = fAccInt->GetBinContent(xind, etaind, vzind);
-  if (weight != 0)
-    return 1. / weight;
-  return 1;
+  if (!fAccInt)
+    return kFALSE;
+  fAccGrid.build(fAccInt);
+  return kTRUE;
 }
-double GFWWeights::getNUE(double pt, double eta, double vz)
+bool GFWWeights::createNUEGrid()
 {
   if (!fEffInt)
     createNUE();
-  int xind = fEffInt->GetXaxis()->FindBin(pt);
-  int etaind = fEffInt->GetYaxis()->FindBin(eta);
-  int vzind = fEffInt->GetZaxis()->FindBin(vz);
-  double weight = fEffInt->GetBinContent(xind, etaind, vzind);
-  if (weight != 0)
-    return 1. / weight;
-  return 1;
+  if (!fEffInt)
+    return kFALSE;
+  fEffGrid.build(fEffInt);
+  return kTRUE;
+}
+double GFWWeights::getNUA(double phi, double eta, double vz)
+{
+  if (fAccGrid.empty() && !createNUAGrid())
+    return 1;
+  return fAccGrid.get(phi, eta, vz);
+}
+double GFWWeights::getNUE(double pt, double eta, double vz)
+{
+  if (fEffGrid.empty() && !createNUEGrid())
+    return 1;
+  return fEffGrid.get(pt, eta, vz);
+}
+void GFWWeights::getNUA(std::span<const float> phi, std::span<const float> eta, double vz, std::span<float> weights)
+{
+  if (fAccGrid.empty() && !createNUAGrid()) {
+    std::fill(weights.begin(), weights.end(), 1.f);
+    return;
+  }
+  int vzind = fAccGrid.z.findBin(vz);
+  for (size_t i = 0; i < weights.size(); ++i)
+    weights[i] = fAccGrid.values[fAccGrid.x.findBin(phi[i]) + (fAccGrid.x.nBins + 2) * (fAccGrid.y.findBin(eta[i]) + (fAccGrid.y.nBins + 2) * vzind)];
+}
+void GFWWeights::getNUE(std::span<const float> pt, std::span<const float> eta, double vz, std::span<float> weights)
+{
+  if (fEffGrid.empty() && !createNUEGrid()) {
+    std::fill(weights.begin(), weights.end(), 1.f);
+    return;
+  }
+  int vzind = fEffGrid.z.findBin(vz);
+  for (size_t i = 0; i < weights.size(); ++i)
+    weights[i] = fEffGrid.values[fEffGrid.x.findBin(pt[i]) + (fEffGrid.x.nBins + 2) * (fEffGrid.y.findBin(eta[i]) + (fEffGrid.y.nBins + 2) * vzind)];
 }
 double GFWWeights::findMax(TH3D* inh, int& ix, int& iy, int& iz)
 {
@@ -218,6 +263,7 @@ void GFWWeights::createNUA(bool IntegrateOverCentAndPt)
   if (IntegrateOverCentAndPt) {
     if (fAccInt)
       delete fAccInt;
+    fAccGrid.clear();
     fAccInt = reinterpret_cast<TH3D*>(fW_data->At(0)->Clone("IntegratedAcceptance"));
     fAccInt->Sumw2();
     for (int etai = 1; etai <= fAccInt->GetNbinsY(); etai++) {
@@ -278,6 +324,7 @@ void GFWWeights::createNUE(bool IntegrateOverCentrality)
     den->RebinY(2);
     num->RebinZ(5);
     den->RebinZ(5);
+    fEffGrid.clear();
     fEffInt = reinterpret_cast<TH3D*>(num->Clone("Efficiency_Integrated"));
     fEffInt->Divide(den);
     return;
@@ -364,6 +411,8 @@ void GFWWeights::overwriteNUA()
   delete trash;
   fW_data->Add(reinterpret_cast<TH3D*>(fAccInt->Clone(ts.Data())));
   delete fAccInt;
+  fAccInt = 0;
+  fAccGrid.clear();
 }
 Long64_t GFWWeights::Merge(TCollection* collist)
 {
@@ -27,6 +27,10 @@
 #include "TCollection.h"
 #include "TString.h"
 
+#include <algorithm>
+#include <span>
+#include <vector>
+
 class GFWWeights : public TNamed
 {
  public:
@@ -40,6 +44,8 @@ class GFWWeights : public TNamed
   double getNUE(double pt, double eta, double vz);                                                    // fetches weight from fEffInt
   bool isDataFilled() { return fDataFilled; }
   bool isMCFilled() { return fMCFilled; }
+  void getNUA(std::span<const float> phi, std::span<const float> eta, double vz, std::span<float> weights); // NUA weights of a span of tracks of the same collision
+  void getNUE(std::span<const float> pt, std::span<const float> eta, double vz, std::span<float> weights);  // NUE weights of a span of tracks of the same collision
   double findMax(TH3D* inh, int& ix, int& iy, int& iz);
   void mcToEfficiency();
   TObjArray* getRecArray() { return fW_mcrec; }
@@ -73,6 +79,38 @@ class GFWWeights : public TNamed
   TH3D* fAccInt;   //!
   int fNbinsPt;    //! do not store
   double* fbinsPt; //! do not store
+
+  /// Flat copy of the inverse weights of a TH3D, looked up without virtual calls nor bin search for uniform axes
+  struct FlatGrid {
+    struct Axis {
+      int nBins = 0;
+      double min = 0;
+      double max = 0;
+      std::vector<double> edges; // empty for uniform binning
+      /// same bin as TAxis::FindBin, including underflow and overflow
+      int findBin(double x) const
+      {
+        if (x < min)
+          return 0;
+        if (!(x < max))
+          return nBins + 1;
+        if (edges.empty())
+          return 1 + static_cast<int>(nBins * (x - min) / (max - min));
+        return static_cast<int>(std::upper_bound(edges.begin(), edges.end(), x) - edges.begin());
+      }
+    };
+    Axis x, y, z;
+    std::vector<float> values; // inverse weights, 1 for empty bins, in the TH3 global bin order
+    bool empty() const { return values.empty(); }
+    void clear() { values.clear(); }
+    void build(TH3D* h);
+    int findBinYZ(double yv, double zv) const { return (x.nBins + 2) * (y.findBin(yv) + (y.nBins + 2) * z.findBin(zv)); }
+    float get(double xv, double yv, double zv) const { return values[x.findBin(xv) + findBinYZ(yv, zv)]; }
+  };
+  FlatGrid fAccGrid; //! do not store, built from fAccInt
+  FlatGrid fEffGrid; //! do not store, built from fEffInt
+  bool createNUAGrid();
+  bool createNUEGrid();
   void addArray(TObjArray* targ, TObjArray* sour);
   const char* getBinName(double /*ptv*/, double /*v0mv*/, const char* pf = "")
   {
@@ -40,11 +40,13 @@
 #include <DataFormatsParameters/GRPObject.h>
 
 #include <TF1.h>
+#include <TList.h>
 #include <TPDGCode.h>
 #include <TProfile.h>
 #include <TRandom3.h>
 
 #include <algorithm>
+#include <bit>
 #include <complex>
 #include <map>
 #include <numeric>
@@ -112,6 +114,12 @@ struct FlowGenericFramework {
   O2_DEFINE_CONFIGURABLE(cfgEta, float, 0.8, "eta cut");
   O2_DEFINE_CONFIGURABLE(cfgEtaPtPt, float, 0.4, "eta cut for pt-pt correlations");
   O2_DEFINE_CONFIGURABLE(cfgVtxZ, float, 10, "vertex cut (cm)");
+  struct : ConfigurableGroup {
+    Configurable<std::vector<float>> cfgVariationDCAxyNSigma{"cfgVariationDCAxyNSigma", std::vector<float>{}, "Cut on number of sigma deviations from expected DCAxy for each systematic variation (empty: nominal cut)"};
+    Configurable<std::vector<float>> cfgVariationNTPCCls{"cfgVariationNTPCCls", std::vector<float>{}, "Cut on number of TPC clusters found for each systematic variation (empty: nominal cut)"};
+    Configurable<std::vector<float>> cfgVariationNTPCXrows{"cfgVariationNTPCXrows", std::vector<float>{}, "Cut on number of TPC crossed rows for each systematic variation (empty: nominal cut)"};
+    Configurable<std::vector<float>> cfgVariationMinNITSCls{"cfgVariationMinNITSCls", std::vector<float>{}, "Cut on minimum number of ITS clusters found for each systematic variation (empty: nominal cut)"};
+  } cfgTrackCutVariations;
   struct : ConfigurableGroup {
     O2_DEFINE_CONFIGURABLE(cfgNoSameBunchPileupCut, bool, true, "kNoSameBunchPileupCut");
     O2_DEFINE_CONFIGURABLE(cfgIsGoodZvtxFT0vsPV, bool, true, "kIsGoodZvtxFT0vsPV");
@@ -168,6 +176,7 @@ struct FlowGenericFramework {
   OutputObj<FlowContainer> fFC{FlowContainer("FlowContainer")};
   OutputObj<FlowPtContainer> fFCpt{FlowPtContainer("FlowPtContainer")};
   OutputObj<FlowContainer> fFCgen{FlowContainer("FlowContainer_gen")};
+  OutputObj<TList> fFCVariations{"FlowContainerVariations", OutputObjHandlingPolicy::AnalysisObject};
   HistogramRegistry registry{"registry"};
 
   // QA outputs
@@ -241,6 +250,18 @@ struct FlowGenericFramework {
   GFW* fGFW = new GFW();
   std::vector<GFW::CorrConfig> corrconfigs;
 
+  // Systematic variations of the track cuts, filled in the same loop over the tracks as the nominal GFW
+  struct TrackCuts {
+    float dcaXYNSigma;
+    float nTPCCls;
+    float nTPCXrows;
+    float minNITSCls;
+  };
+  static constexpr size_t MaxTrackCutVariations = 32;
+  std::vector<TrackCuts> variationCuts;
+  std::vector<GFW*> fGFWVariations;
+  std::vector<FlowContainer*> fFCVariationContainers;
+
   TRandom3* fRndm = new TRandom3(0);
   TAxis* fPtAxis;
   int lastRun = -1;
@@ -433,6 +454,7 @@ struct FlowGenericFramework {
       fFCgen->SetXAxis(fPtAxis);
       fFCgen->Initialize(oba, multAxis, cfgNbootstrap);
     }
+    initTrackCutVariations(oba, multAxis, ptbins);
     delete oba;
     fFCpt->setUseCentralMoments(cfgUseCentralMoments);
     fFCpt->setUseGapMethod(cfgUseGapMethod);
@@ -698,12 +720,69 @@ struct FlowGenericFramework {
     return true;
   }
 
+  void initTrackCutVariations(TObjArray* oba, const AxisSpec& multAxis, int ptbins)
+  {
+    fFCVariations.setObject(new TList());
+    fFCVariations->SetOwner(kTRUE);
+    if (!doprocessData && !doprocessRun2 && !doprocessMCReco)
+      return;
+    const std::vector<float>* variationValues[] = {&cfgTrackCutVariations.cfgVariationDCAxyNSigma.value, &cfgTrackCutVariations.cfgVariationNTPCCls.value, &cfgTrackCutVariations.cfgVariationNTPCXrows.value, &cfgTrackCutVariations.cfgVariationMinNITSCls.value};
+    size_t nVariations = 0;
+    for (const auto* values : variationValues)
+      nVariations = std::max(nVariations, values->size());
+    if (nVariations == 0)
+      return;
+    for (const auto* values : variationValues) {
+      if (!values->empty() && values->size() != nVariations)
+        LOGF(fatal, "Track cut variations have vectors of different size - check the cfgTrackCutVariations configurables");
+    }
+    if (nVariations > MaxTrackCutVariations)
+      LOGF(fatal, "%zu track cut variations requested, at most %zu are supported", nVariations, MaxTrackCutVariations);
+    auto variationValue = [&](const std::vector<float>& values, size_t i, float nominal) { return values.empty() ? nominal : values[i]; };
+    for (size_t i = 0; i < nVariations; ++i) {
+      variationCuts.push_back({variationValue(cfgTrackCutVariations.cfgVariationDCAxyNSigma.value, i, cfgDCAxyNSigma),
+                               variationValue(cfgTrackCutVariations.cfgVariationNTPCCls.value, i, cfgNTPCCls),
+                               variationValue(cfgTrackCutVariations.cfgVariationNTPCXrows.value, i, cfgNTPCXrows),
+                               variationValue(cfgTrackCutVariations.cfgVariationMinNITSCls.value, i, cfgMinNITSCls)});
+      GFW* gfw = new GFW();
+      for (auto j(0); j < o2::analysis::gfw::regions.GetSize(); ++j) {
+        gfw->AddRegion(o2::analysis::gfw::regions.GetNames()[j], o2::analysis::gfw::regions.GetEtaMin()[j], o2::analysis::gfw::regions.GetEtaMax()[j], (o2::analysis::gfw::regions.GetpTDifs()[j]) ? ptbins + 1 : 1, o2::analysis::gfw::regions.GetBitmasks()[j]);
+      }
+      gfw->CreateRegions();
+      fGFWVariations.push_back(gfw);
+      FlowContainer* fc = new FlowContainer(Form("FlowContainer_var%zu", i));
+      fc->SetXAxis(fPtAxis);
+      fc->Initialize(oba, multAxis, cfgNbootstrap);
+      fFCVariations->Add(fc);
+      fFCVariationContainers.push_back(fc);
+      LOGF(info, "Track cut variation %zu: DCAxy %.2f sigma, %.0f TPC clusters, %.0f TPC crossed rows, %.0f ITS clusters", i, variationCuts[i].dcaXYNSigma, variationCuts[i].nTPCCls, variationCuts[i].nTPCXrows, variationCuts[i].minNITSCls);
+    }
+  }
+
   template <typename TTrack>
   bool trackSelected(TTrack track)
   {
-    if (cfgDCAxyNSigma && (std::fabs(track.dcaXY()) > cfgDCAxyNSigma / 7. * (0.0105f + 0.0035f / track.pt())))
+    return trackSelected(track, TrackCuts{cfgDCAxyNSigma, cfgNTPCCls, cfgNTPCXrows, cfgMinNITSCls});
+  }
+
+  template <typename TTrack>
+  bool trackSelected(TTrack track, const TrackCuts& cuts)
+  {
+    if (cuts.dcaXYNSigma && (std::fabs(track.dcaXY()) > cuts.dcaXYNSigma / 7. * (0.0105f + 0.0035f / track.pt())))
       return false;
-    return ((track.tpcNClsCrossedRows() >= cfgNTPCXrows) && (track.tpcNClsFound() >= cfgNTPCCls) && (track.itsNCls() >= cfgMinNITSCls));
+    return ((track.tpcNClsCrossedRows() >= cuts.nTPCXrows) && (track.tpcNClsFound() >= cuts.nTPCCls) && (track.itsNCls() >= cuts.minNITSCls));
+  }
+
+  // Bit i is set if the track passes the cuts of the i-th systematic variation
+  template <typename TTrack>
+  uint32_t trackCutVariationsSelected(TTrack track)
+  {
+    uint32_t mask = 0;
+    for (size_t i = 0; i < variationCuts.size(); ++i) {
+      if (trackSelected(track, variationCuts[i]))
+        mask |= (1u << i);
+    }
+    return mask;
   }
 
   template <typename TTrack>
@@ -831,6 +910,10 @@ struct FlowGenericFramework {
           (dt == kGen) ? fFCgen->FillProfile(Form("%s_pt_%i", corrconfigs.at(l_ind).Head.c_str(), i), centmult, val, dnx, rndm) : fFC->FillProfile(Form("%s_pt_%i", corrconfigs.at(l_ind).Head.c_str(), i), centmult, val, dnx, rndm);
       }
     }
+    if (dt != kGen) {
+      for (size_t v = 0; v < fGFWVariations.size(); ++v)
+        fillVariationContainer(fGFWVariations[v], fFCVariationContainers[v], centmult, rndm);
+    }
 
     // Only consider events where mean pt can be calculated
     if (fFCpt->corrDen[1] != 0) {
@@ -845,6 +928,29 @@ struct FlowGenericFramework {
     return;
   }
 
+  void fillVariationContainer(GFW* gfw, FlowContainer* fc, const float& centmult, const double& rndm)
+  {
+    for (uint l_ind = 0; l_ind < corrconfigs.size(); ++l_ind) {
+      if (!corrconfigs.at(l_ind).pTDif) {
+        auto dnx = gfw->Calculate(corrconfigs.at(l_ind), 0, kTRUE).real();
+        if (dnx == 0)
+          continue;
+        auto val = gfw->Calculate(corrconfigs.at(l_ind), 0, kFALSE).real() / dnx;
+        if (std::abs(val) < 1)
+          fc->FillProfile(corrconfigs.at(l_ind).Head.c_str(), centmult, val, dnx, rndm);
+        continue;
+      }
+      for (int i = 1; i <= fPtAxis->GetNbins(); i++) {
+        auto dnx = gfw->Calculate(corrconfigs.at(l_ind), i - 1, kTRUE).real();
+        if (dnx == 0)
+          continue;
+        auto val = gfw->Calculate(corrconfigs.at(l_ind), i - 1, kFALSE).real() / dnx;
+        if (std::abs(val) < 1)
+          fc->FillProfile(Form("%s_pt_%i", corrconfigs.at(l_ind).Head.c_str(), i), centmult, val, dnx, rndm);
+      }
+    }
+  }
+
   template <DataType dt, typename TCollision, typename TTracks>
   void processCollision(TCollision collision, TTracks tracks, const float& centrality, const int& run)
   {
@@ -864,6 +970,8 @@ struct FlowGenericFramework {
       th1sList[run][hCent]->Fill(centrality);
     }
     fGFW->Clear();
+    for (auto* gfw : fGFWVariations)
+      gfw->Clear();
     fFCpt->clearVector();
     event_pt_spectrum->Reset();
     float lRandom = fRndm->Rndm();
@@ -959,7 +1067,9 @@ struct FlowGenericFramework {
       acceptedTracks.corrected += getEfficiency(track);
       ++acceptedTracks.uncorrected;
 
-      if (!trackSelected(track))
+      bool nominalSelected = trackSelected(track);
+      uint32_t variationMask = trackCutVariationsSelected(track);
+      if (!nominalSelected && !variationMask)
         return;
 
       int pidIndex = 0;
@@ -973,11 +1083,15 @@ struct FlowGenericFramework {
       }
 
       if (cfgFillWeights) {
-        fillWeights(mcParticle, vtxz, 0, run);
+        if (nominalSelected)
+          fillWeights(mcParticle, vtxz, 0, run);
       } else {
-        fillPtSums<kReco>(track, vtxz);
-        fillGFW<kReco>(mcParticle, vtxz, pidIndex, densitycorrections);
+        if (nominalSelected)
+          fillPtSums<kReco>(track, vtxz);
+        fillGFW<kReco>(mcParticle, vtxz, pidIndex, densitycorrections, nominalSelected, variationMask);
       }
+      if (!nominalSelected)
+        return;
 
       if (cfgFillQA) {
         fillTrackQA<kReco, kAfter>(track, vtxz);
@@ -1023,7 +1137,9 @@ struct FlowGenericFramework {
       acceptedTracks.corrected += getEfficiency(track);
       ++acceptedTracks.uncorrected;
 
-      if (!trackSelected(track))
+      bool nominalSelected = trackSelected(track);
+      uint32_t variationMask = trackCutVariationsSelected(track);
+      if (!nominalSelected && !variationMask)
         return;
 
       int pidIndex = 0;
@@ -1033,12 +1149,17 @@ struct FlowGenericFramework {
         pidIndex = 0;
       }
       if (cfgFillWeights) {
-        fillWeights(track, vtxz, pidIndex, run);
+        if (nominalSelected)
+          fillWeights(track, vtxz, pidIndex, run);
       } else {
-        fillPtSums<kReco>(track, vtxz);
-        fillGFW<kReco>(track, vtxz, pidIndex, densitycorrections);
-        event_pt_spectrum->Fill(track.pt(), (cfgUseNchCorrection == 1) ? getEfficiency(track) : 1.);
+        if (nominalSelected) {
+          fillPtSums<kReco>(track, vtxz);
+          event_pt_spectrum->Fill(track.pt(), (cfgUseNchCorrection == 1) ? getEfficiency(track) : 1.);
+        }
+        fillGFW<kReco>(track, vtxz, pidIndex, densitycorrections, nominalSelected, variationMask);
       }
+      if (!nominalSelected)
+        return;
       if (cfgFillQA) {
         fillTrackQA<kReco, kAfter>(track, vtxz);
         if (cfgRunByRun) {
@@ -1068,8 +1189,16 @@ struct FlowGenericFramework {
   }
 
   template <DataType dt, typename TTrack>
-  inline void fillGFW(TTrack track, const double& vtxz, int pid_index, DensityCorr densitycorrections)
+  inline void fillGFW(TTrack track, const double& vtxz, int pid_index, DensityCorr densitycorrections, bool fillNominal = true, uint32_t variationMask = 0)
   {
+    // Fills the nominal GFW and the GFWs of the systematic variations passed by the track
+    const int ptBin = fPtAxis->FindBin(track.pt()) - 1;
+    auto fillRegions = [&](double weight, int mask) {
+      if (fillNominal)
+        fGFW->Fill(track.eta(), ptBin, track.phi(), weight, mask);
+      for (uint32_t variations = variationMask; variations; variations &= variations - 1)
+        fGFWVariations[std::countr_zero(variations)]->Fill(track.eta(), ptBin, track.phi(), weight, mask);
+    };
     if (cfgUsePID) { // Analysing POI flow with id'ed particles
       double ptmins[] = {o2::analysis::gfw::ptpoilow, o2::analysis::gfw::ptpoilow, 0.3, 0.5};
       double ptmaxs[] = {o2::analysis::gfw::ptpoiup, o2::analysis::gfw::ptpoiup, 6.0, 6.0};
@@ -1084,15 +1213,15 @@ struct FlowGenericFramework {
       if (withinPtRef && withinPtPOI && pid_index)
         waccRef = waccPOI; // if particle is both (then it's overlap), override ref with POI
       if (withinPtRef)
-        fGFW->Fill(track.eta(), fPtAxis->FindBin(track.pt()) - 1, track.phi(), waccRef, 1);
+        fillRegions(waccRef, 1);
       if (withinPtPOI && pid_index)
-        fGFW->Fill(track.eta(), fPtAxis->FindBin(track.pt()) - 1, track.phi(), waccPOI, (1 << (pid_index + 1)));
+        fillRegions(waccPOI, (1 << (pid_index + 1)));
       if (withinPtNch)
-        fGFW->Fill(track.eta(), fPtAxis->FindBin(track.pt()) - 1, track.phi(), waccPOI, 2);
+        fillRegions(waccPOI, 2);
       if (withinPtPOI && withinPtRef && pid_index)
-        fGFW->Fill(track.eta(), fPtAxis->FindBin(track.pt()) - 1, track.phi(), waccPOI, (1 << (pid_index + 5)));
+        fillRegions(waccPOI, (1 << (pid_index + 5)));
       if (withinPtNch && withinPtRef)
-        fGFW->Fill(track.eta(), fPtAxis->FindBin(track.pt()) - 1, track.phi(), waccPOI, 32);
+        fillRegions(waccPOI, 32);
     } else { // Analysing only integrated flow
       bool withinPtRef = (track.pt() > o2::analysis::gfw::ptreflow && track.pt() < o2::analysis::gfw::ptrefup);
       bool withinPtPOI = (track.pt() > o2::analysis::gfw::ptpoilow && track.pt() < o2::analysis::gfw::ptpoiup);
@@ -1115,11 +1244,11 @@ struct FlowGenericFramework {
       }
       double wacc = (dt == kGen) ? 1. : getAcceptance(track, vtxz, 0);
       if (withinPtRef)
-        fGFW->Fill(track.eta(), fPtAxis->FindBin(track.pt()) - 1, track.phi(), weff * wacc, 1);
+        fillRegions(weff * wacc, 1);
       if (withinPtPOI)
-        fGFW->Fill(track.eta(), fPtAxis->FindBin(track.pt()) - 1, track.phi(), weff * wacc, 2);
+        fillRegions(weff * wacc, 2);
       if (withinPtRef && withinPtPOI)
-        fGFW->Fill(track.eta(), fPtAxis->FindBin(track.pt()) - 1, track.phi(), weff * wacc, 4);
+        fillRegions(weff * wacc, 4);
     }
     return;
   }
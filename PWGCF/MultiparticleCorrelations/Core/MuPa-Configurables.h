@@ -213,6 +213,7 @@ struct : ConfigurableGroup {
   Configurable<std::string> cfFileWithLabels{"cfFileWithLabels", "/home/abilandz/DatasetsO2/labels.root", "path to external ROOT file which specifies all labels"}; // for AliEn file prepend "/alice/cern.ch/", for CCDB prepend "/alice-ccdb.cern.ch"
   Configurable<bool> cfUseDefaultLabels{"cfUseDefaultLabels", false, "use default internally hardwired labels, only for testing purposes"};
   Configurable<std::string> cfWhichDefaultLabels{"cfWhichDefaultLabels", "standard", "only for testing purposes, select one set of default labels, see GetDefaultObjArrayWithLabels for supported options"};
+  Configurable<int> cfNumberOfThreadsKine{"cfNumberOfThreadsKine", 1, "number of threads evaluating concurrently Test0 correlators in kine bins (1 = serial, using legacy TComplex code)"};
 } cf_t0;
 
 // *) Eta separation:
@@ -120,10 +120,13 @@ struct EventByEventQuantities {
 // *) Particle-by-particle quantities:
 //    Remark: Here I define all particle quantities, that I need across several member functions.
 struct ParticleByParticleQuantities {
-  double fPhi = 0.;      // azimuthal angle
-  double fPt = 0.;       // transverse momentum
-  double fEta = 0.;      // pseudorapidity
-  double fCharge = -44.; // particle charge. Yes, never initialize charge to 0.
+  double fPhi = 0.;                                                      // azimuthal angle
+  double fPt = 0.;                                                       // transverse momentum
+  double fEta = 0.;                                                      // pseudorapidity
+  double fCharge = -44.;                                                 // particle charge. Yes, never initialize charge to 0.
+  std::complex<double> fPhiHarmonics[gMaxHarmonic * gMaxCorrelator + 1]; // exp(i*h*phi) of current particle, calculated by recursion only once, and used for all integrated and differential Q-vectors
+  double fDiffWeights[eDiffWeightCategory_N] = {1.};                     // differential weights of current particle, looked up only once, see DiffWeight(...)
+  bool fDiffWeightsLookedUp[eDiffWeightCategory_N] = {false};            // have particle weights in the array above already been looked up for current particle?
 } pbyp;
 
 // *) QA:
@@ -423,6 +426,12 @@ struct Test0 {
   TString fFileWithLabels = "";                                                       // path to external ROOT file which specifies all labels of interest
   bool fUseDefaultLabels = false;                                                     // use default labels hardwired in GetDefaultObjArrayWithLabels(), the choice is made with cfWhichDefaultLabels
   TString fWhichDefaultLabels = "";                                                   // only for testing purposes, select one set of default labels, see GetDefaultObjArrayWithLabels for supported options
+  int fTest0Harmonics[gMaxCorrelator][gMaxIndex][gMaxCorrelator] = {{{0}}};           //! harmonics extracted only once from fTest0Labels, see Test0Harmonics(...)
+  bool fTest0HarmonicsExtracted[gMaxCorrelator][gMaxIndex] = {{false}};               //! whether harmonics were already extracted from fTest0Labels[mo][mi]
+  int fNumberOfThreadsKine = 1;                                                       // number of threads evaluating concurrently Test0 correlators in kine bins, see EvaluateKineTest0Correlators(...)
+  int fKineTest0Index[gMaxCorrelator][gMaxIndex] = {{0}};                             //! index of correlator [mo][mi] in fKineTest0Correlations, -1 if not requested
+  std::vector<double> fKineTest0Correlations;                                         //! [kine bin][requested correlator] unnormalized correlators, evaluated in EvaluateKineTest0Correlators(...)
+  std::vector<double> fKineTest0Weights;                                              //! [kine bin][order] event weights, evaluated in EvaluateKineTest0Correlators(...)
 } t0;                                                                                 // "t0" labels an instance of this group of histograms
 
 // *) Eta separations:
@@ -623,6 +623,10 @@ void defaultConfiguration()
     t0.fFileWithLabels = TString(cf_t0.cfFileWithLabels);
     t0.fUseDefaultLabels = cf_t0.cfUseDefaultLabels;
     t0.fWhichDefaultLabels = TString(cf_t0.cfWhichDefaultLabels);
+    t0.fNumberOfThreadsKine = cf_t0.cfNumberOfThreadsKine;
+    if (t0.fNumberOfThreadsKine < 1) {
+      LOGF(fatal, "\033[1;31m%s at line %d : t0.fNumberOfThreadsKine = %d, it has to be at least 1 \n \033[0m", __FUNCTION__, __LINE__, t0.fNumberOfThreadsKine);
+    }
   }
 
   // *) Particle weights:
@@ -7157,6 +7161,9 @@ void InternalValidation()
         }
       } // if (ph.fFillParticleHistograms || ph.fFillParticleHistograms2D)
 
+      // *) Quantities of this particle, used for all Q-vectors below:
+      this->PrepareParticleKernel();
+
       // Remark: Keep in sync all calls and flags below with the ones in MainLoopOverParticles().
       // *) Integrated Q-vectors:
       if (qv.fCalculateQvectors || es.fCalculateEtaSeparations) {
@@ -11953,7 +11960,9 @@ void CalculateTest0()
   // b) Calculate correlations:
   double correlation = 0.; // still has to be divided with 'weight' later, to get average correlation
   double weight = 0.;
-  int n[gMaxCorrelator] = {0}; // array holding harmonics
+  int n[gMaxCorrelator] = {0};                 // array holding harmonics
+  double weightPerOrder[gMaxCorrelator] = {0.}; // event weights, reused for all correlators of the same order
+  bool weightEvaluated[gMaxCorrelator] = {false};
 
   for (int mo = 0; mo < gMaxCorrelator; mo++) {
     for (int mi = 0; mi < gMaxIndex; mi++) {
@@ -11971,14 +11980,10 @@ void CalculateTest0()
       } // if(!t0_afTest0Labels[mo][mi])
 
       if (t0.fTest0Labels[mo][mi]) {
-        // Extract harmonics from TString, FS is " ":
+        // Extract harmonics from TString, FS is " " (this is done only once, see Test0Harmonics(...)):
+        const int* test0Harmonics = Test0Harmonics(mo, mi);
         for (int h = 0; h <= mo; h++) {
-          TObjArray* oa = t0.fTest0Labels[mo][mi]->Tokenize(" ");
-          if (!oa) {
-            LOGF(fatal, "\033[1;31m%s at line %d\033[0m", __FUNCTION__, __LINE__);
-          }
-          n[h] = TString(oa->At(h)->GetName()).Atoi();
-          delete oa; // yes, otherwise it's a memory leak
+          n[h] = test0Harmonics[h];
         }
 
         switch (mo + 1) // which order? yes, mo+1
@@ -11988,7 +11993,11 @@ void CalculateTest0()
               return;
             }
             correlation = One(n[0]).Re();
-            weight = One(0).Re();
+            if (!weightEvaluated[mo]) { // event weight depends only on the order, so it is evaluated only once per order
+              weightPerOrder[mo] = One(0).Re();
+              weightEvaluated[mo] = true;
+            }
+            weight = weightPerOrder[mo];
             break;
 
           case 2:
@@ -11996,7 +12005,11 @@ void CalculateTest0()
               return;
             }
             correlation = Two(n[0], n[1]).Re();
-            weight = Two(0, 0).Re();
+            if (!weightEvaluated[mo]) { // event weight depends only on the order, so it is evaluated only once per order
+              weightPerOrder[mo] = Two(0, 0).Re();
+              weightEvaluated[mo] = true;
+            }
+            weight = weightPerOrder[mo];
             break;
 
           case 3:
@@ -12004,7 +12017,11 @@ void CalculateTest0()
               return;
             }
             correlation = Three(n[0], n[1], n[2]).Re();
-            weight = Three(0, 0, 0).Re();
+            if (!weightEvaluated[mo]) { // event weight depends only on the order, so it is evaluated only once per order
+              weightPerOrder[mo] = Three(0, 0, 0).Re();
+              weightEvaluated[mo] = true;
+            }
+            weight = weightPerOrder[mo];
             break;
 
           case 4:
@@ -12012,7 +12029,11 @@ void CalculateTest0()
               return;
             }
             correlation = Four(n[0], n[1], n[2], n[3]).Re();
-            weight = Four(0, 0, 0, 0).Re();
+            if (!weightEvaluated[mo]) { // event weight depends only on the order, so it is evaluated only once per order
+              weightPerOrder[mo] = Four(0, 0, 0, 0).Re();
+              weightEvaluated[mo] = true;
+            }
+            weight = weightPerOrder[mo];
             break;
 
           case 5:
@@ -12020,7 +12041,11 @@ void CalculateTest0()
               return;
             }
             correlation = Five(n[0], n[1], n[2], n[3], n[4]).Re();
-            weight = Five(0, 0, 0, 0, 0).Re();
+            if (!weightEvaluated[mo]) { // event weight depends only on the order, so it is evaluated only once per order
+              weightPerOrder[mo] = Five(0, 0, 0, 0, 0).Re();
+              weightEvaluated[mo] = true;
+            }
+            weight = weightPerOrder[mo];
             break;
 
           case 6:
@@ -12028,7 +12053,11 @@ void CalculateTest0()
               return;
             }
             correlation = Six(n[0], n[1], n[2], n[3], n[4], n[5]).Re();
-            weight = Six(0, 0, 0, 0, 0, 0).Re();
+            if (!weightEvaluated[mo]) { // event weight depends only on the order, so it is evaluated only once per order
+              weightPerOrder[mo] = Six(0, 0, 0, 0, 0, 0).Re();
+              weightEvaluated[mo] = true;
+            }
+            weight = weightPerOrder[mo];
             break;
 
           case 7:
@@ -12036,7 +12065,11 @@ void CalculateTest0()
               return;
             }
             correlation = Seven(n[0], n[1], n[2], n[3], n[4], n[5], n[6]).Re();
-            weight = Seven(0, 0, 0, 0, 0, 0, 0).Re();
+            if (!weightEvaluated[mo]) { // event weight depends only on the order, so it is evaluated only once per order
+              weightPerOrder[mo] = Seven(0, 0, 0, 0, 0, 0, 0).Re();
+              weightEvaluated[mo] = true;
+            }
+            weight = weightPerOrder[mo];
             break;
 
           case 8:
@@ -12044,7 +12077,11 @@ void CalculateTest0()
               return;
             }
             correlation = Eight(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7]).Re();
-            weight = Eight(0, 0, 0, 0, 0, 0, 0, 0).Re();
+            if (!weightEvaluated[mo]) { // event weight depends only on the order, so it is evaluated only once per order
+              weightPerOrder[mo] = Eight(0, 0, 0, 0, 0, 0, 0, 0).Re();
+              weightEvaluated[mo] = true;
+            }
+            weight = weightPerOrder[mo];
             break;
 
           case 9:
@@ -12052,7 +12089,11 @@ void CalculateTest0()
               return;
             }
             correlation = Nine(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7], n[8]).Re();
-            weight = Nine(0, 0, 0, 0, 0, 0, 0, 0, 0).Re();
+            if (!weightEvaluated[mo]) { // event weight depends only on the order, so it is evaluated only once per order
+              weightPerOrder[mo] = Nine(0, 0, 0, 0, 0, 0, 0, 0, 0).Re();
+              weightEvaluated[mo] = true;
+            }
+            weight = weightPerOrder[mo];
             break;
 
           case 10:
@@ -12060,7 +12101,11 @@ void CalculateTest0()
               return;
             }
             correlation = Ten(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7], n[8], n[9]).Re();
-            weight = Ten(0, 0, 0, 0, 0, 0, 0, 0, 0, 0).Re();
+            if (!weightEvaluated[mo]) { // event weight depends only on the order, so it is evaluated only once per order
+              weightPerOrder[mo] = Ten(0, 0, 0, 0, 0, 0, 0, 0, 0, 0).Re();
+              weightEvaluated[mo] = true;
+            }
+            weight = weightPerOrder[mo];
             break;
 
           case 11:
@@ -12068,7 +12113,11 @@ void CalculateTest0()
               return;
             }
             correlation = Eleven(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7], n[8], n[9], n[10]).Re();
-            weight = Eleven(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0).Re();
+            if (!weightEvaluated[mo]) { // event weight depends only on the order, so it is evaluated only once per order
+              weightPerOrder[mo] = Eleven(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0).Re();
+              weightEvaluated[mo] = true;
+            }
+            weight = weightPerOrder[mo];
             break;
 
           case 12:
@@ -12076,7 +12125,11 @@ void CalculateTest0()
               return;
             }
             correlation = Twelve(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7], n[8], n[9], n[10], n[11]).Re();
-            weight = Twelve(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0).Re();
+            if (!weightEvaluated[mo]) { // event weight depends only on the order, so it is evaluated only once per order
+              weightPerOrder[mo] = Twelve(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0).Re();
+              weightEvaluated[mo] = true;
+            }
+            weight = weightPerOrder[mo];
             break;
 
           default:
@@ -12488,6 +12541,13 @@ void CalculateKineTest0Ndim(eqvectorKine kineVarChoice, int Ndim)
 
   } // switch (Ndim)
 
+  // *) If requested, evaluate concurrently all Test0 correlators in all kine bins, which are then only used below for filling:
+  bool useKineEngine = (t0.fNumberOfThreadsKine > 1);
+  int nRequested = 0;
+  if (useKineEngine) {
+    nRequested = EvaluateKineTest0Correlators(kineVarChoice, nBins);
+  }
+
   // *) Uniform loop over linearized global bins for all kine variables:
   for (int b = 0; b < nBins; b++) { // yes, "< nBins", not "<= nBins", because b runs over all regular bins + 2 (therefore, including underflow and overflow already)
 
@@ -12538,92 +12598,142 @@ void CalculateKineTest0Ndim(eqvectorKine kineVarChoice, int Ndim)
     // *) Okay, let's do transparently the differential calculus, whether it's 1D, 2D, 3D, ...:
     double correlation = 0.;
     double weight = 0.;
-    int n[gMaxCorrelator] = {0}; // array holding harmonics
+    int n[gMaxCorrelator] = {0};                 // array holding harmonics
+    double weightPerOrder[gMaxCorrelator] = {0.}; // event weights, reused for all correlators of the same order
+    bool weightEvaluated[gMaxCorrelator] = {false};
 
     for (int mo = 0; mo < gMaxCorrelator; mo++) {
       for (int mi = 0; mi < gMaxIndex; mi++) {
         // TBI 20240221 I do not have to loop each time all the way up to gMaxCorrelator and gMaxIndex, but nevermind now, it's not a big efficiency loss.
         if (t0.fTest0Labels[mo][mi]) {
-          // Extract harmonics from TString, FS is " ":
+          // Extract harmonics from TString, FS is " " (this is done only once, see Test0Harmonics(...)):
+          const int* test0Harmonics = Test0Harmonics(mo, mi);
           for (int h = 0; h <= mo; h++) {
-            // cout<<Form("h = %d, t0.fTest0Labels[%d][%d] = ",h,mo,mi)<<t0.fTest0Labels[mo][mi]->Data()<<endl;
-            TObjArray* oa = t0.fTest0Labels[mo][mi]->Tokenize(" ");
-            if (!oa) {
-              LOGF(fatal, "\033[1;31m%s at line %d\033[0m", __FUNCTION__, __LINE__);
-            }
-            n[h] = TString(oa->At(h)->GetName()).Atoi();
-            delete oa; // yes, otherwise it's a memory leak
+            n[h] = test0Harmonics[h];
           }
 
           if (qv.fqvectorEntries[kineVarChoice][b] < mo + 1) {
             continue;
           }
 
-          switch (mo + 1) // which order? yes, mo+1
-          {
-            case 1:
-              correlation = One(n[0]).Re();
-              weight = One(0).Re();
-              break;
+          if (useKineEngine) {
+            correlation = t0.fKineTest0Correlations[b * nRequested + t0.fKineTest0Index[mo][mi]];
+            weight = t0.fKineTest0Weights[b * gMaxCorrelator + mo];
+          } else {
+            switch (mo + 1) // which order? yes, mo+1
+            {
+              case 1:
+                correlation = One(n[0]).Re();
+                if (!weightEvaluated[mo]) { // event weight depends only on the order, so it is evaluated only once per order
+                  weightPerOrder[mo] = One(0).Re();
+                  weightEvaluated[mo] = true;
+                }
+                weight = weightPerOrder[mo];
+                break;
 
-            case 2:
-              correlation = Two(n[0], n[1]).Re();
-              weight = Two(0, 0).Re();
-              break;
+              case 2:
+                correlation = Two(n[0], n[1]).Re();
+                if (!weightEvaluated[mo]) { // event weight depends only on the order, so it is evaluated only once per order
+                  weightPerOrder[mo] = Two(0, 0).Re();
+                  weightEvaluated[mo] = true;
+                }
+                weight = weightPerOrder[mo];
+                break;
 
-            case 3:
-              correlation = Three(n[0], n[1], n[2]).Re();
-              weight = Three(0, 0, 0).Re();
-              break;
+              case 3:
+                correlation = Three(n[0], n[1], n[2]).Re();
+                if (!weightEvaluated[mo]) { // event weight depends only on the order, so it is evaluated only once per order
+                  weightPerOrder[mo] = Three(0, 0, 0).Re();
+                  weightEvaluated[mo] = true;
+                }
+                weight = weightPerOrder[mo];
+                break;
 
-            case 4:
-              correlation = Four(n[0], n[1], n[2], n[3]).Re();
-              weight = Four(0, 0, 0, 0).Re();
-              break;
+              case 4:
+                correlation = Four(n[0], n[1], n[2], n[3]).Re();
+                if (!weightEvaluated[mo]) { // event weight depends only on the order, so it is evaluated only once per order
+                  weightPerOrder[mo] = Four(0, 0, 0, 0).Re();
+                  weightEvaluated[mo] = true;
+                }
+                weight = weightPerOrder[mo];
+                break;
 
-            case 5:
-              correlation = Five(n[0], n[1], n[2], n[3], n[4]).Re();
-              weight = Five(0, 0, 0, 0, 0).Re();
-              break;
+              case 5:
+                correlation = Five(n[0], n[1], n[2], n[3], n[4]).Re();
+                if (!weightEvaluated[mo]) { // event weight depends only on the order, so it is evaluated only once per order
+                  weightPerOrder[mo] = Five(0, 0, 0, 0, 0).Re();
+                  weightEvaluated[mo] = true;
+                }
+                weight = weightPerOrder[mo];
+                break;
 
-            case 6:
-              correlation = Six(n[0], n[1], n[2], n[3], n[4], n[5]).Re();
-              weight = Six(0, 0, 0, 0, 0, 0).Re();
-              break;
+              case 6:
+                correlation = Six(n[0], n[1], n[2], n[3], n[4], n[5]).Re();
+                if (!weightEvaluated[mo]) { // event weight depends only on the order, so it is evaluated only once per order
+                  weightPerOrder[mo] = Six(0, 0, 0, 0, 0, 0).Re();
+                  weightEvaluated[mo] = true;
+                }
+                weight = weightPerOrder[mo];
+                break;
 
-            case 7:
-              correlation = Seven(n[0], n[1], n[2], n[3], n[4], n[5], n[6]).Re();
-              weight = Seven(0, 0, 0, 0, 0, 0, 0).Re();
-              break;
+              case 7:
+                correlation = Seven(n[0], n[1], n[2], n[3], n[4], n[5], n[6]).Re();
+                if (!weightEvaluated[mo]) { // event weight depends only on the order, so it is evaluated only once per order
+                  weightPerOrder[mo] = Seven(0, 0, 0, 0, 0, 0, 0).Re();
+                  weightEvaluated[mo] = true;
+                }
+                weight = weightPerOrder[mo];
+                break;
 
-            case 8:
-              correlation = Eight(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7]).Re();
-              weight = Eight(0, 0, 0, 0, 0, 0, 0, 0).Re();
-              break;
+              case 8:
+                correlation = Eight(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7]).Re();
+                if (!weightEvaluated[mo]) { // event weight depends only on the order, so it is evaluated only once per order
+                  weightPerOrder[mo] = Eight(0, 0, 0, 0, 0, 0, 0, 0).Re();
+                  weightEvaluated[mo] = true;
+                }
+                weight = weightPerOrder[mo];
+                break;
 
-            case 9:
-              correlation = Nine(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7], n[8]).Re();
-              weight = Nine(0, 0, 0, 0, 0, 0, 0, 0, 0).Re();
-              break;
+              case 9:
+                correlation = Nine(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7], n[8]).Re();
+                if (!weightEvaluated[mo]) { // event weight depends only on the order, so it is evaluated only once per order
+                  weightPerOrder[mo] = Nine(0, 0, 0, 0, 0, 0, 0, 0, 0).Re();
+                  weightEvaluated[mo] = true;
+                }
+                weight = weightPerOrder[mo];
+                break;
 
-            case 10:
-              correlation = Ten(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7], n[8], n[9]).Re();
-              weight = Ten(0, 0, 0, 0, 0, 0, 0, 0, 0, 0).Re();
-              break;
+              case 10:
+                correlation = Ten(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7], n[8], n[9]).Re();
+                if (!weightEvaluated[mo]) { // event weight depends only on the order, so it is evaluated only once per order
+                  weightPerOrder[mo] = Ten(0, 0, 0, 0, 0, 0, 0, 0, 0, 0).Re();
+                  weightEvaluated[mo] = true;
+                }
+                weight = weightPerOrder[mo];
+                break;
 
-            case 11:
-              correlation = Eleven(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7], n[8], n[9], n[10]).Re();
-              weight = Eleven(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0).Re();
-              break;
+              case 11:
+                correlation = Eleven(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7], n[8], n[9], n[10]).Re();
+                if (!weightEvaluated[mo]) { // event weight depends only on the order, so it is evaluated only once per order
+                  weightPerOrder[mo] = Eleven(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0).Re();
+                  weightEvaluated[mo] = true;
+                }
+                weight = weightPerOrder[mo];
+                break;
 
-            case 12:
-              correlation = Twelve(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7], n[8], n[9], n[10], n[11]).Re();
-              weight = Twelve(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0).Re();
-              break;
+              case 12:
+                correlation = Twelve(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7], n[8], n[9], n[10], n[11]).Re();
+                if (!weightEvaluated[mo]) { // event weight depends only on the order, so it is evaluated only once per order
+                  weightPerOrder[mo] = Twelve(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0).Re();
+                  weightEvaluated[mo] = true;
+                }
+                weight = weightPerOrder[mo];
+                break;
 
-            default:
-              LOGF(fatal, "\033[1;31m%s at line %d : not supported yet: %s \n\n\033[0m", __FUNCTION__, __LINE__, t0.fTest0Labels[mo][mi]->Data());
-          } // switch(mo+1)
+              default:
+                LOGF(fatal, "\033[1;31m%s at line %d : not supported yet: %s \n\n\033[0m", __FUNCTION__, __LINE__, t0.fTest0Labels[mo][mi]->Data());
+            } // switch(mo+1)
+          } // if (useKineEngine)
 
           // *) e-b-e sanity check:
           if (nl.fCalculateKineCustomNestedLoops) {
@@ -13850,6 +13960,176 @@ TComplex Recursion(int n, int* harmonic, int mult = 1, int skip = 0)
 
 //============================================================
 
+std::complex<double> RecursionFlat(const std::complex<double>* q, int n, int* harmonic, int mult = 1, int skip = 0)
+{
+  // The same recursion as in Recursion(...), but for Q-vectors stored in contiguous array q, with layout [harmonic][weight power].
+
+  // Remarks:
+  //  1. It does not use any data member, so it can be called concurrently from different threads, each with its own q and harmonic arrays;
+  //  2. Q{-n,p} = Q{n,p}^* is used, like in Q(...).
+
+  const int nm1 = n - 1;
+  const int h = harmonic[nm1];
+  std::complex<double> c(h >= 0 ? q[h * (gMaxCorrelator + 1) + mult] : std::conj(q[-h * (gMaxCorrelator + 1) + mult]));
+  if (nm1 == 0)
+    return c;
+  c *= RecursionFlat(q, nm1, harmonic);
+  if (nm1 == skip)
+    return c;
+
+  int multp1 = mult + 1;
+  int nm2 = n - 2;
+  int counter1 = 0;
+  int hhold = harmonic[counter1];
+  harmonic[counter1] = harmonic[nm2];
+  harmonic[nm2] = hhold + harmonic[nm1];
+  std::complex<double> c2(RecursionFlat(q, nm1, harmonic, multp1, nm2));
+  int counter2 = n - 3;
+  while (counter2 >= skip) {
+    harmonic[nm2] = harmonic[counter1];
+    harmonic[counter1] = hhold;
+    ++counter1;
+    hhold = harmonic[counter1];
+    harmonic[counter1] = harmonic[nm2];
+    harmonic[nm2] = hhold + harmonic[nm1];
+    c2 += RecursionFlat(q, nm1, harmonic, multp1, counter2);
+    --counter2;
+  }
+  harmonic[nm2] = harmonic[counter1];
+  harmonic[counter1] = hhold;
+
+  if (mult == 1)
+    return c - c2;
+  return c - static_cast<double>(mult) * c2;
+
+} // std::complex<double> RecursionFlat(const std::complex<double>* q, int n, int* harmonic, int mult = 1, int skip = 0)
+
+//============================================================
+
+const int* Test0Harmonics(int mo, int mi)
+{
+  // Get harmonics of Test0 correlator [mo][mi] from its label. Labels are tokenized only the first time, afterwards cached harmonics are returned.
+
+  if (!t0.fTest0HarmonicsExtracted[mo][mi]) {
+    if (!t0.fTest0Labels[mo][mi]) {
+      LOGF(fatal, "\033[1;31m%s at line %d : t0.fTest0Labels[%d][%d] is NULL \033[0m", __FUNCTION__, __LINE__, mo, mi);
+    }
+    TObjArray* oa = t0.fTest0Labels[mo][mi]->Tokenize(" "); // FS is " "
+    if (!oa || oa->GetEntries() < mo + 1) {
+      LOGF(fatal, "\033[1;31m%s at line %d : cannot extract %d harmonics from label %s \033[0m", __FUNCTION__, __LINE__, mo + 1, t0.fTest0Labels[mo][mi]->Data());
+    }
+    for (int h = 0; h <= mo; h++) {
+      t0.fTest0Harmonics[mo][mi][h] = TString(oa->At(h)->GetName()).Atoi();
+    }
+    delete oa; // yes, otherwise it's a memory leak
+    t0.fTest0HarmonicsExtracted[mo][mi] = true;
+  }
+
+  return t0.fTest0Harmonics[mo][mi];
+
+} // const int* Test0Harmonics(int mo, int mi)
+
+//============================================================
+
+int EvaluateKineTest0Correlators(eqvectorKine kineVarChoice, int nBins)
+{
+  // Evaluate concurrently all requested Test0 correlators in all kine bins, from differential q-vectors.
+  // Returns the number of requested correlators, which is the stride of t0.fKineTest0Correlations.
+
+  // Remarks:
+  //  1. Each (kine bin, correlator) task is independent, so kine bins are split in t0.fNumberOfThreadsKine contiguous blocks, one block per thread;
+  //  2. In each kine bin, q-vector is copied into contiguous std::complex<double> array, and all correlators are evaluated with RecursionFlat(...), which is thread-safe;
+  //  3. Event weight depends only on the order, so it is evaluated only once per kine bin and per order, and then reused for all correlators of that order;
+  //  4. Nothing is filled here. Results are used in CalculateKineTest0Ndim(...), which fills serially all profiles, so the order and content of all fills is the same as in the serial case;
+  //  5. Kine bins which are skipped in CalculateKineTest0Ndim(...) (no entries, cut on multiplicity, too few particles for a given order) are also skipped here.
+
+  // a) Map all requested correlators [mo][mi] into contiguous index;
+  // b) Book flat buffers for the results;
+  // c) Evaluate concurrently all kine bins.
+
+  if (tc.fVerbose) {
+    StartFunction(__FUNCTION__);
+  }
+
+  // a) Map all requested correlators [mo][mi] into contiguous index:
+  std::vector<int> requested; // mo * gMaxIndex + mi
+  for (int mo = 0; mo < gMaxCorrelator; mo++) {
+    for (int mi = 0; mi < gMaxIndex; mi++) {
+      t0.fKineTest0Index[mo][mi] = -1;
+      if (t0.fTest0Labels[mo][mi]) {
+        Test0Harmonics(mo, mi); // yes, harmonics are extracted here serially, so that threads below only read them
+        t0.fKineTest0Index[mo][mi] = static_cast<int>(requested.size());
+        requested.push_back(mo * gMaxIndex + mi);
+      }
+    }
+  }
+  const int nRequested = static_cast<int>(requested.size());
+  if (nBins <= 0 || 0 == nRequested) {
+    if (tc.fVerbose) {
+      ExitFunction(__FUNCTION__);
+    }
+    return nRequested;
+  }
+
+  // b) Book flat buffers for the results:
+  t0.fKineTest0Correlations.assign(static_cast<size_t>(nBins) * nRequested, 0.);
+  t0.fKineTest0Weights.assign(static_cast<size_t>(nBins) * gMaxCorrelator, 0.);
+
+  // c) Evaluate concurrently all kine bins:
+  auto evaluateBins = [&](int bMin, int bMax) {
+    std::vector<std::complex<double>> q((gMaxHarmonic * gMaxCorrelator + 1) * (gMaxCorrelator + 1)); // contiguous q-vector, layout [harmonic][weight power]
+    int harmonic[gMaxCorrelator] = {0};                                                              // local copy, since recursion modifies it temporarily
+    for (int b = bMin; b < bMax; b++) {
+      const int nEntries = qv.fqvectorEntries[kineVarChoice][b];
+      if (0 == nEntries || nEntries < ec.fdEventCuts[eMultiplicity][eMin] || nEntries > ec.fdEventCuts[eMultiplicity][eMax] || std::abs(nEntries - ec.fdEventCuts[eMultiplicity][eMax]) < tc.fFloatingPointPrecision) {
+        continue; // the same conditions as in CalculateKineTest0Ndim(...)
+      }
+      for (int h = 0; h < gMaxHarmonic * gMaxCorrelator + 1; h++) {
+        std::copy(qv.fqvector[kineVarChoice][b][h].begin(), qv.fqvector[kineVarChoice][b][h].begin() + gMaxCorrelator + 1, q.begin() + h * (gMaxCorrelator + 1));
+      }
+      bool weightEvaluated[gMaxCorrelator] = {false};
+      for (int r = 0; r < nRequested; r++) {
+        const int mo = requested[r] / gMaxIndex;
+        const int mi = requested[r] % gMaxIndex;
+        if (nEntries < mo + 1) {
+          continue;
+        }
+        if (!weightEvaluated[mo]) {
+          for (int h = 0; h <= mo; h++) {
+            harmonic[h] = 0;
+          }
+          t0.fKineTest0Weights[static_cast<size_t>(b) * gMaxCorrelator + mo] = RecursionFlat(q.data(), mo + 1, harmonic).real();
+          weightEvaluated[mo] = true;
+        }
+        for (int h = 0; h <= mo; h++) {
+          harmonic[h] = t0.fTest0Harmonics[mo][mi][h];
+        }
+        t0.fKineTest0Correlations[static_cast<size_t>(b) * nRequested + r] = RecursionFlat(q.data(), mo + 1, harmonic).real();
+      } // for (int r = 0; r < nRequested; r++)
+    } // for (int b = bMin; b < bMax; b++)
+  };
+
+  const int nThreads = std::min(t0.fNumberOfThreadsKine, nBins);
+  const int nBinsPerThread = (nBins + nThreads - 1) / nThreads;
+  std::vector<std::thread> threads;
+  for (int t = 1; t < nThreads; t++) {
+    threads.emplace_back(evaluateBins, t * nBinsPerThread, std::min(nBins, (t + 1) * nBinsPerThread));
+  }
+  evaluateBins(0, std::min(nBins, nBinsPerThread)); // first block in this thread
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  if (tc.fVerbose) {
+    ExitFunction(__FUNCTION__);
+  }
+
+  return nRequested;
+
+} // int EvaluateKineTest0Correlators(eqvectorKine kineVarChoice, int nBins)
+
+//============================================================
+
 void ResetQ()
 {
   // Reset the components of generic Q-vectors. Use it whenever you call the
@@ -17968,6 +18248,67 @@ void FillQvector(const double& dPhi, const double& dPt, const double& dEta)
 
 //============================================================
 
+void PrepareParticleKernel()
+{
+  // Prepare all quantities of current particle, which are then used in all integrated and differential Q-vectors.
+  // Call this function only once for each particle, after pbyp.fPhi, pbyp.fPt, pbyp.fEta and pbyp.fCharge were set.
+
+  // a) Calculate exp(i*h*phi) for all harmonics by recursion, exp(i*h*phi) = exp(i*(h-1)*phi) * exp(i*phi), so that cos and sin are evaluated only once;
+  // b) Invalidate particle weights of previous particle.
+
+  if (tc.fVerboseForEachParticle) {
+    StartFunction(__FUNCTION__);
+  }
+
+  // a) Calculate exp(i*h*phi) for all harmonics by recursion:
+  const std::complex<double> phiHarmonic(std::cos(pbyp.fPhi), std::sin(pbyp.fPhi));
+  pbyp.fPhiHarmonics[0] = std::complex<double>(1., 0.);
+  for (int h = 1; h < gMaxHarmonic * gMaxCorrelator + 1; h++) {
+    pbyp.fPhiHarmonics[h] = pbyp.fPhiHarmonics[h - 1] * phiHarmonic;
+  }
+
+  // b) Invalidate particle weights of previous particle:
+  for (int dwc = 0; dwc < eDiffWeightCategory_N; dwc++) {
+    pbyp.fDiffWeightsLookedUp[dwc] = false;
+  }
+
+  if (tc.fVerboseForEachParticle) {
+    ExitFunction(__FUNCTION__);
+  }
+
+} // void PrepareParticleKernel()
+
+//============================================================
+
+double DiffWeight(eDiffWeightCategory dwc)
+{
+  // Differential multidimensional weight of current particle. It is looked up in sparse histogram only once per particle and per category,
+  // and then reused for integrated Q-vector and for all differential q-vectors, see PrepareParticleKernel().
+
+  if (!pbyp.fDiffWeightsLookedUp[dwc]) {
+    pbyp.fDiffWeights[dwc] = WeightFromSparse(dwc);
+    pbyp.fDiffWeightsLookedUp[dwc] = true;
+  }
+
+  return pbyp.fDiffWeights[dwc];
+
+} // double DiffWeight(eDiffWeightCategory dwc)
+
+//============================================================
+
+void WeightsToPowerP(const double& dWeight, double* wToPowerP)
+{
+  // Fill wToPowerP[wp] = dWeight^wp, for all weight powers wp = 0, ..., gMaxCorrelator, by recursion.
+
+  wToPowerP[0] = 1.;
+  for (int wp = 1; wp < gMaxCorrelator + 1; wp++) {
+    wToPowerP[wp] = wToPowerP[wp - 1] * dWeight;
+  }
+
+} // void WeightsToPowerP(const double& dWeight, double* wToPowerP)
+
+//============================================================
+
 void FillQvectorFromSparse()
 {
   // Fill integrated Q-vector using sparse histograms.
@@ -17982,14 +18323,13 @@ void FillQvectorFromSparse()
 
   // Particle weights from sparse histograms:
   // Remark: Keep in sync with corresponding implementation in Fillqvectors()
-  double wPhi = 1.;      // differential multidimensional phi weight, its dimensions are defined via enum eDiffPhiWeights
-  double wPt = 1.;       // differential multidimensional pt weight, its dimensions are defined via enum eDiffPtWeights
-  double wEta = 1.;      // differential multidimensional eta weight, its dimensions are defined via enum eDiffEtaWeights
-  double wToPowerP = 1.; // weight raised to power p
+  double wPhi = 1.; // differential multidimensional phi weight, its dimensions are defined via enum eDiffPhiWeights
+  double wPt = 1.;  // differential multidimensional pt weight, its dimensions are defined via enum eDiffPtWeights
+  double wEta = 1.; // differential multidimensional eta weight, its dimensions are defined via enum eDiffEtaWeights
 
   // *) Multidimensional phi weights:
   if (pw.fUseDiffPhiWeights[wPhiPhiAxis]) { // yes, 0th axis serves as a common boolean for this category
-    wPhi = WeightFromSparse(eDWPhi);
+    wPhi = DiffWeight(eDWPhi);
     if (!(wPhi > 0.)) {
       LOGF(error, "\033[1;33m%s wPhi is not positive\033[0m", __FUNCTION__);
       LOGF(error, "pbyp.fPhi = %f", pbyp.fPhi);
@@ -18014,7 +18354,7 @@ void FillQvectorFromSparse()
 
   // *) Multidimensional pt weights:
   if (pw.fUseDiffPtWeights[wPtPtAxis]) { // yes, 0th axis serves as a common boolean for this category
-    wPt = WeightFromSparse(eDWPt);
+    wPt = DiffWeight(eDWPt);
     if (!(wPt > 0.)) {
       LOGF(error, "\033[1;33m%s wPt is not positive\033[0m", __FUNCTION__);
       LOGF(error, "pbyp.fPt = %f", pbyp.fPt);
@@ -18030,7 +18370,7 @@ void FillQvectorFromSparse()
 
   // *) Multidimensional eta weights:
   if (pw.fUseDiffEtaWeights[wEtaEtaAxis]) { // yes, 0th axis serves as a common boolean for this category
-    wEta = WeightFromSparse(eDWEta);
+    wEta = DiffWeight(eDWEta);
     if (!(wEta > 0.)) {
       LOGF(error, "\033[1;33m%s wEta is not positive\033[0m", __FUNCTION__);
       LOGF(error, "pbyp.fEta = %f", pbyp.fEta);
@@ -18045,16 +18385,18 @@ void FillQvectorFromSparse()
   } // if(pw.fUseDiffEtaWeights[wEtaEtaAxis])
 
   if (qv.fCalculateQvectors) {
+    double wToPowerP[gMaxCorrelator + 1] = {1.}; // weight raised to power p, for all p
+    WeightsToPowerP(wPhi * wPt * wEta, wToPowerP);
     for (int h = 0; h < gMaxHarmonic * gMaxCorrelator + 1; h++) {
-      for (int wp = 0; wp < gMaxCorrelator + 1; wp++) { // weight power
+      const std::complex<double>& phiHarmonic = pbyp.fPhiHarmonics[h]; // exp(i*h*phi), see PrepareParticleKernel()
+      for (int wp = 0; wp < gMaxCorrelator + 1; wp++) {                // weight power
         if (pw.fUseDiffPhiWeights[wPhiPhiAxis] || pw.fUseDiffPtWeights[wPtPtAxis] || pw.fUseDiffEtaWeights[wEtaEtaAxis]) {
-          wToPowerP = std::pow(wPhi * wPt * wEta, wp);
-          qv.fQvector[h][wp] += TComplex(wToPowerP * std::cos(h * pbyp.fPhi), wToPowerP * std::sin(h * pbyp.fPhi)); // Q-vector with weights, legacy code (TBI 20251027 remove this line)
-          // qv.fQvector[h][wp] += std::complex<double>(wToPowerP * std::cos(h * pbyp.fPhi), wToPowerP * std::sin(h * pbyp.fPhi)); // Q-vector with weights, new code
+          qv.fQvector[h][wp] += TComplex(wToPowerP[wp] * phiHarmonic.real(), wToPowerP[wp] * phiHarmonic.imag()); // Q-vector with weights, legacy code (TBI 20251027 remove this line)
+          // qv.fQvector[h][wp] += wToPowerP[wp] * phiHarmonic; // Q-vector with weights, new code
           // TBI 20251028 I have to keep it this way for the time being, otherwise I have to change all over the place, e.g. in TComplex Q(int n, int wp), etc.
         } else {
-          qv.fQvector[h][wp] += TComplex(std::cos(h * pbyp.fPhi), std::sin(h * pbyp.fPhi)); // bare Q-vector without weights, legacy code (TBI 20251027 remove this line)
-          // qv.fQvector[h][wp] += std::complex<double>(std::cos(h * pbyp.fPhi), std::sin(h * pbyp.fPhi)); // bare Q-vector without weights, new code
+          qv.fQvector[h][wp] += TComplex(phiHarmonic.real(), phiHarmonic.imag()); // bare Q-vector without weights, legacy code (TBI 20251027 remove this line)
+          // qv.fQvector[h][wp] += phiHarmonic; // bare Q-vector without weights, new code
           // TBI 20251028 I have to keep it this way for the time being, otherwise I have to change all over the place, e.g. in TComplex Q(int n, int wp), etc.
         }
       } // for(int wp=0;wp<gMaxCorrelator+1;wp++)
@@ -18071,7 +18413,7 @@ void FillQvectorFromSparse()
             if (es.fEtaSeparationsSkipHarmonics[h]) {
               continue;
             }
-            qv.fQabVector[0][h][e] += TComplex(wPhi * wPt * wEta * std::cos((h + 1) * pbyp.fPhi), wPhi * wPt * wEta * std::sin((h + 1) * pbyp.fPhi));
+            qv.fQabVector[0][h][e] += TComplex(wPhi * wPt * wEta * pbyp.fPhiHarmonics[h + 1].real(), wPhi * wPt * wEta * pbyp.fPhiHarmonics[h + 1].imag());
             // Remark: I can hardwire linear weights like this only for 2-p correlations
             // TBI 20251028 Replace TComplex with std::complex<double> (but it's a major modification, see the comment above within if (qv.fCalculateQvectors) )
           }
@@ -18086,7 +18428,7 @@ void FillQvectorFromSparse()
               if (es.fEtaSeparationsSkipHarmonics[h]) {
                 continue;
               }
-              qv.fQabVector[1][h][e] += TComplex(wPhi * wPt * wEta * std::cos((h + 1) * pbyp.fPhi), wPhi * wPt * wEta * std::sin((h + 1) * pbyp.fPhi));
+              qv.fQabVector[1][h][e] += TComplex(wPhi * wPt * wEta * pbyp.fPhiHarmonics[h + 1].real(), wPhi * wPt * wEta * pbyp.fPhiHarmonics[h + 1].imag());
               // TBI 20251028 Replace TComplex with std::complex<double> (but it's a major modification, see the comment above within if (qv.fCalculateQvectors) )
               // Remark: I can hardwire linear weights like this only for 2-p correlations
             }
@@ -18562,8 +18904,7 @@ void FillqvectorNdim(const double& dPhi, double* kineVarValues, int Ndim, eqvect
   // Remark: Keep in sync with corresponding implementation in FillQvectorFromSparse
   double wPhi = 1.;      // differential multidimensional phi weight, its dimensions are defined via enum eDiffPhiWeights
   double wPt = 1.;       // differential multidimensional pt weight, its dimensions are defined via enum eDiffPtWeights
-  double wEta = 1.;      // differential multidimensional eta weight, its dimensions are defined via enum eDiffEtaWeights
-  double wToPowerP = 1.; // weight raised to power p
+  double wEta = 1.; // differential multidimensional eta weight, its dimensions are defined via enum eDiffEtaWeights
 
   // *) Multidimensional phi weights:
   if (pw.fUseDiffPhiWeights[wPhiPhiAxis]) { // yes, 0th axis serves as a common boolean for this category
@@ -18771,11 +19112,11 @@ void Fillqvectors()
     // ****) determine all supported particle weights:
     // w_phi(pt):
     if (pw.fUseDiffPhiWeights[wPhiPtAxis]) {
-      wPhi = WeightFromSparse(eDWPhi);
+      wPhi = DiffWeight(eDWPhi);
     }
     // w_pt(pt):
     if (pw.fUseDiffPtWeights[wPtPtAxis]) {
-      wPt = WeightFromSparse(eDWPt);
+      wPt = DiffWeight(eDWPt);
     }
 
     // ****) finally, fill:
@@ -18792,11 +19133,11 @@ void Fillqvectors()
     // ****) determine all supported particle weights:
     // w_phi(eta):
     if (pw.fUseDiffPhiWeights[wPhiEtaAxis]) {
-      wPhi = WeightFromSparse(eDWPhi);
+      wPhi = DiffWeight(eDWPhi);
     }
     // w_eta(eta):
     if (pw.fUseDiffEtaWeights[wEtaEtaAxis]) {
-      wEta = WeightFromSparse(eDWEta);
+      wEta = DiffWeight(eDWEta);
     }
 
     // ****) finally, fill:
@@ -18813,15 +19154,15 @@ void Fillqvectors()
     // ****) determine all supported particle weights:
     // w_phi(charge):
     if (pw.fUseDiffPhiWeights[wPhiChargeAxis]) {
-      wPhi = WeightFromSparse(eDWPhi);
+      wPhi = DiffWeight(eDWPhi);
     }
     // w_pt(charge):
     if (pw.fUseDiffPtWeights[wPtChargeAxis]) {
-      wPt = WeightFromSparse(eDWPhi);
+      wPt = DiffWeight(eDWPhi);
     }
     // w_eta(charge):
     if (pw.fUseDiffEtaWeights[wEtaChargeAxis]) {
-      wEta = WeightFromSparse(eDWPhi);
+      wEta = DiffWeight(eDWPhi);
     }
 
     // ****) finally, fill:
@@ -18841,7 +19182,7 @@ void Fillqvectors()
     // ****) determine all supported particle weights:
     // w_phi(pt,eta):
     if (pw.fUseDiffPhiWeights[wPhiPtAxis] && pw.fUseDiffPhiWeights[wPhiEtaAxis]) {
-      wPhi = WeightFromSparse(eDWPhi);
+      wPhi = DiffWeight(eDWPhi);
     }
 
     // ****) finally, fill:
@@ -18858,7 +19199,7 @@ void Fillqvectors()
     // ****) determine all supported particle weights:
     // w_phi(pt,charge):
     if (pw.fUseDiffPhiWeights[wPhiPtAxis] && pw.fUseDiffPhiWeights[wPhiChargeAxis]) {
-      wPhi = WeightFromSparse(eDWPhi);
+      wPhi = DiffWeight(eDWPhi);
     }
 
     // ****) finally, fill:
@@ -18875,7 +19216,7 @@ void Fillqvectors()
     // ****) determine all supported particle weights:
     // w_phi(eta,charge):
     if (pw.fUseDiffPhiWeights[wEtaChargeAxis] && pw.fUseDiffPhiWeights[wPhiChargeAxis]) {
-      wPhi = WeightFromSparse(eDWPhi);
+      wPhi = DiffWeight(eDWPhi);
     }
 
     // ****) finally, fill:
@@ -18896,7 +19237,7 @@ void Fillqvectors()
     // ****) determine all supported particle weights:
     // w_phi(pt,eta,charge):
     if (pw.fUseDiffPhiWeights[wPhiPtAxis] && pw.fUseDiffPhiWeights[wPhiEtaAxis] && pw.fUseDiffPhiWeights[wPhiChargeAxis]) {
-      wPhi = WeightFromSparse(eDWPhi);
+      wPhi = DiffWeight(eDWPhi);
     }
 
     // ****) finally, fill:
@@ -18923,18 +19264,23 @@ void FillqvectorFromSparse(const eqvectorKine& kineVarChoice, const int& bin, co
   }
 
   // *) Finally, fill differential q-vector in that linearized "global bin":
-  double wToPowerP = 1.; // weight raised to power p
-
-  for (int h = 0; h < gMaxHarmonic * gMaxCorrelator + 1; h++) {
-    for (int wp = 0; wp < gMaxCorrelator + 1; wp++) {                                                                                             // weight power
-      if (pw.fUseDiffPhiWeights[wPhiPhiAxis] || pw.fUseDiffPtWeights[wPtPtAxis] || pw.fUseDiffEtaWeights[wEtaEtaAxis]) {                          // yes, because the first enum serves as a boolean for that category
-        wToPowerP = std::pow(dWeight, wp);                                                                                                        // dWeight = wPhi * wPt * wEta
-        qv.fqvector[kineVarChoice][bin][h][wp] += std::complex<double>(wToPowerP * std::cos(h * pbyp.fPhi), wToPowerP * std::sin(h * pbyp.fPhi)); // q-vector with weights
-      } else {
-        qv.fqvector[kineVarChoice][bin][h][wp] += std::complex<double>(std::cos(h * pbyp.fPhi), std::sin(h * pbyp.fPhi)); // bare q-vector without weights
+  //    Remark: exp(i*h*phi) is not re-calculated here for each kine variable, it was calculated only once for this particle in PrepareParticleKernel().
+  std::vector<std::vector<std::complex<double>>>& qvector = qv.fqvector[kineVarChoice][bin];
+  if (pw.fUseDiffPhiWeights[wPhiPhiAxis] || pw.fUseDiffPtWeights[wPtPtAxis] || pw.fUseDiffEtaWeights[wEtaEtaAxis]) { // yes, because the first enum serves as a boolean for that category
+    double wToPowerP[gMaxCorrelator + 1] = {1.};                                                                     // weight raised to power p, for all p
+    WeightsToPowerP(dWeight, wToPowerP);                                                                             // dWeight = wPhi * wPt * wEta
+    for (int h = 0; h < gMaxHarmonic * gMaxCorrelator + 1; h++) {
+      for (int wp = 0; wp < gMaxCorrelator + 1; wp++) {          // weight power
+        qvector[h][wp] += wToPowerP[wp] * pbyp.fPhiHarmonics[h]; // q-vector with weights
       }
-    } // for(int wp=0;wp<gMaxCorrelator+1;wp++)
-  } // for (int h = 0; h < gMaxHarmonic * gMaxCorrelator + 1; h++)
+    }
+  } else {
+    for (int h = 0; h < gMaxHarmonic * gMaxCorrelator + 1; h++) {
+      for (int wp = 0; wp < gMaxCorrelator + 1; wp++) { // weight power
+        qvector[h][wp] += pbyp.fPhiHarmonics[h];        // bare q-vector without weights
+      }
+    }
+  } // if (pw.fUseDiffPhiWeights[wPhiPhiAxis] || pw.fUseDiffPtWeights[wPtPtAxis] || pw.fUseDiffEtaWeights[wEtaEtaAxis])
 
   // *) Differential nested loops:
   if (nl.fCalculateKineCustomNestedLoops) {
@@ -18960,7 +19306,7 @@ void FillqvectorFromSparse(const eqvectorKine& kineVarChoice, const int& bin, co
             if (es.fEtaSeparationsSkipHarmonics[h]) {
               continue;
             }
-            qv.fqabVector[0][kineVarChoice][bin][h][e] += std::complex<double>(dWeight * std::cos((h + 1) * pbyp.fPhi), dWeight * std::sin((h + 1) * pbyp.fPhi)); // dWeight = wPhi * wPt * wEta => Remark: I can hardwire linear weight like this only for 2-p correlation
+            qv.fqabVector[0][kineVarChoice][bin][h][e] += dWeight * pbyp.fPhiHarmonics[h + 1]; // dWeight = wPhi * wPt * wEta => Remark: I can hardwire linear weight like this only for 2-p correlation
           }
         } // for (int h = 0; h < gMaxHarmonic; h++) {
       } // for (int e = 0; e < gMaxNumberEtaSeparations; e++) { // eta separation
@@ -18973,7 +19319,7 @@ void FillqvectorFromSparse(const eqvectorKine& kineVarChoice, const int& bin, co
               if (es.fEtaSeparationsSkipHarmonics[h]) {
                 continue;
               }
-              qv.fqabVector[1][kineVarChoice][bin][h][e] += std::complex<double>(dWeight * std::cos((h + 1) * pbyp.fPhi), dWeight * std::sin((h + 1) * pbyp.fPhi)); // dWeight = wPhi * wPt * wEta => Remark: I can hardwire linear weight like this only for 2-p correlation
+              qv.fqabVector[1][kineVarChoice][bin][h][e] += dWeight * pbyp.fPhiHarmonics[h + 1]; // dWeight = wPhi * wPt * wEta => Remark: I can hardwire linear weight like this only for 2-p correlation
             }
           } // for (int h = 0; h < gMaxHarmonic; h++) {
         } // for (int e = 0; e < gMaxNumberEtaSeparations; e++) { // eta separation
@@ -19210,6 +19556,9 @@ void MainLoopOverParticles(T const& tracks)
     pbyp.fEta = track.eta();
     pbyp.fCharge = track.sign();
 
+    // *) Quantities of this particle, used for all Q-vectors below (computed only once, and only then all enabled kine q-vectors are filled):
+    this->PrepareParticleKernel();
+
     // Remark: Keep in sync all calls and flags below with the ones in InternalValidation().
     // *) Integrated Q-vectors:
     if (qv.fCalculateQvectors || es.fCalculateEtaSeparations) {
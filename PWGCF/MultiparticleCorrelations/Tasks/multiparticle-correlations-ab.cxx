@@ -95,7 +95,10 @@ using TracksRec_QA = TracksRec;    // if I would need additional tables for QA,
 
 #include <Riostream.h>
 
+#include <algorithm>
 #include <complex>
+#include <thread>
+#include <vector>
 using namespace std;
 
 // *) Enums:
@@ -634,7 +634,7 @@ struct DptDptTrackSelection {
       itsTrack->stdTrackSelection->SetRequireITSRefit(true);
       itsTrack->stdTrackSelection->SetRequireHitsInITSLayers(2, {0, 1, 2});
       itsTrack->stdTrackSelection->SetMaxChi2PerClusterITS(36.0f);
-      itsTrack->stdTrackSelection->SetMaxDcaXYPtDep([](float pt) { return 0.004f + 0.013f / pt; });
+      itsTrack->stdTrackSelection->SetMaxDcaXYPtDep(0.004f, 0.013f, 1.f);
       return itsTrack;
     };
     switch (tracktype) {
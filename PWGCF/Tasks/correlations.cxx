@@ -13,6 +13,7 @@
 /// \brief task for the correlation calculations with CF-filtered tracks for O2 analysis
 /// \author Jan Fiete Grosse-Oetringhaus <jan.fiete.grosse-oetringhaus@cern.ch>, Jasper Parkkila <jasper.parkkila@cern.ch>
 
+#include "PWGCF/Core/BinnedCorrelator.h"
 #include "PWGCF/Core/CorrelationContainer.h"
 #include "PWGCF/Core/PairCuts.h"
 #include "PWGCF/DataModel/CorrelationsDerived.h"
@@ -41,10 +42,14 @@
 #include <THn.h>
 #include <TVector2.h>
 
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <experimental/type_traits>
 #include <memory>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -85,6 +90,8 @@ struct CorrelationTask {
 
   O2_DEFINE_CONFIGURABLE(cfgTwoTrackCut, float, -1, "Two track cut: -1 = off; >0 otherwise distance value (suggested: 0.02)");
   O2_DEFINE_CONFIGURABLE(cfgTwoTrackCutMinRadius, float, 0.8f, "Two track cut: radius in m from which two track cuts are applied");
+  O2_DEFINE_CONFIGURABLE(cfgPairThreads, int, 1, "Number of threads of the pair loop, each one correlating a block of trigger particles (1 = serial). The control histograms of the pair cuts are not filled with more than one thread");
+  O2_DEFINE_CONFIGURABLE(cfgBinnedCorrelations, int, 0, "Fill the track pairs from eta-phi grids of the trigger and associated tracks per pT bin (0 = OFF, 1 = ON). Only for track-track correlations without pair cuts, pair charge selection and mass axis");
   O2_DEFINE_CONFIGURABLE(cfgLocalEfficiency, int, 0, "0 = OFF and 1 = ON for local efficiency");
   O2_DEFINE_CONFIGURABLE(cfgCentBinsForMC, int, 0, "0 = OFF and 1 = ON for data like multiplicity/centrality bins for MC steps");
   O2_DEFINE_CONFIGURABLE(cfgTrackBitMask, uint16_t, 0, "BitMask for track selection systematics; refer to the enum TrackSelectionCuts in filtering task");
@@ -148,6 +155,7 @@ struct CorrelationTask {
 
   // persistent caches
   std::vector<float> efficiencyAssociatedCache;
+  std::vector<float> efficiencyTriggerCache;
   std::vector<int> p2indexCache;
 
   std::unique_ptr<TFormula> multCutFormula;
@@ -162,6 +170,7 @@ struct CorrelationTask {
 
   HistogramRegistry registry{"registry"};
   PairCuts mPairCuts;
+  BinnedCorrelator mBinnedCorrelator;
 
   Service<o2::ccdb::BasicCCDBManager> ccdb;
 
@@ -236,6 +245,24 @@ struct CorrelationTask {
       mPairCuts.SetTwoTrackCuts(cfgTwoTrackCut, cfgTwoTrackCutMinRadius);
     }
 
+    if (cfgBinnedCorrelations != 0) {
+      if (cfgMassAxis != 0 || cfg.mPairCuts || cfgTwoTrackCut > 0 || cfgPairCharge != 0) {
+        LOGF(fatal, "cfgBinnedCorrelations can not be used together with cfgMassAxis, cfgPairCut, cfgTwoTrackCut or cfgPairCharge.");
+      }
+      auto getBinEdges = [](const ConfigurableAxis& axis) {
+        const AxisSpec spec(axis);
+        if (!spec.nBins.has_value()) {
+          return spec.binEdges;
+        }
+        std::vector<double> edges;
+        for (int i = 0; i <= spec.nBins.value(); i++) {
+          edges.push_back(spec.binEdges[0] + i * (spec.binEdges[1] - spec.binEdges[0]) / spec.nBins.value());
+        }
+        return edges;
+      };
+      mBinnedCorrelator.Init(getBinEdges(axisDeltaEta), getBinEdges(axisDeltaPhi), getBinEdges(axisPtAssoc), getBinEdges(axisPtTrigger), cfgCutEta, cfgPtOrder != 0);
+    }
+
     // --- OBJECT INIT ---
 
     if (!cfgMultCutFormula.value.empty()) {
@@ -540,236 +567,442 @@ struct CorrelationTask {
       }
     }
 
+    if constexpr (std::is_same<TTracks1, TTracks2>::value && step >= CorrelationContainer::kCFStepReconstructed && !std::experimental::is_detected<HasDecay, typename TTracks1::iterator>::value && !std::experimental::is_detected<HasPDGCode, typename TTracks1::iterator>::value) {
+      if (cfgBinnedCorrelations != 0) {
+        fillCorrelationsBinned<step>(target, tracks1, tracks2, multiplicity, posZ, eventWeight);
+        return;
+      }
+    }
+
+    if (cfgPairThreads > 1 && tracks1.size() > 1) {
+      fillCorrelationsParallel<step>(target, tracks1, tracks2, multiplicity, posZ, magField, eventWeight);
+      return;
+    }
+
+    DirectSink<step, TTarget> sink{target, registry};
     for (const auto& track1 : tracks1) {
-      // LOGF(info, "Track %f | %f | %f  %d %d", track1.eta(), track1.phi(), track1.pt(), track1.isGlobalTrack(), track1.isGlobalTrackSDD());
+      auto triggerEfficiency = [&]() { return getEfficiencyCorrection(cfg.mEfficiencyTrigger, track1.eta(), track1.pt(), multiplicity, posZ); };
+      fillCorrelationsTrigger<step, TTracks1>(sink, track1, tracks2, multiplicity, posZ, magField, eventWeight, triggerEfficiency, mPairCuts);
+    }
+  }
+
+  // Histogram fills of the pair loop, done directly
+  template <CorrelationContainer::CFStep step, typename TTarget>
+  struct DirectSink {
+    TTarget target;
+    HistogramRegistry& registry;
+
+    template <typename... Ts>
+    void fillTrigger(const Ts&... valuesAndWeight)
+    {
+      target->getTriggerHist()->Fill(step, valuesAndWeight...);
+    }
+    template <typename... Ts>
+    void fillPair(const Ts&... valuesAndWeight)
+    {
+      target->getPairHist()->Fill(step, valuesAndWeight...);
+    }
+    void fillYvsPt(float y, float pt) { registry.fill(HIST("yvspt"), y, pt); }
+  };
+
+  // Histogram fills of the pair loop, buffered by a thread and replayed later in the same order
+  struct BufferSink {
+    enum Kind : int8_t { Trigger,
+                         Pair,
+                         YvsPt };
+
+    std::vector<double> values;              // values and weight of the fills, one after the other
+    std::vector<std::pair<Kind, int>> fills; // kind and number of values of each fill
+
+    template <typename... Ts>
+    void fillTrigger(const Ts&... valuesAndWeight)
+    {
+      add(Trigger, valuesAndWeight...);
+    }
+    template <typename... Ts>
+    void fillPair(const Ts&... valuesAndWeight)
+    {
+      add(Pair, valuesAndWeight...);
+    }
+    void fillYvsPt(float y, float pt) { add(YvsPt, y, pt); }
+
+    template <typename... Ts>
+    void add(Kind kind, const Ts&... fillValues)
+    {
+      (values.push_back(static_cast<double>(fillValues)), ...);
+      fills.emplace_back(kind, static_cast<int>(sizeof...(Ts)));
+    }
+    void clear()
+    {
+      values.clear();
+      fills.clear();
+    }
 
-      if constexpr (step <= CorrelationContainer::kCFStepTracked && !std::experimental::is_detected<HasDecay, typename TTracks1::iterator>::value) {
-        if (!checkObject<step>(track1)) {
+    template <CorrelationContainer::CFStep step, typename TTarget>
+    void replay(TTarget target, HistogramRegistry& registry) const
+    {
+      std::size_t offset = 0;
+      for (const auto& [kind, nValues] : fills) {
+        const double* v = &values[offset];
+        offset += nValues;
+        if (kind == YvsPt) {
+          registry.fill(HIST("yvspt"), v[0], v[1]);
           continue;
         }
+        auto* hist = (kind == Trigger ? target->getTriggerHist() : target->getPairHist());
+        switch (nValues) {
+          case 4:
+            hist->Fill(step, v[0], v[1], v[2], v[3]);
+            break;
+          case 5:
+            hist->Fill(step, v[0], v[1], v[2], v[3], v[4]);
+            break;
+          case 7:
+            hist->Fill(step, v[0], v[1], v[2], v[3], v[4], v[5], v[6]);
+            break;
+          case 8:
+            hist->Fill(step, v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7]);
+            break;
+          case 9:
+            hist->Fill(step, v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], v[8]);
+            break;
+          default:
+            LOGF(fatal, "Unexpected number of values %d in buffered fill", nValues);
+        }
       }
+    }
+  };
+  std::vector<BufferSink> fillBuffers; // one per thread of the pair loop
 
-      // sign check and PDG code special cases
-      if constexpr (std::experimental::is_detected<HasPDGCode, typename TTracks1::iterator>::value) {
-        // If the MC trigger particle is on the trigger PDG code list, we will accept them regardless of their charge.
-        if (!cfgMcTriggerPDGs->empty()) {
-          if (std::find(cfgMcTriggerPDGs->begin(), cfgMcTriggerPDGs->end(), track1.pdgCode()) == cfgMcTriggerPDGs->end())
-            continue;
-        } else { // otherwise check the sign against the configuration
-          if (cfgTriggerCharge != 0) {
-            if (cfgTriggerCharge * track1.sign() < 0)
-              continue;
-          } else if (track1.sign() == 0) {
-            continue; // reject neutral MC particles
-          }
+  // Pair loop over blocks of trigger particles on cfgPairThreads threads. The fills of each block are buffered and replayed in the order
+  // of the triggers, such that the histograms are the same as with one thread. The trigger efficiencies are looked up beforehand.
+  template <CorrelationContainer::CFStep step, typename TTarget, typename TTracks1, typename TTracks2>
+  void fillCorrelationsParallel(TTarget target, TTracks1& tracks1, TTracks2& tracks2, float multiplicity, float posZ, int magField, float eventWeight)
+  {
+    const std::size_t nTriggers = tracks1.size();
+    const std::size_t nThreads = std::min<std::size_t>(cfgPairThreads, nTriggers);
+
+    efficiencyTriggerCache.clear();
+    if constexpr (step == CorrelationContainer::kCFStepCorrected) {
+      if (cfg.mEfficiencyTrigger) {
+        efficiencyTriggerCache.reserve(nTriggers);
+        for (const auto& track : tracks1) {
+          efficiencyTriggerCache.push_back(getEfficiencyCorrection(cfg.mEfficiencyTrigger, track.eta(), track.pt(), multiplicity, posZ));
         }
-      } else if constexpr (std::experimental::is_detected<HasSign, typename TTracks1::iterator>::value) {
-        // Check reco objects that have the sign attribute. There are no neutrals to deal with.
-        if (cfgTriggerCharge != 0 && cfgTriggerCharge * track1.sign() < 0)
-          continue;
       }
+    }
 
-      if constexpr (std::experimental::is_detected<HasMcDecay, typename TTracks1::iterator>::value) {
-        if (((track1.mcDecay() != aod::cf2prongtrack::D0ToPiK) && (track1.mcDecay() != aod::cf2prongtrack::D0barToKPiExclusive)) || (track1.decay() & aod::cf2prongmcpart::Prompt) == 0)
-          continue;
-      } else if constexpr (std::experimental::is_detected<HasDecay, typename TTracks1::iterator>::value) {
-        if (cfgDecayParticleMask != 0 && (cfgDecayParticleMask & (1u << static_cast<uint32_t>(track1.decay()))) == 0u) {
-          continue; // skip particles that do not match the decay mask
+    fillBuffers.resize(nThreads);
+    auto worker = [&](std::size_t iThread) {
+      BufferSink& sink = fillBuffers[iThread];
+      sink.clear();
+      PairCuts pairCuts = mPairCuts;
+      pairCuts.SetHistogramRegistry(nullptr); // the control histograms are not thread safe
+      const std::size_t first = iThread * nTriggers / nThreads;
+      const std::size_t last = (iThread + 1) * nTriggers / nThreads;
+      std::size_t iTrigger = 0;
+      for (const auto& track1 : tracks1) {
+        if (iTrigger >= last) {
+          break;
         }
-        if (cfgV0RapidityMax > 0) {
-          auto [t, y] = getV0Rapidity(track1);
-          if (t && std::abs(y) > cfgV0RapidityMax)
-            continue; // V0s are not allowed to be outside the rapidity range
-          registry.fill(HIST("yvspt"), y, track1.pt());
+        if (iTrigger >= first) {
+          auto triggerEfficiency = [&]() { return efficiencyTriggerCache[iTrigger]; };
+          fillCorrelationsTrigger<step, TTracks1>(sink, track1, tracks2, multiplicity, posZ, magField, eventWeight, triggerEfficiency, pairCuts);
         }
+        iTrigger++;
       }
+    };
+    std::vector<std::thread> threads;
+    for (std::size_t iThread = 1; iThread < nThreads; iThread++) {
+      threads.emplace_back(worker, iThread);
+    }
+    worker(0);
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    for (std::size_t iThread = 0; iThread < nThreads; iThread++) {
+      fillBuffers[iThread].replay<step>(target, registry);
+    }
+  }
 
-      if constexpr (std::experimental::is_detected<HasPartDaugh0Id, typename TTracks1::iterator>::value) {
-        if (track1.cfParticleDaugh0Id() < 0 && track1.cfParticleDaugh1Id() < 0)
-          continue; // these we could not match
-      }
+  // Correlations of one trigger particle with the associated particles
+  template <CorrelationContainer::CFStep step, typename TTracks1, typename TSink, typename TTrack1, typename TTracks2, typename TEfficiency>
+  void fillCorrelationsTrigger(TSink& sink, const TTrack1& track1, TTracks2& tracks2, float multiplicity, float posZ, int magField, float eventWeight, TEfficiency const& triggerEfficiency, PairCuts& pairCuts)
+  {
+    // LOGF(info, "Track %f | %f | %f  %d %d", track1.eta(), track1.phi(), track1.pt(), track1.isGlobalTrack(), track1.isGlobalTrackSDD());
 
-      if constexpr (std::experimental::is_detected<HasMlProbD0, typename TTracks1::iterator>::value) {
-        if (!passMLScore(track1))
-          continue;
-      } // ML selection
+    if constexpr (step <= CorrelationContainer::kCFStepTracked && !std::experimental::is_detected<HasDecay, typename TTracks1::iterator>::value) {
+      if (!checkObject<step>(track1)) {
+        return;
+      }
+    }
 
-      float triggerWeight = eventWeight;
-      if constexpr (step == CorrelationContainer::kCFStepCorrected) {
-        if (cfg.mEfficiencyTrigger) {
-          triggerWeight *= getEfficiencyCorrection(cfg.mEfficiencyTrigger, track1.eta(), track1.pt(), multiplicity, posZ);
+    // sign check and PDG code special cases
+    if constexpr (std::experimental::is_detected<HasPDGCode, typename TTracks1::iterator>::value) {
+      // If the MC trigger particle is on the trigger PDG code list, we will accept them regardless of their charge.
+      if (!cfgMcTriggerPDGs->empty()) {
+        if (std::find(cfgMcTriggerPDGs->begin(), cfgMcTriggerPDGs->end(), track1.pdgCode()) == cfgMcTriggerPDGs->end())
+          return;
+      } else { // otherwise check the sign against the configuration
+        if (cfgTriggerCharge != 0) {
+          if (cfgTriggerCharge * track1.sign() < 0)
+            return;
+        } else if (track1.sign() == 0) {
+          return; // reject neutral MC particles
         }
       }
+    } else if constexpr (std::experimental::is_detected<HasSign, typename TTracks1::iterator>::value) {
+      // Check reco objects that have the sign attribute. There are no neutrals to deal with.
+      if (cfgTriggerCharge != 0 && cfgTriggerCharge * track1.sign() < 0)
+        return;
+    }
 
-      if (cfgMassAxis) {
-        if constexpr (std::experimental::is_detected<HasInvMass, typename TTracks1::iterator>::value)
-          target->getTriggerHist()->Fill(step, track1.pt(), multiplicity, posZ, track1.invMass(), triggerWeight);
-        else if constexpr (std::experimental::is_detected<HasPDGCode, typename TTracks1::iterator>::value) {
-          // TParticlePDG *p = pdg->GetParticle(track1.pdgCode());
-          // target->getTriggerHist()->Fill(step, track1.pt(), multiplicity, posZ, p->Mass(), triggerWeight);
-          target->getTriggerHist()->Fill(step, track1.pt(), multiplicity, posZ, 1.8, triggerWeight);
-        } else {
-          LOGF(fatal, "Can not fill mass axis without invMass column. Disable cfgMassAxis.");
-        }
+    if constexpr (std::experimental::is_detected<HasMcDecay, typename TTracks1::iterator>::value) {
+      if (((track1.mcDecay() != aod::cf2prongtrack::D0ToPiK) && (track1.mcDecay() != aod::cf2prongtrack::D0barToKPiExclusive)) || (track1.decay() & aod::cf2prongmcpart::Prompt) == 0)
+        return;
+    } else if constexpr (std::experimental::is_detected<HasDecay, typename TTracks1::iterator>::value) {
+      if (cfgDecayParticleMask != 0 && (cfgDecayParticleMask & (1u << static_cast<uint32_t>(track1.decay()))) == 0u) {
+        return; // skip particles that do not match the decay mask
+      }
+      if (cfgV0RapidityMax > 0) {
+        auto [t, y] = getV0Rapidity(track1);
+        if (t && std::abs(y) > cfgV0RapidityMax)
+          return; // V0s are not allowed to be outside the rapidity range
+        sink.fillYvsPt(y, track1.pt());
+      }
+    }
+
+    if constexpr (std::experimental::is_detected<HasPartDaugh0Id, typename TTracks1::iterator>::value) {
+      if (track1.cfParticleDaugh0Id() < 0 && track1.cfParticleDaugh1Id() < 0)
+        return; // these we could not match
+    }
+
+    if constexpr (std::experimental::is_detected<HasMlProbD0, typename TTracks1::iterator>::value) {
+      if (!passMLScore(track1))
+        return;
+    } // ML selection
+
+    float triggerWeight = eventWeight;
+    if constexpr (step == CorrelationContainer::kCFStepCorrected) {
+      if (cfg.mEfficiencyTrigger) {
+        triggerWeight *= triggerEfficiency();
+      }
+    }
+
+    if (cfgMassAxis) {
+      if constexpr (std::experimental::is_detected<HasInvMass, typename TTracks1::iterator>::value)
+        sink.fillTrigger(track1.pt(), multiplicity, posZ, track1.invMass(), triggerWeight);
+      else if constexpr (std::experimental::is_detected<HasPDGCode, typename TTracks1::iterator>::value) {
+        // TParticlePDG *p = pdg->GetParticle(track1.pdgCode());
+        // sink.fillTrigger(track1.pt(), multiplicity, posZ, p->Mass(), triggerWeight);
+        sink.fillTrigger(track1.pt(), multiplicity, posZ, 1.8, triggerWeight);
       } else {
-        target->getTriggerHist()->Fill(step, track1.pt(), multiplicity, posZ, triggerWeight);
+        LOGF(fatal, "Can not fill mass axis without invMass column. Disable cfgMassAxis.");
       }
+    } else {
+      sink.fillTrigger(track1.pt(), multiplicity, posZ, triggerWeight);
+    }
 
-      for (const auto& track2 : tracks2) {
-        if constexpr (std::is_same<TTracks1, TTracks2>::value) {
-          if (track1.globalIndex() == track2.globalIndex()) {
-            // LOGF(info, "Track identical: %f | %f | %f || %f | %f | %f", track1.eta(), track1.phi(), track1.pt(),  track2.eta(), track2.phi(), track2.pt());
-            continue;
-          }
-        }
-        if constexpr (std::experimental::is_detected<HasPDGCode, typename TTracks2::iterator>::value) { // skip those that are specifically chosen to be triggers
-          if (!cfgMcTriggerPDGs->empty() && std::find(cfgMcTriggerPDGs->begin(), cfgMcTriggerPDGs->end(), track2.pdgCode()) != cfgMcTriggerPDGs->end())
-            continue; // TODO: fix cases like MC D0-D0
+    for (const auto& track2 : tracks2) {
+      if constexpr (std::is_same<TTracks1, TTracks2>::value) {
+        if (track1.globalIndex() == track2.globalIndex()) {
+          // LOGF(info, "Track identical: %f | %f | %f || %f | %f | %f", track1.eta(), track1.phi(), track1.pt(),  track2.eta(), track2.phi(), track2.pt());
+          continue;
         }
+      }
+      if constexpr (std::experimental::is_detected<HasPDGCode, typename TTracks2::iterator>::value) { // skip those that are specifically chosen to be triggers
+        if (!cfgMcTriggerPDGs->empty() && std::find(cfgMcTriggerPDGs->begin(), cfgMcTriggerPDGs->end(), track2.pdgCode()) != cfgMcTriggerPDGs->end())
+          continue; // TODO: fix cases like MC D0-D0
+      }
 
-        // Daughter track and particle checks
-        if constexpr (std::experimental::is_detected<HasProng0Id, typename TTracks1::iterator>::value) {
-          if (track2.globalIndex() == track1.cfTrackProng0Id()) // do not correlate daughter tracks of the same event
-            continue;
+      // Daughter track and particle checks
+      if constexpr (std::experimental::is_detected<HasProng0Id, typename TTracks1::iterator>::value) {
+        if (track2.globalIndex() == track1.cfTrackProng0Id()) // do not correlate daughter tracks of the same event
+          continue;
+      }
+      if constexpr (std::experimental::is_detected<HasProng1Id, typename TTracks1::iterator>::value) {
+        if (track2.globalIndex() == track1.cfTrackProng1Id()) // do not correlate daughter tracks of the same event
+          continue;
+      }
+      if constexpr (std::experimental::is_detected<HasPartDaugh0Id, typename TTracks1::iterator>::value) {
+        if (track2.globalIndex() == track1.cfParticleDaugh0Id()) // do not correlate daughter particles of the same event
+          continue;
+      }
+      if constexpr (std::experimental::is_detected<HasPartDaugh1Id, typename TTracks1::iterator>::value) {
+        if (track2.globalIndex() == track1.cfParticleDaugh1Id()) // do not correlate daughter particles of the same event
+          continue;
+      }
+
+      if constexpr (step <= CorrelationContainer::kCFStepTracked && !std::experimental::is_detected<HasDecay, typename TTracks2::iterator>::value) {
+        if (!checkObject<step>(track2)) {
+          continue;
         }
-        if constexpr (std::experimental::is_detected<HasProng1Id, typename TTracks1::iterator>::value) {
-          if (track2.globalIndex() == track1.cfTrackProng1Id()) // do not correlate daughter tracks of the same event
-            continue;
+      }
+
+      // If decay attributes are found for the second track/particle, we assume 2p-2p correlation
+      if constexpr (std::experimental::is_detected<HasMcDecay, typename TTracks2::iterator>::value) {
+        if ((((track2.mcDecay()) != aod::cf2prongtrack::D0ToPiK) && ((track2.mcDecay()) != aod::cf2prongtrack::D0barToKPiExclusive)) || (track2.decay() & aod::cf2prongmcpart::Prompt) == 0)
+          continue;
+      } else if constexpr (std::experimental::is_detected<HasDecay, typename TTracks2::iterator>::value) {
+        if (cfgDecayParticleMask != 0 && (cfgDecayParticleMask & (1u << static_cast<uint32_t>(track2.decay()))) == 0u) {
+          continue; // skip particles that do not match the decay mask
         }
-        if constexpr (std::experimental::is_detected<HasPartDaugh0Id, typename TTracks1::iterator>::value) {
-          if (track2.globalIndex() == track1.cfParticleDaugh0Id()) // do not correlate daughter particles of the same event
+
+        // track2 here is charged hadron so we don't need rapidity cut for this track...this rapidity is only needed for V0
+        /*
+          if (cfgV0RapidityMax > 0) {
+          auto [t, y] = getV0Rapidity(track2);
+                if (t && std::abs(y) > cfgV0RapidityMax)
+          continue;
+          }*/
+      }
+
+      if constexpr (std::experimental::is_detected<HasDecay, typename TTracks1::iterator>::value && std::experimental::is_detected<HasDecay, typename TTracks2::iterator>::value) {
+        if (cfgCorrelationMethod == 1 && track1.decay() != track2.decay())
+          continue;
+        if (cfgCorrelationMethod == 2 && track1.decay() == track2.decay())
+          continue;
+      }
+
+      if constexpr (std::experimental::is_detected<HasProng0Id, typename TTracks1::iterator>::value) {
+        if constexpr (std::experimental::is_detected<HasProng0Id, typename TTracks2::iterator>::value) {
+          if (track1.cfTrackProng0Id() == track2.cfTrackProng0Id()) {
             continue;
+          }
         }
-        if constexpr (std::experimental::is_detected<HasPartDaugh1Id, typename TTracks1::iterator>::value) {
-          if (track2.globalIndex() == track1.cfParticleDaugh1Id()) // do not correlate daughter particles of the same event
+        if constexpr (std::experimental::is_detected<HasProng1Id, typename TTracks2::iterator>::value) {
+          if (track1.cfTrackProng0Id() == track2.cfTrackProng1Id()) {
             continue;
+          }
         }
+      }
 
-        if constexpr (step <= CorrelationContainer::kCFStepTracked && !std::experimental::is_detected<HasDecay, typename TTracks2::iterator>::value) {
-          if (!checkObject<step>(track2)) {
+      if constexpr (std::experimental::is_detected<HasProng1Id, typename TTracks1::iterator>::value) {
+        if constexpr (std::experimental::is_detected<HasProng0Id, typename TTracks2::iterator>::value) {
+          if (track1.cfTrackProng1Id() == track2.cfTrackProng0Id()) {
             continue;
           }
         }
-
-        // If decay attributes are found for the second track/particle, we assume 2p-2p correlation
-        if constexpr (std::experimental::is_detected<HasMcDecay, typename TTracks2::iterator>::value) {
-          if ((((track2.mcDecay()) != aod::cf2prongtrack::D0ToPiK) && ((track2.mcDecay()) != aod::cf2prongtrack::D0barToKPiExclusive)) || (track2.decay() & aod::cf2prongmcpart::Prompt) == 0)
+        if constexpr (std::experimental::is_detected<HasProng1Id, typename TTracks2::iterator>::value) {
+          if (track1.cfTrackProng1Id() == track2.cfTrackProng1Id()) {
             continue;
-        } else if constexpr (std::experimental::is_detected<HasDecay, typename TTracks2::iterator>::value) {
-          if (cfgDecayParticleMask != 0 && (cfgDecayParticleMask & (1u << static_cast<uint32_t>(track2.decay()))) == 0u) {
-            continue; // skip particles that do not match the decay mask
           }
+        }
+      } // no shared prong for two mothers
+      // TODO MC daughters check ^^
 
-          // track2 here is charged hadron so we don't need rapidity cut for this track...this rapidity is only needed for V0
-          /*
-            if (cfgV0RapidityMax > 0) {
-            auto [t, y] = getV0Rapidity(track2);
-                  if (t && std::abs(y) > cfgV0RapidityMax)
+      if (cfgPtOrder != 0 && track2.pt() >= track1.pt()) {
+        continue;
+      }
+
+      if constexpr (std::experimental::is_detected<HasSign, typename TTracks2::iterator>::value) {
+        // TODO: support for MC D0-D0 case
+        if (cfgAssociatedCharge != 0) {
+          if (cfgAssociatedCharge * track2.sign() < 0)
             continue;
-            }*/
+        } else if (track2.sign() == 0) { // mc particles come in neutrals, need to check explicitly
+          continue;
         }
+      }
 
-        if constexpr (std::experimental::is_detected<HasDecay, typename TTracks1::iterator>::value && std::experimental::is_detected<HasDecay, typename TTracks2::iterator>::value) {
-          if (cfgCorrelationMethod == 1 && track1.decay() != track2.decay())
-            continue;
-          if (cfgCorrelationMethod == 2 && track1.decay() == track2.decay())
-            continue;
+      if constexpr (std::experimental::is_detected<HasSign, typename TTracks1::iterator>::value && std::experimental::is_detected<HasSign, typename TTracks2::iterator>::value) {
+        if (cfgPairCharge != 0 && cfgPairCharge * track1.sign() * track2.sign() < 0) {
+          continue;
         }
+      }
 
-        if constexpr (std::experimental::is_detected<HasProng0Id, typename TTracks1::iterator>::value) {
-          if constexpr (std::experimental::is_detected<HasProng0Id, typename TTracks2::iterator>::value) {
-            if (track1.cfTrackProng0Id() == track2.cfTrackProng0Id()) {
+      if constexpr (std::is_same<TTracks1, TTracks2>::value) {
+        if constexpr (step >= CorrelationContainer::kCFStepReconstructed) {
+          if constexpr (std::experimental::is_detected<HasSign, typename TTracks1::iterator>::value && std::experimental::is_detected<HasSign, typename TTracks2::iterator>::value) {
+            if (cfg.mPairCuts && pairCuts.conversionCuts(track1, track2)) {
               continue;
             }
-          }
-          if constexpr (std::experimental::is_detected<HasProng1Id, typename TTracks2::iterator>::value) {
-            if (track1.cfTrackProng0Id() == track2.cfTrackProng1Id()) {
+            if (cfgTwoTrackCut > 0 && pairCuts.twoTrackCut(track1, track2, magField)) {
               continue;
             }
           }
         }
+      }
+
+      float associatedWeight = triggerWeight;
+      if constexpr (step == CorrelationContainer::kCFStepCorrected) {
+        if (cfg.mEfficiencyAssociated) {
+          associatedWeight *= efficiencyAssociatedCache[track2.filteredIndex()];
+        }
+      }
 
-        if constexpr (std::experimental::is_detected<HasProng1Id, typename TTracks1::iterator>::value) {
-          if constexpr (std::experimental::is_detected<HasProng0Id, typename TTracks2::iterator>::value) {
-            if (track1.cfTrackProng1Id() == track2.cfTrackProng0Id()) {
-              continue;
-            }
-          }
-          if constexpr (std::experimental::is_detected<HasProng1Id, typename TTracks2::iterator>::value) {
-            if (track1.cfTrackProng1Id() == track2.cfTrackProng1Id()) {
-              continue;
-            }
-          }
-        } // no shared prong for two mothers
-        // TODO MC daughters check ^^
+      float deltaPhi = RecoDecay::constrainAngle(track1.phi() - track2.phi(), -o2::constants::math::PIHalf);
 
-        if (cfgPtOrder != 0 && track2.pt() >= track1.pt()) {
+      if constexpr (std::experimental::is_detected<HasMlProbD0, typename TTracks2::iterator>::value) {
+        if (!passMLScore(track2))
           continue;
-        }
+      } // ML selection
 
-        if constexpr (std::experimental::is_detected<HasSign, typename TTracks2::iterator>::value) {
-          // TODO: support for MC D0-D0 case
-          if (cfgAssociatedCharge != 0) {
-            if (cfgAssociatedCharge * track2.sign() < 0)
-              continue;
-          } else if (track2.sign() == 0) { // mc particles come in neutrals, need to check explicitly
-            continue;
-          }
+      // last param is the weight
+      if (cfgMassAxis && (doprocessSame2Prong2Prong || doprocessMixed2Prong2Prong || doprocessSame2Prong2ProngML || doprocessMixed2Prong2ProngML) && !(doprocessSame2ProngDerived || doprocessSame2ProngDerivedML || doprocessMixed2ProngDerived || doprocessMixed2ProngDerivedML)) {
+        if constexpr (std::experimental::is_detected<HasInvMass, typename TTracks1::iterator>::value && std::experimental::is_detected<HasInvMass, typename TTracks2::iterator>::value)
+          sink.fillPair(track1.eta() - track2.eta(), track2.pt(), track1.pt(), multiplicity, deltaPhi, posZ, track2.invMass(), track1.invMass(), associatedWeight);
+        else
+          LOGF(fatal, "Can not fill mass axis without invMass column. \n no mass for two particles");
+      } else if (cfgMassAxis) {
+        if constexpr (std::experimental::is_detected<HasInvMass, typename TTracks1::iterator>::value)
+          sink.fillPair(track1.eta() - track2.eta(), track2.pt(), track1.pt(), multiplicity, deltaPhi, posZ, track1.invMass(), associatedWeight);
+        else if constexpr (std::experimental::is_detected<HasPDGCode, typename TTracks1::iterator>::value) {
+          // TParticlePDG *p = pdg->GetParticle(track1.pdgCode()); //TODO: get the mass for the PDG properly
+          sink.fillPair(track1.eta() - track2.eta(), track2.pt(), track1.pt(), multiplicity, deltaPhi, posZ, 1.8, associatedWeight); // p->Mass()
+        } else {
+          LOGF(fatal, "Can not fill mass axis without invMass column. Disable cfgMassAxis.");
         }
+      } else {
+        sink.fillPair(track1.eta() - track2.eta(), track2.pt(), track1.pt(), multiplicity, deltaPhi, posZ, associatedWeight);
+      }
+    }
+  }
 
-        if constexpr (std::experimental::is_detected<HasSign, typename TTracks1::iterator>::value && std::experimental::is_detected<HasSign, typename TTracks2::iterator>::value) {
-          if (cfgPairCharge != 0 && cfgPairCharge * track1.sign() * track2.sign() < 0) {
-            continue;
-          }
-        }
+  // Track-track correlations from the eta-phi grids of the trigger and associated tracks, see BinnedCorrelator
+  template <CorrelationContainer::CFStep step, typename TTarget, typename TTracks1, typename TTracks2>
+  void fillCorrelationsBinned(TTarget target, TTracks1& tracks1, TTracks2& tracks2, float multiplicity, float posZ, float eventWeight)
+  {
+    // same event processing passes the same table twice, its pairs of a track with itself are then removed
+    const bool sameEvent = (static_cast<const void*>(&tracks1) == static_cast<const void*>(&tracks2));
 
-        if constexpr (std::is_same<TTracks1, TTracks2>::value) {
-          if constexpr (step >= CorrelationContainer::kCFStepReconstructed) {
-            if constexpr (std::experimental::is_detected<HasSign, typename TTracks1::iterator>::value && std::experimental::is_detected<HasSign, typename TTracks2::iterator>::value) {
-              if (cfg.mPairCuts && mPairCuts.conversionCuts(track1, track2)) {
-                continue;
-              }
-              if (cfgTwoTrackCut > 0 && mPairCuts.twoTrackCut(track1, track2, magField)) {
-                continue;
-              }
-            }
-          }
-        }
+    mBinnedCorrelator.Clear();
+    for (const auto& track1 : tracks1) {
+      if constexpr (std::experimental::is_detected<HasSign, typename TTracks1::iterator>::value) {
+        if (cfgTriggerCharge != 0 && cfgTriggerCharge * track1.sign() < 0)
+          continue;
+      }
 
-        float associatedWeight = triggerWeight;
-        if constexpr (step == CorrelationContainer::kCFStepCorrected) {
-          if (cfg.mEfficiencyAssociated) {
-            associatedWeight *= efficiencyAssociatedCache[track2.filteredIndex()];
-          }
+      float triggerWeight = eventWeight;
+      if constexpr (step == CorrelationContainer::kCFStepCorrected) {
+        if (cfg.mEfficiencyTrigger) {
+          triggerWeight *= getEfficiencyCorrection(cfg.mEfficiencyTrigger, track1.eta(), track1.pt(), multiplicity, posZ);
         }
+      }
+      target->getTriggerHist()->Fill(step, track1.pt(), multiplicity, posZ, triggerWeight);
+      mBinnedCorrelator.AddTrigger(track1.eta(), track1.phi(), track1.pt(), triggerWeight, track1.globalIndex());
+    }
 
-        float deltaPhi = RecoDecay::constrainAngle(track1.phi() - track2.phi(), -o2::constants::math::PIHalf);
-
-        if constexpr (std::experimental::is_detected<HasMlProbD0, typename TTracks2::iterator>::value) {
-          if (!passMLScore(track2))
+    for (const auto& track2 : tracks2) {
+      if constexpr (std::experimental::is_detected<HasSign, typename TTracks2::iterator>::value) {
+        if (cfgAssociatedCharge != 0) {
+          if (cfgAssociatedCharge * track2.sign() < 0)
             continue;
-        } // ML selection
-
-        // last param is the weight
-        if (cfgMassAxis && (doprocessSame2Prong2Prong || doprocessMixed2Prong2Prong || doprocessSame2Prong2ProngML || doprocessMixed2Prong2ProngML) && !(doprocessSame2ProngDerived || doprocessSame2ProngDerivedML || doprocessMixed2ProngDerived || doprocessMixed2ProngDerivedML)) {
-          if constexpr (std::experimental::is_detected<HasInvMass, typename TTracks1::iterator>::value && std::experimental::is_detected<HasInvMass, typename TTracks2::iterator>::value)
-            target->getPairHist()->Fill(step, track1.eta() - track2.eta(), track2.pt(), track1.pt(), multiplicity, deltaPhi, posZ, track2.invMass(), track1.invMass(), associatedWeight);
-          else
-            LOGF(fatal, "Can not fill mass axis without invMass column. \n no mass for two particles");
-        } else if (cfgMassAxis) {
-          if constexpr (std::experimental::is_detected<HasInvMass, typename TTracks1::iterator>::value)
-            target->getPairHist()->Fill(step, track1.eta() - track2.eta(), track2.pt(), track1.pt(), multiplicity, deltaPhi, posZ, track1.invMass(), associatedWeight);
-          else if constexpr (std::experimental::is_detected<HasPDGCode, typename TTracks1::iterator>::value) {
-            // TParticlePDG *p = pdg->GetParticle(track1.pdgCode()); //TODO: get the mass for the PDG properly
-            target->getPairHist()->Fill(step, track1.eta() - track2.eta(), track2.pt(), track1.pt(), multiplicity, deltaPhi, posZ, 1.8, associatedWeight); // p->Mass()
-          } else {
-            LOGF(fatal, "Can not fill mass axis without invMass column. Disable cfgMassAxis.");
-          }
-        } else {
-          target->getPairHist()->Fill(step, track1.eta() - track2.eta(), track2.pt(), track1.pt(), multiplicity, deltaPhi, posZ, associatedWeight);
+        } else if (track2.sign() == 0) {
+          continue;
         }
       }
+
+      float associatedWeight = 1.0f;
+      if constexpr (step == CorrelationContainer::kCFStepCorrected) {
+        if (cfg.mEfficiencyAssociated) {
+          associatedWeight = efficiencyAssociatedCache[track2.filteredIndex()];
+        }
+      }
+      mBinnedCorrelator.AddAssociated(track2.eta(), track2.phi(), track2.pt(), associatedWeight, track2.globalIndex());
     }
+
+    mBinnedCorrelator.Fill(target->getPairHist(), step, multiplicity, posZ, sameEvent);
   }
 
   void loadEfficiency(uint64_t timestamp)
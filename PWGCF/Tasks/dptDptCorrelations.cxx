@@ -45,6 +45,7 @@
 #include <TVector2.h>
 
 #include <cmath>
+#include <cstdint>
 #include <cstdio>
 #include <ctime>
 #include <string>
@@ -137,6 +138,20 @@ struct DptDptCorrelations {
     std::vector<std::vector<TProfile*>> fhSum2PtPtnwVsC{nch, {nch, nullptr}};   //!<! un-weighted accumulated \f${p_T}_1 {p_T}_2\f$ distribution vs event centrality/multiplicity 1-1,1-2,2-1,2-2, combinations
     std::vector<std::vector<TProfile*>> fhSum2DptDptnwVsC{nch, {nch, nullptr}}; //!<! un-weighted accumulated \f$\sum ({p_T}_1- <{p_T}_1>) ({p_T}_2 - <{p_T}_2>) \f$ distribution vs \f$\Delta\eta,\;\Delta\phi\f$ distribution vs event centrality/multiplicity 1-1,1-2,2-1,2-2, combinations
 
+    /* dense accumulator of the differential pair quantities laid out as [pid1][pid2][quantity][delta eta delta phi index] */
+    enum PairQuantity {
+      kN2 = 0,
+      kSum2DptDpt,
+      kSum2PtPt,
+      kSupN1N1,
+      kSupPt1Pt1,
+      kNoOfPairQuantities
+    };
+    int nDEtaDPhiBins = 0;                 //!<! number of delta eta delta phi bins of the differential histograms
+    std::vector<float> fPairAccumulator;   //!<! the pair quantities accumulated along the current collision
+    std::vector<uint8_t> fPairCellTouched; //!<! whether a [pid1][pid2][index] cell has been accumulated in the current collision
+    std::vector<int> fPairTouchedCells;    //!<! the cells accumulated in the current collision, to be flushed into the histograms
+
     bool ccdbstored = false;
 
     float isCCDBstored()
@@ -236,17 +251,17 @@ struct DptDptCorrelations {
       return RecoDecay::constrainAngle(value, deltaphilow - constants::math::PI);
     }
 
-    /// \brief Returns the TH2 global bin for the differential histograms
+    /// \brief Returns the zero based delta eta delta phi index for the differential histograms
     /// \param t1 the intended track one
     /// \param t2 the intended track two
-    /// \return the globl TH2 bin for delta eta delta phi
+    /// \return the zero based index for delta eta delta phi, delta eta being the first index component
     ///
     /// WARNING: for performance reasons no checks are done about the consistency
     /// of tracks' eta and phi within the corresponding ranges so, it is suppossed
     /// the tracks have been accepted and they are within that ranges
     /// IF THAT IS NOT THE CASE THE ROUTINE WILL PRODUCE NONSENSE RESULTS
     template <typename TrackObject>
-    int getDEtaDPhiGlobalBin(TrackObject const& t1, TrackObject const& t2)
+    int getDEtaDPhiIndex(TrackObject const& t1, TrackObject const& t2)
     {
       using namespace correlationstask;
       using namespace o2::analysis::dptdptfilter;
@@ -267,7 +282,51 @@ struct DptDptCorrelations {
         deltaPhiIx += phibins;
       }
 
-      return fhN2VsDEtaDPhi[0][0]->GetBin(deltaEtaIx + 1, deltaPhiIx + 1);
+      return deltaEtaIx * deltaphibins + deltaPhiIx;
+    }
+
+    /// \brief Returns the accumulator cell of the differential pair quantities for a species pair and a delta eta delta phi index
+    /// \param pid1 the species of track one
+    /// \param pid2 the species of track two
+    /// \param ix the zero based delta eta delta phi index
+    /// \return the address of the first quantity, the next ones being each nDEtaDPhiBins further
+    ///
+    /// The cell is registered for being flushed into the histograms at the end of the collision
+    float* getPairCell(int pid1, int pid2, int ix)
+    {
+      int pairix = pid1 * static_cast<int>(nch) + pid2;
+      int cell = pairix * nDEtaDPhiBins + ix;
+      if (fPairCellTouched[cell] == 0) {
+        fPairCellTouched[cell] = 1;
+        fPairTouchedCells.push_back(cell);
+      }
+      return &fPairAccumulator[(pairix * kNoOfPairQuantities) * nDEtaDPhiBins + ix];
+    }
+
+    /// \brief Flushes the touched accumulator cells into the differential histograms and resets them
+    void flushPairAccumulator()
+    {
+      using namespace correlationstask;
+
+      for (int cell : fPairTouchedCells) {
+        int pairix = cell / nDEtaDPhiBins;
+        int ix = cell % nDEtaDPhiBins;
+        int pid1 = pairix / static_cast<int>(nch);
+        int pid2 = pairix % static_cast<int>(nch);
+        TH2F* hists[kNoOfPairQuantities] = {fhN2VsDEtaDPhi[pid1][pid2], fhSum2DptDptVsDEtaDPhi[pid1][pid2], fhSum2PtPtVsDEtaDPhi[pid1][pid2],
+                                            fhSupN1N1VsDEtaDPhi[pid1][pid2], fhSupPt1Pt1VsDEtaDPhi[pid1][pid2]};
+        /* rule: ix are always zero based while bins are always one based */
+        int globalbin = hists[kN2]->GetBin(ix / deltaphibins + 1, ix % deltaphibins + 1);
+        float* values = &fPairAccumulator[(pairix * kNoOfPairQuantities) * nDEtaDPhiBins + ix];
+        for (int q = 0; q < kNoOfPairQuantities; ++q) {
+          if (values[q * nDEtaDPhiBins] != 0) {
+            hists[q]->AddBinContent(globalbin, values[q * nDEtaDPhiBins]);
+            values[q * nDEtaDPhiBins] = 0;
+          }
+        }
+        fPairCellTouched[cell] = 0;
+      }
+      fPairTouchedCells.clear();
     }
 
     /* taken from PWGCF/Core/PairCuts.h implemented by JFGO */
@@ -484,8 +543,7 @@ struct DptDptCorrelations {
       std::vector<std::vector<double>> sum2PtPtnw(nch, std::vector<double>(nch, 0.0));   ///< accumulated sum of not weighted track 1 track 2 \f${p_T}_1 {p_T}_2\f$ for current collision
       std::vector<std::vector<double>> sum2DptDptnw(nch, std::vector<double>(nch, 0.0)); ///< accumulated sum of not weighted number of track 1 tracks times not weighted track 2 \f$p_T\f$ for current collision
       int index1 = 0;
-      int globalbin = 0;
-      LOGF(debug, "Initializing globalbin to ", globalbin);
+      int dedphiix = 0;
 
       for (auto const& track1 : trks1) {
         double ptAvg1 = (*ptavgs1)[index1];
@@ -512,9 +570,9 @@ struct DptDptCorrelations {
           double dptdptnw = (track1.pt() - ptAvg1) * (track2.pt() - ptAvg2);
           double dptdptw = (corr1 * track1.pt() - ptAvg1) * (corr2 * track2.pt() - ptAvg2);
 
-          /* get the global bin for filling the differential histograms */
+          /* get the delta eta delta phi index for filling the differential histograms */
           if constexpr (docorrelations) {
-            globalbin = getDEtaDPhiGlobalBin(track1, track2);
+            dedphiix = getDEtaDPhiIndex(track1, track2);
           }
           float deltaeta = track1.eta() - track2.eta();
           float deltaphi = track1.phi() - track2.phi();
@@ -522,8 +580,9 @@ struct DptDptCorrelations {
           if ((fUseConversionCuts && fPairCuts.conversionCuts(track1, track2)) || (fUseTwoTrackCut && fPairCuts.twoTrackCut(track1, track2, bfield))) {
             /* suppress the pair */
             if constexpr (docorrelations) {
-              fhSupN1N1VsDEtaDPhi[track1.trackacceptedid()][track2.trackacceptedid()]->AddBinContent(globalbin, corr);
-              fhSupPt1Pt1VsDEtaDPhi[track1.trackacceptedid()][track2.trackacceptedid()]->AddBinContent(globalbin, track1.pt() * track2.pt() * corr);
+              float* cell = getPairCell(track1.trackacceptedid(), track2.trackacceptedid(), dedphiix);
+              cell[kSupN1N1 * nDEtaDPhiBins] += corr;
+              cell[kSupPt1Pt1 * nDEtaDPhiBins] += track1.pt() * track2.pt() * corr;
             }
             n2sup[track1.trackacceptedid()][track2.trackacceptedid()] += corr;
           } else {
@@ -536,10 +595,11 @@ struct DptDptCorrelations {
             sum2DptDptnw[track1.trackacceptedid()][track2.trackacceptedid()] += dptdptnw;
 
             if constexpr (docorrelations) {
-              fhN2VsDEtaDPhi[track1.trackacceptedid()][track2.trackacceptedid()]->AddBinContent(globalbin, corr);
+              float* cell = getPairCell(track1.trackacceptedid(), track2.trackacceptedid(), dedphiix);
+              cell[kN2 * nDEtaDPhiBins] += corr;
+              cell[kSum2DptDpt * nDEtaDPhiBins] += dptdptw;
+              cell[kSum2PtPt * nDEtaDPhiBins] += track1.pt() * track2.pt() * corr;
               fhN2contVsDEtaDPhi[track1.trackacceptedid()][track2.trackacceptedid()]->Fill(deltaeta, deltaphi, corr);
-              fhSum2DptDptVsDEtaDPhi[track1.trackacceptedid()][track2.trackacceptedid()]->AddBinContent(globalbin, dptdptw);
-              fhSum2PtPtVsDEtaDPhi[track1.trackacceptedid()][track2.trackacceptedid()]->AddBinContent(globalbin, track1.pt() * track2.pt() * corr);
               fhN2VsPtPt[track1.trackacceptedid()][track2.trackacceptedid()]->Fill(track1.pt(), track2.pt(), corr);
             }
             if constexpr (doinvmass) {
@@ -555,6 +615,9 @@ struct DptDptCorrelations {
         }
         index1++;
       }
+      if constexpr (docorrelations) {
+        flushPairAccumulator();
+      }
       for (uint pid1 = 0; pid1 < nch; ++pid1) {
         for (uint pid2 = 0; pid2 < nch; ++pid2) {
           fhN2VsC[pid1][pid2]->Fill(cmul, n2[pid1][pid2]);
@@ -887,6 +950,14 @@ struct DptDptCorrelations {
           }
         }
       }
+      if constexpr (docorrelations) {
+        if (processpairs) {
+          nDEtaDPhiBins = deltaetabins * deltaphibins;
+          fPairAccumulator.assign(nch * nch * kNoOfPairQuantities * nDEtaDPhiBins, 0.0f);
+          fPairCellTouched.assign(nch * nch * nDEtaDPhiBins, 0);
+          fPairTouchedCells.reserve(nch * nch * nDEtaDPhiBins);
+        }
+      }
       TH1::AddDirectory(oldstatus);
     }
   }; // DataCollectingEngine
@@ -15,6 +15,7 @@
 /// \since  May/03/2025
 
 #include "PWGCF/Core/CorrelationContainer.h"
+#include "PWGCF/Core/EventMixingPool.h"
 #include "PWGCF/Core/PairCuts.h"
 #include "PWGCF/DataModel/CorrelationsDerived.h"
 #include "PWGCF/GenericFramework/Core/GFW.h"
@@ -103,6 +104,9 @@ struct DiHadronCor {
   O2_DEFINE_CONFIGURABLE(cfgUseCFStepAll, bool, true, "Filling kCFStepAll")
   O2_DEFINE_CONFIGURABLE(cfgSoloPtTrack, bool, false, "Skip trigger tracks that are alone in their pT bin for same process")
   O2_DEFINE_CONFIGURABLE(cfgSingleSoloPtTrack, bool, false, "Skip associated tracks that are alone in their pT bin for same process, works only if cfgSoloPtTrack is enabled")
+  O2_DEFINE_CONFIGURABLE(cfgMixPoolDepth, int, 5, "Number of events kept per mixing bin by the mixing pool")
+  O2_DEFINE_CONFIGURABLE(cfgMixPoolMaxTracks, int, -1, "Maximum number of tracks stored by the mixing pool, no limit if <= 0")
+  O2_DEFINE_CONFIGURABLE(cfgMixPoolRandomEviction, bool, false, "A new event replaces a random event of a full mixing bin instead of the oldest one")
   struct : ConfigurableGroup {
     O2_DEFINE_CONFIGURABLE(cfgMultCentHighCutFunction, std::string, "[0] + [1]*x + [2]*x*x + [3]*x*x*x + [4]*x*x*x*x + 10.*([5] + [6]*x + [7]*x*x + [8]*x*x*x + [9]*x*x*x*x)", "Functional for multiplicity correlation cut");
     O2_DEFINE_CONFIGURABLE(cfgMultCentLowCutFunction, std::string, "[0] + [1]*x + [2]*x*x + [3]*x*x*x + [4]*x*x*x*x - 3.*([5] + [6]*x + [7]*x*x + [8]*x*x*x + [9]*x*x*x*x)", "Functional for multiplicity correlation cut");
@@ -199,6 +203,17 @@ struct DiHadronCor {
 
   // persistent caches
   std::vector<float> efficiencyAssociatedCache;
+  EventMixingPool mixingPool; // events of the previous data frames for processMixedPool
+
+  // associated track of the mixing pool, for the merging cut
+  struct PoolTrack {
+    float ptValue;
+    float phiValue;
+    float signValue;
+    float pt() const { return ptValue; }
+    float phi() const { return phiValue; }
+    float sign() const { return signValue; }
+  };
 
   void init(InitContext&)
   {
@@ -297,6 +312,12 @@ struct DiHadronCor {
     if (doprocessMCMixed && doprocessOntheflyMixed) {
       LOGF(fatal, "Full simulation and on-the-fly processing of mixed event not supported");
     }
+    if (doprocessMixed && doprocessMixedPool) {
+      LOGF(fatal, "Mixed event processing with and without the mixing pool not supported");
+    }
+    if (doprocessMixedPool) {
+      mixingPool.Init(EventMixingPool::GetAxisEdges(axisVtxMix.value), EventMixingPool::GetAxisEdges(axisMultMix.value), cfgMixPoolDepth, cfgMixPoolRandomEviction ? EventMixingPool::kRandom : EventMixingPool::kOldest, cfgMixPoolMaxTracks);
+    }
     if (doprocessMCSame || doprocessOntheflySame) {
       registry.add("MCTrue/MCeventcount", "MCeventcount", {HistType::kTH1F, {{5, 0, 5, "bin"}}}); // histogram to see how many events are in the same and mixed event
       registry.get<TH1>(HIST("MCTrue/MCeventcount"))->GetXaxis()->SetBinLabel(2, "same all");
@@ -593,6 +614,74 @@ struct DiHadronCor {
     }
   }
 
+  template <CorrelationContainer::CFStep step, typename TTracks>
+  void fillCorrelationsPool(TTracks const& tracks1, EventMixingPool::EventView const& event2, float posZ, int magneticField, float eventWeight) // function to fill the mixed event of the tracks with an event of the mixing pool
+  {
+    // Cache efficiency for particles (too many FindBin lookups)
+    if (mEfficiency) {
+      efficiencyAssociatedCache.clear();
+      efficiencyAssociatedCache.reserve(event2.size());
+      for (std::size_t i = 0; i < event2.size(); i++) {
+        float weff = 1.;
+        getEfficiencyCorrection(weff, event2.eta[i], event2.pt[i], posZ);
+        efficiencyAssociatedCache.push_back(weff);
+      }
+    }
+
+    int fSampleIndex = gRandom->Uniform(0, cfgSampleSize);
+
+    float triggerWeight = 1.0f;
+    float associatedWeight = 1.0f;
+    // loop over all tracks
+    for (auto const& track1 : tracks1) {
+
+      if (!trackSelected(track1))
+        continue;
+      if (!getEfficiencyCorrection(triggerWeight, track1.eta(), track1.pt(), posZ))
+        continue;
+
+      // the tracks of the pool passed the track selection when stored
+      for (std::size_t i = 0; i < event2.size(); i++) {
+
+        if (mEfficiency) {
+          associatedWeight = efficiencyAssociatedCache[i];
+        }
+
+        if (cfgUsePtOrder && cfgUsePtOrderInMixEvent && track1.pt() <= event2.pt[i])
+          continue; // For pt-differential correlations in mixed events, skip if the trigger pt is less than the associate pt
+
+        float deltaPhi = RecoDecay::constrainAngle(track1.phi() - event2.phi[i], -PIHalf);
+        float deltaEta = track1.eta() - event2.eta[i];
+
+        if (std::abs(deltaEta) < cfgCutMerging) {
+
+          const PoolTrack track2{event2.pt[i], event2.phi[i], static_cast<float>(event2.sign[i])};
+          double dPhiStarHigh = getDPhiStar(track1, track2, cfgRadiusHigh, magneticField);
+          double dPhiStarLow = getDPhiStar(track1, track2, cfgRadiusLow, magneticField);
+
+          const double kLimit = 3.0 * cfgCutMerging;
+
+          bool bIsBelow = false;
+
+          if (std::abs(dPhiStarLow) < kLimit || std::abs(dPhiStarHigh) < kLimit || dPhiStarLow * dPhiStarHigh < 0) {
+            for (double rad(cfgRadiusLow); rad < cfgRadiusHigh; rad += 0.01) {
+              double dPhiStar = getDPhiStar(track1, track2, rad, magneticField);
+              if (std::abs(dPhiStar) < kLimit) {
+                bIsBelow = true;
+                break;
+              }
+            }
+            if (bIsBelow)
+              continue;
+          }
+        }
+
+        mixed->getPairHist()->Fill(step, fSampleIndex, posZ, track1.pt(), event2.pt[i], deltaPhi, deltaEta, eventWeight * triggerWeight * associatedWeight);
+        registry.fill(HIST("deltaEta_deltaPhi_mixed"), deltaPhi, deltaEta, eventWeight * triggerWeight * associatedWeight);
+      }
+    }
+  }
+
   template <CorrelationContainer::CFStep step, typename TTracks, typename TTracksAssoc>
   void fillCorrelationsExcludeSoloTracks(TTracks tracks1, TTracksAssoc tracks2, float posZ, int magneticField, float cent, float eventWeight) // function to fill the Output functions (sparse) and the delta eta and delta phi histograms
   {
@@ -976,6 +1065,55 @@ struct DiHadronCor {
 
   PROCESS_SWITCH(DiHadronCor, processMixed, "Process mixed events", true);
 
+  // the process for filling the mixed events with the mixing pool, which keeps the last events of each bin across the data frames
+  void processMixedPool(FilteredCollisions::iterator const& collision, FilteredTracks const& tracks, aod::BCsWithTimestamps const&)
+  {
+    if (!collision.sel8())
+      return;
+    float cent = -1.;
+    if (!cfgCentTableUnavailable) {
+      cent = getCentrality(collision);
+    }
+    if (cfgUseAdditionalEventCut && !eventSelected(collision, tracks.size(), cent, false))
+      return;
+    if (cfgSelCollByNch && (tracks.size() < cfgCutMultMin || tracks.size() >= cfgCutMultMax))
+      return;
+    if (!cfgSelCollByNch && !cfgCentTableUnavailable && (cent < cfgCutCentMin || cent >= cfgCutCentMax))
+      return;
+
+    const int bin = mixingPool.GetBin(collision.posZ(), tracks.size());
+    if (bin < 0)
+      return;
+
+    auto bc = collision.bc_as<aod::BCsWithTimestamps>();
+    loadCorrection(bc.timestamp());
+    const int magneticField = getMagneticField(bc.timestamp());
+    float weightCent = 1.0f;
+    if (!cfgCentTableUnavailable)
+      getCentralityWeight(weightCent, cent);
+
+    const int nEvents = mixingPool.GetNEvents(bin);
+    for (int i = 0; i < nEvents; i++) {
+      registry.fill(HIST("eventcount"), MixedEvent); // fill the mixed event in the 3 bin
+      float eventWeight = 1.0f;
+      if (cfgUseEventWeights) {
+        eventWeight = 1.0f / nEvents;
+      }
+      fillCorrelationsPool<CorrelationContainer::kCFStepReconstructed>(tracks, mixingPool.GetEvent(bin, i), collision.posZ(), magneticField, eventWeight * weightCent);
+    }
+
+    // the event is mixed with the next events of its bin
+    mixingPool.StartEvent(bin, collision.posZ());
+    for (auto const& track : tracks) {
+      if (!trackSelected(track))
+        continue;
+      mixingPool.AddParticle(track.pt(), track.eta(), track.phi(), track.sign());
+    }
+    mixingPool.FinishEvent();
+  }
+
+  PROCESS_SWITCH(DiHadronCor, processMixedPool, "Process mixed events with the mixing pool kept across data frames", false);
+
   int getSpecies(int pdgCode)
   {
     switch (std::abs(pdgCode)) {
@@ -41,6 +41,8 @@ class AnalysisCompositeCut : public AnalysisCut
 
   bool GetUseAND() const { return fOptionUseAND; }
   int GetNCuts() const { return fCutList.size() + fCompositeCutList.size(); }
+  const std::vector<AnalysisCut>& GetCutList() const { return fCutList; }
+  const std::vector<AnalysisCompositeCut>& GetCompositeCutList() const { return fCompositeCutList; }
 
   bool IsSelected(float* values) override;
 
@@ -0,0 +1,298 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#include "PWGDQ/Core/AnalysisCutEvaluator.h"
+
+#include "Framework/Logger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+//____________________________________________________________________________
+void AnalysisCutEvaluator::Clear()
+{
+  //
+  // remove all the cuts
+  //
+  fRangeTests.clear();
+  fFunctionTests.clear();
+  fClauses.clear();
+  fProgram.clear();
+  fOperands.clear();
+  fOpaqueCuts.clear();
+  fOutputs.clear();
+  fRangeTestIndex.clear();
+  fFunctionTestIndex.clear();
+  fClauseIndex.clear();
+  fInstructionIndex.clear();
+  fRangeResults.clear();
+  fFunctionResults.clear();
+  fResults.clear();
+}
+
+//____________________________________________________________________________
+void AnalysisCutEvaluator::AddCut(AnalysisCut* cut)
+{
+  //
+  // compile the cut and assign it to the next bit of the map
+  //
+  if (fOutputs.size() >= 64) {
+    LOG(fatal) << "AnalysisCutEvaluator: at most 64 cuts can be evaluated, cannot add the cut " << cut->GetName();
+  }
+  if (cut->IsA() == AnalysisCompositeCut::Class()) {
+    fOutputs.push_back(CompileCompositeCut(*static_cast<AnalysisCompositeCut*>(cut)));
+  } else if (cut->IsA() == AnalysisCut::Class()) {
+    fOutputs.push_back(CompileSimpleCut(*cut));
+  } else {
+    fOpaqueCuts.push_back(cut);
+    fOutputs.push_back(AddInstruction(kOpaqueCut, {static_cast<int>(fOpaqueCuts.size()) - 1}));
+  }
+}
+
+//____________________________________________________________________________
+int AnalysisCutEvaluator::CompileSimpleCut(const AnalysisCut& cut)
+{
+  //
+  // one clause per CutContainer, see AnalysisCut::IsSelected()
+  //
+  std::vector<int> clauses;
+  for (const auto& container : cut.GetCuts()) {
+    Clause clause = {};
+    clause.fDep = (container.fDepVar != -1 ? AddRangeTest(container.fDepVar, container.fDepLow, container.fDepHigh, false) : -1);
+    clause.fDepExclude = container.fDepExclude;
+    clause.fDep2 = (container.fDepVar2 != -1 ? AddRangeTest(container.fDepVar2, container.fDep2Low, container.fDep2High, false) : -1);
+    clause.fDep2Exclude = container.fDep2Exclude;
+    clause.fFunction = (container.fFuncLow != nullptr || container.fFuncHigh != nullptr);
+    clause.fTest = (clause.fFunction ? AddFunctionTest(container) : AddRangeTest(container.fVar, container.fLow, container.fHigh, true));
+    clause.fExclude = container.fExclude;
+
+    auto key = std::make_tuple(clause.fDep, clause.fDepExclude, clause.fDep2, clause.fDep2Exclude, clause.fTest, clause.fFunction, clause.fExclude);
+    auto it = fClauseIndex.find(key);
+    if (it == fClauseIndex.end()) {
+      it = fClauseIndex.emplace(key, static_cast<int>(fClauses.size())).first;
+      fClauses.push_back(clause);
+    }
+    clauses.push_back(it->second);
+  }
+  return AddInstruction(kSimpleCut, clauses);
+}
+
+//____________________________________________________________________________
+int AnalysisCutEvaluator::CompileCompositeCut(const AnalysisCompositeCut& cut)
+{
+  //
+  // the cuts of the list are compiled first, see AnalysisCompositeCut::IsSelected()
+  //
+  std::vector<int> children;
+  for (const auto& child : cut.GetCutList()) {
+    children.push_back(CompileSimpleCut(child));
+  }
+  for (const auto& child : cut.GetCompositeCutList()) {
+    children.push_back(CompileCompositeCut(child));
+  }
+  return AddInstruction(cut.GetUseAND() ? kAND : kOR, children);
+}
+
+//____________________________________________________________________________
+int AnalysisCutEvaluator::AddInstruction(InstructionType type, const std::vector<int>& operands)
+{
+  //
+  // add an instruction, or return the identical one already in the program
+  //
+  if (type != kOpaqueCut) {
+    auto it = fInstructionIndex.find(std::make_pair(static_cast<int>(type), operands));
+    if (it != fInstructionIndex.end()) {
+      return it->second;
+    }
+    fInstructionIndex.emplace(std::make_pair(static_cast<int>(type), operands), static_cast<int>(fProgram.size()));
+  }
+
+  Instruction instruction = {};
+  instruction.fType = type;
+  if (type == kOpaqueCut) {
+    instruction.fFirst = operands[0];
+    instruction.fN = 0;
+  } else {
+    instruction.fFirst = fOperands.size();
+    instruction.fN = operands.size();
+    fOperands.insert(fOperands.end(), operands.begin(), operands.end());
+  }
+  fProgram.push_back(instruction);
+  fResults.push_back(0);
+  return fProgram.size() - 1;
+}
+
+//____________________________________________________________________________
+int AnalysisCutEvaluator::AddRangeTest(short var, float low, float high, bool lowInclusive)
+{
+  auto key = std::make_tuple(var, low, high, lowInclusive);
+  auto it = fRangeTestIndex.find(key);
+  if (it != fRangeTestIndex.end()) {
+    return it->second;
+  }
+  fRangeTestIndex.emplace(key, static_cast<int>(fRangeTests.size()));
+  fRangeTests.push_back({var, low, high, lowInclusive});
+  fRangeResults.push_back(0);
+  return fRangeTests.size() - 1;
+}
+
+//____________________________________________________________________________
+int AnalysisCutEvaluator::AddFunctionTest(const AnalysisCut::CutContainer& cut)
+{
+  //
+  // the limits are tabulated only if the cut is applied in an inclusive range of the variable at which the functions are evaluated
+  //
+  bool tabulate = (fNTabulationPoints > 1 && cut.fDepVar != -1 && !cut.fDepExclude &&
+                   std::isfinite(cut.fDepLow) && std::isfinite(cut.fDepHigh) && cut.fDepHigh > cut.fDepLow);
+  float tabMin = (tabulate ? cut.fDepLow : 0.);
+  float tabMax = (tabulate ? cut.fDepHigh : 0.);
+
+  auto key = std::make_tuple(cut.fVar, cut.fDepVar, cut.fFuncLow, cut.fLow, cut.fFuncHigh, cut.fHigh, tabMin, tabMax);
+  auto it = fFunctionTestIndex.find(key);
+  if (it != fFunctionTestIndex.end()) {
+    return it->second;
+  }
+  fFunctionTestIndex.emplace(key, static_cast<int>(fFunctionTests.size()));
+
+  FunctionTest test = {};
+  test.fVar = cut.fVar;
+  test.fDepVar = cut.fDepVar;
+  test.fFuncLow = cut.fFuncLow;
+  test.fLow = cut.fLow;
+  test.fFuncHigh = cut.fFuncHigh;
+  test.fHigh = cut.fHigh;
+  if (tabulate) {
+    test.fTabMin = tabMin;
+    test.fTabStep = (tabMax - tabMin) / (fNTabulationPoints - 1);
+    for (int i = 0; i < fNTabulationPoints; ++i) {
+      float x = tabMin + i * test.fTabStep;
+      if (test.fFuncLow) {
+        test.fTabLow.push_back(test.fFuncLow->Eval(x));
+      }
+      if (test.fFuncHigh) {
+        test.fTabHigh.push_back(test.fFuncHigh->Eval(x));
+      }
+    }
+  }
+  fFunctionTests.push_back(test);
+  fFunctionResults.push_back(-1);
+  return fFunctionTests.size() - 1;
+}
+
+//____________________________________________________________________________
+float AnalysisCutEvaluator::Interpolate(const std::vector<float>& table, float min, float step, float x)
+{
+  float t = (x - min) / step;
+  int i = std::clamp(static_cast<int>(t), 0, static_cast<int>(table.size()) - 2);
+  return table[i] + (t - i) * (table[i + 1] - table[i]);
+}
+
+//____________________________________________________________________________
+bool AnalysisCutEvaluator::EvaluateFunctionTest(int iTest, float* values)
+{
+  //
+  // the result is kept for the other cuts using the same limits
+  //
+  if (fFunctionResults[iTest] >= 0) {
+    return fFunctionResults[iTest];
+  }
+  const FunctionTest& test = fFunctionTests[iTest];
+  float x = values[test.fDepVar];
+  float cutLow, cutHigh;
+  if (!test.fTabLow.empty()) {
+    cutLow = Interpolate(test.fTabLow, test.fTabMin, test.fTabStep, x);
+  } else if (test.fFuncLow) {
+    cutLow = test.fFuncLow->Eval(x);
+  } else {
+    cutLow = test.fLow;
+  }
+  if (!test.fTabHigh.empty()) {
+    cutHigh = Interpolate(test.fTabHigh, test.fTabMin, test.fTabStep, x);
+  } else if (test.fFuncHigh) {
+    cutHigh = test.fFuncHigh->Eval(x);
+  } else {
+    cutHigh = test.fHigh;
+  }
+  bool inRange = (values[test.fVar] >= cutLow && values[test.fVar] <= cutHigh);
+  fFunctionResults[iTest] = inRange;
+  return inRange;
+}
+
+//____________________________________________________________________________
+uint64_t AnalysisCutEvaluator::Evaluate(float* values)
+{
+  //
+  // run the program and return the bit map of the passed cuts
+  //
+  // range tests, all of them in one go
+  for (std::size_t i = 0; i < fRangeTests.size(); ++i) {
+    const RangeTest& test = fRangeTests[i];
+    float value = values[test.fVar];
+    fRangeResults[i] = ((test.fLowInclusive ? value >= test.fLow : value > test.fLow) && value <= test.fHigh);
+  }
+  // tests with function limits, evaluated only if needed
+  std::fill(fFunctionResults.begin(), fFunctionResults.end(), -1);
+
+  for (std::size_t i = 0; i < fProgram.size(); ++i) {
+    const Instruction& instruction = fProgram[i];
+    bool result = true;
+    switch (instruction.fType) {
+      case kSimpleCut:
+        for (int j = instruction.fFirst; j < instruction.fFirst + instruction.fN; ++j) {
+          const Clause& clause = fClauses[fOperands[j]];
+          // the clause is not applied if the dependent variables are not in the requested ranges
+          if (clause.fDep != -1 && static_cast<bool>(fRangeResults[clause.fDep]) == clause.fDepExclude) {
+            continue;
+          }
+          if (clause.fDep2 != -1 && static_cast<bool>(fRangeResults[clause.fDep2]) == clause.fDep2Exclude) {
+            continue;
+          }
+          bool inRange = (clause.fFunction ? EvaluateFunctionTest(clause.fTest, values) : static_cast<bool>(fRangeResults[clause.fTest]));
+          if (inRange == clause.fExclude) {
+            result = false;
+            break;
+          }
+        }
+        break;
+      case kAND:
+        for (int j = instruction.fFirst; j < instruction.fFirst + instruction.fN; ++j) {
+          if (!fResults[fOperands[j]]) {
+            result = false;
+            break;
+          }
+        }
+        break;
+      case kOR:
+        result = false;
+        for (int j = instruction.fFirst; j < instruction.fFirst + instruction.fN; ++j) {
+          if (fResults[fOperands[j]]) {
+            result = true;
+            break;
+          }
+        }
+        break;
+      case kOpaqueCut:
+        result = fOpaqueCuts[instruction.fFirst]->IsSelected(values);
+        break;
+    }
+    fResults[i] = result;
+  }
+
+  uint64_t filterMap = 0;
+  for (std::size_t i = 0; i < fOutputs.size(); ++i) {
+    if (fResults[fOutputs[i]]) {
+      filterMap |= (static_cast<uint64_t>(1) << i);
+    }
+  }
+  return filterMap;
+}
@@ -0,0 +1,124 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//
+// Contact: iarsene@cern.ch, i.c.arsene@fys.uio.no
+//
+// Class evaluating a list of analysis cuts in one pass and returning the bit map of the passed cuts
+//   The cuts are compiled into a flat program, in which the range tests, the function limits and the sub-cuts
+//   shared by several cuts are evaluated only once. The decision for each cut is the one of its IsSelected()
+//
+
+#ifndef AnalysisCutEvaluator_H
+#define AnalysisCutEvaluator_H
+
+#include "PWGDQ/Core/AnalysisCompositeCut.h"
+#include "PWGDQ/Core/AnalysisCut.h"
+
+#include <TF1.h>
+
+#include <cstdint>
+#include <map>
+#include <tuple>
+#include <vector>
+
+//_________________________________________________________________________
+class AnalysisCutEvaluator
+{
+ public:
+  AnalysisCutEvaluator() = default;
+  ~AnalysisCutEvaluator() = default;
+
+  // NOTE: If nPoints > 0, the TF1 limits of the cuts added afterwards are tabulated in nPoints nodes over the range of their dependent variable
+  // NOTE:   and linearly interpolated. This is possible only for limits applied in an inclusive dependent variable range, the other ones are
+  // NOTE:   always evaluated. The decisions for values close to the tabulated limits may differ from the ones of IsSelected()
+  void SetFunctionTabulation(int nPoints) { fNTabulationPoints = nPoints; }
+
+  // NOTE: The cuts are assigned to the bits of the map in the order in which they are added (at most 64 cuts)
+  void AddCut(AnalysisCut* cut);
+  void Clear();
+  int GetNCuts() const { return fOutputs.size(); }
+
+  uint64_t Evaluate(float* values);
+
+ private:
+  enum InstructionType {
+    kSimpleCut = 0, // AND over clauses, as in AnalysisCut::IsSelected()
+    kAND,           // composite cut using AND
+    kOR,            // composite cut using OR
+    kOpaqueCut      // cut of another type, evaluated through IsSelected()
+  };
+
+  struct RangeTest {
+    short fVar;         // variable to be tested
+    float fLow;         // lower limit
+    float fHigh;        // upper limit
+    bool fLowInclusive; // [low, high] for the cut ranges, (low, high] for the dependent variable ranges
+  };
+
+  struct FunctionTest {
+    short fVar;     // variable to be cut upon
+    short fDepVar;  // variable at which the functions are evaluated
+    TF1* fFuncLow;  // function for the lower limit, if any
+    float fLow;     // lower limit, if no function
+    TF1* fFuncHigh; // function for the upper limit, if any
+    float fHigh;    // upper limit, if no function
+
+    float fTabMin;               // first node of the tabulated limits
+    float fTabStep;              // distance between the nodes
+    std::vector<float> fTabLow;  // tabulated lower limit, empty if evaluated or no function
+    std::vector<float> fTabHigh; // tabulated upper limit, empty if evaluated or no function
+  };
+
+  struct Clause {
+    int fDep;          // range test of the first dependent variable, -1 if none
+    bool fDepExclude;  // use the first dependent variable range as exclusion
+    int fDep2;         // range test of the second dependent variable, -1 if none
+    bool fDep2Exclude; // use the second dependent variable range as exclusion
+    int fTest;         // range or function test of the variable
+    bool fFunction;    // fTest is a function test
+    bool fExclude;     // use the selection range for exclusion
+  };
+
+  struct Instruction {
+    InstructionType fType;
+    int fFirst; // first operand in fOperands (clauses for kSimpleCut, instructions for kAND/kOR, cut in fOpaqueCuts for kOpaqueCut)
+    int fN;     // number of operands
+  };
+
+  int CompileSimpleCut(const AnalysisCut& cut);
+  int CompileCompositeCut(const AnalysisCompositeCut& cut);
+  int AddInstruction(InstructionType type, const std::vector<int>& operands);
+  int AddRangeTest(short var, float low, float high, bool lowInclusive);
+  int AddFunctionTest(const AnalysisCut::CutContainer& cut);
+  bool EvaluateFunctionTest(int iTest, float* values);
+  static float Interpolate(const std::vector<float>& table, float min, float step, float x);
+
+  int fNTabulationPoints = 0;
+
+  std::vector<RangeTest> fRangeTests;       // range tests shared by all the cuts
+  std::vector<FunctionTest> fFunctionTests; // tests with function limits, evaluated when needed
+  std::vector<Clause> fClauses;             // one clause per CutContainer
+  std::vector<Instruction> fProgram;        // instructions, each one only depending on the previous ones
+  std::vector<int> fOperands;               // operands of the instructions
+  std::vector<AnalysisCut*> fOpaqueCuts;    // cuts not compiled
+  std::vector<int> fOutputs;                // instruction giving the decision for each bit
+
+  std::map<std::tuple<short, float, float, bool>, int> fRangeTestIndex;
+  std::map<std::tuple<short, short, TF1*, float, TF1*, float, float, float>, int> fFunctionTestIndex;
+  std::map<std::tuple<int, bool, int, bool, int, bool, bool>, int> fClauseIndex;
+  std::map<std::pair<int, std::vector<int>>, int> fInstructionIndex;
+
+  std::vector<char> fRangeResults;    // results of the range tests for the current values
+  std::vector<char> fFunctionResults; // results of the function tests, -1 if not evaluated yet
+  std::vector<char> fResults;         // results of the instructions
+};
+
+#endif
@@ -11,6 +11,7 @@
 
 #include "PWGDQ/Core/HistogramManager.h"
 
+#include <cstddef>
 #include <iostream>
 #include <memory>
 #include <fstream>
@@ -45,7 +46,15 @@ HistogramManager::HistogramManager() : TNamed("", ""),
                                        fUseDefaultVariableNames(false),
                                        fBinsAllocated(0),
                                        fVariableNames(nullptr),
-                                       fVariableUnits(nullptr)
+                                       fVariableUnits(nullptr),
+                                       fFillPlan(),
+                                       fFillPlanTHnVars(),
+                                       fFillPlanOffsets(),
+                                       fFillPlanHandles(),
+                                       fFillPlanDirty(true),
+                                       fUseSparseAccumulators(false),
+                                       fAccumulatorMaxEntries(1000000),
+                                       fAccumulators()
 {
   //
   // Constructor
@@ -61,7 +70,15 @@ HistogramManager::HistogramManager(const char* name, const char* title, const in
                                                                                               fUseDefaultVariableNames(kFALSE),
                                                                                               fBinsAllocated(0),
                                                                                               fVariableNames(),
-                                                                                              fVariableUnits()
+                                                                                              fVariableUnits(),
+                                                                                              fFillPlan(),
+                                                                                              fFillPlanTHnVars(),
+                                                                                              fFillPlanOffsets(),
+                                                                                              fFillPlanHandles(),
+                                                                                              fFillPlanDirty(true),
+                                                                                              fUseSparseAccumulators(false),
+                                                                                              fAccumulatorMaxEntries(1000000),
+                                                                                              fAccumulators()
 {
   //
   // Constructor
@@ -116,6 +133,7 @@ void HistogramManager::AddHistClass(const char* histClass)
   fMainList->Add(hList);
   std::list<std::vector<int>> varList;
   fVariablesMap[histClass] = varList;
+  fFillPlanDirty = true;
 }
 
 //_________________________________________________________________
@@ -187,6 +205,7 @@ void HistogramManager::AddHistogram(const char* histClass, const char* hname, co
   std::list varList = fVariablesMap[histClass];
   varList.push_back(varVector);
   fVariablesMap[histClass] = varList;
+  fFillPlanDirty = true;
 
   // create and configure histograms according to required options
   TH1* h = nullptr;
@@ -397,6 +416,7 @@ void HistogramManager::AddHistogram(const char* histClass, const char* hname, co
   std::list varList = fVariablesMap[histClass];
   varList.push_back(varVector);
   fVariablesMap[histClass] = varList;
+  fFillPlanDirty = true;
 
   TH1* h = nullptr;
   switch (dimension) {
@@ -582,6 +602,7 @@ void HistogramManager::AddHistogram(const char* histClass, const char* hname, co
   std::list varList = fVariablesMap[histClass];
   varList.push_back(varVector);
   fVariablesMap[histClass] = varList;
+  fFillPlanDirty = true;
 
   uint32_t nbins = 1;
   THnBase* h = nullptr;
@@ -675,6 +696,7 @@ void HistogramManager::AddHistogram(const char* histClass, const char* hname, co
   std::list varList = fVariablesMap[histClass];
   varList.push_back(varVector);
   fVariablesMap[histClass] = varList;
+  fFillPlanDirty = true;
 
   // get the min and max for each axis
   auto* xmin = new double[nDimensions];
@@ -741,158 +763,342 @@ void HistogramManager::AddHistogram(const char* histClass, const char* hname, co
 }
 
 //__________________________________________________________________
-void HistogramManager::FillHistClass(const char* className, Float_t* values)
+void HistogramManager::CompileFillPlan()
 {
   //
-  //  fill a class of histograms
+  // Resolve all histogram classes into a flat array of fill entries, indexed by an integer handle
+  //  For each histogram, the type of the Fill() call is decided here once, so that the fill loop does not need
+  //  to look-up lists, decode the variable vectors or call TH1::GetDimension()
   //
+  // the accumulated fills are added to the histograms before the accumulators are rebuilt
+  FlushAccumulators();
+  fAccumulators.clear();
+  fFillPlan.clear();
+  fFillPlanTHnVars.clear();
+  fFillPlanOffsets.clear();
+  fFillPlanHandles.clear();
 
-  // get the needed histogram list
-  auto* hList = reinterpret_cast<TList*>(fMainList->FindObject(className));
-  if (!hList) {
-    // TODO: add some meaningfull error message
-    /*LOG(warn) << "HistogramManager::FillHistClass(): Histogram list " << className << " not found!";
-    LOG(warn) << "         Histogram list not filled" << endl; */
-    return;
-  }
-
-  // get the corresponding std::list containng identifiers to the needed variables to be filled
-  auto const& varList = fVariablesMap[className];
-
-  TIter next(hList);
-
-  TObject* h = nullptr;
-  bool isProfile;
-  bool isTHn;
-  int dimension = 0;
-  bool isSparse = kFALSE;
-  bool isFillLabelx = kFALSE;
-  // TODO: At the moment, maximum 20 dimensions are foreseen for the THn histograms. We should make this more dynamic
-  //       But maybe its better to have it like to avoid dynamically allocating this array in the histogram loop
-  double fillValues[20] = {0.0};
-  int varX = -1, varY = -1, varZ = -1, varT = -1, varW = -1;
-
-  // loop over the histogram and std::list
-  // NOTE: these two should contain the same number of elements and be synchronized, otherwise its a mess
-  for (auto varIter = varList.begin(); varIter != varList.end(); varIter++) {
-    h = next(); // get the histogram
-    // decode information from the vector of indices
-    isProfile = ((*varIter)[0] == 1 ? true : false);
-    isTHn = ((*varIter)[1] > 0 ? true : false);
-    if (isTHn) {
-      dimension = (*varIter)[1];
-    } else {
-      dimension = (reinterpret_cast<TH1*>(h))->GetDimension();
-    }
+  for (int iclass = 0; iclass < fMainList->GetEntries(); ++iclass) {
+    auto* hList = reinterpret_cast<TList*>(fMainList->At(iclass));
+    fFillPlanHandles[hList->GetName()] = iclass;
+    fFillPlanOffsets.push_back(fFillPlan.size());
 
-    // get the various variable indices
-    varW = (*varIter)[2];
-    if (isTHn) {
-      for (int i = 0; i < dimension; i++) {
-        fillValues[i] = values[(*varIter)[3 + i]];
+    auto const& varList = fVariablesMap[hList->GetName()];
+    TIter next(hList);
+    // NOTE: the histogram list and the std::list of variables are synchronized
+    for (auto varIter = varList.begin(); varIter != varList.end(); varIter++) {
+      TObject* h = next();
+      FillPlanEntry entry{h, kFillTHn, (*varIter)[2], {kNothing, kNothing, kNothing, kNothing}, 0, 0, kNothing};
+      bool isProfile = ((*varIter)[0] == 1);
+      if ((*varIter)[1] > 0) { // THn
+        entry.fNDim = (*varIter)[1];
+        entry.fTHnOffset = fFillPlanTHnVars.size();
+        for (int idim = 0; idim < entry.fNDim; ++idim) {
+          fFillPlanTHnVars.push_back((*varIter)[3 + idim]);
+        }
+        if (fUseSparseAccumulators && h->InheritsFrom(THnSparse::Class()) && MakeAccumulator(reinterpret_cast<THnBase*>(h))) {
+          entry.fKind = kFillTHnAccumulated;
+          entry.fAccumulator = fAccumulators.size() - 1;
+        }
+        fFillPlan.push_back(entry);
+        continue;
       }
-    } else {
-      varX = (*varIter)[3];
-      varY = (*varIter)[4];
-      varZ = (*varIter)[5];
-      varT = (*varIter)[6];
-      isFillLabelx = ((*varIter)[7] == 1 ? true : false);
-    }
-
-    if (!isTHn) {
-      switch (dimension) {
+      for (int i = 0; i < 4; ++i) {
+        entry.fVars[i] = (*varIter)[3 + i];
+      }
+      bool isFillLabelx = ((*varIter)[7] == 1);
+      switch ((reinterpret_cast<TH1*>(h))->GetDimension()) {
         case 1:
           if (isProfile) {
-            if (varW > kNothing) {
-              if (isFillLabelx) {
-                (reinterpret_cast<TProfile*>(h))->Fill(Form("%d", static_cast<int>(values[varX])), values[varY], values[varW]);
-              } else {
-                (reinterpret_cast<TProfile*>(h))->Fill(values[varX], values[varY], values[varW]);
-              }
-            } else {
-              if (isFillLabelx) {
-                (reinterpret_cast<TProfile*>(h))->Fill(Form("%d", static_cast<int>(values[varX])), values[varY]);
-              } else {
-                (reinterpret_cast<TProfile*>(h))->Fill(values[varX], values[varY]);
-              }
-            }
+            entry.fKind = (isFillLabelx ? kFillTProfileLabel : kFillTProfile);
           } else {
-            if (varW > kNothing) {
-              if (isFillLabelx) {
-                (reinterpret_cast<TH1*>(h))->Fill(Form("%d", static_cast<int>(values[varX])), values[varW]);
-              } else {
-                (reinterpret_cast<TH1*>(h))->Fill(values[varX], values[varW]);
-              }
-            } else {
-              if (isFillLabelx) {
-                (reinterpret_cast<TH1*>(h))->Fill(Form("%d", static_cast<int>(values[varX])), 1.);
-              } else {
-                (reinterpret_cast<TH1*>(h))->Fill(values[varX]);
-              }
-            }
+            entry.fKind = (isFillLabelx ? kFillTH1Label : kFillTH1);
           }
           break;
         case 2:
           if (isProfile) {
-            if (varW > kNothing) {
-              (reinterpret_cast<TProfile2D*>(h))->Fill(values[varX], values[varY], values[varZ], values[varW]);
-            } else {
-              (reinterpret_cast<TProfile2D*>(h))->Fill(values[varX], values[varY], values[varZ]);
-            }
+            entry.fKind = kFillTProfile2D;
           } else {
-            if (varW > kNothing) {
-              if (isFillLabelx) {
-                (reinterpret_cast<TH2*>(h))->Fill(Form("%d", static_cast<int>(values[varX])), values[varY], values[varW]);
-              } else {
-                (reinterpret_cast<TH2*>(h))->Fill(values[varX], values[varY], values[varW]);
-              }
-            } else {
-              if (isFillLabelx) {
-                (reinterpret_cast<TH2*>(h))->Fill(Form("%d", static_cast<int>(values[varX])), values[varY], 1.);
-              } else {
-                (reinterpret_cast<TH2*>(h))->Fill(values[varX], values[varY]);
-              }
-            }
+            entry.fKind = (isFillLabelx ? kFillTH2Label : kFillTH2);
           }
           break;
         case 3:
-          if (isProfile) {
-            if (varW > kNothing) {
-              (reinterpret_cast<TProfile3D*>(h))->Fill(values[varX], values[varY], values[varZ], values[varT], values[varW]);
-            } else {
-              (reinterpret_cast<TProfile3D*>(h))->Fill(values[varX], values[varY], values[varZ], values[varT]);
-            }
-          } else {
-            if (varW > kNothing) {
-              (reinterpret_cast<TH3*>(h))->Fill(values[varX], values[varY], values[varZ], values[varW]);
-            } else {
-              (reinterpret_cast<TH3*>(h))->Fill(values[varX], values[varY], values[varZ]);
-            }
-          }
+          entry.fKind = (isProfile ? kFillTProfile3D : kFillTH3);
           break;
-
         default:
-          break;
-      } // end switch
-      // end if(!isTHn)
-    } else {
-      if (varW > kNothing) {
-        if (isSparse) {
-          (reinterpret_cast<THnSparse*>(h))->Fill(fillValues, values[varW]);
+          continue;
+      }
+      fFillPlan.push_back(entry);
+    }
+  }
+  fFillPlanOffsets.push_back(fFillPlan.size());
+  fFillPlanDirty = false;
+}
+
+//__________________________________________________________________
+int HistogramManager::GetHistClassHandle(const char* className)
+{
+  //
+  // Get the integer handle of a histogram class
+  //
+  if (fFillPlanDirty) {
+    CompileFillPlan();
+  }
+  auto it = fFillPlanHandles.find(className);
+  if (it == fFillPlanHandles.end()) {
+    return kNothing;
+  }
+  return it->second;
+}
+
+//__________________________________________________________________
+void HistogramManager::FillHistClass(const char* className, Float_t* values)
+{
+  //
+  //  fill a class of histograms
+  //
+  int handle = GetHistClassHandle(className);
+  if (handle == kNothing) {
+    // TODO: add some meaningfull error message
+    /*LOG(warn) << "HistogramManager::FillHistClass(): Histogram list " << className << " not found!";
+    LOG(warn) << "         Histogram list not filled" << endl; */
+    return;
+  }
+  FillHistClass(handle, values);
+}
+
+//__________________________________________________________________
+void HistogramManager::FillHistClass(int handle, Float_t* values)
+{
+  //
+  //  fill a class of histograms using the compiled fill plan
+  //
+  if (fFillPlanDirty) {
+    // histograms were added after the handles were obtained; handles stay valid since classes are only appended
+    CompileFillPlan();
+  }
+
+  // TODO: At the moment, maximum 20 dimensions are foreseen for the THn histograms. We should make this more dynamic
+  //       But maybe its better to have it like to avoid dynamically allocating this array in the histogram loop
+  double fillValues[20] = {0.0};
+
+  const FillPlanEntry* entry = fFillPlan.data() + fFillPlanOffsets[handle];
+  const FillPlanEntry* last = fFillPlan.data() + fFillPlanOffsets[handle + 1];
+  for (; entry != last; ++entry) {
+    TObject* h = entry->fHist;
+    const int* vars = entry->fVars;
+    const int varW = entry->fVarW;
+    switch (entry->fKind) {
+      case kFillTH1:
+        if (varW > kNothing) {
+          (reinterpret_cast<TH1*>(h))->Fill(values[vars[0]], values[varW]);
         } else {
-          (reinterpret_cast<THn*>(h))->Fill(fillValues, values[varW]);
+          (reinterpret_cast<TH1*>(h))->Fill(values[vars[0]]);
         }
-      } else {
-        if (isSparse) {
-          (reinterpret_cast<THnSparse*>(h))->Fill(fillValues);
+        break;
+      case kFillTH1Label:
+        (reinterpret_cast<TH1*>(h))->Fill(Form("%d", static_cast<int>(values[vars[0]])), (varW > kNothing ? values[varW] : 1.));
+        break;
+      case kFillTProfile:
+        if (varW > kNothing) {
+          (reinterpret_cast<TProfile*>(h))->Fill(values[vars[0]], values[vars[1]], values[varW]);
         } else {
-          (reinterpret_cast<THn*>(h))->Fill(fillValues);
+          (reinterpret_cast<TProfile*>(h))->Fill(values[vars[0]], values[vars[1]]);
         }
-      }
-    } // end else
+        break;
+      case kFillTProfileLabel:
+        if (varW > kNothing) {
+          (reinterpret_cast<TProfile*>(h))->Fill(Form("%d", static_cast<int>(values[vars[0]])), values[vars[1]], values[varW]);
+        } else {
+          (reinterpret_cast<TProfile*>(h))->Fill(Form("%d", static_cast<int>(values[vars[0]])), values[vars[1]]);
+        }
+        break;
+      case kFillTH2:
+        if (varW > kNothing) {
+          (reinterpret_cast<TH2*>(h))->Fill(values[vars[0]], values[vars[1]], values[varW]);
+        } else {
+          (reinterpret_cast<TH2*>(h))->Fill(values[vars[0]], values[vars[1]]);
+        }
+        break;
+      case kFillTH2Label:
+        (reinterpret_cast<TH2*>(h))->Fill(Form("%d", static_cast<int>(values[vars[0]])), values[vars[1]], (varW > kNothing ? values[varW] : 1.));
+        break;
+      case kFillTProfile2D:
+        if (varW > kNothing) {
+          (reinterpret_cast<TProfile2D*>(h))->Fill(values[vars[0]], values[vars[1]], values[vars[2]], values[varW]);
+        } else {
+          (reinterpret_cast<TProfile2D*>(h))->Fill(values[vars[0]], values[vars[1]], values[vars[2]]);
+        }
+        break;
+      case kFillTH3:
+        if (varW > kNothing) {
+          (reinterpret_cast<TH3*>(h))->Fill(values[vars[0]], values[vars[1]], values[vars[2]], values[varW]);
+        } else {
+          (reinterpret_cast<TH3*>(h))->Fill(values[vars[0]], values[vars[1]], values[vars[2]]);
+        }
+        break;
+      case kFillTProfile3D:
+        if (varW > kNothing) {
+          (reinterpret_cast<TProfile3D*>(h))->Fill(values[vars[0]], values[vars[1]], values[vars[2]], values[vars[3]], values[varW]);
+        } else {
+          (reinterpret_cast<TProfile3D*>(h))->Fill(values[vars[0]], values[vars[1]], values[vars[2]], values[vars[3]]);
+        }
+        break;
+      case kFillTHn: {
+        const int* thnVars = fFillPlanTHnVars.data() + entry->fTHnOffset;
+        for (int i = 0; i < entry->fNDim; i++) {
+          fillValues[i] = values[thnVars[i]];
+        }
+        // NOTE: THnBase::Fill() is used for both THn and THnSparse
+        if (varW > kNothing) {
+          (reinterpret_cast<THnBase*>(h))->Fill(fillValues, values[varW]);
+        } else {
+          (reinterpret_cast<THnBase*>(h))->Fill(fillValues);
+        }
+      } break;
+      case kFillTHnAccumulated: {
+        const int* thnVars = fFillPlanTHnVars.data() + entry->fTHnOffset;
+        for (int i = 0; i < entry->fNDim; i++) {
+          fillValues[i] = values[thnVars[i]];
+        }
+        Accumulate(fAccumulators[entry->fAccumulator], fillValues, (varW > kNothing ? values[varW] : 1.));
+      } break;
+      default:
+        break;
+    } // end switch
   } // end loop over histograms
 }
 
+//__________________________________________________________________
+bool HistogramManager::MakeAccumulator(THnBase* h)
+{
+  //
+  // Create the accumulator of a THnSparse, if the bin coordinates (including the under- and overflow bins) can be packed in 64 bits
+  //
+  SparseAccumulator acc;
+  acc.fHist = h;
+  int nBits = 0;
+  for (int idim = 0; idim < h->GetNdimensions(); ++idim) {
+    TAxis* axis = h->GetAxis(idim);
+    int nBitsAxis = 1;
+    while ((static_cast<uint64_t>(1) << nBitsAxis) < static_cast<uint64_t>(axis->GetNbins() + 2)) {
+      nBitsAxis++;
+    }
+    acc.fAxes.push_back(axis);
+    acc.fShifts.push_back(nBits);
+    acc.fMasks.push_back((static_cast<uint64_t>(1) << nBitsAxis) - 1);
+    nBits += nBitsAxis;
+  }
+  // NOTE: one bit is kept free, such that kEmptyKey is never a valid key
+  if (nBits > 63) {
+    LOG(info) << "HistogramManager: the bins of " << h->GetName() << " cannot be accumulated (" << nBits << " bits needed), the histogram is filled directly";
+    return false;
+  }
+  acc.fNUsed = 0;
+  acc.fNFills = 0;
+  Rehash(acc, 1024);
+  fAccumulators.push_back(acc);
+  return true;
+}
+
+//__________________________________________________________________
+void HistogramManager::Rehash(SparseAccumulator& acc, int64_t size)
+{
+  //
+  // Move the accumulated bins to a hash table of the given size (power of 2)
+  //
+  std::vector<uint64_t> keys(size, kEmptyKey);
+  std::vector<double> sumW(size, 0.);
+  std::vector<double> sumW2(size, 0.);
+  uint64_t mask = size - 1;
+  for (std::size_t i = 0; i < acc.fKeys.size(); ++i) {
+    if (acc.fKeys[i] == kEmptyKey) {
+      continue;
+    }
+    uint64_t slot = ((acc.fKeys[i] * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+    while (keys[slot] != kEmptyKey) {
+      slot = (slot + 1) & mask;
+    }
+    keys[slot] = acc.fKeys[i];
+    sumW[slot] = acc.fSumW[i];
+    sumW2[slot] = acc.fSumW2[i];
+  }
+  acc.fKeys.swap(keys);
+  acc.fSumW.swap(sumW);
+  acc.fSumW2.swap(sumW2);
+}
+
+//__________________________________________________________________
+void HistogramManager::Accumulate(SparseAccumulator& acc, const double* x, double w)
+{
+  //
+  // Add a fill to the bin of the accumulator, the bins are found as in THnBase::Fill()
+  //
+  uint64_t key = 0;
+  for (std::size_t idim = 0; idim < acc.fAxes.size(); ++idim) {
+    key |= static_cast<uint64_t>(acc.fAxes[idim]->FindFixBin(x[idim])) << acc.fShifts[idim];
+  }
+  uint64_t mask = acc.fKeys.size() - 1;
+  uint64_t slot = ((key * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+  while (acc.fKeys[slot] != key && acc.fKeys[slot] != kEmptyKey) {
+    slot = (slot + 1) & mask;
+  }
+  if (acc.fKeys[slot] == kEmptyKey) {
+    acc.fKeys[slot] = key;
+    acc.fNUsed++;
+  }
+  acc.fSumW[slot] += w;
+  acc.fSumW2[slot] += w * w;
+  acc.fNFills++;
+
+  if (fAccumulatorMaxEntries > 0 && acc.fNUsed >= fAccumulatorMaxEntries) {
+    Flush(acc);
+  } else if (2 * acc.fNUsed > static_cast<int64_t>(acc.fKeys.size())) {
+    Rehash(acc, 2 * acc.fKeys.size());
+  }
+}
+
+//__________________________________________________________________
+void HistogramManager::Flush(SparseAccumulator& acc)
+{
+  //
+  // Add the accumulated bins to the THnSparse and reset the accumulator
+  //
+  if (acc.fNFills == 0) {
+    return;
+  }
+  // TODO: At the moment, maximum 20 dimensions are foreseen for the THn histograms
+  int coord[20] = {0};
+  for (std::size_t i = 0; i < acc.fKeys.size(); ++i) {
+    if (acc.fKeys[i] == kEmptyKey) {
+      continue;
+    }
+    for (std::size_t idim = 0; idim < acc.fAxes.size(); ++idim) {
+      coord[idim] = (acc.fKeys[i] >> acc.fShifts[idim]) & acc.fMasks[idim];
+    }
+    Long64_t bin = acc.fHist->GetBin(coord, kTRUE);
+    acc.fHist->AddBinContent(bin, acc.fSumW[i]);
+    acc.fHist->AddBinError2(bin, acc.fSumW2[i]);
+    acc.fKeys[i] = kEmptyKey;
+    acc.fSumW[i] = 0.;
+    acc.fSumW2[i] = 0.;
+  }
+  acc.fHist->SetEntries(acc.fHist->GetEntries() + acc.fNFills);
+  acc.fNUsed = 0;
+  acc.fNFills = 0;
+}
+
+//__________________________________________________________________
+void HistogramManager::FlushAccumulators()
+{
+  //
+  // Add the accumulated fills to all the THnSparse histograms
+  //
+  for (auto& acc : fAccumulators) {
+    Flush(acc);
+  }
+}
+
 //____________________________________________________________________________________
 void HistogramManager::MakeAxisLabels(TAxis* ax, const char* labels)
 {
@@ -23,7 +23,9 @@
 #include <THashList.h>
 #include <TAxis.h>
 #include <TArrayD.h>
+#include <THnBase.h>
 
+#include <cstdint>
 #include <string>
 #include <map>
 #include <vector>
@@ -85,6 +87,11 @@ class HistogramManager : public TNamed
                     TString* axLabels = nullptr, int varW = -1, bool useSparse = kFALSE, bool isdouble = false);
 
   void FillHistClass(const char* className, float* values);
+  // Fill a class of histograms using the integer handle obtained from GetHistClassHandle()
+  // This skips the string lookup and uses the pre-compiled fill plan of the class
+  void FillHistClass(int handle, float* values);
+  // Get the handle of a histogram class to be used with FillHistClass(int, float*); returns kNothing if the class does not exist
+  int GetHistClassHandle(const char* className);
 
   void SetUseDefaultVariableNames(bool flag) { fUseDefaultVariableNames = flag; }
   void SetDefaultVarNames(TString* vars, TString* units);
@@ -92,6 +99,18 @@ class HistogramManager : public TNamed
 
   THashList* GetMainHistogramList() { return fMainList; } // get a histogram list
 
+  // NOTE: If enabled, the fills of the THnSparse histograms are accumulated in a hash map of the bin coordinates and added to the histograms
+  // NOTE:   only with FlushAccumulators() (or when an accumulator reaches maxEntries bins), such that the repeated fills of a bin cost a single bin update.
+  // NOTE:   The bin contents, errors and number of entries are the same as with direct fills, but the fill statistics of the THnSparse are not kept.
+  // NOTE:   FlushAccumulators() needs to be called before the histograms are written, e.g. at the end of each data frame
+  void SetUseSparseAccumulators(bool flag, int64_t maxEntries = 1000000)
+  {
+    fUseSparseAccumulators = flag;
+    fAccumulatorMaxEntries = maxEntries;
+    fFillPlanDirty = true;
+  }
+  void FlushAccumulators();
+
   uint64_t GetAllocatedBins() const { return fBinsAllocated; }
   void Print(Option_t*) const override;
 
@@ -102,6 +121,53 @@ class HistogramManager : public TNamed
   bool* fUsedVars;                                                  //! flags of used variables
   std::map<std::string, std::list<std::vector<int>>> fVariablesMap; //!  map holding identifiers for all variables needed by histograms
 
+  // type of fill call resolved at compile time for each histogram
+  enum FillKind {
+    kFillTH1 = 0,
+    kFillTH1Label,
+    kFillTH2,
+    kFillTH2Label,
+    kFillTH3,
+    kFillTProfile,
+    kFillTProfileLabel,
+    kFillTProfile2D,
+    kFillTProfile3D,
+    kFillTHn,
+    kFillTHnAccumulated
+  };
+  // one compiled entry for each histogram: everything needed for the Fill() call
+  struct FillPlanEntry {
+    TObject* fHist;   // histogram to be filled
+    int fKind;        // one of the FillKind values
+    int fVarW;        // weight variable, kNothing if not used
+    int fVars[4];     // x, y, z and t variables for TH1/TProfile types
+    int fNDim;        // number of dimensions for THn
+    int fTHnOffset;   // offset in fFillPlanTHnVars of the THn axis variables
+    int fAccumulator; // index in fAccumulators for kFillTHnAccumulated
+  };
+  // open addressing hash map of the bin coordinates of a THnSparse, packed in a 64 bit key, to the sums of weights and squared weights
+  struct SparseAccumulator {
+    THnBase* fHist;               // histogram receiving the accumulated fills
+    std::vector<TAxis*> fAxes;    // axes of the histogram
+    std::vector<int> fShifts;     // bit offset of each coordinate in the key
+    std::vector<uint64_t> fMasks; // bit mask of each coordinate
+    std::vector<uint64_t> fKeys;  // packed bin coordinates, kEmptyKey for empty slots
+    std::vector<double> fSumW;    // sum of weights
+    std::vector<double> fSumW2;   // sum of squared weights
+    int64_t fNUsed;               // number of used slots
+    int64_t fNFills;              // number of fills since the last flush
+  };
+  static constexpr uint64_t kEmptyKey = ~static_cast<uint64_t>(0);
+
+  std::vector<FillPlanEntry> fFillPlan;         //! flat array of fill entries for all histogram classes
+  std::vector<int> fFillPlanTHnVars;            //! flat array with the axis variables of all THn histograms
+  std::vector<int> fFillPlanOffsets;            //! start index in fFillPlan for each handle (size = number of classes + 1)
+  std::map<std::string, int> fFillPlanHandles;  //! histogram class name -> handle
+  bool fFillPlanDirty;                          //! the fill plan needs to be (re)compiled
+  bool fUseSparseAccumulators;                  //! accumulate the fills of the THnSparse histograms
+  int64_t fAccumulatorMaxEntries;               //! number of bins of an accumulator triggering its flush
+  std::vector<SparseAccumulator> fAccumulators; //! accumulators of the THnSparse histograms
+
   // various
   bool fUseDefaultVariableNames;    //! toggle the usage of default variable names and units
   uint64_t fBinsAllocated;          //! number of allocated bins
@@ -109,6 +175,11 @@ class HistogramManager : public TNamed
   TString* fVariableUnits;          //! variable units
 
   void MakeAxisLabels(TAxis* ax, const char* labels);
+  void CompileFillPlan();
+  bool MakeAccumulator(THnBase* h);
+  void Accumulate(SparseAccumulator& acc, const double* x, double w);
+  void Rehash(SparseAccumulator& acc, int64_t size);
+  void Flush(SparseAccumulator& acc);
 
   HistogramManager& operator=(const HistogramManager& c);
   HistogramManager(const HistogramManager& c);
@@ -118,6 +118,25 @@ class MCSignal : public TNamed
 
   void PrintConfig();
 
+  // accessors used by MCSignalMatcher to identify the prongs shared by several signals
+  const MCProng& GetProng(int i) const
+  {
+    return fProngs[i];
+  }
+  int8_t GetCommonAncestorIdx(int i) const
+  {
+    return fCommonAncestorIdxs[i];
+  }
+  bool GetExcludeCommonAncestor() const
+  {
+    return fExcludeCommonAncestor;
+  }
+
+  // Check prong i of this signal for the given particle, except for the comparison of the common ancestor with the one of the other prongs.
+  //   If the generation of the common ancestor is reached, its global index is returned in ancestorLabel, which is left unchanged otherwise
+  template <typename T>
+  bool TestProng(int i, bool checkSources, const T& track, int& ancestorLabel);
+
  private:
   std::vector<MCProng> fProngs;            // vector of MCProng
   unsigned int fNProngs;                   // number of prongs
@@ -131,6 +150,7 @@ class MCSignal : public TNamed
   template <typename T>
   bool CheckProng(int i, bool checkSources, const T& track);
 
+
   bool CheckMC(int, bool)
   {
     return true;
@@ -150,6 +170,27 @@ class MCSignal : public TNamed
 
 template <typename T>
 bool MCSignal::CheckProng(int i, bool checkSources, const T& track)
+{
+  int ancestorLabel = -1;
+  if (!TestProng(i, checkSources, track, ancestorLabel)) {
+    return false;
+  }
+  // check the common ancestor (if specified)
+  if (ancestorLabel >= 0) {
+    if (i == 0) {
+      fTempAncestorLabel = ancestorLabel;
+    } else {
+      if (ancestorLabel != fTempAncestorLabel && !fExcludeCommonAncestor)
+        return false;
+      else if (ancestorLabel == fTempAncestorLabel && fExcludeCommonAncestor)
+        return false;
+    }
+  }
+  return true;
+}
+
+template <typename T>
+bool MCSignal::TestProng(int i, bool checkSources, const T& track, int& ancestorLabel)
 {
   using P = typename T::parent_t;
   auto currentMCParticle = track;
@@ -162,8 +203,8 @@ bool MCSignal::CheckProng(int i, bool checkSources, const T& track)
     }
     // check the common ancestor (if specified)
     if (fNProngs > 1 && fCommonAncestorIdxs[i] == j) {
+      ancestorLabel = currentMCParticle.globalIndex();
       if (i == 0) {
-        fTempAncestorLabel = currentMCParticle.globalIndex();
         // In the case of decay channels marked as being "exclusive", check how many decay daughters this mother has registered
         //   in the stack and compare to the number of prongs defined for this MCSignal.
         //  If these numbers are equal, it means this decay MCSignal match is exclusive (there are no additional prongs for this mother besides the
@@ -176,11 +217,6 @@ bool MCSignal::CheckProng(int i, bool checkSources, const T& track)
             return false;
           }
         }
-      } else {
-        if (currentMCParticle.globalIndex() != fTempAncestorLabel && !fExcludeCommonAncestor)
-          return false;
-        else if (currentMCParticle.globalIndex() == fTempAncestorLabel && fExcludeCommonAncestor)
-          return false;
       }
     }
 
@@ -0,0 +1,143 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#include "PWGDQ/Core/MCSignalMatcher.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace
+{
+// effective settings of the common ancestor check done in MCSignal::TestProng() for a given prong
+struct AncestorSettings {
+  int fIdx = -1;                  // generation of the common ancestor, -1 if not checked
+  bool fExclusive = false;        // exclusive decay channel of the common ancestor (prong 0 only)
+  bool fNotExclusive = false;     // not exclusive decay channel of the common ancestor (prong 0 only)
+  int fNAncestorDirectProngs = 0; // number of direct prongs of the common ancestor (prong 0 only)
+};
+
+AncestorSettings GetAncestorSettings(const MCSignal* signal, int prong)
+{
+  AncestorSettings settings;
+  if (signal->GetNProngs() < 2 || signal->GetCommonAncestorIdx(prong) < 0) {
+    return settings;
+  }
+  settings.fIdx = signal->GetCommonAncestorIdx(prong);
+  if (prong == 0) {
+    settings.fExclusive = signal->GetDecayChannelIsExclusive();
+    settings.fNotExclusive = signal->GetDecayChannelIsNotExclusive();
+    if (settings.fExclusive || settings.fNotExclusive) {
+      settings.fNAncestorDirectProngs = signal->GetNAncestorDirectProngs();
+    }
+  }
+  return settings;
+}
+
+bool SameProng(const MCProng& p1, const MCProng& p2)
+{
+  return p1.fNGenerations == p2.fNGenerations && p1.fPDGcodes == p2.fPDGcodes && p1.fCheckBothCharges == p2.fCheckBothCharges &&
+         p1.fExcludePDG == p2.fExcludePDG && p1.fSourceBits == p2.fSourceBits && p1.fExcludeSource == p2.fExcludeSource &&
+         p1.fUseANDonSourceBitMap == p2.fUseANDonSourceBitMap && p1.fCheckGenerationsInTime == p2.fCheckGenerationsInTime &&
+         p1.fPDGInHistory == p2.fPDGInHistory && p1.fExcludePDGInHistory == p2.fExcludePDGInHistory;
+}
+} // namespace
+
+//____________________________________________________________________________
+void MCSignalMatcher::Clear()
+{
+  fSignals.clear();
+  fTests.clear();
+  fNWords = 0;
+  fNAncestorSlots = 0;
+  fNParticles = 0;
+  fDecisions.clear();
+  fAncestorLabels.clear();
+}
+
+//____________________________________________________________________________
+bool MCSignalMatcher::SameProngTest(const MCSignal* signal, int prong, const ProngTest& test) const
+{
+  AncestorSettings s1 = GetAncestorSettings(signal, prong);
+  AncestorSettings s2 = GetAncestorSettings(test.fSignal, test.fProng);
+  if (s1.fIdx != s2.fIdx || s1.fExclusive != s2.fExclusive || s1.fNotExclusive != s2.fNotExclusive || s1.fNAncestorDirectProngs != s2.fNAncestorDirectProngs) {
+    return false;
+  }
+  return SameProng(signal->GetProng(prong), test.fSignal->GetProng(test.fProng));
+}
+
+//____________________________________________________________________________
+void MCSignalMatcher::AddSignal(MCSignal* signal)
+{
+  //
+  // assign each prong of the signal to a prong test, shared with the previous signals if they have the same prong definition
+  //
+  Signal compiled;
+  compiled.fExcludeCommonAncestor = signal->GetExcludeCommonAncestor();
+  for (int i = 0; i < signal->GetNProngs(); i++) {
+    int iTest = -1;
+    for (std::size_t it = 0; it < fTests.size(); ++it) {
+      if (SameProngTest(signal, i, fTests[it])) {
+        iTest = it;
+        break;
+      }
+    }
+    if (iTest < 0) {
+      ProngTest test = {signal, i, -1};
+      if (GetAncestorSettings(signal, i).fIdx >= 0) {
+        test.fAncestorSlot = fNAncestorSlots++;
+        fAncestorLabels.emplace_back();
+      }
+      iTest = fTests.size();
+      fTests.push_back(test);
+    }
+    compiled.fTests.push_back(iTest);
+  }
+  fSignals.push_back(compiled);
+  fNWords = (fTests.size() + 63) / 64;
+  // the decisions of the previous data frame cannot be used anymore
+  fNParticles = 0;
+  fDecisions.clear();
+}
+
+//____________________________________________________________________________
+bool MCSignalMatcher::CheckIndices(int iSignal, const int64_t* indices) const
+{
+  //
+  // same sequence of checks as in MCSignal::CheckMC() and MCSignal::CheckProng()
+  //
+  const Signal& signal = fSignals[iSignal];
+  int firstAncestorLabel = -1;
+  for (std::size_t i = 0; i < signal.fTests.size(); ++i) {
+    int64_t ip = indices[i];
+    if (ip < 0 || ip >= fNParticles) {
+      return false;
+    }
+    int iTest = signal.fTests[i];
+    if (!(fDecisions[ip * fNWords + iTest / 64] & (static_cast<uint64_t>(1) << (iTest % 64)))) {
+      return false;
+    }
+    // check the common ancestor (if specified)
+    int slot = fTests[iTest].fAncestorSlot;
+    if (slot < 0 || fAncestorLabels[slot][ip] < 0) {
+      continue;
+    }
+    int ancestorLabel = fAncestorLabels[slot][ip];
+    if (i == 0) {
+      firstAncestorLabel = ancestorLabel;
+    } else {
+      if (ancestorLabel != firstAncestorLabel && !signal.fExcludeCommonAncestor)
+        return false;
+      else if (ancestorLabel == firstAncestorLabel && signal.fExcludeCommonAncestor)
+        return false;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,110 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//
+// Contact: iarsene@cern.ch, i.c.arsene@fys.uio.no
+//
+// Class matching a list of MC signals using decisions precomputed once per data frame
+//   The prongs of all the signals are compiled into a list of distinct prong tests (prongs shared by several signals are tested once).
+//   Precompute() runs all the tests on each MC particle of the data frame and stores their decisions in a bit map per particle,
+//   together with the global index of the common ancestor candidate for the prongs of the multi-prong signals.
+//   CheckSignal() then reduces to bit tests and comparisons of the common ancestors, with the same decision as MCSignal::CheckSignal()
+//
+
+#ifndef PWGDQ_CORE_MCSIGNALMATCHER_H_
+#define PWGDQ_CORE_MCSIGNALMATCHER_H_
+
+#include "PWGDQ/Core/MCSignal.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class MCSignalMatcher
+{
+ public:
+  MCSignalMatcher() = default;
+  ~MCSignalMatcher() = default;
+
+  // NOTE: The signals are identified by the order in which they are added
+  void AddSignal(MCSignal* signal);
+  void Clear();
+  int GetNSignals() const { return fSignals.size(); }
+  int GetNProngTests() const { return fTests.size(); }
+
+  // NOTE: mcTracks must be the full table of MC particles of the data frame, the particles are identified by their global index
+  template <typename TMCTracks>
+  void Precompute(const TMCTracks& mcTracks, bool checkSources = true);
+
+  template <typename... T>
+  bool CheckSignal(int iSignal, const T&... tracks) const
+  {
+    // Make sure number of tracks provided is equal to the number of prongs
+    if (sizeof...(tracks) != fSignals[iSignal].fTests.size()) {
+      return false;
+    }
+    const int64_t indices[] = {static_cast<int64_t>(tracks.globalIndex())...};
+    return CheckIndices(iSignal, indices);
+  }
+
+ private:
+  struct ProngTest {
+    MCSignal* fSignal; // first signal using this prong test
+    int fProng;        // prong of fSignal
+    int fAncestorSlot; // index in fAncestorLabels, -1 if no common ancestor is requested
+  };
+
+  struct Signal {
+    std::vector<int> fTests; // prong test of each prong
+    bool fExcludeCommonAncestor;
+  };
+
+  bool SameProngTest(const MCSignal* signal, int prong, const ProngTest& test) const;
+  bool CheckIndices(int iSignal, const int64_t* indices) const;
+
+  std::vector<Signal> fSignals;
+  std::vector<ProngTest> fTests;
+  int fNWords = 0; // number of 64 bit words of the bit map of each particle
+  int fNAncestorSlots = 0;
+
+  int64_t fNParticles = 0;
+  std::vector<uint64_t> fDecisions;              // bit map of the passed prong tests, fNWords per particle
+  std::vector<std::vector<int>> fAncestorLabels; // common ancestor candidate of each particle, -1 if not reached
+};
+
+template <typename TMCTracks>
+void MCSignalMatcher::Precompute(const TMCTracks& mcTracks, bool checkSources)
+{
+  fNParticles = mcTracks.size();
+  fDecisions.assign(fNParticles * fNWords, 0);
+  for (auto& labels : fAncestorLabels) {
+    labels.assign(fNParticles, -1);
+  }
+  if (fTests.empty()) {
+    return;
+  }
+
+  for (const auto& particle : mcTracks) {
+    int64_t ip = particle.globalIndex();
+    uint64_t* decisions = &fDecisions[ip * fNWords];
+    for (std::size_t it = 0; it < fTests.size(); ++it) {
+      const ProngTest& test = fTests[it];
+      int ancestorLabel = -1;
+      if (test.fSignal->TestProng(test.fProng, checkSources, particle, ancestorLabel)) {
+        decisions[it / 64] |= (static_cast<uint64_t>(1) << (it % 64));
+      }
+      if (test.fAncestorSlot >= 0) {
+        fAncestorLabels[test.fAncestorSlot][ip] = ancestorLabel;
+      }
+    }
+  }
+}
+
+#endif // PWGDQ_CORE_MCSIGNALMATCHER_H_
@@ -12,6 +12,8 @@
 #include "PWGDQ/Core/MixingHandler.h"
 #include "PWGDQ/Core/VarManager.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <fstream>
 using namespace std;
@@ -63,6 +65,7 @@ void MixingHandler::AddMixingVariable(int var, int nBins, float* binLims)
   varBins.Set(nBins, binLims);
   fVariableLimits.push_back(varBins);
   VarManager::SetUseVariable(var);
+  fIsInitialized = kFALSE;
 }
 
 //_________________________________________________________________________
@@ -110,15 +113,80 @@ void MixingHandler::Init()
   //
   // Initialization of pools
   //       The correct event category will be retrieved using the function FindEventCategory()
+  //       The strides of the variables in the category index and the parameters of the uniform binnings are computed here
   //
-  int size = 1;
-  for (auto v : fVariableLimits) {
-    size *= (v.GetSize() - 1);
+  int nVars = fVariables.size();
+  fStrides.assign(nVars, 1);
+  for (int iVar = nVars - 2; iVar >= 0; --iVar) {
+    fStrides[iVar] = fStrides[iVar + 1] * (fVariableLimits[iVar + 1].GetSize() - 1);
+  }
+
+  fBinOrigins.assign(nVars, 0.);
+  fInvBinWidths.assign(nVars, 0.);
+  for (int iVar = 0; iVar < nVars; ++iVar) {
+    const int nLimits = fVariableLimits[iVar].GetSize();
+    const float* limits = fVariableLimits[iVar].GetArray();
+    if (nLimits < 2) {
+      continue;
+    }
+    // the binning is used as uniform if the limits are increasing and equally spaced.
+    //   The bin found from the width is anyway corrected with the limits, so that the tolerance does not change the result
+    float width = (limits[nLimits - 1] - limits[0]) / (nLimits - 1);
+    bool isUniform = std::isfinite(width) && width > 0.;
+    for (int i = 1; i < nLimits && isUniform; ++i) {
+      isUniform = (limits[i] > limits[i - 1]) && (std::abs(limits[i] - (limits[0] + i * width)) < 1.0e-3 * width);
+    }
+    if (isUniform) {
+      fBinOrigins[iVar] = limits[0];
+      fInvBinWidths[iVar] = 1. / width;
+    }
   }
-  (void)size;
   fIsInitialized = kTRUE;
 }
 
+//_________________________________________________________________________
+int MixingHandler::FindBin(int iVar, float value) const
+{
+  //
+  // Find the bin of the value in the limits of the variable, -1 if outside the limits
+  //
+  const int nLimits = fVariableLimits[iVar].GetSize();
+  const float* limits = fVariableLimits[iVar].GetArray();
+  if (fInvBinWidths[iVar] > 0.) {
+    if (!(value >= limits[0] && value < limits[nLimits - 1])) {
+      return -1;
+    }
+    int bin = std::clamp(static_cast<int>((value - fBinOrigins[iVar]) * fInvBinWidths[iVar]), 0, nLimits - 2);
+    while (bin > 0 && limits[bin] > value) {
+      --bin;
+    }
+    while (bin < nLimits - 2 && limits[bin + 1] <= value) {
+      ++bin;
+    }
+    return bin;
+  }
+  int bin = TMath::BinarySearch(nLimits, limits, value);
+  return (bin == nLimits - 1 ? -1 : bin);
+}
+
+//_________________________________________________________________________
+template <bool TPacked>
+int MixingHandler::ComputeCategory(const float* values) const
+{
+  //
+  // Category index from the values of the variables, either the full array of values or the packed values of the mixing variables
+  //
+  int category = 0;
+  for (std::size_t iVar = 0; iVar < fVariables.size(); ++iVar) {
+    int bin = FindBin(iVar, values[TPacked ? iVar : fVariables[iVar]]);
+    if (bin == -1) {
+      return -1; // all variables must be inside limits
+    }
+    category += bin * fStrides[iVar];
+  }
+  return category;
+}
+
 //_________________________________________________________________________
 int MixingHandler::FindEventCategory(float* values)
 {
@@ -131,34 +199,37 @@ int MixingHandler::FindEventCategory(float* values)
   if (!fIsInitialized) {
     Init();
   }
+  return ComputeCategory<false>(values);
+}
 
-  std::vector<int> bin;
-  int iVar = 0;
-  for (auto v = fVariableLimits.begin(); v != fVariableLimits.end(); v++, iVar++) {
-    int binValue = TMath::BinarySearch((*v).GetSize(), (*v).GetArray(), values[fVariables[iVar]]);
-    bin.push_back(binValue);
-    if (bin[iVar] == -1 || bin[iVar] == (*v).GetSize() - 1) {
-      return -1; // all variables must be inside limits
-    }
+//_________________________________________________________________________
+void MixingHandler::GetMixingValues(const float* values, float* mixingValues) const
+{
+  //
+  // Copy the values of the mixing variables, in the order in which they were added
+  //
+  for (std::size_t iVar = 0; iVar < fVariables.size(); ++iVar) {
+    mixingValues[iVar] = values[fVariables[iVar]];
   }
+}
 
-  int category = 0;
-  int tempCategory = 1;
-  int iv1 = 0;
-  int iv2 = 0;
-  for (auto v1 = fVariables.begin(); v1 != fVariables.end(); v1++, iv1++) {
-    tempCategory = 1;
-    iv2 = iv1;
-    for (auto v2 = v1; v2 != fVariables.end(); v2++, iv2++) {
-      if (iv2 == iv1) {
-        tempCategory *= bin[iv2];
-      } else {
-        tempCategory *= (fVariableLimits[iv2].GetSize() - 1);
-      }
-    }
-    category += tempCategory;
+//_________________________________________________________________________
+void MixingHandler::FindEventCategories(int nEvents, const float* mixingValues, int* categories)
+{
+  //
+  // Find the event categories of nEvents events, from the values of the mixing variables filled with GetMixingValues()
+  //
+  if (fVariables.size() == 0) {
+    std::fill(categories, categories + nEvents, -1);
+    return;
+  }
+  if (!fIsInitialized) {
+    Init();
+  }
+  const int nVars = fVariables.size();
+  for (int iEvent = 0; iEvent < nEvents; ++iEvent) {
+    categories[iEvent] = ComputeCategory<true>(mixingValues + iEvent * nVars);
   }
-  return category;
 }
 
 //_________________________________________________________________________
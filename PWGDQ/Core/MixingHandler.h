@@ -50,6 +50,11 @@ class MixingHandler : public TNamed
   int FindEventCategory(float* values);
   int GetBinFromCategory(VarManager::Variables var, int category) const;
 
+  // batched categorization: the values of the mixing variables of each event are first collected with GetMixingValues()
+  //   into consecutive arrays of GetNMixingVariables() floats, then the categories of all the events are found at once
+  void GetMixingValues(const float* values, float* mixingValues) const;
+  void FindEventCategories(int nEvents, const float* mixingValues, int* categories);
+
  private:
   MixingHandler(const MixingHandler& handler);
   MixingHandler& operator=(const MixingHandler& handler);
@@ -60,6 +65,15 @@ class MixingHandler : public TNamed
   std::vector<TArrayF> fVariableLimits;
   std::vector<int> fVariables;
 
+  // lookup tables filled by Init()
+  std::vector<int> fStrides;        //! number of categories spanned by one bin of each variable
+  std::vector<float> fBinOrigins;   //! lower limit of the uniform binnings
+  std::vector<float> fInvBinWidths; //! inverse bin width of the uniform binnings, 0 for variable binnings
+
+  int FindBin(int iVar, float value) const;
+  template <bool TPacked>
+  int ComputeCategory(const float* values) const;
+
   ClassDef(MixingHandler, 1);
 };
 
@@ -0,0 +1,154 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#include "PWGDQ/Core/MixingPool.h"
+
+#include "Framework/Logger.h"
+
+#include <utility>
+
+//____________________________________________________________________________
+void MixingPool::EventRecord::Clear()
+{
+  //
+  // the capacity of the columns is kept, such that the records are not reallocated once the pool is filled
+  //
+  fPt.clear();
+  fEta.clear();
+  fPhi.clear();
+  fSign.clear();
+  fFilter.clear();
+  fFwdDcaX.clear();
+  fFwdDcaY.clear();
+  fChi2.clear();
+  fChi2MatchMCHMID.clear();
+  fChi2MatchMCHMFT.clear();
+  fMatchMCHTrackId.clear();
+  fMatchMFTTrackId.clear();
+  fAmbiguityInBunch.clear();
+  fAmbiguityOutOfBunch.clear();
+  fCurrentDataFrame = true;
+}
+
+//____________________________________________________________________________
+void MixingPool::Init(int depth, long maxTracks)
+{
+  if (depth < 1) {
+    LOG(fatal) << "MixingPool: the depth of the pool must be at least 1, got " << depth;
+  }
+  fDepth = depth;
+  fMaxTracks = maxTracks;
+  Clear();
+}
+
+//____________________________________________________________________________
+void MixingPool::Clear()
+{
+  //
+  // remove all the stored events, e.g. at a run change
+  //
+  fCategories.clear();
+  fNStoredTracks = 0;
+  fWarnedMaxTracks = false;
+  fCurrentCategory = -1;
+  fCurrent.Clear();
+}
+
+//____________________________________________________________________________
+void MixingPool::NewDataFrame()
+{
+  //
+  // the matching indices of the stored muons do not refer anymore to the tables of the current data frame
+  //
+  for (auto& [category, pool] : fCategories) {
+    for (auto& event : pool.fEvents) {
+      event.fCurrentDataFrame = false;
+    }
+  }
+}
+
+//____________________________________________________________________________
+void MixingPool::StartEvent(int category)
+{
+  fCurrentCategory = category;
+  fCurrent.Clear();
+}
+
+//____________________________________________________________________________
+void MixingPool::AddTrack(float pt, float eta, float phi, int sign, uint32_t filter)
+{
+  fCurrent.fPt.push_back(pt);
+  fCurrent.fEta.push_back(eta);
+  fCurrent.fPhi.push_back(phi);
+  fCurrent.fSign.push_back(sign);
+  fCurrent.fFilter.push_back(filter);
+}
+
+//____________________________________________________________________________
+void MixingPool::AddMuon(float pt, float eta, float phi, int sign, uint32_t filter, float fwdDcaX, float fwdDcaY, float chi2, float chi2MatchMCHMID, float chi2MatchMCHMFT,
+                         int matchMCHTrackId, int matchMFTTrackId, int ambiguityInBunch, int ambiguityOutOfBunch)
+{
+  AddTrack(pt, eta, phi, sign, filter);
+  fCurrent.fFwdDcaX.push_back(fwdDcaX);
+  fCurrent.fFwdDcaY.push_back(fwdDcaY);
+  fCurrent.fChi2.push_back(chi2);
+  fCurrent.fChi2MatchMCHMID.push_back(chi2MatchMCHMID);
+  fCurrent.fChi2MatchMCHMFT.push_back(chi2MatchMCHMFT);
+  fCurrent.fMatchMCHTrackId.push_back(matchMCHTrackId);
+  fCurrent.fMatchMFTTrackId.push_back(matchMFTTrackId);
+  fCurrent.fAmbiguityInBunch.push_back(ambiguityInBunch);
+  fCurrent.fAmbiguityOutOfBunch.push_back(ambiguityOutOfBunch);
+}
+
+//____________________________________________________________________________
+void MixingPool::FinishEvent()
+{
+  //
+  // push the current event into the ring buffer of its category, in place of the oldest event if the buffer is full
+  //
+  if (fCurrentCategory < 0 || fCurrent.GetNTracks() == 0) {
+    return;
+  }
+  Category& pool = fCategories[fCurrentCategory];
+  if (pool.fEvents.empty()) {
+    pool.fEvents.resize(fDepth);
+  }
+  EventRecord& slot = pool.fEvents[pool.fNext];
+  long nTracksReplaced = (pool.fN == fDepth ? slot.GetNTracks() : 0);
+  if (fMaxTracks > 0 && fNStoredTracks - nTracksReplaced + fCurrent.GetNTracks() > fMaxTracks) {
+    if (!fWarnedMaxTracks) {
+      LOG(warning) << "MixingPool: the maximum number of stored tracks (" << fMaxTracks << ") is reached, the next events are not stored unless they replace older ones";
+      fWarnedMaxTracks = true;
+    }
+    return;
+  }
+  fNStoredTracks += fCurrent.GetNTracks() - nTracksReplaced;
+  std::swap(slot, fCurrent);
+  pool.fNext = (pool.fNext + 1) % fDepth;
+  if (pool.fN < fDepth) {
+    pool.fN++;
+  }
+  fCurrent.Clear();
+}
+
+//____________________________________________________________________________
+int MixingPool::GetNEvents(int category) const
+{
+  auto it = fCategories.find(category);
+  return (it == fCategories.end() ? 0 : it->second.fN);
+}
+
+//____________________________________________________________________________
+const MixingPool::EventRecord& MixingPool::GetEvent(int category, int i) const
+{
+  const Category& pool = fCategories.at(category);
+  return pool.fEvents[(pool.fNext - pool.fN + i + fDepth) % fDepth];
+}
@@ -0,0 +1,129 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//
+// Contact: iarsene@cern.ch, i.c.arsene@fys.uio.no
+//
+// Class keeping, for each event mixing category, the selected tracks of the last events in a ring buffer of fixed depth
+//   The tracks are stored as compact records in columns (kinematics, filter map and the muon matching information),
+//   such that the events of successive data frames can be mixed with each other with a bounded memory use
+//
+
+#ifndef PWGDQ_CORE_MIXINGPOOL_H_
+#define PWGDQ_CORE_MIXINGPOOL_H_
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class MixingPool
+{
+ public:
+  class EventRecord;
+
+  // view of a stored track, with the accessors of the reduced tracks used by VarManager::FillPairME() and FillPairVn()
+  class Track
+  {
+   public:
+    Track(const EventRecord& event, int index) : fEvent(event), fIndex(index) {}
+
+    float pt() const { return fEvent.fPt[fIndex]; }
+    float eta() const { return fEvent.fEta[fIndex]; }
+    float phi() const { return fEvent.fPhi[fIndex]; }
+    int sign() const { return fEvent.fSign[fIndex]; }
+    uint32_t filter() const { return fEvent.fFilter[fIndex]; }
+    // muon information, zero for the barrel tracks
+    float fwdDcaX() const { return fEvent.IsMuon() ? fEvent.fFwdDcaX[fIndex] : 0.f; }
+    float fwdDcaY() const { return fEvent.IsMuon() ? fEvent.fFwdDcaY[fIndex] : 0.f; }
+    float chi2() const { return fEvent.IsMuon() ? fEvent.fChi2[fIndex] : 0.f; }
+    float chi2MatchMCHMID() const { return fEvent.IsMuon() ? fEvent.fChi2MatchMCHMID[fIndex] : 0.f; }
+    float chi2MatchMCHMFT() const { return fEvent.IsMuon() ? fEvent.fChi2MatchMCHMFT[fIndex] : 0.f; }
+    int muonAmbiguityInBunch() const { return fEvent.IsMuon() ? fEvent.fAmbiguityInBunch[fIndex] : 0; }
+    int muonAmbiguityOutOfBunch() const { return fEvent.IsMuon() ? fEvent.fAmbiguityOutOfBunch[fIndex] : 0; }
+    // NOTE: the matching indices refer to the tables of the data frame in which the muon was stored, they are -1 for the events of the previous data frames
+    int matchMCHTrackId() const { return (fEvent.IsMuon() && fEvent.fCurrentDataFrame) ? fEvent.fMatchMCHTrackId[fIndex] : -1; }
+    int matchMFTTrackId() const { return (fEvent.IsMuon() && fEvent.fCurrentDataFrame) ? fEvent.fMatchMFTTrackId[fIndex] : -1; }
+
+   private:
+    const EventRecord& fEvent;
+    int fIndex;
+  };
+
+  // tracks of one event
+  class EventRecord
+  {
+   public:
+    int GetNTracks() const { return fPt.size(); }
+    Track GetTrack(int i) const { return Track(*this, i); }
+    bool IsMuon() const { return !fFwdDcaX.empty(); }
+
+   private:
+    friend class MixingPool;
+    friend class MixingPool::Track;
+
+    void Clear();
+
+    std::vector<float> fPt;
+    std::vector<float> fEta;
+    std::vector<float> fPhi;
+    std::vector<int8_t> fSign;
+    std::vector<uint32_t> fFilter;
+    std::vector<float> fFwdDcaX;
+    std::vector<float> fFwdDcaY;
+    std::vector<float> fChi2;
+    std::vector<float> fChi2MatchMCHMID;
+    std::vector<float> fChi2MatchMCHMFT;
+    std::vector<int> fMatchMCHTrackId;
+    std::vector<int> fMatchMFTTrackId;
+    std::vector<int16_t> fAmbiguityInBunch;
+    std::vector<int16_t> fAmbiguityOutOfBunch;
+    bool fCurrentDataFrame = true; // the event was stored in the current data frame
+  };
+
+  MixingPool() = default;
+  ~MixingPool() = default;
+
+  // NOTE: At most depth events are kept for each category, the oldest one being replaced by the new one.
+  // NOTE:   If maxTracks > 0, the events which would bring the total number of stored tracks above maxTracks are not stored
+  void Init(int depth, long maxTracks = -1);
+  void Clear();
+  void NewDataFrame();
+
+  // the tracks of the current event are added to a staging record, which can be mixed with the stored events of its category
+  //   before being pushed into the ring buffer with FinishEvent()
+  void StartEvent(int category);
+  void AddTrack(float pt, float eta, float phi, int sign, uint32_t filter);
+  void AddMuon(float pt, float eta, float phi, int sign, uint32_t filter, float fwdDcaX, float fwdDcaY, float chi2, float chi2MatchMCHMID, float chi2MatchMCHMFT,
+               int matchMCHTrackId, int matchMFTTrackId, int ambiguityInBunch, int ambiguityOutOfBunch);
+  void FinishEvent();
+
+  const EventRecord& GetCurrentEvent() const { return fCurrent; }
+  int GetNEvents(int category) const;
+  const EventRecord& GetEvent(int category, int i) const; // i-th stored event of the category, from the oldest one
+  long GetNStoredTracks() const { return fNStoredTracks; }
+
+ private:
+  struct Category {
+    std::vector<EventRecord> fEvents; // ring buffer
+    int fNext = 0;                    // slot of the next event
+    int fN = 0;                       // number of stored events
+  };
+
+  int fDepth = 0;
+  long fMaxTracks = -1;
+  long fNStoredTracks = 0;
+  bool fWarnedMaxTracks = false;
+
+  std::unordered_map<int, Category> fCategories;
+  int fCurrentCategory = -1;
+  EventRecord fCurrent; // staging record of the current event
+};
+
+#endif // PWGDQ_CORE_MIXINGPOOL_H_
@@ -15,6 +15,7 @@
 #include <cmath>
 #include <iostream>
 #include <map>
+#include <utility>
 #include <vector>
 
 using std::cout;
@@ -27,6 +28,8 @@ TString VarManager::fgVariableNames[VarManager::kNVars] = {""};
 TString VarManager::fgVariableUnits[VarManager::kNVars] = {""};
 std::map<TString, int> VarManager::fgVarNamesMap;
 bool VarManager::fgUsedVars[VarManager::kNVars] = {false};
+bool VarManager::fgUsedVarGroups[VarManager::kNVarGroups] = {false};
+bool VarManager::fgSkipUnusedVarGroups = false;
 bool VarManager::fgUsedKF = false;
 bool VarManager::fgPVrecalKF = true;
 float VarManager::fgMagField = 0.5;
@@ -42,6 +45,10 @@ uint64_t VarManager::fgSOR = 0;
 uint64_t VarManager::fgEOR = 0;
 ROOT::Math::PxPyPzEVector VarManager::fgBeamA(0, 0, 6799.99, 6800);  // GeV, beam from A-side 4-momentum vector
 ROOT::Math::PxPyPzEVector VarManager::fgBeamC(0, 0, -6799.99, 6800); // GeV, beam from C-side 4-momentum vector
+bool VarManager::fgUsePairVertexingCache = false;
+std::map<std::tuple<int, int64_t, int64_t>, VarManager::PairVertexingFit> VarManager::fgPairVertexingCache;
+std::vector<int> VarManager::fgTrackValuesCacheVars;
+std::vector<float> VarManager::fgTrackValuesCache;
 o2::vertexing::DCAFitterN<2> VarManager::fgFitterTwoProngBarrel;
 o2::vertexing::DCAFitterN<3> VarManager::fgFitterThreeProngBarrel;
 o2::vertexing::DCAFitterN<4> VarManager::fgFitterFourProngBarrel;
@@ -65,39 +72,69 @@ VarManager::VarManager() : TObject()
 //__________________________________________________________________
 VarManager::~VarManager() = default;
 
+namespace
+{
+using VM = VarManager;
+
+// dependency graph of the variables: {variable, variables needed for its calculation}
+const std::vector<std::pair<int, std::vector<int>>> varDependencies = {
+  {VM::kP, {VM::kPt, VM::kEta}},
+  {VM::kVertexingLxyOverErr, {VM::kVertexingLxy, VM::kVertexingLxyErr}},
+  {VM::kVertexingLzOverErr, {VM::kVertexingLz, VM::kVertexingLzErr}},
+  {VM::kVertexingLxyzOverErr, {VM::kVertexingLxyz, VM::kVertexingLxyzErr}},
+  {VM::kKFTracksDCAxyzMax, {VM::kKFTrack0DCAxyz, VM::kKFTrack1DCAxyz}},
+  {VM::kKFTracksDCAxyMax, {VM::kKFTrack0DCAxy, VM::kKFTrack1DCAxy}},
+  {VM::kTrackIsInsideTPCModule, {VM::kPhiTPCOuter}}};
+
+// variables filled by each group of the fill functions (see VarManager::VarGroups).
+// NOTE: a variable filled in one of these blocks must be listed here, otherwise it is not filled when the unused groups are skipped
+const std::vector<int> varGroupMembers[VM::kNVarGroups] = {
+  // kVarGroupSecondaryVertexing: FillPairVertexing, FillTripletVertexing, FillDileptonTrackVertexing, FillDileptonTrackTrackVertexing
+  {VM::kUsedKF, VM::kKFMass, VM::kKFMassGeoTop, VM::kVertexingLxy, VM::kVertexingLxyErr, VM::kVertexingLxyz, VM::kVertexingLxyzErr, VM::kVertexingLz,
+   VM::kVertexingLzErr, VM::kVertexingTauxy, VM::kVertexingTauxyErr, VM::kVertexingLzProjected, VM::kVertexingLxyProjected,
+   VM::kVertexingLxyProjectedRecalculatePV, VM::kVertexingLxyzProjected, VM::kVertexingTauzProjected, VM::kVertexingTauxyProjected,
+   VM::kVertexingTauxyProjectedPoleJPsiMass, VM::kVertexingTauxyProjectedPoleJPsiMassRecalculatePV, VM::kVertexingTauxyProjectedNs,
+   VM::kVertexingTauxyzProjected, VM::kVertexingTauz, VM::kVertexingTauzErr, VM::kVertexingPz, VM::kVertexingSV, VM::kVertexingProcCode,
+   VM::kVertexingChi2PCA, VM::kCosPointingAngle, VM::kVertexingLxyOverErr, VM::kVertexingLzOverErr, VM::kVertexingLxyzOverErr, VM::kKFTrack0DCAxyz,
+   VM::kKFTrack1DCAxyz, VM::kKFTracksDCAxyzMax, VM::kKFDCAxyzBetweenProngs, VM::kKFTrack0DCAxy, VM::kKFTrack1DCAxy, VM::kKFTracksDCAxyMax,
+   VM::kKFDCAxyBetweenProngs, VM::kKFTrack0DeviationFromPV, VM::kKFTrack1DeviationFromPV, VM::kKFTrack0DeviationxyFromPV,
+   VM::kKFTrack1DeviationxyFromPV, VM::kKFChi2OverNDFGeo, VM::kKFNContributorsPV, VM::kKFCosPA, VM::kKFChi2OverNDFGeoTop, VM::kKFJpsiDCAxyz,
+   VM::kKFJpsiDCAxy, VM::kKFPairDeviationFromPV, VM::kKFPairDeviationxyFromPV, VM::kS12, VM::kS13, VM::kS23},
+  // kVarGroupPVRefit: FillPairVertexingRecomputePV
+  {VM::kVertexingLxyProjectedRecalculatePV, VM::kVertexingTauxyProjectedPoleJPsiMassRecalculatePV}};
+} // namespace
+
 //__________________________________________________________________
 void VarManager::SetVariableDependencies()
 {
   //
-  // Set as used variables on which other variables calculation depends
+  // Set as used variables on which other variables calculation depends, following the dependency graph until no new variable is added
   //
-  if (fgUsedVars[kP]) {
-    fgUsedVars[kPt] = true;
-    fgUsedVars[kEta] = true;
+  bool added = true;
+  while (added) {
+    added = false;
+    for (const auto& [var, dependencies] : varDependencies) {
+      if (!fgUsedVars[var]) {
+        continue;
+      }
+      for (const auto& dependency : dependencies) {
+        if (!fgUsedVars[dependency]) {
+          fgUsedVars[dependency] = true;
+          added = true;
+        }
+      }
+    }
   }
 
-  if (fgUsedVars[kVertexingLxyOverErr]) {
-    fgUsedVars[kVertexingLxy] = true;
-    fgUsedVars[kVertexingLxyErr] = true;
-  }
-  if (fgUsedVars[kVertexingLzOverErr]) {
-    fgUsedVars[kVertexingLz] = true;
-    fgUsedVars[kVertexingLzErr] = true;
-  }
-  if (fgUsedVars[kVertexingLxyzOverErr]) {
-    fgUsedVars[kVertexingLxyz] = true;
-    fgUsedVars[kVertexingLxyzErr] = true;
-  }
-  if (fgUsedVars[kKFTracksDCAxyzMax]) {
-    fgUsedVars[kKFTrack0DCAxyz] = true;
-    fgUsedVars[kKFTrack1DCAxyz] = true;
-  }
-  if (fgUsedVars[kKFTracksDCAxyMax]) {
-    fgUsedVars[kKFTrack0DCAxy] = true;
-    fgUsedVars[kKFTrack1DCAxy] = true;
-  }
-  if (fgUsedVars[kTrackIsInsideTPCModule]) {
-    fgUsedVars[kPhiTPCOuter] = true;
+  // groups of the fill functions needed by the used variables
+  for (int group = 0; group < kNVarGroups; group++) {
+    fgUsedVarGroups[group] = false;
+    for (const auto& var : varGroupMembers[group]) {
+      if (fgUsedVars[var]) {
+        fgUsedVarGroups[group] = true;
+        break;
+      }
+    }
   }
 }
 
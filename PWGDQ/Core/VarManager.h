@@ -67,9 +67,11 @@
 #include <algorithm>
 #include <cmath>
 #include <complex>
+#include <cstddef>
 #include <cstdint>
 #include <iostream>
 #include <map>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -1097,6 +1099,21 @@ class VarManager : public TObject
     kITSUPCMode
   };
 
+  // Expensive blocks of the fill functions, which can be skipped if none of the variables they fill is used
+  enum VarGroups {
+    kVarGroupSecondaryVertexing = 0, // DCAFitter or KFParticle fit of the pair, triplet and dilepton-track(s) vertices
+    kVarGroupPVRefit,                // decay lengths with respect to the refitted primary vertex
+    kNVarGroups
+  };
+
+  // Vertexer used in FillPairVertexing(): chosen at run time by the last SetupTwoProng*() call (kVertexerRuntime),
+  //   or fixed at compile time, in which case the code of the other vertexer is not instantiated
+  enum VertexerPolicy {
+    kVertexerRuntime = 0,
+    kVertexerDCAFitter,
+    kVertexerKF
+  };
+
   enum MuonExtrapolation {
     // Index used to set different options for Muon propagation
     kToVertex = 0, // propagtion to vertex by default
@@ -1131,6 +1148,7 @@ class VarManager : public TObject
     for (auto& var : usedVars) {
       fgUsedVars[var] = true;
     }
+    SetVariableDependencies();
   }
   static bool GetUsedVar(int var)
   {
@@ -1139,6 +1157,13 @@ class VarManager : public TObject
     }
     return false;
   }
+  // Skip the groups of the fill functions (see VarGroups) none of whose variables are used.
+  // NOTE: only for tasks which mark as used all the variables they read, including the ones written to tables
+  static void SetSkipUnusedVarGroups(bool skip) { fgSkipUnusedVarGroups = skip; }
+  static bool IsVarGroupNeeded(int group)
+  {
+    return !fgSkipUnusedVarGroups || fgUsedVarGroups[group];
+  }
 
   // Flag to  set PV recalculation via KF
   static void SetPVrecalculationKF(const bool pvRecalKF)
@@ -1184,6 +1209,35 @@ class VarManager : public TObject
     o2::mch::TrackExtrap::setField();
   }
 
+  // NOTE: If the pair vertexing cache is used, the results of the two-prong DCAFitterN fits of FillPairVertexing() are kept for each pair of tracks,
+  // NOTE:   such that the fit is done once for the pairs of tracks associated to several collisions. The cache is keyed by the table indices of the tracks
+  // NOTE:   and has to be cleared for each data frame. The fitters are not updated for the cached pairs (not to be used with FillPairVertexingRecomputePV())
+  static void SetUsePairVertexingCache(bool use)
+  {
+    fgUsePairVertexingCache = use;
+    fgPairVertexingCache.clear();
+  }
+  static void ClearPairVertexingCache() { fgPairVertexingCache.clear(); }
+
+  // NOTE: The track-wise variables of a full table of tracks can be computed once per data frame with FillTracks(), instead of once per association
+  // NOTE:   for the tracks associated to several collisions. The used variables in [kNEventWiseVariables, endValue) are kept for each track,
+  // NOTE:   indexed by its global index, and copied into the values array with LoadTrackValues(). This is not possible if the variables computed
+  // NOTE:   by FillTrack() from event-wise quantities (single muon cumulants) are used, see CanCacheTrackValues()
+  static bool CanCacheTrackValues()
+  {
+    return !fgUsedVars[kM11REFoverMpsingle];
+  }
+  static void LoadTrackValues(int64_t globalIndex, float* values = nullptr)
+  {
+    if (!values) {
+      values = fgValues;
+    }
+    const float* row = &fgTrackValuesCache[globalIndex * fgTrackValuesCacheVars.size()];
+    for (std::size_t i = 0; i < fgTrackValuesCacheVars.size(); ++i) {
+      values[fgTrackValuesCacheVars[i]] = row[i];
+    }
+  }
+
   // Setup the 2 prong DCAFitterN
   static void SetupTwoProngDCAFitter(float magField, bool propagateToPCA, float maxR, float maxDZIni, float minParamChange, float minRelChi2Change, bool useAbsDCA)
   {
@@ -1317,6 +1371,8 @@ class VarManager : public TObject
   template <uint32_t fillMap, typename T>
   static void FillTrack(T const& track, float* values = nullptr);
   template <uint32_t fillMap, typename T>
+  static void FillTracks(T const& tracks, int endValue = kNMuonTrackVariables);
+  template <uint32_t fillMap, typename T>
   static void FillPhoton(T const& photon, float* values = nullptr);
   template <uint32_t fillMap, typename T, typename C>
   static void FillTrackCollision(T const& track, C const& collision, float* values = nullptr);
@@ -1352,7 +1408,7 @@ class VarManager : public TObject
   static void FillTripleMC(T1 const& t1, T2 const& t2, T3 const& t3, float* values = nullptr);
   template <int candidateType, typename T1, typename T2>
   static void FillQuadMC(T1 const& t1, T2 const& t2, T2 const& t3, float* values = nullptr);
-  template <int pairType, uint32_t collFillMap, uint32_t fillMap, typename C, typename T>
+  template <int pairType, uint32_t collFillMap, uint32_t fillMap, int vertexer = kVertexerRuntime, typename C, typename T>
   static void FillPairVertexing(C const& collision, T const& t1, T const& t2, bool propToSV = false, float* values = nullptr);
   template <int pairType, uint32_t collFillMap, uint32_t fillMap, typename C, typename T>
   static void FillPairVertexingRecomputePV(C const& /*collision*/, T const& t1, T const& t2, o2::dataformats::VertexBase pvRefitted, float* values = nullptr);
@@ -1468,7 +1524,9 @@ class VarManager : public TObject
   static void ResetValues(int startValue = 0, int endValue = kNVars, float* values = nullptr);
 
  private:
-  static bool fgUsedVars[kNVars]; // holds flags for when the corresponding variable is needed (e.g., in the histogram manager, in cuts, mixing handler, etc.)
+  static bool fgUsedVars[kNVars];           // holds flags for when the corresponding variable is needed (e.g., in the histogram manager, in cuts, mixing handler, etc.)
+  static bool fgUsedVarGroups[kNVarGroups]; // holds flags for when the corresponding group of variables is needed, set from fgUsedVars
+  static bool fgSkipUnusedVarGroups;        // skip the computation of the groups of variables which are not needed
   static bool fgUsedKF;
   static bool fgPVrecalKF;
   static void SetVariableDependencies(); // toggle those variables on which other used variables might depend
@@ -1504,6 +1562,39 @@ class VarManager : public TObject
   template <typename T1, typename T2>
   static float LorentzTransformJpsihadroncosChi(TString Option, const T1& v1, const T2& v2);
 
+  // outputs of the two-prong DCAFitterN used in FillPairVertexing(), kept in the pair vertexing cache
+  struct PairVertexingFit {
+    int fProcCode;
+    Vec3D fSecondaryVertex;
+    std::array<float, 6> fCovMatrixPCA;
+    float fChi2PCA;
+    float fPt[2];
+    float fEta[2];
+    float fPhi[2];
+  };
+  template <typename TFitter>
+  static void GetTwoProngFit(TFitter& fitter, int procCode, PairVertexingFit& fit)
+  {
+    fit.fProcCode = procCode;
+    if (procCode == 0) {
+      return;
+    }
+    fit.fSecondaryVertex = fitter.getPCACandidate();
+    fit.fCovMatrixPCA = fitter.calcPCACovMatrixFlat();
+    fit.fChi2PCA = fitter.getChi2AtPCACandidate();
+    for (int i = 0; i < 2; i++) {
+      const auto& trackParVar = fitter.getTrack(i);
+      fit.fPt[i] = trackParVar.getPt();
+      fit.fEta[i] = trackParVar.getEta();
+      fit.fPhi[i] = trackParVar.getPhi();
+    }
+  }
+  static bool fgUsePairVertexingCache;
+  static std::map<std::tuple<int, int64_t, int64_t>, PairVertexingFit> fgPairVertexingCache; // (pair type, track indices) -> fit
+
+  static std::vector<int> fgTrackValuesCacheVars; // variables kept in the track values cache
+  static std::vector<float> fgTrackValuesCache;   // values of fgTrackValuesCacheVars, one row per track
+
   static o2::vertexing::DCAFitterN<2> fgFitterTwoProngBarrel;
   static o2::vertexing::DCAFitterN<3> fgFitterThreeProngBarrel;
   static o2::vertexing::DCAFitterN<4> fgFitterFourProngBarrel;
@@ -3108,6 +3199,33 @@ void VarManager::FillTrack(T const& track, float* values)
   FillTrackDerived(values);
 }
 
+template <uint32_t fillMap, typename T>
+void VarManager::FillTracks(T const& tracks, int endValue)
+{
+  //
+  // fill the track values cache for all the tracks of the table, see LoadTrackValues()
+  //
+  fgTrackValuesCacheVars.clear();
+  for (int var = kNEventWiseVariables; var < endValue; ++var) {
+    if (fgUsedVars[var]) {
+      fgTrackValuesCacheVars.push_back(var);
+    }
+  }
+  const std::size_t nVars = fgTrackValuesCacheVars.size();
+  fgTrackValuesCache.resize(tracks.size() * nVars);
+
+  float values[kNVars];
+  ResetValues(0, kNVars, values);
+  for (const auto& track : tracks) {
+    ResetValues(kNEventWiseVariables, endValue, values);
+    FillTrack<fillMap>(track, values);
+    float* row = &fgTrackValuesCache[track.globalIndex() * nVars];
+    for (std::size_t i = 0; i < nVars; ++i) {
+      row[i] = values[fgTrackValuesCacheVars[i]];
+    }
+  }
+}
+
 template <uint32_t fillMap, typename T, typename C>
 void VarManager::FillTrackCollision(T const& track, C const& collision, float* values)
 {
@@ -4337,7 +4455,7 @@ void VarManager::FillTripleMC(T1 const& t1, T2 const& t2, T3 const& t3, float* v
   }
 }
 
-template <int pairType, uint32_t collFillMap, uint32_t fillMap, typename C, typename T>
+template <int pairType, uint32_t collFillMap, uint32_t fillMap, int vertexer, typename C, typename T>
 void VarManager::FillPairVertexing(C const& collision, T const& t1, T const& t2, bool propToSV, float* values)
 {
   // check at compile time that the event and cov matrix have the cov matrix
@@ -4362,344 +4480,374 @@ void VarManager::FillPairVertexing(C const& collision, T const& t1, T const& t2,
   ROOT::Math::PtEtaPhiMVector v2(t2.pt(), t2.eta(), t2.phi(), m2);
   ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
 
-  values[kUsedKF] = fgUsedKF;
-  if (!fgUsedKF) {
-    int procCode = 0;
-
-    // TODO: use trackUtilities functions to initialize the various matrices to avoid code duplication
-    // auto pars1 = getTrackParCov(t1);
-    // auto pars2 = getTrackParCov(t2);
-    // We need to hide the cov data members from the cases when no cov table is provided
-    if constexpr ((pairType == kDecayToEE || pairType == kDecayToKPi) && trackHasCov) {
-      std::array<float, 5> t1pars = {t1.y(), t1.z(), t1.snp(), t1.tgl(), t1.signed1Pt()};
-      std::array<float, 15> t1covs = {t1.cYY(), t1.cZY(), t1.cZZ(), t1.cSnpY(), t1.cSnpZ(),
-                                      t1.cSnpSnp(), t1.cTglY(), t1.cTglZ(), t1.cTglSnp(), t1.cTglTgl(),
-                                      t1.c1PtY(), t1.c1PtZ(), t1.c1PtSnp(), t1.c1PtTgl(), t1.c1Pt21Pt2()};
-      o2::track::TrackParCov pars1{t1.x(), t1.alpha(), t1pars, t1covs};
-      std::array<float, 5> t2pars = {t2.y(), t2.z(), t2.snp(), t2.tgl(), t2.signed1Pt()};
-      std::array<float, 15> t2covs = {t2.cYY(), t2.cZY(), t2.cZZ(), t2.cSnpY(), t2.cSnpZ(),
-                                      t2.cSnpSnp(), t2.cTglY(), t2.cTglZ(), t2.cTglSnp(), t2.cTglTgl(),
-                                      t2.c1PtY(), t2.c1PtZ(), t2.c1PtSnp(), t2.c1PtTgl(), t2.c1Pt21Pt2()};
-      o2::track::TrackParCov pars2{t2.x(), t2.alpha(), t2pars, t2covs};
-      procCode = fgFitterTwoProngBarrel.process(pars1, pars2);
-    } else if constexpr ((pairType == kDecayToMuMu) && muonHasCov) {
-      // Initialize track parameters for forward
-      o2::track::TrackParCovFwd pars1 = FwdToTrackPar(t1, t1);
-      o2::track::TrackParCovFwd pars2 = FwdToTrackPar(t2, t2);
-      procCode = fgFitterTwoProngFwd.process(pars1, pars2);
-    } else {
-      return;
-    }
-
-    values[kVertexingProcCode] = procCode;
-    if (procCode == 0) {
-      // TODO: set the other variables to appropriate values and return
-      values[kVertexingChi2PCA] = -999.;
-      values[kVertexingLxy] = -999.;
-      values[kVertexingLxyz] = -999.;
-      values[kVertexingLz] = -999.;
-      values[kVertexingLxyErr] = -999.;
-      values[kVertexingLxyzErr] = -999.;
-      values[kVertexingLzErr] = -999.;
-
-      values[kVertexingTauxy] = -999.;
-      values[kVertexingTauz] = -999.;
-      values[kVertexingTauxyErr] = -999.;
-      values[kVertexingTauzErr] = -999.;
-      values[kVertexingPz] = -999.;
-      values[kVertexingSV] = -999.;
-      return;
-    }
-
-    Vec3D secondaryVertex;
-    o2::dataformats::VertexBase primaryVertexNew;
-
-    if constexpr (eventHasVtxCov) {
-
-      std::array<float, 6> covMatrixPCA{};
-      // get track impact parameters
-      // This modifies track momenta!
-      o2::math_utils::Point3D<float> vtxXYZ(collision.posX(), collision.posY(), collision.posZ());
-      std::array<float, 6> vtxCov{collision.covXX(), collision.covXY(), collision.covYY(), collision.covXZ(), collision.covYZ(), collision.covZZ()};
-      o2::dataformats::VertexBase primaryVertex = {std::move(vtxXYZ), std::move(vtxCov)};
-      // auto primaryVertex = getPrimaryVertex(collision);
-      auto covMatrixPV = primaryVertex.getCov();
-
-      if constexpr ((pairType == kDecayToEE || pairType == kDecayToKPi) && trackHasCov) {
-        secondaryVertex = fgFitterTwoProngBarrel.getPCACandidate();
-        // printf("secVtx (first) %f %f  %f \n",secondaryVertex[0],secondaryVertex[1],secondaryVertex[2]);
-        covMatrixPCA = fgFitterTwoProngBarrel.calcPCACovMatrixFlat();
-        auto chi2PCA = fgFitterTwoProngBarrel.getChi2AtPCACandidate();
-        auto trackParVar0 = fgFitterTwoProngBarrel.getTrack(0);
-        auto trackParVar1 = fgFitterTwoProngBarrel.getTrack(1);
-        values[kVertexingChi2PCA] = chi2PCA;
-        v1 = {trackParVar0.getPt(), trackParVar0.getEta(), trackParVar0.getPhi(), m1};
-        v2 = {trackParVar1.getPt(), trackParVar1.getEta(), trackParVar1.getPhi(), m2};
-        v12 = v1 + v2;
-        if (fgPVrecalKF)
-          primaryVertexNew = RecalculatePrimaryVertex(t1, t2, collision);
+  if (!propToSV && !IsVarGroupNeeded(kVarGroupSecondaryVertexing)) {
+    values[kPt1] = t1.pt();
+    values[kEta1] = t1.eta();
+    values[kPhi1] = t1.phi();
 
-      } else if constexpr (pairType == kDecayToMuMu && muonHasCov) {
-        // Get pca candidate from forward DCA fitter
-        secondaryVertex = fgFitterTwoProngFwd.getPCACandidate();
-        covMatrixPCA = fgFitterTwoProngFwd.calcPCACovMatrixFlat();
-        auto chi2PCA = fgFitterTwoProngFwd.getChi2AtPCACandidate();
-        auto trackParVar0 = fgFitterTwoProngFwd.getTrack(0);
-        auto trackParVar1 = fgFitterTwoProngFwd.getTrack(1);
-        values[kVertexingChi2PCA] = chi2PCA;
-        v1 = {trackParVar0.getPt(), trackParVar0.getEta(), trackParVar0.getPhi(), m1};
-        v2 = {trackParVar1.getPt(), trackParVar1.getEta(), trackParVar1.getPhi(), m2};
-        v12 = v1 + v2;
+    values[kPt2] = t2.pt();
+    values[kEta2] = t2.eta();
+    values[kPhi2] = t2.phi();
+    return;
+  }
 
-        values[kPt1] = trackParVar0.getPt();
-        values[kEta1] = trackParVar0.getEta();
-        values[kPhi1] = trackParVar0.getPhi();
+  bool usedKF = (vertexer == kVertexerRuntime ? fgUsedKF : vertexer == kVertexerKF);
+  values[kUsedKF] = usedKF;
+  if (!usedKF) {
+    if constexpr (vertexer != kVertexerKF) {
+      int procCode = 0;
+      PairVertexingFit fit = {};
+
+      // the fit of a pair of tracks already fitted for another collision is taken from the cache, if used
+      auto cacheKey = std::make_tuple(pairType, static_cast<int64_t>(t1.globalIndex()), static_cast<int64_t>(t2.globalIndex()));
+      auto cachedFit = (fgUsePairVertexingCache ? fgPairVertexingCache.find(cacheKey) : fgPairVertexingCache.end());
+
+      // TODO: use trackUtilities functions to initialize the various matrices to avoid code duplication
+      // auto pars1 = getTrackParCov(t1);
+      // auto pars2 = getTrackParCov(t2);
+      // We need to hide the cov data members from the cases when no cov table is provided
+      if (cachedFit != fgPairVertexingCache.end()) {
+        fit = cachedFit->second;
+        procCode = fit.fProcCode;
+      } else if constexpr ((pairType == kDecayToEE || pairType == kDecayToKPi) && trackHasCov) {
+        std::array<float, 5> t1pars = {t1.y(), t1.z(), t1.snp(), t1.tgl(), t1.signed1Pt()};
+        std::array<float, 15> t1covs = {t1.cYY(), t1.cZY(), t1.cZZ(), t1.cSnpY(), t1.cSnpZ(),
+                                        t1.cSnpSnp(), t1.cTglY(), t1.cTglZ(), t1.cTglSnp(), t1.cTglTgl(),
+                                        t1.c1PtY(), t1.c1PtZ(), t1.c1PtSnp(), t1.c1PtTgl(), t1.c1Pt21Pt2()};
+        o2::track::TrackParCov pars1{t1.x(), t1.alpha(), t1pars, t1covs};
+        std::array<float, 5> t2pars = {t2.y(), t2.z(), t2.snp(), t2.tgl(), t2.signed1Pt()};
+        std::array<float, 15> t2covs = {t2.cYY(), t2.cZY(), t2.cZZ(), t2.cSnpY(), t2.cSnpZ(),
+                                        t2.cSnpSnp(), t2.cTglY(), t2.cTglZ(), t2.cTglSnp(), t2.cTglTgl(),
+                                        t2.c1PtY(), t2.c1PtZ(), t2.c1PtSnp(), t2.c1PtTgl(), t2.c1Pt21Pt2()};
+        o2::track::TrackParCov pars2{t2.x(), t2.alpha(), t2pars, t2covs};
+        procCode = fgFitterTwoProngBarrel.process(pars1, pars2);
+        if constexpr (eventHasVtxCov) {
+          GetTwoProngFit(fgFitterTwoProngBarrel, procCode, fit);
+        }
+        if (fgUsePairVertexingCache) {
+          fgPairVertexingCache[cacheKey] = fit;
+        }
+      } else if constexpr ((pairType == kDecayToMuMu) && muonHasCov) {
+        // Initialize track parameters for forward
+        o2::track::TrackParCovFwd pars1 = FwdToTrackPar(t1, t1);
+        o2::track::TrackParCovFwd pars2 = FwdToTrackPar(t2, t2);
+        procCode = fgFitterTwoProngFwd.process(pars1, pars2);
+        if constexpr (eventHasVtxCov) {
+          GetTwoProngFit(fgFitterTwoProngFwd, procCode, fit);
+        }
+        if (fgUsePairVertexingCache) {
+          fgPairVertexingCache[cacheKey] = fit;
+        }
+      } else {
+        return;
+      }
 
-        values[kPt2] = trackParVar1.getPt();
-        values[kEta2] = trackParVar1.getEta();
-        values[kPhi2] = trackParVar1.getPhi();
+      values[kVertexingProcCode] = procCode;
+      if (procCode == 0) {
+        // TODO: set the other variables to appropriate values and return
+        values[kVertexingChi2PCA] = -999.;
+        values[kVertexingLxy] = -999.;
+        values[kVertexingLxyz] = -999.;
+        values[kVertexingLz] = -999.;
+        values[kVertexingLxyErr] = -999.;
+        values[kVertexingLxyzErr] = -999.;
+        values[kVertexingLzErr] = -999.;
+
+        values[kVertexingTauxy] = -999.;
+        values[kVertexingTauz] = -999.;
+        values[kVertexingTauxyErr] = -999.;
+        values[kVertexingTauzErr] = -999.;
+        values[kVertexingPz] = -999.;
+        values[kVertexingSV] = -999.;
+        return;
       }
-      double phi = std::atan2(secondaryVertex[1] - collision.posY(), secondaryVertex[0] - collision.posX());
-      double theta = std::atan2(secondaryVertex[2] - collision.posZ(),
-                                std::sqrt((secondaryVertex[0] - collision.posX()) * (secondaryVertex[0] - collision.posX()) +
-                                          (secondaryVertex[1] - collision.posY()) * (secondaryVertex[1] - collision.posY())));
 
-      values[kVertexingLxyzErr] = std::sqrt(getRotatedCovMatrixXX(covMatrixPV, phi, theta) + getRotatedCovMatrixXX(covMatrixPCA, phi, theta));
-      values[kVertexingLxyErr] = std::sqrt(getRotatedCovMatrixXX(covMatrixPV, phi, 0.) + getRotatedCovMatrixXX(covMatrixPCA, phi, 0.));
-      values[kVertexingLzErr] = std::sqrt(getRotatedCovMatrixXX(covMatrixPV, 0, theta) + getRotatedCovMatrixXX(covMatrixPCA, 0, theta));
+      Vec3D secondaryVertex;
+      o2::dataformats::VertexBase primaryVertexNew;
 
-      values[kVertexingLxy] = (collision.posX() - secondaryVertex[0]) * (collision.posX() - secondaryVertex[0]) +
-                              (collision.posY() - secondaryVertex[1]) * (collision.posY() - secondaryVertex[1]);
-      values[kVertexingLz] = (collision.posZ() - secondaryVertex[2]) * (collision.posZ() - secondaryVertex[2]);
-      values[kVertexingLxyz] = values[kVertexingLxy] + values[kVertexingLz];
-      values[kVertexingLxy] = std::sqrt(values[kVertexingLxy]);
-      values[kVertexingLz] = std::sqrt(values[kVertexingLz]);
-      values[kVertexingLxyz] = std::sqrt(values[kVertexingLxyz]);
+      if constexpr (eventHasVtxCov) {
 
-      values[kVertexingTauz] = (collision.posZ() - secondaryVertex[2]) * v12.M() / (TMath::Abs(v12.Pz()) * o2::constants::physics::LightSpeedCm2NS);
-      values[kVertexingTauxy] = values[kVertexingLxy] * v12.M() / (v12.Pt() * o2::constants::physics::LightSpeedCm2NS);
+        std::array<float, 6> covMatrixPCA{};
+        // get track impact parameters
+        // This modifies track momenta!
+        o2::math_utils::Point3D<float> vtxXYZ(collision.posX(), collision.posY(), collision.posZ());
+        std::array<float, 6> vtxCov{collision.covXX(), collision.covXY(), collision.covYY(), collision.covXZ(), collision.covYZ(), collision.covZZ()};
+        o2::dataformats::VertexBase primaryVertex = {std::move(vtxXYZ), std::move(vtxCov)};
+        // auto primaryVertex = getPrimaryVertex(collision);
+        auto covMatrixPV = primaryVertex.getCov();
+
+        if constexpr ((pairType == kDecayToEE || pairType == kDecayToKPi) && trackHasCov) {
+          secondaryVertex = fit.fSecondaryVertex;
+          // printf("secVtx (first) %f %f  %f \n",secondaryVertex[0],secondaryVertex[1],secondaryVertex[2]);
+          covMatrixPCA = fit.fCovMatrixPCA;
+          values[kVertexingChi2PCA] = fit.fChi2PCA;
+          v1 = {fit.fPt[0], fit.fEta[0], fit.fPhi[0], m1};
+          v2 = {fit.fPt[1], fit.fEta[1], fit.fPhi[1], m2};
+          v12 = v1 + v2;
+          if (fgPVrecalKF)
+            primaryVertexNew = RecalculatePrimaryVertex(t1, t2, collision);
+
+        } else if constexpr (pairType == kDecayToMuMu && muonHasCov) {
+          // Get pca candidate from forward DCA fitter
+          secondaryVertex = fit.fSecondaryVertex;
+          covMatrixPCA = fit.fCovMatrixPCA;
+          values[kVertexingChi2PCA] = fit.fChi2PCA;
+          v1 = {fit.fPt[0], fit.fEta[0], fit.fPhi[0], m1};
+          v2 = {fit.fPt[1], fit.fEta[1], fit.fPhi[1], m2};
+          v12 = v1 + v2;
 
-      values[kVertexingPz] = TMath::Abs(v12.Pz());
-      values[kVertexingSV] = secondaryVertex[2];
+          values[kPt1] = fit.fPt[0];
+          values[kEta1] = fit.fEta[0];
+          values[kPhi1] = fit.fPhi[0];
 
-      values[kVertexingTauzErr] = values[kVertexingLzErr] * v12.M() / (TMath::Abs(v12.Pz()) * o2::constants::physics::LightSpeedCm2NS);
-      values[kVertexingTauxyErr] = values[kVertexingLxyErr] * v12.M() / (v12.Pt() * o2::constants::physics::LightSpeedCm2NS);
-
-      values[kCosPointingAngle] = ((collision.posX() - secondaryVertex[0]) * v12.Px() +
-                                   (collision.posY() - secondaryVertex[1]) * v12.Py() +
-                                   (collision.posZ() - secondaryVertex[2]) * v12.Pz()) /
-                                  (v12.P() * values[VarManager::kVertexingLxyz]);
-      // Decay length defined as in Run 2
-      values[kVertexingLzProjected] = ((secondaryVertex[2] - collision.posZ()) * v12.Pz()) / TMath::Sqrt(v12.Pz() * v12.Pz());
-      values[kVertexingLxyProjected] = ((secondaryVertex[0] - collision.posX()) * v12.Px()) + ((secondaryVertex[1] - collision.posY()) * v12.Py());
-      values[kVertexingLxyProjected] = values[kVertexingLxyProjected] / TMath::Sqrt((v12.Px() * v12.Px()) + (v12.Py() * v12.Py()));
-      values[kVertexingLxyzProjected] = ((secondaryVertex[0] - collision.posX()) * v12.Px()) + ((secondaryVertex[1] - collision.posY()) * v12.Py()) + ((secondaryVertex[2] - collision.posZ()) * v12.Pz());
-      values[kVertexingLxyzProjected] = values[kVertexingLxyzProjected] / TMath::Sqrt((v12.Px() * v12.Px()) + (v12.Py() * v12.Py()) + (v12.Pz() * v12.Pz()));
-      if (fgPVrecalKF) {
-        values[kVertexingLxyProjectedRecalculatePV] = (secondaryVertex[0] - primaryVertexNew.getX()) * v12.Px() + (secondaryVertex[1] - primaryVertexNew.getY()) * v12.Py();
-        values[kVertexingLxyProjectedRecalculatePV] = values[kVertexingLxyProjectedRecalculatePV] / v12.Pt();
-      }
-      values[kVertexingTauxyProjected] = values[kVertexingLxyProjected] * v12.M() / (v12.Pt());
-      values[kVertexingTauxyProjectedPoleJPsiMass] = values[kVertexingLxyProjected] * o2::constants::physics::MassJPsi / (v12.Pt());
-      values[kVertexingTauxyProjectedNs] = values[kVertexingTauxyProjected] / o2::constants::physics::LightSpeedCm2NS;
-      if (fgPVrecalKF)
-        values[kVertexingTauxyProjectedPoleJPsiMassRecalculatePV] = values[kVertexingLxyProjectedRecalculatePV] * o2::constants::physics::MassJPsi / (v12.Pt());
-      values[kVertexingTauzProjected] = values[kVertexingLzProjected] * v12.M() / TMath::Abs(v12.Pz());
-      values[kVertexingTauxyzProjected] = values[kVertexingLxyzProjected] * v12.M() / (v12.P());
-    }
-  } else {
-    KFParticle trk0KF;
-    KFParticle trk1KF;
-    KFParticle KFGeoTwoProng;
-    if constexpr ((pairType == kDecayToEE) && trackHasCov) {
-      KFPTrack kfpTrack0 = createKFPTrackFromTrack(t1);
-      trk0KF = KFParticle(kfpTrack0, -11 * t1.sign());
-      KFPTrack kfpTrack1 = createKFPTrackFromTrack(t2);
-      trk1KF = KFParticle(kfpTrack1, -11 * t2.sign());
+          values[kPt2] = fit.fPt[1];
+          values[kEta2] = fit.fEta[1];
+          values[kPhi2] = fit.fPhi[1];
+        }
+        double phi = std::atan2(secondaryVertex[1] - collision.posY(), secondaryVertex[0] - collision.posX());
+        double theta = std::atan2(secondaryVertex[2] - collision.posZ(),
+                                  std::sqrt((secondaryVertex[0] - collision.posX()) * (secondaryVertex[0] - collision.posX()) +
+                                            (secondaryVertex[1] - collision.posY()) * (secondaryVertex[1] - collision.posY())));
 
-      KFGeoTwoProng.SetConstructMethod(2);
-      KFGeoTwoProng.AddDaughter(trk0KF);
-      KFGeoTwoProng.AddDaughter(trk1KF);
+        values[kVertexingLxyzErr] = std::sqrt(getRotatedCovMatrixXX(covMatrixPV, phi, theta) + getRotatedCovMatrixXX(covMatrixPCA, phi, theta));
+        values[kVertexingLxyErr] = std::sqrt(getRotatedCovMatrixXX(covMatrixPV, phi, 0.) + getRotatedCovMatrixXX(covMatrixPCA, phi, 0.));
+        values[kVertexingLzErr] = std::sqrt(getRotatedCovMatrixXX(covMatrixPV, 0, theta) + getRotatedCovMatrixXX(covMatrixPCA, 0, theta));
 
-    } else if constexpr ((pairType == kDecayToMuMu) && muonHasCov) {
-      KFPTrack kfpTrack0 = createKFPFwdTrackFromFwdTrack(t1);
-      trk0KF = KFParticle(kfpTrack0, -13 * t1.sign());
-      KFPTrack kfpTrack1 = createKFPFwdTrackFromFwdTrack(t2);
-      trk1KF = KFParticle(kfpTrack1, -13 * t2.sign());
+        values[kVertexingLxy] = (collision.posX() - secondaryVertex[0]) * (collision.posX() - secondaryVertex[0]) +
+                                (collision.posY() - secondaryVertex[1]) * (collision.posY() - secondaryVertex[1]);
+        values[kVertexingLz] = (collision.posZ() - secondaryVertex[2]) * (collision.posZ() - secondaryVertex[2]);
+        values[kVertexingLxyz] = values[kVertexingLxy] + values[kVertexingLz];
+        values[kVertexingLxy] = std::sqrt(values[kVertexingLxy]);
+        values[kVertexingLz] = std::sqrt(values[kVertexingLz]);
+        values[kVertexingLxyz] = std::sqrt(values[kVertexingLxyz]);
 
-      KFGeoTwoProng.SetConstructMethod(2);
-      KFGeoTwoProng.AddDaughter(trk0KF);
-      KFGeoTwoProng.AddDaughter(trk1KF);
+        values[kVertexingTauz] = (collision.posZ() - secondaryVertex[2]) * v12.M() / (TMath::Abs(v12.Pz()) * o2::constants::physics::LightSpeedCm2NS);
+        values[kVertexingTauxy] = values[kVertexingLxy] * v12.M() / (v12.Pt() * o2::constants::physics::LightSpeedCm2NS);
 
-    } else if constexpr ((pairType == kDecayToKPi) && trackHasCov) {
-      KFPTrack kfpTrack0 = createKFPTrackFromTrack(t1);
-      trk0KF = KFParticle(kfpTrack0, 321 * t1.sign());
-      KFPTrack kfpTrack1 = createKFPTrackFromTrack(t2);
-      trk1KF = KFParticle(kfpTrack1, 211 * t2.sign());
+        values[kVertexingPz] = TMath::Abs(v12.Pz());
+        values[kVertexingSV] = secondaryVertex[2];
 
-      KFGeoTwoProng.SetConstructMethod(2);
-      KFGeoTwoProng.AddDaughter(trk0KF);
-      KFGeoTwoProng.AddDaughter(trk1KF);
-    }
-    if (fgUsedVars[kKFMass]) {
-      float mass = 0., massErr = 0.;
-      if (!KFGeoTwoProng.GetMass(mass, massErr))
-        values[kKFMass] = mass;
-      else
-        values[kKFMass] = -999.;
-    }
+        values[kVertexingTauzErr] = values[kVertexingLzErr] * v12.M() / (TMath::Abs(v12.Pz()) * o2::constants::physics::LightSpeedCm2NS);
+        values[kVertexingTauxyErr] = values[kVertexingLxyErr] * v12.M() / (v12.Pt() * o2::constants::physics::LightSpeedCm2NS);
 
-    if constexpr (eventHasVtxCov) {
-      KFPVertex kfpVertex = createKFPVertexFromCollision(collision);
-      values[kKFNContributorsPV] = kfpVertex.GetNContributors();
-      KFParticle KFPV(kfpVertex);
-      double dxPair2PV = KFGeoTwoProng.GetX() - KFPV.GetX();
-      double dyPair2PV = KFGeoTwoProng.GetY() - KFPV.GetY();
-      double dzPair2PV = KFGeoTwoProng.GetZ() - KFPV.GetZ();
-      if (fgUsedVars[kVertexingLxy] || fgUsedVars[kVertexingLz] || fgUsedVars[kVertexingLxyz] || fgUsedVars[kVertexingLxyErr] || fgUsedVars[kVertexingLzErr] || fgUsedVars[kVertexingTauxy] || fgUsedVars[kVertexingLxyOverErr] || fgUsedVars[kVertexingLzOverErr] || fgUsedVars[kVertexingLxyzOverErr] || fgUsedVars[kCosPointingAngle]) {
-        values[kVertexingLxy] = std::sqrt(dxPair2PV * dxPair2PV + dyPair2PV * dyPair2PV);
-        values[kVertexingLz] = std::sqrt(dzPair2PV * dzPair2PV);
-        values[kVertexingLxyz] = std::sqrt(dxPair2PV * dxPair2PV + dyPair2PV * dyPair2PV + dzPair2PV * dzPair2PV);
-        values[kVertexingLxyErr] = (KFPV.GetCovariance(0) + KFGeoTwoProng.GetCovariance(0)) * dxPair2PV * dxPair2PV + (KFPV.GetCovariance(2) + KFGeoTwoProng.GetCovariance(2)) * dyPair2PV * dyPair2PV + 2 * ((KFPV.GetCovariance(1) + KFGeoTwoProng.GetCovariance(1)) * dxPair2PV * dyPair2PV);
-        values[kVertexingLzErr] = (KFPV.GetCovariance(5) + KFGeoTwoProng.GetCovariance(5)) * dzPair2PV * dzPair2PV;
-        values[kVertexingLxyzErr] = (KFPV.GetCovariance(0) + KFGeoTwoProng.GetCovariance(0)) * dxPair2PV * dxPair2PV + (KFPV.GetCovariance(2) + KFGeoTwoProng.GetCovariance(2)) * dyPair2PV * dyPair2PV + (KFPV.GetCovariance(5) + KFGeoTwoProng.GetCovariance(5)) * dzPair2PV * dzPair2PV + 2 * ((KFPV.GetCovariance(1) + KFGeoTwoProng.GetCovariance(1)) * dxPair2PV * dyPair2PV + (KFPV.GetCovariance(3) + KFGeoTwoProng.GetCovariance(3)) * dxPair2PV * dzPair2PV + (KFPV.GetCovariance(4) + KFGeoTwoProng.GetCovariance(4)) * dyPair2PV * dzPair2PV);
-        if (fabs(values[kVertexingLxy]) < 1.e-8f)
-          values[kVertexingLxy] = 1.e-8f;
-        values[kVertexingLxyErr] = values[kVertexingLxyErr] < 0. ? 1.e8f : std::sqrt(values[kVertexingLxyErr]) / values[kVertexingLxy];
-        if (fabs(values[kVertexingLz]) < 1.e-8f)
-          values[kVertexingLz] = 1.e-8f;
-        values[kVertexingLzErr] = values[kVertexingLzErr] < 0. ? 1.e8f : std::sqrt(values[kVertexingLzErr]) / values[kVertexingLz];
-        if (fabs(values[kVertexingLxyz]) < 1.e-8f)
-          values[kVertexingLxyz] = 1.e-8f;
-        values[kVertexingLxyzErr] = values[kVertexingLxyzErr] < 0. ? 1.e8f : std::sqrt(values[kVertexingLxyzErr]) / values[kVertexingLxyz];
-        values[kVertexingTauxy] = KFGeoTwoProng.GetPseudoProperDecayTime(KFPV, KFGeoTwoProng.GetMass()) / (o2::constants::physics::LightSpeedCm2NS);
-        values[kVertexingTauz] = -1 * dzPair2PV * KFGeoTwoProng.GetMass() / (TMath::Abs(KFGeoTwoProng.GetPz()) * o2::constants::physics::LightSpeedCm2NS);
-        values[kVertexingPz] = TMath::Abs(KFGeoTwoProng.GetPz());
-        values[kVertexingSV] = KFGeoTwoProng.GetZ();
-        values[kVertexingTauxyErr] = values[kVertexingLxyErr] * KFGeoTwoProng.GetMass() / (KFGeoTwoProng.GetPt() * o2::constants::physics::LightSpeedCm2NS);
-        values[kVertexingTauzErr] = values[kVertexingLzErr] * KFGeoTwoProng.GetMass() / (TMath::Abs(KFGeoTwoProng.GetPz()) * o2::constants::physics::LightSpeedCm2NS);
-        values[kCosPointingAngle] = (std::sqrt(dxPair2PV * dxPair2PV) * v12.Px() +
-                                     std::sqrt(dyPair2PV * dyPair2PV) * v12.Py() +
-                                     std::sqrt(dzPair2PV * dzPair2PV) * v12.Pz()) /
+        values[kCosPointingAngle] = ((collision.posX() - secondaryVertex[0]) * v12.Px() +
+                                     (collision.posY() - secondaryVertex[1]) * v12.Py() +
+                                     (collision.posZ() - secondaryVertex[2]) * v12.Pz()) /
                                     (v12.P() * values[VarManager::kVertexingLxyz]);
-      }
-      // As defined in Run 2 (projected onto momentum)
-      if (fgUsedVars[kVertexingLxyProjected] || fgUsedVars[kVertexingLxyzProjected] || fgUsedVars[kVertexingLzProjected]) {
-        values[kVertexingLzProjected] = (dzPair2PV * KFGeoTwoProng.GetPz()) / TMath::Sqrt(KFGeoTwoProng.GetPz() * KFGeoTwoProng.GetPz());
-        values[kVertexingLxyProjected] = (dxPair2PV * KFGeoTwoProng.GetPx()) + (dyPair2PV * KFGeoTwoProng.GetPy());
-        values[kVertexingLxyProjected] = values[kVertexingLxyProjected] / TMath::Sqrt((KFGeoTwoProng.GetPx() * KFGeoTwoProng.GetPx()) + (KFGeoTwoProng.GetPy() * KFGeoTwoProng.GetPy()));
-        values[kVertexingLxyzProjected] = (dxPair2PV * KFGeoTwoProng.GetPx()) + (dyPair2PV * KFGeoTwoProng.GetPy()) + (dzPair2PV * KFGeoTwoProng.GetPz());
-        values[kVertexingLxyzProjected] = values[kVertexingLxyzProjected] / TMath::Sqrt((KFGeoTwoProng.GetPx() * KFGeoTwoProng.GetPx()) + (KFGeoTwoProng.GetPy() * KFGeoTwoProng.GetPy()) + (KFGeoTwoProng.GetPz() * KFGeoTwoProng.GetPz()));
-        values[kVertexingTauxyProjected] = values[kVertexingLxyProjected] * KFGeoTwoProng.GetMass() / (KFGeoTwoProng.GetPt());
-        values[kVertexingTauxyProjectedPoleJPsiMass] = values[kVertexingLxyProjected] * o2::constants::physics::MassJPsi / (KFGeoTwoProng.GetPt());
+        // Decay length defined as in Run 2
+        values[kVertexingLzProjected] = ((secondaryVertex[2] - collision.posZ()) * v12.Pz()) / TMath::Sqrt(v12.Pz() * v12.Pz());
+        values[kVertexingLxyProjected] = ((secondaryVertex[0] - collision.posX()) * v12.Px()) + ((secondaryVertex[1] - collision.posY()) * v12.Py());
+        values[kVertexingLxyProjected] = values[kVertexingLxyProjected] / TMath::Sqrt((v12.Px() * v12.Px()) + (v12.Py() * v12.Py()));
+        values[kVertexingLxyzProjected] = ((secondaryVertex[0] - collision.posX()) * v12.Px()) + ((secondaryVertex[1] - collision.posY()) * v12.Py()) + ((secondaryVertex[2] - collision.posZ()) * v12.Pz());
+        values[kVertexingLxyzProjected] = values[kVertexingLxyzProjected] / TMath::Sqrt((v12.Px() * v12.Px()) + (v12.Py() * v12.Py()) + (v12.Pz() * v12.Pz()));
+        if (fgPVrecalKF) {
+          values[kVertexingLxyProjectedRecalculatePV] = (secondaryVertex[0] - primaryVertexNew.getX()) * v12.Px() + (secondaryVertex[1] - primaryVertexNew.getY()) * v12.Py();
+          values[kVertexingLxyProjectedRecalculatePV] = values[kVertexingLxyProjectedRecalculatePV] / v12.Pt();
+        }
+        values[kVertexingTauxyProjected] = values[kVertexingLxyProjected] * v12.M() / (v12.Pt());
+        values[kVertexingTauxyProjectedPoleJPsiMass] = values[kVertexingLxyProjected] * o2::constants::physics::MassJPsi / (v12.Pt());
         values[kVertexingTauxyProjectedNs] = values[kVertexingTauxyProjected] / o2::constants::physics::LightSpeedCm2NS;
-        values[kVertexingTauzProjected] = values[kVertexingLzProjected] * KFGeoTwoProng.GetMass() / TMath::Abs(KFGeoTwoProng.GetPz());
-      }
-
-      if (fgUsedVars[kVertexingLxyOverErr] || fgUsedVars[kVertexingLzOverErr] || fgUsedVars[kVertexingLxyzOverErr]) {
-        values[kVertexingLxyOverErr] = values[kVertexingLxy] / values[kVertexingLxyErr];
-        values[kVertexingLzOverErr] = values[kVertexingLz] / values[kVertexingLzErr];
-        values[kVertexingLxyzOverErr] = values[kVertexingLxyz] / values[kVertexingLxyzErr];
-      }
-
-      if (fgUsedVars[kKFChi2OverNDFGeo])
-        values[kKFChi2OverNDFGeo] = KFGeoTwoProng.GetChi2() / KFGeoTwoProng.GetNDF();
-      if (fgUsedVars[kKFCosPA])
-        values[kKFCosPA] = calculateCosPA(KFGeoTwoProng, KFPV);
-
-      // in principle, they should be in FillTrack
-      if (fgUsedVars[kKFTrack0DCAxyz] || fgUsedVars[kKFTrack1DCAxyz]) {
-        values[kKFTrack0DCAxyz] = trk0KF.GetDistanceFromVertex(KFPV);
-        values[kKFTrack1DCAxyz] = trk1KF.GetDistanceFromVertex(KFPV);
-      }
-      if (fgUsedVars[kKFTrack0DCAxy] || fgUsedVars[kKFTrack1DCAxy]) {
-        values[kKFTrack0DCAxy] = trk0KF.GetDistanceFromVertexXY(KFPV);
-        values[kKFTrack1DCAxy] = trk1KF.GetDistanceFromVertexXY(KFPV);
-      }
-      if (fgUsedVars[kKFDCAxyzBetweenProngs])
-        values[kKFDCAxyzBetweenProngs] = trk0KF.GetDistanceFromParticle(trk1KF);
-      if (fgUsedVars[kKFDCAxyBetweenProngs])
-        values[kKFDCAxyBetweenProngs] = trk0KF.GetDistanceFromParticleXY(trk1KF);
-
-      if (fgUsedVars[kKFTracksDCAxyzMax]) {
-        values[kKFTracksDCAxyzMax] = values[kKFTrack0DCAxyz] > values[kKFTrack1DCAxyz] ? values[kKFTrack0DCAxyz] : values[kKFTrack1DCAxyz];
-      }
-      if (fgUsedVars[kKFTracksDCAxyMax]) {
-        values[kKFTracksDCAxyMax] = TMath::Abs(values[kKFTrack0DCAxy]) > TMath::Abs(values[kKFTrack1DCAxy]) ? values[kKFTrack0DCAxy] : values[kKFTrack1DCAxy];
-      }
-      if (fgUsedVars[kKFTrack0DeviationFromPV] || fgUsedVars[kKFTrack1DeviationFromPV]) {
-        values[kKFTrack0DeviationFromPV] = trk0KF.GetDeviationFromVertex(KFPV);
-        values[kKFTrack1DeviationFromPV] = trk1KF.GetDeviationFromVertex(KFPV);
-      }
-      if (fgUsedVars[kKFTrack0DeviationxyFromPV] || fgUsedVars[kKFTrack1DeviationxyFromPV]) {
-        values[kKFTrack0DeviationxyFromPV] = trk0KF.GetDeviationFromVertexXY(KFPV);
-        values[kKFTrack1DeviationxyFromPV] = trk1KF.GetDeviationFromVertexXY(KFPV);
-      }
-      if (fgUsedVars[kKFJpsiDCAxyz]) {
-        values[kKFJpsiDCAxyz] = KFGeoTwoProng.GetDistanceFromVertex(KFPV);
-      }
-      if (fgUsedVars[kKFJpsiDCAxy]) {
-        values[kKFJpsiDCAxy] = KFGeoTwoProng.GetDistanceFromVertexXY(KFPV);
+        if (fgPVrecalKF)
+          values[kVertexingTauxyProjectedPoleJPsiMassRecalculatePV] = values[kVertexingLxyProjectedRecalculatePV] * o2::constants::physics::MassJPsi / (v12.Pt());
+        values[kVertexingTauzProjected] = values[kVertexingLzProjected] * v12.M() / TMath::Abs(v12.Pz());
+        values[kVertexingTauxyzProjected] = values[kVertexingLxyzProjected] * v12.M() / (v12.P());
       }
-      if (fgUsedVars[kKFPairDeviationFromPV] || fgUsedVars[kKFPairDeviationxyFromPV]) {
-        values[kKFPairDeviationFromPV] = KFGeoTwoProng.GetDeviationFromVertex(KFPV);
-        values[kKFPairDeviationxyFromPV] = KFGeoTwoProng.GetDeviationFromVertexXY(KFPV);
+    }
+  } else {
+    if constexpr (vertexer != kVertexerDCAFitter) {
+      KFParticle trk0KF;
+      KFParticle trk1KF;
+      KFParticle KFGeoTwoProng;
+      if constexpr ((pairType == kDecayToEE) && trackHasCov) {
+        KFPTrack kfpTrack0 = createKFPTrackFromTrack(t1);
+        trk0KF = KFParticle(kfpTrack0, -11 * t1.sign());
+        KFPTrack kfpTrack1 = createKFPTrackFromTrack(t2);
+        trk1KF = KFParticle(kfpTrack1, -11 * t2.sign());
+
+        KFGeoTwoProng.SetConstructMethod(2);
+        KFGeoTwoProng.AddDaughter(trk0KF);
+        KFGeoTwoProng.AddDaughter(trk1KF);
+
+      } else if constexpr ((pairType == kDecayToMuMu) && muonHasCov) {
+        KFPTrack kfpTrack0 = createKFPFwdTrackFromFwdTrack(t1);
+        trk0KF = KFParticle(kfpTrack0, -13 * t1.sign());
+        KFPTrack kfpTrack1 = createKFPFwdTrackFromFwdTrack(t2);
+        trk1KF = KFParticle(kfpTrack1, -13 * t2.sign());
+
+        KFGeoTwoProng.SetConstructMethod(2);
+        KFGeoTwoProng.AddDaughter(trk0KF);
+        KFGeoTwoProng.AddDaughter(trk1KF);
+
+      } else if constexpr ((pairType == kDecayToKPi) && trackHasCov) {
+        KFPTrack kfpTrack0 = createKFPTrackFromTrack(t1);
+        trk0KF = KFParticle(kfpTrack0, 321 * t1.sign());
+        KFPTrack kfpTrack1 = createKFPTrackFromTrack(t2);
+        trk1KF = KFParticle(kfpTrack1, 211 * t2.sign());
+
+        KFGeoTwoProng.SetConstructMethod(2);
+        KFGeoTwoProng.AddDaughter(trk0KF);
+        KFGeoTwoProng.AddDaughter(trk1KF);
       }
-      if (fgUsedVars[kKFChi2OverNDFGeoTop] || fgUsedVars[kKFMassGeoTop]) {
-        KFParticle KFGeoTopTwoProngBarrel = KFGeoTwoProng;
-        KFGeoTopTwoProngBarrel.SetProductionVertex(KFPV);
-        values[kKFChi2OverNDFGeoTop] = KFGeoTopTwoProngBarrel.GetChi2() / KFGeoTopTwoProngBarrel.GetNDF();
+      if (fgUsedVars[kKFMass]) {
         float mass = 0., massErr = 0.;
-        if (!KFGeoTopTwoProngBarrel.GetMass(mass, massErr))
-          values[kKFMassGeoTop] = mass;
+        if (!KFGeoTwoProng.GetMass(mass, massErr))
+          values[kKFMass] = mass;
         else
-          values[kKFMassGeoTop] = -999.;
+          values[kKFMass] = -999.;
       }
-      if (propToSV) {
-        if constexpr ((pairType == kDecayToMuMu) && muonHasCov) {
-          o2::track::TrackParCovFwd pars1 = FwdToTrackPar(t1, t1);
-          o2::track::TrackParCovFwd pars2 = FwdToTrackPar(t2, t2);
-
-          auto geoMan1 = o2::base::GeometryManager::meanMaterialBudget(t1.x(), t1.y(), t1.z(), KFGeoTwoProng.GetX(), KFGeoTwoProng.GetY(), KFGeoTwoProng.GetZ());
-          auto geoMan2 = o2::base::GeometryManager::meanMaterialBudget(t2.x(), t2.y(), t2.z(), KFGeoTwoProng.GetX(), KFGeoTwoProng.GetY(), KFGeoTwoProng.GetZ());
-          auto x2x01 = static_cast<float>(geoMan1.meanX2X0);
-          auto x2x02 = static_cast<float>(geoMan2.meanX2X0);
-          float B[3];
-          float xyz[3] = {0, 0, 0};
-          KFGeoTwoProng.GetFieldValue(xyz, B);
-          // TODO: find better soluton to handle cases where KF outputs negative variances
-          /*float covXX = 0.1;
-          float covYY = 0.1;
-          if (KFGeoTwoProng.GetCovariance(0, 0) > 0) {
-            covXX = KFGeoTwoProng.GetCovariance(0, 0);
-          }
-          if (KFGeoTwoProng.GetCovariance(1, 1) > 0) {
-            covYY = KFGeoTwoProng.GetCovariance(0, 0);
-          }*/
-          pars1.propagateToVtxhelixWithMCS(KFGeoTwoProng.GetZ(), {KFGeoTwoProng.GetX(), KFGeoTwoProng.GetY()}, {KFGeoTwoProng.GetCovariance(0, 0), KFGeoTwoProng.GetCovariance(1, 1)}, B[2], x2x01);
-          pars2.propagateToVtxhelixWithMCS(KFGeoTwoProng.GetZ(), {KFGeoTwoProng.GetX(), KFGeoTwoProng.GetY()}, {KFGeoTwoProng.GetCovariance(0, 0), KFGeoTwoProng.GetCovariance(1, 1)}, B[2], x2x02);
-          v1 = {pars1.getPt(), pars1.getEta(), pars1.getPhi(), m1};
-          v2 = {pars2.getPt(), pars2.getEta(), pars2.getPhi(), m2};
-          v12 = v1 + v2;
-          values[kMass] = v12.M();
-          values[kPt] = v12.Pt();
-          values[kEta] = v12.Eta();
-          values[kPhi] = v12.Phi();
-          values[kRap] = -v12.Rapidity();
-          values[kVertexingTauxy] = KFGeoTwoProng.GetPseudoProperDecayTime(KFPV, v12.M()) / (o2::constants::physics::LightSpeedCm2NS);
-          values[kVertexingTauz] = -1 * dzPair2PV * v12.M() / (TMath::Abs(v12.Pz()) * o2::constants::physics::LightSpeedCm2NS);
-          values[kVertexingTauxyErr] = values[kVertexingLxyErr] * v12.M() / (v12.Pt() * o2::constants::physics::LightSpeedCm2NS);
-          values[kVertexingTauzErr] = values[kVertexingLzErr] * v12.M() / (TMath::Abs(v12.Pz()) * o2::constants::physics::LightSpeedCm2NS);
-          values[kVertexingPz] = TMath::Abs(v12.Pz());
+
+      if constexpr (eventHasVtxCov) {
+        KFPVertex kfpVertex = createKFPVertexFromCollision(collision);
+        values[kKFNContributorsPV] = kfpVertex.GetNContributors();
+        KFParticle KFPV(kfpVertex);
+        double dxPair2PV = KFGeoTwoProng.GetX() - KFPV.GetX();
+        double dyPair2PV = KFGeoTwoProng.GetY() - KFPV.GetY();
+        double dzPair2PV = KFGeoTwoProng.GetZ() - KFPV.GetZ();
+        if (fgUsedVars[kVertexingLxy] || fgUsedVars[kVertexingLz] || fgUsedVars[kVertexingLxyz] || fgUsedVars[kVertexingLxyErr] || fgUsedVars[kVertexingLzErr] || fgUsedVars[kVertexingTauxy] || fgUsedVars[kVertexingLxyOverErr] || fgUsedVars[kVertexingLzOverErr] || fgUsedVars[kVertexingLxyzOverErr] || fgUsedVars[kCosPointingAngle]) {
+          values[kVertexingLxy] = std::sqrt(dxPair2PV * dxPair2PV + dyPair2PV * dyPair2PV);
+          values[kVertexingLz] = std::sqrt(dzPair2PV * dzPair2PV);
+          values[kVertexingLxyz] = std::sqrt(dxPair2PV * dxPair2PV + dyPair2PV * dyPair2PV + dzPair2PV * dzPair2PV);
+          values[kVertexingLxyErr] = (KFPV.GetCovariance(0) + KFGeoTwoProng.GetCovariance(0)) * dxPair2PV * dxPair2PV + (KFPV.GetCovariance(2) + KFGeoTwoProng.GetCovariance(2)) * dyPair2PV * dyPair2PV + 2 * ((KFPV.GetCovariance(1) + KFGeoTwoProng.GetCovariance(1)) * dxPair2PV * dyPair2PV);
+          values[kVertexingLzErr] = (KFPV.GetCovariance(5) + KFGeoTwoProng.GetCovariance(5)) * dzPair2PV * dzPair2PV;
+          values[kVertexingLxyzErr] = (KFPV.GetCovariance(0) + KFGeoTwoProng.GetCovariance(0)) * dxPair2PV * dxPair2PV + (KFPV.GetCovariance(2) + KFGeoTwoProng.GetCovariance(2)) * dyPair2PV * dyPair2PV + (KFPV.GetCovariance(5) + KFGeoTwoProng.GetCovariance(5)) * dzPair2PV * dzPair2PV + 2 * ((KFPV.GetCovariance(1) + KFGeoTwoProng.GetCovariance(1)) * dxPair2PV * dyPair2PV + (KFPV.GetCovariance(3) + KFGeoTwoProng.GetCovariance(3)) * dxPair2PV * dzPair2PV + (KFPV.GetCovariance(4) + KFGeoTwoProng.GetCovariance(4)) * dyPair2PV * dzPair2PV);
+          if (fabs(values[kVertexingLxy]) < 1.e-8f)
+            values[kVertexingLxy] = 1.e-8f;
+          values[kVertexingLxyErr] = values[kVertexingLxyErr] < 0. ? 1.e8f : std::sqrt(values[kVertexingLxyErr]) / values[kVertexingLxy];
+          if (fabs(values[kVertexingLz]) < 1.e-8f)
+            values[kVertexingLz] = 1.e-8f;
+          values[kVertexingLzErr] = values[kVertexingLzErr] < 0. ? 1.e8f : std::sqrt(values[kVertexingLzErr]) / values[kVertexingLz];
+          if (fabs(values[kVertexingLxyz]) < 1.e-8f)
+            values[kVertexingLxyz] = 1.e-8f;
+          values[kVertexingLxyzErr] = values[kVertexingLxyzErr] < 0. ? 1.e8f : std::sqrt(values[kVertexingLxyzErr]) / values[kVertexingLxyz];
+          values[kVertexingTauxy] = KFGeoTwoProng.GetPseudoProperDecayTime(KFPV, KFGeoTwoProng.GetMass()) / (o2::constants::physics::LightSpeedCm2NS);
+          values[kVertexingTauz] = -1 * dzPair2PV * KFGeoTwoProng.GetMass() / (TMath::Abs(KFGeoTwoProng.GetPz()) * o2::constants::physics::LightSpeedCm2NS);
+          values[kVertexingPz] = TMath::Abs(KFGeoTwoProng.GetPz());
           values[kVertexingSV] = KFGeoTwoProng.GetZ();
+          values[kVertexingTauxyErr] = values[kVertexingLxyErr] * KFGeoTwoProng.GetMass() / (KFGeoTwoProng.GetPt() * o2::constants::physics::LightSpeedCm2NS);
+          values[kVertexingTauzErr] = values[kVertexingLzErr] * KFGeoTwoProng.GetMass() / (TMath::Abs(KFGeoTwoProng.GetPz()) * o2::constants::physics::LightSpeedCm2NS);
+          values[kCosPointingAngle] = (std::sqrt(dxPair2PV * dxPair2PV) * v12.Px() +
+                                       std::sqrt(dyPair2PV * dyPair2PV) * v12.Py() +
+                                       std::sqrt(dzPair2PV * dzPair2PV) * v12.Pz()) /
+                                      (v12.P() * values[VarManager::kVertexingLxyz]);
+        }
+        // As defined in Run 2 (projected onto momentum)
+        if (fgUsedVars[kVertexingLxyProjected] || fgUsedVars[kVertexingLxyzProjected] || fgUsedVars[kVertexingLzProjected]) {
+          values[kVertexingLzProjected] = (dzPair2PV * KFGeoTwoProng.GetPz()) / TMath::Sqrt(KFGeoTwoProng.GetPz() * KFGeoTwoProng.GetPz());
+          values[kVertexingLxyProjected] = (dxPair2PV * KFGeoTwoProng.GetPx()) + (dyPair2PV * KFGeoTwoProng.GetPy());
+          values[kVertexingLxyProjected] = values[kVertexingLxyProjected] / TMath::Sqrt((KFGeoTwoProng.GetPx() * KFGeoTwoProng.GetPx()) + (KFGeoTwoProng.GetPy() * KFGeoTwoProng.GetPy()));
+          values[kVertexingLxyzProjected] = (dxPair2PV * KFGeoTwoProng.GetPx()) + (dyPair2PV * KFGeoTwoProng.GetPy()) + (dzPair2PV * KFGeoTwoProng.GetPz());
+          values[kVertexingLxyzProjected] = values[kVertexingLxyzProjected] / TMath::Sqrt((KFGeoTwoProng.GetPx() * KFGeoTwoProng.GetPx()) + (KFGeoTwoProng.GetPy() * KFGeoTwoProng.GetPy()) + (KFGeoTwoProng.GetPz() * KFGeoTwoProng.GetPz()));
+          values[kVertexingTauxyProjected] = values[kVertexingLxyProjected] * KFGeoTwoProng.GetMass() / (KFGeoTwoProng.GetPt());
+          values[kVertexingTauxyProjectedPoleJPsiMass] = values[kVertexingLxyProjected] * o2::constants::physics::MassJPsi / (KFGeoTwoProng.GetPt());
+          values[kVertexingTauxyProjectedNs] = values[kVertexingTauxyProjected] / o2::constants::physics::LightSpeedCm2NS;
+          values[kVertexingTauzProjected] = values[kVertexingLzProjected] * KFGeoTwoProng.GetMass() / TMath::Abs(KFGeoTwoProng.GetPz());
+        }
+
+        if (fgUsedVars[kVertexingLxyOverErr] || fgUsedVars[kVertexingLzOverErr] || fgUsedVars[kVertexingLxyzOverErr]) {
+          values[kVertexingLxyOverErr] = values[kVertexingLxy] / values[kVertexingLxyErr];
+          values[kVertexingLzOverErr] = values[kVertexingLz] / values[kVertexingLzErr];
+          values[kVertexingLxyzOverErr] = values[kVertexingLxyz] / values[kVertexingLxyzErr];
+        }
 
-          values[kPt1] = pars1.getPt();
-          values[kEta1] = pars1.getEta();
-          values[kPhi1] = pars1.getPhi();
+        if (fgUsedVars[kKFChi2OverNDFGeo])
+          values[kKFChi2OverNDFGeo] = KFGeoTwoProng.GetChi2() / KFGeoTwoProng.GetNDF();
+        if (fgUsedVars[kKFCosPA])
+          values[kKFCosPA] = calculateCosPA(KFGeoTwoProng, KFPV);
 
-          values[kPt2] = pars2.getPt();
-          values[kEta2] = pars2.getEta();
-          values[kPhi2] = pars2.getPhi();
+        // in principle, they should be in FillTrack
+        if (fgUsedVars[kKFTrack0DCAxyz] || fgUsedVars[kKFTrack1DCAxyz]) {
+          values[kKFTrack0DCAxyz] = trk0KF.GetDistanceFromVertex(KFPV);
+          values[kKFTrack1DCAxyz] = trk1KF.GetDistanceFromVertex(KFPV);
+        }
+        if (fgUsedVars[kKFTrack0DCAxy] || fgUsedVars[kKFTrack1DCAxy]) {
+          values[kKFTrack0DCAxy] = trk0KF.GetDistanceFromVertexXY(KFPV);
+          values[kKFTrack1DCAxy] = trk1KF.GetDistanceFromVertexXY(KFPV);
+        }
+        if (fgUsedVars[kKFDCAxyzBetweenProngs])
+          values[kKFDCAxyzBetweenProngs] = trk0KF.GetDistanceFromParticle(trk1KF);
+        if (fgUsedVars[kKFDCAxyBetweenProngs])
+          values[kKFDCAxyBetweenProngs] = trk0KF.GetDistanceFromParticleXY(trk1KF);
+
+        if (fgUsedVars[kKFTracksDCAxyzMax]) {
+          values[kKFTracksDCAxyzMax] = values[kKFTrack0DCAxyz] > values[kKFTrack1DCAxyz] ? values[kKFTrack0DCAxyz] : values[kKFTrack1DCAxyz];
+        }
+        if (fgUsedVars[kKFTracksDCAxyMax]) {
+          values[kKFTracksDCAxyMax] = TMath::Abs(values[kKFTrack0DCAxy]) > TMath::Abs(values[kKFTrack1DCAxy]) ? values[kKFTrack0DCAxy] : values[kKFTrack1DCAxy];
+        }
+        if (fgUsedVars[kKFTrack0DeviationFromPV] || fgUsedVars[kKFTrack1DeviationFromPV]) {
+          values[kKFTrack0DeviationFromPV] = trk0KF.GetDeviationFromVertex(KFPV);
+          values[kKFTrack1DeviationFromPV] = trk1KF.GetDeviationFromVertex(KFPV);
+        }
+        if (fgUsedVars[kKFTrack0DeviationxyFromPV] || fgUsedVars[kKFTrack1DeviationxyFromPV]) {
+          values[kKFTrack0DeviationxyFromPV] = trk0KF.GetDeviationFromVertexXY(KFPV);
+          values[kKFTrack1DeviationxyFromPV] = trk1KF.GetDeviationFromVertexXY(KFPV);
+        }
+        if (fgUsedVars[kKFJpsiDCAxyz]) {
+          values[kKFJpsiDCAxyz] = KFGeoTwoProng.GetDistanceFromVertex(KFPV);
+        }
+        if (fgUsedVars[kKFJpsiDCAxy]) {
+          values[kKFJpsiDCAxy] = KFGeoTwoProng.GetDistanceFromVertexXY(KFPV);
+        }
+        if (fgUsedVars[kKFPairDeviationFromPV] || fgUsedVars[kKFPairDeviationxyFromPV]) {
+          values[kKFPairDeviationFromPV] = KFGeoTwoProng.GetDeviationFromVertex(KFPV);
+          values[kKFPairDeviationxyFromPV] = KFGeoTwoProng.GetDeviationFromVertexXY(KFPV);
+        }
+        if (fgUsedVars[kKFChi2OverNDFGeoTop] || fgUsedVars[kKFMassGeoTop]) {
+          KFParticle KFGeoTopTwoProngBarrel = KFGeoTwoProng;
+          KFGeoTopTwoProngBarrel.SetProductionVertex(KFPV);
+          values[kKFChi2OverNDFGeoTop] = KFGeoTopTwoProngBarrel.GetChi2() / KFGeoTopTwoProngBarrel.GetNDF();
+          float mass = 0., massErr = 0.;
+          if (!KFGeoTopTwoProngBarrel.GetMass(mass, massErr))
+            values[kKFMassGeoTop] = mass;
+          else
+            values[kKFMassGeoTop] = -999.;
+        }
+        if (propToSV) {
+          if constexpr ((pairType == kDecayToMuMu) && muonHasCov) {
+            o2::track::TrackParCovFwd pars1 = FwdToTrackPar(t1, t1);
+            o2::track::TrackParCovFwd pars2 = FwdToTrackPar(t2, t2);
+
+            auto geoMan1 = o2::base::GeometryManager::meanMaterialBudget(t1.x(), t1.y(), t1.z(), KFGeoTwoProng.GetX(), KFGeoTwoProng.GetY(), KFGeoTwoProng.GetZ());
+            auto geoMan2 = o2::base::GeometryManager::meanMaterialBudget(t2.x(), t2.y(), t2.z(), KFGeoTwoProng.GetX(), KFGeoTwoProng.GetY(), KFGeoTwoProng.GetZ());
+            auto x2x01 = static_cast<float>(geoMan1.meanX2X0);
+            auto x2x02 = static_cast<float>(geoMan2.meanX2X0);
+            float B[3];
+            float xyz[3] = {0, 0, 0};
+            KFGeoTwoProng.GetFieldValue(xyz, B);
+            // TODO: find better soluton to handle cases where KF outputs negative variances
+            /*float covXX = 0.1;
+            float covYY = 0.1;
+            if (KFGeoTwoProng.GetCovariance(0, 0) > 0) {
+              covXX = KFGeoTwoProng.GetCovariance(0, 0);
+            }
+            if (KFGeoTwoProng.GetCovariance(1, 1) > 0) {
+              covYY = KFGeoTwoProng.GetCovariance(0, 0);
+            }*/
+            pars1.propagateToVtxhelixWithMCS(KFGeoTwoProng.GetZ(), {KFGeoTwoProng.GetX(), KFGeoTwoProng.GetY()}, {KFGeoTwoProng.GetCovariance(0, 0), KFGeoTwoProng.GetCovariance(1, 1)}, B[2], x2x01);
+            pars2.propagateToVtxhelixWithMCS(KFGeoTwoProng.GetZ(), {KFGeoTwoProng.GetX(), KFGeoTwoProng.GetY()}, {KFGeoTwoProng.GetCovariance(0, 0), KFGeoTwoProng.GetCovariance(1, 1)}, B[2], x2x02);
+            v1 = {pars1.getPt(), pars1.getEta(), pars1.getPhi(), m1};
+            v2 = {pars2.getPt(), pars2.getEta(), pars2.getPhi(), m2};
+            v12 = v1 + v2;
+            values[kMass] = v12.M();
+            values[kPt] = v12.Pt();
+            values[kEta] = v12.Eta();
+            values[kPhi] = v12.Phi();
+            values[kRap] = -v12.Rapidity();
+            values[kVertexingTauxy] = KFGeoTwoProng.GetPseudoProperDecayTime(KFPV, v12.M()) / (o2::constants::physics::LightSpeedCm2NS);
+            values[kVertexingTauz] = -1 * dzPair2PV * v12.M() / (TMath::Abs(v12.Pz()) * o2::constants::physics::LightSpeedCm2NS);
+            values[kVertexingTauxyErr] = values[kVertexingLxyErr] * v12.M() / (v12.Pt() * o2::constants::physics::LightSpeedCm2NS);
+            values[kVertexingTauzErr] = values[kVertexingLzErr] * v12.M() / (TMath::Abs(v12.Pz()) * o2::constants::physics::LightSpeedCm2NS);
+            values[kVertexingPz] = TMath::Abs(v12.Pz());
+            values[kVertexingSV] = KFGeoTwoProng.GetZ();
+
+            values[kPt1] = pars1.getPt();
+            values[kEta1] = pars1.getEta();
+            values[kPhi1] = pars1.getPhi();
+
+            values[kPt2] = pars2.getPt();
+            values[kEta2] = pars2.getEta();
+            values[kPhi2] = pars2.getPhi();
+          }
         }
       }
     }
@@ -4735,6 +4883,10 @@ void VarManager::FillPairVertexingRecomputePV(C const& /*collision*/, T const& t
     values = fgValues;
   }
 
+  if (!IsVarGroupNeeded(kVarGroupPVRefit)) {
+    return;
+  }
+
   float m1 = o2::constants::physics::MassElectron;
   float m2 = o2::constants::physics::MassElectron;
   if constexpr (pairType == kDecayToKPi) {
@@ -4795,6 +4947,10 @@ void VarManager::FillTripletVertexing(C const& collision, T const& t1, T const&
     values = fgValues;
   }
 
+  if (!IsVarGroupNeeded(kVarGroupSecondaryVertexing)) {
+    return;
+  }
+
   float m1, m2, m3;
 
   if (tripletType == kTripleCandidateToKPiPi) {
@@ -5017,6 +5173,10 @@ void VarManager::FillDileptonTrackVertexing(C const& collision, T1 const& lepton
     values = fgValues;
   }
 
+  if (!IsVarGroupNeeded(kVarGroupSecondaryVertexing)) {
+    return;
+  }
+
   float mtrack;
   float mlepton1, mlepton2;
 
@@ -6019,6 +6179,10 @@ void VarManager::FillDileptonTrackTrackVertexing(C const& collision, T1 const& l
     values = fgValues;
   }
 
+  if (!IsVarGroupNeeded(kVarGroupSecondaryVertexing)) {
+    return;
+  }
+
   float mtrack1, mtrack2;
   float mlepton1, mlepton2;
 
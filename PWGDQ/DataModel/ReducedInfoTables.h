@@ -26,7 +26,9 @@
 #include "Framework/AnalysisDataModel.h"
 #include "MathUtils/Utils.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <vector>
 
 namespace o2::aod
@@ -435,6 +437,152 @@ DECLARE_SOA_TABLE(ReducedTracksBarrelPID, "AOD", "RTBARRELPID", //!
                   pidtof::TOFNSigmaPi, pidtof::TOFNSigmaKa, pidtof::TOFNSigmaPr,
                   track::TRDSignal);
 
+namespace reducedtrackcompact
+{
+// Covariance matrices with the diagonal elements stored as float and the off-diagonal ones as correlation coefficients
+//   in int16 with a fixed scale, decoded with the diagonal elements
+struct covpacking {
+  static constexpr float scale = 32767.f;
+
+  static int16_t pack(float cij, float cii, float cjj)
+  {
+    float norm = std::sqrt(cii * cjj);
+    if (!(norm > 0.f) || std::isnan(cij)) {
+      return 0;
+    }
+    return static_cast<int16_t>(std::round(std::clamp(cij / norm, -1.f, 1.f) * scale));
+  }
+
+  static float unPack(int16_t rho, float cii, float cjj)
+  {
+    return rho / scale * std::sqrt(cii * cjj);
+  }
+};
+
+// PID n-sigmas stored as int8 in steps of 0.1 in [-12.7, 12.7], the values outside being stored in the edge bins.
+//   The default value for the missing PID information (-999) has a dedicated bin
+struct nsigmapacking {
+  typedef int8_t binned_t;
+  static constexpr float binWidth = 0.1f;
+  static constexpr binned_t maxBin = 127;
+  static constexpr binned_t missingBin = -128;
+  static constexpr float missingValue = -999.f;
+
+  static binned_t pack(float nSigma)
+  {
+    if (nSigma <= missingValue) {
+      return missingBin;
+    }
+    return static_cast<binned_t>(std::clamp(std::round(nSigma / binWidth), -static_cast<float>(maxBin), static_cast<float>(maxBin)));
+  }
+
+  static float unPack(binned_t binned)
+  {
+    return (binned == missingBin ? missingValue : binWidth * binned);
+  }
+};
+
+DECLARE_SOA_COLUMN(RhoZY, rhoZY, int16_t);                      //! Correlation coefficient between Z and Y, packed
+DECLARE_SOA_COLUMN(RhoSnpY, rhoSnpY, int16_t);                  //! Correlation coefficient between Snp and Y, packed
+DECLARE_SOA_COLUMN(RhoSnpZ, rhoSnpZ, int16_t);                  //! Correlation coefficient between Snp and Z, packed
+DECLARE_SOA_COLUMN(RhoTglY, rhoTglY, int16_t);                  //! Correlation coefficient between Tgl and Y, packed
+DECLARE_SOA_COLUMN(RhoTglZ, rhoTglZ, int16_t);                  //! Correlation coefficient between Tgl and Z, packed
+DECLARE_SOA_COLUMN(RhoTglSnp, rhoTglSnp, int16_t);              //! Correlation coefficient between Tgl and Snp, packed
+DECLARE_SOA_COLUMN(Rho1PtY, rho1PtY, int16_t);                  //! Correlation coefficient between 1/pt and Y, packed
+DECLARE_SOA_COLUMN(Rho1PtZ, rho1PtZ, int16_t);                  //! Correlation coefficient between 1/pt and Z, packed
+DECLARE_SOA_COLUMN(Rho1PtSnp, rho1PtSnp, int16_t);              //! Correlation coefficient between 1/pt and Snp, packed
+DECLARE_SOA_COLUMN(Rho1PtTgl, rho1PtTgl, int16_t);              //! Correlation coefficient between 1/pt and Tgl, packed
+DECLARE_SOA_COLUMN(TPCNSigmaStoreEl, tpcNSigmaStoreEl, int8_t); //! TPC n-sigma for electrons, packed
+DECLARE_SOA_COLUMN(TPCNSigmaStoreMu, tpcNSigmaStoreMu, int8_t); //! TPC n-sigma for muons, packed
+DECLARE_SOA_COLUMN(TPCNSigmaStorePi, tpcNSigmaStorePi, int8_t); //! TPC n-sigma for pions, packed
+DECLARE_SOA_COLUMN(TPCNSigmaStoreKa, tpcNSigmaStoreKa, int8_t); //! TPC n-sigma for kaons, packed
+DECLARE_SOA_COLUMN(TPCNSigmaStorePr, tpcNSigmaStorePr, int8_t); //! TPC n-sigma for protons, packed
+DECLARE_SOA_COLUMN(TOFNSigmaStoreEl, tofNSigmaStoreEl, int8_t); //! TOF n-sigma for electrons, packed
+DECLARE_SOA_COLUMN(TOFNSigmaStoreMu, tofNSigmaStoreMu, int8_t); //! TOF n-sigma for muons, packed
+DECLARE_SOA_COLUMN(TOFNSigmaStorePi, tofNSigmaStorePi, int8_t); //! TOF n-sigma for pions, packed
+DECLARE_SOA_COLUMN(TOFNSigmaStoreKa, tofNSigmaStoreKa, int8_t); //! TOF n-sigma for kaons, packed
+DECLARE_SOA_COLUMN(TOFNSigmaStorePr, tofNSigmaStorePr, int8_t); //! TOF n-sigma for protons, packed
+
+// decoded values, with the accessors of the full precision tables
+DECLARE_SOA_DYNAMIC_COLUMN(CZY, cZY, //! Unpacked covariance element
+                           [](int16_t rho, float cii, float cjj) -> float { return reducedtrackcompact::covpacking::unPack(rho, cii, cjj); });
+DECLARE_SOA_DYNAMIC_COLUMN(CSnpY, cSnpY, //! Unpacked covariance element
+                           [](int16_t rho, float cii, float cjj) -> float { return reducedtrackcompact::covpacking::unPack(rho, cii, cjj); });
+DECLARE_SOA_DYNAMIC_COLUMN(CSnpZ, cSnpZ, //! Unpacked covariance element
+                           [](int16_t rho, float cii, float cjj) -> float { return reducedtrackcompact::covpacking::unPack(rho, cii, cjj); });
+DECLARE_SOA_DYNAMIC_COLUMN(CTglY, cTglY, //! Unpacked covariance element
+                           [](int16_t rho, float cii, float cjj) -> float { return reducedtrackcompact::covpacking::unPack(rho, cii, cjj); });
+DECLARE_SOA_DYNAMIC_COLUMN(CTglZ, cTglZ, //! Unpacked covariance element
+                           [](int16_t rho, float cii, float cjj) -> float { return reducedtrackcompact::covpacking::unPack(rho, cii, cjj); });
+DECLARE_SOA_DYNAMIC_COLUMN(CTglSnp, cTglSnp, //! Unpacked covariance element
+                           [](int16_t rho, float cii, float cjj) -> float { return reducedtrackcompact::covpacking::unPack(rho, cii, cjj); });
+DECLARE_SOA_DYNAMIC_COLUMN(C1PtY, c1PtY, //! Unpacked covariance element
+                           [](int16_t rho, float cii, float cjj) -> float { return reducedtrackcompact::covpacking::unPack(rho, cii, cjj); });
+DECLARE_SOA_DYNAMIC_COLUMN(C1PtZ, c1PtZ, //! Unpacked covariance element
+                           [](int16_t rho, float cii, float cjj) -> float { return reducedtrackcompact::covpacking::unPack(rho, cii, cjj); });
+DECLARE_SOA_DYNAMIC_COLUMN(C1PtSnp, c1PtSnp, //! Unpacked covariance element
+                           [](int16_t rho, float cii, float cjj) -> float { return reducedtrackcompact::covpacking::unPack(rho, cii, cjj); });
+DECLARE_SOA_DYNAMIC_COLUMN(C1PtTgl, c1PtTgl, //! Unpacked covariance element
+                           [](int16_t rho, float cii, float cjj) -> float { return reducedtrackcompact::covpacking::unPack(rho, cii, cjj); });
+DECLARE_SOA_DYNAMIC_COLUMN(TPCNSigmaEl, tpcNSigmaEl, //! Unpacked TPC n-sigma for electrons
+                           [](int8_t binned) -> float { return nsigmapacking::unPack(binned); });
+DECLARE_SOA_DYNAMIC_COLUMN(TPCNSigmaMu, tpcNSigmaMu, //! Unpacked TPC n-sigma for muons
+                           [](int8_t binned) -> float { return nsigmapacking::unPack(binned); });
+DECLARE_SOA_DYNAMIC_COLUMN(TPCNSigmaPi, tpcNSigmaPi, //! Unpacked TPC n-sigma for pions
+                           [](int8_t binned) -> float { return nsigmapacking::unPack(binned); });
+DECLARE_SOA_DYNAMIC_COLUMN(TPCNSigmaKa, tpcNSigmaKa, //! Unpacked TPC n-sigma for kaons
+                           [](int8_t binned) -> float { return nsigmapacking::unPack(binned); });
+DECLARE_SOA_DYNAMIC_COLUMN(TPCNSigmaPr, tpcNSigmaPr, //! Unpacked TPC n-sigma for protons
+                           [](int8_t binned) -> float { return nsigmapacking::unPack(binned); });
+DECLARE_SOA_DYNAMIC_COLUMN(TOFNSigmaEl, tofNSigmaEl, //! Unpacked TOF n-sigma for electrons
+                           [](int8_t binned) -> float { return nsigmapacking::unPack(binned); });
+DECLARE_SOA_DYNAMIC_COLUMN(TOFNSigmaMu, tofNSigmaMu, //! Unpacked TOF n-sigma for muons
+                           [](int8_t binned) -> float { return nsigmapacking::unPack(binned); });
+DECLARE_SOA_DYNAMIC_COLUMN(TOFNSigmaPi, tofNSigmaPi, //! Unpacked TOF n-sigma for pions
+                           [](int8_t binned) -> float { return nsigmapacking::unPack(binned); });
+DECLARE_SOA_DYNAMIC_COLUMN(TOFNSigmaKa, tofNSigmaKa, //! Unpacked TOF n-sigma for kaons
+                           [](int8_t binned) -> float { return nsigmapacking::unPack(binned); });
+DECLARE_SOA_DYNAMIC_COLUMN(TOFNSigmaPr, tofNSigmaPr, //! Unpacked TOF n-sigma for protons
+                           [](int8_t binned) -> float { return nsigmapacking::unPack(binned); });
+} // namespace reducedtrackcompact
+
+// compact versions of ReducedTracksBarrelCov and ReducedTracksBarrelPID, with the same accessors
+//   They are written by the table-maker instead of the full precision tables if requested (compact skim)
+DECLARE_SOA_TABLE(ReducedTracksBarrelCovCompact, "AOD", "RTBARRELCOVC", //!
+                  track::CYY, track::CZZ, track::CSnpSnp, track::CTglTgl, track::C1Pt21Pt2,
+                  reducedtrackcompact::RhoZY, reducedtrackcompact::RhoSnpY, reducedtrackcompact::RhoSnpZ,
+                  reducedtrackcompact::RhoTglY, reducedtrackcompact::RhoTglZ, reducedtrackcompact::RhoTglSnp,
+                  reducedtrackcompact::Rho1PtY, reducedtrackcompact::Rho1PtZ, reducedtrackcompact::Rho1PtSnp, reducedtrackcompact::Rho1PtTgl,
+                  reducedtrackcompact::CZY<reducedtrackcompact::RhoZY, track::CZZ, track::CYY>,
+                  reducedtrackcompact::CSnpY<reducedtrackcompact::RhoSnpY, track::CSnpSnp, track::CYY>,
+                  reducedtrackcompact::CSnpZ<reducedtrackcompact::RhoSnpZ, track::CSnpSnp, track::CZZ>,
+                  reducedtrackcompact::CTglY<reducedtrackcompact::RhoTglY, track::CTglTgl, track::CYY>,
+                  reducedtrackcompact::CTglZ<reducedtrackcompact::RhoTglZ, track::CTglTgl, track::CZZ>,
+                  reducedtrackcompact::CTglSnp<reducedtrackcompact::RhoTglSnp, track::CTglTgl, track::CSnpSnp>,
+                  reducedtrackcompact::C1PtY<reducedtrackcompact::Rho1PtY, track::C1Pt21Pt2, track::CYY>,
+                  reducedtrackcompact::C1PtZ<reducedtrackcompact::Rho1PtZ, track::C1Pt21Pt2, track::CZZ>,
+                  reducedtrackcompact::C1PtSnp<reducedtrackcompact::Rho1PtSnp, track::C1Pt21Pt2, track::CSnpSnp>,
+                  reducedtrackcompact::C1PtTgl<reducedtrackcompact::Rho1PtTgl, track::C1Pt21Pt2, track::CTglTgl>);
+
+DECLARE_SOA_TABLE(ReducedTracksBarrelPIDCompact, "AOD", "RTBARRELPIDC", //!
+                  track::TPCSignal,
+                  reducedtrackcompact::TPCNSigmaStoreEl, reducedtrackcompact::TPCNSigmaStoreMu,
+                  reducedtrackcompact::TPCNSigmaStorePi, reducedtrackcompact::TPCNSigmaStoreKa, reducedtrackcompact::TPCNSigmaStorePr,
+                  pidtofbeta::Beta,
+                  reducedtrackcompact::TOFNSigmaStoreEl, reducedtrackcompact::TOFNSigmaStoreMu,
+                  reducedtrackcompact::TOFNSigmaStorePi, reducedtrackcompact::TOFNSigmaStoreKa, reducedtrackcompact::TOFNSigmaStorePr,
+                  track::TRDSignal,
+                  reducedtrackcompact::TPCNSigmaEl<reducedtrackcompact::TPCNSigmaStoreEl>,
+                  reducedtrackcompact::TPCNSigmaMu<reducedtrackcompact::TPCNSigmaStoreMu>,
+                  reducedtrackcompact::TPCNSigmaPi<reducedtrackcompact::TPCNSigmaStorePi>,
+                  reducedtrackcompact::TPCNSigmaKa<reducedtrackcompact::TPCNSigmaStoreKa>,
+                  reducedtrackcompact::TPCNSigmaPr<reducedtrackcompact::TPCNSigmaStorePr>,
+                  reducedtrackcompact::TOFNSigmaEl<reducedtrackcompact::TOFNSigmaStoreEl>,
+                  reducedtrackcompact::TOFNSigmaMu<reducedtrackcompact::TOFNSigmaStoreMu>,
+                  reducedtrackcompact::TOFNSigmaPi<reducedtrackcompact::TOFNSigmaStorePi>,
+                  reducedtrackcompact::TOFNSigmaKa<reducedtrackcompact::TOFNSigmaStoreKa>,
+                  reducedtrackcompact::TOFNSigmaPr<reducedtrackcompact::TOFNSigmaStorePr>);
+
 // barrel collision information (joined with ReducedTracks) allowing to connect different tables (cross PWGs)
 DECLARE_SOA_TABLE(ReducedTracksBarrelInfo, "AOD", "RTBARRELINFO",
                   reducedtrack::CollisionId, collision::PosX, collision::PosY, collision::PosZ, reducedtrack::TrackId);
@@ -443,6 +591,8 @@ using ReducedTrack = ReducedTracks::iterator;
 using ReducedTrackBarrel = ReducedTracksBarrel::iterator;
 using ReducedTrackBarrelCov = ReducedTracksBarrelCov::iterator;
 using ReducedTrackBarrelPID = ReducedTracksBarrelPID::iterator;
+using ReducedTrackBarrelCovCompact = ReducedTracksBarrelCovCompact::iterator;
+using ReducedTrackBarrelPIDCompact = ReducedTracksBarrelPIDCompact::iterator;
 using ReducedTrackBarrelInfo = ReducedTracksBarrelInfo::iterator;
 
 namespace reducedtrackMC
@@ -613,6 +763,58 @@ DECLARE_SOA_TABLE(ReducedMuonsCov, "AOD", "RTMUONCOV",
                   fwdtrack::CTglX, fwdtrack::CTglY, fwdtrack::CTglPhi, fwdtrack::CTglTgl, fwdtrack::C1PtX,
                   fwdtrack::C1PtY, fwdtrack::C1PtPhi, fwdtrack::C1PtTgl, fwdtrack::C1Pt21Pt2);
 
+namespace reducedmuoncompact
+{
+DECLARE_SOA_COLUMN(RhoXY, rhoXY, int16_t);         //! Correlation coefficient between X and Y, packed
+DECLARE_SOA_COLUMN(RhoPhiX, rhoPhiX, int16_t);     //! Correlation coefficient between Phi and X, packed
+DECLARE_SOA_COLUMN(RhoPhiY, rhoPhiY, int16_t);     //! Correlation coefficient between Phi and Y, packed
+DECLARE_SOA_COLUMN(RhoTglX, rhoTglX, int16_t);     //! Correlation coefficient between Tgl and X, packed
+DECLARE_SOA_COLUMN(RhoTglY, rhoTglY, int16_t);     //! Correlation coefficient between Tgl and Y, packed
+DECLARE_SOA_COLUMN(RhoTglPhi, rhoTglPhi, int16_t); //! Correlation coefficient between Tgl and Phi, packed
+DECLARE_SOA_COLUMN(Rho1PtX, rho1PtX, int16_t);     //! Correlation coefficient between 1/pt and X, packed
+DECLARE_SOA_COLUMN(Rho1PtY, rho1PtY, int16_t);     //! Correlation coefficient between 1/pt and Y, packed
+DECLARE_SOA_COLUMN(Rho1PtPhi, rho1PtPhi, int16_t); //! Correlation coefficient between 1/pt and Phi, packed
+DECLARE_SOA_COLUMN(Rho1PtTgl, rho1PtTgl, int16_t); //! Correlation coefficient between 1/pt and Tgl, packed
+DECLARE_SOA_DYNAMIC_COLUMN(CXY, cXY, //! Unpacked covariance element
+                           [](int16_t rho, float cii, float cjj) -> float { return reducedtrackcompact::covpacking::unPack(rho, cii, cjj); });
+DECLARE_SOA_DYNAMIC_COLUMN(CPhiX, cPhiX, //! Unpacked covariance element
+                           [](int16_t rho, float cii, float cjj) -> float { return reducedtrackcompact::covpacking::unPack(rho, cii, cjj); });
+DECLARE_SOA_DYNAMIC_COLUMN(CPhiY, cPhiY, //! Unpacked covariance element
+                           [](int16_t rho, float cii, float cjj) -> float { return reducedtrackcompact::covpacking::unPack(rho, cii, cjj); });
+DECLARE_SOA_DYNAMIC_COLUMN(CTglX, cTglX, //! Unpacked covariance element
+                           [](int16_t rho, float cii, float cjj) -> float { return reducedtrackcompact::covpacking::unPack(rho, cii, cjj); });
+DECLARE_SOA_DYNAMIC_COLUMN(CTglY, cTglY, //! Unpacked covariance element
+                           [](int16_t rho, float cii, float cjj) -> float { return reducedtrackcompact::covpacking::unPack(rho, cii, cjj); });
+DECLARE_SOA_DYNAMIC_COLUMN(CTglPhi, cTglPhi, //! Unpacked covariance element
+                           [](int16_t rho, float cii, float cjj) -> float { return reducedtrackcompact::covpacking::unPack(rho, cii, cjj); });
+DECLARE_SOA_DYNAMIC_COLUMN(C1PtX, c1PtX, //! Unpacked covariance element
+                           [](int16_t rho, float cii, float cjj) -> float { return reducedtrackcompact::covpacking::unPack(rho, cii, cjj); });
+DECLARE_SOA_DYNAMIC_COLUMN(C1PtY, c1PtY, //! Unpacked covariance element
+                           [](int16_t rho, float cii, float cjj) -> float { return reducedtrackcompact::covpacking::unPack(rho, cii, cjj); });
+DECLARE_SOA_DYNAMIC_COLUMN(C1PtPhi, c1PtPhi, //! Unpacked covariance element
+                           [](int16_t rho, float cii, float cjj) -> float { return reducedtrackcompact::covpacking::unPack(rho, cii, cjj); });
+DECLARE_SOA_DYNAMIC_COLUMN(C1PtTgl, c1PtTgl, //! Unpacked covariance element
+                           [](int16_t rho, float cii, float cjj) -> float { return reducedtrackcompact::covpacking::unPack(rho, cii, cjj); });
+} // namespace reducedmuoncompact
+
+// compact version of ReducedMuonsCov, with the same accessors
+DECLARE_SOA_TABLE(ReducedMuonsCovCompact, "AOD", "RTMUONCOVC", //!
+                  fwdtrack::X, fwdtrack::Y, fwdtrack::Z, reducedmuon::RawPhi, fwdtrack::Tgl, fwdtrack::Signed1Pt,
+                  fwdtrack::CXX, fwdtrack::CYY, fwdtrack::CPhiPhi, fwdtrack::CTglTgl, fwdtrack::C1Pt21Pt2,
+                  reducedmuoncompact::RhoXY, reducedmuoncompact::RhoPhiX, reducedmuoncompact::RhoPhiY,
+                  reducedmuoncompact::RhoTglX, reducedmuoncompact::RhoTglY, reducedmuoncompact::RhoTglPhi,
+                  reducedmuoncompact::Rho1PtX, reducedmuoncompact::Rho1PtY, reducedmuoncompact::Rho1PtPhi, reducedmuoncompact::Rho1PtTgl,
+                  reducedmuoncompact::CXY<reducedmuoncompact::RhoXY, fwdtrack::CXX, fwdtrack::CYY>,
+                  reducedmuoncompact::CPhiX<reducedmuoncompact::RhoPhiX, fwdtrack::CPhiPhi, fwdtrack::CXX>,
+                  reducedmuoncompact::CPhiY<reducedmuoncompact::RhoPhiY, fwdtrack::CPhiPhi, fwdtrack::CYY>,
+                  reducedmuoncompact::CTglX<reducedmuoncompact::RhoTglX, fwdtrack::CTglTgl, fwdtrack::CXX>,
+                  reducedmuoncompact::CTglY<reducedmuoncompact::RhoTglY, fwdtrack::CTglTgl, fwdtrack::CYY>,
+                  reducedmuoncompact::CTglPhi<reducedmuoncompact::RhoTglPhi, fwdtrack::CTglTgl, fwdtrack::CPhiPhi>,
+                  reducedmuoncompact::C1PtX<reducedmuoncompact::Rho1PtX, fwdtrack::C1Pt21Pt2, fwdtrack::CXX>,
+                  reducedmuoncompact::C1PtY<reducedmuoncompact::Rho1PtY, fwdtrack::C1Pt21Pt2, fwdtrack::CYY>,
+                  reducedmuoncompact::C1PtPhi<reducedmuoncompact::Rho1PtPhi, fwdtrack::C1Pt21Pt2, fwdtrack::CPhiPhi>,
+                  reducedmuoncompact::C1PtTgl<reducedmuoncompact::Rho1PtTgl, fwdtrack::C1Pt21Pt2, fwdtrack::CTglTgl>);
+
 // Muon collision information (joined with ReducedMuons) allowing to connect different tables (cross PWGs)
 DECLARE_SOA_TABLE(ReducedMuonsInfo, "AOD", "RTMUONINFO",
                   reducedmuon::CollisionId, collision::PosX, collision::PosY, collision::PosZ);
@@ -621,6 +823,7 @@ DECLARE_SOA_TABLE(ReducedMuonsInfo, "AOD", "RTMUONINFO",
 using ReducedMuon = ReducedMuons::iterator;
 using ReducedMuonExtra = ReducedMuonsExtra::iterator;
 using ReducedMuonCov = ReducedMuonsCov::iterator;
+using ReducedMuonCovCompact = ReducedMuonsCovCompact::iterator;
 using ReducedMuonInfo = ReducedMuonsInfo::iterator;
 
 namespace reducedmuonlabel
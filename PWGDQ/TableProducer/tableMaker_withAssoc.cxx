@@ -181,10 +181,13 @@ struct TableMaker {
   Produces<ReducedTracksBarrel> trackBarrel;
   Produces<ReducedTracksBarrelCov> trackBarrelCov;
   Produces<ReducedTracksBarrelPID> trackBarrelPID;
+  Produces<ReducedTracksBarrelCovCompact> trackBarrelCovCompact;
+  Produces<ReducedTracksBarrelPIDCompact> trackBarrelPIDCompact;
   Produces<ReducedTracksAssoc> trackBarrelAssoc;
   Produces<ReducedMuons> muonBasic;
   Produces<ReducedMuonsExtra> muonExtra;
   Produces<ReducedMuonsCov> muonCov;
+  Produces<ReducedMuonsCovCompact> muonCovCompact;
   Produces<ReducedMuonsInfo> muonInfo;
   Produces<ReducedMuonsAssoc> muonAssoc;
   Produces<ReducedMFTs> mftTrack;
@@ -232,6 +235,12 @@ struct TableMaker {
     Configurable<std::string> fConfigIrEstimator{"cfgIrEstimator", "", "Estimator of the interaction rate (pp,OO --> T0VTX, Pb-Pb --> ZNC hadronic), to be used with cfgFillBcStat"};
   } fConfigHistOutput;
 
+  // Compact skim: the covariance and PID tables are replaced by their packed versions, with the same accessors
+  struct : ConfigurableGroup {
+    Configurable<bool> fConfigCompactCov{"cfgCompactCov", false, "If true, write ReducedTracksBarrelCovCompact and ReducedMuonsCovCompact (correlations packed in int16) instead of the full covariance tables"};
+    Configurable<bool> fConfigCompactPID{"cfgCompactPID", false, "If true, write ReducedTracksBarrelPIDCompact (n-sigmas packed in int8 in steps of 0.1) instead of ReducedTracksBarrelPID"};
+  } fConfigCompactSkim;
+
   Configurable<bool> fIsRun2{"cfgIsRun2", false, "Whether we analyze Run-2 or Run-3 data"};
 
   // Selections to be applied as Filter on the Track and FwdTrack
@@ -1363,28 +1372,60 @@ struct TableMaker {
                   track.trackTime(), track.trackTimeRes(), track.tofExpMom(),
                   track.detectorMap());
       if constexpr (static_cast<bool>(TTrackFillMap & VarManager::ObjTypes::TrackCov)) {
-        trackBarrelCov(track.cYY(), track.cZY(), track.cZZ(), track.cSnpY(), track.cSnpZ(),
-                       track.cSnpSnp(), track.cTglY(), track.cTglZ(), track.cTglSnp(), track.cTglTgl(),
-                       track.c1PtY(), track.c1PtZ(), track.c1PtSnp(), track.c1PtTgl(), track.c1Pt21Pt2());
+        if (fConfigCompactSkim.fConfigCompactCov) {
+          using covpacking = o2::aod::reducedtrackcompact::covpacking;
+          trackBarrelCovCompact(track.cYY(), track.cZZ(), track.cSnpSnp(), track.cTglTgl(), track.c1Pt21Pt2(),
+                                covpacking::pack(track.cZY(), track.cZZ(), track.cYY()),
+                                covpacking::pack(track.cSnpY(), track.cSnpSnp(), track.cYY()),
+                                covpacking::pack(track.cSnpZ(), track.cSnpSnp(), track.cZZ()),
+                                covpacking::pack(track.cTglY(), track.cTglTgl(), track.cYY()),
+                                covpacking::pack(track.cTglZ(), track.cTglTgl(), track.cZZ()),
+                                covpacking::pack(track.cTglSnp(), track.cTglTgl(), track.cSnpSnp()),
+                                covpacking::pack(track.c1PtY(), track.c1Pt21Pt2(), track.cYY()),
+                                covpacking::pack(track.c1PtZ(), track.c1Pt21Pt2(), track.cZZ()),
+                                covpacking::pack(track.c1PtSnp(), track.c1Pt21Pt2(), track.cSnpSnp()),
+                                covpacking::pack(track.c1PtTgl(), track.c1Pt21Pt2(), track.cTglTgl()));
+        } else {
+          trackBarrelCov(track.cYY(), track.cZY(), track.cZZ(), track.cSnpY(), track.cSnpZ(),
+                         track.cSnpSnp(), track.cTglY(), track.cTglZ(), track.cTglSnp(), track.cTglTgl(),
+                         track.c1PtY(), track.c1PtZ(), track.c1PtSnp(), track.c1PtTgl(), track.c1Pt21Pt2());
+        }
       }
       if constexpr (static_cast<bool>(TTrackFillMap & VarManager::ObjTypes::TrackPID)) {
         float nSigmaEl = (fConfigPostCalibTPC.fConfigComputeTPCpostCalib ? VarManager::fgValues[VarManager::kTPCnSigmaEl_Corr] : track.tpcNSigmaEl());
         float nSigmaPi = (fConfigPostCalibTPC.fConfigComputeTPCpostCalib ? VarManager::fgValues[VarManager::kTPCnSigmaPi_Corr] : track.tpcNSigmaPi());
         float nSigmaKa = ((fConfigPostCalibTPC.fConfigComputeTPCpostCalib && fConfigPostCalibTPC.fConfigComputeTPCpostCalibKaon) ? VarManager::fgValues[VarManager::kTPCnSigmaKa_Corr] : track.tpcNSigmaKa());
         float nSigmaPr = (fConfigPostCalibTPC.fConfigComputeTPCpostCalib ? VarManager::fgValues[VarManager::kTPCnSigmaPr_Corr] : track.tpcNSigmaPr());
-        trackBarrelPID(track.tpcSignal(),
-                       nSigmaEl, track.tpcNSigmaMu(), nSigmaPi, nSigmaKa, nSigmaPr,
-                       track.beta(), track.tofNSigmaEl(), track.tofNSigmaMu(), track.tofNSigmaPi(), track.tofNSigmaKa(), track.tofNSigmaPr(),
-                       track.trdSignal());
+        if (fConfigCompactSkim.fConfigCompactPID) {
+          using nsigmapacking = o2::aod::reducedtrackcompact::nsigmapacking;
+          trackBarrelPIDCompact(track.tpcSignal(),
+                                nsigmapacking::pack(nSigmaEl), nsigmapacking::pack(track.tpcNSigmaMu()), nsigmapacking::pack(nSigmaPi), nsigmapacking::pack(nSigmaKa), nsigmapacking::pack(nSigmaPr),
+                                track.beta(), nsigmapacking::pack(track.tofNSigmaEl()), nsigmapacking::pack(track.tofNSigmaMu()), nsigmapacking::pack(track.tofNSigmaPi()),
+                                nsigmapacking::pack(track.tofNSigmaKa()), nsigmapacking::pack(track.tofNSigmaPr()),
+                                track.trdSignal());
+        } else {
+          trackBarrelPID(track.tpcSignal(),
+                         nSigmaEl, track.tpcNSigmaMu(), nSigmaPi, nSigmaKa, nSigmaPr,
+                         track.beta(), track.tofNSigmaEl(), track.tofNSigmaMu(), track.tofNSigmaPi(), track.tofNSigmaKa(), track.tofNSigmaPr(),
+                         track.trdSignal());
+        }
       } else if constexpr (static_cast<bool>(TTrackFillMap & VarManager::ObjTypes::TrackTPCPID)) {
         float nSigmaEl = (fConfigPostCalibTPC.fConfigComputeTPCpostCalib ? VarManager::fgValues[VarManager::kTPCnSigmaEl_Corr] : track.tpcNSigmaEl());
         float nSigmaPi = (fConfigPostCalibTPC.fConfigComputeTPCpostCalib ? VarManager::fgValues[VarManager::kTPCnSigmaPi_Corr] : track.tpcNSigmaPi());
         float nSigmaKa = ((fConfigPostCalibTPC.fConfigComputeTPCpostCalib && fConfigPostCalibTPC.fConfigComputeTPCpostCalibKaon) ? VarManager::fgValues[VarManager::kTPCnSigmaKa_Corr] : track.tpcNSigmaKa());
         float nSigmaPr = (fConfigPostCalibTPC.fConfigComputeTPCpostCalib ? VarManager::fgValues[VarManager::kTPCnSigmaPr_Corr] : track.tpcNSigmaPr());
-        trackBarrelPID(track.tpcSignal(),
-                       nSigmaEl, -999.0, nSigmaPi, nSigmaKa, nSigmaPr,
-                       -999.0, -999.0, -999.0, -999.0, -999.0, -999.0,
-                       -999.0);
+        if (fConfigCompactSkim.fConfigCompactPID) {
+          using nsigmapacking = o2::aod::reducedtrackcompact::nsigmapacking;
+          trackBarrelPIDCompact(track.tpcSignal(),
+                                nsigmapacking::pack(nSigmaEl), nsigmapacking::missingBin, nsigmapacking::pack(nSigmaPi), nsigmapacking::pack(nSigmaKa), nsigmapacking::pack(nSigmaPr),
+                                -999.0, nsigmapacking::missingBin, nsigmapacking::missingBin, nsigmapacking::missingBin, nsigmapacking::missingBin, nsigmapacking::missingBin,
+                                -999.0);
+        } else {
+          trackBarrelPID(track.tpcSignal(),
+                         nSigmaEl, -999.0, nSigmaPi, nSigmaKa, nSigmaPr,
+                         -999.0, -999.0, -999.0, -999.0, -999.0, -999.0,
+                         -999.0);
+        }
       }
 
       fTrackIndexMap[track.globalIndex()] = trackBasic.lastIndex();
@@ -1639,10 +1680,27 @@ struct TableMaker {
                 muon.trackTime(), muon.trackTimeRes());
       muonInfo(muon.collisionId(), collision.posX(), collision.posY(), collision.posZ());
       if constexpr (static_cast<bool>(TMuonFillMap & VarManager::ObjTypes::MuonCov) || static_cast<bool>(TMuonFillMap & VarManager::ObjTypes::MuonCovRealign)) {
-        muonCov(VarManager::fgValues[VarManager::kX], VarManager::fgValues[VarManager::kY], VarManager::fgValues[VarManager::kZ], VarManager::fgValues[VarManager::kPhi], VarManager::fgValues[VarManager::kTgl], muon.sign() / VarManager::fgValues[VarManager::kPt],
-                VarManager::fgValues[VarManager::kMuonCXX], VarManager::fgValues[VarManager::kMuonCXY], VarManager::fgValues[VarManager::kMuonCYY], VarManager::fgValues[VarManager::kMuonCPhiX], VarManager::fgValues[VarManager::kMuonCPhiY], VarManager::fgValues[VarManager::kMuonCPhiPhi],
-                VarManager::fgValues[VarManager::kMuonCTglX], VarManager::fgValues[VarManager::kMuonCTglY], VarManager::fgValues[VarManager::kMuonCTglPhi], VarManager::fgValues[VarManager::kMuonCTglTgl], VarManager::fgValues[VarManager::kMuonC1Pt2X], VarManager::fgValues[VarManager::kMuonC1Pt2Y],
-                VarManager::fgValues[VarManager::kMuonC1Pt2Phi], VarManager::fgValues[VarManager::kMuonC1Pt2Tgl], VarManager::fgValues[VarManager::kMuonC1Pt21Pt2]);
+        if (fConfigCompactSkim.fConfigCompactCov) {
+          using covpacking = o2::aod::reducedtrackcompact::covpacking;
+          const float* values = VarManager::fgValues;
+          muonCovCompact(values[VarManager::kX], values[VarManager::kY], values[VarManager::kZ], values[VarManager::kPhi], values[VarManager::kTgl], muon.sign() / values[VarManager::kPt],
+                         values[VarManager::kMuonCXX], values[VarManager::kMuonCYY], values[VarManager::kMuonCPhiPhi], values[VarManager::kMuonCTglTgl], values[VarManager::kMuonC1Pt21Pt2],
+                         covpacking::pack(values[VarManager::kMuonCXY], values[VarManager::kMuonCXX], values[VarManager::kMuonCYY]),
+                         covpacking::pack(values[VarManager::kMuonCPhiX], values[VarManager::kMuonCPhiPhi], values[VarManager::kMuonCXX]),
+                         covpacking::pack(values[VarManager::kMuonCPhiY], values[VarManager::kMuonCPhiPhi], values[VarManager::kMuonCYY]),
+                         covpacking::pack(values[VarManager::kMuonCTglX], values[VarManager::kMuonCTglTgl], values[VarManager::kMuonCXX]),
+                         covpacking::pack(values[VarManager::kMuonCTglY], values[VarManager::kMuonCTglTgl], values[VarManager::kMuonCYY]),
+                         covpacking::pack(values[VarManager::kMuonCTglPhi], values[VarManager::kMuonCTglTgl], values[VarManager::kMuonCPhiPhi]),
+                         covpacking::pack(values[VarManager::kMuonC1Pt2X], values[VarManager::kMuonC1Pt21Pt2], values[VarManager::kMuonCXX]),
+                         covpacking::pack(values[VarManager::kMuonC1Pt2Y], values[VarManager::kMuonC1Pt21Pt2], values[VarManager::kMuonCYY]),
+                         covpacking::pack(values[VarManager::kMuonC1Pt2Phi], values[VarManager::kMuonC1Pt21Pt2], values[VarManager::kMuonCPhiPhi]),
+                         covpacking::pack(values[VarManager::kMuonC1Pt2Tgl], values[VarManager::kMuonC1Pt21Pt2], values[VarManager::kMuonCTglTgl]));
+        } else {
+          muonCov(VarManager::fgValues[VarManager::kX], VarManager::fgValues[VarManager::kY], VarManager::fgValues[VarManager::kZ], VarManager::fgValues[VarManager::kPhi], VarManager::fgValues[VarManager::kTgl], muon.sign() / VarManager::fgValues[VarManager::kPt],
+                  VarManager::fgValues[VarManager::kMuonCXX], VarManager::fgValues[VarManager::kMuonCXY], VarManager::fgValues[VarManager::kMuonCYY], VarManager::fgValues[VarManager::kMuonCPhiX], VarManager::fgValues[VarManager::kMuonCPhiY], VarManager::fgValues[VarManager::kMuonCPhiPhi],
+                  VarManager::fgValues[VarManager::kMuonCTglX], VarManager::fgValues[VarManager::kMuonCTglY], VarManager::fgValues[VarManager::kMuonCTglPhi], VarManager::fgValues[VarManager::kMuonCTglTgl], VarManager::fgValues[VarManager::kMuonC1Pt2X], VarManager::fgValues[VarManager::kMuonC1Pt2Y],
+                  VarManager::fgValues[VarManager::kMuonC1Pt2Phi], VarManager::fgValues[VarManager::kMuonC1Pt2Tgl], VarManager::fgValues[VarManager::kMuonC1Pt21Pt2]);
+        }
       }
     } // end loop over selected muons
   } // end skimMuons
@@ -1728,8 +1786,16 @@ struct TableMaker {
       trackBarrelInfo.reserve(tracksBarrel.size());
       trackBasic.reserve(tracksBarrel.size());
       trackBarrel.reserve(tracksBarrel.size());
-      trackBarrelCov.reserve(tracksBarrel.size());
-      trackBarrelPID.reserve(tracksBarrel.size());
+      if (fConfigCompactSkim.fConfigCompactCov) {
+        trackBarrelCovCompact.reserve(tracksBarrel.size());
+      } else {
+        trackBarrelCov.reserve(tracksBarrel.size());
+      }
+      if (fConfigCompactSkim.fConfigCompactPID) {
+        trackBarrelPIDCompact.reserve(tracksBarrel.size());
+      } else {
+        trackBarrelPID.reserve(tracksBarrel.size());
+      }
       trackBarrelAssoc.reserve(tracksBarrel.size());
     }
 
@@ -1748,7 +1814,11 @@ struct TableMaker {
       muonBasic.reserve(muons.size());
       muonExtra.reserve(muons.size());
       muonInfo.reserve(muons.size());
-      muonCov.reserve(muons.size());
+      if (fConfigCompactSkim.fConfigCompactCov) {
+        muonCovCompact.reserve(muons.size());
+      } else {
+        muonCov.reserve(muons.size());
+      }
       muonAssoc.reserve(muons.size());
     }
 
@@ -19,6 +19,7 @@
 #include "PWGDQ/Core/HistogramsLibrary.h"
 #include "PWGDQ/Core/MCSignal.h"
 #include "PWGDQ/Core/MCSignalLibrary.h"
+#include "PWGDQ/Core/MCSignalMatcher.h"
 #include "PWGDQ/Core/MixingHandler.h"
 #include "PWGDQ/Core/MixingLibrary.h"
 #include "PWGDQ/Core/VarManager.h"
@@ -1372,6 +1373,7 @@ struct AnalysisSameEventPairing {
     Configurable<std::string> recSignalsJSON{"cfgMCRecSignalsJSON", "", "Comma separated list of MC signals (reconstructed) via JSON"};
     Configurable<std::string> finalStateSignals{"cfgBarrelMCFinalStateSignals", "eFromJpsi", "Comma separated list of MC signals (final state particles)"};
     Configurable<bool> skimSignalOnly{"cfgSkimSignalOnly", false, "Configurable to select only matched candidates"};
+    Configurable<bool> precomputeSignals{"cfgPrecomputeMCSignals", false, "Precompute the MC signal prong decisions once per data frame for all the MC particles"};
   } fConfigMC;
 
   struct : ConfigurableGroup {
@@ -1398,6 +1400,8 @@ struct AnalysisSameEventPairing {
   std::vector<MCSignal*> fRecMCSignals;
   std::vector<MCSignal*> fGenMCSignals;
   std::vector<MCSignal*> fFinalStateMCSignals;
+  MCSignalMatcher fRecMCSignalMatcher; // precomputed decisions for fRecMCSignals, if fConfigMC.precomputeSignals is enabled
+  MCSignalMatcher fGenMCSignalMatcher; // precomputed decisions for fGenMCSignals, if fConfigMC.precomputeSignals is enabled
 
   std::vector<AnalysisCompositeCut> fPairCuts;
   std::vector<AnalysisCut*> fMCGenAccCuts;
@@ -1474,6 +1478,11 @@ struct AnalysisSameEventPairing {
         fRecMCSignals.push_back(mcIt);
       }
     }
+    if (fConfigMC.precomputeSignals) {
+      for (auto& sig : fRecMCSignals) {
+        fRecMCSignalMatcher.AddSignal(sig);
+      }
+    }
 
     // get the barrel track selection cuts
     string tempCuts;
@@ -1692,6 +1701,11 @@ struct AnalysisSameEventPairing {
         fGenMCSignals.push_back(mcIt);
       }
     }
+    if (fConfigMC.precomputeSignals) {
+      for (auto& sig : fGenMCSignals) {
+        fGenMCSignalMatcher.AddSignal(sig);
+      }
+    }
 
     // define final state MC signals
     TString sigFinalStateNamesStr = fConfigMC.finalStateSignals.value;
@@ -1785,9 +1799,27 @@ struct AnalysisSameEventPairing {
     }
   }
 
+  // MC signal decisions, taken from the decisions precomputed for the data frame if requested
+  template <typename... T>
+  bool checkRecMCSignal(int isig, T const&... particles)
+  {
+    if (fConfigMC.precomputeSignals) {
+      return fRecMCSignalMatcher.CheckSignal(isig, particles...);
+    }
+    return fRecMCSignals[isig]->CheckSignal(true, particles...);
+  }
+  template <typename... T>
+  bool checkGenMCSignal(int isig, T const&... particles)
+  {
+    if (fConfigMC.precomputeSignals) {
+      return fGenMCSignalMatcher.CheckSignal(isig, particles...);
+    }
+    return fGenMCSignals[isig]->CheckSignal(true, particles...);
+  }
+
   // Template function to run same event pairing (barrel-barrel, muon-muon, barrel-muon)
   template <bool TTwoProngFitter, int TPairType, uint32_t TEventFillMap, uint32_t TTrackFillMap, typename TEvents, typename TTrackAssocs, typename TTracks>
-  void runSameEventPairing(TEvents const& events, Preslice<TTrackAssocs>& preslice, TTrackAssocs const& assocs, TTracks const& /*tracks*/, ReducedMCEvents const& /*mcEvents*/, ReducedMCTracks const& /*mcTracks*/)
+  void runSameEventPairing(TEvents const& events, Preslice<TTrackAssocs>& preslice, TTrackAssocs const& assocs, TTracks const& /*tracks*/, ReducedMCEvents const& /*mcEvents*/, ReducedMCTracks const& mcTracks)
   {
     if (events.size() == 0) {
       LOG(warning) << "No events in this TF, going to the next one ...";
@@ -1797,6 +1829,9 @@ struct AnalysisSameEventPairing {
       initParamsFromCCDB(events.begin().timestamp(), TTwoProngFitter);
       fCurrentRun = events.begin().runNumber();
     }
+    if (fConfigMC.precomputeSignals) {
+      fRecMCSignalMatcher.Precompute(mcTracks);
+    }
 
     TString cutNames = fConfigCuts.track.value;
     std::map<int, std::vector<TString>> histNames = fTrackHistNames;
@@ -1882,7 +1917,7 @@ struct AnalysisSameEventPairing {
           mcDecision = 0;
           for (auto sig = fRecMCSignals.begin(); sig != fRecMCSignals.end(); sig++, isig++) {
             if (t1.has_reducedMCTrack() && t2.has_reducedMCTrack()) {
-              if ((*sig)->CheckSignal(true, t1.reducedMCTrack(), t2.reducedMCTrack())) {
+              if (checkRecMCSignal(isig, t1.reducedMCTrack(), t2.reducedMCTrack())) {
                 mcDecision |= (static_cast<uint32_t>(1) << isig);
               }
             }
@@ -1970,7 +2005,7 @@ struct AnalysisSameEventPairing {
           mcDecision = 0;
           for (auto sig = fRecMCSignals.begin(); sig != fRecMCSignals.end(); sig++, isig++) {
             if (t1.has_reducedMCTrack() && t2.has_reducedMCTrack()) {
-              if ((*sig)->CheckSignal(true, t1.reducedMCTrack(), t2.reducedMCTrack())) {
+              if (checkRecMCSignal(isig, t1.reducedMCTrack(), t2.reducedMCTrack())) {
                 mcDecision |= (static_cast<uint32_t>(1) << isig);
               }
             }
@@ -2332,14 +2367,18 @@ struct AnalysisSameEventPairing {
     // Fill Generated histograms taking into account all generated tracks
     uint32_t mcDecision = 0;
     int isig = 0;
+    if (fConfigMC.precomputeSignals) {
+      fGenMCSignalMatcher.Precompute(mcTracks);
+    }
 
     for (auto& mctrack : mcTracks) {
       VarManager::FillTrackMC(mcTracks, mctrack);
       // NOTE: Signals are checked here mostly based on the skimmed MC stack, so depending on the requested signal, the stack could be incomplete.
       // NOTE: However, the working model is that the decisions on MC signals are precomputed during skimming and are stored in the mcReducedFlags member.
       // TODO:  Use the mcReducedFlags to select signals
-      for (auto& sig : fGenMCSignals) {
-        if (sig->CheckSignal(true, mctrack)) {
+      for (unsigned int igen = 0; igen < fGenMCSignals.size(); igen++) {
+        auto sig = fGenMCSignals[igen];
+        if (checkGenMCSignal(igen, mctrack)) {
           fHistMan->FillHistClass(Form("MCTruthGen_%s", sig->GetName()), VarManager::fgValues);
         }
       }
@@ -2367,8 +2406,9 @@ struct AnalysisSameEventPairing {
         // auto track_raw = groupedMCTracks.rawIteratorAt(track.globalIndex());
         mcDecision = 0;
         isig = 0;
-        for (auto& sig : fGenMCSignals) {
-          if (sig->CheckSignal(true, track_raw)) {
+        for (unsigned int igen = 0; igen < fGenMCSignals.size(); igen++) {
+          auto sig = fGenMCSignals[igen];
+          if (checkGenMCSignal(igen, track_raw)) {
             mcDecision |= (static_cast<uint32_t>(1) << isig);
             fHistMan->FillHistClass(Form("MCTruthGenSel_%s", sig->GetName()), VarManager::fgValues);
             MCTruthTableEffi(VarManager::fgValues[VarManager::kMCPt], VarManager::fgValues[VarManager::kMCEta], VarManager::fgValues[VarManager::kMCY], VarManager::fgValues[VarManager::kMCPhi], VarManager::fgValues[VarManager::kMCVz], VarManager::fgValues[VarManager::kMCVtxZ], VarManager::fgValues[VarManager::kMultFT0A], VarManager::fgValues[VarManager::kMultFT0C], VarManager::fgValues[VarManager::kCentFT0M], VarManager::fgValues[VarManager::kVtxNcontribReal]);
@@ -2387,11 +2427,12 @@ struct AnalysisSameEventPairing {
         auto t1_raw = mcTracks.rawIteratorAt(t1.globalIndex());
         auto t2_raw = mcTracks.rawIteratorAt(t2.globalIndex());
         if (t1_raw.reducedMCeventId() == t2_raw.reducedMCeventId()) {
-          for (auto& sig : fGenMCSignals) {
+          for (unsigned int igen = 0; igen < fGenMCSignals.size(); igen++) {
+            auto sig = fGenMCSignals[igen];
             if (sig->GetNProngs() != 2) { // NOTE: 2-prong signals required here
               continue;
             }
-            if (sig->CheckSignal(true, t1_raw, t2_raw)) {
+            if (checkGenMCSignal(igen, t1_raw, t2_raw)) {
               VarManager::FillPairMC<VarManager::kDecayToMuMu>(t1, t2); // NOTE: This feature will only work for muons
               fHistMan->FillHistClass(Form("MCTruthGenPair_%s", sig->GetName()), VarManager::fgValues);
             }
@@ -2421,11 +2462,12 @@ struct AnalysisSameEventPairing {
           if (t1_raw.reducedMCeventId() == t2_raw.reducedMCeventId()) {
             mcDecision = 0;
             isig = 0;
-            for (auto& sig : fGenMCSignals) {
+            for (unsigned int igen = 0; igen < fGenMCSignals.size(); igen++) {
+              auto sig = fGenMCSignals[igen];
               if (sig->GetNProngs() != 2) { // NOTE: 2-prong signals required here
                 continue;
               }
-              if (sig->CheckSignal(true, t1_raw, t2_raw)) {
+              if (checkGenMCSignal(igen, t1_raw, t2_raw)) {
                 mcDecision |= (static_cast<uint32_t>(1) << isig);
                 VarManager::FillPairMC<VarManager::kDecayToMuMu>(t1, t2); // NOTE: This feature will only work for muons
                 fHistMan->FillHistClass(Form("MCTruthGenPairSel_%s", sig->GetName()), VarManager::fgValues);
@@ -14,12 +14,14 @@
 
 #include "PWGDQ/Core/AnalysisCompositeCut.h"
 #include "PWGDQ/Core/AnalysisCut.h"
+#include "PWGDQ/Core/AnalysisCutEvaluator.h"
 #include "PWGDQ/Core/CutsLibrary.h"
 #include "PWGDQ/Core/DQMlResponse.h"
 #include "PWGDQ/Core/HistogramManager.h"
 #include "PWGDQ/Core/HistogramsLibrary.h"
 #include "PWGDQ/Core/MixingHandler.h"
 #include "PWGDQ/Core/MixingLibrary.h"
+#include "PWGDQ/Core/MixingPool.h"
 #include "PWGDQ/Core/VarManager.h"
 #include "PWGDQ/DataModel/ReducedInfoTables.h"
 
@@ -295,6 +297,8 @@ struct AnalysisEventSelection {
 
   HistogramManager* fHistMan = nullptr;
   MixingHandler* fMixHandler = nullptr;
+  std::vector<float> fMixingValues;   // values of the mixing variables for the events of the data frame
+  std::vector<int> fMixingCategories; // mixing categories of the events of the data frame
   AnalysisCompositeCut* fEventCut;
 
   Service<o2::ccdb::BasicCCDBManager> fCCDB;
@@ -393,7 +397,11 @@ struct AnalysisEventSelection {
 
     fSelMap.clear();
     fBCCollMap.clear();
+    if (fMixHandler != nullptr) {
+      fMixingValues.resize(events.size() * fMixHandler->GetNMixingVariables());
+    }
 
+    int iEvent = 0;
     for (auto& event : events) {
       // Reset the fValues array and fill event observables
       VarManager::ResetValues(0, VarManager::kNEventWiseVariables);
@@ -434,9 +442,18 @@ struct AnalysisEventSelection {
         evIndices.push_back(event.globalIndex());
       }
 
-      // create the mixing hash and publish it into the hash table
+      // keep the mixing variables, the mixing hashes of all the events are computed after the loop
       if (fMixHandler != nullptr) {
-        int hh = fMixHandler->FindEventCategory(VarManager::fgValues);
+        fMixHandler->GetMixingValues(VarManager::fgValues, fMixingValues.data() + iEvent * fMixHandler->GetNMixingVariables());
+      }
+      iEvent++;
+    }
+
+    // create the mixing hashes and publish them into the hash table
+    if (fMixHandler != nullptr) {
+      fMixingCategories.resize(events.size());
+      fMixHandler->FindEventCategories(events.size(), fMixingValues.data(), fMixingCategories.data());
+      for (auto hh : fMixingCategories) {
         hash(hh);
       }
     }
@@ -580,6 +597,8 @@ struct AnalysisTrackSelection {
   Configurable<std::string> fConfigAddJSONHistograms{"cfgAddJSONHistograms", "", "Histograms in JSON format"};
   Configurable<bool> fConfigQA{"cfgQA", false, "If true, fill QA histograms"};
   Configurable<bool> fConfigPublishAmbiguity{"cfgPublishAmbiguity", true, "If true, publish ambiguity table and fill QA histograms"};
+  Configurable<int> fConfigCutFunctionTabulation{"cfgCutFunctionTabulation", 0, "If > 0, number of nodes used to tabulate the TF1 cut limits (0: evaluate the functions)"};
+  Configurable<bool> fConfigCacheTrackValues{"cfgCacheTrackValues", false, "If true, compute the track variables once per track instead of once per association"};
 
   Configurable<std::string> fConfigCcdbUrl{"ccdb-url", "http://alice-ccdb.cern.ch", "url of the ccdb repository"};
   Configurable<std::string> fConfigCcdbPathTPC{"ccdb-path-tpc", "Users/z/zhxiong/TPCPID/PostCalib", "base path to the ccdb object"};
@@ -597,6 +616,8 @@ struct AnalysisTrackSelection {
 
   HistogramManager* fHistMan;
   std::vector<AnalysisCompositeCut*> fTrackCuts;
+  AnalysisCutEvaluator fTrackCutsEvaluator; // all the track cuts, evaluated in one pass
+  std::vector<uint8_t> fEventFilter;        // event decisions of the current data frame, indexed by the event global index
 
   int fCurrentRun; // current run kept to detect run changes and trigger loading params from CCDB
 
@@ -626,6 +647,10 @@ struct AnalysisTrackSelection {
         fTrackCuts.push_back(reinterpret_cast<AnalysisCompositeCut*>(t));
       }
     }
+    fTrackCutsEvaluator.SetFunctionTabulation(fConfigCutFunctionTabulation.value);
+    for (auto& cut : fTrackCuts) {
+      fTrackCutsEvaluator.AddCut(cut);
+    }
 
     VarManager::SetUseVars(AnalysisCut::fgUsedVars); // provide the list of required variables so that VarManager knows what to fill
 
@@ -700,21 +725,37 @@ struct AnalysisTrackSelection {
     uint32_t filterMap = static_cast<uint32_t>(0);
     int iCut = 0;
 
+    // the track variables of the tracks associated to several collisions are computed only once
+    bool cacheTrackValues = fConfigCacheTrackValues && VarManager::CanCacheTrackValues();
+    if (cacheTrackValues) {
+      VarManager::FillTracks<TTrackFillMap>(tracks, VarManager::kNBarrelTrackVariables);
+    }
+
+    // keep the event decisions in a compact array, such that the associations of the rejected events are skipped without accessing the events
+    fEventFilter.resize(events.size());
+    for (auto& event : events) {
+      fEventFilter[event.globalIndex()] = event.isEventSelected_raw();
+    }
+
     for (auto& assoc : assocs) {
 
       // if the event from this association is not selected, reject also the association
-      auto event = assoc.template reducedevent_as<TEvents>();
-      if (!event.isEventSelected_bit(0)) {
+      if (!(fEventFilter[assoc.reducedeventId()] & static_cast<uint8_t>(1))) {
         trackSel(0);
         continue;
       }
+      auto event = assoc.template reducedevent_as<TEvents>();
       VarManager::ResetValues(0, VarManager::kNBarrelTrackVariables);
       // fill event information which might be needed in histograms/cuts that combine track and event properties
       VarManager::FillEvent<TEventFillMap>(event);
 
       auto track = assoc.template reducedtrack_as<TTracks>();
       filterMap = static_cast<uint32_t>(0);
-      VarManager::FillTrack<TTrackFillMap>(track);
+      if (cacheTrackValues) {
+        VarManager::LoadTrackValues(track.globalIndex());
+      } else {
+        VarManager::FillTrack<TTrackFillMap>(track);
+      }
       // compute quantities which depend on the associated collision, such as DCA
       if (fPropTrack) {
         VarManager::FillTrackCollision<TTrackFillMap>(track, event);
@@ -722,11 +763,11 @@ struct AnalysisTrackSelection {
       if (fConfigQA) {
         fHistMan->FillHistClass("TrackBarrel_BeforeCuts", VarManager::fgValues);
       }
-      iCut = 0;
-      for (auto cut = fTrackCuts.begin(); cut != fTrackCuts.end(); cut++, iCut++) {
-        if ((*cut)->IsSelected(VarManager::fgValues)) {
-          filterMap |= (static_cast<uint32_t>(1) << iCut);
-          if (fConfigQA) {
+      filterMap = static_cast<uint32_t>(fTrackCutsEvaluator.Evaluate(VarManager::fgValues));
+      if (fConfigQA) {
+        iCut = 0;
+        for (auto cut = fTrackCuts.begin(); cut != fTrackCuts.end(); cut++, iCut++) {
+          if (filterMap & (static_cast<uint32_t>(1) << iCut)) {
             fHistMan->FillHistClass(Form("TrackBarrel_%s", (*cut)->GetName()), VarManager::fgValues);
           }
         }
@@ -838,6 +879,8 @@ struct AnalysisMuonSelection {
   Configurable<std::string> fConfigAddMuonHistogram{"cfgAddMuonHistogram", "", "Comma separated list of histograms"};
   Configurable<std::string> fConfigAddJSONHistograms{"cfgAddJSONHistograms", "", "Histograms in JSON format"};
   Configurable<bool> fConfigPublishAmbiguity{"cfgPublishAmbiguity", true, "If true, publish ambiguity table and fill QA histograms"};
+  Configurable<int> fConfigCutFunctionTabulation{"cfgCutFunctionTabulation", 0, "If > 0, number of nodes used to tabulate the TF1 cut limits (0: evaluate the functions)"};
+  Configurable<bool> fConfigCacheTrackValues{"cfgCacheTrackValues", false, "If true, compute the muon variables once per muon instead of once per association"};
 
   Configurable<std::string> fConfigCcdbUrl{"ccdb-url", "http://alice-ccdb.cern.ch", "url of the ccdb repository"};
   Configurable<std::string> grpmagPath{"grpmagPath", "GLO/Config/GRPMagField", "CCDB path of the GRPMagField object"};
@@ -848,6 +891,8 @@ struct AnalysisMuonSelection {
 
   HistogramManager* fHistMan;
   std::vector<AnalysisCompositeCut*> fMuonCuts;
+  AnalysisCutEvaluator fMuonCutsEvaluator; // all the muon cuts, evaluated in one pass
+  std::vector<uint8_t> fEventFilter;       // event decisions of the current data frame, indexed by the event global index
 
   int fCurrentRun; // current run kept to detect run changes and trigger loading params from CCDB
 
@@ -877,6 +922,10 @@ struct AnalysisMuonSelection {
         fMuonCuts.push_back(reinterpret_cast<AnalysisCompositeCut*>(t));
       }
     }
+    fMuonCutsEvaluator.SetFunctionTabulation(fConfigCutFunctionTabulation.value);
+    for (auto& cut : fMuonCuts) {
+      fMuonCutsEvaluator.AddCut(cut);
+    }
 
     VarManager::SetUseVars(AnalysisCut::fgUsedVars); // provide the list of required variables so that VarManager knows what to fill
 
@@ -931,27 +980,43 @@ struct AnalysisMuonSelection {
     uint32_t filterMap = static_cast<uint32_t>(0);
     int iCut = 0;
 
+    // the muon variables of the muons associated to several collisions are computed only once
+    bool cacheTrackValues = fConfigCacheTrackValues && VarManager::CanCacheTrackValues();
+    if (cacheTrackValues) {
+      VarManager::FillTracks<TMuonFillMap>(muons, VarManager::kNMuonTrackVariables);
+    }
+
+    // keep the event decisions in a compact array, such that the associations of the rejected events are skipped without accessing the events
+    fEventFilter.resize(events.size());
+    for (auto& event : events) {
+      fEventFilter[event.globalIndex()] = event.isEventSelected_raw();
+    }
+
     for (auto& assoc : assocs) {
-      auto event = assoc.template reducedevent_as<TEvents>();
-      if (!event.isEventSelected_bit(0)) {
+      if (!(fEventFilter[assoc.reducedeventId()] & static_cast<uint8_t>(1))) {
         muonSel(0);
         continue;
       }
+      auto event = assoc.template reducedevent_as<TEvents>();
       VarManager::ResetValues(0, VarManager::kNMuonTrackVariables);
       // fill event information which might be needed in histograms/cuts that combine track and event properties
       VarManager::FillEvent<TEventFillMap>(event);
 
       auto track = assoc.template reducedmuon_as<TMuons>();
       filterMap = static_cast<uint32_t>(0);
-      VarManager::FillTrack<TMuonFillMap>(track);
+      if (cacheTrackValues) {
+        VarManager::LoadTrackValues(track.globalIndex());
+      } else {
+        VarManager::FillTrack<TMuonFillMap>(track);
+      }
       if (fConfigQA) {
         fHistMan->FillHistClass("TrackMuon_BeforeCuts", VarManager::fgValues);
       }
-      iCut = 0;
-      for (auto cut = fMuonCuts.begin(); cut != fMuonCuts.end(); cut++, iCut++) {
-        if ((*cut)->IsSelected(VarManager::fgValues)) {
-          filterMap |= (static_cast<uint32_t>(1) << iCut);
-          if (fConfigQA) {
+      filterMap = static_cast<uint32_t>(fMuonCutsEvaluator.Evaluate(VarManager::fgValues));
+      if (fConfigQA) {
+        iCut = 0;
+        for (auto cut = fMuonCuts.begin(); cut != fMuonCuts.end(); cut++, iCut++) {
+          if (filterMap & (static_cast<uint32_t>(1) << iCut)) {
             fHistMan->FillHistClass(Form("TrackMuon_%s", (*cut)->GetName()), VarManager::fgValues);
           }
         }
@@ -1174,11 +1239,15 @@ struct AnalysisPrefilterSelection {
     } // end loop over combinations
   }
 
-  void processBarrelSkimmed(MyEvents const& events, soa::Join<aod::ReducedTracksAssoc, aod::BarrelTrackCuts> const& assocs, MyBarrelTracks const& tracks)
+  void processBarrelSkimmed(MyEventsSelected const& events, soa::Join<aod::ReducedTracksAssoc, aod::BarrelTrackCuts> const& assocs, MyBarrelTracks const& tracks)
   {
     fPrefilterMap.clear();
 
     for (auto& event : events) {
+      // the associations of the rejected events have no track cut fulfilled, so they cannot contribute to the prefilter
+      if (!event.isEventSelected_bit(0)) {
+        continue;
+      }
       auto groupedAssocs = assocs.sliceBy(trackAssocsPerCollision, event.globalIndex());
       if (groupedAssocs.size() > 1) {
         runPrefilter<gkTrackFillMap>(groupedAssocs, tracks);
@@ -1250,6 +1319,8 @@ struct AnalysisSameEventPairing {
   } fConfigCuts;
 
   Configurable<int> fConfigMixingDepth{"cfgMixingDepth", 100, "Number of Events stored for event mixing"};
+  Configurable<bool> fConfigMixingAcrossDF{"cfgMixingAcrossDF", false, "If true, each event is mixed with the last cfgMixingDepth events of its category, stored in pools kept across data frames"};
+  Configurable<int> fConfigMixingMaxTracks{"cfgMixingMaxTracks", -1, "Maximum number of tracks stored in each mixing pool when mixing across data frames (no limit if <= 0)"};
   // Configurable<std::string> fConfigAddEventMixingHistogram{"cfgAddEventMixingHistogram", "", "Comma separated list of histograms"};
   Configurable<std::string> fConfigAddSEPHistogram{"cfgAddSEPHistogram", "", "Comma separated list of histograms"};
   Configurable<std::string> fConfigAddJSONHistograms{"cfgAddJSONHistograms", "", "Histograms in JSON format"};
@@ -1272,6 +1343,8 @@ struct AnalysisSameEventPairing {
     Configurable<bool> useKFVertexing{"cfgUseKFVertexing", false, "Use KF Particle for secondary vertex reconstruction (DCAFitter is used by default)"};
     Configurable<bool> useAbsDCA{"cfgUseAbsDCA", false, "Use absolute DCA minimization instead of chi^2 minimization in secondary vertexing"};
     Configurable<bool> propToPCA{"cfgPropToPCA", false, "Propagate tracks to secondary vertex"};
+    Configurable<bool> pairVertexingCache{"cfgPairVertexingCache", false, "Fit only once the pairs of tracks associated to several collisions (DCAFitter only)"};
+    Configurable<bool> sparseAccumulators{"cfgSparseAccumulators", false, "Accumulate the THnSparse fills in hash maps, added to the histograms at the end of each data frame"};
     Configurable<bool> corrFullGeo{"cfgCorrFullGeo", false, "Use full geometry to correct for MCS effects in track propagation"};
     Configurable<bool> noCorr{"cfgNoCorrFwdProp", false, "Do not correct for MCS effects in track propagation"};
     Configurable<std::string> collisionSystem{"syst", "pp", "Collision system, pp or PbPb"};
@@ -1322,6 +1395,11 @@ struct AnalysisSameEventPairing {
 
   NoBinningPolicy<aod::dqanalysisflags::MixingHash> hashBin;
 
+  MixingPool fBarrelMixingPool; // selected tracks of the previous events, used if mixing across data frames
+  MixingPool fMuonMixingPool;
+  int fBarrelMixingPoolRun; // run of the events in the pools, which are cleared at a run change
+  int fMuonMixingPoolRun;
+
   Preslice<soa::Join<aod::ReducedTracksAssoc, aod::BarrelTrackCuts, aod::Prefilter>> trackAssocsPerCollision = aod::reducedtrack_association::reducedeventId;
   Preslice<soa::Join<aod::ReducedTracksAssoc, aod::BarrelTrackCuts>> trackEmuAssocsPerCollision = aod::reducedtrack_association::reducedeventId;
   Preslice<soa::Join<aod::ReducedMuonsAssoc, aod::MuonTrackCuts>> muonAssocsPerCollision = aod::reducedtrack_association::reducedeventId;
@@ -1560,6 +1638,13 @@ struct AnalysisSameEventPairing {
     }
 
     fCurrentRun = 0;
+    VarManager::SetUsePairVertexingCache(fConfigOptions.pairVertexingCache.value);
+    if (fConfigMixingAcrossDF.value) {
+      fBarrelMixingPool.Init(fConfigMixingDepth.value, fConfigMixingMaxTracks.value);
+      fMuonMixingPool.Init(fConfigMixingDepth.value, fConfigMixingMaxTracks.value);
+    }
+    fBarrelMixingPoolRun = -1;
+    fMuonMixingPoolRun = -1;
 
     fCCDB->setURL(fConfigCCDB.url.value);
     fCCDB->setCaching(true);
@@ -1625,6 +1710,7 @@ struct AnalysisSameEventPairing {
       fHistMan = new HistogramManager("analysisHistos", "aa", VarManager::kNVars);
       fHistMan->SetUseDefaultVariableNames(true);
       fHistMan->SetDefaultVarNames(VarManager::fgVariableNames, VarManager::fgVariableUnits);
+      fHistMan->SetUseSparseAccumulators(fConfigOptions.sparseAccumulators.value);
       VarManager::SetCollisionSystem((TString)fConfigOptions.collisionSystem, fConfigOptions.centerMassEnergy); // set collision system and center of mass energy
       DefineHistograms(fHistMan, histNames.Data(), fConfigAddSEPHistogram.value.data());                        // define all histograms
       dqhistograms::AddHistogramsFromJSON(fHistMan, fConfigAddJSONHistograms.value.c_str());                    // ad-hoc histograms via JSON
@@ -1731,6 +1817,7 @@ struct AnalysisSameEventPairing {
       dileptonPolarList.reserve(1);
     }
     fAmbiguousPairs.clear();
+    VarManager::ClearPairVertexingCache(); // the track indices of the cached fits are the ones of the previous data frame
     constexpr bool eventHasQvector = ((TEventFillMap & VarManager::ObjTypes::ReducedEventQvector) > 0);
     constexpr bool eventHasQvectorCentr = ((TEventFillMap & VarManager::ObjTypes::CollisionQvect) > 0);
     constexpr bool trackHasCov = ((TTrackFillMap & VarManager::ObjTypes::TrackCov) > 0 || (TTrackFillMap & VarManager::ObjTypes::ReducedTrackBarrelCov) > 0);
@@ -1788,7 +1875,12 @@ struct AnalysisSameEventPairing {
             VarManager::FillPairCollision<TPairType, TTrackFillMap>(event, t1, t2);
           }
           if constexpr (TTwoProngFitter) {
-            VarManager::FillPairVertexing<TPairType, TEventFillMap, TTrackFillMap>(event, t1, t2, fConfigOptions.propToPCA);
+            // the vertexer is fixed at compile time, such that only its code is instantiated
+            if (fConfigOptions.useKFVertexing.value) {
+              VarManager::FillPairVertexing<TPairType, TEventFillMap, TTrackFillMap, VarManager::kVertexerKF>(event, t1, t2, fConfigOptions.propToPCA);
+            } else {
+              VarManager::FillPairVertexing<TPairType, TEventFillMap, TTrackFillMap, VarManager::kVertexerDCAFitter>(event, t1, t2, fConfigOptions.propToPCA);
+            }
           }
           if constexpr (eventHasQvector) {
             VarManager::FillPairVn<TPairType>(t1, t2);
@@ -1901,7 +1993,12 @@ struct AnalysisSameEventPairing {
             VarManager::FillPairCollision<TPairType, TTrackFillMap>(event, t1, t2);
           }
           if constexpr (TTwoProngFitter) {
-            VarManager::FillPairVertexing<TPairType, TEventFillMap, TTrackFillMap>(event, t1, t2, fConfigOptions.propToPCA);
+            // the vertexer is fixed at compile time, such that only its code is instantiated
+            if (fConfigOptions.useKFVertexing.value) {
+              VarManager::FillPairVertexing<TPairType, TEventFillMap, TTrackFillMap, VarManager::kVertexerKF>(event, t1, t2, fConfigOptions.propToPCA);
+            } else {
+              VarManager::FillPairVertexing<TPairType, TEventFillMap, TTrackFillMap, VarManager::kVertexerDCAFitter>(event, t1, t2, fConfigOptions.propToPCA);
+            }
           }
           if constexpr (eventHasQvector) {
             VarManager::FillPairVn<TPairType>(t1, t2);
@@ -2088,14 +2185,14 @@ struct AnalysisSameEventPairing {
         } // end loop (cuts)
       } // end loop over pairs of track associations
     } // end loop over events
+    if (fConfigQA && fConfigOptions.sparseAccumulators) {
+      fHistMan->FlushAccumulators();
+    }
   }
 
   template <int TPairType, uint32_t TEventFillMap, typename TAssoc1, typename TAssoc2, typename TTracks1, typename TTracks2>
   void runMixedPairing(TAssoc1 const& assocs1, TAssoc2 const& assocs2, TTracks1 const& /*tracks1*/, TTracks2 const& /*tracks2*/)
   {
-    std::map<int, std::vector<TString>> histNames = fTrackHistNames;
-    int pairSign = 0;
-    int ncuts = 0;
     uint32_t twoTrackFilter = static_cast<uint32_t>(0);
     for (auto& a1 : assocs1) {
       for (auto& a2 : assocs2) {
@@ -2104,154 +2201,163 @@ struct AnalysisSameEventPairing {
           if (!twoTrackFilter) { // the tracks must have at least one filter bit in common to continue
             continue;
           }
-          auto t1 = a1.template reducedtrack_as<TTracks1>();
-          auto t2 = a2.template reducedtrack_as<TTracks2>();
-          VarManager::FillPairME<TEventFillMap, TPairType>(t1, t2);
-          if constexpr ((TEventFillMap & VarManager::ObjTypes::ReducedEventQvector) > 0) {
-            VarManager::FillPairVn<TEventFillMap, TPairType>(t1, t2);
-          }
-          if constexpr ((TEventFillMap & VarManager::ObjTypes::CollisionQvect) > 0) {
-            VarManager::FillPairVn<TEventFillMap, TPairType>(t1, t2);
-          }
-          pairSign = t1.sign() + t2.sign();
-          ncuts = fNCutsBarrel;
+          fillMixedPair<TPairType, TEventFillMap>(twoTrackFilter, a1.template reducedtrack_as<TTracks1>(), a2.template reducedtrack_as<TTracks2>());
         }
         if constexpr (TPairType == VarManager::kDecayToMuMu) {
           twoTrackFilter = a1.isMuonSelected_raw() & a2.isMuonSelected_raw() & fMuonFilterMask;
           if (!twoTrackFilter) { // the tracks must have at least one filter bit in common to continue
             continue;
           }
-          auto t1 = a1.template reducedmuon_as<TTracks1>();
-          auto t2 = a2.template reducedmuon_as<TTracks2>();
-          if (t1.matchMCHTrackId() == t2.matchMCHTrackId() && t1.matchMCHTrackId() >= 0)
-            continue;
-          if (t1.matchMFTTrackId() == t2.matchMFTTrackId() && t1.matchMCHTrackId() >= 0)
-            continue;
-          VarManager::FillPairME<TEventFillMap, TPairType>(t1, t2);
-          if constexpr ((TEventFillMap & VarManager::ObjTypes::ReducedEventQvector) > 0) {
-            VarManager::FillPairVn<TEventFillMap, TPairType>(t1, t2);
-          }
-          pairSign = t1.sign() + t2.sign();
-          // store the ambiguity number of the two dilepton legs in the last 4 digits of the two-track filter
-          if (t1.muonAmbiguityInBunch() > 1) {
-            twoTrackFilter |= (static_cast<uint32_t>(1) << 28);
-          }
-          if (t2.muonAmbiguityInBunch() > 1) {
-            twoTrackFilter |= (static_cast<uint32_t>(1) << 29);
-          }
-          if (t1.muonAmbiguityOutOfBunch() > 1) {
-            twoTrackFilter |= (static_cast<uint32_t>(1) << 30);
-          }
-          if (t2.muonAmbiguityOutOfBunch() > 1) {
-            twoTrackFilter |= (static_cast<uint32_t>(1) << 31);
-          }
-          ncuts = fNCutsMuon;
-          histNames = fMuonHistNames;
-
-          if (fConfigOptions.flatTables.value) {
-            dimuonAllList(-999., -999., -999., -999.,
-                          0, 0,
-                          -999., -999., -999.,
-                          VarManager::fgValues[VarManager::kMass],
-                          false,
-                          VarManager::fgValues[VarManager::kPt], VarManager::fgValues[VarManager::kEta], VarManager::fgValues[VarManager::kPhi], t1.sign() + t2.sign(), VarManager::fgValues[VarManager::kVertexingChi2PCA],
-                          VarManager::fgValues[VarManager::kVertexingTauz], VarManager::fgValues[VarManager::kVertexingTauzErr],
-                          VarManager::fgValues[VarManager::kVertexingTauxy], VarManager::fgValues[VarManager::kVertexingTauxyErr],
-                          VarManager::fgValues[VarManager::kCosPointingAngle],
-                          t1.pt(), t1.eta(), t1.phi(), t1.sign(),
-                          t2.pt(), t2.eta(), t2.phi(), t2.sign(),
-                          t1.fwdDcaX(), t1.fwdDcaY(), t2.fwdDcaX(), t2.fwdDcaY(),
-                          0., 0.,
-                          t1.chi2MatchMCHMID(), t2.chi2MatchMCHMID(),
-                          t1.chi2MatchMCHMFT(), t2.chi2MatchMCHMFT(),
-                          t1.chi2(), t2.chi2(),
-                          -999., -999., -999., -999.,
-                          -999., -999., -999., -999.,
-                          -999., -999., -999., -999.,
-                          -999., -999., -999., -999.,
-                          (twoTrackFilter & (static_cast<uint32_t>(1) << 28)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 29)), (twoTrackFilter & (static_cast<uint32_t>(1) << 30)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 31)),
-                          true, true,
-                          VarManager::fgValues[VarManager::kU2Q2], VarManager::fgValues[VarManager::kU3Q3],
-                          VarManager::fgValues[VarManager::kR2EP_AB], VarManager::fgValues[VarManager::kR2SP_AB], VarManager::fgValues[VarManager::kCentFT0C],
-                          VarManager::fgValues[VarManager::kCos2DeltaPhi], VarManager::fgValues[VarManager::kCos3DeltaPhi],
-                          VarManager::fgValues[VarManager::kCORR2POI], VarManager::fgValues[VarManager::kCORR4POI], VarManager::fgValues[VarManager::kM01POI], VarManager::fgValues[VarManager::kM0111POI], VarManager::fgValues[VarManager::kMultDimuons],
-                          VarManager::fgValues[VarManager::kVertexingPz], VarManager::fgValues[VarManager::kVertexingSV]);
-          }
+          fillMixedPair<TPairType, TEventFillMap>(twoTrackFilter, a1.template reducedmuon_as<TTracks1>(), a2.template reducedmuon_as<TTracks2>());
         }
         /*if constexpr (TPairType == VarManager::kElectronMuon) {
           twoTrackFilter = a1.isBarrelSelected_raw() & a1.isBarrelSelectedPrefilter_raw() & a2.isMuonSelected_raw() & fTrackFilterMask;
         }*/
+      } // end for (track2)
+    } // end for (track1)
+  }
 
-        bool isAmbiInBunch = false;
-        bool isAmbiOutOfBunch = false;
-        bool isUnambiguous = false;
-        for (int icut = 0; icut < ncuts; icut++) {
-          if (!(twoTrackFilter & (static_cast<uint32_t>(1) << icut))) {
-            continue; // cut not passed
-          }
-          isAmbiInBunch = (twoTrackFilter & (static_cast<uint32_t>(1) << 28)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 29));
-          isAmbiOutOfBunch = (twoTrackFilter & (static_cast<uint32_t>(1) << 30)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 31));
-          isUnambiguous = !((twoTrackFilter & (static_cast<uint32_t>(1) << 28)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 29)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 30)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 31)));
-          if (pairSign == 0) {
-            if constexpr (TPairType == VarManager::kDecayToMuMu) {
-              fHistMan->FillHistClass(histNames[icut][3].Data(), VarManager::fgValues);
-              if (fConfigAmbiguousMuonHistograms) {
-                if (isAmbiInBunch) {
-                  fHistMan->FillHistClass(histNames[icut][15].Data(), VarManager::fgValues);
-                }
-                if (isAmbiOutOfBunch) {
-                  fHistMan->FillHistClass(histNames[icut][18].Data(), VarManager::fgValues);
-                }
-                if (isUnambiguous) {
-                  fHistMan->FillHistClass(histNames[icut][21].Data(), VarManager::fgValues);
-                }
-              }
+  // mixed event pair of tracks having at least one filter bit in common, either reduced tracks or MixingPool records
+  template <int TPairType, uint32_t TEventFillMap, typename T1, typename T2>
+  void fillMixedPair(uint32_t twoTrackFilter, T1 const& t1, T2 const& t2)
+  {
+    std::map<int, std::vector<TString>>& histNames = (TPairType == VarManager::kDecayToMuMu ? fMuonHistNames : fTrackHistNames);
+    int pairSign = 0;
+    int ncuts = 0;
+    if constexpr (TPairType == VarManager::kDecayToEE) {
+      VarManager::FillPairME<TEventFillMap, TPairType>(t1, t2);
+      if constexpr ((TEventFillMap & VarManager::ObjTypes::ReducedEventQvector) > 0) {
+        VarManager::FillPairVn<TEventFillMap, TPairType>(t1, t2);
+      }
+      if constexpr ((TEventFillMap & VarManager::ObjTypes::CollisionQvect) > 0) {
+        VarManager::FillPairVn<TEventFillMap, TPairType>(t1, t2);
+      }
+      pairSign = t1.sign() + t2.sign();
+      ncuts = fNCutsBarrel;
+    }
+    if constexpr (TPairType == VarManager::kDecayToMuMu) {
+      if (t1.matchMCHTrackId() == t2.matchMCHTrackId() && t1.matchMCHTrackId() >= 0)
+        return;
+      if (t1.matchMFTTrackId() == t2.matchMFTTrackId() && t1.matchMCHTrackId() >= 0)
+        return;
+      VarManager::FillPairME<TEventFillMap, TPairType>(t1, t2);
+      if constexpr ((TEventFillMap & VarManager::ObjTypes::ReducedEventQvector) > 0) {
+        VarManager::FillPairVn<TEventFillMap, TPairType>(t1, t2);
+      }
+      pairSign = t1.sign() + t2.sign();
+      // store the ambiguity number of the two dilepton legs in the last 4 digits of the two-track filter
+      if (t1.muonAmbiguityInBunch() > 1) {
+        twoTrackFilter |= (static_cast<uint32_t>(1) << 28);
+      }
+      if (t2.muonAmbiguityInBunch() > 1) {
+        twoTrackFilter |= (static_cast<uint32_t>(1) << 29);
+      }
+      if (t1.muonAmbiguityOutOfBunch() > 1) {
+        twoTrackFilter |= (static_cast<uint32_t>(1) << 30);
+      }
+      if (t2.muonAmbiguityOutOfBunch() > 1) {
+        twoTrackFilter |= (static_cast<uint32_t>(1) << 31);
+      }
+      ncuts = fNCutsMuon;
+
+      if (fConfigOptions.flatTables.value) {
+        dimuonAllList(-999., -999., -999., -999.,
+                      0, 0,
+                      -999., -999., -999.,
+                      VarManager::fgValues[VarManager::kMass],
+                      false,
+                      VarManager::fgValues[VarManager::kPt], VarManager::fgValues[VarManager::kEta], VarManager::fgValues[VarManager::kPhi], t1.sign() + t2.sign(), VarManager::fgValues[VarManager::kVertexingChi2PCA],
+                      VarManager::fgValues[VarManager::kVertexingTauz], VarManager::fgValues[VarManager::kVertexingTauzErr],
+                      VarManager::fgValues[VarManager::kVertexingTauxy], VarManager::fgValues[VarManager::kVertexingTauxyErr],
+                      VarManager::fgValues[VarManager::kCosPointingAngle],
+                      t1.pt(), t1.eta(), t1.phi(), t1.sign(),
+                      t2.pt(), t2.eta(), t2.phi(), t2.sign(),
+                      t1.fwdDcaX(), t1.fwdDcaY(), t2.fwdDcaX(), t2.fwdDcaY(),
+                      0., 0.,
+                      t1.chi2MatchMCHMID(), t2.chi2MatchMCHMID(),
+                      t1.chi2MatchMCHMFT(), t2.chi2MatchMCHMFT(),
+                      t1.chi2(), t2.chi2(),
+                      -999., -999., -999., -999.,
+                      -999., -999., -999., -999.,
+                      -999., -999., -999., -999.,
+                      -999., -999., -999., -999.,
+                      (twoTrackFilter & (static_cast<uint32_t>(1) << 28)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 29)), (twoTrackFilter & (static_cast<uint32_t>(1) << 30)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 31)),
+                      true, true,
+                      VarManager::fgValues[VarManager::kU2Q2], VarManager::fgValues[VarManager::kU3Q3],
+                      VarManager::fgValues[VarManager::kR2EP_AB], VarManager::fgValues[VarManager::kR2SP_AB], VarManager::fgValues[VarManager::kCentFT0C],
+                      VarManager::fgValues[VarManager::kCos2DeltaPhi], VarManager::fgValues[VarManager::kCos3DeltaPhi],
+                      VarManager::fgValues[VarManager::kCORR2POI], VarManager::fgValues[VarManager::kCORR4POI], VarManager::fgValues[VarManager::kM01POI], VarManager::fgValues[VarManager::kM0111POI], VarManager::fgValues[VarManager::kMultDimuons],
+                      VarManager::fgValues[VarManager::kVertexingPz], VarManager::fgValues[VarManager::kVertexingSV]);
+      }
+    }
+    bool isAmbiInBunch = false;
+    bool isAmbiOutOfBunch = false;
+    bool isUnambiguous = false;
+    for (int icut = 0; icut < ncuts; icut++) {
+      if (!(twoTrackFilter & (static_cast<uint32_t>(1) << icut))) {
+        continue; // cut not passed
+      }
+      isAmbiInBunch = (twoTrackFilter & (static_cast<uint32_t>(1) << 28)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 29));
+      isAmbiOutOfBunch = (twoTrackFilter & (static_cast<uint32_t>(1) << 30)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 31));
+      isUnambiguous = !((twoTrackFilter & (static_cast<uint32_t>(1) << 28)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 29)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 30)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 31)));
+      if (pairSign == 0) {
+        if constexpr (TPairType == VarManager::kDecayToMuMu) {
+          fHistMan->FillHistClass(histNames[icut][3].Data(), VarManager::fgValues);
+          if (fConfigAmbiguousMuonHistograms) {
+            if (isAmbiInBunch) {
+              fHistMan->FillHistClass(histNames[icut][15].Data(), VarManager::fgValues);
             }
-            if constexpr (TPairType == VarManager::kDecayToEE) {
-              fHistMan->FillHistClass(Form("PairsBarrelMEPM_%s", fTrackCuts[icut].Data()), VarManager::fgValues);
+            if (isAmbiOutOfBunch) {
+              fHistMan->FillHistClass(histNames[icut][18].Data(), VarManager::fgValues);
             }
-          } else {
-            if (pairSign > 0) {
-              if constexpr (TPairType == VarManager::kDecayToMuMu) {
-                fHistMan->FillHistClass(histNames[icut][4].Data(), VarManager::fgValues);
-                if (fConfigAmbiguousMuonHistograms) {
-                  if (isAmbiInBunch) {
-                    fHistMan->FillHistClass(histNames[icut][16].Data(), VarManager::fgValues);
-                  }
-                  if (isAmbiOutOfBunch) {
-                    fHistMan->FillHistClass(histNames[icut][19].Data(), VarManager::fgValues);
-                  }
-                  if (isUnambiguous) {
-                    fHistMan->FillHistClass(histNames[icut][22].Data(), VarManager::fgValues);
-                  }
-                }
+            if (isUnambiguous) {
+              fHistMan->FillHistClass(histNames[icut][21].Data(), VarManager::fgValues);
+            }
+          }
+        }
+        if constexpr (TPairType == VarManager::kDecayToEE) {
+          fHistMan->FillHistClass(Form("PairsBarrelMEPM_%s", fTrackCuts[icut].Data()), VarManager::fgValues);
+        }
+      } else {
+        if (pairSign > 0) {
+          if constexpr (TPairType == VarManager::kDecayToMuMu) {
+            fHistMan->FillHistClass(histNames[icut][4].Data(), VarManager::fgValues);
+            if (fConfigAmbiguousMuonHistograms) {
+              if (isAmbiInBunch) {
+                fHistMan->FillHistClass(histNames[icut][16].Data(), VarManager::fgValues);
               }
-              if constexpr (TPairType == VarManager::kDecayToEE) {
-                fHistMan->FillHistClass(Form("PairsBarrelMEPP_%s", fTrackCuts[icut].Data()), VarManager::fgValues);
+              if (isAmbiOutOfBunch) {
+                fHistMan->FillHistClass(histNames[icut][19].Data(), VarManager::fgValues);
               }
-            } else {
-              if constexpr (TPairType == VarManager::kDecayToMuMu) {
-                fHistMan->FillHistClass(histNames[icut][5].Data(), VarManager::fgValues);
-                if (fConfigAmbiguousMuonHistograms) {
-                  if (isAmbiInBunch) {
-                    fHistMan->FillHistClass(histNames[icut][17].Data(), VarManager::fgValues);
-                  }
-                  if (isAmbiOutOfBunch) {
-                    fHistMan->FillHistClass(histNames[icut][20].Data(), VarManager::fgValues);
-                  }
-                  if (isUnambiguous) {
-                    fHistMan->FillHistClass(histNames[icut][23].Data(), VarManager::fgValues);
-                  }
-                }
+              if (isUnambiguous) {
+                fHistMan->FillHistClass(histNames[icut][22].Data(), VarManager::fgValues);
               }
-              if constexpr (TPairType == VarManager::kDecayToEE) {
-                fHistMan->FillHistClass(Form("PairsBarrelMEMM_%s", fTrackCuts[icut].Data()), VarManager::fgValues);
+            }
+          }
+          if constexpr (TPairType == VarManager::kDecayToEE) {
+            fHistMan->FillHistClass(Form("PairsBarrelMEPP_%s", fTrackCuts[icut].Data()), VarManager::fgValues);
+          }
+        } else {
+          if constexpr (TPairType == VarManager::kDecayToMuMu) {
+            fHistMan->FillHistClass(histNames[icut][5].Data(), VarManager::fgValues);
+            if (fConfigAmbiguousMuonHistograms) {
+              if (isAmbiInBunch) {
+                fHistMan->FillHistClass(histNames[icut][17].Data(), VarManager::fgValues);
+              }
+              if (isAmbiOutOfBunch) {
+                fHistMan->FillHistClass(histNames[icut][20].Data(), VarManager::fgValues);
+              }
+              if (isUnambiguous) {
+                fHistMan->FillHistClass(histNames[icut][23].Data(), VarManager::fgValues);
               }
             }
           }
-        } // end for (cuts)
-      } // end for (track2)
-    } // end for (track1)
+          if constexpr (TPairType == VarManager::kDecayToEE) {
+            fHistMan->FillHistClass(Form("PairsBarrelMEMM_%s", fTrackCuts[icut].Data()), VarManager::fgValues);
+          }
+        }
+      }
+    } // end for (cuts)
   }
 
   // barrel-barrel and muon-muon event mixing
@@ -2259,6 +2365,13 @@ struct AnalysisSameEventPairing {
   void runSameSideMixing(TEvents& events, TAssocs const& assocs, TTracks const& tracks, Preslice<TAssocs>& preSlice)
   {
     events.bindExternalIndices(&assocs);
+    if (fConfigMixingAcrossDF.value) {
+      runPoolMixing<TPairType, TEventFillMap>(events, assocs, tracks, preSlice);
+      if (fConfigQA && fConfigOptions.sparseAccumulators) {
+        fHistMan->FlushAccumulators();
+      }
+      return;
+    }
     int mixingDepth = fConfigMixingDepth.value;
     fAmbiguousPairs.clear();
     for (auto& [event1, event2] : selfCombinations(hashBin, mixingDepth, -1, events, events)) {
@@ -2273,6 +2386,73 @@ struct AnalysisSameEventPairing {
 
       runMixedPairing<TPairType, TEventFillMap>(assocs1, assocs2, tracks, tracks);
     } // end event loop
+    if (fConfigQA && fConfigOptions.sparseAccumulators) {
+      fHistMan->FlushAccumulators();
+    }
+  }
+
+  // barrel-barrel and muon-muon event mixing with the events of the same category stored in the mixing pools,
+  //   such that the events of the previous data frames of the run are also used
+  template <int TPairType, uint32_t TEventFillMap, typename TEvents, typename TAssocs, typename TTracks>
+  void runPoolMixing(TEvents& events, TAssocs const& assocs, TTracks const& /*tracks*/, Preslice<TAssocs>& preSlice)
+  {
+    MixingPool& pool = (TPairType == VarManager::kDecayToEE ? fBarrelMixingPool : fMuonMixingPool);
+    int& poolRun = (TPairType == VarManager::kDecayToEE ? fBarrelMixingPoolRun : fMuonMixingPoolRun);
+    if (events.size() > 0 && events.begin().runNumber() != poolRun) {
+      pool.Clear();
+      poolRun = events.begin().runNumber();
+    }
+    pool.NewDataFrame();
+
+    for (auto& event : events) {
+      int category = event.mixingHash();
+      if (category < 0) {
+        continue;
+      }
+      // compact records of the selected tracks of this event, mixed with the stored events before being stored
+      pool.StartEvent(category);
+      auto eventAssocs = assocs.sliceBy(preSlice, event.globalIndex());
+      for (auto& assoc : eventAssocs) {
+        if constexpr (TPairType == VarManager::kDecayToEE) {
+          uint32_t filter = assoc.isBarrelSelected_raw() & assoc.isBarrelSelectedPrefilter_raw() & fTrackFilterMask;
+          if (!filter) {
+            continue;
+          }
+          auto track = assoc.template reducedtrack_as<TTracks>();
+          pool.AddTrack(track.pt(), track.eta(), track.phi(), track.sign(), filter);
+        }
+        if constexpr (TPairType == VarManager::kDecayToMuMu) {
+          uint32_t filter = assoc.isMuonSelected_raw() & fMuonFilterMask;
+          if (!filter) {
+            continue;
+          }
+          auto muon = assoc.template reducedmuon_as<TTracks>();
+          pool.AddMuon(muon.pt(), muon.eta(), muon.phi(), muon.sign(), filter, muon.fwdDcaX(), muon.fwdDcaY(), muon.chi2(), muon.chi2MatchMCHMID(), muon.chi2MatchMCHMFT(),
+                       muon.matchMCHTrackId(), muon.matchMFTTrackId(), muon.muonAmbiguityInBunch(), muon.muonAmbiguityOutOfBunch());
+        }
+      }
+
+      const auto& current = pool.GetCurrentEvent();
+      if (current.GetNTracks() > 0 && pool.GetNEvents(category) > 0) {
+        VarManager::ResetValues(0, VarManager::kNVars);
+        VarManager::FillEvent<TEventFillMap>(event, VarManager::fgValues);
+        for (int iEvent = 0; iEvent < pool.GetNEvents(category); iEvent++) {
+          const auto& storedEvent = pool.GetEvent(category, iEvent);
+          for (int i1 = 0; i1 < current.GetNTracks(); i1++) {
+            auto t1 = current.GetTrack(i1);
+            for (int i2 = 0; i2 < storedEvent.GetNTracks(); i2++) {
+              auto t2 = storedEvent.GetTrack(i2);
+              uint32_t twoTrackFilter = t1.filter() & t2.filter();
+              if (!twoTrackFilter) { // the tracks must have at least one filter bit in common to continue
+                continue;
+              }
+              fillMixedPair<TPairType, TEventFillMap>(twoTrackFilter, t1, t2);
+            }
+          }
+        }
+      }
+      pool.FinishEvent();
+    } // end event loop
   }
 
   template <bool TTwoProngFitter, int TPairType, uint32_t TEventFillMap, uint32_t TTrackFillMap, uint32_t TMuonFillMap, typename TEvents, typename TTrackAssocs, typename TTracks, typename TMuonAssocs, typename TMuons>
@@ -2390,6 +2570,9 @@ struct AnalysisSameEventPairing {
 
       } // end combinations loop
     } // end event loop
+    if (fConfigQA && fConfigOptions.sparseAccumulators) {
+      fHistMan->FlushAccumulators();
+    }
   }
 
   void processAllSkimmed(MyEventsVtxCovSelected const& events,
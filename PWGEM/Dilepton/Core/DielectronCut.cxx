@@ -17,6 +17,7 @@
 
 #include "Framework/Logger.h"
 
+#include <algorithm>
 #include <set>
 #include <utility>
 
@@ -84,12 +85,14 @@ void DielectronCut::SetTrackPtRange(float minPt, float maxPt)
 {
   mMinTrackPt = minPt;
   mMaxTrackPt = maxPt;
+  mTrackCutSequenceBuilt = false;
   LOG(info) << "Dielectron Cut, set track pt range: " << mMinTrackPt << " - " << mMaxTrackPt;
 }
 void DielectronCut::SetTrackEtaRange(float minEta, float maxEta)
 {
   mMinTrackEta = minEta;
   mMaxTrackEta = maxEta;
+  mTrackCutSequenceBuilt = false;
   LOG(info) << "Dielectron Cut, set track eta range: " << mMinTrackEta << " - " << mMaxTrackEta;
 }
 void DielectronCut::SetTrackPhiRange(float minPhi, float maxPhi, bool mirror, bool reject)
@@ -98,6 +101,7 @@ void DielectronCut::SetTrackPhiRange(float minPhi, float maxPhi, bool mirror, bo
   mMaxTrackPhi = maxPhi;
   mMirrorTrackPhi = mirror;
   mRejectTrackPhi = reject;
+  mTrackCutSequenceBuilt = false;
   LOG(info) << "Dielectron Cut, set track phi range (rad.): " << mMinTrackPhi << " - " << mMaxTrackPhi << " with mirror: " << mMirrorTrackPhi << " and rejection: " << mRejectTrackPhi;
 }
 void DielectronCut::SetTrackPhiPositionRange(float minPhi, float maxPhi, float refR, float bz, bool mirror)
@@ -107,39 +111,46 @@ void DielectronCut::SetTrackPhiPositionRange(float minPhi, float maxPhi, float r
   mRefR = refR;
   mBz = bz;
   mMirrorTrackPhi = mirror;
+  mTrackCutSequenceBuilt = false;
   LOG(info) << "Dielectron Cut, set track phi position range (rad.): " << mMinTrackPhiPosition << " - " << mMaxTrackPhiPosition << " at Rxy = " << mRefR << " with mirror: " << mMirrorTrackPhi;
   LOG(info) << "Dielectron Cut, set Bz in kG: " << mBz;
 }
 void DielectronCut::SetMinNClustersTPC(int minNClustersTPC)
 {
   mMinNClustersTPC = minNClustersTPC;
+  mTrackCutSequenceBuilt = false;
   LOG(info) << "Dielectron Cut, set min N clusters TPC: " << mMinNClustersTPC;
 }
 void DielectronCut::SetMinNCrossedRowsTPC(int minNCrossedRowsTPC)
 {
   mMinNCrossedRowsTPC = minNCrossedRowsTPC;
+  mTrackCutSequenceBuilt = false;
   LOG(info) << "Dielectron Cut, set min N crossed rows TPC: " << mMinNCrossedRowsTPC;
 }
 void DielectronCut::SetMinNCrossedRowsOverFindableClustersTPC(float minNCrossedRowsOverFindableClustersTPC)
 {
   mMinNCrossedRowsOverFindableClustersTPC = minNCrossedRowsOverFindableClustersTPC;
+  mTrackCutSequenceBuilt = false;
   LOG(info) << "Dielectron Cut, set min N crossed rows over findable clusters TPC: " << mMinNCrossedRowsOverFindableClustersTPC;
 }
 void DielectronCut::SetMaxFracSharedClustersTPC(float max)
 {
   mMaxFracSharedClustersTPC = max;
+  mTrackCutSequenceBuilt = false;
   LOG(info) << "Dielectron Cut, set max fraction of shared clusters in  TPC: " << mMaxFracSharedClustersTPC;
 }
 void DielectronCut::SetRelDiffPin(float min, float max)
 {
   mMinRelDiffPin = min;
   mMaxRelDiffPin = max;
+  mTrackCutSequenceBuilt = false;
   LOG(info) << "Dielectron Cut, set rel. diff. between Pin and Ppv range: " << mMinRelDiffPin << " - " << mMaxRelDiffPin;
 }
 void DielectronCut::SetChi2PerClusterTPC(float min, float max)
 {
   mMinChi2PerClusterTPC = min;
   mMaxChi2PerClusterTPC = max;
+  mTrackCutSequenceBuilt = false;
   LOG(info) << "Dielectron Cut, set chi2 per cluster TPC range: " << mMinChi2PerClusterTPC << " - " << mMaxChi2PerClusterTPC;
 }
 
@@ -147,12 +158,14 @@ void DielectronCut::SetNClustersITS(int min, int max)
 {
   mMinNClustersITS = min;
   mMaxNClustersITS = max;
+  mTrackCutSequenceBuilt = false;
   LOG(info) << "Dielectron Cut, set N clusters ITS range: " << mMinNClustersITS << " - " << mMaxNClustersITS;
 }
 void DielectronCut::SetChi2PerClusterITS(float min, float max)
 {
   mMinChi2PerClusterITS = min;
   mMaxChi2PerClusterITS = max;
+  mTrackCutSequenceBuilt = false;
   LOG(info) << "Dielectron Cut, set chi2 per cluster ITS range: " << mMinChi2PerClusterITS << " - " << mMaxChi2PerClusterITS;
 }
 void DielectronCut::SetMeanClusterSizeITS(float min, float max)
@@ -161,6 +174,7 @@ void DielectronCut::SetMeanClusterSizeITS(float min, float max)
   mMaxMeanClusterSizeITS = max;
   // mMinP_ITSClusterSize = minP;
   // mMaxP_ITSClusterSize = maxP;
+  mTrackCutSequenceBuilt = false;
   LOG(info) << "Dielectron Cut, set mean cluster size ITS range: " << mMinMeanClusterSizeITS << " - " << mMaxMeanClusterSizeITS;
 }
 void DielectronCut::SetChi2TOF(float min, float max)
@@ -174,22 +188,26 @@ void DielectronCut::SetTrackDca3DRange(float min, float max)
 {
   mMinDca3D = min;
   mMaxDca3D = max;
+  mTrackCutSequenceBuilt = false;
   LOG(info) << "Dielectron Cut, set DCA 3D range in sigma: " << mMinDca3D << " - " << mMaxDca3D;
 }
 void DielectronCut::SetTrackMaxDcaXY(float maxDcaXY)
 {
   mMaxDcaXY = maxDcaXY;
+  mTrackCutSequenceBuilt = false;
   LOG(info) << "Dielectron Cut, set max DCA xy: " << mMaxDcaXY;
 }
 void DielectronCut::SetTrackMaxDcaZ(float maxDcaZ)
 {
   mMaxDcaZ = maxDcaZ;
+  mTrackCutSequenceBuilt = false;
   LOG(info) << "Dielectron Cut, set max DCA z: " << mMaxDcaZ;
 }
 
 void DielectronCut::SetTrackMaxDcaXYPtDep(std::function<float(float)> ptDepCut)
 {
   mMaxDcaXYPtDep = ptDepCut;
+  mTrackCutSequenceBuilt = false;
   LOG(info) << "Dielectron Cut, set max DCA xy pt dep: " << mMaxDcaXYPtDep(1.0);
 }
 void DielectronCut::ApplyPhiV(bool flag)
@@ -200,6 +218,7 @@ void DielectronCut::ApplyPhiV(bool flag)
 void DielectronCut::ApplyPrefilter(bool flag)
 {
   mApplyPF = flag;
+  mTrackCutSequenceBuilt = false;
   LOG(info) << "Dielectron Cut, apply prefilter: " << mApplyPF;
 }
 
@@ -356,3 +375,106 @@ void DielectronCut::IncludeITSsa(bool flag, float max)
   mMaxPtITSsa = max;
   LOG(info) << "Dielectron Cut, include ITSsa tracks: " << mIncludeITSsa << ", mMaxPtITSsa = " << mMaxPtITSsa;
 }
+void DielectronCut::EnableTrackCache(bool flag)
+{
+  mUseTrackCache = flag;
+  mTrackCache.clear();
+  LOG(info) << "Dielectron Cut, cache the track selection: " << mUseTrackCache;
+}
+void DielectronCut::CalibrateTrackCutOrder(int nTracks)
+{
+  mNCalibrationTracks = nTracks;
+  mNTracksEvaluated.fill(0);
+  mNTracksRejected.fill(0);
+  LOG(info) << "Dielectron Cut, calibrate the order of track cuts with " << mNCalibrationTracks << " tracks";
+}
+
+bool DielectronCut::IsTrackCutEnabled(const DielectronCuts& cut) const
+{
+  constexpr float NoLimit = 1e9f; // limits beyond are never reached by the track variables
+  switch (cut) {
+    case DielectronCuts::kTrackPtRange:
+      return mMinTrackPt > 0.f || mMaxTrackPt < NoLimit;
+    case DielectronCuts::kTrackEtaRange:
+      return mMinTrackEta > -NoLimit || mMaxTrackEta < NoLimit;
+    case DielectronCuts::kTrackPhiRange:
+    case DielectronCuts::kTrackPhiPositionRange:
+    case DielectronCuts::kTPCCrossedRowsOverNCls:
+      return true;
+    case DielectronCuts::kTPCNCls:
+      return mMinNClustersTPC > 0;
+    case DielectronCuts::kTPCCrossedRows:
+      return mMinNCrossedRowsTPC > 0;
+    case DielectronCuts::kTPCFracSharedClusters:
+      return mMaxFracSharedClustersTPC < NoLimit;
+    case DielectronCuts::kRelDiffPin:
+      return mMinRelDiffPin > -NoLimit || mMaxRelDiffPin < NoLimit;
+    case DielectronCuts::kTPCChi2NDF:
+      return mMinChi2PerClusterTPC > -NoLimit || mMaxChi2PerClusterTPC < NoLimit;
+    case DielectronCuts::kDCA3Dsigma:
+      return mMinDca3D > -NoLimit || mMaxDca3D < NoLimit;
+    case DielectronCuts::kDCAxy:
+      return static_cast<bool>(mMaxDcaXYPtDep) || mMaxDcaXY < NoLimit;
+    case DielectronCuts::kDCAz:
+      return mMaxDcaZ < NoLimit;
+    case DielectronCuts::kITSNCls:
+      return mMinNClustersITS > 0 || mMaxNClustersITS < 7;
+    case DielectronCuts::kITSChi2NDF:
+      return mMinChi2PerClusterITS > -NoLimit || mMaxChi2PerClusterITS < NoLimit;
+    case DielectronCuts::kITSClusterSize:
+      return mMinMeanClusterSizeITS > -NoLimit || mMaxMeanClusterSizeITS < NoLimit;
+    case DielectronCuts::kPrefilter:
+      return mApplyPF;
+    default:
+      return false;
+  }
+}
+
+namespace
+{
+// relative cost of the evaluation of the track cuts
+float trackCutCost(const DielectronCut::DielectronCuts& cut)
+{
+  switch (cut) {
+    case DielectronCut::DielectronCuts::kTrackPhiPositionRange: // propagation to the reference radius
+      return 4.f;
+    case DielectronCut::DielectronCuts::kDCA3Dsigma:     // DCA covariance
+    case DielectronCut::DielectronCuts::kITSClusterSize: // loop over the ITS layers
+      return 3.f;
+    default:
+      return 1.f;
+  }
+}
+} // namespace
+
+void DielectronCut::BuildTrackCutSequence() const
+{
+  // kinematics, DCA and ITS first, then TPC, as the cuts were applied so far
+  static constexpr DielectronCuts DefaultOrder[] = {
+    DielectronCuts::kTrackPtRange, DielectronCuts::kTrackEtaRange, DielectronCuts::kTrackPhiRange, DielectronCuts::kTrackPhiPositionRange,
+    DielectronCuts::kDCA3Dsigma, DielectronCuts::kDCAxy, DielectronCuts::kDCAz,
+    DielectronCuts::kITSNCls, DielectronCuts::kITSChi2NDF, DielectronCuts::kITSClusterSize,
+    DielectronCuts::kTPCNCls, DielectronCuts::kTPCCrossedRows, DielectronCuts::kTPCCrossedRowsOverNCls, DielectronCuts::kTPCFracSharedClusters, DielectronCuts::kRelDiffPin, DielectronCuts::kTPCChi2NDF,
+    DielectronCuts::kPrefilter};
+  mTrackCutSequence.clear();
+  for (const auto& cut : DefaultOrder) {
+    if (IsTrackCutEnabled(cut)) {
+      mTrackCutSequence.emplace_back(cut);
+    }
+  }
+  std::stable_sort(mTrackCutSequence.begin(), mTrackCutSequence.end(), [](const DielectronCuts& a, const DielectronCuts& b) { return trackCutCost(a) < trackCutCost(b); });
+  mTrackCutSequenceBuilt = true;
+  mTrackCache.clear(); // the cached selections used the previous cuts
+}
+
+void DielectronCut::OrderTrackCutSequence() const
+{
+  auto rejectionPerCost = [this](const DielectronCuts& cut) {
+    int64_t nEvaluated = mNTracksEvaluated[static_cast<int>(cut)];
+    return nEvaluated > 0 ? static_cast<float>(mNTracksRejected[static_cast<int>(cut)]) / nEvaluated / trackCutCost(cut) : 0.f;
+  };
+  std::stable_sort(mTrackCutSequence.begin(), mTrackCutSequence.end(), [&](const DielectronCuts& a, const DielectronCuts& b) { return rejectionPerCost(a) > rejectionPerCost(b); });
+  for (const auto& cut : mTrackCutSequence) {
+    LOG(info) << "Dielectron Cut, track cut " << static_cast<int>(cut) << ": rejection " << mNTracksRejected[static_cast<int>(cut)] << " / " << mNTracksEvaluated[static_cast<int>(cut)];
+  }
+}
@@ -18,6 +18,7 @@
 
 #include "PWGEM/Dilepton/Utils/EMTrackUtilities.h"
 #include "PWGEM/Dilepton/Utils/MlResponseDielectronSingleTrack.h"
+#include "PWGEM/Dilepton/Utils/PairKernel.h"
 #include "PWGEM/Dilepton/Utils/PairUtilities.h"
 
 #include "CommonConstants/PhysicsConstants.h"
@@ -28,6 +29,8 @@
 #include "TNamed.h"
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <set>
 #include <string>
 #include <utility>
@@ -167,48 +170,119 @@ class DielectronCut : public TNamed
     return true;
   }
 
-  template <bool dont_require_pteta = false, typename TTrack>
-  bool IsSelectedTrack(TTrack const& track) const
+  // same selection as IsSelectedPair, on the pair variables of a block computed by computePairBlock()
+  void IsSelectedPairBlock(PairBlock& block, LeptonColumns const& c1, LeptonColumns const& c2, const float bz, const float refR) const
   {
-    if (!track.hasITS()) {
-      return false;
-    }
-
-    if (!dont_require_pteta) {
-      if (!IsSelectedTrack(track, DielectronCuts::kTrackPtRange)) {
-        return false;
+    for (int ip = 0; ip < block.n; ip++) {
+      block.selected[ip] = false;
+      const float mee = block.mass[ip];
+      const float phiv = block.phiv[ip];
+      if (mee < mMinMee || mMaxMee < mee) {
+        continue;
       }
-      if (!IsSelectedTrack(track, DielectronCuts::kTrackEtaRange)) {
-        return false;
+      if (block.pt[ip] < mMinPairPt || mMaxPairPt < block.pt[ip]) {
+        continue;
+      }
+      if (block.rapidity[ip] < mMinPairY || mMaxPairY < block.rapidity[ip]) {
+        continue;
       }
+      if (mApplyPhiV && (((mMinPhivPair < phiv && phiv < mMaxPhivPair) && mee < mMaxMeePhiVDep(phiv)) ^ mSelectPC)) {
+        continue;
+      }
+      if (block.dca3D[ip] < mMinPairDCA3D || mMaxPairDCA3D < block.dca3D[ip]) { // in sigma for pair
+        continue;
+      }
+      if (block.opAng[ip] < mMinOpAng || mMaxOpAng < block.opAng[ip]) {
+        continue;
+      }
+      const int j1 = block.i1[ip];
+      const int j2 = block.i2[ip];
+      if (mRequireDiffSides && c1.eta[j1] * c2.eta[j2] > 0.0) {
+        continue;
+      }
+      if (mApplydEtadPhi && mApplydEtadPhiPosition) { // applying both cuts is not allowed.
+        continue;
+      }
+      const float deta = block.deta[ip];
+      if (mApplydEtadPhi && std::pow(deta / mMinDeltaEta, 2) + std::pow(block.dphi[ip] / mMinDeltaPhi, 2) < 1.f) {
+        continue;
+      }
+      if (mApplydEtadPhiPosition) {
+        float phiPosition1 = c1.phi[j1] + std::asin(c1.sign[j1] * 0.30282 * (bz * 0.1) * refR / (2.f * c1.pt[j1]));
+        float phiPosition2 = c2.phi[j2] + std::asin(c2.sign[j2] * 0.30282 * (bz * 0.1) * refR / (2.f * c2.pt[j2]));
+        phiPosition1 = RecoDecay::constrainAngle(phiPosition1, 0, 1); // 0-2pi
+        phiPosition2 = RecoDecay::constrainAngle(phiPosition2, 0, 1); // 0-2pi
+        float dphiPosition = phiPosition1 - phiPosition2;
+        o2::math_utils::bringToPMPi(dphiPosition);
+        if (std::pow(deta / mMinDeltaEta, 2) + std::pow(dphiPosition / mMinDeltaPhi, 2) < 1.f) {
+          continue;
+        }
+      }
+      block.selected[ip] = true;
     }
+  }
 
-    if (!IsSelectedTrack(track, DielectronCuts::kTrackPhiRange)) {
-      return false;
-    }
-    if (!IsSelectedTrack(track, DielectronCuts::kTrackPhiPositionRange)) {
-      return false;
-    }
-    if (!IsSelectedTrack(track, DielectronCuts::kDCA3Dsigma)) {
-      return false;
-    }
-    if (!IsSelectedTrack(track, DielectronCuts::kDCAxy)) {
-      return false;
-    }
-    if (!IsSelectedTrack(track, DielectronCuts::kDCAz)) {
-      return false;
-    }
+  template <bool dont_require_pteta = false, typename TTrack>
+  bool IsSelectedTrack(TTrack const& track) const
+  {
+    if (!mUseTrackCache) {
+      return IsSelectedTrackUncached<dont_require_pteta>(track);
+    }
+    // the pair loops evaluate the same track once per pair
+    constexpr uint8_t kEvaluated = dont_require_pteta ? 4 : 1;
+    constexpr uint8_t kSelected = dont_require_pteta ? 8 : 2;
+    const int64_t index = track.globalIndex();
+    if (index >= static_cast<int64_t>(mTrackCache.size())) {
+      mTrackCache.resize(index + 1, 0);
+    }
+    if (mTrackCache[index] & kEvaluated) {
+      return mTrackCache[index] & kSelected;
+    }
+    bool selected = IsSelectedTrackUncached<dont_require_pteta>(track);
+    mTrackCache[index] |= selected ? (kEvaluated | kSelected) : kEvaluated;
+    return selected;
+  }
 
-    // ITS cuts
-    if (!IsSelectedTrack(track, DielectronCuts::kITSNCls)) {
+  template <bool dont_require_pteta = false, typename TTrack>
+  bool IsSelectedTrackUncached(TTrack const& track) const
+  {
+    if (!track.hasITS()) {
       return false;
     }
-    if (!IsSelectedTrack(track, DielectronCuts::kITSChi2NDF)) {
-      return false;
+
+    if (!mTrackCutSequenceBuilt) {
+      BuildTrackCutSequence();
     }
 
-    if (!IsSelectedTrack(track, DielectronCuts::kITSClusterSize)) {
-      return false;
+    // enabled single-track cuts, in the order of their rejection power per unit cost
+    if (mNCalibrationTracks > 0) {
+      // calibration: all the cuts are evaluated to measure the rejection power of each of them
+      bool selected = true;
+      for (const auto& cut : mTrackCutSequence) {
+        if (SkipTrackCut<dont_require_pteta>(track, cut)) {
+          continue;
+        }
+        mNTracksEvaluated[static_cast<int>(cut)]++;
+        if (!IsSelectedTrack(track, cut)) {
+          mNTracksRejected[static_cast<int>(cut)]++;
+          selected = false;
+        }
+      }
+      if (--mNCalibrationTracks == 0) {
+        OrderTrackCutSequence();
+      }
+      if (!selected) {
+        return false;
+      }
+    } else {
+      for (const auto& cut : mTrackCutSequence) {
+        if (SkipTrackCut<dont_require_pteta>(track, cut)) {
+          continue;
+        }
+        if (!IsSelectedTrack(track, cut)) {
+          return false;
+        }
+      }
     }
 
     if (mRequireITSibAny) {
@@ -233,32 +307,6 @@ class DielectronCut : public TNamed
       return false;
     }
 
-    // TPC cuts
-    if (track.hasTPC()) {
-      if (!IsSelectedTrack(track, DielectronCuts::kTPCNCls)) {
-        return false;
-      }
-      if (!IsSelectedTrack(track, DielectronCuts::kTPCCrossedRows)) {
-        return false;
-      }
-      if (!IsSelectedTrack(track, DielectronCuts::kTPCCrossedRowsOverNCls)) {
-        return false;
-      }
-      if (!IsSelectedTrack(track, DielectronCuts::kTPCFracSharedClusters)) {
-        return false;
-      }
-      if (!IsSelectedTrack(track, DielectronCuts::kRelDiffPin)) {
-        return false;
-      }
-      if (!IsSelectedTrack(track, DielectronCuts::kTPCChi2NDF)) {
-        return false;
-      }
-    }
-
-    if (mApplyPF && !IsSelectedTrack(track, DielectronCuts::kPrefilter)) {
-      return false;
-    }
-
     // PID cuts
     if (!PassPID(track)) {
       return false;
@@ -267,6 +315,15 @@ class DielectronCut : public TNamed
     return true;
   }
 
+  template <bool dont_require_pteta, typename TTrack>
+  bool SkipTrackCut(TTrack const& track, const DielectronCuts& cut) const
+  {
+    if (dont_require_pteta && (cut == DielectronCuts::kTrackPtRange || cut == DielectronCuts::kTrackEtaRange)) {
+      return true;
+    }
+    return IsTPCTrackCut(cut) && !track.hasTPC(); // TPC cuts are applied only to tracks with TPC
+  }
+
   template <typename TTrack>
   bool PassPIDML(TTrack const& track) const
   {
@@ -540,6 +597,12 @@ class DielectronCut : public TNamed
   void ApplyPhiV(bool flag);
   void IncludeITSsa(bool flag, float maxpt);
 
+  // Evaluation of the single-track cuts
+  void EnableTrackCache(bool flag);
+  void ClearTrackCache() const { mTrackCache.clear(); } // to be called when the track table changes, e.g. per data frame
+  void CalibrateTrackCutOrder(int nTracks);             // the cut order is learned from the next nTracks tracks
+  static bool IsTPCTrackCut(const DielectronCuts& cut) { return cut >= DielectronCuts::kTPCNCls && cut <= DielectronCuts::kTPCChi2NDF; }
+
   void SetPIDMlResponse(o2::analysis::MlResponseDielectronSingleTrack<float>* mlResponse)
   {
     mPIDMlResponse = mlResponse;
@@ -642,6 +705,18 @@ class DielectronCut : public TNamed
   std::vector<float> mMLBins{}; // binning for a feature variable. e.g. tpcInnerParam
   std::vector<float> mMLCuts{}; // threshold for each bin. mMLCuts.size() must be mMLBins.size()-1.
 
+  // compiled single-track cuts, rebuilt when a setter changes a track cut
+  bool IsTrackCutEnabled(const DielectronCuts& cut) const;
+  void BuildTrackCutSequence() const;
+  void OrderTrackCutSequence() const;
+  mutable bool mTrackCutSequenceBuilt{false};                                                //! flag that mTrackCutSequence is up to date
+  mutable std::vector<DielectronCuts> mTrackCutSequence{};                                   //! enabled track cuts in the order of evaluation
+  mutable int mNCalibrationTracks{0};                                                        //! number of tracks left to calibrate the cut order
+  mutable std::array<int64_t, static_cast<int>(DielectronCuts::kNCuts)> mNTracksEvaluated{}; //! tracks evaluated per cut during the calibration
+  mutable std::array<int64_t, static_cast<int>(DielectronCuts::kNCuts)> mNTracksRejected{};  //! tracks rejected per cut during the calibration
+  bool mUseTrackCache{false};                                                                //! flag to cache the selection per track
+  mutable std::vector<uint8_t> mTrackCache{};                                                //! selection per track global index, with and without the pt and eta cuts
+
   ClassDef(DielectronCut, 1);
 };
 
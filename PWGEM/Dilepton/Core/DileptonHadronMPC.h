@@ -28,6 +28,7 @@
 #include "PWGEM/Dilepton/Utils/EventHistograms.h"
 #include "PWGEM/Dilepton/Utils/EventMixingHandler.h"
 #include "PWGEM/Dilepton/Utils/MlResponseDielectronSingleTrack.h"
+#include "PWGEM/Dilepton/Utils/PairKernel.h"
 #include "PWGEM/Dilepton/Utils/PairUtilities.h"
 
 #include "Common/CCDB/RCTSelectionFlags.h"
@@ -126,6 +127,8 @@ struct DileptonHadronMPC {
   Configurable<int> cfgNbinsDPhi{"cfgNbinsDPhi", 36, "nbins in dphi for output histograms"};
   Configurable<int> cfgNbinsCosNDPhi{"cfgNbinsCosNDPhi", 200, "nbins in cos(n(dphi)) for output histograms"};
   Configurable<int> cfgNmod{"cfgNmod", 2, "n-th harmonics"};
+  Configurable<int> cfgNbinsEtaHadronGrid{"cfgNbinsEtaHadronGrid", 0, "nbins in eta of ref. track grid for dilepton-hadron correlation. 0 correlates with each ref. track"};
+  Configurable<int> cfgNbinsPhiHadronGrid{"cfgNbinsPhiHadronGrid", 72, "nbins in phi of ref. track grid for dilepton-hadron correlation"};
 
   EMEventCut fEMEventCut;
   struct : ConfigurableGroup {
@@ -277,6 +280,7 @@ struct DileptonHadronMPC {
   } dimuoncuts;
 
   EMTrackCut fEMTrackCut;
+  o2::aod::pwgem::dilepton::utils::pairutil::HadronGrid hadronGrid; // selected ref. tracks per collision
   struct : ConfigurableGroup {
     std::string prefix = "trackcut_group";
     Configurable<float> cfg_min_pt_track{"cfg_min_pt_track", 0.2, "min pT for ref. track"};
@@ -387,6 +391,7 @@ struct DileptonHadronMPC {
 
     DefineEMEventCut();
     DefineEMTrackCut();
+    hadronGrid.setGrid(cfgNbinsEtaHadronGrid, cfgNbinsPhiHadronGrid, trackcuts.cfg_min_eta_track, trackcuts.cfg_max_eta_track);
     addhistograms();
     if constexpr (pairtype == o2::aod::pwgem::dilepton::utils::pairutil::DileptonPairType::kDielectron) {
       DefineDielectronCut();
@@ -828,52 +833,10 @@ struct DileptonHadronMPC {
     return true;
   }
 
-  template <int ev_id, typename TTrack1, typename TTrack2, typename TCut, typename TAllTracks, typename TRefTrack>
-  bool fillDileptonHadron(TTrack1 const& t1, TTrack2 const& t2, TCut const& cut, TAllTracks const& tracks, TRefTrack const& t3)
+  template <int ev_id, typename TTrack1, typename TTrack2>
+  void fillDileptonHadrons(TTrack1 const& t1, TTrack2 const& t2)
   {
-    // this function must be called, if dilepton passes the cut.
-
-    if constexpr (ev_id == 0) {
-      if constexpr (pairtype == o2::aod::pwgem::dilepton::utils::pairutil::DileptonPairType::kDielectron) {
-        if (dielectroncuts.cfg_pid_scheme == static_cast<int>(DielectronCut::PIDSchemes::kPIDML)) {
-          if (!cut.template IsSelectedTrack<false>(t1) || !cut.template IsSelectedTrack<false>(t2)) {
-            return false;
-          }
-        } else { // cut-based
-          if (!cut.template IsSelectedTrack<false>(t1) || !cut.template IsSelectedTrack<false>(t2)) {
-            return false;
-          }
-        }
-        if (t1.trackId() == t3.trackId() || t2.trackId() == t3.trackId()) {
-          return false;
-        }
-      } else if constexpr (pairtype == o2::aod::pwgem::dilepton::utils::pairutil::DileptonPairType::kDimuon) {
-        if (!cut.template IsSelectedTrack<false>(t1) || !cut.template IsSelectedTrack<false>(t2)) {
-          return false;
-        }
-
-        if (!o2::aod::pwgem::dilepton::utils::emtrackutil::isBestMatch(t1, cut, tracks)) {
-          return false;
-        }
-        if (!o2::aod::pwgem::dilepton::utils::emtrackutil::isBestMatch(t2, cut, tracks)) {
-          return false;
-        }
-      }
-
-      if (!fEMTrackCut.IsSelected(t3)) { // for charged track
-        return false;
-      }
-    }
-
-    if constexpr (pairtype == o2::aod::pwgem::dilepton::utils::pairutil::DileptonPairType::kDielectron) {
-      if (!cut.IsSelectedPair(t1, t2, d_bz, dielectroncuts.cfgRefR)) {
-        return false;
-      }
-    } else if constexpr (pairtype == o2::aod::pwgem::dilepton::utils::pairutil::DileptonPairType::kDimuon) {
-      if (!cut.IsSelectedPair(t1, t2)) {
-        return false;
-      }
-    }
+    // this function must be called, if dilepton passes the cut. hadronGrid must contain selected ref. tracks in this collision.
 
     float weight = 1.f;
     if (cfgApplyWeightTTCA) {
@@ -887,10 +850,6 @@ struct DileptonHadronMPC {
     ROOT::Math::PtEtaPhiMVector v2(t2.pt(), t2.eta(), t2.phi(), leptonM2);
     ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
 
-    ROOT::Math::PtEtaPhiMVector v3(t3.pt(), t3.eta(), t3.phi(), 0.139); // mass of hadron does not matter.
-    float deta = v12.Eta() - v3.Eta();
-    float dphi = v12.Phi() - v3.Phi();
-
     float pair_dca = 999.f;
     if constexpr (pairtype == o2::aod::pwgem::dilepton::utils::pairutil::DileptonPairType::kDielectron) {
       pair_dca = pairDCAQuadSum(dca3DinSigma(t1), dca3DinSigma(t2));
@@ -903,28 +862,68 @@ struct DileptonHadronMPC {
       pair_dca = pairDCAQuadSum(fwdDcaXYinSigma(t1), fwdDcaXYinSigma(t2));
     }
 
+    const float mass = v12.M(), pt = v12.Pt(), rapidity = v12.Rapidity(), eta = v12.Eta(), phi = v12.Phi();
+    const int sign = t1.sign() * t2.sign() < 0 ? 0 : (t1.sign() > 0 ? 1 : -1);
+
+    // legs of dielectron should not be correlated with themselves.
+    int leg1 = -1, leg2 = -1;
+    if constexpr (pairtype == o2::aod::pwgem::dilepton::utils::pairutil::DileptonPairType::kDielectron) {
+      leg1 = hadronGrid.findTrack(t1.trackId());
+      leg2 = hadronGrid.findTrack(t2.trackId());
+    }
+
+    if (!hadronGrid.useGrid()) {
+      for (int i = 0; i < hadronGrid.size(); i++) {
+        if (i == leg1 || i == leg2) {
+          continue;
+        }
+        fillDileptonHadronHistograms<ev_id>(sign, mass, pt, pair_dca, rapidity, eta - hadronGrid.eta[i], phi - hadronGrid.phi[i], weight);
+      }
+      return;
+    }
+
+    // ref. tracks are counted per cell in the grid. The correlation is filled once per occupied cell with the number of ref. tracks as weight.
+    for (const auto& leg : {leg1, leg2}) {
+      if (leg >= 0) {
+        hadronGrid.counts[hadronGrid.cell[leg]] -= 1.f;
+      }
+    }
+    for (const auto& c : hadronGrid.occupied) {
+      if (hadronGrid.counts[c] < 0.5f) {
+        continue;
+      }
+      fillDileptonHadronHistograms<ev_id>(sign, mass, pt, pair_dca, rapidity, eta - hadronGrid.etaCenter(c), phi - hadronGrid.phiCenter(c), weight * hadronGrid.counts[c]);
+    }
+    for (const auto& leg : {leg1, leg2}) {
+      if (leg >= 0) {
+        hadronGrid.counts[hadronGrid.cell[leg]] += 1.f;
+      }
+    }
+  }
+
+  template <int ev_id>
+  void fillDileptonHadronHistograms(const int sign, const float mass, const float pt, const float pair_dca, const float rapidity, const float deta, float dphi, const float weight)
+  {
     if (cfgAnalysisType == static_cast<int>(o2::aod::pwgem::dilepton::utils::pairutil::DileptonHadronAnalysisType::kAzimuthalCorrelation)) {
       dphi = RecoDecay::constrainAngle(dphi, -M_PI / 2, 1U);
-      if (t1.sign() * t2.sign() < 0) { // ULS
-        fRegistry.fill(HIST("DileptonHadron/") + HIST(event_pair_types[ev_id]) + HIST("uls/hs"), v12.M(), v12.Pt(), pair_dca, v12.Rapidity(), deta, dphi, weight);
-      } else if (t1.sign() > 0 && t2.sign() > 0) { // LS++
-        fRegistry.fill(HIST("DileptonHadron/") + HIST(event_pair_types[ev_id]) + HIST("lspp/hs"), v12.M(), v12.Pt(), pair_dca, v12.Rapidity(), deta, dphi, weight);
-      } else if (t1.sign() < 0 && t2.sign() < 0) { // LS--
-        fRegistry.fill(HIST("DileptonHadron/") + HIST(event_pair_types[ev_id]) + HIST("lsmm/hs"), v12.M(), v12.Pt(), pair_dca, v12.Rapidity(), deta, dphi, weight);
+      if (sign == 0) { // ULS
+        fRegistry.fill(HIST("DileptonHadron/") + HIST(event_pair_types[ev_id]) + HIST("uls/hs"), mass, pt, pair_dca, rapidity, deta, dphi, weight);
+      } else if (sign > 0) { // LS++
+        fRegistry.fill(HIST("DileptonHadron/") + HIST(event_pair_types[ev_id]) + HIST("lspp/hs"), mass, pt, pair_dca, rapidity, deta, dphi, weight);
+      } else { // LS--
+        fRegistry.fill(HIST("DileptonHadron/") + HIST(event_pair_types[ev_id]) + HIST("lsmm/hs"), mass, pt, pair_dca, rapidity, deta, dphi, weight);
       }
     } else if (cfgAnalysisType == static_cast<int>(o2::aod::pwgem::dilepton::utils::pairutil::DileptonHadronAnalysisType::kCumulant)) {
       o2::math_utils::bringTo02Pi(dphi);
       float cosndphi = std::cos(cfgNmod * dphi);
-      if (t1.sign() * t2.sign() < 0) { // ULS
-        fRegistry.fill(HIST("DileptonHadron/") + HIST(event_pair_types[ev_id]) + HIST("uls/hs"), v12.M(), v12.Pt(), pair_dca, v12.Rapidity(), deta, cosndphi, weight);
-      } else if (t1.sign() > 0 && t2.sign() > 0) { // LS++
-        fRegistry.fill(HIST("DileptonHadron/") + HIST(event_pair_types[ev_id]) + HIST("lspp/hs"), v12.M(), v12.Pt(), pair_dca, v12.Rapidity(), deta, cosndphi, weight);
-      } else if (t1.sign() < 0 && t2.sign() < 0) { // LS--
-        fRegistry.fill(HIST("DileptonHadron/") + HIST(event_pair_types[ev_id]) + HIST("lsmm/hs"), v12.M(), v12.Pt(), pair_dca, v12.Rapidity(), deta, cosndphi, weight);
+      if (sign == 0) { // ULS
+        fRegistry.fill(HIST("DileptonHadron/") + HIST(event_pair_types[ev_id]) + HIST("uls/hs"), mass, pt, pair_dca, rapidity, deta, cosndphi, weight);
+      } else if (sign > 0) { // LS++
+        fRegistry.fill(HIST("DileptonHadron/") + HIST(event_pair_types[ev_id]) + HIST("lspp/hs"), mass, pt, pair_dca, rapidity, deta, cosndphi, weight);
+      } else { // LS--
+        fRegistry.fill(HIST("DileptonHadron/") + HIST(event_pair_types[ev_id]) + HIST("lsmm/hs"), mass, pt, pair_dca, rapidity, deta, cosndphi, weight);
       }
     }
-
-    return true;
   }
 
   template <int ev_id, typename TRefTrack, typename TLeptons, typename TLeptonCut>
@@ -1073,32 +1072,33 @@ struct DileptonHadronMPC {
       auto negTracks_per_coll = negTracks.sliceByCached(perCollision, collision.globalIndex(), cache);
       used_trackIds_per_col.reserve(posTracks_per_coll.size() + negTracks_per_coll.size());
 
+      hadronGrid.clear();
+      for (const auto& refTrack : refTracks_per_coll) {
+        if (fEMTrackCut.IsSelected(refTrack)) {
+          hadronGrid.add(refTrack.trackId(), refTrack.eta(), RecoDecay::constrainAngle(refTrack.phi()));
+        }
+      }
+
       int nuls = 0, nlspp = 0, nlsmm = 0;
       for (const auto& [pos, neg] : combinations(CombinationsFullIndexPolicy(posTracks_per_coll, negTracks_per_coll))) { // ULS
         bool is_pair_ok = fillDilepton<0>(collision, pos, neg, cut, tracks);
         if (is_pair_ok) {
           nuls++;
-          for (const auto& refTrack : refTracks_per_coll) {
-            fillDileptonHadron<0>(pos, neg, cut, tracks, refTrack);
-          }
+          fillDileptonHadrons<0>(pos, neg);
         }
       }
       for (const auto& [pos1, pos2] : combinations(CombinationsStrictlyUpperIndexPolicy(posTracks_per_coll, posTracks_per_coll))) { // LS++
         bool is_pair_ok = fillDilepton<0>(collision, pos1, pos2, cut, tracks);
         if (is_pair_ok) {
           nlspp++;
-          for (const auto& refTrack : refTracks_per_coll) {
-            fillDileptonHadron<0>(pos1, pos2, cut, tracks, refTrack);
-          }
+          fillDileptonHadrons<0>(pos1, pos2);
         }
       }
       for (const auto& [neg1, neg2] : combinations(CombinationsStrictlyUpperIndexPolicy(negTracks_per_coll, negTracks_per_coll))) { // LS--
         bool is_pair_ok = fillDilepton<0>(collision, neg1, neg2, cut, tracks);
         if (is_pair_ok) {
           nlsmm++;
-          for (const auto& refTrack : refTracks_per_coll) {
-            fillDileptonHadron<0>(neg1, neg2, cut, tracks, refTrack);
-          }
+          fillDileptonHadrons<0>(neg1, neg2);
         }
       }
       used_trackIds_per_col.clear();
@@ -120,3 +120,9 @@ void EMEventCut::SetRequireGoodITSLayersAll(bool flag)
   mRequireGoodITSLayersAll = flag;
   LOG(info) << "EM Event Cut, require GoodITSLayersAll: " << mRequireGoodITSLayersAll;
 }
+
+void EMEventCut::SetEventCutBit(int bit)
+{
+  mEventCutBit = bit;
+  LOG(info) << "EM Event Cut, use event cut bit: " << mEventCutBit;
+}
@@ -54,6 +54,11 @@ class EMEventCut : public TNamed
   template <typename T>
   bool IsSelected(T const& collision) const
   {
+    if constexpr (requires { collision.eventCutBits(); }) {
+      if (mEventCutBit >= 0) { // already evaluated once per collision in emEventCutBits.cxx
+        return collision.eventCutBits_bit(mEventCutBit);
+      }
+    }
     if (mRequireSel8 && !IsSelected(collision, EMEventCuts::kSel8)) {
       return false;
     }
@@ -186,6 +191,7 @@ class EMEventCut : public TNamed
   void SetRequireGoodITSLayer3(bool flag);
   void SetRequireGoodITSLayer0123(bool flag);
   void SetRequireGoodITSLayersAll(bool flag);
+  void SetEventCutBit(int bit);
 
  private:
   bool mRequireSel8{false};
@@ -205,6 +211,7 @@ class EMEventCut : public TNamed
   bool mRequireGoodITSLayer3{false};
   bool mRequireGoodITSLayer0123{false};
   bool mRequireGoodITSLayersAll{false};
+  int mEventCutBit{-1}; // bit in EMEventCutBits to be used instead of the cuts above. -1 evaluates the cuts above.
 
   ClassDef(EMEventCut, 1);
 };
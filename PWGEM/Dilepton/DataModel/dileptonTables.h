@@ -75,6 +75,7 @@ namespace emevent
 DECLARE_SOA_COLUMN(CollisionId, collisionId, int);
 DECLARE_SOA_BITMAP_COLUMN(SWTAliasTmp, swtaliastmp, 16);             //! Bitmask of fired trigger aliases (see above for definitions) to be join to aod::Collisions for skimming
 DECLARE_SOA_BITMAP_COLUMN(SWTAlias, swtalias, 16);                   //! Bitmask of fired trigger aliases (see above for definitions) to be join to aod::EMEvents for analysis
+DECLARE_SOA_BITMAP_COLUMN(EventCutBits, eventCutBits, 16);           //! Bitmask of passed event cut variants in emEventCutBits.cxx to be join to aod::EMEvents for analysis
 DECLARE_SOA_COLUMN(NInspectedTVX, nInspectedTVX, uint64_t);          //! the number of inspected TVX bcs per run
 DECLARE_SOA_COLUMN(NScalars, nScalers, std::vector<uint64_t>);       //! the number of triggered bcs before down scaling per run
 DECLARE_SOA_COLUMN(NSelections, nSelections, std::vector<uint64_t>); //! the number of triggered bcs after down scaling per run
@@ -286,6 +287,9 @@ using EMEventProperty = EMEventsProperty::iterator;
 DECLARE_SOA_TABLE(EMEventsNee, "AOD", "EMEVENTNEE", emevent::NeeULS, emevent::NeeLSpp, emevent::NeeLSmm); // joinable to EMEvents or aod::Collisions
 using EMEventNee = EMEventsNee::iterator;
 
+DECLARE_SOA_TABLE(EMEventCutBits, "AOD", "EMEVENTCUTBIT", emevent::EventCutBits); //! joinable to EMEvents
+using EMEventCutBit = EMEventCutBits::iterator;
+
 DECLARE_SOA_TABLE(EMEvSels, "AOD", "EMEVSEL", //! joinable to aod::Collisions
                   emevent::IsSelected);
 using EMEvSel = EMEvSels::iterator;
@@ -26,6 +26,7 @@
 #include "ReconstructionDataFormats/Track.h"
 
 #include <iostream>
+#include <cstdint>
 #include <map>
 #include <random>
 #include <vector>
@@ -139,24 +140,68 @@ struct AssociateMCInfoDilepton {
   Partition<aod::McParticles> mcmuons = nabs(o2::aod::mcparticle::pdgCode) == 13 && min_eta_gen_primary_fwd < o2::aod::mcparticle::eta && o2::aod::mcparticle::eta < max_eta_gen_primary_fwd;
   Partition<aod::McParticles> mcvectormesons = o2::aod::mcparticle::pdgCode == 223 || o2::aod::mcparticle::pdgCode == 333;
 
+  // skimmed MC stack of the current data frame
+  std::vector<int> fNewLabels;               // new label of each particle in aod::McParticles, -1 if not stored
+  std::vector<uint8_t> fIsMotherChainStored; // the whole first-mother chain of this particle is stored
+  std::vector<int64_t> fNewLabelsReversed;   // index in aod::McParticles of each new label
+  std::vector<int> fEventIdx;                // index of the MC event of each new label
+
+  // if the MC truth particle is not already written, add it to the skimmed MC stack
+  void storeParticle(const int64_t globalIndex, const int eventIdx)
+  {
+    if (fNewLabels[globalIndex] < 0) {
+      fNewLabels[globalIndex] = static_cast<int>(fNewLabelsReversed.size());
+      fNewLabelsReversed.emplace_back(globalIndex);
+      fEventIdx.emplace_back(eventIdx);
+    }
+  }
+
+  // add the first-mother chain of a stored particle to the skimmed MC stack.
+  // The walk stops at the first mother whose chain is already stored, such that each chain is walked once per data frame.
+  template <typename TMCParticle, typename TMCParticles>
+  void storeMotherChain(TMCParticle const& mctrack, TMCParticles const& mcTracks, const int eventIdx)
+  {
+    if (fIsMotherChainStored[mctrack.globalIndex()]) {
+      return;
+    }
+    fIsMotherChainStored[mctrack.globalIndex()] = 1;
+    int motherid = -999; // first mother index
+    if (mctrack.has_mothers()) {
+      motherid = mctrack.mothersIds()[0]; // first mother index
+    }
+    while (motherid > -1 && motherid < mcTracks.size()) { // protect against bad mother indices
+      if (fIsMotherChainStored[motherid]) {
+        break;
+      }
+      storeParticle(motherid, eventIdx);
+      fIsMotherChainStored[motherid] = 1;
+      auto mp = mcTracks.iteratorAt(motherid);
+      if (mp.has_mothers()) {
+        motherid = mp.mothersIds()[0]; // first mother index
+      } else {
+        motherid = -999;
+      }
+    }
+  }
+
   template <uint8_t system, typename TTracks, typename TFwdTracks, typename TMFTTracks, typename TPCMs, typename TPCMLegs, typename TEMPrimaryElectrons, typename TEMPrimaryMuons>
   void skimmingMC(MyCollisionsMC const& collisions, aod::BCs const&, aod::McCollisions const& mcCollisions, aod::McParticles const& mcTracks, TTracks const& o2tracks, TFwdTracks const& o2fwdtracks, TMFTTracks const&, TPCMs const& v0photons, TPCMLegs const&, TEMPrimaryElectrons const& emprimaryelectrons, TEMPrimaryMuons const& emprimarymuons)
   {
     // temporary variables used for the indexing of the skimmed MC stack
-    std::map<uint64_t, int> fNewLabels;
-    std::map<uint64_t, int> fNewLabelsReversed;
-    // std::map<uint64_t, uint16_t> fMCFlags;
-    std::map<uint64_t, int> fEventIdx;
+    fNewLabels.assign(mcTracks.size(), -1);
+    fIsMotherChainStored.assign(mcTracks.size(), 0);
+    fNewLabelsReversed.clear();
+    fEventIdx.clear();
     std::map<uint64_t, int> fEventLabels;
-    int fCounters[2] = {0, 0}; //! [0] - particle counter, [1] - event counter
+    int fEventCounter = 0; //! event counter
 
     // first, run loop over mc collisions to create map between aod::McCollisions and aod::EMMCEvents
     for (const auto& mcCollision : mcCollisions) {
       // make an entry for this MC event only if it was not already added to the table
       if (!(fEventLabels.find(mcCollision.globalIndex()) != fEventLabels.end())) {
         mcevents(mcCollision.globalIndex(), mcCollision.generatorsID(), mcCollision.posX(), mcCollision.posY(), mcCollision.posZ(), mcCollision.impactParameter(), mcCollision.eventPlaneAngle());
-        fEventLabels[mcCollision.globalIndex()] = fCounters[1];
-        fCounters[1]++;
+        fEventLabels[mcCollision.globalIndex()] = fEventCounter;
+        fEventCounter++;
       }
     } // end of mc collision loop
 
@@ -203,40 +248,9 @@ struct AssociateMCInfoDilepton {
         int ndau_tmp = mp_tmp.daughtersIds()[1] - mp_tmp.daughtersIds()[0] + 1;
         if (ndau_tmp < 10) {
 
-          if (!(fNewLabels.find(mctrack.globalIndex()) != fNewLabels.end())) {
-            fNewLabels[mctrack.globalIndex()] = fCounters[0];
-            fNewLabelsReversed[fCounters[0]] = mctrack.globalIndex();
-            // fMCFlags[mctrack.globalIndex()] = mcflags;
-            fEventIdx[mctrack.globalIndex()] = fEventLabels.find(mcCollision.globalIndex())->second;
-            fCounters[0]++;
-          }
-
-          int motherid = -999; // first mother index
-          if (mctrack.has_mothers()) {
-            motherid = mctrack.mothersIds()[0]; // first mother index
-          }
-          while (motherid > -1) {
-            if (motherid < mcTracks.size()) { // protect against bad mother indices. why is this needed?
-              auto mp = mcTracks.iteratorAt(motherid);
-
-              // if the MC truth particle corresponding to this reconstructed track which is not already written, add it to the skimmed MC stack
-              if (!(fNewLabels.find(mp.globalIndex()) != fNewLabels.end())) {
-                fNewLabels[mp.globalIndex()] = fCounters[0];
-                fNewLabelsReversed[fCounters[0]] = mp.globalIndex();
-                // fMCFlags[mp.globalIndex()] = mcflags;
-                fEventIdx[mp.globalIndex()] = fEventLabels.find(mcCollision.globalIndex())->second;
-                fCounters[0]++;
-              }
+          storeParticle(mctrack.globalIndex(), fEventLabels.find(mcCollision.globalIndex())->second);
 
-              if (mp.has_mothers()) {
-                motherid = mp.mothersIds()[0]; // first mother index
-              } else {
-                motherid = -999;
-              }
-            } else {
-              motherid = -999;
-            }
-          } // end of mother chain loop
+          storeMotherChain(mctrack, mcTracks, fEventLabels.find(mcCollision.globalIndex())->second);
         } // end of ndau protection
       } // end of mc electron loop
 
@@ -255,40 +269,9 @@ struct AssociateMCInfoDilepton {
         int ndau_tmp = mp_tmp.daughtersIds()[1] - mp_tmp.daughtersIds()[0] + 1;
         if (ndau_tmp < 10) {
 
-          if (!(fNewLabels.find(mctrack.globalIndex()) != fNewLabels.end())) {
-            fNewLabels[mctrack.globalIndex()] = fCounters[0];
-            fNewLabelsReversed[fCounters[0]] = mctrack.globalIndex();
-            // fMCFlags[mctrack.globalIndex()] = mcflags;
-            fEventIdx[mctrack.globalIndex()] = fEventLabels.find(mcCollision.globalIndex())->second;
-            fCounters[0]++;
-          }
+          storeParticle(mctrack.globalIndex(), fEventLabels.find(mcCollision.globalIndex())->second);
 
-          int motherid = -999; // first mother index
-          if (mctrack.has_mothers()) {
-            motherid = mctrack.mothersIds()[0]; // first mother index
-          }
-          while (motherid > -1) {
-            if (motherid < mcTracks.size()) { // protect against bad mother indices. why is this needed?
-              auto mp = mcTracks.iteratorAt(motherid);
-
-              // if the MC truth particle corresponding to this reconstructed track which is not already written, add it to the skimmed MC stack
-              if (!(fNewLabels.find(mp.globalIndex()) != fNewLabels.end())) {
-                fNewLabels[mp.globalIndex()] = fCounters[0];
-                fNewLabelsReversed[fCounters[0]] = mp.globalIndex();
-                // fMCFlags[mp.globalIndex()] = mcflags;
-                fEventIdx[mp.globalIndex()] = fEventLabels.find(mcCollision.globalIndex())->second;
-                fCounters[0]++;
-              }
-
-              if (mp.has_mothers()) {
-                motherid = mp.mothersIds()[0]; // first mother index
-              } else {
-                motherid = -999;
-              }
-            } else {
-              motherid = -999;
-            }
-          } // end of mother chain loop
+          storeMotherChain(mctrack, mcTracks, fEventLabels.find(mcCollision.globalIndex())->second);
         } // end of ndau protection
       } // end of mc muon loop
 
@@ -308,13 +291,7 @@ struct AssociateMCInfoDilepton {
         int ndau = mctrack.daughtersIds()[1] - mctrack.daughtersIds()[0] + 1;
         if (ndau < 10) {
 
-          if (!(fNewLabels.find(mctrack.globalIndex()) != fNewLabels.end())) {
-            fNewLabels[mctrack.globalIndex()] = fCounters[0];
-            fNewLabelsReversed[fCounters[0]] = mctrack.globalIndex();
-            // fMCFlags[mctrack.globalIndex()] = mcflags;
-            fEventIdx[mctrack.globalIndex()] = fEventLabels.find(mcCollision.globalIndex())->second;
-            fCounters[0]++;
-          }
+          storeParticle(mctrack.globalIndex(), fEventLabels.find(mcCollision.globalIndex())->second);
 
           // store daughter of vector mesons
           if (mctrack.has_daughters()) {
@@ -340,13 +317,7 @@ struct AssociateMCInfoDilepton {
                 if (d < mcTracks.size()) { // protect against bad daughter indices
                   auto daughter = mcTracks.iteratorAt(d);
                   // if the MC truth particle corresponding to this reconstructed track which is not already written, add it to the skimmed MC stack
-                  if (!(fNewLabels.find(daughter.globalIndex()) != fNewLabels.end())) {
-                    fNewLabels[daughter.globalIndex()] = fCounters[0];
-                    fNewLabelsReversed[fCounters[0]] = daughter.globalIndex();
-                    // fMCFlags[daughter.globalIndex()] = mcflags;
-                    fEventIdx[daughter.globalIndex()] = fEventLabels.find(mcCollision.globalIndex())->second;
-                    fCounters[0]++;
-                  }
+                  storeParticle(daughter.globalIndex(), fEventLabels.find(mcCollision.globalIndex())->second);
                 } else {
                   std::cout << "Daughter label (" << d << ") exceeds the McParticles size (" << mcTracks.size() << ")" << std::endl;
                   std::cout << " Check the MC generator" << std::endl;
@@ -382,42 +353,11 @@ struct AssociateMCInfoDilepton {
           // LOGF(info, "mctrack.globalIndex() = %d, mctrack.index() = %d", mctrack.globalIndex(), mctrack.index()); // these are exactly the same.
 
           // if the MC truth particle corresponding to this reconstructed track which is not already written, add it to the skimmed MC stack
-          if (!(fNewLabels.find(mctrack.globalIndex()) != fNewLabels.end())) {
-            fNewLabels[mctrack.globalIndex()] = fCounters[0];
-            fNewLabelsReversed[fCounters[0]] = mctrack.globalIndex();
-            // fMCFlags[mctrack.globalIndex()] = mcflags;
-            fEventIdx[mctrack.globalIndex()] = fEventLabels.find(mctrack.mcCollisionId())->second;
-            fCounters[0]++;
-          }
-          v0legmclabels(fNewLabels.find(mctrack.index())->second, o2track.mcMask());
+          storeParticle(mctrack.globalIndex(), fEventLabels.find(mctrack.mcCollisionId())->second);
+          v0legmclabels(fNewLabels[mctrack.globalIndex()], o2track.mcMask());
 
           // Next, store mother-chain of this reconstructed track.
-          int motherid = -999; // first mother index
-          if (mctrack.has_mothers()) {
-            motherid = mctrack.mothersIds()[0]; // first mother index
-          }
-          while (motherid > -1) {
-            if (motherid < mcTracks.size()) { // protect against bad mother indices. why is this needed?
-              auto mp = mcTracks.iteratorAt(motherid);
-
-              // if the MC truth particle corresponding to this reconstructed track which is not already written, add it to the skimmed MC stack
-              if (!(fNewLabels.find(mp.globalIndex()) != fNewLabels.end())) {
-                fNewLabels[mp.globalIndex()] = fCounters[0];
-                fNewLabelsReversed[fCounters[0]] = mp.globalIndex();
-                // fMCFlags[mp.globalIndex()] = mcflags;
-                fEventIdx[mp.globalIndex()] = fEventLabels.find(mp.mcCollisionId())->second;
-                fCounters[0]++;
-              }
-
-              if (mp.has_mothers()) {
-                motherid = mp.mothersIds()[0]; // first mother index
-              } else {
-                motherid = -999;
-              }
-            } else {
-              motherid = -999;
-            }
-          } // end of mother chain loop
+          storeMotherChain(mctrack, mcTracks, fEventLabels.find(mctrack.mcCollisionId())->second);
         } // end of leg loop
       } // end of v0 loop
     }
@@ -437,42 +377,11 @@ struct AssociateMCInfoDilepton {
         auto mctrack = o2track.template mcParticle_as<aod::McParticles>();
 
         // if the MC truth particle corresponding to this reconstructed track which is not already written, add it to the skimmed MC stack
-        if (!(fNewLabels.find(mctrack.globalIndex()) != fNewLabels.end())) {
-          fNewLabels[mctrack.globalIndex()] = fCounters[0];
-          fNewLabelsReversed[fCounters[0]] = mctrack.globalIndex();
-          // fMCFlags[mctrack.globalIndex()] = mcflags;
-          fEventIdx[mctrack.globalIndex()] = fEventLabels.find(mctrack.mcCollisionId())->second;
-          fCounters[0]++;
-        }
-        emprimaryelectronmclabels(fNewLabels.find(mctrack.index())->second, o2track.mcMask());
+        storeParticle(mctrack.globalIndex(), fEventLabels.find(mctrack.mcCollisionId())->second);
+        emprimaryelectronmclabels(fNewLabels[mctrack.globalIndex()], o2track.mcMask());
 
         // Next, store mother-chain of this reconstructed track.
-        int motherid = -999; // first mother index
-        if (mctrack.has_mothers()) {
-          motherid = mctrack.mothersIds()[0]; // first mother index
-        }
-        while (motherid > -1) {
-          if (motherid < mcTracks.size()) { // protect against bad mother indices. why is this needed?
-            auto mp = mcTracks.iteratorAt(motherid);
-
-            // if the MC truth particle corresponding to this reconstructed track which is not already written, add it to the skimmed MC stack
-            if (!(fNewLabels.find(mp.globalIndex()) != fNewLabels.end())) {
-              fNewLabels[mp.globalIndex()] = fCounters[0];
-              fNewLabelsReversed[fCounters[0]] = mp.globalIndex();
-              // fMCFlags[mp.globalIndex()] = mcflags;
-              fEventIdx[mp.globalIndex()] = fEventLabels.find(mp.mcCollisionId())->second;
-              fCounters[0]++;
-            }
-
-            if (mp.has_mothers()) {
-              motherid = mp.mothersIds()[0]; // first mother index
-            } else {
-              motherid = -999;
-            }
-          } else {
-            motherid = -999;
-          }
-        } // end of mother chain loop
+        storeMotherChain(mctrack, mcTracks, fEventLabels.find(mctrack.mcCollisionId())->second);
 
       } // end of em primary electron loop
     }
@@ -492,42 +401,11 @@ struct AssociateMCInfoDilepton {
         auto mctrack = o2track.template mcParticle_as<aod::McParticles>();
 
         // if the MC truth particle corresponding to this reconstructed track which is not already written, add it to the skimmed MC stack
-        if (!(fNewLabels.find(mctrack.globalIndex()) != fNewLabels.end())) {
-          fNewLabels[mctrack.globalIndex()] = fCounters[0];
-          fNewLabelsReversed[fCounters[0]] = mctrack.globalIndex();
-          // fMCFlags[mctrack.globalIndex()] = mcflags;
-          fEventIdx[mctrack.globalIndex()] = fEventLabels.find(mctrack.mcCollisionId())->second;
-          fCounters[0]++;
-        }
-        emprimarymuonmclabels(fNewLabels.find(mctrack.index())->second, o2track.mcMask());
+        storeParticle(mctrack.globalIndex(), fEventLabels.find(mctrack.mcCollisionId())->second);
+        emprimarymuonmclabels(fNewLabels[mctrack.globalIndex()], o2track.mcMask());
 
         // Next, store mother-chain of this reconstructed track.
-        int motherid = -999; // first mother index
-        if (mctrack.has_mothers()) {
-          motherid = mctrack.mothersIds()[0]; // first mother index
-        }
-        while (motherid > -1) {
-          if (motherid < mcTracks.size()) { // protect against bad mother indices. why is this needed?
-            auto mp = mcTracks.iteratorAt(motherid);
-
-            // if the MC truth particle corresponding to this reconstructed track which is not already written, add it to the skimmed MC stack
-            if (!(fNewLabels.find(mp.globalIndex()) != fNewLabels.end())) {
-              fNewLabels[mp.globalIndex()] = fCounters[0];
-              fNewLabelsReversed[fCounters[0]] = mp.globalIndex();
-              // fMCFlags[mp.globalIndex()] = mcflags;
-              fEventIdx[mp.globalIndex()] = fEventLabels.find(mp.mcCollisionId())->second;
-              fCounters[0]++;
-            }
-
-            if (mp.has_mothers()) {
-              motherid = mp.mothersIds()[0]; // first mother index
-            } else {
-              motherid = -999;
-            }
-          } else {
-            motherid = -999;
-          }
-        } // end of mother chain loop
+        storeMotherChain(mctrack, mcTracks, fEventLabels.find(mctrack.mcCollisionId())->second);
 
         // mc label for tracks registered in MFT in global muons
         if (o2track.matchMFTTrackId() > -1) {
@@ -538,42 +416,11 @@ struct AssociateMCInfoDilepton {
           }
 
           auto mco2mfttrack = o2mfttrack.template mcParticle_as<aod::McParticles>();
-          if (!(fNewLabels.find(mco2mfttrack.globalIndex()) != fNewLabels.end())) {
-            fNewLabels[mco2mfttrack.globalIndex()] = fCounters[0];
-            fNewLabelsReversed[fCounters[0]] = mco2mfttrack.globalIndex();
-            // fMCFlags[mco2mfttrack.globalIndex()] = mcflags;
-            fEventIdx[mco2mfttrack.globalIndex()] = fEventLabels.find(mco2mfttrack.mcCollisionId())->second;
-            fCounters[0]++;
-          }
-          emmftmclabels(fNewLabels.find(mco2mfttrack.index())->second, o2track.mcMask());
+          storeParticle(mco2mfttrack.globalIndex(), fEventLabels.find(mco2mfttrack.mcCollisionId())->second);
+          emmftmclabels(fNewLabels[mco2mfttrack.globalIndex()], o2track.mcMask());
 
           // Next, store mother-chain of this reconstructed track.
-          int motherid = -999; // first mother index
-          if (mctrack.has_mothers()) {
-            motherid = mctrack.mothersIds()[0]; // first mother index
-          }
-          while (motherid > -1) {
-            if (motherid < mcTracks.size()) { // protect against bad mother indices. why is this needed?
-              auto mp = mcTracks.iteratorAt(motherid);
-
-              // if the MC truth particle corresponding to this reconstructed track which is not already written, add it to the skimmed MC stack
-              if (!(fNewLabels.find(mp.globalIndex()) != fNewLabels.end())) {
-                fNewLabels[mp.globalIndex()] = fCounters[0];
-                fNewLabelsReversed[fCounters[0]] = mp.globalIndex();
-                // fMCFlags[mp.globalIndex()] = mcflags;
-                fEventIdx[mp.globalIndex()] = fEventLabels.find(mp.mcCollisionId())->second;
-                fCounters[0]++;
-              }
-
-              if (mp.has_mothers()) {
-                motherid = mp.mothersIds()[0]; // first mother index
-              } else {
-                motherid = -999;
-              }
-            } else {
-              motherid = -999;
-            }
-          } // end of mother chain loop
+          storeMotherChain(mctrack, mcTracks, fEventLabels.find(mctrack.mcCollisionId())->second);
         } else {
           emmftmclabels(-1, 0);
         }
@@ -581,7 +428,7 @@ struct AssociateMCInfoDilepton {
     }
 
     //  Loop over the label map, create the mother/daughter relationships if these exist and write the skimmed MC stack
-    for (const auto& [newLabel, oldLabel] : fNewLabelsReversed) {
+    for (const auto& oldLabel : fNewLabelsReversed) {
       auto mctrack = mcTracks.iteratorAt(oldLabel);
       // uint16_t mcflags = fMCFlags.find(oldLabel)->second;
 
@@ -589,8 +436,8 @@ struct AssociateMCInfoDilepton {
       if (mctrack.has_mothers()) {
         for (const auto& m : mctrack.mothersIds()) {
           if (m < mcTracks.size()) { // protect against bad mother indices
-            if (fNewLabels.find(m) != fNewLabels.end()) {
-              mothers.push_back(fNewLabels.find(m)->second);
+            if (m > -1 && fNewLabels[m] > -1) {
+              mothers.push_back(fNewLabels[m]);
             }
           } else {
             std::cout << "Mother label (" << m << ") exceeds the McParticles size (" << mcTracks.size() << ")" << std::endl;
@@ -615,8 +462,8 @@ struct AssociateMCInfoDilepton {
             //   }
             // }
 
-            if (fNewLabels.find(d) != fNewLabels.end()) {
-              daughters.push_back(fNewLabels.find(d)->second);
+            if (fNewLabels[d] > -1) {
+              daughters.push_back(fNewLabels[d]);
             }
           } else {
             std::cout << "Daughter label (" << d << ") exceeds the McParticles size (" << mcTracks.size() << ")" << std::endl;
@@ -625,7 +472,7 @@ struct AssociateMCInfoDilepton {
         }
       }
 
-      emmcparticles(fEventIdx.find(oldLabel)->second, mctrack.pdgCode(), mctrack.flags(), mctrack.statusCode(),
+      emmcparticles(fEventIdx[fNewLabels[oldLabel]], mctrack.pdgCode(), mctrack.flags(), mctrack.statusCode(),
                     mothers, daughters,
                     mctrack.px(), mctrack.py(), mctrack.pz(), mctrack.e(),
                     mctrack.vx(), mctrack.vy(), mctrack.vz());
@@ -657,12 +504,11 @@ struct AssociateMCInfoDilepton {
     } // end of reconstructed collision loop
 
     fNewLabels.clear();
+    fIsMotherChainStored.clear();
     fNewLabelsReversed.clear();
-    // fMCFlags.clear();
     fEventIdx.clear();
     fEventLabels.clear();
-    fCounters[0] = 0;
-    fCounters[1] = 0;
+    fEventCounter = 0;
   } //  end of skimmingMC
 
   void processMC_Electron(MyCollisionsMC const& collisions, aod::BCs const& bcs, aod::McCollisions const& mccollisions, aod::McParticles const& mcTracks, TracksMC const& o2tracks, aod::EMPrimaryElectrons const& emprimaryelectrons)
@@ -0,0 +1,116 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//
+/// \file emEventCutBits.cxx
+/// \brief This code evaluates several variants of EMEventCut once per collision and stores the results as a bitmask joinable to EMEvents.
+/// \author Daiki Sekihata, daiki.sekihata@cern.ch
+
+#include "PWGEM/Dilepton/Core/EMEventCut.h"
+#include "PWGEM/Dilepton/DataModel/dileptonTables.h"
+
+#include <Framework/AnalysisDataModel.h>
+#include <Framework/AnalysisHelpers.h>
+#include <Framework/AnalysisTask.h>
+#include <Framework/Configurable.h>
+#include <Framework/InitContext.h>
+#include <Framework/runDataProcessing.h>
+
+#include <TString.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace o2;
+using namespace o2::framework;
+using namespace o2::framework::expressions;
+using namespace o2::soa;
+
+struct EMEventCutBitsProducer {
+  Produces<o2::aod::EMEventCutBits> eventCutBits;
+
+  // Each entry of the vectors below defines 1 variant of event cut. The i-th variant is stored in the i-th bit. All vectors must have the same size.
+  Configurable<std::vector<float>> cfgZvtxMin{"cfgZvtxMin", {-10.f}, "min. Zvtx"};
+  Configurable<std::vector<float>> cfgZvtxMax{"cfgZvtxMax", {+10.f}, "max. Zvtx"};
+  Configurable<std::vector<int>> cfgRequireSel8{"cfgRequireSel8", {1}, "require sel8 in event cut"};
+  Configurable<std::vector<int>> cfgRequireFT0AND{"cfgRequireFT0AND", {1}, "require FT0AND in event cut"};
+  Configurable<std::vector<int>> cfgRequireNoTFB{"cfgRequireNoTFB", {0}, "require No time frame border in event cut"};
+  Configurable<std::vector<int>> cfgRequireNoITSROFB{"cfgRequireNoITSROFB", {0}, "require no ITS readout frame border in event cut"};
+  Configurable<std::vector<int>> cfgRequireNoSameBunchPileup{"cfgRequireNoSameBunchPileup", {0}, "require no same bunch pileup in event cut"};
+  Configurable<std::vector<int>> cfgRequireVertexITSTPC{"cfgRequireVertexITSTPC", {0}, "require Vertex ITSTPC in event cut"};
+  Configurable<std::vector<int>> cfgRequireVertexTOFmatched{"cfgRequireVertexTOFmatched", {0}, "require Vertex TOFmatched in event cut"};
+  Configurable<std::vector<int>> cfgRequireGoodZvtxFT0vsPV{"cfgRequireGoodZvtxFT0vsPV", {0}, "require good Zvtx between FT0 vs. PV in event cut"};
+  Configurable<std::vector<int>> cfgRequireNoCollInTimeRangeStandard{"cfgRequireNoCollInTimeRangeStandard", {0}, "require no collision in time range standard"};
+  Configurable<std::vector<int>> cfgRequireNoCollInTimeRangeStrict{"cfgRequireNoCollInTimeRangeStrict", {0}, "require no collision in time range strict"};
+  Configurable<std::vector<int>> cfgRequireNoCollInITSROFStandard{"cfgRequireNoCollInITSROFStandard", {0}, "require no collision in ITS ROF standard"};
+  Configurable<std::vector<int>> cfgRequireNoCollInITSROFStrict{"cfgRequireNoCollInITSROFStrict", {0}, "require no collision in ITS ROF strict"};
+  Configurable<std::vector<int>> cfgRequireNoHighMultCollInPrevRof{"cfgRequireNoHighMultCollInPrevRof", {0}, "require no HM collision in previous ITS ROF"};
+  Configurable<std::vector<int>> cfgRequireGoodITSLayer3{"cfgRequireGoodITSLayer3", {0}, "number of inactive chips on ITS layer 3 are below threshold"};
+  Configurable<std::vector<int>> cfgRequireGoodITSLayer0123{"cfgRequireGoodITSLayer0123", {0}, "number of inactive chips on ITS layers 0-3 are below threshold"};
+  Configurable<std::vector<int>> cfgRequireGoodITSLayersAll{"cfgRequireGoodITSLayersAll", {0}, "number of inactive chips on all ITS layers are below threshold"};
+
+  static constexpr int maxNCuts = 16; // size of EMEventCutBits
+  std::vector<EMEventCut> fEMEventCuts;
+
+  void init(InitContext&)
+  {
+    const int ncuts = cfgZvtxMin.value.size();
+    const std::vector<int> sizes = {static_cast<int>(cfgZvtxMax.value.size()), static_cast<int>(cfgRequireSel8.value.size()), static_cast<int>(cfgRequireFT0AND.value.size()), static_cast<int>(cfgRequireNoTFB.value.size()), static_cast<int>(cfgRequireNoITSROFB.value.size()), static_cast<int>(cfgRequireNoSameBunchPileup.value.size()), static_cast<int>(cfgRequireVertexITSTPC.value.size()), static_cast<int>(cfgRequireVertexTOFmatched.value.size()), static_cast<int>(cfgRequireGoodZvtxFT0vsPV.value.size()), static_cast<int>(cfgRequireNoCollInTimeRangeStandard.value.size()), static_cast<int>(cfgRequireNoCollInTimeRangeStrict.value.size()), static_cast<int>(cfgRequireNoCollInITSROFStandard.value.size()), static_cast<int>(cfgRequireNoCollInITSROFStrict.value.size()), static_cast<int>(cfgRequireNoHighMultCollInPrevRof.value.size()), static_cast<int>(cfgRequireGoodITSLayer3.value.size()), static_cast<int>(cfgRequireGoodITSLayer0123.value.size()), static_cast<int>(cfgRequireGoodITSLayersAll.value.size())};
+    for (const auto& size : sizes) {
+      if (size != ncuts) {
+        LOGF(fatal, "All event cut configurables must have the same number of variants. %d != %d", size, ncuts);
+      }
+    }
+    if (ncuts < 1 || maxNCuts < ncuts) {
+      LOGF(fatal, "The number of event cut variants must be in 1 - %d. %d is given.", maxNCuts, ncuts);
+    }
+
+    fEMEventCuts.reserve(ncuts);
+    for (int i = 0; i < ncuts; i++) {
+      EMEventCut cut(Form("fEMEventCut_%d", i), Form("fEMEventCut_%d", i));
+      cut.SetRequireSel8(cfgRequireSel8.value[i]);
+      cut.SetRequireFT0AND(cfgRequireFT0AND.value[i]);
+      cut.SetZvtxRange(cfgZvtxMin.value[i], cfgZvtxMax.value[i]);
+      cut.SetRequireNoTFB(cfgRequireNoTFB.value[i]);
+      cut.SetRequireNoITSROFB(cfgRequireNoITSROFB.value[i]);
+      cut.SetRequireNoSameBunchPileup(cfgRequireNoSameBunchPileup.value[i]);
+      cut.SetRequireVertexITSTPC(cfgRequireVertexITSTPC.value[i]);
+      cut.SetRequireVertexTOFmatched(cfgRequireVertexTOFmatched.value[i]);
+      cut.SetRequireGoodZvtxFT0vsPV(cfgRequireGoodZvtxFT0vsPV.value[i]);
+      cut.SetRequireNoCollInTimeRangeStandard(cfgRequireNoCollInTimeRangeStandard.value[i]);
+      cut.SetRequireNoCollInTimeRangeStrict(cfgRequireNoCollInTimeRangeStrict.value[i]);
+      cut.SetRequireNoCollInITSROFStandard(cfgRequireNoCollInITSROFStandard.value[i]);
+      cut.SetRequireNoCollInITSROFStrict(cfgRequireNoCollInITSROFStrict.value[i]);
+      cut.SetRequireNoHighMultCollInPrevRof(cfgRequireNoHighMultCollInPrevRof.value[i]);
+      cut.SetRequireGoodITSLayer3(cfgRequireGoodITSLayer3.value[i]);
+      cut.SetRequireGoodITSLayer0123(cfgRequireGoodITSLayer0123.value[i]);
+      cut.SetRequireGoodITSLayersAll(cfgRequireGoodITSLayersAll.value[i]);
+      fEMEventCuts.emplace_back(cut);
+    }
+  }
+
+  void process(aod::EMEvents const& collisions)
+  {
+    for (const auto& collision : collisions) {
+      uint16_t bits = 0;
+      for (int i = 0; i < static_cast<int>(fEMEventCuts.size()); i++) {
+        if (fEMEventCuts[i].IsSelected(collision)) {
+          bits |= static_cast<uint16_t>(1 << i);
+        }
+      }
+      eventCutBits(bits);
+    } // end of collision loop
+  }
+};
+WorkflowSpec defineDataProcessing(ConfigContext const& cfgc)
+{
+  return WorkflowSpec{adaptAnalysisTask<EMEventCutBitsProducer>(cfgc, TaskName{"em-event-cut-bits"})};
+}
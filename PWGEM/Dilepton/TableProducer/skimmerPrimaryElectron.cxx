@@ -38,6 +38,7 @@
 #include "Math/Vector4D.h"
 
 #include <map>
+#include <span>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -371,37 +372,46 @@ struct skimmerPrimaryElectron {
     return true;
   }
 
+  template <typename TCollision, typename TTrack>
+  bool getMlInput(TCollision const& collision, TTrack const& track, std::vector<float>& inputFeatures, int& pbin)
+  {
+    if (!isElectron_TOFif(track, collision)) {
+      return false;
+    }
+    o2::dataformats::DCA mDcaInfoCov;
+    mDcaInfoCov.set(999, 999, 999, 999, 999);
+    auto trackParCov = getTrackParCov(track);
+    trackParCov.setPID(o2::track::PID::Electron);
+    mVtx.setPos({collision.posX(), collision.posY(), collision.posZ()});
+    mVtx.setCov(collision.covXX(), collision.covXY(), collision.covYY(), collision.covXZ(), collision.covYZ(), collision.covZZ());
+    bool isPropOK = o2::base::Propagator::Instance()->propagateToDCABxByBz(mVtx, trackParCov, 2.f, matCorr, &mDcaInfoCov);
+    if (!isPropOK) {
+      return false;
+    }
+    inputFeatures = mlResponseSingleTrack.getInputFeatures(track, trackParCov, collision, mapTOFBetaReassociated[std::make_pair(collision.globalIndex(), track.globalIndex())], mapTOFNsigmaReassociated[std::make_pair(collision.globalIndex(), track.globalIndex())]);
+    float binningFeature = mlResponseSingleTrack.getBinningFeature(track, trackParCov, collision, mapTOFBetaReassociated[std::make_pair(collision.globalIndex(), track.globalIndex())], mapTOFNsigmaReassociated[std::make_pair(collision.globalIndex(), track.globalIndex())]);
+
+    pbin = lower_bound(binsMl.value.begin(), binsMl.value.end(), binningFeature) - binsMl.value.begin() - 1;
+    if (pbin < 0) {
+      pbin = 0;
+    } else if (static_cast<int>(binsMl.value.size()) - 2 < pbin) {
+      pbin = static_cast<int>(binsMl.value.size()) - 2;
+    }
+    // LOGF(info, "track.tpcInnerParam() = %f (GeV/c), pbin = %d", track.tpcInnerParam(), pbin);
+    return true;
+  }
+
   template <typename TCollision, typename TTrack>
   bool isElectron(TCollision const& collision, TTrack const& track, float& probaEl)
   {
     probaEl = 1.f;
     if (usePIDML) {
-      if (!isElectron_TOFif(track, collision)) {
+      std::vector<float> inputFeatures;
+      int pbin = 0;
+      if (!getMlInput(collision, track, inputFeatures, pbin)) {
         probaEl = 0.0;
         return false;
       }
-      o2::dataformats::DCA mDcaInfoCov;
-      mDcaInfoCov.set(999, 999, 999, 999, 999);
-      auto trackParCov = getTrackParCov(track);
-      trackParCov.setPID(o2::track::PID::Electron);
-      mVtx.setPos({collision.posX(), collision.posY(), collision.posZ()});
-      mVtx.setCov(collision.covXX(), collision.covXY(), collision.covYY(), collision.covXZ(), collision.covYZ(), collision.covZZ());
-      bool isPropOK = o2::base::Propagator::Instance()->propagateToDCABxByBz(mVtx, trackParCov, 2.f, matCorr, &mDcaInfoCov);
-      if (!isPropOK) {
-        probaEl = 0.0;
-        return false;
-      }
-      std::vector<float> inputFeatures = mlResponseSingleTrack.getInputFeatures(track, trackParCov, collision, mapTOFBetaReassociated[std::make_pair(collision.globalIndex(), track.globalIndex())], mapTOFNsigmaReassociated[std::make_pair(collision.globalIndex(), track.globalIndex())]);
-      float binningFeature = mlResponseSingleTrack.getBinningFeature(track, trackParCov, collision, mapTOFBetaReassociated[std::make_pair(collision.globalIndex(), track.globalIndex())], mapTOFNsigmaReassociated[std::make_pair(collision.globalIndex(), track.globalIndex())]);
-
-      int pbin = lower_bound(binsMl.value.begin(), binsMl.value.end(), binningFeature) - binsMl.value.begin() - 1;
-      if (pbin < 0) {
-        pbin = 0;
-      } else if (static_cast<int>(binsMl.value.size()) - 2 < pbin) {
-        pbin = static_cast<int>(binsMl.value.size()) - 2;
-      }
-      // LOGF(info, "track.tpcInnerParam() = %f (GeV/c), pbin = %d", track.tpcInnerParam(), pbin);
-
       probaEl = mlResponseSingleTrack.getModelOutput(inputFeatures, pbin)[1]; // 0: hadron, 1:electron
       return probaEl > cutsMl.value[pbin];
     } else {
@@ -410,6 +420,47 @@ struct skimmerPrimaryElectron {
     }
   }
 
+  template <typename TCollision, typename TTrack>
+  void addElectronCandidate(TCollision const& collision, TTrack const& track)
+  {
+    if (usePIDML) {
+      // the model is evaluated once per data frame for all the candidates in selectElectronCandidatesMl()
+      std::vector<float> inputFeatures;
+      int pbin = 0;
+      if (!getMlInput(collision, track, inputFeatures, pbin)) {
+        return;
+      }
+      mlCandidateIds.emplace_back(collision.globalIndex(), track.globalIndex());
+      mlCandidateInputs.emplace_back(std::move(inputFeatures));
+      mlCandidateBins.emplace_back(pbin);
+      return;
+    }
+    float probaEl = 1.0;
+    if (!isElectron(collision, track, probaEl)) {
+      return;
+    }
+    mapProbEl[std::make_pair(collision.globalIndex(), track.globalIndex())] = probaEl;
+    multiMapTracksPerCollision.insert(std::make_pair(collision.globalIndex(), track.globalIndex()));
+  }
+
+  void selectElectronCandidatesMl()
+  {
+    if (mlCandidateIds.empty()) {
+      return;
+    }
+    mlResponseSingleTrack.getModelOutputBatch(std::span<std::vector<float>>(mlCandidateInputs), std::span<const int>(mlCandidateBins), mlCandidateOutputs);
+    for (size_t i = 0; i < mlCandidateIds.size(); i++) {
+      float probaEl = mlCandidateOutputs[i][1]; // 0: hadron, 1:electron
+      if (probaEl > cutsMl.value[mlCandidateBins[i]]) {
+        mapProbEl[mlCandidateIds[i]] = probaEl;
+        multiMapTracksPerCollision.insert(mlCandidateIds[i]);
+      }
+    }
+    mlCandidateIds.clear();
+    mlCandidateInputs.clear();
+    mlCandidateBins.clear();
+  }
+
   template <typename TTrack, typename TCollision>
   bool isElectron_TOFif(TTrack const& track, TCollision const& collision)
   {
@@ -670,6 +721,12 @@ struct skimmerPrimaryElectron {
   std::map<std::pair<int, int>, float> mapProbEl;               // map pair(collisionId, trackId) -> probaEl
   std::unordered_multimap<int, int> multiMapTracksPerCollision; // collisionId -> trackIds
 
+  // electron candidates waiting for the batched evaluation of the PID ML model
+  std::vector<std::pair<int, int>> mlCandidateIds;    // pair(collisionId, trackId)
+  std::vector<std::vector<float>> mlCandidateInputs;  // input features
+  std::vector<int> mlCandidateBins;                   // model index
+  std::vector<std::vector<float>> mlCandidateOutputs; // model output
+
   std::unordered_map<int, double> mapCollisionTime;
   std::unordered_map<int, double> mapCollisionTimeError;
 
@@ -697,17 +754,13 @@ struct skimmerPrimaryElectron {
 
       auto tracks_per_coll = tracks.sliceBy(perCol, collision.globalIndex());
       for (const auto& track : tracks_per_coll) {
-        float probaEl = 1.0;
         if (!checkTrack<false>(collision, track)) {
           continue;
         }
-        if (!isElectron(collision, track, probaEl)) {
-          continue;
-        }
-        mapProbEl[std::make_pair(collision.globalIndex(), track.globalIndex())] = probaEl;
-        multiMapTracksPerCollision.insert(std::make_pair(collision.globalIndex(), track.globalIndex()));
+        addElectronCandidate(collision, track);
       }
     } // end of collision loop
+    selectElectronCandidatesMl();
 
     for (const auto& collision : collisions) {
       int count_electrons = multiMapTracksPerCollision.count(collision.globalIndex());
@@ -763,17 +816,13 @@ struct skimmerPrimaryElectron {
 
       for (const auto& trackId : trackIdsThisCollision) {
         auto track = trackId.template track_as<MyTracks>();
-        float probaEl = 1.0;
         if (!checkTrack<false>(collision, track)) {
           continue;
         }
-        if (!isElectron(collision, track, probaEl)) {
-          continue;
-        }
-        mapProbEl[std::make_pair(collision.globalIndex(), track.globalIndex())] = probaEl;
-        multiMapTracksPerCollision.insert(std::make_pair(collision.globalIndex(), track.globalIndex()));
+        addElectronCandidate(collision, track);
       }
     } // end of collision loop
+    selectElectronCandidatesMl();
 
     for (const auto& collision : collisions) {
       int count_electrons = multiMapTracksPerCollision.count(collision.globalIndex());
@@ -821,18 +870,14 @@ struct skimmerPrimaryElectron {
 
       auto tracks_per_coll = tracks.sliceBy(perCol, collision.globalIndex());
       for (const auto& track : tracks_per_coll) {
-        float probaEl = 1.0;
         if (!checkTrack<false>(collision, track)) {
           continue;
         }
-        if (!isElectron(collision, track, probaEl)) {
-          continue;
-        }
-        mapProbEl[std::make_pair(collision.globalIndex(), track.globalIndex())] = probaEl;
-        multiMapTracksPerCollision.insert(std::make_pair(collision.globalIndex(), track.globalIndex()));
+        addElectronCandidate(collision, track);
       }
 
     } // end of collision loop
+    selectElectronCandidatesMl();
 
     for (const auto& collision : collisions) {
       int count_electrons = multiMapTracksPerCollision.count(collision.globalIndex());
@@ -888,17 +933,13 @@ struct skimmerPrimaryElectron {
 
       for (const auto& trackId : trackIdsThisCollision) {
         auto track = trackId.template track_as<MyTracks>();
-        float probaEl = 1.0;
         if (!checkTrack<false>(collision, track)) {
           continue;
         }
-        if (!isElectron(collision, track, probaEl)) {
-          continue;
-        }
-        mapProbEl[std::make_pair(collision.globalIndex(), track.globalIndex())] = probaEl;
-        multiMapTracksPerCollision.insert(std::make_pair(collision.globalIndex(), track.globalIndex()));
+        addElectronCandidate(collision, track);
       }
     } // end of collision loop
+    selectElectronCandidatesMl();
 
     for (const auto& collision : collisions) {
       int count_electrons = multiMapTracksPerCollision.count(collision.globalIndex());
@@ -950,17 +991,13 @@ struct skimmerPrimaryElectron {
 
       auto tracks_per_coll = tracks.sliceBy(perCol, collision.globalIndex());
       for (const auto& track : tracks_per_coll) {
-        float probaEl = 1.0;
         if (!checkTrack<true>(collision, track)) {
           continue;
         }
-        if (!isElectron(collision, track, probaEl)) {
-          continue;
-        }
-        mapProbEl[std::make_pair(collision.globalIndex(), track.globalIndex())] = probaEl;
-        multiMapTracksPerCollision.insert(std::make_pair(collision.globalIndex(), track.globalIndex()));
+        addElectronCandidate(collision, track);
       }
     } // end of collision loop
+    selectElectronCandidatesMl();
 
     for (const auto& collision : collisions) {
       int count_electrons = multiMapTracksPerCollision.count(collision.globalIndex());
@@ -1016,17 +1053,13 @@ struct skimmerPrimaryElectron {
 
       for (const auto& trackId : trackIdsThisCollision) {
         auto track = trackId.template track_as<MyTracksMC>();
-        float probaEl = 1.0;
         if (!checkTrack<true>(collision, track)) {
           continue;
         }
-        if (!isElectron(collision, track, probaEl)) {
-          continue;
-        }
-        mapProbEl[std::make_pair(collision.globalIndex(), track.globalIndex())] = probaEl;
-        multiMapTracksPerCollision.insert(std::make_pair(collision.globalIndex(), track.globalIndex()));
+        addElectronCandidate(collision, track);
       }
     } // end of collision loop
+    selectElectronCandidatesMl();
 
     for (const auto& collision : collisions) {
       int count_electrons = multiMapTracksPerCollision.count(collision.globalIndex());
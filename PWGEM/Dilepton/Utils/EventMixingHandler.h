@@ -15,68 +15,198 @@
 #ifndef PWGEM_DILEPTON_UTILS_EVENTMIXINGHANDLER_H_
 #define PWGEM_DILEPTON_UTILS_EVENTMIXINGHANDLER_H_
 
+#include <cstdint>
 #include <map>
+#include <span>
 #include <utility>
 #include <vector>
 
 namespace o2::aod::pwgem::dilepton::utils
 {
+// Event pool organised as one ring buffer of fNdepth collisions per mixing bin.
+// Tracks of a collision are stored contiguously and are accessed through spans, without copies.
+// Tracks are first staged for the current collision and moved into the pool by AddCollisionIdAtLast().
+// Tracks of a collision that is never added to the pool are discarded when the next collision is started.
 template <typename T, typename U, typename V>
 class EventMixingHandler
 {
  public:
-  EventMixingHandler()
-  {
-    fNdepth = 0;
-    fMapMixBins.clear();
-    fMap_Tracks_per_collision.clear();
-  }
+  EventMixingHandler() : EventMixingHandler(0) {}
 
   explicit EventMixingHandler(int ndepth)
   {
     fNdepth = ndepth;
-    fMapMixBins.clear();
-    fMap_Tracks_per_collision.clear();
   }
 
-  ~EventMixingHandler()
-  {
-    fMapMixBins.clear();
-    fMap_Tracks_per_collision.clear();
-  }
+  ~EventMixingHandler() = default;
 
+  // ndepth has to be set before the first collision is added to the pool
   void SetNdepth(int ndepth) { fNdepth = ndepth; }
+  // maximum number of tracks kept in the pool (0 = no limit). When exceeded, tracks of the oldest collisions in the same mixing bin are released.
+  void SetMaxNTracks(int64_t maxNTracks) { fMaxNTracks = maxNTracks; }
+  int64_t GetNTracksInPool() const { return fNTracksInPool; }
 
   void ReserveNTracksPerCollision(U key_df_collision, int ntrack)
   {
-    fMap_Tracks_per_collision[key_df_collision].reserve(ntrack);
+    selectCurrentCollision(key_df_collision);
+    fCurrentTracks.reserve(ntrack);
   }
 
   void AddTrackToEventPool(U key_df_collision, V obj)
   {
-    fMap_Tracks_per_collision[key_df_collision].emplace_back(obj);
+    selectCurrentCollision(key_df_collision);
+    fCurrentTracks.emplace_back(obj);
+  }
+
+  // NOTE: the order of collisions in the returned span is the order of the slots in the ring buffer.
+  // The span is valid until the next call to AddCollisionIdAtLast().
+  std::span<const U> GetCollisionIdsFromEventPool(T key_bin)
+  {
+    auto it = fMapMixBins.find(key_bin);
+    if (it == fMapMixBins.end()) {
+      fActivePool = -1;
+      return {};
+    }
+    fActivePool = it->second;
+    fCursor = 0;
+    const auto& pool = fPools[fActivePool];
+    return std::span<const U>(pool.collisionIds.data(), pool.collisionIds.size());
+  }
+
+  // index is the position of the collision in the span returned by GetCollisionIdsFromEventPool()
+  std::span<const V> GetTracksPerCollision(T key_bin, int index)
+  {
+    auto it = fMapMixBins.find(key_bin);
+    if (it == fMapMixBins.end() || index < 0 || index >= static_cast<int>(fPools[it->second].tracks.size())) {
+      return {};
+    }
+    const auto& tracks = fPools[it->second].tracks[index];
+    return std::span<const V>(tracks.data(), tracks.size());
   }
 
-  std::vector<U> GetCollisionIdsFromEventPool(T key_bin) { return fMapMixBins[key_bin]; }
-  std::vector<V> GetTracksPerCollision(T key_bin, int index) { return fMap_Tracks_per_collision[fMapMixBins[key_bin][index]]; }
-  std::vector<V> GetTracksPerCollision(U key_df_collision) { return fMap_Tracks_per_collision[key_df_collision]; }
+  std::span<const V> GetTracksPerCollision(U key_df_collision)
+  {
+    if (fHasCurrent && key_df_collision == fCurrentKey) {
+      return std::span<const V>(fCurrentTracks.data(), fCurrentTracks.size());
+    }
+    // look first in the bin of the last GetCollisionIdsFromEventPool(), starting after the last found slot
+    if (fActivePool >= 0) {
+      int slot = findSlot(fPools[fActivePool], key_df_collision, fCursor);
+      if (slot >= 0) {
+        fCursor = slot + 1;
+        const auto& tracks = fPools[fActivePool].tracks[slot];
+        return std::span<const V>(tracks.data(), tracks.size());
+      }
+    }
+    for (std::size_t ipool = 0; ipool < fPools.size(); ipool++) {
+      int slot = findSlot(fPools[ipool], key_df_collision, 0);
+      if (slot >= 0) {
+        fActivePool = ipool;
+        fCursor = slot + 1;
+        const auto& tracks = fPools[ipool].tracks[slot];
+        return std::span<const V>(tracks.data(), tracks.size());
+      }
+    }
+    return {};
+  }
 
   // call this function at the end of collision loop
   void AddCollisionIdAtLast(T key_bin, U key_df_collision)
   {
-    // LOGF(info, "fMapMixBins[key_bin].size() = %d", fMapMixBins[key_bin].size());
-    if (static_cast<int>(fMapMixBins[key_bin].size()) >= fNdepth) {
-      fMap_Tracks_per_collision[fMapMixBins[key_bin][0]].clear();
-      fMap_Tracks_per_collision[fMapMixBins[key_bin][0]].shrink_to_fit();
-      fMapMixBins[key_bin].erase(fMapMixBins[key_bin].begin());
+    if (fNdepth <= 0) {
+      fHasCurrent = false;
+      fCurrentTracks.clear();
+      return;
+    }
+
+    auto it = fMapMixBins.find(key_bin);
+    if (it == fMapMixBins.end()) {
+      it = fMapMixBins.emplace(key_bin, static_cast<int>(fPools.size())).first;
+      fPools.emplace_back();
+      fPools.back().collisionIds.reserve(fNdepth);
+      fPools.back().tracks.reserve(fNdepth);
+    }
+    auto& pool = fPools[it->second];
+
+    int slot = 0;
+    if (static_cast<int>(pool.collisionIds.size()) < fNdepth) {
+      slot = pool.collisionIds.size();
+      pool.collisionIds.emplace_back(key_df_collision);
+      pool.tracks.emplace_back();
+    } else { // the ring is full, overwrite the oldest collision
+      slot = pool.next;
+      pool.next = (pool.next + 1) % fNdepth;
+      fNTracksInPool -= pool.tracks[slot].size();
+      pool.collisionIds[slot] = key_df_collision;
+    }
+
+    // move the staged tracks into the slot; the released buffer is reused for the next collision
+    pool.tracks[slot].clear();
+    if (fHasCurrent && key_df_collision == fCurrentKey) {
+      pool.tracks[slot].swap(fCurrentTracks);
+    }
+    fNTracksInPool += pool.tracks[slot].size();
+    fHasCurrent = false;
+    fCurrentTracks.clear();
+
+    if (fMaxNTracks > 0) {
+      releaseOldestTracks(pool);
     }
-    fMapMixBins[key_bin].emplace_back(key_df_collision);
   }
 
  private:
-  int fNdepth;                                           // depth of event mixing
-  std::map<T, std::vector<U>> fMapMixBins;               // map : e.g. <zbin, centbin, epbin> -> pair<df index, global collision index>
-  std::map<U, std::vector<V>> fMap_Tracks_per_collision; // map : e.g. pair<df index, global collision index> -> track array
+  struct Pool {
+    std::vector<U> collisionIds;        // e.g. pair<df index, global collision index>, one per slot
+    std::vector<std::vector<V>> tracks; // contiguous track array, one per slot
+    int next = 0;                       // slot to be overwritten (the oldest one) once the ring is full
+  };
+
+  int fNdepth = 0;              // depth of event mixing
+  int64_t fMaxNTracks = 0;      // maximum number of tracks stored in the pool (0 = no limit)
+  int64_t fNTracksInPool = 0;   // number of tracks stored in the pool
+  std::map<T, int> fMapMixBins; // map : e.g. <zbin, centbin, epbin> -> index of the pool
+  std::vector<Pool> fPools;     // one ring buffer per mixing bin
+
+  int fActivePool = -1; // pool of the last GetCollisionIdsFromEventPool()
+  int fCursor = 0;      // slot following the last one found in the active pool
+
+  bool fHasCurrent = false;      // tracks are being staged for fCurrentKey
+  U fCurrentKey{};               // current collision
+  std::vector<V> fCurrentTracks; // tracks staged for the current collision
+
+  void selectCurrentCollision(U const& key_df_collision)
+  {
+    if (!fHasCurrent || !(key_df_collision == fCurrentKey)) {
+      fCurrentTracks.clear(); // tracks of a collision not added to the pool are dropped
+      fCurrentKey = key_df_collision;
+      fHasCurrent = true;
+    }
+  }
+
+  // mixing loops access the collisions in the order of GetCollisionIdsFromEventPool(), so the search starts from the expected slot
+  int findSlot(Pool const& pool, U const& key_df_collision, int start) const
+  {
+    const int n = pool.collisionIds.size();
+    for (int i = 0; i < n; i++) {
+      int slot = (start + i) % n;
+      if (pool.collisionIds[slot] == key_df_collision) {
+        return slot;
+      }
+    }
+    return -1;
+  }
+
+  // release the track memory of the oldest collisions in this pool until the ceiling is respected; the newest collision is always kept
+  void releaseOldestTracks(Pool& pool)
+  {
+    const int n = pool.collisionIds.size();
+    const int oldest = (n < fNdepth ? 0 : pool.next);
+    for (int i = 0; i < n - 1 && fNTracksInPool > fMaxNTracks; i++) {
+      auto& tracks = pool.tracks[(oldest + i) % n];
+      fNTracksInPool -= tracks.size();
+      std::vector<V>().swap(tracks);
+    }
+  }
 };
 } // namespace o2::aod::pwgem::dilepton::utils
 #endif // PWGEM_DILEPTON_UTILS_EVENTMIXINGHANDLER_H_
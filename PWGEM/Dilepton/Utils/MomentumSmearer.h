@@ -30,6 +30,9 @@
 #include <TKey.h>
 #include <TString.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <random>
 #include <vector>
 
 using namespace o2;
@@ -40,6 +43,22 @@ using namespace o2::soa;
 class MomentumSmearer
 {
  public:
+  /// Inverse CDF of a resolution variable per generated pt bin, from a 2D histogram (pt, variable)
+  struct ResoTable {
+    int nBins = 0;             // number of bins of the resolution variable
+    std::vector<double> edges; // bin edges of the resolution variable
+    std::vector<float> cdf;    // per pt bin, cumulative probability at the nBins + 1 edges
+  };
+
+  /// Inverse CDF of the (relative pt, eta, phi) resolution per (centrality, pt, eta, phi, charge) cell, from the filled bins of the ND histogram
+  struct ResoTableND {
+    int nBins[3] = {0, 0, 0};     // number of bins of the resolution variables
+    std::vector<double> edges[3]; // bin edges of the resolution variables
+    std::vector<int64_t> offsets; // first filled bin of each cell, the last element is the number of filled bins
+    std::vector<float> cdf;       // per cell, cumulative probability at the upper edge of the filled bins
+    std::vector<int32_t> bins;    // per cell, 3D bin of the filled bins
+  };
+
   /// Default constructor
   MomentumSmearer() = default;
 
@@ -133,57 +152,115 @@ class MomentumSmearer
     }
   }
 
-  void fillVecReso(TH2F* fReso, std::vector<TH1F*>& fVecReso, const char* suffix)
+  void fillVecReso(TH2F* fReso, ResoTable& table, const char* suffix)
   {
     TAxis* axisPt = fReso->GetXaxis(); // be careful! This works only for variable bin width.
+    TAxis* axisReso = fReso->GetYaxis();
     int nBinsPt = axisPt->GetNbins();
-    fVecReso.resize(nBinsPt);
+    table.nBins = axisReso->GetNbins();
+    table.edges.resize(table.nBins + 1);
+    for (int j = 0; j <= table.nBins; j++) {
+      table.edges[j] = axisReso->GetBinLowEdge(j + 1);
+    }
+    table.cdf.assign(nBinsPt * (table.nBins + 1), 0.f);
     for (int i = 0; i < nBinsPt; i++) {
-      auto h1 = reinterpret_cast<TH1F*>(fReso->ProjectionY(Form("h1reso%s_pt%d", suffix, i), i + 1, i + 1));
-      h1->Scale(1.f, "width"); // convert ntrack to probability density
-      fVecReso[i] = h1;
+      float* cdf = &table.cdf[i * (table.nBins + 1)];
+      double sum = 0.;
+      for (int j = 0; j < table.nBins; j++) {
+        double content = fReso->GetBinContent(i + 1, j + 1);
+        if (content > 0.) {
+          sum += content / axisReso->GetBinWidth(j + 1); // convert ntrack to probability density
+        }
+        cdf[j + 1] = sum;
+      }
+      if (sum > 0.) {
+        for (int j = 1; j < table.nBins; j++) {
+          cdf[j] /= sum;
+        }
+        cdf[table.nBins] = 1.f;
+      }
     }
+    LOGF(info, "inverse CDF of resolution%s: %d pt bins x %d bins", suffix, nBinsPt, table.nBins);
   }
 
   void fillVecResoND(THnSparseF* hs_reso)
   {
-    LOGP(info, "prepare TH3D");
+    LOGP(info, "prepare inverse CDF of ND resolution");
     fNCenBins = hs_reso->GetAxis(0)->GetNbins();
     fNPtBins = hs_reso->GetAxis(1)->GetNbins();
     fNEtaBins = hs_reso->GetAxis(2)->GetNbins();
     fNPhiBins = hs_reso->GetAxis(3)->GetNbins();
     fNChBins = hs_reso->GetAxis(4)->GetNbins();
     LOGF(info, "ncen = %d, npt = %d, neta = %d, nphi = %d, nch = %d without under- and overflow bins", fNCenBins, fNPtBins, fNEtaBins, fNPhiBins, fNChBins);
-    // fVecResoND.reserve(npt * neta * nphi * nch);
-
-    fVecResoND.resize(fNCenBins, std::vector<std::vector<std::vector<std::vector<TH3D*>>>>(fNPtBins, std::vector<std::vector<std::vector<TH3D*>>>(fNEtaBins, std::vector<std::vector<TH3D*>>(fNPhiBins, std::vector<TH3D*>(fNChBins)))));
-    // fVecResoND.resize(fNPtBins, std::vector<std::vector<std::vector<TH3D*>>>(fNEtaBins, std::vector<std::vector<TH3D*>>(fNPhiBins, std::vector<TH3D*>(fNChBins))));
-    //  auto h3 = reinterpret_cast<TH3D*>(hs_reso->Projection(4, 5, 6));
-    //  h3->SetName(Form("h3reso_pt%d_eta%d_phi%d_ch%d", 0, 0, 0, 0));
-    //  fVecResoND[0][0][0][0] = h3;
-
-    for (int icen = 0; icen < fNCenBins; icen++) {
-      hs_reso->GetAxis(0)->SetRange(icen + 1, icen + 1);
-      for (int ipt = 0; ipt < fNPtBins; ipt++) {
-        hs_reso->GetAxis(1)->SetRange(ipt + 1, ipt + 1);
-        for (int ieta = 0; ieta < fNEtaBins; ieta++) {
-          hs_reso->GetAxis(2)->SetRange(ieta + 1, ieta + 1);
-          for (int iphi = 0; iphi < fNPhiBins; iphi++) {
-            hs_reso->GetAxis(3)->SetRange(iphi + 1, iphi + 1);
-            for (int ich = 0; ich < fNChBins; ich++) {
-              if (-0.5 < hs_reso->GetAxis(4)->GetBinCenter(ich + 1) && hs_reso->GetAxis(4)->GetBinCenter(ich + 1) < 0.5) {
-                continue;
-              }
-              hs_reso->GetAxis(4)->SetRange(ich + 1, ich + 1);
-              auto h3 = reinterpret_cast<TH3D*>(hs_reso->Projection(5, 6, 7));
-              h3->SetName(Form("h3reso_cen%d_pt%d_eta%d_phi%d_ch%d", icen, ipt, ieta, iphi, ich));
-              h3->Scale(1.f, "width"); // convert ntrack to probability density
-              fVecResoND[icen][ipt][ieta][iphi][ich] = h3;
-            } // end of charge loop
-          } // end of phi loop
-        } // end of eta loop
-      } // end of pt loop
-    } // end of centrality loop
+
+    ResoTableND& table = fResoTableND;
+    for (int k = 0; k < 3; k++) {
+      TAxis* axis = hs_reso->GetAxis(5 + k);
+      table.nBins[k] = axis->GetNbins();
+      table.edges[k].resize(table.nBins[k] + 1);
+      for (int j = 0; j <= table.nBins[k]; j++) {
+        table.edges[k][j] = axis->GetBinLowEdge(j + 1);
+      }
+    }
+    const int nCells = fNCenBins * fNPtBins * fNEtaBins * fNPhiBins * fNChBins;
+
+    // the filled bins are visited twice, to count them per cell and then to store them, instead of projecting a TH3D per cell
+    std::vector<int> coord(hs_reso->GetNdimensions());
+    auto getCell = [&](int64_t ibin, double& density, int32_t& bin3D) -> int {
+      double content = hs_reso->GetBinContent(ibin, coord.data());
+      if (!(content > 0.)) {
+        return -1;
+      }
+      for (int k = 0; k < 8; k++) {
+        if (coord[k] < 1 || coord[k] > hs_reso->GetAxis(k)->GetNbins()) {
+          return -1; // under- or overflow bin
+        }
+      }
+      double chcenter = hs_reso->GetAxis(4)->GetBinCenter(coord[4]);
+      if (-0.5 < chcenter && chcenter < 0.5) {
+        return -1;
+      }
+      density = content / (hs_reso->GetAxis(5)->GetBinWidth(coord[5]) * hs_reso->GetAxis(6)->GetBinWidth(coord[6]) * hs_reso->GetAxis(7)->GetBinWidth(coord[7])); // convert ntrack to probability density
+      bin3D = ((coord[7] - 1) * table.nBins[1] + coord[6] - 1) * table.nBins[0] + coord[5] - 1;
+      return (((((coord[0] - 1) * fNPtBins + coord[1] - 1) * fNEtaBins + coord[2] - 1) * fNPhiBins + coord[3] - 1) * fNChBins + coord[4] - 1);
+    };
+
+    double density = 0.;
+    int32_t bin3D = 0;
+    table.offsets.assign(nCells + 1, 0);
+    for (int64_t ibin = 0; ibin < hs_reso->GetNbins(); ibin++) {
+      int cell = getCell(ibin, density, bin3D);
+      if (cell >= 0) {
+        table.offsets[cell + 1]++;
+      }
+    }
+    for (int cell = 0; cell < nCells; cell++) {
+      table.offsets[cell + 1] += table.offsets[cell];
+    }
+    table.cdf.resize(table.offsets[nCells]);
+    table.bins.resize(table.offsets[nCells]);
+    std::vector<int64_t> next(table.offsets.begin(), table.offsets.end() - 1);
+    std::vector<double> sums(nCells, 0.);
+    for (int64_t ibin = 0; ibin < hs_reso->GetNbins(); ibin++) {
+      int cell = getCell(ibin, density, bin3D);
+      if (cell < 0) {
+        continue;
+      }
+      sums[cell] += density;
+      table.cdf[next[cell]] = sums[cell];
+      table.bins[next[cell]] = bin3D;
+      next[cell]++;
+    }
+    for (int cell = 0; cell < nCells; cell++) {
+      if (table.offsets[cell] == table.offsets[cell + 1]) {
+        continue;
+      }
+      for (int64_t i = table.offsets[cell]; i < table.offsets[cell + 1] - 1; i++) {
+        table.cdf[i] /= sums[cell];
+      }
+      table.cdf[table.offsets[cell + 1] - 1] = 1.f;
+    }
+    LOGF(info, "%ld filled resolution bins in %d cells", table.offsets[nCells], nCells);
   }
 
   void init()
@@ -374,7 +451,22 @@ class MomentumSmearer
     fInitialized = true;
   }
 
-  void applySmearing(const float ptgen, const float vargen, const float multiply, float& varsmeared, TH2F* fReso, std::vector<TH1F*>& fVecReso)
+  /// \return a random value of the resolution variable in the pt bin (0-based), 0 if the bin is empty
+  float getRandomReso(const ResoTable& table, int ptbin)
+  {
+    const float* cdf = &table.cdf[ptbin * (table.nBins + 1)];
+    if (!(cdf[table.nBins] > 0.f)) {
+      return 0.f;
+    }
+    double u = fUniform(fRandom);
+    int j = std::upper_bound(cdf + 1, cdf + table.nBins + 1, u) - (cdf + 1);
+    if (j >= table.nBins) {
+      j = table.nBins - 1;
+    }
+    return table.edges[j] + (table.edges[j + 1] - table.edges[j]) * (u - cdf[j]) / (cdf[j + 1] - cdf[j]);
+  }
+
+  void applySmearing(const float ptgen, const float vargen, const float multiply, float& varsmeared, TH2F* fReso, const ResoTable& table)
   {
     float ptgen_tmp = ptgen > fMinPtGen ? ptgen : fMinPtGen;
     TAxis* axisPt = fReso->GetXaxis();
@@ -386,10 +478,7 @@ class MomentumSmearer
     if (ptbin > nBinsPt) {
       ptbin = nBinsPt;
     }
-    float smearing = 0.;
-    if (fVecReso[ptbin - 1]->GetEntries() > 0) {
-      smearing = fVecReso[ptbin - 1]->GetRandom() * multiply;
-    }
+    float smearing = getRandomReso(table, ptbin - 1) * multiply;
     varsmeared = vargen - smearing;
   }
 
@@ -466,8 +555,24 @@ class MomentumSmearer
     }
 
     double dpt_rel = 0, deta = 0, dphi = 0;
-    if (fVecResoND[cenbin - 1][ptbin - 1][etabin - 1][phibin - 1][chbin - 1]->GetEntries() > 0) {
-      fVecResoND[cenbin - 1][ptbin - 1][etabin - 1][phibin - 1][chbin - 1]->GetRandom3(dpt_rel, deta, dphi);
+    const ResoTableND& table = fResoTableND;
+    const int cell = (((((cenbin - 1) * fNPtBins + ptbin - 1) * fNEtaBins + etabin - 1) * fNPhiBins + phibin - 1) * fNChBins + chbin - 1);
+    const int64_t first = table.offsets[cell];
+    const int64_t last = table.offsets[cell + 1];
+    if (first < last) {
+      double u = fUniform(fRandom);
+      int64_t i = std::upper_bound(table.cdf.begin() + first, table.cdf.begin() + last, u) - table.cdf.begin();
+      if (i >= last) {
+        i = last - 1;
+      }
+      double lower = i > first ? table.cdf[i - 1] : 0.;
+      int ix = table.bins[i] % table.nBins[0];
+      int iy = (table.bins[i] / table.nBins[0]) % table.nBins[1];
+      int iz = table.bins[i] / (table.nBins[0] * table.nBins[1]);
+      // same as TH3::GetRandom3: interpolation of the CDF in the first variable, uniform in the others
+      dpt_rel = table.edges[0][ix] + (table.edges[0][ix + 1] - table.edges[0][ix]) * (u - lower) / (table.cdf[i] - lower);
+      deta = table.edges[1][iy] + (table.edges[1][iy + 1] - table.edges[1][iy]) * fUniform(fRandom);
+      dphi = table.edges[2][iz] + (table.edges[2][iz + 1] - table.edges[2][iz]) * fUniform(fRandom);
     }
     ptsmeared = ptgen - dpt_rel * ptgen;
     etasmeared = etagen - deta;
@@ -554,11 +659,7 @@ class MomentumSmearer
     if (ptbin > nBinsPt) {
       ptbin = nBinsPt;
     }
-    float dca = 0.;
-    if (fVecDCA[ptbin - 1]->GetEntries() > 0) {
-      dca = fVecDCA[ptbin - 1]->GetRandom();
-    }
-    return dca;
+    return getRandomReso(fVecDCA, ptbin - 1);
   }
 
   // setters
@@ -583,6 +684,7 @@ class MomentumSmearer
   }
   void setTimestamp(int64_t timestamp) { fTimestamp = timestamp; }
   void setMinPt(float minpt) { fMinPtGen = minpt; }
+  void setSeed(uint32_t seed) { fRandom.seed(seed); }
 
   // getters
   bool getNDSmearing() { return fDoNDSmearing; }
@@ -630,23 +732,25 @@ class MomentumSmearer
   TH2F* fResoEta;
   TH2F* fResoPhi_Pos;
   TH2F* fResoPhi_Neg;
-  std::vector<std::vector<std::vector<std::vector<std::vector<TH3D*>>>>> fVecResoND;
+  ResoTableND fResoTableND;
   int fNCenBins = 1;
   int fNPtBins = 1;
   int fNEtaBins = 1;
   int fNPhiBins = 1;
   int fNChBins = 1;
-  std::vector<TH1F*> fVecResoPt;
-  std::vector<TH1F*> fVecResoEta;
-  std::vector<TH1F*> fVecResoPhi_Pos;
-  std::vector<TH1F*> fVecResoPhi_Neg;
+  ResoTable fVecResoPt;
+  ResoTable fVecResoEta;
+  ResoTable fVecResoPhi_Pos;
+  ResoTable fVecResoPhi_Neg;
   TObject* fEff;
   TH2F* fDCA;
-  std::vector<TH1F*> fVecDCA;
+  ResoTable fVecDCA;
   int64_t fTimestamp;
   bool fFromCcdb = false;
   Service<ccdb::BasicCCDBManager> fCcdb;
   float fMinPtGen = -1.f;
+  std::mt19937 fRandom{4357}; // own generator of the smearer, not shared with the other tasks of the process
+  std::uniform_real_distribution<double> fUniform{0., 1.};
 };
 
 #endif // PWGEM_DILEPTON_UTILS_MOMENTUMSMEARER_H_
@@ -0,0 +1,262 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \pair variables computed for blocks of pairs from the lepton kinematics stored as columns
+/// \author daiki.sekihata@cern.ch
+
+#ifndef PWGEM_DILEPTON_UTILS_PAIRKERNEL_H_
+#define PWGEM_DILEPTON_UTILS_PAIRKERNEL_H_
+
+#include "PWGEM/Dilepton/Utils/EMTrackUtilities.h"
+
+#include "CommonConstants/MathConstants.h"
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+//_______________________________________________________________________
+namespace o2::aod::pwgem::dilepton::utils::pairutil
+{
+
+// Kinematics of the selected leptons of a collision (or of an event of the mixing pool), as columns.
+// The pair loops address the leptons by their position in the columns.
+struct LeptonColumns {
+  std::vector<float> pt{};
+  std::vector<float> eta{};
+  std::vector<float> phi{};
+  std::vector<int8_t> sign{};
+  std::vector<double> px{};
+  std::vector<double> py{};
+  std::vector<double> pz{};
+  std::vector<double> e{};
+  std::vector<float> dca3D{}; // in sigma
+  std::vector<float> dcaXY{}; // in sigma
+  std::vector<float> dcaZ{};  // in sigma
+
+  template <typename TTrack>
+  void add(TTrack const& track, const float mass)
+  {
+    pt.emplace_back(track.pt());
+    eta.emplace_back(track.eta());
+    phi.emplace_back(track.phi());
+    sign.emplace_back(track.sign());
+    const double tpx = track.pt() * std::cos(static_cast<double>(track.phi()));
+    const double tpy = track.pt() * std::sin(static_cast<double>(track.phi()));
+    const double tpz = track.pt() * std::sinh(static_cast<double>(track.eta()));
+    px.emplace_back(tpx);
+    py.emplace_back(tpy);
+    pz.emplace_back(tpz);
+    e.emplace_back(std::sqrt(tpx * tpx + tpy * tpy + tpz * tpz + static_cast<double>(mass) * mass));
+    dca3D.emplace_back(o2::aod::pwgem::dilepton::utils::emtrackutil::dca3DinSigma(track));
+    dcaXY.emplace_back(o2::aod::pwgem::dilepton::utils::emtrackutil::dcaXYinSigma(track));
+    dcaZ.emplace_back(o2::aod::pwgem::dilepton::utils::emtrackutil::dcaZinSigma(track));
+  }
+
+  void clear()
+  {
+    pt.clear();
+    eta.clear();
+    phi.clear();
+    sign.clear();
+    px.clear();
+    py.clear();
+    pz.clear();
+    e.clear();
+    dca3D.clear();
+    dcaXY.clear();
+    dcaZ.clear();
+  }
+
+  std::size_t size() const { return pt.size(); }
+};
+
+// Variables of a block of pairs, filled by computePairBlock().
+// The pair variables are the same as the ones of the per-pair functions of PairUtilities.h.
+struct PairBlock {
+  static constexpr int kSize = 64;
+
+  int n = 0;                   // number of pairs in the block
+  std::array<int, kSize> i1{}; // position of the first leg in its columns
+  std::array<int, kSize> i2{}; // position of the second leg in its columns
+
+  std::array<float, kSize> mass{};
+  std::array<float, kSize> pt{};
+  std::array<float, kSize> rapidity{};
+  std::array<float, kSize> phiv{};
+  std::array<float, kSize> opAng{};
+  std::array<float, kSize> deta{};    // eta1 - eta2
+  std::array<float, kSize> dphi{};    // phi1 - phi2 in [-pi, +pi]
+  std::array<float, kSize> detaQC{};  // leg with the larger sign * pT first
+  std::array<float, kSize> dphiQC{};  // leg with the larger sign * pT first, in [-pi, +pi]
+  std::array<float, kSize> dca3D{};   // quadratic sum of the 3D DCA in sigma, for the pair cut
+  std::array<float, kSize> pairDCA{}; // DCA of the output histograms
+  std::array<uint8_t, kSize> selected{};
+
+  bool add(const int first, const int second)
+  {
+    i1[n] = first;
+    i2[n] = second;
+    n++;
+    return n == kSize;
+  }
+};
+
+//_______________________________________________________________________
+inline float bringDeltaToPMPi(float dphi)
+{
+  // difference of two angles in [0, 2pi], no loop such that the block loops stay vectorizable
+  dphi -= o2::constants::math::TwoPI * (dphi > o2::constants::math::PI);
+  dphi += o2::constants::math::TwoPI * (dphi < -o2::constants::math::PI);
+  return dphi;
+}
+
+//_______________________________________________________________________
+/// Computes the pair variables of the pairs of the block
+/// \param dcaType is the DCA of the output histograms. 0:3D, 1:XY, 2:Z, else:3D
+/// \param useSignedDCA is to multiply the output DCA by the signs of the charges and of the single-track DCAs
+inline void computePairBlock(LeptonColumns const& c1, LeptonColumns const& c2, PairBlock& block, const float bz, const int dcaType, const bool useSignedDCA)
+{
+  const float* dca1 = dcaType == 1 ? c1.dcaXY.data() : (dcaType == 2 ? c1.dcaZ.data() : c1.dca3D.data());
+  const float* dca2 = dcaType == 1 ? c2.dcaXY.data() : (dcaType == 2 ? c2.dcaZ.data() : c2.dca3D.data());
+  const int n = block.n;
+
+  for (int ip = 0; ip < n; ip++) {
+    const int j1 = block.i1[ip];
+    const int j2 = block.i2[ip];
+    const double px = c1.px[j1] + c2.px[j2];
+    const double py = c1.py[j1] + c2.py[j2];
+    const double pz = c1.pz[j1] + c2.pz[j2];
+    const double e = c1.e[j1] + c2.e[j2];
+    const double m2 = e * e - px * px - py * py - pz * pz;
+    const double pt = std::sqrt(px * px + py * py);
+    block.mass[ip] = m2 > 0. ? std::sqrt(m2) : 0.;
+    block.pt[ip] = pt;
+    block.rapidity[ip] = 0.5 * std::log((e + pz) / (e - pz));
+
+    const float s1 = c1.sign[j1] * c1.pt[j1];
+    const float s2 = c2.sign[j2] * c2.pt[j2];
+    const float order = s1 > s2 ? 1.f : -1.f;
+    block.deta[ip] = c1.eta[j1] - c2.eta[j2];
+    block.dphi[ip] = bringDeltaToPMPi(c1.phi[j1] - c2.phi[j2]);
+    block.detaQC[ip] = order * block.deta[ip];
+    block.dphiQC[ip] = bringDeltaToPMPi(order * (c1.phi[j1] - c2.phi[j2]));
+
+    // phiv as in getPhivPair(): the orientation of the cross product depends on the field and on the leg order
+    const float p1x = c1.px[j1], p1y = c1.py[j1], p1z = c1.pz[j1];
+    const float p2x = c2.px[j2], p2y = c2.py[j2], p2z = c2.pz[j2];
+    const bool likeSign = c1.sign[j1] * c2.sign[j2] > 0;
+    const float fieldOrder = likeSign ? (bz < 0.f ? 1.f : -1.f) : (bz > 0.f ? 1.f : -1.f);
+    const float orient = order * fieldOrder;
+    const float cx = orient * (p1y * p2z - p1z * p2y);
+    const float cy = orient * (p1z * p2x - p1x * p2z);
+    const float cz = orient * (p1x * p2y - p1y * p2x);
+    const float cnorm = std::sqrt(cx * cx + cy * cy + cz * cz);
+    const float vx = cx / cnorm, vy = cy / cnorm, vz = cz / cnorm;
+    const float unorm = std::sqrt(static_cast<float>(px * px + py * py + pz * pz));
+    const float ux = px / unorm, uy = py / unorm, uz = pz / unorm;
+    const float uxy = std::sqrt(ux * ux + uy * uy);
+    const float ax = uy / uxy, ay = -ux / uxy;
+    const float wx = uy * vz - uz * vy;
+    const float wy = uz * vx - ux * vz;
+    const float cosPhiv = wx * ax + wy * ay;
+    block.phiv[ip] = std::acos(cosPhiv < -1.f ? -1.f : (cosPhiv > 1.f ? 1.f : cosPhiv));
+
+    const float p1 = std::sqrt(p1x * p1x + p1y * p1y + p1z * p1z);
+    const float p2 = std::sqrt(p2x * p2x + p2y * p2y + p2z * p2z);
+    const float cosOpAng = (p1x * p2x + p1y * p2y + p1z * p2z) / (p1 * p2);
+    block.opAng[ip] = std::acos(cosOpAng < -1.f ? -1.f : (cosOpAng > 1.f ? 1.f : cosOpAng));
+
+    block.dca3D[ip] = std::sqrt((c1.dca3D[j1] * c1.dca3D[j1] + c2.dca3D[j2] * c2.dca3D[j2]) / 2.f);
+    const float signDCA = useSignedDCA ? c1.sign[j1] * c2.sign[j2] * (dca1[j1] >= 0.f ? 1.f : -1.f) * (dca2[j2] >= 0.f ? 1.f : -1.f) : 1.f;
+    block.pairDCA[ip] = signDCA * std::sqrt((dca1[j1] * dca1[j1] + dca2[j2] * dca2[j2]) / 2.f);
+  }
+}
+//_______________________________________________________________________
+// Reference hadrons of a collision for the dilepton-hadron correlation.
+// The hadrons are kept as columns for the exact correlation, and are counted in an eta-phi grid when the grid is enabled.
+struct HadronGrid {
+  std::vector<int> trackId{};
+  std::vector<float> eta{};
+  std::vector<float> phi{};
+  std::vector<int> cell{};     // cell of each hadron in the grid
+  std::vector<float> counts{}; // number of hadrons per cell
+  std::vector<int> occupied{}; // cells with at least 1 hadron
+  std::unordered_map<int, int> positionOfTrack{};
+  int nEta = 0;
+  int nPhi = 0;
+  float minEta = 0.f;
+  float maxEta = 0.f;
+
+  /// \param nbinsEta and nbinsPhi are the numbers of cells in eta and in phi (0 to 2pi). The grid is disabled, if one of them is not positive.
+  void setGrid(const int nbinsEta, const int nbinsPhi, const float etaMin, const float etaMax)
+  {
+    nEta = nbinsEta > 0 && nbinsPhi > 0 ? nbinsEta : 0;
+    nPhi = nbinsEta > 0 && nbinsPhi > 0 ? nbinsPhi : 0;
+    minEta = etaMin;
+    maxEta = etaMax;
+    counts.assign(nEta * nPhi, 0.f);
+    occupied.clear();
+  }
+
+  bool useGrid() const { return nEta > 0; }
+
+  void add(const int id, const float teta, const float tphi)
+  {
+    positionOfTrack[id] = static_cast<int>(trackId.size());
+    trackId.emplace_back(id);
+    eta.emplace_back(teta);
+    phi.emplace_back(tphi);
+    if (!useGrid()) {
+      return;
+    }
+    int ieta = static_cast<int>((teta - minEta) / (maxEta - minEta) * nEta);
+    int iphi = static_cast<int>(tphi / o2::constants::math::TwoPI * nPhi);
+    ieta = ieta < 0 ? 0 : (ieta > nEta - 1 ? nEta - 1 : ieta);
+    iphi = iphi < 0 ? 0 : (iphi > nPhi - 1 ? nPhi - 1 : iphi);
+    const int c = ieta * nPhi + iphi;
+    if (counts[c] == 0.f) {
+      occupied.emplace_back(c);
+    }
+    counts[c] += 1.f;
+    cell.emplace_back(c);
+  }
+
+  void clear()
+  {
+    for (const auto& c : occupied) {
+      counts[c] = 0.f;
+    }
+    occupied.clear();
+    trackId.clear();
+    eta.clear();
+    phi.clear();
+    cell.clear();
+    positionOfTrack.clear();
+  }
+
+  // position of the track in the columns, -1 if the track is not a reference hadron
+  int findTrack(const int id) const
+  {
+    auto it = positionOfTrack.find(id);
+    return it != positionOfTrack.end() ? it->second : -1;
+  }
+
+  float etaCenter(const int c) const { return minEta + (c / nPhi + 0.5f) * (maxEta - minEta) / nEta; }
+  float phiCenter(const int c) const { return (c % nPhi + 0.5f) * o2::constants::math::TwoPI / nPhi; }
+  int size() const { return static_cast<int>(trackId.size()); }
+};
+//_______________________________________________________________________
+} // namespace o2::aod::pwgem::dilepton::utils::pairutil
+#endif // PWGEM_DILEPTON_UTILS_PAIRKERNEL_H_
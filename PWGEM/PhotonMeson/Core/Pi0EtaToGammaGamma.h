@@ -243,6 +243,10 @@ struct Pi0EtaToGammaGamma {
 
   std::vector<int> used_photonIds_per_col;                   // <ndf, trackId>
   std::vector<std::pair<int, int>> used_dileptonIds_per_col; // <ndf, trackId>
+  o2::aod::pwgem::photonmeson::photonpair::PhotonColumns photons1_columns;
+  o2::aod::pwgem::photonmeson::photonpair::PhotonColumns photons2_columns;
+  o2::aod::pwgem::photonmeson::photonpair::PhotonColumns photons_mix_columns;
+  o2::aod::pwgem::photonmeson::photonpair::DiphotonRow diphoton_row;
   std::map<std::pair<int, int>, uint64_t> map_mixed_eventId_to_globalBC;
 
   std::vector<float> zvtx_bin_edges;
@@ -697,6 +701,28 @@ struct Pi0EtaToGammaGamma {
   /// \param legs placeholder argument used only for template deduction (PCM/DalitzEE)
   /// \param matchedtracks table of matched global tracks to EMCal clusters (optional)
   /// \param matchedsecondaries table of matched secondary tracks to EMCal clusters (optional)
+  template <typename TPhotons>
+  void fillColumns(o2::aod::pwgem::photonmeson::photonpair::PhotonColumns& columns, TPhotons const& photons)
+  {
+    columns.clear();
+    for (const auto& g : photons) {
+      columns.add(g.pt(), g.eta(), g.phi());
+    }
+  }
+
+  // pairs of the photons of the current event with the photons of an event in the mixing pool
+  void fillMixedPairs(o2::aod::pwgem::photonmeson::photonpair::PhotonColumns const& columns1, o2::aod::pwgem::photonmeson::photonpair::PhotonColumns const& columns2, const float weight)
+  {
+    for (int i = 0; i < columns1.size(); i++) {
+      o2::aod::pwgem::photonmeson::photonpair::computeDiphotonRow(columns1, i, columns2, 0, maxY, diphoton_row);
+      for (int j = 0; j < columns2.size(); j++) {
+        if (diphoton_row.selected[j]) {
+          fRegistry.fill(HIST("Pair/mix/hs"), diphoton_row.mass[j], diphoton_row.pt[j], weight);
+        }
+      }
+    }
+  }
+
   template <typename TDetectorTag1, typename TDetectorTag2, template <typename...> class TCombinationPolicy = o2::soa::CombinationsStrictlyUpperIndexPolicy, o2::soa::is_table TCollisions, o2::soa::is_table TPhotons1, o2::soa::is_table TPhotons2, typename TLegs = std::nullptr_t, typename TMatchedTracks = std::nullptr_t, typename TMatchedSecondaries = std::nullptr_t>
   void runPairing(TCollisions const& collisions,
                   TPhotons1 const& photons1, TPhotons2 const& photons2, TLegs const& /*legs*/ = nullptr, TMatchedTracks const& matchedTracks = nullptr, TMatchedSecondaries const& matchedSecondaries = nullptr)
@@ -845,7 +871,12 @@ struct Pi0EtaToGammaGamma {
         auto photons1_per_collision = photons1.sliceByCached(TDetectorTag1::perCollision(), collision.globalIndex(), cache);
         auto photons2_per_collision = photons2.sliceByCached(TDetectorTag2::perCollision(), collision.globalIndex(), cache);
 
-        for (const auto& [g1, g2] : o2::soa::combinations(TCombinationPolicy(photons1_per_collision, photons2_per_collision))) {
+        // the photon cuts are applied once per photon, and the pair variables are computed for a row of pairs at once.
+        // photons of the same kind come from the same table, and each pair is taken once, as with CombinationsStrictlyUpperIndexPolicy.
+        constexpr bool isSameKind = std::is_same_v<TDetectorTag1, TDetectorTag2>;
+        photons1_columns.clear();
+        photons2_columns.clear();
+        for (const auto& g1 : photons1_per_collision) {
           if constexpr (std::is_same_v<TDetectorTag1, EMCTag>) {
             // For the EMCal case we need to get the primary and secondary matched tracks
             auto matchedTracks1 = matchedTracks.sliceByCached(TDetectorTag1::perClusterMT(), g1.globalIndex(), cache);
@@ -855,41 +886,50 @@ struct Pi0EtaToGammaGamma {
               continue;
             }
           } else {
-            if (!TDetectorTag1::applyCut(*this, g1) || !TDetectorTag2::applyCut(*this, g2)) {
+            if (!TDetectorTag1::applyCut(*this, g1)) {
               continue;
             }
           }
-
-          if constexpr (std::is_same_v<TDetectorTag2, EMCTag>) {
-            auto matchedTracks2 = matchedTracks.sliceByCached(TDetectorTag2::perClusterMT(), g2.globalIndex(), cache);
-            auto matchedSecondaries2 = matchedSecondaries.sliceByCached(TDetectorTag2::perClusterMS(), g2.globalIndex(), cache);
-            if (!TDetectorTag2::applyCut(*this, g2, matchedTracks2, matchedSecondaries2)) {
-              continue;
+          photons1_columns.add(g1.pt(), g1.eta(), g1.phi());
+        }
+        if constexpr (!isSameKind) {
+          for (const auto& g2 : photons2_per_collision) {
+            if constexpr (std::is_same_v<TDetectorTag2, EMCTag>) {
+              auto matchedTracks2 = matchedTracks.sliceByCached(TDetectorTag2::perClusterMT(), g2.globalIndex(), cache);
+              auto matchedSecondaries2 = matchedSecondaries.sliceByCached(TDetectorTag2::perClusterMS(), g2.globalIndex(), cache);
+              if (!TDetectorTag2::applyCut(*this, g2, matchedTracks2, matchedSecondaries2)) {
+                continue;
+              }
+            } else {
+              if (!TDetectorTag2::applyCut(*this, g2)) {
+                continue;
+              }
             }
-          } else {
-            if (!TDetectorTag2::applyCut(*this, g2)) {
+            photons2_columns.add(g2.pt(), g2.eta(), g2.phi());
+          }
+        }
+        auto& columns2 = isSameKind ? photons1_columns : photons2_columns;
+
+        for (int i = 0; i < photons1_columns.size(); i++) {
+          const int jBegin = isSameKind ? i + 1 : 0;
+          o2::aod::pwgem::photonmeson::photonpair::computeDiphotonRow(photons1_columns, i, columns2, jBegin, maxY, diphoton_row);
+          for (int j = jBegin; j < columns2.size(); j++) {
+            if (!diphoton_row.selected[j]) {
               continue;
             }
-          }
-
-          ROOT::Math::PtEtaPhiMVector v1(g1.pt(), g1.eta(), g1.phi(), 0.);
-          ROOT::Math::PtEtaPhiMVector v2(g2.pt(), g2.eta(), g2.phi(), 0.);
-          ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
-          if (std::fabs(v12.Rapidity()) > maxY) {
-            continue;
-          }
 
-          fRegistry.fill(HIST("Pair/same/hs"), v12.M(), v12.Pt(), weight);
+            fRegistry.fill(HIST("Pair/same/hs"), diphoton_row.mass[j], diphoton_row.pt[j], weight);
 
-          if (std::find(used_photonIds_per_col.begin(), used_photonIds_per_col.end(), g1.globalIndex()) == used_photonIds_per_col.end()) {
-            emh1->AddTrackToEventPool(key_df_collision, o2::aod::pwgem::dilepton::utils::EMTrack(g1.pt(), g1.eta(), g1.phi(), 0));
-            used_photonIds_per_col.emplace_back(g1.globalIndex());
-          }
-          if (std::find(used_photonIds_per_col.begin(), used_photonIds_per_col.end(), g2.globalIndex()) == used_photonIds_per_col.end()) {
-            emh2->AddTrackToEventPool(key_df_collision, o2::aod::pwgem::dilepton::utils::EMTrack(g2.pt(), g2.eta(), g2.phi(), 0));
-            used_photonIds_per_col.emplace_back(g2.globalIndex());
+            if (!photons1_columns.used[i]) {
+              emh1->AddTrackToEventPool(key_df_collision, o2::aod::pwgem::dilepton::utils::EMTrack(photons1_columns.pt[i], photons1_columns.eta[i], photons1_columns.phi[i], 0));
+              photons1_columns.used[i] = 1;
+            }
+            if (!columns2.used[j]) {
+              emh2->AddTrackToEventPool(key_df_collision, o2::aod::pwgem::dilepton::utils::EMTrack(columns2.pt[j], columns2.eta[j], columns2.phi[j], 0));
+              columns2.used[j] = 1;
+            }
+            ndiphoton++;
           }
-          ndiphoton++;
         } // end of pairing loop
       } // end of pairing in same event
 
@@ -911,6 +951,7 @@ struct Pi0EtaToGammaGamma {
       auto collisionIds2_in_mixing_pool = emh2->GetCollisionIdsFromEventPool(key_bin);
 
       if constexpr (pairtype == o2::aod::pwgem::photonmeson::photonpair::PairType::kPCMPCM || pairtype == o2::aod::pwgem::photonmeson::photonpair::PairType::kPHOSPHOS || pairtype == o2::aod::pwgem::photonmeson::photonpair::PairType::kEMCEMC) { // same kinds pairing
+        fillColumns(photons1_columns, selected_photons1_in_this_event);
         for (const auto& mix_dfId_collisionId : collisionIds1_in_mixing_pool) {
           int mix_dfId = mix_dfId_collisionId.first;
           int64_t mix_collisionId = mix_dfId_collisionId.second;
@@ -929,21 +970,15 @@ struct Pi0EtaToGammaGamma {
           auto photons1_from_event_pool = emh1->GetTracksPerCollision(mix_dfId_collisionId);
           // LOGF(info, "Do event mixing: current event (%d, %d), ngamma = %d | event pool (%d, %d), ngamma = %d", ndf, collision.globalIndex(), selected_photons1_in_this_event.size(), mix_dfId, mix_collisionId, photons1_from_event_pool.size());
 
-          for (const auto& g1 : selected_photons1_in_this_event) {
-            for (const auto& g2 : photons1_from_event_pool) {
-              ROOT::Math::PtEtaPhiMVector v1(g1.pt(), g1.eta(), g1.phi(), 0.);
-              ROOT::Math::PtEtaPhiMVector v2(g2.pt(), g2.eta(), g2.phi(), 0.);
-              ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
-              if (std::fabs(v12.Rapidity()) > maxY) {
-                continue;
-              }
-
-              fRegistry.fill(HIST("Pair/mix/hs"), v12.M(), v12.Pt(), weight);
-            }
-          }
+          fillColumns(photons_mix_columns, photons1_from_event_pool);
+          fillMixedPairs(photons1_columns, photons_mix_columns, weight);
         } // end of loop over mixed event pool
 
       } else { // [photon1 from event1, photon2 from event2] and [photon1 from event2, photon2 from event1]
+        if constexpr (pairtype != o2::aod::pwgem::photonmeson::photonpair::PairType::kPCMDalitzEE) {
+          fillColumns(photons1_columns, selected_photons1_in_this_event);
+          fillColumns(photons2_columns, selected_photons2_in_this_event);
+        }
         for (const auto& mix_dfId_collisionId : collisionIds2_in_mixing_pool) {
           int mix_dfId = mix_dfId_collisionId.first;
           int64_t mix_collisionId = mix_dfId_collisionId.second;
@@ -962,19 +997,22 @@ struct Pi0EtaToGammaGamma {
           auto photons2_from_event_pool = emh2->GetTracksPerCollision(mix_dfId_collisionId);
           // LOGF(info, "Do event mixing: current event (%d, %d), ngamma = %d | event pool (%d, %d), nll = %d", ndf, collision.globalIndex(), selected_photons1_in_this_event.size(), mix_dfId, mix_collisionId, photons2_from_event_pool.size());
 
-          for (const auto& g1 : selected_photons1_in_this_event) {
-            for (const auto& g2 : photons2_from_event_pool) {
-              ROOT::Math::PtEtaPhiMVector v1(g1.pt(), g1.eta(), g1.phi(), 0.);
-              ROOT::Math::PtEtaPhiMVector v2(g2.pt(), g2.eta(), g2.phi(), 0.);
-              if constexpr (pairtype == o2::aod::pwgem::photonmeson::photonpair::PairType::kPCMDalitzEE) { //[photon from event1, dilepton from event2] and [photon from event2, dilepton from event1]
+          if constexpr (pairtype == o2::aod::pwgem::photonmeson::photonpair::PairType::kPCMDalitzEE) { //[photon from event1, dilepton from event2] and [photon from event2, dilepton from event1]
+            for (const auto& g1 : selected_photons1_in_this_event) {
+              for (const auto& g2 : photons2_from_event_pool) {
+                ROOT::Math::PtEtaPhiMVector v1(g1.pt(), g1.eta(), g1.phi(), 0.);
+                ROOT::Math::PtEtaPhiMVector v2(g2.pt(), g2.eta(), g2.phi(), 0.);
                 v2.SetM(g2.mass());
+                ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
+                if (std::fabs(v12.Rapidity()) > maxY) {
+                  continue;
+                }
+                fRegistry.fill(HIST("Pair/mix/hs"), v12.M(), v12.Pt(), weight);
               }
-              ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
-              if (std::fabs(v12.Rapidity()) > maxY) {
-                continue;
-              }
-              fRegistry.fill(HIST("Pair/mix/hs"), v12.M(), v12.Pt(), weight);
             }
+          } else {
+            fillColumns(photons_mix_columns, photons2_from_event_pool);
+            fillMixedPairs(photons1_columns, photons_mix_columns, weight);
           }
         } // end of loop over mixed event pool
         for (const auto& mix_dfId_collisionId : collisionIds1_in_mixing_pool) {
@@ -995,19 +1033,22 @@ struct Pi0EtaToGammaGamma {
           auto photons1_from_event_pool = emh1->GetTracksPerCollision(mix_dfId_collisionId);
           // LOGF(info, "Do event mixing: current event (%d, %d), nll = %d | event pool (%d, %d), ngamma = %d", ndf, collision.globalIndex(), selected_photons2_in_this_event.size(), mix_dfId, mix_collisionId, photons1_from_event_pool.size());
 
-          for (const auto& g1 : selected_photons2_in_this_event) {
-            for (const auto& g2 : photons1_from_event_pool) {
-              ROOT::Math::PtEtaPhiMVector v1(g1.pt(), g1.eta(), g1.phi(), 0.);
-              ROOT::Math::PtEtaPhiMVector v2(g2.pt(), g2.eta(), g2.phi(), 0.);
-              if constexpr (pairtype == o2::aod::pwgem::photonmeson::photonpair::PairType::kPCMDalitzEE) { //[photon from event1, dilepton from event2] and [photon from event2, dilepton from event1]
+          if constexpr (pairtype == o2::aod::pwgem::photonmeson::photonpair::PairType::kPCMDalitzEE) { //[photon from event1, dilepton from event2] and [photon from event2, dilepton from event1]
+            for (const auto& g1 : selected_photons2_in_this_event) {
+              for (const auto& g2 : photons1_from_event_pool) {
+                ROOT::Math::PtEtaPhiMVector v1(g1.pt(), g1.eta(), g1.phi(), 0.);
+                ROOT::Math::PtEtaPhiMVector v2(g2.pt(), g2.eta(), g2.phi(), 0.);
                 v1.SetM(g1.mass());
+                ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
+                if (std::fabs(v12.Rapidity()) > maxY) {
+                  continue;
+                }
+                fRegistry.fill(HIST("Pair/mix/hs"), v12.M(), v12.Pt(), weight);
               }
-              ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
-              if (std::fabs(v12.Rapidity()) > maxY) {
-                continue;
-              }
-              fRegistry.fill(HIST("Pair/mix/hs"), v12.M(), v12.Pt(), weight);
             }
+          } else {
+            fillColumns(photons_mix_columns, photons1_from_event_pool);
+            fillMixedPairs(photons2_columns, photons_mix_columns, weight);
           }
         } // end of loop over mixed event pool
       }
@@ -47,16 +47,17 @@ enum Observable {
 };
 
 // Values in tables are stored in downscaled format to save disk space
+// The resolution of a stored value is 1 / downscalingFactor, the range is given by the storage type
 const float downscalingFactors[nObservables]{
   1E0, // Cluster definition
-  1E3, // Cluster energy
-  1E4, // Cluster eta
-  1E4, // Cluster phi
+  1E3, // Cluster energy: 1 MeV, up to ~65 GeV (uint16_t)
+  1E4, // Cluster eta: 1E-4, |eta| < ~3.2 (int16_t)
+  1E4, // Cluster phi: 1E-4 rad, 0 to 2pi (uint16_t)
   1E0, // Number of cells + exotic
-  1E4, // M02
-  1E2, // Cluster time
-  1E5, // diff between cluster and track in eta
-  1E5, // diff between cluster and track in phi
+  1E4, // M02: 1E-4, up to ~3.2 (int16_t)
+  1E2, // Cluster time: 10 ps, |t| < ~327 ns (int16_t)
+  1E5, // diff between cluster and track in eta: 1E-5, |deta| < ~0.32 (int16_t)
+  1E5, // diff between cluster and track in phi: 1E-5 rad, |dphi| < ~0.32 (int16_t)
 };
 
 /// \brief convert values for storage into correspoding smaller types
@@ -29,6 +29,7 @@
 
 #include <TPDGCode.h>
 
+#include <cstdint>
 #include <map>
 #include <vector>
 
@@ -118,16 +119,60 @@ struct AssociateMCInfoPhoton {
   std::vector<uint16_t> genPi0;   // primary, pt, y
   std::vector<uint16_t> genEta;   // primary, pt, y
 
+  // skimmed MC stack of the current data frame
+  std::vector<int> fNewLabels;               // new label of each particle in aod::McParticles, -1 if not stored
+  std::vector<uint8_t> fIsMotherChainStored; // the whole first-mother chain of this particle is stored
+  std::vector<int64_t> fNewLabelsReversed;   // index in aod::McParticles of each new label
+  std::vector<int> fEventIdx;                // index of the MC event of each new label
+
+  // if the MC truth particle is not already written, add it to the skimmed MC stack
+  void storeParticle(const int64_t globalIndex, const int eventIdx)
+  {
+    if (fNewLabels[globalIndex] < 0) {
+      fNewLabels[globalIndex] = static_cast<int>(fNewLabelsReversed.size());
+      fNewLabelsReversed.emplace_back(globalIndex);
+      fEventIdx.emplace_back(eventIdx);
+    }
+  }
+
+  // add the first-mother chain of a stored particle to the skimmed MC stack.
+  // The walk stops at the first mother whose chain is already stored, such that each chain is walked once per data frame.
+  template <typename TMCParticle, typename TMCParticles>
+  void storeMotherChain(TMCParticle const& mcParticle, TMCParticles const& mcParticles, const int eventIdx)
+  {
+    if (fIsMotherChainStored[mcParticle.globalIndex()]) {
+      return;
+    }
+    fIsMotherChainStored[mcParticle.globalIndex()] = 1;
+    int motherid = -999; // first mother index
+    if (mcParticle.has_mothers()) {
+      motherid = mcParticle.mothersIds()[0]; // first mother index
+    }
+    while (motherid > -1 && motherid < mcParticles.size()) { // protect against bad mother indices
+      if (fIsMotherChainStored[motherid]) {
+        break;
+      }
+      storeParticle(motherid, eventIdx);
+      fIsMotherChainStored[motherid] = 1;
+      auto mp = mcParticles.iteratorAt(motherid);
+      if (mp.has_mothers()) {
+        motherid = mp.mothersIds()[0]; // first mother index
+      } else {
+        motherid = -999;
+      }
+    }
+  }
+
   template <uint8_t system, typename TTracks, typename TFwdTracks, typename TPCMs, typename TPCMLegs, typename TPHOSs, typename TEMCs, typename TEMPrimaryElectrons>
   void skimmingMC(MyCollisionsMC const& collisions, aod::BCs const&, aod::McCollisions const& mcCollisions, aod::McParticles const& mcParticles, TTracks const& o2tracks, TFwdTracks const&, TPCMs const& v0photons, TPCMLegs const& legs, TPHOSs const&, TEMCs const& emcclusters, TEMPrimaryElectrons const& emprimaryelectrons)
   {
     // temporary variables used for the indexing of the skimmed MC stack
-    std::map<uint64_t, int> fNewLabels;
-    std::map<uint64_t, int> fNewLabelsReversed;
-    // std::map<uint64_t, uint16_t> fMCFlags;
-    std::map<uint64_t, int> fEventIdx;
+    fNewLabels.assign(mcParticles.size(), -1);
+    fIsMotherChainStored.assign(mcParticles.size(), 0);
+    fNewLabelsReversed.clear();
+    fEventIdx.clear();
     std::map<uint64_t, int> fEventLabels;
-    int fCounters[2] = {0, 0}; //! [0] - particle counter, [1] - event counter
+    int fEventCounter = 0; //! event counter
     auto hBinFinder = registry.get<TH2>(HIST("Generated/h2PtY_Gamma"));
 
     // collision iterator from EMCal cluster
@@ -196,8 +241,8 @@ struct AssociateMCInfoPhoton {
       // make an entry for this MC event only if it was not already added to the table
       if (!(fEventLabels.find(mcCollisionIter.globalIndex()) != fEventLabels.end())) {
         mcevents(mcCollisionIter.globalIndex(), mcCollisionIter.generatorsID(), mcCollisionIter.posX(), mcCollisionIter.posY(), mcCollisionIter.posZ(), mcCollisionIter.impactParameter(), mcCollisionIter.eventPlaneAngle());
-        fEventLabels[mcCollisionIter.globalIndex()] = fCounters[1];
-        fCounters[1]++;
+        fEventLabels[mcCollisionIter.globalIndex()] = fEventCounter;
+        fEventCounter++;
         binnedGenPt(genGamma, genPi0, genEta);
       }
 
@@ -226,22 +271,10 @@ struct AssociateMCInfoPhoton {
 
           if (motherParticle.pdgCode() == PDG_t::kGamma && (motherParticle.isPhysicalPrimary() || motherParticle.producedByGenerator()) && std::fabs(motherParticle.eta()) < max_eta_gen_secondary) {
             // if the MC truth particle corresponding to this reconstructed track which is not already written, add it to the skimmed MC stack
-            if (!(fNewLabels.find(mcParticle.globalIndex()) != fNewLabels.end())) { // store electron information. !!Not photon!!
-              fNewLabels[mcParticle.globalIndex()] = fCounters[0];
-              fNewLabelsReversed[fCounters[0]] = mcParticle.globalIndex();
-              // fMCFlags[mcParticle.globalIndex()] = mcflags;
-              fEventIdx[mcParticle.globalIndex()] = fEventLabels.find(mcCollisionIter.globalIndex())->second;
-              fCounters[0]++;
-            }
+            storeParticle(mcParticle.globalIndex(), fEventLabels.find(mcCollisionIter.globalIndex())->second); // store electron information. !!Not photon!!
 
             // if the MC truth particle corresponding to this reconstructed track which is not already written, add it to the skimmed MC stack
-            if (!(fNewLabels.find(motherParticle.globalIndex()) != fNewLabels.end())) { // store conversion photon
-              fNewLabels[motherParticle.globalIndex()] = fCounters[0];
-              fNewLabelsReversed[fCounters[0]] = motherParticle.globalIndex();
-              // fMCFlags[motherParticle.globalIndex()] = mcflags;
-              fEventIdx[motherParticle.globalIndex()] = fEventLabels.find(mcCollisionIter.globalIndex())->second;
-              fCounters[0]++;
-            }
+            storeParticle(motherParticle.globalIndex(), fEventLabels.find(mcCollisionIter.globalIndex())->second); // store conversion photon
           }
         }
       } // end of mc track loop
@@ -279,42 +312,11 @@ struct AssociateMCInfoPhoton {
           // LOGF(info, "mcParticleIter.globalIndex() = %d, mcParticleIter.index() = %d", mcParticleIter.globalIndex(), mcParticleIter.index()); // these are exactly the same.
 
           // if the MC truth particle corresponding to this reconstructed track which is not already written, add it to the skimmed MC stack
-          if (!(fNewLabels.find(mcParticleIter.globalIndex()) != fNewLabels.end())) {
-            fNewLabels[mcParticleIter.globalIndex()] = fCounters[0];
-            fNewLabelsReversed[fCounters[0]] = mcParticleIter.globalIndex();
-            // fMCFlags[mcParticleIter.globalIndex()] = mcflags;
-            fEventIdx[mcParticleIter.globalIndex()] = fEventLabels.find(mcCollisionIter.globalIndex())->second;
-            fCounters[0]++;
-          }
-          v0legmclabels(fNewLabels.find(mcParticleIter.index())->second, o2TrackIter.mcMask());
+          storeParticle(mcParticleIter.globalIndex(), fEventLabels.find(mcCollisionIter.globalIndex())->second);
+          v0legmclabels(fNewLabels[mcParticleIter.globalIndex()], o2TrackIter.mcMask());
 
           // Next, store mother-chain of this reconstructed track.
-          int motherid = -999; // first mother index
-          if (mcParticleIter.has_mothers()) {
-            motherid = mcParticleIter.mothersIds()[0]; // first mother index
-          }
-          while (motherid > -1) {
-            if (motherid < mcParticles.size()) { // protect against bad mother indices. why is this needed?
-              motherParticle.setCursor(motherid);
-
-              // if the MC truth particle corresponding to this reconstructed track which is not already written, add it to the skimmed MC stack
-              if (!(fNewLabels.find(motherParticle.globalIndex()) != fNewLabels.end())) {
-                fNewLabels[motherParticle.globalIndex()] = fCounters[0];
-                fNewLabelsReversed[fCounters[0]] = motherParticle.globalIndex();
-                // fMCFlags[motherParticle.globalIndex()] = mcflags;
-                fEventIdx[motherParticle.globalIndex()] = fEventLabels.find(mcCollisionIter.globalIndex())->second;
-                fCounters[0]++;
-              }
-
-              if (motherParticle.has_mothers()) {
-                motherid = motherParticle.mothersIds()[0]; // first mother index
-              } else {
-                motherid = -999;
-              }
-            } else {
-              motherid = -999;
-            }
-          } // end of mother chain loop
+          storeMotherChain(mcParticleIter, mcParticles, fEventLabels.find(mcCollisionIter.globalIndex())->second);
         } // end of leg loop
       } // end of v0 loop
     }
@@ -336,42 +338,11 @@ struct AssociateMCInfoPhoton {
         mcParticleIter.setCursor(o2TrackIter.mcParticleId());
 
         // if the MC truth particle corresponding to this reconstructed track which is not already written, add it to the skimmed MC stack
-        if (!(fNewLabels.find(mcParticleIter.globalIndex()) != fNewLabels.end())) {
-          fNewLabels[mcParticleIter.globalIndex()] = fCounters[0];
-          fNewLabelsReversed[fCounters[0]] = mcParticleIter.globalIndex();
-          // fMCFlags[mcParticleIter.globalIndex()] = mcflags;
-          fEventIdx[mcParticleIter.globalIndex()] = fEventLabels.find(mcCollisionIter.globalIndex())->second;
-          fCounters[0]++;
-        }
-        emprimaryelectronmclabels(fNewLabels.find(mcParticleIter.index())->second, o2TrackIter.mcMask());
+        storeParticle(mcParticleIter.globalIndex(), fEventLabels.find(mcCollisionIter.globalIndex())->second);
+        emprimaryelectronmclabels(fNewLabels[mcParticleIter.globalIndex()], o2TrackIter.mcMask());
 
         // Next, store mother-chain of this reconstructed track.
-        int motherid = -999; // first mother index
-        if (mcParticleIter.has_mothers()) {
-          motherid = mcParticleIter.mothersIds()[0]; // first mother index
-        }
-        while (motherid > -1) {
-          if (motherid < mcParticles.size()) { // protect against bad mother indices. why is this needed?
-            motherParticle.setCursor(motherid);
-
-            // if the MC truth particle corresponding to this reconstructed track which is not already written, add it to the skimmed MC stack
-            if (!(fNewLabels.find(motherParticle.globalIndex()) != fNewLabels.end())) {
-              fNewLabels[motherParticle.globalIndex()] = fCounters[0];
-              fNewLabelsReversed[fCounters[0]] = motherParticle.globalIndex();
-              // fMCFlags[motherParticle.globalIndex()] = mcflags;
-              fEventIdx[motherParticle.globalIndex()] = fEventLabels.find(mcCollisionIter.globalIndex())->second;
-              fCounters[0]++;
-            }
-
-            if (motherParticle.has_mothers()) {
-              motherid = motherParticle.mothersIds()[0]; // first mother index
-            } else {
-              motherid = -999;
-            }
-          } else {
-            motherid = -999;
-          }
-        } // end of mother chain loop
+        storeMotherChain(mcParticleIter, mcParticles, fEventLabels.find(mcCollisionIter.globalIndex())->second);
 
       } // end of em primary electron loop
     }
@@ -397,41 +368,12 @@ struct AssociateMCInfoPhoton {
           mcPhoton.setCursor(emcParticleId);
 
           // if the MC truth particle corresponding to this reconstructed track which is not already written, add it to the skimmed MC stack
-          if (!(fNewLabels.find(mcPhoton.globalIndex()) != fNewLabels.end())) {
-            fNewLabels[mcPhoton.globalIndex()] = fCounters[0];
-            fNewLabelsReversed[fCounters[0]] = mcPhoton.globalIndex();
-            fEventIdx[mcPhoton.globalIndex()] = fEventLabels.find(mcCollisionIter.globalIndex())->second;
-            fCounters[0]++;
-          }
-          vEmcMcParticleIds.emplace_back(fNewLabels.find(mcPhoton.index())->second);
-          // ememcclustermclabels(fNewLabels.find(mcPhoton.index())->second);
+          storeParticle(mcPhoton.globalIndex(), fEventLabels.find(mcCollisionIter.globalIndex())->second);
+          vEmcMcParticleIds.emplace_back(fNewLabels[mcPhoton.globalIndex()]);
+          // ememcclustermclabels(fNewLabels[mcPhoton.globalIndex()]);
 
           // Next, store mother-chain of this reconstructed track.
-          int motherid = -999; // first mother index
-          if (mcPhoton.has_mothers()) {
-            motherid = mcPhoton.mothersIds()[0]; // first mother index
-          }
-          while (motherid > -1) {
-            if (motherid < mcParticles.size()) { // protect against bad mother indices. why is this needed?
-              motherParticle.setCursor(motherid);
-
-              // if the MC truth particle corresponding to this reconstructed track which is not already written, add it to the skimmed MC stack
-              if (!(fNewLabels.find(motherParticle.globalIndex()) != fNewLabels.end())) {
-                fNewLabels[motherParticle.globalIndex()] = fCounters[0];
-                fNewLabelsReversed[fCounters[0]] = motherParticle.globalIndex();
-                fEventIdx[motherParticle.globalIndex()] = fEventLabels.find(mcCollisionIter.globalIndex())->second;
-                fCounters[0]++;
-              }
-
-              if (motherParticle.has_mothers()) {
-                motherid = motherParticle.mothersIds()[0]; // first mother index
-              } else {
-                motherid = -999;
-              }
-            } else {
-              motherid = -999;
-            }
-          } // end of mother chain loop
+          storeMotherChain(mcPhoton, mcParticles, fEventLabels.find(mcCollisionIter.globalIndex())->second);
 
         } // end of loop over mc particles of the current emc cluster
         ememcclustermclabels(vEmcMcParticleIds);
@@ -440,7 +382,7 @@ struct AssociateMCInfoPhoton {
     }
 
     //  Loop over the label map, create the mother/daughter relationships if these exist and write the skimmed MC stack
-    for (const auto& [newLabel, oldLabel] : fNewLabelsReversed) {
+    for (const auto& oldLabel : fNewLabelsReversed) {
       mcParticleIter.setCursor(oldLabel);
       // uint16_t mcflags = fMCFlags.find(oldLabel)->second;
 
@@ -448,8 +390,8 @@ struct AssociateMCInfoPhoton {
       if (mcParticleIter.has_mothers()) {
         for (const auto& m : mcParticleIter.mothersIds()) {
           if (m < mcParticles.size()) { // protect against bad mother indices
-            if (fNewLabels.find(m) != fNewLabels.end()) {
-              mothers.push_back(fNewLabels.find(m)->second);
+            if (m > -1 && fNewLabels[m] > -1) {
+              mothers.push_back(fNewLabels[m]);
             }
           } else {
             LOG(info) << "Mother label (" << m << ") exceeds the McParticles size (" << mcParticles.size() << ")";
@@ -467,8 +409,8 @@ struct AssociateMCInfoPhoton {
           if (d < mcParticles.size()) { // protect against bad daughter indices
             // auto dau_tmp = mcParticles.iteratorAt(d);
             // LOGF(info, "daughter pdg = %d", dau_tmp.pdgCode());
-            if (fNewLabels.find(d) != fNewLabels.end()) {
-              daughters.push_back(fNewLabels.find(d)->second);
+            if (fNewLabels[d] > -1) {
+              daughters.push_back(fNewLabels[d]);
             }
           } else {
             LOG(error) << "Daughter label (" << d << ") exceeds the McParticles size (" << mcParticles.size() << ")";
@@ -477,19 +419,18 @@ struct AssociateMCInfoPhoton {
         }
       }
 
-      emmcparticles(fEventIdx.find(oldLabel)->second, mcParticleIter.pdgCode(), mcParticleIter.flags(), mcParticleIter.statusCode(),
+      emmcparticles(fEventIdx[fNewLabels[oldLabel]], mcParticleIter.pdgCode(), mcParticleIter.flags(), mcParticleIter.statusCode(),
                     mothers, daughters,
                     mcParticleIter.px(), mcParticleIter.py(), mcParticleIter.pz(), mcParticleIter.e(),
                     mcParticleIter.vx(), mcParticleIter.vy(), mcParticleIter.vz());
     } // end loop over labels
 
     fNewLabels.clear();
+    fIsMotherChainStored.clear();
     fNewLabelsReversed.clear();
-    // fMCFlags.clear();
     fEventIdx.clear();
     fEventLabels.clear();
-    fCounters[0] = 0;
-    fCounters[1] = 0;
+    fEventCounter = 0;
   } // end of skimmingMC
 
   void processMC_PCM(MyCollisionsMC const& collisions, aod::BCs const& bcs, aod::McCollisions const& mccollisions, aod::McParticles const& mcParticles, TracksMC const& o2tracks, aod::V0PhotonsKF const& v0photons, aod::V0Legs const& v0legs)
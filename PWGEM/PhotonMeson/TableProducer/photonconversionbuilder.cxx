@@ -450,7 +450,7 @@ struct PhotonConversionBuilder {
     return true;
   }
 
-  float cospaXY_KF(KFParticle kfp, KFParticle PV)
+  float cospaXY_KF(const KFParticle& kfp, const KFParticle& PV)
   {
     float lx = kfp.GetX() - PV.GetX(); // flight length X
     float ly = kfp.GetY() - PV.GetY(); // flight length Y
@@ -466,7 +466,7 @@ struct PhotonConversionBuilder {
     return cospaXY;
   }
 
-  float cospaRZ_KF(KFParticle kfp, KFParticle PV)
+  float cospaRZ_KF(const KFParticle& kfp, const KFParticle& PV)
   {
     float lx = kfp.GetX() - PV.GetX();              // flight length X
     float ly = kfp.GetY() - PV.GetY();              // flight length Y
@@ -502,6 +502,41 @@ struct PhotonConversionBuilder {
     }
   }
 
+  // V0 leg at IU, DCA to the collision and KF daughter, shared by all the V0s of the leg in the collision
+  struct V0Leg {
+    bool isOK{false}; // false if the TPC drift correction failed
+    o2::track::TrackParCov track{};
+    float dcaXY{999.f};
+    float dcaZ{999.f};
+    KFParticle kfp{};
+  };
+  std::map<std::pair<int64_t, int64_t>, V0Leg> v0leg_map; // (collision.globalIndex(), track.globalIndex()) -> V0 leg
+
+  template <class TBCs, class TCollisions, typename TCollision, typename TTrack>
+  const V0Leg& getV0Leg(TCollision const& collision, TTrack const& track)
+  {
+    const auto key = std::make_pair(static_cast<int64_t>(collision.globalIndex()), static_cast<int64_t>(track.globalIndex()));
+    if (auto found = v0leg_map.find(key); found != v0leg_map.end()) {
+      return found->second;
+    }
+    V0Leg& leg = v0leg_map[key];
+    leg.track = getTrackParCov(track);
+    if (moveTPCTracks && isTPConlyTrack(track) && !mVDriftMgr.moveTPCTrack<TBCs, TCollisions>(collision, track, leg.track)) {
+      LOGP(error, "failed correction for {} tpc track", track.sign() > 0 ? "positive" : "negative");
+      return leg;
+    }
+    std::array<float, 2> dcaInfo;
+    auto trackC = leg.track;
+    trackC.setPID(o2::track::PID::Electron);
+    o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackC, 2.f, matCorr, &dcaInfo);
+    leg.dcaXY = dcaInfo[0];
+    leg.dcaZ = dcaInfo[1];
+    KFPTrack kfp_track = createKFPTrackFromTrackParCov(leg.track, track.sign(), track.tpcNClsFound(), track.tpcChi2NCl());
+    leg.kfp = KFParticle(kfp_track, track.sign() > 0 ? kPositron : kElectron);
+    leg.isOK = true;
+    return leg;
+  }
+
   template <bool isMC, class TBCs, class TCollisions, class TTracks, typename TV0>
   void fillV0Table(TV0 const& v0, const bool filltable)
   {
@@ -545,27 +580,21 @@ struct PhotonConversionBuilder {
     // Calculate DCA with respect to the collision associated to the v0, not individual tracks
     std::array<float, 2> dcaInfo;
 
-    auto pTrack = getTrackParCov(pos);
-    if (moveTPCTracks && isTPConlyTrack(pos) && !mVDriftMgr.moveTPCTrack<TBCs, TCollisions>(collision, pos, pTrack)) {
-      LOGP(error, "failed correction for positive tpc track");
+    const V0Leg& posLeg = getV0Leg<TBCs, TCollisions>(collision, pos);
+    if (!posLeg.isOK) {
       return;
     }
-    auto pTrackC = pTrack;
-    pTrackC.setPID(o2::track::PID::Electron);
-    o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, pTrackC, 2.f, matCorr, &dcaInfo);
-    auto posdcaXY = dcaInfo[0];
-    auto posdcaZ = dcaInfo[1];
-
-    auto nTrack = getTrackParCov(ele);
-    if (moveTPCTracks && isTPConlyTrack(ele) && !mVDriftMgr.moveTPCTrack<TBCs, TCollisions>(collision, ele, nTrack)) {
-      LOGP(error, "failed correction for negative tpc track");
+    const auto& pTrack = posLeg.track;
+    auto posdcaXY = posLeg.dcaXY;
+    auto posdcaZ = posLeg.dcaZ;
+
+    const V0Leg& eleLeg = getV0Leg<TBCs, TCollisions>(collision, ele);
+    if (!eleLeg.isOK) {
       return;
     }
-    auto nTrackC = nTrack;
-    nTrackC.setPID(o2::track::PID::Electron);
-    o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, nTrackC, 2.f, matCorr, &dcaInfo);
-    auto eledcaXY = dcaInfo[0];
-    auto eledcaZ = dcaInfo[1];
+    const auto& nTrack = eleLeg.track;
+    auto eledcaXY = eleLeg.dcaXY;
+    auto eledcaZ = eleLeg.dcaZ;
 
     if (std::fabs(posdcaXY) < dcapostopv || std::fabs(eledcaXY) < dcanegtopv) {
       return;
@@ -612,10 +641,8 @@ struct PhotonConversionBuilder {
       LOG(debug) << "Propagation failed for all radii (" << propV0LegsRadius << ", 30, 10 cm). Using default values for phiv and psipair (999.f).";
     }
 
-    KFPTrack kfp_track_pos = createKFPTrackFromTrackParCov(pTrack, pos.sign(), pos.tpcNClsFound(), pos.tpcChi2NCl());
-    KFPTrack kfp_track_ele = createKFPTrackFromTrackParCov(nTrack, ele.sign(), ele.tpcNClsFound(), ele.tpcChi2NCl());
-    KFParticle kfp_pos(kfp_track_pos, kPositron);
-    KFParticle kfp_ele(kfp_track_ele, kElectron);
+    const KFParticle& kfp_pos = posLeg.kfp;
+    const KFParticle& kfp_ele = eleLeg.kfp;
     const KFParticle* GammaDaughters[2] = {&kfp_pos, &kfp_ele};
 
     KFParticle gammaKF;
@@ -827,10 +854,10 @@ struct PhotonConversionBuilder {
       registry.fill(HIST("V0/hCosPAXY_Rxy"), rxy, cospaXY_kf);
       registry.fill(HIST("V0/hCosPARZ_Rxy"), rxy, cospaRZ_kf);
 
-      for (const auto& leg : {kfp_pos_DecayVtx, kfp_ele_DecayVtx}) {
-        float legpt = RecoDecay::sqrtSumOfSquares(leg.GetPx(), leg.GetPy());
-        float legeta = RecoDecay::eta(std::array{leg.GetPx(), leg.GetPy(), leg.GetPz()});
-        float legphi = RecoDecay::constrainAngle(RecoDecay::phi(leg.GetPx(), leg.GetPy()));
+      for (const auto* leg : {&kfp_pos_DecayVtx, &kfp_ele_DecayVtx}) {
+        float legpt = RecoDecay::sqrtSumOfSquares(leg->GetPx(), leg->GetPy());
+        float legeta = RecoDecay::eta(std::array{leg->GetPx(), leg->GetPy(), leg->GetPz()});
+        float legphi = RecoDecay::constrainAngle(RecoDecay::phi(leg->GetPx(), leg->GetPy()));
         registry.fill(HIST("V0Leg/hPt"), legpt);
         registry.fill(HIST("V0Leg/hEtaPhi"), legphi, legeta);
       } // end of leg loop
@@ -838,9 +865,9 @@ struct PhotonConversionBuilder {
         registry.fill(HIST("V0Leg/hdEdx_Pin"), leg.tpcInnerParam(), leg.tpcSignal());
         registry.fill(HIST("V0Leg/hTPCNsigmaEl"), leg.tpcInnerParam(), leg.tpcNSigmaEl());
       } // end of leg loop
-      for (const auto& leg : {pTrack, nTrack}) {
-        registry.fill(HIST("V0Leg/hXZ"), leg.getZ(), leg.getX());
-        registry.fill(HIST("V0Leg/hRelDeltaPt"), leg.getPt(), leg.getPt() * std::sqrt(leg.getSigma1Pt2()));
+      for (const auto* leg : {&pTrack, &nTrack}) {
+        registry.fill(HIST("V0Leg/hXZ"), leg->getZ(), leg->getX());
+        registry.fill(HIST("V0Leg/hRelDeltaPt"), leg->getPt(), leg->getPt() * std::sqrt(leg->getSigma1Pt2()));
       } // end of leg loop
       registry.fill(HIST("V0Leg/hDCAxyz"), posdcaXY, posdcaZ);
       registry.fill(HIST("V0Leg/hDCAxyz"), eledcaXY, eledcaZ);
@@ -994,6 +1021,7 @@ struct PhotonConversionBuilder {
     pca_map.clear();
     cospa_map.clear();
     nv0_map.clear();
+    v0leg_map.clear();
     stored_v0Ids.clear();
     stored_v0Ids.shrink_to_fit();
     stored_fullv0Ids.clear();
@@ -79,6 +79,7 @@ struct SkimmerGammaCalo {
   Configurable<float> maxdEtaSec{"maxdEtaSec", 0.1, "Set a maximum difference in eta for secondary tracks and cluster to still count as matched"};
   Configurable<float> maxdPhiSec{"maxdPhiSec", 0.1, "Set a maximum difference in phi for secondary tracks and cluster to still count as matched"};
   Configurable<bool> needEMCTrigger{"needEMCTrigger", false, "flag to only save events which have kTVXinEMC trigger bit. To reduce PbPb derived data size"};
+  Configurable<bool> fillFullPrecisionTables{"fillFullPrecisionTables", true, "flag to fill SkimEMCClusters and EmEmcClusters in addition to the compact MinClusters tables. To reduce derived data size"};
 
   HistogramRegistry historeg{"output", {}, OutputObjHandlingPolicy::AnalysisObject, false, false};
 
@@ -244,11 +245,13 @@ struct SkimmerGammaCalo {
       historeg.fill(HIST("M02Out"), emccluster.m02());
       historeg.fill(HIST("TimeOut"), emccluster.time());
 
-      tableGammaEMCReco(emccluster.collisionId(), emccluster.definition(), emccluster.energy(), emccluster.eta(), emccluster.phi(), emccluster.m02(),
-                        emccluster.nCells(), emccluster.time(), emccluster.isExotic(), vPhi, vEta, vP, vPt, vPhiSecondaries, vEtaSecondaries, vPSecondaries, vPtSecondaries);
+      if (fillFullPrecisionTables.value) {
+        tableGammaEMCReco(emccluster.collisionId(), emccluster.definition(), emccluster.energy(), emccluster.eta(), emccluster.phi(), emccluster.m02(),
+                          emccluster.nCells(), emccluster.time(), emccluster.isExotic(), vPhi, vEta, vP, vPt, vPhiSecondaries, vEtaSecondaries, vPSecondaries, vPtSecondaries);
 
-      tableEmEmcClusters(emccluster.collisionId(), emccluster.definition(), emccluster.energy(), emccluster.eta(), emccluster.phi(), emccluster.m02(),
-                         emccluster.nCells(), emccluster.time(), emccluster.isExotic());
+        tableEmEmcClusters(emccluster.collisionId(), emccluster.definition(), emccluster.energy(), emccluster.eta(), emccluster.phi(), emccluster.m02(),
+                           emccluster.nCells(), emccluster.time(), emccluster.isExotic());
+      }
 
       tableMinClusters(emccluster.collisionId(), convertForStorage<int8_t>(emccluster.definition(), Observable::kDefinition),
                        convertForStorage<uint16_t>(emccluster.energy(), Observable::kEnergy),
@@ -260,7 +263,9 @@ struct SkimmerGammaCalo {
 
       if (vEta.size() > 0) {
         for (size_t iPart = 0; iPart < vEta.size(); ++iPart) {
-          tableEmEmcMTracks(tableEmEmcClusters.lastIndex(), vEta[iPart], vPhi[iPart], vP[iPart], vPt[iPart]);
+          if (fillFullPrecisionTables.value) {
+            tableEmEmcMTracks(tableEmEmcClusters.lastIndex(), vEta[iPart], vPhi[iPart], vP[iPart], vPt[iPart]);
+          }
           tableMinMTracks(tableMinClusters.lastIndex(),
                           convertForStorage<int16_t>(vPhi[iPart], Observable::kDeltaPhi),
                           convertForStorage<int16_t>(vEta[iPart], Observable::kDeltaEta),
@@ -270,7 +275,9 @@ struct SkimmerGammaCalo {
       }
       if (vEtaSecondaries.size() > 0) {
         for (size_t iPart = 0; iPart < vEtaSecondaries.size(); ++iPart) {
-          tableEmEmcMSTracks(tableEmEmcClusters.lastIndex(), vEtaSecondaries[iPart], vPhiSecondaries[iPart], vPSecondaries[iPart], vPtSecondaries[iPart]);
+          if (fillFullPrecisionTables.value) {
+            tableEmEmcMSTracks(tableEmEmcClusters.lastIndex(), vEtaSecondaries[iPart], vPhiSecondaries[iPart], vPSecondaries[iPart], vPtSecondaries[iPart]);
+          }
           tableMinMSTracks(tableMinClusters.lastIndex(),
                            convertForStorage<int16_t>(vPhiSecondaries[iPart], Observable::kDeltaPhi),
                            convertForStorage<int16_t>(vEtaSecondaries[iPart], Observable::kDeltaEta),
@@ -0,0 +1,81 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file skimEmcClusterToMinClusterConverter.cxx
+/// \brief Converter task to convert SkimEMCClusters into the compact MinClusters, MinMTracks and MinMSTracks
+/// \author M. Hemmer, marvin.hemmer@cern.ch
+
+#include "PWGEM/PhotonMeson/DataModel/GammaTablesRedux.h"
+#include "PWGEM/PhotonMeson/DataModel/gammaTables.h"
+
+#include <Framework/AnalysisDataModel.h>
+#include <Framework/AnalysisHelpers.h>
+#include <Framework/AnalysisTask.h>
+#include <Framework/runDataProcessing.h>
+
+#include <cstddef>
+#include <cstdint>
+
+using namespace o2;
+using namespace o2::framework;
+using namespace o2::aod::emcdownscaling;
+
+// Converts SkimEMCClusters_001, with the matched tracks as array columns, into MinClusters
+// with the matched tracks in MinMTracks and MinMSTracks, pointing to their cluster
+struct SkimEmcClusterToMinClusterConverter {
+  Produces<aod::MinClusters> tableMinClusters;
+  Produces<aod::MinMTracks> tableMinMTracks;
+  Produces<aod::MinMSTracks> tableMinMSTracks;
+
+  void process(aod::SkimEMCClusters_001 const& emcClusters)
+  {
+    for (const auto& emcCluster : emcClusters) {
+      tableMinClusters(emcCluster.collisionId(), convertForStorage<int8_t>(emcCluster.definition(), Observable::kDefinition),
+                       convertForStorage<uint16_t>(emcCluster.e(), Observable::kEnergy),
+                       convertForStorage<int16_t>(emcCluster.eta(), Observable::kEta),
+                       convertForStorage<uint16_t>(emcCluster.phi(), Observable::kPhi),
+                       convertForStorage<uint8_t>((emcCluster.nCells() & 0x7F) | (emcCluster.isExotic() << 7), Observable::kNCellsExo),
+                       convertForStorage<int16_t>(emcCluster.m02(), Observable::kM02),
+                       convertForStorage<int16_t>(emcCluster.time(), Observable::kTime));
+
+      auto deltaPhi = emcCluster.deltaPhi();
+      auto deltaEta = emcCluster.deltaEta();
+      auto trackP = emcCluster.trackp();
+      auto trackPt = emcCluster.trackpt();
+      for (size_t iTrack = 0; iTrack < deltaEta.size(); ++iTrack) {
+        tableMinMTracks(tableMinClusters.lastIndex(),
+                        convertForStorage<int16_t>(deltaPhi[iTrack], Observable::kDeltaPhi),
+                        convertForStorage<int16_t>(deltaEta[iTrack], Observable::kDeltaEta),
+                        convertForStorage<uint16_t>(trackP[iTrack], Observable::kEnergy),
+                        convertForStorage<uint16_t>(trackPt[iTrack], Observable::kEnergy));
+      }
+
+      auto deltaPhiSec = emcCluster.deltaPhiSec();
+      auto deltaEtaSec = emcCluster.deltaEtaSec();
+      auto trackPSec = emcCluster.trackpSec();
+      auto trackPtSec = emcCluster.trackptSec();
+      for (size_t iTrack = 0; iTrack < deltaEtaSec.size(); ++iTrack) {
+        tableMinMSTracks(tableMinClusters.lastIndex(),
+                         convertForStorage<int16_t>(deltaPhiSec[iTrack], Observable::kDeltaPhi),
+                         convertForStorage<int16_t>(deltaEtaSec[iTrack], Observable::kDeltaEta),
+                         convertForStorage<uint16_t>(trackPSec[iTrack], Observable::kEnergy),
+                         convertForStorage<uint16_t>(trackPtSec[iTrack], Observable::kEnergy));
+      }
+    }
+  }
+};
+
+WorkflowSpec defineDataProcessing(ConfigContext const& cfgc)
+{
+  return WorkflowSpec{
+    adaptAnalysisTask<SkimEmcClusterToMinClusterConverter>(cfgc),
+  };
+}
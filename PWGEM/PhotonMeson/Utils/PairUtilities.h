@@ -21,6 +21,8 @@
 #include <Framework/ASoA.h>
 
 #include <cmath>
+#include <cstdint>
+#include <vector>
 
 namespace o2::aod::pwgem::photonmeson::utils::pairutil
 {
@@ -67,6 +69,76 @@ bool DoesV0LegMatchWithCluster(TV0Leg const& v0leg, TCluster const& cluster, con
   float Ep = cluster.e() / v0leg.p();
   return (std::pow(deta / max_deta, 2.f) + std::pow(dphi / max_dphi, 2.f) < 1.f) && (std::abs(Ep - 1.f) < max_Ep_width);
 }
+
+// Selected photons of an event as columns of energy and direction, for the diphoton pair loops
+struct PhotonColumns {
+  std::vector<float> pt{};
+  std::vector<float> eta{};
+  std::vector<float> phi{};
+  std::vector<double> e{};  // massless: e = p
+  std::vector<double> ux{}; // unit vector of the momentum
+  std::vector<double> uy{};
+  std::vector<double> uz{};
+  std::vector<uint8_t> used{}; // already stored in the mixing pool
+
+  void add(const float gpt, const float geta, const float gphi)
+  {
+    pt.emplace_back(gpt);
+    eta.emplace_back(geta);
+    phi.emplace_back(gphi);
+    const double coshEta = std::cosh(static_cast<double>(geta));
+    e.emplace_back(gpt * coshEta);
+    ux.emplace_back(std::cos(static_cast<double>(gphi)) / coshEta);
+    uy.emplace_back(std::sin(static_cast<double>(gphi)) / coshEta);
+    uz.emplace_back(std::tanh(static_cast<double>(geta)));
+    used.emplace_back(0);
+  }
+
+  void clear()
+  {
+    pt.clear();
+    eta.clear();
+    phi.clear();
+    e.clear();
+    ux.clear();
+    uy.clear();
+    uz.clear();
+    used.clear();
+  }
+
+  int size() const { return static_cast<int>(pt.size()); }
+};
+
+// Mass, pT and rapidity of the diphotons of photon i of c1 with the photons [jBegin, n) of c2, indexed by the photon of c2
+struct DiphotonRow {
+  std::vector<float> mass{};
+  std::vector<float> pt{};
+  std::vector<float> rapidity{};
+  std::vector<uint8_t> selected{}; // |y| <= maxY
+};
+
+inline void computeDiphotonRow(PhotonColumns const& c1, const int i, PhotonColumns const& c2, const int jBegin, const float maxY, DiphotonRow& row)
+{
+  const int n = c2.size();
+  row.mass.resize(n);
+  row.pt.resize(n);
+  row.rapidity.resize(n);
+  row.selected.resize(n);
+  const double e1 = c1.e[i];
+  const double ux1 = c1.ux[i], uy1 = c1.uy[i], uz1 = c1.uz[i];
+  for (int j = jBegin; j < n; j++) {
+    // m^2 = 2 E1 E2 (1 - cos(theta12)) for massless photons
+    const double m2 = 2. * e1 * c2.e[j] * (1. - (ux1 * c2.ux[j] + uy1 * c2.uy[j] + uz1 * c2.uz[j]));
+    const double px = e1 * ux1 + c2.e[j] * c2.ux[j];
+    const double py = e1 * uy1 + c2.e[j] * c2.uy[j];
+    const double pz = e1 * uz1 + c2.e[j] * c2.uz[j];
+    const double e = e1 + c2.e[j];
+    row.mass[j] = m2 > 0. ? std::sqrt(m2) : 0.;
+    row.pt[j] = std::sqrt(px * px + py * py);
+    row.rapidity[j] = 0.5 * std::log((e + pz) / (e - pz));
+    row.selected[j] = !(std::fabs(row.rapidity[j]) > maxY);
+  }
+}
 } // namespace o2::aod::pwgem::photonmeson::photonpair
 
 #endif // PWGEM_PHOTONMESON_UTILS_PAIRUTILITIES_H_
@@ -28,6 +28,8 @@
 #include "ReconstructionDataFormats/DCA.h"
 #include "ReconstructionDataFormats/V0.h"
 
+#include <array>
+#include <cstdint>
 #include <utility>
 #include <vector>
 
@@ -71,6 +73,13 @@ struct HfCandidateCreatorChic {
   double massJpsi{0.};
   double massJpsiGamma{0.};
 
+  // photon candidate of the collision, selected once for all the Jpsi candidates
+  struct GammaCandidate {
+    std::array<float, 3> pVec;
+    int64_t globalIndex;
+  };
+  std::vector<GammaCandidate> gammas;
+
   Filter filterSelectCandidates = (aod::hf_sel_candidate_jpsi::isSelJpsiToEE >= selectionFlagJpsi || aod::hf_sel_candidate_jpsi::isSelJpsiToMuMu >= selectionFlagJpsi);
 
   OutputObj<TH1F> hMassJpsiToEE{TH1F("hMassJpsiToEE", "J/#psi candidates;inv. mass (e^{#plus} e^{#minus}) (GeV/#it{c}^{2});entries", 500, 0., 5.)};
@@ -103,6 +112,23 @@ struct HfCandidateCreatorChic {
                aod::TracksWCov const&,
                aod::ECALs const& ecals)
   {
+    // select the photon candidates once per collision
+    gammas.clear();
+    for (const auto& ecal : ecals) {
+      if (ecal.e() < energyGammaMin) {
+        continue;
+      }
+      std::array<float, 3> pvecGamma{static_cast<float>(ecal.px()), static_cast<float>(ecal.py()), static_cast<float>(ecal.pz())};
+      auto etagamma = RecoDecay::eta(pvecGamma);
+      if (etagamma < etaGammaMin || etagamma > etaGammaMax) { // calcolare la pseudorapidità da posz
+        continue;
+      }
+      gammas.push_back({pvecGamma, ecal.globalIndex()});
+    }
+
+    auto primaryVertex = getPrimaryVertex(collision);
+    auto covMatrixPV = primaryVertex.getCov();
+
     // loop over Jpsi candidates
     for (const auto& jpsiCand : jpsiCands) {
       if (!(jpsiCand.hfflag() & 1 << hf_cand_2prong::DecayType::JpsiToEE) && !(jpsiCand.hfflag() & 1 << hf_cand_2prong::DecayType::JpsiToMuMu)) {
@@ -138,30 +164,17 @@ struct HfCandidateCreatorChic {
       // define the Jpsi track
       auto trackJpsi = o2::dataformats::V0(vertexJpsi, pvecJpsi, covJpsi, prong0TrackParCov, prong1TrackParCov); // FIXME: also needs covxyz???
 
+      // get track impact parameters, the same for all the photons
+      // This modifies track momenta!
+      o2::dataformats::DCA impactParameter0;
+      trackJpsi.propagateToDCA(primaryVertex, bz, &impactParameter0);
+
       // -----------------------------------------------------------------
       // loop over gamma candidates
 
-      for (const auto& ecal : ecals) {
-
-        if (ecal.e() < energyGammaMin) {
-          continue;
-        }
-        auto etagamma = RecoDecay::eta(std::array{ecal.px(), ecal.py(), ecal.pz()});
-        if (etagamma < etaGammaMin || etagamma > etaGammaMax) { // calcolare la pseudorapidità da posz
-          continue;
-        }
-
-        std::array<float, 3> pvecGamma{static_cast<float>(ecal.px()), static_cast<float>(ecal.py()), static_cast<float>(ecal.pz())};
-
-        // get track impact parameters
-        // This modifies track momenta!
-
-        auto primaryVertex = getPrimaryVertex(collision);
-        auto covMatrixPV = primaryVertex.getCov();
+      for (const auto& gamma : gammas) {
+        const auto& pvecGamma = gamma.pVec;
         hCovPVXX->Fill(covMatrixPV[0]);
-        o2::dataformats::DCA impactParameter0;
-        o2::dataformats::DCA impactParameter1;
-        trackJpsi.propagateToDCA(primaryVertex, bz, &impactParameter0);
 
         // get uncertainty of the decay length
         // double phi, theta;
@@ -187,7 +200,7 @@ struct HfCandidateCreatorChic {
                          pvecGamma[0], pvecGamma[1], pvecGamma[2],
                          impactParameter0.getY(), 0.f,                  // impactParameter1.getY(),
                          std::sqrt(impactParameter0.getSigmaY2()), 0.f, // std::sqrt(impactParameter1.getSigmaY2()),
-                         jpsiCand.globalIndex(), ecal.globalIndex(),
+                         jpsiCand.globalIndex(), gamma.globalIndex,
                          hfFlag, HfHelper::invMassJpsiToMuMu(jpsiCand));
 
         // calculate invariant mass
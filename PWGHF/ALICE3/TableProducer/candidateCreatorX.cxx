@@ -28,6 +28,8 @@
 #include "ReconstructionDataFormats/DCA.h"
 #include "ReconstructionDataFormats/V0.h"
 
+#include <array>
+#include <cstdint>
 #include <utility>
 #include <vector>
 
@@ -64,6 +66,7 @@ struct HfCandidateCreatorX {
   Configurable<int> selectionFlagJpsi{"selectionFlagJpsi", 1, "Selection Flag for Jpsi"};
   Configurable<double> yCandMax{"yCandMax", -1., "max. cand. rapidity"};
   Configurable<double> diffMassJpsiMax{"diffMassJpsiMax", 0.07, "max. diff. between Jpsi rec. and PDG mass"};
+  Configurable<double> xPreselMassWindow{"xPreselMassWindow", -1., "Mass window around X(3872) peak with the momenta before the vertex fit (GeV/c^2), negative: no preselection"};
 
   o2::vertexing::DCAFitterN<2> df2; // 2-prong vertex fitter (to rebuild Jpsi vertex)
   o2::vertexing::DCAFitterN<3> df3; // 3-prong vertex fitter
@@ -72,6 +75,15 @@ struct HfCandidateCreatorX {
   double massJpsi{0.};
   double massJpsiPiPi{0.};
 
+  // pion candidate of the collision, with the track parametrisation built once for all the Jpsi candidates
+  struct PionCandidate {
+    o2::track::TrackParCov trackParCov;
+    std::array<float, 3> pVec;
+    int64_t globalIndex;
+  };
+  std::vector<PionCandidate> pionsPos;
+  std::vector<PionCandidate> pionsNeg;
+
   Filter filterSelectCandidates = (aod::hf_sel_candidate_jpsi::isSelJpsiToEE >= selectionFlagJpsi || aod::hf_sel_candidate_jpsi::isSelJpsiToMuMu >= selectionFlagJpsi);
 
   OutputObj<TH1F> hMassJpsiToEE{TH1F("hMassJpsiToEE", "J/#psi candidates;inv. mass (e^{#plus} e^{#minus}) (GeV/#it{c}^{2});entries", 500, 0., 5.)};
@@ -113,6 +125,26 @@ struct HfCandidateCreatorX {
                  aod::HfSelJpsi>> const& jpsiCands,
                aod::TracksWCov const& tracks)
   {
+    // select the pion candidates once per collision
+    pionsPos.clear();
+    pionsNeg.clear();
+    for (const auto& track : tracks) {
+      if (track.pt() < ptPionMin) {
+        continue;
+      }
+      PionCandidate pion{getTrackParCov(track), {}, track.globalIndex()};
+      pion.trackParCov.getPxPyPzGlo(pion.pVec);
+      if (track.sign() >= 0) {
+        pionsPos.push_back(pion);
+      }
+      if (track.sign() <= 0) {
+        pionsNeg.push_back(pion);
+      }
+    }
+
+    auto primaryVertex = getPrimaryVertex(collision);
+    auto covMatrixPV = primaryVertex.getCov();
+
     // loop over Jpsi candidates
     for (const auto& jpsiCand : jpsiCands) {
       if (!(jpsiCand.hfflag() & 1 << hf_cand_2prong::DecayType::JpsiToEE) && !(jpsiCand.hfflag() & 1 << hf_cand_2prong::DecayType::JpsiToMuMu)) {
@@ -138,7 +170,8 @@ struct HfCandidateCreatorX {
       hCPAJpsi->Fill(jpsiCand.cpa());
       // create Jpsi track to pass to DCA fitter; use cand table + rebuild vertex
       const std::array<float, 3> vertexJpsi = {jpsiCand.xSecondaryVertex(), jpsiCand.ySecondaryVertex(), jpsiCand.zSecondaryVertex()};
-      std::array<float, 3> pvecJpsi = jpsiCand.pVector();
+      const std::array<float, 3> pvecJpsiCand = jpsiCand.pVector();
+      std::array<float, 3> pvecJpsi = pvecJpsiCand;
       auto prong0 = jpsiCand.prong0_as<aod::TracksWCov>();
       auto prong1 = jpsiCand.prong1_as<aod::TracksWCov>();
       auto prong0TrackParCov = getTrackParCov(prong0);
@@ -160,31 +193,24 @@ struct HfCandidateCreatorX {
       int index1Jpsi = jpsiCand.prong1Id();
 
       // loop over pi+ candidates
-      for (const auto& trackPos : tracks) {
-        if (trackPos.pt() < ptPionMin) {
-          continue;
-        }
-        if (trackPos.sign() < 0) { // select only positive tracks - use partitions?
-          continue;
-        }
-        if (trackPos.globalIndex() == index0Jpsi) {
+      for (const auto& pionPos : pionsPos) {
+        if (pionPos.globalIndex == index0Jpsi) {
           continue;
         }
 
         // loop over pi- candidates
-        for (const auto& trackNeg : tracks) {
-          if (trackNeg.pt() < ptPionMin) {
+        for (const auto& pionNeg : pionsNeg) {
+          if (pionNeg.globalIndex == index1Jpsi) {
             continue;
           }
-          if (trackNeg.sign() > 0) { // select only negative tracks - use partitions?
-            continue;
-          }
-          if (trackNeg.globalIndex() == index1Jpsi) {
+
+          // mass of the combination with the momenta before the vertex fit
+          if (xPreselMassWindow >= 0. && std::abs(RecoDecay::m(std::array{pvecJpsiCand, pionPos.pVec, pionNeg.pVec}, std::array{massJpsi, massPi, massPi}) - MassX3872) > xPreselMassWindow) {
             continue;
           }
 
-          auto trackParVarPos = getTrackParCov(trackPos);
-          auto trackParVarNeg = getTrackParCov(trackNeg);
+          auto trackParVarPos = pionPos.trackParCov;
+          auto trackParVarNeg = pionNeg.trackParCov;
           std::array<float, 3> pvecPos;
           std::array<float, 3> pvecNeg;
 
@@ -206,8 +232,6 @@ struct HfCandidateCreatorX {
 
           // get track impact parameters
           // This modifies track momenta!
-          auto primaryVertex = getPrimaryVertex(collision);
-          auto covMatrixPV = primaryVertex.getCov();
           hCovPVXX->Fill(covMatrixPV[0]);
           o2::dataformats::DCA impactParameter0;
           o2::dataformats::DCA impactParameter1;
@@ -241,7 +265,7 @@ struct HfCandidateCreatorX {
                            pvecNeg[0], pvecNeg[1], pvecNeg[2],
                            impactParameter0.getY(), impactParameter1.getY(), impactParameter2.getY(),
                            std::sqrt(impactParameter0.getSigmaY2()), std::sqrt(impactParameter1.getSigmaY2()), std::sqrt(impactParameter2.getSigmaY2()),
-                           jpsiCand.globalIndex(), trackPos.globalIndex(), trackNeg.globalIndex(),
+                           jpsiCand.globalIndex(), pionPos.globalIndex, pionNeg.globalIndex,
                            hfFlag);
 
           // calculate invariant mass
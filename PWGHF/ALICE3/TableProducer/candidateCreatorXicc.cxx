@@ -78,10 +78,20 @@ struct HfCandidateCreatorXicc {
   // selection
   Configurable<int> selectionFlagXic{"selectionFlagXic", 1, "Selection Flag for Xic"};
   Configurable<double> cutPtPionMin{"cutPtPionMin", 1., "min. pt pion track"};
+  Configurable<double> xiccPreselMassWindow{"xiccPreselMassWindow", -1., "Mass window around Xicc peak with the momenta before the vertex fit (GeV/c^2), negative: no preselection"};
 
   o2::vertexing::DCAFitterN<3> df3; // 3-prong vertex fitter to rebuild the Xic vertex
   o2::vertexing::DCAFitterN<2> df2; // 2-prong vertex fitter to build the Xicc vertex
 
+  // pion candidate of the collision, with the track parametrisation built once for all the Xic candidates
+  struct PionCandidate {
+    o2::track::TrackParCov trackParCov;
+    std::array<float, 3> pVec;
+    int64_t globalIndex;
+    int sign;
+  };
+  std::vector<PionCandidate> pions;
+
   Filter filterSelectCandidates = (aod::hf_sel_candidate_xic::isSelXicToPKPi >= selectionFlagXic || aod::hf_sel_candidate_xic::isSelXicToPiKP >= selectionFlagXic);
 
   OutputObj<TH1F> hMassXic{TH1F("hMassXic", "xic candidates;inv. mass (#pi K #pi) (GeV/#it{c}^{2});entries", 500, 1.6, 2.6)};
@@ -113,6 +123,16 @@ struct HfCandidateCreatorXicc {
                soa::Filtered<soa::Join<aod::HfCand3Prong, aod::HfSelXicToPKPi>> const& xicCands,
                aod::TracksWCov const& tracks)
   {
+    // select the pion candidates once per collision
+    pions.clear();
+    for (const auto& track : tracks) {
+      if (track.pt() < cutPtPionMin) {
+        continue;
+      }
+      auto& pion = pions.emplace_back(PionCandidate{getTrackParCov(track), {}, track.globalIndex(), track.sign()});
+      pion.trackParCov.getPxPyPzGlo(pion.pVec);
+    }
+
     for (const auto& xicCand : xicCands) {
       if ((xicCand.hfflag() & 1 << o2::aod::hf_cand_3prong::DecayType::XicToPKPi) == 0) {
         continue;
@@ -150,18 +170,23 @@ struct HfCandidateCreatorXicc {
       int const index2Xic = track2.globalIndex();
       int const charge = track0.sign() + track1.sign() + track2.sign();
 
-      for (const auto& trackpion : tracks) {
-        if (trackpion.pt() < cutPtPionMin) {
+      auto primaryVertex = getPrimaryVertex(collision);
+      auto covMatrixPV = primaryVertex.getCov();
+      const std::array<float, 3> pvecxicCand = pvecxic;
+
+      for (const auto& pion : pions) {
+        if (pion.sign * charge < 0) {
           continue;
         }
-        if (trackpion.sign() * charge < 0) {
+        if (pion.globalIndex == index0Xic || pion.globalIndex == index1Xic || pion.globalIndex == index2Xic) {
           continue;
         }
-        if (trackpion.globalIndex() == index0Xic || trackpion.globalIndex() == index1Xic || trackpion.globalIndex() == index2Xic) {
+        // mass of the combination with the momenta before the vertex fit
+        if (xiccPreselMassWindow >= 0. && std::abs(RecoDecay::m(std::array{pvecxicCand, pion.pVec}, std::array{MassXiCPlus, MassPiPlus}) - MassXiCCPlusPlus) > xiccPreselMassWindow) {
           continue;
         }
         std::array<float, 3> pvecpion{};
-        auto trackParVarPi = getTrackParCov(trackpion);
+        auto trackParVarPi = pion.trackParCov;
 
         // reconstruct the 3-prong X vertex
         if (df2.process(trackxic, trackParVarPi) == 0) {
@@ -176,8 +201,6 @@ struct HfCandidateCreatorXicc {
         df2.getTrack(0).getPxPyPzGlo(pvecxic);
         df2.getTrack(1).getPxPyPzGlo(pvecpion);
 
-        auto primaryVertex = getPrimaryVertex(collision);
-        auto covMatrixPV = primaryVertex.getCov();
         o2::dataformats::DCA impactParameter0;
         o2::dataformats::DCA impactParameter1;
         trackxic.propagateToDCA(primaryVertex, bz, &impactParameter0);
@@ -200,7 +223,7 @@ struct HfCandidateCreatorXicc {
                          pvecpion[0], pvecpion[1], pvecpion[2],
                          impactParameter0.getY(), impactParameter1.getY(),
                          std::sqrt(impactParameter0.getSigmaY2()), std::sqrt(impactParameter1.getSigmaY2()),
-                         xicCand.globalIndex(), trackpion.globalIndex(),
+                         xicCand.globalIndex(), pion.globalIndex,
                          hfFlag);
       } // if on selected Xicc
     } // loop over candidates
@@ -40,6 +40,7 @@
 #include <Framework/ASoA.h>
 #include <Framework/AnalysisDataModel.h>
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <cstdint>
@@ -294,6 +295,92 @@ DECLARE_SOA_TABLE(HfRedTracksCov, "AOD", "HFREDTRACKCOV", //! Table with track c
                   HFTRACKPARCOV_COLUMNS,
                   o2::soa::Marker<1>);
 
+namespace hf_track_par_cov_compact
+{
+// Covariance matrix with the diagonal elements stored as float and the off-diagonal ones as correlation coefficients in int16 with a fixed scale.
+// The correlation coefficients are stored with a precision of 1/32767, i.e. a relative precision better than 2e-5 on the unpacked elements.
+struct CovPacking {
+  static constexpr float Scale = 32767.f;
+
+  static int16_t pack(float cij, float cii, float cjj)
+  {
+    const float norm = std::sqrt(cii * cjj);
+    if (!(norm > 0.f) || std::isnan(cij)) {
+      return 0;
+    }
+    return static_cast<int16_t>(std::round(std::clamp(cij / norm, -1.f, 1.f) * Scale));
+  }
+
+  static float unPack(int16_t rho, float cii, float cjj)
+  {
+    return rho / Scale * std::sqrt(cii * cjj);
+  }
+};
+
+DECLARE_SOA_COLUMN(RhoZY, rhoZY, int16_t);         //! Correlation coefficient between Z and Y, packed
+DECLARE_SOA_COLUMN(RhoSnpY, rhoSnpY, int16_t);     //! Correlation coefficient between Snp and Y, packed
+DECLARE_SOA_COLUMN(RhoSnpZ, rhoSnpZ, int16_t);     //! Correlation coefficient between Snp and Z, packed
+DECLARE_SOA_COLUMN(RhoTglY, rhoTglY, int16_t);     //! Correlation coefficient between Tgl and Y, packed
+DECLARE_SOA_COLUMN(RhoTglZ, rhoTglZ, int16_t);     //! Correlation coefficient between Tgl and Z, packed
+DECLARE_SOA_COLUMN(RhoTglSnp, rhoTglSnp, int16_t); //! Correlation coefficient between Tgl and Snp, packed
+DECLARE_SOA_COLUMN(Rho1PtY, rho1PtY, int16_t);     //! Correlation coefficient between 1/pt and Y, packed
+DECLARE_SOA_COLUMN(Rho1PtZ, rho1PtZ, int16_t);     //! Correlation coefficient between 1/pt and Z, packed
+DECLARE_SOA_COLUMN(Rho1PtSnp, rho1PtSnp, int16_t); //! Correlation coefficient between 1/pt and Snp, packed
+DECLARE_SOA_COLUMN(Rho1PtTgl, rho1PtTgl, int16_t); //! Correlation coefficient between 1/pt and Tgl, packed
+
+// CAREFUL: the getters names shall be the same as the ones of the getTrackParCov method in Common/Core/trackUtilities.h
+DECLARE_SOA_DYNAMIC_COLUMN(CZY, cZY, //! Unpacked covariance element
+                           [](int16_t rho, float cii, float cjj) -> float { return CovPacking::unPack(rho, cii, cjj); });
+DECLARE_SOA_DYNAMIC_COLUMN(CSnpY, cSnpY, //! Unpacked covariance element
+                           [](int16_t rho, float cii, float cjj) -> float { return CovPacking::unPack(rho, cii, cjj); });
+DECLARE_SOA_DYNAMIC_COLUMN(CSnpZ, cSnpZ, //! Unpacked covariance element
+                           [](int16_t rho, float cii, float cjj) -> float { return CovPacking::unPack(rho, cii, cjj); });
+DECLARE_SOA_DYNAMIC_COLUMN(CTglY, cTglY, //! Unpacked covariance element
+                           [](int16_t rho, float cii, float cjj) -> float { return CovPacking::unPack(rho, cii, cjj); });
+DECLARE_SOA_DYNAMIC_COLUMN(CTglZ, cTglZ, //! Unpacked covariance element
+                           [](int16_t rho, float cii, float cjj) -> float { return CovPacking::unPack(rho, cii, cjj); });
+DECLARE_SOA_DYNAMIC_COLUMN(CTglSnp, cTglSnp, //! Unpacked covariance element
+                           [](int16_t rho, float cii, float cjj) -> float { return CovPacking::unPack(rho, cii, cjj); });
+DECLARE_SOA_DYNAMIC_COLUMN(C1PtY, c1PtY, //! Unpacked covariance element
+                           [](int16_t rho, float cii, float cjj) -> float { return CovPacking::unPack(rho, cii, cjj); });
+DECLARE_SOA_DYNAMIC_COLUMN(C1PtZ, c1PtZ, //! Unpacked covariance element
+                           [](int16_t rho, float cii, float cjj) -> float { return CovPacking::unPack(rho, cii, cjj); });
+DECLARE_SOA_DYNAMIC_COLUMN(C1PtSnp, c1PtSnp, //! Unpacked covariance element
+                           [](int16_t rho, float cii, float cjj) -> float { return CovPacking::unPack(rho, cii, cjj); });
+DECLARE_SOA_DYNAMIC_COLUMN(C1PtTgl, c1PtTgl, //! Unpacked covariance element
+                           [](int16_t rho, float cii, float cjj) -> float { return CovPacking::unPack(rho, cii, cjj); });
+} // namespace hf_track_par_cov_compact
+
+// compact version of HfRedTracksCov (40 instead of 60 bytes per track), with the same accessors
+DECLARE_SOA_TABLE(HfRedTracksCovCompact, "AOD", "HFREDTRACKCOVC", //! Table with compact track covariance information for reduced workflow
+                  soa::Index<>,
+                  hf_track_par_cov::CYY,
+                  hf_track_par_cov::CZZ,
+                  hf_track_par_cov::CSnpSnp,
+                  hf_track_par_cov::CTglTgl,
+                  hf_track_par_cov::C1Pt21Pt2,
+                  hf_track_par_cov_compact::RhoZY,
+                  hf_track_par_cov_compact::RhoSnpY,
+                  hf_track_par_cov_compact::RhoSnpZ,
+                  hf_track_par_cov_compact::RhoTglY,
+                  hf_track_par_cov_compact::RhoTglZ,
+                  hf_track_par_cov_compact::RhoTglSnp,
+                  hf_track_par_cov_compact::Rho1PtY,
+                  hf_track_par_cov_compact::Rho1PtZ,
+                  hf_track_par_cov_compact::Rho1PtSnp,
+                  hf_track_par_cov_compact::Rho1PtTgl,
+                  hf_track_par_cov_compact::CZY<hf_track_par_cov_compact::RhoZY, hf_track_par_cov::CZZ, hf_track_par_cov::CYY>,
+                  hf_track_par_cov_compact::CSnpY<hf_track_par_cov_compact::RhoSnpY, hf_track_par_cov::CSnpSnp, hf_track_par_cov::CYY>,
+                  hf_track_par_cov_compact::CSnpZ<hf_track_par_cov_compact::RhoSnpZ, hf_track_par_cov::CSnpSnp, hf_track_par_cov::CZZ>,
+                  hf_track_par_cov_compact::CTglY<hf_track_par_cov_compact::RhoTglY, hf_track_par_cov::CTglTgl, hf_track_par_cov::CYY>,
+                  hf_track_par_cov_compact::CTglZ<hf_track_par_cov_compact::RhoTglZ, hf_track_par_cov::CTglTgl, hf_track_par_cov::CZZ>,
+                  hf_track_par_cov_compact::CTglSnp<hf_track_par_cov_compact::RhoTglSnp, hf_track_par_cov::CTglTgl, hf_track_par_cov::CSnpSnp>,
+                  hf_track_par_cov_compact::C1PtY<hf_track_par_cov_compact::Rho1PtY, hf_track_par_cov::C1Pt21Pt2, hf_track_par_cov::CYY>,
+                  hf_track_par_cov_compact::C1PtZ<hf_track_par_cov_compact::Rho1PtZ, hf_track_par_cov::C1Pt21Pt2, hf_track_par_cov::CZZ>,
+                  hf_track_par_cov_compact::C1PtSnp<hf_track_par_cov_compact::Rho1PtSnp, hf_track_par_cov::C1Pt21Pt2, hf_track_par_cov::CSnpSnp>,
+                  hf_track_par_cov_compact::C1PtTgl<hf_track_par_cov_compact::Rho1PtTgl, hf_track_par_cov::C1Pt21Pt2, hf_track_par_cov::CTglTgl>,
+                  o2::soa::Marker<1>);
+
 DECLARE_SOA_TABLE(HfRedTracksMom, "AOD", "HFREDTRACKMOM", //! Table with track momentum information for reduced workflow
                   soa::Index<>,
                   hf_track_vars_reduced::Px,
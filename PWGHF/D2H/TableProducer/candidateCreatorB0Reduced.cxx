@@ -82,13 +82,14 @@ struct HfCandidateCreatorB0Reduced {
   Preslice<soa::Join<aod::HfRed2Prongs, aod::HfRed2ProngsCov>> candsDstarPerCollision = hf_track_index_reduced::hfRedCollisionId;
   Preslice<soa::Join<aod::HfRed2Prongs, aod::HfRed2ProngsCov, aod::HfRed3ProngsMl>> candsDstarWithMlPerCollision = hf_track_index_reduced::hfRedCollisionId;
   Preslice<soa::Join<aod::HfRedTrackBases, aod::HfRedTracksCov>> tracksPionPerCollision = hf_track_index_reduced::hfRedCollisionId;
+  Preslice<soa::Join<aod::HfRedTrackBases, aod::HfRedTracksCovCompact>> tracksPionCompactCovPerCollision = hf_track_index_reduced::hfRedCollisionId;
 
   std::shared_ptr<TH1> hCandidates;
   HistogramRegistry registry{"registry"};
 
   void init(InitContext const&)
   {
-    std::array<bool, 4> doprocess{doprocessDataDplusPi, doprocessDataDplusPiWithDmesMl, doprocessDataDstarPi, doprocessDataDstarPiWithDmesMl};
+    std::array<bool, 5> doprocess{doprocessDataDplusPi, doprocessDataDplusPiCompactCov, doprocessDataDplusPiWithDmesMl, doprocessDataDstarPi, doprocessDataDstarPiWithDmesMl};
     if ((std::accumulate(doprocess.begin(), doprocess.end(), 0)) != 1) {
       LOGP(fatal, "Only one process function for data should be enabled at a time.");
     }
@@ -372,6 +373,40 @@ struct HfCandidateCreatorB0Reduced {
 
   PROCESS_SWITCH(HfCandidateCreatorB0Reduced, processDataDplusPi, "Process data D-pi without any ML score", true);
 
+  void processDataDplusPiCompactCov(HfRedCollisionsWithExtras const& collisions,
+                                    soa::Join<aod::HfRed3Prongs, aod::HfRed3ProngsCov> const& candsD,
+                                    soa::Join<aod::HfRedTrackBases, aod::HfRedTracksCovCompact> const& tracksPion,
+                                    aod::HfOrigColCounts const& collisionsCounter,
+                                    aod::HfCandB0Configs const& configs)
+  {
+    // DPi invariant-mass window cut
+    for (const auto& config : configs) {
+      myInvMassWindowDPi = config.myInvMassWindowDPi();
+    }
+    // invMassWindowDPiTolerance is used to apply a slightly tighter cut than in DPi pair preselection
+    // to avoid accepting DPi pairs that were not formed in DPi pair creator
+    float const invMass2DPiMin = (o2::constants::physics::MassB0 - myInvMassWindowDPi + invMassWindowDPiTolerance) * (o2::constants::physics::MassB0 - myInvMassWindowDPi + invMassWindowDPiTolerance);
+    float const invMass2DPiMax = (o2::constants::physics::MassB0 + myInvMassWindowDPi - invMassWindowDPiTolerance) * (o2::constants::physics::MassB0 + myInvMassWindowDPi - invMassWindowDPiTolerance);
+
+    for (const auto& collisionCounter : collisionsCounter) {
+      registry.fill(HIST("hEvents"), 1, collisionCounter.originalCollisionCount());
+    }
+
+    static int ncol = 0;
+    for (const auto& collision : collisions) {
+      auto thisCollId = collision.globalIndex();
+      auto candsDThisColl = candsD.sliceBy(candsDplusPerCollision, thisCollId);
+      auto tracksPionThisCollision = tracksPion.sliceBy(tracksPionCompactCovPerCollision, thisCollId);
+      runCandidateCreation<false>(collision, candsDThisColl, tracksPionThisCollision, invMass2DPiMin, invMass2DPiMax);
+      if (ncol % 10000 == 0) {
+        LOGP(debug, "collisions parsed {}", ncol);
+      }
+      ncol++;
+    }
+  } // processDataDplusPiCompactCov
+
+  PROCESS_SWITCH(HfCandidateCreatorB0Reduced, processDataDplusPiCompactCov, "Process data D-pi without any ML score, with compact pion covariance matrices", false);
+
   void processDataDplusPiWithDmesMl(HfRedCollisionsWithExtras const& collisions,
                                     soa::Join<aod::HfRed3Prongs, aod::HfRed3ProngsCov, aod::HfRed3ProngsMl> const& candsD,
                                     soa::Join<aod::HfRedTrackBases, aod::HfRedTracksCov> const& tracksPion,
@@ -77,13 +77,14 @@ struct HfCandidateCreatorBplusReduced {
   Preslice<soa::Join<aod::HfRed2Prongs, aod::HfRed2ProngsCov>> candsDPerCollision = hf_track_index_reduced::hfRedCollisionId;
   Preslice<soa::Join<aod::HfRed2Prongs, aod::HfRed2ProngsCov, aod::HfRed2ProngsMl>> candsDWithMlPerCollision = hf_track_index_reduced::hfRedCollisionId;
   Preslice<soa::Join<aod::HfRedTracks, aod::HfRedTracksCov>> tracksPionPerCollision = hf_track_index_reduced::hfRedCollisionId;
+  Preslice<soa::Join<aod::HfRedTracks, aod::HfRedTracksCovCompact>> tracksPionCompactCovPerCollision = hf_track_index_reduced::hfRedCollisionId;
 
   std::shared_ptr<TH1> hCandidates;
   HistogramRegistry registry{"registry"};
 
   void init(InitContext const&)
   {
-    std::array<bool, 2> doprocess{doprocessData, doprocessDataWithDmesMl};
+    std::array<bool, 3> doprocess{doprocessData, doprocessDataCompactCov, doprocessDataWithDmesMl};
     if ((std::accumulate(doprocess.begin(), doprocess.end(), 0)) != 1) {
       LOGP(fatal, "Only one process function for data should be enabled at a time.");
     }
@@ -248,6 +249,41 @@ struct HfCandidateCreatorBplusReduced {
 
   PROCESS_SWITCH(HfCandidateCreatorBplusReduced, processData, "Process data without any ML score", true);
 
+  void processDataCompactCov(HfRedCollisionsWithExtras const& collisions,
+                             soa::Join<aod::HfRed2Prongs, aod::HfRed2ProngsCov> const& candsD,
+                             soa::Join<aod::HfRedTrackBases, aod::HfRedTracksCovCompact> const& tracksPion,
+                             aod::HfOrigColCounts const& collisionsCounter,
+                             aod::HfCandBpConfigs const& configs)
+  {
+    // D0Pi invariant-mass window cut
+    for (const auto& config : configs) {
+      myInvMassWindowD0Pi = config.myInvMassWindowD0Pi();
+    }
+    // invMassWindowD0PiTolerance is used to apply a slightly tighter cut than in D0Pi pair preselection
+    // to avoid accepting D0Pi pairs that were not formed in D0Pi pair creator
+    double const invMass2D0PiMin = (massBplus - myInvMassWindowD0Pi + invMassWindowD0PiTolerance) * (massBplus - myInvMassWindowD0Pi + invMassWindowD0PiTolerance);
+    double const invMass2D0PiMax = (massBplus + myInvMassWindowD0Pi - invMassWindowD0PiTolerance) * (massBplus + myInvMassWindowD0Pi - invMassWindowD0PiTolerance);
+
+    for (const auto& collisionCounter : collisionsCounter) {
+      registry.fill(HIST("hEvents"), 1, collisionCounter.originalCollisionCount());
+    }
+
+    static int ncol = 0;
+
+    for (const auto& collision : collisions) {
+      auto thisCollId = collision.globalIndex();
+      auto candsDThisColl = candsD.sliceBy(candsDPerCollision, thisCollId);
+      auto tracksPionThisCollision = tracksPion.sliceBy(tracksPionCompactCovPerCollision, thisCollId);
+      runCandidateCreation<false>(collision, candsDThisColl, tracksPionThisCollision, invMass2D0PiMin, invMass2D0PiMax);
+      if (ncol % 10000 == 0) {
+        LOG(debug) << ncol << " collisions parsed";
+      }
+      ncol++;
+    }
+  } // processDataCompactCov
+
+  PROCESS_SWITCH(HfCandidateCreatorBplusReduced, processDataCompactCov, "Process data without any ML score, with compact pion covariance matrices", false);
+
   void processDataWithDmesMl(HfRedCollisionsWithExtras const& collisions,
                              soa::Join<aod::HfRed2Prongs, aod::HfRed2ProngsCov, aod::HfRed2ProngsMl> const& candsD,
                              soa::Join<aod::HfRedTrackBases, aod::HfRedTracksCov> const& tracksPion,
@@ -123,6 +123,7 @@ struct HfDataCreatorCharmHadPiReduced {
     // Pi bachelor related tables
     Produces<aod::HfRedTrackBases> hfTrackPion;
     Produces<aod::HfRedTracksCov> hfTrackCovPion;
+    Produces<aod::HfRedTracksCovCompact> hfTrackCovCompactPion;
     Produces<aod::HfRedTracksPid> hfTrackPidPion;
     Produces<aod::HfRedTracksMom> hfTrackMomPion;
     // charm hadron related tables
@@ -174,6 +175,8 @@ struct HfDataCreatorCharmHadPiReduced {
     Configurable<std::string> ccdbPathGrpMag{"ccdbPathGrpMag", "GLO/Config/GRPMagField", "CCDB path of the GRPMagField object (Run 3)"};
     // pair selection
     Configurable<double> invMassWindowCharmHadPi{"invMassWindowCharmHadPi", 0.3, "invariant-mass window for CharmHad-Pi pair preselections (GeV/c2)"};
+    // output format
+    Configurable<bool> storeCompactCovPion{"storeCompactCovPion", false, "store the pion covariance matrices in HfRedTracksCovCompact (off-diagonal elements as packed correlation coefficients) instead of HfRedTracksCov"};
     // MC extra
     Configurable<bool> checkDecayTypeMc{"checkDecayTypeMc", false, "flag to enable MC checks on decay type"};
   } configs;
@@ -1320,12 +1323,32 @@ struct HfDataCreatorCharmHadPiReduced {
                              trackParCovPion.getY(), trackParCovPion.getZ(), trackParCovPion.getSnp(),
                              trackParCovPion.getTgl(), trackParCovPion.getQ2Pt(),
                              trackPion.itsNCls(), trackPion.tpcNClsCrossedRows(), trackPion.tpcChi2NCl());
-          tables.hfTrackCovPion(trackParCovPion.getSigmaY2(), trackParCovPion.getSigmaZY(), trackParCovPion.getSigmaZ2(),
-                                trackParCovPion.getSigmaSnpY(), trackParCovPion.getSigmaSnpZ(),
-                                trackParCovPion.getSigmaSnp2(), trackParCovPion.getSigmaTglY(), trackParCovPion.getSigmaTglZ(),
-                                trackParCovPion.getSigmaTglSnp(), trackParCovPion.getSigmaTgl2(),
-                                trackParCovPion.getSigma1PtY(), trackParCovPion.getSigma1PtZ(), trackParCovPion.getSigma1PtSnp(),
-                                trackParCovPion.getSigma1PtTgl(), trackParCovPion.getSigma1Pt2());
+          if (configs.storeCompactCovPion) {
+            using o2::aod::hf_track_par_cov_compact::CovPacking;
+            const float cYY = trackParCovPion.getSigmaY2();
+            const float cZZ = trackParCovPion.getSigmaZ2();
+            const float cSnpSnp = trackParCovPion.getSigmaSnp2();
+            const float cTglTgl = trackParCovPion.getSigmaTgl2();
+            const float c1Pt21Pt2 = trackParCovPion.getSigma1Pt2();
+            tables.hfTrackCovCompactPion(cYY, cZZ, cSnpSnp, cTglTgl, c1Pt21Pt2,
+                                         CovPacking::pack(trackParCovPion.getSigmaZY(), cZZ, cYY),
+                                         CovPacking::pack(trackParCovPion.getSigmaSnpY(), cSnpSnp, cYY),
+                                         CovPacking::pack(trackParCovPion.getSigmaSnpZ(), cSnpSnp, cZZ),
+                                         CovPacking::pack(trackParCovPion.getSigmaTglY(), cTglTgl, cYY),
+                                         CovPacking::pack(trackParCovPion.getSigmaTglZ(), cTglTgl, cZZ),
+                                         CovPacking::pack(trackParCovPion.getSigmaTglSnp(), cTglTgl, cSnpSnp),
+                                         CovPacking::pack(trackParCovPion.getSigma1PtY(), c1Pt21Pt2, cYY),
+                                         CovPacking::pack(trackParCovPion.getSigma1PtZ(), c1Pt21Pt2, cZZ),
+                                         CovPacking::pack(trackParCovPion.getSigma1PtSnp(), c1Pt21Pt2, cSnpSnp),
+                                         CovPacking::pack(trackParCovPion.getSigma1PtTgl(), c1Pt21Pt2, cTglTgl));
+          } else {
+            tables.hfTrackCovPion(trackParCovPion.getSigmaY2(), trackParCovPion.getSigmaZY(), trackParCovPion.getSigmaZ2(),
+                                  trackParCovPion.getSigmaSnpY(), trackParCovPion.getSigmaSnpZ(),
+                                  trackParCovPion.getSigmaSnp2(), trackParCovPion.getSigmaTglY(), trackParCovPion.getSigmaTglZ(),
+                                  trackParCovPion.getSigmaTglSnp(), trackParCovPion.getSigmaTgl2(),
+                                  trackParCovPion.getSigma1PtY(), trackParCovPion.getSigma1PtZ(), trackParCovPion.getSigma1PtSnp(),
+                                  trackParCovPion.getSigma1PtTgl(), trackParCovPion.getSigma1Pt2());
+          }
           tables.hfTrackPidPion(trackPion.hasTPC(), trackPion.hasTOF(),
                                 trackPion.tpcNSigmaPi(), trackPion.tofNSigmaPi());
           tables.hfTrackMomPion(pVecPion[0], pVecPion[1], pVecPion[2], trackPion.sign());
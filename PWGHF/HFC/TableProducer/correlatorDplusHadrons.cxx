@@ -21,6 +21,8 @@
 #include "PWGHF/DataModel/CandidateSelectionTables.h"
 #include "PWGHF/DataModel/TrackIndexSkimmingTables.h"
 #include "PWGHF/HFC/DataModel/CorrelationTables.h"
+#include "PWGHF/HFC/Utils/utilsCorrelations.h"
+#include "PWGHF/HFC/Utils/utilsMixingPool.h"
 #include "PWGHF/Utils/utilsAnalysis.h"
 
 #include "Common/CCDB/EventSelectionParams.h"
@@ -47,6 +49,7 @@
 #include <TPDGCode.h>
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <vector>
@@ -186,6 +189,8 @@ struct HfCorrelatorDplusHadrons {
 
   Configurable<int> selectionFlagDplus{"selectionFlagDplus", 7, "Selection Flag for Dplus"}; // 7 corresponds to topo+PID cuts
   Configurable<int> numberEventsMixed{"numberEventsMixed", 5, "Number of events mixed in ME process"};
+  Configurable<int> depthMixingPool{"depthMixingPool", 20, "Number of events kept per mixing bin in the ME process with the persistent pool"};
+  Configurable<int64_t> maxTracksMixingPool{"maxTracksMixingPool", -1, "Maximum number of tracks stored in the persistent mixing pool (no limit if <= 0)"};
   Configurable<bool> applyEfficiency{"applyEfficiency", true, "Flag for applying D-meson efficiency weights"};
   Configurable<bool> removeDaughters{"removeDaughters", true, "Flag for removing D-meson daughters from correlations"};
   Configurable<float> yCandMax{"yCandMax", 0.8, "max. cand. rapidity"};
@@ -237,6 +242,9 @@ struct HfCorrelatorDplusHadrons {
   ConfigurableAxis binsMultFT0M{"binsMultFT0M", {600, 0., 6000.}, "Multiplicity as FT0M signal amplitude"};
   ConfigurableAxis binsMassD{"binsMassD", {200, 1.7, 2.10}, "inv. mass (#pi^{+}K^{-}#pi^{+}) (GeV/#it{c}^{2})"};
   BinningType corrBinning{{binsZVtx, binsMultiplicity}, true};
+  hf_correlations::AssociatedTrackBlock<TracksData::iterator> assocTracksData; // associated tracks of the current collision, data
+  hf_correlations::AssociatedTrackBlock<TracksWithMc::iterator> assocTracksMc; // associated tracks of the current collision, MC reco
+  hf_correlations::HfMixingPool mixingPool;                                     // associated tracks of the previous collisions, across data frames
   HistogramRegistry registry{"registry", {}, OutputObjHandlingPolicy::AnalysisObject};
 
   void init(InitContext&)
@@ -309,6 +317,9 @@ struct HfCorrelatorDplusHadrons {
     registry.add("hPhiMcGen", "D+,Hadron particles - MC Gen", {HistType::kTH1F, {axisPhi}});
     registry.add("hMultFT0AMcGen", "D+,Hadron multiplicity FT0A - MC Gen", {HistType::kTH1F, {axisMultiplicity}});
     corrBinning = {{binsZVtx, binsMultiplicity}, true};
+    if (doprocessDataMixedEventPool) {
+      mixingPool.init(depthMixingPool, maxTracksMixingPool);
+    }
   }
 
   /// Dplus-hadron correlation pair builder - for real data and data-like analysis (i.e. reco-level w/o matching request via MC truth)
@@ -337,6 +348,9 @@ struct HfCorrelatorDplusHadrons {
       }
       registry.fill(HIST("hMultiplicity"), nTracks);
 
+      // associated tracks passing the candidate-independent selection, shared by all the candidates of the collision
+      assocTracksData.build(tracks, [](const auto& track) { return track.isGlobalTrackWoDCA(); });
+
       int cntDplus = 0;
       std::vector<float> outputMl = {-1., -1., -1.};
       for (const auto& candidate : candidates) {
@@ -368,27 +382,25 @@ struct HfCorrelatorDplusHadrons {
 
         // Dplus-Hadron correlation dedicated section
         // if the candidate is a Dplus, search for Hadrons and evaluate correlations
-        for (const auto& track : tracks) {
-          // apply track selection
-          if (!track.isGlobalTrackWoDCA()) {
-            continue;
-          }
+        for (std::size_t iTrack = 0; iTrack < assocTracksData.size(); iTrack++) {
+          const auto& track = assocTracksData.track(iTrack);
+          const auto trackIndex = assocTracksData.globalIndex(iTrack);
           // Removing Dplus daughters by checking track indices
           if (removeDaughters) {
-            if ((candidate.prong0Id() == track.globalIndex()) || (candidate.prong1Id() == track.globalIndex()) || (candidate.prong2Id() == track.globalIndex())) {
+            if ((candidate.prong0Id() == trackIndex) || (candidate.prong1Id() == trackIndex) || (candidate.prong2Id() == trackIndex)) {
               continue;
             }
           }
-          entryDplusHadronPair(getDeltaPhi(track.phi(), candidate.phi()),
-                               track.eta() - candidate.eta(),
+          entryDplusHadronPair(getDeltaPhi(assocTracksData.phi(iTrack), candidate.phi()),
+                               assocTracksData.eta(iTrack) - candidate.eta(),
                                candidate.pt(),
-                               track.pt(), poolBin);
+                               assocTracksData.pt(iTrack), poolBin);
           entryDplusHadronRecoInfo(HfHelper::invMassDplusToPiKPi(candidate), false);
           entryDplusHadronGenInfo(false, false, 0);
           entryDplusHadronMlInfo(outputMl[0], outputMl[1], outputMl[2]);
           entryTrackRecoInfo(track.dcaXY(), track.dcaZ(), track.tpcNClsCrossedRows());
           if (cntDplus == 0) {
-            entryHadron(track.phi(), track.eta(), track.pt(), poolBin, gCollisionId, timeStamp);
+            entryHadron(assocTracksData.phi(iTrack), assocTracksData.eta(iTrack), assocTracksData.pt(iTrack), poolBin, gCollisionId, timeStamp);
             registry.fill(HIST("hTracksBin"), poolBin);
           }
         } // Hadron Tracks loop
@@ -425,6 +437,9 @@ struct HfCorrelatorDplusHadrons {
 
       float const multiplicityFT0M = collision.multFT0M();
 
+      // associated tracks passing the candidate-independent selection, shared by all the candidates of the collision
+      assocTracksMc.build(tracks, [](const auto& track) { return track.isGlobalTrackWoDCA(); });
+
       // MC reco level
       for (const auto& candidate : candidates) {
         // rapidity and pT selections
@@ -492,23 +507,21 @@ struct HfCorrelatorDplusHadrons {
 
         // Dplus-Hadron correlation dedicated section
         // if the candidate is selected as Dplus, search for Hadron and evaluate correlations
-        for (const auto& track : tracks) {
+        for (std::size_t iTrack = 0; iTrack < assocTracksMc.size(); iTrack++) {
+          const auto& track = assocTracksMc.track(iTrack);
+          const auto trackIndex = assocTracksMc.globalIndex(iTrack);
           bool isPhysicalPrimary = false;
           int trackOrigin = -1;
-          // apply track selection
-          if (!track.isGlobalTrackWoDCA()) {
-            continue;
-          }
           // Removing Dplus daughters by checking track indices
           if (removeDaughters) {
-            if ((candidate.prong0Id() == track.globalIndex()) || (candidate.prong1Id() == track.globalIndex()) || (candidate.prong2Id() == track.globalIndex())) {
+            if ((candidate.prong0Id() == trackIndex) || (candidate.prong1Id() == trackIndex) || (candidate.prong2Id() == trackIndex)) {
               continue;
             }
           }
-          entryDplusHadronPair(getDeltaPhi(track.phi(), candidate.phi()),
-                               track.eta() - candidate.eta(),
+          entryDplusHadronPair(getDeltaPhi(assocTracksMc.phi(iTrack), candidate.phi()),
+                               assocTracksMc.eta(iTrack) - candidate.eta(),
                                candidate.pt(),
-                               track.pt(), poolBin);
+                               assocTracksMc.pt(iTrack), poolBin);
           entryDplusHadronRecoInfo(HfHelper::invMassDplusToPiKPi(candidate), isDplusSignal);
           entryDplusHadronMlInfo(outputMl[0], outputMl[1], outputMl[2]);
           if (track.has_mcParticle()) {
@@ -656,6 +669,39 @@ struct HfCorrelatorDplusHadrons {
   }
   PROCESS_SWITCH(HfCorrelatorDplusHadrons, processDataMixedEvent, "Process Mixed Event Data", false);
 
+  /// Mixed event with a pool of the associated tracks persisting across data frames:
+  /// the Dplus candidates of each collision are paired with the tracks of the previous collisions of the same bin, then its tracks are added to the pool
+  void processDataMixedEventPool(SelCollisionsWithDplus::iterator const& collision,
+                                 CandidatesDplusData const& candidates,
+                                 TracksData const& tracks)
+  {
+    int const poolBin = corrBinning.getBin(std::make_tuple(collision.posZ(), collision.multFT0M()));
+    if (poolBin < 0) {
+      return;
+    }
+    for (int iEvent = 0; iEvent < mixingPool.getNEvents(poolBin); iEvent++) {
+      const auto& event = mixingPool.getEvent(poolBin, iEvent);
+      for (const auto& trigDplus : candidates) {
+        if (std::abs(HfHelper::yDplus(trigDplus)) >= yCandMax) {
+          continue;
+        }
+        for (std::size_t iTrack = 0; iTrack < event.size(); iTrack++) {
+          entryDplusHadronPair(getDeltaPhi(trigDplus.phi(), event.phi(iTrack)), trigDplus.eta() - event.eta(iTrack), trigDplus.pt(), event.pt(iTrack), poolBin);
+          entryDplusHadronRecoInfo(HfHelper::invMassDplusToPiKPi(trigDplus), 0);
+        }
+      }
+    }
+    mixingPool.startEvent(poolBin);
+    for (const auto& track : tracks) {
+      if (!track.isGlobalTrackWoDCA()) {
+        continue;
+      }
+      mixingPool.addTrack(track.pt(), track.eta(), track.phi(), track.sign());
+    }
+    mixingPool.finishEvent();
+  }
+  PROCESS_SWITCH(HfCorrelatorDplusHadrons, processDataMixedEventPool, "Process Mixed Event Data with a pool persisting across data frames", false);
+
   void processMcRecMixedEvent(SelCollisionsWithDplus const& collisions,
                               CandidatesDplusMcRec const& candidates,
                               TracksWithMc const& tracks,
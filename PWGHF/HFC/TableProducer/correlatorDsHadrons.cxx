@@ -54,6 +54,7 @@
 
 #include <array>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <unordered_map>
@@ -247,6 +248,9 @@ struct HfCorrelatorDsHadrons {
   ConfigurableAxis binsPosZ{"binsPosZ", {100, -10., 10.}, "primary vertex z coordinate"};
   ConfigurableAxis binsPoolBin{"binsPoolBin", {9, 0., 9.}, "PoolBin"};
 
+  AssociatedTrackBlock<MyTracksData::iterator> assocTracksData; // associated tracks of the current collision, data
+  AssociatedTrackBlock<TracksWithMc::iterator> assocTracksMc;   // associated tracks of the current collision, MC reco
+
   HistogramRegistry registry{"registry", {}, OutputObjHandlingPolicy::AnalysisObject};
 
   void init(InitContext&)
@@ -450,6 +454,9 @@ struct HfCorrelatorDsHadrons {
     int const nTracks = tracks.size();
     registry.fill(HIST("hMultiplicity"), nTracks);
 
+    // associated tracks passing the candidate-independent selection, shared by all the candidates of the collision
+    assocTracksData.build(tracks, [](const auto& track) { return track.isGlobalTrackWoDCA(); });
+
     // Ds fill histograms and Ds-Hadron correlation for DsToKKPi
     for (const auto& candidate : candidates) {
       if (std::abs(HfHelper::yDs(candidate)) > yCandMax || candidate.pt() < ptCandMin || candidate.pt() > ptCandMax) {
@@ -481,22 +488,24 @@ struct HfCorrelatorDsHadrons {
       }
 
       // Ds-Hadron correlation dedicated section
-      for (const auto& track : tracks) {
+      for (std::size_t iTrack = 0; iTrack < assocTracksData.size(); iTrack++) {
+        const auto& track = assocTracksData.track(iTrack);
+        const auto trackIndex = assocTracksData.globalIndex(iTrack);
         // Removing Ds daughters by checking track indices
-        if ((candidate.prong0Id() == track.globalIndex()) || (candidate.prong1Id() == track.globalIndex()) || (candidate.prong2Id() == track.globalIndex())) {
-          continue;
-        }
-        if (!track.isGlobalTrackWoDCA()) {
+        if ((candidate.prong0Id() == trackIndex) || (candidate.prong1Id() == trackIndex) || (candidate.prong2Id() == trackIndex)) {
           continue;
         }
 
-        registry.fill(HIST("hEtaVsPtPartAssoc"), track.eta(), candidate.pt());
-        registry.fill(HIST("hPhiVsPtPartAssoc"), RecoDecay::constrainAngle(track.phi(), -PIHalf), candidate.pt());
+        const auto etaTrack = assocTracksData.eta(iTrack);
+        const auto phiTrack = assocTracksData.phi(iTrack);
+        const auto ptTrack = assocTracksData.pt(iTrack);
+        registry.fill(HIST("hEtaVsPtPartAssoc"), etaTrack, candidate.pt());
+        registry.fill(HIST("hPhiVsPtPartAssoc"), RecoDecay::constrainAngle(phiTrack, -PIHalf), candidate.pt());
         if (candidate.isSelDsToKKPi() >= selectionFlagDs) {
-          entryDsHadronPair(getDeltaPhi(track.phi(), candidate.phi()),
-                            track.eta() - candidate.eta(),
+          entryDsHadronPair(getDeltaPhi(phiTrack, candidate.phi()),
+                            etaTrack - candidate.eta(),
                             candidate.pt() * chargeDs,
-                            track.pt() * track.sign(),
+                            ptTrack * track.sign(),
                             poolBin,
                             collision.numContrib());
           entryDsHadronRecoInfo(HfHelper::invMassDsToKKPi(candidate), false, false);
@@ -504,10 +513,10 @@ struct HfCorrelatorDsHadrons {
           entryDsHadronMlInfo(outputMl[0], outputMl[2]);
           entryTrackRecoInfo(track.dcaXY(), track.dcaZ(), track.tpcNClsCrossedRows());
         } else if (candidate.isSelDsToPiKK() >= selectionFlagDs) {
-          entryDsHadronPair(getDeltaPhi(track.phi(), candidate.phi()),
-                            track.eta() - candidate.eta(),
+          entryDsHadronPair(getDeltaPhi(phiTrack, candidate.phi()),
+                            etaTrack - candidate.eta(),
                             candidate.pt() * chargeDs,
-                            track.pt() * track.sign(),
+                            ptTrack * track.sign(),
                             poolBin,
                             collision.numContrib());
           entryDsHadronRecoInfo(HfHelper::invMassDsToPiKK(candidate), false, false);
@@ -536,6 +545,8 @@ struct HfCorrelatorDsHadrons {
     bool isCorrectInvMassHypo = false;
     bool isAlreadyFilledEvent = false;
     float const multiplicityFT0M = collision.multFT0M();
+    // associated tracks passing the candidate-independent selection, shared by all the candidates of the collision
+    assocTracksMc.build(tracks, [](const auto& track) { return track.isGlobalTrackWoDCA(); });
     for (const auto& candidate : candidates) {
       // prompt and non-prompt division
       bool isDsPrompt = candidate.originMcRec() == RecoDecay::OriginType::Prompt;
@@ -605,12 +616,11 @@ struct HfCorrelatorDsHadrons {
 
       // Ds-Hadron correlation dedicated section
       // if the candidate is selected as Ds, search for Hadron and evaluate correlations
-      for (const auto& track : tracks) {
+      for (std::size_t iTrack = 0; iTrack < assocTracksMc.size(); iTrack++) {
+        const auto& track = assocTracksMc.track(iTrack);
+        const auto trackIndex = assocTracksMc.globalIndex(iTrack);
         // Removing Ds daughters by checking track indices
-        if ((candidate.prong0Id() == track.globalIndex()) || (candidate.prong1Id() == track.globalIndex()) || (candidate.prong2Id() == track.globalIndex())) {
-          continue;
-        }
-        if (!track.isGlobalTrackWoDCA()) {
+        if ((candidate.prong0Id() == trackIndex) || (candidate.prong1Id() == trackIndex) || (candidate.prong2Id() == trackIndex)) {
           continue;
         }
         if (!track.has_mcParticle()) { // remove traks that don't have a corresponding generated track
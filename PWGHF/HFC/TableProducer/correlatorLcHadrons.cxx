@@ -57,6 +57,7 @@
 #include <TRandom3.h>
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <vector>
@@ -284,6 +285,9 @@ struct HfCorrelatorLcHadrons {
 
   BinningType corrBinning{{binsZVtx, binsMultiplicity}, true};
 
+  AssociatedTrackBlock<TracksData::iterator> assocTracksData; // associated tracks of the current collision
+  AssociatedTrackBlock<TracksWithMc::iterator> assocTracksMc;
+
   HistogramRegistry registry{"registry", {}, OutputObjHandlingPolicy::AnalysisObject};
   void init(InitContext&)
   {
@@ -409,6 +413,17 @@ struct HfCorrelatorLcHadrons {
     }
     registry.fill(HIST("hMultiplicity"), nTracks);
 
+    // associated tracks passing the candidate-independent selections, shared by all the candidates of the collision
+    assocTracksData.build(tracks, [this](const auto& track) {
+      if (!track.isGlobalTrackWoDCA()) {
+        return false;
+      }
+      if (pidTrkApplied && !passPIDSelection(track, trkPIDspecies, pidTPCMax, pidTOFMax, tofPIDThreshold, forceTOF)) {
+        return false;
+      }
+      return !correlateLcWithLeadingParticle || track.globalIndex() == leadingIndex;
+    });
+
     int countLc = 0;
     std::vector<float> outputMl = {-1., -1., -1.};
 
@@ -459,33 +474,22 @@ struct HfCorrelatorLcHadrons {
 
       // Lc-Hadron correlation dedicated section
       // if the candidate is a Lc, search for Hadrons and evaluate correlations
-      for (const auto& track : tracks) {
+      for (std::size_t iTrack = 0; iTrack < assocTracksData.size(); iTrack++) {
+        const auto& track = assocTracksData.track(iTrack);
+        const auto trackIndex = assocTracksData.globalIndex(iTrack);
         correlationStatus = false;
         // Remove Lc daughters by checking track indices
-        if ((candidate.prong0Id() == track.globalIndex()) || (candidate.prong1Id() == track.globalIndex()) || (candidate.prong2Id() == track.globalIndex())) {
+        if ((candidate.prong0Id() == trackIndex) || (candidate.prong1Id() == trackIndex) || (candidate.prong2Id() == trackIndex)) {
           if (!storeAutoCorrelationFlag) {
             continue;
           }
           correlationStatus = true;
         }
-        if (!track.isGlobalTrackWoDCA()) {
-          continue;
-        }
-        if (pidTrkApplied) {
-          if (!passPIDSelection(track, trkPIDspecies, pidTPCMax, pidTOFMax, tofPIDThreshold, forceTOF)) {
-            continue;
-          }
-        }
-        if (correlateLcWithLeadingParticle) {
-          if (track.globalIndex() != leadingIndex) {
-            continue;
-          }
-        }
         if (candidate.isSelLcToPKPi() >= selectionFlagLc) {
-          entryLcHadronPair(getDeltaPhi(track.phi(), candidate.phi()),
-                            track.eta() - candidate.eta(),
+          entryLcHadronPair(getDeltaPhi(assocTracksData.phi(iTrack), candidate.phi()),
+                            assocTracksData.eta(iTrack) - candidate.eta(),
                             candidate.pt() * chargeLc,
-                            track.pt() * track.sign(),
+                            assocTracksData.pt(iTrack) * track.sign(),
                             poolBin,
                             correlationStatus,
                             cent);
@@ -499,10 +503,10 @@ struct HfCorrelatorLcHadrons {
           }
         }
         if (candidate.isSelLcToPiKP() >= selectionFlagLc) {
-          entryLcHadronPair(getDeltaPhi(track.phi(), candidate.phi()),
-                            track.eta() - candidate.eta(),
+          entryLcHadronPair(getDeltaPhi(assocTracksData.phi(iTrack), candidate.phi()),
+                            assocTracksData.eta(iTrack) - candidate.eta(),
                             candidate.pt() * chargeLc,
-                            track.pt() * track.sign(),
+                            assocTracksData.pt(iTrack) * track.sign(),
                             poolBin,
                             correlationStatus,
                             cent);
@@ -517,7 +521,7 @@ struct HfCorrelatorLcHadrons {
         }
         if (countLc == 0) {
           if (!skipMixedEventTableFilling) {
-            entryHadron(track.phi(), track.eta(), track.pt() * track.sign(), poolBin, gCollisionId, timeStamp);
+            entryHadron(assocTracksData.phi(iTrack), assocTracksData.eta(iTrack), assocTracksData.pt(iTrack) * track.sign(), poolBin, gCollisionId, timeStamp);
             if (fillTrkPID) {
               entryTrkPID(track.tpcNSigmaPr(), track.tpcNSigmaKa(), track.tpcNSigmaPi(), track.tofNSigmaPr(), track.tofNSigmaKa(), track.tofNSigmaPi());
             }
@@ -565,6 +569,10 @@ struct HfCorrelatorLcHadrons {
     registry.fill(HIST("hMultiplicity"), nTracks);
 
     float const multiplicityFT0M = collision.multFT0M();
+    // associated tracks passing the candidate-independent selections, shared by all the candidates of the collision
+    assocTracksMc.build(tracks, [this](const auto& track) {
+      return track.isGlobalTrackWoDCA() && (!pidTrkApplied || passPIDSelection(track, trkPIDspecies, pidTPCMax, pidTOFMax, tofPIDThreshold, forceTOF));
+    });
     // Mc reco level
     bool isLcPrompt = false;
     bool isLcNonPrompt = false;
@@ -700,19 +708,11 @@ struct HfCorrelatorLcHadrons {
 
       // Lc-Hadron correlation dedicated section
       // if the candidate is selected as Lc, search for Hadron ad evaluate correlations
-      for (const auto& track : tracks) {
+      for (std::size_t iTrack = 0; iTrack < assocTracksMc.size(); iTrack++) {
+        const auto& track = assocTracksMc.track(iTrack);
         correlationStatus = false;
         bool isPhysicalPrimary = false;
         int trackOrigin = -1;
-        // apply track selection
-        if (!track.isGlobalTrackWoDCA()) {
-          continue;
-        }
-        if (pidTrkApplied) {
-          if (!passPIDSelection(track, trkPIDspecies, pidTPCMax, pidTOFMax, tofPIDThreshold, forceTOF)) {
-            continue;
-          }
-        }
 
         if (calTrkEff && countLc == 1 && (isLcSignal || !calEffLcEvent) && track.has_mcParticle()) {
           auto mcParticle = track.template mcParticle_as<aod::McParticles>();
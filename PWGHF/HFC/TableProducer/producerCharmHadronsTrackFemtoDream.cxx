@@ -31,6 +31,7 @@
 #include "PWGHF/DataModel/CandidateSelectionTables.h"
 #include "PWGHF/Utils/utilsBfieldCCDB.h"
 #include "PWGHF/Utils/utilsEvSelHf.h"
+#include "PWGHF/Utils/utilsMlHf.h"
 
 #include "Common/Core/ZorroSummary.h"
 #include "Common/DataModel/Centrality.h"
@@ -194,6 +195,7 @@ struct HfProducerCharmHadronsTrackFemtoDream {
   o2::analysis::HfMlResponseDplusToPiKPi<float> hfMlResponseDplus;
   o2::analysis::HfMlResponseD0ToKPi<float> hfMlResponseD0;
   o2::analysis::HfMlResponseDstarToD0Pi<float> hfMlResponseDstar;
+  bool reuseSelectorScoresLc{false}; // the Lc selector of the workflow evaluates the same model, whose published scores are then only cut on
 
   std::vector<float> outputMlD0;
   std::vector<float> outputMlD0bar;
@@ -240,7 +242,7 @@ struct HfProducerCharmHadronsTrackFemtoDream {
   HistogramRegistry trackRegistry{"Tracks", {}, OutputObjHandlingPolicy::AnalysisObject};
   OutputObj<ZorroSummary> zorroSummary{"zorroSummary"};
 
-  void init(InitContext&)
+  void init(InitContext& initContext)
   {
     std::array<bool, 20> processes = {doprocessDataDplusToPiKPi, doprocessMcDplusToPiKPi, doprocessDataDplusToPiKPiWithML, doprocessMcDplusToPiKPiWithML, doprocessMcDplusToPiKPiGen,
                                       doprocessDataLcToPKPi, doprocessMcLcToPKPi, doprocessDataLcToPKPiWithML, doprocessMcLcToPKPiWithML, doprocessMcLcToPKPiGen, doprocessDataD0ToPiK, doprocessMcD0ToPiK, doprocessDataD0ToPiKWithML, doprocessMcD0ToPiKWithML, doprocessMcD0ToPiKGen, doprocessDataDstarToD0Pi, doprocessMcDstarToD0Pi, doprocessDataDstarToD0PiWithML, doprocessMcDstarToD0PiWithML, doprocessMcDstarToD0PiGen};
@@ -303,6 +305,24 @@ struct HfProducerCharmHadronsTrackFemtoDream {
 
     if (applyMlMode == FillMlFromNewBDT) {
 
+      if (useLcMl) {
+        HfMlModelIdentity identitySelector;
+        const HfMlModelIdentity identity{true, loadModelsFromCCDB.value, timestampCCDB.value, nClassesMl.value, modelPathsCCDB.value, onnxFileNames.value, namesInputFeatures.value};
+        bool selectorWithKfParticle{false};
+        if (getMlModelIdentity(initContext, "hf-candidate-selector-lc", identitySelector) && identitySelector.applyMl) {
+          bool processWithKfParticle{false};
+          for (const auto& processName : {"processNoBayesPidWithKFParticle", "processBayesPidWithKFParticle"}) {
+            if (getTaskOptionValue(initContext, "hf-candidate-selector-lc", processName, processWithKfParticle, false) && processWithKfParticle) {
+              selectorWithKfParticle = true;
+            }
+          }
+          reuseSelectorScoresLc = !selectorWithKfParticle && identity.isSameModel(identitySelector);
+        }
+        if (reuseSelectorScoresLc) {
+          LOGF(info, "The Lc model is the one of hf-candidate-selector-lc: its scores are reused instead of evaluating the model again");
+        }
+      }
+
       auto setupFeatures = [&](auto& hfResponse, bool useMlFlag) {
         if (!useMlFlag) {
           return;
@@ -334,7 +354,7 @@ struct HfProducerCharmHadronsTrackFemtoDream {
         hfResponse.init();
       };
 
-      initModel(hfMlResponseLc, useLcMl);
+      initModel(hfMlResponseLc, useLcMl && !reuseSelectorScoresLc);
       initModel(hfMlResponseDplus, useDplusMl);
       initModel(hfMlResponseD0, useD0Ml);
       initModel(hfMlResponseDstar, useDstarMl);
@@ -773,12 +793,22 @@ struct HfProducerCharmHadronsTrackFemtoDream {
             isSelectedMlLcToPKPi = false;
             isSelectedMlLcToPiKP = false;
             if (candidate.mlProbLcToPKPi().size() > 0) {
-              std::vector<float> inputFeaturesLcToPKPi = hfMlResponseLc.getInputFeatures(candidate, true);
-              isSelectedMlLcToPKPi = hfMlResponseLc.isSelectedMl(inputFeaturesLcToPKPi, candidate.pt(), outputMlPKPi);
+              if (reuseSelectorScoresLc) {
+                outputMlPKPi.assign(candidate.mlProbLcToPKPi().begin(), candidate.mlProbLcToPKPi().end());
+                isSelectedMlLcToPKPi = hfMlResponseLc.isSelectedMlScores(outputMlPKPi, candidate.pt());
+              } else {
+                std::vector<float> inputFeaturesLcToPKPi = hfMlResponseLc.getInputFeatures(candidate, true);
+                isSelectedMlLcToPKPi = hfMlResponseLc.isSelectedMl(inputFeaturesLcToPKPi, candidate.pt(), outputMlPKPi);
+              }
             }
             if (candidate.mlProbLcToPiKP().size() > 0) {
-              std::vector<float> inputFeaturesLcToPiKP = hfMlResponseLc.getInputFeatures(candidate, false);
-              isSelectedMlLcToPiKP = hfMlResponseLc.isSelectedMl(inputFeaturesLcToPiKP, candidate.pt(), outputMlPKPi);
+              if (reuseSelectorScoresLc) {
+                outputMlPKPi.assign(candidate.mlProbLcToPiKP().begin(), candidate.mlProbLcToPiKP().end());
+                isSelectedMlLcToPiKP = hfMlResponseLc.isSelectedMlScores(outputMlPKPi, candidate.pt());
+              } else {
+                std::vector<float> inputFeaturesLcToPiKP = hfMlResponseLc.getInputFeatures(candidate, false);
+                isSelectedMlLcToPiKP = hfMlResponseLc.isSelectedMl(inputFeaturesLcToPiKP, candidate.pt(), outputMlPKPi);
+              }
             }
             if (!isSelectedMlLcToPKPi && !isSelectedMlLcToPiKP) {
               continue;
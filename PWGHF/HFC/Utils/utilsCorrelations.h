@@ -29,6 +29,8 @@
 
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <vector>
 
 namespace o2::analysis::hf_correlations
 {
@@ -190,6 +192,60 @@ bool matchCandAndMass(McParticleType const& particle, double& massCand)
   }
 }
 
+/// Associated tracks of a collision passing the track selections which do not depend on the trigger candidate
+/// The block is built once per collision and looped over for each trigger candidate, with the kinematics read from contiguous columns.
+/// The tracks keep the order of the table, such that the pairs are produced in the same order as in a loop over the table
+template <typename TTrack>
+class AssociatedTrackBlock
+{
+ public:
+  /// \param tracks are the tracks of the collision
+  /// \param isSelected is the candidate-independent track selection
+  template <typename TTracks, typename TSelection>
+  void build(TTracks const& tracks, TSelection const& isSelected)
+  {
+    clear();
+    mTracks.reserve(tracks.size());
+    mGlobalIndices.reserve(tracks.size());
+    mPt.reserve(tracks.size());
+    mEta.reserve(tracks.size());
+    mPhi.reserve(tracks.size());
+    for (const auto& track : tracks) {
+      if (!isSelected(track)) {
+        continue;
+      }
+      mTracks.push_back(track);
+      mGlobalIndices.push_back(track.globalIndex());
+      mPt.push_back(track.pt());
+      mEta.push_back(track.eta());
+      mPhi.push_back(track.phi());
+    }
+  }
+
+  void clear()
+  {
+    mTracks.clear();
+    mGlobalIndices.clear();
+    mPt.clear();
+    mEta.clear();
+    mPhi.clear();
+  }
+
+  std::size_t size() const { return mTracks.size(); }
+  TTrack const& track(std::size_t i) const { return mTracks[i]; }
+  int64_t globalIndex(std::size_t i) const { return mGlobalIndices[i]; }
+  float pt(std::size_t i) const { return mPt[i]; }
+  float eta(std::size_t i) const { return mEta[i]; }
+  float phi(std::size_t i) const { return mPhi[i]; }
+
+ private:
+  std::vector<TTrack> mTracks{};
+  std::vector<int64_t> mGlobalIndices{};
+  std::vector<float> mPt{};
+  std::vector<float> mEta{};
+  std::vector<float> mPhi{};
+};
+
 // ========= Find Leading Particle ==============
 template <typename TTracks, typename T1> //// FIXME: 14 days
 int findLeadingParticle(TTracks const& tracks, T1 const etaTrackMax)
@@ -0,0 +1,168 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file utilsMixingPool.h
+/// \brief Pool of associated hadrons for the event mixing of the HF correlators across data frames
+
+#ifndef PWGHF_HFC_UTILS_UTILSMIXINGPOOL_H_
+#define PWGHF_HFC_UTILS_UTILSMIXINGPOOL_H_
+
+#include <Framework/Logger.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace o2::analysis::hf_correlations
+{
+/// Associated hadrons of the last events of each mixing bin, kept in a ring buffer of fixed depth.
+/// The hadrons are stored as compact columns, such that the trigger candidates of an event can be mixed
+/// with the hadrons of the previous events of the same bin, also if these were in previous data frames.
+class HfMixingPool
+{
+ public:
+  /// Associated hadrons of one event
+  class Event
+  {
+   public:
+    std::size_t size() const { return mPt.size(); }
+    float pt(std::size_t i) const { return mPt[i]; }
+    float eta(std::size_t i) const { return mEta[i]; }
+    float phi(std::size_t i) const { return mPhi[i]; }
+    int sign(std::size_t i) const { return mSign[i]; }
+
+   private:
+    friend class HfMixingPool;
+
+    /// the capacity of the columns is kept, such that the events are not reallocated once the pool is filled
+    void clear()
+    {
+      mPt.clear();
+      mEta.clear();
+      mPhi.clear();
+      mSign.clear();
+    }
+
+    std::vector<float> mPt{};
+    std::vector<float> mEta{};
+    std::vector<float> mPhi{};
+    std::vector<int8_t> mSign{};
+  };
+
+  /// \param depth is the number of events kept for each bin, the oldest one being replaced by the new one
+  /// \param maxTracks is the maximum number of stored hadrons, the events exceeding it are not stored unless they replace older ones (no limit if <= 0)
+  void init(int depth, int64_t maxTracks = -1)
+  {
+    if (depth < 1) {
+      LOGF(fatal, "HfMixingPool: the depth of the pool must be at least 1, got %d", depth);
+    }
+    mDepth = depth;
+    mMaxTracks = maxTracks;
+    clear();
+  }
+
+  /// Removes all the stored events
+  void clear()
+  {
+    mBins.clear();
+    mNStoredTracks = 0;
+    mWarnedMaxTracks = false;
+    mCurrentBin = -1;
+    mCurrent.clear();
+  }
+
+  /// Starts the staging of the hadrons of a new event, which can be mixed with the stored events of its bin before being stored with finishEvent()
+  /// \param poolBin is the mixing bin of the event, the events with a negative bin are not stored
+  void startEvent(int poolBin)
+  {
+    mCurrentBin = poolBin;
+    mCurrent.clear();
+  }
+
+  void addTrack(float pt, float eta, float phi, int sign)
+  {
+    mCurrent.mPt.push_back(pt);
+    mCurrent.mEta.push_back(eta);
+    mCurrent.mPhi.push_back(phi);
+    mCurrent.mSign.push_back(static_cast<int8_t>(sign));
+  }
+
+  /// Stores the current event in the ring buffer of its bin
+  void finishEvent()
+  {
+    if (mCurrentBin < 0 || mCurrent.size() == 0) {
+      return;
+    }
+    if (static_cast<std::size_t>(mCurrentBin) >= mBins.size()) {
+      mBins.resize(mCurrentBin + 1);
+    }
+    Bin& bin = mBins[mCurrentBin];
+    if (bin.events.empty()) {
+      bin.events.resize(mDepth);
+    }
+    Event& slot = bin.events[bin.next];
+    const int64_t nTracksReplaced = (bin.n == mDepth ? static_cast<int64_t>(slot.size()) : 0);
+    const int64_t nTracksAdded = static_cast<int64_t>(mCurrent.size());
+    if (mMaxTracks > 0 && mNStoredTracks - nTracksReplaced + nTracksAdded > mMaxTracks) {
+      if (!mWarnedMaxTracks) {
+        LOGF(warning, "HfMixingPool: the maximum number of stored tracks (%ld) is reached, the next events are not stored unless they replace older ones", mMaxTracks);
+        mWarnedMaxTracks = true;
+      }
+      return;
+    }
+    mNStoredTracks += nTracksAdded - nTracksReplaced;
+    std::swap(slot, mCurrent);
+    bin.next = (bin.next + 1) % mDepth;
+    if (bin.n < mDepth) {
+      bin.n++;
+    }
+    mCurrent.clear();
+  }
+
+  /// \return the number of stored events of the bin
+  int getNEvents(int poolBin) const
+  {
+    if (poolBin < 0 || static_cast<std::size_t>(poolBin) >= mBins.size()) {
+      return 0;
+    }
+    return mBins[poolBin].n;
+  }
+
+  /// \return the i-th stored event of the bin, from the oldest one
+  Event const& getEvent(int poolBin, int i) const
+  {
+    const Bin& bin = mBins[poolBin];
+    return bin.events[(bin.next - bin.n + i + mDepth) % mDepth];
+  }
+
+  Event const& getCurrentEvent() const { return mCurrent; }
+  int64_t getNStoredTracks() const { return mNStoredTracks; }
+
+ private:
+  struct Bin {
+    std::vector<Event> events{}; // ring buffer
+    int next{0};                 // slot of the next event
+    int n{0};                    // number of stored events
+  };
+
+  int mDepth{1};
+  int64_t mMaxTracks{-1};
+  int64_t mNStoredTracks{0};
+  bool mWarnedMaxTracks{false};
+
+  std::vector<Bin> mBins{}; // indexed by the mixing bin
+  int mCurrentBin{-1};
+  Event mCurrent{}; // staging event
+};
+} // namespace o2::analysis::hf_correlations
+
+#endif // PWGHF_HFC_UTILS_UTILSMIXINGPOOL_H_
@@ -31,6 +31,7 @@
 #include "PWGHF/Utils/utilsMcMatching.h"
 #include "PWGHF/Utils/utilsPid.h"
 #include "PWGHF/Utils/utilsTrkCandHf.h"
+#include "PWGHF/Utils/utilsVertexingHf.h"
 #include "PWGLF/DataModel/mcCentrality.h"
 
 #include "Common/Core/RecoDecay.h"
@@ -67,6 +68,7 @@
 
 #include <Rtypes.h>
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
 #include <cstdint>
@@ -108,20 +110,23 @@ struct HfCandidateCreator2Prong {
   Configurable<double> minParamChange{"minParamChange", 1.e-3, "stop iterations if largest change of any X is smaller than this"};
   Configurable<double> minRelChi2Change{"minRelChi2Change", 0.9, "stop iterations is chi2/chi2old > this"};
   Configurable<bool> fillHistograms{"fillHistograms", true, "do validation plots"};
+  Configurable<int> nThreadsVertexing{"nThreadsVertexing", 1, "number of threads reconstructing the secondary vertices with DCAFitterN, each with its own fitter. 1: serial"};
   // magnetic field setting from CCDB
   Configurable<bool> isRun2{"isRun2", false, "enable Run 2 or Run 3 GRP objects for magnetic field"};
   Configurable<std::string> ccdbUrl{"ccdbUrl", "http://alice-ccdb.cern.ch", "url of the ccdb repository"};
   Configurable<std::string> ccdbPathGrp{"ccdbPathGrp", "GLO/GRP/GRP", "Path of the grp file (Run 2)"};
   Configurable<std::string> ccdbPathGrpMag{"ccdbPathGrpMag", "GLO/Config/GRPMagField", "CCDB path of the GRPMagField object (Run 3)"};
 
-  HfEventSelection hfEvSel;        // event selection and monitoring
-  o2::vertexing::DCAFitterN<2> df; // 2-prong vertex fitter
+  HfEventSelection hfEvSel;                           // event selection and monitoring
+  o2::vertexing::DCAFitterN<2> df;                    // 2-prong vertex fitter
+  o2::hf_vertexing::HfVertexingPool<2> vertexingPool; // copies of the 2-prong vertex fitter for the threads
   Service<o2::ccdb::BasicCCDBManager> ccdb{};
 
   int runNumber{0};
   double bz{0.};
 
-  constexpr static float CentiToMicro{10000.f}; // from cm to µm
+  constexpr static float CentiToMicro{10000.f};                   // from cm to µm
+  constexpr static std::size_t NCandidatesPerThreadInBlock{1000}; // candidates per thread whose secondary vertices are buffered at the same time
 
   std::shared_ptr<TH1> hCandidates;
 
@@ -200,6 +205,10 @@ struct HfCandidateCreator2Prong {
       df.setMinRelChi2Change(minRelChi2Change);
       df.setUseAbsDCA(useAbsDCA);
       df.setWeightedFinalPCA(useWeightedFinalPCA);
+      vertexingPool.init(df, nThreadsVertexing);
+      if (nThreadsVertexing > 1) {
+        LOGF(info, "Reconstructing the secondary vertices with %d threads", nThreadsVertexing.value);
+      }
     }
     if (std::accumulate(doprocessKF.begin(), doprocessKF.end(), 0) == 1) {
       registry.fill(HIST("hVertexerType"), aod::hf_cand::VertexerType::KfParticle);
@@ -220,6 +229,118 @@ struct HfCandidateCreator2Prong {
                                       TTracks const&,
                                       BCsType const& bcs)
   {
+    // the candidates are processed in blocks: the prongs are collected, the secondary vertices are reconstructed by the pool of fitters
+    // and the candidates are written in their original order
+    const std::size_t blockSize = static_cast<std::size_t>(vertexingPool.getNThreads()) * NCandidatesPerThreadInBlock;
+    std::vector<typename CandType::iterator> blockCandidates;
+    std::vector<o2::hf_vertexing::HfVertexingInput<2>> vertexingInputs;
+    std::vector<o2::hf_vertexing::HfVertexingResult<2>> vertexingResults;
+    blockCandidates.reserve(std::min<std::size_t>(blockSize, rowsTrackIndexProng2.size()));
+    vertexingInputs.reserve(blockCandidates.capacity());
+
+    auto writeBlock = [&]() {
+      vertexingPool.fit(vertexingInputs, vertexingResults);
+      for (std::size_t iCand = 0; iCand < blockCandidates.size(); iCand++) {
+        const auto& rowTrackIndexProng2 = blockCandidates[iCand];
+        const auto& primaryVertex = vertexingInputs[iCand].primaryVertex;
+        const auto& result = vertexingResults[iCand];
+
+        // reconstruct the 2-prong secondary vertex
+        hCandidates->Fill(SVFitting::BeforeFit);
+        if (result.status == SVFitting::Fail) {
+          LOG(info) << "Run time error found: " << result.error << ". DCAFitterN cannot work, skipping the candidate.";
+          hCandidates->Fill(SVFitting::Fail);
+          continue;
+        }
+        if (result.status != SVFitting::FitOk) {
+          continue;
+        }
+        hCandidates->Fill(SVFitting::FitOk);
+
+        auto collision = rowTrackIndexProng2.template collision_as<Coll>();
+        auto track0 = rowTrackIndexProng2.template prong0_as<TTracks>();
+        auto track1 = rowTrackIndexProng2.template prong1_as<TTracks>();
+
+        const auto& secondaryVertex = result.secondaryVertex;
+        auto chi2PCA = result.chi2PCA;
+        auto covMatrixPCA = result.covMatrixPCA;
+        registry.fill(HIST("hCovSVXX"), covMatrixPCA[0]); // FIXME: Calculation of errorDecayLength(XY) gives wrong values without this line.
+        registry.fill(HIST("hCovSVYY"), covMatrixPCA[2]);
+        registry.fill(HIST("hCovSVXZ"), covMatrixPCA[3]);
+        registry.fill(HIST("hCovSVZZ"), covMatrixPCA[5]);
+
+        // get track momenta
+        const auto& pvec0 = result.pVecs[0];
+        const auto& pvec1 = result.pVecs[1];
+
+        // get track impact parameters
+        auto covMatrixPV = primaryVertex.getCov();
+        registry.fill(HIST("hCovPVXX"), covMatrixPV[0]);
+        registry.fill(HIST("hCovPVYY"), covMatrixPV[2]);
+        registry.fill(HIST("hCovPVXZ"), covMatrixPV[3]);
+        registry.fill(HIST("hCovPVZZ"), covMatrixPV[5]);
+        const auto& impactParameter0 = result.impactParameters[0];
+        const auto& impactParameter1 = result.impactParameters[1];
+        registry.fill(HIST("hDcaXYProngs"), track0.pt(), impactParameter0.getY() * CentiToMicro);
+        registry.fill(HIST("hDcaXYProngs"), track1.pt(), impactParameter1.getY() * CentiToMicro);
+        registry.fill(HIST("hDcaZProngs"), track0.pt(), impactParameter0.getZ() * CentiToMicro);
+        registry.fill(HIST("hDcaZProngs"), track1.pt(), impactParameter1.getZ() * CentiToMicro);
+
+        // get uncertainty of the decay length
+        double phi{}, theta{};
+        getPointDirection(std::array{primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ()}, secondaryVertex, phi, theta);
+        auto errorDecayLength = std::sqrt(getRotatedCovMatrixXX(covMatrixPV, phi, theta) + getRotatedCovMatrixXX(covMatrixPCA, phi, theta));
+        auto errorDecayLengthXY = std::sqrt(getRotatedCovMatrixXX(covMatrixPV, phi, 0.) + getRotatedCovMatrixXX(covMatrixPCA, phi, 0.));
+
+        auto indexCollision = collision.globalIndex();
+        uint8_t bitmapProngsContributorsPV = 0;
+        if (indexCollision == track0.collisionId() && track0.isPVContributor()) {
+          SETBIT(bitmapProngsContributorsPV, 0);
+        }
+        if (indexCollision == track1.collisionId() && track1.isPVContributor()) {
+          SETBIT(bitmapProngsContributorsPV, 1);
+        }
+        const auto nProngsContributorsPV = hf_trkcandsel::countOnesInBinary(bitmapProngsContributorsPV);
+
+        // fill candidate table rows
+        rowCandidateBase(indexCollision,
+                         primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ(),
+                         secondaryVertex[0], secondaryVertex[1], secondaryVertex[2],
+                         errorDecayLength, errorDecayLengthXY,
+                         chi2PCA,
+                         pvec0[0], pvec0[1], pvec0[2],
+                         pvec1[0], pvec1[1], pvec1[2],
+                         impactParameter0.getY(), impactParameter1.getY(),
+                         std::sqrt(impactParameter0.getSigmaY2()), std::sqrt(impactParameter1.getSigmaY2()),
+                         impactParameter0.getZ(), impactParameter1.getZ(),
+                         std::sqrt(impactParameter0.getSigmaZ2()), std::sqrt(impactParameter1.getSigmaZ2()),
+                         rowTrackIndexProng2.prong0Id(), rowTrackIndexProng2.prong1Id(), nProngsContributorsPV, bitmapProngsContributorsPV,
+                         rowTrackIndexProng2.hfflag());
+
+        // fill candidate prong PID rows
+        fillProngPid<HfProngSpecies::Pion>(track0, rowProng0PidPi);
+        fillProngPid<HfProngSpecies::Kaon>(track0, rowProng0PidKa);
+        fillProngPid<HfProngSpecies::Pion>(track1, rowProng1PidPi);
+        fillProngPid<HfProngSpecies::Kaon>(track1, rowProng1PidKa);
+
+        // fill histograms
+        if (fillHistograms) {
+          // calculate invariant masses
+          const auto arrayMomenta = std::array{pvec0, pvec1};
+          const auto massPiK = RecoDecay::m(arrayMomenta, std::array{MassPiPlus, MassKPlus});
+          const auto massKPi = RecoDecay::m(arrayMomenta, std::array{MassKPlus, MassPiPlus});
+          const auto massEE = RecoDecay::m(arrayMomenta, std::array{MassElectron, MassElectron});
+          const auto massMuMu = RecoDecay::m(arrayMomenta, std::array{MassMuon, MassMuon});
+          registry.fill(HIST("hMass2"), massPiK);
+          registry.fill(HIST("hMass2"), massKPi);
+          registry.fill(HIST("hMassEE"), massEE);
+          registry.fill(HIST("hMassMuMu"), massMuMu);
+        }
+      }
+      blockCandidates.clear();
+      vertexingInputs.clear();
+    };
+
     // loop over pairs of track indices
     for (const auto& rowTrackIndexProng2 : rowsTrackIndexProng2) {
 
@@ -239,8 +360,6 @@ struct HfCandidateCreator2Prong {
 
       auto track0 = rowTrackIndexProng2.template prong0_as<TTracks>();
       auto track1 = rowTrackIndexProng2.template prong1_as<TTracks>();
-      auto trackParVarPos1 = getTrackParCov(track0);
-      auto trackParVarNeg1 = getTrackParCov(track1);
 
       /// Set the magnetic field from ccdb.
       /// The static instance of the propagator was already modified in the HFTrackIndexSkimCreator,
@@ -254,41 +373,8 @@ struct HfCandidateCreator2Prong {
         // df.setBz(bz); /// put it outside the 'if'! Otherwise we have a difference wrt bz Configurable (< 1 permille) in Run2 conv. data
         // df.print();
       }
-      df.setBz(bz);
 
-      // reconstruct the 2-prong secondary vertex
-      hCandidates->Fill(SVFitting::BeforeFit);
-      try {
-        if (df.process(trackParVarPos1, trackParVarNeg1) == 0) {
-          continue;
-        }
-      } catch (const std::runtime_error& error) {
-        LOG(info) << "Run time error found: " << error.what() << ". DCAFitterN cannot work, skipping the candidate.";
-        hCandidates->Fill(SVFitting::Fail);
-        continue;
-      }
-      hCandidates->Fill(SVFitting::FitOk);
-
-      const auto& secondaryVertex = df.getPCACandidate();
-      auto chi2PCA = df.getChi2AtPCACandidate();
-      auto covMatrixPCA = df.calcPCACovMatrixFlat();
-      registry.fill(HIST("hCovSVXX"), covMatrixPCA[0]); // FIXME: Calculation of errorDecayLength(XY) gives wrong values without this line.
-      registry.fill(HIST("hCovSVYY"), covMatrixPCA[2]);
-      registry.fill(HIST("hCovSVXZ"), covMatrixPCA[3]);
-      registry.fill(HIST("hCovSVZZ"), covMatrixPCA[5]);
-      auto trackParVar0 = df.getTrack(0);
-      auto trackParVar1 = df.getTrack(1);
-
-      // get track momenta
-      std::array<float, 3> pvec0{};
-      std::array<float, 3> pvec1{};
-      trackParVar0.getPxPyPzGlo(pvec0);
-      trackParVar1.getPxPyPzGlo(pvec1);
-
-      // get track impact parameters
-      // This modifies track momenta!
       auto primaryVertex = getPrimaryVertex(collision);
-      auto covMatrixPV = primaryVertex.getCov();
       if constexpr (DoPvRefit) {
         /// use PV refit
         /// Using it in the rowCandidateBase all dynamic columns shall take it into account
@@ -303,72 +389,15 @@ struct HfCandidateCreator2Prong {
         primaryVertex.setSigmaXZ(rowTrackIndexProng2.pvRefitSigmaXZ());
         primaryVertex.setSigmaYZ(rowTrackIndexProng2.pvRefitSigmaYZ());
         primaryVertex.setSigmaZ2(rowTrackIndexProng2.pvRefitSigmaZ2());
-        covMatrixPV = primaryVertex.getCov();
-      }
-      registry.fill(HIST("hCovPVXX"), covMatrixPV[0]);
-      registry.fill(HIST("hCovPVYY"), covMatrixPV[2]);
-      registry.fill(HIST("hCovPVXZ"), covMatrixPV[3]);
-      registry.fill(HIST("hCovPVZZ"), covMatrixPV[5]);
-      o2::dataformats::DCA impactParameter0;
-      o2::dataformats::DCA impactParameter1;
-      trackParVar0.propagateToDCA(primaryVertex, bz, &impactParameter0);
-      trackParVar1.propagateToDCA(primaryVertex, bz, &impactParameter1);
-      registry.fill(HIST("hDcaXYProngs"), track0.pt(), impactParameter0.getY() * CentiToMicro);
-      registry.fill(HIST("hDcaXYProngs"), track1.pt(), impactParameter1.getY() * CentiToMicro);
-      registry.fill(HIST("hDcaZProngs"), track0.pt(), impactParameter0.getZ() * CentiToMicro);
-      registry.fill(HIST("hDcaZProngs"), track1.pt(), impactParameter1.getZ() * CentiToMicro);
-
-      // get uncertainty of the decay length
-      double phi{}, theta{};
-      getPointDirection(std::array{primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ()}, secondaryVertex, phi, theta);
-      auto errorDecayLength = std::sqrt(getRotatedCovMatrixXX(covMatrixPV, phi, theta) + getRotatedCovMatrixXX(covMatrixPCA, phi, theta));
-      auto errorDecayLengthXY = std::sqrt(getRotatedCovMatrixXX(covMatrixPV, phi, 0.) + getRotatedCovMatrixXX(covMatrixPCA, phi, 0.));
-
-      auto indexCollision = collision.globalIndex();
-      uint8_t bitmapProngsContributorsPV = 0;
-      if (indexCollision == track0.collisionId() && track0.isPVContributor()) {
-        SETBIT(bitmapProngsContributorsPV, 0);
-      }
-      if (indexCollision == track1.collisionId() && track1.isPVContributor()) {
-        SETBIT(bitmapProngsContributorsPV, 1);
       }
-      const auto nProngsContributorsPV = hf_trkcandsel::countOnesInBinary(bitmapProngsContributorsPV);
-
-      // fill candidate table rows
-      rowCandidateBase(indexCollision,
-                       primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ(),
-                       secondaryVertex[0], secondaryVertex[1], secondaryVertex[2],
-                       errorDecayLength, errorDecayLengthXY,
-                       chi2PCA,
-                       pvec0[0], pvec0[1], pvec0[2],
-                       pvec1[0], pvec1[1], pvec1[2],
-                       impactParameter0.getY(), impactParameter1.getY(),
-                       std::sqrt(impactParameter0.getSigmaY2()), std::sqrt(impactParameter1.getSigmaY2()),
-                       impactParameter0.getZ(), impactParameter1.getZ(),
-                       std::sqrt(impactParameter0.getSigmaZ2()), std::sqrt(impactParameter1.getSigmaZ2()),
-                       rowTrackIndexProng2.prong0Id(), rowTrackIndexProng2.prong1Id(), nProngsContributorsPV, bitmapProngsContributorsPV,
-                       rowTrackIndexProng2.hfflag());
 
-      // fill candidate prong PID rows
-      fillProngPid<HfProngSpecies::Pion>(track0, rowProng0PidPi);
-      fillProngPid<HfProngSpecies::Kaon>(track0, rowProng0PidKa);
-      fillProngPid<HfProngSpecies::Pion>(track1, rowProng1PidPi);
-      fillProngPid<HfProngSpecies::Kaon>(track1, rowProng1PidKa);
-
-      // fill histograms
-      if (fillHistograms) {
-        // calculate invariant masses
-        const auto arrayMomenta = std::array{pvec0, pvec1};
-        const auto massPiK = RecoDecay::m(arrayMomenta, std::array{MassPiPlus, MassKPlus});
-        const auto massKPi = RecoDecay::m(arrayMomenta, std::array{MassKPlus, MassPiPlus});
-        const auto massEE = RecoDecay::m(arrayMomenta, std::array{MassElectron, MassElectron});
-        const auto massMuMu = RecoDecay::m(arrayMomenta, std::array{MassMuon, MassMuon});
-        registry.fill(HIST("hMass2"), massPiK);
-        registry.fill(HIST("hMass2"), massKPi);
-        registry.fill(HIST("hMassEE"), massEE);
-        registry.fill(HIST("hMassMuMu"), massMuMu);
+      blockCandidates.push_back(rowTrackIndexProng2);
+      vertexingInputs.push_back({{getTrackParCov(track0), getTrackParCov(track1)}, primaryVertex, static_cast<float>(bz)});
+      if (blockCandidates.size() == blockSize) {
+        writeBlock();
       }
     }
+    writeBlock();
   }
 
   template <bool DoPvRefit, bool ApplyUpcSel, o2::hf_centrality::CentralityEstimator CentEstimator, typename Coll, typename CandType, typename TTracks, typename BCsType>
@@ -827,8 +856,11 @@ struct HfCandidateCreator2ProngExpressions {
   Configurable<bool> matchKinkedDecayTopology{"matchKinkedDecayTopology", false, "Match also candidates with tracks that decay with kinked topology"};
   Configurable<bool> matchInteractionsWithMaterial{"matchInteractionsWithMaterial", false, "Match also candidates with tracks that interact with material"};
   Configurable<bool> matchCorrelatedBackground{"matchCorrelatedBackground", false, "Match correlated background candidates"};
+  Configurable<bool> useMcAncestryIndex{"useMcAncestryIndex", true, "Match reconstructed candidates using a flattened MC particle tree built once per data frame"};
 
-  HfEventSelectionMc hfEvSelMc; // mc event selection and monitoring
+  HfEventSelectionMc hfEvSelMc;                   // mc event selection and monitoring
+  RecoDecay::McAncestryIndex mcAncestry;          // MC particle tree of the current data frame
+  RecoDecay::McMatchingScratch mcMatchingScratch; // buffers reused by the MC matching of all candidates
 
   using McCollisionsNoCents = soa::Join<aod::Collisions, aod::EvSels, aod::McCollisionLabels>;
   using McCollisionsFT0Cs = soa::Join<aod::Collisions, aod::EvSels, aod::McCollisionLabels, aod::CentFT0Cs>;
@@ -871,6 +903,12 @@ struct HfCandidateCreator2ProngExpressions {
   {
     rowCandidateProng2->bindExternalIndices(&tracks);
 
+    RecoDecay::McAncestryIndex* ancestry = nullptr;
+    if (useMcAncestryIndex) {
+      mcAncestry.build(mcParticles);
+      ancestry = &mcAncestry;
+    }
+
     int indexRec = -1;
     int8_t sign = 0;
     int8_t flagChannelMain = 0;
@@ -917,32 +955,32 @@ struct HfCandidateCreator2ProngExpressions {
           std::array<int, 2> const arrPdgDaughtersMain2Prongs = std::array{finalState[0], finalState[1]};
           if (finalState.size() == 3) { // o2-linter: disable=magic-number (partially reconstructed 3-prong decays)
             if (matchKinkedDecayTopology && matchInteractionsWithMaterial) {
-              indexRec = RecoDecay::getMatchedMCRec<false, false, true, true, true>(mcParticles, arrayDaughters, Pdg::kD0, arrPdgDaughtersMain2Prongs, true, &sign, FinalStateDepth, &nKinkedTracks, &nInteractionsWithMaterial);
+              indexRec = RecoDecay::getMatchedMCRec<false, false, true, true, true>(mcParticles, arrayDaughters, Pdg::kD0, arrPdgDaughtersMain2Prongs, true, &sign, FinalStateDepth, &nKinkedTracks, &nInteractionsWithMaterial, nullptr, ancestry, &mcMatchingScratch);
             } else if (matchKinkedDecayTopology && !matchInteractionsWithMaterial) {
-              indexRec = RecoDecay::getMatchedMCRec<false, false, true, true, false>(mcParticles, arrayDaughters, Pdg::kD0, arrPdgDaughtersMain2Prongs, true, &sign, FinalStateDepth, &nKinkedTracks);
+              indexRec = RecoDecay::getMatchedMCRec<false, false, true, true, false>(mcParticles, arrayDaughters, Pdg::kD0, arrPdgDaughtersMain2Prongs, true, &sign, FinalStateDepth, &nKinkedTracks, nullptr, nullptr, ancestry, &mcMatchingScratch);
             } else if (!matchKinkedDecayTopology && matchInteractionsWithMaterial) {
-              indexRec = RecoDecay::getMatchedMCRec<false, false, true, false, true>(mcParticles, arrayDaughters, Pdg::kD0, arrPdgDaughtersMain2Prongs, true, &sign, FinalStateDepth, nullptr, &nInteractionsWithMaterial);
+              indexRec = RecoDecay::getMatchedMCRec<false, false, true, false, true>(mcParticles, arrayDaughters, Pdg::kD0, arrPdgDaughtersMain2Prongs, true, &sign, FinalStateDepth, nullptr, &nInteractionsWithMaterial, nullptr, ancestry, &mcMatchingScratch);
             } else {
-              indexRec = RecoDecay::getMatchedMCRec<false, false, true, false, false>(mcParticles, arrayDaughters, Pdg::kD0, arrPdgDaughtersMain2Prongs, true, &sign, FinalStateDepth);
+              indexRec = RecoDecay::getMatchedMCRec<false, false, true, false, false>(mcParticles, arrayDaughters, Pdg::kD0, arrPdgDaughtersMain2Prongs, true, &sign, FinalStateDepth, nullptr, nullptr, nullptr, ancestry, &mcMatchingScratch);
             }
 
             if (indexRec > -1) {
               auto motherParticle = mcParticles.rawIteratorAt(indexRec);
               std::array<int, 3> arrPdgDaughtersMain3Prongs = std::array{finalState[0], finalState[1], finalState[2]};
               flipPdgSign(motherParticle.pdgCode(), +kPi0, arrPdgDaughtersMain3Prongs);
-              if (!RecoDecay::isMatchedMCGen(mcParticles, motherParticle, Pdg::kD0, arrPdgDaughtersMain3Prongs, true, &sign, FinalStateDepth)) {
+              if (!RecoDecay::isMatchedMCGen(mcParticles, motherParticle, Pdg::kD0, arrPdgDaughtersMain3Prongs, true, &sign, FinalStateDepth, nullptr, ancestry, &mcMatchingScratch)) {
                 indexRec = -1; // Reset indexRec if the generated decay does not match the reconstructed one
               }
             }
           } else if (finalState.size() == 2) { // o2-linter: disable=magic-number (fully reconstructed 2-prong decays)
             if (matchKinkedDecayTopology && matchInteractionsWithMaterial) {
-              indexRec = RecoDecay::getMatchedMCRec<false, false, false, true, true>(mcParticles, arrayDaughters, Pdg::kD0, arrPdgDaughtersMain2Prongs, true, &sign, FinalStateDepth, &nKinkedTracks, &nInteractionsWithMaterial);
+              indexRec = RecoDecay::getMatchedMCRec<false, false, false, true, true>(mcParticles, arrayDaughters, Pdg::kD0, arrPdgDaughtersMain2Prongs, true, &sign, FinalStateDepth, &nKinkedTracks, &nInteractionsWithMaterial, nullptr, ancestry, &mcMatchingScratch);
             } else if (matchKinkedDecayTopology && !matchInteractionsWithMaterial) {
-              indexRec = RecoDecay::getMatchedMCRec<false, false, false, true, false>(mcParticles, arrayDaughters, Pdg::kD0, arrPdgDaughtersMain2Prongs, true, &sign, FinalStateDepth, &nKinkedTracks);
+              indexRec = RecoDecay::getMatchedMCRec<false, false, false, true, false>(mcParticles, arrayDaughters, Pdg::kD0, arrPdgDaughtersMain2Prongs, true, &sign, FinalStateDepth, &nKinkedTracks, nullptr, nullptr, ancestry, &mcMatchingScratch);
             } else if (!matchKinkedDecayTopology && matchInteractionsWithMaterial) {
-              indexRec = RecoDecay::getMatchedMCRec<false, false, false, false, true>(mcParticles, arrayDaughters, Pdg::kD0, arrPdgDaughtersMain2Prongs, true, &sign, FinalStateDepth, nullptr, &nInteractionsWithMaterial);
+              indexRec = RecoDecay::getMatchedMCRec<false, false, false, false, true>(mcParticles, arrayDaughters, Pdg::kD0, arrPdgDaughtersMain2Prongs, true, &sign, FinalStateDepth, nullptr, &nInteractionsWithMaterial, nullptr, ancestry, &mcMatchingScratch);
             } else {
-              indexRec = RecoDecay::getMatchedMCRec<false, false, false, false, false>(mcParticles, arrayDaughters, Pdg::kD0, arrPdgDaughtersMain2Prongs, true, &sign, FinalStateDepth);
+              indexRec = RecoDecay::getMatchedMCRec<false, false, false, false, false>(mcParticles, arrayDaughters, Pdg::kD0, arrPdgDaughtersMain2Prongs, true, &sign, FinalStateDepth, nullptr, nullptr, nullptr, ancestry, &mcMatchingScratch);
             }
           } else {
             LOG(fatal) << "Final state size not supported: " << finalState.size();
@@ -968,13 +1006,13 @@ struct HfCandidateCreator2ProngExpressions {
       } else {
         // D0(bar) → π± K∓
         if (matchKinkedDecayTopology && matchInteractionsWithMaterial) {
-          indexRec = RecoDecay::getMatchedMCRec<false, false, false, true, true>(mcParticles, arrayDaughters, Pdg::kD0, std::array{+kPiPlus, -kKPlus}, true, &sign, 1, &nKinkedTracks, &nInteractionsWithMaterial);
+          indexRec = RecoDecay::getMatchedMCRec<false, false, false, true, true>(mcParticles, arrayDaughters, Pdg::kD0, std::array{+kPiPlus, -kKPlus}, true, &sign, 1, &nKinkedTracks, &nInteractionsWithMaterial, nullptr, ancestry, &mcMatchingScratch);
         } else if (matchKinkedDecayTopology && !matchInteractionsWithMaterial) {
-          indexRec = RecoDecay::getMatchedMCRec<false, false, false, true, false>(mcParticles, arrayDaughters, Pdg::kD0, std::array{+kPiPlus, -kKPlus}, true, &sign, 1, &nKinkedTracks);
+          indexRec = RecoDecay::getMatchedMCRec<false, false, false, true, false>(mcParticles, arrayDaughters, Pdg::kD0, std::array{+kPiPlus, -kKPlus}, true, &sign, 1, &nKinkedTracks, nullptr, nullptr, ancestry, &mcMatchingScratch);
         } else if (!matchKinkedDecayTopology && matchInteractionsWithMaterial) {
-          indexRec = RecoDecay::getMatchedMCRec<false, false, false, false, true>(mcParticles, arrayDaughters, Pdg::kD0, std::array{+kPiPlus, -kKPlus}, true, &sign, 1, nullptr, &nInteractionsWithMaterial);
+          indexRec = RecoDecay::getMatchedMCRec<false, false, false, false, true>(mcParticles, arrayDaughters, Pdg::kD0, std::array{+kPiPlus, -kKPlus}, true, &sign, 1, nullptr, &nInteractionsWithMaterial, nullptr, ancestry, &mcMatchingScratch);
         } else {
-          indexRec = RecoDecay::getMatchedMCRec(mcParticles, arrayDaughters, Pdg::kD0, std::array{+kPiPlus, -kKPlus}, true, &sign);
+          indexRec = RecoDecay::getMatchedMCRec(mcParticles, arrayDaughters, Pdg::kD0, std::array{+kPiPlus, -kKPlus}, true, &sign, 1, nullptr, nullptr, nullptr, ancestry, &mcMatchingScratch);
         }
         if (indexRec > -1) {
           flagChannelMain = sign * DecayChannelMain::D0ToPiK;
@@ -983,9 +1021,9 @@ struct HfCandidateCreator2ProngExpressions {
         // J/ψ → e+ e−
         if (flagChannelMain == 0) {
           if (matchInteractionsWithMaterial) {
-            indexRec = RecoDecay::getMatchedMCRec<false, false, false, false, true>(mcParticles, arrayDaughters, Pdg::kJPsi, std::array{+kElectron, +kPositron}, true, &sign, 1, nullptr, &nInteractionsWithMaterial);
+            indexRec = RecoDecay::getMatchedMCRec<false, false, false, false, true>(mcParticles, arrayDaughters, Pdg::kJPsi, std::array{+kElectron, +kPositron}, true, &sign, 1, nullptr, &nInteractionsWithMaterial, nullptr, ancestry, &mcMatchingScratch);
           } else {
-            indexRec = RecoDecay::getMatchedMCRec(mcParticles, arrayDaughters, Pdg::kJPsi, std::array{+kElectron, +kPositron}, true);
+            indexRec = RecoDecay::getMatchedMCRec(mcParticles, arrayDaughters, Pdg::kJPsi, std::array{+kElectron, +kPositron}, true, nullptr, 1, nullptr, nullptr, nullptr, ancestry, &mcMatchingScratch);
           }
           if (indexRec > -1) {
             flagChannelMain = DecayChannelMain::JpsiToEE;
@@ -995,9 +1033,9 @@ struct HfCandidateCreator2ProngExpressions {
         // J/ψ → μ+ μ−
         if (flagChannelMain == 0) {
           if (matchInteractionsWithMaterial) {
-            indexRec = RecoDecay::getMatchedMCRec<false, false, false, false, true>(mcParticles, arrayDaughters, Pdg::kJPsi, std::array{+kMuonMinus, +kMuonPlus}, true, &sign, 1, nullptr, &nInteractionsWithMaterial);
+            indexRec = RecoDecay::getMatchedMCRec<false, false, false, false, true>(mcParticles, arrayDaughters, Pdg::kJPsi, std::array{+kMuonMinus, +kMuonPlus}, true, &sign, 1, nullptr, &nInteractionsWithMaterial, nullptr, ancestry, &mcMatchingScratch);
           } else {
-            indexRec = RecoDecay::getMatchedMCRec(mcParticles, arrayDaughters, Pdg::kJPsi, std::array{+kMuonMinus, +kMuonPlus}, true);
+            indexRec = RecoDecay::getMatchedMCRec(mcParticles, arrayDaughters, Pdg::kJPsi, std::array{+kMuonMinus, +kMuonPlus}, true, nullptr, 1, nullptr, nullptr, nullptr, ancestry, &mcMatchingScratch);
           }
           if (indexRec > -1) {
             flagChannelMain = DecayChannelMain::JpsiToMuMu;
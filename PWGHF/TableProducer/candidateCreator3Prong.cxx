@@ -31,6 +31,7 @@
 #include "PWGHF/Utils/utilsMcMatching.h"
 #include "PWGHF/Utils/utilsPid.h"
 #include "PWGHF/Utils/utilsTrkCandHf.h"
+#include "PWGHF/Utils/utilsVertexingHf.h"
 #include "PWGLF/DataModel/mcCentrality.h"
 
 #include "Common/Core/RecoDecay.h"
@@ -67,6 +68,7 @@
 
 #include <Rtypes.h>
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
 #include <cstdint>
@@ -127,6 +129,7 @@ struct HfCandidateCreator3Prong {
   Configurable<double> minParamChange{"minParamChange", 1.e-3, "stop iterations if largest change of any X is smaller than this"};
   Configurable<double> minRelChi2Change{"minRelChi2Change", 0.9, "stop iterations is chi2/chi2old > this"};
   Configurable<bool> fillHistograms{"fillHistograms", true, "do validation plots"};
+  Configurable<int> nThreadsVertexing{"nThreadsVertexing", 1, "number of threads reconstructing the secondary vertices with DCAFitterN, each with its own fitter. 1: serial"};
   // magnetic field setting from CCDB
   Configurable<bool> isRun2{"isRun2", false, "enable Run 2 or Run 3 GRP objects for magnetic field"};
   Configurable<std::string> ccdbUrl{"ccdbUrl", "http://alice-ccdb.cern.ch", "url of the ccdb repository"};
@@ -144,14 +147,16 @@ struct HfCandidateCreator3Prong {
 
   Configurable<LabeledArray<float>> tpcPidBBParamsLightNuclei{"tpcPidBBParamsLightNuclei", {hf_presel_lightnuclei::BetheBlochParams[0], hf_presel_lightnuclei::NParticleRows, hf_presel_lightnuclei::NBetheBlochParams, hf_presel_lightnuclei::labelsRowsNucleiType, hf_presel_lightnuclei::labelsBetheBlochParams}, "TPC PID Bethe–Bloch parameter configurations for light nuclei (deuteron, triton, helium-3)"};
 
-  HfEventSelection hfEvSel;        // event selection and monitoring
-  o2::vertexing::DCAFitterN<3> df; // 3-prong vertex fitter
+  HfEventSelection hfEvSel;                           // event selection and monitoring
+  o2::vertexing::DCAFitterN<3> df;                    // 3-prong vertex fitter
+  o2::hf_vertexing::HfVertexingPool<3> vertexingPool; // copies of the 3-prong vertex fitter for the threads
   Service<o2::ccdb::BasicCCDBManager> ccdb{};
 
   int runNumber{0};
   double bz{0.};
 
-  constexpr static float CentiToMicro{10000.f}; // from cm to µm
+  constexpr static float CentiToMicro{10000.f};                   // from cm to µm
+  constexpr static std::size_t NCandidatesPerThreadInBlock{1000}; // candidates per thread whose secondary vertices are buffered at the same time
   constexpr static float UndefValueFloat{-999.f};
 
   using FilteredHf3Prongs = soa::Filtered<aod::Hf3Prongs>;
@@ -245,6 +250,10 @@ struct HfCandidateCreator3Prong {
     df.setMinRelChi2Change(static_cast<float>(minRelChi2Change));
     df.setUseAbsDCA(useAbsDCA);
     df.setWeightedFinalPCA(useWeightedFinalPCA);
+    vertexingPool.init(df, nThreadsVertexing);
+    if (nThreadsVertexing > 1) {
+      LOGF(info, "Reconstructing the secondary vertices with %d threads", nThreadsVertexing.value);
+    }
 
     ccdb->setURL(ccdbUrl);
     ccdb->setCaching(true);
@@ -293,6 +302,134 @@ struct HfCandidateCreator3Prong {
                                       TracksWCovExtraPidPiKaPrLightNuclei const&,
                                       BCsType const& bcs)
   {
+    // the candidates are processed in blocks: the prongs are collected, the secondary vertices are reconstructed by the pool of fitters
+    // and the candidates are written in their original order
+    const std::size_t blockSize = static_cast<std::size_t>(vertexingPool.getNThreads()) * NCandidatesPerThreadInBlock;
+    std::vector<typename Cand::iterator> blockCandidates;
+    std::vector<o2::hf_vertexing::HfVertexingInput<3>> vertexingInputs;
+    std::vector<o2::hf_vertexing::HfVertexingResult<3>> vertexingResults;
+    blockCandidates.reserve(std::min<std::size_t>(blockSize, rowsTrackIndexProng3.size()));
+    vertexingInputs.reserve(blockCandidates.capacity());
+
+    auto writeBlock = [&]() {
+      vertexingPool.fit(vertexingInputs, vertexingResults);
+      for (std::size_t iCand = 0; iCand < blockCandidates.size(); iCand++) {
+        const auto& rowTrackIndexProng3 = blockCandidates[iCand];
+        const auto& primaryVertex = vertexingInputs[iCand].primaryVertex;
+        const auto& result = vertexingResults[iCand];
+
+        // reconstruct the 3-prong secondary vertex
+        hCandidates->Fill(SVFitting::BeforeFit);
+        if (result.status == SVFitting::Fail) {
+          LOG(info) << "Run time error found: " << result.error << ". DCAFitterN cannot work, skipping the candidate.";
+          hCandidates->Fill(SVFitting::Fail);
+          continue;
+        }
+        if (result.status != SVFitting::FitOk) {
+          continue;
+        }
+        hCandidates->Fill(SVFitting::FitOk);
+
+        auto collision = rowTrackIndexProng3.template collision_as<Coll>();
+        auto track0 = rowTrackIndexProng3.template prong0_as<TracksWCovExtraPidPiKaPrLightNuclei>();
+        auto track1 = rowTrackIndexProng3.template prong1_as<TracksWCovExtraPidPiKaPrLightNuclei>();
+        auto track2 = rowTrackIndexProng3.template prong2_as<TracksWCovExtraPidPiKaPrLightNuclei>();
+
+        const auto& secondaryVertex = result.secondaryVertex;
+        auto chi2PCA = result.chi2PCA;
+        auto covMatrixPCA = result.covMatrixPCA;
+        registry.fill(HIST("hCovSVXX"), covMatrixPCA[0]); // FIXME: Calculation of errorDecayLength(XY) gives wrong values without this line.
+        registry.fill(HIST("hCovSVYY"), covMatrixPCA[2]);
+        registry.fill(HIST("hCovSVXZ"), covMatrixPCA[3]);
+        registry.fill(HIST("hCovSVZZ"), covMatrixPCA[5]);
+
+        // get track momenta
+        const auto& pvec0 = result.pVecs[0];
+        const auto& pvec1 = result.pVecs[1];
+        const auto& pvec2 = result.pVecs[2];
+
+        // get track impact parameters
+        auto covMatrixPV = primaryVertex.getCov();
+        registry.fill(HIST("hCovPVXX"), covMatrixPV[0]);
+        registry.fill(HIST("hCovPVYY"), covMatrixPV[2]);
+        registry.fill(HIST("hCovPVXZ"), covMatrixPV[3]);
+        registry.fill(HIST("hCovPVZZ"), covMatrixPV[5]);
+        const auto& impactParameter0 = result.impactParameters[0];
+        const auto& impactParameter1 = result.impactParameters[1];
+        const auto& impactParameter2 = result.impactParameters[2];
+        registry.fill(HIST("hDcaXYProngs"), track0.pt(), impactParameter0.getY() * CentiToMicro);
+        registry.fill(HIST("hDcaXYProngs"), track1.pt(), impactParameter1.getY() * CentiToMicro);
+        registry.fill(HIST("hDcaXYProngs"), track2.pt(), impactParameter2.getY() * CentiToMicro);
+        registry.fill(HIST("hDcaZProngs"), track0.pt(), impactParameter0.getZ() * CentiToMicro);
+        registry.fill(HIST("hDcaZProngs"), track1.pt(), impactParameter1.getZ() * CentiToMicro);
+        registry.fill(HIST("hDcaZProngs"), track2.pt(), impactParameter2.getZ() * CentiToMicro);
+
+        // get uncertainty of the decay length
+        double phi{}, theta{};
+        getPointDirection(std::array{primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ()}, secondaryVertex, phi, theta);
+        auto errorDecayLength = std::sqrt(getRotatedCovMatrixXX(covMatrixPV, phi, theta) + getRotatedCovMatrixXX(covMatrixPCA, phi, theta));
+        auto errorDecayLengthXY = std::sqrt(getRotatedCovMatrixXX(covMatrixPV, phi, 0.) + getRotatedCovMatrixXX(covMatrixPCA, phi, 0.));
+
+        auto indexCollision = collision.globalIndex();
+        uint8_t bitmapProngsContributorsPV = 0;
+        if (indexCollision == track0.collisionId() && track0.isPVContributor()) {
+          SETBIT(bitmapProngsContributorsPV, 0);
+        }
+        if (indexCollision == track1.collisionId() && track1.isPVContributor()) {
+          SETBIT(bitmapProngsContributorsPV, 1);
+        }
+        if (indexCollision == track2.collisionId() && track2.isPVContributor()) {
+          SETBIT(bitmapProngsContributorsPV, 2);
+        }
+        const auto nProngsContributorsPV = hf_trkcandsel::countOnesInBinary(bitmapProngsContributorsPV);
+
+        // fill candidate table rows
+        rowCandidateBase(indexCollision,
+                         primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ(),
+                         secondaryVertex[0], secondaryVertex[1], secondaryVertex[2],
+                         errorDecayLength, errorDecayLengthXY,
+                         chi2PCA,
+                         pvec0[0], pvec0[1], pvec0[2],
+                         pvec1[0], pvec1[1], pvec1[2],
+                         pvec2[0], pvec2[1], pvec2[2],
+                         impactParameter0.getY(), impactParameter1.getY(), impactParameter2.getY(),
+                         std::sqrt(impactParameter0.getSigmaY2()), std::sqrt(impactParameter1.getSigmaY2()), std::sqrt(impactParameter2.getSigmaY2()),
+                         impactParameter0.getZ(), impactParameter1.getZ(), impactParameter2.getZ(),
+                         std::sqrt(impactParameter0.getSigmaZ2()), std::sqrt(impactParameter1.getSigmaZ2()), std::sqrt(impactParameter2.getSigmaZ2()),
+                         rowTrackIndexProng3.prong0Id(), rowTrackIndexProng3.prong1Id(), rowTrackIndexProng3.prong2Id(), nProngsContributorsPV, bitmapProngsContributorsPV,
+                         rowTrackIndexProng3.hfflag());
+
+        // fill candidate prong PID rows
+        fillProngsPid(track0, track1, track2);
+
+        // fill histograms
+        if (fillHistograms) {
+          // calculate invariant mass
+          const auto arrayMomenta = std::array{pvec0, pvec1, pvec2};
+          const auto massPKPi = RecoDecay::m(arrayMomenta, std::array{MassProton, MassKPlus, MassPiPlus});
+          const auto massPiKP = RecoDecay::m(arrayMomenta, std::array{MassPiPlus, MassKPlus, MassProton});
+          const auto massPiKPi = RecoDecay::m(arrayMomenta, std::array{MassPiPlus, MassKPlus, MassPiPlus});
+          const auto massKKPi = RecoDecay::m(arrayMomenta, std::array{MassKPlus, MassKPlus, MassPiPlus});
+          const auto massPiKK = RecoDecay::m(arrayMomenta, std::array{MassPiPlus, MassKPlus, MassKPlus});
+          const auto massDeKPi = RecoDecay::m(arrayMomenta, std::array{MassDeuteron, MassKPlus, MassPiPlus});
+          const auto massPiKDe = RecoDecay::m(arrayMomenta, std::array{MassPiPlus, MassKPlus, MassDeuteron});
+          const auto massKPi = RecoDecay::m(std::array{arrayMomenta.at(1), arrayMomenta.at(2)}, std::array{MassKPlus, MassPiPlus});
+          const auto massPiK = RecoDecay::m(std::array{arrayMomenta.at(0), arrayMomenta.at(1)}, std::array{MassPiPlus, MassKPlus});
+          registry.fill(HIST("hMass3PiKPi"), massPiKPi);
+          registry.fill(HIST("hMass3PKPi"), massPKPi);
+          registry.fill(HIST("hMass3PiKP"), massPiKP);
+          registry.fill(HIST("hMass3KKPi"), massKKPi);
+          registry.fill(HIST("hMass3PiKK"), massPiKK);
+          registry.fill(HIST("hMass3DeKPi"), massDeKPi);
+          registry.fill(HIST("hMass3PiKDe"), massPiKDe);
+          registry.fill(HIST("hMass2KPi"), massKPi);
+          registry.fill(HIST("hMass2PiK"), massPiK);
+        }
+      }
+      blockCandidates.clear();
+      vertexingInputs.clear();
+    };
+
     // loop over triplets of track indices
     for (const auto& rowTrackIndexProng3 : rowsTrackIndexProng3) {
 
@@ -313,9 +450,6 @@ struct HfCandidateCreator3Prong {
       auto track0 = rowTrackIndexProng3.template prong0_as<TracksWCovExtraPidPiKaPrLightNuclei>();
       auto track1 = rowTrackIndexProng3.template prong1_as<TracksWCovExtraPidPiKaPrLightNuclei>();
       auto track2 = rowTrackIndexProng3.template prong2_as<TracksWCovExtraPidPiKaPrLightNuclei>();
-      auto trackParVar0 = getTrackParCov(track0);
-      auto trackParVar1 = getTrackParCov(track1);
-      auto trackParVar2 = getTrackParCov(track2);
 
       /// Set the magnetic field from ccdb.
       /// The static instance of the propagator was already modified in the HFTrackIndexSkimCreator,
@@ -329,44 +463,8 @@ struct HfCandidateCreator3Prong {
         // df.setBz(bz); /// put it outside the 'if'! Otherwise we have a difference wrt bz Configurable (< 1 permille) in Run2 conv. data
         // df.print();
       }
-      df.setBz(static_cast<float>(bz));
 
-      // reconstruct the 3-prong secondary vertex
-      hCandidates->Fill(SVFitting::BeforeFit);
-      try {
-        if (df.process(trackParVar0, trackParVar1, trackParVar2) == 0) {
-          continue;
-        }
-      } catch (const std::runtime_error& error) {
-        LOG(info) << "Run time error found: " << error.what() << ". DCAFitterN cannot work, skipping the candidate.";
-        hCandidates->Fill(SVFitting::Fail);
-        continue;
-      }
-      hCandidates->Fill(SVFitting::FitOk);
-
-      const auto& secondaryVertex = df.getPCACandidate();
-      auto chi2PCA = df.getChi2AtPCACandidate();
-      auto covMatrixPCA = df.calcPCACovMatrixFlat();
-      registry.fill(HIST("hCovSVXX"), covMatrixPCA[0]); // FIXME: Calculation of errorDecayLength(XY) gives wrong values without this line.
-      registry.fill(HIST("hCovSVYY"), covMatrixPCA[2]);
-      registry.fill(HIST("hCovSVXZ"), covMatrixPCA[3]);
-      registry.fill(HIST("hCovSVZZ"), covMatrixPCA[5]);
-      trackParVar0 = df.getTrack(0);
-      trackParVar1 = df.getTrack(1);
-      trackParVar2 = df.getTrack(2);
-
-      // get track momenta
-      std::array<float, 3> pvec0{};
-      std::array<float, 3> pvec1{};
-      std::array<float, 3> pvec2{};
-      trackParVar0.getPxPyPzGlo(pvec0);
-      trackParVar1.getPxPyPzGlo(pvec1);
-      trackParVar2.getPxPyPzGlo(pvec2);
-
-      // get track impact parameters
-      // This modifies track momenta!
       auto primaryVertex = getPrimaryVertex(collision);
-      auto covMatrixPV = primaryVertex.getCov();
       if constexpr (DoPvRefit) {
         /// use PV refit
         /// Using it in the rowCandidateBase all dynamic columns shall take it into account
@@ -381,87 +479,15 @@ struct HfCandidateCreator3Prong {
         primaryVertex.setSigmaXZ(rowTrackIndexProng3.pvRefitSigmaXZ());
         primaryVertex.setSigmaYZ(rowTrackIndexProng3.pvRefitSigmaYZ());
         primaryVertex.setSigmaZ2(rowTrackIndexProng3.pvRefitSigmaZ2());
-        covMatrixPV = primaryVertex.getCov();
       }
-      registry.fill(HIST("hCovPVXX"), covMatrixPV[0]);
-      registry.fill(HIST("hCovPVYY"), covMatrixPV[2]);
-      registry.fill(HIST("hCovPVXZ"), covMatrixPV[3]);
-      registry.fill(HIST("hCovPVZZ"), covMatrixPV[5]);
-      o2::dataformats::DCA impactParameter0;
-      o2::dataformats::DCA impactParameter1;
-      o2::dataformats::DCA impactParameter2;
-      trackParVar0.propagateToDCA(primaryVertex, bz, &impactParameter0);
-      trackParVar1.propagateToDCA(primaryVertex, bz, &impactParameter1);
-      trackParVar2.propagateToDCA(primaryVertex, bz, &impactParameter2);
-      registry.fill(HIST("hDcaXYProngs"), track0.pt(), impactParameter0.getY() * CentiToMicro);
-      registry.fill(HIST("hDcaXYProngs"), track1.pt(), impactParameter1.getY() * CentiToMicro);
-      registry.fill(HIST("hDcaXYProngs"), track2.pt(), impactParameter2.getY() * CentiToMicro);
-      registry.fill(HIST("hDcaZProngs"), track0.pt(), impactParameter0.getZ() * CentiToMicro);
-      registry.fill(HIST("hDcaZProngs"), track1.pt(), impactParameter1.getZ() * CentiToMicro);
-      registry.fill(HIST("hDcaZProngs"), track2.pt(), impactParameter2.getZ() * CentiToMicro);
-
-      // get uncertainty of the decay length
-      double phi{}, theta{};
-      getPointDirection(std::array{primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ()}, secondaryVertex, phi, theta);
-      auto errorDecayLength = std::sqrt(getRotatedCovMatrixXX(covMatrixPV, phi, theta) + getRotatedCovMatrixXX(covMatrixPCA, phi, theta));
-      auto errorDecayLengthXY = std::sqrt(getRotatedCovMatrixXX(covMatrixPV, phi, 0.) + getRotatedCovMatrixXX(covMatrixPCA, phi, 0.));
 
-      auto indexCollision = collision.globalIndex();
-      uint8_t bitmapProngsContributorsPV = 0;
-      if (indexCollision == track0.collisionId() && track0.isPVContributor()) {
-        SETBIT(bitmapProngsContributorsPV, 0);
-      }
-      if (indexCollision == track1.collisionId() && track1.isPVContributor()) {
-        SETBIT(bitmapProngsContributorsPV, 1);
-      }
-      if (indexCollision == track2.collisionId() && track2.isPVContributor()) {
-        SETBIT(bitmapProngsContributorsPV, 2);
-      }
-      const auto nProngsContributorsPV = hf_trkcandsel::countOnesInBinary(bitmapProngsContributorsPV);
-
-      // fill candidate table rows
-      rowCandidateBase(indexCollision,
-                       primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ(),
-                       secondaryVertex[0], secondaryVertex[1], secondaryVertex[2],
-                       errorDecayLength, errorDecayLengthXY,
-                       chi2PCA,
-                       pvec0[0], pvec0[1], pvec0[2],
-                       pvec1[0], pvec1[1], pvec1[2],
-                       pvec2[0], pvec2[1], pvec2[2],
-                       impactParameter0.getY(), impactParameter1.getY(), impactParameter2.getY(),
-                       std::sqrt(impactParameter0.getSigmaY2()), std::sqrt(impactParameter1.getSigmaY2()), std::sqrt(impactParameter2.getSigmaY2()),
-                       impactParameter0.getZ(), impactParameter1.getZ(), impactParameter2.getZ(),
-                       std::sqrt(impactParameter0.getSigmaZ2()), std::sqrt(impactParameter1.getSigmaZ2()), std::sqrt(impactParameter2.getSigmaZ2()),
-                       rowTrackIndexProng3.prong0Id(), rowTrackIndexProng3.prong1Id(), rowTrackIndexProng3.prong2Id(), nProngsContributorsPV, bitmapProngsContributorsPV,
-                       rowTrackIndexProng3.hfflag());
-
-      // fill candidate prong PID rows
-      fillProngsPid(track0, track1, track2);
-
-      // fill histograms
-      if (fillHistograms) {
-        // calculate invariant mass
-        const auto arrayMomenta = std::array{pvec0, pvec1, pvec2};
-        const auto massPKPi = RecoDecay::m(arrayMomenta, std::array{MassProton, MassKPlus, MassPiPlus});
-        const auto massPiKP = RecoDecay::m(arrayMomenta, std::array{MassPiPlus, MassKPlus, MassProton});
-        const auto massPiKPi = RecoDecay::m(arrayMomenta, std::array{MassPiPlus, MassKPlus, MassPiPlus});
-        const auto massKKPi = RecoDecay::m(arrayMomenta, std::array{MassKPlus, MassKPlus, MassPiPlus});
-        const auto massPiKK = RecoDecay::m(arrayMomenta, std::array{MassPiPlus, MassKPlus, MassKPlus});
-        const auto massDeKPi = RecoDecay::m(arrayMomenta, std::array{MassDeuteron, MassKPlus, MassPiPlus});
-        const auto massPiKDe = RecoDecay::m(arrayMomenta, std::array{MassPiPlus, MassKPlus, MassDeuteron});
-        const auto massKPi = RecoDecay::m(std::array{arrayMomenta.at(1), arrayMomenta.at(2)}, std::array{MassKPlus, MassPiPlus});
-        const auto massPiK = RecoDecay::m(std::array{arrayMomenta.at(0), arrayMomenta.at(1)}, std::array{MassPiPlus, MassKPlus});
-        registry.fill(HIST("hMass3PiKPi"), massPiKPi);
-        registry.fill(HIST("hMass3PKPi"), massPKPi);
-        registry.fill(HIST("hMass3PiKP"), massPiKP);
-        registry.fill(HIST("hMass3KKPi"), massKKPi);
-        registry.fill(HIST("hMass3PiKK"), massPiKK);
-        registry.fill(HIST("hMass3DeKPi"), massDeKPi);
-        registry.fill(HIST("hMass3PiKDe"), massPiKDe);
-        registry.fill(HIST("hMass2KPi"), massKPi);
-        registry.fill(HIST("hMass2PiK"), massPiK);
+      blockCandidates.push_back(rowTrackIndexProng3);
+      vertexingInputs.push_back({{getTrackParCov(track0), getTrackParCov(track1), getTrackParCov(track2)}, primaryVertex, static_cast<float>(bz)});
+      if (blockCandidates.size() == blockSize) {
+        writeBlock();
       }
     }
+    writeBlock();
   }
 
   template <bool DoPvRefit, bool ApplyUpcSel, o2::hf_centrality::CentralityEstimator CentEstimator, typename Coll, typename Cand, typename BCsType>
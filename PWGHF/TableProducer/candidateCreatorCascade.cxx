@@ -22,6 +22,7 @@
 #include "PWGHF/Utils/utilsBfieldCCDB.h"
 #include "PWGHF/Utils/utilsEvSelHf.h"
 #include "PWGHF/Utils/utilsTrkCandHf.h"
+#include "PWGHF/Utils/utilsVertexingHf.h"
 #include "PWGLF/DataModel/LFStrangenessTables.h"
 #include "PWGLF/DataModel/mcCentrality.h"
 
@@ -53,7 +54,9 @@
 #include <TH1.h>
 #include <TPDGCode.h>
 
+#include <algorithm>
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <numeric>
@@ -82,6 +85,7 @@ struct HfCandidateCreatorCascade {
   Configurable<double> minParamChange{"minParamChange", 1.e-3, "stop iterations if largest change of any X is smaller than this"};
   Configurable<double> minRelChi2Change{"minRelChi2Change", 0.9, "stop iterations is chi2/chi2old > this"};
   Configurable<bool> fillHistograms{"fillHistograms", true, "fill validation histograms"};
+  Configurable<int> nThreadsVertexing{"nThreadsVertexing", 1, "number of threads reconstructing the secondary vertices with DCAFitterN, each with its own fitter. 1: serial"};
   Configurable<bool> silenceV0DataWarning{"silenceV0DataWarning", false, "do not print a warning for not found V0s and silently skip them"};
   // magnetic field setting from CCDB
   Configurable<bool> isRun2{"isRun2", false, "enable Run 2 or Run 3 GRP objects for magnetic field"};
@@ -90,8 +94,9 @@ struct HfCandidateCreatorCascade {
   Configurable<std::string> ccdbPathGrp{"ccdbPathGrp", "GLO/GRP/GRP", "Path of the grp file (Run 2)"};
   Configurable<std::string> ccdbPathGrpMag{"ccdbPathGrpMag", "GLO/Config/GRPMagField", "CCDB path of the GRPMagField object (Run 3)"};
 
-  HfEventSelection hfEvSel;        // event selection and monitoring
-  o2::vertexing::DCAFitterN<2> df; // 2-prong vertex fitter
+  HfEventSelection hfEvSel;                           // event selection and monitoring
+  o2::vertexing::DCAFitterN<2> df;                    // 2-prong vertex fitter
+  o2::hf_vertexing::HfVertexingPool<2> vertexingPool; // copies of the 2-prong vertex fitter for the threads
   Service<o2::ccdb::BasicCCDBManager> ccdb{};
   o2::base::MatLayerCylSet* lut{};
   o2::base::Propagator::MatCorrType matCorr = o2::base::Propagator::MatCorrType::USEMatCorrLUT;
@@ -100,6 +105,8 @@ struct HfCandidateCreatorCascade {
   double mass2K0sP{0.};
   double bz = 0.;
 
+  constexpr static std::size_t NCandidatesPerThreadInBlock{1000}; // candidates per thread whose secondary vertices are buffered at the same time
+
   using V0full = soa::Join<aod::V0Datas, aod::V0Covs>;
 
   std::shared_ptr<TH1> hCandidates;
@@ -147,6 +154,10 @@ struct HfCandidateCreatorCascade {
     df.setMinRelChi2Change(minRelChi2Change);
     df.setUseAbsDCA(useAbsDCA);
     df.setWeightedFinalPCA(useWeightedFinalPCA);
+    vertexingPool.init(df, nThreadsVertexing);
+    if (nThreadsVertexing > 1) {
+      LOGF(info, "Reconstructing the secondary vertices with %d threads", nThreadsVertexing.value);
+    }
 
     ccdb->setURL(ccdbUrl);
     ccdb->setCaching(true);
@@ -166,6 +177,91 @@ struct HfCandidateCreatorCascade {
                          aod::TracksWCov const&,
                          aod::BCsWithTimestamps const& /*bcWithTimeStamps*/)
   {
+    // the candidates are processed in blocks: the prongs are collected, the secondary vertices are reconstructed by the pool of fitters
+    // and the candidates are written in their original order
+    const std::size_t blockSize = static_cast<std::size_t>(vertexingPool.getNThreads()) * NCandidatesPerThreadInBlock;
+    std::vector<aod::HfCascades::iterator> blockCandidates;
+    std::vector<V0full::iterator> blockV0s;
+    std::vector<o2::hf_vertexing::HfVertexingInput<2>> vertexingInputs;
+    std::vector<o2::hf_vertexing::HfVertexingResult<2>> vertexingResults;
+    blockCandidates.reserve(std::min<std::size_t>(blockSize, rowsTrackIndexCasc.size()));
+    blockV0s.reserve(blockCandidates.capacity());
+    vertexingInputs.reserve(blockCandidates.capacity());
+
+    auto writeBlock = [&]() {
+      vertexingPool.fit(vertexingInputs, vertexingResults);
+      for (std::size_t iCand = 0; iCand < blockCandidates.size(); iCand++) {
+        const auto& casc = blockCandidates[iCand];
+        const auto& v0row = blockV0s[iCand];
+        const auto& result = vertexingResults[iCand];
+
+        // reconstruct the cascade secondary vertex
+        hCandidates->Fill(SVFitting::BeforeFit);
+        if (result.status == SVFitting::Fail) {
+          LOG(debug) << "Run time error found: " << result.error << ". DCAFitterN cannot work, skipping the candidate.";
+          hCandidates->Fill(SVFitting::Fail);
+          continue;
+        }
+        if (result.status != SVFitting::FitOk) {
+          continue;
+        }
+        LOG(debug) << "Vertexing succeeded for Lc candidate";
+        hCandidates->Fill(SVFitting::FitOk);
+
+        auto collision = casc.template collision_as<Coll>();
+
+        const auto& secondaryVertex = result.secondaryVertex;
+        auto chi2PCA = result.chi2PCA;
+        auto covMatrixPCA = result.covMatrixPCA;
+        registry.fill(HIST("hCovSVXX"), covMatrixPCA[0]); // FIXME: Calculation of errorDecayLength(XY) gives wrong values without this line.
+
+        // get track momenta
+        const auto& pVecV0 = result.pVecs[0];
+        const auto& pVecBach = result.pVecs[1];
+
+        // get track impact parameters
+        auto covMatrixPV = vertexingInputs[iCand].primaryVertex.getCov();
+        registry.fill(HIST("hCovPVXX"), covMatrixPV[0]);
+        const auto& impactParameterV0 = result.impactParameters[0];
+        const auto& impactParameterBach = result.impactParameters[1];
+
+        // get uncertainty of the decay length
+        double phi{}, theta{};
+        getPointDirection(std::array{collision.posX(), collision.posY(), collision.posZ()}, secondaryVertex, phi, theta);
+        auto errorDecayLength = std::sqrt(getRotatedCovMatrixXX(covMatrixPV, phi, theta) + getRotatedCovMatrixXX(covMatrixPCA, phi, theta));
+        auto errorDecayLengthXY = std::sqrt(getRotatedCovMatrixXX(covMatrixPV, phi, 0.) + getRotatedCovMatrixXX(covMatrixPCA, phi, 0.));
+
+        // fill candidate table rows
+        rowCandidateBase(collision.globalIndex(),
+                         collision.posX(), collision.posY(), collision.posZ(),
+                         secondaryVertex[0], secondaryVertex[1], secondaryVertex[2],
+                         errorDecayLength, errorDecayLengthXY,
+                         chi2PCA,
+                         pVecBach[0], pVecBach[1], pVecBach[2],
+                         pVecV0[0], pVecV0[1], pVecV0[2],
+                         impactParameterBach.getY(), impactParameterV0.getY(),
+                         std::sqrt(impactParameterBach.getSigmaY2()), std::sqrt(impactParameterV0.getSigmaY2()),
+                         casc.prong0Id(), casc.v0Id(),
+                         v0row.x(), v0row.y(), v0row.z(),
+                         v0row.posTrackId(), v0row.negTrackId(),
+                         v0row.pxpos(), v0row.pypos(), v0row.pzpos(),
+                         v0row.pxneg(), v0row.pyneg(), v0row.pzneg(),
+                         v0row.dcaV0daughters(),
+                         v0row.dcapostopv(),
+                         v0row.dcanegtopv(),
+                         v0row.v0cosPA());
+
+        // fill histograms
+        if (fillHistograms) {
+          // calculate invariant masses
+          mass2K0sP = RecoDecay::m(std::array{pVecBach, pVecV0}, std::array{MassProton, MassK0Short});
+          registry.fill(HIST("hMass2"), mass2K0sP);
+        }
+      }
+      blockCandidates.clear();
+      blockV0s.clear();
+      vertexingInputs.clear();
+    };
 
     // loop over pairs of track indices
     for (const auto& casc : rowsTrackIndexCasc) {
@@ -186,49 +282,23 @@ struct HfCandidateCreatorCascade {
         continue;
       }
 
-      int posGlobalIndex = -1, negGlobalIndex = -1;
-      float v0X{}, v0Y{}, v0Z{}, v0px{}, v0py{}, v0pz{};
-      float v0PosPx{}, v0PosPy{}, v0PosPz{}, v0NegPx{}, v0NegPy{}, v0NegPz{};
-      float dcaV0dau{}, dcaPosToPV{}, dcaNegToPV{}, v0cosPA{};
       std::array<float, 21> covV{};
 
       auto v0index = casc.template v0_as<o2::aod::V0sLinked>();
-      if (v0index.has_v0Data()) {
-        // this V0 passed both standard V0 and cascade V0 selections
-        auto v0row = v0index.template v0Data_as<V0full>();
-        const auto& trackV0DaughPos = v0row.posTrack_as<aod::TracksWCov>();
-        const auto& trackV0DaughNeg = v0row.negTrack_as<aod::TracksWCov>();
-        posGlobalIndex = trackV0DaughPos.globalIndex();
-        negGlobalIndex = trackV0DaughNeg.globalIndex();
-        v0X = v0row.x();
-        v0Y = v0row.y();
-        v0Z = v0row.z();
-        v0px = v0row.px();
-        v0py = v0row.py();
-        v0pz = v0row.pz();
-        v0PosPx = v0row.pxpos();
-        v0PosPy = v0row.pypos();
-        v0PosPz = v0row.pzpos();
-        v0NegPx = v0row.pxneg();
-        v0NegPy = v0row.pyneg();
-        v0NegPz = v0row.pzneg();
-        dcaV0dau = v0row.dcaV0daughters();
-        dcaPosToPV = v0row.dcapostopv();
-        dcaNegToPV = v0row.dcanegtopv();
-        v0cosPA = v0row.v0cosPA();
-
-        int const momIndSize = 6;
-        constexpr int MomInd[6] = {9, 13, 14, 18, 19, 20}; // cov matrix elements for momentum component
-        for (int i = 0; i < momIndSize; i++) {
-          covV[MomInd[i]] = v0row.momentumCovMat()[i];
-          covV[i] = v0row.positionCovMat()[i];
-        }
-      } else {
+      if (!v0index.has_v0Data()) {
         if (!silenceV0DataWarning) {
           LOGF(warning, "V0Data not there for V0 %d in HF cascade %d. Skipping candidate.", casc.v0Id(), casc.globalIndex());
         }
         continue; // this was inadequately linked, should not happen
       }
+      // this V0 passed both standard V0 and cascade V0 selections
+      auto v0row = v0index.template v0Data_as<V0full>();
+      int const momIndSize = 6;
+      constexpr int MomInd[6] = {9, 13, 14, 18, 19, 20}; // cov matrix elements for momentum component
+      for (int i = 0; i < momIndSize; i++) {
+        covV[MomInd[i]] = v0row.momentumCovMat()[i];
+        covV[i] = v0row.positionCovMat()[i];
+      }
 
       /// Set the magnetic field from ccdb.
       /// The static instance of the propagator was already modified in the HFTrackIndexSkimCreator,
@@ -239,87 +309,23 @@ struct HfCandidateCreatorCascade {
         bz = o2::base::Propagator::Instance()->getNominalBz();
         // df.setBz(bz); /// put it outside the 'if'! Otherwise we have a difference wrt bz Configurable (< 1 permille) in Run2 conv. data
       }
-      df.setBz(bz);
 
       auto trackBach = getTrackParCov(bach);
-      const std::array<float, 3> vertexV0 = {v0X, v0Y, v0Z};
-      const std::array<float, 3> momentumV0 = {v0px, v0py, v0pz};
+      const std::array<float, 3> vertexV0 = {v0row.x(), v0row.y(), v0row.z()};
+      const std::array<float, 3> momentumV0 = {v0row.px(), v0row.py(), v0row.pz()};
       // we build the neutral track to then build the cascade
       auto trackV0 = o2::track::TrackParCov(vertexV0, momentumV0, covV, 0, true);
       trackV0.setAbsCharge(0);
       trackV0.setPID(o2::track::PID::K0);
 
-      // reconstruct the cascade secondary vertex
-      hCandidates->Fill(SVFitting::BeforeFit);
-      try {
-        if (df.process(trackV0, trackBach) == 0) {
-          continue;
-        }
-        LOG(debug) << "Vertexing succeeded for Lc candidate";
-
-      } catch (const std::runtime_error& error) {
-        LOG(debug) << "Run time error found: " << error.what() << ". DCAFitterN cannot work, skipping the candidate.";
-        hCandidates->Fill(SVFitting::Fail);
-        continue;
-      }
-      hCandidates->Fill(SVFitting::FitOk);
-
-      const auto& secondaryVertex = df.getPCACandidate();
-      auto chi2PCA = df.getChi2AtPCACandidate();
-      auto covMatrixPCA = df.calcPCACovMatrixFlat();
-      registry.fill(HIST("hCovSVXX"), covMatrixPCA[0]); // FIXME: Calculation of errorDecayLength(XY) gives wrong values without this line.
-      auto trackParVarV0 = df.getTrack(0);
-      auto trackParVarBach = df.getTrack(1);
-
-      // get track momenta
-      std::array<float, 3> pVecV0{};
-      std::array<float, 3> pVecBach{};
-      trackParVarV0.getPxPyPzGlo(pVecV0);
-      trackParVarBach.getPxPyPzGlo(pVecBach);
-
-      // get track impact parameters
-      // This modifies track momenta!
-      auto primaryVertex = getPrimaryVertex(collision);
-      auto covMatrixPV = primaryVertex.getCov();
-      registry.fill(HIST("hCovPVXX"), covMatrixPV[0]);
-      o2::dataformats::DCA impactParameterV0;
-      o2::dataformats::DCA impactParameterBach;
-      trackParVarV0.propagateToDCA(primaryVertex, bz, &impactParameterV0); // we do this wrt the primary vtx
-      trackParVarBach.propagateToDCA(primaryVertex, bz, &impactParameterBach);
-
-      // get uncertainty of the decay length
-      double phi{}, theta{};
-      getPointDirection(std::array{collision.posX(), collision.posY(), collision.posZ()}, secondaryVertex, phi, theta);
-      auto errorDecayLength = std::sqrt(getRotatedCovMatrixXX(covMatrixPV, phi, theta) + getRotatedCovMatrixXX(covMatrixPCA, phi, theta));
-      auto errorDecayLengthXY = std::sqrt(getRotatedCovMatrixXX(covMatrixPV, phi, 0.) + getRotatedCovMatrixXX(covMatrixPCA, phi, 0.));
-
-      // fill candidate table rows
-      rowCandidateBase(collision.globalIndex(),
-                       collision.posX(), collision.posY(), collision.posZ(),
-                       secondaryVertex[0], secondaryVertex[1], secondaryVertex[2],
-                       errorDecayLength, errorDecayLengthXY,
-                       chi2PCA,
-                       pVecBach[0], pVecBach[1], pVecBach[2],
-                       pVecV0[0], pVecV0[1], pVecV0[2],
-                       impactParameterBach.getY(), impactParameterV0.getY(),
-                       std::sqrt(impactParameterBach.getSigmaY2()), std::sqrt(impactParameterV0.getSigmaY2()),
-                       casc.prong0Id(), casc.v0Id(),
-                       v0X, v0Y, v0Z,
-                       posGlobalIndex, negGlobalIndex,
-                       v0PosPx, v0PosPy, v0PosPz,
-                       v0NegPx, v0NegPy, v0NegPz,
-                       dcaV0dau,
-                       dcaPosToPV,
-                       dcaNegToPV,
-                       v0cosPA);
-
-      // fill histograms
-      if (fillHistograms) {
-        // calculate invariant masses
-        mass2K0sP = RecoDecay::m(std::array{pVecBach, pVecV0}, std::array{MassProton, MassK0Short});
-        registry.fill(HIST("hMass2"), mass2K0sP);
+      blockCandidates.push_back(casc);
+      blockV0s.push_back(v0row);
+      vertexingInputs.push_back({{trackV0, trackBach}, getPrimaryVertex(collision), static_cast<float>(bz)});
+      if (blockCandidates.size() == blockSize) {
+        writeBlock();
       }
     }
+    writeBlock();
   }
 
   /// @brief process function w/o centrality selections
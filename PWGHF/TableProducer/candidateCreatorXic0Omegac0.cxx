@@ -75,6 +75,7 @@
 #include <numeric>
 #include <stdexcept>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 using namespace o2;
@@ -260,6 +261,27 @@ struct HfCandidateCreatorXic0Omegac0 {
     float etaXic;
   } kfXic0Candidate{};
 
+  /// V0 and cascade of the KF creators (steps 1 and 2), which depend only on the cascade and are shared by all its charm-baryon candidates
+  struct KfCascadeReco {
+    bool isSelected{false}; // V0 and cascade reconstructed and selected
+    KFParticle kfV0DauPos{};
+    KFParticle kfV0DauNeg{};
+    KFParticle kfCascBachelor{};
+    KFParticle kfV0{};
+    KFParticle kfV0MassConstrained{};
+    KFParticle kfCasc{};
+    KFParticle kfCascMassConstrained{};
+    float chi2GeoV0{0.f};
+    float chi2GeoCasc{0.f};
+    float massV0{0.f};
+    float sigmaMassV0{0.f};
+    float massCasc{0.f};
+    float sigmaMassCasc{0.f};
+    float massCascRej{0.f};
+    float sigmaMassCascRej{0.f};
+  };
+  std::unordered_map<int64_t, KfCascadeReco> kfCascadeRecos; // KF cascades of the current data frame, by cascade index
+
   void init(InitContext const&)
   {
     std::array<bool, 16> allProcesses = {doprocessNoCentToXiPi, doprocessNoCentToXiPiTraCasc, doprocessCentFT0CToXiPi, doprocessCentFT0MToXiPi, doprocessNoCentToOmegaPi, doprocessNoCentOmegacToOmegaPiWithKFParticle, doprocessCentFT0COmegacToOmegaPiWithKFParticle, doprocessCentFT0MOmegacToOmegaPiWithKFParticle, doprocessCentFT0CToOmegaPi, doprocessCentFT0MToOmegaPi, doprocessNoCentToOmegaK, doprocessCentFT0CToOmegaK, doprocessCentFT0MToOmegaK, doprocessNoCentXicToXiPiWithKFParticle, doprocessCentFT0CXicToXiPiWithKFParticle, doprocessCentFT0MXicToXiPiWithKFParticle};
@@ -739,6 +761,356 @@ struct HfCandidateCreatorXic0Omegac0 {
     } // loop over LF Cascade-bachelor candidates
   } // end of run function
 
+  /// Reconstructs with KFParticle the V0 and the Omega of a cascade for the Omegac0 -> Omega pi creator (steps 1 and 2)
+  /// \return false if the reconstruction fails or the V0 or the Omega is rejected
+  template <typename TTrack>
+  bool buildKfCascadeOmegac0ToOmegaPi(TTrack const& trackV0Dau0, TTrack const& trackV0Dau1, TTrack const& trackCascDauCharged, KfCascadeReco& reco)
+  {
+    auto bachCharge = trackCascDauCharged.signed1Pt() > 0 ? +1 : -1;
+
+    // convert tracks into KFParticle object
+    KFPTrack const kfTrack0 = createKFPTrackFromTrack(trackV0Dau0);
+    KFPTrack const kfTrack1 = createKFPTrackFromTrack(trackV0Dau1);
+    KFPTrack const kfTrackBach = createKFPTrackFromTrack(trackCascDauCharged);
+
+    KFParticle const kfPosPr(kfTrack0, kProton);
+    KFParticle const kfNegPi(kfTrack1, kPiMinus);
+    KFParticle const kfNegKa(kfTrackBach, kKMinus);
+    KFParticle const kfNegPiRej(kfTrackBach, kPiMinus); // rej
+    KFParticle const kfPosPi(kfTrack0, kPiPlus);
+    KFParticle const kfNegPr(kfTrack1, kProton);
+    KFParticle const kfPosKa(kfTrackBach, kKPlus);
+    KFParticle const kfPosPiRej(kfTrackBach, kPiPlus); // rej
+
+    KFParticle kfBachKaon;
+    KFParticle kfPos;
+    KFParticle kfNeg;
+    KFParticle kfBachPionRej; // rej
+    if (bachCharge < 0) {
+      kfPos = kfPosPr;
+      kfNeg = kfNegPi;
+      kfBachKaon = kfNegKa;
+      kfBachPionRej = kfNegPiRej; // rej
+    } else {
+      kfPos = kfPosPi;
+      kfNeg = kfNegPr;
+      kfBachKaon = kfPosKa;
+      kfBachPionRej = kfPosPiRej; // rej
+    }
+
+    //__________________________________________
+    //*>~<* step 1 : construct V0 with KF
+    const KFParticle* v0Daughters[2] = {&kfPos, &kfNeg};
+    // construct V0
+    KFParticle kfV0;
+    kfV0.SetConstructMethod(kfConstructMethod);
+    try {
+      kfV0.Construct(v0Daughters, 2);
+    } catch (std::runtime_error& e) {
+      LOG(debug) << "Failed to construct cascade V0 from daughter tracks: " << e.what();
+      return false;
+    }
+
+    // mass window cut on lambda before mass constraint
+    float massLam{}, sigLam{};
+    kfV0.GetMass(massLam, sigLam);
+    if (std::abs(massLam - MassLambda0) > lambdaMassWindow) {
+      return false;
+    }
+    // err_mass>0 of Lambda
+    if (sigLam <= 0) {
+      return false;
+    }
+    reco.chi2GeoV0 = kfV0.GetChi2();
+    KFParticle kfV0MassConstrained = kfV0;
+    kfV0MassConstrained.SetNonlinearMassConstraint(o2::constants::physics::MassLambda); // set mass constrain to Lambda
+    if (kfUseV0MassConstraint) {
+      KFParticle const kfV0 = kfV0MassConstrained;
+    }
+    kfV0.TransportToDecayVertex();
+
+    //__________________________________________
+    //*>~<* step 2 : reconstruct cascade(Omega) with KF
+    const KFParticle* omegaDaugthers[2] = {&kfBachKaon, &kfV0};
+    const KFParticle* omegaDaugthersRej[2] = {&kfBachPionRej, &kfV0}; // rej
+    // construct cascade
+    KFParticle kfOmega;
+    KFParticle kfOmegarej; // rej
+    kfOmega.SetConstructMethod(kfConstructMethod);
+    kfOmegarej.SetConstructMethod(kfConstructMethod); // rej
+    try {
+      kfOmega.Construct(omegaDaugthers, 2);
+      kfOmegarej.Construct(omegaDaugthersRej, 2); // rej
+    } catch (std::runtime_error& e) {
+      LOG(debug) << "Failed to construct Omega or Omega_rej from V0 and bachelor track: " << e.what();
+      return false;
+    }
+    float massCasc{}, sigCasc{};
+    float massCascrej{}, sigCascrej{};
+    kfOmega.GetMass(massCasc, sigCasc);
+    kfOmegarej.GetMass(massCascrej, sigCascrej); // rej
+    // err_massOmega > 0
+    if (sigCasc <= 0) {
+      return false;
+    }
+    if (std::abs(massCasc - MassOmegaMinus) > massToleranceCascade) {
+      return false;
+    }
+
+    reco.chi2GeoCasc = kfOmega.GetChi2();
+    KFParticle kfOmegaMassConstrained = kfOmega;
+    kfOmegaMassConstrained.SetNonlinearMassConstraint(o2::constants::physics::MassOmegaMinus); // set mass constrain to OmegaMinus
+    if (kfUseCascadeMassConstraint) {
+      // set mass constraint if requested
+      KFParticle const kfOmega = kfOmegaMassConstrained;
+    }
+    kfOmega.TransportToDecayVertex();
+    // rej: Add competing rejection to minimize misidentified Xi impact. Reject if kfBachPionRej is Pion and the constructed cascade has Xi's invariant mass.
+
+    reco.kfV0DauPos = kfPos;
+    reco.kfV0DauNeg = kfNeg;
+    reco.kfCascBachelor = kfBachKaon;
+    reco.kfV0 = kfV0;
+    reco.kfV0MassConstrained = kfV0MassConstrained;
+    reco.kfCasc = kfOmega;
+    reco.kfCascMassConstrained = kfOmegaMassConstrained;
+    reco.massV0 = massLam;
+    reco.sigmaMassV0 = sigLam;
+    reco.massCasc = massCasc;
+    reco.sigmaMassCasc = sigCasc;
+    reco.massCascRej = massCascrej;
+    reco.sigmaMassCascRej = sigCascrej;
+    return true;
+  }
+
+  /// Reconstructs with KFParticle the V0 and the Xi of a cascade for the Xic0 -> Xi pi creator (steps 1 and 2)
+  /// \return false if the reconstruction fails or the V0 or the Xi is rejected
+  template <typename TTrack>
+  bool buildKfCascadeXic0ToXiPi(TTrack const& trackV0Dau0, TTrack const& trackV0Dau1, TTrack const& trackCascDauCharged, KfCascadeReco& reco)
+  {
+    auto bachCharge = trackCascDauCharged.signed1Pt() > 0 ? +1 : -1;
+
+    // convert tracks into KFParticle object
+    KFPTrack const kfTrack0 = createKFPTrackFromTrack(trackV0Dau0);
+    KFPTrack const kfTrack1 = createKFPTrackFromTrack(trackV0Dau1);
+    KFPTrack const kfTrackBach = createKFPTrackFromTrack(trackCascDauCharged);
+
+    KFParticle const kfPosPr(kfTrack0, kProton);
+    KFParticle const kfNegPi(kfTrack1, kPiMinus);
+    KFParticle const kfNegBachPi(kfTrackBach, kPiMinus);
+    KFParticle const kfPosPi(kfTrack0, kPiPlus);
+    KFParticle const kfNegPr(kfTrack1, kProton);
+    KFParticle const kfPosBachPi(kfTrackBach, kPiPlus);
+
+    KFParticle kfBachPion;
+    KFParticle kfPos;
+    KFParticle kfNeg;
+    if (bachCharge < 0) {
+      kfPos = kfPosPr;
+      kfNeg = kfNegPi;
+      kfBachPion = kfNegBachPi;
+    } else {
+      kfPos = kfPosPi;
+      kfNeg = kfNegPr;
+      kfBachPion = kfPosBachPi;
+    }
+
+    //__________________________________________
+    //*>~<* step 1 : construct V0 with KF
+    const KFParticle* v0Daughters[2] = {&kfPos, &kfNeg};
+    // construct V0
+    KFParticle kfV0;
+    kfV0.SetConstructMethod(kfConstructMethod);
+    try {
+      kfV0.Construct(v0Daughters, 2);
+    } catch (std::runtime_error& e) {
+      LOG(debug) << "Failed to construct cascade V0 from daughter tracks: " << e.what();
+      return false;
+    }
+
+    // mass window cut on lambda before mass constraint
+    float massLam, sigLam;
+    kfV0.GetMass(massLam, sigLam);
+    if (std::abs(massLam - MassLambda0) > lambdaMassWindow) {
+      return false;
+    }
+
+    // err_mass>0 of Lambda
+    if (sigLam <= 0) {
+      return false;
+    }
+    // chi2>0 && NDF>0 for selecting Lambda
+    if ((kfV0.GetNDF() <= 0 || kfV0.GetChi2() <= 0)) {
+      return false;
+    }
+
+    reco.chi2GeoV0 = kfV0.GetChi2();
+    KFParticle kfV0MassConstrained = kfV0;
+    kfV0MassConstrained.SetNonlinearMassConstraint(o2::constants::physics::MassLambda); // set mass constrain to Lambda
+    if (kfUseV0MassConstraint) {
+      kfV0 = kfV0MassConstrained;
+    }
+    kfV0.TransportToDecayVertex();
+
+    //__________________________________________
+    //*>~<* step 2 : reconstruct cascade(Xi) with KF
+    const KFParticle* xiDaugthers[2] = {&kfBachPion, &kfV0};
+    // construct cascade
+    KFParticle kfXi;
+    kfXi.SetConstructMethod(kfConstructMethod);
+    try {
+      kfXi.Construct(xiDaugthers, 2);
+    } catch (std::runtime_error& e) {
+      LOG(debug) << "Failed to construct Xi from V0 and bachelor track: " << e.what();
+      return false;
+    }
+
+    float massCasc, sigCasc;
+    kfXi.GetMass(massCasc, sigCasc);
+    // err_massXi > 0
+    if (sigCasc <= 0) {
+      return false;
+    }
+
+    if (std::abs(massCasc - MassXiMinus) > massToleranceCascade) {
+      return false;
+    }
+    // chi2>0 && NDF>0
+    if (kfXi.GetNDF() <= 0 || kfXi.GetChi2() <= 0) {
+      return false;
+    }
+    reco.chi2GeoCasc = kfXi.GetChi2();
+    KFParticle kfXiMassConstrained = kfXi;
+    kfXiMassConstrained.SetNonlinearMassConstraint(o2::constants::physics::MassXiMinus); // set mass constrain to XiMinus
+    if (kfUseCascadeMassConstraint) {
+      // set mass constraint if requested
+      KFParticle const kfXi = kfXiMassConstrained;
+    }
+    kfXi.TransportToDecayVertex();
+
+    reco.kfV0DauPos = kfPos;
+    reco.kfV0DauNeg = kfNeg;
+    reco.kfCascBachelor = kfBachPion;
+    reco.kfV0 = kfV0;
+    reco.kfV0MassConstrained = kfV0MassConstrained;
+    reco.kfCasc = kfXi;
+    reco.kfCascMassConstrained = kfXiMassConstrained;
+    reco.massV0 = massLam;
+    reco.sigmaMassV0 = sigLam;
+    reco.massCasc = massCasc;
+    reco.sigmaMassCasc = sigCasc;
+    return true;
+  }
+
+  /// Reconstructs with KFParticle the V0 and the Omega of a cascade for the Omegac0/Xic0 -> Omega K creator (steps 1 and 2)
+  /// \return false if the reconstruction fails or the V0 or the Omega is rejected
+  template <typename TTrack>
+  bool buildKfCascadeToOmegaKa(TTrack const& trackV0DauPos, TTrack const& trackV0DauNeg, TTrack const& trackKaFromOmega, int signOmega, KfCascadeReco& reco)
+  {
+    KFPTrack const kfpTrackKaFromOmega = createKFPTrackFromTrack(trackKaFromOmega);
+    KFPTrack const kfpTrackV0DauPos = createKFPTrackFromTrack(trackV0DauPos);
+    KFPTrack const kfpTrackV0DauNeg = createKFPTrackFromTrack(trackV0DauNeg);
+
+    KFParticle kfPrFromV0(kfpTrackV0DauPos, kProton);
+    KFParticle kfPiFromV0(kfpTrackV0DauNeg, kPiMinus);
+    KFParticle kfKaFromOmega(kfpTrackKaFromOmega, kKMinus);
+    KFParticle kfPiFromXiRej(kfpTrackKaFromOmega, kPiMinus); // rej
+
+    // convert for Pos and Neg Particles
+    if (signOmega > 0) {
+      kfPiFromV0 = KFParticle(kfpTrackV0DauPos, kPiPlus);
+      kfPrFromV0 = KFParticle(kfpTrackV0DauNeg, -kProton);
+      kfKaFromOmega = KFParticle(kfpTrackKaFromOmega, kKPlus);
+      kfPiFromXiRej = KFParticle(kfpTrackKaFromOmega, kPiPlus); // rej
+    }
+
+    // step 1 : construct V0 with KF
+    const KFParticle* v0Daughters[2] = {&kfPrFromV0, &kfPiFromV0};
+    // construct V0
+    KFParticle kfV0;
+    kfV0.SetConstructMethod(kfConstructMethod);
+    try {
+      kfV0.Construct(v0Daughters, 2);
+    } catch (std::runtime_error& e) {
+      LOG(debug) << "Failed to construct cascade V0 from daughter tracks: " << e.what();
+      return false;
+    }
+    // mass window cut on lambda before mass constraint
+    float massLam, sigLam;
+    kfV0.GetMass(massLam, sigLam);
+    if (std::abs(massLam - MassLambda0) > lambdaMassWindow) {
+      return false;
+    }
+    // err_mass>0 of Lambda
+    if (sigLam <= 0) {
+      return false;
+    }
+    // chi2>0 && NDF>0 for selecting Lambda
+    if ((kfV0.GetNDF() <= 0 || kfV0.GetChi2() <= 0)) {
+      return false;
+    }
+    KFParticle kfV0MassConstrained = kfV0;
+    kfV0MassConstrained.SetNonlinearMassConstraint(o2::constants::physics::MassLambda); // set mass constrain to Lambda
+    if (kfUseV0MassConstraint) {
+      kfV0 = kfV0MassConstrained;
+    }
+    kfV0.TransportToDecayVertex();
+
+    // step 2 : reconstruct cascade(Omega) with KF
+    const KFParticle* omegaDaugthers[2] = {&kfKaFromOmega, &kfV0};
+    const KFParticle* omegaDaugthersRej[2] = {&kfPiFromXiRej, &kfV0}; // rej
+    // construct cascade
+    KFParticle kfOmega;
+    KFParticle kfOmegarej; // rej
+    kfOmega.SetConstructMethod(kfConstructMethod);
+    kfOmegarej.SetConstructMethod(kfConstructMethod); // rej
+    try {
+      kfOmega.Construct(omegaDaugthers, 2);
+      kfOmegarej.Construct(omegaDaugthersRej, 2); // rej
+    } catch (std::runtime_error& e) {
+      LOG(debug) << "Failed to construct Omega or Omega_rej from V0 and bachelor track: " << e.what();
+      return false;
+    }
+    float massCasc, sigCasc;
+    float massCascrej, sigCascrej;
+    kfOmega.GetMass(massCasc, sigCasc);
+    kfOmegarej.GetMass(massCascrej, sigCascrej); // rej
+    // err_massOmega and err_massXiRej > 0
+    if (sigCasc <= 0 || sigCascrej <= 0) {
+      return false;
+    }
+    // chi2>0 && NDF>0
+    if (kfOmega.GetNDF() <= 0 || kfOmega.GetChi2() <= 0) {
+      return false;
+    }
+    if ((std::abs(massCasc - MassOmegaMinus) > massToleranceCascade) || (std::abs(massCascrej - MassXiMinus) < massToleranceCascadeRej)) {
+      return false;
+    }
+    KFParticle kfOmegaMassConstrained = kfOmega;
+    kfOmegaMassConstrained.SetNonlinearMassConstraint(o2::constants::physics::MassOmegaMinus); // set mass constrain to XiMinus
+    if (kfUseCascadeMassConstraint) {
+      // set mass constraint if requested
+      kfOmega = kfOmegaMassConstrained;
+    }
+    kfOmega.TransportToDecayVertex();
+    // rej: Add competing rejection to minimize misidentified Xi impact. Reject if kfBachPionRej is Pion and the constructed cascade has Xi's invariant mass.
+
+    reco.kfV0DauPos = kfPrFromV0;
+    reco.kfV0DauNeg = kfPiFromV0;
+    reco.kfCascBachelor = kfKaFromOmega;
+    reco.kfV0 = kfV0;
+    reco.kfV0MassConstrained = kfV0MassConstrained;
+    reco.kfCasc = kfOmega;
+    reco.kfCascMassConstrained = kfOmegaMassConstrained;
+    reco.massV0 = massLam;
+    reco.sigmaMassV0 = sigLam;
+    reco.massCasc = massCasc;
+    reco.sigmaMassCasc = sigCasc;
+    reco.massCascRej = massCascrej;
+    reco.sigmaMassCascRej = sigCascrej;
+    return true;
+  }
+
   template <o2::hf_centrality::CentralityEstimator CentEstimator, int DecayChannel, typename Coll, typename Hist>
   void runKfOmegac0CreatorWithKFParticle(Coll const&,
                                          aod::BCsWithTimestamps const& /*bcWithTimeStamps*/,
@@ -751,6 +1123,7 @@ struct HfCandidateCreatorXic0Omegac0 {
                                          Hist& hCandidateCounter,
                                          Hist& hCascadesCounter)
   {
+    kfCascadeRecos.clear();
     for (const auto& cand : candidates) {
       hCandidateCounter->Fill(1);
 
@@ -770,6 +1143,7 @@ struct HfCandidateCreatorXic0Omegac0 {
         magneticField = o2::base::Propagator::Instance()->getNominalBz();
         LOG(info) << ">>>>>>>>>>>> Magnetic field: " << magneticField;
         runNumber = bc.runNumber();
+        kfCascadeRecos.clear(); // built with the magnetic field of the previous run
       }
       df.setBz(magneticField);
       KFParticle::SetField(magneticField);
@@ -798,107 +1172,30 @@ struct HfCandidateCreatorXic0Omegac0 {
       auto trackParCovV0Dau1 = getTrackParCov(trackV0Dau1);
       // kaon <- casc TrackParCov
       auto omegaDauChargedTrackParCov = getTrackParCov(trackCascDauCharged);
-      // convert tracks into KFParticle object
-      KFPTrack const kfTrack0 = createKFPTrackFromTrack(trackV0Dau0);
-      KFPTrack const kfTrack1 = createKFPTrackFromTrack(trackV0Dau1);
-      KFPTrack const kfTrackBach = createKFPTrackFromTrack(trackCascDauCharged);
-
-      KFParticle const kfPosPr(kfTrack0, kProton);
-      KFParticle const kfNegPi(kfTrack1, kPiMinus);
-      KFParticle const kfNegKa(kfTrackBach, kKMinus);
-      KFParticle const kfNegPiRej(kfTrackBach, kPiMinus); // rej
-      KFParticle const kfPosPi(kfTrack0, kPiPlus);
-      KFParticle const kfNegPr(kfTrack1, kProton);
-      KFParticle const kfPosKa(kfTrackBach, kKPlus);
-      KFParticle const kfPosPiRej(kfTrackBach, kPiPlus); // rej
-
-      KFParticle kfBachKaon;
-      KFParticle kfPos;
-      KFParticle kfNeg;
-      KFParticle kfBachPionRej; // rej
-      if (bachCharge < 0) {
-        kfPos = kfPosPr;
-        kfNeg = kfNegPi;
-        kfBachKaon = kfNegKa;
-        kfBachPionRej = kfNegPiRej; // rej
-      } else {
-        kfPos = kfPosPi;
-        kfNeg = kfNegPr;
-        kfBachKaon = kfPosKa;
-        kfBachPionRej = kfPosPiRej; // rej
-      }
-
-      //__________________________________________
-      //*>~<* step 1 : construct V0 with KF
-      const KFParticle* v0Daughters[2] = {&kfPos, &kfNeg};
-      // construct V0
-      KFParticle kfV0;
-      kfV0.SetConstructMethod(kfConstructMethod);
-      try {
-        kfV0.Construct(v0Daughters, 2);
-      } catch (std::runtime_error& e) {
-        LOG(debug) << "Failed to construct cascade V0 from daughter tracks: " << e.what();
-        continue;
-      }
-
-      // mass window cut on lambda before mass constraint
-      float massLam{}, sigLam{};
-      kfV0.GetMass(massLam, sigLam);
-      if (std::abs(massLam - MassLambda0) > lambdaMassWindow) {
-        continue;
-      }
-      // err_mass>0 of Lambda
-      if (sigLam <= 0) {
-        continue;
-      }
-      kfOmegac0Candidate.chi2GeoV0 = kfV0.GetChi2();
-      KFParticle kfV0MassConstrained = kfV0;
-      kfV0MassConstrained.SetNonlinearMassConstraint(o2::constants::physics::MassLambda); // set mass constrain to Lambda
-      if (kfUseV0MassConstraint) {
-        KFParticle const kfV0 = kfV0MassConstrained;
-      }
-      kfV0.TransportToDecayVertex();
 
-      //__________________________________________
-      //*>~<* step 2 : reconstruct cascade(Omega) with KF
-      const KFParticle* omegaDaugthers[2] = {&kfBachKaon, &kfV0};
-      const KFParticle* omegaDaugthersRej[2] = {&kfBachPionRej, &kfV0}; // rej
-      // construct cascade
-      KFParticle kfOmega;
-      KFParticle kfOmegarej; // rej
-      kfOmega.SetConstructMethod(kfConstructMethod);
-      kfOmegarej.SetConstructMethod(kfConstructMethod); // rej
-      try {
-        kfOmega.Construct(omegaDaugthers, 2);
-        kfOmegarej.Construct(omegaDaugthersRej, 2); // rej
-      } catch (std::runtime_error& e) {
-        LOG(debug) << "Failed to construct Omega or Omega_rej from V0 and bachelor track: " << e.what();
-        continue;
-      }
-      float massCasc{}, sigCasc{};
-      float massCascrej{}, sigCascrej{};
-      kfOmega.GetMass(massCasc, sigCasc);
-      kfOmegarej.GetMass(massCascrej, sigCascrej); // rej
-      // err_massOmega > 0
-      if (sigCasc <= 0) {
-        continue;
+      // V0 and cascade reconstructed once per cascade of the data frame
+      auto [itKfCascadeReco, isNewCascade] = kfCascadeRecos.try_emplace(casc.globalIndex());
+      KfCascadeReco& kfCascadeReco = itKfCascadeReco->second;
+      if (isNewCascade) {
+        kfCascadeReco.isSelected = buildKfCascadeOmegac0ToOmegaPi(trackV0Dau0, trackV0Dau1, trackCascDauCharged, kfCascadeReco);
       }
-      if (std::abs(massCasc - MassOmegaMinus) > massToleranceCascade) {
+      if (!kfCascadeReco.isSelected) {
         continue;
       }
-
-      kfOmegac0Candidate.chi2GeoCasc = kfOmega.GetChi2();
-      kfOmegac0Candidate.cascRejectInvmass = massCascrej;
-      registry.fill(HIST("hInvMassXiMinus_rej"), massCascrej); // rej
-      KFParticle kfOmegaMassConstrained = kfOmega;
-      kfOmegaMassConstrained.SetNonlinearMassConstraint(o2::constants::physics::MassOmegaMinus); // set mass constrain to OmegaMinus
-      if (kfUseCascadeMassConstraint) {
-        // set mass constraint if requested
-        KFParticle const kfOmega = kfOmegaMassConstrained;
-      }
+      KFParticle kfPos = kfCascadeReco.kfV0DauPos;
+      KFParticle kfNeg = kfCascadeReco.kfV0DauNeg;
+      KFParticle kfBachKaon = kfCascadeReco.kfCascBachelor;
+      KFParticle kfV0 = kfCascadeReco.kfV0;
+      KFParticle kfV0MassConstrained = kfCascadeReco.kfV0MassConstrained;
+      KFParticle kfOmega = kfCascadeReco.kfCasc;
+      KFParticle kfOmegaMassConstrained = kfCascadeReco.kfCascMassConstrained;
+      float const massLam = kfCascadeReco.massV0;
+      float const massCasc = kfCascadeReco.massCasc;
+      kfOmegac0Candidate.chi2GeoV0 = kfCascadeReco.chi2GeoV0;
+      kfOmegac0Candidate.chi2GeoCasc = kfCascadeReco.chi2GeoCasc;
+      kfOmegac0Candidate.cascRejectInvmass = kfCascadeReco.massCascRej;
+      registry.fill(HIST("hInvMassXiMinus_rej"), kfCascadeReco.massCascRej); // rej
       registry.fill(HIST("hInvMassOmegaMinus"), massCasc);
-      kfOmega.TransportToDecayVertex();
-      // rej: Add competing rejection to minimize misidentified Xi impact. Reject if kfBachPionRej is Pion and the constructed cascade has Xi's invariant mass.
 
       //__________________________________________
       //*>~<* step 3 : reconstruc Omegac0 with KF
@@ -1237,6 +1534,7 @@ struct HfCandidateCreatorXic0Omegac0 {
                                       Hist& hCandidateCounter,
                                       Hist& hCascadesCounter)
   {
+    kfCascadeRecos.clear();
     for (const auto& cand : candidates) {
       hCandidateCounter->Fill(1);
       if (!TESTBIT(cand.hfflag(), aod::hf_cand_casc_lf::DecayType2Prong::XiczeroOmegaczeroToXiPi)) {
@@ -1259,6 +1557,7 @@ struct HfCandidateCreatorXic0Omegac0 {
         magneticField = o2::base::Propagator::Instance()->getNominalBz();
         LOG(info) << ">>>>>>>>>>>> Magnetic field: " << magneticField;
         runNumber = bc.runNumber();
+        kfCascadeRecos.clear(); // built with the magnetic field of the previous run
       }
       df.setBz(magneticField);
       KFParticle::SetField(magneticField);
@@ -1288,104 +1587,29 @@ struct HfCandidateCreatorXic0Omegac0 {
       // pion <- casc TrackParCov
       auto xiDauChargedTrackParCov = getTrackParCov(trackCascDauCharged);
 
-      // convert tracks into KFParticle object
-      KFPTrack const kfTrack0 = createKFPTrackFromTrack(trackV0Dau0);
-      KFPTrack const kfTrack1 = createKFPTrackFromTrack(trackV0Dau1);
-      KFPTrack const kfTrackBach = createKFPTrackFromTrack(trackCascDauCharged);
-
-      KFParticle const kfPosPr(kfTrack0, kProton);
-      KFParticle const kfNegPi(kfTrack1, kPiMinus);
-      KFParticle const kfNegBachPi(kfTrackBach, kPiMinus);
-      KFParticle const kfPosPi(kfTrack0, kPiPlus);
-      KFParticle const kfNegPr(kfTrack1, kProton);
-      KFParticle const kfPosBachPi(kfTrackBach, kPiPlus);
-
-      KFParticle kfBachPion;
-      KFParticle kfPos;
-      KFParticle kfNeg;
-      if (bachCharge < 0) {
-        kfPos = kfPosPr;
-        kfNeg = kfNegPi;
-        kfBachPion = kfNegBachPi;
-      } else {
-        kfPos = kfPosPi;
-        kfNeg = kfNegPr;
-        kfBachPion = kfPosBachPi;
-      }
-
-      //__________________________________________
-      //*>~<* step 1 : construct V0 with KF
-      const KFParticle* v0Daughters[2] = {&kfPos, &kfNeg};
-      // construct V0
-      KFParticle kfV0;
-      kfV0.SetConstructMethod(kfConstructMethod);
-      try {
-        kfV0.Construct(v0Daughters, 2);
-      } catch (std::runtime_error& e) {
-        LOG(debug) << "Failed to construct cascade V0 from daughter tracks: " << e.what();
-        continue;
-      }
-
-      // mass window cut on lambda before mass constraint
-      float massLam, sigLam;
-      kfV0.GetMass(massLam, sigLam);
-      if (std::abs(massLam - MassLambda0) > lambdaMassWindow) {
-        continue;
-      }
-
-      // err_mass>0 of Lambda
-      if (sigLam <= 0) {
-        continue;
-      }
-      // chi2>0 && NDF>0 for selecting Lambda
-      if ((kfV0.GetNDF() <= 0 || kfV0.GetChi2() <= 0)) {
-        continue;
-      }
-
-      kfXic0Candidate.chi2GeoV0 = kfV0.GetChi2();
-      KFParticle kfV0MassConstrained = kfV0;
-      kfV0MassConstrained.SetNonlinearMassConstraint(o2::constants::physics::MassLambda); // set mass constrain to Lambda
-      if (kfUseV0MassConstraint) {
-        kfV0 = kfV0MassConstrained;
-      }
-      kfV0.TransportToDecayVertex();
-
-      //__________________________________________
-      //*>~<* step 2 : reconstruct cascade(Xi) with KF
-      const KFParticle* xiDaugthers[2] = {&kfBachPion, &kfV0};
-      // construct cascade
-      KFParticle kfXi;
-      kfXi.SetConstructMethod(kfConstructMethod);
-      try {
-        kfXi.Construct(xiDaugthers, 2);
-      } catch (std::runtime_error& e) {
-        LOG(debug) << "Failed to construct Xi from V0 and bachelor track: " << e.what();
-        continue;
-      }
-
-      float massCasc, sigCasc;
-      kfXi.GetMass(massCasc, sigCasc);
-      // err_massXi > 0
-      if (sigCasc <= 0) {
-        continue;
-      }
-
-      if (std::abs(massCasc - MassXiMinus) > massToleranceCascade) {
-        continue;
+      // V0 and cascade reconstructed once per cascade of the data frame
+      auto [itKfCascadeReco, isNewCascade] = kfCascadeRecos.try_emplace(casc.globalIndex());
+      KfCascadeReco& kfCascadeReco = itKfCascadeReco->second;
+      if (isNewCascade) {
+        kfCascadeReco.isSelected = buildKfCascadeXic0ToXiPi(trackV0Dau0, trackV0Dau1, trackCascDauCharged, kfCascadeReco);
       }
-      // chi2>0 && NDF>0
-      if (kfXi.GetNDF() <= 0 || kfXi.GetChi2() <= 0) {
+      if (!kfCascadeReco.isSelected) {
         continue;
       }
-      kfXic0Candidate.chi2GeoCasc = kfXi.GetChi2();
-      KFParticle kfXiMassConstrained = kfXi;
-      kfXiMassConstrained.SetNonlinearMassConstraint(o2::constants::physics::MassXiMinus); // set mass constrain to XiMinus
-      if (kfUseCascadeMassConstraint) {
-        // set mass constraint if requested
-        KFParticle const kfXi = kfXiMassConstrained;
-      }
+      KFParticle kfPos = kfCascadeReco.kfV0DauPos;
+      KFParticle kfNeg = kfCascadeReco.kfV0DauNeg;
+      KFParticle kfBachPion = kfCascadeReco.kfCascBachelor;
+      KFParticle kfV0 = kfCascadeReco.kfV0;
+      KFParticle kfV0MassConstrained = kfCascadeReco.kfV0MassConstrained;
+      KFParticle kfXi = kfCascadeReco.kfCasc;
+      KFParticle kfXiMassConstrained = kfCascadeReco.kfCascMassConstrained;
+      float const massLam = kfCascadeReco.massV0;
+      float const sigLam = kfCascadeReco.sigmaMassV0;
+      float const massCasc = kfCascadeReco.massCasc;
+      float const sigCasc = kfCascadeReco.sigmaMassCasc;
+      kfXic0Candidate.chi2GeoV0 = kfCascadeReco.chi2GeoV0;
+      kfXic0Candidate.chi2GeoCasc = kfCascadeReco.chi2GeoCasc;
       registry.fill(HIST("hInvMassXiMinus"), massCasc);
-      kfXi.TransportToDecayVertex();
 
       //__________________________________________
       //*>~<* step 3 : reconstruc Xic0 with KF
@@ -1659,6 +1883,7 @@ struct HfCandidateCreatorXic0Omegac0 {
                                                     Hist& hCandidateCounter,
                                                     Hist& hCascadesCounter)
   {
+    kfCascadeRecos.clear();
     for (const auto& cand : candidates) {
       hCandidateCounter->Fill(1);
 
@@ -1679,6 +1904,7 @@ struct HfCandidateCreatorXic0Omegac0 {
         magneticField = o2::base::Propagator::Instance()->getNominalBz();
         LOG(info) << ">>>>>>>>>>>> Magnetic field: " << magneticField;
         runNumber = bc.runNumber();
+        kfCascadeRecos.clear(); // built with the magnetic field of the previous run
       }
       KFParticle::SetField(magneticField);
 
@@ -1704,14 +1930,6 @@ struct HfCandidateCreatorXic0Omegac0 {
       auto signOmega = casc.sign();
 
       KFPTrack const kfpTrackKaFromCharm = createKFPTrackFromTrack(trackKaFromCharm);
-      KFPTrack const kfpTrackKaFromOmega = createKFPTrackFromTrack(trackKaFromOmega);
-      KFPTrack const kfpTrackV0DauPos = createKFPTrackFromTrack(trackV0DauPos);
-      KFPTrack const kfpTrackV0DauNeg = createKFPTrackFromTrack(trackV0DauNeg);
-
-      KFParticle kfPrFromV0(kfpTrackV0DauPos, kProton);
-      KFParticle kfPiFromV0(kfpTrackV0DauNeg, kPiMinus);
-      KFParticle kfKaFromOmega(kfpTrackKaFromOmega, kKMinus);
-      KFParticle kfPiFromXiRej(kfpTrackKaFromOmega, kPiMinus); // rej
       KFParticle kfKaFromCharm(kfpTrackKaFromCharm, kKPlus);
 
       if (signOmega == 0 || kaFromOmegaCharge == 0 || kaFromOmegaCharge != signOmega) {
@@ -1719,10 +1937,6 @@ struct HfCandidateCreatorXic0Omegac0 {
       }
       // convert for Pos and Neg Particles
       if (signOmega > 0) {
-        kfPiFromV0 = KFParticle(kfpTrackV0DauPos, kPiPlus);
-        kfPrFromV0 = KFParticle(kfpTrackV0DauNeg, -kProton);
-        kfKaFromOmega = KFParticle(kfpTrackKaFromOmega, kKPlus);
-        kfPiFromXiRej = KFParticle(kfpTrackKaFromOmega, kPiPlus); // rej
         kfKaFromCharm = KFParticle(kfpTrackKaFromCharm, kKMinus);
       }
 
@@ -1747,78 +1961,30 @@ struct HfCandidateCreatorXic0Omegac0 {
       std::array<float, 3> vertexCasc = {casc.x(), casc.y(), casc.z()};
       std::array<float, 3> pVecCasc = {casc.px(), casc.py(), casc.pz()};
 
-      // step 1 : construct V0 with KF
-      const KFParticle* v0Daughters[2] = {&kfPrFromV0, &kfPiFromV0};
-      // construct V0
-      KFParticle kfV0;
-      kfV0.SetConstructMethod(kfConstructMethod);
-      try {
-        kfV0.Construct(v0Daughters, 2);
-      } catch (std::runtime_error& e) {
-        LOG(debug) << "Failed to construct cascade V0 from daughter tracks: " << e.what();
-        continue;
-      }
-      // mass window cut on lambda before mass constraint
-      float massLam, sigLam;
-      kfV0.GetMass(massLam, sigLam);
-      if (std::abs(massLam - MassLambda0) > lambdaMassWindow) {
-        continue;
+      // V0 and cascade reconstructed once per cascade of the data frame
+      auto [itKfCascadeReco, isNewCascade] = kfCascadeRecos.try_emplace(casc.globalIndex());
+      KfCascadeReco& kfCascadeReco = itKfCascadeReco->second;
+      if (isNewCascade) {
+        kfCascadeReco.isSelected = buildKfCascadeToOmegaKa(trackV0DauPos, trackV0DauNeg, trackKaFromOmega, signOmega, kfCascadeReco);
       }
-      // err_mass>0 of Lambda
-      if (sigLam <= 0) {
-        continue;
-      }
-      // chi2>0 && NDF>0 for selecting Lambda
-      if ((kfV0.GetNDF() <= 0 || kfV0.GetChi2() <= 0)) {
-        continue;
-      }
-      KFParticle kfV0MassConstrained = kfV0;
-      kfV0MassConstrained.SetNonlinearMassConstraint(o2::constants::physics::MassLambda); // set mass constrain to Lambda
-      if (kfUseV0MassConstraint) {
-        kfV0 = kfV0MassConstrained;
-      }
-      kfV0.TransportToDecayVertex();
-
-      // step 2 : reconstruct cascade(Omega) with KF
-      const KFParticle* omegaDaugthers[2] = {&kfKaFromOmega, &kfV0};
-      const KFParticle* omegaDaugthersRej[2] = {&kfPiFromXiRej, &kfV0}; // rej
-      // construct cascade
-      KFParticle kfOmega;
-      KFParticle kfOmegarej; // rej
-      kfOmega.SetConstructMethod(kfConstructMethod);
-      kfOmegarej.SetConstructMethod(kfConstructMethod); // rej
-      try {
-        kfOmega.Construct(omegaDaugthers, 2);
-        kfOmegarej.Construct(omegaDaugthersRej, 2); // rej
-      } catch (std::runtime_error& e) {
-        LOG(debug) << "Failed to construct Omega or Omega_rej from V0 and bachelor track: " << e.what();
-        continue;
-      }
-      float massCasc, sigCasc;
-      float massCascrej, sigCascrej;
-      kfOmega.GetMass(massCasc, sigCasc);
-      kfOmegarej.GetMass(massCascrej, sigCascrej); // rej
-      // err_massOmega and err_massXiRej > 0
-      if (sigCasc <= 0 || sigCascrej <= 0) {
-        continue;
-      }
-      // chi2>0 && NDF>0
-      if (kfOmega.GetNDF() <= 0 || kfOmega.GetChi2() <= 0) {
-        continue;
-      }
-      if ((std::abs(massCasc - MassOmegaMinus) > massToleranceCascade) || (std::abs(massCascrej - MassXiMinus) < massToleranceCascadeRej)) {
+      if (!kfCascadeReco.isSelected) {
         continue;
       }
+      KFParticle kfPrFromV0 = kfCascadeReco.kfV0DauPos;
+      KFParticle kfPiFromV0 = kfCascadeReco.kfV0DauNeg;
+      KFParticle kfKaFromOmega = kfCascadeReco.kfCascBachelor;
+      KFParticle kfV0 = kfCascadeReco.kfV0;
+      KFParticle kfV0MassConstrained = kfCascadeReco.kfV0MassConstrained;
+      KFParticle kfOmega = kfCascadeReco.kfCasc;
+      KFParticle kfOmegaMassConstrained = kfCascadeReco.kfCascMassConstrained;
+      float const massLam = kfCascadeReco.massV0;
+      float const sigLam = kfCascadeReco.sigmaMassV0;
+      float const massCasc = kfCascadeReco.massCasc;
+      float const sigCasc = kfCascadeReco.sigmaMassCasc;
+      float const massCascrej = kfCascadeReco.massCascRej;
+      float const sigCascrej = kfCascadeReco.sigmaMassCascRej;
       registry.fill(HIST("hInvMassXiMinus_rej"), massCascrej); // rej: Add competing rejection to minimize misidentified Xi impact. Reject if kfBachPionRej is Pion and the constructed cascade has Xi's invariant mass.
-      KFParticle kfOmegaMassConstrained = kfOmega;
-      kfOmegaMassConstrained.SetNonlinearMassConstraint(o2::constants::physics::MassOmegaMinus); // set mass constrain to XiMinus
-      if (kfUseCascadeMassConstraint) {
-        // set mass constraint if requested
-        kfOmega = kfOmegaMassConstrained;
-      }
       registry.fill(HIST("hInvMassXiMinus"), massCasc);
-      kfOmega.TransportToDecayVertex();
-      // rej: Add competing rejection to minimize misidentified Xi impact. Reject if kfBachPionRej is Pion and the constructed cascade has Xi's invariant mass.
 
       // step 3 : reconstruc OmegaKa with KF
       //  Create KF charm bach Pion from track
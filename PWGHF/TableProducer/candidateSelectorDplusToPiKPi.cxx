@@ -23,6 +23,7 @@
 #include "PWGHF/DataModel/CandidateSelectionTables.h"
 #include "PWGHF/DataModel/TrackIndexSkimmingTables.h"
 #include "PWGHF/Utils/utilsAnalysis.h"
+#include "PWGHF/Utils/utilsSelectorHf.h"
 
 #include "Common/Core/TrackSelectorPID.h"
 
@@ -42,6 +43,7 @@
 
 #include <Rtypes.h>
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -102,6 +104,9 @@ struct HfCandidateSelectorDplusToPiKPi {
   TrackSelectorPi selectorPion;
   TrackSelectorKa selectorKaon;
   HfTrigger3ProngCuts hfTriggerCuts;
+  HfPtBinColumn ptBins;            // pT bins of the candidates of the data frame
+  HfPidStatusColumn pidStatusPion; // pion PID status of the tracks of the data frame
+  HfPidStatusColumn pidStatusKaon; // kaon PID status of the tracks of the data frame
 
   using TracksSel = soa::Join<aod::TracksWExtra, aod::TracksPidPi, aod::PidTpcTofFullPi, aod::TracksPidKa, aod::PidTpcTofFullKa>;
 
@@ -147,15 +152,15 @@ struct HfCandidateSelectorDplusToPiKPi {
 
   /// Candidate selections
   /// \param candidate is candidate
+  /// \param pTBin is the pT bin of the candidate
   /// \param trackPion1 is the first track with the pion hypothesis
   /// \param trackKaon is the track with the kaon hypothesis
   /// \param trackPion2 is the second track with the pion hypothesis
   /// \return true if candidate passes all cuts
   template <typename T1, typename T2>
-  bool selection(const T1& candidate, const T2& trackPion1, const T2& trackKaon, const T2& trackPion2)
+  bool selection(const T1& candidate, const int pTBin, const T2& trackPion1, const T2& trackKaon, const T2& trackPion2)
   {
     auto ptCand = candidate.pt();
-    int const pTBin = findBin(binsPt, ptCand);
     if (pTBin == -1) {
       return false;
     }
@@ -231,10 +236,19 @@ struct HfCandidateSelectorDplusToPiKPi {
   }
 
   void process(aod::HfCand3ProngWPidPiKa const& candidates,
-               TracksSel const&)
+               TracksSel const& tracks)
   {
+    ptBins.fill(binsPt, candidates);
+    pidStatusPion.reset(tracks.size());
+    pidStatusKaon.reset(tracks.size());
+    auto statusPid = [this](auto& selector, const auto& track, float nSigmaTpc, float nSigmaTof) {
+      return usePidTpcAndTof ? selector.statusTpcAndTof(track, nSigmaTpc, nSigmaTof) : selector.statusTpcOrTof(track, nSigmaTpc, nSigmaTof);
+    };
+
     // looping over 3-prong candidates
+    std::size_t iCandidate = 0;
     for (const auto& candidate : candidates) {
+      const int pTBin = ptBins[iCandidate++];
 
       // final selection flag:
       auto statusDplusToPiKPi = 0;
@@ -261,7 +275,7 @@ struct HfCandidateSelectorDplusToPiKPi {
       auto trackPos2 = candidate.prong2_as<TracksSel>(); // positive daughter (negative for the antiparticles)
 
       // topological selection
-      if (!selection(candidate, trackPos1, trackNeg, trackPos2)) {
+      if (!selection(candidate, pTBin, trackPos1, trackNeg, trackPos2)) {
         hfSelDplusToPiKPiCandidate(statusDplusToPiKPi);
         if (applyMl) {
           hfMlDplusToPiKPiCandidate(outputMlNotPreselected);
@@ -273,20 +287,10 @@ struct HfCandidateSelectorDplusToPiKPi {
         registry.fill(HIST("hSelections"), 2 + aod::SelectionStep::RecoTopol, ptCand);
       }
 
-      // track-level PID selection
-      int pidTrackPos1Pion = -1;
-      int pidTrackNegKaon = -1;
-      int pidTrackPos2Pion = -1;
-
-      if (usePidTpcAndTof) {
-        pidTrackPos1Pion = selectorPion.statusTpcAndTof(trackPos1, candidate.nSigTpcPi0(), candidate.nSigTofPi0());
-        pidTrackNegKaon = selectorKaon.statusTpcAndTof(trackNeg, candidate.nSigTpcKa1(), candidate.nSigTofKa1());
-        pidTrackPos2Pion = selectorPion.statusTpcAndTof(trackPos2, candidate.nSigTpcPi2(), candidate.nSigTofPi2());
-      } else {
-        pidTrackPos1Pion = selectorPion.statusTpcOrTof(trackPos1, candidate.nSigTpcPi0(), candidate.nSigTofPi0());
-        pidTrackNegKaon = selectorKaon.statusTpcOrTof(trackNeg, candidate.nSigTpcKa1(), candidate.nSigTofKa1());
-        pidTrackPos2Pion = selectorPion.statusTpcOrTof(trackPos2, candidate.nSigTpcPi2(), candidate.nSigTofPi2());
-      }
+      // track-level PID selection, computed once per track of the data frame
+      int const pidTrackPos1Pion = pidStatusPion.get(trackPos1.globalIndex(), [&]() { return statusPid(selectorPion, trackPos1, candidate.nSigTpcPi0(), candidate.nSigTofPi0()); });
+      int const pidTrackNegKaon = pidStatusKaon.get(trackNeg.globalIndex(), [&]() { return statusPid(selectorKaon, trackNeg, candidate.nSigTpcKa1(), candidate.nSigTofKa1()); });
+      int const pidTrackPos2Pion = pidStatusPion.get(trackPos2.globalIndex(), [&]() { return statusPid(selectorPion, trackPos2, candidate.nSigTpcPi2(), candidate.nSigTofPi2()); });
 
       if (!selectionPID(pidTrackPos1Pion, pidTrackNegKaon, pidTrackPos2Pion)) { // exclude D±
         hfSelDplusToPiKPiCandidate(statusDplusToPiKPi);
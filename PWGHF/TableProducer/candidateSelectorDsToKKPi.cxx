@@ -23,6 +23,7 @@
 #include "PWGHF/DataModel/CandidateSelectionTables.h"
 #include "PWGHF/DataModel/TrackIndexSkimmingTables.h"
 #include "PWGHF/Utils/utilsAnalysis.h"
+#include "PWGHF/Utils/utilsSelectorHf.h"
 
 #include "Common/Core/TrackSelectorPID.h"
 
@@ -42,6 +43,7 @@
 
 #include <Rtypes.h>
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -103,6 +105,9 @@ struct HfCandidateSelectorDsToKKPi {
   TrackSelectorPi selectorPion;
   TrackSelectorKa selectorKaon;
   HfTrigger3ProngCuts hfTriggerCuts;
+  HfPtBinColumn ptBins;            // pT bins of the candidates of the data frame
+  HfPidStatusColumn pidStatusPion; // pion PID status of the tracks of the data frame
+  HfPidStatusColumn pidStatusKaon; // kaon PID status of the tracks of the data frame
 
   using TracksSel = soa::Join<aod::TracksWExtra, aod::TracksPidPi, aod::PidTpcTofFullPi, aod::TracksPidKa, aod::PidTpcTofFullKa>;
 
@@ -159,12 +164,12 @@ struct HfCandidateSelectorDsToKKPi {
 
   /// Candidate selections independent from the daugther-mass hypothesis
   /// \param candidate is candidate
+  /// \param pTBin is the pT bin of the candidate
   /// \return true if candidate passes all cuts
   template <typename T1>
-  bool selection(const T1& candidate)
+  bool selection(const T1& candidate, const int pTBin)
   {
     auto candpT = candidate.pt();
-    int const pTBin = findBin(binsPt, candpT);
     if (pTBin == -1) {
       return false;
     }
@@ -201,14 +206,14 @@ struct HfCandidateSelectorDsToKKPi {
 
   /// Candidate selections for the KKPi daugther-mass hypothesis
   /// \param candidate is candidate
+  /// \param pTBin is the pT bin of the candidate
   /// \param trackKaon1 is the first track with the kaon hypothesis
   /// \param trackKaon2 is the second track with the kaon hypothesis
   /// \param trackPion is the track with the pion hypothesis
   /// \return true if candidate passes all cuts
   template <typename T1, typename T2>
-  bool selectionKKPi(const T1& candidate, const T2& trackKaon1, const T2& trackKaon2, const T2& trackPion)
+  bool selectionKKPi(const T1& candidate, const int pTBin, const T2& trackKaon1, const T2& trackKaon2, const T2& trackPion)
   {
-    int const pTBin = findBin(binsPt, candidate.pt());
     if (pTBin == -1) {
       return false;
     }
@@ -233,14 +238,14 @@ struct HfCandidateSelectorDsToKKPi {
 
   /// Candidate selections for the PiKK daugther-mass hypothesis
   /// \param candidate is candidate
+  /// \param pTBin is the pT bin of the candidate
   /// \param trackPion is the track with the pion hypothesis
   /// \param trackKaon1 is the first track with the kaon hypothesis
   /// \param trackKaon2 is the second track with the kaon hypothesis
   /// \return true if candidate passes all cuts
   template <typename T1, typename T2>
-  bool selectionPiKK(const T1& candidate, const T2& trackPion, const T2& trackKaon1, const T2& trackKaon2)
+  bool selectionPiKK(const T1& candidate, const int pTBin, const T2& trackPion, const T2& trackKaon1, const T2& trackKaon2)
   {
-    int const pTBin = findBin(binsPt, candidate.pt());
     if (pTBin == -1) {
       return false;
     }
@@ -264,10 +269,19 @@ struct HfCandidateSelectorDsToKKPi {
   }
 
   void process(aod::HfCand3ProngWPidPiKa const& candidates,
-               TracksSel const&)
+               TracksSel const& tracks)
   {
+    ptBins.fill(binsPt, candidates);
+    pidStatusPion.reset(tracks.size());
+    pidStatusKaon.reset(tracks.size());
+    auto statusPid = [this](auto& selector, const auto& track, float nSigmaTpc, float nSigmaTof) {
+      return usePidTpcAndTof ? selector.statusTpcAndTof(track, nSigmaTpc, nSigmaTof) : selector.statusTpcOrTof(track, nSigmaTpc, nSigmaTof);
+    };
+
     // looping over 3-prong candidates
+    std::size_t iCandidate = 0;
     for (const auto& candidate : candidates) {
+      const int pTBin = ptBins[iCandidate++];
 
       // final selection flag:
       auto statusDsToKKPi = 0;
@@ -297,7 +311,7 @@ struct HfCandidateSelectorDsToKKPi {
       auto trackPos2 = candidate.prong2_as<TracksSel>(); // positive daughter (negative for the antiparticles)
 
       // topological selections
-      if (!selection(candidate)) {
+      if (!selection(candidate, pTBin)) {
         hfSelDsToKKPiCandidate(statusDsToKKPi, statusDsToPiKK);
         if (applyMl) {
           hfMlDsToKKPiCandidate(outputMlDsToKKPi, outputMlDsToPiKK);
@@ -305,8 +319,8 @@ struct HfCandidateSelectorDsToKKPi {
         continue;
       }
 
-      bool const topolDsToKKPi = selectionKKPi(candidate, trackPos1, trackNeg, trackPos2);
-      bool const topolDsToPiKK = selectionPiKK(candidate, trackPos1, trackNeg, trackPos2);
+      bool const topolDsToKKPi = selectionKKPi(candidate, pTBin, trackPos1, trackNeg, trackPos2);
+      bool const topolDsToPiKK = selectionPiKK(candidate, pTBin, trackPos1, trackNeg, trackPos2);
       if (!topolDsToKKPi && !topolDsToPiKK) {
         hfSelDsToKKPiCandidate(statusDsToKKPi, statusDsToPiKK);
         if (applyMl) {
@@ -324,26 +338,12 @@ struct HfCandidateSelectorDsToKKPi {
         registry.fill(HIST("hSelections"), 2 + aod::SelectionStep::RecoTopol, candidate.pt());
       }
 
-      // track-level PID selection
-      int pidTrackPos1Pion = -1;
-      int pidTrackPos1Kaon = -1;
-      int pidTrackPos2Pion = -1;
-      int pidTrackPos2Kaon = -1;
-      int pidTrackNegKaon = -1;
-
-      if (usePidTpcAndTof) {
-        pidTrackPos1Pion = selectorPion.statusTpcAndTof(trackPos1, candidate.nSigTpcPi0(), candidate.nSigTofPi0());
-        pidTrackPos1Kaon = selectorKaon.statusTpcAndTof(trackPos1, candidate.nSigTpcKa0(), candidate.nSigTofKa0());
-        pidTrackPos2Pion = selectorPion.statusTpcAndTof(trackPos2, candidate.nSigTpcPi2(), candidate.nSigTofPi2());
-        pidTrackPos2Kaon = selectorKaon.statusTpcAndTof(trackPos2, candidate.nSigTpcKa2(), candidate.nSigTofKa2());
-        pidTrackNegKaon = selectorKaon.statusTpcAndTof(trackNeg, candidate.nSigTpcKa1(), candidate.nSigTofKa1());
-      } else {
-        pidTrackPos1Pion = selectorPion.statusTpcOrTof(trackPos1, candidate.nSigTpcPi0(), candidate.nSigTofPi0());
-        pidTrackPos1Kaon = selectorKaon.statusTpcOrTof(trackPos1, candidate.nSigTpcKa0(), candidate.nSigTofKa0());
-        pidTrackPos2Pion = selectorPion.statusTpcOrTof(trackPos2, candidate.nSigTpcPi2(), candidate.nSigTofPi2());
-        pidTrackPos2Kaon = selectorKaon.statusTpcOrTof(trackPos2, candidate.nSigTpcKa2(), candidate.nSigTofKa2());
-        pidTrackNegKaon = selectorKaon.statusTpcOrTof(trackNeg, candidate.nSigTpcKa1(), candidate.nSigTofKa1());
-      }
+      // track-level PID selection, computed once per track of the data frame
+      int const pidTrackPos1Pion = pidStatusPion.get(trackPos1.globalIndex(), [&]() { return statusPid(selectorPion, trackPos1, candidate.nSigTpcPi0(), candidate.nSigTofPi0()); });
+      int const pidTrackPos1Kaon = pidStatusKaon.get(trackPos1.globalIndex(), [&]() { return statusPid(selectorKaon, trackPos1, candidate.nSigTpcKa0(), candidate.nSigTofKa0()); });
+      int const pidTrackPos2Pion = pidStatusPion.get(trackPos2.globalIndex(), [&]() { return statusPid(selectorPion, trackPos2, candidate.nSigTpcPi2(), candidate.nSigTofPi2()); });
+      int const pidTrackPos2Kaon = pidStatusKaon.get(trackPos2.globalIndex(), [&]() { return statusPid(selectorKaon, trackPos2, candidate.nSigTpcKa2(), candidate.nSigTofKa2()); });
+      int const pidTrackNegKaon = pidStatusKaon.get(trackNeg.globalIndex(), [&]() { return statusPid(selectorKaon, trackNeg, candidate.nSigTpcKa1(), candidate.nSigTofKa1()); });
 
       bool const pidDsToKKPi = pidTrackPos1Kaon != TrackSelectorPID::Rejected &&
                                pidTrackNegKaon != TrackSelectorPID::Rejected &&
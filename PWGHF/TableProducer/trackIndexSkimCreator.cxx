@@ -78,12 +78,17 @@
 
 #include <algorithm> // std::find
 #include <array>
+#include <atomic>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <functional>
 #include <iterator> // std::distance
 #include <numeric>
 #include <string>  // std::string
+#include <thread>
+#include <unordered_map>
 #include <utility> // std::forward
 #include <vector>  // std::vector
 
@@ -1398,6 +1403,7 @@ struct HfTrackIndexSkimCreator {
     Configurable<bool> debug{"debug", false, "debug mode"};
     Configurable<bool> debugPvRefit{"debugPvRefit", false, "debug lines for primary vertex refit"};
     Configurable<bool> fillHistograms{"fillHistograms", true, "fill histograms"};
+    Configurable<int> nThreadsVertexing{"nThreadsVertexing", 1, "number of threads reconstructing the 2- and 3-prong vertices of different collisions, each with its own fitters. 1: serial (always the case with PV refit or ML for HF filters)"};
     // Configurable<int> nCollsMax{"nCollsMax", -1, "Max collisions per file"}; //can be added to run over limited collisions per file - for tesing purposes
     // preselection
     Configurable<double> ptTolerance{"ptTolerance", 0.1, "pT tolerance in GeV/c for applying preselections before vertex reconstruction"};
@@ -1488,6 +1494,8 @@ struct HfTrackIndexSkimCreator {
   o2::base::MatLayerCylSet* lut{};
   o2::base::Propagator::MatCorrType noMatCorr = o2::base::Propagator::MatCorrType::USEMatCorrNONE;
   int runNumber{};
+  int lastFilledD0{-1}; // index to be filled in table for D* mesons
+  static constexpr std::size_t NCollisionsPerThreadInBlock = 16; // collisions per thread whose output is buffered at the same time in the multithreaded vertexing
 
   // int nColls{0}; //can be added to run over limited collisions per file - for tesing purposes
 
@@ -1504,6 +1512,7 @@ struct HfTrackIndexSkimCreator {
   std::array<std::vector<double>, kN2ProngDecays> binsPt2Prong{};
   std::array<LabeledArray<double>, kN3ProngDecays> cut3Prong{};
   std::array<std::vector<double>, kN3ProngDecays> binsPt3Prong{};
+  std::array<double, kN3ProngDecays> maxMass3Prong{}; // largest upper edge of the 3-prong mass preselection over the pT bins, negative if the mass is not preselected in at least one bin
 
   // ML response
   o2::analysis::MlResponse<float> hfMlResponse2Prongs;                               // only D0
@@ -1582,6 +1591,18 @@ struct HfTrackIndexSkimCreator {
     // cuts for 3-prong decays retrieved by json. the order must be then one in hf_cand_3prong::DecayType
     cut3Prong = {config.cutsDplusToPiKPi, config.cutsLcToPKPi, config.cutsDsToKKPi, config.cutsXicToPKPi, config.cutsCdToDeKPi, config.cutsCtToTrKPi, config.cutsChToHeKPi, config.cutsCaToAlKPi};
     binsPt3Prong = {config.binsPtDplusToPiKPi, config.binsPtLcToPKPi, config.binsPtDsToKKPi, config.binsPtXicToPKPi, config.binsPtCdToDeKPi, config.binsPtCtToTrKPi, config.binsPtChToHeKPi, config.binsPtCaToAlKPi};
+    for (int iDecay3P = 0; iDecay3P < kN3ProngDecays; iDecay3P++) {
+      maxMass3Prong[iDecay3P] = 0.;
+      for (std::size_t iBinPt = 0; iBinPt + 1 < binsPt3Prong[iDecay3P].size(); iBinPt++) {
+        const double minMass = cut3Prong[iDecay3P].get(iBinPt, 0u);
+        const double maxMass = cut3Prong[iDecay3P].get(iBinPt, 1u);
+        if (!(minMass >= 0. && maxMass > 0.)) {
+          maxMass3Prong[iDecay3P] = -1.;
+          break;
+        }
+        maxMass3Prong[iDecay3P] = std::max(maxMass3Prong[iDecay3P], maxMass);
+      }
+    }
 
     df2.setPropagateToPCA(config.propagateToPCA);
     df2.setMaxR(config.maxR);
@@ -1598,6 +1619,9 @@ struct HfTrackIndexSkimCreator {
     df3.setMinRelChi2Change(config.minRelChi2Change);
     df3.setUseAbsDCA(config.useAbsDCA);
     df3.setWeightedFinalPCA(config.useWeightedFinalPCA);
+    if (config.nThreadsVertexing > 1) {
+      LOGF(info, "Reconstructing the 2- and 3-prong vertices of different collisions with %d threads", config.nThreadsVertexing.value);
+    }
 
     ccdb->setURL(config.ccdbUrl);
     ccdb->setCaching(true);
@@ -1920,6 +1944,28 @@ struct HfTrackIndexSkimCreator {
     }
   }
 
+  /// Method to check, before looping over the third tracks, whether a pair of tracks can give any 3-prong candidate passing the mass preselection
+  /// The invariant mass of the triplet is larger than the one of the pair plus the mass of the third particle, whatever the third track is
+  /// \param pVecTrack0 is the momentum array of the first daughter track
+  /// \param pVecTrack1 is the momentum array of the second daughter track
+  /// \return false if no mass hypothesis of any 3-prong decay can be selected with this pair
+  template <typename T>
+  bool isPairCompatibleWith3ProngMasses(T const& pVecTrack0, T const& pVecTrack1)
+  {
+    for (int iDecay3P = 0; iDecay3P < kN3ProngDecays; iDecay3P++) {
+      if (maxMass3Prong[iDecay3P] < 0.) {
+        return true;
+      }
+      for (const auto& masses : arrMass3Prong[iDecay3P]) {
+        const double minMassTriplet = std::sqrt(RecoDecay::m2(std::array{pVecTrack0, pVecTrack1}, std::array{masses[0], masses[1]})) + masses[2];
+        if (minMassTriplet < maxMass3Prong[iDecay3P]) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
   /// Method to perform selections for 2-prong candidates after vertex reconstruction
   /// \param pVecCand is the array for the candidate momentum after reconstruction of secondary vertex
   /// \param secVtx is the secondary vertex
@@ -2287,6 +2333,19 @@ struct HfTrackIndexSkimCreator {
 
   } /// end of performPvRefitCandProngs function
 
+  /// Fills the output (table rows, histograms) of a candidate, right away or, for the multithreaded vertexing, once the previous collisions are written
+  /// \param deferredOutput buffer of the output of the collision, nullptr to fill it right away
+  /// \param fill function filling the output
+  template <typename TFunc>
+  static void writeOutput(std::vector<std::function<void()>>* deferredOutput, TFunc&& fill)
+  {
+    if (deferredOutput != nullptr) {
+      deferredOutput->emplace_back(std::forward<TFunc>(fill));
+    } else {
+      fill();
+    }
+  }
+
   template <bool DoPvRefit, bool UsePidForHfFiltersBdt, typename TTracks>
   void run2And3Prongs(SelectedCollisions const& collisions,
                       aod::BCsWithTimestamps const& bcWithTimeStamps,
@@ -2305,7 +2364,9 @@ struct HfTrackIndexSkimCreator {
     }
     */
 
-    for (const auto& collision : collisions) {
+    // vertexing of the candidates of one collision with the given fitters. The histograms and the table rows are filled via writeOutput
+    auto processCollision = [&](const auto& collision, const auto& groupedTrackIndicesPos1, const auto& groupedTrackIndicesNeg1, const auto& groupedTrackIndicesSoftPionsPos, const auto& groupedTrackIndicesSoftPionsNeg,
+                                o2::vertexing::DCAFitterN<2>& fitter2, o2::vertexing::DCAFitterN<3>& fitter3, std::vector<std::function<void()>>* deferredOutput) {
 
       /// retrieve PV contributors for the current collision
       std::vector<int64_t> vecPvContributorGlobId{};
@@ -2361,15 +2422,9 @@ struct HfTrackIndexSkimCreator {
       int whichHypo2Prong[kN2ProngDecays + 1]; // we also put D0 for D* in the last slot
       int whichHypo3Prong[kN3ProngDecays];
 
-      // set the magnetic field from CCDB
-      const auto bc = collision.bc_as<o2::aod::BCsWithTimestamps>();
-      initCCDB(bc, runNumber, ccdb, config.isRun2 ? config.ccdbPathGrp : config.ccdbPathGrpMag, lut, config.isRun2);
-      df2.setBz(o2::base::Propagator::Instance()->getNominalBz());
-      df3.setBz(o2::base::Propagator::Instance()->getNominalBz());
-
       // used to calculate number of candidiates per event
-      auto nCand2 = rowTrackIndexProng2.lastIndex();
-      auto nCand3 = rowTrackIndexProng3.lastIndex();
+      int nCand2{0};
+      int nCand3{0};
 
       // if there isn't at least a positive and a negative track, continue immediately
       // if (tracksPos.size() < 1 || tracksNeg.size() < 1) {
@@ -2378,9 +2433,20 @@ struct HfTrackIndexSkimCreator {
 
       const auto thisCollId = collision.globalIndex();
 
+      // Tracks associated to this collision but not assigned to it are propagated to its vertex once, at the first request,
+      // instead of once per combination they enter
+      std::unordered_map<int64_t, std::pair<o2::track::TrackParCov, std::array<float, 2>>> tracksPropagatedToThisCollision{};
+      auto propagateToThisCollision = [&](const auto& track, o2::track::TrackParCov& trackParVar, std::array<float, 2>& dcaInfo, std::array<float, 3>& pVecTrack) {
+        auto [propagatedTrack, isNew] = tracksPropagatedToThisCollision.try_emplace(track.globalIndex(), trackParVar, dcaInfo);
+        if (isNew) {
+          o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, propagatedTrack->second.first, 2.f, noMatCorr, &propagatedTrack->second.second);
+        }
+        trackParVar = propagatedTrack->second.first;
+        dcaInfo = propagatedTrack->second.second;
+        getPxPyPz(trackParVar, pVecTrack);
+      };
+
       // first loop over positive tracks
-      const auto groupedTrackIndicesPos1 = positiveFor2And3Prongs->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache);
-      int lastFilledD0 = -1; // index to be filled in table for D* mesons
       for (auto trackIndexPos1 = groupedTrackIndicesPos1.begin(); trackIndexPos1 != groupedTrackIndicesPos1.end(); ++trackIndexPos1) {
         const auto trackPos1 = trackIndexPos1.template track_as<TTracks>();
 
@@ -2393,12 +2459,10 @@ struct HfTrackIndexSkimCreator {
         std::array pVecTrackPos1{trackPos1.pVector()};
         std::array dcaInfoPos1{trackPos1.dcaXY(), trackPos1.dcaZ()};
         if (thisCollId != trackPos1.collisionId()) { // this is not the "default" collision for this track, we have to re-propagate it
-          o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParVarPos1, 2.f, noMatCorr, &dcaInfoPos1);
-          getPxPyPz(trackParVarPos1, pVecTrackPos1);
+          propagateToThisCollision(trackPos1, trackParVarPos1, dcaInfoPos1, pVecTrackPos1);
         }
 
         // first loop over negative tracks
-        const auto groupedTrackIndicesNeg1 = negativeFor2And3Prongs->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache);
         for (auto trackIndexNeg1 = groupedTrackIndicesNeg1.begin(); trackIndexNeg1 != groupedTrackIndicesNeg1.end(); ++trackIndexNeg1) {
           const auto trackNeg1 = trackIndexNeg1.template track_as<TTracks>();
 
@@ -2411,8 +2475,7 @@ struct HfTrackIndexSkimCreator {
           std::array pVecTrackNeg1{trackNeg1.pVector()};
           std::array dcaInfoNeg1{trackNeg1.dcaXY(), trackNeg1.dcaZ()};
           if (thisCollId != trackNeg1.collisionId()) { // this is not the "default" collision for this track, we have to re-propagate it
-            o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParVarNeg1, 2.f, noMatCorr, &dcaInfoNeg1);
-            getPxPyPz(trackParVarNeg1, pVecTrackNeg1);
+            propagateToThisCollision(trackNeg1, trackParVarNeg1, dcaInfoNeg1, pVecTrackNeg1);
           }
 
           uint isSelected2ProngCand = n2ProngBit; // bitmap for checking status of two-prong candidates (1 is true, 0 is rejected)
@@ -2432,6 +2495,13 @@ struct HfTrackIndexSkimCreator {
           // 2-prong vertex reconstruction
           float pt2Prong{-1.};
           bool is2ProngCandidateGoodFor3Prong{sel3ProngStatusPos1 && sel3ProngStatusNeg1};
+          // pair stage of the 3-prong preselection, for the two loops over the third track (+-+ and -+-): cheap checks not depending on the third track
+          bool isPairGoodFor3ProngPos{true}, isPairGoodFor3ProngNeg{true};
+          if (config.do3Prong && is2ProngCandidateGoodFor3Prong && !config.debug) {
+            isPairGoodFor3ProngPos = (!config.applyKaonPidIn3Prongs || TESTBIT(trackIndexNeg1.isIdentifiedPid(), ChannelKaonPid)) && isPairCompatibleWith3ProngMasses(pVecTrackPos1, pVecTrackNeg1);
+            isPairGoodFor3ProngNeg = (!config.applyKaonPidIn3Prongs || TESTBIT(trackIndexPos1.isIdentifiedPid(), ChannelKaonPid)) && isPairCompatibleWith3ProngMasses(pVecTrackNeg1, pVecTrackPos1);
+            is2ProngCandidateGoodFor3Prong = isPairGoodFor3ProngPos || isPairGoodFor3ProngNeg;
+          }
           int nVtxFrom2ProngFitter = 0;
           if (sel2ProngStatusPos && sel2ProngStatusNeg) {
 
@@ -2442,18 +2512,18 @@ struct HfTrackIndexSkimCreator {
             if (isSelected2ProngCand > 0) {
               // secondary vertex reconstruction and further 2-prong selections
               try {
-                nVtxFrom2ProngFitter = df2.process(trackParVarPos1, trackParVarNeg1);
+                nVtxFrom2ProngFitter = fitter2.process(trackParVarPos1, trackParVarNeg1);
               } catch (...) {
               }
 
               if (nVtxFrom2ProngFitter > 0) { // should it be this or > 0 or are they equivalent
                 // get secondary vertex
-                const auto& secondaryVertex2 = df2.getPCACandidate();
+                const auto& secondaryVertex2 = fitter2.getPCACandidate();
                 // get track momenta
                 std::array<float, 3> pvec0{};
                 std::array<float, 3> pvec1{};
-                df2.getTrack(0).getPxPyPzGlo(pvec0);
-                df2.getTrack(1).getPxPyPzGlo(pvec1);
+                fitter2.getTrack(0).getPxPyPzGlo(pvec0);
+                fitter2.getTrack(1).getPxPyPzGlo(pvec1);
 
                 /// PV refit excluding the candidate daughters, if contributors
                 if constexpr (DoPvRefit) {
@@ -2525,35 +2595,21 @@ struct HfTrackIndexSkimCreator {
                 }
                 applySelection2Prong(pVecCandProng2, secondaryVertex2, pvCoord2Prong, cutStatus2Prong, isSelected2ProngCand);
                 if (is2ProngCandidateGoodFor3Prong && config.do3Prong) {
-                  is2ProngCandidateGoodFor3Prong = isTwoTrackVertexSelectedFor3Prongs(secondaryVertex2, pvCoord2Prong, df2);
+                  is2ProngCandidateGoodFor3Prong = isTwoTrackVertexSelectedFor3Prongs(secondaryVertex2, pvCoord2Prong, fitter2);
                 }
 
                 std::vector<float> mlScoresD0{};
                 if (config.applyMlForHfFilters) {
-                  const auto trackParVarPcaPos1 = df2.getTrack(0);
-                  const auto trackParVarPcaNeg1 = df2.getTrack(1);
+                  const auto trackParVarPcaPos1 = fitter2.getTrack(0);
+                  const auto trackParVarPcaNeg1 = fitter2.getTrack(1);
                   const std::vector<float> inputFeatures{trackParVarPcaPos1.getPt(), dcaInfoPos1[0], dcaInfoPos1[1], trackParVarPcaNeg1.getPt(), dcaInfoNeg1[0], dcaInfoNeg1[1]};
                   applyMlSelectionForHfFilters2Prong(inputFeatures, mlScoresD0, isSelected2ProngCand);
                 }
 
                 if (isSelected2ProngCand > 0) {
-                  // fill table row
-                  rowTrackIndexProng2(thisCollId, trackPos1.globalIndex(), trackNeg1.globalIndex(), isSelected2ProngCand);
-                  if (config.applyMlForHfFilters) {
-                    rowTrackIndexMlScoreProng2(mlScoresD0);
-                  }
-                  if (TESTBIT(isSelected2ProngCand, hf_cand_2prong::DecayType::D0ToPiK)) {
-                    lastFilledD0 = rowTrackIndexProng2.lastIndex();
-                  }
-
-                  if constexpr (DoPvRefit) {
-                    // fill table row with coordinates of PV refit
-                    rowProng2PVrefit(pvRefitCoord2Prong[0], pvRefitCoord2Prong[1], pvRefitCoord2Prong[2],
-                                     pvRefitCovMatrix2Prong[0], pvRefitCovMatrix2Prong[1], pvRefitCovMatrix2Prong[2], pvRefitCovMatrix2Prong[3], pvRefitCovMatrix2Prong[4], pvRefitCovMatrix2Prong[5]);
-                  }
-
+                  nCand2++;
+                  std::array<uint8_t, kN2ProngDecays> prong2CutStatus{};
                   if (config.debug) {
-                    uint8_t prong2CutStatus[kN2ProngDecays];
                     for (int iDecay2P = 0; iDecay2P < kN2ProngDecays; iDecay2P++) {
                       prong2CutStatus[iDecay2P] = nCutStatus2ProngBit[iDecay2P];
                       for (int iCut = 0; iCut < kNCuts2Prong[iDecay2P]; iCut++) {
@@ -2562,40 +2618,59 @@ struct HfTrackIndexSkimCreator {
                         }
                       }
                     }
-                    rowProng2CutStatus(prong2CutStatus[0], prong2CutStatus[1], prong2CutStatus[2]); // FIXME when we can do this by looping over kN2ProngDecays
                   }
+                  writeOutput(deferredOutput, [=, this, globalIndexPos1 = trackPos1.globalIndex(), globalIndexNeg1 = trackNeg1.globalIndex()]() {
+                    // fill table row
+                    rowTrackIndexProng2(thisCollId, globalIndexPos1, globalIndexNeg1, isSelected2ProngCand);
+                    if (config.applyMlForHfFilters) {
+                      rowTrackIndexMlScoreProng2(mlScoresD0);
+                    }
+                    if (TESTBIT(isSelected2ProngCand, hf_cand_2prong::DecayType::D0ToPiK)) {
+                      lastFilledD0 = rowTrackIndexProng2.lastIndex();
+                    }
 
-                  // fill histograms
-                  if (config.fillHistograms) {
-                    registry.fill(HIST("hVtx2ProngX"), secondaryVertex2[0]);
-                    registry.fill(HIST("hVtx2ProngY"), secondaryVertex2[1]);
-                    registry.fill(HIST("hVtx2ProngZ"), secondaryVertex2[2]);
-                    const std::array arrMom{pvec0, pvec1};
-                    for (int iDecay2P = 0; iDecay2P < kN2ProngDecays; iDecay2P++) {
-                      if (TESTBIT(isSelected2ProngCand, iDecay2P)) {
-                        if (TESTBIT(whichHypo2Prong[iDecay2P], 0)) {
-                          const auto mass2Prong = RecoDecay::m(arrMom, arrMass2Prong[iDecay2P][0]);
-                          switch (iDecay2P) {
-                            case hf_cand_2prong::DecayType::D0ToPiK:
-                              registry.fill(HIST("hMassD0ToPiK"), mass2Prong);
-                              break;
-                            case hf_cand_2prong::DecayType::JpsiToEE:
-                              registry.fill(HIST("hMassJpsiToEE"), mass2Prong);
-                              break;
-                            case hf_cand_2prong::DecayType::JpsiToMuMu:
-                              registry.fill(HIST("hMassJpsiToMuMu"), mass2Prong);
-                              break;
+                    if constexpr (DoPvRefit) {
+                      // fill table row with coordinates of PV refit
+                      rowProng2PVrefit(pvRefitCoord2Prong[0], pvRefitCoord2Prong[1], pvRefitCoord2Prong[2],
+                                       pvRefitCovMatrix2Prong[0], pvRefitCovMatrix2Prong[1], pvRefitCovMatrix2Prong[2], pvRefitCovMatrix2Prong[3], pvRefitCovMatrix2Prong[4], pvRefitCovMatrix2Prong[5]);
+                    }
+
+                    if (config.debug) {
+                      rowProng2CutStatus(prong2CutStatus[0], prong2CutStatus[1], prong2CutStatus[2]); // FIXME when we can do this by looping over kN2ProngDecays
+                    }
+
+                    // fill histograms
+                    if (config.fillHistograms) {
+                      registry.fill(HIST("hVtx2ProngX"), secondaryVertex2[0]);
+                      registry.fill(HIST("hVtx2ProngY"), secondaryVertex2[1]);
+                      registry.fill(HIST("hVtx2ProngZ"), secondaryVertex2[2]);
+                      const std::array arrMom{pvec0, pvec1};
+                      for (int iDecay2P = 0; iDecay2P < kN2ProngDecays; iDecay2P++) {
+                        if (TESTBIT(isSelected2ProngCand, iDecay2P)) {
+                          if (TESTBIT(whichHypo2Prong[iDecay2P], 0)) {
+                            const auto mass2Prong = RecoDecay::m(arrMom, arrMass2Prong[iDecay2P][0]);
+                            switch (iDecay2P) {
+                              case hf_cand_2prong::DecayType::D0ToPiK:
+                                registry.fill(HIST("hMassD0ToPiK"), mass2Prong);
+                                break;
+                              case hf_cand_2prong::DecayType::JpsiToEE:
+                                registry.fill(HIST("hMassJpsiToEE"), mass2Prong);
+                                break;
+                              case hf_cand_2prong::DecayType::JpsiToMuMu:
+                                registry.fill(HIST("hMassJpsiToMuMu"), mass2Prong);
+                                break;
+                            }
                           }
-                        }
-                        if (TESTBIT(whichHypo2Prong[iDecay2P], 1)) {
-                          const auto mass2Prong = RecoDecay::m(arrMom, arrMass2Prong[iDecay2P][1]);
-                          if (iDecay2P == hf_cand_2prong::DecayType::D0ToPiK) {
-                            registry.fill(HIST("hMassD0ToPiK"), mass2Prong);
+                          if (TESTBIT(whichHypo2Prong[iDecay2P], 1)) {
+                            const auto mass2Prong = RecoDecay::m(arrMom, arrMass2Prong[iDecay2P][1]);
+                            if (iDecay2P == hf_cand_2prong::DecayType::D0ToPiK) {
+                              registry.fill(HIST("hMassD0ToPiK"), mass2Prong);
+                            }
                           }
                         }
                       }
                     }
-                  }
+                  });
                 }
               } else {
                 isSelected2ProngCand = 0; // reset to 0 not to use the D0 to build a D* meson
@@ -2608,13 +2683,13 @@ struct HfTrackIndexSkimCreator {
           // if the cut on the decay length of 3-prongs computed with the first two tracks is enabled and the vertex was not computed for the D0, we compute it now
           if (config.do3Prong && is2ProngCandidateGoodFor3Prong && (config.minTwoTrackDecayLengthFor3Prongs > 0.f || config.maxTwoTrackChi2PcaFor3Prongs < 1.e9f) && nVtxFrom2ProngFitter == 0) { // o2-linter: disable="magic-number" (default maxTwoTrackChi2PcaFor3Prongs is 1.e10)
             try {
-              nVtxFrom2ProngFitter = df2.process(trackParVarPos1, trackParVarNeg1);
+              nVtxFrom2ProngFitter = fitter2.process(trackParVarPos1, trackParVarNeg1);
             } catch (...) {
             }
             if (nVtxFrom2ProngFitter > 0) {
-              const auto& secondaryVertex2 = df2.getPCACandidate();
+              const auto& secondaryVertex2 = fitter2.getPCACandidate();
               const std::array pvCoord2Prong{collision.posX(), collision.posY(), collision.posZ()};
-              is2ProngCandidateGoodFor3Prong = isTwoTrackVertexSelectedFor3Prongs(secondaryVertex2, pvCoord2Prong, df2);
+              is2ProngCandidateGoodFor3Prong = isTwoTrackVertexSelectedFor3Prongs(secondaryVertex2, pvCoord2Prong, fitter2);
             } else {
               is2ProngCandidateGoodFor3Prong = false;
             }
@@ -2623,6 +2698,9 @@ struct HfTrackIndexSkimCreator {
           if (config.do3Prong && is2ProngCandidateGoodFor3Prong) { // if 3 prongs are enabled and the first 2 tracks are selected for the 3-prong channels
             // second loop over positive tracks
             for (auto trackIndexPos2 = trackIndexPos1 + 1; trackIndexPos2 != groupedTrackIndicesPos1.end(); ++trackIndexPos2) {
+              if (!isPairGoodFor3ProngPos) {
+                break; // no third track can give a selected candidate with this pair
+              }
 
               uint isSelected3ProngCand = n3ProngBit;
               if (!TESTBIT(trackIndexPos2.isSelProng(), CandidateType::Cand3Prong)) { // continue immediately
@@ -2648,8 +2726,7 @@ struct HfTrackIndexSkimCreator {
               if (isSelected3ProngCand) {
                 std::array pVecTrackPos2{trackPos2.pVector()};
                 if (thisCollId != trackPos2.collisionId()) { // this is not the "default" collision for this track and we still did not re-propagate it, we have to re-propagate it
-                  o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParVarPos2, 2.f, noMatCorr, &dcaInfoPos2);
-                  getPxPyPz(trackParVarPos2, pVecTrackPos2);
+                  propagateToThisCollision(trackPos2, trackParVarPos2, dcaInfoPos2, pVecTrackPos2);
                 }
 
                 if (config.debug) {
@@ -2761,7 +2838,7 @@ struct HfTrackIndexSkimCreator {
               // reconstruct the 3-prong secondary vertex
               int nVtxFrom3ProngFitter = 0;
               try {
-                nVtxFrom3ProngFitter = df3.process(trackParVarPos1, trackParVarNeg1, trackParVarPos2);
+                nVtxFrom3ProngFitter = fitter3.process(trackParVarPos1, trackParVarNeg1, trackParVarPos2);
               } catch (...) {
                 continue;
               }
@@ -2770,14 +2847,14 @@ struct HfTrackIndexSkimCreator {
                 continue;
               }
               // get secondary vertex
-              const auto& secondaryVertex3 = df3.getPCACandidate();
+              const auto& secondaryVertex3 = fitter3.getPCACandidate();
               // get track momenta
               std::array<float, 3> pvec0{};
               std::array<float, 3> pvec1{};
               std::array<float, 3> pvec2{};
-              const auto trackParVarPcaPos1 = df3.getTrack(0);
-              const auto trackParVarPcaNeg1 = df3.getTrack(1);
-              const auto trackParVarPcaPos2 = df3.getTrack(2);
+              const auto trackParVarPcaPos1 = fitter3.getTrack(0);
+              const auto trackParVarPcaNeg1 = fitter3.getTrack(1);
+              const auto trackParVarPcaPos2 = fitter3.getTrack(2);
               trackParVarPcaPos1.getPxPyPzGlo(pvec0);
               trackParVarPcaNeg1.getPxPyPzGlo(pvec1);
               trackParVarPcaPos2.getPxPyPzGlo(pvec2);
@@ -2804,19 +2881,9 @@ struct HfTrackIndexSkimCreator {
                 continue;
               }
 
-              // fill table row
-              rowTrackIndexProng3(thisCollId, trackPos1.globalIndex(), trackNeg1.globalIndex(), trackPos2.globalIndex(), isSelected3ProngCand);
-              if (config.applyMlForHfFilters) {
-                rowTrackIndexMlScoreProng3(mlScores3Prongs[0], mlScores3Prongs[1], mlScores3Prongs[2], mlScores3Prongs[3]);
-              }
-              if constexpr (DoPvRefit) {
-                // fill table row of coordinates of PV refit
-                rowProng3PVrefit(pvRefitCoord3Prong2Pos1Neg[0], pvRefitCoord3Prong2Pos1Neg[1], pvRefitCoord3Prong2Pos1Neg[2],
-                                 pvRefitCovMatrix3Prong2Pos1Neg[0], pvRefitCovMatrix3Prong2Pos1Neg[1], pvRefitCovMatrix3Prong2Pos1Neg[2], pvRefitCovMatrix3Prong2Pos1Neg[3], pvRefitCovMatrix3Prong2Pos1Neg[4], pvRefitCovMatrix3Prong2Pos1Neg[5]);
-              }
-
+              nCand3++;
+              std::array<uint8_t, kN3ProngDecays> prong3CutStatus{};
               if (config.debug) {
-                uint8_t prong3CutStatus[kN3ProngDecays];
                 for (int iDecay3P = 0; iDecay3P < kN3ProngDecays; iDecay3P++) {
                   prong3CutStatus[iDecay3P] = nCutStatus3ProngBit[iDecay3P];
                   for (int iCut = 0; iCut < kNCuts3Prong[iDecay3P]; iCut++) {
@@ -2825,79 +2892,97 @@ struct HfTrackIndexSkimCreator {
                     }
                   }
                 }
-                rowProng3CutStatus(prong3CutStatus[0], prong3CutStatus[1], prong3CutStatus[2], prong3CutStatus[3]); // FIXME when we can do this by looping over kN3ProngDecays
               }
+              writeOutput(deferredOutput, [=, this, globalIndexPos1 = trackPos1.globalIndex(), globalIndexNeg1 = trackNeg1.globalIndex(), globalIndexPos2 = trackPos2.globalIndex()]() {
+                // fill table row
+                rowTrackIndexProng3(thisCollId, globalIndexPos1, globalIndexNeg1, globalIndexPos2, isSelected3ProngCand);
+                if (config.applyMlForHfFilters) {
+                  rowTrackIndexMlScoreProng3(mlScores3Prongs[0], mlScores3Prongs[1], mlScores3Prongs[2], mlScores3Prongs[3]);
+                }
+                if constexpr (DoPvRefit) {
+                  // fill table row of coordinates of PV refit
+                  rowProng3PVrefit(pvRefitCoord3Prong2Pos1Neg[0], pvRefitCoord3Prong2Pos1Neg[1], pvRefitCoord3Prong2Pos1Neg[2],
+                                   pvRefitCovMatrix3Prong2Pos1Neg[0], pvRefitCovMatrix3Prong2Pos1Neg[1], pvRefitCovMatrix3Prong2Pos1Neg[2], pvRefitCovMatrix3Prong2Pos1Neg[3], pvRefitCovMatrix3Prong2Pos1Neg[4], pvRefitCovMatrix3Prong2Pos1Neg[5]);
+                }
 
-              // fill histograms
-              if (config.fillHistograms) {
-                registry.fill(HIST("hVtx3ProngX"), secondaryVertex3[0]);
-                registry.fill(HIST("hVtx3ProngY"), secondaryVertex3[1]);
-                registry.fill(HIST("hVtx3ProngZ"), secondaryVertex3[2]);
-                const std::array arr3Mom{pvec0, pvec1, pvec2};
-                for (int iDecay3P = 0; iDecay3P < kN3ProngDecays; iDecay3P++) {
-                  if (TESTBIT(isSelected3ProngCand, iDecay3P)) {
-                    if (TESTBIT(whichHypo3Prong[iDecay3P], 0)) {
-                      const auto mass3Prong = RecoDecay::m(arr3Mom, arrMass3Prong[iDecay3P][0]);
-                      switch (iDecay3P) {
-                        case hf_cand_3prong::DecayType::DplusToPiKPi:
-                          registry.fill(HIST("hMassDPlusToPiKPi"), mass3Prong);
-                          break;
-                        case hf_cand_3prong::DecayType::DsToKKPi:
-                          registry.fill(HIST("hMassDsToKKPi"), mass3Prong);
-                          break;
-                        case hf_cand_3prong::DecayType::LcToPKPi:
-                          registry.fill(HIST("hMassLcToPKPi"), mass3Prong);
-                          break;
-                        case hf_cand_3prong::DecayType::XicToPKPi:
-                          registry.fill(HIST("hMassXicToPKPi"), mass3Prong);
-                          break;
-                        case hf_cand_3prong::DecayType::CdToDeKPi:
-                          registry.fill(HIST("hMassCdToDeKPi"), mass3Prong);
-                          break;
-                        case hf_cand_3prong::DecayType::CtToTrKPi:
-                          registry.fill(HIST("hMassCtToTrKPi"), mass3Prong);
-                          break;
-                        case hf_cand_3prong::DecayType::ChToHeKPi:
-                          registry.fill(HIST("hMassChToHeKPi"), mass3Prong);
-                          break;
-                        case hf_cand_3prong::DecayType::CaToAlKPi:
-                          registry.fill(HIST("hMassCaToAlKPi"), mass3Prong);
-                          break;
+                if (config.debug) {
+                  rowProng3CutStatus(prong3CutStatus[0], prong3CutStatus[1], prong3CutStatus[2], prong3CutStatus[3]); // FIXME when we can do this by looping over kN3ProngDecays
+                }
+
+                // fill histograms
+                if (config.fillHistograms) {
+                  registry.fill(HIST("hVtx3ProngX"), secondaryVertex3[0]);
+                  registry.fill(HIST("hVtx3ProngY"), secondaryVertex3[1]);
+                  registry.fill(HIST("hVtx3ProngZ"), secondaryVertex3[2]);
+                  const std::array arr3Mom{pvec0, pvec1, pvec2};
+                  for (int iDecay3P = 0; iDecay3P < kN3ProngDecays; iDecay3P++) {
+                    if (TESTBIT(isSelected3ProngCand, iDecay3P)) {
+                      if (TESTBIT(whichHypo3Prong[iDecay3P], 0)) {
+                        const auto mass3Prong = RecoDecay::m(arr3Mom, arrMass3Prong[iDecay3P][0]);
+                        switch (iDecay3P) {
+                          case hf_cand_3prong::DecayType::DplusToPiKPi:
+                            registry.fill(HIST("hMassDPlusToPiKPi"), mass3Prong);
+                            break;
+                          case hf_cand_3prong::DecayType::DsToKKPi:
+                            registry.fill(HIST("hMassDsToKKPi"), mass3Prong);
+                            break;
+                          case hf_cand_3prong::DecayType::LcToPKPi:
+                            registry.fill(HIST("hMassLcToPKPi"), mass3Prong);
+                            break;
+                          case hf_cand_3prong::DecayType::XicToPKPi:
+                            registry.fill(HIST("hMassXicToPKPi"), mass3Prong);
+                            break;
+                          case hf_cand_3prong::DecayType::CdToDeKPi:
+                            registry.fill(HIST("hMassCdToDeKPi"), mass3Prong);
+                            break;
+                          case hf_cand_3prong::DecayType::CtToTrKPi:
+                            registry.fill(HIST("hMassCtToTrKPi"), mass3Prong);
+                            break;
+                          case hf_cand_3prong::DecayType::ChToHeKPi:
+                            registry.fill(HIST("hMassChToHeKPi"), mass3Prong);
+                            break;
+                          case hf_cand_3prong::DecayType::CaToAlKPi:
+                            registry.fill(HIST("hMassCaToAlKPi"), mass3Prong);
+                            break;
+                        }
                       }
-                    }
-                    if (TESTBIT(whichHypo3Prong[iDecay3P], 1)) {
-                      const auto mass3Prong = RecoDecay::m(arr3Mom, arrMass3Prong[iDecay3P][1]);
-                      switch (iDecay3P) {
-                        case hf_cand_3prong::DecayType::DsToKKPi:
-                          registry.fill(HIST("hMassDsToKKPi"), mass3Prong);
-                          break;
-                        case hf_cand_3prong::DecayType::LcToPKPi:
-                          registry.fill(HIST("hMassLcToPKPi"), mass3Prong);
-                          break;
-                        case hf_cand_3prong::DecayType::XicToPKPi:
-                          registry.fill(HIST("hMassXicToPKPi"), mass3Prong);
-                          break;
-                        case hf_cand_3prong::DecayType::CdToDeKPi:
-                          registry.fill(HIST("hMassCdToDeKPi"), mass3Prong);
-                          break;
-                        case hf_cand_3prong::DecayType::CtToTrKPi:
-                          registry.fill(HIST("hMassCtToTrKPi"), mass3Prong);
-                          break;
-                        case hf_cand_3prong::DecayType::ChToHeKPi:
-                          registry.fill(HIST("hMassChToHeKPi"), mass3Prong);
-                          break;
-                        case hf_cand_3prong::DecayType::CaToAlKPi:
-                          registry.fill(HIST("hMassCaToAlKPi"), mass3Prong);
-                          break;
+                      if (TESTBIT(whichHypo3Prong[iDecay3P], 1)) {
+                        const auto mass3Prong = RecoDecay::m(arr3Mom, arrMass3Prong[iDecay3P][1]);
+                        switch (iDecay3P) {
+                          case hf_cand_3prong::DecayType::DsToKKPi:
+                            registry.fill(HIST("hMassDsToKKPi"), mass3Prong);
+                            break;
+                          case hf_cand_3prong::DecayType::LcToPKPi:
+                            registry.fill(HIST("hMassLcToPKPi"), mass3Prong);
+                            break;
+                          case hf_cand_3prong::DecayType::XicToPKPi:
+                            registry.fill(HIST("hMassXicToPKPi"), mass3Prong);
+                            break;
+                          case hf_cand_3prong::DecayType::CdToDeKPi:
+                            registry.fill(HIST("hMassCdToDeKPi"), mass3Prong);
+                            break;
+                          case hf_cand_3prong::DecayType::CtToTrKPi:
+                            registry.fill(HIST("hMassCtToTrKPi"), mass3Prong);
+                            break;
+                          case hf_cand_3prong::DecayType::ChToHeKPi:
+                            registry.fill(HIST("hMassChToHeKPi"), mass3Prong);
+                            break;
+                          case hf_cand_3prong::DecayType::CaToAlKPi:
+                            registry.fill(HIST("hMassCaToAlKPi"), mass3Prong);
+                            break;
+                        }
                       }
                     }
                   }
                 }
-              }
+              });
             }
 
             // second loop over negative tracks
             for (auto trackIndexNeg2 = trackIndexNeg1 + 1; trackIndexNeg2 != groupedTrackIndicesNeg1.end(); ++trackIndexNeg2) {
+              if (!isPairGoodFor3ProngNeg) {
+                break; // no third track can give a selected candidate with this pair
+              }
 
               int isSelected3ProngCand = n3ProngBit;
               if (!TESTBIT(trackIndexNeg2.isSelProng(), CandidateType::Cand3Prong)) { // continue immediately
@@ -2922,8 +3007,7 @@ struct HfTrackIndexSkimCreator {
               if (isSelected3ProngCand) {
                 std::array pVecTrackNeg2{trackNeg2.pVector()};
                 if (thisCollId != trackNeg2.collisionId()) { // this is not the "default" collision for this track and we still did not re-propagate it, we have to re-propagate it
-                  o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParVarNeg2, 2.f, noMatCorr, &dcaInfoNeg2);
-                  getPxPyPz(trackParVarNeg2, pVecTrackNeg2);
+                  propagateToThisCollision(trackNeg2, trackParVarNeg2, dcaInfoNeg2, pVecTrackNeg2);
                 }
 
                 if (config.debug) {
@@ -3035,7 +3119,7 @@ struct HfTrackIndexSkimCreator {
               // reconstruct the 3-prong secondary vertex
               int nVtxFrom3ProngFitterSecondLoop = 0;
               try {
-                nVtxFrom3ProngFitterSecondLoop = df3.process(trackParVarNeg1, trackParVarPos1, trackParVarNeg2);
+                nVtxFrom3ProngFitterSecondLoop = fitter3.process(trackParVarNeg1, trackParVarPos1, trackParVarNeg2);
               } catch (...) {
                 continue;
               }
@@ -3044,14 +3128,14 @@ struct HfTrackIndexSkimCreator {
                 continue;
               }
               // get secondary vertex
-              const auto& secondaryVertex3 = df3.getPCACandidate();
+              const auto& secondaryVertex3 = fitter3.getPCACandidate();
               // get track momenta
               std::array<float, 3> pvec0{};
               std::array<float, 3> pvec1{};
               std::array<float, 3> pvec2{};
-              const auto trackParVarPcaNeg1 = df3.getTrack(0);
-              const auto trackParVarPcaPos1 = df3.getTrack(1);
-              const auto trackParVarPcaNeg2 = df3.getTrack(2);
+              const auto trackParVarPcaNeg1 = fitter3.getTrack(0);
+              const auto trackParVarPcaPos1 = fitter3.getTrack(1);
+              const auto trackParVarPcaNeg2 = fitter3.getTrack(2);
               trackParVarPcaNeg1.getPxPyPzGlo(pvec0);
               trackParVarPcaPos1.getPxPyPzGlo(pvec1);
               trackParVarPcaNeg2.getPxPyPzGlo(pvec2);
@@ -3079,19 +3163,9 @@ struct HfTrackIndexSkimCreator {
                 continue;
               }
 
-              // fill table row
-              rowTrackIndexProng3(thisCollId, trackNeg1.globalIndex(), trackPos1.globalIndex(), trackNeg2.globalIndex(), isSelected3ProngCand);
-              if (config.applyMlForHfFilters) {
-                rowTrackIndexMlScoreProng3(mlScores3Prongs[0], mlScores3Prongs[1], mlScores3Prongs[2], mlScores3Prongs[3]);
-              }
-              if constexpr (DoPvRefit) {
-                // fill table row of coordinates of PV refit
-                rowProng3PVrefit(pvRefitCoord3Prong1Pos2Neg[0], pvRefitCoord3Prong1Pos2Neg[1], pvRefitCoord3Prong1Pos2Neg[2],
-                                 pvRefitCovMatrix3Prong1Pos2Neg[0], pvRefitCovMatrix3Prong1Pos2Neg[1], pvRefitCovMatrix3Prong1Pos2Neg[2], pvRefitCovMatrix3Prong1Pos2Neg[3], pvRefitCovMatrix3Prong1Pos2Neg[4], pvRefitCovMatrix3Prong1Pos2Neg[5]);
-              }
-
+              nCand3++;
+              std::array<int, kN3ProngDecays> prong3CutStatus{};
               if (config.debug) {
-                int prong3CutStatus[kN3ProngDecays];
                 for (int iDecay3P = 0; iDecay3P < kN3ProngDecays; iDecay3P++) {
                   prong3CutStatus[iDecay3P] = nCutStatus3ProngBit[iDecay3P];
                   for (int iCut = 0; iCut < kNCuts3Prong[iDecay3P]; iCut++) {
@@ -3100,75 +3174,90 @@ struct HfTrackIndexSkimCreator {
                     }
                   }
                 }
-                rowProng3CutStatus(prong3CutStatus[0], prong3CutStatus[1], prong3CutStatus[2], prong3CutStatus[3]); // FIXME when we can do this by looping over kN3ProngDecays
               }
+              writeOutput(deferredOutput, [=, this, globalIndexNeg1 = trackNeg1.globalIndex(), globalIndexPos1 = trackPos1.globalIndex(), globalIndexNeg2 = trackNeg2.globalIndex()]() {
+                // fill table row
+                rowTrackIndexProng3(thisCollId, globalIndexNeg1, globalIndexPos1, globalIndexNeg2, isSelected3ProngCand);
+                if (config.applyMlForHfFilters) {
+                  rowTrackIndexMlScoreProng3(mlScores3Prongs[0], mlScores3Prongs[1], mlScores3Prongs[2], mlScores3Prongs[3]);
+                }
+                if constexpr (DoPvRefit) {
+                  // fill table row of coordinates of PV refit
+                  rowProng3PVrefit(pvRefitCoord3Prong1Pos2Neg[0], pvRefitCoord3Prong1Pos2Neg[1], pvRefitCoord3Prong1Pos2Neg[2],
+                                   pvRefitCovMatrix3Prong1Pos2Neg[0], pvRefitCovMatrix3Prong1Pos2Neg[1], pvRefitCovMatrix3Prong1Pos2Neg[2], pvRefitCovMatrix3Prong1Pos2Neg[3], pvRefitCovMatrix3Prong1Pos2Neg[4], pvRefitCovMatrix3Prong1Pos2Neg[5]);
+                }
 
-              // fill histograms
-              if (config.fillHistograms) {
-                registry.fill(HIST("hVtx3ProngX"), secondaryVertex3[0]);
-                registry.fill(HIST("hVtx3ProngY"), secondaryVertex3[1]);
-                registry.fill(HIST("hVtx3ProngZ"), secondaryVertex3[2]);
-                const std::array arr3Mom{pvec0, pvec1, pvec2};
-                for (int iDecay3P = 0; iDecay3P < kN3ProngDecays; iDecay3P++) {
-                  if (TESTBIT(isSelected3ProngCand, iDecay3P)) {
-                    if (TESTBIT(whichHypo3Prong[iDecay3P], 0)) {
-                      const auto mass3Prong = RecoDecay::m(arr3Mom, arrMass3Prong[iDecay3P][0]);
-                      switch (iDecay3P) {
-                        case hf_cand_3prong::DecayType::DplusToPiKPi:
-                          registry.fill(HIST("hMassDPlusToPiKPi"), mass3Prong);
-                          break;
-                        case hf_cand_3prong::DecayType::DsToKKPi:
-                          registry.fill(HIST("hMassDsToKKPi"), mass3Prong);
-                          break;
-                        case hf_cand_3prong::DecayType::LcToPKPi:
-                          registry.fill(HIST("hMassLcToPKPi"), mass3Prong);
-                          break;
-                        case hf_cand_3prong::DecayType::XicToPKPi:
-                          registry.fill(HIST("hMassXicToPKPi"), mass3Prong);
-                          break;
-                        case hf_cand_3prong::DecayType::CdToDeKPi:
-                          registry.fill(HIST("hMassCdToDeKPi"), mass3Prong);
-                          break;
-                        case hf_cand_3prong::DecayType::CtToTrKPi:
-                          registry.fill(HIST("hMassCtToTrKPi"), mass3Prong);
-                          break;
-                        case hf_cand_3prong::DecayType::ChToHeKPi:
-                          registry.fill(HIST("hMassChToHeKPi"), mass3Prong);
-                          break;
-                        case hf_cand_3prong::DecayType::CaToAlKPi:
-                          registry.fill(HIST("hMassCaToAlKPi"), mass3Prong);
-                          break;
+                if (config.debug) {
+                  rowProng3CutStatus(prong3CutStatus[0], prong3CutStatus[1], prong3CutStatus[2], prong3CutStatus[3]); // FIXME when we can do this by looping over kN3ProngDecays
+                }
+
+                // fill histograms
+                if (config.fillHistograms) {
+                  registry.fill(HIST("hVtx3ProngX"), secondaryVertex3[0]);
+                  registry.fill(HIST("hVtx3ProngY"), secondaryVertex3[1]);
+                  registry.fill(HIST("hVtx3ProngZ"), secondaryVertex3[2]);
+                  const std::array arr3Mom{pvec0, pvec1, pvec2};
+                  for (int iDecay3P = 0; iDecay3P < kN3ProngDecays; iDecay3P++) {
+                    if (TESTBIT(isSelected3ProngCand, iDecay3P)) {
+                      if (TESTBIT(whichHypo3Prong[iDecay3P], 0)) {
+                        const auto mass3Prong = RecoDecay::m(arr3Mom, arrMass3Prong[iDecay3P][0]);
+                        switch (iDecay3P) {
+                          case hf_cand_3prong::DecayType::DplusToPiKPi:
+                            registry.fill(HIST("hMassDPlusToPiKPi"), mass3Prong);
+                            break;
+                          case hf_cand_3prong::DecayType::DsToKKPi:
+                            registry.fill(HIST("hMassDsToKKPi"), mass3Prong);
+                            break;
+                          case hf_cand_3prong::DecayType::LcToPKPi:
+                            registry.fill(HIST("hMassLcToPKPi"), mass3Prong);
+                            break;
+                          case hf_cand_3prong::DecayType::XicToPKPi:
+                            registry.fill(HIST("hMassXicToPKPi"), mass3Prong);
+                            break;
+                          case hf_cand_3prong::DecayType::CdToDeKPi:
+                            registry.fill(HIST("hMassCdToDeKPi"), mass3Prong);
+                            break;
+                          case hf_cand_3prong::DecayType::CtToTrKPi:
+                            registry.fill(HIST("hMassCtToTrKPi"), mass3Prong);
+                            break;
+                          case hf_cand_3prong::DecayType::ChToHeKPi:
+                            registry.fill(HIST("hMassChToHeKPi"), mass3Prong);
+                            break;
+                          case hf_cand_3prong::DecayType::CaToAlKPi:
+                            registry.fill(HIST("hMassCaToAlKPi"), mass3Prong);
+                            break;
+                        }
                       }
-                    }
-                    if (TESTBIT(whichHypo3Prong[iDecay3P], 1)) {
-                      const auto mass3Prong = RecoDecay::m(arr3Mom, arrMass3Prong[iDecay3P][1]);
-                      switch (iDecay3P) {
-                        case hf_cand_3prong::DecayType::DsToKKPi:
-                          registry.fill(HIST("hMassDsToKKPi"), mass3Prong);
-                          break;
-                        case hf_cand_3prong::DecayType::LcToPKPi:
-                          registry.fill(HIST("hMassLcToPKPi"), mass3Prong);
-                          break;
-                        case hf_cand_3prong::DecayType::XicToPKPi:
-                          registry.fill(HIST("hMassXicToPKPi"), mass3Prong);
-                          break;
-                        case hf_cand_3prong::DecayType::CdToDeKPi:
-                          registry.fill(HIST("hMassCdToDeKPi"), mass3Prong);
-                          break;
-                        case hf_cand_3prong::DecayType::CtToTrKPi:
-                          registry.fill(HIST("hMassCtToTrKPi"), mass3Prong);
-                          break;
-                        case hf_cand_3prong::DecayType::ChToHeKPi:
-                          registry.fill(HIST("hMassChToHeKPi"), mass3Prong);
-                          break;
-                        case hf_cand_3prong::DecayType::CaToAlKPi:
-                          registry.fill(HIST("hMassCaToAlKPi"), mass3Prong);
-                          break;
+                      if (TESTBIT(whichHypo3Prong[iDecay3P], 1)) {
+                        const auto mass3Prong = RecoDecay::m(arr3Mom, arrMass3Prong[iDecay3P][1]);
+                        switch (iDecay3P) {
+                          case hf_cand_3prong::DecayType::DsToKKPi:
+                            registry.fill(HIST("hMassDsToKKPi"), mass3Prong);
+                            break;
+                          case hf_cand_3prong::DecayType::LcToPKPi:
+                            registry.fill(HIST("hMassLcToPKPi"), mass3Prong);
+                            break;
+                          case hf_cand_3prong::DecayType::XicToPKPi:
+                            registry.fill(HIST("hMassXicToPKPi"), mass3Prong);
+                            break;
+                          case hf_cand_3prong::DecayType::CdToDeKPi:
+                            registry.fill(HIST("hMassCdToDeKPi"), mass3Prong);
+                            break;
+                          case hf_cand_3prong::DecayType::CtToTrKPi:
+                            registry.fill(HIST("hMassCtToTrKPi"), mass3Prong);
+                            break;
+                          case hf_cand_3prong::DecayType::ChToHeKPi:
+                            registry.fill(HIST("hMassChToHeKPi"), mass3Prong);
+                            break;
+                          case hf_cand_3prong::DecayType::CaToAlKPi:
+                            registry.fill(HIST("hMassCaToAlKPi"), mass3Prong);
+                            break;
+                        }
                       }
                     }
                   }
                 }
-              }
+              });
             }
           }
 
@@ -3176,7 +3265,6 @@ struct HfTrackIndexSkimCreator {
                                                                                                                                                                                                                         // if D* enabled and pt of the D0 is larger than the minimum of the D* one within 20% (D* and D0 momenta are very similar, always within 20% according to PYTHIA8)
             // second loop over positive tracks
             if (TESTBIT(whichHypo2Prong[kN2ProngDecays], 0) && (!config.applyKaonPidIn3Prongs || TESTBIT(trackIndexNeg1.isIdentifiedPid(), ChannelKaonPid))) { // only for D0 candidates; moreover if kaon PID enabled, apply to the negative track
-              auto groupedTrackIndicesSoftPionsPos = positiveSoftPions->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache);
               for (auto trackIndexPos2 = groupedTrackIndicesSoftPionsPos.begin(); trackIndexPos2 != groupedTrackIndicesSoftPionsPos.end(); ++trackIndexPos2) {
                 if (trackIndexPos2 == trackIndexPos1) {
                   continue;
@@ -3186,8 +3274,7 @@ struct HfTrackIndexSkimCreator {
                 if (thisCollId != trackPos2.collisionId()) { // this is not the "default" collision for this track, we have to re-propagate it
                   auto trackParVarPos2 = getTrackParCov(trackPos2);
                   std::array dcaInfoPos2{trackPos2.dcaXY(), trackPos2.dcaZ()};
-                  o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParVarPos2, 2.f, noMatCorr, &dcaInfoPos2);
-                  getPxPyPz(trackParVarPos2, pVecTrackPos2);
+                  propagateToThisCollision(trackPos2, trackParVarPos2, dcaInfoPos2, pVecTrackPos2);
                 }
 
                 uint8_t isSelectedDstar{0};
@@ -3195,25 +3282,26 @@ struct HfTrackIndexSkimCreator {
                 float deltaMass{-1.};
                 isSelectedDstar = applySelectionDstar(pVecTrackPos1, pVecTrackNeg1, pVecTrackPos2, cutStatus, deltaMass); // we do not compute the D* decay vertex at this stage because we are not interested in applying topological selections
                 if (isSelectedDstar) {
-                  rowTrackIndexDstar(thisCollId, trackPos2.globalIndex(), lastFilledD0);
-                  if (config.fillHistograms) {
-                    registry.fill(HIST("hMassDstarToD0Pi"), deltaMass);
-                  }
-                  if constexpr (DoPvRefit) {
-                    // fill table row with coordinates of PV refit (same as 2-prong because we do not remove the soft pion)
-                    rowDstarPVrefit(pvRefitCoord2Prong[0], pvRefitCoord2Prong[1], pvRefitCoord2Prong[2],
-                                    pvRefitCovMatrix2Prong[0], pvRefitCovMatrix2Prong[1], pvRefitCovMatrix2Prong[2], pvRefitCovMatrix2Prong[3], pvRefitCovMatrix2Prong[4], pvRefitCovMatrix2Prong[5]);
-                  }
+                  writeOutput(deferredOutput, [=, this, globalIndexPos2 = trackPos2.globalIndex()]() {
+                    rowTrackIndexDstar(thisCollId, globalIndexPos2, lastFilledD0);
+                    if (config.fillHistograms) {
+                      registry.fill(HIST("hMassDstarToD0Pi"), deltaMass);
+                    }
+                    if constexpr (DoPvRefit) {
+                      // fill table row with coordinates of PV refit (same as 2-prong because we do not remove the soft pion)
+                      rowDstarPVrefit(pvRefitCoord2Prong[0], pvRefitCoord2Prong[1], pvRefitCoord2Prong[2],
+                                      pvRefitCovMatrix2Prong[0], pvRefitCovMatrix2Prong[1], pvRefitCovMatrix2Prong[2], pvRefitCovMatrix2Prong[3], pvRefitCovMatrix2Prong[4], pvRefitCovMatrix2Prong[5]);
+                    }
+                  });
                 }
                 if (config.debug) {
-                  rowDstarCutStatus(cutStatus);
+                  writeOutput(deferredOutput, [=, this]() { rowDstarCutStatus(cutStatus); });
                 }
               }
             }
 
             // second loop over negative tracks
             if (TESTBIT(whichHypo2Prong[kN2ProngDecays], 1) && (!config.applyKaonPidIn3Prongs || TESTBIT(trackIndexPos1.isIdentifiedPid(), ChannelKaonPid))) { // only for D0bar candidates; moreover if kaon PID enabled, apply to the positive track
-              auto groupedTrackIndicesSoftPionsNeg = negativeSoftPions->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache);
               for (auto trackIndexNeg2 = groupedTrackIndicesSoftPionsNeg.begin(); trackIndexNeg2 != groupedTrackIndicesSoftPionsNeg.end(); ++trackIndexNeg2) {
                 if (trackIndexNeg1 == trackIndexNeg2) {
                   continue;
@@ -3223,8 +3311,7 @@ struct HfTrackIndexSkimCreator {
                 if (thisCollId != trackNeg2.collisionId()) { // this is not the "default" collision for this track, we have to re-propagate it
                   auto trackParVarNeg2 = getTrackParCov(trackNeg2);
                   std::array dcaInfoNeg2{trackNeg2.dcaXY(), trackNeg2.dcaZ()};
-                  o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParVarNeg2, 2.f, noMatCorr, &dcaInfoNeg2);
-                  getPxPyPz(trackParVarNeg2, pVecTrackNeg2);
+                  propagateToThisCollision(trackNeg2, trackParVarNeg2, dcaInfoNeg2, pVecTrackNeg2);
                 }
 
                 uint8_t isSelectedDstar{0};
@@ -3232,18 +3319,20 @@ struct HfTrackIndexSkimCreator {
                 float deltaMass{-1.};
                 isSelectedDstar = applySelectionDstar(pVecTrackNeg1, pVecTrackPos1, pVecTrackNeg2, cutStatus, deltaMass); // we do not compute the D* decay vertex at this stage because we are not interested in applying topological selections
                 if (isSelectedDstar) {
-                  rowTrackIndexDstar(thisCollId, trackNeg2.globalIndex(), lastFilledD0);
-                  if (config.fillHistograms) {
-                    registry.fill(HIST("hMassDstarToD0Pi"), deltaMass);
-                  }
-                  if constexpr (DoPvRefit) {
-                    // fill table row with coordinates of PV refit (same as 2-prong because we do not remove the soft pion)
-                    rowDstarPVrefit(pvRefitCoord2Prong[0], pvRefitCoord2Prong[1], pvRefitCoord2Prong[2],
-                                    pvRefitCovMatrix2Prong[0], pvRefitCovMatrix2Prong[1], pvRefitCovMatrix2Prong[2], pvRefitCovMatrix2Prong[3], pvRefitCovMatrix2Prong[4], pvRefitCovMatrix2Prong[5]);
-                  }
+                  writeOutput(deferredOutput, [=, this, globalIndexNeg2 = trackNeg2.globalIndex()]() {
+                    rowTrackIndexDstar(thisCollId, globalIndexNeg2, lastFilledD0);
+                    if (config.fillHistograms) {
+                      registry.fill(HIST("hMassDstarToD0Pi"), deltaMass);
+                    }
+                    if constexpr (DoPvRefit) {
+                      // fill table row with coordinates of PV refit (same as 2-prong because we do not remove the soft pion)
+                      rowDstarPVrefit(pvRefitCoord2Prong[0], pvRefitCoord2Prong[1], pvRefitCoord2Prong[2],
+                                      pvRefitCovMatrix2Prong[0], pvRefitCovMatrix2Prong[1], pvRefitCovMatrix2Prong[2], pvRefitCovMatrix2Prong[3], pvRefitCovMatrix2Prong[4], pvRefitCovMatrix2Prong[5]);
+                    }
+                  });
                 }
                 if (config.debug) {
-                  rowDstarCutStatus(cutStatus);
+                  writeOutput(deferredOutput, [=, this]() { rowDstarCutStatus(cutStatus); });
                 }
               }
             }
@@ -3253,15 +3342,98 @@ struct HfTrackIndexSkimCreator {
 
       const int nTracks = 0;
       // auto nTracks = trackIndicesPerCollision.lastIndex() - trackIndicesPerCollision.firstIndex(); // number of tracks passing 2 and 3 prong selection in this collision
-      nCand2 = rowTrackIndexProng2.lastIndex() - nCand2; // number of 2-prong candidates in this collision
-      nCand3 = rowTrackIndexProng3.lastIndex() - nCand3; // number of 3-prong candidates in this collision
-
       if (config.fillHistograms) {
-        registry.fill(HIST("hNTracks"), nTracks);
-        registry.fill(HIST("hNCand2Prong"), nCand2);
-        registry.fill(HIST("hNCand3Prong"), nCand3);
-        registry.fill(HIST("hNCand2ProngVsNTracks"), nTracks, nCand2);
-        registry.fill(HIST("hNCand3ProngVsNTracks"), nTracks, nCand3);
+        writeOutput(deferredOutput, [=, this]() {
+          registry.fill(HIST("hNTracks"), nTracks);
+          registry.fill(HIST("hNCand2Prong"), nCand2);
+          registry.fill(HIST("hNCand3Prong"), nCand3);
+          registry.fill(HIST("hNCand2ProngVsNTracks"), nTracks, nCand2);
+          registry.fill(HIST("hNCand3ProngVsNTracks"), nTracks, nCand3);
+        });
+      }
+    };
+
+    const int nThreads = (DoPvRefit || config.applyMlForHfFilters) ? 1 : config.nThreadsVertexing.value; // PV refit and ML fill histograms inside the selection functions
+    const auto nCollisions = collisions.size();
+    bool isSingleRun = true;
+    if (nThreads > 1 && nCollisions > 1) {
+      const auto runNumberFirst = collisions.begin().template bc_as<o2::aod::BCsWithTimestamps>().runNumber();
+      for (const auto& collision : collisions) {
+        if (collision.template bc_as<o2::aod::BCsWithTimestamps>().runNumber() != runNumberFirst) {
+          isSingleRun = false;
+          break;
+        }
+      }
+    }
+
+    if (nThreads <= 1 || nCollisions <= 1 || !isSingleRun) {
+      for (const auto& collision : collisions) {
+        // set the magnetic field from CCDB
+        const auto bc = collision.template bc_as<o2::aod::BCsWithTimestamps>();
+        initCCDB(bc, runNumber, ccdb, config.isRun2 ? config.ccdbPathGrp : config.ccdbPathGrpMag, lut, config.isRun2);
+        df2.setBz(o2::base::Propagator::Instance()->getNominalBz());
+        df3.setBz(o2::base::Propagator::Instance()->getNominalBz());
+
+        processCollision(collision,
+                         positiveFor2And3Prongs->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache),
+                         negativeFor2And3Prongs->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache),
+                         positiveSoftPions->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache),
+                         negativeSoftPions->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache),
+                         df2, df3, nullptr);
+      }
+      return;
+    }
+
+    // multithreaded vertexing: the collisions are distributed over the workers, each with its own copy of the fitters.
+    // The output of each collision is buffered and written in the order of the collisions, so that the tables are the same as in the serial mode
+    const auto bc = collisions.begin().template bc_as<o2::aod::BCsWithTimestamps>();
+    initCCDB(bc, runNumber, ccdb, config.isRun2 ? config.ccdbPathGrp : config.ccdbPathGrpMag, lut, config.isRun2);
+    df2.setBz(o2::base::Propagator::Instance()->getNominalBz());
+    df3.setBz(o2::base::Propagator::Instance()->getNominalBz());
+    std::vector<o2::vertexing::DCAFitterN<2>> fitters2(nThreads, df2);
+    std::vector<o2::vertexing::DCAFitterN<3>> fitters3(nThreads, df3);
+
+    // the slices are taken beforehand, the slice cache is not thread safe
+    using TrackIndicesSlice = decltype(positiveFor2And3Prongs->sliceByCached(aod::track::collisionId, 0, cache));
+    std::vector<SelectedCollisions::iterator> vecCollisions;
+    std::array<std::vector<TrackIndicesSlice>, 4> vecGroupedTrackIndices; // positive and negative tracks for 2 and 3 prongs, positive and negative soft pions
+    vecCollisions.reserve(nCollisions);
+    for (auto& grouped : vecGroupedTrackIndices) {
+      grouped.reserve(nCollisions);
+    }
+    for (const auto& collision : collisions) {
+      vecCollisions.push_back(collision);
+      vecGroupedTrackIndices[0].push_back(positiveFor2And3Prongs->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache));
+      vecGroupedTrackIndices[1].push_back(negativeFor2And3Prongs->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache));
+      vecGroupedTrackIndices[2].push_back(positiveSoftPions->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache));
+      vecGroupedTrackIndices[3].push_back(negativeSoftPions->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache));
+    }
+
+    // the collisions are processed in blocks, to limit the memory used by the buffered output
+    const std::size_t blockSize = static_cast<std::size_t>(nThreads) * NCollisionsPerThreadInBlock;
+    std::vector<std::vector<std::function<void()>>> deferredOutputs(std::min<std::size_t>(blockSize, vecCollisions.size()));
+    for (std::size_t blockBegin = 0; blockBegin < vecCollisions.size(); blockBegin += blockSize) {
+      const std::size_t blockEnd = std::min(blockBegin + blockSize, vecCollisions.size());
+      std::atomic<std::size_t> next{blockBegin};
+      auto worker = [&](int iThread) {
+        for (std::size_t iColl = next++; iColl < blockEnd; iColl = next++) {
+          processCollision(vecCollisions[iColl], vecGroupedTrackIndices[0][iColl], vecGroupedTrackIndices[1][iColl], vecGroupedTrackIndices[2][iColl], vecGroupedTrackIndices[3][iColl],
+                           fitters2[iThread], fitters3[iThread], &deferredOutputs[iColl - blockBegin]);
+        }
+      };
+      std::vector<std::thread> threads;
+      for (int iThread = 1; iThread < nThreads; iThread++) {
+        threads.emplace_back(worker, iThread);
+      }
+      worker(0);
+      for (auto& thread : threads) {
+        thread.join();
+      }
+      for (std::size_t iColl = blockBegin; iColl < blockEnd; iColl++) {
+        for (const auto& output : deferredOutputs[iColl - blockBegin]) {
+          output();
+        }
+        deferredOutputs[iColl - blockBegin].clear();
       }
     }
   } /// end of run2And3Prongs function
@@ -22,6 +22,7 @@
 #include "PWGHF/DataModel/AliasTables.h"
 #include "PWGHF/DataModel/CandidateReconstructionTables.h"
 #include "PWGHF/DataModel/CandidateSelectionTables.h"
+#include "PWGHF/Utils/utilsMlHf.h"
 
 #include "Common/Core/RecoDecay.h"
 #include "Common/DataModel/Centrality.h"
@@ -466,7 +467,7 @@ struct HfTreeCreatorLcToPKPi {
     return status;
   }
 
-  void init(InitContext const&)
+  void init(InitContext& initContext)
   {
     std::array<bool, 8> processes = {doprocessDataNoCentralityWithDCAFitterN, doprocessDataWithCentralityWithDCAFitterN, doprocessDataNoCentralityWithKFParticle, doprocessDataWithCentralityWithKFParticle,
                                      doprocessMcNoCentralityWithDCAFitterN, doprocessMcWithCentralityWithDCAFitterN, doprocessMcNoCentralityWithKFParticle, doprocessMcWithCentralityWithKFParticle};
@@ -476,6 +477,9 @@ struct HfTreeCreatorLcToPKPi {
     if ((std::accumulate(processes.begin(), processes.begin() + 4, 0) != 0) && fillCandidateMcTable) {
       LOGP(fatal, "fillCandidateMcTable can be activated only in case of MC processing.");
     }
+    if (applyMl) {
+      o2::analysis::checkMlScoresFromSelector(initContext, "hf-candidate-selector-lc");
+    }
   }
 
   /// \brief function to fill event properties
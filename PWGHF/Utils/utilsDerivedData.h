@@ -23,8 +23,8 @@
 #include <Framework/Configurable.h>
 #include <Framework/Logger.h>
 
+#include <cstddef>
 #include <cstdint>
-#include <map>
 #include <vector>
 
 // Macro to store nSigma for prong _id_ with PID hypothesis _hyp_ in an array
@@ -88,8 +88,8 @@ struct HfProducesDerivedData : o2::framework::ProducesGroup {
   o2::framework::Produces<HfPIds> rowParticleId;
 
   HfConfigurableDerivedData const* conf{};
-  std::map<int, std::vector<int>> matchedCollisions; // indices of derived reconstructed collisions matched to the global indices of MC collisions
-  std::map<int, bool> hasMcParticles;                // flags for MC collisions with HF particles
+  std::vector<std::vector<int>> matchedCollisions; // indices of derived reconstructed collisions matched to MC collisions, indexed by the global index of the MC collision
+  std::vector<bool> hasMcParticles;                // flags for MC collisions with HF particles, indexed by the global index of the MC collision
 
   void init(HfConfigurableDerivedData const& c)
   {
@@ -157,13 +157,27 @@ struct HfProducesDerivedData : o2::framework::ProducesGroup {
     }
     if constexpr (IsMc) {
       if (conf->fillMcRCollId.value && collision.has_mcCollision()) {
-        // Save rowCollBase.lastIndex() at key collision.mcCollisionId()
+        // Save rowCollBase.lastIndex() at index collision.mcCollisionId()
         LOGF(debug, "Rec. collision %d: Filling derived-collision index %d for MC collision %d", collision.globalIndex(), rowCollBase.lastIndex(), collision.mcCollisionId());
-        matchedCollisions[collision.mcCollisionId()].push_back(rowCollBase.lastIndex()); // [] inserts an empty element if it does not exist
+        if (static_cast<std::size_t>(collision.mcCollisionId()) >= matchedCollisions.size()) {
+          matchedCollisions.resize(collision.mcCollisionId() + 1);
+        }
+        matchedCollisions[collision.mcCollisionId()].push_back(rowCollBase.lastIndex());
       }
     }
   }
 
+  /// Indices of the derived reconstructed collisions matched to an MC collision
+  /// \param mcCollisionId  global index of the MC collision
+  const std::vector<int>& getMatchedCollisions(const int64_t mcCollisionId) const
+  {
+    static const std::vector<int> NoCollisions{};
+    if (mcCollisionId < 0 || static_cast<std::size_t>(mcCollisionId) >= matchedCollisions.size()) {
+      return NoCollisions;
+    }
+    return matchedCollisions[mcCollisionId];
+  }
+
   template <typename TMcCollision>
   void fillTablesMcCollision(TMcCollision const& mcCollision)
   {
@@ -181,7 +195,7 @@ struct HfProducesDerivedData : o2::framework::ProducesGroup {
     if (conf->fillMcRCollId.value) {
       // Fill the table with the vector of indices of derived reconstructed collisions matched to mcCollision.globalIndex()
       rowMcRCollId(
-        matchedCollisions[mcCollision.globalIndex()]);
+        getMatchedCollisions(mcCollision.globalIndex()));
     }
   }
 
@@ -213,13 +227,13 @@ struct HfProducesDerivedData : o2::framework::ProducesGroup {
     if (!conf->fillMcRCollId.value) {
       return;
     }
-    hasMcParticles.clear();
-    // Fill MC collision flags
-    for (const auto& mcCollision : mcCollisions) {
-      const auto thisMcCollId = mcCollision.globalIndex();
-      const auto particlesThisMcColl = mcParticles.sliceBy(mcParticlesPerMcCollision, thisMcCollId);
-      LOGF(debug, "MC collision %d has %d MC particles (preprocess)", thisMcCollId, particlesThisMcColl.size());
-      hasMcParticles[thisMcCollId] = (particlesThisMcColl.size() > 0);
+    // Fill MC collision flags, in one pass over the HF particles
+    hasMcParticles.assign(mcCollisions.size(), false);
+    for (const auto& particle : mcParticles) {
+      const auto thisMcCollId = particle.mcCollisionId();
+      if (thisMcCollId >= 0 && static_cast<std::size_t>(thisMcCollId) < hasMcParticles.size()) {
+        hasMcParticles[thisMcCollId] = true;
+      }
     }
   }
 
@@ -229,17 +243,28 @@ struct HfProducesDerivedData : o2::framework::ProducesGroup {
                           TMcParticles const& mcParticles,
                           const TMass massParticle)
   {
-    // Fill MC collision properties
-    const auto sizeTableMcColl = mcCollisions.size();
+    // Count the saved MC collisions and particles, such that the tables are reserved exactly once per data frame
+    uint64_t sizeTableMcColl = 0;
+    uint64_t sizeTablePartAll = 0;
+    for (const auto& mcCollision : mcCollisions) {
+      const auto sizeTablePart = mcParticles.sliceBy(mcParticlesPerMcCollision, mcCollision.globalIndex()).size();
+      if (sizeTablePart > 0 || (conf->fillMcRCollId.value && !getMatchedCollisions(mcCollision.globalIndex()).empty())) {
+        sizeTableMcColl++;
+        sizeTablePartAll += sizeTablePart;
+      }
+    }
     reserveTablesMcColl(sizeTableMcColl);
+    reserveTablesParticles(sizeTablePartAll);
+
+    // Fill MC collision properties
     for (const auto& mcCollision : mcCollisions) {
       const auto thisMcCollId = mcCollision.globalIndex();
       const auto particlesThisMcColl = mcParticles.sliceBy(mcParticlesPerMcCollision, thisMcCollId);
       const auto sizeTablePart = particlesThisMcColl.size();
       LOGF(debug, "MC collision %d has %d MC particles", thisMcCollId, sizeTablePart);
       // Skip MC collisions without HF particles (and without HF candidates in matched reconstructed collisions if saving indices of reconstructed collisions matched to MC collisions)
-      LOGF(debug, "MC collision %d has %d saved derived rec. collisions", thisMcCollId, matchedCollisions[thisMcCollId].size());
-      if (sizeTablePart == 0 && (!conf->fillMcRCollId.value || matchedCollisions[thisMcCollId].empty())) {
+      LOGF(debug, "MC collision %d has %d saved derived rec. collisions", thisMcCollId, getMatchedCollisions(thisMcCollId).size());
+      if (sizeTablePart == 0 && (!conf->fillMcRCollId.value || getMatchedCollisions(thisMcCollId).empty())) {
         LOGF(debug, "Skipping MC collision %d", thisMcCollId);
         continue;
       }
@@ -247,7 +272,6 @@ struct HfProducesDerivedData : o2::framework::ProducesGroup {
       fillTablesMcCollision(mcCollision);
 
       // Fill MC particle properties
-      reserveTablesParticles(sizeTablePart);
       for (const auto& particle : particlesThisMcColl) {
         fillTablesParticle(particle, massParticle);
       }
@@ -0,0 +1,83 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file utilsMlHf.h
+/// \brief Consistency of the ML scores published by the HF candidate selectors with the tasks consuming them
+
+#ifndef PWGHF_UTILS_UTILSMLHF_H_
+#define PWGHF_UTILS_UTILSMLHF_H_
+
+#include "Common/Core/TableHelper.h"
+
+#include <Framework/InitContext.h>
+#include <Framework/Logger.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace o2::analysis
+{
+/// ML models applied by a task, as given by its configurables
+struct HfMlModelIdentity {
+  bool applyMl{false};
+  bool loadModelsFromCCDB{false};
+  int64_t timestampCCDB{-1};
+  int nClassesMl{0};
+  std::vector<std::string> modelPathsCCDB{};
+  std::vector<std::string> onnxFileNames{};
+  std::vector<std::string> namesInputFeatures{};
+
+  /// \return true if the two tasks evaluate the same models on the same input features
+  bool isSameModel(HfMlModelIdentity const& other) const
+  {
+    return loadModelsFromCCDB == other.loadModelsFromCCDB && timestampCCDB == other.timestampCCDB && nClassesMl == other.nClassesMl &&
+           (!loadModelsFromCCDB || modelPathsCCDB == other.modelPathsCCDB) && onnxFileNames == other.onnxFileNames && namesInputFeatures == other.namesInputFeatures;
+  }
+};
+
+/// Gets the ML models of another task of the workflow from its configurables
+/// \param initContext is the init context of the calling task
+/// \param taskName is the name of the device of the other task, e.g. "hf-candidate-selector-lc"
+/// \param identity is filled with the ML models of the other task
+/// \return false if the task is not in the workflow, e.g. when its tables are read from the input files
+inline bool getMlModelIdentity(o2::framework::InitContext& initContext, const std::string& taskName, HfMlModelIdentity& identity)
+{
+  if (!getTaskOptionValue(initContext, taskName, "applyMl", identity.applyMl, false)) {
+    return false;
+  }
+  getTaskOptionValue(initContext, taskName, "loadModelsFromCCDB", identity.loadModelsFromCCDB, false);
+  getTaskOptionValue(initContext, taskName, "timestampCCDB", identity.timestampCCDB, false);
+  getTaskOptionValue(initContext, taskName, "nClassesMl", identity.nClassesMl, false);
+  getTaskOptionValue(initContext, taskName, "modelPathsCCDB", identity.modelPathsCCDB, false);
+  getTaskOptionValue(initContext, taskName, "onnxFileNames", identity.onnxFileNames, false);
+  getTaskOptionValue(initContext, taskName, "namesInputFeatures", identity.namesInputFeatures, false);
+  return true;
+}
+
+/// Checks that the selector of the workflow publishes the ML scores consumed by the calling task, which then does not evaluate the models again
+/// \param initContext is the init context of the calling task
+/// \param selectorName is the name of the device of the candidate selector
+inline void checkMlScoresFromSelector(o2::framework::InitContext& initContext, const std::string& selectorName)
+{
+  HfMlModelIdentity identity;
+  if (!getMlModelIdentity(initContext, selectorName, identity)) {
+    LOGF(info, "%s is not in the workflow, the ML scores are read from the input tables", selectorName);
+    return;
+  }
+  if (!identity.applyMl) {
+    LOGF(fatal, "The ML scores are consumed, but %s does not apply ML and publishes empty scores: set its applyMl or disable the ML in this task", selectorName);
+  }
+  LOGF(info, "Consuming the ML scores of %s: %d classes, %zu models, first one %s", selectorName, identity.nClassesMl, identity.onnxFileNames.size(), identity.onnxFileNames.empty() ? "none" : identity.onnxFileNames.front());
+}
+} // namespace o2::analysis
+
+#endif // PWGHF_UTILS_UTILSMLHF_H_
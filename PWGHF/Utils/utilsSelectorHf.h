@@ -0,0 +1,78 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file utilsSelectorHf.h
+/// \brief Per-data-frame columns shared by the selections of the HF candidate selectors
+
+#ifndef PWGHF_UTILS_UTILSSELECTORHF_H_
+#define PWGHF_UTILS_UTILSSELECTORHF_H_
+
+#include "PWGHF/Utils/utilsAnalysis.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace o2::analysis
+{
+/// pT bins of the candidates of a data frame, searched once per candidate and shared by all the selections of the candidate
+class HfPtBinColumn
+{
+ public:
+  /// \param bins are the pT bin limits of the cuts
+  /// \param candidates are the candidates of the data frame, in the order in which they are then processed
+  template <typename TArrayPt, typename TCandidates>
+  void fill(TArrayPt const& bins, TCandidates const& candidates)
+  {
+    mPtBins.clear();
+    mPtBins.reserve(candidates.size());
+    for (const auto& candidate : candidates) {
+      mPtBins.push_back(findBin(bins, candidate.pt()));
+    }
+  }
+
+  /// \return the pT bin of the i-th candidate, -1 if outside the bins
+  int operator[](std::size_t iCandidate) const { return mPtBins[iCandidate]; }
+
+ private:
+  std::vector<int> mPtBins{};
+};
+
+/// PID status of the tracks of a data frame for one species, computed once per track and shared by all the prongs of all the candidates
+class HfPidStatusColumn
+{
+ public:
+  /// Invalidates the statuses, to be called once per data frame
+  /// \param nTracks is the number of tracks of the data frame
+  void reset(std::size_t nTracks) { mStatus.assign(nTracks, NotComputed); }
+
+  /// \param trackIndex is the global index of the track
+  /// \param computeStatus returns the TrackSelectorPID status of the track, called only the first time the track is met
+  /// \return the PID status of the track
+  template <typename TComputeStatus>
+  int get(int64_t trackIndex, TComputeStatus&& computeStatus)
+  {
+    int8_t& status = mStatus[trackIndex];
+    if (status == NotComputed) {
+      status = static_cast<int8_t>(computeStatus());
+    }
+    return status;
+  }
+
+ private:
+  static constexpr int8_t NotComputed = std::numeric_limits<int8_t>::min();
+
+  std::vector<int8_t> mStatus{};
+};
+} // namespace o2::analysis
+
+#endif // PWGHF_UTILS_UTILSSELECTORHF_H_
@@ -0,0 +1,153 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file utilsVertexingHf.h
+/// \brief Secondary-vertex reconstruction of HF candidates with DCAFitterN on several threads
+
+#ifndef PWGHF_UTILS_UTILSVERTEXINGHF_H_
+#define PWGHF_UTILS_UTILSVERTEXINGHF_H_
+
+#include "PWGHF/Utils/utilsTrkCandHf.h"
+
+#include <DCAFitter/DCAFitterN.h>
+#include <ReconstructionDataFormats/DCA.h>
+#include <ReconstructionDataFormats/Track.h>
+#include <ReconstructionDataFormats/Vertex.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace o2::hf_vertexing
+{
+/// Prongs of a candidate to be fitted
+template <int NProngs>
+struct HfVertexingInput {
+  std::array<o2::track::TrackParCov, NProngs> tracks{}; // prong track parametrisations given to the fitter
+  o2::dataformats::VertexBase primaryVertex{};          // vertex to which the prongs are propagated for the impact parameters
+  float bz{0.f};                                        // magnetic field
+};
+
+/// Secondary vertex of a candidate and its prongs at the vertex
+template <int NProngs>
+struct HfVertexingResult {
+  using Fitter = o2::vertexing::DCAFitterN<NProngs>;
+
+  int status{o2::hf_trkcandsel::SVFitting::BeforeFit}; // FitOk, Fail (run-time error of the fitter) or BeforeFit (no vertex found)
+  std::string error{};                                 // message of the run-time error
+  std::decay_t<decltype(std::declval<Fitter&>().getPCACandidate())> secondaryVertex{};
+  std::decay_t<decltype(std::declval<Fitter&>().getChi2AtPCACandidate())> chi2PCA{};
+  std::decay_t<decltype(std::declval<Fitter&>().calcPCACovMatrixFlat())> covMatrixPCA{};
+  std::array<std::array<float, 3>, NProngs> pVecs{};           // prong momenta at the secondary vertex
+  std::array<o2::dataformats::DCA, NProngs> impactParameters{}; // prong impact parameters w.r.t. the primary vertex
+};
+
+/// Pool of fitters reconstructing the secondary vertices of a list of candidates, each thread with its own copy of the fitter.
+/// The results are stored at the positions of the inputs, so that the candidates can be written in their original order.
+/// The fit of each candidate is the one of the creators: DCAFitterN::process, then the prongs at the secondary vertex are propagated to the primary vertex.
+template <int NProngs>
+class HfVertexingPool
+{
+ public:
+  using Fitter = o2::vertexing::DCAFitterN<NProngs>;
+  using Input = HfVertexingInput<NProngs>;
+  using Result = HfVertexingResult<NProngs>;
+
+  /// \param fitter is the configured fitter, copied for each thread
+  /// \param nThreads is the number of threads, the calling one included
+  void init(Fitter const& fitter, int nThreads)
+  {
+    mFitters.assign(std::max(nThreads, 1), fitter);
+  }
+
+  int getNThreads() const { return static_cast<int>(mFitters.size()); }
+
+  /// Whether the prongs at the secondary vertex are propagated to the primary vertex to fill pVecs and impactParameters (default).
+  /// Users which take the prong momenta and impact parameters from the input tracks can skip it
+  void setPropagateProngs(bool propagate) { mPropagateProngs = propagate; }
+
+  /// Reconstructs the secondary vertices of the candidates
+  /// \param inputs are the prongs of the candidates
+  /// \param results are the vertices, at the same positions as the inputs
+  void fit(std::vector<Input> const& inputs, std::vector<Result>& results)
+  {
+    fit(inputs, results, [](Fitter&, std::size_t) {});
+  }
+
+  /// Same as above, with afterFit(fitter, iCand) called after each successful fit by the thread of the candidate, while the fitter still holds it,
+  /// to compute further quantities (e.g. the dispersion of the prongs around the vertex) into containers of the caller indexed by iCand
+  template <typename TAfterFit>
+  void fit(std::vector<Input> const& inputs, std::vector<Result>& results, TAfterFit afterFit)
+  {
+    results.resize(inputs.size());
+    std::atomic<std::size_t> next{0};
+    auto worker = [&](std::size_t iThread) {
+      for (std::size_t iCand = next++; iCand < inputs.size(); iCand = next++) {
+        fitCandidate(mFitters[iThread], inputs[iCand], results[iCand]);
+        if (results[iCand].status == o2::hf_trkcandsel::SVFitting::FitOk) {
+          afterFit(mFitters[iThread], iCand);
+        }
+      }
+    };
+    const std::size_t nThreads = std::min(mFitters.size(), inputs.size());
+    std::vector<std::thread> threads;
+    for (std::size_t iThread = 1; iThread < nThreads; iThread++) {
+      threads.emplace_back(worker, iThread);
+    }
+    worker(0);
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+ private:
+  void fitCandidate(Fitter& fitter, Input const& input, Result& result) const
+  {
+    result = Result{};
+    fitter.setBz(input.bz);
+    try {
+      if (std::apply([&fitter](auto const&... tracks) { return fitter.process(tracks...); }, input.tracks) == 0) {
+        return;
+      }
+    } catch (const std::runtime_error& error) {
+      result.status = o2::hf_trkcandsel::SVFitting::Fail;
+      result.error = error.what();
+      return;
+    }
+    result.status = o2::hf_trkcandsel::SVFitting::FitOk;
+    result.secondaryVertex = fitter.getPCACandidate();
+    result.chi2PCA = fitter.getChi2AtPCACandidate();
+    result.covMatrixPCA = fitter.calcPCACovMatrixFlat();
+    if (!mPropagateProngs) {
+      return;
+    }
+    for (int iProng = 0; iProng < NProngs; iProng++) {
+      auto trackParVar = fitter.getTrack(iProng);
+      trackParVar.getPxPyPzGlo(result.pVecs[iProng]);
+      // This modifies track momenta!
+      trackParVar.propagateToDCA(input.primaryVertex, input.bz, &result.impactParameters[iProng]);
+    }
+  }
+
+  std::vector<Fitter> mFitters{};
+  bool mPropagateProngs{true}; // fill the prong momenta and impact parameters of the results
+};
+} // namespace o2::hf_vertexing
+
+#endif // PWGHF_UTILS_UTILSVERTEXINGHF_H_
@@ -15,10 +15,15 @@
 
 #include <vector>
 
-void fastjetutilities::setFastJetUserInfo(std::vector<fastjet::PseudoJet>& constituents, int index, JetConstituentStatus status)
+void fastjetutilities::setFastJetUserInfo(std::vector<fastjet::PseudoJet>& constituents, int index, JetConstituentStatus status, bool withUserInfo)
 {
-  fastjet_user_info* user_info = new fastjet_user_info(status, index); // FIXME: can setting this as a pointer be avoided?
-  constituents.back().set_user_info(user_info);
+  if (withUserInfo) {
+    fastjet_user_info* user_info = new fastjet_user_info(status, index); // FIXME: can setting this as a pointer be avoided?
+    constituents.back().set_user_info(user_info);
+  } else if (index == invalidIndex) {
+    constituents.back().set_user_index(0); // decoded as invalid
+    return;
+  }
   if (index != invalidIndex) { // FIXME: in principle needed for constituent subtraction, particularly when clusters are added to the subtraction. However since the HF particle is not subtracted then we dont need to check for it in this manner
     int i = index;
     if (status == JetConstituentStatus::track) {
@@ -28,8 +33,44 @@ void fastjetutilities::setFastJetUserInfo(std::vector<fastjet::PseudoJet>& const
       i = -1 * (i + 1);
     }
     if (status == JetConstituentStatus::candidate) {
-      i = 0;
+      i = withUserInfo ? 0 : i + 1 + candidateUserIndexOffset; // without user info the candidate index has to be recoverable
     }
     constituents.back().set_user_index(i); // FIXME: needed for constituent subtraction, but need to be quite careful to make sure indices dont overlap between tracks, clusters and HF candidates. Current solution might not be optimal
   }
 }
+
+JetConstituentStatus fastjetutilities::getConstituentStatus(const fastjet::PseudoJet& constituent)
+{
+  if (constituent.has_user_info()) {
+    return constituent.user_info<fastjet_user_info>().getStatus();
+  }
+  int i = constituent.user_index();
+  if (i > candidateUserIndexOffset) {
+    return JetConstituentStatus::candidate;
+  }
+  if (i > 0) {
+    return JetConstituentStatus::track;
+  }
+  if (i < 0) {
+    return JetConstituentStatus::cluster;
+  }
+  return JetConstituentStatus::invalidStatus;
+}
+
+int fastjetutilities::getConstituentIndex(const fastjet::PseudoJet& constituent)
+{
+  if (constituent.has_user_info()) {
+    return constituent.user_info<fastjet_user_info>().getIndex();
+  }
+  int i = constituent.user_index();
+  if (i > candidateUserIndexOffset) {
+    return i - 1 - candidateUserIndexOffset;
+  }
+  if (i > 0) {
+    return i - 1;
+  }
+  if (i < 0) {
+    return -1 * i - 1;
+  }
+  return invalidIndex;
+}
@@ -25,6 +25,7 @@
 #include <vector>
 
 constexpr int invalidIndex = -99999999;
+constexpr int candidateUserIndexOffset = 1 << 30; // user_index offset of the candidates when the constituents are encoded in the user_index only
 
 enum class JetConstituentStatus {
   invalidStatus = -1,
@@ -66,9 +67,26 @@ class fastjet_user_info : public fastjet::PseudoJet::UserInfoBase
  * @param constituents vector of constituents to be clustered.
  * @param index global index of constituent
  * @param status status of constituent type
+ * @param withUserInfo if false, no fastjet_user_info is allocated and the index and status are only encoded in the user_index (tracks: index+1, clusters: -(index+1), candidates: index+1+candidateUserIndexOffset)
  */
 
-void setFastJetUserInfo(std::vector<fastjet::PseudoJet>& constituents, int index = invalidIndex, JetConstituentStatus status = JetConstituentStatus::track);
+void setFastJetUserInfo(std::vector<fastjet::PseudoJet>& constituents, int index = invalidIndex, JetConstituentStatus status = JetConstituentStatus::track, bool withUserInfo = true);
+
+/**
+ * Returns the status of a constituent, from its fastjet_user_info if it has one or else from its user_index
+ *
+ * @param constituent constituent filled with setFastJetUserInfo
+ */
+
+JetConstituentStatus getConstituentStatus(const fastjet::PseudoJet& constituent);
+
+/**
+ * Returns the global index of a constituent, from its fastjet_user_info if it has one or else from its user_index
+ *
+ * @param constituent constituent filled with setFastJetUserInfo
+ */
+
+int getConstituentIndex(const fastjet::PseudoJet& constituent);
 
 /**
  * Add track as a pseudojet object to the fastjet vector
@@ -78,17 +96,18 @@ void setFastJetUserInfo(std::vector<fastjet::PseudoJet>& constituents, int index
  * @param index global index of constituent
  * @param status status of constituent type
  * @param status mass hypothesis for constituent
+ * @param withUserInfo attach a fastjet_user_info to the constituent
  */
 
 template <typename T>
-void fillTracks(const T& constituent, std::vector<fastjet::PseudoJet>& constituents, int index = invalidIndex, JetConstituentStatus status = JetConstituentStatus::track, float mass = o2::constants::physics::MassPiPlus)
+void fillTracks(const T& constituent, std::vector<fastjet::PseudoJet>& constituents, int index = invalidIndex, JetConstituentStatus status = JetConstituentStatus::track, float mass = o2::constants::physics::MassPiPlus, bool withUserInfo = true)
 {
   if (status == JetConstituentStatus::track || status == JetConstituentStatus::candidate) {
     // auto p = std::sqrt((constituent.px() * constituent.px()) + (constituent.py() * constituent.py()) + (constituent.pz() * constituent.pz()));
     auto energy = std::sqrt((constituent.p() * constituent.p()) + (mass * mass));
     constituents.emplace_back(constituent.px(), constituent.py(), constituent.pz(), energy);
   }
-  setFastJetUserInfo(constituents, index, status);
+  setFastJetUserInfo(constituents, index, status, withUserInfo);
 }
 
 /**
@@ -98,10 +117,11 @@ void fillTracks(const T& constituent, std::vector<fastjet::PseudoJet>& constitue
  * @param constituents vector of constituents
  * @param index global index of constituent
  * @param status status of constituent type
+ * @param withUserInfo attach a fastjet_user_info to the constituent
  */
 
 template <typename T>
-void fillClusters(const T& constituent, std::vector<fastjet::PseudoJet>& constituents, int index = invalidIndex, int hadronicCorrectionType = 0, JetConstituentStatus status = JetConstituentStatus::cluster)
+void fillClusters(const T& constituent, std::vector<fastjet::PseudoJet>& constituents, int index = invalidIndex, int hadronicCorrectionType = 0, JetConstituentStatus status = JetConstituentStatus::cluster, bool withUserInfo = true)
 {
   if (status == JetConstituentStatus::cluster) {
     float constituentEnergy = 0.0;
@@ -123,7 +143,7 @@ void fillClusters(const T& constituent, std::vector<fastjet::PseudoJet>& constit
     float constituentPt = constituentEnergy / std::cosh(constituent.eta());
     constituents.emplace_back(constituentPt * std::cos(constituent.phi()), constituentPt * std::sin(constituent.phi()), constituentPt * std::sinh(constituent.eta()), constituentEnergy);
   }
-  setFastJetUserInfo(constituents, index, status);
+  setFastJetUserInfo(constituents, index, status, withUserInfo);
 }
 
 }; // namespace fastjetutilities
@@ -28,6 +28,11 @@
 #include <fastjet/contrib/ConstituentSubtractor.hh>
 #include <fastjet/tools/Subtractor.hh>
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <thread>
 #include <tuple>
 #include <vector>
 
@@ -107,6 +112,178 @@ std::tuple<double, double> JetBkgSubUtils::estimateRhoAreaMedian(const std::vect
   return std::make_tuple(rho, rhoM);
 }
 
+std::tuple<double, double> JetBkgSubUtils::estimateRhoGridMedian(const std::vector<fastjet::PseudoJet>& inputParticles, bool doSparseSub)
+{
+  if (inputParticles.size() == 0) {
+    return std::make_tuple(0.0, 0.0);
+  }
+
+  // the grid covers the background acceptance, the full azimuth if the phi range is larger than 2pi
+  const double phiRange = std::min(static_cast<double>(bkgPhiMax - bkgPhiMin), 2.0 * M_PI);
+  const double etaRange = bkgEtaMax - bkgEtaMin;
+  const int nCellsEta = std::max(1, static_cast<int>(std::round(etaRange / gridSpacing)));
+  const int nCellsPhi = std::max(1, static_cast<int>(std::round(phiRange / gridSpacing)));
+  const double cellEta = etaRange / nCellsEta;
+  const double cellPhi = phiRange / nCellsPhi;
+  const double cellArea = cellEta * cellPhi;
+
+  gridCellPt.assign(nCellsEta * nCellsPhi, 0.0);
+  gridCellMd.assign(nCellsEta * nCellsPhi, 0.0);
+  for (const auto& particle : inputParticles) {
+    double eta = particle.eta();
+    if (eta < bkgEtaMin || eta >= bkgEtaMax) {
+      continue;
+    }
+    double dPhi = particle.phi() - bkgPhiMin;
+    dPhi -= 2.0 * M_PI * std::floor(dPhi / (2.0 * M_PI));
+    if (dPhi >= phiRange) {
+      continue;
+    }
+    int iEta = std::min(static_cast<int>((eta - bkgEtaMin) / cellEta), nCellsEta - 1);
+    int iPhi = std::min(static_cast<int>(dPhi / cellPhi), nCellsPhi - 1);
+    gridCellPt[iEta * nCellsPhi + iPhi] += particle.perp();
+    gridCellMd[iEta * nCellsPhi + iPhi] += std::sqrt(particle.m() * particle.m() + particle.perp() * particle.perp()) - particle.perp();
+  }
+
+  // Fill a vector for pT/area of the occupied cells to be used for the median
+  std::vector<double> rhovector;
+  std::vector<double> rhoMdvector;
+  for (std::size_t iCell = 0; iCell < gridCellPt.size(); iCell++) {
+    if (gridCellPt[iCell] <= 0.0) {
+      continue;
+    }
+    rhovector.push_back(gridCellPt[iCell] / cellArea);
+    rhoMdvector.push_back(gridCellMd[iCell] / cellArea);
+  }
+
+  double rho = 0.0;
+  double rhoM = 0.0;
+  if (rhovector.size() != 0) {
+    rho = TMath::Median<double>(rhovector.size(), rhovector.data());
+    rhoM = TMath::Median<double>(rhoMdvector.size(), rhoMdvector.data());
+  }
+
+  if (doSparseSub) {
+    // the occupancy factor is the fraction of occupied cells
+    double occupancyFactor = static_cast<double>(rhovector.size()) / gridCellPt.size();
+    rho *= occupancyFactor;
+    rhoM *= occupancyFactor;
+  }
+
+  return std::make_tuple(rho, rhoM);
+}
+
+void JetBkgSubUtils::prepareRhoAreaMedian(const std::vector<fastjet::PseudoJet>& inputParticles)
+{
+  JetBkgSubUtils::initialise();
+
+  preparedParticles = inputParticles;
+  preparedParticleJet.assign(inputParticles.size(), -1);
+  preparedJets.clear();
+  preparedJetArea.clear();
+  preparedJetMd.clear();
+  preparedJetNPhysical.clear();
+  if (inputParticles.size() == 0) {
+    return;
+  }
+
+  // cluster the kT jets
+  fastjet::ClusterSequenceArea clusterSeq(inputParticles, jetDefBkg, areaDefBkg);
+
+  // select jets in detector acceptance
+  std::vector<fastjet::PseudoJet> alljets = selRho(clusterSeq.inclusive_jets());
+
+  for (auto& ijet : alljets) {
+    int iJet = preparedJets.size();
+    int nPhysical = 0;
+    for (auto& constituent : ijet.constituents()) {
+      // the input particles are the first entries of the clustering history, followed by the ghosts
+      int position = constituent.cluster_hist_index();
+      if (position >= 0 && position < static_cast<int>(inputParticles.size())) {
+        preparedParticleJet[position] = iJet;
+        nPhysical++;
+      }
+    }
+    preparedJets.push_back(ijet);
+    preparedJetArea.push_back(ijet.area());
+    preparedJetMd.push_back(getMd(ijet));
+    preparedJetNPhysical.push_back(nPhysical);
+  }
+}
+
+std::tuple<double, double> JetBkgSubUtils::estimateRhoAreaMedianExcluding(const std::vector<int>& excludedParticles, bool doSparseSub)
+{
+  if (preparedParticles.size() == 0) {
+    return std::make_tuple(0.0, 0.0);
+  }
+
+  // four-momentum, mT - pT and number of the removed particles for the affected jets
+  std::vector<std::tuple<int, fastjet::PseudoJet, double, int>> removed;
+  for (auto position : excludedParticles) {
+    int iJet = preparedParticleJet[position];
+    if (iJet < 0) {
+      continue;
+    }
+    const fastjet::PseudoJet& particle = preparedParticles[position];
+    double md = std::sqrt(particle.m() * particle.m() + particle.pt() * particle.pt()) - particle.pt();
+    auto it = std::find_if(removed.begin(), removed.end(), [iJet](const auto& entry) { return std::get<0>(entry) == iJet; });
+    if (it == removed.end()) {
+      removed.emplace_back(iJet, particle, md, 1);
+    } else {
+      std::get<1>(*it) += particle;
+      std::get<2>(*it) += md;
+      std::get<3>(*it) += 1;
+    }
+  }
+
+  double totaljetAreaPhys(0), totalAreaCovered(0);
+  std::vector<double> rhovector;
+  std::vector<double> rhoMdvector;
+
+  // Fill a vector for pT/area to be used for the median
+  for (std::size_t iJet = 0; iJet < preparedJets.size(); iJet++) {
+    double area = preparedJetArea[iJet];
+    if (area <= 0.0) {
+      continue;
+    }
+    double pt = preparedJets[iJet].perp();
+    double md = preparedJetMd[iJet];
+    int nPhysical = preparedJetNPhysical[iJet];
+    auto it = std::find_if(removed.begin(), removed.end(), [iJet](const auto& entry) { return std::get<0>(entry) == static_cast<int>(iJet); });
+    if (it != removed.end()) {
+      pt = (preparedJets[iJet] - std::get<1>(*it)).perp();
+      md -= std::get<2>(*it);
+      nPhysical -= std::get<3>(*it);
+    }
+    // Physical area/ Physical jets (no ghost)
+    if (nPhysical > 0) {
+      rhovector.push_back(pt / area);
+      rhoMdvector.push_back(md / area);
+
+      totaljetAreaPhys += area;
+    }
+    // Full area
+    totalAreaCovered += area;
+  }
+  // calculate Rho as the median of the jet pT / jet area
+
+  double rho = 0.0;
+  double rhoM = 0.0;
+  if (rhovector.size() != 0) {
+    rho = TMath::Median<double>(rhovector.size(), rhovector.data());
+    rhoM = TMath::Median<double>(rhoMdvector.size(), rhoMdvector.data());
+  }
+
+  if (doSparseSub) {
+    // calculate The ocupancy factor, which the ratio of covered area / total area
+    double occupancyFactor = totalAreaCovered > 0 ? totaljetAreaPhys / totalAreaCovered : 1.;
+    rho *= occupancyFactor;
+    rhoM *= occupancyFactor;
+  }
+
+  return std::make_tuple(rho, rhoM);
+}
+
 fastjet::PseudoJet JetBkgSubUtils::doRhoAreaSub(const fastjet::PseudoJet& jet, double rhoParam, double rhoMParam)
 {
 
@@ -120,6 +297,11 @@ fastjet::PseudoJet JetBkgSubUtils::doRhoAreaSub(const fastjet::PseudoJet& jet, d
 std::vector<fastjet::PseudoJet> JetBkgSubUtils::doEventConstSub(std::vector<fastjet::PseudoJet>& inputParticles, double rhoParam, double rhoMParam)
 {
   JetBkgSubUtils::initialise();
+  return subtractEventConst(inputParticles, rhoParam, rhoMParam);
+}
+
+std::vector<fastjet::PseudoJet> JetBkgSubUtils::subtractEventConst(std::vector<fastjet::PseudoJet>& inputParticles, double rhoParam, double rhoMParam) const
+{
   fastjet::contrib::ConstituentSubtractor constituentSub(rhoParam, rhoMParam);
   constituentSub.set_distance_type(fastjet::contrib::ConstituentSubtractor::deltaR); /// deltaR=sqrt((y_i-y_j)^2+(phi_i-phi_j)^2)), longitudinal Lorentz invariant
   constituentSub.set_max_distance(constSubRMax);
@@ -135,6 +317,77 @@ std::vector<fastjet::PseudoJet> JetBkgSubUtils::doEventConstSub(std::vector<fast
   return constituentSub.subtract_event(inputParticles, std::max(std::abs(bkgEtaMin), std::abs(bkgEtaMax)));
 }
 
+std::vector<fastjet::PseudoJet> JetBkgSubUtils::doEventConstSubTiled(std::vector<fastjet::PseudoJet>& inputParticles, double rhoParam, double rhoMParam, int nTiles, int nThreads, float tileMargin)
+{
+  const double tileWidth = 2. * M_PI / std::max(nTiles, 1);
+  const double margin = tileMargin * constSubRMax;
+  if (nTiles <= 1 || 2. * margin >= 2. * M_PI - tileWidth) { // the tiles would contain the full event
+    return doEventConstSub(inputParticles, rhoParam, rhoMParam);
+  }
+  JetBkgSubUtils::initialise();
+
+  auto coreTile = [&](double phi) {
+    return std::min(static_cast<int>(phi / tileWidth), nTiles - 1);
+  };
+  // particles of the core and of the margins of each tile
+  tileParticles.resize(nTiles);
+  for (auto& particles : tileParticles) {
+    particles.clear();
+  }
+  for (const auto& particle : inputParticles) {
+    double phi = particle.phi();
+    for (int iTile = 0; iTile < nTiles; iTile++) {
+      double dPhi = std::abs(RecoDecay::constrainAngle(phi - (iTile + 0.5) * tileWidth, -M_PI)); // distance to the middle of the tile
+      if (dPhi <= 0.5 * tileWidth + margin) {
+        tileParticles[iTile].push_back(particle);
+      }
+    }
+  }
+
+  tileSubtracted.resize(nTiles);
+  auto subtractTile = [&](int iTile) {
+    tileSubtracted[iTile] = subtractEventConst(tileParticles[iTile], rhoParam, rhoMParam);
+  };
+#ifdef FASTJET_HAVE_LIMITED_THREAD_SAFETY
+  const int nWorkers = std::min(nThreads, nTiles);
+#else
+  const int nWorkers = 1;
+  (void)nThreads;
+#endif
+  if (nWorkers <= 1) {
+    for (int iTile = 0; iTile < nTiles; iTile++) {
+      subtractTile(iTile);
+    }
+  } else {
+    std::atomic<int> nextTile{0};
+    auto worker = [&]() {
+      for (int iTile = nextTile++; iTile < nTiles; iTile = nextTile++) {
+        subtractTile(iTile);
+      }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(nWorkers - 1);
+    for (int iThread = 1; iThread < nWorkers; iThread++) {
+      threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  // the subtraction keeps the directions of the particles, so the subtracted particles are kept in the tile of their core
+  std::vector<fastjet::PseudoJet> subtractedParticles;
+  for (int iTile = 0; iTile < nTiles; iTile++) {
+    for (const auto& particle : tileSubtracted[iTile]) {
+      if (coreTile(particle.phi()) == iTile) {
+        subtractedParticles.push_back(particle);
+      }
+    }
+  }
+  return subtractedParticles;
+}
+
 std::vector<fastjet::PseudoJet> JetBkgSubUtils::doJetConstSub(std::vector<fastjet::PseudoJet>& jets, double rhoParam, double rhoMParam)
 {
   JetBkgSubUtils::initialise();
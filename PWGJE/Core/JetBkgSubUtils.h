@@ -68,6 +68,26 @@ class JetBkgSubUtils
   /// @return Rho, RhoM the underlying event density
   std::tuple<double, double> estimateRhoAreaMedian(const std::vector<fastjet::PseudoJet>& inputParticles, bool doSparseSub);
 
+  /// @brief Method for estimating the jet background density using the median of pT/area over the cells of an eta-phi grid, without jet clustering
+  /// @param inputParticles (all particles in the event)
+  /// @param doSparseSub weather to do rho sparse subtraction
+  /// @return Rho, RhoM the underlying event density
+  /// Note: the median is taken over the occupied cells, for the sparse subtraction it is scaled by the fraction of occupied cells. The result is close to,
+  /// but not identical with, the one of estimateRhoAreaMedian, the two methods should be compared for the chosen grid spacing before using this one
+  std::tuple<double, double> estimateRhoGridMedian(const std::vector<fastjet::PseudoJet>& inputParticles, bool doSparseSub);
+
+  /// @brief Method clustering the kT jets of the event once, such that the median background density can be re-derived for subsets of the particles
+  /// @param inputParticles (all particles in the event)
+  void prepareRhoAreaMedian(const std::vector<fastjet::PseudoJet>& inputParticles);
+
+  /// @brief Method estimating the jet background density as in estimateRhoAreaMedian, using the jets of prepareRhoAreaMedian from which some particles are removed
+  /// @param excludedParticles positions in the inputParticles of prepareRhoAreaMedian of the particles to be removed (e.g. the daughters of a candidate)
+  /// @param doSparseSub weather to do rho sparse subtraction
+  /// @return Rho, RhoM the underlying event density
+  /// Note: the removed particles are subtracted from the four-momentum of their jets, the jet areas and the rejection of the hardest jets are the ones of the full event.
+  /// This approximates the reclustering of the remaining particles, the difference being small if few particles are removed
+  std::tuple<double, double> estimateRhoAreaMedianExcluding(const std::vector<int>& excludedParticles, bool doSparseSub);
+
   /// @brief method that subtracts the background from jets using the area method
   /// @param jet input jet to be background subtracted
   /// @param rhoParam the underlying evvent density vs pT (to be set)
@@ -82,6 +102,19 @@ class JetBkgSubUtils
   /// @return inputParticles, a vector of background subtracted input particles
   std::vector<fastjet::PseudoJet> doEventConstSub(std::vector<fastjet::PseudoJet>& inputParticles, double rhoParam, double rhoMParam);
 
+  /// @brief method that subtracts the background as doEventConstSub, splitting the azimuth into tiles which are subtracted concurrently
+  /// @param inputParticles (all the tracks/clusters/particles in the event)
+  /// @param rhoParam the underlying evvent density vs pT (to be set)
+  /// @param rhoParam the underlying evvent density vs jet mass (to be set)
+  /// @param nTiles number of phi tiles
+  /// @param nThreads threads used to subtract the tiles (requires fastjet built with thread safety)
+  /// @param tileMargin margin, in units of the maximum distance of the subtraction, of the particles added on both sides of each tile
+  /// @return inputParticles, a vector of background subtracted input particles, ordered by tile
+  /// Note: each tile is subtracted with its particles and the ones of the margins, and only the particles of the tile are kept. A particle is subtracted exactly as
+  /// in doEventConstSub unless a chain of particle-ghost pairs closer than the maximum distance links it to a particle outside of the margins, which requires
+  /// at least tileMargin such pairs. Otherwise its subtracted pT differs by at most min(pT, rho * pi * constSubRMax^2), the pT of the ghosts it can be paired with
+  std::vector<fastjet::PseudoJet> doEventConstSubTiled(std::vector<fastjet::PseudoJet>& inputParticles, double rhoParam, double rhoMParam, int nTiles, int nThreads, float tileMargin = 2.);
+
   /// @brief method that subtracts the background from jets using the jet-wise constituent subtractor
   /// @param jets (all jets in the event)
   /// @param rhoParam the underlying evvent density vs pT (to be set)
@@ -108,6 +141,7 @@ class JetBkgSubUtils
   }
   void setDoRhoMassSub(bool doMSub_out = true) { doRhoMassSub = doMSub_out; }
   void setGhostAreaSpec(fastjet::GhostedAreaSpec ghostAreaSpec_out) { ghostAreaSpec = ghostAreaSpec_out; }
+  void setGridSpacing(float gridSpacing_out) { gridSpacing = gridSpacing_out; }
 
   // Getters
   float getJetBkgR() const { return jetBkgR; }
@@ -119,6 +153,7 @@ class JetBkgSubUtils
   float getConstSubRMax() const { return constSubRMax; }
   float getDoRhoMassSub() const { return doRhoMassSub; }
   fastjet::GhostedAreaSpec getGhostAreaSpec() const { return ghostAreaSpec; }
+  float getGridSpacing() const { return gridSpacing; }
   fastjet::JetDefinition getJetDefinition() const { return jetDefBkg; }
   fastjet::AreaDefinition getAreaDefinition() const { return areaDefBkg; }
   fastjet::Selector getRhoSelector() const { return selRho; }
@@ -136,6 +171,7 @@ class JetBkgSubUtils
   float constSubRMax = 0.24;
   int nHardReject = 2;
   bool doRhoMassSub = false; /// flag whether to do jet mass subtraction with the const sub
+  float gridSpacing = 0.55;  /// cell size in eta and phi for the grid median estimation
 
   fastjet::GhostedAreaSpec ghostAreaSpec = fastjet::GhostedAreaSpec();
   fastjet::JetAlgorithm algorithmBkg = fastjet::kt_algorithm;
@@ -144,6 +180,22 @@ class JetBkgSubUtils
   fastjet::AreaDefinition areaDefBkg = fastjet::AreaDefinition(fastjet::active_area_explicit_ghosts, ghostAreaSpec);
   fastjet::Selector selRho = fastjet::Selector();
 
+  std::vector<double> gridCellPt; /// pT sum of the cells of the grid median estimation
+  std::vector<double> gridCellMd; /// sum of mT - pT of the cells of the grid median estimation
+
+  std::vector<fastjet::PseudoJet> preparedParticles; /// input particles of prepareRhoAreaMedian
+  std::vector<int> preparedParticleJet;              /// index of the prepared jet containing each input particle, -1 if none
+  std::vector<fastjet::PseudoJet> preparedJets;      /// selected kT jets of prepareRhoAreaMedian
+  std::vector<double> preparedJetArea;               /// area of the prepared jets
+  std::vector<double> preparedJetMd;                 /// sum of mT - pT of the constituents of the prepared jets
+  std::vector<int> preparedJetNPhysical;             /// number of non-ghost constituents of the prepared jets
+
+  std::vector<std::vector<fastjet::PseudoJet>> tileParticles;  /// input particles of the tiles of doEventConstSubTiled
+  std::vector<std::vector<fastjet::PseudoJet>> tileSubtracted; /// subtracted particles of the tiles of doEventConstSubTiled
+
+  /// event-wise constituent subtraction of doEventConstSub, once the selectors are initialised
+  std::vector<fastjet::PseudoJet> subtractEventConst(std::vector<fastjet::PseudoJet>& inputParticles, double rhoParam, double rhoMParam) const;
+
 }; // class JetBkgSubUtils
 
 #endif // PWGJE_CORE_JETBKGSUBUTILS_H_
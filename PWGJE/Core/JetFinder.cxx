@@ -20,7 +20,13 @@
 #include <fastjet/JetDefinition.hh>
 #include <fastjet/PseudoJet.hh>
 #include <fastjet/Selector.hh>
+#include <fastjet/config.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
 #include <vector>
 
 /// Sets the jet finding parameters
@@ -65,3 +71,61 @@ fastjet::ClusterSequenceArea JetFinder::findJets(std::vector<fastjet::PseudoJet>
   jets = fastjet::sorted_by_pt(jets);
   return clusterSeq;
 }
+
+bool JetFinder::isThreadSafe()
+{
+#ifdef FASTJET_HAVE_LIMITED_THREAD_SAFETY
+  return true;
+#else
+  return false;
+#endif
+}
+
+std::size_t JetFinder::findJetsMultiR(const std::vector<fastjet::PseudoJet>& inputParticles, const std::vector<double>& radii, std::vector<std::vector<fastjet::PseudoJet>>& jets)
+{
+  const std::size_t nR = radii.size();
+  jets.resize(nR);
+  clusterSeqsMultiR.resize(nR);
+  jetDefsMultiR.resize(nR);
+  areaDefsMultiR.resize(nR);
+  selJetsMultiR.resize(nR);
+  // the definitions depend on the radius through the data members, so they are prepared serially
+  const float jetRInput = jetR;
+  for (std::size_t iR = 0; iR < nR; iR++) {
+    jetR = radii[iR];
+    setParams();
+    jetDefsMultiR[iR] = jetDef;
+    areaDefsMultiR[iR] = areaDef;
+    selJetsMultiR[iR] = selJets;
+  }
+  jetR = jetRInput;
+
+  auto clusterRadius = [&](std::size_t iR) {
+    clusterSeqsMultiR[iR] = std::make_unique<fastjet::ClusterSequenceArea>(inputParticles, jetDefsMultiR[iR], areaDefsMultiR[iR]);
+    jets[iR] = fastjet::sorted_by_pt(selJetsMultiR[iR](clusterSeqsMultiR[iR]->inclusive_jets()));
+  };
+
+  const int nWorkers = isThreadSafe() ? std::min<int>(nThreads, nR) : 1;
+  if (nWorkers <= 1) {
+    for (std::size_t iR = 0; iR < nR; iR++) {
+      clusterRadius(iR);
+    }
+    return nR;
+  }
+  std::atomic<std::size_t> nextR{0};
+  auto worker = [&]() {
+    for (std::size_t iR = nextR++; iR < nR; iR = nextR++) {
+      clusterRadius(iR);
+    }
+  };
+  std::vector<std::thread> threads;
+  threads.reserve(nWorkers - 1);
+  for (int iThread = 1; iThread < nWorkers; iThread++) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  return nR;
+}
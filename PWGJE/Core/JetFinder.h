@@ -27,6 +27,8 @@
 
 #include <Rtypes.h>
 
+#include <cstddef>
+#include <memory>
 #include <vector>
 
 #include <math.h>
@@ -81,6 +83,10 @@ class JetFinder
   fastjet::Selector selJets;
   fastjet::Selector selGhosts;
   double fastjetExtraParam = -99.0;
+  int nThreads = 1; // threads used by findJetsMultiR to cluster the different radii concurrently
+
+  /// Returns whether findJetsMultiR can cluster the radii concurrently (requires fastjet built with thread safety)
+  static bool isThreadSafe();
 
   /// Sets the jet finding parameters
   void setParams();
@@ -92,7 +98,22 @@ class JetFinder
   /// \return ClusterSequenceArea object needed to access constituents
   fastjet::ClusterSequenceArea findJets(std::vector<fastjet::PseudoJet>& inputParticles, std::vector<fastjet::PseudoJet>& jets); // ideally find a way of passing the cluster sequence as a reeference
 
+  /// Performs jet finding for several jet radii on the same input particles
+  /// \note the radii are clustered concurrently on up to nThreads threads, the jet definitions and selections being prepared beforehand for each radius
+  /// \note with several threads the ghosts of the different radii are drawn in a non-deterministic order, so jet areas are statistically, not bitwise, equivalent to the serial ones
+  /// \param inputParticles vector of input particles/tracks, shared by all radii
+  /// \param radii jet radii
+  /// \param jets vector of jets to be filled for each radius, in the order of radii
+  /// \return number of radii clustered. The cluster sequences, needed to access constituents, are owned by the JetFinder and valid until the next call
+  std::size_t findJetsMultiR(const std::vector<fastjet::PseudoJet>& inputParticles, const std::vector<double>& radii, std::vector<std::vector<fastjet::PseudoJet>>& jets);
+  const fastjet::ClusterSequenceArea& getClusterSequence(std::size_t iR) const { return *clusterSeqsMultiR[iR]; }
+
  private:
+  std::vector<std::unique_ptr<fastjet::ClusterSequenceArea>> clusterSeqsMultiR; //! cluster sequences of findJetsMultiR, reused between events
+  std::vector<fastjet::JetDefinition> jetDefsMultiR;                            //! jet definition of each radius
+  std::vector<fastjet::AreaDefinition> areaDefsMultiR;                          //! area definition of each radius
+  std::vector<fastjet::Selector> selJetsMultiR;                                 //! jet selection of each radius
+
   ClassDefNV(JetFinder, 1);
 };
 
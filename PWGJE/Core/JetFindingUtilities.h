@@ -36,6 +36,7 @@
 #include <fastjet/PseudoJet.hh>
 
 #include <cmath>
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <type_traits>
@@ -112,14 +113,15 @@ bool isTrackSelected(T const& track, int trackSelection, const U* candidate = nu
  * @param tracks track table to be added
  * @param trackSelection track selection to be applied to tracks
  * @param candidate optional HF candidiate
+ * @param withUserInfo attach a fastjet_user_info to each constituent, else the constituents are only identified by their user_index
  */
 
 template <typename T, typename U>
-void analyseTracks(std::vector<fastjet::PseudoJet>& inputParticles, T const& tracks, int trackSelection, const U* candidate = nullptr)
+void analyseTracks(std::vector<fastjet::PseudoJet>& inputParticles, T const& tracks, int trackSelection, const U* candidate = nullptr, bool withUserInfo = true)
 {
   for (auto& track : tracks) {
     if (isTrackSelected(track, trackSelection, candidate)) {
-      fastjetutilities::fillTracks(track, inputParticles, track.globalIndex());
+      fastjetutilities::fillTracks(track, inputParticles, track.globalIndex(), JetConstituentStatus::track, o2::constants::physics::MassPiPlus, withUserInfo);
     }
   }
 }
@@ -131,10 +133,11 @@ void analyseTracks(std::vector<fastjet::PseudoJet>& inputParticles, T const& tra
  * @param tracks track table to be added
  * @param trackSelection track selection to be applied to tracks
  * @param candidates candidiates
+ * @param withUserInfo attach a fastjet_user_info to each constituent
  */
 
 template <typename T, typename U>
-void analyseTracksMultipleCandidates(std::vector<fastjet::PseudoJet>& inputParticles, T const& tracks, int trackSelection, U const& candidates)
+void analyseTracksMultipleCandidates(std::vector<fastjet::PseudoJet>& inputParticles, T const& tracks, int trackSelection, U const& candidates, bool withUserInfo = true)
 {
   for (auto& track : tracks) {
     if (!jetderiveddatautilities::selectTrack(track, trackSelection)) {
@@ -145,7 +148,7 @@ void analyseTracksMultipleCandidates(std::vector<fastjet::PseudoJet>& inputParti
         continue;
       }
     }
-    fastjetutilities::fillTracks(track, inputParticles, track.globalIndex());
+    fastjetutilities::fillTracks(track, inputParticles, track.globalIndex(), JetConstituentStatus::track, o2::constants::physics::MassPiPlus, withUserInfo);
   }
 }
 
@@ -154,16 +157,17 @@ void analyseTracksMultipleCandidates(std::vector<fastjet::PseudoJet>& inputParti
  *
  * @param inputParticles fastjet container
  * @param clusters track table to be added
+ * @param withUserInfo attach a fastjet_user_info to each constituent
  */
 template <typename T>
-void analyseClusters(std::vector<fastjet::PseudoJet>& inputParticles, T const& clusters, int clusterDefinition, int hadronicCorrectionType)
+void analyseClusters(std::vector<fastjet::PseudoJet>& inputParticles, T const& clusters, int clusterDefinition, int hadronicCorrectionType, bool withUserInfo = true)
 {
   for (auto const& cluster : clusters) {
     // add cluster selections
     if (cluster.definition() != clusterDefinition) {
       continue;
     }
-    fastjetutilities::fillClusters(cluster, inputParticles, cluster.globalIndex(), hadronicCorrectionType);
+    fastjetutilities::fillClusters(cluster, inputParticles, cluster.globalIndex(), hadronicCorrectionType, JetConstituentStatus::cluster, withUserInfo);
   }
 }
 
@@ -176,9 +180,10 @@ void analyseClusters(std::vector<fastjet::PseudoJet>& inputParticles, T const& c
  * @param candYMin minimum Y of hf candidate
  * @param candYMax maximum Y of hf candidate
  * @param candidate hf candidate
+ * @param withUserInfo attach a fastjet_user_info to the constituent
  */
 template <typename T>
-bool analyseCandidate(std::vector<fastjet::PseudoJet>& inputParticles, T const& candidate, float candPtMin, float candPtMax, float candYMin, float candYMax)
+bool analyseCandidate(std::vector<fastjet::PseudoJet>& inputParticles, T const& candidate, float candPtMin, float candPtMax, float candYMin, float candYMax, bool withUserInfo = true)
 {
   auto candMass = jetcandidateutilities::getCandidatePDGMass(candidate);
   if (std::isnan(candidate.y())) {
@@ -190,7 +195,7 @@ bool analyseCandidate(std::vector<fastjet::PseudoJet>& inputParticles, T const&
   if (candidate.pt() < candPtMin || candidate.pt() >= candPtMax) {
     return false;
   }
-  fastjetutilities::fillTracks(candidate, inputParticles, candidate.globalIndex(), JetConstituentStatus::candidate, candMass);
+  fastjetutilities::fillTracks(candidate, inputParticles, candidate.globalIndex(), JetConstituentStatus::candidate, candMass, withUserInfo);
   return true;
 }
 
@@ -204,14 +209,15 @@ bool analyseCandidate(std::vector<fastjet::PseudoJet>& inputParticles, T const&
  * @param candYMax maximum Y of hf candidate
  * @param candidate hf candidate
  * @param rejectBackgroundMCCandidates choose whether to accept background hf candidates as defined by the selection flag
+ * @param withUserInfo attach a fastjet_user_info to the constituent
  */
 template <typename T>
-bool analyseCandidateMC(std::vector<fastjet::PseudoJet>& inputParticles, T const& candidate, float candPtMin, float candPtMax, float candYMin, float candYMax, bool rejectBackgroundMCCandidates)
+bool analyseCandidateMC(std::vector<fastjet::PseudoJet>& inputParticles, T const& candidate, float candPtMin, float candPtMax, float candYMin, float candYMax, bool rejectBackgroundMCCandidates, bool withUserInfo = true)
 {
   if (rejectBackgroundMCCandidates && !jetcandidateutilities::isMatchedCandidate(candidate)) {
     return false;
   }
-  return analyseCandidate(inputParticles, candidate, candPtMin, candPtMax, candYMin, candYMax);
+  return analyseCandidate(inputParticles, candidate, candPtMin, candPtMax, candYMin, candYMax, withUserInfo);
 }
 
 /**
@@ -226,7 +232,7 @@ bool analyseCandidateMC(std::vector<fastjet::PseudoJet>& inputParticles, T const
  * @param v0s V0 candidates
  */
 template <typename T>
-bool analyseV0s(std::vector<fastjet::PseudoJet>& inputParticles, T const& v0s, float v0PtMin, float v0PtMax, float v0YMin, float v0YMax, int v0Index, bool useV0SignalFlags)
+bool analyseV0s(std::vector<fastjet::PseudoJet>& inputParticles, T const& v0s, float v0PtMin, float v0PtMax, float v0YMin, float v0YMax, int v0Index, bool useV0SignalFlags, bool withUserInfo = true)
 {
   float v0Mass = 0;
   float v0Y = -10.0;
@@ -257,7 +263,7 @@ bool analyseV0s(std::vector<fastjet::PseudoJet>& inputParticles, T const& v0s, f
     if (v0.pt() < v0PtMin || v0.pt() >= v0PtMax) {
       continue;
     }
-    fastjetutilities::fillTracks(v0, inputParticles, v0.globalIndex(), JetConstituentStatus::candidate, v0Mass);
+    fastjetutilities::fillTracks(v0, inputParticles, v0.globalIndex(), JetConstituentStatus::candidate, v0Mass, withUserInfo);
     nSelectedV0s++;
   }
   if (nSelectedV0s > 0) {
@@ -284,10 +290,10 @@ void findJets(JetFinder& jetFinder, std::vector<fastjet::PseudoJet>& inputPartic
   auto jetRValues = static_cast<std::vector<double>>(jetRadius);
   jetFinder.jetPtMin = jetPtMin;
   jetFinder.jetPtMax = jetPtMax;
-  for (auto R : jetRValues) {
-    jetFinder.jetR = R;
-    std::vector<fastjet::PseudoJet> jets;
-    fastjet::ClusterSequenceArea clusterSeq(jetFinder.findJets(inputParticles, jets));
+  std::vector<int> tracks; // constituent indices, reused for all the jets of the event
+  std::vector<int> cands;
+  std::vector<int> clusters;
+  auto fillJets = [&](double R, std::vector<fastjet::PseudoJet> const& jets) {
     for (const auto& jet : jets) {
       if (jet.has_area() && jet.area() < jetAreaFractionMin * M_PI * R * R) {
         continue;
@@ -298,7 +304,7 @@ void findJets(JetFinder& jetFinder, std::vector<fastjet::PseudoJet>& inputPartic
       if (doCandidateJetFinding) {
         bool isCandidateJet = false;
         for (const auto& constituent : jet.constituents()) {
-          JetConstituentStatus constituentStatus = constituent.template user_info<fastjetutilities::fastjet_user_info>().getStatus();
+          JetConstituentStatus constituentStatus = fastjetutilities::getConstituentStatus(constituent);
           if (constituentStatus == JetConstituentStatus::candidate) { // note currently we cannot run V0 and HF in the same jet. If we ever need to we can seperate the loops
             isCandidateJet = true;
             break;
@@ -308,24 +314,39 @@ void findJets(JetFinder& jetFinder, std::vector<fastjet::PseudoJet>& inputPartic
           continue;
         }
       }
-      std::vector<int> tracks;
-      std::vector<int> cands;
-      std::vector<int> clusters;
+      tracks.clear();
+      cands.clear();
+      clusters.clear();
       jetsTable(collision.globalIndex(), jet.pt(), jet.eta(), jet.phi(),
                 jet.E(), jet.rapidity(), jet.m(), jet.has_area() ? jet.area() : 0., std::round(R * 100));
       for (const auto& constituent : sorted_by_pt(jet.constituents())) {
-        if (constituent.template user_info<fastjetutilities::fastjet_user_info>().getStatus() == JetConstituentStatus::track) {
-          tracks.push_back(constituent.template user_info<fastjetutilities::fastjet_user_info>().getIndex());
+        JetConstituentStatus constituentStatus = fastjetutilities::getConstituentStatus(constituent);
+        if (constituentStatus == JetConstituentStatus::track) {
+          tracks.push_back(fastjetutilities::getConstituentIndex(constituent));
         }
-        if (constituent.template user_info<fastjetutilities::fastjet_user_info>().getStatus() == JetConstituentStatus::cluster) {
-          clusters.push_back(constituent.template user_info<fastjetutilities::fastjet_user_info>().getIndex());
+        if (constituentStatus == JetConstituentStatus::cluster) {
+          clusters.push_back(fastjetutilities::getConstituentIndex(constituent));
         }
-        if (constituent.template user_info<fastjetutilities::fastjet_user_info>().getStatus() == JetConstituentStatus::candidate) {
-          cands.push_back(constituent.template user_info<fastjetutilities::fastjet_user_info>().getIndex());
+        if (constituentStatus == JetConstituentStatus::candidate) {
+          cands.push_back(fastjetutilities::getConstituentIndex(constituent));
         }
       }
       constituentsTable(jetsTable.lastIndex(), tracks, clusters, cands);
     }
+  };
+  if (jetFinder.nThreads > 1 && jetRValues.size() > 1) { // radii clustered concurrently, tables filled afterwards in the order of the radii
+    std::vector<std::vector<fastjet::PseudoJet>> jetsPerR;
+    jetFinder.findJetsMultiR(inputParticles, jetRValues, jetsPerR);
+    for (std::size_t iR = 0; iR < jetRValues.size(); iR++) {
+      fillJets(jetRValues[iR], jetsPerR[iR]);
+    }
+    return;
+  }
+  for (auto R : jetRValues) {
+    jetFinder.jetR = R;
+    std::vector<fastjet::PseudoJet> jets;
+    fastjet::ClusterSequenceArea clusterSeq(jetFinder.findJets(inputParticles, jets));
+    fillJets(R, jets);
   }
 }
 
@@ -338,9 +359,10 @@ void findJets(JetFinder& jetFinder, std::vector<fastjet::PseudoJet>& inputPartic
  * @param particles particle table to be added
  * @param pdgDatabase database of pdg codes
  * @param candidate optional hf candidiate
+ * @param withUserInfo attach a fastjet_user_info to each constituent
  */
 template <bool checkIsDaughter, typename T, typename U>
-void analyseParticles(std::vector<fastjet::PseudoJet>& inputParticles, const std::string& particleSelection, int jetTypeParticleLevel, T const& particles, o2::framework::Service<o2::framework::O2DatabasePDG> pdgDatabase, const U* candidate = nullptr)
+void analyseParticles(std::vector<fastjet::PseudoJet>& inputParticles, const std::string& particleSelection, int jetTypeParticleLevel, T const& particles, o2::framework::Service<o2::framework::O2DatabasePDG> pdgDatabase, const U* candidate = nullptr, bool withUserInfo = true)
 {
   for (auto& particle : particles) {
     if (particleSelection == "PhysicalPrimary" && !particle.isPhysicalPrimary()) { // CHECK : Does this exclude the HF hadron?
@@ -389,7 +411,7 @@ void analyseParticles(std::vector<fastjet::PseudoJet>& inputParticles, const std
         }
       }
     }
-    fastjetutilities::fillTracks(particle, inputParticles, particle.globalIndex(), JetConstituentStatus::track, pdgParticle->Mass());
+    fastjetutilities::fillTracks(particle, inputParticles, particle.globalIndex(), JetConstituentStatus::track, pdgParticle->Mass(), withUserInfo);
   }
 }
 
@@ -31,11 +31,14 @@
 #include <RtypesCore.h>
 
 #include <algorithm>
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <numeric>
 #include <ostream>
 #include <stdexcept>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include <math.h>
@@ -292,10 +295,230 @@ std::tuple<std::vector<int>, std::vector<int>> MatchJetsGeometrically(
   return std::make_tuple(baseToTagMap, tagToBaseMap);
 }
 
+/**
+ * Uniform eta-phi grid of a jet collection, periodic in phi, for the geometrical jet matching.
+ *
+ * The cells are at least as large as the matching distance, such that the jets closer than the matching
+ * distance to a point are in the 3x3 cells around it, the phi boundary being handled by wrapping the phi cells.
+ * The candidate positions shifted by +-2pi are the ones of `DuplicateJetsAroundPhiBoundary`, such that the nearest
+ * jet and its distance are the ones found by the KD-tree on the duplicated jets (up to exact ties in distance).
+ * The buffers are kept between the calls to `build`.
+ */
+template <typename T>
+class JetMatchingGrid
+{
+ public:
+  /**
+   * Fills the grid with a jet collection, which must stay valid while the grid is used.
+   *
+   * @param jetsPhi Jets phi
+   * @param jetsEta Jets eta
+   * @param maxMatchingDistance Maximum matching distance.
+   * @param additionalMargin Margin added to the matching distance for the duplication around the phi boundary, as in `DuplicateJetsAroundPhiBoundary`.
+   */
+  void build(const std::vector<T>& jetsPhi, const std::vector<T>& jetsEta, double maxMatchingDistance, double additionalMargin = 0.05)
+  {
+    phi = &jetsPhi;
+    eta = &jetsEta;
+    maxDistance = maxMatchingDistance;
+    duplicationDistance = maxMatchingDistance + additionalMargin;
+    nEtaCells = 0;
+    nPhiCells = 0;
+    if (jetsEta.empty() || !(maxMatchingDistance > 0.)) {
+      return;
+    }
+    etaMin = INFINITY;
+    double etaMax = -INFINITY;
+    for (auto jetEta : jetsEta) {
+      if (!std::isnan(jetEta)) {
+        etaMin = std::min<double>(etaMin, jetEta);
+        etaMax = std::max<double>(etaMax, jetEta);
+      }
+    }
+    if (!(etaMax >= etaMin)) {
+      return;
+    }
+    // cells of the size of the matching distance, enlarged if there would be many more cells than jets
+    double cellSize = maxMatchingDistance;
+    const double maxCells = 4. * jetsEta.size() + 16.;
+    double nCellsNominal = (std::floor((etaMax - etaMin) / cellSize) + 1.) * std::max(std::floor(2. * M_PI / cellSize), 1.);
+    if (nCellsNominal > maxCells) {
+      cellSize *= std::sqrt(nCellsNominal / maxCells);
+    }
+    etaCellSize = cellSize;
+    nEtaCells = static_cast<int>(std::floor((etaMax - etaMin) / etaCellSize)) + 1;
+    nPhiCells = std::max(static_cast<int>(std::floor(2. * M_PI / cellSize)), 1);
+    phiCellSize = 2. * M_PI / nPhiCells;
+
+    // jets sorted by cell (counting sort)
+    cellStart.assign(nEtaCells * nPhiCells + 1, 0);
+    jetCells.resize(jetsEta.size());
+    for (std::size_t i = 0; i < jetsEta.size(); i++) {
+      jetCells[i] = cellIndex(etaCell(jetsEta[i]), phiCell(jetsPhi[i]));
+      cellStart[jetCells[i] + 1]++;
+    }
+    for (std::size_t iCell = 1; iCell < cellStart.size(); iCell++) {
+      cellStart[iCell] += cellStart[iCell - 1];
+    }
+    cellJets.resize(jetsEta.size());
+    cellFill.assign(cellStart.begin(), cellStart.end() - 1);
+    for (std::size_t i = 0; i < jetsEta.size(); i++) {
+      cellJets[cellFill[jetCells[i]]++] = i;
+    }
+  }
+
+  /**
+   * Returns the index of the closest jet within the matching distance, or -1 if there is none.
+   *
+   * @param pointEta Eta of the point
+   * @param pointPhi Phi of the point
+   * @param distance Distance to the closest jet, if found
+   */
+  int findNearest(double pointEta, double pointPhi, double& distance) const
+  {
+    int index = -1;
+    if (nEtaCells == 0 || std::isnan(pointEta)) {
+      return index;
+    }
+    double etaPosition = std::floor((pointEta - etaMin) / etaCellSize);
+    if (etaPosition < -1. || etaPosition > nEtaCells) {
+      return index;
+    }
+    int iEtaPoint = static_cast<int>(etaPosition);
+    int iPhiPoint = phiCell(pointPhi);
+    int nPhiSearched = std::min(nPhiCells, 3);
+    for (int iEta = std::max(iEtaPoint - 1, 0); iEta <= std::min(iEtaPoint + 1, nEtaCells - 1); iEta++) {
+      for (int jPhi = 0; jPhi < nPhiSearched; jPhi++) {
+        int iPhi = (nPhiSearched < 3 ? jPhi : (iPhiPoint - 1 + jPhi + nPhiCells) % nPhiCells);
+        int iCell = cellIndex(iEta, iPhi);
+        for (int iJet = cellStart[iCell]; iJet < cellStart[iCell + 1]; iJet++) {
+          int jet = cellJets[iJet];
+          T jetPhi = (*phi)[jet];
+          checkCandidate(pointEta, pointPhi, jet, jetPhi, index, distance);
+          // shifted copies of the jets close to the phi boundary, see DuplicateJetsAroundPhiBoundary
+          if (jetPhi <= duplicationDistance) {
+            checkCandidate(pointEta, pointPhi, jet, static_cast<T>(jetPhi + 2 * M_PI), index, distance);
+          }
+          if (jetPhi >= (2 * M_PI - duplicationDistance)) {
+            checkCandidate(pointEta, pointPhi, jet, static_cast<T>(jetPhi - 2 * M_PI), index, distance);
+          }
+        }
+      }
+    }
+    return index;
+  }
+
+ private:
+  int etaCell(double jetEta) const { return std::isnan(jetEta) ? 0 : std::clamp(static_cast<int>(std::floor((jetEta - etaMin) / etaCellSize)), 0, nEtaCells - 1); }
+  int phiCell(double jetPhi) const
+  {
+    double wrappedPhi = jetPhi - 2. * M_PI * std::floor(jetPhi / (2. * M_PI));
+    if (std::isnan(wrappedPhi)) {
+      return 0;
+    }
+    return std::clamp(static_cast<int>(wrappedPhi / phiCellSize), 0, nPhiCells - 1);
+  }
+  int cellIndex(int iEta, int iPhi) const { return iEta * nPhiCells + iPhi; }
+
+  void checkCandidate(double pointEta, double pointPhi, int jet, T jetPhi, int& index, double& distance) const
+  {
+    // same distance as evaluated by the KD-tree
+    double dEta = pointEta - (*eta)[jet];
+    double dPhi = pointPhi - jetPhi;
+    double candidateDistance = std::sqrt(dEta * dEta + dPhi * dPhi);
+    if (candidateDistance < maxDistance && (index < 0 || candidateDistance < distance)) {
+      index = jet;
+      distance = candidateDistance;
+    }
+  }
+
+  const std::vector<T>* phi = nullptr;
+  const std::vector<T>* eta = nullptr;
+  double maxDistance = 0.;
+  double duplicationDistance = 0.;
+  double etaMin = 0.;
+  double etaCellSize = 1.;
+  double phiCellSize = 1.;
+  int nEtaCells = 0;
+  int nPhiCells = 0;
+  std::vector<int> cellStart; // first jet of each cell in cellJets
+  std::vector<int> cellFill;
+  std::vector<int> jetCells;
+  std::vector<int> cellJets; // jet indices, sorted by cell
+};
+
+/**
+ * Geometrical jet matching using eta-phi grids instead of KD-trees.
+ *
+ * Gives the same unique matches as `MatchJetsGeometrically` (up to exact ties in distance), without duplicating
+ * the jets around the phi boundary. The grids are passed by the caller such that their buffers can be reused.
+ *
+ * @param jetsBasePhi Base jet collection phi.
+ * @param jetsBaseEta Base jet collection eta.
+ * @param jetsTagPhi Tag jet collection phi.
+ * @param jetsTagEta Tag jet collection eta.
+ * @param maxMatchingDistance Maximum matching distance.
+ * @param gridBase Grid filled with the base jet collection.
+ * @param gridTag Grid filled with the tag jet collection.
+ *
+ * @returns (Base to tag index map, tag to base index map) for uniquely matched jets.
+ */
+template <typename T>
+std::tuple<std::vector<int>, std::vector<int>> MatchJetsGeometricallyGrid(
+  const std::vector<T>& jetsBasePhi,
+  const std::vector<T>& jetsBaseEta,
+  const std::vector<T>& jetsTagPhi,
+  const std::vector<T>& jetsTagEta,
+  double maxMatchingDistance,
+  JetMatchingGrid<T>& gridBase,
+  JetMatchingGrid<T>& gridTag)
+{
+  // Validation
+  const std::size_t nJetsBase = jetsBaseEta.size();
+  const std::size_t nJetsTag = jetsTagEta.size();
+  if (!(nJetsBase && nJetsTag)) {
+    // There are no jets, so nothing to be done.
+    return std::make_tuple(std::vector<int>(nJetsBase, -1), std::vector<int>(nJetsTag, -1));
+  }
+  // Input sizes must match
+  if (jetsBasePhi.size() != jetsBaseEta.size()) {
+    throw std::invalid_argument("Base collection eta and phi sizes don't match. Check the inputs.");
+  }
+  if (jetsTagPhi.size() != jetsTagEta.size()) {
+    throw std::invalid_argument("Tag collection eta and phi sizes don't match. Check the inputs.");
+  }
+
+  gridBase.build(jetsBasePhi, jetsBaseEta, maxMatchingDistance);
+  gridTag.build(jetsTagPhi, jetsTagEta, maxMatchingDistance);
+
+  // Find the closest jets in both directions
+  std::vector<int> matchIndexTag(nJetsBase, -1), matchIndexBase(nJetsTag, -1);
+  double distance = -1.;
+  for (std::size_t iBase = 0; iBase < nJetsBase; iBase++) {
+    matchIndexTag[iBase] = gridTag.findNearest(jetsBaseEta[iBase], jetsBasePhi[iBase], distance);
+  }
+  for (std::size_t iTag = 0; iTag < nJetsTag; iTag++) {
+    matchIndexBase[iTag] = gridBase.findNearest(jetsTagEta[iTag], jetsTagPhi[iTag], distance);
+  }
+
+  // True matches, where the base jet is the closest to the tag jet and vice versa
+  std::vector<int> baseToTagMap(nJetsBase, -1);
+  std::vector<int> tagToBaseMap(nJetsTag, -1);
+  for (std::size_t iBase = 0; iBase < nJetsBase; iBase++) {
+    if (matchIndexTag[iBase] > -1 && matchIndexBase[matchIndexTag[iBase]] == static_cast<int>(iBase)) {
+      baseToTagMap[iBase] = matchIndexTag[iBase];
+      tagToBaseMap[matchIndexTag[iBase]] = iBase;
+    }
+  }
+
+  return std::make_tuple(baseToTagMap, tagToBaseMap);
+}
+
 template <typename T, typename U>
-void MatchGeo(T const& jetsBasePerCollision, U const& jetsTagPerCollision, std::vector<std::vector<int>>& baseToTagMatchingGeo, std::vector<std::vector<int>>& tagToBaseMatchingGeo, float maxMatchingDistance)
+void MatchGeo(T const& jetsBasePerCollision, U const& jetsTagPerCollision, std::vector<std::vector<int>>& baseToTagMatchingGeo, std::vector<std::vector<int>>& tagToBaseMatchingGeo, float maxMatchingDistance, bool useMatchingGrid = false)
 {
   std::vector<double> jetsR;
+  JetMatchingGrid<double> gridBase, gridTag; // buffers shared by the jet radii
   for (const auto& jetBase : jetsBasePerCollision) {
     if (std::find(jetsR.begin(), jetsR.end(), std::round(jetBase.r())) == jetsR.end()) {
       jetsR.push_back(std::round(jetBase.r()));
@@ -332,7 +555,11 @@ void MatchGeo(T const& jetsBasePerCollision, U const& jetsTagPerCollision, std::
       jetsTagEta.emplace_back(jetTag.eta());
       jetsTagGlobalIndex.emplace_back(jetTag.globalIndex());
     }
-    std::tie(baseToTagMatchingGeoIndex, tagToBaseMatchingGeoIndex) = MatchJetsGeometrically(jetsBasePhi, jetsBaseEta, jetsTagPhi, jetsTagEta, maxMatchingDistance); // change max distnace to a function call
+    if (useMatchingGrid) {
+      std::tie(baseToTagMatchingGeoIndex, tagToBaseMatchingGeoIndex) = MatchJetsGeometricallyGrid(jetsBasePhi, jetsBaseEta, jetsTagPhi, jetsTagEta, maxMatchingDistance, gridBase, gridTag);
+    } else {
+      std::tie(baseToTagMatchingGeoIndex, tagToBaseMatchingGeoIndex) = MatchJetsGeometrically(jetsBasePhi, jetsBaseEta, jetsTagPhi, jetsTagEta, maxMatchingDistance); // change max distnace to a function call
+    }
     int jetBaseIndex = 0;
     int jetTagIndex = 0;
     for (const auto& jetBase : jetsBasePerCollision) {
@@ -421,6 +648,45 @@ auto constexpr getConstituentId(T const& track)
   }
 }
 
+// adds to ptSum the pt of the candidates of the base jet matched to candidates of the tag jet
+template <bool jetsBaseIsMc, bool jetsTagIsMc, typename U, typename P, typename R, typename S>
+void addCandidatePtSum(float& ptSum, U const& candidatesBase, P const& candidatesTag, R const& fullTracksBase, S const& fullTracksTag)
+{
+  if constexpr (jetsTagIsMc) {
+    for (auto const& candidateBase : candidatesBase) {
+      if (jetcandidateutilities::isMatchedCandidate(candidateBase)) {
+        const auto candidateBaseMcId = jetcandidateutilities::matchedParticleId(candidateBase, fullTracksBase, fullTracksTag);
+        for (auto const& candidateTag : candidatesTag) {
+          const auto candidateTagId = candidateTag.mcParticleId();
+          if (candidateBaseMcId == candidateTagId) {
+            ptSum += candidateBase.pt();
+          }
+        }
+      }
+    }
+  } else if constexpr (jetsBaseIsMc) {
+    for (auto const& candidateTag : candidatesTag) {
+      if (jetcandidateutilities::isMatchedCandidate(candidateTag)) {
+        const auto candidateTagMcId = jetcandidateutilities::matchedParticleId(candidateTag, fullTracksTag, fullTracksBase);
+        for (auto const& candidateBase : candidatesBase) {
+          const auto candidateBaseId = candidateBase.mcParticleId();
+          if (candidateTagMcId == candidateBaseId) {
+            ptSum += candidateTag.pt();
+          }
+        }
+      }
+    }
+  } else {
+    for (auto const& candidateBase : candidatesBase) {
+      for (auto const& candidateTag : candidatesTag) {
+        if (candidateBase.globalIndex() == candidateTag.globalIndex()) {
+          ptSum += candidateBase.pt();
+        }
+      }
+    }
+  }
+}
+
 template <bool isEMCAL, bool isCandidate, bool jetsBaseIsMc, bool jetsTagIsMc, typename T, typename U, typename V, typename O, typename P, typename Q, typename R, typename S>
 float getPtSum(T const& tracksBase, U const& candidatesBase, V const& clustersBase, O const& tracksTag, P const& candidatesTag, Q const& clustersTag, R const& fullTracksBase, S const& fullTracksTag)
 {
@@ -480,39 +746,7 @@ float getPtSum(T const& tracksBase, U const& candidatesBase, V const& clustersBa
     }
   }
   if constexpr (isCandidate) {
-    if constexpr (jetsTagIsMc) {
-      for (auto const& candidateBase : candidatesBase) {
-        if (jetcandidateutilities::isMatchedCandidate(candidateBase)) {
-          const auto candidateBaseMcId = jetcandidateutilities::matchedParticleId(candidateBase, fullTracksBase, fullTracksTag);
-          for (auto const& candidateTag : candidatesTag) {
-            const auto candidateTagId = candidateTag.mcParticleId();
-            if (candidateBaseMcId == candidateTagId) {
-              ptSum += candidateBase.pt();
-            }
-          }
-        }
-      }
-    } else if constexpr (jetsBaseIsMc) {
-      for (auto const& candidateTag : candidatesTag) {
-        if (jetcandidateutilities::isMatchedCandidate(candidateTag)) {
-          const auto candidateTagMcId = jetcandidateutilities::matchedParticleId(candidateTag, fullTracksTag, fullTracksBase);
-          for (auto const& candidateBase : candidatesBase) {
-            const auto candidateBaseId = candidateBase.mcParticleId();
-            if (candidateTagMcId == candidateBaseId) {
-              ptSum += candidateTag.pt();
-            }
-          }
-        }
-      }
-    } else {
-      for (auto const& candidateBase : candidatesBase) {
-        for (auto const& candidateTag : candidatesTag) {
-          if (candidateBase.globalIndex() == candidateTag.globalIndex()) {
-            ptSum += candidateBase.pt();
-          }
-        }
-      }
-    }
+    addCandidatePtSum<jetsBaseIsMc, jetsTagIsMc>(ptSum, candidatesBase, candidatesTag, fullTracksBase, fullTracksTag);
   }
   return ptSum;
 }
@@ -562,17 +796,126 @@ void MatchPt(T const& jetsBasePerCollision, U const& jetsTagPerCollision, std::v
   }
 }
 
+// flattened track constituents of a jet collection, with the identifiers used to compare them to the ones of the other collection
+struct JetTrackOverlapInput {
+  std::vector<int> jetR;
+  std::vector<int> trackStart; // first track of each jet
+  std::vector<int64_t> trackId;
+  std::vector<float> trackPt;
+  std::vector<std::pair<int64_t, int>> idToJet; // (identifier, jet) sorted, each pair present once
+
+  template <bool otherIsMc, typename T, typename V>
+  void fill(T const& jets, V const& tracks)
+  {
+    jetR.clear();
+    trackStart.assign(1, 0);
+    trackId.clear();
+    trackPt.clear();
+    idToJet.clear();
+    for (const auto& jet : jets) {
+      int iJet = jetR.size();
+      jetR.push_back(static_cast<int>(std::round(jet.r())));
+      for (const auto& track : getConstituents(jet, tracks)) {
+        auto id = getConstituentId<otherIsMc>(track);
+        trackId.push_back(id);
+        trackPt.push_back(track.pt());
+        if (id != -1) {
+          idToJet.emplace_back(id, iJet);
+        }
+      }
+      trackStart.push_back(trackId.size());
+    }
+    std::sort(idToJet.begin(), idToJet.end());
+    idToJet.erase(std::unique(idToJet.begin(), idToJet.end()), idToJet.end());
+  }
+
+  // adds the pt of the tracks of each jet of the other collection that are in each jet of this one, ptSums[iOther * nThis + iThis]
+  void addOverlapPt(const JetTrackOverlapInput& other, std::vector<float>& ptSums, bool otherIsRows) const
+  {
+    const int nThis = jetR.size();
+    const int nOther = other.jetR.size();
+    for (int iOther = 0; iOther < nOther; iOther++) {
+      for (int iTrack = other.trackStart[iOther]; iTrack < other.trackStart[iOther + 1]; iTrack++) {
+        if (other.trackId[iTrack] == -1) {
+          continue;
+        }
+        auto it = std::lower_bound(idToJet.begin(), idToJet.end(), std::make_pair(other.trackId[iTrack], 0));
+        for (; it != idToJet.end() && it->first == other.trackId[iTrack]; ++it) {
+          if (jetR[it->second] != other.jetR[iOther]) {
+            continue;
+          }
+          ptSums[otherIsRows ? iOther * nThis + it->second : it->second * nOther + iOther] += other.trackPt[iTrack];
+        }
+      }
+    }
+  }
+};
+
+// pt matching with the track overlaps of all the jet pairs computed in one pass over the constituents of each jet, giving the same matches as MatchPt
+// NOTE: The EMCAL cluster contributions depend on the tracks matched in each pair, the jets with clusters are therefore matched with MatchPt
+template <bool jetsBaseIsMc, bool jetsTagIsMc, typename T, typename U, typename V, typename M, typename N, typename O, typename P, typename Q>
+void MatchPtWithOverlapMap(T const& jetsBasePerCollision, U const& jetsTagPerCollision, std::vector<std::vector<int>>& baseToTagMatchingPt, std::vector<std::vector<int>>& tagToBaseMatchingPt, V const& tracksBase, M const& candidatesBase, N const& clustersBase, O const& tracksTag, P const& candidatesTag, Q const& clustersTag, float minPtFraction)
+{
+  constexpr bool IsEMCAL{jetfindingutilities::isEMCALClusterTable<N>() || jetfindingutilities::isEMCALClusterTable<Q>()};
+  constexpr bool IsCandidate{(jetcandidateutilities::isCandidateTable<M>() || jetcandidateutilities::isCandidateMcTable<M>()) && (jetcandidateutilities::isCandidateTable<P>() || jetcandidateutilities::isCandidateMcTable<P>())};
+  if constexpr (IsEMCAL) {
+    MatchPt<jetsBaseIsMc, jetsTagIsMc>(jetsBasePerCollision, jetsTagPerCollision, baseToTagMatchingPt, tagToBaseMatchingPt, tracksBase, candidatesBase, clustersBase, tracksTag, candidatesTag, clustersTag, minPtFraction);
+  } else {
+    JetTrackOverlapInput base, tag;
+    base.fill<jetsTagIsMc>(jetsBasePerCollision, tracksBase);
+    tag.fill<jetsBaseIsMc>(jetsTagPerCollision, tracksTag);
+    const int nTag = tag.jetR.size();
+    // the track pt are summed in the order of the constituents, as in getPtSum
+    std::vector<float> ptSumsBase(base.jetR.size() * nTag, 0.f), ptSumsTag(base.jetR.size() * nTag, 0.f);
+    tag.addOverlapPt(base, ptSumsBase, true);
+    base.addOverlapPt(tag, ptSumsTag, false);
+
+    int iBase = 0;
+    for (const auto& jetBase : jetsBasePerCollision) {
+      int iTag = 0;
+      for (const auto& jetTag : jetsTagPerCollision) {
+        if (base.jetR[iBase] != tag.jetR[iTag]) {
+          iTag++;
+          continue;
+        }
+        float ptSumBase = ptSumsBase[iBase * nTag + iTag];
+        float ptSumTag = ptSumsTag[iBase * nTag + iTag];
+        if constexpr (IsCandidate) {
+          if (jetBase.candidatesIds().size() > 0 && jetTag.candidatesIds().size() > 0) {
+            auto jetBaseCandidates = getConstituents(jetBase, candidatesBase);
+            auto jetTagCandidates = getConstituents(jetTag, candidatesTag);
+            addCandidatePtSum<jetsBaseIsMc, jetsTagIsMc>(ptSumBase, jetBaseCandidates, jetTagCandidates, tracksBase, tracksTag);
+            addCandidatePtSum<jetsTagIsMc, jetsBaseIsMc>(ptSumTag, jetTagCandidates, jetBaseCandidates, tracksTag, tracksBase);
+          }
+        }
+        if (ptSumBase > jetBase.pt() * minPtFraction) {
+          baseToTagMatchingPt[jetBase.globalIndex()].push_back(jetTag.globalIndex());
+        }
+        if (ptSumTag > jetTag.pt() * minPtFraction) {
+          tagToBaseMatchingPt[jetTag.globalIndex()].push_back(jetBase.globalIndex());
+        }
+        iTag++;
+      }
+      iBase++;
+    }
+  }
+}
+
 // function that calls all the Match functions
 template <bool jetsBaseIsMc, bool jetsTagIsMc, typename T, typename U, typename V, typename M, typename N, typename O, typename P, typename R>
-void doAllMatching(T const& jetsBasePerCollision, U const& jetsTagPerCollision, std::vector<std::vector<int>>& baseToTagMatchingGeo, std::vector<std::vector<int>>& baseToTagMatchingPt, std::vector<std::vector<int>>& baseToTagMatchingHF, std::vector<std::vector<int>>& tagToBaseMatchingGeo, std::vector<std::vector<int>>& tagToBaseMatchingPt, std::vector<std::vector<int>>& tagToBaseMatchingHF, V const& candidatesBase, M const& tracksBase, N const& clustersBase, O const& candidatesTag, P const& tracksTag, R const& clustersTag, bool doMatchingGeo, bool doMatchingHf, bool doMatchingPt, float maxMatchingDistance, float minPtFraction)
+void doAllMatching(T const& jetsBasePerCollision, U const& jetsTagPerCollision, std::vector<std::vector<int>>& baseToTagMatchingGeo, std::vector<std::vector<int>>& baseToTagMatchingPt, std::vector<std::vector<int>>& baseToTagMatchingHF, std::vector<std::vector<int>>& tagToBaseMatchingGeo, std::vector<std::vector<int>>& tagToBaseMatchingPt, std::vector<std::vector<int>>& tagToBaseMatchingHF, V const& candidatesBase, M const& tracksBase, N const& clustersBase, O const& candidatesTag, P const& tracksTag, R const& clustersTag, bool doMatchingGeo, bool doMatchingHf, bool doMatchingPt, float maxMatchingDistance, float minPtFraction, bool useMatchingGrid = false, bool useOverlapMap = false)
 {
   // geometric matching
   if (doMatchingGeo) {
-    MatchGeo(jetsBasePerCollision, jetsTagPerCollision, baseToTagMatchingGeo, tagToBaseMatchingGeo, maxMatchingDistance);
+    MatchGeo(jetsBasePerCollision, jetsTagPerCollision, baseToTagMatchingGeo, tagToBaseMatchingGeo, maxMatchingDistance, useMatchingGrid);
   }
   // pt matching
   if (doMatchingPt) {
-    MatchPt<jetsBaseIsMc, jetsTagIsMc>(jetsBasePerCollision, jetsTagPerCollision, baseToTagMatchingPt, tagToBaseMatchingPt, tracksBase, candidatesBase, clustersBase, tracksTag, candidatesTag, clustersTag, minPtFraction);
+    if (useOverlapMap) {
+      MatchPtWithOverlapMap<jetsBaseIsMc, jetsTagIsMc>(jetsBasePerCollision, jetsTagPerCollision, baseToTagMatchingPt, tagToBaseMatchingPt, tracksBase, candidatesBase, clustersBase, tracksTag, candidatesTag, clustersTag, minPtFraction);
+    } else {
+      MatchPt<jetsBaseIsMc, jetsTagIsMc>(jetsBasePerCollision, jetsTagPerCollision, baseToTagMatchingPt, tagToBaseMatchingPt, tracksBase, candidatesBase, clustersBase, tracksTag, candidatesTag, clustersTag, minPtFraction);
+    }
   }
   // HF matching
   if constexpr (jetcandidateutilities::isCandidateTable<V>() || jetcandidateutilities::isCandidateMcTable<V>()) {
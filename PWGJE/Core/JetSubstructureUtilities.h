@@ -24,13 +24,16 @@
 
 #include <Framework/ASoA.h>
 
+#include <fastjet/ClusterSequence.hh>
 #include <fastjet/ClusterSequenceArea.hh>
+#include <fastjet/JetDefinition.hh>
 #include <fastjet/PseudoJet.hh>
 #include <fastjet/contrib/MeasureDefinition.hh>
 #include <fastjet/contrib/Nsubjettiness.hh>
 #include <fastjet/contrib/SoftDrop.hh>
 
 #include <cmath>
+#include <memory>
 #include <type_traits>
 #include <vector>
 
@@ -38,18 +41,18 @@ namespace jetsubstructureutilities
 {
 
 /**
- * convert an O2Physics jet to a fastjet pseudojet object, returning its clusterSequence
+ * fill the constituents of an O2Physics jet as fastjet pseudojet objects
  *
- * @param jet jet to be converted
+ * @param jet jet whose constituents are filled
  * @param tracks vector of constituent tracks
  * @param clusters vector of constituent clusters
  * @param candidates vector of constituent candidates
- * @param pseudoJet converted pseudoJet object which is passed by reference
+ * @param jetConstituents vector of pseudojets to be filled, cleared first such that its allocation is reused
  */
 template <typename T, typename U, typename V, typename O>
-fastjet::ClusterSequenceArea jetToPseudoJet(T const& jet, U const& /*tracks*/, V const& /*clusters*/, O const& /*candidates*/, fastjet::PseudoJet& pseudoJet, int hadronicCorrectionType = 0)
+void fillJetConstituents(T const& jet, U const& /*tracks*/, V const& /*clusters*/, O const& /*candidates*/, std::vector<fastjet::PseudoJet>& jetConstituents, int hadronicCorrectionType = 0)
 {
-  std::vector<fastjet::PseudoJet> jetConstituents;
+  jetConstituents.clear();
   for (auto& jetConstituent : jet.template tracks_as<U>()) {
     fastjetutilities::fillTracks(jetConstituent, jetConstituents, jetConstituent.globalIndex());
   }
@@ -63,6 +66,22 @@ fastjet::ClusterSequenceArea jetToPseudoJet(T const& jet, U const& /*tracks*/, V
       fastjetutilities::fillTracks(jetHFConstituent, jetConstituents, jetHFConstituent.globalIndex(), JetConstituentStatus::candidate, jetcandidateutilities::getTablePDGMass<O>());
     }
   }
+}
+
+/**
+ * convert an O2Physics jet to a fastjet pseudojet object, returning its clusterSequence
+ *
+ * @param jet jet to be converted
+ * @param tracks vector of constituent tracks
+ * @param clusters vector of constituent clusters
+ * @param candidates vector of constituent candidates
+ * @param pseudoJet converted pseudoJet object which is passed by reference
+ */
+template <typename T, typename U, typename V, typename O>
+fastjet::ClusterSequenceArea jetToPseudoJet(T const& jet, U const& tracks, V const& clusters, O const& candidates, fastjet::PseudoJet& pseudoJet, int hadronicCorrectionType = 0)
+{
+  std::vector<fastjet::PseudoJet> jetConstituents;
+  fillJetConstituents(jet, tracks, clusters, candidates, jetConstituents, hadronicCorrectionType);
   std::vector<fastjet::PseudoJet> jetReclustered;
 
   JetFinder jetReclusterer;
@@ -75,40 +94,71 @@ fastjet::ClusterSequenceArea jetToPseudoJet(T const& jet, U const& /*tracks*/, V
 }
 
 /**
- * returns a vector with Nsubjettiness variables
+ * reclusters the constituents of a jet without area (no ghosts are needed for the substructure within the jet)
  *
- * @param jet jet
- * @param tracks track table to be added
- * @param clusters clusters table to be added (if no clusters just add track table here)
- * @param candidates candidates table to be added (if no candidates just add track table here)
- * @param nMax returns a vector filled with TauN values upto N (the first entry is the distance between axes in tau2)
- * @param reclusteringAlgorithm type of reclustering algorithm used to find Nsubjettiness axes
- * @param doSoftDrop apply SoftDrop
- * @param zCut minimim momentum sharing fraction needed to satisfy the SoftDrop condition
- * @param beta angular exponent in the SoftDrop condition
+ * The cluster sequence is kept until the next reclustering, such that the softdrop, Lund plane and N-subjettiness observables
+ * of a jet can all be computed from the same reclustering history
  */
+class JetReclusterer
+{
+ public:
+  fastjet::JetAlgorithm algorithm = fastjet::cambridge_algorithm;
+  fastjet::RecombinationScheme recombScheme = fastjet::E_scheme;
 
-// function that returns the N-subjettiness ratio and the distance betewwen the two axes considered for tau2, in the form of a vector
-template <typename T, typename U, typename V, typename O, typename M>
-std::vector<float> getNSubjettiness(T const& jet, U const& tracks, V const& clusters, O const& candidates, std::vector<fastjet::PseudoJet>::size_type nMax, M const& reclusteringAlgorithm, bool doSoftDrop = false, float zCut = 0.1, float beta = 0.0, int hadronicCorrectionType = 0)
+  /// reclusters the constituents with a radius large enough to merge all of them (as JetFinder::isReclustering)
+  /// \param jetConstituents constituents of the jet
+  /// \param jetR radius of the jet
+  /// \return leading reclustered jet, an empty pseudojet if there are no constituents
+  fastjet::PseudoJet recluster(const std::vector<fastjet::PseudoJet>& jetConstituents, float jetR)
+  {
+    reclusteredJet = fastjet::PseudoJet();
+    if (jetConstituents.empty()) {
+      return reclusteredJet;
+    }
+    fastjet::JetDefinition jetDef(algorithm, 5.0 * jetR, recombScheme, fastjet::Best);
+    clusterSeq = std::make_unique<fastjet::ClusterSequence>(jetConstituents, jetDef);
+    std::vector<fastjet::PseudoJet> jetReclustered = fastjet::sorted_by_pt(clusterSeq->inclusive_jets());
+    if (!jetReclustered.empty()) {
+      reclusteredJet = jetReclustered[0];
+    }
+    return reclusteredJet;
+  }
+
+  /// \return leading jet of the last reclustering
+  const fastjet::PseudoJet& getReclusteredJet() const { return reclusteredJet; }
+
+ private:
+  std::unique_ptr<fastjet::ClusterSequence> clusterSeq; // cluster sequence of the last reclustering
+  fastjet::PseudoJet reclusteredJet;
+};
+
+/**
+ * returns a vector with Nsubjettiness variables for an already reclustered jet (e.g. the one of JetReclusterer)
+ *
+ * @param pseudoJet reclustered jet
+ * @param jetR radius of the jet
+ * see getNSubjettiness for the other arguments
+ */
+template <typename M>
+std::vector<float> getPseudoJetNSubjettiness(fastjet::PseudoJet pseudoJet, float jetR, std::vector<fastjet::PseudoJet>::size_type nMax, M const& reclusteringAlgorithm, bool doSoftDrop = false, float zCut = 0.1, float beta = 0.0)
 {
   std::vector<float> result;
-  fastjet::PseudoJet pseudoJet;
-  fastjet::ClusterSequenceArea clusterSeq(jetToPseudoJet(jet, tracks, clusters, candidates, pseudoJet, hadronicCorrectionType));
+  for (std::vector<fastjet::PseudoJet>::size_type n = 0; n < nMax + 1; n++) {
+    result.push_back(-1.0 * (n + 1));
+  }
+  if (!pseudoJet.has_constituents()) {
+    return result;
+  }
   if (doSoftDrop) {
     fastjet::contrib::SoftDrop softDrop(beta, zCut);
     pseudoJet = softDrop(pseudoJet);
   }
 
-  for (std::vector<fastjet::PseudoJet>::size_type n = 0; n < nMax + 1; n++) {
-    result.push_back(-1.0 * (n + 1));
-  }
-
   for (std::vector<fastjet::PseudoJet>::size_type n = 1; n <= nMax; n++) {
     if (pseudoJet.constituents().size() < n) { // Tau_N needs at least N tracks
       return result;
     }
-    fastjet::contrib::Nsubjettiness nSub(n, reclusteringAlgorithm, fastjet::contrib::NormalizedMeasure(1.0, jet.r() / 100.0));
+    fastjet::contrib::Nsubjettiness nSub(n, reclusteringAlgorithm, fastjet::contrib::NormalizedMeasure(1.0, jetR));
     result[n] = nSub.result(pseudoJet);
     if (n == 2) {
       std::vector<fastjet::PseudoJet> nSubAxes = nSub.currentAxes(); // gets the two axes used in the 2-subjettiness calculation
@@ -118,6 +168,29 @@ std::vector<float> getNSubjettiness(T const& jet, U const& tracks, V const& clus
   return result;
 }
 
+/**
+ * returns a vector with Nsubjettiness variables
+ *
+ * @param jet jet
+ * @param tracks track table to be added
+ * @param clusters clusters table to be added (if no clusters just add track table here)
+ * @param candidates candidates table to be added (if no candidates just add track table here)
+ * @param nMax returns a vector filled with TauN values upto N (the first entry is the distance between axes in tau2)
+ * @param reclusteringAlgorithm type of reclustering algorithm used to find Nsubjettiness axes
+ * @param doSoftDrop apply SoftDrop
+ * @param zCut minimim momentum sharing fraction needed to satisfy the SoftDrop condition
+ * @param beta angular exponent in the SoftDrop condition
+ */
+
+// function that returns the N-subjettiness ratio and the distance betewwen the two axes considered for tau2, in the form of a vector
+template <typename T, typename U, typename V, typename O, typename M>
+std::vector<float> getNSubjettiness(T const& jet, U const& tracks, V const& clusters, O const& candidates, std::vector<fastjet::PseudoJet>::size_type nMax, M const& reclusteringAlgorithm, bool doSoftDrop = false, float zCut = 0.1, float beta = 0.0, int hadronicCorrectionType = 0)
+{
+  fastjet::PseudoJet pseudoJet;
+  fastjet::ClusterSequenceArea clusterSeq(jetToPseudoJet(jet, tracks, clusters, candidates, pseudoJet, hadronicCorrectionType));
+  return getPseudoJetNSubjettiness(pseudoJet, jet.r() / 100.0, nMax, reclusteringAlgorithm, doSoftDrop, zCut, beta);
+}
+
 }; // namespace jetsubstructureutilities
 
 #endif // PWGJE_CORE_JETSUBSTRUCTUREUTILITIES_H_
@@ -23,7 +23,7 @@
 #include <Framework/HistogramRegistry.h>
 #include <Framework/HistogramSpec.h>
 
-#include <algorithm> // std::find_if
+#include <algorithm>
 #include <array>
 #include <cstddef> // size_t
 #include <cstdlib> // std::abs
@@ -134,6 +134,8 @@ void EMCCrossTalk::initObjects(const EmcCrossTalkConf& config)
   mGeometry = o2::emcal::Geometry::GetInstanceFromRunNumber(run3RunNumber);
   if (!mGeometry) {
     LOG(error) << "Failure accessing mGeometry";
+  } else {
+    initCellLayout();
   }
 
   // first set the simple run time variables
@@ -185,12 +187,26 @@ void EMCCrossTalk::initObjects(const EmcCrossTalkConf& config)
   }
 }
 
-void EMCCrossTalk::resetArrays()
+void EMCCrossTalk::initCellLayout()
 {
-  for (size_t j = 0; j < NCells; j++) {
-    mTCardCorrCellsEner[j] = 0.;
-    mTCardCorrCellsNew[j] = false;
+  for (auto& grid : mAbsIdGrid) { // o2-linter: disable=const-ref-in-for-loop (we are changing a value here)
+    grid.fill(-1);
+  }
+  for (int absId = 0; absId < NCells; ++absId) {
+    auto [iSM, iMod, iIphi, iIeta] = mGeometry->GetCellIndex(absId);
+    auto [iphi, ieta] = mGeometry->GetCellPhiEtaIndexInSModule(iSM, iMod, iIphi, iIeta);
+    mCellSM[absId] = iSM;
+    mCellRow[absId] = iphi;
+    mCellColumn[absId] = ieta;
+    mAbsIdGrid[iSM][iphi * MaxNColumns + ieta] = absId;
   }
+}
+
+void EMCCrossTalk::resetArrays()
+{
+  mTCardCorrCellsEner.fill(0.f);
+  mTCardCorrCellsNew.fill(false);
+  mCellIndex.fill(-1);
 
   mCellsTmp.clear();
 }
@@ -200,6 +216,10 @@ void EMCCrossTalk::setCells(std::vector<o2::emcal::Cell>& cells, std::vector<o2:
   mCells = &cells;
   mCellsTmp = cells; // a copy since we will need one vector with the changed energies and one with the original ones
   mCellLabels = &cellLabels;
+  // index of the cells by absId, replaces a search in the cells for each neighbour
+  for (size_t iCell = cells.size(); iCell-- > 0;) {
+    mCellIndex[cells[iCell].getTower()] = iCell; // the first cell wins for duplicated absIds, as with a forward search
+  }
 }
 
 void EMCCrossTalk::calculateInducedEnergyInTCardCell(int absId, int absIdRef, int iSM, float ampRef, int cellCase)
@@ -231,10 +251,8 @@ void EMCCrossTalk::calculateInducedEnergyInTCardCell(int absId, int absIdRef, in
       ietaMax = 15;
     }
 
-    // First get the SM, col-row of this tower
-    // int imod = -1, iphi =-1, ieta=-1,iTower = -1, iIphi = -1, iIeta = -1;
-    auto [iSM, iMod, iIphi, iIeta] = mGeometry->GetCellIndex(absId);
-    auto [iphi, ieta] = mGeometry->GetCellPhiEtaIndexInSModule(iSM, iMod, iIphi, iIeta);
+    // First get the col of this tower
+    const int ieta = mCellColumn[absId];
 
     if (ieta >= ietaMin && ieta <= ietaMax) {
       if (frac < mTCardCorrInduceEnerFracMinCentralEta[iSM])
@@ -266,13 +284,11 @@ void EMCCrossTalk::calculateInducedEnergyInTCardCell(int absId, int absIdRef, in
 
   // Try to find the cell that will get energy induced
   float amp = 0.f;
-  auto itCell = std::find_if((*mCells).begin(), (*mCells).end(), [absId](const o2::emcal::Cell& cell) {
-    return cell.getTower() == absId;
-  });
+  const int indexInCells = mCellIndex[absId];
 
-  if (itCell != (*mCells).end()) {
+  if (indexInCells >= 0) {
     // We found a cell, so let's get the amplitude of that cell
-    amp = itCell->getAmplitude();
+    amp = (*mCells)[indexInCells].getAmplitude();
   } else {
     amp = 0.f; // this is a new cell, so the base amp is 0.f
   }
@@ -314,8 +330,9 @@ void EMCCrossTalk::makeCellTCardCorrelation()
     }
 
     // First get the SM, col-row of this tower
-    auto [iSM, iMod, iIphi, iIeta] = mGeometry->GetCellIndex(id);
-    auto [iphi, ieta] = mGeometry->GetCellPhiEtaIndexInSModule(iSM, iMod, iIphi, iIeta);
+    const int iSM = mCellSM[id];
+    const int iphi = mCellRow[id];
+    const int ieta = mCellColumn[id];
 
     // Determine randomly if we want to create a correlation for this cell,
     // depending the SM number of the cell
@@ -347,31 +364,31 @@ void EMCCrossTalk::makeCellTCardCorrelation()
       colShift = -1;
     }
 
-    absIDlr = mGeometry->GetAbsCellIdFromCellIndexes(iSM, iphi, ieta + colShift);
+    absIDlr = absIdAt(iSM, iphi, ieta + colShift);
 
     // Check if up / down cells from reference cell are not out of SM
     // First check if there is space one above
     if (iphi < emcal::EMCAL_ROWS - 1) {
-      absIDup = mGeometry->GetAbsCellIdFromCellIndexes(iSM, iphi + 1, ieta);
-      absIDuplr = mGeometry->GetAbsCellIdFromCellIndexes(iSM, iphi + 1, ieta + colShift);
+      absIDup = absIdAt(iSM, iphi + 1, ieta);
+      absIDuplr = absIdAt(iSM, iphi + 1, ieta + colShift);
     }
 
     // 2nd check if there is space one below
     if (iphi > 0) {
-      absIDdo = mGeometry->GetAbsCellIdFromCellIndexes(iSM, iphi - 1, ieta);
-      absIDdolr = mGeometry->GetAbsCellIdFromCellIndexes(iSM, iphi - 1, ieta + colShift);
+      absIDdo = absIdAt(iSM, iphi - 1, ieta);
+      absIDdolr = absIdAt(iSM, iphi - 1, ieta + colShift);
     }
 
     // 3rd check if there is space two above
     if (iphi < emcal::EMCAL_ROWS - 2) {
-      absIDup2 = mGeometry->GetAbsCellIdFromCellIndexes(iSM, iphi + 2, ieta);
-      absIDup2lr = mGeometry->GetAbsCellIdFromCellIndexes(iSM, iphi + 2, ieta + colShift);
+      absIDup2 = absIdAt(iSM, iphi + 2, ieta);
+      absIDup2lr = absIdAt(iSM, iphi + 2, ieta + colShift);
     }
 
     // 4th check if there is space two below
     if (iphi > 1) {
-      absIDdo2 = mGeometry->GetAbsCellIdFromCellIndexes(iSM, iphi - 2, ieta);
-      absIDdo2lr = mGeometry->GetAbsCellIdFromCellIndexes(iSM, iphi - 2, ieta + colShift);
+      absIDdo2 = absIdAt(iSM, iphi - 2, ieta);
+      absIDdo2lr = absIdAt(iSM, iphi - 2, ieta + colShift);
     }
 
     // Check if those cells are in the same T-Card
@@ -510,8 +527,9 @@ void EMCCrossTalk::addInducedEnergiesToNewCells()
     // Still assign 0 as fraction of energy.
 
     // First get the iphi and ieta of this tower
-    auto [iSM, iMod, iIphi, iIeta] = mGeometry->GetCellIndex(absId);
-    auto [iphi, ieta] = mGeometry->GetCellPhiEtaIndexInSModule(iSM, iMod, iIphi, iIeta);
+    const int iSM = mCellSM[absId];
+    const int iphi = mCellRow[absId];
+    const int ieta = mCellColumn[absId];
 
     LOGF(debug, "Trying to add cell %d \t ieta = %d\t iphi = %d\t amplitude = %1.3f", absId, ieta, iphi, amp);
 
@@ -531,21 +549,20 @@ void EMCCrossTalk::addInducedEnergiesToNewCells()
           continue;
         }
 
-        int absIDi = mGeometry->GetAbsCellIdFromCellIndexes(iSM, iphii, ietai);
-        // Try to find the cell that will get energy induced
+        int absIDi = absIdAt(iSM, iphii, ietai);
+        if (absIDi < 0) {
+          continue;
+        }
+        // Try to find the cell that will get energy induced, the index only holds the original cells
         float ampi = 0.f;
-        size_t indexInCells = 0;
-        auto itCell = std::find_if((*mCells).begin(), (*mCells).begin() + nCells, [absIDi](const o2::emcal::Cell& cell) {
-          return cell.getTower() == absIDi;
-        });
+        const int indexInCells = mCellIndex[absIDi];
 
-        if (itCell != (*mCells).begin() + nCells) {
+        if (indexInCells >= 0) {
           // We found a cell, so let's get the amplitude of that cell
-          ampi = itCell->getAmplitude();
+          ampi = (*mCells)[indexInCells].getAmplitude();
           if (ampi <= ampMax) {
             continue; // early continue if the new amplitude is not the biggest one
           }
-          indexInCells = std::distance((*mCells).begin(), itCell);
           LOGF(debug, "Found cell with index %d", indexInCells);
         } else {
           continue;
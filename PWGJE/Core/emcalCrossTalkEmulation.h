@@ -27,6 +27,7 @@
 #include <TRandom3.h>
 
 #include <array>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -126,6 +127,8 @@ static constexpr int NNeighbourCases = 4;     // 0-same row, diff col, 1-up/down
 static constexpr int FirstDCal23SM = 12;      // index of the first 2/3 DCal SM
 static constexpr int LastDCal23SM = 17;       // index of the last 2/3 DCal SM
 static constexpr float MinCellEnergy = 0.01f; // Minimum energy a new cell needs to be added
+static constexpr int MaxNRows = 24;           // Number of rows of a full SM
+static constexpr int MaxNColumns = 48;        // Number of columns of a full SM
 
 static constexpr int NColumns[NSM] = {48, 48, 48, 48, 48, 48, 48, 48, 48, 48, 48, 48, 32, 32, 32, 32, 32, 32, 48, 48};
 static constexpr int NRows[NSM] = {24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 8, 8, 24, 24, 24, 24, 24, 24, 8, 8};
@@ -179,6 +182,26 @@ class EMCCrossTalk
   void calculateInducedEnergyInTCardCell(int absId, int absIdRef, int iSM, float ampRef, int cellCase);
 
  private:
+  /// \brief Fill the cell layout tables from the geometry, done once in initObjects
+  void initCellLayout();
+
+  /// \brief Cell at a given position of a SM, from the layout tables
+  /// \return absId of the cell, -1 if the position is outside of the SM
+  int absIdAt(int iSM, int iphi, int ieta) const
+  {
+    if (iphi < 0 || iphi >= NRows[iSM] || ieta < 0 || ieta >= NColumns[iSM]) {
+      return -1;
+    }
+    return mAbsIdGrid[iSM][iphi * MaxNColumns + ieta];
+  }
+
+  // Cell layout, filled once from the geometry: SM, row (phi) and column (eta) in the SM of each absId, and absId at each SM position
+  std::array<int8_t, NCells> mCellSM;
+  std::array<int8_t, NCells> mCellRow;
+  std::array<int8_t, NCells> mCellColumn;
+  std::array<std::array<int, MaxNRows * MaxNColumns>, NSM> mAbsIdGrid;
+  std::array<int, NCells> mCellIndex; // Position in the original cells of the current event of each absId, -1 if the cell has no signal
+
   // T-Card correlation emulation, do on MC
   bool mTCardCorrClusEnerConserv;                // When making correlation, subtract from the reference cell the induced energy on the neighbour cells
   std::array<float, NCells> mTCardCorrCellsEner; //  Array with induced cell energy in T-Card neighbour cells
@@ -24,6 +24,7 @@
 #include <limits>
 #include <span>
 #include <stdexcept>
+#include <utility>
 #include <vector>
 
 namespace tmemcutilities
@@ -114,6 +115,150 @@ MatchResult matchTracksToCluster(
   }
   return result;
 }
+
+/**
+ * Match clusters and tracks using a binned eta-phi grid of the tracks instead of a KD-tree.
+ *
+ * Same matches as matchTracksToCluster(): for each cluster, the maxNumberMatches closest tracks within
+ * dR=maxMatchingDistance, ordered by increasing distance. The grid cells are at least maxMatchingDistance
+ * wide, so that only the 3x3 cells around a cluster have to be searched.
+ *
+ * @param clusterPhi cluster collection phi.
+ * @param clusterEta cluster collection eta.
+ * @param trackPhi track collection phi.
+ * @param trackEta track collection eta.
+ * @param maxMatchingDistance Maximum matching distance.
+ * @param maxNumberMatches Maximum number of matches (e.g. 5 closest).
+ *
+ * @returns (cluster to track index map, track to cluster index map)
+ */
+MatchResult matchTracksToClusterGrid(
+  std::span<float> clusterPhi,
+  std::span<float> clusterEta,
+  std::span<float> trackPhi,
+  std::span<float> trackEta,
+  double maxMatchingDistance,
+  int maxNumberMatches)
+{
+  const std::size_t nClusters = clusterEta.size();
+  const std::size_t nTracks = trackEta.size();
+  MatchResult result;
+
+  if (nClusters == 0 || nTracks == 0) {
+    // There are no jets, so nothing to be done.
+    return result;
+  }
+  // Input sizes must match
+  if (clusterPhi.size() != clusterEta.size()) {
+    throw std::invalid_argument("cluster collection eta and phi sizes don't match. Check the inputs.");
+  }
+  if (trackPhi.size() != trackEta.size()) {
+    throw std::invalid_argument("track collection eta and phi sizes don't match. Check the inputs.");
+  }
+
+  result.matchIndexTrack.resize(nClusters);
+  result.matchDeltaPhi.resize(nClusters);
+  result.matchDeltaEta.resize(nClusters);
+  if (!(maxMatchingDistance > 0.) || maxNumberMatches <= 0) {
+    return result;
+  }
+
+  // Range of the tracks, the ones with non finite coordinates can never be matched
+  float etaMin = std::numeric_limits<float>::max(), etaMax = std::numeric_limits<float>::lowest();
+  float phiMin = std::numeric_limits<float>::max(), phiMax = std::numeric_limits<float>::lowest();
+  for (std::size_t iTrack = 0; iTrack < nTracks; iTrack++) {
+    if (std::isfinite(trackEta[iTrack]) && std::isfinite(trackPhi[iTrack])) {
+      etaMin = std::min(etaMin, trackEta[iTrack]);
+      etaMax = std::max(etaMax, trackEta[iTrack]);
+      phiMin = std::min(phiMin, trackPhi[iTrack]);
+      phiMax = std::max(phiMax, trackPhi[iTrack]);
+    }
+  }
+  if (etaMin > etaMax) {
+    return result;
+  }
+
+  // Cells of at least maxMatchingDistance, enlarged if needed to keep the number of cells of the order of the number of tracks
+  const long maxCells = 4 * static_cast<long>(nTracks) + 16;
+  double cellSize = maxMatchingDistance;
+  long nEta = 0, nPhi = 0;
+  while (true) {
+    nEta = static_cast<long>((etaMax - etaMin) / cellSize) + 1;
+    nPhi = static_cast<long>((phiMax - phiMin) / cellSize) + 1;
+    if (nEta * nPhi <= maxCells) {
+      break;
+    }
+    cellSize *= 2.;
+  }
+
+  // Tracks sorted per cell (counting sort)
+  std::vector<int> cellStart(nEta * nPhi + 1, 0);
+  std::vector<int> trackCell(nTracks, -1);
+  for (std::size_t iTrack = 0; iTrack < nTracks; iTrack++) {
+    if (std::isfinite(trackEta[iTrack]) && std::isfinite(trackPhi[iTrack])) {
+      long iEta = std::min(static_cast<long>((trackEta[iTrack] - etaMin) / cellSize), nEta - 1);
+      long iPhi = std::min(static_cast<long>((trackPhi[iTrack] - phiMin) / cellSize), nPhi - 1);
+      trackCell[iTrack] = iEta * nPhi + iPhi;
+      cellStart[trackCell[iTrack] + 1]++;
+    }
+  }
+  for (std::size_t iCell = 1; iCell < cellStart.size(); iCell++) {
+    cellStart[iCell] += cellStart[iCell - 1];
+  }
+  std::vector<int> cellTracks(cellStart.back());
+  std::vector<int> cellFill(cellStart.begin(), cellStart.end() - 1);
+  for (std::size_t iTrack = 0; iTrack < nTracks; iTrack++) {
+    if (trackCell[iTrack] >= 0) {
+      cellTracks[cellFill[trackCell[iTrack]]++] = iTrack;
+    }
+  }
+
+  // Find the tracks closest to each cluster.
+  std::vector<std::pair<float, int>> candidates;
+  for (std::size_t iCluster = 0; iCluster < nClusters; iCluster++) {
+    if (!std::isfinite(clusterEta[iCluster]) || !std::isfinite(clusterPhi[iCluster])) {
+      continue;
+    }
+    const double cellEta = std::floor((clusterEta[iCluster] - etaMin) / cellSize);
+    const double cellPhi = std::floor((clusterPhi[iCluster] - phiMin) / cellSize);
+    // no track can be within maxMatchingDistance of the clusters outside the grid and its neighbouring cells
+    if (cellEta < -1. || cellEta > nEta || cellPhi < -1. || cellPhi > nPhi) {
+      continue;
+    }
+    const long iEta = static_cast<long>(cellEta);
+    const long iPhi = static_cast<long>(cellPhi);
+    candidates.clear();
+    for (long jEta = std::max(iEta - 1, 0L); jEta <= std::min(iEta + 1, nEta - 1); jEta++) {
+      for (long jPhi = std::max(iPhi - 1, 0L); jPhi <= std::min(iPhi + 1, nPhi - 1); jPhi++) {
+        const long iCell = jEta * nPhi + jPhi;
+        for (int i = cellStart[iCell]; i < cellStart[iCell + 1]; i++) {
+          const int iTrack = cellTracks[i];
+          const float dEta = trackEta[iTrack] - clusterEta[iCluster];
+          const float dPhi = trackPhi[iTrack] - clusterPhi[iCluster];
+          const float distance = std::sqrt(dEta * dEta + dPhi * dPhi);
+          if (distance < maxMatchingDistance) {
+            candidates.emplace_back(distance, iTrack);
+          }
+        }
+      }
+    }
+    const std::size_t nMatches = std::min(candidates.size(), static_cast<std::size_t>(maxNumberMatches));
+    std::partial_sort(candidates.begin(), candidates.begin() + nMatches, candidates.end());
+
+    // allocate enough memory
+    result.matchIndexTrack[iCluster].reserve(nMatches);
+    result.matchDeltaPhi[iCluster].reserve(nMatches);
+    result.matchDeltaEta[iCluster].reserve(nMatches);
+
+    for (std::size_t m = 0; m < nMatches; m++) {
+      const int iTrack = candidates[m].second;
+      result.matchIndexTrack[iCluster].push_back(iTrack);
+      result.matchDeltaPhi[iCluster].push_back(trackPhi[iTrack] - clusterPhi[iCluster]);
+      result.matchDeltaEta[iCluster].push_back(trackEta[iTrack] - clusterEta[iCluster]);
+    }
+  }
+  return result;
+}
 }; // namespace tmemcutilities
 
 #endif // PWGJE_CORE_UTILSTRACKMATCHINGEMC_H_
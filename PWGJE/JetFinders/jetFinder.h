@@ -108,6 +108,8 @@ struct JetFinderTask {
   o2::framework::Configurable<int> jetPtBinWidth{"jetPtBinWidth", 5, "used to define the width of the jetPt bins for the THnSparse"};
   o2::framework::Configurable<bool> fillTHnSparse{"fillTHnSparse", false, "switch to fill the THnSparse"};
   o2::framework::Configurable<double> jetExtraParam{"jetExtraParam", -99.0, "sets the _extra_param in fastjet"};
+  o2::framework::Configurable<int> nThreadsJetRadii{"nThreadsJetRadii", 1, "number of threads used to cluster the different jet radii concurrently (1 = serial). Jet areas are then statistically, not bitwise, reproducible"};
+  o2::framework::Configurable<bool> encodeConstituentsInUserIndex{"encodeConstituentsInUserIndex", false, "identify the jet finding inputs by their PseudoJet user_index instead of allocating a user info object for each of them"};
 
   o2::framework::Service<o2::framework::O2DatabasePDG> pdgDatabase;
   int trackSelection = -1;
@@ -160,6 +162,10 @@ struct JetFinderTask {
       jetFinder.isTriggering = true;
     }
     jetFinder.fastjetExtraParam = jetExtraParam;
+    jetFinder.nThreads = nThreadsJetRadii;
+    if (nThreadsJetRadii > 1 && !JetFinder::isThreadSafe()) {
+      LOGF(warning, "fastjet was built without thread safety, the jet radii will be clustered serially");
+    }
 
     auto jetRadiiBins = (std::vector<double>)jetRadius;
     if (jetRadiiBins.size() > 1) {
@@ -196,7 +202,7 @@ struct JetFinderTask {
       return;
     }
     inputParticles.clear();
-    jetfindingutilities::analyseTracks<o2::soa::Filtered<o2::aod::JetTracks>, o2::soa::Filtered<o2::aod::JetTracks>::iterator>(inputParticles, tracks, trackSelection);
+    jetfindingutilities::analyseTracks<o2::soa::Filtered<o2::aod::JetTracks>, o2::soa::Filtered<o2::aod::JetTracks>::iterator>(inputParticles, tracks, trackSelection, nullptr, !encodeConstituentsInUserIndex);
     jetfindingutilities::findJets(jetFinder, inputParticles, jetPtMin, jetPtMax, jetRadius, jetAreaFractionMin, collision, jetsTable, constituentsTable, fillTHnSparse ? registry.get<THn>(HIST("hJet")) : std::shared_ptr<THn>(nullptr), fillTHnSparse);
   }
 
@@ -209,7 +215,7 @@ struct JetFinderTask {
       return;
     }
     inputParticles.clear();
-    jetfindingutilities::analyseTracks<o2::soa::Filtered<o2::aod::JetTracksSub>, o2::soa::Filtered<o2::aod::JetTracksSub>::iterator>(inputParticles, tracks, trackSelection);
+    jetfindingutilities::analyseTracks<o2::soa::Filtered<o2::aod::JetTracksSub>, o2::soa::Filtered<o2::aod::JetTracksSub>::iterator>(inputParticles, tracks, trackSelection, nullptr, !encodeConstituentsInUserIndex);
     jetfindingutilities::findJets(jetFinder, inputParticles, jetEWSPtMin, jetEWSPtMax, jetRadius, jetAreaFractionMin, collision, jetsEvtWiseSubTable, constituentsEvtWiseSubTable, fillTHnSparse ? registry.get<THn>(HIST("hJetEWS")) : std::shared_ptr<THn>(nullptr), fillTHnSparse);
   }
 
@@ -224,7 +230,7 @@ struct JetFinderTask {
     for (auto const& clusterDefinition : clusterDefinitionsVec) {
       for (auto const& hadronicCorrectionType : hadronicCorrectionTypesVec) {
         inputParticles.clear();
-        jetfindingutilities::analyseClusters(inputParticles, clusters, clusterDefinition, hadronicCorrectionType);
+        jetfindingutilities::analyseClusters(inputParticles, clusters, clusterDefinition, hadronicCorrectionType, !encodeConstituentsInUserIndex);
         jetfindingutilities::findJets(jetFinder, inputParticles, jetPtMin, jetPtMax, jetRadius, jetAreaFractionMin, collision, jetsTable, constituentsTable, fillTHnSparse ? registry.get<THn>(HIST("hJet")) : std::shared_ptr<THn>(nullptr), fillTHnSparse);
       }
     }
@@ -241,8 +247,8 @@ struct JetFinderTask {
     for (auto const& clusterDefinition : clusterDefinitionsVec) {
       for (auto const& hadronicCorrectionType : hadronicCorrectionTypesVec) {
         inputParticles.clear();
-        jetfindingutilities::analyseTracks<o2::soa::Filtered<o2::aod::JetTracks>, o2::soa::Filtered<o2::aod::JetTracks>::iterator>(inputParticles, tracks, trackSelection);
-        jetfindingutilities::analyseClusters(inputParticles, clusters, clusterDefinition, hadronicCorrectionType);
+        jetfindingutilities::analyseTracks<o2::soa::Filtered<o2::aod::JetTracks>, o2::soa::Filtered<o2::aod::JetTracks>::iterator>(inputParticles, tracks, trackSelection, nullptr, !encodeConstituentsInUserIndex);
+        jetfindingutilities::analyseClusters(inputParticles, clusters, clusterDefinition, hadronicCorrectionType, !encodeConstituentsInUserIndex);
         jetfindingutilities::findJets(jetFinder, inputParticles, jetPtMin, jetPtMax, jetRadius, jetAreaFractionMin, collision, jetsTable, constituentsTable, fillTHnSparse ? registry.get<THn>(HIST("hJet")) : std::shared_ptr<THn>(nullptr), fillTHnSparse);
       }
     }
@@ -255,7 +261,7 @@ struct JetFinderTask {
       return;
     }
     inputParticles.clear();
-    jetfindingutilities::analyseParticles<false, o2::soa::Filtered<o2::aod::JetParticles>, o2::soa::Filtered<o2::aod::JetParticles>::iterator>(inputParticles, particleSelection, 1, particles, pdgDatabase);
+    jetfindingutilities::analyseParticles<false, o2::soa::Filtered<o2::aod::JetParticles>, o2::soa::Filtered<o2::aod::JetParticles>::iterator>(inputParticles, particleSelection, 1, particles, pdgDatabase, nullptr, !encodeConstituentsInUserIndex);
     jetfindingutilities::findJets(jetFinder, inputParticles, jetPtMin, jetPtMax, jetRadius, jetAreaFractionMin, mcCollision, jetsTable, constituentsTable, fillTHnSparse ? registry.get<THn>(HIST("hJetMCP")) : std::shared_ptr<THn>(nullptr), fillTHnSparse);
   }
   PROCESS_SWITCH(JetFinderTask, processParticleLevelChargedJets, "Particle level charged jet finding", false);
@@ -266,7 +272,7 @@ struct JetFinderTask {
       return;
     }
     inputParticles.clear();
-    jetfindingutilities::analyseParticles<false, o2::soa::Filtered<o2::aod::JetParticlesSub>, o2::soa::Filtered<o2::aod::JetParticlesSub>::iterator>(inputParticles, particleSelection, 1, particles, pdgDatabase);
+    jetfindingutilities::analyseParticles<false, o2::soa::Filtered<o2::aod::JetParticlesSub>, o2::soa::Filtered<o2::aod::JetParticlesSub>::iterator>(inputParticles, particleSelection, 1, particles, pdgDatabase, nullptr, !encodeConstituentsInUserIndex);
     jetfindingutilities::findJets(jetFinder, inputParticles, jetEWSPtMin, jetEWSPtMax, jetRadius, jetAreaFractionMin, mcCollision, jetsEvtWiseSubTable, constituentsEvtWiseSubTable, fillTHnSparse ? registry.get<THn>(HIST("hJetEWSMCP")) : std::shared_ptr<THn>(nullptr), fillTHnSparse);
   }
   PROCESS_SWITCH(JetFinderTask, processParticleLevelChargedEvtWiseSubJets, "Particle level charged with event-wise constituent subtraction jet finding", false);
@@ -277,7 +283,7 @@ struct JetFinderTask {
       return;
     }
     inputParticles.clear();
-    jetfindingutilities::analyseParticles<false, o2::soa::Filtered<o2::aod::JetParticles>, o2::soa::Filtered<o2::aod::JetParticles>::iterator>(inputParticles, particleSelection, 2, particles, pdgDatabase);
+    jetfindingutilities::analyseParticles<false, o2::soa::Filtered<o2::aod::JetParticles>, o2::soa::Filtered<o2::aod::JetParticles>::iterator>(inputParticles, particleSelection, 2, particles, pdgDatabase, nullptr, !encodeConstituentsInUserIndex);
     jetfindingutilities::findJets(jetFinder, inputParticles, jetPtMin, jetPtMax, jetRadius, jetAreaFractionMin, mcCollision, jetsTable, constituentsTable, fillTHnSparse ? registry.get<THn>(HIST("hJetMCP")) : std::shared_ptr<THn>(nullptr), fillTHnSparse);
   }
   PROCESS_SWITCH(JetFinderTask, processParticleLevelNeutralJets, "Particle level neutral jet finding", false);
@@ -288,7 +294,7 @@ struct JetFinderTask {
       return;
     }
     inputParticles.clear();
-    jetfindingutilities::analyseParticles<false, o2::soa::Filtered<o2::aod::JetParticles>, o2::soa::Filtered<o2::aod::JetParticles>::iterator>(inputParticles, particleSelection, 0, particles, pdgDatabase);
+    jetfindingutilities::analyseParticles<false, o2::soa::Filtered<o2::aod::JetParticles>, o2::soa::Filtered<o2::aod::JetParticles>::iterator>(inputParticles, particleSelection, 0, particles, pdgDatabase, nullptr, !encodeConstituentsInUserIndex);
     jetfindingutilities::findJets(jetFinder, inputParticles, jetPtMin, jetPtMax, jetRadius, jetAreaFractionMin, mcCollision, jetsTable, constituentsTable, fillTHnSparse ? registry.get<THn>(HIST("hJetMCP")) : std::shared_ptr<THn>(nullptr), fillTHnSparse);
   }
 
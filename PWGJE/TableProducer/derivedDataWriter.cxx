@@ -54,6 +54,9 @@ struct JetDerivedDataWriter {
     Configurable<float> trackPtSelectionMin{"trackPtSelectionMin", 0.15, "only save tracks that have a pT larger than this pT"};
     Configurable<float> trackEtaSelectionMax{"trackEtaSelectionMax", 0.9, "only save tracks that have an eta smaller than this eta"};
     Configurable<bool> savePartonLevelInfo{"savePartonLevelInfo", true, "save parton level info at MCP level"};
+    Configurable<bool> saveTrackExtras{"saveTrackExtras", true, "save the track extra table (DCAs and their uncertainties), only switch off if no analysis downstream joins it with the tracks"};
+    Configurable<bool> saveParentIndices{"saveParentIndices", true, "save the parent index tables of the BCs, collisions, tracks, clusters, mcCollisions and mcParticles, only switch off if no analysis downstream joins them"};
+    Configurable<bool> reserveOutputTables{"reserveOutputTables", false, "reserve the output tables of the BCs, collisions, tracks, mcCollisions and mcParticles once per data frame from the number of selected entries"};
 
   } config;
 
@@ -293,6 +296,18 @@ struct JetDerivedDataWriter {
     return true;
   }
 
+  template <typename T>
+  int countSelectedCollisions(T const& collisions)
+  {
+    int nSelectedCollisions = 0;
+    for (auto const& collision : collisions) {
+      if (collision.isCollisionSelected()) {
+        nSelectedCollisions++;
+      }
+    }
+    return nSelectedCollisions;
+  }
+
   template <bool isMc, typename T>
   void storeD0(soa::Join<aod::JCollisions, aod::JCollisionSelections>::iterator const& collision, aod::JTracks const&, aod::CollisionsD0 const& D0Collisions, T const& D0Candidates)
   {
@@ -442,12 +457,21 @@ struct JetDerivedDataWriter {
     bcMapping.clear();
     bcMapping.resize(bcs.size(), -1);
 
+    if (config.reserveOutputTables) {
+      int nSelectedCollisions = countSelectedCollisions(collisions);
+      products.storedJBCsTable.reserve(nSelectedCollisions);
+      if (config.saveParentIndices) {
+        products.storedJBCParentIndexTable.reserve(nSelectedCollisions);
+      }
+    }
     for (auto const& collision : collisions) {
       if (collision.isCollisionSelected()) {
         auto bc = collision.bc_as<soa::Join<aod::JBCs, aod::JBCPIs>>();
         if (std::find(bcIndicies.begin(), bcIndicies.end(), bc.globalIndex()) == bcIndicies.end()) {
           products.storedJBCsTable(bc.runNumber(), bc.globalBC(), bc.triggerMask(), bc.timestamp(), bc.alias_raw(), bc.selection_raw(), bc.rct_raw());
-          products.storedJBCParentIndexTable(bc.bcId());
+          if (config.saveParentIndices) {
+            products.storedJBCParentIndexTable(bc.bcId());
+          }
           bcIndicies.push_back(bc.globalIndex());
           bcMapping[bc.globalIndex()] = products.storedJBCsTable.lastIndex();
         }
@@ -480,12 +504,22 @@ struct JetDerivedDataWriter {
     collisionMapping.clear();
     collisionMapping.resize(collisions.size(), -1);
 
+    if (config.reserveOutputTables) {
+      int nSelectedCollisions = countSelectedCollisions(collisions);
+      products.storedJCollisionsTable.reserve(nSelectedCollisions);
+      products.storedJCollisionMcInfosTable.reserve(nSelectedCollisions);
+      if (config.saveParentIndices) {
+        products.storedJCollisionsParentIndexTable.reserve(nSelectedCollisions);
+      }
+    }
     for (auto const& collision : collisions) {
       if (collision.isCollisionSelected()) {
         products.storedJCollisionsTable(bcMapping[collision.bcId()], collision.posX(), collision.posY(), collision.posZ(), collision.collisionTime(), collision.multFV0A(), collision.multFV0C(), collision.multFT0A(), collision.multFT0C(), collision.centFV0A(), collision.centFV0M(), collision.centFT0A(), collision.centFT0C(), collision.centFT0M(), collision.centFT0CVariant1(), collision.hadronicRate(), collision.trackOccupancyInTimeRange(), collision.alias_raw(), collision.eventSel(), collision.rct_raw(), collision.triggerSel());
         collisionMapping[collision.globalIndex()] = products.storedJCollisionsTable.lastIndex();
         products.storedJCollisionMcInfosTable(collision.weight(), collision.getSubGeneratorId());
-        products.storedJCollisionsParentIndexTable(collision.collisionId());
+        if (config.saveParentIndices) {
+          products.storedJCollisionsParentIndexTable(collision.collisionId());
+        }
       }
     }
   }
@@ -526,6 +560,21 @@ struct JetDerivedDataWriter {
     trackMapping.clear();
     trackMapping.resize(tracks.size(), -1);
 
+    if (config.reserveOutputTables) {
+      int nTracksSelectedCollisions = 0; // upper bound, the track selection is applied afterwards
+      for (auto const& collision : collisions) {
+        if (collision.isCollisionSelected()) {
+          nTracksSelectedCollisions += tracks.sliceBy(preslices.TracksPerCollision, collision.globalIndex()).size();
+        }
+      }
+      products.storedJTracksTable.reserve(nTracksSelectedCollisions);
+      if (config.saveTrackExtras) {
+        products.storedJTracksExtraTable.reserve(nTracksSelectedCollisions);
+      }
+      if (config.saveParentIndices) {
+        products.storedJTracksParentIndexTable.reserve(nTracksSelectedCollisions);
+      }
+    }
     for (auto const& collision : collisions) {
       if (collision.isCollisionSelected()) {
         const auto tracksPerCollision = tracks.sliceBy(preslices.TracksPerCollision, collision.globalIndex());
@@ -534,8 +583,12 @@ struct JetDerivedDataWriter {
             continue;
           }
           products.storedJTracksTable(collisionMapping[collision.globalIndex()], o2::math_utils::detail::truncateFloatFraction(track.pt(), precisionMomentumMask), o2::math_utils::detail::truncateFloatFraction(track.eta(), precisionPositionMask), o2::math_utils::detail::truncateFloatFraction(track.phi(), precisionPositionMask), track.trackSel());
-          products.storedJTracksExtraTable(o2::math_utils::detail::truncateFloatFraction(track.dcaX(), precisionPositionMask), o2::math_utils::detail::truncateFloatFraction(track.dcaY(), precisionPositionMask), o2::math_utils::detail::truncateFloatFraction(track.dcaZ(), precisionPositionMask), o2::math_utils::detail::truncateFloatFraction(track.dcaXY(), precisionPositionMask), o2::math_utils::detail::truncateFloatFraction(track.dcaXYZ(), precisionPositionMask), o2::math_utils::detail::truncateFloatFraction(track.sigmadcaZ(), precisionPositionMask), o2::math_utils::detail::truncateFloatFraction(track.sigmadcaXY(), precisionPositionMask), o2::math_utils::detail::truncateFloatFraction(track.sigmadcaXYZ(), precisionPositionMask), o2::math_utils::detail::truncateFloatFraction(track.sigma1Pt(), precisionMomentumMask));
-          products.storedJTracksParentIndexTable(track.trackId());
+          if (config.saveTrackExtras) {
+            products.storedJTracksExtraTable(o2::math_utils::detail::truncateFloatFraction(track.dcaX(), precisionPositionMask), o2::math_utils::detail::truncateFloatFraction(track.dcaY(), precisionPositionMask), o2::math_utils::detail::truncateFloatFraction(track.dcaZ(), precisionPositionMask), o2::math_utils::detail::truncateFloatFraction(track.dcaXY(), precisionPositionMask), o2::math_utils::detail::truncateFloatFraction(track.dcaXYZ(), precisionPositionMask), o2::math_utils::detail::truncateFloatFraction(track.sigmadcaZ(), precisionPositionMask), o2::math_utils::detail::truncateFloatFraction(track.sigmadcaXY(), precisionPositionMask), o2::math_utils::detail::truncateFloatFraction(track.sigmadcaXYZ(), precisionPositionMask), o2::math_utils::detail::truncateFloatFraction(track.sigma1Pt(), precisionMomentumMask));
+          }
+          if (config.saveParentIndices) {
+            products.storedJTracksParentIndexTable(track.trackId());
+          }
           trackMapping[track.globalIndex()] = products.storedJTracksTable.lastIndex();
         }
       }
@@ -551,7 +604,9 @@ struct JetDerivedDataWriter {
         products.storedJClustersTable(collisionMapping[collision.globalIndex()], cluster.id(), cluster.energy(), cluster.coreEnergy(), cluster.rawEnergy(),
                                       cluster.eta(), cluster.phi(), cluster.m02(), cluster.m20(), cluster.nCells(), cluster.time(), cluster.isExotic(), cluster.distanceToBadChannel(),
                                       cluster.nlm(), cluster.definition(), cluster.leadingCellEnergy(), cluster.subleadingCellEnergy(), cluster.leadingCellNumber(), cluster.subleadingCellNumber());
-        products.storedJClustersParentIndexTable(cluster.clusterId());
+        if (config.saveParentIndices) {
+          products.storedJClustersParentIndexTable(cluster.clusterId());
+        }
 
         std::vector<int32_t> clusterStoredJTrackIDs;
         for (const auto& clusterTrack : cluster.matchedTracks_as<aod::JTracks>()) {
@@ -683,10 +738,24 @@ struct JetDerivedDataWriter {
   {
     mcCollisionMapping.clear();
     mcCollisionMapping.resize(mcCollisions.size(), -1);
+    if (config.reserveOutputTables) {
+      int nSelectedMcCollisions = 0;
+      for (auto const& mcCollision : mcCollisions) {
+        if (mcCollision.isMcCollisionSelected()) {
+          nSelectedMcCollisions++;
+        }
+      }
+      products.storedJMcCollisionsTable.reserve(nSelectedMcCollisions);
+      if (config.saveParentIndices) {
+        products.storedJMcCollisionsParentIndexTable.reserve(nSelectedMcCollisions);
+      }
+    }
     for (auto const& mcCollision : mcCollisions) {
       if (mcCollision.isMcCollisionSelected()) {
         products.storedJMcCollisionsTable(bcMapping[mcCollision.bcId()], mcCollision.posX(), mcCollision.posY(), mcCollision.posZ(), mcCollision.multFV0A(), mcCollision.multFT0A(), mcCollision.multFT0C(), mcCollision.centFT0M(), mcCollision.weight(), mcCollision.accepted(), mcCollision.attempted(), mcCollision.xsectGen(), mcCollision.xsectErr(), mcCollision.ptHard(), mcCollision.rct_raw(), mcCollision.getGeneratorId(), mcCollision.getSubGeneratorId(), mcCollision.getSourceId(), mcCollision.impactParameter(), mcCollision.eventPlaneAngle());
-        products.storedJMcCollisionsParentIndexTable(mcCollision.mcCollisionId());
+        if (config.saveParentIndices) {
+          products.storedJMcCollisionsParentIndexTable(mcCollision.mcCollisionId());
+        }
         mcCollisionMapping[mcCollision.globalIndex()] = products.storedJMcCollisionsTable.lastIndex();
       }
     }
@@ -698,6 +767,18 @@ struct JetDerivedDataWriter {
     particleMapping.clear();
     particleMapping.resize(particles.size(), -1);
     int particleTableIndex = 0;
+    if (config.reserveOutputTables) {
+      int nParticlesSelectedMcCollisions = 0; // upper bound if only the physical primaries are saved
+      for (auto const& mcCollision : mcCollisions) {
+        if (mcCollision.isMcCollisionSelected()) {
+          nParticlesSelectedMcCollisions += particles.sliceBy(preslices.ParticlesPerMcCollision, mcCollision.globalIndex()).size();
+        }
+      }
+      products.storedJMcParticlesTable.reserve(nParticlesSelectedMcCollisions);
+      if (config.saveParentIndices) {
+        products.storedJParticlesParentIndexTable.reserve(nParticlesSelectedMcCollisions);
+      }
+    }
     for (auto const& mcCollision : mcCollisions) {
       if (mcCollision.isMcCollisionSelected()) {
 
@@ -734,7 +815,9 @@ struct JetDerivedDataWriter {
             }
           }
           products.storedJMcParticlesTable(mcCollisionMapping[mcCollision.globalIndex()], o2::math_utils::detail::truncateFloatFraction(particle.pt(), precisionMomentumMask), o2::math_utils::detail::truncateFloatFraction(particle.eta(), precisionPositionMask), o2::math_utils::detail::truncateFloatFraction(particle.phi(), precisionPositionMask), o2::math_utils::detail::truncateFloatFraction(particle.y(), precisionPositionMask), o2::math_utils::detail::truncateFloatFraction(particle.e(), precisionMomentumMask), particle.pdgCode(), particle.statusCode(), particle.flags(), mothersIds, daughtersIds);
-          products.storedJParticlesParentIndexTable(particle.mcParticleId());
+          if (config.saveParentIndices) {
+            products.storedJParticlesParentIndexTable(particle.mcParticleId());
+          }
         }
       }
     }
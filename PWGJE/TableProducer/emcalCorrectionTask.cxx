@@ -117,6 +117,7 @@ struct EmcalCorrectionTask {
   Configurable<int> selectedCellType{"selectedCellType", 1, "EMCAL Cell type"};
   Configurable<std::string> clusterDefinitions{"clusterDefinitions", "kV3Default", "cluster definition to be selected, e.g. V3Default. Multiple definitions can be specified separated by comma"};
   Configurable<float> maxMatchingDistance{"maxMatchingDistance", 0.4f, "Max matching distance track-cluster"};
+  Configurable<bool> useMatchingGrid{"useMatchingGrid", false, "Match tracks and clusters with a binned eta-phi grid of the tracks instead of a KD-tree"};
   Configurable<std::string> nonlinearityFunction{"nonlinearityFunction", "DATA_TestbeamFinal_NoScale", "Nonlinearity correction at cluster level. Default for data should be DATA_TestbeamFinal_NoScale. Default for MC should be MC_TestbeamFinal."};
   Configurable<bool> disableNonLin{"disableNonLin", false, "Disable NonLin correction if set to true"};
   Configurable<bool> hasShaperCorrection{"hasShaperCorrection", true, "Apply correction for shaper saturation"};
@@ -184,6 +185,17 @@ struct EmcalCorrectionTask {
   // EMCal geometry
   o2::emcal::Geometry* geometry;
 
+  // Geometry of each cell, filled once at init instead of querying the geometry for each cell of each event
+  struct CellGeometry {
+    float eta;
+    float phi; // in [0, 2pi)
+    int16_t row;
+    int16_t col;
+    int8_t supermodule;
+    int8_t smType;
+  };
+  std::vector<CellGeometry> mCellGeometry;
+
   // EMCal cell temperature calibrator
   std::unique_ptr<o2::emcal::EMCALTempCalibExtractor> mTempCalibExtractor;
   bool mIsTempCalibInitialized = false;
@@ -222,6 +234,7 @@ struct EmcalCorrectionTask {
     if (useCCDBAlignment.value) {
       geometry->SetMisalMatrixFromCcdb();
     }
+    fillCellGeometry();
 
     if (applyTempCalib) {
       mTempCalibExtractor = std::make_unique<o2::emcal::EMCALTempCalibExtractor>();
@@ -1369,7 +1382,11 @@ struct EmcalCorrectionTask {
     trackGlobalIndex.reserve(nTracksInCol);
     fillTrackInfo<decltype(groupedTracks)>(groupedTracks, trackPhi, trackEta, trackGlobalIndex);
 
-    indexMapPair = matchTracksToCluster(mClusterPhi, mClusterEta, trackPhi, trackEta, maxMatchingDistance, kMaxMatchesPerCluster);
+    if (useMatchingGrid) {
+      indexMapPair = matchTracksToClusterGrid(mClusterPhi, mClusterEta, trackPhi, trackEta, maxMatchingDistance, kMaxMatchesPerCluster);
+    } else {
+      indexMapPair = matchTracksToCluster(mClusterPhi, mClusterEta, trackPhi, trackEta, maxMatchingDistance, kMaxMatchesPerCluster);
+    }
   }
 
   template <typename Collision>
@@ -1405,7 +1422,11 @@ struct EmcalCorrectionTask {
       trackEta.emplace_back(trackEtaEmcal);
       trackGlobalIndex.emplace_back(track.globalIndex());
     }
-    indexMapPair = matchTracksToCluster(mClusterPhi, mClusterEta, trackPhi, trackEta, maxMatchingDistance, kMaxMatchesPerCluster);
+    if (useMatchingGrid) {
+      indexMapPair = matchTracksToClusterGrid(mClusterPhi, mClusterEta, trackPhi, trackEta, maxMatchingDistance, kMaxMatchesPerCluster);
+    } else {
+      indexMapPair = matchTracksToCluster(mClusterPhi, mClusterEta, trackPhi, trackEta, maxMatchingDistance, kMaxMatchesPerCluster);
+    }
   }
 
   template <typename Tracks>
@@ -1462,11 +1483,26 @@ struct EmcalCorrectionTask {
       else if (cell.getHighGain())
         mHistManager.fill(HIST("hHGCellTimeEnergy"), cell.getTimeStamp(), cell.getEnergy());
       mHistManager.fill(HIST("hCellTowerID"), cell.getTower());
-      auto res = mClusterizers.at(0)->getGeometry()->EtaPhiFromIndex(cell.getTower());
-      mHistManager.fill(HIST("hCellEtaPhi"), std::get<0>(res), RecoDecay::constrainAngle(std::get<1>(res)));
-      res = mClusterizers.at(0)->getGeometry()->GlobalRowColFromIndex(cell.getTower());
+      const CellGeometry& cellGeometry = mCellGeometry[cell.getTower()];
+      mHistManager.fill(HIST("hCellEtaPhi"), cellGeometry.eta, cellGeometry.phi);
       // NOTE: Reversed column and row because it's more natural for presentation.
-      mHistManager.fill(HIST("hCellRowCol"), std::get<1>(res), std::get<0>(res));
+      mHistManager.fill(HIST("hCellRowCol"), cellGeometry.col, cellGeometry.row);
+    }
+  }
+
+  void fillCellGeometry()
+  {
+    mCellGeometry.resize(geometry->GetNCells());
+    for (int cellID = 0; cellID < static_cast<int>(mCellGeometry.size()); cellID++) {
+      CellGeometry& cellGeometry = mCellGeometry[cellID];
+      auto [eta, phi] = geometry->EtaPhiFromIndex(cellID);
+      auto [row, col] = geometry->GlobalRowColFromIndex(cellID);
+      cellGeometry.eta = eta;
+      cellGeometry.phi = RecoDecay::constrainAngle(phi);
+      cellGeometry.row = row;
+      cellGeometry.col = col;
+      cellGeometry.supermodule = geometry->GetSuperModuleNumber(cellID);
+      cellGeometry.smType = geometry->GetSMType(cellGeometry.supermodule);
     }
   }
 
@@ -1475,13 +1511,11 @@ struct EmcalCorrectionTask {
     // Apply cell scale based on SM types (Full, Half (not used), EMC 1/3, DCal, DCal 1/3)
     // Same as in Run2 data
     if (applyCellAbsScale == CellScaleMode::ModeSMWise) {
-      int iSM = mClusterizers.at(0)->getGeometry()->GetSuperModuleNumber(cellID);
-      return cellAbsScaleFactors.value[mClusterizers.at(0)->getGeometry()->GetSMType(iSM)];
+      return cellAbsScaleFactors.value[mCellGeometry[cellID].smType];
 
       // Apply cell scale based on columns to accoutn for material of TRD structures
     } else if (applyCellAbsScale == CellScaleMode::ModeColumnWise) {
-      auto res = mClusterizers.at(0)->getGeometry()->GlobalRowColFromIndex(cellID);
-      return cellAbsScaleFactors.value[std::get<1>(res)];
+      return cellAbsScaleFactors.value[mCellGeometry[cellID].col];
     } else {
       return 1.f;
     }
@@ -1504,8 +1538,8 @@ struct EmcalCorrectionTask {
       // Shift the time to 0, as the TOF was simulated -> eta dependent shift (as larger eta values are further away from collision point)
       // Use distance between vertex and EMCal (at eta = 0) and distance on EMCal surface (cell size times column) to calculate distance to cell
       // 0.2 is cell size in m (0.06) divided by the speed of light in m/ns (0.3) - 47.5 is the "middle" of the EMCal (2*48 cells in one column)
-      float timeCol = 0.2f * (geometry->GlobalCol(cellID) - 47.5f); // calculate time to get to specific column
-      timeshift = -std::sqrt(215.f + timeCol * timeCol);            // 215 is 14.67ns^2 (time it takes to get the cell at eta = 0)
+      float timeCol = 0.2f * (mCellGeometry[cellID].col - 47.5f); // calculate time to get to specific column
+      timeshift = -std::sqrt(215.f + timeCol * timeCol);          // 215 is 14.67ns^2 (time it takes to get the cell at eta = 0)
 
       // Also smear the time to account for the broader time resolution in data than in MC
       if (cellEnergy < minLeaderEnergy)                                           // Cells with tless than 300 MeV cannot be the leading cell in the cluster, so their time does not require precise calibration
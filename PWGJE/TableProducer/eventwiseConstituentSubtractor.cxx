@@ -88,6 +88,9 @@ struct eventWiseConstituentSubtractorTask {
   Configurable<double> ghostGridScatter{"ghostGridScatter", 1.0, "Grid scatter"};
   Configurable<double> ghostKtScatter{"ghostKtScatter", 0.1, "kT scatter"};
   Configurable<double> ghostMeanPt{"ghostMeanPt", 1e-100, "Mean ghost pT"};
+  Configurable<int> nTilesPhi{"nTilesPhi", 1, "number of phi tiles subtracted separately (1 = exact subtraction of the full event)"};
+  Configurable<float> tileMargin{"tileMargin", 2.0, "margin of the particles added on both sides of each phi tile, in units of rMax"};
+  Configurable<int> nThreadsTiles{"nThreadsTiles", 1, "number of threads used to subtract the phi tiles concurrently"};
 
   JetBkgSubUtils eventWiseConstituentSubtractor;
   std::vector<fastjet::PseudoJet> inputParticles;
@@ -117,6 +120,14 @@ struct eventWiseConstituentSubtractorTask {
   Filter trackCuts = (aod::jtrack::pt >= trackPtMin && aod::jtrack::pt < trackPtMax && aod::jtrack::eta > trackEtaMin && aod::jtrack::eta < trackEtaMax && aod::jtrack::phi >= trackPhiMin && aod::jtrack::phi <= trackPhiMax);
   Filter partCuts = (aod::jmcparticle::pt >= trackPtMin && aod::jmcparticle::pt < trackPtMax && aod::jmcparticle::eta >= trackEtaMin && aod::jmcparticle::eta <= trackEtaMax && aod::jmcparticle::phi >= trackPhiMin && aod::jmcparticle::phi <= trackPhiMax);
 
+  std::vector<fastjet::PseudoJet> subtractEvent(double rho, double rhoM)
+  {
+    if (nTilesPhi > 1) {
+      return eventWiseConstituentSubtractor.JetBkgSubUtils::doEventConstSubTiled(inputParticles, rho, rhoM, nTilesPhi, nThreadsTiles, tileMargin);
+    }
+    return eventWiseConstituentSubtractor.JetBkgSubUtils::doEventConstSub(inputParticles, rho, rhoM);
+  }
+
   template <typename T, typename U, typename V, typename M>
   void analyseHF(T const& collision, U const& tracks, V const& candidates, M& trackSubTable)
   {
@@ -131,7 +142,7 @@ struct eventWiseConstituentSubtractorTask {
       tracksSubtracted.clear();
       jetfindingutilities::analyseTracks(inputParticles, tracks, trackSelection, &candidate);
 
-      tracksSubtracted = eventWiseConstituentSubtractor.JetBkgSubUtils::doEventConstSub(inputParticles, candidate.rho(), candidate.rhoM());
+      tracksSubtracted = subtractEvent(candidate.rho(), candidate.rhoM());
       for (auto const& trackSubtracted : tracksSubtracted) {
         trackSubTable(candidate.globalIndex(), trackSubtracted.pt(), trackSubtracted.eta(), trackSubtracted.phi(), jetderiveddatautilities::setSingleTrackSelectionBit(trackSelection));
       }
@@ -152,7 +163,7 @@ struct eventWiseConstituentSubtractorTask {
       tracksSubtracted.clear();
       jetfindingutilities::analyseParticles<true>(inputParticles, particleSelection, 1, particles, pdgDatabase, &candidate); // currently only works for charged analyses
 
-      tracksSubtracted = eventWiseConstituentSubtractor.JetBkgSubUtils::doEventConstSub(inputParticles, candidate.rho(), candidate.rhoM());
+      tracksSubtracted = subtractEvent(candidate.rho(), candidate.rhoM());
       for (auto const& trackSubtracted : tracksSubtracted) {
         particleSubTable(candidate.globalIndex(), trackSubtracted.pt(), trackSubtracted.eta(), trackSubtracted.phi(), trackSubtracted.rap(), trackSubtracted.e(), 211, 0, static_cast<uint8_t>(o2::aod::mcparticle::enums::PhysicalPrimary)); // everything after phi is artificial and should not be used for analyses
       }
@@ -168,7 +179,7 @@ struct eventWiseConstituentSubtractorTask {
     tracksSubtracted.clear();
     jetfindingutilities::analyseTracks<soa::Filtered<aod::JetTracks>, soa::Filtered<aod::JetTracks>::iterator>(inputParticles, tracks, trackSelection);
 
-    tracksSubtracted = eventWiseConstituentSubtractor.JetBkgSubUtils::doEventConstSub(inputParticles, collision.rho(), collision.rhoM());
+    tracksSubtracted = subtractEvent(collision.rho(), collision.rhoM());
 
     for (auto const& trackSubtracted : tracksSubtracted) {
       trackSubtractedTable(collision.globalIndex(), trackSubtracted.pt(), trackSubtracted.eta(), trackSubtracted.phi(), jetderiveddatautilities::setSingleTrackSelectionBit(trackSelection));
@@ -185,7 +196,7 @@ struct eventWiseConstituentSubtractorTask {
     tracksSubtracted.clear();
     jetfindingutilities::analyseParticles<false, soa::Filtered<aod::JetParticles>, soa::Filtered<aod::JetParticles>::iterator>(inputParticles, particleSelection, 1, particles, pdgDatabase);
 
-    tracksSubtracted = eventWiseConstituentSubtractor.JetBkgSubUtils::doEventConstSub(inputParticles, mcCollision.rho(), mcCollision.rhoM());
+    tracksSubtracted = subtractEvent(mcCollision.rho(), mcCollision.rhoM());
 
     for (auto const& trackSubtracted : tracksSubtracted) {
       particleSubtractedTable(mcCollision.globalIndex(), trackSubtracted.pt(), trackSubtracted.eta(), trackSubtracted.phi(), trackSubtracted.rap(), trackSubtracted.e(), 211, 0, static_cast<uint8_t>(o2::aod::mcparticle::enums::PhysicalPrimary)); // everything after phi is artificial and should not be used for analyses
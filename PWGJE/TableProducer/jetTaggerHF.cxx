@@ -50,6 +50,7 @@
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <span>
 #include <string>
 #include <type_traits>
 #include <vector>
@@ -112,6 +113,7 @@ struct JetTaggerHFTask {
   Configurable<int> nClassesMl{"nClassesMl", 2, "Number of classes in ML model"};
   Configurable<std::vector<std::string>> namesInputFeatures{"namesInputFeatures", std::vector<std::string>{"feature1", "feature2"}, "Names of ML model input features"};
   Configurable<bool> useDb{"useDb", false, "Flag to use DB for ML model instead of the score"};
+  Configurable<bool> useBatchedInference{"useBatchedInference", false, "Evaluate the ML model once per data frame and pT bin on all the jets instead of once per jet (not used by the GNN)"};
 
   Configurable<std::string> ccdbUrl{"ccdbUrl", "http://alice-ccdb.cern.ch", "url of the ccdb repository"};
   Configurable<std::vector<std::string>> modelPathsCCDB{"modelPathsCCDB", std::vector<std::string>{"Users/h/hahassan"}, "Paths of models on CCDB"};
@@ -148,6 +150,14 @@ struct JetTaggerHFTask {
   o2::analysis::MlResponseHfTagging<float> bMlResponse;
   o2::ccdb::CcdbApi ccdbApi;
 
+  // inputs and outputs of the batched ML inference, reused among data frames
+  std::vector<std::vector<float>> batchInputs1D;
+  std::vector<std::vector<std::vector<float>>> batchInputs2D;
+  std::vector<float> batchJetPts;
+  std::vector<int32_t> batchJetIndices;
+  std::vector<bool> batchIsSelected;
+  std::vector<std::vector<float>> batchOutputs;
+
   using JetTracksExt = soa::Join<aod::JetTracks, aod::JTrackExtras, aod::JTrackPIs>;
   using OriginalTracks = soa::Join<aod::Tracks, aod::TracksCov, aod::TrackSelection, aod::TracksDCA, aod::TracksDCACov, aod::TracksExtra>;
 
@@ -545,9 +555,51 @@ struct JetTaggerHFTask {
     }
   }
 
+  void clearBatch()
+  {
+    batchInputs1D.clear();
+    batchInputs2D.clear();
+    batchJetPts.clear();
+    batchJetIndices.clear();
+  }
+
+  template <typename AnyJet, typename T2, typename T3>
+  void addJetToBatch(AnyJet const& jet, jettaggingutilities::BJetParams const& jetparam, std::vector<T2> const& tracksParams, std::vector<T3> const& svsParams)
+  {
+    if (bMlResponse.getInputShape().size() > 1) {
+      batchInputs2D.push_back(bMlResponse.getInputFeatures2D(jetparam, tracksParams, svsParams));
+    } else {
+      batchInputs1D.push_back(bMlResponse.getInputFeatures1D(jetparam, tracksParams, svsParams));
+    }
+    batchJetPts.push_back(jet.pt());
+    batchJetIndices.push_back(jet.globalIndex());
+  }
+
+  void evaluateBatch()
+  {
+    if (bMlResponse.getInputShape().size() > 1) {
+      bMlResponse.isSelectedMlBatchMultiInput(std::span(batchInputs2D), std::span(batchJetPts), batchIsSelected, &batchOutputs);
+    } else {
+      bMlResponse.isSelectedMlBatch(std::span(batchInputs1D), std::span(batchJetPts), batchIsSelected, &batchOutputs);
+    }
+  }
+
+  float getScoreML(const std::vector<float>& output)
+  {
+    if (bMlResponse.getOutputNodes() > 1) {
+      auto mDb = [](const std::vector<float>& scores, float fC) {
+        return std::log(scores[2] / (fC * scores[1] + (1 - fC) * scores[0]));
+      };
+
+      return useDb ? mDb(output, fC) : output[2]; // 2 is the b-jet index
+    }
+    return output[0];
+  }
+
   template <typename AnyJets, typename AnyTracks, typename SecondaryVertices>
   void analyzeJetAlgorithmML(AnyJets const& alljets, AnyTracks const& allTracks, SecondaryVertices const& allSVs)
   {
+    clearBatch();
     for (const auto& analysisJet : alljets) {
 
       std::vector<jettaggingutilities::BJetTrackParams> tracksParams;
@@ -562,6 +614,11 @@ struct JetTaggerHFTask {
       tracksParams.resize(nJetConst); // resize to the number of inputs of the ML
       svsParams.resize(nJetConst);    // resize to the number of inputs of the ML
 
+      if (useBatchedInference) {
+        addJetToBatch(analysisJet, jetparam, tracksParams, svsParams);
+        continue;
+      }
+
       std::vector<float> output;
 
       if (bMlResponse.getInputShape().size() > 1) {
@@ -572,14 +629,13 @@ struct JetTaggerHFTask {
         bMlResponse.isSelectedMl(inputML, analysisJet.pt(), output);
       }
 
-      if (bMlResponse.getOutputNodes() > 1) {
-        auto mDb = [](const std::vector<float>& scores, float fC) {
-          return std::log(scores[2] / (fC * scores[1] + (1 - fC) * scores[0]));
-        };
+      scoreML[analysisJet.globalIndex()] = getScoreML(output);
+    }
 
-        scoreML[analysisJet.globalIndex()] = useDb ? mDb(output, fC) : output[2]; // 2 is the b-jet index
-      } else {
-        scoreML[analysisJet.globalIndex()] = output[0];
+    if (useBatchedInference && !batchJetIndices.empty()) {
+      evaluateBatch();
+      for (std::size_t i = 0; i < batchJetIndices.size(); i++) {
+        scoreML[batchJetIndices[i]] = getScoreML(batchOutputs[i]);
       }
     }
   }
@@ -587,6 +643,7 @@ struct JetTaggerHFTask {
   template <typename AnyJets, typename AnyTracks>
   void analyzeJetAlgorithmMLnoSV(AnyJets const& alljets, AnyTracks const& allTracks)
   {
+    clearBatch();
     for (const auto& analysisJet : alljets) {
 
       std::vector<jettaggingutilities::BJetTrackParams> tracksParams;
@@ -597,6 +654,11 @@ struct JetTaggerHFTask {
       jettaggingutilities::BJetParams jetparam = {analysisJet.pt(), analysisJet.eta(), analysisJet.phi(), static_cast<int>(tracksParams.size()), 0, analysisJet.mass()};
       tracksParams.resize(nJetConst); // resize to the number of inputs of the ML
 
+      if (useBatchedInference) {
+        addJetToBatch(analysisJet, jetparam, tracksParams, svsParams);
+        continue;
+      }
+
       std::vector<float> output;
 
       if (bMlResponse.getInputShape().size() > 1) {
@@ -609,6 +671,13 @@ struct JetTaggerHFTask {
 
       scoreML[analysisJet.globalIndex()] = output[0];
     }
+
+    if (useBatchedInference && !batchJetIndices.empty()) {
+      evaluateBatch();
+      for (std::size_t i = 0; i < batchJetIndices.size(); i++) {
+        scoreML[batchJetIndices[i]] = batchOutputs[i][0];
+      }
+    }
   }
 
   template <typename AnyJets, typename AnyTracks, typename AnyOriginalTracks>
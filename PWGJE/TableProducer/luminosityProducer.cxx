@@ -19,7 +19,9 @@
 #include "PWGJE/DataModel/Jet.h"
 #include "PWGJE/DataModel/JetReducedData.h"
 
+#include "Common/CCDB/EventSelectionChecker.h"
 #include "Common/CCDB/EventSelectionParams.h"
+#include "Common/CCDB/RCTSelectionFlags.h"
 
 #include "Framework/ASoA.h"
 #include "Framework/AnalysisTask.h"
@@ -30,6 +32,7 @@
 #include <Framework/runDataProcessing.h>
 
 #include <algorithm>
+#include <array>
 #include <cstdlib>
 #include <iterator>
 #include <string>
@@ -49,27 +52,39 @@ struct LuminosityProducer {
   Configurable<bool> skipMBGapEvents{"skipMBGapEvents", true, "decide to run over MB gap events or not"};
   Configurable<bool> applyRCTSelections{"applyRCTSelections", true, "decide to apply RCT selections"};
 
+  // selections counted after the TVX and z-vertex requirements, in the order of the StoredCollisionCounts columns
+  static constexpr int NCollisionSelections = 11;
+  const std::array<std::string, NCollisionSelections> collisionSelectionNames{"sel8", "sel8Full", "sel8FullPbPb", "selMC", "selMCFull", "selMCFullPbPb", "selUnanchoredMC", "TVX", "sel7", "sel7KINT7", ""};
+
+  // the selection strings are parsed once, not for each collision
+  std::vector<int> eventSelectionBitsTVX;
+  std::array<std::vector<int>, NCollisionSelections> collisionSelectionBits;
+  o2::aod::rctsel::RCTFlagsChecker rctChecker; // same flags as the default ones of jetderiveddatautilities::selectCollision
+  o2::aod::evsel::EventSelectionChecker bcSelectionTVX{o2::aod::evsel::kIsTriggerTVX};
+  o2::aod::evsel::EventSelectionChecker bcSelectionTVXAndNoTFB{o2::aod::evsel::kIsTriggerTVX, o2::aod::evsel::kNoTimeFrameBorder};
+  o2::aod::evsel::EventSelectionChecker bcSelectionTVXAndNoTFBAndNoITSROFB{o2::aod::evsel::kIsTriggerTVX, o2::aod::evsel::kNoTimeFrameBorder, o2::aod::evsel::kNoITSROFrameBorder};
+
   void init(InitContext&)
   {
+    eventSelectionBitsTVX = jetderiveddatautilities::initialiseEventSelectionBits("TVX");
+    for (int iSelection = 0; iSelection < NCollisionSelections - 1; iSelection++) {
+      collisionSelectionBits[iSelection] = jetderiveddatautilities::initialiseEventSelectionBits(collisionSelectionNames[iSelection]);
+    }
+    collisionSelectionBits[NCollisionSelections - 1] = jetderiveddatautilities::initialiseEventSelectionBits(static_cast<std::string>(customEventSelections));
+    rctChecker.init("CBT_hadronPID", false, false);
   }
 
   void processBCCountingNonDerived(aod::JBCs const& bcs)
   {
-    int bcCounter = 0;
+    int bcCounter = bcs.size();
     int bcWithTVXCounter = 0;
     int bcWithTVXAndNoTFBCounter = 0;
     int bcWithTVXAndNoTFBAndNoITSROFBCounter = 0;
     for (const auto& bc : bcs) {
-      bcCounter++;
-      if (bc.selection_bit(aod::evsel::EventSelectionFlags::kIsTriggerTVX)) {
-        bcWithTVXCounter++;
-        if (bc.selection_bit(aod::evsel::EventSelectionFlags::kNoTimeFrameBorder)) {
-          bcWithTVXAndNoTFBCounter++;
-          if (bc.selection_bit(aod::evsel::EventSelectionFlags::kNoITSROFrameBorder)) {
-            bcWithTVXAndNoTFBAndNoITSROFBCounter++;
-          }
-        }
-      }
+      const uint64_t selection = bc.selection_raw();
+      bcWithTVXCounter += bcSelectionTVX.checkRaw(selection);
+      bcWithTVXAndNoTFBCounter += bcSelectionTVXAndNoTFB.checkRaw(selection);
+      bcWithTVXAndNoTFBAndNoITSROFBCounter += bcSelectionTVXAndNoTFBAndNoITSROFB.checkRaw(selection);
     }
     bcCountsTable(bcCounter, bcWithTVXCounter, bcWithTVXAndNoTFBCounter, bcWithTVXAndNoTFBAndNoITSROFBCounter);
   }
@@ -94,64 +109,28 @@ struct LuminosityProducer {
 
   void processCollisionCountingNonDerived(aod::JetCollisions const& collisions)
   {
-
-    int collisionCounter = 0;
+    int collisionCounter = collisions.size();
     int collisionWithTVXCounter = 0;
-    int collisionWithTVXAndZVertexAndSel8Counter = 0;
-    int collisionWithTVXAndZVertexAndSel8FullCounter = 0;
-    int collisionWithTVXAndZVertexAndSel8FullPbPbCounter = 0;
-    int collisionWithTVXAndZVertexAndSelMCCounter = 0;
-    int collisionWithTVXAndZVertexAndSelMCFullCounter = 0;
-    int collisionWithTVXAndZVertexAndSelMCFullPbPbCounter = 0;
-    int collisionWithTVXAndZVertexAndSelUnanchoredMCCounter = 0;
-    int collisionWithTVXAndZVertexAndSelTVXCounter = 0; // redundant but we keep it
-    int collisionWithTVXAndZVertexAndSel7Counter = 0;
-    int collisionWithTVXAndZVertexAndSel7KINT7Counter = 0;
-    int collisionWithCustomCounter = 0;
+    std::array<int, NCollisionSelections> collisionWithTVXAndZVertexCounters{};
     for (const auto& collision : collisions) {
-      collisionCounter++;
-      if (jetderiveddatautilities::selectCollision(collision, jetderiveddatautilities::initialiseEventSelectionBits("TVX"), skipMBGapEvents, false)) { // asuumes all selections include the TVX trigger but for this step does not include the rct flags
-        collisionWithTVXCounter++;
-        if (std::abs(collision.posZ()) > vertexZCutForCounting) {
-          continue;
-        }
-        if (jetderiveddatautilities::selectCollision(collision, jetderiveddatautilities::initialiseEventSelectionBits("sel8"), skipMBGapEvents, applyRCTSelections)) {
-          collisionWithTVXAndZVertexAndSel8Counter++;
-        }
-        if (jetderiveddatautilities::selectCollision(collision, jetderiveddatautilities::initialiseEventSelectionBits("TVX"), skipMBGapEvents, applyRCTSelections)) {
-          collisionWithTVXAndZVertexAndSelTVXCounter++;
-        }
-        if (jetderiveddatautilities::selectCollision(collision, jetderiveddatautilities::initialiseEventSelectionBits("sel7"), skipMBGapEvents, applyRCTSelections)) {
-          collisionWithTVXAndZVertexAndSel7Counter++;
-        }
-        if (jetderiveddatautilities::selectCollision(collision, jetderiveddatautilities::initialiseEventSelectionBits("sel7KINT7"), skipMBGapEvents, applyRCTSelections)) {
-          collisionWithTVXAndZVertexAndSel7KINT7Counter++;
-        }
-        if (jetderiveddatautilities::selectCollision(collision, jetderiveddatautilities::initialiseEventSelectionBits("sel8Full"), skipMBGapEvents, applyRCTSelections)) {
-          collisionWithTVXAndZVertexAndSel8FullCounter++;
-        }
-        if (jetderiveddatautilities::selectCollision(collision, jetderiveddatautilities::initialiseEventSelectionBits("sel8FullPbPb"), skipMBGapEvents, applyRCTSelections)) {
-          collisionWithTVXAndZVertexAndSel8FullPbPbCounter++;
-        }
-        if (jetderiveddatautilities::selectCollision(collision, jetderiveddatautilities::initialiseEventSelectionBits("selMC"), skipMBGapEvents, applyRCTSelections)) {
-          collisionWithTVXAndZVertexAndSelMCCounter++;
-        }
-        if (jetderiveddatautilities::selectCollision(collision, jetderiveddatautilities::initialiseEventSelectionBits("selMCFull"), skipMBGapEvents, applyRCTSelections)) {
-          collisionWithTVXAndZVertexAndSelMCFullCounter++;
-        }
-        if (jetderiveddatautilities::selectCollision(collision, jetderiveddatautilities::initialiseEventSelectionBits("selMCFullPbPb"), skipMBGapEvents, applyRCTSelections)) {
-          collisionWithTVXAndZVertexAndSelMCFullPbPbCounter++;
-        }
-        if (jetderiveddatautilities::selectCollision(collision, jetderiveddatautilities::initialiseEventSelectionBits("selUnanchoredMC"), skipMBGapEvents, applyRCTSelections)) {
-          collisionWithTVXAndZVertexAndSelUnanchoredMCCounter++;
-        }
-        if (jetderiveddatautilities::selectCollision(collision, jetderiveddatautilities::initialiseEventSelectionBits(static_cast<std::string>(customEventSelections)), skipMBGapEvents, applyRCTSelections)) {
-          collisionWithCustomCounter++;
-        }
+      if (!jetderiveddatautilities::selectCollision(collision, eventSelectionBitsTVX, skipMBGapEvents, false)) { // asuumes all selections include the TVX trigger but for this step does not include the rct flags
+        continue;
+      }
+      collisionWithTVXCounter++;
+      if (std::abs(collision.posZ()) > vertexZCutForCounting) {
+        continue;
+      }
+      if (applyRCTSelections && !rctChecker.checkTable(collision)) {
+        continue;
+      }
+      // the MB gap and RCT requirements are common to all the selections and already checked
+      for (int iSelection = 0; iSelection < NCollisionSelections; iSelection++) {
+        collisionWithTVXAndZVertexCounters[iSelection] += jetderiveddatautilities::selectCollision(collision, collisionSelectionBits[iSelection], false, false);
       }
     }
 
-    collisionCountsTable(collisionCounter, collisionWithTVXCounter, collisionWithTVXAndZVertexAndSel8Counter, collisionWithTVXAndZVertexAndSel8FullCounter, collisionWithTVXAndZVertexAndSel8FullPbPbCounter, collisionWithTVXAndZVertexAndSelMCCounter, collisionWithTVXAndZVertexAndSelMCFullCounter, collisionWithTVXAndZVertexAndSelMCFullPbPbCounter, collisionWithTVXAndZVertexAndSelUnanchoredMCCounter, collisionWithTVXAndZVertexAndSelTVXCounter, collisionWithTVXAndZVertexAndSel7Counter, collisionWithTVXAndZVertexAndSel7KINT7Counter, collisionWithCustomCounter);
+    const auto& counters = collisionWithTVXAndZVertexCounters;
+    collisionCountsTable(collisionCounter, collisionWithTVXCounter, counters[0], counters[1], counters[2], counters[3], counters[4], counters[5], counters[6], counters[7], counters[8], counters[9], counters[10]);
   }
   PROCESS_SWITCH(LuminosityProducer, processCollisionCountingNonDerived, "write out collision counting output table for running on full AO2D", true);
 
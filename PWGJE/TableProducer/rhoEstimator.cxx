@@ -14,6 +14,7 @@
 /// \author Nima Zardoshti <nima.zardoshti@cern.ch>
 
 #include "PWGJE/Core/JetBkgSubUtils.h"
+#include "PWGJE/Core/JetCandidateUtilities.h"
 #include "PWGJE/Core/JetDerivedDataUtilities.h"
 #include "PWGJE/Core/JetFindingUtilities.h"
 #include "PWGJE/DataModel/Jet.h"
@@ -33,6 +34,7 @@
 #include <fastjet/PseudoJet.hh>
 
 #include <string>
+#include <tuple>
 #include <type_traits>
 #include <vector>
 
@@ -84,6 +86,9 @@ struct RhoEstimatorTask {
     Configurable<float> bkgPhiMin{"bkgPhiMin", -6.283, "minimim phi for determining background density"};
     Configurable<float> bkgPhiMax{"bkgPhiMax", 6.283, "maximum phi for determining background density"};
     Configurable<bool> doSparse{"doSparse", false, "perfom sparse estimation"};
+    Configurable<int> rhoMethod{"rhoMethod", 0, "background density estimation. 0 = median of the kT jets with ghosted area, 1 = median of the cells of an eta-phi grid (no clustering)"};
+    Configurable<float> gridSpacing{"gridSpacing", 0.55, "cell size in eta and phi for the grid median estimation"};
+    Configurable<bool> incrementalCandidateRho{"incrementalCandidateRho", false, "cluster the kT jets once per collision and remove the candidate daughters from them, instead of reclustering for each candidate (rhoMethod 0, data only)"};
     Configurable<double> ghostRapMax{"ghostRapMax", 0.9, "Ghost rapidity max"};
     Configurable<int> ghostRepeat{"ghostRepeat", 1, "Ghost tiling repeats"};
     Configurable<double> ghostArea{"ghostArea", 0.005, "Area per ghost"};
@@ -112,6 +117,7 @@ struct RhoEstimatorTask {
   float bkgPhiMax_;
   float bkgPhiMin_;
   std::vector<fastjet::PseudoJet> inputParticles;
+  std::vector<int> excludedParticles;
   int trackSelection = -1;
   std::string particleSelection;
 
@@ -141,11 +147,53 @@ struct RhoEstimatorTask {
     fastjet::GhostedAreaSpec ghostAreaSpec(config.ghostRapMax, config.ghostRepeat, config.ghostArea,
                                            config.ghostGridScatter, config.ghostKtScatter, config.ghostMeanPt);
     bkgSub.setGhostAreaSpec(ghostAreaSpec);
+    bkgSub.setGridSpacing(config.gridSpacing);
 
     eventSelectionBits = jetderiveddatautilities::initialiseEventSelectionBits(static_cast<std::string>(config.eventSelections));
     triggerMaskBits = jetderiveddatautilities::initialiseTriggerMaskBits(config.triggerMasks);
   }
 
+  std::tuple<double, double> estimateRho(const std::vector<fastjet::PseudoJet>& particles)
+  {
+    if (config.rhoMethod == 1) {
+      return bkgSub.estimateRhoGridMedian(particles, config.doSparse);
+    }
+    return bkgSub.estimateRhoAreaMedian(particles, config.doSparse);
+  }
+
+  template <typename T, typename U, typename V>
+  void estimateCandidateRhosIncremental(aod::JetCollision const& collision, T const& tracks, U const& candidates, V& rhoTable)
+  {
+    if (!jetderiveddatautilities::selectCollision(collision, eventSelectionBits, config.skipMBGapEvents, config.applyRCTSelections) || collision.centFT0M() < config.centralityMin || collision.centFT0M() >= config.centralityMax || collision.trackOccupancyInTimeRange() > config.trackOccupancyInTimeRangeMax || std::abs(collision.posZ()) > config.vertexZCut) {
+      for ([[maybe_unused]] auto const& candidate : candidates) {
+        rhoTable(0.0, 0.0);
+      }
+      return;
+    }
+    if (candidates.size() == 0) {
+      return;
+    }
+    // the kT jets are clustered once with all the selected tracks, the daughters of each candidate are then removed from them
+    inputParticles.clear();
+    jetfindingutilities::analyseTracks<T, typename T::iterator>(inputParticles, tracks, trackSelection);
+    bkgSub.prepareRhoAreaMedian(inputParticles);
+    for (auto& candidate : candidates) {
+      excludedParticles.clear();
+      int position = 0;
+      for (auto& track : tracks) {
+        if (!jetderiveddatautilities::selectTrack(track, trackSelection)) {
+          continue;
+        }
+        if (jetcandidateutilities::isDaughterTrack(track, candidate)) {
+          excludedParticles.push_back(position);
+        }
+        position++;
+      }
+      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedianExcluding(excludedParticles, config.doSparse);
+      rhoTable(rho, rhoM);
+    }
+  }
+
   Filter trackCuts = (aod::jtrack::pt >= config.trackPtMin && aod::jtrack::pt < config.trackPtMax && aod::jtrack::eta > config.trackEtaMin && aod::jtrack::eta < config.trackEtaMax && aod::jtrack::phi >= config.trackPhiMin && aod::jtrack::phi <= config.trackPhiMax);
   Filter partCuts = (aod::jmcparticle::pt >= config.trackPtMin && aod::jmcparticle::pt < config.trackPtMax && aod::jmcparticle::eta >= config.trackEtaMin && aod::jmcparticle::eta <= config.trackEtaMax && aod::jmcparticle::phi >= config.trackPhiMin && aod::jmcparticle::phi <= config.trackPhiMax);
 
@@ -216,7 +264,7 @@ struct RhoEstimatorTask {
     }
     inputParticles.clear();
     jetfindingutilities::analyseTracks<soa::Filtered<aod::JetTracks>, soa::Filtered<aod::JetTracks>::iterator>(inputParticles, tracks, trackSelection);
-    auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+    auto [rho, rhoM] = estimateRho(inputParticles);
     rhoChargedTable(rho, rhoM);
   }
   PROCESS_SWITCH(RhoEstimatorTask, processChargedCollisions, "Fill rho tables for collisions using charged tracks", true);
@@ -229,13 +277,17 @@ struct RhoEstimatorTask {
     }
     inputParticles.clear();
     jetfindingutilities::analyseParticles<false, soa::Filtered<aod::JetParticles>, soa::Filtered<aod::JetParticles>::iterator>(inputParticles, particleSelection, 1, particles, pdgDatabase);
-    auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+    auto [rho, rhoM] = estimateRho(inputParticles);
     rhoChargedMcTable(rho, rhoM);
   }
   PROCESS_SWITCH(RhoEstimatorTask, processChargedMcCollisions, "Fill rho tables for MC collisions using charged tracks", false);
 
   void processD0Collisions(aod::JetCollision const& collision, soa::Filtered<aod::JetTracks> const& tracks, aod::CandidatesD0Data const& candidates)
   {
+    if (config.incrementalCandidateRho && config.rhoMethod == 0) {
+      estimateCandidateRhosIncremental(collision, tracks, candidates, rhoD0Table);
+      return;
+    }
     for (auto& candidate : candidates) {
       if (!jetderiveddatautilities::selectCollision(collision, eventSelectionBits, config.skipMBGapEvents, config.applyRCTSelections) || collision.centFT0M() < config.centralityMin || collision.centFT0M() >= config.centralityMax || collision.trackOccupancyInTimeRange() > config.trackOccupancyInTimeRangeMax || std::abs(collision.posZ()) > config.vertexZCut) {
         rhoD0Table(0.0, 0.0);
@@ -244,7 +296,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseTracks(inputParticles, tracks, trackSelection, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = estimateRho(inputParticles);
       rhoD0Table(rho, rhoM);
     }
   }
@@ -260,7 +312,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseParticles<true>(inputParticles, particleSelection, 1, particles, pdgDatabase, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = estimateRho(inputParticles);
       rhoD0McTable(rho, rhoM);
     }
   }
@@ -268,6 +320,10 @@ struct RhoEstimatorTask {
 
   void processDplusCollisions(aod::JetCollision const& collision, soa::Filtered<aod::JetTracks> const& tracks, aod::CandidatesDplusData const& candidates)
   {
+    if (config.incrementalCandidateRho && config.rhoMethod == 0) {
+      estimateCandidateRhosIncremental(collision, tracks, candidates, rhoDplusTable);
+      return;
+    }
     for (auto& candidate : candidates) {
       if (!jetderiveddatautilities::selectCollision(collision, eventSelectionBits, config.skipMBGapEvents, config.applyRCTSelections) || collision.centFT0M() < config.centralityMin || collision.centFT0M() >= config.centralityMax || collision.trackOccupancyInTimeRange() > config.trackOccupancyInTimeRangeMax || std::abs(collision.posZ()) > config.vertexZCut) {
         rhoDplusTable(0.0, 0.0);
@@ -276,7 +332,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseTracks(inputParticles, tracks, trackSelection, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = estimateRho(inputParticles);
       rhoDplusTable(rho, rhoM);
     }
   }
@@ -293,7 +349,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseParticles<true>(inputParticles, particleSelection, 1, particles, pdgDatabase, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = estimateRho(inputParticles);
       rhoDplusMcTable(rho, rhoM);
     }
   }
@@ -301,6 +357,10 @@ struct RhoEstimatorTask {
 
   void processDsCollisions(aod::JetCollision const& collision, soa::Filtered<aod::JetTracks> const& tracks, aod::CandidatesDsData const& candidates)
   {
+    if (config.incrementalCandidateRho && config.rhoMethod == 0) {
+      estimateCandidateRhosIncremental(collision, tracks, candidates, rhoDsTable);
+      return;
+    }
     for (auto& candidate : candidates) {
       if (!jetderiveddatautilities::selectCollision(collision, eventSelectionBits, config.skipMBGapEvents, config.applyRCTSelections) || collision.centFT0M() < config.centralityMin || collision.centFT0M() >= config.centralityMax || collision.trackOccupancyInTimeRange() > config.trackOccupancyInTimeRangeMax || std::abs(collision.posZ()) > config.vertexZCut) {
         rhoDsTable(0.0, 0.0);
@@ -309,7 +369,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseTracks(inputParticles, tracks, trackSelection, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = estimateRho(inputParticles);
       rhoDsTable(rho, rhoM);
     }
   }
@@ -325,7 +385,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseParticles<true>(inputParticles, particleSelection, 1, particles, pdgDatabase, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = estimateRho(inputParticles);
       rhoDsMcTable(rho, rhoM);
     }
   }
@@ -333,6 +393,10 @@ struct RhoEstimatorTask {
 
   void processDstarCollisions(aod::JetCollision const& collision, soa::Filtered<aod::JetTracks> const& tracks, aod::CandidatesDstarData const& candidates)
   {
+    if (config.incrementalCandidateRho && config.rhoMethod == 0) {
+      estimateCandidateRhosIncremental(collision, tracks, candidates, rhoDstarTable);
+      return;
+    }
     for (auto& candidate : candidates) {
       if (!jetderiveddatautilities::selectCollision(collision, eventSelectionBits, config.skipMBGapEvents, config.applyRCTSelections) || collision.centFT0M() < config.centralityMin || collision.centFT0M() >= config.centralityMax || collision.trackOccupancyInTimeRange() > config.trackOccupancyInTimeRangeMax || std::abs(collision.posZ()) > config.vertexZCut) {
         rhoDstarTable(0.0, 0.0);
@@ -341,7 +405,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseTracks(inputParticles, tracks, trackSelection, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = estimateRho(inputParticles);
       rhoDstarTable(rho, rhoM);
     }
   }
@@ -357,7 +421,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseParticles<true>(inputParticles, particleSelection, 1, particles, pdgDatabase, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = estimateRho(inputParticles);
       rhoDstarMcTable(rho, rhoM);
     }
   }
@@ -365,6 +429,10 @@ struct RhoEstimatorTask {
 
   void processLcCollisions(aod::JetCollision const& collision, soa::Filtered<aod::JetTracks> const& tracks, aod::CandidatesLcData const& candidates)
   {
+    if (config.incrementalCandidateRho && config.rhoMethod == 0) {
+      estimateCandidateRhosIncremental(collision, tracks, candidates, rhoLcTable);
+      return;
+    }
     for (auto& candidate : candidates) {
       if (!jetderiveddatautilities::selectCollision(collision, eventSelectionBits, config.skipMBGapEvents, config.applyRCTSelections) || collision.centFT0M() < config.centralityMin || collision.centFT0M() >= config.centralityMax || collision.trackOccupancyInTimeRange() > config.trackOccupancyInTimeRangeMax || std::abs(collision.posZ()) > config.vertexZCut) {
         rhoLcTable(0.0, 0.0);
@@ -373,7 +441,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseTracks(inputParticles, tracks, trackSelection, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = estimateRho(inputParticles);
       rhoLcTable(rho, rhoM);
     }
   }
@@ -389,7 +457,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseParticles<true>(inputParticles, particleSelection, 1, particles, pdgDatabase, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = estimateRho(inputParticles);
       rhoLcMcTable(rho, rhoM);
     }
   }
@@ -397,6 +465,10 @@ struct RhoEstimatorTask {
 
   void processB0Collisions(aod::JetCollision const& collision, soa::Filtered<aod::JetTracks> const& tracks, aod::CandidatesB0Data const& candidates)
   {
+    if (config.incrementalCandidateRho && config.rhoMethod == 0) {
+      estimateCandidateRhosIncremental(collision, tracks, candidates, rhoB0Table);
+      return;
+    }
     for (auto& candidate : candidates) {
       if (!jetderiveddatautilities::selectCollision(collision, eventSelectionBits, config.skipMBGapEvents, config.applyRCTSelections) || collision.centFT0M() < config.centralityMin || collision.centFT0M() >= config.centralityMax || collision.trackOccupancyInTimeRange() > config.trackOccupancyInTimeRangeMax || std::abs(collision.posZ()) > config.vertexZCut) {
         rhoB0Table(0.0, 0.0);
@@ -405,7 +477,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseTracks(inputParticles, tracks, trackSelection, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = estimateRho(inputParticles);
       rhoB0Table(rho, rhoM);
     }
   }
@@ -421,7 +493,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseParticles<true>(inputParticles, particleSelection, 1, particles, pdgDatabase, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = estimateRho(inputParticles);
       rhoB0McTable(rho, rhoM);
     }
   }
@@ -429,6 +501,10 @@ struct RhoEstimatorTask {
 
   void processBplusCollisions(aod::JetCollision const& collision, soa::Filtered<aod::JetTracks> const& tracks, aod::CandidatesBplusData const& candidates)
   {
+    if (config.incrementalCandidateRho && config.rhoMethod == 0) {
+      estimateCandidateRhosIncremental(collision, tracks, candidates, rhoBplusTable);
+      return;
+    }
     for (auto& candidate : candidates) {
       if (!jetderiveddatautilities::selectCollision(collision, eventSelectionBits, config.skipMBGapEvents, config.applyRCTSelections) || collision.centFT0M() < config.centralityMin || collision.centFT0M() >= config.centralityMax || collision.trackOccupancyInTimeRange() > config.trackOccupancyInTimeRangeMax || std::abs(collision.posZ()) > config.vertexZCut) {
         rhoBplusTable(0.0, 0.0);
@@ -437,7 +513,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseTracks(inputParticles, tracks, trackSelection, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = estimateRho(inputParticles);
       rhoBplusTable(rho, rhoM);
     }
   }
@@ -453,7 +529,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseParticles<true>(inputParticles, particleSelection, 1, particles, pdgDatabase, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = estimateRho(inputParticles);
       rhoBplusMcTable(rho, rhoM);
     }
   }
@@ -461,6 +537,10 @@ struct RhoEstimatorTask {
 
   void processXicToXiPiPiCollisions(aod::JetCollision const& collision, soa::Filtered<aod::JetTracks> const& tracks, aod::CandidatesXicToXiPiPiData const& candidates)
   {
+    if (config.incrementalCandidateRho && config.rhoMethod == 0) {
+      estimateCandidateRhosIncremental(collision, tracks, candidates, rhoXicToXiPiPiTable);
+      return;
+    }
     for (auto& candidate : candidates) {
       if (!jetderiveddatautilities::selectCollision(collision, eventSelectionBits, config.skipMBGapEvents, config.applyRCTSelections) || collision.centFT0M() < config.centralityMin || collision.centFT0M() >= config.centralityMax || collision.trackOccupancyInTimeRange() > config.trackOccupancyInTimeRangeMax || std::abs(collision.posZ()) > config.vertexZCut) {
         rhoXicToXiPiPiTable(0.0, 0.0);
@@ -469,7 +549,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseTracks(inputParticles, tracks, trackSelection, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = estimateRho(inputParticles);
       rhoXicToXiPiPiTable(rho, rhoM);
     }
   }
@@ -485,7 +565,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseParticles<true>(inputParticles, particleSelection, 1, particles, pdgDatabase, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = estimateRho(inputParticles);
       rhoXicToXiPiPiMcTable(rho, rhoM);
     }
   }
@@ -493,6 +573,10 @@ struct RhoEstimatorTask {
 
   void processDielectronCollisions(aod::JetCollision const& collision, soa::Filtered<aod::JetTracks> const& tracks, aod::CandidatesDielectronData const& candidates)
   {
+    if (config.incrementalCandidateRho && config.rhoMethod == 0) {
+      estimateCandidateRhosIncremental(collision, tracks, candidates, rhoDielectronTable);
+      return;
+    }
     for (auto& candidate : candidates) {
       if (!jetderiveddatautilities::selectCollision(collision, eventSelectionBits, config.skipMBGapEvents, config.applyRCTSelections) || collision.centFT0M() < config.centralityMin || collision.centFT0M() >= config.centralityMax || collision.trackOccupancyInTimeRange() > config.trackOccupancyInTimeRangeMax || std::abs(collision.posZ()) > config.vertexZCut) {
         rhoDielectronTable(0.0, 0.0);
@@ -501,7 +585,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseTracks(inputParticles, tracks, trackSelection, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = estimateRho(inputParticles);
       rhoDielectronTable(rho, rhoM);
     }
   }
@@ -517,7 +601,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseParticles<true>(inputParticles, particleSelection, 1, particles, pdgDatabase, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = estimateRho(inputParticles);
       rhoDielectronMcTable(rho, rhoM);
     }
   }
@@ -14,6 +14,7 @@
 /// \author Hadi Hassan <hadi.hassan@cern.ch>
 
 #include "PWGHF/Utils/utilsBfieldCCDB.h"
+#include "PWGHF/Utils/utilsVertexingHf.h"
 #include "PWGJE/DataModel/Jet.h"
 #include "PWGJE/DataModel/JetReducedData.h"
 #include "PWGJE/DataModel/JetTagging.h"
@@ -45,6 +46,7 @@
 
 #include <array>
 #include <cstddef>
+#include <cstdint>
 #include <stdexcept>
 #include <string>
 #include <utility>
@@ -85,7 +87,9 @@ struct SecondaryVertexReconstruction {
   Configurable<float> etaMaxTrack{"etaMaxTrack", 4., "max. pseudorapidity"};
   Configurable<float> maxIPxy{"maxIPxy", 10, "maximum track DCA in xy plane"};
   Configurable<float> maxIPz{"maxIPz", 10, "maximum track DCA in z direction"};
+  Configurable<float> minIPxySignificance{"minIPxySignificance", -1., "min. significance of the track DCA in xy plane, negative: no cut"};
   Configurable<bool> fillHistograms{"fillHistograms", true, "do validation plots"};
+  Configurable<int> nThreadsVertexing{"nThreadsVertexing", 1, "number of threads reconstructing the secondary vertices with DCAFitterN, each with its own fitter. 1: serial"};
 
   Configurable<std::string> ccdbUrl{"ccdbUrl", "http://alice-ccdb.cern.ch", "url of the ccdb repository"};
   Configurable<std::string> ccdbPathLut{"ccdbPathLut", "GLO/Param/MatLUT", "Path for LUT parametrization"};
@@ -93,6 +97,12 @@ struct SecondaryVertexReconstruction {
 
   o2::vertexing::DCAFitterN<2> df2; // 2-prong vertex fitter
   o2::vertexing::DCAFitterN<3> df3; // 3-prong vertex fitter
+  o2::hf_vertexing::HfVertexingPool<2> vertexingPool2;
+  o2::hf_vertexing::HfVertexingPool<3> vertexingPool3;
+  std::vector<o2::hf_vertexing::HfVertexingInput<2>> vertexingInputs2;
+  std::vector<o2::hf_vertexing::HfVertexingInput<3>> vertexingInputs3;
+  std::vector<o2::hf_vertexing::HfVertexingResult<2>> vertexingResults2;
+  std::vector<o2::hf_vertexing::HfVertexingResult<3>> vertexingResults3;
   Service<o2::ccdb::BasicCCDBManager> ccdb;
   o2::base::MatLayerCylSet* lut;
 
@@ -131,6 +141,15 @@ struct SecondaryVertexReconstruction {
     df3.setUseAbsDCA(useAbsDCA);
     df3.setWeightedFinalPCA(useWeightedFinalPCA);
 
+    // the momenta and impact parameters of the prongs are taken from the constituents, computed once per collision
+    vertexingPool2.init(df2, nThreadsVertexing);
+    vertexingPool2.setPropagateProngs(false);
+    vertexingPool3.init(df3, nThreadsVertexing);
+    vertexingPool3.setPropagateProngs(false);
+    if (nThreadsVertexing > 1) {
+      LOGF(info, "Reconstructing the secondary vertices with %d threads", nThreadsVertexing.value);
+    }
+
     ccdb->setURL(ccdbUrl);
     ccdb->setCaching(true);
     ccdb->setLocalObjectValidityChecking();
@@ -145,169 +164,252 @@ struct SecondaryVertexReconstruction {
   using JetTracksMCDwPIs = soa::Filtered<soa::Join<aod::JetTracksMCD, aod::JTrackPIs>>;
   using OriginalTracks = soa::Join<aod::Tracks, aod::TracksCov, aod::TrackSelection, aod::TracksDCA, aod::TracksDCACov>;
 
-  template <unsigned int numProngs, bool externalMagneticField, typename AnyCollision, typename AnyJet, typename AnyParticles>
-  void runCreatorNProng(AnyCollision const& collision,
-                        AnyJet const& analysisJet,
-                        AnyParticles const& listoftracks,
-                        std::vector<int>& svIndices,
-                        o2::vertexing::DCAFitterN<numProngs>& df,
-                        size_t prongIndex = 0,
-                        std::vector<size_t> currentCombination = {})
+  // Constituent track of the current collision, converted and propagated to the primary vertex once,
+  // whatever the number of jets and of combinations containing it
+  struct ProngCache {
+    o2::track::TrackParCov trackParCov;
+    std::array<float, 3> pVec;            // momentum of the input track
+    o2::dataformats::DCA impactParameter; // of the input track w.r.t. the primary vertex
+    double energy;                        // with the pion mass
+    float pt;
+  };
+  std::vector<ProngCache> prongCache;
+  std::vector<int> prongCacheSlots;       // position in prongCache of each original track, valid if stamped with the current collision
+  std::vector<uint64_t> prongCacheStamps; // collision counter at which the slot was filled
+  uint64_t prongCacheStamp{0};
+  std::vector<int> jetProngs;                    // selected constituents of the current jet, as positions in prongCache
+  std::vector<int> candidateJets;                // position in the jet table of each candidate of the collision
+  std::vector<std::vector<int>> candidateProngs; // prongCache positions of the prongs of each candidate
+  std::vector<float> candidateDispersions;       // computed by the fitting threads
+
+  template <typename AnyCollision>
+  void updateMagneticField(AnyCollision const& collision)
   {
+    auto bc = collision.template bc_as<aod::BCsWithTimestamps>();
+    if (runNumber != bc.runNumber()) {
+      initCCDB(bc, runNumber, ccdb, ccdbPathGrpMag, lut, false);
+      bz = o2::base::Propagator::Instance()->getNominalBz();
+    }
+  }
 
-    const auto& particles = analysisJet.template tracks_as<AnyParticles>();
+  /// Position in prongCache of the original track, converted and propagated at the first request in the collision
+  int getProngCacheSlot(OriginalTracks::iterator const& track, o2::dataformats::VertexBase const& primaryVertex)
+  {
+    const auto trackIndex = track.globalIndex();
+    if (static_cast<int64_t>(prongCacheStamps.size()) <= trackIndex) {
+      prongCacheStamps.resize(trackIndex + 1, 0);
+      prongCacheSlots.resize(trackIndex + 1, -1);
+    }
+    if (prongCacheStamps[trackIndex] == prongCacheStamp) {
+      return prongCacheSlots[trackIndex];
+    }
+    prongCacheStamps[trackIndex] = prongCacheStamp;
+    prongCacheSlots[trackIndex] = prongCache.size();
+    auto& prong = prongCache.emplace_back();
+    prong.trackParCov = getTrackParCov(track);
+    prong.trackParCov.getPxPyPzGlo(prong.pVec);
+    // This modifies track momenta!
+    auto trackParCovAtPV = prong.trackParCov;
+    trackParCovAtPV.propagateToDCA(primaryVertex, bz, &prong.impactParameter);
+    prong.energy = track.energy(o2::constants::physics::MassPiPlus);
+    prong.pt = track.pt();
+    return prongCacheSlots[trackIndex];
+  }
 
-    if (currentCombination.size() == numProngs) {
-      // Create an array of track parameters and covariance matrices for the current combination
-      std::array<o2::track::TrackParametrizationWithError<float>, numProngs> trackParVars;
-      double energySV = 0.;
+  /// Adds all the numProngs combinations of the selected constituents of the current jet to the vertexing inputs
+  template <unsigned int numProngs>
+  void addCombinations(int jetPosition, std::vector<o2::hf_vertexing::HfVertexingInput<numProngs>>& inputs, o2::dataformats::VertexBase const& primaryVertex,
+                       size_t prongIndex = 0, std::array<int, numProngs> currentCombination = {}, unsigned int nInCombination = 0)
+  {
+    if (nInCombination == numProngs) {
+      auto& input = inputs.emplace_back();
       for (unsigned int inum = 0; inum < numProngs; ++inum) {
-        const auto& prong = particles[currentCombination[inum]].template track_as<OriginalTracks>();
-        energySV += prong.energy(o2::constants::physics::MassPiPlus);
-        trackParVars[inum] = getTrackParCov(prong);
-      }
-
-      if constexpr (externalMagneticField) {
-        bz = magneticField;
-      } else {
-        auto bc = collision.template bc_as<aod::BCsWithTimestamps>();
-        if (runNumber != bc.runNumber()) {
-          initCCDB(bc, runNumber, ccdb, ccdbPathGrpMag, lut, false);
-          bz = o2::base::Propagator::Instance()->getNominalBz();
-        }
+        input.tracks[inum] = prongCache[currentCombination[inum]].trackParCov;
       }
+      input.primaryVertex = primaryVertex;
+      input.bz = bz;
+      candidateJets.push_back(jetPosition);
+      candidateProngs.emplace_back(currentCombination.begin(), currentCombination.end());
+      return;
+    }
+    for (size_t iprong = prongIndex; iprong < jetProngs.size(); ++iprong) {
+      currentCombination[nInCombination] = jetProngs[iprong];
+      addCombinations<numProngs>(jetPosition, inputs, primaryVertex, iprong + 1, currentCombination, nInCombination + 1);
+    }
+  }
 
-      // Use a different fitter depending on the number of prongs
-      df.setBz(bz);
+  /// Reconstructs the numProngs secondary vertices of all the jets of the collision.
+  /// The constituents are converted once per collision, the combinations of all the jets are then fitted together, on several threads
+  /// if configured, and the candidates are finally written jet by jet in the order of the combinations
+  template <unsigned int numProngs, bool externalMagneticField, typename AnyCollision, typename AnyJets, typename AnyParticles, typename AnyIndicesTable>
+  void runCreatorNProng(AnyCollision const& collision,
+                        AnyJets const& jets,
+                        AnyParticles const& /*listoftracks*/,
+                        o2::hf_vertexing::HfVertexingPool<numProngs>& vertexingPool,
+                        std::vector<o2::hf_vertexing::HfVertexingInput<numProngs>>& vertexingInputs,
+                        std::vector<o2::hf_vertexing::HfVertexingResult<numProngs>>& vertexingResults,
+                        AnyIndicesTable& svIndicesTable)
+  {
+    if constexpr (externalMagneticField) {
+      bz = magneticField;
+    } else {
+      updateMagneticField(collision);
+    }
 
-      // Reconstruct the secondary vertex
-      int processResult = 0;
-      try {
-        std::apply([&df, &processResult](const auto&... elems) { processResult = df.process(elems...); }, trackParVars);
-      } catch (const std::runtime_error& error) {
-        LOG(info) << "Run time error found: " << error.what() << ". DCAFitterN cannot work, skipping the candidate.";
-        return;
-      }
-      if (processResult == 0) {
-        return;
+    auto primaryVertex = getPrimaryVertex(collision);
+    auto covMatrixPV = primaryVertex.getCov();
+
+    prongCacheStamp++;
+    prongCache.clear();
+    candidateJets.clear();
+    candidateProngs.clear();
+    vertexingInputs.clear();
+    int jetPosition = 0;
+    for (const auto& analysisJet : jets) {
+      jetProngs.clear();
+      for (const auto& particle : analysisJet.template tracks_as<AnyParticles>()) {
+        const auto& testTrack = particle.template track_as<OriginalTracks>();
+        if (testTrack.pt() < ptMinTrack || testTrack.eta() < etaMinTrack || testTrack.eta() > etaMaxTrack || std::abs(testTrack.dcaXY()) > maxIPxy || std::abs(testTrack.dcaZ()) > maxIPz) {
+          continue;
+        }
+        if (minIPxySignificance > 0. && std::abs(testTrack.dcaXY()) < minIPxySignificance * std::sqrt(testTrack.sigmaDcaXY2())) {
+          continue; // compatible with the primary vertex
+        }
+        jetProngs.push_back(getProngCacheSlot(testTrack, primaryVertex));
       }
+      addCombinations<numProngs>(jetPosition++, vertexingInputs, primaryVertex);
+    }
 
+    candidateDispersions.assign(vertexingInputs.size(), 0.f);
+    vertexingPool.fit(vertexingInputs, vertexingResults, [&](o2::vertexing::DCAFitterN<numProngs>& df, std::size_t iCand) {
       const auto& secondaryVertex = df.getPCACandidatePos();
       if (std::sqrt(secondaryVertex[0] * secondaryVertex[0] + secondaryVertex[1] * secondaryVertex[1]) > maxRsv || std::abs(secondaryVertex[2]) > maxZsv) {
-        return;
+        return; // rejected when writing the candidates
       }
-
       float dispersion = 0.;
       for (unsigned int inum = 0; inum < numProngs; ++inum) {
         o2::dataformats::VertexBase sv(o2::math_utils::Point3D<float>{secondaryVertex[0], secondaryVertex[1], secondaryVertex[2]}, std::array<float, 6>{0});
         o2::dataformats::DCA dcaSV;
         auto& prong = df.getTrack(inum);
-        prong.propagateToDCA(sv, bz, &dcaSV);
+        prong.propagateToDCA(sv, vertexingInputs[iCand].bz, &dcaSV);
         dispersion += (dcaSV.getY() * dcaSV.getY() + dcaSV.getZ() * dcaSV.getZ());
       }
-      dispersion = std::sqrt(dispersion / numProngs);
-
-      auto chi2PCA = df.getChi2AtPCACandidate();
-      auto covMatrixPCA = df.calcPCACovMatrixFlat();
-
-      // get track impact parameters
-      // This modifies track momenta!
-      auto primaryVertex = getPrimaryVertex(collision);
-      auto covMatrixPV = primaryVertex.getCov();
-
-      // Get track momenta and impact parameters
-      std::array<std::array<float, 3>, numProngs> arrayMomenta;
-      std::array<o2::dataformats::DCA, numProngs> impactParameters;
-      for (unsigned int inum = 0; inum < numProngs; ++inum) {
-        trackParVars[inum].getPxPyPzGlo(arrayMomenta[inum]);
-        trackParVars[inum].propagateToDCA(primaryVertex, bz, &impactParameters[inum]);
-
-        if (fillHistograms) {
-          const auto& prong = particles[currentCombination[inum]].template track_as<OriginalTracks>();
-          registry.fill(HIST("hDcaXYNProngs"), prong.pt(), impactParameters[inum].getY() * toMicrometers, numProngs);
-          registry.fill(HIST("hDcaZNProngs"), prong.pt(), impactParameters[inum].getZ() * toMicrometers, numProngs);
-        }
-      }
-
-      // get uncertainty of the decay length
-      double phi, theta;
-      getPointDirection(std::array{primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ()}, secondaryVertex, phi, theta);
-      auto errorDecayLength = std::sqrt(getRotatedCovMatrixXX(covMatrixPV, phi, theta) + getRotatedCovMatrixXX(covMatrixPCA, phi, theta));
-      auto errorDecayLengthXY = std::sqrt(getRotatedCovMatrixXX(covMatrixPV, phi, 0.) + getRotatedCovMatrixXX(covMatrixPCA, phi, 0.));
-
-      // calculate invariant mass
-      std::array<double, numProngs> massArray;
-      std::fill(massArray.begin(), massArray.end(), o2::constants::physics::MassPiPlus);
-      double massSV = RecoDecay::m(std::move(arrayMomenta), massArray);
-
-      // fill candidate table rows
-      if ((doprocessData3Prongs || doprocessData3ProngsExternalMagneticField) && numProngs == 3) {
-        sv3prongTableData(analysisJet.globalIndex(),
-                          primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ(),
-                          secondaryVertex[0], secondaryVertex[1], secondaryVertex[2],
-                          arrayMomenta[0][0] + arrayMomenta[1][0] + arrayMomenta[2][0],
-                          arrayMomenta[0][1] + arrayMomenta[1][1] + arrayMomenta[2][1],
-                          arrayMomenta[0][2] + arrayMomenta[1][2] + arrayMomenta[2][2],
-                          energySV, massSV, chi2PCA, dispersion, errorDecayLength, errorDecayLengthXY);
-        svIndices.push_back(sv3prongTableData.lastIndex());
-      } else if ((doprocessData2Prongs || doprocessData2ProngsExternalMagneticField) && numProngs == 2) {
-        sv2prongTableData(analysisJet.globalIndex(),
-                          primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ(),
-                          secondaryVertex[0], secondaryVertex[1], secondaryVertex[2],
-                          arrayMomenta[0][0] + arrayMomenta[1][0],
-                          arrayMomenta[0][1] + arrayMomenta[1][1],
-                          arrayMomenta[0][2] + arrayMomenta[1][2],
-                          energySV, massSV, chi2PCA, dispersion, errorDecayLength, errorDecayLengthXY);
-        svIndices.push_back(sv2prongTableData.lastIndex());
-      } else if ((doprocessMCD3Prongs || doprocessMCD3ProngsExternalMagneticField) && numProngs == 3) {
-        sv3prongTableMCD(analysisJet.globalIndex(),
-                         primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ(),
-                         secondaryVertex[0], secondaryVertex[1], secondaryVertex[2],
-                         arrayMomenta[0][0] + arrayMomenta[1][0] + arrayMomenta[2][0],
-                         arrayMomenta[0][1] + arrayMomenta[1][1] + arrayMomenta[2][1],
-                         arrayMomenta[0][2] + arrayMomenta[1][2] + arrayMomenta[2][2],
-                         energySV, massSV, chi2PCA, dispersion, errorDecayLength, errorDecayLengthXY);
-        svIndices.push_back(sv3prongTableMCD.lastIndex());
-      } else if ((doprocessMCD2Prongs || doprocessMCD2ProngsExternalMagneticField) && numProngs == 2) {
-        sv2prongTableMCD(analysisJet.globalIndex(),
-                         primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ(),
-                         secondaryVertex[0], secondaryVertex[1], secondaryVertex[2],
-                         arrayMomenta[0][0] + arrayMomenta[1][0],
-                         arrayMomenta[0][1] + arrayMomenta[1][1],
-                         arrayMomenta[0][2] + arrayMomenta[1][2],
-                         energySV, massSV, chi2PCA, dispersion, errorDecayLength, errorDecayLengthXY);
-        svIndices.push_back(sv2prongTableMCD.lastIndex());
-      } else {
-        LOG(error) << "No process specified\n";
+      candidateDispersions[iCand] = std::sqrt(dispersion / numProngs);
+    });
+
+    std::vector<int> svIndices;
+    size_t iCand = 0;
+    jetPosition = 0;
+    for (const auto& analysisJet : jets) {
+      svIndices.clear();
+      for (; iCand < vertexingInputs.size() && candidateJets[iCand] == jetPosition; ++iCand) {
+        fillCandidate<numProngs>(analysisJet, primaryVertex, covMatrixPV, vertexingResults[iCand], candidateProngs[iCand], candidateDispersions[iCand], svIndices);
       }
+      svIndicesTable(svIndices);
+      jetPosition++;
+    }
+  }
 
-      // fill histograms
-      if (fillHistograms) {
-        double decayLengthNormalised = RecoDecay::distance(std::array{primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ()}, std::array{secondaryVertex[0], secondaryVertex[1], secondaryVertex[2]}) / errorDecayLength;
-        double decayLengthXYNormalised = RecoDecay::distanceXY(std::array{primaryVertex.getX(), primaryVertex.getY()}, std::array{secondaryVertex[0], secondaryVertex[1]}) / errorDecayLengthXY;
-
-        registry.fill(HIST("hDispersion"), dispersion, numProngs);
-        registry.fill(HIST("hMassNProngs"), massSV, numProngs);
-        registry.fill(HIST("hLxySNProngs"), decayLengthXYNormalised, numProngs);
-        registry.fill(HIST("hLSNProngs"), decayLengthNormalised, numProngs);
-        registry.fill(HIST("hFeNProngs"), energySV / analysisJet.energy() > 1. ? 0.99 : energySV / analysisJet.energy(), numProngs);
-      }
+  template <unsigned int numProngs, typename AnyJet, typename AnyCovMatrix>
+  void fillCandidate(AnyJet const& analysisJet,
+                     o2::dataformats::VertexBase const& primaryVertex,
+                     AnyCovMatrix const& covMatrixPV,
+                     o2::hf_vertexing::HfVertexingResult<numProngs> const& result,
+                     std::vector<int> const& prongs,
+                     float dispersion,
+                     std::vector<int>& svIndices)
+  {
+    if (result.status == o2::hf_trkcandsel::SVFitting::Fail) {
+      LOG(info) << "Run time error found: " << result.error << ". DCAFitterN cannot work, skipping the candidate.";
+      return;
+    }
+    if (result.status != o2::hf_trkcandsel::SVFitting::FitOk) {
+      return;
+    }
 
+    const auto& secondaryVertex = result.secondaryVertex;
+    if (std::sqrt(secondaryVertex[0] * secondaryVertex[0] + secondaryVertex[1] * secondaryVertex[1]) > maxRsv || std::abs(secondaryVertex[2]) > maxZsv) {
       return;
     }
 
-    // Recursive call to explore all combinations
-    for (size_t iprong = prongIndex; iprong < particles.size(); ++iprong) {
+    auto chi2PCA = result.chi2PCA;
+    const auto& covMatrixPCA = result.covMatrixPCA;
 
-      const auto& testTrack = particles[iprong].template track_as<OriginalTracks>();
-      if (testTrack.pt() < ptMinTrack || testTrack.eta() < etaMinTrack || testTrack.eta() > etaMaxTrack || std::abs(testTrack.dcaXY()) > maxIPxy || std::abs(testTrack.dcaZ()) > maxIPz) {
-        continue;
+    // Get track momenta and impact parameters
+    std::array<std::array<float, 3>, numProngs> arrayMomenta;
+    double energySV = 0.;
+    for (unsigned int inum = 0; inum < numProngs; ++inum) {
+      const auto& prong = prongCache[prongs[inum]];
+      arrayMomenta[inum] = prong.pVec;
+      energySV += prong.energy;
+      if (fillHistograms) {
+        registry.fill(HIST("hDcaXYNProngs"), prong.pt, prong.impactParameter.getY() * toMicrometers, numProngs);
+        registry.fill(HIST("hDcaZNProngs"), prong.pt, prong.impactParameter.getZ() * toMicrometers, numProngs);
       }
+    }
 
-      currentCombination.push_back(iprong);
-      runCreatorNProng<numProngs, externalMagneticField>(
-        collision, analysisJet, listoftracks, svIndices, df, iprong + 1, currentCombination);
-      currentCombination.pop_back();
+    // get uncertainty of the decay length
+    double phi, theta;
+    getPointDirection(std::array{primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ()}, secondaryVertex, phi, theta);
+    auto errorDecayLength = std::sqrt(getRotatedCovMatrixXX(covMatrixPV, phi, theta) + getRotatedCovMatrixXX(covMatrixPCA, phi, theta));
+    auto errorDecayLengthXY = std::sqrt(getRotatedCovMatrixXX(covMatrixPV, phi, 0.) + getRotatedCovMatrixXX(covMatrixPCA, phi, 0.));
+
+    // calculate invariant mass
+    std::array<double, numProngs> massArray;
+    std::fill(massArray.begin(), massArray.end(), o2::constants::physics::MassPiPlus);
+    double massSV = RecoDecay::m(std::move(arrayMomenta), massArray);
+
+    // fill candidate table rows
+    if ((doprocessData3Prongs || doprocessData3ProngsExternalMagneticField) && numProngs == 3) {
+      sv3prongTableData(analysisJet.globalIndex(),
+                        primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ(),
+                        secondaryVertex[0], secondaryVertex[1], secondaryVertex[2],
+                        arrayMomenta[0][0] + arrayMomenta[1][0] + arrayMomenta[2][0],
+                        arrayMomenta[0][1] + arrayMomenta[1][1] + arrayMomenta[2][1],
+                        arrayMomenta[0][2] + arrayMomenta[1][2] + arrayMomenta[2][2],
+                        energySV, massSV, chi2PCA, dispersion, errorDecayLength, errorDecayLengthXY);
+      svIndices.push_back(sv3prongTableData.lastIndex());
+    } else if ((doprocessData2Prongs || doprocessData2ProngsExternalMagneticField) && numProngs == 2) {
+      sv2prongTableData(analysisJet.globalIndex(),
+                        primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ(),
+                        secondaryVertex[0], secondaryVertex[1], secondaryVertex[2],
+                        arrayMomenta[0][0] + arrayMomenta[1][0],
+                        arrayMomenta[0][1] + arrayMomenta[1][1],
+                        arrayMomenta[0][2] + arrayMomenta[1][2],
+                        energySV, massSV, chi2PCA, dispersion, errorDecayLength, errorDecayLengthXY);
+      svIndices.push_back(sv2prongTableData.lastIndex());
+    } else if ((doprocessMCD3Prongs || doprocessMCD3ProngsExternalMagneticField) && numProngs == 3) {
+      sv3prongTableMCD(analysisJet.globalIndex(),
+                       primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ(),
+                       secondaryVertex[0], secondaryVertex[1], secondaryVertex[2],
+                       arrayMomenta[0][0] + arrayMomenta[1][0] + arrayMomenta[2][0],
+                       arrayMomenta[0][1] + arrayMomenta[1][1] + arrayMomenta[2][1],
+                       arrayMomenta[0][2] + arrayMomenta[1][2] + arrayMomenta[2][2],
+                       energySV, massSV, chi2PCA, dispersion, errorDecayLength, errorDecayLengthXY);
+      svIndices.push_back(sv3prongTableMCD.lastIndex());
+    } else if ((doprocessMCD2Prongs || doprocessMCD2ProngsExternalMagneticField) && numProngs == 2) {
+      sv2prongTableMCD(analysisJet.globalIndex(),
+                       primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ(),
+                       secondaryVertex[0], secondaryVertex[1], secondaryVertex[2],
+                       arrayMomenta[0][0] + arrayMomenta[1][0],
+                       arrayMomenta[0][1] + arrayMomenta[1][1],
+                       arrayMomenta[0][2] + arrayMomenta[1][2],
+                       energySV, massSV, chi2PCA, dispersion, errorDecayLength, errorDecayLengthXY);
+      svIndices.push_back(sv2prongTableMCD.lastIndex());
+    } else {
+      LOG(error) << "No process specified\n";
+    }
+
+    // fill histograms
+    if (fillHistograms) {
+      double decayLengthNormalised = RecoDecay::distance(std::array{primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ()}, std::array{secondaryVertex[0], secondaryVertex[1], secondaryVertex[2]}) / errorDecayLength;
+      double decayLengthXYNormalised = RecoDecay::distanceXY(std::array{primaryVertex.getX(), primaryVertex.getY()}, std::array{secondaryVertex[0], secondaryVertex[1]}) / errorDecayLengthXY;
+
+      registry.fill(HIST("hDispersion"), dispersion, numProngs);
+      registry.fill(HIST("hMassNProngs"), massSV, numProngs);
+      registry.fill(HIST("hLxySNProngs"), decayLengthXYNormalised, numProngs);
+      registry.fill(HIST("hLSNProngs"), decayLengthNormalised, numProngs);
+      registry.fill(HIST("hFeNProngs"), energySV / analysisJet.energy() > 1. ? 0.99 : energySV / analysisJet.energy(), numProngs);
     }
   }
 
@@ -318,81 +420,49 @@ struct SecondaryVertexReconstruction {
 
   void processData3Prongs(JetCollisionwPIs::iterator const& collision, aod::Collisions const& /*realColl*/, soa::Join<aod::ChargedJets, aod::ChargedJetConstituents> const& jets, JetTracksData const& tracks, OriginalTracks const& /*tracks*/, aod::BCsWithTimestamps const& /*bcWithTimeStamps*/)
   {
-    for (const auto& jet : jets) {
-      std::vector<int> svIndices;
-      runCreatorNProng<3, false>(collision.template collision_as<aod::Collisions>(), jet, tracks, svIndices, df3);
-      sv3prongIndicesTableData(svIndices);
-    }
+    runCreatorNProng<3, false>(collision.template collision_as<aod::Collisions>(), jets, tracks, vertexingPool3, vertexingInputs3, vertexingResults3, sv3prongIndicesTableData);
   }
   PROCESS_SWITCH(SecondaryVertexReconstruction, processData3Prongs, "Reconstruct the data 3-prong secondary vertex", false);
 
   void processData3ProngsExternalMagneticField(JetCollisionwPIs::iterator const& collision, aod::Collisions const& /*realColl*/, soa::Join<aod::ChargedJets, aod::ChargedJetConstituents> const& jets, JetTracksData const& tracks, OriginalTracks const& /*tracks*/)
   {
-    for (const auto& jet : jets) {
-      std::vector<int> svIndices;
-      runCreatorNProng<3, true>(collision.template collision_as<aod::Collisions>(), jet, tracks, svIndices, df3);
-      sv3prongIndicesTableData(svIndices);
-    }
+    runCreatorNProng<3, true>(collision.template collision_as<aod::Collisions>(), jets, tracks, vertexingPool3, vertexingInputs3, vertexingResults3, sv3prongIndicesTableData);
   }
   PROCESS_SWITCH(SecondaryVertexReconstruction, processData3ProngsExternalMagneticField, "Reconstruct the data 3-prong secondary vertex with external magnetic field", false);
 
   void processData2Prongs(JetCollisionwPIs::iterator const& collision, aod::Collisions const& /*realColl*/, soa::Join<aod::ChargedJets, aod::ChargedJetConstituents> const& jets, JetTracksData const& tracks, OriginalTracks const& /*tracks*/, aod::BCsWithTimestamps const& /*bcWithTimeStamps*/)
   {
-    for (const auto& jet : jets) {
-      std::vector<int> svIndices;
-      runCreatorNProng<2, false>(collision.template collision_as<aod::Collisions>(), jet, tracks, svIndices, df2);
-      sv2prongIndicesTableData(svIndices);
-    }
+    runCreatorNProng<2, false>(collision.template collision_as<aod::Collisions>(), jets, tracks, vertexingPool2, vertexingInputs2, vertexingResults2, sv2prongIndicesTableData);
   }
   PROCESS_SWITCH(SecondaryVertexReconstruction, processData2Prongs, "Reconstruct the data 2-prong secondary vertex", false);
 
   void processData2ProngsExternalMagneticField(JetCollisionwPIs::iterator const& collision, aod::Collisions const& /*realColl*/, soa::Join<aod::ChargedJets, aod::ChargedJetConstituents> const& jets, JetTracksData const& tracks, OriginalTracks const& /*tracks*/)
   {
-    for (const auto& jet : jets) {
-      std::vector<int> svIndices;
-      runCreatorNProng<2, true>(collision.template collision_as<aod::Collisions>(), jet, tracks, svIndices, df2);
-      sv2prongIndicesTableData(svIndices);
-    }
+    runCreatorNProng<2, true>(collision.template collision_as<aod::Collisions>(), jets, tracks, vertexingPool2, vertexingInputs2, vertexingResults2, sv2prongIndicesTableData);
   }
   PROCESS_SWITCH(SecondaryVertexReconstruction, processData2ProngsExternalMagneticField, "Reconstruct the data 2-prong secondary vertex with extrernal magnetic field", false);
 
   void processMCD3Prongs(JetCollisionwPIs::iterator const& collision, aod::Collisions const& /*realColl*/, soa::Join<aod::ChargedMCDetectorLevelJets, aod::ChargedMCDetectorLevelJetConstituents> const& mcdjets, JetTracksMCDwPIs const& tracks, OriginalTracks const& /*tracks*/, aod::BCsWithTimestamps const& /*bcWithTimeStamps*/)
   {
-    for (const auto& jet : mcdjets) {
-      std::vector<int> svIndices;
-      runCreatorNProng<3, false>(collision.template collision_as<aod::Collisions>(), jet, tracks, svIndices, df3);
-      sv3prongIndicesTableMCD(svIndices);
-    }
+    runCreatorNProng<3, false>(collision.template collision_as<aod::Collisions>(), mcdjets, tracks, vertexingPool3, vertexingInputs3, vertexingResults3, sv3prongIndicesTableMCD);
   }
   PROCESS_SWITCH(SecondaryVertexReconstruction, processMCD3Prongs, "Reconstruct the MCD 3-prong secondary vertex", false);
 
   void processMCD3ProngsExternalMagneticField(JetCollisionwPIs::iterator const& collision, aod::Collisions const& /*realColl*/, soa::Join<aod::ChargedMCDetectorLevelJets, aod::ChargedMCDetectorLevelJetConstituents> const& mcdjets, JetTracksMCDwPIs const& tracks, OriginalTracks const& /*tracks*/)
   {
-    for (const auto& jet : mcdjets) {
-      std::vector<int> svIndices;
-      runCreatorNProng<3, true>(collision.template collision_as<aod::Collisions>(), jet, tracks, svIndices, df3);
-      sv3prongIndicesTableMCD(svIndices);
-    }
+    runCreatorNProng<3, true>(collision.template collision_as<aod::Collisions>(), mcdjets, tracks, vertexingPool3, vertexingInputs3, vertexingResults3, sv3prongIndicesTableMCD);
   }
   PROCESS_SWITCH(SecondaryVertexReconstruction, processMCD3ProngsExternalMagneticField, "Reconstruct the MCD 3-prong secondary vertex with external magnetic field", false);
 
   void processMCD2Prongs(JetCollisionwPIs::iterator const& collision, aod::Collisions const& /*realColl*/, soa::Join<aod::ChargedMCDetectorLevelJets, aod::ChargedMCDetectorLevelJetConstituents> const& mcdjets, JetTracksMCDwPIs const& tracks, OriginalTracks const& /*tracks*/, aod::BCsWithTimestamps const& /*bcWithTimeStamps*/)
   {
-    for (const auto& jet : mcdjets) {
-      std::vector<int> svIndices;
-      runCreatorNProng<2, false>(collision.template collision_as<aod::Collisions>(), jet, tracks, svIndices, df2);
-      sv2prongIndicesTableMCD(svIndices);
-    }
+    runCreatorNProng<2, false>(collision.template collision_as<aod::Collisions>(), mcdjets, tracks, vertexingPool2, vertexingInputs2, vertexingResults2, sv2prongIndicesTableMCD);
   }
   PROCESS_SWITCH(SecondaryVertexReconstruction, processMCD2Prongs, "Reconstruct the MCD 2-prong secondary vertex", false);
 
   void processMCD2ProngsExternalMagneticField(JetCollisionwPIs::iterator const& collision, aod::Collisions const& /*realColl*/, soa::Join<aod::ChargedMCDetectorLevelJets, aod::ChargedMCDetectorLevelJetConstituents> const& mcdjets, JetTracksMCDwPIs const& tracks, OriginalTracks const& /*tracks*/)
   {
-    for (const auto& jet : mcdjets) {
-      std::vector<int> svIndices;
-      runCreatorNProng<2, true>(collision.template collision_as<aod::Collisions>(), jet, tracks, svIndices, df2);
-      sv2prongIndicesTableMCD(svIndices);
-    }
+    runCreatorNProng<2, true>(collision.template collision_as<aod::Collisions>(), mcdjets, tracks, vertexingPool2, vertexingInputs2, vertexingResults2, sv2prongIndicesTableMCD);
   }
   PROCESS_SWITCH(SecondaryVertexReconstruction, processMCD2ProngsExternalMagneticField, "Reconstruct the MCD 2-prong secondary vertex with external magnetic field", false);
 };
@@ -89,8 +89,7 @@ struct JetSubstructureHFTask {
   float candMass;
 
   std::vector<fastjet::PseudoJet> jetConstituents;
-  std::vector<fastjet::PseudoJet> jetReclustered;
-  JetFinder jetReclusterer;
+  jetsubstructureutilities::JetReclusterer jetReclusterer;
 
   std::vector<float> energyMotherVec;
   std::vector<float> ptLeadingVec;
@@ -131,9 +130,7 @@ struct JetSubstructureHFTask {
     registry.add("h2_jet_pt_jet_rg_eventwiseconstituentsubtracted", ";#it{p}_{T,jet} (GeV/#it{c});#it{R}_{g}", {o2::framework::HistType::kTH2F, {{200, 0., 200.}, {22, 0.0, 1.1}}});
     registry.add("h2_jet_pt_jet_nsd_eventwiseconstituentsubtracted", ";#it{p}_{T,jet} (GeV/#it{c});#it{n}_{SD}", {o2::framework::HistType::kTH2F, {{200, 0., 200.}, {15, -0.5, 14.5}}});
 
-    jetReclusterer.isReclustering = true;
     jetReclusterer.algorithm = fastjet::JetAlgorithm::cambridge_algorithm;
-    jetReclusterer.ghostRepeatN = 0;
 
     candMass = jetcandidateutilities::getTablePDGMass<CandidateTable>();
 
@@ -185,10 +182,8 @@ struct JetSubstructureHFTask {
     ptLeadingVec.clear();
     ptSubLeadingVec.clear();
     thetaVec.clear();
-    jetReclustered.clear();
-    fastjet::ClusterSequenceArea clusterSeq(jetReclusterer.findJets(jetConstituents, jetReclustered));
-    jetReclustered = sorted_by_pt(jetReclustered);
-    fastjet::PseudoJet daughterSubJet = jetReclustered[0];
+    // the reclustering history is kept by jetReclusterer, such that the N-subjettiness can be computed from the same reclustered jet
+    fastjet::PseudoJet daughterSubJet = jetReclusterer.recluster(jetConstituents, jet.r() / 100.f);
     fastjet::PseudoJet parentSubJet1;
     fastjet::PseudoJet parentSubJet2;
     bool softDropped = false;
@@ -473,8 +468,8 @@ struct JetSubstructureHFTask {
       fastjetutilities::fillTracks(jetHFCandidate, jetConstituents, jetHFCandidate.globalIndex(), JetConstituentStatus::candidate, candMass);
       nHFCandidates++;
     }
-    nSub = jetsubstructureutilities::getNSubjettiness(jet, tracks, tracks, candidates, 2, fastjet::contrib::CA_Axes(), true, zCut, beta);
     jetReclustering<false, isSubtracted>(jet, splittingTable, nHFCandidates);
+    nSub = jetsubstructureutilities::getPseudoJetNSubjettiness(jetReclusterer.getReclusteredJet(), jet.r() / 100.f, 2, fastjet::contrib::CA_Axes(), true, zCut, beta);
     jetPairing<false, isSubtracted>(jet, tracks, candidates, trackSlicer, pairTable);
     jetSubstructureSimple(jet, tracks, candidates);
     outputTable(energyMotherVec, ptLeadingVec, ptSubLeadingVec, thetaVec, nSub[0], nSub[1], nSub[2], pairJetPtVec, pairJetEnergyVec, pairJetThetaVec, pairJetPerpCone1PtVec, pairJetPerpCone1EnergyVec, pairJetPerpCone1ThetaVec, pairPerpCone1PerpCone1PtVec, pairPerpCone1PerpCone1EnergyVec, pairPerpCone1PerpCone1ThetaVec, pairPerpCone1PerpCone2PtVec, pairPerpCone1PerpCone2EnergyVec, pairPerpCone1PerpCone2ThetaVec, angularity, leadingConstituentPt, perpConeRho);
@@ -0,0 +1,59 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file LFNucleiPidTables.h
+/// \brief Light nuclei PID table (custom Bethe-Bloch TPC nSigma, TOF beta and mass), joinable to the track tables
+///
+
+#include "Framework/AnalysisDataModel.h"
+
+#include <cmath>
+
+#ifndef PWGLF_DATAMODEL_LFNUCLEIPIDTABLES_H_
+#define PWGLF_DATAMODEL_LFNUCLEIPIDTABLES_H_
+
+namespace o2::aod
+{
+namespace nucleipid
+{
+DECLARE_SOA_COLUMN(NucleiNSigmaTPCPr, nucleiNSigmaTPCPr, float);       //! TPC nSigma with the custom Bethe-Bloch parametrisation for proton
+DECLARE_SOA_COLUMN(NucleiNSigmaTPCDe, nucleiNSigmaTPCDe, float);       //! TPC nSigma with the custom Bethe-Bloch parametrisation for deuteron
+DECLARE_SOA_COLUMN(NucleiNSigmaTPCTr, nucleiNSigmaTPCTr, float);       //! TPC nSigma with the custom Bethe-Bloch parametrisation for triton
+DECLARE_SOA_COLUMN(NucleiNSigmaTPCHe, nucleiNSigmaTPCHe, float);       //! TPC nSigma with the custom Bethe-Bloch parametrisation for helium3
+DECLARE_SOA_COLUMN(NucleiNSigmaTPCAl, nucleiNSigmaTPCAl, float);       //! TPC nSigma with the custom Bethe-Bloch parametrisation for alpha
+DECLARE_SOA_COLUMN(NucleiBeta, nucleiBeta, float);                     //! TOF beta, not clamped (-999 without TOF)
+DECLARE_SOA_COLUMN(NucleiTOFMass2OverZ2, nucleiTOFMass2OverZ2, float); //! TOF (m/z)^2 from the TPC inner rigidity, -999 without TOF
+DECLARE_SOA_DYNAMIC_COLUMN(NucleiNSigmaTPC, nucleiNSigmaTPC,           //! TPC nSigma for the species index of nuclei::Species
+                           [](float pr, float de, float tr, float he, float al, int iS) -> float {
+                             const float nSigmas[5]{pr, de, tr, he, al};
+                             return (iS >= 0 && iS < 5) ? nSigmas[iS] : -999.f;
+                           });
+DECLARE_SOA_DYNAMIC_COLUMN(NucleiTOFMass, nucleiTOFMass, //! TOF mass for a given electric charge, -999 without TOF
+                           [](float mass2OverZ2, float charge) -> float {
+                             return mass2OverZ2 < 0.f ? -999.f : charge * std::sqrt(mass2OverZ2);
+                           });
+} // namespace nucleipid
+
+DECLARE_SOA_TABLE(NucleiPidTables, "AOD", "NUCLEIPID", //! Light nuclei PID, joinable to the track tables
+                  nucleipid::NucleiNSigmaTPCPr,
+                  nucleipid::NucleiNSigmaTPCDe,
+                  nucleipid::NucleiNSigmaTPCTr,
+                  nucleipid::NucleiNSigmaTPCHe,
+                  nucleipid::NucleiNSigmaTPCAl,
+                  nucleipid::NucleiBeta,
+                  nucleipid::NucleiTOFMass2OverZ2,
+                  nucleipid::NucleiNSigmaTPC<nucleipid::NucleiNSigmaTPCPr, nucleipid::NucleiNSigmaTPCDe, nucleipid::NucleiNSigmaTPCTr, nucleipid::NucleiNSigmaTPCHe, nucleipid::NucleiNSigmaTPCAl>,
+                  nucleipid::NucleiTOFMass<nucleipid::NucleiTOFMass2OverZ2>);
+using NucleiPidTable = NucleiPidTables::iterator;
+} // namespace o2::aod
+
+#endif // PWGLF_DATAMODEL_LFNUCLEIPIDTABLES_H_
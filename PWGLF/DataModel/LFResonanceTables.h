@@ -120,6 +120,55 @@ DECLARE_SOA_TABLE(ResoEvtPlCollisions, "AOD", "RESOEVTPLCOLLISION",
                   resocollision::EvtPlResBC);
 using ResoEvtPlCollision = ResoEvtPlCollisions::iterator;
 
+namespace resoblock
+{
+enum PidClass : int {
+  kPion = 0,
+  kKaon,
+  kProton,
+  kOther,
+  kNPidClasses
+};
+DECLARE_SOA_COLUMN(TrackFirst, trackFirst, int);           //! Row of ResoTracks of the first track of the event
+DECLARE_SOA_COLUMN(NTracksPi, nTracksPi, int);             //! Number of tracks of the pion class (first block of the event)
+DECLARE_SOA_COLUMN(NTracksKa, nTracksKa, int);             //! Number of tracks of the kaon class (second block of the event)
+DECLARE_SOA_COLUMN(NTracksPr, nTracksPr, int);             //! Number of tracks of the proton class (third block of the event)
+DECLARE_SOA_COLUMN(NTracksOther, nTracksOther, int);       //! Number of tracks without PID class, or of all the tracks if the tracks are not sorted
+DECLARE_SOA_COLUMN(MicroTrackFirst, microTrackFirst, int); //! Row of ResoMicroTracks of the first micro track of the event
+DECLARE_SOA_COLUMN(NMicroTracks, nMicroTracks, int);       //! Number of micro tracks of the event
+DECLARE_SOA_COLUMN(V0First, v0First, int);                 //! Row of ResoV0s of the first V0 of the event
+DECLARE_SOA_COLUMN(NV0s, nV0s, int);                       //! Number of V0s of the event
+DECLARE_SOA_COLUMN(CascadeFirst, cascadeFirst, int);       //! Row of ResoCascades of the first cascade of the event
+DECLARE_SOA_COLUMN(NCascades, nCascades, int);             //! Number of cascades of the event
+DECLARE_SOA_DYNAMIC_COLUMN(NTracks, nTracks,               //! Number of tracks of the event
+                           [](int nPi, int nKa, int nPr, int nOther) -> int { return nPi + nKa + nPr + nOther; });
+DECLARE_SOA_DYNAMIC_COLUMN(TrackClassFirst, trackClassFirst, //! Row of ResoTracks of the first track of a PID class block
+                           [](int first, int nPi, int nKa, int nPr, int pidClass) -> int {
+                             const int n[kNPidClasses - 1]{nPi, nKa, nPr};
+                             for (int i = 0; i < pidClass && i < kNPidClasses - 1; i++) {
+                               first += n[i];
+                             }
+                             return first;
+                           });
+} // namespace resoblock
+
+// Per event contiguous candidate blocks of the reduced tables, joinable to ResoCollisions
+DECLARE_SOA_TABLE(ResoCandidateBlocks, "AOD", "RESOCANDBLOCK",
+                  resoblock::TrackFirst,
+                  resoblock::NTracksPi,
+                  resoblock::NTracksKa,
+                  resoblock::NTracksPr,
+                  resoblock::NTracksOther,
+                  resoblock::MicroTrackFirst,
+                  resoblock::NMicroTracks,
+                  resoblock::V0First,
+                  resoblock::NV0s,
+                  resoblock::CascadeFirst,
+                  resoblock::NCascades,
+                  resoblock::NTracks<resoblock::NTracksPi, resoblock::NTracksKa, resoblock::NTracksPr, resoblock::NTracksOther>,
+                  resoblock::TrackClassFirst<resoblock::TrackFirst, resoblock::NTracksPi, resoblock::NTracksKa, resoblock::NTracksPr>);
+using ResoCandidateBlock = ResoCandidateBlocks::iterator;
+
 // For DF mixing study
 DECLARE_SOA_TABLE(ResoCollisionDFs, "AOD", "RESOCOLLISIONDF",
                   o2::soa::Index<>,
@@ -46,9 +46,11 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstdint>
 #include <cstdlib>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
@@ -97,6 +99,13 @@ struct decay3bodyBuilder {
   // helper object
   o2::pwglf::decay3bodyBuilderHelper helper;
 
+  // helpers used by the worker threads when building in parallel, copies of helper made for every DF
+  std::vector<o2::pwglf::decay3bodyBuilderHelper> helperPool;
+  static constexpr std::size_t PoolChunkSize = 4096; // candidates built in parallel before they are written out in order
+  std::vector<int> poolTripletIndices;               // index of the triplet of each decay3body of the chunk, -1 if not to be built
+  std::vector<o2::pwglf::decay3bodyCandidate> poolCandidates;
+  std::vector<uint8_t> poolIsBuilt;
+
   // table index : match order above
   enum tableIndex { kDecay3BodyIndices = 0,
                     kVtx3BodyDatas,
@@ -122,6 +131,7 @@ struct decay3bodyBuilder {
   Configurable<bool> doTrackQA{"doTrackQA", false, "Flag to fill QA histograms for daughter tracks of (selected) decay3body candidates."};
   Configurable<bool> doVertexQA{"doVertexQA", false, "Flag to fill QA histograms for PV of (selected) events."};
   Configurable<bool> disableITSROFCut{"disableITSROFCut", false, "Disable ITS ROF border cut"};
+  Configurable<int> nThreads{"nThreads", 1, "number of threads building the decay3body candidates, each with its own fitter. 1: serial building. Only used on AO2Ds"};
 
   // data processing options
   Configurable<bool> doSkimmedProcessing{"doSkimmedProcessing", false, "Apply Zoroo counting in case of skimmed data input"};
@@ -672,10 +682,63 @@ struct decay3bodyBuilder {
       }
     } // loop over collisions
 
+    // parallel building on AO2Ds: candidates are built by the pool chunk by chunk, then written out in order below
+    const bool usePool = soa::is_table<TBCs> && nThreads > 1;
+    std::size_t chunkBegin = 0, chunkEnd = 0;
+    if (usePool) {
+      helperPool.assign(nThreads, helper);
+    }
+    using TTriplet = o2::pwglf::decay3bodyTriplet<std::decay_t<decltype(collisions.rawIteratorAt(0))>, std::decay_t<decltype(decay3bodys.rawIteratorAt(0).template track0_as<TTracksTo>())>>;
+    std::vector<TTriplet> triplets;
+    const o2::pwglf::decay3bodyBuildOptions buildOptions{decay3bodyBuilderOpts.useKFParticle, decay3bodyBuilderOpts.kfSetTopologicalConstraint, decay3bodyBuilderOpts.useSelections, decay3bodyBuilderOpts.useChi2Selection,
+                                                         decay3bodyBuilderOpts.useTPCforPion, decay3bodyBuilderOpts.acceptTPCOnly, decay3bodyBuilderOpts.askOnlyITSMatch, decay3bodyBuilderOpts.calculateCovariance};
+    auto prebuildChunk = [&]() {
+      triplets.clear();
+      poolTripletIndices.assign(chunkEnd - chunkBegin, -1);
+      if constexpr (soa::is_table<TBCs>) {
+        for (std::size_t i = chunkBegin; i < chunkEnd; i++) {
+          auto const& decay3body = decay3bodys.rawIteratorAt(i);
+          // same candidate and event selections as in the loop below
+          if ((decay3bodyBuilderOpts.buildOnlyTracked && fTrackedClSizeVector[decay3body.globalIndex()] == 0) || decay3body.collisionId() < 0) {
+            continue;
+          }
+          auto const& collision = collisions.rawIteratorAt(decay3body.collisionId());
+          if (!collision.selection_bit(aod::evsel::kNoITSROFrameBorder) && !disableITSROFCut) {
+            continue;
+          }
+          if (!collision.selection_bit(aod::evsel::kIsTriggerTVX) || !collision.selection_bit(aod::evsel::kNoTimeFrameBorder) || (collision.posZ() >= 10.0f || collision.posZ() <= -10.0f)) {
+            continue;
+          }
+          if (doSkimmedProcessing && onlyKeepInterestedTrigger && !isTriggeredCollision[collision.globalIndex()]) {
+            continue;
+          }
+          auto trackPos = decay3body.template track0_as<TTracksTo>();
+          auto trackNeg = decay3body.template track1_as<TTracksTo>();
+          auto trackDeuteron = decay3body.template track2_as<TTracksTo>();
+          int protonSign = doLikeSign ? -trackDeuteron.sign() : trackDeuteron.sign();
+          float tofNSigmaDeuteron;
+          if constexpr (soa::is_table<TMCParticles>) {
+            tofNSigmaDeuteron = getTOFnSigma<true /*isMC*/, TCollisions>(mRespParamsV3, collision, trackDeuteron);
+          } else {
+            tofNSigmaDeuteron = getTOFnSigma<false /*isMC*/, TCollisions>(mRespParamsV3, collision, trackDeuteron);
+          }
+          poolTripletIndices[i - chunkBegin] = triplets.size();
+          triplets.emplace_back(TTriplet{collision, protonSign > 0 ? trackPos : trackNeg, protonSign > 0 ? trackNeg : trackPos, trackDeuteron, static_cast<int>(decay3body.globalIndex()), tofNSigmaDeuteron, static_cast<float>(fTrackedClSizeVector[decay3body.globalIndex()])});
+        }
+      }
+      o2::pwglf::buildDecay3BodyCandidates(helperPool, triplets, buildOptions, poolCandidates, poolIsBuilt);
+    };
+
     // Loop over all decay3bodys in same time frame
     registry.fill(HIST("Counters/hInputStatistics"), kVtx3BodyDatas, decay3bodys.size());
     int lastRunNumber = -1;
     for (const auto& decay3body : decay3bodys) {
+      if (usePool && static_cast<std::size_t>(decay3body.globalIndex()) >= chunkEnd) {
+        chunkBegin = decay3body.globalIndex();
+        chunkEnd = std::min(chunkBegin + PoolChunkSize, static_cast<std::size_t>(decay3bodys.size()));
+        prebuildChunk();
+      }
+
       // only build tracked decay3body if aksed
       if (decay3bodyBuilderOpts.buildOnlyTracked && fTrackedClSizeVector[decay3body.globalIndex()] == 0) {
         continue;
@@ -734,23 +797,29 @@ struct decay3bodyBuilder {
       }
 
       /// build Decay3body candidate
-      if (!helper.buildDecay3BodyCandidate(collision,
-                                           trackProton,
-                                           trackPion,
-                                           trackDeuteron,
-                                           decay3body.globalIndex(),
-                                           tofNSigmaDeuteron,
-                                           fTrackedClSizeVector[decay3body.globalIndex()],
-                                           decay3bodyBuilderOpts.useKFParticle,
-                                           decay3bodyBuilderOpts.kfSetTopologicalConstraint,
-                                           decay3bodyBuilderOpts.useSelections,
-                                           decay3bodyBuilderOpts.useChi2Selection,
-                                           decay3bodyBuilderOpts.useTPCforPion,
-                                           decay3bodyBuilderOpts.acceptTPCOnly,
-                                           decay3bodyBuilderOpts.askOnlyITSMatch,
-                                           decay3bodyBuilderOpts.calculateCovariance,
-                                           false /*isEventMixing*/,
-                                           false /*applySVertexerCuts*/)) {
+      if (usePool) {
+        const int iTriplet = poolTripletIndices[decay3body.globalIndex() - chunkBegin];
+        if (iTriplet < 0 || !poolIsBuilt[iTriplet]) {
+          continue;
+        }
+        helper.decay3body = poolCandidates[iTriplet];
+      } else if (!helper.buildDecay3BodyCandidate(collision,
+                                                  trackProton,
+                                                  trackPion,
+                                                  trackDeuteron,
+                                                  decay3body.globalIndex(),
+                                                  tofNSigmaDeuteron,
+                                                  fTrackedClSizeVector[decay3body.globalIndex()],
+                                                  decay3bodyBuilderOpts.useKFParticle,
+                                                  decay3bodyBuilderOpts.kfSetTopologicalConstraint,
+                                                  decay3bodyBuilderOpts.useSelections,
+                                                  decay3bodyBuilderOpts.useChi2Selection,
+                                                  decay3bodyBuilderOpts.useTPCforPion,
+                                                  decay3bodyBuilderOpts.acceptTPCOnly,
+                                                  decay3bodyBuilderOpts.askOnlyITSMatch,
+                                                  decay3bodyBuilderOpts.calculateCovariance,
+                                                  false /*isEventMixing*/,
+                                                  false /*applySVertexerCuts*/)) {
         continue;
       }
 
@@ -19,6 +19,7 @@
 #include "PWGLF/Utils/pidTOFGeneric.h"
 
 #include "Common/Core/RecoDecay.h"
+#include "Common/Core/ScratchArena.h"
 #include "Common/Core/trackUtilities.h"
 #include "Common/DataModel/EventSelection.h"
 #include "Common/DataModel/PIDResponseITS.h"
@@ -395,6 +396,7 @@ struct HyperkinkRecoTask {
   int mRunNumber;
   float mBz;
   o2::base::MatLayerCylSet* lut = nullptr;
+  o2::common::core::ScratchArena scratchArena; // per data frame collision flags
 
   o2::aod::ITSResponse itsResponse;
 
@@ -716,9 +718,10 @@ struct HyperkinkRecoTask {
     std::vector<int64_t> mcPartIndices;
     setTrackIDForMC(mcPartIndices, particlesMC, tracks);
     std::vector<int64_t> signalIndicesPool;
-    std::vector<bool> isReconstructedMCCollisions(mcCollisions.size(), false);
-    std::vector<bool> isSelectedMCCollisions(mcCollisions.size(), false);
-    std::vector<bool> isGoodCollisions(collisions.size(), false);
+    scratchArena.reset();
+    auto isReconstructedMCCollisions = scratchArena.allocate<uint8_t>(mcCollisions.size(), false);
+    auto isSelectedMCCollisions = scratchArena.allocate<uint8_t>(mcCollisions.size(), false);
+    auto isGoodCollisions = scratchArena.allocate<uint8_t>(collisions.size(), false);
     std::vector<int> dauIDList(2, -1);
 
     for (const auto& collision : collisions) {
@@ -966,7 +969,7 @@ struct HyperkinkRecoTask {
         -1, -1, -1,
         -1, -1, -1,
         -1, -1, -1,
-        true, false, isReconstructedMCCollisions[mcparticle.mcCollisionId()], isSelectedMCCollisions[mcparticle.mcCollisionId()],
+        true, false, static_cast<bool>(isReconstructedMCCollisions[mcparticle.mcCollisionId()]), static_cast<bool>(isSelectedMCCollisions[mcparticle.mcCollisionId()]),
         hypkinkCand.truePosSV[0], hypkinkCand.truePosSV[1], hypkinkCand.truePosSV[2],
         hypkinkCand.trueMomMothPV[0], hypkinkCand.trueMomMothPV[1], hypkinkCand.trueMomMothPV[2],
         hypkinkCand.trueMomMothSV[0], hypkinkCand.trueMomMothSV[1], hypkinkCand.trueMomMothSV[2],
@@ -0,0 +1,92 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file nucleiPidTable.cxx
+/// \brief Producer of the light nuclei PID table: TPC nSigma with the custom Bethe-Bloch parametrisations of nucleiUtils.h, TOF beta and TOF (m/z)^2, computed once per track
+///
+
+#include "PWGLF/DataModel/LFNucleiPidTables.h"
+#include "PWGLF/Utils/nucleiUtils.h"
+
+#include "Common/Core/PID/PIDTOF.h"
+#include "Common/TableProducer/PID/pidTOFBase.h"
+
+#include "Framework/AnalysisDataModel.h"
+#include "Framework/AnalysisTask.h"
+#include "Framework/runDataProcessing.h"
+#include "MathUtils/BetheBlochAleph.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace o2;
+using namespace o2::framework;
+
+struct nucleiPidTable {
+  Produces<o2::aod::NucleiPidTables> nucleiPid;
+
+  // Same meaning and defaults as in nucleiSpectra, the consumers must be configured consistently
+  Configurable<bool> cfgCompensatePIDinTracking{"cfgCompensatePIDinTracking", false, "If true, divide tpcInnerParam by the electric charge"};
+  Configurable<LabeledArray<double>> cfgMomentumScalingBetheBloch{"cfgMomentumScalingBetheBloch", {nuclei::bbMomScalingDefault[0], 5, 2, nuclei::names, nuclei::chargeLabelNames}, "TPC Bethe-Bloch momentum scaling for light nuclei"};
+  Configurable<LabeledArray<double>> cfgBetheBlochParams{"cfgBetheBlochParams", {nuclei::betheBlochDefault[0], 5, 6, nuclei::names, nuclei::betheBlochParNames}, "TPC Bethe-Bloch parameterisation for light nuclei"};
+
+  using TrackCandidates = soa::Join<aod::TracksIU, aod::TracksExtra, aod::TOFSignal, aod::TOFEvTime>;
+
+  double mBgScalings[nuclei::Species::kNspecies][2]; // [species][positive/negative]
+  double mBetheBloch[nuclei::Species::kNspecies][6]; // [species][p0-p4, resolution]
+
+  void init(o2::framework::InitContext&)
+  {
+    for (int iS{0}; iS < nuclei::Species::kNspecies; ++iS) {
+      const unsigned int iScaling = iS == 4 ? 3u : iS; // alpha shares the helium3 momentum scaling, as in nucleiSpectra
+      for (unsigned int iC{0}; iC < 2; ++iC) {
+        mBgScalings[iS][iC] = nuclei::charges[iS] * cfgMomentumScalingBetheBloch->get(iScaling, iC) / nuclei::masses[iS];
+      }
+      for (unsigned int iP{0}; iP < 6; ++iP) {
+        mBetheBloch[iS][iP] = cfgBetheBlochParams->get(iS, iP);
+      }
+    }
+  }
+
+  void process(TrackCandidates const& tracks)
+  {
+    nucleiPid.reserve(tracks.size());
+    for (const auto& track : tracks) {
+      const bool heliumPID = track.pidForTracking() == o2::track::PID::Helium3 || track.pidForTracking() == o2::track::PID::Alpha;
+      const float correctedTpcInnerParam = (heliumPID && cfgCompensatePIDinTracking) ? track.tpcInnerParam() / 2 : track.tpcInnerParam();
+      const int iC{track.sign() < 0};
+
+      float nSigma[nuclei::Species::kNspecies]{-999.f, -999.f, -999.f, -999.f, -999.f};
+      if (track.hasTPC()) {
+        for (int iS{0}; iS < nuclei::Species::kNspecies; ++iS) {
+          const double expBethe{common::BetheBlochAleph(static_cast<double>(correctedTpcInnerParam * mBgScalings[iS][iC]), mBetheBloch[iS][0], mBetheBloch[iS][1], mBetheBloch[iS][2], mBetheBloch[iS][3], mBetheBloch[iS][4])};
+          const double expSigma{expBethe * mBetheBloch[iS][5]};
+          nSigma[iS] = static_cast<float>((track.tpcSignal() - expBethe) / expSigma);
+        }
+      }
+
+      float beta{-999.f}, mass2OverZ2{-999.f};
+      if (track.hasTOF()) {
+        beta = o2::pid::tof::Beta::GetBeta(track);
+        const float clampedBeta = std::min(1.f - 1.e-6f, std::max(1.e-4f, beta)); /// sometimes beta > 1 or < 0, to be checked
+        mass2OverZ2 = correctedTpcInnerParam * correctedTpcInnerParam * (1.f / (clampedBeta * clampedBeta) - 1.f);
+      }
+      nucleiPid(nSigma[0], nSigma[1], nSigma[2], nSigma[3], nSigma[4], beta, mass2OverZ2);
+    }
+  }
+};
+
+WorkflowSpec defineDataProcessing(ConfigContext const& cfgc)
+{
+  return WorkflowSpec{
+    adaptAnalysisTask<nucleiPidTable>(cfgc, TaskName{"nuclei-pid-table"})};
+}
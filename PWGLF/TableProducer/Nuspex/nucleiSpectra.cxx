@@ -20,7 +20,9 @@
 // (to add flow: o2-analysis-qvector-table, o2-analysis-centrality-table)
 
 #include "PWGLF/DataModel/EPCalibrationTables.h"
+#include "PWGLF/DataModel/LFNucleiPidTables.h"
 #include "PWGLF/DataModel/LFSlimNucleiTables.h"
+#include "PWGLF/Utils/mcBookkeeping.h"
 
 #include "Common/Core/EventPlaneHelper.h"
 #include "Common/Core/PID/PIDTOF.h"
@@ -348,6 +350,7 @@ struct nucleiSpectra {
   float mBz = 0.f;
 
   using TrackCandidates = soa::Join<aod::TracksIU, aod::TracksCovIU, aod::TracksExtra, aod::TOFSignal, aod::TOFEvTime>;
+  using TrackCandidatesWithPid = soa::Join<TrackCandidates, aod::NucleiPidTables>;
 
   // Collisions with chentrality
   using CollWithCent = soa::Join<aod::Collisions, aod::EvSels, aod::CentFV0As, aod::CentFT0Ms, aod::CentFT0As, aod::CentFT0Cs, aod::CentNTPVs>::iterator;
@@ -469,6 +472,7 @@ struct nucleiSpectra {
   void init(o2::framework::InitContext&)
   {
     zorroSummary.setObject(zorro.getZorroSummary());
+    mcBookkeeping.setSelection(std::vector<int>(nuclei::codes, nuclei::codes + nuclei::species));
     zorro.setBaseCCDBPath(cfgZorroCCDBpath.value);
     ccdb->setURL(cfgCCDBurl);
     ccdb->setCaching(true);
@@ -653,9 +657,13 @@ struct nucleiSpectra {
       bool selectedTPC[5]{false}, goodToAnalyse{false};
       std::array<float, 5> nSigmaTPC;
       for (int iS{0}; iS < nuclei::species; ++iS) {
-        double expBethe{common::BetheBlochAleph(static_cast<double>(correctedTpcInnerParam * bgScalings[iS][iC]), cfgBetheBlochParams->get(iS, 0u), cfgBetheBlochParams->get(iS, 1u), cfgBetheBlochParams->get(iS, 2u), cfgBetheBlochParams->get(iS, 3u), cfgBetheBlochParams->get(iS, 4u))};
-        double expSigma{expBethe * cfgBetheBlochParams->get(iS, 5u)};
-        nSigma[0][iS] = static_cast<float>((track.tpcSignal() - expBethe) / expSigma);
+        if constexpr (requires { track.nucleiNSigmaTPCPr(); }) { /// computed once per track by nuclei-pid-table
+          nSigma[0][iS] = track.nucleiNSigmaTPC(iS);
+        } else {
+          double expBethe{common::BetheBlochAleph(static_cast<double>(correctedTpcInnerParam * bgScalings[iS][iC]), cfgBetheBlochParams->get(iS, 0u), cfgBetheBlochParams->get(iS, 1u), cfgBetheBlochParams->get(iS, 2u), cfgBetheBlochParams->get(iS, 3u), cfgBetheBlochParams->get(iS, 4u))};
+          double expSigma{expBethe * cfgBetheBlochParams->get(iS, 5u)};
+          nSigma[0][iS] = static_cast<float>((track.tpcSignal() - expBethe) / expSigma);
+        }
         nSigmaTPC[iS] = nSigma[0][iS];
         selectedTPC[iS] = (nSigma[0][iS] > nuclei::pidCuts[0][iS][0] && nSigma[0][iS] < nuclei::pidCuts[0][iS][1]);
         goodToAnalyse = goodToAnalyse || selectedTPC[iS];
@@ -673,7 +681,12 @@ struct nucleiSpectra {
       std::array<float, 2> dcaInfo;
       o2::base::Propagator::Instance()->propagateToDCA(collVtx, mTrackParCov, mBz, 2.f, static_cast<o2::base::Propagator::MatCorrType>(cfgMaterialCorrection.value), &dcaInfo);
 
-      float beta{o2::pid::tof::Beta::GetBeta(track)};
+      float beta{o2::pid::tof::defaultReturnValue};
+      if constexpr (requires { track.nucleiBeta(); }) {
+        beta = track.nucleiBeta();
+      } else {
+        beta = o2::pid::tof::Beta::GetBeta(track);
+      }
       spectra.fill(HIST("hTpcSignalDataSelected"), correctedTpcInnerParam * track.sign(), track.tpcSignal());
       spectra.fill(HIST("hTofSignalData"), correctedTpcInnerParam, beta);
       beta = std::min(1.f - 1.e-6f, std::max(1.e-4f, beta)); /// sometimes beta > 1 or < 0, to be checked
@@ -819,7 +832,8 @@ struct nucleiSpectra {
     nuclei::hGloTOFtracks[1]->Fill(nGloTracks[1], nTOFTracks[1]);
   }
 
-  void processData(soa::Join<aod::Collisions, aod::EvSels>::iterator const& collision, TrackCandidates const& tracks, aod::BCsWithTimestamps const&)
+  template <typename Tcoll, typename Ttrks>
+  void runDataAnalysis(Tcoll const& collision, Ttrks const& tracks)
   {
     nuclei::candidates.clear();
     if (!eventSelectionWithHisto(collision)) {
@@ -850,8 +864,19 @@ struct nucleiSpectra {
       }
     }
   }
+
+  void processData(soa::Join<aod::Collisions, aod::EvSels>::iterator const& collision, TrackCandidates const& tracks, aod::BCsWithTimestamps const&)
+  {
+    runDataAnalysis(collision, tracks);
+  }
   PROCESS_SWITCH(nucleiSpectra, processData, "Data analysis", true);
 
+  void processDataWithPidTable(soa::Join<aod::Collisions, aod::EvSels>::iterator const& collision, TrackCandidatesWithPid const& tracks, aod::BCsWithTimestamps const&)
+  {
+    runDataAnalysis(collision, tracks);
+  }
+  PROCESS_SWITCH(nucleiSpectra, processDataWithPidTable, "Data analysis using the TPC nSigma and TOF beta of nuclei-pid-table", false);
+
   void processDataFlow(CollWithEP const& collision, TrackCandidates const& tracks, aod::BCsWithTimestamps const&)
   {
     nuclei::candidates.clear();
@@ -911,6 +936,7 @@ struct nucleiSpectra {
   PROCESS_SWITCH(nucleiSpectra, processDataFlowAlternative, "Data analysis with flow - alternative framework", false);
 
   Preslice<TrackCandidates> tracksPerCollisions = aod::track::collisionId;
+  o2::pwglf::McParticleBookkeeping mcBookkeeping; // nuclei of the MC stack and their reconstruction status, filled once per data frame
   void processMC(soa::Join<aod::Collisions, aod::EvSels, aod::McCollisionLabels> const& collisions, aod::McCollisions const& mcCollisions, soa::Join<TrackCandidates, aod::McTrackLabels> const& tracks, aod::McParticles const& particlesMC, aod::BCsWithTimestamps const&)
   {
     nuclei::candidates.clear();
@@ -926,7 +952,7 @@ struct nucleiSpectra {
       const auto& slicedTracks = tracks.sliceBy(tracksPerCollisions, collision.globalIndex());
       fillDataInfo(collision, slicedTracks);
     }
-    std::vector<bool> isReconstructed(particlesMC.size(), false);
+    mcBookkeeping.fill(particlesMC);
     for (auto& c : nuclei::candidates) {
       auto label = tracks.iteratorAt(c.globalIndex);
       if (label.mcParticleId() < -1 || label.mcParticleId() >= particlesMC.size()) {
@@ -962,7 +988,6 @@ struct nucleiSpectra {
 
       int motherPdgCode = 0;
       float motherDecRadius = -1;
-      isReconstructed[particle.globalIndex()] = true;
       if (particle.isPhysicalPrimary()) {
         c.flags |= kIsPhysicalPrimary;
         if (particle.has_mothers()) {
@@ -985,65 +1010,59 @@ struct nucleiSpectra {
         c.flags |= kIsSecondaryFromMaterial;
       }
 
-      isReconstructed[particle.globalIndex()] = true;
+      mcBookkeeping.markReconstructed(particle.globalIndex());
       float absoDecL = computeAbsoDecL(particle);
       nucleiTableMC(c.pt, c.eta, c.phi, c.tpcInnerParam, c.beta, c.zVertex, c.nContrib, c.DCAxy, c.DCAz, c.TPCsignal, c.ITSchi2, c.TPCchi2, c.TOFchi2, c.flags, c.TPCfindableCls, c.TPCcrossedRows, c.ITSclsMap, c.TPCnCls, c.TPCnClsShared, c.clusterSizesITS, goodCollisions[particle.mcCollisionId()], particle.pt(), particle.eta(), particle.phi(), particle.pdgCode(), motherPdgCode, motherDecRadius, absoDecL);
     }
 
-    int index{0};
-    for (const auto& particle : particlesMC) {
-      int pdg{std::abs(particle.pdgCode())};
-      for (int iS{0}; iS < nuclei::species; ++iS) {
-        if (pdg != nuclei::codes[iS]) {
-          continue;
-        }
-        if (particle.y() < cfgTrackCut.RapidityMin || particle.y() > cfgTrackCut.RapidityMax) {
-          continue;
-        }
+    for (size_t iP{0}; iP < mcBookkeeping.size(); ++iP) {
+      const int64_t index{mcBookkeeping.indices()[iP]};
+      const int iS{mcBookkeeping.species()[iP]};
+      auto particle = particlesMC.rawIteratorAt(index);
+      if (particle.y() < cfgTrackCut.RapidityMin || particle.y() > cfgTrackCut.RapidityMax) {
+        continue;
+      }
 
-        uint16_t flags = 0;
-        int motherPdgCode = 0;
-        float motherDecRadius = -1;
-        if (particle.isPhysicalPrimary()) {
-          flags |= kIsPhysicalPrimary;
-          nuclei::hGenNuclei[iS][particle.pdgCode() < 0]->Fill(1., particle.pt());
-          // antinuclei from B hadrons are classified as physical primaries
-          if (particle.has_mothers()) {
-            for (auto& motherparticle : particle.mothers_as<aod::McParticles>()) {
-              if (std::find(nuclei::hfMothCodes.begin(), nuclei::hfMothCodes.end(), std::abs(motherparticle.pdgCode())) != nuclei::hfMothCodes.end()) {
-                flags |= kIsSecondaryFromWeakDecay;
-                motherPdgCode = motherparticle.pdgCode();
-                motherDecRadius = std::hypot(particle.vx() - motherparticle.vx(), particle.vy() - motherparticle.vy());
-                break;
-              }
+      uint16_t flags = 0;
+      int motherPdgCode = 0;
+      float motherDecRadius = -1;
+      if (particle.isPhysicalPrimary()) {
+        flags |= kIsPhysicalPrimary;
+        nuclei::hGenNuclei[iS][particle.pdgCode() < 0]->Fill(1., particle.pt());
+        // antinuclei from B hadrons are classified as physical primaries
+        if (particle.has_mothers()) {
+          for (auto& motherparticle : particle.mothers_as<aod::McParticles>()) {
+            if (std::find(nuclei::hfMothCodes.begin(), nuclei::hfMothCodes.end(), std::abs(motherparticle.pdgCode())) != nuclei::hfMothCodes.end()) {
+              flags |= kIsSecondaryFromWeakDecay;
+              motherPdgCode = motherparticle.pdgCode();
+              motherDecRadius = std::hypot(particle.vx() - motherparticle.vx(), particle.vy() - motherparticle.vy());
+              break;
             }
           }
-        } else if (particle.getProcess() == TMCProcess::kPDecay) {
-          if (!particle.has_mothers()) {
-            continue; // skip secondaries from weak decay without mothers
-          }
-          flags |= kIsSecondaryFromWeakDecay;
-          for (const auto& motherparticle : particle.mothers_as<aod::McParticles>()) {
-            motherPdgCode = motherparticle.pdgCode();
-            motherDecRadius = std::hypot(particle.vx() - motherparticle.vx(), particle.vy() - motherparticle.vy());
-          }
-        } else {
-          flags |= kIsSecondaryFromMaterial;
         }
+      } else if (particle.getProcess() == TMCProcess::kPDecay) {
+        if (!particle.has_mothers()) {
+          continue; // skip secondaries from weak decay without mothers
+        }
+        flags |= kIsSecondaryFromWeakDecay;
+        for (const auto& motherparticle : particle.mothers_as<aod::McParticles>()) {
+          motherPdgCode = motherparticle.pdgCode();
+          motherDecRadius = std::hypot(particle.vx() - motherparticle.vx(), particle.vy() - motherparticle.vy());
+        }
+      } else {
+        flags |= kIsSecondaryFromMaterial;
+      }
 
-        if (!isReconstructed[index] && (cfgTreeConfig->get(iS, 0u) || cfgTreeConfig->get(iS, 1u))) {
-          if ((flags & kIsPhysicalPrimary) == 0 && cfgFillGenSecondaries == 0) {
-            continue; // skip secondaries if not requested
-          }
-          if ((flags & (kIsPhysicalPrimary | kIsSecondaryFromWeakDecay)) == 0 && cfgFillGenSecondaries == 1) {
-            continue; // skip secondaries from material if not requested
-          }
-          float absDecL = computeAbsoDecL(particle);
-          nucleiTableMC(999., 999., 999., 0., 0., 999., -1, 999., 999., -1, -1, -1, -1, flags, 0, 0, 0, 0, 0, 0, goodCollisions[particle.mcCollisionId()], particle.pt(), particle.eta(), particle.phi(), particle.pdgCode(), motherPdgCode, motherDecRadius, absDecL);
+      if (!mcBookkeeping.isReconstructed(index) && (cfgTreeConfig->get(iS, 0u) || cfgTreeConfig->get(iS, 1u))) {
+        if ((flags & kIsPhysicalPrimary) == 0 && cfgFillGenSecondaries == 0) {
+          continue; // skip secondaries if not requested
         }
-        break;
+        if ((flags & (kIsPhysicalPrimary | kIsSecondaryFromWeakDecay)) == 0 && cfgFillGenSecondaries == 1) {
+          continue; // skip secondaries from material if not requested
+        }
+        float absDecL = computeAbsoDecL(particle);
+        nucleiTableMC(999., 999., 999., 0., 0., 999., -1, 999., 999., -1, -1, -1, -1, flags, 0, 0, 0, 0, 0, 0, goodCollisions[particle.mcCollisionId()], particle.pt(), particle.eta(), particle.phi(), particle.pdgCode(), motherPdgCode, motherDecRadius, absDecL);
       }
-      index++;
     }
   }
   PROCESS_SWITCH(nucleiSpectra, processMC, "MC analysis", false);
@@ -1088,7 +1107,6 @@ struct nucleiSpectra {
       const auto& slicedTracks = tracks.sliceBy(tracksPerCollisions, collision.globalIndex());
       fillDataInfo(collision, slicedTracks);
     }
-    std::vector<bool> isReconstructed(particlesMC.size(), false);
     for (size_t i{0}; i < nuclei::candidates.size(); ++i) {
       auto& c = nuclei::candidates[i];
       if (c.fillTree) {
@@ -1099,7 +1117,6 @@ struct nucleiSpectra {
         auto particle = particlesMC.iteratorAt(label.mcParticleId());
         int motherPdgCode = 0;
         float motherDecRadius = -1;
-        isReconstructed[particle.globalIndex()] = true;
         if (particle.isPhysicalPrimary()) {
           c.flags |= kIsPhysicalPrimary;
           if (particle.has_mothers()) {
@@ -1122,7 +1139,6 @@ struct nucleiSpectra {
           c.flags |= kIsSecondaryFromMaterial;
         }
 
-        isReconstructed[particle.globalIndex()] = true;
         float absoDecL = computeAbsoDecL(particle);
 
         nucleiTableMC(c.pt, c.eta, c.phi, c.tpcInnerParam, c.beta, c.zVertex, c.nContrib, c.DCAxy, c.DCAz, c.TPCsignal, c.ITSchi2, c.TPCchi2, c.TOFchi2, c.flags, c.TPCfindableCls, c.TPCcrossedRows, c.ITSclsMap, c.TPCnCls, c.TPCnClsShared, c.clusterSizesITS, goodCollisions[particle.mcCollisionId()], particle.pt(), particle.eta(), particle.phi(), particle.pdgCode(), motherPdgCode, motherDecRadius, absoDecL);
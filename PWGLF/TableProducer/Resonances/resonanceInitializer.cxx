@@ -42,7 +42,11 @@
 #include "Framework/runDataProcessing.h"
 #include "ReconstructionDataFormats/Track.h"
 
+#include <algorithm>
+#include <cmath>
+#include <iterator>
 #include <string>
+#include <utility>
 #include <vector>
 
 using namespace o2;
@@ -79,6 +83,7 @@ struct ResonanceInitializer {
   Produces<aod::ResoMCParents> reso2mcparents;
   Produces<aod::ResoMCV0s> reso2mcv0s;
   Produces<aod::ResoMCCascades> reso2mccascades;
+  Produces<aod::ResoCandidateBlocks> resoCandidateBlocks;
 
   // CCDB options
   Configurable<std::string> ccdbURL{"ccdbURL", "http://alice-ccdb.cern.ch", "url of the ccdb repository"};
@@ -92,6 +97,8 @@ struct ResonanceInitializer {
   Configurable<bool> cfgBypassTrackFill{"cfgBypassTrackFill", false, "Bypass track fill"};
   Configurable<bool> cfgBypassCollIndexFill{"cfgBypassCollIndexFill", false, "Bypass collision index fill"};
   Configurable<bool> cfgBypassTrackIndexFill{"cfgBypassTrackIndexFill", false, "Bypass track index fill"};
+  Configurable<bool> cfgSortTracksByPidClass{"cfgSortTracksByPidClass", false, "Store the tracks of each event sorted in pion, kaon, proton and other blocks (see ResoCandidateBlocks)"};
+  Configurable<float> cfgPidClassMaxNSigmaTPC{"cfgPidClassMaxNSigmaTPC", 3.f, "Max. |TPC nSigma| for the PID class of the tracks, the smallest one wins"};
 
   // Configurables
   Configurable<double> dBzInput{"dBzInput", -999, "bz field, -999 is automatic"};
@@ -709,49 +716,111 @@ struct ResonanceInitializer {
       }
     }
   }
+  // Index of the first row of each reduced table for the event being filled, see ResoCandidateBlocks
+  int blockFirst[4] = {0, 0, 0, 0}; // tracks, micro tracks, V0s, cascades
+  int nTracksPerClass[aod::resoblock::kNPidClasses] = {0, 0, 0, 0};
+  std::vector<std::pair<int, int>> classAndTrack; // PID class and position in the sliced table of the selected tracks
+
+  void beginCandidateBlocks()
+  {
+    blockFirst[0] = reso2trks.lastIndex() + 1;
+    blockFirst[1] = reso2microtrks.lastIndex() + 1;
+    blockFirst[2] = reso2v0s.lastIndex() + 1;
+    blockFirst[3] = reso2cascades.lastIndex() + 1;
+    std::fill(std::begin(nTracksPerClass), std::end(nTracksPerClass), 0);
+  }
+
+  void fillCandidateBlocks()
+  {
+    if (!cfgSortTracksByPidClass) {
+      nTracksPerClass[aod::resoblock::kOther] = reso2trks.lastIndex() + 1 - blockFirst[0];
+    }
+    resoCandidateBlocks(blockFirst[0], nTracksPerClass[aod::resoblock::kPion], nTracksPerClass[aod::resoblock::kKaon], nTracksPerClass[aod::resoblock::kProton], nTracksPerClass[aod::resoblock::kOther],
+                        blockFirst[1], reso2microtrks.lastIndex() + 1 - blockFirst[1],
+                        blockFirst[2], reso2v0s.lastIndex() + 1 - blockFirst[2],
+                        blockFirst[3], reso2cascades.lastIndex() + 1 - blockFirst[3]);
+  }
+
+  template <typename TrackType>
+  int getPidClass(TrackType const& track)
+  {
+    const float nSigmas[3] = {std::abs(track.tpcNSigmaPi()), std::abs(track.tpcNSigmaKa()), std::abs(track.tpcNSigmaPr())};
+    int pidClass = aod::resoblock::kOther;
+    float minNSigma = cfgPidClassMaxNSigmaTPC;
+    for (int i = 0; i < 3; i++) {
+      if (nSigmas[i] < minNSigma) {
+        minNSigma = nSigmas[i];
+        pidClass = i;
+      }
+    }
+    return pidClass;
+  }
+
+  template <bool isMC, typename TrackType>
+  void fillTrack(TrackType const& track)
+  {
+    uint8_t trackFlags = (track.passedITSRefit() << 0) |
+                         (track.passedTPCRefit() << 1) |
+                         (track.isGlobalTrackWoDCA() << 2) |
+                         (track.isGlobalTrack() << 3) |
+                         (track.isPrimaryTrack() << 4) |
+                         (track.isPVContributor() << 5) |
+                         (track.hasTOF() << 6) |
+                         ((track.sign() > 0) << 7); // sign +1: 1, -1: 0
+    reso2trks(resoCollisions.lastIndex(),
+              track.pt(),
+              track.px(),
+              track.py(),
+              track.pz(),
+              static_cast<uint8_t>(track.tpcNClsCrossedRows()),
+              static_cast<uint8_t>(track.tpcNClsFound()),
+              static_cast<int16_t>(std::round(track.dcaXY() * 10000)),
+              static_cast<int16_t>(std::round(track.dcaZ() * 10000)),
+              static_cast<int8_t>(std::round(track.tpcNSigmaPi() * 10)),
+              static_cast<int8_t>(std::round(track.tpcNSigmaKa() * 10)),
+              static_cast<int8_t>(std::round(track.tpcNSigmaPr() * 10)),
+              static_cast<int8_t>(std::round(track.tofNSigmaPi() * 10)),
+              static_cast<int8_t>(std::round(track.tofNSigmaKa() * 10)),
+              static_cast<int8_t>(std::round(track.tofNSigmaPr() * 10)),
+              static_cast<int8_t>(std::round(track.tpcSignal() * 10)),
+              trackFlags);
+    if (!cfgBypassTrackIndexFill) {
+      resoTrackTracks(track.globalIndex());
+    }
+    if constexpr (isMC) {
+      fillMCTrack(track);
+    }
+  }
+
   // Filter for all tracks
   template <bool isMC, typename TrackType, typename CollisionType>
   void fillTracks(CollisionType const& collision, TrackType const& tracks)
   {
     if (cfgBypassTrackFill)
       return;
+    if (cfgSortTracksByPidClass) {
+      classAndTrack.clear();
+      int position = 0;
+      for (auto const& track : tracks) {
+        if (isTrackSelected<isMC>(collision, track) && filterTrack(track)) {
+          classAndTrack.emplace_back(getPidClass(track), position);
+        }
+        position++;
+      }
+      std::stable_sort(classAndTrack.begin(), classAndTrack.end(), [](auto const& a, auto const& b) { return a.first < b.first; });
+      for (auto const& [pidClass, trackPosition] : classAndTrack) {
+        fillTrack<isMC>(tracks.iteratorAt(trackPosition));
+        nTracksPerClass[pidClass]++;
+      }
+      return;
+    }
     // Loop over tracks
     for (auto const& track : tracks) {
       if (!isTrackSelected<isMC>(collision, track))
         continue;
       if (!filterTrack(track))
         continue;
-      uint8_t trackFlags = (track.passedITSRefit() << 0) |
-                           (track.passedTPCRefit() << 1) |
-                           (track.isGlobalTrackWoDCA() << 2) |
-                           (track.isGlobalTrack() << 3) |
-                           (track.isPrimaryTrack() << 4) |
-                           (track.isPVContributor() << 5) |
-                           (track.hasTOF() << 6) |
-                           ((track.sign() > 0) << 7); // sign +1: 1, -1: 0
-      reso2trks(resoCollisions.lastIndex(),
-                track.pt(),
-                track.px(),
-                track.py(),
-                track.pz(),
-                static_cast<uint8_t>(track.tpcNClsCrossedRows()),
-                static_cast<uint8_t>(track.tpcNClsFound()),
-                static_cast<int16_t>(std::round(track.dcaXY() * 10000)),
-                static_cast<int16_t>(std::round(track.dcaZ() * 10000)),
-                static_cast<int8_t>(std::round(track.tpcNSigmaPi() * 10)),
-                static_cast<int8_t>(std::round(track.tpcNSigmaKa() * 10)),
-                static_cast<int8_t>(std::round(track.tpcNSigmaPr() * 10)),
-                static_cast<int8_t>(std::round(track.tofNSigmaPi() * 10)),
-                static_cast<int8_t>(std::round(track.tofNSigmaKa() * 10)),
-                static_cast<int8_t>(std::round(track.tofNSigmaPr() * 10)),
-                static_cast<int8_t>(std::round(track.tpcSignal() * 10)),
-                trackFlags);
-      if (!cfgBypassTrackIndexFill) {
-        resoTrackTracks(track.globalIndex());
-      }
-      if constexpr (isMC) {
-        fillMCTrack(track);
-      }
+      fillTrack<isMC>(track);
     }
   }
 
@@ -1432,11 +1501,13 @@ struct ResonanceInitializer {
     }
     resoSpheroCollisions(computeSpherocity(tracks, trackSphMin, trackSphDef));
     resoEvtPlCollisions(0, 0, 0, 0);
+    beginCandidateBlocks();
 
     fillTracks<false>(collision, tracks);
     if (cfgFillMicroTracks) {
       fillMicroTracks<false>(collision, tracks);
     }
+    fillCandidateBlocks();
   }
   PROCESS_SWITCH(ResonanceInitializer, processTrackData, "Process for data", false);
 
@@ -1458,11 +1529,13 @@ struct ResonanceInitializer {
     }
     resoSpheroCollisions(computeSpherocity(tracks, trackSphMin, trackSphDef));
     resoEvtPlCollisions(0, 0, 0, 0);
+    beginCandidateBlocks();
 
     fillTracks<false>(collision, tracks);
     if (cfgFillMicroTracks) {
       fillMicroTracks<false>(collision, tracks);
     }
+    fillCandidateBlocks();
   }
   PROCESS_SWITCH(ResonanceInitializer, processTrackDataRun2, "Process for data", false);
 
@@ -1485,10 +1558,12 @@ struct ResonanceInitializer {
     }
     resoSpheroCollisions(computeSpherocity(tracks, trackSphMin, trackSphDef));
     resoEvtPlCollisions(getEvtPl(collision), getEvtPlRes(collision, evtPlDetId, evtPlRefAId), getEvtPlRes(collision, evtPlDetId, evtPlRefBId), getEvtPlRes(collision, evtPlRefAId, evtPlRefBId));
+    beginCandidateBlocks();
     fillTracks<false>(collision, tracks);
     if (cfgFillMicroTracks) {
       fillMicroTracks<false>(collision, tracks);
     }
+    fillCandidateBlocks();
   }
   PROCESS_SWITCH(ResonanceInitializer, processTrackEPData, "Process for data and ep ana", false);
 
@@ -1512,12 +1587,14 @@ struct ResonanceInitializer {
     }
     resoSpheroCollisions(computeSpherocity(tracks, trackSphMin, trackSphDef));
     resoEvtPlCollisions(0, 0, 0, 0);
+    beginCandidateBlocks();
 
     fillTracks<false>(collision, tracks);
     if (cfgFillMicroTracks) {
       fillMicroTracks<false>(collision, tracks);
     }
     fillV0s<false>(collision, V0s, tracks);
+    fillCandidateBlocks();
   }
   PROCESS_SWITCH(ResonanceInitializer, processTrackV0Data, "Process for data", false);
 
@@ -1538,12 +1615,14 @@ struct ResonanceInitializer {
     }
     resoSpheroCollisions(computeSpherocity(tracks, trackSphMin, trackSphDef));
     resoEvtPlCollisions(0, 0, 0, 0);
+    beginCandidateBlocks();
 
     fillTracks<false>(collision, tracks);
     if (cfgFillMicroTracks) {
       fillMicroTracks<false>(collision, tracks);
     }
     fillV0s<false>(collision, V0s, tracks);
+    fillCandidateBlocks();
   }
   PROCESS_SWITCH(ResonanceInitializer, processTrackV0DataRun2, "Process for data", false);
 
@@ -1571,12 +1650,14 @@ struct ResonanceInitializer {
     }
     resoSpheroCollisions(computeSpherocity(tracks, trackSphMin, trackSphDef));
     resoEvtPlCollisions(0, 0, 0, 0);
+    beginCandidateBlocks();
     fillTracks<false>(collision, tracks);
     if (cfgFillMicroTracks) {
       fillMicroTracks<false>(collision, tracks);
     }
     fillV0s<false>(collision, V0s, tracks);
     fillCascades<false>(collision, Cascades, tracks);
+    fillCandidateBlocks();
   }
   PROCESS_SWITCH(ResonanceInitializer, processTrackV0CascData, "Process for data", false);
 
@@ -1598,6 +1679,7 @@ struct ResonanceInitializer {
     }
     resoSpheroCollisions(computeSpherocity(tracks, trackSphMin, trackSphDef));
     resoEvtPlCollisions(0, 0, 0, 0);
+    beginCandidateBlocks();
 
     fillTracks<false>(collision, tracks);
     if (cfgFillMicroTracks) {
@@ -1605,6 +1687,7 @@ struct ResonanceInitializer {
     }
     fillV0s<false>(collision, V0s, tracks);
     fillCascades<false>(collision, Cascades, tracks);
+    fillCandidateBlocks();
   }
   PROCESS_SWITCH(ResonanceInitializer, processTrackV0CascDataRun2, "Process for data", false);
 
@@ -1625,6 +1708,7 @@ struct ResonanceInitializer {
     }
     resoSpheroCollisions(computeSpherocity(tracks, trackSphMin, trackSphDef));
     resoEvtPlCollisions(0, 0, 0, 0);
+    beginCandidateBlocks();
     auto mccollision = collision.mcCollision_as<aod::McCollisions>();
     float impactpar = mccollision.impactParameter();
     fillMCCollision<false>(collision, mcParticles, impactpar);
@@ -1638,6 +1722,7 @@ struct ResonanceInitializer {
     // Loop over all MC particles
     auto mcParts = selectedMCParticles->sliceBy(perMcCollision, collision.mcCollision().globalIndex());
     fillMCParticles(mcParts, mcParticles);
+    fillCandidateBlocks();
   }
   PROCESS_SWITCH(ResonanceInitializer, processTrackMC, "Process for MC", false);
 
@@ -1657,6 +1742,7 @@ struct ResonanceInitializer {
     }
     resoSpheroCollisions(computeSpherocity(tracks, trackSphMin, trackSphDef));
     resoEvtPlCollisions(getEvtPl(collision), getEvtPlRes(collision, evtPlDetId, evtPlRefAId), getEvtPlRes(collision, evtPlDetId, evtPlRefBId), getEvtPlRes(collision, evtPlRefAId, evtPlRefBId));
+    beginCandidateBlocks();
     fillMCCollision<false>(collision, mcParticles);
 
     // Loop over tracks
@@ -1667,6 +1753,7 @@ struct ResonanceInitializer {
     // Loop over all MC particles
     auto mcParts = selectedMCParticles->sliceBy(perMcCollision, collision.mcCollision().globalIndex());
     fillMCParticles(mcParts, mcParticles);
+    fillCandidateBlocks();
   }
   PROCESS_SWITCH(ResonanceInitializer, processTrackEPMC, "Process for MC and ep ana", false);
 
@@ -1684,6 +1771,7 @@ struct ResonanceInitializer {
     }
     resoSpheroCollisions(computeSpherocity(tracks, trackSphMin, trackSphDef));
     resoEvtPlCollisions(0, 0, 0, 0);
+    beginCandidateBlocks();
     fillMCCollision<true>(collision, mcParticles);
 
     // Loop over tracks
@@ -1694,6 +1782,7 @@ struct ResonanceInitializer {
     // Loop over all MC particles
     auto mcParts = selectedMCParticles->sliceBy(perMcCollisionRun2, collision.mcCollision().globalIndex());
     fillMCParticles(mcParts, mcParticles);
+    fillCandidateBlocks();
   }
   PROCESS_SWITCH(ResonanceInitializer, processTrackMCRun2, "Process for MC", false);
 
@@ -1714,6 +1803,7 @@ struct ResonanceInitializer {
     }
     resoSpheroCollisions(computeSpherocity(tracks, trackSphMin, trackSphDef));
     resoEvtPlCollisions(0, 0, 0, 0);
+    beginCandidateBlocks();
     fillMCCollision<false>(collision, mcParticles);
 
     // Loop over tracks
@@ -1726,6 +1816,7 @@ struct ResonanceInitializer {
     // Loop over all MC particles
     auto mcParts = selectedMCParticles->sliceBy(perMcCollision, collision.mcCollision().globalIndex());
     fillMCParticles(mcParts, mcParticles);
+    fillCandidateBlocks();
   }
   PROCESS_SWITCH(ResonanceInitializer, processTrackV0MC, "Process for MC", false);
 
@@ -1743,6 +1834,7 @@ struct ResonanceInitializer {
     }
     resoSpheroCollisions(computeSpherocity(tracks, trackSphMin, trackSphDef));
     resoEvtPlCollisions(0, 0, 0, 0);
+    beginCandidateBlocks();
     fillMCCollision<true>(collision, mcParticles);
 
     // Loop over tracks
@@ -1755,6 +1847,7 @@ struct ResonanceInitializer {
     // Loop over all MC particles
     auto mcParts = selectedMCParticles->sliceBy(perMcCollision, collision.mcCollision().globalIndex());
     fillMCParticles(mcParts, mcParticles);
+    fillCandidateBlocks();
   }
   PROCESS_SWITCH(ResonanceInitializer, processTrackV0MCRun2, "Process for MC", false);
 
@@ -1792,6 +1885,7 @@ struct ResonanceInitializer {
     }
     resoSpheroCollisions(computeSpherocity(tracks, trackSphMin, trackSphDef));
     resoEvtPlCollisions(0, 0, 0, 0);
+    beginCandidateBlocks();
 
     if (GenCuts.cfgGenMult05)
       mult = mcCollision.multMCNParticlesEta05();
@@ -1811,6 +1905,7 @@ struct ResonanceInitializer {
     // Loop over all MC particles
     auto mcParts = selectedMCParticles->sliceBy(perMcCollision, mcId);
     fillMCParticles(mcParts, mcParticles);
+    fillCandidateBlocks();
   }
   PROCESS_SWITCH(ResonanceInitializer, processTrackV0CascMC, "Process for MC", false);
 
@@ -1914,6 +2009,7 @@ struct ResonanceInitializer {
     }
     resoSpheroCollisions(computeSpherocity(tracks, trackSphMin, trackSphDef));
     resoEvtPlCollisions(0, 0, 0, 0);
+    beginCandidateBlocks();
     fillMCCollision<true>(collision, mcParticles);
 
     // Loop over tracks
@@ -1927,6 +2023,7 @@ struct ResonanceInitializer {
     // Loop over all MC particles
     auto mcParts = selectedMCParticles->sliceBy(perMcCollision, collision.mcCollision().globalIndex());
     fillMCParticles(mcParts, mcParticles);
+    fillCandidateBlocks();
   }
   PROCESS_SWITCH(ResonanceInitializer, processTrackV0CascMCRun2, "Process for MC", false);
 };
@@ -51,6 +51,8 @@
 #include "Framework/runDataProcessing.h"
 #include "ReconstructionDataFormats/Track.h"
 
+#include <array>
+#include <cmath>
 #include <vector>
 
 using namespace o2;
@@ -98,323 +100,186 @@ struct ResonanceMergeDF {
   Produces<aod::ResoCascadeDFs> reso2cascadesdf;
   int df = 0;
 
-  std::vector<std::tuple<float, float, float, float, float, float, int>> vecOfTuples;
-  std::vector<std::vector<std::tuple<float, float, float, float,
-                                     unsigned char, unsigned char,
-                                     int16_t, int16_t, int8_t, int8_t, int8_t,
-                                     int8_t, int8_t, int8_t, float,
-                                     uint8_t>>>
-    vecOfVecOfTuples;
-  std::vector<std::vector<std::tuple<float, float, float, float,
-                                     int*,
-                                     int8_t, int8_t, int8_t, // TPC Pos Trk
-                                     int8_t, int8_t, int8_t, // TPC Neg Trk
-                                     int8_t, int8_t, int8_t, // TPC Bach Trk
-                                     int8_t, int8_t, int8_t, // TOF Pos Trk
-                                     int8_t, int8_t, int8_t, // TOF Neg Trk
-                                     int8_t, int8_t, int8_t, // TOF Bach Trk
-                                     float, float, float, float,
-                                     float, float, float, float,
-                                     float, float, int, float,
-                                     float, float, float,
-                                     float, float, float>>>
-    vecOfVecOfTuplesCasc;
-  void processTrackDataDF(aod::ResoCollisions::iterator const& collision, aod::ResoTracks const& tracks)
+  // Buffered events of the merged frame, the tracks and cascades of event i are the rows [begin, end) of the column buffers
+  struct BufferedEvent {
+    float posX, posY, posZ, cent;
+    int trackBegin, trackEnd;
+    int cascBegin, cascEnd;
+  };
+  // Column storage of the buffered tracks, the stored (already packed) columns of ResoTracks are copied as they are
+  struct TrackColumns {
+    std::vector<std::array<float, 4>> ptPxPyPz;
+    std::vector<std::array<uint8_t, 2>> tpcNCls;  // crossed rows, found
+    std::vector<std::array<int16_t, 2>> dca10000; // xy, z
+    std::vector<std::array<int8_t, 7>> pid10;     // TPC pi/K/p, TOF pi/K/p, TPC signal
+    std::vector<uint8_t> trackFlags;
+
+    template <typename T>
+    void add(T const& track)
+    {
+      ptPxPyPz.push_back({track.pt(), track.px(), track.py(), track.pz()});
+      tpcNCls.push_back({track.tpcNClsCrossedRows(), track.tpcNClsFound()});
+      dca10000.push_back({track.dcaXY10000(), track.dcaZ10000()});
+      pid10.push_back({track.tpcNSigmaPi10(), track.tpcNSigmaKa10(), track.tpcNSigmaPr10(), track.tofNSigmaPi10(), track.tofNSigmaKa10(), track.tofNSigmaPr10(), track.tpcSignal10()});
+      trackFlags.push_back(track.trackFlags());
+    }
+    void clear()
+    {
+      ptPxPyPz.clear();
+      tpcNCls.clear();
+      dca10000.clear();
+      pid10.clear();
+      trackFlags.clear();
+    }
+    int size() const { return static_cast<int>(trackFlags.size()); }
+  };
+  // Column storage of the buffered cascades
+  struct CascadeColumns {
+    std::vector<std::array<float, 4>> ptPxPyPz;
+    std::vector<std::array<int, 3>> cascadeIndices; // copied, the input table is gone when the merged frame is written
+    std::vector<std::array<int8_t, 18>> pid10;      // TPC then TOF, pos/neg/bach, pi/K/p
+    std::vector<std::array<float, 10>> topology;    // v0CosPA, cascCosPA, daughDCA, cascDaughDCA, dcapostopv, dcanegtopv, dcabachtopv, dcav0topv, dcaXYCascToPV, dcaZCascToPV
+    std::vector<int> sign;
+    std::vector<std::array<float, 7>> massAndVertex; // mLambda, mXi, transRadius, cascTransRadius, decayVtxX, decayVtxY, decayVtxZ
+
+    template <typename T>
+    void add(T const& casc)
+    {
+      ptPxPyPz.push_back({casc.pt(), casc.px(), casc.py(), casc.pz()});
+      cascadeIndices.push_back({casc.cascadeIndices()[0], casc.cascadeIndices()[1], casc.cascadeIndices()[2]});
+      pid10.push_back({casc.daughterTPCNSigmaPosPi10(), casc.daughterTPCNSigmaPosKa10(), casc.daughterTPCNSigmaPosPr10(),
+                       casc.daughterTPCNSigmaNegPi10(), casc.daughterTPCNSigmaNegKa10(), casc.daughterTPCNSigmaNegPr10(),
+                       casc.daughterTPCNSigmaBachPi10(), casc.daughterTPCNSigmaBachKa10(), casc.daughterTPCNSigmaBachPr10(),
+                       casc.daughterTOFNSigmaPosPi10(), casc.daughterTOFNSigmaPosKa10(), casc.daughterTOFNSigmaPosPr10(),
+                       casc.daughterTOFNSigmaNegPi10(), casc.daughterTOFNSigmaNegKa10(), casc.daughterTOFNSigmaNegPr10(),
+                       casc.daughterTOFNSigmaBachPi10(), casc.daughterTOFNSigmaBachKa10(), casc.daughterTOFNSigmaBachPr10()});
+      topology.push_back({casc.v0CosPA(), casc.cascCosPA(), casc.daughDCA(), casc.cascDaughDCA(), casc.dcapostopv(), casc.dcanegtopv(), casc.dcabachtopv(), casc.dcav0topv(), casc.dcaXYCascToPV(), casc.dcaZCascToPV()});
+      sign.push_back(casc.sign());
+      massAndVertex.push_back({casc.mLambda(), casc.mXi(), casc.transRadius(), casc.cascTransRadius(), casc.decayVtxX(), casc.decayVtxY(), casc.decayVtxZ()});
+    }
+    void clear()
+    {
+      ptPxPyPz.clear();
+      cascadeIndices.clear();
+      pid10.clear();
+      topology.clear();
+      sign.clear();
+      massAndVertex.clear();
+    }
+    int size() const { return static_cast<int>(sign.size()); }
+  };
+  std::vector<BufferedEvent> bufferedEvents;
+  TrackColumns bufferedTracks;
+  CascadeColumns bufferedCascades;
+
+  template <typename T>
+  bool isTrackSelectedDF(T const& track)
   {
+    if (!cpidCut) {
+      return true;
+    }
+    if (!track.hasTOF()) {
+      if (std::abs(track.tpcNSigmaPr()) > nsigmaPr && std::abs(track.tpcNSigmaKa()) > nsigmaKa)
+        return false;
+      if (crejtpc && (std::abs(track.tpcNSigmaPr()) > std::abs(track.tpcNSigmaPi()) && std::abs(track.tpcNSigmaKa()) > std::abs(track.tpcNSigmaPi())))
+        return false;
+    } else {
+      if (std::abs(track.tofNSigmaPr()) > nsigmatofPr && std::abs(track.tofNSigmaKa()) > nsigmatofKa)
+        return false;
+      if (crejtof && (std::abs(track.tofNSigmaPr()) > std::abs(track.tofNSigmaPi()) && std::abs(track.tofNSigmaKa()) > std::abs(track.tofNSigmaPi())))
+        return false;
+    }
+    if (std::abs(track.dcaXY()) > cDCAXY)
+      return false;
+    if (std::abs(track.dcaZ()) > cDCAZ)
+      return false;
+    return true;
+  }
 
-    int nCollisions = nDF;
-    vecOfTuples.push_back(std::make_tuple(collision.posX(), collision.posY(), collision.posZ(), collision.cent(), 0, 0, 0));
-    std::vector<std::tuple<float, float, float, float,
-                           unsigned char, unsigned char,
-                           int16_t, int16_t, int8_t, int8_t, int8_t,
-                           int8_t, int8_t, int8_t, float,
-                           uint8_t>>
-      innerVector;
+  // Adds one event to the buffer and writes the merged frame as soon as nDF events are buffered
+  template <bool withCascades, typename TCollision, typename TTracks, typename TCascades>
+  void bufferEvent(TCollision const& collision, TTracks const& tracks, TCascades const& cascades)
+  {
+    if (bufferedEvents.capacity() < static_cast<size_t>(nDF.value)) {
+      bufferedEvents.reserve(nDF.value);
+    }
+    BufferedEvent event{collision.posX(), collision.posY(), collision.posZ(), collision.cent(), bufferedTracks.size(), 0, bufferedCascades.size(), 0};
     for (const auto& track : tracks) {
-      if (cpidCut) {
-        if (!track.hasTOF()) {
-          if (std::abs(track.tpcNSigmaPr()) > nsigmaPr && std::abs(track.tpcNSigmaKa()) > nsigmaKa)
-            continue;
-
-          if (crejtpc && (std::abs(track.tpcNSigmaPr()) > std::abs(track.tpcNSigmaPi()) && std::abs(track.tpcNSigmaKa()) > std::abs(track.tpcNSigmaPi())))
-            continue;
-
-        } else {
-          if (std::abs(track.tofNSigmaPr()) > nsigmatofPr && std::abs(track.tofNSigmaKa()) > nsigmatofKa)
-            continue;
-
-          if (crejtof && (std::abs(track.tofNSigmaPr()) > std::abs(track.tofNSigmaPi()) && std::abs(track.tofNSigmaKa()) > std::abs(track.tofNSigmaPi())))
-            continue;
-        }
-
-        if (std::abs(track.dcaXY()) > cDCAXY)
-          continue;
-        if (std::abs(track.dcaZ()) > cDCAZ)
-          continue;
+      if (isTrackSelectedDF(track)) {
+        bufferedTracks.add(track);
       }
-
-      innerVector.push_back(std::make_tuple(
-        //  track.trackId(),
-        track.pt(),
-        track.px(),
-        track.py(),
-        track.pz(),
-        (uint8_t)track.tpcNClsCrossedRows(),
-        (uint8_t)track.tpcNClsFound(),
-        static_cast<int16_t>(track.dcaXY() * 10000),
-        static_cast<int16_t>(track.dcaZ() * 10000),
-        (int8_t)(track.tpcNSigmaPi() * 10),
-        (int8_t)(track.tpcNSigmaKa() * 10),
-        (int8_t)(track.tpcNSigmaPr() * 10),
-        (int8_t)(track.tofNSigmaPi() * 10),
-        (int8_t)(track.tofNSigmaKa() * 10),
-        (int8_t)(track.tofNSigmaPr() * 10),
-        (int8_t)(track.tpcSignal() * 10),
-        track.trackFlags()));
     }
+    if constexpr (withCascades) {
+      for (const auto& casc : cascades) {
+        bufferedCascades.add(casc);
+      }
+    }
+    event.trackEnd = bufferedTracks.size();
+    event.cascEnd = bufferedCascades.size();
+    bufferedEvents.push_back(event);
 
-    vecOfVecOfTuples.push_back(innerVector);
-    innerVector.clear();
     df++;
     if (isLoggingEnabled)
       LOGF(info, "collisions: df = %i", df);
-    if (df < nCollisions)
+    if (df < nDF)
       return;
     df = 0;
-
-    for (size_t i = 0; i < vecOfTuples.size(); ++i) {
-      const auto& tuple = vecOfTuples[i];
-      const auto& innerVector = vecOfVecOfTuples[i];
-
-      histos.fill(HIST("Event/h1d_ft0_mult_percentile"), std::get<3>(tuple));
-      resoCollisionsdf(0, std::get<0>(tuple), std::get<1>(tuple), std::get<2>(tuple), std::get<3>(tuple), std::get<4>(tuple), std::get<5>(tuple), 0., 0., 0., 0., 0, std::get<6>(tuple));
-      //  LOGF(info, "collisions: Index = %d ) %f - %f - %f %f %d -- %d", std::get<0>(tuple).globalIndex(),std::get<1>(tuple),std::get<2>(tuple), std::get<3>(tuple), std::get<4>(tuple), std::get<5>(tuple).size(),resoCollisionsdf.lastIndex());
-
-      for (const auto& tuple : innerVector) {
-        reso2trksdf(resoCollisionsdf.lastIndex(),
-                    std::get<0>(tuple),
-                    std::get<1>(tuple),
-                    std::get<2>(tuple),
-                    std::get<3>(tuple),
-                    std::get<4>(tuple),
-                    std::get<5>(tuple),
-                    std::get<6>(tuple),
-                    std::get<7>(tuple),
-                    std::get<8>(tuple),
-                    std::get<9>(tuple),
-                    std::get<10>(tuple),
-                    std::get<11>(tuple),
-                    std::get<12>(tuple),
-                    std::get<13>(tuple),
-                    std::get<14>(tuple),
-                    std::get<15>(tuple));
-      }
-    }
-
-    vecOfTuples.clear();
-    vecOfVecOfTuples.clear();
+    writeMergedFrame<withCascades>();
   }
 
-  PROCESS_SWITCH(ResonanceMergeDF, processTrackDataDF, "Process for data merged DF", true);
-
-  void processTrackDataDFCasc(aod::ResoCollisions::iterator const& collision, aod::ResoTracks const& tracks, aod::ResoCascades const& trackCascs)
+  template <bool withCascades>
+  void writeMergedFrame()
   {
+    for (const auto& event : bufferedEvents) {
+      histos.fill(HIST("Event/h1d_ft0_mult_percentile"), event.cent);
+      resoCollisionsdf(0, event.posX, event.posY, event.posZ, event.cent, 0, 0, 0., 0., 0., 0., 0, 0);
 
-    int nCollisions = nDF;
-    vecOfTuples.push_back(std::make_tuple(collision.posX(), collision.posY(), collision.posZ(), collision.cent(), 0, 0, 0));
-    std::vector<std::tuple<float, float, float, float,
-                           unsigned char, unsigned char,
-                           int16_t, int16_t, int8_t, int8_t, int8_t,
-                           int8_t, int8_t, int8_t, float,
-                           uint8_t>>
-      innerVector;
-    std::vector<std::tuple<float, float, float, float,
-                           int*,
-                           int8_t, int8_t, int8_t, // TPC Pos Trk
-                           int8_t, int8_t, int8_t, // TPC Neg Trk
-                           int8_t, int8_t, int8_t, // TPC Bach Trk
-                           int8_t, int8_t, int8_t, // TOF Pos Trk
-                           int8_t, int8_t, int8_t, // TOF Neg Trk
-                           int8_t, int8_t, int8_t, // TOF Bach Trk
-                           float, float, float, float,
-                           float, float, float, float,
-                           float, float, int, float,
-                           float, float, float,
-                           float, float, float>>
-      innerVectorCasc;
-    for (const auto& track : tracks) {
-      if (cpidCut) {
-        if (!track.hasTOF()) {
-          if (std::abs(track.tpcNSigmaPr()) > nsigmaPr && std::abs(track.tpcNSigmaKa()) > nsigmaKa)
-            continue;
-
-          if (crejtpc && (std::abs(track.tpcNSigmaPr()) > std::abs(track.tpcNSigmaPi()) && std::abs(track.tpcNSigmaKa()) > std::abs(track.tpcNSigmaPi())))
-            continue;
-
-        } else {
-          if (std::abs(track.tofNSigmaPr()) > nsigmatofPr && std::abs(track.tofNSigmaKa()) > nsigmatofKa)
-            continue;
+      for (int i = event.trackBegin; i < event.trackEnd; i++) {
+        const auto& p = bufferedTracks.ptPxPyPz[i];
+        const auto& pid = bufferedTracks.pid10[i];
+        reso2trksdf(resoCollisionsdf.lastIndex(),
+                    p[0], p[1], p[2], p[3],
+                    bufferedTracks.tpcNCls[i][0],
+                    bufferedTracks.tpcNCls[i][1],
+                    bufferedTracks.dca10000[i][0],
+                    bufferedTracks.dca10000[i][1],
+                    pid[0], pid[1], pid[2], pid[3], pid[4], pid[5], pid[6],
+                    bufferedTracks.trackFlags[i]);
+      }
 
-          if (crejtof && (std::abs(track.tofNSigmaPr()) > std::abs(track.tofNSigmaPi()) && std::abs(track.tofNSigmaKa()) > std::abs(track.tofNSigmaPi())))
-            continue;
+      if constexpr (withCascades) {
+        for (int i = event.cascBegin; i < event.cascEnd; i++) {
+          const auto& p = bufferedCascades.ptPxPyPz[i];
+          const auto& pid = bufferedCascades.pid10[i];
+          const auto& topo = bufferedCascades.topology[i];
+          const auto& mv = bufferedCascades.massAndVertex[i];
+          reso2cascadesdf(resoCollisionsdf.lastIndex(),
+                          p[0], p[1], p[2], p[3],
+                          bufferedCascades.cascadeIndices[i].data(),
+                          pid[0], pid[1], pid[2], pid[3], pid[4], pid[5], pid[6], pid[7], pid[8],
+                          pid[9], pid[10], pid[11], pid[12], pid[13], pid[14], pid[15], pid[16], pid[17],
+                          topo[0], topo[1], topo[2], topo[3], topo[4], topo[5], topo[6], topo[7], topo[8], topo[9],
+                          bufferedCascades.sign[i],
+                          mv[0], mv[1], mv[2], mv[3], mv[4], mv[5], mv[6]);
         }
-
-        if (std::abs(track.dcaXY()) > cDCAXY)
-          continue;
-        if (std::abs(track.dcaZ()) > cDCAZ)
-          continue;
       }
-
-      innerVector.push_back(std::make_tuple(
-        //  track.trackId(),
-        track.pt(),
-        track.px(),
-        track.py(),
-        track.pz(),
-        (uint8_t)track.tpcNClsCrossedRows(),
-        (uint8_t)track.tpcNClsFound(),
-        static_cast<int16_t>(track.dcaXY() * 10000),
-        static_cast<int16_t>(track.dcaZ() * 10000),
-        (int8_t)(track.tpcNSigmaPi() * 10),
-        (int8_t)(track.tpcNSigmaKa() * 10),
-        (int8_t)(track.tpcNSigmaPr() * 10),
-        (int8_t)(track.tofNSigmaPi() * 10),
-        (int8_t)(track.tofNSigmaKa() * 10),
-        (int8_t)(track.tofNSigmaPr() * 10),
-        (int8_t)(track.tpcSignal() * 10),
-        track.trackFlags()));
-    }
-
-    for (const auto& trackCasc : trackCascs) {
-      innerVectorCasc.push_back(std::make_tuple(
-        trackCasc.pt(),
-        trackCasc.px(),
-        trackCasc.py(),
-        trackCasc.pz(),
-        const_cast<int*>(trackCasc.cascadeIndices()),
-        (int8_t)(trackCasc.daughterTPCNSigmaPosPi() * 10),
-        (int8_t)(trackCasc.daughterTPCNSigmaPosKa() * 10),
-        (int8_t)(trackCasc.daughterTPCNSigmaPosPr() * 10),
-        (int8_t)(trackCasc.daughterTPCNSigmaNegPi() * 10),
-        (int8_t)(trackCasc.daughterTPCNSigmaNegKa() * 10),
-        (int8_t)(trackCasc.daughterTPCNSigmaNegPr() * 10),
-        (int8_t)(trackCasc.daughterTPCNSigmaBachPi() * 10),
-        (int8_t)(trackCasc.daughterTPCNSigmaBachKa() * 10),
-        (int8_t)(trackCasc.daughterTPCNSigmaBachPr() * 10),
-        (int8_t)(trackCasc.daughterTOFNSigmaPosPi() * 10),
-        (int8_t)(trackCasc.daughterTOFNSigmaPosKa() * 10),
-        (int8_t)(trackCasc.daughterTOFNSigmaPosPr() * 10),
-        (int8_t)(trackCasc.daughterTOFNSigmaNegPi() * 10),
-        (int8_t)(trackCasc.daughterTOFNSigmaNegKa() * 10),
-        (int8_t)(trackCasc.daughterTOFNSigmaNegPr() * 10),
-        (int8_t)(trackCasc.daughterTOFNSigmaBachPi() * 10),
-        (int8_t)(trackCasc.daughterTOFNSigmaBachKa() * 10),
-        (int8_t)(trackCasc.daughterTOFNSigmaBachPr() * 10),
-        trackCasc.v0CosPA(),
-        trackCasc.cascCosPA(),
-        trackCasc.daughDCA(),
-        trackCasc.cascDaughDCA(),
-        trackCasc.dcapostopv(),
-        trackCasc.dcanegtopv(),
-        trackCasc.dcabachtopv(),
-        trackCasc.dcav0topv(),
-        trackCasc.dcaXYCascToPV(),
-        trackCasc.dcaZCascToPV(),
-        trackCasc.sign(),
-        trackCasc.mLambda(),
-        trackCasc.mXi(),
-        trackCasc.transRadius(), trackCasc.cascTransRadius(), trackCasc.decayVtxX(), trackCasc.decayVtxY(), trackCasc.decayVtxZ()));
     }
 
-    vecOfVecOfTuples.push_back(innerVector);
-    vecOfVecOfTuplesCasc.push_back(innerVectorCasc);
-    innerVector.clear();
-    innerVectorCasc.clear();
-
-    df++;
-    LOGF(info, "collisions: df = %i", df);
-    if (df < nCollisions)
-      return;
-    df = 0;
-
-    for (size_t i = 0; i < vecOfTuples.size(); ++i) {
-      const auto& tuple = vecOfTuples[i];
-      const auto& innerVector = vecOfVecOfTuples[i];
-      const auto& innerVectorCasc = vecOfVecOfTuplesCasc[i];
-
-      histos.fill(HIST("Event/h1d_ft0_mult_percentile"), std::get<3>(tuple));
-      resoCollisionsdf(0, std::get<0>(tuple), std::get<1>(tuple), std::get<2>(tuple), std::get<3>(tuple), std::get<4>(tuple), std::get<5>(tuple), 0., 0., 0., 0., 0, std::get<6>(tuple));
-      //  LOGF(info, "collisions: Index = %d ) %f - %f - %f %f %d -- %d", std::get<0>(tuple).globalIndex(),std::get<1>(tuple),std::get<2>(tuple), std::get<3>(tuple), std::get<4>(tuple), std::get<5>(tuple).size(),resoCollisionsdf.lastIndex());
+    bufferedEvents.clear();
+    bufferedTracks.clear();
+    bufferedCascades.clear();
+  }
 
-      for (const auto& tuple : innerVector) {
-        reso2trksdf(resoCollisionsdf.lastIndex(),
-                    std::get<0>(tuple),
-                    std::get<1>(tuple),
-                    std::get<2>(tuple),
-                    std::get<3>(tuple),
-                    std::get<4>(tuple),
-                    std::get<5>(tuple),
-                    std::get<6>(tuple),
-                    std::get<7>(tuple),
-                    std::get<8>(tuple),
-                    std::get<9>(tuple),
-                    std::get<10>(tuple),
-                    std::get<11>(tuple),
-                    std::get<12>(tuple),
-                    std::get<13>(tuple),
-                    std::get<14>(tuple),
-                    std::get<15>(tuple));
-      }
+  void processTrackDataDF(aod::ResoCollisions::iterator const& collision, aod::ResoTracks const& tracks)
+  {
+    bufferEvent<false>(collision, tracks, tracks);
+  }
 
-      for (const auto& tuple : innerVectorCasc) {
-        reso2cascadesdf(resoCollisionsdf.lastIndex(),
-                        std::get<0>(tuple),
-                        std::get<1>(tuple),
-                        std::get<2>(tuple),
-                        std::get<3>(tuple),
-                        std::get<4>(tuple),
-                        std::get<5>(tuple),
-                        std::get<6>(tuple),
-                        std::get<7>(tuple),
-                        std::get<8>(tuple),
-                        std::get<9>(tuple),
-                        std::get<10>(tuple),
-                        std::get<11>(tuple),
-                        std::get<12>(tuple),
-                        std::get<13>(tuple),
-                        std::get<14>(tuple),
-                        std::get<15>(tuple),
-                        std::get<16>(tuple),
-                        std::get<17>(tuple),
-                        std::get<18>(tuple),
-                        std::get<19>(tuple),
-                        std::get<20>(tuple),
-                        std::get<21>(tuple),
-                        std::get<22>(tuple),
-                        std::get<23>(tuple),
-                        std::get<24>(tuple),
-                        std::get<25>(tuple),
-                        std::get<26>(tuple),
-                        std::get<27>(tuple),
-                        std::get<28>(tuple),
-                        std::get<29>(tuple),
-                        std::get<30>(tuple),
-                        std::get<31>(tuple),
-                        std::get<32>(tuple),
-                        std::get<33>(tuple),
-                        std::get<34>(tuple),
-                        std::get<35>(tuple),
-                        std::get<36>(tuple),
-                        std::get<37>(tuple),
-                        std::get<38>(tuple),
-                        std::get<39>(tuple),
-                        std::get<40>(tuple));
-      }
-    }
+  PROCESS_SWITCH(ResonanceMergeDF, processTrackDataDF, "Process for data merged DF", true);
 
-    vecOfTuples.clear();
-    vecOfVecOfTuples.clear();
-    vecOfVecOfTuplesCasc.clear(); //
+  void processTrackDataDFCasc(aod::ResoCollisions::iterator const& collision, aod::ResoTracks const& tracks, aod::ResoCascades const& trackCascs)
+  {
+    bufferEvent<true>(collision, tracks, trackCascs);
   }
 
   PROCESS_SWITCH(ResonanceMergeDF, processTrackDataDFCasc, "Process for data merged DF for cascade", false);
@@ -50,9 +50,11 @@
 #include <TPDGCode.h>
 #include <TProfile.h>
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <cstdlib>
+#include <vector>
 
 using namespace o2;
 using namespace o2::analysis;
@@ -75,8 +77,15 @@ struct cascademlselection {
   o2::ml::OnnxModel mlModelOmegaMinus;
   o2::ml::OnnxModel mlModelOmegaPlus;
 
-  // Custom grouping
-  std::vector<std::vector<int>> cascadesGrouped;
+  // Batched inference: row-major feature matrix of the data frame, rows per charge and scores, reused across data frames
+  static constexpr std::size_t nFeatures = 4;
+  std::vector<float> mlInput;
+  std::vector<float> batchInput;
+  std::vector<float> batchOutput;
+  std::vector<int> rowsNegative;
+  std::vector<int> rowsPositive;
+  std::vector<float> xiScores;
+  std::vector<float> omegaScores;
 
   std::map<std::string, std::string> metadata;
 
@@ -226,95 +235,97 @@ struct cascademlselection {
     ccdb->setURL(ccdbConfigurations.ccdburl);
   }
 
-  // Process candidate and store properties in object
+  // Fill the row of input features of a candidate
   template <typename TCascObject>
-  void processCandidate(TCascObject const& cand)
+  void fillInputFeatures(TCascObject const& /*cand*/, float* row)
   {
     // Select features
     // FIXME THIS NEEDS ADJUSTING
-    std::vector<float> inputFeatures{0.0f, 0.0f,
-                                     0.0f, 0.0f};
+    std::fill(row, row + nFeatures, 0.0f);
+  }
 
-    // calculate scores
-    if (cand.sign() < 0) {
-      if (mlConfigurations.calculateXiMinusScores) {
-        float* xiMinusProbability = mlModelXiMinus.evalModel(inputFeatures);
-        xiMLSelections(xiMinusProbability[1]);
-      } else {
-        xiMLSelections(-1);
-      }
-      if (mlConfigurations.calculateOmegaMinusScores) {
-        float* omegaMinusProbability = mlModelOmegaMinus.evalModel(inputFeatures);
-        omegaMLSelections(omegaMinusProbability[1]);
-      } else {
-        omegaMLSelections(-1);
-      }
+  // Evaluate one model on the selected rows of the feature matrix and store the class-1 probabilities
+  void evaluateModel(o2::ml::OnnxModel& model, const std::vector<int>& rows, std::vector<float>& scores)
+  {
+    if (rows.empty()) {
+      return;
     }
-    if (cand.sign() > 0) {
-      if (mlConfigurations.calculateXiPlusScores) {
-        float* xiPlusProbability = mlModelXiPlus.evalModel(inputFeatures);
-        xiMLSelections(xiPlusProbability[1]);
-      } else {
-        xiMLSelections(-1);
-      }
-      if (mlConfigurations.calculateOmegaPlusScores) {
-        float* omegaPlusProbability = mlModelOmegaPlus.evalModel(inputFeatures);
-        omegaMLSelections(omegaPlusProbability[1]);
-      } else {
-        omegaMLSelections(-1);
-      }
+    batchInput.resize(rows.size() * nFeatures);
+    auto itInput = batchInput.begin();
+    for (const auto& iRow : rows) {
+      itInput = std::copy(mlInput.begin() + iRow * nFeatures, mlInput.begin() + (iRow + 1) * nFeatures, itInput);
+    }
+    const int64_t rowSize = model.evalModelBatch(batchInput.data(), rows.size(), batchOutput);
+    if (rowSize < 2) {
+      LOG(fatal) << "Batched inference returned " << rowSize << " values per candidate, at least 2 class probabilities expected!";
+    }
+    for (std::size_t i = 0; i < rows.size(); i++) {
+      scores[rows[i]] = batchOutput[i * rowSize + 1];
     }
   }
 
-  void processDerivedData(soa::Join<aod::StraCollisions, aod::StraStamps> const& collisions, CascDerivedDatas const& cascades)
+  // Assemble the feature matrix of all cascades of the data frame, run each model once on the
+  // cascades of the corresponding charge and write the scores following the cascade table
+  template <typename TCollisions, typename TCascades>
+  void processCandidates(TCollisions const& collisions, TCascades const& cascades)
   {
-    // Custom grouping
-    cascadesGrouped.clear();
-    cascadesGrouped.resize(collisions.size());
-
-    for (const auto& cascade : cascades) {
-      cascadesGrouped[cascade.straCollisionId()].push_back(cascade.globalIndex());
-    }
-
     for (const auto& collision : collisions) {
       initCCDB(collision);
-
       histos.fill(HIST("hEventVertexZ"), collision.posZ());
-      for (std::size_t i = 0; i < cascadesGrouped[collision.globalIndex()].size(); i++) {
-        auto casc = cascades.rawIteratorAt(cascadesGrouped[collision.globalIndex()][i]);
-        nCandidates++;
-        if (nCandidates % 50000 == 0) {
-          LOG(info) << "Candidates processed: " << nCandidates;
-        }
-        processCandidate(casc);
+    }
+
+    const std::size_t nCascades = cascades.size();
+    mlInput.resize(nCascades * nFeatures);
+    rowsNegative.clear();
+    rowsPositive.clear();
+    for (const auto& casc : cascades) {
+      fillInputFeatures(casc, mlInput.data() + casc.globalIndex() * nFeatures);
+      if (casc.sign() < 0) {
+        rowsNegative.push_back(static_cast<int>(casc.globalIndex()));
+      } else {
+        rowsPositive.push_back(static_cast<int>(casc.globalIndex()));
       }
     }
-  }
-  void processStandardData(aod::Collisions const& collisions, CascOriginalDatas const& cascades)
-  {
-    // Custom grouping
-    cascadesGrouped.clear();
-    cascadesGrouped.resize(collisions.size());
 
-    for (const auto& cascade : cascades) {
-      cascadesGrouped[cascade.collisionId()].push_back(cascade.globalIndex());
+    // calculate scores, -1 if the model of the candidate charge is not requested
+    xiScores.assign(nCascades, -1.f);
+    omegaScores.assign(nCascades, -1.f);
+    if (mlConfigurations.calculateXiMinusScores) {
+      evaluateModel(mlModelXiMinus, rowsNegative, xiScores);
+    }
+    if (mlConfigurations.calculateOmegaMinusScores) {
+      evaluateModel(mlModelOmegaMinus, rowsNegative, omegaScores);
+    }
+    if (mlConfigurations.calculateXiPlusScores) {
+      evaluateModel(mlModelXiPlus, rowsPositive, xiScores);
+    }
+    if (mlConfigurations.calculateOmegaPlusScores) {
+      evaluateModel(mlModelOmegaPlus, rowsPositive, omegaScores);
     }
 
-    for (const auto& collision : collisions) {
-      initCCDB(collision);
+    xiMLSelections.reserve(nCascades);
+    omegaMLSelections.reserve(nCascades);
+    for (std::size_t i = 0; i < nCascades; i++) {
+      xiMLSelections(xiScores[i]);
+      omegaMLSelections(omegaScores[i]);
+    }
 
-      histos.fill(HIST("hEventVertexZ"), collision.posZ());
-      for (std::size_t i = 0; i < cascadesGrouped[collision.globalIndex()].size(); i++) {
-        auto casc = cascades.rawIteratorAt(cascadesGrouped[collision.globalIndex()][i]);
-        nCandidates++;
-        if (nCandidates % 50000 == 0) {
-          LOG(info) << "Candidates processed: " << nCandidates;
-        }
-        processCandidate(casc);
-      }
+    const int previousCandidates = nCandidates;
+    nCandidates += nCascades;
+    if (nCandidates / 50000 != previousCandidates / 50000) {
+      LOG(info) << "Candidates processed: " << nCandidates;
     }
   }
 
+  void processDerivedData(soa::Join<aod::StraCollisions, aod::StraStamps> const& collisions, CascDerivedDatas const& cascades)
+  {
+    processCandidates(collisions, cascades);
+  }
+  void processStandardData(aod::Collisions const& collisions, CascOriginalDatas const& cascades)
+  {
+    processCandidates(collisions, cascades);
+  }
+
   PROCESS_SWITCH(cascademlselection, processStandardData, "Process standard data", false);
   PROCESS_SWITCH(cascademlselection, processDerivedData, "Process derived data", true);
 };
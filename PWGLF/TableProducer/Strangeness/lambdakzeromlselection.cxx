@@ -53,6 +53,7 @@
 #include <array>
 #include <cmath>
 #include <cstdlib>
+#include <vector>
 
 using namespace o2;
 using namespace o2::analysis;
@@ -102,6 +103,12 @@ struct lambdakzeromlselection {
   //// Casting
   std::vector<int> CastKine_SelMap, CastTopo_SelMap, Feature_SelMask;
 
+  // Batched inference: row-major feature matrix of the data frame and model output, reused across data frames
+  static constexpr std::size_t nBaseFeatures = 18;
+  std::vector<std::size_t> featureIndices; // indices of the selected base features
+  std::vector<float> mlInput;
+  std::vector<float> mlOutput;
+
   // CCDB configuration
   o2::ccdb::CcdbApi ccdbApi;
   Service<o2::ccdb::BasicCCDBManager> ccdb;
@@ -189,76 +196,93 @@ struct lambdakzeromlselection {
     Feature_SelMask.insert(Feature_SelMask.end(), CastKine_SelMap.begin(), CastKine_SelMap.end());
     Feature_SelMask.insert(Feature_SelMask.end(), CastTopo_SelMap.begin(), CastTopo_SelMap.end());
     LOG(info) << "Feature_SelMask size: " << Feature_SelMask.size();
+    if (Feature_SelMask.size() != nBaseFeatures) {
+      LOG(fatal) << "Feature selection masks cover " << Feature_SelMask.size() << " features, " << nBaseFeatures << " expected!";
+    }
+    for (std::size_t i = 0; i < Feature_SelMask.size(); ++i) {
+      if (Feature_SelMask[i] >= 1) { // If the mask value is true, select the corresponding element
+        featureIndices.push_back(i);
+      }
+    }
   }
 
-  template <typename T, typename U>
-  std::vector<float> extractSelectedElements(const std::vector<T>& base_features, const std::vector<U>& Sel_mask)
+  // Fill the row of selected input features of a candidate
+  template <typename TV0Object>
+  void fillInputFeatures(TV0Object const& cand, float* row)
   {
-    std::vector<float> selected_elements;
-    for (size_t i = 0; i < Sel_mask.size(); ++i) {
-      if (Sel_mask[i] >= 1) { // If the mask value is true, select the corresponding element
-        selected_elements.push_back(base_features[i]);
-      }
+    const std::array<float, nBaseFeatures> base_features{cand.mLambda(), cand.mAntiLambda(),
+                                                         cand.mGamma(), cand.mK0Short(),
+                                                         cand.pt(), static_cast<float>(cand.qtarm()), cand.alpha(),
+                                                         cand.positiveeta(), cand.negativeeta(), cand.eta(),
+                                                         cand.z(), cand.v0radius(), static_cast<float>(TMath::ACos(cand.v0cosPA())),
+                                                         cand.dcapostopv(), cand.dcanegtopv(), cand.dcaV0daughters(),
+                                                         cand.dcav0topv(), cand.psipair()};
+    for (const auto& iFeature : featureIndices) {
+      *row++ = base_features[iFeature];
     }
-    return selected_elements;
   }
 
-  // Process candidate and store properties in object
-  template <typename TV0Object, typename T>
-  void processCandidate(TV0Object const& cand, const std::vector<T>& Feature_SelMask)
+  // Evaluate one model on the whole feature matrix and write the class-1 probability of each candidate
+  template <typename TCursor>
+  void evaluateModel(o2::ml::OnnxModel& model, const int64_t nRows, TCursor& cursor)
   {
-    // Select features
-    std::vector<float> base_features{cand.mLambda(), cand.mAntiLambda(),
-                                     cand.mGamma(), cand.mK0Short(),
-                                     cand.pt(), static_cast<float>(cand.qtarm()), cand.alpha(),
-                                     cand.positiveeta(), cand.negativeeta(), cand.eta(),
-                                     cand.z(), cand.v0radius(), static_cast<float>(TMath::ACos(cand.v0cosPA())),
-                                     cand.dcapostopv(), cand.dcanegtopv(), cand.dcaV0daughters(),
-                                     cand.dcav0topv(), cand.psipair()};
-
-    // Apply mask to select features
-    std::vector<float> inputFeatures = extractSelectedElements(base_features, Feature_SelMask);
+    const int64_t rowSize = model.evalModelBatch(mlInput.data(), nRows, mlOutput);
+    if (rowSize < 2) {
+      LOG(fatal) << "Batched inference returned " << rowSize << " values per candidate, at least 2 class probabilities expected!";
+    }
+    cursor.reserve(nRows);
+    for (int64_t i = 0; i < nRows; i++) {
+      cursor(mlOutput[i * rowSize + 1]);
+    }
+  }
+
+  // Assemble the feature matrix of all V0s of the data frame and run each model once
+  template <typename TCollisions, typename TV0s>
+  void processCandidates(TCollisions const& collisions, TV0s const& v0s)
+  {
+    for (const auto& coll : collisions) {
+      histos.fill(HIST("hEventVertexZ"), coll.posZ());
+    }
+    const int64_t nRows = v0s.size();
+    if (nRows == 0) {
+      return;
+    }
+    const std::size_t nFeatures = featureIndices.size();
+    mlInput.resize(nRows * nFeatures);
+    float* row = mlInput.data();
+    for (const auto& v0 : v0s) {
+      fillInputFeatures(v0, row);
+      row += nFeatures;
+    }
 
     // calculate classifier output
     if (PredictLambda) {
-      float* LambdaProbability = lambda_bdt.evalModel(inputFeatures);
-      lambdaMLSelections(LambdaProbability[1]);
+      evaluateModel(lambda_bdt, nRows, lambdaMLSelections);
     }
     if (PredictGamma) {
-      float* GammaProbability = gamma_bdt.evalModel(inputFeatures);
-      gammaMLSelections(GammaProbability[1]);
+      evaluateModel(gamma_bdt, nRows, gammaMLSelections);
     }
     if (PredictAntiLambda) {
-      float* AntiLambdaProbability = antilambda_bdt.evalModel(inputFeatures);
-      antiLambdaMLSelections(AntiLambdaProbability[1]);
+      evaluateModel(antilambda_bdt, nRows, antiLambdaMLSelections);
     }
     if (PredictKZeroShort) {
-      float* KZeroShortProbability = kzeroshort_bdt.evalModel(inputFeatures);
-      kzeroShortMLSelections(KZeroShortProbability[1]);
+      evaluateModel(kzeroshort_bdt, nRows, kzeroShortMLSelections);
+    }
+
+    const int previousCandidates = nCandidates;
+    nCandidates += nRows;
+    if (nCandidates / 50000 != previousCandidates / 50000) {
+      LOG(info) << "Candidates processed: " << nCandidates;
     }
   }
 
-  void processDerivedData(aod::StraCollision const& coll, V0DerivedDatas const& v0s)
+  void processDerivedData(aod::StraCollisions const& collisions, V0DerivedDatas const& v0s)
   {
-    histos.fill(HIST("hEventVertexZ"), coll.posZ());
-    for (auto& v0 : v0s) {
-      nCandidates++;
-      if (nCandidates % 50000 == 0) {
-        LOG(info) << "Candidates processed: " << nCandidates;
-      }
-      processCandidate(v0, Feature_SelMask);
-    }
+    processCandidates(collisions, v0s);
   }
-  void processStandardData(aod::Collision const& coll, V0OriginalDatas const& v0s)
+  void processStandardData(aod::Collisions const& collisions, V0OriginalDatas const& v0s)
   {
-    histos.fill(HIST("hEventVertexZ"), coll.posZ());
-    for (auto& v0 : v0s) {
-      nCandidates++;
-      if (nCandidates % 50000 == 0) {
-        LOG(info) << "Candidates processed: " << nCandidates;
-      }
-      processCandidate(v0, Feature_SelMask);
-    }
+    processCandidates(collisions, v0s);
   }
 
   PROCESS_SWITCH(lambdakzeromlselection, processStandardData, "Process standard data", false);
@@ -210,10 +210,6 @@ struct strangederivedbuilder {
   } axisDetectors;
 
   // For manual sliceBy
-  Preslice<aod::V0Datas> V0perCollision = o2::aod::v0data::collisionId;
-  Preslice<aod::CascDatas> CascperCollision = o2::aod::cascdata::collisionId;
-  Preslice<aod::KFCascDatas> KFCascperCollision = o2::aod::cascdata::collisionId;
-  Preslice<aod::TraCascDatas> TraCascperCollision = o2::aod::cascdata::collisionId;
   Preslice<aod::McParticles> mcParticlePerMcCollision = o2::aod::mcparticle::mcCollisionId;
   Preslice<UDCollisionsFull> udCollisionsPerCollision = o2::aod::udcollision::collisionId;
 
@@ -429,24 +425,25 @@ struct strangederivedbuilder {
   template <typename coll, typename udcoll, typename v0d, typename cad, typename kfcad, typename tracad, typename bcType>
   void populateCollisionTables(coll const& collisions, udcoll const& udCollisions, v0d const& V0s, cad const& Cascades, kfcad const& KFCascades, tracad const& TraCascades, bcType const& /*bcs*/)
   {
-    // create collision indices beforehand
-    std::vector<int> V0CollIndices(V0s.size(), -1);                 // index -1: no collision
-    std::vector<int> CascadeCollIndices(Cascades.size(), -1);       // index -1: no collision
-    std::vector<int> KFCascadeCollIndices(KFCascades.size(), -1);   // index -1: no collision
-    std::vector<int> TraCascadeCollIndices(TraCascades.size(), -1); // index -1: no collision
+    // count the candidates of each collision from their collision index, instead of slicing the four tables per collision
+    std::vector<int> nStrangePerCollision(collisions.size(), 0);
+    auto countPerCollision = [&](auto const& candidates) {
+      for (const auto& candidate : candidates) {
+        if (candidate.collisionId() >= 0) {
+          nStrangePerCollision[candidate.collisionId()]++;
+        }
+      }
+    };
+    countPerCollision(V0s);
+    countPerCollision(Cascades);
+    countPerCollision(KFCascades);
+    countPerCollision(TraCascades);
+    std::vector<int> strangeCollIndices(collisions.size(), -1); // index -1: collision not stored
 
     // +-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+
     for (const auto& collision : collisions) {
       const uint64_t collIdx = collision.globalIndex();
-
-      auto V0Table_thisColl = V0s.sliceBy(V0perCollision, collIdx);
-      auto CascTable_thisColl = Cascades.sliceBy(CascperCollision, collIdx);
-      auto KFCascTable_thisColl = KFCascades.sliceBy(KFCascperCollision, collIdx);
-      auto TraCascTable_thisColl = TraCascades.sliceBy(TraCascperCollision, collIdx);
-      bool strange = V0Table_thisColl.size() > 0 ||
-                     CascTable_thisColl.size() > 0 ||
-                     KFCascTable_thisColl.size() > 0 ||
-                     TraCascTable_thisColl.size() > 0;
+      bool strange = nStrangePerCollision[collIdx] > 0;
 
       auto bc = collision.template bc_as<bcType>();
 
@@ -562,29 +559,31 @@ struct strangederivedbuilder {
                                      collision.alias_raw());
         }
       }
-      for (const auto& v0 : V0Table_thisColl)
-        V0CollIndices[v0.globalIndex()] = products.strangeColl.lastIndex();
-      for (const auto& casc : CascTable_thisColl)
-        CascadeCollIndices[casc.globalIndex()] = products.strangeColl.lastIndex();
-      for (const auto& casc : KFCascTable_thisColl)
-        KFCascadeCollIndices[casc.globalIndex()] = products.strangeColl.lastIndex();
-      for (const auto& casc : TraCascTable_thisColl)
-        TraCascadeCollIndices[casc.globalIndex()] = products.strangeColl.lastIndex();
+      if (strange || fillEmptyCollisions) {
+        strangeCollIndices[collIdx] = products.strangeColl.lastIndex();
+      }
     }
 
     // +-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+-<*>-+
     // populate references, including those that might not be assigned
+    auto strangeCollIndex = [&](auto const& candidate) {
+      return candidate.collisionId() >= 0 ? strangeCollIndices[candidate.collisionId()] : -1;
+    };
+    products.v0collref.reserve(V0s.size());
     for (const auto& v0 : V0s) {
-      products.v0collref(V0CollIndices[v0.globalIndex()]);
+      products.v0collref(strangeCollIndex(v0));
     }
+    products.casccollref.reserve(Cascades.size());
     for (const auto& casc : Cascades) {
-      products.casccollref(CascadeCollIndices[casc.globalIndex()]);
+      products.casccollref(strangeCollIndex(casc));
     }
+    products.kfcasccollref.reserve(KFCascades.size());
     for (const auto& casc : KFCascades) {
-      products.kfcasccollref(KFCascadeCollIndices[casc.globalIndex()]);
+      products.kfcasccollref(strangeCollIndex(casc));
     }
+    products.tracasccollref.reserve(TraCascades.size());
     for (const auto& casc : TraCascades) {
-      products.tracasccollref(TraCascadeCollIndices[casc.globalIndex()]);
+      products.tracasccollref(strangeCollIndex(casc));
     }
   }
 
@@ -924,48 +923,36 @@ struct strangederivedbuilder {
 
   using interlinkedCascades = soa::Join<aod::Cascades, aod::CascDataLink, aod::KFCascDataLink, aod::TraCascDataLink>;
 
-  void processCascadeInterlinkTracked(interlinkedCascades const& /*masterCascades*/, aod::CascIndices const& Cascades, aod::TraCascIndices const& TraCascades)
+  // link from each cascade index table row to the master cascade, through the index columns only
+  template <typename TLinked, typename TCursor>
+  void fillInterlink(std::vector<int> const& masterToOther, TLinked const& linkedCascades, TCursor& cursor)
   {
-    // Standard to tracked
-    for (auto const& c : Cascades) {
-      int indexTracked = -1;
-      if (c.has_cascade()) {
-        auto cascade = c.cascade_as<interlinkedCascades>();
-        indexTracked = cascade.traCascDataId();
-      }
-      products.cascToTraRefs(indexTracked);
-    }
-    // Tracked to standard
-    for (auto const& c : TraCascades) {
-      int index = -1;
-      if (c.has_cascade()) {
-        auto cascade = c.cascade_as<interlinkedCascades>();
-        index = cascade.cascDataId();
-      }
-      products.traToCascRefs(index);
+    cursor.reserve(linkedCascades.size());
+    for (auto const& c : linkedCascades) {
+      cursor(c.has_cascade() ? masterToOther[c.cascadeId()] : -1);
     }
   }
 
-  void processCascadeInterlinkKF(interlinkedCascades const& /*masterCascades*/, aod::CascIndices const& Cascades, aod::KFCascIndices const& KFCascades)
+  void processCascadeInterlinkTracked(interlinkedCascades const& masterCascades, aod::CascIndices const& Cascades, aod::TraCascIndices const& TraCascades)
   {
-    // Standard to KF
-    for (auto const& c : Cascades) {
-      int indexKF = -1;
-      if (c.has_cascade()) {
-        auto cascade = c.cascade_as<interlinkedCascades>();
-        indexKF = cascade.kfCascDataId();
-      }
-      products.cascToKFRefs(indexKF);
-    }
-    // KF to standard
-    for (auto const& c : KFCascades) {
-      int index = -1;
-      if (c.has_cascade()) {
-        auto cascade = c.cascade_as<interlinkedCascades>();
-        index = cascade.cascDataId();
-      }
-      products.kfToCascRefs(index);
+    std::vector<int> masterToTracked(masterCascades.size(), -1), masterToStandard(masterCascades.size(), -1);
+    for (auto const& cascade : masterCascades) {
+      masterToTracked[cascade.globalIndex()] = cascade.traCascDataId();
+      masterToStandard[cascade.globalIndex()] = cascade.cascDataId();
+    }
+    fillInterlink(masterToTracked, Cascades, products.cascToTraRefs);     // Standard to tracked
+    fillInterlink(masterToStandard, TraCascades, products.traToCascRefs); // Tracked to standard
+  }
+
+  void processCascadeInterlinkKF(interlinkedCascades const& masterCascades, aod::CascIndices const& Cascades, aod::KFCascIndices const& KFCascades)
+  {
+    std::vector<int> masterToKF(masterCascades.size(), -1), masterToStandard(masterCascades.size(), -1);
+    for (auto const& cascade : masterCascades) {
+      masterToKF[cascade.globalIndex()] = cascade.kfCascDataId();
+      masterToStandard[cascade.globalIndex()] = cascade.cascDataId();
     }
+    fillInterlink(masterToKF, Cascades, products.cascToKFRefs);         // Standard to KF
+    fillInterlink(masterToStandard, KFCascades, products.kfToCascRefs); // KF to standard
   }
 
   void processPureSimulation(aod::McParticles const& mcParticles)
@@ -38,6 +38,8 @@
 #include "PWGLF/DataModel/LFStrangenessTables.h"
 #include "PWGLF/Utils/strangenessBuilderHelper.h"
 
+#include "Common/Core/IndexGrouping.h"
+#include "Common/Core/ScratchArena.h"
 #include "Common/Core/TPCVDriftManager.h"
 #include "Common/DataModel/PIDResponseTPC.h"
 #include "Tools/ML/MlResponse.h"
@@ -51,7 +53,12 @@
 #include "Framework/DataSpecUtils.h"
 #include "Framework/runDataProcessing.h"
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <span>
 #include <string>
+#include <thread>
 #include <vector>
 
 using namespace o2;
@@ -332,6 +339,10 @@ struct StrangenessBuilder {
   // exchanges CPU (generate V0s again) with memory (save pre-generated V0s)
   Configurable<bool> useV0BufferForCascades{"useV0BufferForCascades", false, "store array of V0s for cascades or not. False (default): save RAM, use more CPU; true: save CPU, use more RAM"};
 
+  // CPU options: results do not depend on them
+  Configurable<bool> useProngDCACache{"useProngDCACache", true, "compute the DCA to PV of a daughter track only once per collision, even if it enters several candidates"};
+  Configurable<int> nThreads{"nThreads", 1, "number of threads building the V0 and cascade candidates, each with its own fitter. 1: serial building"};
+
   Configurable<int> mc_findableMode{"mc_findableMode", 0, "0: disabled; 1: add findable-but-not-found to existing V0s from AO2D; 2: reset V0s and generate only findable-but-not-found"};
 
   // Autoconfigure process functions
@@ -459,6 +470,16 @@ struct StrangenessBuilder {
   int mRunNumber;
   o2::base::MatLayerCylSet* lut = nullptr;
 
+  // helpers used by the worker threads when building in parallel, copies of straHelper made for every DF
+  std::vector<o2::pwglf::strangenessBuilderHelper> helperPool;
+  static constexpr std::size_t PoolChunkSize = 4096; // candidates built in parallel before they are written out in order
+  enum poolStatus : uint8_t { kNotPrebuilt = 0,
+                              kPrebuilt,
+                              kPrebuildFailed };
+  std::vector<uint8_t> poolStatuses;
+  std::vector<o2::pwglf::v0candidate> poolV0s;
+  std::vector<o2::pwglf::cascadeCandidate> poolCascades;
+
   // for handling TPC-only tracks (photons)
   o2::aod::common::TPCVDriftManager mVDriftMgr;
 
@@ -567,12 +588,24 @@ struct StrangenessBuilder {
   std::vector<cascadeEntry> cascadeList;
   std::vector<std::size_t> sorted_v0;
   std::vector<std::size_t> sorted_cascade;
+  o2::common::core::IndexGrouping collisionGrouping; // V0 / cascade lists grouped by collision for the findable modes
 
   // for tagging V0s used in cascades
   std::vector<o2::pwglf::v0candidate> v0sFromCascades; // Vector of v0 candidates used in cascades
   std::vector<int> ao2dV0toV0List;                     // index to relate v0s -> v0List
+  o2::common::core::ScratchArena scratchArena;         // per data frame temporary arrays (McCollision -> Collision maps)
   std::vector<int> v0Map;                              // index to relate v0List -> v0sFromCascades
 
+  // de-duplication buffers, reused across data frames
+  std::vector<o2::pwglf::V0group> v0tableGrouped;       // V0s grouped by (pos, neg) track indices
+  std::vector<o2::pwglf::V0groupKey> v0GroupingKeys;    // sorting buffer for the grouping
+  std::vector<V0DuplicateExtra> v0DuplicateExtras;      // duplicates info of the group being processed
+  std::vector<float> paVec;                             // pointing angles for ranking
+  std::vector<float> v0zVec;                            // V0 vertex z for ranking
+  std::vector<int> paRanks;                             // pointing angle ranks
+  std::vector<int> v0zRanks;                            // V0 vertex z ranks
+  std::vector<std::pair<float, size_t>> rankSortBuffer; // value-index pairs for rankSort
+
   void init(InitContext& context)
   {
     // setup bookkeeping histogram
@@ -767,6 +800,10 @@ struct StrangenessBuilder {
     straHelper.cascadeselections.dcacascdau = cascadeBuilderOpts.dcacascdau;
     straHelper.cascadeselections.lambdaMassWindow = cascadeBuilderOpts.lambdaMassWindow;
     straHelper.cascadeselections.maxDaughterEta = cascadeBuilderOpts.maxDaughterEta;
+    straHelper.useProngDCACache = useProngDCACache;
+    if (nThreads > 1) {
+      LOGF(info, "Building V0 and cascade candidates with %d threads", nThreads.value);
+    }
 
     // Loading BDT model
     if (DeduplicationOpts.deduplicationAlgorithm.value == 4 || DeduplicationOpts.deduplicationAlgorithm.value == 6) {
@@ -794,20 +831,21 @@ struct StrangenessBuilder {
   template <typename T>
   std::vector<std::size_t> sort_indices(const std::vector<T>& v, bool doSorting = false)
   {
-    std::vector<std::size_t> idx(v.size());
-    std::iota(idx.begin(), idx.end(), 0);
     if (doSorting) {
-      // do sorting only if requested (not always necessary)
-      std::stable_sort(idx.begin(), idx.end(),
-                       [&v](std::size_t i1, std::size_t i2) { return v[i1].collisionId < v[i2].collisionId; });
+      // do sorting only if requested (not always necessary): stable grouping by collisionId in linear time
+      collisionGrouping.buildByCollision(v);
+      return collisionGrouping.rows();
     }
+    std::vector<std::size_t> idx(v.size());
+    std::iota(idx.begin(), idx.end(), 0);
     return idx;
   }
 
-  // Simple function to rank vectors based on values
-  std::vector<int> rankSort(const std::vector<float>& v_temp, bool descending = false)
+  // Simple function to rank vectors based on values, result and sorting buffer are reused
+  void rankSort(const std::vector<float>& v_temp, std::vector<int>& result, bool descending = false)
   {
-    std::vector<std::pair<float, size_t>> v_sort(v_temp.size());
+    std::vector<std::pair<float, size_t>>& v_sort = rankSortBuffer;
+    v_sort.resize(v_temp.size());
 
     // Pair each value with its original index
     for (size_t i = 0U; i < v_temp.size(); ++i) {
@@ -827,7 +865,7 @@ struct StrangenessBuilder {
     }
 
     std::pair<float, size_t> rank_tracker = std::make_pair(std::numeric_limits<float>::quiet_NaN(), 0);
-    std::vector<int> result(v_temp.size());
+    result.resize(v_temp.size());
 
     for (size_t i = 0U; i < v_sort.size(); ++i) {
       // Only update rank if value is different from previous
@@ -836,24 +874,23 @@ struct StrangenessBuilder {
       }
       result[v_sort[i].second] = rank_tracker.second; // assign rank to original index
     }
-
-    return result;
   }
 
   //_______________________________________________________________________
-  // Process duplicated photons
+  // Process duplicated photons, fills v0DuplicateExtras (one entry per collision
+  // of the group) and returns false if the group is not to be de-duplicated
   template <class TBCs, typename TCollisions, typename TTracks>
-  std::vector<V0DuplicateExtra> processDuplicates(TCollisions const& collisions, TTracks const& tracks, std::vector<o2::pwglf::V0group> V0Grouped, size_t iV0)
+  bool processDuplicates(TCollisions const& collisions, TTracks const& tracks, o2::pwglf::V0group const& v0group)
   {
-    auto pTrack = tracks.rawIteratorAt(V0Grouped[iV0].posTrackId);
-    auto nTrack = tracks.rawIteratorAt(V0Grouped[iV0].negTrackId);
+    auto pTrack = tracks.rawIteratorAt(v0group.posTrackId);
+    auto nTrack = tracks.rawIteratorAt(v0group.negTrackId);
 
     bool isPosTPCOnly = (pTrack.hasTPC() && !pTrack.hasITS() && !pTrack.hasTRD() && !pTrack.hasTOF());
     bool isNegTPCOnly = (nTrack.hasTPC() && !nTrack.hasITS() && !nTrack.hasTRD() && !nTrack.hasTOF());
 
     // don't try to de-duplicate if no track is TPC only
     if (!isPosTPCOnly && !isNegTPCOnly) {
-      return {};
+      return false;
     }
 
     // fitness criteria defined here
@@ -871,14 +908,15 @@ struct StrangenessBuilder {
     float AvgPA = 0.0f;
 
     // Containers for ranking
-    std::vector<float> paVec(V0Grouped[iV0].collisionIds.size(), 999.f);
-    std::vector<float> v0zVec(V0Grouped[iV0].collisionIds.size(), 999.f);
+    paVec.assign(v0group.collisionIds.size(), 999.f);
+    v0zVec.assign(v0group.collisionIds.size(), 999.f);
 
     // Auxiliary vector to store V0 duplicate info
-    std::vector<V0DuplicateExtra> V0DuplicateExtras;
+    std::vector<V0DuplicateExtra>& V0DuplicateExtras = v0DuplicateExtras;
+    V0DuplicateExtras.clear();
 
     // Loop over duplicates
-    for (size_t ic = 0; ic < V0Grouped[iV0].collisionIds.size(); ic++) {
+    for (size_t ic = 0; ic < v0group.collisionIds.size(); ic++) {
 
       // Helper structure to save duplicates info - initializing with dummy values
       V0DuplicateExtra v0DuplicateInfo;
@@ -897,7 +935,7 @@ struct StrangenessBuilder {
       // get track parametrizations, collisions
       auto posTrackPar = getTrackParCov(pTrack);
       auto negTrackPar = getTrackParCov(nTrack);
-      auto const& collision = collisions.rawIteratorAt(V0Grouped[iV0].collisionIds[ic]);
+      auto const& collision = collisions.rawIteratorAt(v0group.collisionIds[ic]);
 
       // handle TPC-only tracks properly (photon conversions)
       if (v0BuilderOpts.moveTPCOnlyTracks) {
@@ -922,7 +960,7 @@ struct StrangenessBuilder {
       // process candidate with helper, generate properties for consulting
       // <false>: do not apply selections: do as much as possible to preserve
       // candidate at this level and do not select with topo selections
-      if (straHelper.buildV0Candidate<false>(V0Grouped[iV0].collisionIds[ic], collision.posX(), collision.posY(), collision.posZ(), pTrack, nTrack, posTrackPar, negTrackPar, true, false, true)) {
+      if (straHelper.buildV0Candidate<false>(v0group.collisionIds[ic], collision.posX(), collision.posY(), collision.posZ(), pTrack, nTrack, posTrackPar, negTrackPar, true, false, true)) {
 
         // candidate built, check pointing angle
         if (straHelper.v0.pointingAngle < bestPointingAngle) {
@@ -958,11 +996,11 @@ struct StrangenessBuilder {
         AvgPA /= NDuplicates;
 
       // Get vector of ranks
-      std::vector<int> paRanks = rankSort(paVec, false);
-      std::vector<int> v0zRanks = rankSort(v0zVec, false);
+      rankSort(paVec, paRanks, false);
+      rankSort(v0zVec, v0zRanks, false);
 
       // Fill the ML score for all candidates
-      for (size_t ic = 0; ic < V0Grouped[iV0].collisionIds.size(); ic++) {
+      for (size_t ic = 0; ic < v0group.collisionIds.size(); ic++) {
 
         // Skip if v0 was not built
         if (!V0DuplicateExtras[ic].isBuildOk)
@@ -1007,8 +1045,7 @@ struct StrangenessBuilder {
       histos.fill(HIST("DeduplicationQA/hPAOfBestMLScore"), V0DuplicateExtras[bestMLScoreIndex].PA);
     }
 
-    // return vector with duplicates info
-    return V0DuplicateExtras;
+    return true;
   }
 
   template <typename TCollisions>
@@ -1131,13 +1168,14 @@ struct StrangenessBuilder {
     sorted_v0.clear();
     sorted_cascade.clear();
     ao2dV0toV0List.clear();
+    scratchArena.reset();
 
     trackEntry currentTrackEntry;
     v0Entry currentV0Entry;
     cascadeEntry currentCascadeEntry;
 
-    std::vector<int> bestCollisionArray;          // stores McCollision -> Collision map
-    std::vector<int> bestCollisionNContribsArray; // stores Ncontribs for biggest coll assoc to mccoll
+    std::span<int> bestCollisionArray;          // stores McCollision -> Collision map
+    std::span<int> bestCollisionNContribsArray; // stores Ncontribs for biggest coll assoc to mccoll
 
     int collisionLessV0s = 0;
     int collisionLessCascades = 0;
@@ -1145,10 +1183,8 @@ struct StrangenessBuilder {
     if (mc_findableMode.value > 0) {
       if constexpr (soa::is_table<TMCCollisions>) {
         // if mcCollisions exist, assemble mcColl -> bestRecoColl map here
-        bestCollisionArray.clear();
-        bestCollisionNContribsArray.clear();
-        bestCollisionArray.resize(mcCollisions.size(), -1);          // marks not reconstructed
-        bestCollisionNContribsArray.resize(mcCollisions.size(), -1); // marks not reconstructed
+        bestCollisionArray = scratchArena.allocate<int>(mcCollisions.size(), -1);          // marks not reconstructed
+        bestCollisionNContribsArray = scratchArena.allocate<int>(mcCollisions.size(), -1); // marks not reconstructed
 
         // single loop over double loop at a small cost in memory for extra array
         for (const auto& collision : collisions) {
@@ -1170,7 +1206,7 @@ struct StrangenessBuilder {
         // handle duplicates explicitly: group V0s according to (p,n) indices
         // will provide a list of collisionIds (in V0group), allowing for
         // easy de-duplication when passing to the v0List
-        std::vector<o2::pwglf::V0group> v0tableGrouped = o2::pwglf::groupDuplicates(v0s);
+        o2::pwglf::groupDuplicates(v0s, v0tableGrouped, v0GroupingKeys);
         histos.fill(HIST("hDeduplicationStatistics"), 0.0, v0s.size());
         histos.fill(HIST("hDeduplicationStatistics"), 1.0, v0tableGrouped.size());
 
@@ -1182,13 +1218,11 @@ struct StrangenessBuilder {
             continue;
           }
 
-          // process duplicates
-          std::vector<V0DuplicateExtra> deduplicationOutput = processDuplicates<TBCs>(collisions, tracks, v0tableGrouped, iV0);
-
-          // skip if empty
-          if (deduplicationOutput.empty()) {
+          // process duplicates, skip if not to be de-duplicated
+          if (!processDuplicates<TBCs>(collisions, tracks, v0tableGrouped[iV0])) {
             continue;
           }
+          const std::vector<V0DuplicateExtra>& deduplicationOutput = v0DuplicateExtras;
 
           // mark de-duplicated candidates
           for (size_t ic = 0; ic < v0tableGrouped[iV0].collisionIds.size(); ic++) {
@@ -1600,6 +1634,34 @@ struct StrangenessBuilder {
     LOGF(debug, "V0 total %i, Cascade total %i, Tracked cascade total %i, V0s flagged used in cascades: %i", v0s.size(), cascades.size(), trackedCascadeCount, v0sUsedInCascades);
   }
 
+  //__________________________________________________
+  // run prebuild(helper, i) for i in [begin, end) on the threads of the pool, each with its own helper
+  // the outcome of each entry is stored at its index, so that the output does not depend on the scheduling
+  void runInPool(std::size_t begin, std::size_t end, std::function<void(o2::pwglf::strangenessBuilderHelper&, std::size_t)> const& prebuild)
+  {
+    poolStatuses.assign(end - begin, kNotPrebuilt);
+    std::atomic<std::size_t> next{begin};
+    auto worker = [&](o2::pwglf::strangenessBuilderHelper& helper) {
+      for (std::size_t i = next++; i < end; i = next++) {
+        prebuild(helper, i);
+      }
+    };
+    std::vector<std::thread> threads;
+    for (std::size_t iThread = 1; iThread < helperPool.size(); iThread++) {
+      threads.emplace_back(worker, std::ref(helperPool[iThread]));
+    }
+    worker(helperPool[0]);
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  template <typename TTrack>
+  static bool isTPCOnly(TTrack const& track)
+  {
+    return track.hasTPC() && !track.hasITS() && !track.hasTRD() && !track.hasTOF();
+  }
+
   //__________________________________________________
   template <class TBCs, typename TCollisions, typename TTracks, typename TV0s, typename TMCParticles>
   void buildV0s(TCollisions const& collisions, TV0s const& v0s, TTracks const& tracks, TMCParticles const& mcParticles)
@@ -1613,6 +1675,38 @@ struct StrangenessBuilder {
       mcParticleIsReco.resize(mcParticles.size(), false);
     }
 
+    // parallel building: candidates are built by the pool chunk by chunk, then written out in order below
+    // V0s with TPC-only tracks to be moved are left to the serial loop, the drift manager not being thread safe
+    const bool usePool = helperPool.size() > 1;
+    std::size_t chunkBegin = 0, chunkEnd = 0;
+    poolV0s.resize(usePool ? PoolChunkSize : 0);
+    auto prebuildV0 = [&](o2::pwglf::strangenessBuilderHelper& helper, std::size_t iv0) {
+      const auto& v0 = v0List[sorted_v0[iv0]];
+      if (!mEnabledTables[kV0CoresBase] && v0Map[iv0] == -2) {
+        return;
+      }
+      auto const& posTrack = tracks.rawIteratorAt(v0.posTrackId);
+      auto const& negTrack = tracks.rawIteratorAt(v0.negTrackId);
+      if (v0BuilderOpts.moveTPCOnlyTracks && (isTPCOnly(posTrack) || isTPCOnly(negTrack))) {
+        return;
+      }
+      float pvX = 0.0f, pvY = 0.0f, pvZ = 0.0f;
+      if (v0.collisionId >= 0) {
+        auto const& collision = collisions.rawIteratorAt(v0.collisionId);
+        pvX = collision.posX();
+        pvY = collision.posY();
+        pvZ = collision.posZ();
+      }
+      auto posTrackPar = getTrackParCov(posTrack);
+      auto negTrackPar = getTrackParCov(negTrack);
+      if (!helper.buildV0Candidate(v0.collisionId, pvX, pvY, pvZ, posTrack, negTrack, posTrackPar, negTrackPar, v0.isCollinearV0, mEnabledTables[kV0Covs], v0BuilderOpts.generatePhotonCandidates)) {
+        poolStatuses[iv0 - chunkBegin] = kPrebuildFailed;
+        return;
+      }
+      poolV0s[iv0 - chunkBegin] = helper.v0;
+      poolStatuses[iv0 - chunkBegin] = kPrebuilt;
+    };
+
     int nV0s = 0;
     // Loops over all V0s in the time frame
     histos.fill(HIST("hInputStatistics"), kV0CoresBase, v0s.size());
@@ -1625,6 +1719,12 @@ struct StrangenessBuilder {
         continue;
       }
 
+      if (usePool && iv0 >= chunkEnd) {
+        chunkBegin = iv0;
+        chunkEnd = std::min(iv0 + PoolChunkSize, v0List.size());
+        runInPool(chunkBegin, chunkEnd, prebuildV0);
+      }
+
       // Get tracks and generate candidate
       // if collisionId positive: get vertex, negative: origin
       // could be replaced by mean vertex (but without much benefit...)
@@ -1638,41 +1738,50 @@ struct StrangenessBuilder {
       auto const& posTrack = tracks.rawIteratorAt(v0.posTrackId);
       auto const& negTrack = tracks.rawIteratorAt(v0.negTrackId);
 
-      auto posTrackPar = getTrackParCov(posTrack);
-      auto negTrackPar = getTrackParCov(negTrack);
-
-      // handle TPC-only tracks properly (photon conversions)
-      if (v0BuilderOpts.moveTPCOnlyTracks) {
-        bool isPosTPCOnly = (posTrack.hasTPC() && !posTrack.hasITS() && !posTrack.hasTRD() && !posTrack.hasTOF());
-        if (isPosTPCOnly) {
-          // Nota bene: positive is TPC-only -> this entire V0 merits treatment as photon candidate
-          posTrackPar.setPID(o2::track::PID::Electron);
-          negTrackPar.setPID(o2::track::PID::Electron);
-
-          auto const& collision = collisions.rawIteratorAt(v0.collisionId);
-          if (!mVDriftMgr.moveTPCTrack<TBCs, TCollisions>(collision, posTrack, posTrackPar)) {
-            products.v0dataLink(-1, -1);
-            continue;
+      const uint8_t prebuildStatus = usePool ? poolStatuses[iv0 - chunkBegin] : kNotPrebuilt;
+      if (prebuildStatus == kPrebuildFailed) {
+        products.v0dataLink(-1, -1);
+        continue;
+      }
+      if (prebuildStatus == kPrebuilt) {
+        straHelper.v0 = poolV0s[iv0 - chunkBegin];
+      } else {
+        auto posTrackPar = getTrackParCov(posTrack);
+        auto negTrackPar = getTrackParCov(negTrack);
+
+        // handle TPC-only tracks properly (photon conversions)
+        if (v0BuilderOpts.moveTPCOnlyTracks) {
+          bool isPosTPCOnly = isTPCOnly(posTrack);
+          if (isPosTPCOnly) {
+            // Nota bene: positive is TPC-only -> this entire V0 merits treatment as photon candidate
+            posTrackPar.setPID(o2::track::PID::Electron);
+            negTrackPar.setPID(o2::track::PID::Electron);
+
+            auto const& collision = collisions.rawIteratorAt(v0.collisionId);
+            if (!mVDriftMgr.moveTPCTrack<TBCs, TCollisions>(collision, posTrack, posTrackPar)) {
+              products.v0dataLink(-1, -1);
+              continue;
+            }
           }
-        }
 
-        bool isNegTPCOnly = (negTrack.hasTPC() && !negTrack.hasITS() && !negTrack.hasTRD() && !negTrack.hasTOF());
-        if (isNegTPCOnly) {
-          // Nota bene: negative is TPC-only -> this entire V0 merits treatment as photon candidate
-          posTrackPar.setPID(o2::track::PID::Electron);
-          negTrackPar.setPID(o2::track::PID::Electron);
+          bool isNegTPCOnly = isTPCOnly(negTrack);
+          if (isNegTPCOnly) {
+            // Nota bene: negative is TPC-only -> this entire V0 merits treatment as photon candidate
+            posTrackPar.setPID(o2::track::PID::Electron);
+            negTrackPar.setPID(o2::track::PID::Electron);
 
-          auto const& collision = collisions.rawIteratorAt(v0.collisionId);
-          if (!mVDriftMgr.moveTPCTrack<TBCs, TCollisions>(collision, negTrack, negTrackPar)) {
-            products.v0dataLink(-1, -1);
-            continue;
+            auto const& collision = collisions.rawIteratorAt(v0.collisionId);
+            if (!mVDriftMgr.moveTPCTrack<TBCs, TCollisions>(collision, negTrack, negTrackPar)) {
+              products.v0dataLink(-1, -1);
+              continue;
+            }
           }
         }
-      }
 
-      if (!straHelper.buildV0Candidate(v0.collisionId, pvX, pvY, pvZ, posTrack, negTrack, posTrackPar, negTrackPar, v0.isCollinearV0, mEnabledTables[kV0Covs], v0BuilderOpts.generatePhotonCandidates)) {
-        products.v0dataLink(-1, -1);
-        continue;
+        if (!straHelper.buildV0Candidate(v0.collisionId, pvX, pvY, pvZ, posTrack, negTrack, posTrackPar, negTrackPar, v0.isCollinearV0, mEnabledTables[kV0Covs], v0BuilderOpts.generatePhotonCandidates)) {
+          products.v0dataLink(-1, -1);
+          continue;
+        }
       }
       if constexpr (requires { posTrack.tpcNSigmaEl(); }) {
         if (preSelectOpts.preselectOnlyDesiredV0s) {
@@ -2152,14 +2261,9 @@ struct StrangenessBuilder {
     if (!mEnabledTables[kStoredCascCores]) {
       return; // don't do if no request for cascades in place
     }
-    int nCascades = 0;
-    // Loops over all cascades in the time frame
-    histos.fill(HIST("hInputStatistics"), kStoredCascCores, cascades.size());
-    for (size_t icascade = 0; icascade < cascades.size(); icascade++) {
-      // Get tracks and generate candidate
+    // build cascade icascade with the given helper: straHelper in the serial loop or one of the pool
+    auto buildCascade = [&](o2::pwglf::strangenessBuilderHelper& helper, std::size_t icascade) {
       auto const& cascade = cascades[sorted_cascade[icascade]];
-      // if collisionId positive: get vertex, negative: origin
-      // could be replaced by mean vertex (but without much benefit...)
       float pvX = 0.0f, pvY = 0.0f, pvZ = 0.0f;
       if (cascade.collisionId >= 0) {
         auto const& collision = collisions.rawIteratorAt(cascade.collisionId);
@@ -2175,41 +2279,63 @@ struct StrangenessBuilder {
         // additional minimization step is redone. It consumes less
         // CPU at the cost of more memory. Since memory is a more
         // limited commodity, this isn't the default option.
-
-        // check if cached - if not, skip
         if (cascade.v0Id < 0 || v0Map[cascade.v0Id] < 0) {
-          // this V0 hasn't been stored / cached
-          products.cascdataLink(-1);
-          interlinks.cascadeToCascCores.push_back(-1);
-          continue; // didn't work out, skip
+          return false; // this V0 hasn't been stored / cached
         }
+        return helper.buildCascadeCandidate(cascade.collisionId, pvX, pvY, pvZ, v0sFromCascades[v0Map[cascade.v0Id]], posTrack, negTrack, bachTrack,
+                                            mEnabledTables[kCascBBs], cascadeBuilderOpts.useCascadeMomentumAtPrimVtx, mEnabledTables[kCascCovs]);
+      }
+      // this processing path generates the entire cascade
+      // from tracks, without any need to have V0s generated.
+      return helper.buildCascadeCandidate(cascade.collisionId, pvX, pvY, pvZ, posTrack, negTrack, bachTrack,
+                                          mEnabledTables[kCascBBs], cascadeBuilderOpts.useCascadeMomentumAtPrimVtx, mEnabledTables[kCascCovs]);
+    };
+    const bool usePool = helperPool.size() > 1;
+    std::size_t chunkBegin = 0, chunkEnd = 0;
+    poolCascades.resize(usePool ? PoolChunkSize : 0);
+    auto prebuildCascade = [&](o2::pwglf::strangenessBuilderHelper& helper, std::size_t icascade) {
+      if (!buildCascade(helper, icascade)) {
+        poolStatuses[icascade - chunkBegin] = kPrebuildFailed;
+        return;
+      }
+      poolCascades[icascade - chunkBegin] = helper.cascade;
+      poolStatuses[icascade - chunkBegin] = kPrebuilt;
+    };
 
-        if (!straHelper.buildCascadeCandidate(cascade.collisionId, pvX, pvY, pvZ,
-                                              v0sFromCascades[v0Map[cascade.v0Id]],
-                                              posTrack,
-                                              negTrack,
-                                              bachTrack,
-                                              mEnabledTables[kCascBBs],
-                                              cascadeBuilderOpts.useCascadeMomentumAtPrimVtx,
-                                              mEnabledTables[kCascCovs])) {
-          products.cascdataLink(-1);
-          interlinks.cascadeToCascCores.push_back(-1);
-          continue; // didn't work out, skip
-        }
-      } else {
-        // this processing path generates the entire cascade
-        // from tracks, without any need to have V0s generated.
-        if (!straHelper.buildCascadeCandidate(cascade.collisionId, pvX, pvY, pvZ,
-                                              posTrack,
-                                              negTrack,
-                                              bachTrack,
-                                              mEnabledTables[kCascBBs],
-                                              cascadeBuilderOpts.useCascadeMomentumAtPrimVtx,
-                                              mEnabledTables[kCascCovs])) {
+    int nCascades = 0;
+    // Loops over all cascades in the time frame
+    histos.fill(HIST("hInputStatistics"), kStoredCascCores, cascades.size());
+    for (size_t icascade = 0; icascade < cascades.size(); icascade++) {
+      if (usePool && icascade >= chunkEnd) {
+        chunkBegin = icascade;
+        chunkEnd = std::min(icascade + PoolChunkSize, cascades.size());
+        runInPool(chunkBegin, chunkEnd, prebuildCascade);
+      }
+      // Get tracks and generate candidate
+      auto const& cascade = cascades[sorted_cascade[icascade]];
+      // if collisionId positive: get vertex, negative: origin
+      // could be replaced by mean vertex (but without much benefit...)
+      float pvX = 0.0f, pvY = 0.0f, pvZ = 0.0f;
+      if (cascade.collisionId >= 0) {
+        auto const& collision = collisions.rawIteratorAt(cascade.collisionId);
+        pvX = collision.posX();
+        pvY = collision.posY();
+        pvZ = collision.posZ();
+      }
+      auto const& posTrack = tracks.rawIteratorAt(cascade.posTrackId);
+      auto const& negTrack = tracks.rawIteratorAt(cascade.negTrackId);
+      auto const& bachTrack = tracks.rawIteratorAt(cascade.bachTrackId);
+      if (usePool) {
+        if (poolStatuses[icascade - chunkBegin] != kPrebuilt) {
           products.cascdataLink(-1);
           interlinks.cascadeToCascCores.push_back(-1);
           continue; // didn't work out, skip
         }
+        straHelper.cascade = poolCascades[icascade - chunkBegin];
+      } else if (!buildCascade(straHelper, icascade)) {
+        products.cascdataLink(-1);
+        interlinks.cascadeToCascCores.push_back(-1);
+        continue; // didn't work out, skip
       }
       nCascades++;
 
@@ -2809,6 +2935,13 @@ struct StrangenessBuilder {
     if (!initCCDB(bcs, collisions))
       return;
 
+    // prong DCAs are only valid within this DF
+    straHelper.clearProngDCACache();
+    helperPool.clear();
+    if (nThreads > 1) {
+      helperPool.assign(nThreads, straHelper);
+    }
+
     // reset vectors for cascade interlinks
     resetInterlinks();
 
@@ -41,6 +41,7 @@
 
 #include <TPDGCode.h>
 
+#include <array>
 #include <string>
 #include <vector>
 
@@ -299,6 +300,19 @@ struct HStrangeCorrelation {
 
   std::vector<std::vector<float>> axisRanges;
 
+  // Trigger-independent properties of an associated particle, evaluated once per call of the
+  // correlation functions instead of once per trigger-associated pair
+  struct AssocProperties {
+    bool passesCandidateCuts = false;  // systematic / Pb-Pb candidate selections
+    bool passesTrackQuality = false;   // daughter (or track) quality
+    uint64_t selMap = 0;               // selection bitmap of V0s and cascades
+    std::array<float, 4> efficiency{}; // per species, 1 if no correction or zero efficiency
+    std::array<float, 4> efficiencyError{};
+    float purity = 1.0f;
+    float purityError = 0.0f;
+  };
+  std::vector<AssocProperties> assocProperties; // one entry per associated particle, reused across calls
+
   const float ctauxi = 4.91;     // from PDG
   const float ctauomega = 2.461; // from PDG
 
@@ -652,6 +666,61 @@ struct HStrangeCorrelation {
   }
   void fillCorrelationsV0(aod::TriggerTracks const& triggers, aod::AssocV0s const& assocs, bool mixing, float pvx, float pvy, float pvz, float mult, double bField)
   {
+    TH2F* hEfficiencyV0[3] = {hEfficiencyK0Short, hEfficiencyLambda, hEfficiencyAntiLambda};
+    TH2F* hEfficiencyUncertaintyV0[3] = {hEfficiencyUncertaintyK0Short, hEfficiencyUncertaintyLambda, hEfficiencyUncertaintyAntiLambda};
+    THnF* hEfficiencyV0MultVsPhi[3] = {hEfficiencyK0ShortMultVsPhi, hEfficiencyLambdaMultVsPhi, hEfficiencyAntiLambdaMultVsPhi};
+
+    assocProperties.resize(assocs.size());
+    size_t iAssoc = 0;
+    for (auto const& assocCandidate : assocs) {
+      auto& properties = assocProperties[iAssoc++];
+      properties = AssocProperties{};
+      auto assoc = assocCandidate.v0Core_as<V0DatasWithoutTrackX>();
+
+      //---] syst cuts [---
+      if (masterConfigurations.doPPAnalysis) {
+        properties.passesCandidateCuts = !(assoc.v0radius() < systCuts.v0RadiusMin || assoc.v0radius() > systCuts.v0RadiusMax ||
+                                           std::abs(assoc.dcapostopv()) < systCuts.dcapostopv || std::abs(assoc.dcanegtopv()) < systCuts.dcanegtopv ||
+                                           assoc.v0cosPA() < systCuts.v0cospa || assoc.dcaV0daughters() > systCuts.dcaV0dau);
+      } else {
+        properties.passesCandidateCuts = v0SelectedPbPb(assoc);
+      }
+      if (!properties.passesCandidateCuts)
+        continue;
+      properties.selMap = v0selectionBitmap(assoc, pvx, pvy, pvz);
+
+      //---] track quality check [---
+      auto postrack = assoc.posTrack_as<TracksComplete>();
+      auto negtrack = assoc.negTrack_as<TracksComplete>();
+      properties.passesTrackQuality = postrack.tpcNClsCrossedRows() >= systCuts.minTPCNCrossedRowsAssociated && negtrack.tpcNClsCrossedRows() >= systCuts.minTPCNCrossedRowsAssociated;
+      if (!properties.passesTrackQuality)
+        continue;
+
+      float ptassoc = assoc.pt();
+      for (int index = 0; index < 3; index++) {
+        float efficiency = 1.0f;
+        float efficiencyError = 0.0f;
+        if (efficiencyFlags.applyEfficiencyCorrection) {
+          if (efficiencyFlags.applyEffAsFunctionOfMultAndPhi) {
+            double bin[4] = {ptassoc, assoc.eta(), assoc.phi(), mult};
+            efficiency = hEfficiencyV0MultVsPhi[index]->GetBinContent(hEfficiencyV0MultVsPhi[index]->GetBin(bin));
+            if (efficiencyFlags.applyEfficiencyPropagation)
+              efficiencyError = hEfficiencyV0MultVsPhi[index]->GetBinError(hEfficiencyV0MultVsPhi[index]->GetBin(bin));
+          } else {
+            efficiency = hEfficiencyV0[index]->Interpolate(ptassoc, assoc.eta());
+            if (efficiencyFlags.applyEfficiencyPropagation)
+              efficiencyError = hEfficiencyUncertaintyV0[index]->Interpolate(ptassoc, assoc.eta());
+          }
+        }
+        if (efficiency == 0) { // check for zero efficiency, do not apply if the case
+          efficiency = 1;
+          efficiencyError = 0;
+        }
+        properties.efficiency[index] = efficiency;
+        properties.efficiencyError[index] = efficiencyError;
+      }
+    }
+
     for (auto const& triggerTrack : triggers) {
       if (masterConfigurations.doTriggPhysicalPrimary && !triggerTrack.mcPhysicalPrimary())
         continue;
@@ -692,19 +761,13 @@ struct HStrangeCorrelation {
       double triggSign = trigg.sign();
       double triggForDeltaPhiStar[] = {trigg.phi(), trigg.pt(), triggSign};
 
+      iAssoc = 0;
       for (auto const& assocCandidate : assocs) {
-        auto assoc = assocCandidate.v0Core_as<V0DatasWithoutTrackX>();
-
-        //---] syst cuts [---
-        if ((masterConfigurations.doPPAnalysis && (assoc.v0radius() < systCuts.v0RadiusMin || assoc.v0radius() > systCuts.v0RadiusMax ||
-                                                   std::abs(assoc.dcapostopv()) < systCuts.dcapostopv || std::abs(assoc.dcanegtopv()) < systCuts.dcanegtopv ||
-                                                   assoc.v0cosPA() < systCuts.v0cospa || assoc.dcaV0daughters() > systCuts.dcaV0dau)))
-          continue;
-
-        if (!masterConfigurations.doPPAnalysis && !v0SelectedPbPb(assoc))
+        const auto& properties = assocProperties[iAssoc++];
+        if (!properties.passesCandidateCuts)
           continue;
-
-        uint64_t selMap = v0selectionBitmap(assoc, pvx, pvy, pvz);
+        auto assoc = assocCandidate.v0Core_as<V0DatasWithoutTrackX>();
+        uint64_t selMap = properties.selMap;
 
         //---] removing autocorrelations [---
         auto postrack = assoc.posTrack_as<TracksComplete>();
@@ -721,7 +784,7 @@ struct HStrangeCorrelation {
         }
 
         //---] track quality check [---
-        if (postrack.tpcNClsCrossedRows() < systCuts.minTPCNCrossedRowsAssociated || negtrack.tpcNClsCrossedRows() < systCuts.minTPCNCrossedRowsAssociated)
+        if (!properties.passesTrackQuality)
           continue;
 
         float deltaphi = computeDeltaPhi(trigg.phi(), assoc.phi());
@@ -737,23 +800,6 @@ struct HStrangeCorrelation {
         if (ptassoc < axisRanges[2][0] || ptassoc > axisRanges[2][1])
           continue;
 
-        TH2F* hEfficiencyV0[3];
-        TH2F* hEfficiencyUncertaintyV0[3];
-        THnF* hEfficiencyV0MultVsPhi[3];
-        if (efficiencyFlags.applyEffAsFunctionOfMultAndPhi) {
-          hEfficiencyV0MultVsPhi[0] = hEfficiencyK0ShortMultVsPhi;
-          hEfficiencyV0MultVsPhi[1] = hEfficiencyLambdaMultVsPhi;
-          hEfficiencyV0MultVsPhi[2] = hEfficiencyAntiLambdaMultVsPhi;
-        } else {
-          hEfficiencyV0[0] = hEfficiencyK0Short;
-          hEfficiencyV0[1] = hEfficiencyLambda;
-          hEfficiencyV0[2] = hEfficiencyAntiLambda;
-
-          hEfficiencyUncertaintyV0[0] = hEfficiencyUncertaintyK0Short;
-          hEfficiencyUncertaintyV0[1] = hEfficiencyUncertaintyLambda;
-          hEfficiencyUncertaintyV0[2] = hEfficiencyUncertaintyAntiLambda;
-        }
-
         float etaWeight = 1;
         if (systCuts.doOnTheFlyFlattening) {
           float preWeight = 1 - std::abs(deltaeta) / 1.6;
@@ -778,25 +824,9 @@ struct HStrangeCorrelation {
 
         static_for<0, 2>([&](auto i) {
           constexpr int Index = i.value;
-          float efficiency = 1.0f;
+          const float efficiency = properties.efficiency[Index];
+          const float efficiencyError = properties.efficiencyError[Index];
           float totalEffUncert = 0.0;
-          float efficiencyError = 0.0f;
-          if (efficiencyFlags.applyEfficiencyCorrection) {
-            if (efficiencyFlags.applyEffAsFunctionOfMultAndPhi) {
-              double bin[4] = {ptassoc, assoc.eta(), assoc.phi(), mult};
-              efficiency = hEfficiencyV0MultVsPhi[Index]->GetBinContent(hEfficiencyV0MultVsPhi[Index]->GetBin(bin));
-              if (efficiencyFlags.applyEfficiencyPropagation)
-                efficiencyError = hEfficiencyV0MultVsPhi[Index]->GetBinError(hEfficiencyV0MultVsPhi[Index]->GetBin(bin));
-            } else {
-              efficiency = hEfficiencyV0[Index]->Interpolate(ptassoc, assoc.eta());
-              if (efficiencyFlags.applyEfficiencyPropagation)
-                efficiencyError = hEfficiencyUncertaintyV0[Index]->Interpolate(ptassoc, assoc.eta());
-            }
-          }
-          if (efficiency == 0) { // check for zero efficiency, do not apply if the case
-            efficiency = 1;
-            efficiencyError = 0;
-          }
           if (efficiencyFlags.applyEfficiencyPropagation) {
             totalEffUncert = std::sqrt(std::pow(efficiencyTrigg * efficiencyError, 2) + std::pow(efficiencyTriggError * efficiency, 2));
           }
@@ -878,6 +908,69 @@ struct HStrangeCorrelation {
 
   void fillCorrelationsCascade(aod::TriggerTracks const& triggers, aod::AssocCascades const& assocs, bool mixing, float pvx, float pvy, float pvz, float mult, double bField)
   {
+    TH2F* hEfficiencyCascade[4] = {hEfficiencyXiMinus, hEfficiencyXiPlus, hEfficiencyOmegaMinus, hEfficiencyOmegaPlus};
+    TH2F* hEfficiencyUncertaintyCascade[4] = {hEfficiencyUncertaintyXiMinus, hEfficiencyUncertaintyXiPlus, hEfficiencyUncertaintyOmegaMinus, hEfficiencyUncertaintyOmegaPlus};
+    THnF* hEfficiencyCascadeMultVsPhi[4] = {hEfficiencyXiMinusMultVsPhi, hEfficiencyXiPlusMultVsPhi, hEfficiencyOmegaMinusMultVsPhi, hEfficiencyOmegaPlusMultVsPhi};
+
+    assocProperties.resize(assocs.size());
+    size_t iAssoc = 0;
+    for (auto const& assocCandidate : assocs) {
+      auto& properties = assocProperties[iAssoc++];
+      properties = AssocProperties{};
+      auto assoc = assocCandidate.cascData();
+
+      //---] syst cuts [---
+      if (masterConfigurations.doPPAnalysis) {
+        properties.passesCandidateCuts = !(std::abs(assoc.dcapostopv()) < systCuts.dcapostopv ||
+                                           std::abs(assoc.dcanegtopv()) < systCuts.dcanegtopv ||
+                                           std::abs(assoc.dcabachtopv()) < systCuts.cascDcabachtopv ||
+                                           assoc.dcaV0daughters() > systCuts.dcaV0dau ||
+                                           assoc.dcacascdaughters() > systCuts.cascDcacascdau ||
+                                           assoc.v0cosPA(pvx, pvy, pvz) < systCuts.v0cospa ||
+                                           assoc.casccosPA(pvx, pvy, pvz) < systCuts.cascCospa ||
+                                           assoc.cascradius() < systCuts.cascRadius ||
+                                           std::abs(assoc.dcav0topv(pvx, pvy, pvz)) < systCuts.cascMindcav0topv ||
+                                           std::abs(assoc.mLambda() - o2::constants::physics::MassLambda0) > systCuts.cascV0masswindow);
+      } else {
+        properties.passesCandidateCuts = cascadeSelectedPbPb(assoc, pvx, pvy, pvz);
+      }
+      if (!properties.passesCandidateCuts)
+        continue;
+      properties.selMap = cascadeselectionBitmap(assoc, pvx, pvy, pvz);
+
+      //---] track quality check [---
+      auto postrack = assoc.posTrack_as<TracksComplete>();
+      auto negtrack = assoc.negTrack_as<TracksComplete>();
+      auto bachtrack = assoc.bachelor_as<TracksComplete>();
+      properties.passesTrackQuality = postrack.tpcNClsCrossedRows() >= systCuts.minTPCNCrossedRowsAssociated && negtrack.tpcNClsCrossedRows() >= systCuts.minTPCNCrossedRowsAssociated && bachtrack.tpcNClsCrossedRows() >= systCuts.minTPCNCrossedRowsAssociated;
+      if (!properties.passesTrackQuality)
+        continue;
+
+      float ptassoc = assoc.pt();
+      for (int index = 0; index < 4; index++) {
+        float efficiency = 1.0f;
+        float efficiencyError = 0.0f;
+        if (efficiencyFlags.applyEfficiencyCorrection) {
+          if (efficiencyFlags.applyEffAsFunctionOfMultAndPhi) {
+            double bin[4] = {ptassoc, assoc.eta(), assoc.phi(), mult};
+            efficiency = hEfficiencyCascadeMultVsPhi[index]->GetBinContent(hEfficiencyCascadeMultVsPhi[index]->GetBin(bin));
+            if (efficiencyFlags.applyEfficiencyPropagation)
+              efficiencyError = hEfficiencyCascadeMultVsPhi[index]->GetBinError(hEfficiencyCascadeMultVsPhi[index]->GetBin(bin));
+          } else {
+            efficiency = hEfficiencyCascade[index]->Interpolate(ptassoc, assoc.eta());
+            if (efficiencyFlags.applyEfficiencyPropagation)
+              efficiencyError = hEfficiencyUncertaintyCascade[index]->Interpolate(ptassoc, assoc.eta(), assoc.phi());
+          }
+        }
+        if (efficiency == 0) { // check for zero efficiency, do not apply if the case
+          efficiency = 1;
+          efficiencyError = 0;
+        }
+        properties.efficiency[index] = efficiency;
+        properties.efficiencyError[index] = efficiencyError;
+      }
+    }
+
     for (auto const& triggerTrack : triggers) {
       if (masterConfigurations.doTriggPhysicalPrimary && !triggerTrack.mcPhysicalPrimary())
         continue;
@@ -929,24 +1022,13 @@ struct HStrangeCorrelation {
       double triggSign = trigg.sign();
       double triggForDeltaPhiStar[] = {trigg.phi(), trigg.pt(), triggSign};
 
+      iAssoc = 0;
       for (auto const& assocCandidate : assocs) {
-        auto assoc = assocCandidate.cascData();
-
-        //---] syst cuts [---
-        if (masterConfigurations.doPPAnalysis && (std::abs(assoc.dcapostopv()) < systCuts.dcapostopv ||
-                                                  std::abs(assoc.dcanegtopv()) < systCuts.dcanegtopv ||
-                                                  std::abs(assoc.dcabachtopv()) < systCuts.cascDcabachtopv ||
-                                                  assoc.dcaV0daughters() > systCuts.dcaV0dau ||
-                                                  assoc.dcacascdaughters() > systCuts.cascDcacascdau ||
-                                                  assoc.v0cosPA(pvx, pvy, pvz) < systCuts.v0cospa ||
-                                                  assoc.casccosPA(pvx, pvy, pvz) < systCuts.cascCospa ||
-                                                  assoc.cascradius() < systCuts.cascRadius ||
-                                                  std::abs(assoc.dcav0topv(pvx, pvy, pvz)) < systCuts.cascMindcav0topv ||
-                                                  std::abs(assoc.mLambda() - o2::constants::physics::MassLambda0) > systCuts.cascV0masswindow))
+        const auto& properties = assocProperties[iAssoc++];
+        if (!properties.passesCandidateCuts)
           continue;
-        if (!masterConfigurations.doPPAnalysis && !cascadeSelectedPbPb(assoc, pvx, pvy, pvz))
-          continue;
-        uint64_t cascselMap = cascadeselectionBitmap(assoc, pvx, pvy, pvz);
+        auto assoc = assocCandidate.cascData();
+        uint64_t cascselMap = properties.selMap;
         //---] removing autocorrelations [---
         auto postrack = assoc.posTrack_as<TracksComplete>();
         auto negtrack = assoc.negTrack_as<TracksComplete>();
@@ -977,7 +1059,7 @@ struct HStrangeCorrelation {
         }
         double assocForDeltaPhiStar[] = {phiProton, ptProton, signProton};
         //---] track quality check [---
-        if (postrack.tpcNClsCrossedRows() < systCuts.minTPCNCrossedRowsAssociated || negtrack.tpcNClsCrossedRows() < systCuts.minTPCNCrossedRowsAssociated || bachtrack.tpcNClsCrossedRows() < systCuts.minTPCNCrossedRowsAssociated)
+        if (!properties.passesTrackQuality)
           continue;
 
         float deltaphi = computeDeltaPhi(trigg.phi(), assoc.phi());
@@ -993,26 +1075,6 @@ struct HStrangeCorrelation {
         if (ptassoc < axisRanges[2][0] || ptassoc > axisRanges[2][1])
           continue;
 
-        TH2F* hEfficiencyCascade[4];
-        THnF* hEfficiencyCascadeMultVsPhi[4];
-        if (efficiencyFlags.applyEffAsFunctionOfMultAndPhi) {
-          hEfficiencyCascadeMultVsPhi[0] = hEfficiencyXiMinusMultVsPhi;
-          hEfficiencyCascadeMultVsPhi[1] = hEfficiencyXiPlusMultVsPhi;
-          hEfficiencyCascadeMultVsPhi[2] = hEfficiencyOmegaMinusMultVsPhi;
-          hEfficiencyCascadeMultVsPhi[3] = hEfficiencyOmegaPlusMultVsPhi;
-        } else {
-          hEfficiencyCascade[0] = hEfficiencyXiMinus;
-          hEfficiencyCascade[1] = hEfficiencyXiPlus;
-          hEfficiencyCascade[2] = hEfficiencyOmegaMinus;
-          hEfficiencyCascade[3] = hEfficiencyOmegaPlus;
-        }
-
-        TH2F* hEfficiencyUncertaintyCascade[4];
-        hEfficiencyUncertaintyCascade[0] = hEfficiencyUncertaintyXiMinus;
-        hEfficiencyUncertaintyCascade[1] = hEfficiencyUncertaintyXiPlus;
-        hEfficiencyUncertaintyCascade[2] = hEfficiencyUncertaintyOmegaMinus;
-        hEfficiencyUncertaintyCascade[3] = hEfficiencyUncertaintyOmegaPlus;
-
         float etaWeight = 1;
         if (systCuts.doOnTheFlyFlattening) {
           float preWeight = 1 - std::abs(deltaeta) / 1.6;
@@ -1021,25 +1083,9 @@ struct HStrangeCorrelation {
 
         static_for<0, 3>([&](auto i) {
           constexpr int Index = i.value;
-          float efficiency = 1.0f;
+          const float efficiency = properties.efficiency[Index];
+          const float efficiencyError = properties.efficiencyError[Index];
           float totalEffUncert = 0.0;
-          float efficiencyError = 0.0f;
-          if (efficiencyFlags.applyEfficiencyCorrection) {
-            if (efficiencyFlags.applyEffAsFunctionOfMultAndPhi) {
-              double bin[4] = {ptassoc, assoc.eta(), assoc.phi(), mult};
-              efficiency = hEfficiencyCascadeMultVsPhi[Index]->GetBinContent(hEfficiencyCascadeMultVsPhi[Index]->GetBin(bin));
-              if (efficiencyFlags.applyEfficiencyPropagation)
-                efficiencyError = hEfficiencyCascadeMultVsPhi[Index]->GetBinError(hEfficiencyCascadeMultVsPhi[Index]->GetBin(bin));
-            } else {
-              efficiency = hEfficiencyCascade[Index]->Interpolate(ptassoc, assoc.eta());
-              if (efficiencyFlags.applyEfficiencyPropagation)
-                efficiencyError = hEfficiencyUncertaintyCascade[Index]->Interpolate(ptassoc, assoc.eta(), assoc.phi());
-            }
-          }
-          if (efficiency == 0) { // check for zero efficiency, do not apply if the case
-            efficiency = 1;
-            efficiencyError = 0;
-          }
           if (efficiencyFlags.applyEfficiencyPropagation) {
             totalEffUncert = std::sqrt(std::pow(efficiencyTrigg * efficiencyError, 2) + std::pow(efficiencyTriggError * efficiency, 2));
           }
@@ -1089,6 +1135,59 @@ struct HStrangeCorrelation {
   template <typename TTriggers, typename THadrons>
   void fillCorrelationsHadron(TTriggers const& triggers, THadrons const& assocs, bool mixing, float pvz, float mult, double bField)
   {
+    assocProperties.resize(assocs.size());
+    size_t iAssoc = 0;
+    for (auto const& assocTrack : assocs) {
+      auto& properties = assocProperties[iAssoc++];
+      properties = AssocProperties{};
+      auto assoc = assocTrack.template track_as<TracksComplete>();
+
+      //---] track quality check [---
+      properties.passesCandidateCuts = true;
+      properties.passesTrackQuality = isValidAssocHadron(assoc) && (!doAssocPhysicalPrimary || assocTrack.mcPhysicalPrimary());
+      if (!properties.passesTrackQuality)
+        continue;
+
+      float ptassoc = assoc.pt();
+      float efficiency = 1;
+      float efficiencyUncertainty = 0.0f;
+      if (efficiencyFlags.applyEfficiencyCorrection) {
+        if constexpr (requires { assocTrack.nSigmaTPCPi(); }) {
+          efficiency = hEfficiencyPion->Interpolate(ptassoc, assoc.eta());
+          if (efficiencyFlags.applyEfficiencyPropagation)
+            efficiencyUncertainty = hEfficiencyUncertaintyPion->Interpolate(ptassoc, assoc.eta());
+        } else {
+          if (efficiencyFlags.applyEffAsFunctionOfMult)
+            efficiency = hEfficiencyHadronMult->Interpolate(ptassoc, assoc.eta(), mult);
+          else
+            efficiency = hEfficiencyHadron->Interpolate(ptassoc, assoc.eta());
+          if (efficiencyFlags.applyPurityHadron) {
+            if (efficiencyFlags.applyEffAsFunctionOfMult)
+              properties.purity = hPurityHadronMult->Interpolate(ptassoc, mult);
+            else
+              properties.purity = hPurityHadron->Interpolate(ptassoc);
+          }
+          if (efficiencyFlags.applyEfficiencyPropagation) {
+            if (efficiencyFlags.applyEffAsFunctionOfMult)
+              efficiencyUncertainty = hEfficiencyUncertaintyHadronMult->Interpolate(ptassoc, assoc.eta(), mult);
+            else
+              efficiencyUncertainty = hEfficiencyUncertaintyHadron->Interpolate(ptassoc, assoc.eta());
+            if (efficiencyFlags.applyPurityHadron) {
+              if (efficiencyFlags.applyEffAsFunctionOfMult)
+                properties.purityError = hPurityUncertaintyHadronMult->Interpolate(ptassoc, mult);
+              else
+                properties.purityError = hPurityUncertaintyHadron->Interpolate(ptassoc);
+            }
+          }
+        }
+      }
+      if (efficiency == 0) { // check for zero efficiency, do not apply if the case
+        efficiency = 1;
+        efficiencyUncertainty = 0.0;
+      }
+      properties.efficiency[0] = efficiency;
+      properties.efficiencyError[0] = efficiencyUncertainty;
+    }
 
     for (auto const& triggerTrack : triggers) {
       if (masterConfigurations.doTriggPhysicalPrimary && !triggerTrack.mcPhysicalPrimary())
@@ -1137,7 +1236,9 @@ struct HStrangeCorrelation {
       }
       double triggSign = trigg.sign();
       double triggForDeltaPhiStar[] = {trigg.phi(), trigg.pt(), triggSign};
+      iAssoc = 0;
       for (auto const& assocTrack : assocs) {
+        const auto& properties = assocProperties[iAssoc++];
         auto assoc = assocTrack.template track_as<TracksComplete>();
 
         //---] removing autocorrelations [---
@@ -1151,11 +1252,8 @@ struct HStrangeCorrelation {
           }
         }
         //---] track quality check [---
-        if (!isValidAssocHadron(assoc))
-          continue;
-        if (doAssocPhysicalPrimary && !assocTrack.mcPhysicalPrimary()) {
+        if (!properties.passesTrackQuality)
           continue;
-        }
         float deltaphi = computeDeltaPhi(trigg.phi(), assoc.phi());
         float deltaeta = trigg.eta() - assoc.eta();
         float ptassoc = assoc.pt();
@@ -1178,46 +1276,12 @@ struct HStrangeCorrelation {
         if (ptassoc < axisRanges[2][0] || ptassoc > axisRanges[2][1])
           continue;
 
-        float efficiency = 1;
-        float purity = 1.0f;
-        float purityUncertainty = 0.0f;
+        const float efficiency = properties.efficiency[0];
+        const float efficiencyUncertainty = properties.efficiencyError[0];
+        const float purity = properties.purity;
+        const float purityUncertainty = properties.purityError;
         float totalEffUncert = 0.0;
-        float efficiencyUncertainty = 0.0f;
         float totalPurityUncert = 0.0;
-        if (efficiencyFlags.applyEfficiencyCorrection) {
-          if constexpr (requires { assocTrack.nSigmaTPCPi(); }) {
-            efficiency = hEfficiencyPion->Interpolate(ptassoc, assoc.eta());
-            if (efficiencyFlags.applyEfficiencyPropagation)
-              efficiencyUncertainty = hEfficiencyUncertaintyPion->Interpolate(ptassoc, assoc.eta());
-          } else {
-            if (efficiencyFlags.applyEffAsFunctionOfMult)
-              efficiency = hEfficiencyHadronMult->Interpolate(ptassoc, assoc.eta(), mult);
-            else
-              efficiency = hEfficiencyHadron->Interpolate(ptassoc, assoc.eta());
-            if (efficiencyFlags.applyPurityHadron) {
-              if (efficiencyFlags.applyEffAsFunctionOfMult)
-                purity = hPurityHadronMult->Interpolate(ptassoc, mult);
-              else
-                purity = hPurityHadron->Interpolate(ptassoc);
-            }
-            if (efficiencyFlags.applyEfficiencyPropagation) {
-              if (efficiencyFlags.applyEffAsFunctionOfMult)
-                efficiencyUncertainty = hEfficiencyUncertaintyHadronMult->Interpolate(ptassoc, assoc.eta(), mult);
-              else
-                efficiencyUncertainty = hEfficiencyUncertaintyHadron->Interpolate(ptassoc, assoc.eta());
-              if (efficiencyFlags.applyPurityHadron) {
-                if (efficiencyFlags.applyEffAsFunctionOfMult)
-                  purityUncertainty = hPurityUncertaintyHadronMult->Interpolate(ptassoc, mult);
-                else
-                  purityUncertainty = hPurityUncertaintyHadron->Interpolate(ptassoc);
-              }
-            }
-          }
-        }
-        if (efficiency == 0) { // check for zero efficiency, do not apply if the case
-          efficiency = 1;
-          efficiencyUncertainty = 0.0;
-        }
         if (efficiencyFlags.applyEfficiencyPropagation) {
           totalEffUncert = std::sqrt(std::pow(efficiencyTrigger * efficiencyUncertainty, 2) + std::pow(efficiencyTriggerError * efficiency, 2));
           totalPurityUncert = std::sqrt(std::pow(purityTrigger * purityUncertainty, 2) + std::pow(purity * purityTriggerError, 2));
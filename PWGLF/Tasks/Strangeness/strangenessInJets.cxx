@@ -63,6 +63,7 @@
 #include <fastjet/tools/JetMedianBackgroundEstimator.hh>
 #include <fastjet/tools/Subtractor.hh>
 
+#include <array>
 #include <cmath>
 #include <string>
 #include <vector>
@@ -80,25 +81,30 @@ using DaughterTracks = soa::Join<aod::Tracks, aod::TracksIU, aod::TracksExtra, a
                                  aod::pidTOFFullPi, aod::pidTOFFullKa, aod::pidTOFFullPr>;
 using DaughterTracksMC = soa::Join<DaughterTracks, aod::McTrackLabels>;
 
+// Directions of a jet axis and of its two perpendicular cones, computed once per jet
+struct JetAndUeAxes {
+  JetAndUeAxes(const TVector3& jet, const TVector3& ue1, const TVector3& ue2)
+    : etaJet(jet.Eta()), phiJet(jet.Phi()), etaUe1(ue1.Eta()), phiUe1(ue1.Phi()), etaUe2(ue2.Eta()), phiUe2(ue2.Phi())
+  {
+  }
+  double etaJet, phiJet;
+  double etaUe1, phiUe1;
+  double etaUe2, phiUe2;
+};
+
 struct ParticlePositionWithRespectToJet {
   ParticlePositionWithRespectToJet(const float px, const float py, const float pz,
                                    const TVector3& jet,
                                    const TVector3& ue1,
                                    const TVector3& ue2)
+    : ParticlePositionWithRespectToJet(TVector3(px, py, pz).Eta(), TVector3(px, py, pz).Phi(), JetAndUeAxes{jet, ue1, ue2})
+  {
+  }
+  ParticlePositionWithRespectToJet(const double eta, const double phi, const JetAndUeAxes& axes)
   {
-    const TVector3 candidateDirection(px, py, pz);
-    const double deltaEtaJet = candidateDirection.Eta() - jet.Eta();
-    const double deltaPhiJet = getDeltaPhi(candidateDirection.Phi(), jet.Phi());
-    const double deltaRjet = std::sqrt(deltaEtaJet * deltaEtaJet + deltaPhiJet * deltaPhiJet);
-    const double deltaEtaUe1 = candidateDirection.Eta() - ue1.Eta();
-    const double deltaPhiUe1 = getDeltaPhi(candidateDirection.Phi(), ue1.Phi());
-    const double deltaRue1 = std::sqrt(deltaEtaUe1 * deltaEtaUe1 + deltaPhiUe1 * deltaPhiUe1);
-    const double deltaEtaUe2 = candidateDirection.Eta() - ue2.Eta();
-    const double deltaPhiUe2 = getDeltaPhi(candidateDirection.Phi(), ue2.Phi());
-    const double deltaRue2 = std::sqrt(deltaEtaUe2 * deltaEtaUe2 + deltaPhiUe2 * deltaPhiUe2);
-    mInJet = deltaRjet < mJetRadius;
-    mInUE1 = deltaRue1 < mJetRadius;
-    mInUE2 = deltaRue2 < mJetRadius;
+    mInJet = isInCone(eta, phi, axes.etaJet, axes.phiJet);
+    mInUE1 = isInCone(eta, phi, axes.etaUe1, axes.phiUe1);
+    mInUE2 = isInCone(eta, phi, axes.etaUe2, axes.phiUe2);
   }
   bool isInJet() const { return mInJet; }
   bool isInUE1() const { return mInUE1; }
@@ -106,6 +112,13 @@ struct ParticlePositionWithRespectToJet {
 
   static double mJetRadius;
 
+  static bool isInCone(const double eta, const double phi, const double axisEta, const double axisPhi)
+  {
+    const double deltaEta = eta - axisEta;
+    const double deltaPhi = getDeltaPhi(phi, axisPhi);
+    return std::sqrt(deltaEta * deltaEta + deltaPhi * deltaPhi) < mJetRadius;
+  }
+
   // Delta phi calculation
   static double getDeltaPhi(const double a1, const double a2)
   {
@@ -134,6 +147,37 @@ struct PionsFromK0 {
   int idParent;
 };
 
+// Selected candidates of an event, held as a structure of arrays and shared by all the selected jets of the event
+struct SelectedCandidates {
+  std::vector<double> eta;
+  std::vector<double> phi;
+  std::vector<float> pt;
+  std::array<std::vector<float>, 3> mass; // V0s: K0s, Lambda, AntiLambda; cascades: Xi, Omega
+  std::vector<uint8_t> selection;         // one bit per species passing the selection
+
+  void clear()
+  {
+    eta.clear();
+    phi.clear();
+    pt.clear();
+    for (auto& m : mass) {
+      m.clear();
+    }
+    selection.clear();
+  }
+  void add(const TVector3& direction, const float ptCandidate, const std::array<float, 3>& masses, const uint8_t selectionBits)
+  {
+    eta.push_back(direction.Eta());
+    phi.push_back(direction.Phi());
+    pt.push_back(ptCandidate);
+    for (size_t iMass = 0; iMass < masses.size(); iMass++) {
+      mass[iMass].push_back(masses[iMass]);
+    }
+    selection.push_back(selectionBits);
+  }
+  size_t size() const { return selection.size(); }
+};
+
 struct StrangenessInJets {
 
   // Instantiate the CCDB service and API interface
@@ -149,6 +193,10 @@ struct StrangenessInJets {
   HistogramRegistry registryMC{"registryMC", {}, OutputObjHandlingPolicy::AnalysisObject, true, true};
   HistogramRegistry registryQC{"registryQC", {}, OutputObjHandlingPolicy::AnalysisObject, true, true};
 
+  // Per-event caches of the selected candidates, reused across events
+  SelectedCandidates selectedV0s;
+  SelectedCandidates selectedCascades;
+
   // Global analysis parameters
   enum ParticleOfInterest { kV0Particles = 0,
                             kCascades,
@@ -156,6 +204,13 @@ struct StrangenessInJets {
                             kKaons,
                             kProtons,
                             kParticles };
+  enum V0Species { kK0s = 0,
+                   kLambda,
+                   kAntiLambda };
+  enum CascadeSpecies { kXiPos = 0,
+                        kXiNeg,
+                        kOmegaPos,
+                        kOmegaNeg };
   Configurable<std::array<int, kParticles>> enabledSignals{"enabledSignals", {1, 0, 0, 0, 0}, "Enable particles"};
   Configurable<double> minJetPt{"minJetPt", 10.0, "Minimum reconstructed pt of the jet (GeV/c)"};
   Configurable<double> rJet{"rJet", 0.3, "Jet resolution parameter (R)"};
@@ -1136,92 +1191,142 @@ struct StrangenessInJets {
     // Fill event multiplicity
     registryData.fill(HIST("number_of_events_vsmultiplicity"), multiplicity);
 
+    // The candidate selections and directions do not depend on the jet: evaluate them once per event
+    if (enabledSignals.value[ParticleOfInterest::kV0Particles]) {
+      selectedV0s.clear();
+      for (const auto& v0 : fullV0s) {
+        // Get V0 daughters
+        const auto& pos = v0.posTrack_as<DaughterTracks>();
+        const auto& neg = v0.negTrack_as<DaughterTracks>();
+
+        uint8_t selection = 0;
+        if (passedK0ShortSelection(v0, pos, neg)) {
+          SETBIT(selection, kK0s);
+        }
+        if (passedLambdaSelection(v0, pos, neg)) {
+          SETBIT(selection, kLambda);
+        }
+        if (passedAntiLambdaSelection(v0, pos, neg)) {
+          SETBIT(selection, kAntiLambda);
+        }
+        if (selection) {
+          selectedV0s.add(TVector3(v0.px(), v0.py(), v0.pz()), v0.pt(), {v0.mK0Short(), v0.mLambda(), v0.mAntiLambda()}, selection);
+        }
+      }
+    }
+    if (enabledSignals.value[ParticleOfInterest::kCascades]) {
+      selectedCascades.clear();
+      for (const auto& casc : Cascades) {
+        // Get cascade daughters
+        const auto& bach = casc.bachelor_as<DaughterTracks>();
+        const auto& pos = casc.posTrack_as<DaughterTracks>();
+        const auto& neg = casc.negTrack_as<DaughterTracks>();
+
+        uint8_t selection = 0;
+        if (passedXiSelection(casc, pos, neg, bach, collision)) {
+          SETBIT(selection, bach.sign() > 0 ? kXiPos : kXiNeg);
+        }
+        if (passedOmegaSelection(casc, pos, neg, bach, collision)) {
+          SETBIT(selection, bach.sign() > 0 ? kOmegaPos : kOmegaNeg);
+        }
+        if (selection) {
+          selectedCascades.add(TVector3(casc.px(), casc.py(), casc.pz()), casc.pt(), {casc.mXi(), casc.mOmega(), 0.f}, selection);
+        }
+      }
+    }
+
     // Loop over selected jets
     for (int i = 0; i < static_cast<int>(selectedJet.size()); i++) {
-      if (enabledSignals.value[ParticleOfInterest::kV0Particles]) {
-        for (const auto& v0 : fullV0s) {
-          // Get V0 daughters
-          const auto& pos = v0.posTrack_as<DaughterTracks>();
-          const auto& neg = v0.negTrack_as<DaughterTracks>();
+      const JetAndUeAxes axes{selectedJet[i], ue1[i], ue2[i]};
 
+      if (enabledSignals.value[ParticleOfInterest::kV0Particles]) {
+        for (size_t iV0 = 0; iV0 < selectedV0s.size(); iV0++) {
           // Calculate distance from jet and UE axes
-          const ParticlePositionWithRespectToJet position{v0.px(), v0.py(), v0.pz(), selectedJet[i], ue1[i], ue2[i]};
+          const ParticlePositionWithRespectToJet position{selectedV0s.eta[iV0], selectedV0s.phi[iV0], axes};
+          const bool inUE = position.isInUE1() || position.isInUE2();
+          if (!position.isInJet() && !inUE) {
+            continue;
+          }
+          const uint8_t selection = selectedV0s.selection[iV0];
+          const float pt = selectedV0s.pt[iV0];
 
           // K0s
-          if (passedK0ShortSelection(v0, pos, neg)) {
+          if (TESTBIT(selection, kK0s)) {
             if (position.isInJet()) {
-              registryData.fill(HIST("K0s_in_jet"), multiplicity, v0.pt(), v0.mK0Short());
+              registryData.fill(HIST("K0s_in_jet"), multiplicity, pt, selectedV0s.mass[kK0s][iV0]);
             }
-            if (position.isInUE1() || position.isInUE2()) {
-              registryData.fill(HIST("K0s_in_ue"), multiplicity, v0.pt(), v0.mK0Short());
+            if (inUE) {
+              registryData.fill(HIST("K0s_in_ue"), multiplicity, pt, selectedV0s.mass[kK0s][iV0]);
             }
           }
           // Lambda
-          if (passedLambdaSelection(v0, pos, neg)) {
+          if (TESTBIT(selection, kLambda)) {
             if (position.isInJet()) {
-              registryData.fill(HIST("Lambda_in_jet"), multiplicity, v0.pt(), v0.mLambda());
+              registryData.fill(HIST("Lambda_in_jet"), multiplicity, pt, selectedV0s.mass[kLambda][iV0]);
             }
-            if (position.isInUE1() || position.isInUE2()) {
-              registryData.fill(HIST("Lambda_in_ue"), multiplicity, v0.pt(), v0.mLambda());
+            if (inUE) {
+              registryData.fill(HIST("Lambda_in_ue"), multiplicity, pt, selectedV0s.mass[kLambda][iV0]);
             }
           }
           // AntiLambda
-          if (passedAntiLambdaSelection(v0, pos, neg)) {
+          if (TESTBIT(selection, kAntiLambda)) {
             if (position.isInJet()) {
-              registryData.fill(HIST("AntiLambda_in_jet"), multiplicity, v0.pt(), v0.mAntiLambda());
+              registryData.fill(HIST("AntiLambda_in_jet"), multiplicity, pt, selectedV0s.mass[kAntiLambda][iV0]);
             }
-            if (position.isInUE1() || position.isInUE2()) {
-              registryData.fill(HIST("AntiLambda_in_ue"), multiplicity, v0.pt(), v0.mAntiLambda());
+            if (inUE) {
+              registryData.fill(HIST("AntiLambda_in_ue"), multiplicity, pt, selectedV0s.mass[kAntiLambda][iV0]);
             }
           }
         }
       }
 
       if (enabledSignals.value[ParticleOfInterest::kCascades]) {
-        for (const auto& casc : Cascades) {
-          // Get cascade daughters
-          const auto& bach = casc.bachelor_as<DaughterTracks>();
-          const auto& pos = casc.posTrack_as<DaughterTracks>();
-          const auto& neg = casc.negTrack_as<DaughterTracks>();
-          TVector3 cascadeDir(casc.px(), casc.py(), casc.pz());
-
+        for (size_t iCasc = 0; iCasc < selectedCascades.size(); iCasc++) {
           // Calculate distance from jet and UE axes
-          const ParticlePositionWithRespectToJet position{casc.px(), casc.py(), casc.pz(), selectedJet[i], ue1[i], ue2[i]};
+          const ParticlePositionWithRespectToJet position{selectedCascades.eta[iCasc], selectedCascades.phi[iCasc], axes};
+          const bool inUE = position.isInUE1() || position.isInUE2();
+          if (!position.isInJet() && !inUE) {
+            continue;
+          }
+          const uint8_t selection = selectedCascades.selection[iCasc];
+          const float pt = selectedCascades.pt[iCasc];
+          const float massXi = selectedCascades.mass[0][iCasc];
+          const float massOmega = selectedCascades.mass[1][iCasc];
 
           // Xi+
-          if (passedXiSelection(casc, pos, neg, bach, collision) && bach.sign() > 0) {
+          if (TESTBIT(selection, kXiPos)) {
             if (position.isInJet()) {
-              registryData.fill(HIST("XiPos_in_jet"), multiplicity, casc.pt(), casc.mXi());
+              registryData.fill(HIST("XiPos_in_jet"), multiplicity, pt, massXi);
             }
-            if (position.isInUE1() || position.isInUE2()) {
-              registryData.fill(HIST("XiPos_in_ue"), multiplicity, casc.pt(), casc.mXi());
+            if (inUE) {
+              registryData.fill(HIST("XiPos_in_ue"), multiplicity, pt, massXi);
             }
           }
           // Xi-
-          if (passedXiSelection(casc, pos, neg, bach, collision) && bach.sign() < 0) {
+          if (TESTBIT(selection, kXiNeg)) {
             if (position.isInJet()) {
-              registryData.fill(HIST("XiNeg_in_jet"), multiplicity, casc.pt(), casc.mXi());
+              registryData.fill(HIST("XiNeg_in_jet"), multiplicity, pt, massXi);
             }
-            if (position.isInUE1() || position.isInUE2()) {
-              registryData.fill(HIST("XiNeg_in_ue"), multiplicity, casc.pt(), casc.mXi());
+            if (inUE) {
+              registryData.fill(HIST("XiNeg_in_ue"), multiplicity, pt, massXi);
             }
           }
           // Omega+
-          if (passedOmegaSelection(casc, pos, neg, bach, collision) && bach.sign() > 0) {
+          if (TESTBIT(selection, kOmegaPos)) {
             if (position.isInJet()) {
-              registryData.fill(HIST("OmegaPos_in_jet"), multiplicity, casc.pt(), casc.mOmega());
+              registryData.fill(HIST("OmegaPos_in_jet"), multiplicity, pt, massOmega);
             }
-            if (position.isInUE1() || position.isInUE2()) {
-              registryData.fill(HIST("OmegaPos_in_ue"), multiplicity, casc.pt(), casc.mOmega());
+            if (inUE) {
+              registryData.fill(HIST("OmegaPos_in_ue"), multiplicity, pt, massOmega);
             }
           }
           // Omega-
-          if (passedOmegaSelection(casc, pos, neg, bach, collision) && bach.sign() < 0) {
+          if (TESTBIT(selection, kOmegaNeg)) {
             if (position.isInJet()) {
-              registryData.fill(HIST("OmegaNeg_in_jet"), multiplicity, casc.pt(), casc.mOmega());
+              registryData.fill(HIST("OmegaNeg_in_jet"), multiplicity, pt, massOmega);
             }
-            if (position.isInUE1() || position.isInUE2()) {
-              registryData.fill(HIST("OmegaNeg_in_ue"), multiplicity, casc.pt(), casc.mOmega());
+            if (inUE) {
+              registryData.fill(HIST("OmegaNeg_in_ue"), multiplicity, pt, massOmega);
             }
           }
         }
@@ -24,8 +24,13 @@
 #include "ReconstructionDataFormats/Track.h"
 
 #include <array>
+#include <atomic>
 #include <cmath>
+#include <cstdint>
 #include <cstdlib>
+#include <functional>
+#include <thread>
+#include <vector>
 
 #ifndef HomogeneousField
 #define HomogeneousField
@@ -90,6 +95,31 @@ struct decay3bodyCandidate {
   float covariance[21] = {0.0f};
 };
 
+//_______________________________________________________________________
+// input of the batched Decay3body building
+template <typename TCollision, typename TTrack>
+struct decay3bodyTriplet {
+  TCollision collision;
+  TTrack trackProton;
+  TTrack trackPion;
+  TTrack trackDeuteron;
+  int decay3bodyID = -1;
+  double tofNsigmaDeuteron = 0.0f;
+  float trackedClSize = 0.0f;
+};
+
+// building options, see buildDecay3BodyCandidate
+struct decay3bodyBuildOptions {
+  bool useKFParticle = false;
+  bool kfSetTopologicalConstraint = false;
+  bool useSelections = true;
+  bool useChi2Selection = true;
+  bool useTPCforPion = false;
+  bool acceptTPCOnly = false;
+  bool askOnlyITSMatch = true;
+  bool calculateCovariance = true;
+};
+
 //_______________________________________________________________________
 // builder helper class
 class decay3bodyBuilderHelper
@@ -176,6 +206,77 @@ class decay3bodyBuilderHelper
     float maxDCAZ3Body;
   } svertexerselections;
 
+  //_______________________________________________________________________
+  // selections on the daughter tracks, which do not need any propagation or vertex fit
+  template <typename TTrack>
+  bool isSelectedDaughters(TTrack const& trackProton,
+                           TTrack const& trackPion,
+                           TTrack const& trackDeuteron,
+                           double tofNsigmaDeuteron,
+                           bool useTPCforPion = false,
+                           bool acceptTPCOnly = false,
+                           bool askOnlyITSMatch = true) const
+  {
+    // proton track quality
+    if (trackProton.tpcNClsFound() < decay3bodyselections.minTPCNClProton) {
+      return false;
+    }
+    // pion track quality
+    if (useTPCforPion) {
+      if (trackPion.tpcNClsFound() < decay3bodyselections.minTPCNClPion) {
+        return false;
+      }
+    }
+    // deuteron track quality
+    if (trackDeuteron.tpcNClsFound() < decay3bodyselections.minTPCNClDeuteron) {
+      return false;
+    }
+
+    // track eta
+    if (std::fabs(trackProton.eta()) > decay3bodyselections.maxEtaDaughters) {
+      return false;
+    }
+    if (std::fabs(trackPion.eta()) > decay3bodyselections.maxEtaDaughters) {
+      return false;
+    }
+    if (std::fabs(trackDeuteron.eta()) > decay3bodyselections.maxEtaDaughters) {
+      return false;
+    }
+
+    // TPC only
+    if (!acceptTPCOnly) {
+      if (askOnlyITSMatch) {
+        if (!trackProton.hasITS() || !trackPion.hasITS() || !trackDeuteron.hasITS()) {
+          return false;
+        }
+      } else {
+        bool isProtonTPCOnly = !trackProton.hasITS() && !trackProton.hasTOF() && !trackProton.hasTRD();
+        bool isPionTPCOnly = !trackPion.hasITS() && !trackPion.hasTOF() && !trackPion.hasTRD();
+        bool isDeuteronTPCOnly = !trackDeuteron.hasITS() && !trackDeuteron.hasTOF() && !trackDeuteron.hasTRD();
+        if (isProtonTPCOnly || isPionTPCOnly || isDeuteronTPCOnly) {
+          return false;
+        }
+      }
+    }
+
+    // daughter TPC PID
+    if (std::fabs(trackProton.tpcNSigmaPr()) > decay3bodyselections.maxTPCnSigma) {
+      return false;
+    }
+    if (useTPCforPion && std::fabs(trackPion.tpcNSigmaPi()) > decay3bodyselections.maxTPCnSigma) {
+      return false;
+    }
+    if (std::fabs(trackDeuteron.tpcNSigmaDe()) > decay3bodyselections.maxTPCnSigma) {
+      return false;
+    }
+
+    // deuteron TOF PID
+    if ((tofNsigmaDeuteron < decay3bodyselections.minTOFnSigmaDeuteron || tofNsigmaDeuteron > decay3bodyselections.maxTOFnSigmaDeuteron) && trackDeuteron.p() > decay3bodyselections.minPDeuteronUseTOF) {
+      return false;
+    }
+    return true;
+  }
+
   //_______________________________________________________________________
   // build Decay3body from three tracks, including V0 building.
   template <typename TCollision, typename TTrack>
@@ -214,77 +315,10 @@ class decay3bodyBuilderHelper
 
     //_______________________________________________________________________
     // track selections
-    if (useSelections) {
-      // proton track quality
-      if (trackProton.tpcNClsFound() < decay3bodyselections.minTPCNClProton) {
-        decay3body = {};
-        return false;
-      }
-      // pion track quality
-      if (useTPCforPion) {
-        if (trackPion.tpcNClsFound() < decay3bodyselections.minTPCNClPion) {
-          decay3body = {};
-          return false;
-        }
-      }
-      // deuteron track quality
-      if (trackDeuteron.tpcNClsFound() < decay3bodyselections.minTPCNClDeuteron) {
-        decay3body = {};
-        return false;
-      }
-
-      // track eta
-      if (std::fabs(trackProton.eta()) > decay3bodyselections.maxEtaDaughters) {
-        decay3body = {};
-        return false;
-      }
-      if (std::fabs(trackPion.eta()) > decay3bodyselections.maxEtaDaughters) {
-        decay3body = {};
-        return false;
-      }
-      if (std::fabs(trackDeuteron.eta()) > decay3bodyselections.maxEtaDaughters) {
-        decay3body = {};
-        return false;
-      }
-
-      // TPC only
-      if (!acceptTPCOnly) {
-        if (askOnlyITSMatch) {
-          if (!trackProton.hasITS() || !trackPion.hasITS() || !trackDeuteron.hasITS()) {
-            decay3body = {};
-            return false;
-          }
-        } else {
-          bool isProtonTPCOnly = !trackProton.hasITS() && !trackProton.hasTOF() && !trackProton.hasTRD();
-          bool isPionTPCOnly = !trackPion.hasITS() && !trackPion.hasTOF() && !trackPion.hasTRD();
-          bool isDeuteronTPCOnly = !trackDeuteron.hasITS() && !trackDeuteron.hasTOF() && !trackDeuteron.hasTRD();
-          if (isProtonTPCOnly || isPionTPCOnly || isDeuteronTPCOnly) {
-            decay3body = {};
-            return false;
-          }
-        }
-      }
-
-      // daughter TPC PID
-      if (std::fabs(trackProton.tpcNSigmaPr()) > decay3bodyselections.maxTPCnSigma) {
-        decay3body = {};
-        return false;
-      }
-      if (useTPCforPion && std::fabs(trackPion.tpcNSigmaPi()) > decay3bodyselections.maxTPCnSigma) {
-        decay3body = {};
-        return false;
-      }
-      if (std::fabs(trackDeuteron.tpcNSigmaDe()) > decay3bodyselections.maxTPCnSigma) {
-        decay3body = {};
-        return false;
-      }
-
-      // deuteron TOF PID
-      if ((tofNsigmaDeuteron < decay3bodyselections.minTOFnSigmaDeuteron || tofNsigmaDeuteron > decay3bodyselections.maxTOFnSigmaDeuteron) && trackDeuteron.p() > decay3bodyselections.minPDeuteronUseTOF) {
-        decay3body = {};
-        return false;
-      }
-    } // end of selections
+    if (useSelections && !isSelectedDaughters(trackProton, trackPion, trackDeuteron, tofNsigmaDeuteron, useTPCforPion, acceptTPCOnly, askOnlyITSMatch)) {
+      decay3body = {};
+      return false;
+    }
 
     //_______________________________________________________________________
     // daughter track DCA to PV associated with decay3body --> computed with KFParticle
@@ -888,6 +922,71 @@ class decay3bodyBuilderHelper
   }
 };
 
+//_______________________________________________________________________
+// batched building of Decay3body candidates from (proton, pion, deuteron) triplets.
+// The daughter track selections are applied to the whole batch first, then the surviving triplets are fitted
+// in parallel, one helper (and thus one fitter and one candidate storage) per thread.
+// The candidate of triplets[i] is stored in candidates[i], if isBuilt[i] is true. The output does not depend on the scheduling.
+template <typename TCollision, typename TTrack>
+void buildDecay3BodyCandidates(std::vector<decay3bodyBuilderHelper>& helpers,
+                               std::vector<decay3bodyTriplet<TCollision, TTrack>> const& triplets,
+                               decay3bodyBuildOptions const& options,
+                               std::vector<decay3bodyCandidate>& candidates,
+                               std::vector<uint8_t>& isBuilt)
+{
+  candidates.resize(triplets.size());
+  isBuilt.assign(triplets.size(), 0);
+  if (helpers.empty()) {
+    return;
+  }
+
+  // prefilter
+  std::vector<std::size_t> survivors;
+  survivors.reserve(triplets.size());
+  for (std::size_t i = 0; i < triplets.size(); i++) {
+    const auto& triplet = triplets[i];
+    if (!options.useSelections || helpers[0].isSelectedDaughters(triplet.trackProton, triplet.trackPion, triplet.trackDeuteron, triplet.tofNsigmaDeuteron, options.useTPCforPion, options.acceptTPCOnly, options.askOnlyITSMatch)) {
+      survivors.emplace_back(i);
+    }
+  }
+
+  // vertex fit
+  std::atomic<std::size_t> next{0};
+  auto worker = [&](decay3bodyBuilderHelper& helper) {
+    for (std::size_t k = next++; k < survivors.size(); k = next++) {
+      const auto& triplet = triplets[survivors[k]];
+      if (helper.buildDecay3BodyCandidate(triplet.collision,
+                                          triplet.trackProton,
+                                          triplet.trackPion,
+                                          triplet.trackDeuteron,
+                                          triplet.decay3bodyID,
+                                          triplet.tofNsigmaDeuteron,
+                                          triplet.trackedClSize,
+                                          options.useKFParticle,
+                                          options.kfSetTopologicalConstraint,
+                                          options.useSelections,
+                                          options.useChi2Selection,
+                                          options.useTPCforPion,
+                                          options.acceptTPCOnly,
+                                          options.askOnlyITSMatch,
+                                          options.calculateCovariance,
+                                          false /*isEventMixing*/,
+                                          false /*applySVertexerCuts*/)) {
+        candidates[survivors[k]] = helper.decay3body;
+        isBuilt[survivors[k]] = 1;
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  for (std::size_t iThread = 1; iThread < helpers.size(); iThread++) {
+    threads.emplace_back(worker, std::ref(helpers[iThread]));
+  }
+  worker(helpers[0]);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
 } // namespace pwglf
 } // namespace o2
 
@@ -0,0 +1,119 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   mcBookkeeping.h
+/// \since  14/10/2026
+/// \brief  Per data frame bookkeeping of the MC particles of interest: the indices of the particles
+///         with the requested PDG codes and a dense bitmap of the reconstructed ones
+///
+
+#ifndef PWGLF_UTILS_MCBOOKKEEPING_H_
+#define PWGLF_UTILS_MCBOOKKEEPING_H_
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+namespace o2
+{
+namespace pwglf
+{
+
+/// @brief Dense visited-set over the MC stack
+class McParticleBitmap
+{
+ public:
+  /// Resizes the bitmap to nParticles and clears all the bits, the memory is kept across data frames
+  void reset(const int64_t nParticles)
+  {
+    mWords.assign((nParticles + 63) / 64, 0ull);
+    mSize = nParticles;
+  }
+  void set(const int64_t index)
+  {
+    if (index >= 0 && index < mSize) {
+      mWords[index >> 6] |= 1ull << (index & 63);
+    }
+  }
+  bool test(const int64_t index) const
+  {
+    return index >= 0 && index < mSize && (mWords[index >> 6] >> (index & 63) & 1ull);
+  }
+  int64_t size() const { return mSize; }
+
+ private:
+  std::vector<uint64_t> mWords;
+  int64_t mSize = 0;
+};
+
+/// @brief MC particles of interest of a data frame, selected once by |PDG code| (and optionally by generator status),
+///        plus the bitmap of the particles matched to a reconstructed candidate
+class McParticleBookkeeping
+{
+ public:
+  /// \param absPdgCodes |PDG codes| of interest, the position in the vector is the species index returned by species()
+  /// \param onlyProducedByGenerator keep only the particles produced by the event generator
+  void setSelection(const std::vector<int>& absPdgCodes, const bool onlyProducedByGenerator = false)
+  {
+    mAbsPdgCodes = absPdgCodes;
+    mOnlyProducedByGenerator = onlyProducedByGenerator;
+  }
+
+  /// Scans the MC stack once, to be called at the beginning of each data frame
+  template <typename TMcParticles>
+  void fill(TMcParticles const& particles)
+  {
+    mIndices.clear();
+    mSpecies.clear();
+    mReconstructed.reset(particles.size());
+    int64_t index{0};
+    for (const auto& particle : particles) {
+      const int iS = speciesOf(particle.pdgCode());
+      if (iS >= 0 && (!mOnlyProducedByGenerator || particle.producedByGenerator())) {
+        mIndices.push_back(index);
+        mSpecies.push_back(iS);
+      }
+      index++;
+    }
+  }
+
+  int speciesOf(const int pdgCode) const
+  {
+    const int absPdg = std::abs(pdgCode);
+    for (size_t iS{0}; iS < mAbsPdgCodes.size(); ++iS) {
+      if (mAbsPdgCodes[iS] == absPdg) {
+        return static_cast<int>(iS);
+      }
+    }
+    return -1;
+  }
+
+  void markReconstructed(const int64_t index) { mReconstructed.set(index); }
+  bool isReconstructed(const int64_t index) const { return mReconstructed.test(index); }
+
+  /// Number of selected particles, the i-th one is indices()[i] in the MC stack and belongs to species()[i]
+  size_t size() const { return mIndices.size(); }
+  const std::vector<int64_t>& indices() const { return mIndices; }
+  const std::vector<int>& species() const { return mSpecies; }
+
+ private:
+  std::vector<int> mAbsPdgCodes;
+  bool mOnlyProducedByGenerator = false;
+  std::vector<int64_t> mIndices; // global indices of the selected particles
+  std::vector<int> mSpecies;     // species index of the selected particles
+  McParticleBitmap mReconstructed;
+};
+
+} // namespace pwglf
+} // namespace o2
+
+#endif // PWGLF_UTILS_MCBOOKKEEPING_H_
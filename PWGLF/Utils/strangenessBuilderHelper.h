@@ -14,7 +14,11 @@
 
 #include <cstdlib>
 #include <cmath>
+#include <cstdint>
+#include <algorithm>
 #include <array>
+#include <unordered_map>
+#include <vector>
 #include "DCAFitter/DCAFitterN.h"
 #include "Framework/AnalysisDataModel.h"
 #include "ReconstructionDataFormats/Track.h"
@@ -49,90 +53,64 @@ struct V0group {
   uint8_t v0Type;
 };
 
-//_______________________________________________________________________
-template <typename T>
-std::vector<std::size_t> sort_indices_posTrack(const std::vector<T>& v)
-{
-  std::vector<std::size_t> idx(v.size());
-  std::iota(idx.begin(), idx.end(), 0);
-  std::stable_sort(idx.begin(), idx.end(),
-                   [&v](std::size_t i1, std::size_t i2) { return v[i1].posTrackId < v[i2].posTrackId; });
-  return idx;
-}
-
-//_______________________________________________________________________
-template <typename T>
-std::vector<std::size_t> sort_indices_negTrack(const std::vector<T>& v)
-{
-  std::vector<std::size_t> idx(v.size());
-  std::iota(idx.begin(), idx.end(), 0);
-  std::stable_sort(idx.begin(), idx.end(),
-                   [&v](std::size_t i1, std::size_t i2) { return v[i1].negTrackId < v[i2].negTrackId; });
-  return idx;
-}
-
 //_______________________________________________________________________
 // this function deals with the fact that V0s provided in AO2Ds may
 // be duplicated in several collisions and groups them into entries
 // of type pwglf::V0group, each entry having the same neg/pos tracks
 // but an array of compatible collisions. The original V0 indices
 // are preserved in the resulting structure to allow for easy referencing
-// back afterwards. Algorithmically, full N^2 loops and/or multiple
-// find calls are avoided via sorting.
+// back afterwards. Algorithmically, this is a single sort by (pos, neg)
+// followed by a linear scan. The key buffer and the V0group entries
+// (including their inner vectors) are reused across calls.
+struct V0groupKey {
+  int posTrackId;
+  int negTrackId;
+  int V0Id;
+  int collisionId;
+  uint8_t v0Type;
+};
+
 template <typename T>
-std::vector<V0group> groupDuplicates(const T& V0s)
+void groupDuplicates(const T& V0s, std::vector<V0group>& v0tableGrouped, std::vector<V0groupKey>& keys)
 {
-  std::vector<V0group> v0table;
-  if (V0s.size() == 0) {
-    return v0table;
-  }
-  V0group thisV0;
-  thisV0.V0Ids.push_back(-1);        // create one single element
-  thisV0.collisionIds.push_back(-1); // create one single element
+  keys.clear();
+  keys.reserve(V0s.size());
   for (auto const& V0 : V0s) {
-    thisV0.V0Ids[0] = V0.globalIndex();
-    thisV0.collisionIds[0] = V0.collisionId();
-    thisV0.posTrackId = V0.posTrackId();
-    thisV0.negTrackId = V0.negTrackId();
-    thisV0.v0Type = V0.v0Type();
-    v0table.push_back(thisV0);
+    keys.push_back({V0.posTrackId(), V0.negTrackId(), static_cast<int>(V0.globalIndex()), V0.collisionId(), V0.v0Type()});
   }
-
-  // sort tracks according to positive track index to avoid excessive N^2 searches
-  auto posTrackSort = sort_indices_posTrack(v0table);
-
-  // create a proper list of V0s including duplicates: collisionIds is now a vector
-  int atPosTrackId = v0table[posTrackSort[0]].posTrackId;
-  std::vector<V0group> v0tableFixedPositive; // small list with fixed positive id
-  std::vector<V0group> v0tableGrouped;       // final list with proper grouping
-  for (size_t iV0 = 0; iV0 < posTrackSort.size(); iV0++) {
-    if (atPosTrackId != v0table[posTrackSort[iV0]].posTrackId) {
-      // switched pos track id. Process chunk of V0s
-      auto negTrackSort = sort_indices_negTrack(v0tableFixedPositive);
-      thisV0.collisionIds.clear();
-      thisV0.V0Ids.clear();
-      thisV0.negTrackId = v0tableFixedPositive[negTrackSort[0]].negTrackId;
-      for (size_t iPV0 = 0; iPV0 < v0tableFixedPositive.size(); iPV0++) {
-        if (thisV0.negTrackId != v0tableFixedPositive[negTrackSort[iPV0]].negTrackId) {
-          v0tableGrouped.push_back(thisV0);
-          thisV0.collisionIds.clear(); // clean collision Ids
-          thisV0.V0Ids.clear();        // clean aod::V0s Ids
-        }
-        thisV0.V0Ids.push_back(v0tableFixedPositive[negTrackSort[iPV0]].V0Ids[0]);
-        thisV0.collisionIds.push_back(v0tableFixedPositive[negTrackSort[iPV0]].collisionIds[0]);
-        thisV0.posTrackId = v0tableFixedPositive[negTrackSort[iPV0]].posTrackId;
-        thisV0.negTrackId = v0tableFixedPositive[negTrackSort[iPV0]].negTrackId;
-        thisV0.v0Type = v0tableFixedPositive[negTrackSort[iPV0]].v0Type;
+  // V0Id last: same order within a group as the original stable sorting
+  std::sort(keys.begin(), keys.end(), [](V0groupKey const& a, V0groupKey const& b) {
+    return a.posTrackId != b.posTrackId ? a.posTrackId < b.posTrackId : (a.negTrackId != b.negTrackId ? a.negTrackId < b.negTrackId : a.V0Id < b.V0Id);
+  });
+
+  size_t nGroups = 0;
+  for (size_t iKey = 0; iKey < keys.size(); iKey++) {
+    if (iKey == 0 || keys[iKey].posTrackId != keys[iKey - 1].posTrackId || keys[iKey].negTrackId != keys[iKey - 1].negTrackId) {
+      if (nGroups == v0tableGrouped.size()) {
+        v0tableGrouped.emplace_back();
       }
-      v0tableGrouped.push_back(thisV0); // publish last
-      v0tableFixedPositive.clear();
-      atPosTrackId = v0table[posTrackSort[iV0]].posTrackId; // move to the next pos index
-    }
-    v0tableFixedPositive.push_back(v0table[posTrackSort[iV0]]);
+      V0group& group = v0tableGrouped[nGroups++];
+      group.V0Ids.clear();
+      group.collisionIds.clear();
+      group.posTrackId = keys[iKey].posTrackId;
+      group.negTrackId = keys[iKey].negTrackId;
+    }
+    V0group& group = v0tableGrouped[nGroups - 1];
+    group.V0Ids.push_back(keys[iKey].V0Id);
+    group.collisionIds.push_back(keys[iKey].collisionId);
+    group.v0Type = keys[iKey].v0Type;
   }
-  v0tableGrouped.push_back(thisV0); // publish last
+  v0tableGrouped.resize(nGroups);
 
   LOGF(debug, "Duplicate V0s grouped. aod::V0s counted: %i, unique index pairs: %i", V0s.size(), v0tableGrouped.size());
+}
+
+template <typename T>
+std::vector<V0group> groupDuplicates(const T& V0s)
+{
+  std::vector<V0group> v0tableGrouped;
+  std::vector<V0groupKey> keys;
+  groupDuplicates(V0s, v0tableGrouped, keys);
   return v0tableGrouped;
 }
 
@@ -313,17 +291,13 @@ class strangenessBuilderHelper
 
     if constexpr (calculateProngDCAtoPV) {
       // Calculate DCA with respect to the collision associated to the V0
-      std::array<float, 2> dcaInfo;
-
       // do DCA to PV on TrackPar copies and not TrackParCov
       // TrackPar preferred: don't calculate multiple scattering / CovMat changes
       // Spares CPU since variables not checked
       o2::track::TrackPar positiveTrackParamCopy(positiveTrackParam);
       o2::track::TrackPar negativeTrackParamCopy(negativeTrackParam);
 
-      dcaInfo[0] = dcaInfo[1] = 999.0f; // by default, take large value to make sure candidate accepted
-      o2::base::Propagator::Instance()->propagateToDCABxByBz({pvX, pvY, pvZ}, positiveTrackParamCopy, 2.f, fitter.getMatCorrType(), &dcaInfo);
-      v0.positiveDCAxy = dcaInfo[0];
+      v0.positiveDCAxy = getProngDCAxy(positiveTrack.globalIndex(), collisionIndex, pvX, pvY, pvZ, positiveTrackParamCopy);
 
       if constexpr (useSelections) {
         if (std::fabs(v0.positiveDCAxy) < v0selections.dcapostopv) {
@@ -332,9 +306,7 @@ class strangenessBuilderHelper
         }
       }
 
-      dcaInfo[0] = dcaInfo[1] = 999.0f; // by default, take large value to make sure candidate accepted
-      o2::base::Propagator::Instance()->propagateToDCABxByBz({pvX, pvY, pvZ}, negativeTrackParamCopy, 2.f, fitter.getMatCorrType(), &dcaInfo);
-      v0.negativeDCAxy = dcaInfo[0];
+      v0.negativeDCAxy = getProngDCAxy(negativeTrack.globalIndex(), collisionIndex, pvX, pvY, pvZ, negativeTrackParamCopy);
 
       if constexpr (useSelections) {
         if (std::fabs(v0.negativeDCAxy) < v0selections.dcanegtopv) {
@@ -749,11 +721,9 @@ class strangenessBuilderHelper
     // bachelor DCA track to PV
     // Calculate DCA with respect to the collision associated to the V0, not individual tracks
     std::array<float, 2> dcaInfo;
-    dcaInfo[0] = dcaInfo[1] = 999.0f; // by default, take large value to make sure candidate accepted
 
     auto bachTrackPar = getTrackPar(bachelorTrack);
-    o2::base::Propagator::Instance()->propagateToDCABxByBz({pvX, pvY, pvZ}, bachTrackPar, 2.f, fitter.getMatCorrType(), &dcaInfo);
-    cascade.bachelorDCAxy = dcaInfo[0];
+    cascade.bachelorDCAxy = getProngDCAxy(bachelorTrack.globalIndex(), collisionIndex, pvX, pvY, pvZ, bachTrackPar);
 
     if (std::fabs(cascade.bachelorDCAxy) < cascadeselections.dcabachtopv) {
       cascade = {};
@@ -1271,7 +1241,35 @@ class strangenessBuilderHelper
     float maxDaughterEta;
   } cascadeselections;
 
+  //_______________________________________________________________________
+  // DCAxy to PV of a prong, propagated on the given copy of its parameters
+  // the same track typically enters many candidates: if useProngDCACache is set, the value is computed
+  // once per (track, collision, PID hypothesis) and reused. The cache has to be cleared for every data frame
+  bool useProngDCACache = false;
+  void clearProngDCACache() { prongDCAxyCache.clear(); }
+
+  float getProngDCAxy(int64_t trackIndex, int collisionIndex, float pvX, float pvY, float pvZ, o2::track::TrackPar& trackParam)
+  {
+    uint64_t key = 0;
+    if (useProngDCACache) {
+      key = (static_cast<uint64_t>(trackIndex) << 32) | (static_cast<uint64_t>(collisionIndex + 1) << 8) | trackParam.getPID().getID();
+      auto it = prongDCAxyCache.find(key);
+      if (it != prongDCAxyCache.end()) {
+        return it->second;
+      }
+    }
+    std::array<float, 2> dcaInfo;
+    dcaInfo[0] = dcaInfo[1] = 999.0f; // by default, take large value to make sure candidate accepted
+    o2::base::Propagator::Instance()->propagateToDCABxByBz({pvX, pvY, pvZ}, trackParam, 2.f, fitter.getMatCorrType(), &dcaInfo);
+    if (useProngDCACache) {
+      prongDCAxyCache.emplace(key, dcaInfo[0]);
+    }
+    return dcaInfo[0];
+  }
+
  private:
+  std::unordered_map<uint64_t, float> prongDCAxyCache; // (track, collision, PID) -> DCAxy to PV
+
   // internal helper to calculate DCA (3D) of a straight line to a given PV analytically
   float CalculateDCAStraightToPV(float X, float Y, float Z, float Px, float Py, float Pz, float pvX, float pvY, float pvZ)
   {
@@ -24,6 +24,8 @@
 #include "PWGLF/DataModel/LFStrangenessTables.h"
 #include "PWGLF/Utils/strangenessBuilderHelper.h"
 
+#include "Common/Core/IndexGrouping.h"
+#include "Common/Core/ScratchArena.h"
 #include "Common/Core/TPCVDriftManager.h"
 
 #include "DataFormatsCalibration/MeanVertexObject.h"
@@ -38,6 +40,7 @@
 #include <cmath>
 #include <cstdlib>
 #include <memory>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -502,10 +505,12 @@ class BuilderModule
   std::vector<cascadeEntry> cascadeList;
   std::vector<std::size_t> sorted_v0;
   std::vector<std::size_t> sorted_cascade;
+  o2::common::core::IndexGrouping collisionGrouping; // V0 / cascade lists grouped by collision for the findable modes
 
   // for tagging V0s used in cascades
   std::vector<o2::pwglf::v0candidate> v0sFromCascades; // Vector of v0 candidates used in cascades
   std::vector<int> ao2dV0toV0List;                     // index to relate v0s -> v0List
+  o2::common::core::ScratchArena scratchArena;         // per data frame temporary arrays (McCollision -> Collision maps)
   std::vector<int> v0Map;                              // index to relate v0List -> v0sFromCascades
 
   // declaration of structs here
@@ -711,13 +716,13 @@ class BuilderModule
   template <typename T>
   std::vector<std::size_t> sort_indices(const std::vector<T>& v, bool doSorting = false)
   {
-    std::vector<std::size_t> idx(v.size());
-    std::iota(idx.begin(), idx.end(), 0);
     if (doSorting) {
-      // do sorting only if requested (not always necessary)
-      std::stable_sort(idx.begin(), idx.end(),
-                       [&v](std::size_t i1, std::size_t i2) { return v[i1].collisionId < v[i2].collisionId; });
+      // do sorting only if requested (not always necessary): stable grouping by collisionId in linear time
+      collisionGrouping.buildByCollision(v);
+      return collisionGrouping.rows();
     }
+    std::vector<std::size_t> idx(v.size());
+    std::iota(idx.begin(), idx.end(), 0);
     return idx;
   }
 
@@ -821,13 +826,14 @@ class BuilderModule
     sorted_v0.clear();
     sorted_cascade.clear();
     ao2dV0toV0List.clear();
+    scratchArena.reset();
 
     trackEntry currentTrackEntry;
     v0Entry currentV0Entry;
     cascadeEntry currentCascadeEntry;
 
-    std::vector<int> bestCollisionArray;          // stores McCollision -> Collision map
-    std::vector<int> bestCollisionNContribsArray; // stores Ncontribs for biggest coll assoc to mccoll
+    std::span<int> bestCollisionArray;          // stores McCollision -> Collision map
+    std::span<int> bestCollisionNContribsArray; // stores Ncontribs for biggest coll assoc to mccoll
 
     int collisionLessV0s = 0;
     int collisionLessCascades = 0;
@@ -835,10 +841,8 @@ class BuilderModule
     if (baseOpts.mc_findableMode.value > 0) {
       if constexpr (soa::is_table<TMCCollisions>) {
         // if mcCollisions exist, assemble mcColl -> bestRecoColl map here
-        bestCollisionArray.clear();
-        bestCollisionNContribsArray.clear();
-        bestCollisionArray.resize(mcCollisions.size(), -1);          // marks not reconstructed
-        bestCollisionNContribsArray.resize(mcCollisions.size(), -1); // marks not reconstructed
+        bestCollisionArray = scratchArena.allocate<int>(mcCollisions.size(), -1);          // marks not reconstructed
+        bestCollisionNContribsArray = scratchArena.allocate<int>(mcCollisions.size(), -1); // marks not reconstructed
 
         // single loop over double loop at a small cost in memory for extra array
         for (const auto& collision : collisions) {
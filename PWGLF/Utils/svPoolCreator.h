@@ -12,12 +12,15 @@
 #ifndef PWGLF_UTILS_SVPOOLCREATOR_H_
 #define PWGLF_UTILS_SVPOOLCREATOR_H_
 
+#include <algorithm>
 #include <array>
-#include <unordered_map>
+#include <limits>
+#include <numeric>
 #include <vector>
 #include <utility>
 #include "Framework/AnalysisTask.h"
 #include "Framework/ASoAHelpers.h"
+#include "Common/Core/BCIndex.h"
 #include "Common/Core/trackUtilities.h"
 #include "DCAFitter/DCAFitterN.h"
 #include "Framework/AnalysisDataModel.h"
@@ -57,9 +60,9 @@ class svPoolCreator
     for (auto& pool : trackCandPool) {
       pool.clear();
     }
-    tmap.clear();
+    trackPoolPosition.clear();
     svCandPool.clear();
-    bc2Coll.clear();
+    bcIndex.clear();
   }
 
   void setTimeMargin(float timeMargin) { timeMarginNS = timeMargin; }
@@ -69,15 +72,10 @@ class svPoolCreator
   std::array<std::vector<TrackCand>, 4> getTrackCandPool() { return trackCandPool; }
 
   template <typename C, typename BC>
-  void fillBC2Coll(const C& collisions, BC const&)
+  void fillBC2Coll(const C& collisions, BC const& bcs)
   {
-    for (unsigned i = 0; i < collisions.size(); i++) {
-      auto collision = collisions.rawIteratorAt(i);
-      if (!collision.has_bc()) {
-        continue;
-      }
-      bc2Coll[collision.template bc_as<BC>().globalBC()] = i;
-    }
+    bcIndex.setBCs(bcs);
+    bcIndex.setCollisions(collisions);
   }
 
   template <typename T, typename C, typename BC>
@@ -88,7 +86,6 @@ class svPoolCreator
       return;
     }
     bool isDau0 = pdgHypo == track0Pdg;
-    constexpr uint64_t BcInvalid = -1;
     uint64_t globalBC = BcInvalid;
     if (trackCand.has_collision()) {
       if (trackCand.template collision_as<C>().has_bc()) {
@@ -114,26 +111,39 @@ class svPoolCreator
       return;
     }
 
+    // first collision within [globalBC - bOffsetMax, globalBC + bOffsetMax)
     uint64_t firstBC = globalBC < bOffsetMax ? 0 : globalBC - bOffsetMax;
     uint64_t lastBC = globalBC + bOffsetMax;
-    int firstCollIdx = -1;
-    while (firstBC < lastBC) {
-      if (bc2Coll.find(firstBC) != bc2Coll.end()) {
-        firstCollIdx = bc2Coll[firstBC];
-        break;
-      }
-      firstBC++;
-    }
-    if (firstCollIdx == -1) {
+    const int64_t firstCollPos = bcIndex.lowerBoundCollision(firstBC);
+    if (firstCollPos == bcIndex.nSortedCollisions() || bcIndex.sortedCollisionGlobalBC(firstCollPos) >= lastBC) {
       return;
     }
+    int firstCollIdx = bcIndex.sortedCollision(firstCollPos);
+
+    // the track time does not depend on the collision
+    const bool isPVContributor = trackCand.isPVContributor();
+    float trackTime{0.};
+    float trackTimeRes{0.};
+    if (isPVContributor) {
+      trackTime = trackCand.template collision_as<C>().collisionTime(); // if PV contributor, we assume the time to be the one of the collision
+      trackTimeRes = o2::constants::lhc::LHCBunchSpacingNS;             // 1 BC
+    } else {
+      trackTime = trackCand.trackTime();
+      trackTimeRes = trackCand.trackTimeRes();
+    }
+    const float trackTimeRes2 = trackTimeRes * trackTimeRes;
+    const float nSigmaTime2 = TESTBIT(trackCand.flags(), o2::aod::track::TrackTimeResIsRange) ? 1.f : 16.f; // threshold is 1 or 4 sigma + margin, compared in squares
+
+    if (static_cast<int>(trackPoolPosition.size()) <= trackCand.globalIndex()) {
+      trackPoolPosition.resize(trackCand.globalIndex() + 1, {-1, -1});
+    }
 
     // now loop over all the collisions to make the pool
     for (int collIdx = firstCollIdx; collIdx < collisions.size(); collIdx++) {
-      const auto& collision = collisions.rawIteratorAt(collIdx);
-      float collTime = collision.collisionTime();
-      float collTimeRes2 = collision.collisionTimeRes() * collision.collisionTimeRes();
-      uint64_t collBC = collision.template bc_as<BC>().globalBC();
+      uint64_t collBC = bcIndex.collisionGlobalBC(collIdx);
+      if (collBC == BcInvalid) {
+        continue;
+      }
       // int collIdx = collision.globalIndex();
       int64_t bcOffset = globalBC - static_cast<int64_t>(collBC);
       if (static_cast<uint64_t>(std::abs(bcOffset)) > bOffsetMax) {
@@ -144,39 +154,26 @@ class svPoolCreator
         }
       }
 
-      float trackTime{0.};
-      float trackTimeRes{0.};
-      if (trackCand.isPVContributor()) {
-        trackTime = trackCand.template collision_as<C>().collisionTime(); // if PV contributor, we assume the time to be the one of the collision
-        trackTimeRes = o2::constants::lhc::LHCBunchSpacingNS;             // 1 BC
-      } else {
-        trackTime = trackCand.trackTime();
-        trackTimeRes = trackCand.trackTimeRes();
-      }
-
-      const float deltaTime = trackTime - collTime + bcOffset * o2::constants::lhc::LHCBunchSpacingNS;
-      float sigmaTimeRes2 = collTimeRes2 + trackTimeRes * trackTimeRes;
-
-      float thresholdTime = 0.;
-      if (trackCand.isPVContributor()) {
-        thresholdTime = trackTimeRes;
-      } else if (TESTBIT(trackCand.flags(), o2::aod::track::TrackTimeResIsRange)) {
-        thresholdTime = std::sqrt(sigmaTimeRes2);
-        thresholdTime += timeMarginNS;
+      const auto& collision = collisions.rawIteratorAt(collIdx);
+      float collTime = collision.collisionTime();
+      float collTimeRes2 = collision.collisionTimeRes() * collision.collisionTimeRes();
 
+      const float deltaTime = std::abs(trackTime - collTime + bcOffset * o2::constants::lhc::LHCBunchSpacingNS);
+      if (isPVContributor) {
+        if (deltaTime > trackTimeRes) {
+          continue;
+        }
       } else {
-        thresholdTime = 4. * std::sqrt(sigmaTimeRes2);
-        thresholdTime += timeMarginNS;
-      }
-      // LOG(info) << "Threshold time: " << thresholdTime << " isPVContributor: " << trackCand.isPVContributor() << " time margin: " << timeMarginNS;
-      if (std::abs(deltaTime) > thresholdTime) {
-        continue;
+        const float excessTime = deltaTime - timeMarginNS;
+        if (excessTime > 0.f && excessTime * excessTime > nSigmaTime2 * (collTimeRes2 + trackTimeRes2)) {
+          continue;
+        }
       }
 
-      const auto& tref = tmap.find(trackCand.globalIndex());
-      if (tref != tmap.end()) {
+      auto& tref = trackPoolPosition[trackCand.globalIndex()];
+      if (tref.first >= 0) {
         LOG(debug) << "Track: " << trackCand.globalIndex() << " already processed with other vertex";
-        trackCandPool[tref->second.second][tref->second.first].collBracket.setMax(static_cast<int>(collIdx)); // this track was already processed with other vertex, account the latter
+        trackCandPool[tref.second][tref.first].collBracket.setMax(static_cast<int>(collIdx)); // this track was already processed with other vertex, account the latter
         continue;
       }
 
@@ -185,65 +182,45 @@ class svPoolCreator
       trForpool.collBracket = {static_cast<int>(collIdx), static_cast<int>(collIdx)};
       // LOG(info) << "Adding track to pool: " << trForpool.Idxtr << " with bracket: " << trForpool.collBracket.getMin() << " " << trForpool.collBracket.getMax() << " and pool index: " << poolIndex;
       trackCandPool[poolIndex].emplace_back(trForpool);
-      tmap[trackCand.globalIndex()] = {trackCandPool[poolIndex].size() - 1, poolIndex};
+      tref = {static_cast<int>(trackCandPool[poolIndex].size()) - 1, poolIndex};
     }
-
-    // is Sorting Needed ? TBD
   }
   template <typename C>
-  std::vector<SVCand>& getSVCandPool(const C& collisions, bool combineLikeSign = false)
+  std::vector<SVCand>& getSVCandPool(const C& /*collisions*/, bool combineLikeSign = false)
   {
     gsl::span<std::vector<TrackCand>> track0Pool{trackCandPool.data(), 2};
     gsl::span<std::vector<TrackCand>> track1Pool{trackCandPool.data() + 2, 2};
-    std::array<std::vector<int>, 2> mVtxTrack0{}; // 1st pos. and neg. track of the kink pool for each vertex
-
-    for (int i = 0; i < 2; i++) {
-      mVtxTrack0[i].clear();
-      mVtxTrack0[i].resize(collisions.size(), -1);
-    }
 
+    // sweep over the track1 brackets in increasing order of bracket start.
+    // track0 starting before track1 are kept in the active window until they end before track1.
     for (int pn = 0; pn < 2; pn++) {
-      auto& vtxFirstT = mVtxTrack0[pn];
       const auto& signTrack0Pool = track0Pool[pn];
-      for (unsigned i = 0; i < signTrack0Pool.size(); i++) {
-        const auto& track0Seed = signTrack0Pool[i];
-        LOG(debug) << "Processsing track0 with index: " << track0Seed.Idxtr << " min bracket: " << track0Seed.collBracket.getMin() << " max bracket: " << track0Seed.collBracket.getMax();
-        for (int j{track0Seed.collBracket.getMin()}; j <= track0Seed.collBracket.getMax(); ++j) {
-          if (vtxFirstT[j] == -1) {
-            vtxFirstT[j] = i;
-          }
-        }
-      }
       int track1sign = combineLikeSign ? pn : 1 - pn;
-      auto& signTrack1 = track1Pool[track1sign];
-      for (unsigned itp = 0; itp < signTrack1.size(); itp++) {
-        auto& track1Seed = signTrack1[itp];
+      const auto& signTrack1Pool = track1Pool[track1sign];
+      sortByBracketStart(signTrack0Pool, sortedTrack0);
+      sortByBracketStart(signTrack1Pool, sortedTrack1);
+      activeTrack0.clear();
+
+      size_t nextTrack0 = 0;
+      for (const auto& itp : sortedTrack1) {
+        const auto& track1Seed = signTrack1Pool[itp];
         LOG(debug) << "Processing track1 with index: " << track1Seed.Idxtr << " min bracket: " << track1Seed.collBracket.getMin() << " max bracket: " << track1Seed.collBracket.getMax();
-        int firsOverlapIdx = -1;
-        for (int j{track1Seed.collBracket.getMin()}; j <= track1Seed.collBracket.getMax(); ++j) {
-          LOG(debug) << "Checking vtxFirstT at position " << j << " with value " << vtxFirstT[j];
-          if (vtxFirstT[j] != -1) {
-            firsOverlapIdx = vtxFirstT[j];
-            break;
-          }
-        }
-        if (firsOverlapIdx < 0) {
-          continue;
+        while (nextTrack0 < sortedTrack0.size() && signTrack0Pool[sortedTrack0[nextTrack0]].collBracket.getMin() <= track1Seed.collBracket.getMin()) {
+          activeTrack0.emplace_back(sortedTrack0[nextTrack0++]);
         }
-        for (unsigned itn = firsOverlapIdx; itn < signTrack0Pool.size(); itn++) {
-          auto& track0Seed = signTrack0Pool[itn];
+        std::erase_if(activeTrack0, [&](int itn) { return signTrack0Pool[itn].collBracket.getMax() < track1Seed.collBracket.getMin(); });
 
+        for (const auto& itn : activeTrack0) {
+          const auto& track0Seed = signTrack0Pool[itn];
+          svCandPool.emplace_back(SVCand{track0Seed.Idxtr, track1Seed.Idxtr, track0Seed.collBracket.getOverlap(track1Seed.collBracket)});
+        }
+        // track0 starting inside the track1 bracket
+        for (size_t k = nextTrack0; k < sortedTrack0.size(); k++) {
+          const auto& track0Seed = signTrack0Pool[sortedTrack0[k]];
           if (track0Seed.collBracket.getMin() > track1Seed.collBracket.getMax()) {
             break;
           }
-
-          if (track0Seed.collBracket.isOutside(track1Seed.collBracket)) {
-            LOG(debug) << "Brackets do not match";
-            continue;
-          }
-          auto overlapBracket = track0Seed.collBracket.getOverlap(track1Seed.collBracket);
-
-          svCandPool.emplace_back(SVCand{track0Seed.Idxtr, track1Seed.Idxtr, overlapBracket});
+          svCandPool.emplace_back(SVCand{track0Seed.Idxtr, track1Seed.Idxtr, track0Seed.collBracket.getOverlap(track1Seed.collBracket)});
         }
       }
     }
@@ -259,12 +236,23 @@ class svPoolCreator
   int track1Pdg;
   float timeMarginNS = 600.;
   bool skipAmbiTracks = false;
-  std::unordered_map<int, std::pair<int, int>> tmap;
-  std::unordered_map<uint64_t, int> bc2Coll;
+  static constexpr uint64_t BcInvalid = -1;
+  std::vector<std::pair<int, int>> trackPoolPosition;  // position (index in pool, pool index) of each track in trackCandPool, indexed by global track index. -1 if not in the pool
+  o2::common::core::BCIndex bcIndex;                   // global BC of each collision and collisions sorted by global BC
 
   std::array<std::vector<TrackCand>, 4> trackCandPool; // Sorting: dau0 pos, dau0 neg, dau1 pos, dau1 neg
   std::vector<SVCand> svCandPool;                      // index of the two tracks in the track table
   TrackCand trForpool;
+  std::vector<int> sortedTrack0; // indices of track0 in the pool, sorted by the bracket start
+  std::vector<int> sortedTrack1; // indices of track1 in the pool, sorted by the bracket start
+  std::vector<int> activeTrack0; // track0 overlapping with the bracket start of the current track1
+
+  void sortByBracketStart(const std::vector<TrackCand>& pool, std::vector<int>& sorted)
+  {
+    sorted.resize(pool.size());
+    std::iota(sorted.begin(), sorted.end(), 0);
+    std::sort(sorted.begin(), sorted.end(), [&pool](int a, int b) { return pool[a].collBracket.getMin() < pool[b].collBracket.getMin(); });
+  }
 };
 
 #endif // PWGLF_UTILS_SVPOOLCREATOR_H_
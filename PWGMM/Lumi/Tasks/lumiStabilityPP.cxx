@@ -32,6 +32,8 @@
 #include <Framework/Array2D.h>
 #include <Framework/Configurable.h>
 
+#include <array>
+#include <bitset>
 #include <limits>
 #include <map>
 #include <memory>
@@ -126,7 +128,26 @@ struct LumiStabilityPP {
   int nBCsPerTF;
   int64_t currentTFid = -1;
 
-  void init(InitContext&) {}
+  // BC categories fixed by the filling scheme (A, B, C, E, L, NL) for each BC ID, and the enabled categories
+  std::array<uint16_t, o2::constants::lhc::LHCMaxBunches> bcCategoryMask{};
+  uint16_t enabledBCCategories{0};
+
+  // per data frame counters, the per-BC histograms are filled from them at the end of the data frame
+  std::vector<std::array<int, NBCCategories>> nBCsPerBcId;
+  std::vector<std::array<std::array<int, NBCCategories>, NTriggerAliases>> nTriggersPerBcId;
+  std::vector<int> nInspectedBCsPerBcId;
+  std::array<std::array<int, NBCCategories>, NTriggerAliases> nTriggersPerTimeBin{};
+  TAxis* timeBinning = nullptr;
+  int currentTimeBin{-1};
+
+  void init(InitContext&)
+  {
+    for (int iBCCategory{0}; iBCCategory < NBCCategories; ++iBCCategory) {
+      if (doTypeBC->get(0u, iBCCategory)) {
+        enabledBCCategories |= 1 << iBCCategory;
+      }
+    }
+  }
 
   void createHistograms()
   {
@@ -220,6 +241,12 @@ struct LumiStabilityPP {
     }
     LOG(info) << "bcPatternL creation complete. Total leading BCs found: " << totalLeadingBCs;
 
+    for (int iBC = 0; iBC < o2::constants::lhc::LHCMaxBunches; iBC++) {
+      bcCategoryMask[iBC] = (bcPatternA[iBC] << BCA) | (bcPatternB[iBC] << BCB) | (bcPatternC[iBC] << BCC) | (bcPatternE[iBC] << BCE) | (bcPatternL[iBC] << BCL) | ((bcPatternB[iBC] && !bcPatternL[iBC]) << BCNL);
+    }
+    timeBinning = histTfPerMin[runNumber]->GetXaxis();
+    currentTimeBin = -1;
+
     auto runInfo = o2::parameters::AggregatedRunInfo::buildAggregatedRunInfo(o2::ccdb::BasicCCDBManager::instance(), runNumber, metadataInfo.get("LPMProductionTag"));
     bcSOR = runInfo.orbitSOR * nBCsPerOrbit; // first bc of the first orbit
     LOG(info) << "BC SOR: " << bcSOR << " (orbit SOR: " << runInfo.orbitSOR << ") NBCs per orbit: " << nBCsPerOrbit;
@@ -241,12 +268,47 @@ struct LumiStabilityPP {
     return -std::log(1.f - ntriggers / nbc);
   }
 
-  template <int iTrigger, int iBCCategory>
-  void fillHistograms(float timeSinceSOF, int64_t localBC, int& nTriggers)
+  // adds n unweighted entries to a bin: same content, errors and entries as n calls to Fill
+  static void addCounts(TH1* hist, int bin, int n)
   {
-    nTriggers += 1;
-    histBcVsTime[iTrigger][iBCCategory][runNumber]->Fill(timeSinceSOF);
-    histBcVsBcId[iTrigger][iBCCategory][runNumber]->Fill(localBC);
+    hist->AddBinContent(bin, n);
+    if (hist->GetSumw2N() > 0) {
+      hist->GetSumw2()->AddAt(hist->GetSumw2()->At(bin) + n, bin);
+    }
+    hist->SetEntries(hist->GetEntries() + n);
+  }
+
+  void flushTimeCounts()
+  {
+    for (int iTrigger{0}; iTrigger < NTriggerAliases; ++iTrigger) {
+      for (int iBCCategory{0}; iBCCategory < NBCCategories; ++iBCCategory) {
+        if (nTriggersPerTimeBin[iTrigger][iBCCategory] > 0) {
+          addCounts(histBcVsTime[iTrigger][iBCCategory][runNumber].get(), currentTimeBin, nTriggersPerTimeBin[iTrigger][iBCCategory]);
+          nTriggersPerTimeBin[iTrigger][iBCCategory] = 0;
+        }
+      }
+    }
+  }
+
+  // categories of a BC given its position in the orbit and its (non-)super-leading flags, restricted to the enabled ones
+  uint16_t getBCCategories(int localBC, bool isSuperLeadingBcFDD, bool isSuperLeadingBcFT0) const
+  {
+    uint16_t categories = bcCategoryMask[localBC];
+    if (isSuperLeadingBcFDD) {
+      categories |= 1 << BCSLFDD;
+    }
+    if (isSuperLeadingBcFT0) {
+      categories |= 1 << BCSLFT0;
+    }
+    if (bcPatternB[localBC]) {
+      if (!isSuperLeadingBcFDD) {
+        categories |= 1 << BCNSLFDD;
+      }
+      if (!isSuperLeadingBcFT0) {
+        categories |= 1 << BCNSLFT0;
+      }
+    }
+    return categories & enabledBCCategories;
   }
 
   void process(BCsWithTimeStamps const& bcs,
@@ -254,15 +316,9 @@ struct LumiStabilityPP {
                aod::FDDs const&)
   {
     int64_t globalBCIdOfLastBCWithActivityFDD{0}, globalBCIdOfLastBCWithActivityFT0{0}, globalBCLastInspectedBC{-1};
-    std::vector<std::array<int, NBCCategories>> nBCsPerBcId;
-    nBCsPerBcId.resize(nBCsPerOrbit);
-    std::fill(&nBCsPerBcId[0][0], &nBCsPerBcId[0][0] + (static_cast<int>(nBCsPerOrbit) * static_cast<int>(NBCCategories)), 0); // Initialize to 0
-    std::vector<std::array<std::array<int, NBCCategories>, NTriggerAliases>> nTriggersPerBcId;
-    nTriggersPerBcId.resize(nBCsPerOrbit);
-    std::fill(&nTriggersPerBcId[0][0][0], &nTriggersPerBcId[0][0][0] + (static_cast<int>(nBCsPerOrbit) * static_cast<int>(NTriggerAliases) * static_cast<int>(NBCCategories)), 0); // Initialize to 0
-
-    int nTriggersPerDf[NTriggerAliases][NBCCategories];
-    std::fill(&nTriggersPerDf[0][0], &nTriggersPerDf[0][0] + (static_cast<int>(NTriggerAliases) * static_cast<int>(NBCCategories)), 0); // Initialize to 0
+    nBCsPerBcId.assign(nBCsPerOrbit, {});
+    nTriggersPerBcId.assign(nBCsPerOrbit, {});
+    nInspectedBCsPerBcId.assign(nBCsPerOrbit, 0);
 
     double rate{-1.};
     for (const auto& bc : bcs) {
@@ -271,6 +327,9 @@ struct LumiStabilityPP {
         continue;
       }
 
+      if (bc.runNumber() != runNumber && runNumber >= 0) {
+        flushTimeCounts();
+      }
       setLHCIFData(bc);
       int bcShiftFDD{0};
       if (isData23) {
@@ -279,6 +338,11 @@ struct LumiStabilityPP {
         bcShiftFDD = 0;
       }
       float timeSinceSOF = getTimeSinceSOF(bc);
+      int timeBin = timeBinning->FindFixBin(timeSinceSOF);
+      if (timeBin != currentTimeBin) {
+        flushTimeCounts();
+        currentTimeBin = timeBin;
+      }
 
       std::bitset<64> ctpInputMask(bc.inputMask());
       if (ctpInputMask.test(2)) {
@@ -325,33 +389,13 @@ struct LumiStabilityPP {
       }
       for (int64_t iGlobalBC{globalBCStart}; iGlobalBC <= globalBC; ++iGlobalBC) { // we count all BCs in between one and another stored in the AO2Ds
         int iLocalBC = iGlobalBC % nBCsPerOrbit;
-        if (bcPatternA[iLocalBC]) {
-          nBCsPerBcId[iLocalBC][BCA]++;
-        }
+        uint16_t categories = bcCategoryMask[iLocalBC];
         if (bcPatternB[iLocalBC]) {
-          nBCsPerBcId[iLocalBC][BCB]++;
-          if (iGlobalBC - globalBCIdOfLastBCWithActivityFDD > numEmptyBCsBeforeLeadingBC) {
-            nBCsPerBcId[iLocalBC][BCSLFDD]++;
-          } else {
-            nBCsPerBcId[iLocalBC][BCNSLFDD]++;
-          }
-          if (iGlobalBC - globalBCIdOfLastBCWithActivityFT0 > numEmptyBCsBeforeLeadingBC) {
-            nBCsPerBcId[iLocalBC][BCSLFT0]++;
-          } else {
-            nBCsPerBcId[iLocalBC][BCNSLFT0]++;
-          }
-          if (!bcPatternL[iLocalBC]) {
-            nBCsPerBcId[iLocalBC][BCNL]++;
-          }
-        }
-        if (bcPatternC[iLocalBC]) {
-          nBCsPerBcId[iLocalBC][BCC]++;
-        }
-        if (bcPatternE[iLocalBC]) {
-          nBCsPerBcId[iLocalBC][BCE]++;
+          categories |= 1 << ((iGlobalBC - globalBCIdOfLastBCWithActivityFDD > numEmptyBCsBeforeLeadingBC) ? BCSLFDD : BCNSLFDD);
+          categories |= 1 << ((iGlobalBC - globalBCIdOfLastBCWithActivityFT0 > numEmptyBCsBeforeLeadingBC) ? BCSLFT0 : BCNSLFT0);
         }
-        if (bcPatternL[iLocalBC]) {
-          nBCsPerBcId[iLocalBC][BCL]++;
+        for (int iBCCategory{0}; iBCCategory < NBCCategories; ++iBCCategory) {
+          nBCsPerBcId[iLocalBC][iBCCategory] += (categories >> iBCCategory) & 1;
         }
       }
 
@@ -362,118 +406,55 @@ struct LumiStabilityPP {
         histTfPerMin[runNumber]->Fill(timeSinceSOF);
       }
 
+      // FT0 based triggers use the BC ID of the BC, FDD the shifted one
+      const uint16_t categoriesFT0 = getBCCategories(localBC, isSuperLeadingBcFDD, isSuperLeadingBcFT0);
+      const uint16_t categoriesFDD = getBCCategories(localBCFDD, isSuperLeadingBcFDD, isSuperLeadingBcFT0);
+      const bool isTriggered[NTriggerAliases]{true, ctpInputMask.test(2), ctpInputMask.test(4), ctpInputMask.test(15)};
       for (int iTrigger{0}; iTrigger < NTriggerAliases; ++iTrigger) {
+        if (!isTriggered[iTrigger]) {
+          continue;
+        }
+        const int bcId = iTrigger == FDD ? localBCFDD : localBC;
+        const uint16_t categories = iTrigger == FDD ? categoriesFDD : categoriesFT0;
         for (int iBCCategory{0}; iBCCategory < NBCCategories; ++iBCCategory) {
-          if (doTypeBC->get(0u, iBCCategory)) {
-            if (iTrigger == AllBCs) {
-              if (iBCCategory == BCA && bcPatternA[localBC])
-                fillHistograms<AllBCs, BCA>(timeSinceSOF, localBC, nTriggersPerBcId[localBC][iTrigger][iBCCategory]);
-              if (iBCCategory == BCB && bcPatternB[localBC])
-                fillHistograms<AllBCs, BCB>(timeSinceSOF, localBC, nTriggersPerBcId[localBC][iTrigger][iBCCategory]);
-              if (iBCCategory == BCC && bcPatternC[localBC])
-                fillHistograms<AllBCs, BCC>(timeSinceSOF, localBC, nTriggersPerBcId[localBC][iTrigger][iBCCategory]);
-              if (iBCCategory == BCE && bcPatternE[localBC])
-                fillHistograms<AllBCs, BCE>(timeSinceSOF, localBC, nTriggersPerBcId[localBC][iTrigger][iBCCategory]);
-              if (iBCCategory == BCL && bcPatternL[localBC])
-                fillHistograms<AllBCs, BCL>(timeSinceSOF, localBC, nTriggersPerBcId[localBC][iTrigger][iBCCategory]);
-              if (iBCCategory == BCSLFDD && isSuperLeadingBcFDD)
-                fillHistograms<AllBCs, BCSLFDD>(timeSinceSOF, localBC, nTriggersPerBcId[localBC][iTrigger][iBCCategory]);
-              if (iBCCategory == BCSLFT0 && isSuperLeadingBcFT0)
-                fillHistograms<AllBCs, BCSLFT0>(timeSinceSOF, localBC, nTriggersPerBcId[localBC][iTrigger][iBCCategory]);
-              if (iBCCategory == BCNL && !bcPatternL[localBC] && bcPatternB[localBC])
-                fillHistograms<AllBCs, BCNL>(timeSinceSOF, localBC, nTriggersPerBcId[localBC][iTrigger][iBCCategory]);
-              if (iBCCategory == BCNSLFDD && !isSuperLeadingBcFDD && bcPatternB[localBC])
-                fillHistograms<AllBCs, BCNSLFDD>(timeSinceSOF, localBC, nTriggersPerBcId[localBC][iTrigger][iBCCategory]);
-              if (iBCCategory == BCNSLFT0 && !isSuperLeadingBcFT0 && bcPatternB[localBC])
-                fillHistograms<AllBCs, BCNSLFT0>(timeSinceSOF, localBC, nTriggersPerBcId[localBC][iTrigger][iBCCategory]);
-            }
-            if (iTrigger == FT0Vtx && ctpInputMask.test(2)) {
-              if (iBCCategory == BCA && bcPatternA[localBC])
-                fillHistograms<FT0Vtx, BCA>(timeSinceSOF, localBC, nTriggersPerBcId[localBC][iTrigger][iBCCategory]);
-              if (iBCCategory == BCB && bcPatternB[localBC])
-                fillHistograms<FT0Vtx, BCB>(timeSinceSOF, localBC, nTriggersPerBcId[localBC][iTrigger][iBCCategory]);
-              if (iBCCategory == BCC && bcPatternC[localBC])
-                fillHistograms<FT0Vtx, BCC>(timeSinceSOF, localBC, nTriggersPerBcId[localBC][iTrigger][iBCCategory]);
-              if (iBCCategory == BCE && bcPatternE[localBC])
-                fillHistograms<FT0Vtx, BCE>(timeSinceSOF, localBC, nTriggersPerBcId[localBC][iTrigger][iBCCategory]);
-              if (iBCCategory == BCL && bcPatternL[localBC])
-                fillHistograms<FT0Vtx, BCL>(timeSinceSOF, localBC, nTriggersPerBcId[localBC][iTrigger][iBCCategory]);
-              if (iBCCategory == BCSLFDD && isSuperLeadingBcFDD)
-                fillHistograms<FT0Vtx, BCSLFDD>(timeSinceSOF, localBC, nTriggersPerBcId[localBC][iTrigger][iBCCategory]);
-              if (iBCCategory == BCSLFT0 && isSuperLeadingBcFT0)
-                fillHistograms<FT0Vtx, BCSLFT0>(timeSinceSOF, localBC, nTriggersPerBcId[localBC][iTrigger][iBCCategory]);
-              if (iBCCategory == BCNL && !bcPatternL[localBC] && bcPatternB[localBC])
-                fillHistograms<FT0Vtx, BCNL>(timeSinceSOF, localBC, nTriggersPerBcId[localBC][iTrigger][iBCCategory]);
-              if (iBCCategory == BCNSLFDD && !isSuperLeadingBcFDD && bcPatternB[localBC])
-                fillHistograms<FT0Vtx, BCNSLFDD>(timeSinceSOF, localBC, nTriggersPerBcId[localBC][iTrigger][iBCCategory]);
-              if (iBCCategory == BCNSLFT0 && !isSuperLeadingBcFT0 && bcPatternB[localBC])
-                fillHistograms<FT0Vtx, BCNSLFT0>(timeSinceSOF, localBC, nTriggersPerBcId[localBC][iTrigger][iBCCategory]);
-            }
-            if (iTrigger == FT0CE && ctpInputMask.test(4)) {
-              if (iBCCategory == BCA && bcPatternA[localBC])
-                fillHistograms<FT0CE, BCA>(timeSinceSOF, localBC, nTriggersPerBcId[localBC][iTrigger][iBCCategory]);
-              if (iBCCategory == BCB && bcPatternB[localBC])
-                fillHistograms<FT0CE, BCB>(timeSinceSOF, localBC, nTriggersPerBcId[localBC][iTrigger][iBCCategory]);
-              if (iBCCategory == BCC && bcPatternC[localBC])
-                fillHistograms<FT0CE, BCC>(timeSinceSOF, localBC, nTriggersPerBcId[localBC][iTrigger][iBCCategory]);
-              if (iBCCategory == BCE && bcPatternE[localBC])
-                fillHistograms<FT0CE, BCE>(timeSinceSOF, localBC, nTriggersPerBcId[localBC][iTrigger][iBCCategory]);
-              if (iBCCategory == BCL && bcPatternL[localBC])
-                fillHistograms<FT0CE, BCL>(timeSinceSOF, localBC, nTriggersPerBcId[localBC][iTrigger][iBCCategory]);
-              if (iBCCategory == BCSLFDD && isSuperLeadingBcFDD)
-                fillHistograms<FT0CE, BCSLFDD>(timeSinceSOF, localBC, nTriggersPerBcId[localBC][iTrigger][iBCCategory]);
-              if (iBCCategory == BCSLFT0 && isSuperLeadingBcFT0)
-                fillHistograms<FT0CE, BCSLFT0>(timeSinceSOF, localBC, nTriggersPerBcId[localBC][iTrigger][iBCCategory]);
-              if (iBCCategory == BCNL && !bcPatternL[localBC] && bcPatternB[localBC])
-                fillHistograms<FT0CE, BCNL>(timeSinceSOF, localBC, nTriggersPerBcId[localBC][iTrigger][iBCCategory]);
-              if (iBCCategory == BCNSLFDD && !isSuperLeadingBcFDD && bcPatternB[localBC])
-                fillHistograms<FT0CE, BCNSLFDD>(timeSinceSOF, localBC, nTriggersPerBcId[localBC][iTrigger][iBCCategory]);
-              if (iBCCategory == BCNSLFT0 && !isSuperLeadingBcFT0 && bcPatternB[localBC])
-                fillHistograms<FT0CE, BCNSLFT0>(timeSinceSOF, localBC, nTriggersPerBcId[localBC][iTrigger][iBCCategory]);
-            }
-            if (iTrigger == FDD && ctpInputMask.test(15)) {
-              if (iBCCategory == BCA && bcPatternA[localBCFDD])
-                fillHistograms<FDD, BCA>(timeSinceSOF, localBCFDD, nTriggersPerBcId[localBCFDD][iTrigger][iBCCategory]);
-              if (iBCCategory == BCB && bcPatternB[localBCFDD])
-                fillHistograms<FDD, BCB>(timeSinceSOF, localBCFDD, nTriggersPerBcId[localBCFDD][iTrigger][iBCCategory]);
-              if (iBCCategory == BCC && bcPatternC[localBCFDD])
-                fillHistograms<FDD, BCC>(timeSinceSOF, localBCFDD, nTriggersPerBcId[localBCFDD][iTrigger][iBCCategory]);
-              if (iBCCategory == BCE && bcPatternE[localBCFDD])
-                fillHistograms<FDD, BCE>(timeSinceSOF, localBCFDD, nTriggersPerBcId[localBCFDD][iTrigger][iBCCategory]);
-              if (iBCCategory == BCL && bcPatternL[localBCFDD])
-                fillHistograms<FDD, BCL>(timeSinceSOF, localBCFDD, nTriggersPerBcId[localBCFDD][iTrigger][iBCCategory]);
-              if (iBCCategory == BCSLFDD && isSuperLeadingBcFDD)
-                fillHistograms<FDD, BCSLFDD>(timeSinceSOF, localBCFDD, nTriggersPerBcId[localBCFDD][iTrigger][iBCCategory]);
-              if (iBCCategory == BCSLFT0 && isSuperLeadingBcFT0)
-                fillHistograms<FDD, BCSLFT0>(timeSinceSOF, localBCFDD, nTriggersPerBcId[localBCFDD][iTrigger][iBCCategory]);
-              if (iBCCategory == BCNL && !bcPatternL[localBCFDD] && bcPatternB[localBCFDD])
-                fillHistograms<FDD, BCNL>(timeSinceSOF, localBCFDD, nTriggersPerBcId[localBCFDD][iTrigger][iBCCategory]);
-              if (iBCCategory == BCNSLFDD && !isSuperLeadingBcFDD && bcPatternB[localBCFDD])
-                fillHistograms<FDD, BCNSLFDD>(timeSinceSOF, localBCFDD, nTriggersPerBcId[localBCFDD][iTrigger][iBCCategory]);
-              if (iBCCategory == BCNSLFT0 && !isSuperLeadingBcFT0 && bcPatternB[localBCFDD])
-                fillHistograms<FDD, BCNSLFT0>(timeSinceSOF, localBCFDD, nTriggersPerBcId[localBCFDD][iTrigger][iBCCategory]);
-            }
+          if ((categories >> iBCCategory) & 1) {
+            nTriggersPerBcId[bcId][iTrigger][iBCCategory]++;
+            nTriggersPerTimeBin[iTrigger][iBCCategory]++;
           }
         }
       }
-      histNBcsVsBcId[runNumber]->Fill(localBC);
+      nInspectedBCsPerBcId[localBC]++;
       if (globalBCLastInspectedBC < globalBC) {
         globalBCLastInspectedBC = globalBC;
       } else {
         globalBCLastInspectedBC = -1;
       }
     }
-    // fill histogram for mu
+    if (runNumber < 0) {
+      return;
+    }
+    flushTimeCounts();
+
+    // fill the histograms vs BC ID and the histograms for mu
+    for (int iBcId{0}; iBcId < nBCsPerOrbit; ++iBcId) {
+      if (nInspectedBCsPerBcId[iBcId] > 0) {
+        addCounts(histNBcsVsBcId[runNumber].get(), iBcId + 1, nInspectedBCsPerBcId[iBcId]);
+      }
+    }
     for (int iTrigger{0}; iTrigger < NTriggerAliases; ++iTrigger) {
       for (int iBCCategory{0}; iBCCategory < NBCCategories; ++iBCCategory) {
         if (doTypeBC->get(0u, iBCCategory)) {
           int nTotBCs{0};
           int nTotTriggers{0};
           for (int iBcId{0}; iBcId < nBCsPerOrbit; ++iBcId) {
-            float muPerBcId = getMu(nTriggersPerBcId[iBcId][iTrigger][iBCCategory], nBCsPerBcId[iBcId][iBCCategory]);
+            const int nTriggersBcId = nTriggersPerBcId[iBcId][iTrigger][iBCCategory];
+            if (nTriggersBcId > 0) {
+              addCounts(histBcVsBcId[iTrigger][iBCCategory][runNumber].get(), iBcId + 1, nTriggersBcId);
+            }
+            float muPerBcId = getMu(nTriggersBcId, nBCsPerBcId[iBcId][iBCCategory]);
             histMuPerBcId[iTrigger][iBCCategory][runNumber]->Fill(iBcId, muPerBcId);
             nTotBCs += nBCsPerBcId[iBcId][iBCCategory];
-            nTotTriggers += nTriggersPerBcId[iBcId][iTrigger][iBCCategory];
+            nTotTriggers += nTriggersBcId;
           }
           float mu = getMu(nTotTriggers, nTotBCs);
           histMu[iTrigger][iBCCategory][runNumber]->Fill(mu);
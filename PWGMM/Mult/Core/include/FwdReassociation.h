@@ -0,0 +1,97 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#ifndef PWGMM_MULT_CORE_INCLUDE_FWDREASSOCIATION_H_
+#define PWGMM_MULT_CORE_INCLUDE_FWDREASSOCIATION_H_
+
+#include "ReconstructionDataFormats/TrackFwd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace pwgmm::mult
+{
+// Best DCAxy association of a forward track among its compatible collisions.
+// The candidates are visited ordered by their distance in z from the track, so that
+// the track parameters (without covariance) are moved by short steps
+// along the helix instead of jumping back and forth between the vertices.
+class FwdTrackReassociation
+{
+ public:
+  void clear()
+  {
+    mCollisionIds.clear();
+    mPositions.clear();
+    mDCAs.clear();
+  }
+
+  void addCandidate(int64_t collisionId, float posX, float posY, float posZ)
+  {
+    mCollisionIds.push_back(collisionId);
+    mPositions.push_back({posX, posY, posZ});
+  }
+
+  size_t size() const { return mCollisionIds.size(); }
+  int64_t collisionId(size_t i) const { return mCollisionIds[i]; }
+  float posZ(size_t i) const { return mPositions[i].z; }
+  float dcaX(size_t i) const { return mDCAs[i].x; }
+  float dcaY(size_t i) const { return mDCAs[i].y; }
+  float dcaXY(size_t i) const { return mDCAs[i].xy; }
+
+  /// Propagates trackPar to the z of each candidate and returns the index (in insertion order) of the
+  /// candidate with the smallest DCAxy below maxDCA, or -1. Ties go to the first inserted candidate.
+  /// bestPar is set to the parameters at the best candidate.
+  int findBestDCAxy(o2::track::TrackParFwd trackPar, float bZ, o2::track::TrackParFwd& bestPar, float maxDCA = 999.f)
+  {
+    const size_t n = mCollisionIds.size();
+    mDCAs.resize(n);
+    mOrder.resize(n);
+    std::iota(mOrder.begin(), mOrder.end(), 0);
+    const double z0 = trackPar.getZ();
+    std::sort(mOrder.begin(), mOrder.end(), [this, z0](int a, int b) {
+      return std::abs(mPositions[a].z - z0) < std::abs(mPositions[b].z - z0);
+    });
+
+    int best = -1;
+    float bestDCA = maxDCA;
+    for (const auto i : mOrder) {
+      trackPar.propagateParamToZhelix(mPositions[i].z, bZ); // track parameters propagation to the position of the z vertex
+      const float dX = trackPar.getX() - mPositions[i].x;
+      const float dY = trackPar.getY() - mPositions[i].y;
+      mDCAs[i] = {dX, dY, std::sqrt(dX * dX + dY * dY)};
+      if (mDCAs[i].xy < bestDCA || (best >= 0 && mDCAs[i].xy == bestDCA && i < best)) {
+        best = i;
+        bestDCA = mDCAs[i].xy;
+        bestPar = trackPar;
+      }
+    }
+    return best;
+  }
+
+ private:
+  struct Position {
+    float x, y, z;
+  };
+  struct DCA {
+    float x, y, xy;
+  };
+
+  std::vector<int64_t> mCollisionIds;
+  std::vector<Position> mPositions;
+  std::vector<DCA> mDCAs;
+  std::vector<int> mOrder;
+};
+} // namespace pwgmm::mult
+
+#endif // PWGMM_MULT_CORE_INCLUDE_FWDREASSOCIATION_H_
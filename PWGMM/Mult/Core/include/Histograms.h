@@ -11,9 +11,15 @@
 
 #ifndef PWGMM_MULT_CORE_INCLUDE_HISTOGRAMS_H_
 #define PWGMM_MULT_CORE_INCLUDE_HISTOGRAMS_H_
+#include "Framework/HistogramSpec.h"
+
+#include "TAxis.h"
 #include "TPDGCode.h"
+
 #include <array>
+#include <cstdint>
 #include <string_view>
+#include <vector>
 
 namespace pwgmm::mult
 {
@@ -120,6 +126,86 @@ static constexpr std::string_view MCEtaResolution = "Particles/EtaResolution";
 static constexpr std::string_view Mask = "Tracks/Control/Mask";           // reco status bitmask
 static constexpr std::string_view ITSlayers = "Tracks/Control/ITSLayers"; // ITS layers hit distribution
 } // namespace histograms
+
+// Per-event track counts in the eta bins of a histogram axis, for up to 32 selections at once.
+// The coordinates other than eta (vtx Z, centrality, occupancy) are constant within an event, so the
+// histograms can be filled once per non-empty bin, with the count as weight, instead of once per track.
+class EtaBinCounter
+{
+ public:
+  void setAxis(o2::framework::AxisSpec const& spec, int nSelections = 1)
+  {
+    if (spec.nBins.has_value()) {
+      mAxis.Set(*spec.nBins, spec.binEdges[0], spec.binEdges[1]);
+    } else {
+      mAxis.Set(spec.binEdges.size() - 1, spec.binEdges.data());
+    }
+    mNBins = mAxis.GetNbins() + 2; // with under- and overflow
+    mNSelections = nSelections;
+    mCounts.assign(mNBins * mNSelections, 0);
+    mIsTouched.assign(mNBins, false);
+    mTouched.clear();
+  }
+
+  /// clears the counts, to be called at the start of each event
+  void reset()
+  {
+    for (const auto bin : mTouched) {
+      for (int iSel = 0; iSel < mNSelections; ++iSel) {
+        mCounts[iSel * mNBins + bin] = 0;
+      }
+      mIsTouched[bin] = false;
+    }
+    mTouched.clear();
+  }
+
+  /// counts the track in each selection with its bit set in selMask
+  void count(float eta, uint32_t selMask = 1u)
+  {
+    const int bin = mAxis.FindFixBin(eta);
+    for (int iSel = 0; iSel < mNSelections; ++iSel) {
+      if (selMask & (1u << iSel)) {
+        ++mCounts[iSel * mNBins + bin];
+      }
+    }
+    if (!mIsTouched[bin]) {
+      mIsTouched[bin] = true;
+      mTouched.push_back(bin);
+    }
+  }
+
+  /// calls fill(eta, count) for each non-empty bin of the selection, eta is the bin center
+  /// (or a value outside the axis range for the under- and overflow bins)
+  template <typename F>
+  void flush(int iSelection, F&& fill) const
+  {
+    for (const auto bin : mTouched) {
+      const auto n = mCounts[iSelection * mNBins + bin];
+      if (n > 0) {
+        fill(binValue(bin), static_cast<float>(n));
+      }
+    }
+  }
+
+ private:
+  float binValue(int bin) const
+  {
+    if (bin == 0) {
+      return mAxis.GetXmin() - 1.f;
+    }
+    if (bin == mNBins - 1) {
+      return mAxis.GetXmax() + 1.f;
+    }
+    return mAxis.GetBinCenter(bin);
+  }
+
+  TAxis mAxis;
+  int mNBins = 0;
+  int mNSelections = 1;
+  std::vector<int32_t> mCounts; // [selection][bin]
+  std::vector<bool> mIsTouched; // [bin]
+  std::vector<int> mTouched;    // bins counted since the last reset, each listed once
+};
 } // namespace pwgmm::mult
 
 #endif // PWGMM_MULT_CORE_INCLUDE_HISTOGRAMS_H_
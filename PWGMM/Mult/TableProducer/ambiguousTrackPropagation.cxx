@@ -18,6 +18,7 @@
 /// \author Gyula Bencedi <gyula.bencedi@cern.ch>
 /// \author Tulika Tripathy <tulika.tripathy@cern.ch>
 
+#include "FwdReassociation.h"
 #include "bestCollisionTable.h"
 
 #include "Common/Core/fwdtrackUtilities.h"
@@ -90,6 +91,8 @@ struct AmbiguousTrackPropagation {
     } //
   };
 
+  pwgmm::mult::FwdTrackReassociation fwdReassociation;
+
   using ExtBCs = soa::Join<aod::BCs, aod::Timestamps, aod::MatchedBCCollisionsSparseMulti>;
 
   void init(o2::framework::InitContext& /*initContext*/)
@@ -275,21 +278,16 @@ struct AmbiguousTrackPropagation {
     initCCDB(bcs.begin());
 
     // Minimum only on DCAxy
-    float dcaInfo = 0.f;
     float bestDCA = 0.f, bestDCAx = 0.f, bestDCAy = 0.f;
-    o2::track::TrackParCovFwd bestTrackPar;
+    o2::track::TrackParFwd bestTrackPar;
 
     for (auto const& atrack : atracks) {
-      dcaInfo = 999; // DCAxy
       bestDCA = 999;
 
       auto track = atrack.mfttrack();
       auto bestCol = track.has_collision() ? track.collisionId() : -1;
 
-      o2::track::TrackParCovFwd trackPar = o2::aod::fwdtrackutils::getTrackParCovFwdShift(track, mZShift);
-
-      int degree = 0; // degree of ambiguity of the track
-
+      fwdReassociation.clear();
       auto compatibleBCs = atrack.bc_as<ExtBCs>();
       for (auto const& bc : compatibleBCs) {
         if (!bc.has_collisions()) {
@@ -297,34 +295,30 @@ struct AmbiguousTrackPropagation {
         }
         auto collisions = bc.collisions();
         for (auto const& collision : collisions) {
-          degree++;
-          trackPar.propagateToZhelix(collision.posZ(), bZ); // track parameters propagation to the position of the z vertex
-
-          const auto dcaX(trackPar.getX() - collision.posX());
-          const auto dcaY(trackPar.getY() - collision.posY());
-          dcaInfo = std::sqrt(dcaX * dcaX + dcaY * dcaY);
-
-          if ((dcaInfo < bestDCA)) {
-            bestCol = collision.globalIndex();
-            bestDCA = dcaInfo;
-            bestDCAx = dcaX;
-            bestDCAy = dcaY;
-            bestTrackPar = trackPar;
-          }
+          fwdReassociation.addCandidate(collision.globalIndex(), collision.posX(), collision.posY(), collision.posZ());
+        }
+      }
+      int degree = fwdReassociation.size(); // degree of ambiguity of the track
 
-          if (produceHistos) {
-            registry.fill(HIST("TracksDCAXY"), dcaInfo);
-          }
-          if ((track.collisionId() != collision.globalIndex()) && produceHistos) {
-            registry.fill(HIST("DeltaZ"), track.collision().posZ() - collision.posZ()); // deltaZ between the 1st coll zvtx and the other compatible ones
-          }
+      o2::track::TrackParCovFwd trackPar = o2::aod::fwdtrackutils::getTrackParCovFwdShift(track, mZShift);
+      auto best = fwdReassociation.findBestDCAxy(trackPar, bZ, bestTrackPar, bestDCA);
+      if (best >= 0) {
+        bestCol = fwdReassociation.collisionId(best);
+        bestDCA = fwdReassociation.dcaXY(best);
+        bestDCAx = fwdReassociation.dcaX(best);
+        bestDCAy = fwdReassociation.dcaY(best);
+      }
 
-          if ((collision.globalIndex() == track.collisionId()) && produceHistos) {
-            registry.fill(HIST("TracksOrigDCAXY"), dcaInfo);
+      if (produceHistos) {
+        for (auto iColl = 0u; iColl < fwdReassociation.size(); ++iColl) {
+          registry.fill(HIST("TracksDCAXY"), fwdReassociation.dcaXY(iColl));
+          if (track.collisionId() != fwdReassociation.collisionId(iColl)) {
+            registry.fill(HIST("DeltaZ"), track.collision().posZ() - fwdReassociation.posZ(iColl)); // deltaZ between the 1st coll zvtx and the other compatible ones
+          } else {
+            registry.fill(HIST("TracksOrigDCAXY"), fwdReassociation.dcaXY(iColl));
           }
         }
       }
-
       if ((bestCol != track.collisionId()) && produceHistos) {
         // reassigned
         registry.fill(HIST("ReassignedDCAXY"), bestDCA);
@@ -358,12 +352,10 @@ struct AmbiguousTrackPropagation {
     }
     initCCDB(bcs.begin());
 
-    float dcaInfo = 0.f;
     float bestDCA = 0.f, bestDCAx = 0.f, bestDCAy = 0.f;
-    o2::track::TrackParCovFwd bestTrackPar;
+    o2::track::TrackParFwd bestTrackPar;
 
     for (auto const& track : tracks) {
-      dcaInfo = 999; // DCAxy
       bestDCA = 999;
 
       auto bestCol = track.has_collision() ? track.collisionId() : -1;
@@ -376,32 +368,29 @@ struct AmbiguousTrackPropagation {
 
       auto compatibleColls = track.compatibleColl();
 
-      o2::track::TrackParCovFwd trackPar = o2::aod::fwdtrackutils::getTrackParCovFwdShift(track, mZShift);
-
+      fwdReassociation.clear();
       for (auto const& collision : compatibleColls) {
+        fwdReassociation.addCandidate(collision.globalIndex(), collision.posX(), collision.posY(), collision.posZ());
+      }
 
-        trackPar.propagateToZhelix(collision.posZ(), bZ); // track parameters propagation to the position of the z vertex
-
-        const auto dcaX(trackPar.getX() - collision.posX());
-        const auto dcaY(trackPar.getY() - collision.posY());
-        dcaInfo = std::sqrt(dcaX * dcaX + dcaY * dcaY);
-
-        if ((dcaInfo < bestDCA)) {
-          bestCol = collision.globalIndex();
-          bestDCA = dcaInfo;
-          bestDCAx = dcaX;
-          bestDCAy = dcaY;
-          bestTrackPar = trackPar;
-        }
-        if ((track.collisionId() != collision.globalIndex()) && produceHistos) {
-          registry.fill(HIST("DeltaZ"), track.collision().posZ() - collision.posZ()); // deltaZ between the 1st coll zvtx and the other compatible ones
-        }
-        if (produceHistos) {
-          registry.fill(HIST("TracksDCAXY"), dcaInfo);
-        }
+      o2::track::TrackParCovFwd trackPar = o2::aod::fwdtrackutils::getTrackParCovFwdShift(track, mZShift);
+      auto best = fwdReassociation.findBestDCAxy(trackPar, bZ, bestTrackPar, bestDCA);
+      if (best >= 0) {
+        bestCol = fwdReassociation.collisionId(best);
+        bestDCA = fwdReassociation.dcaXY(best);
+        bestDCAx = fwdReassociation.dcaX(best);
+        bestDCAy = fwdReassociation.dcaY(best);
+      }
 
-        if ((collision.globalIndex() == track.collisionId()) && produceHistos) {
-          registry.fill(HIST("TracksOrigDCAXY"), dcaInfo);
+      if (produceHistos) {
+        for (auto iColl = 0u; iColl < fwdReassociation.size(); ++iColl) {
+          if (track.collisionId() != fwdReassociation.collisionId(iColl)) {
+            registry.fill(HIST("DeltaZ"), track.collision().posZ() - fwdReassociation.posZ(iColl)); // deltaZ between the 1st coll zvtx and the other compatible ones
+          }
+          registry.fill(HIST("TracksDCAXY"), fwdReassociation.dcaXY(iColl));
+          if (fwdReassociation.collisionId(iColl) == track.collisionId()) {
+            registry.fill(HIST("TracksOrigDCAXY"), fwdReassociation.dcaXY(iColl));
+          }
         }
       }
       if ((bestCol != track.collisionId()) && produceHistos) {
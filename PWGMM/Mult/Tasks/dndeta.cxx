@@ -115,6 +115,7 @@ struct MultiplicityCounter {
 
   void init(InitContext&)
   {
+    etaCounter.setAxis(EtaAxis);
     AxisSpec MultAxis = {multBinning};
     AxisSpec CentAxis = {centBinning, "centrality"};
     AxisSpec OccuAxis = {occuBinning, "occupancy"};
@@ -488,6 +489,31 @@ struct MultiplicityCounter {
     return Ntrks;
   }
 
+  // per event eta counts of the selected tracks, for the INEL>0 eta vs. vtx Z distributions
+  EtaBinCounter etaCounter;
+
+  template <typename C>
+  void fillEtaZvtxGt0(bool gt0, bool PVgt0, float z, float c, float o)
+  {
+    etaCounter.flush(0, [&](float eta, float n) {
+      if constexpr (has_reco_cent<C>) {
+        if (gt0) {
+          binnedRegistry.fill(HIST(EtaZvtx_gt0), eta, z, c, o, n);
+        }
+        if (PVgt0) {
+          binnedRegistry.fill(HIST(EtaZvtx_PVgt0), eta, z, c, o, n);
+        }
+      } else {
+        if (gt0) {
+          inclusiveRegistry.fill(HIST(EtaZvtx_gt0), eta, z, o, n);
+        }
+        if (PVgt0) {
+          inclusiveRegistry.fill(HIST(EtaZvtx_PVgt0), eta, z, o, n);
+        }
+      }
+    });
+  }
+
   template <typename C>
   void processCountingGeneral(
     typename C::iterator const& collision,
@@ -522,14 +548,11 @@ struct MultiplicityCounter {
           if (Ntrks > 0) {
             binnedRegistry.fill(HIST(EventSelection), static_cast<float>(EvSelBins::kSelectedgt0), c, o);
           }
+          etaCounter.reset();
           for (auto& track : tracks) {
-            if (Ntrks > 0) {
-              binnedRegistry.fill(HIST(EtaZvtx_gt0), track.eta(), z, c, o);
-            }
-            if (INELgt0PV) {
-              binnedRegistry.fill(HIST(EtaZvtx_PVgt0), track.eta(), z, c, o);
-            }
+            etaCounter.count(track.eta());
           }
+          fillEtaZvtxGt0<C>(Ntrks > 0, INELgt0PV, z, c, o);
         }
         binnedRegistry.fill(HIST(NtrkZvtx), Ntrks, z, c, o);
         binnedRegistry.fill(HIST(NpvcZvtx), groupPVContrib.size(), z, c, o);
@@ -541,14 +564,11 @@ struct MultiplicityCounter {
           if (Ntrks > 0) {
             inclusiveRegistry.fill(HIST(EventSelection), static_cast<float>(EvSelBins::kSelectedgt0), o);
           }
+          etaCounter.reset();
           for (auto& track : tracks) {
-            if (Ntrks > 0) {
-              inclusiveRegistry.fill(HIST(EtaZvtx_gt0), track.eta(), z, o);
-            }
-            if (INELgt0PV) {
-              inclusiveRegistry.fill(HIST(EtaZvtx_PVgt0), track.eta(), z, o);
-            }
+            etaCounter.count(track.eta());
           }
+          fillEtaZvtxGt0<C>(Ntrks > 0, INELgt0PV, z, c, o);
         }
         inclusiveRegistry.fill(HIST(NtrkZvtx), Ntrks, z, o);
         inclusiveRegistry.fill(HIST(NpvcZvtx), groupPVContrib.size(), z, o);
@@ -697,13 +717,9 @@ struct MultiplicityCounter {
           if (Ntrks > 0) {
             binnedRegistry.fill(HIST(EventSelection), static_cast<float>(EvSelBins::kSelectedgt0), c, o);
           }
+          etaCounter.reset();
           for (auto& track : atracks) {
-            if (Ntrks > 0) {
-              binnedRegistry.fill(HIST(EtaZvtx_gt0), track.track_as<FiTracks>().eta(), z, c, o);
-            }
-            if (INELgt0PV) {
-              binnedRegistry.fill(HIST(EtaZvtx_PVgt0), track.track_as<FiTracks>().eta(), z, c, o);
-            }
+            etaCounter.count(track.track_as<FiTracks>().eta());
           }
           for (auto& track : tracks) {
             if (std::find(usedTracksIds.begin(), usedTracksIds.end(), track.globalIndex()) != usedTracksIds.end()) {
@@ -712,13 +728,9 @@ struct MultiplicityCounter {
             if (std::find(usedTracksIdsDF.begin(), usedTracksIdsDF.end(), track.globalIndex()) != usedTracksIdsDF.end()) {
               continue;
             }
-            if (Ntrks > 0) {
-              binnedRegistry.fill(HIST(EtaZvtx_gt0), track.eta(), z, c, o);
-            }
-            if (INELgt0PV) {
-              binnedRegistry.fill(HIST(EtaZvtx_PVgt0), track.eta(), z, c, o);
-            }
+            etaCounter.count(track.eta());
           }
+          fillEtaZvtxGt0<C>(Ntrks > 0, INELgt0PV, z, c, o);
         }
         binnedRegistry.fill(HIST(NtrkZvtx), Ntrks, z, c, o);
         binnedRegistry.fill(HIST(NpvcZvtx), groupPVContrib.size(), z, c, o);
@@ -730,13 +742,9 @@ struct MultiplicityCounter {
           if (Ntrks > 0) {
             inclusiveRegistry.fill(HIST(EventSelection), static_cast<float>(EvSelBins::kSelectedgt0), o);
           }
+          etaCounter.reset();
           for (auto& track : atracks) {
-            if (Ntrks > 0) {
-              inclusiveRegistry.fill(HIST(EtaZvtx_gt0), track.track_as<FiTracks>().eta(), z, o);
-            }
-            if (INELgt0PV) {
-              inclusiveRegistry.fill(HIST(EtaZvtx_PVgt0), track.track_as<FiTracks>().eta(), z, o);
-            }
+            etaCounter.count(track.track_as<FiTracks>().eta());
           }
           for (auto& track : tracks) {
             if (std::find(usedTracksIds.begin(), usedTracksIds.end(), track.globalIndex()) != usedTracksIds.end()) {
@@ -745,13 +753,9 @@ struct MultiplicityCounter {
             if (std::find(usedTracksIdsDF.begin(), usedTracksIdsDF.end(), track.globalIndex()) != usedTracksIdsDF.end()) {
               continue;
             }
-            if (Ntrks > 0) {
-              inclusiveRegistry.fill(HIST(EtaZvtx_gt0), track.eta(), z, o);
-            }
-            if (INELgt0PV) {
-              inclusiveRegistry.fill(HIST(EtaZvtx_PVgt0), track.eta(), z, o);
-            }
+            etaCounter.count(track.eta());
           }
+          fillEtaZvtxGt0<C>(Ntrks > 0, INELgt0PV, z, c, o);
         }
         inclusiveRegistry.fill(HIST(NtrkZvtx), Ntrks, z, o);
         inclusiveRegistry.fill(HIST(NpvcZvtx), groupPVContrib.size(), z, o);
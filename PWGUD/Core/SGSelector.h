@@ -155,6 +155,55 @@ class SGSelector
     result.value = gA && gC ? o2::aod::sgselector::DoubleGap : (gA ? o2::aod::sgselector::SingleGapA : o2::aod::sgselector::SingleGapC);
     return result;
   }
+  // Same selection as above, with the compatible BC range and its FIT activity taken from the
+  // per data frame summary fitActivity (filled from bcs with the same cuts) instead of a BC slice
+  template <typename CC, typename BCs, typename BC>
+  SelectionResult<BC> IsSelected(SGCutParHolder const& diffCuts, CC const& collision, udhelpers::FITBCActivity const& fitActivity, BCs const& bcs, BC const& oldbc)
+  {
+    SelectionResult<BC> result;
+    if (collision.numContrib() < diffCuts.minNTracks() || collision.numContrib() > diffCuts.maxNTracks()) {
+      result.value = o2::aod::sgselector::TrkOutOfRange; // 4
+      result.bc = std::make_shared<BC>(oldbc);
+      return result;
+    }
+    const auto [first, last] = fitActivity.compatibleRange(collision, diffCuts.NDtcoll(), diffCuts.minNBCs());
+    const bool gA = fitActivity.cleanA(first, last);
+    const bool gC = fitActivity.cleanC(first, last);
+    if (!gA && !gC) {
+      result.value = o2::aod::sgselector::NoUpc; // gap = 3
+      result.bc = std::make_shared<BC>(oldbc);
+      return result;
+    }
+
+    // single gap: the active BC of the other side closest to the original BC
+    int64_t newbcRow = oldbc.globalIndex();
+    if (!gA) {
+      newbcRow = fitActivity.closestActiveA(first, last, oldbc.globalBC());
+    }
+    if (!gC) {
+      newbcRow = fitActivity.closestActiveC(first, last, oldbc.globalBC());
+    }
+    if (gA && gC) { // so-called DG events: the most active FT0 BC
+      float ampa = 0;
+      float ampc = 0;
+      auto [newdgaRow, newdgcRow] = fitActivity.maxFT0Amplitudes(first, last, ampa, ampc);
+      if (newdgaRow < 0) {
+        newdgaRow = oldbc.globalIndex();
+      }
+      if (newdgcRow < 0) {
+        newdgcRow = oldbc.globalIndex();
+      }
+      if (newdgaRow != newdgcRow) {
+        if (ampc / diffCuts.FITAmpLimits()[2] > ampa / diffCuts.FITAmpLimits()[1])
+          newdgaRow = newdgcRow;
+      }
+      newbcRow = newdgaRow;
+    }
+    result.bc = std::make_shared<BC>(newbcRow == oldbc.globalIndex() ? oldbc : bcs.iteratorAt(newbcRow));
+    result.value = gA && gC ? o2::aod::sgselector::DoubleGap : (gA ? o2::aod::sgselector::SingleGapA : o2::aod::sgselector::SingleGapC);
+    return result;
+  }
+
   template <typename TFwdTrack>
   int FwdTrkSelector(TFwdTrack const& fwdtrack)
   {
@@ -19,6 +19,7 @@
 #include "PWGUD/Core/DGCutparHolder.h"
 #include "PWGUD/Core/UPCHelpers.h"
 
+#include "Common/Core/BCIndex.h"
 #include "Common/DataModel/EventSelection.h"
 #include "Common/DataModel/TrackSelectionTables.h"
 
@@ -29,7 +30,10 @@
 
 #include "TLorentzVector.h"
 
+#include <algorithm>
 #include <bitset>
+#include <cmath>
+#include <utility>
 #include <vector>
 
 // namespace with helpers for UD framework
@@ -195,13 +199,41 @@ T compatibleBCs(C const& collision, int ndt, T const& bcs, int nMinBCs = 7)
 template <typename T>
 T compatibleBCs(uint64_t const& meanBC, int const& deltaBC, T const& bcs)
 {
-  // find BC with globalBC ~ meanBC
-  uint64_t ind = static_cast<uint64_t>(bcs.size() / 2);
-  auto bcIter = bcs.iteratorAt(ind);
+  // find BC with globalBC ~ meanBC, bisecting the BCs table instead of walking it from its middle
+  int64_t low = 0;
+  int64_t high = bcs.size() > 0 ? bcs.size() - 1 : 0;
+  while (low < high) {
+    int64_t mid = low + (high - low) / 2;
+    if (bcs.iteratorAt(mid).globalBC() < meanBC) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  auto bcIter = bcs.iteratorAt(low);
 
   return compatibleBCs(bcIter, meanBC, deltaBC, bcs);
 }
 
+// In this variant of compatibleBCs the slice of BCs with globalBC in meanBC +- deltaBC is found
+// with the BCIndex built once per data frame from the same BCs table.
+template <typename T>
+T compatibleBCs(o2::common::core::BCIndex const& bcIndex, uint64_t const& meanBC, int const& deltaBC, T const& bcs)
+{
+  if (!bcIndex.bcsSorted() || bcIndex.nBCs() != bcs.size()) {
+    return compatibleBCs(meanBC, deltaBC, bcs);
+  }
+  uint64_t minBC = static_cast<uint64_t>(deltaBC) < meanBC ? meanBC - static_cast<uint64_t>(deltaBC) : 0;
+  uint64_t maxBC = meanBC + static_cast<uint64_t>(deltaBC);
+  auto [minBCId, maxBCId] = bcIndex.bcRange(minBC, maxBC);
+
+  // create bc slice
+  T bcslice{{bcs.asArrowTable()->Slice(minBCId, maxBCId - minBCId)}, static_cast<uint64_t>(minBCId)};
+  bcs.copyIndexBindings(bcslice);
+  LOGF(debug, "  size of slice %d", bcslice.size());
+  return bcslice;
+}
+
 // -----------------------------------------------------------------------------
 // Same as above but for collisions with MC information
 template <typename F, typename T>
@@ -417,14 +449,14 @@ bool cleanFDD(T& bc, float maxFITtime, float limitA, float limitC)
 //  lims[4]: FDDC
 
 template <typename T>
-bool cleanFIT(T& bc, float maxFITtime, std::vector<float> lims)
+bool cleanFIT(T& bc, float maxFITtime, std::vector<float> const& lims)
 {
   return cleanFV0(bc, maxFITtime, lims[0]) &&
          cleanFT0(bc, maxFITtime, lims[1], lims[2]) &&
          cleanFDD(bc, maxFITtime, lims[3], lims[4]);
 }
 template <typename T>
-bool cleanFITCollision(T& col, float maxFITtime, std::vector<float> lims)
+bool cleanFITCollision(T& col, float maxFITtime, std::vector<float> const& lims)
 {
   bool isCleanFV0 = true;
   if (col.has_foundFV0()) {
@@ -445,7 +477,7 @@ bool cleanFITCollision(T& col, float maxFITtime, std::vector<float> lims)
 
 // -----------------------------------------------------------------------------
 template <typename T>
-bool cleanFITA(T& bc, float maxFITtime, std::vector<float> lims)
+bool cleanFITA(T& bc, float maxFITtime, std::vector<float> const& lims)
 {
   return cleanFV0(bc, maxFITtime, lims[0]) &&
          cleanFT0A(bc, maxFITtime, lims[1]) &&
@@ -454,12 +486,136 @@ bool cleanFITA(T& bc, float maxFITtime, std::vector<float> lims)
 
 // -----------------------------------------------------------------------------
 template <typename T>
-bool cleanFITC(T& bc, float maxFITtime, std::vector<float> lims)
+bool cleanFITC(T& bc, float maxFITtime, std::vector<float> const& lims)
 {
   return cleanFT0C(bc, maxFITtime, lims[2]) &&
          cleanFDDC(bc, maxFITtime, lims[4]);
 }
 
+// -----------------------------------------------------------------------------
+// Per data frame summary of the FIT activity of the BCs, filled once from the
+// BCs table. It allows to evaluate the A/C side gap conditions of any range of
+// compatible BCs in O(1) (prefix counts of the BCs with FIT activity) instead
+// of re-reading the FIT tables for each collision.
+// A BC is active on the A (C) side if cleanFITA (cleanFITC) is false.
+class FITBCActivity
+{
+ public:
+  template <typename TBCs>
+  void fill(TBCs const& bcs, float maxFITtime, std::vector<float> const& lims)
+  {
+    const int64_t nBCs = bcs.size();
+    mGlobalBCs.resize(nBCs);
+    mAmpFT0A.resize(nBCs);
+    mAmpFT0C.resize(nBCs);
+    mNActiveA.resize(nBCs + 1);
+    mNActiveC.resize(nBCs + 1);
+    mPrevActiveA.resize(nBCs);
+    mPrevActiveC.resize(nBCs);
+    mNextActiveA.resize(nBCs);
+    mNextActiveC.resize(nBCs);
+    mNActiveA[0] = 0;
+    mNActiveC[0] = 0;
+    int64_t row = 0;
+    for (auto const& bc : bcs) {
+      const bool activeA = !cleanFITA(bc, maxFITtime, lims);
+      const bool activeC = !cleanFITC(bc, maxFITtime, lims);
+      mGlobalBCs[row] = bc.globalBC();
+      mAmpFT0A[row] = bc.has_foundFT0() ? FT0AmplitudeA(bc.foundFT0()) : 0.f;
+      mAmpFT0C[row] = bc.has_foundFT0() ? FT0AmplitudeC(bc.foundFT0()) : 0.f;
+      mNActiveA[row + 1] = mNActiveA[row] + activeA;
+      mNActiveC[row + 1] = mNActiveC[row] + activeC;
+      mPrevActiveA[row] = activeA ? row : (row > 0 ? mPrevActiveA[row - 1] : -1);
+      mPrevActiveC[row] = activeC ? row : (row > 0 ? mPrevActiveC[row - 1] : -1);
+      row++;
+    }
+    for (row = nBCs - 1; row >= 0; row--) {
+      const bool activeA = mNActiveA[row + 1] != mNActiveA[row];
+      const bool activeC = mNActiveC[row + 1] != mNActiveC[row];
+      mNextActiveA[row] = activeA ? row : (row < nBCs - 1 ? mNextActiveA[row + 1] : nBCs);
+      mNextActiveC[row] = activeC ? row : (row < nBCs - 1 ? mNextActiveC[row + 1] : nBCs);
+    }
+  }
+
+  int64_t size() const { return mGlobalBCs.size(); }
+
+  // rows [first, last] of the BCs table with globalBC in meanBC +- deltaBC, first > last if there is none
+  std::pair<int64_t, int64_t> compatibleRange(uint64_t meanBC, int deltaBC) const
+  {
+    const uint64_t minBC = static_cast<uint64_t>(deltaBC) < meanBC ? meanBC - static_cast<uint64_t>(deltaBC) : 0;
+    const uint64_t maxBC = meanBC + static_cast<uint64_t>(deltaBC);
+    const int64_t first = std::lower_bound(mGlobalBCs.begin(), mGlobalBCs.end(), minBC) - mGlobalBCs.begin();
+    const int64_t last = std::upper_bound(mGlobalBCs.begin(), mGlobalBCs.end(), maxBC) - mGlobalBCs.begin() - 1;
+    return {first, last};
+  }
+
+  // same range as compatibleBCs(collision, ndt, bcs, nMinBCs)
+  template <typename C>
+  std::pair<int64_t, int64_t> compatibleRange(C const& collision, int ndt, int nMinBCs = 7) const
+  {
+    if (!collision.has_foundBC() || ndt < 0) {
+      return {0, -1};
+    }
+    uint64_t meanBC = mGlobalBCs[collision.foundBCId()] + std::lround(collision.collisionTime() / o2::constants::lhc::LHCBunchSpacingNS);
+    int deltaBC = std::ceil(collision.collisionTimeRes() / o2::constants::lhc::LHCBunchSpacingNS * ndt);
+    if (deltaBC < nMinBCs) {
+      deltaBC = nMinBCs;
+    }
+    return compatibleRange(meanBC, deltaBC);
+  }
+
+  bool cleanA(int64_t first, int64_t last) const { return first > last || mNActiveA[last + 1] == mNActiveA[first]; }
+  bool cleanC(int64_t first, int64_t last) const { return first > last || mNActiveC[last + 1] == mNActiveC[first]; }
+
+  // row of the active BC in [first, last] closest in globalBC to refBC, the lower one in case of a tie; -1 if there is none
+  int64_t closestActiveA(int64_t first, int64_t last, uint64_t refBC) const { return closestActive(mPrevActiveA, mNextActiveA, first, last, refBC); }
+  int64_t closestActiveC(int64_t first, int64_t last, uint64_t refBC) const { return closestActive(mPrevActiveC, mNextActiveC, first, last, refBC); }
+
+  // rows of the BCs with the largest FT0A and FT0C amplitudes in [first, last], -1 if no amplitude is above 0
+  std::pair<int64_t, int64_t> maxFT0Amplitudes(int64_t first, int64_t last, float& ampA, float& ampC) const
+  {
+    std::pair<int64_t, int64_t> rows{-1, -1};
+    ampA = 0.f;
+    ampC = 0.f;
+    for (int64_t row = first; row <= last; row++) {
+      if (mAmpFT0A[row] > ampA) {
+        ampA = mAmpFT0A[row];
+        rows.first = row;
+      }
+      if (mAmpFT0C[row] > ampC) {
+        ampC = mAmpFT0C[row];
+        rows.second = row;
+      }
+    }
+    return rows;
+  }
+
+ private:
+  int64_t closestActive(std::vector<int64_t> const& prevActive, std::vector<int64_t> const& nextActive, int64_t first, int64_t last, uint64_t refBC) const
+  {
+    if (first > last) {
+      return -1;
+    }
+    const int64_t pivot = std::lower_bound(mGlobalBCs.begin() + first, mGlobalBCs.begin() + last + 1, refBC) - mGlobalBCs.begin();
+    const int64_t below = pivot > first && prevActive[pivot - 1] >= first ? prevActive[pivot - 1] : -1;
+    const int64_t above = pivot <= last && nextActive[pivot] <= last ? nextActive[pivot] : -1;
+    if (below < 0 || above < 0) {
+      return below < 0 ? above : below;
+    }
+    return mGlobalBCs[above] - refBC < refBC - mGlobalBCs[below] ? above : below;
+  }
+
+  std::vector<uint64_t> mGlobalBCs;  // globalBC of each row of the BCs table
+  std::vector<float> mAmpFT0A;       // FT0A amplitude of each row, 0 without FT0
+  std::vector<float> mAmpFT0C;       // FT0C amplitude of each row, 0 without FT0
+  std::vector<int64_t> mNActiveA;    // number of A side active BCs in the rows [0, row)
+  std::vector<int64_t> mNActiveC;    // number of C side active BCs in the rows [0, row)
+  std::vector<int64_t> mPrevActiveA; // last A side active row <= row, -1 if none
+  std::vector<int64_t> mPrevActiveC; // last C side active row <= row, -1 if none
+  std::vector<int64_t> mNextActiveA; // first A side active row >= row, size() if none
+  std::vector<int64_t> mNextActiveC; // first C side active row >= row, size() if none
+};
+
 // -----------------------------------------------------------------------------
 template <typename T>
 bool TVX(T& bc)
@@ -498,7 +654,7 @@ bool TCE(T& bc)
 
 // -----------------------------------------------------------------------------
 template <typename T>
-bool TOR(T& bc, float maxFITtime, std::vector<float> lims)
+bool TOR(T& bc, float maxFITtime, std::vector<float> const& lims)
 {
   auto torA = !cleanFT0A(bc, maxFITtime, lims[1]);
   auto torC = !cleanFT0C(bc, maxFITtime, lims[2]);
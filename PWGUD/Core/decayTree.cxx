@@ -805,6 +805,7 @@ bool decayTree::init(std::string const& parFile, o2::framework::HistogramRegistr
 
   // update the parents information
   updateParents();
+  updateNodes();
 
   // check for eventCuts
   // set default values
@@ -907,6 +908,21 @@ void decayTree::updateParents()
   }
 }
 
+void decayTree::updateNodes()
+{
+  fFinals.assign(fnFinals, nullptr);
+  for (const auto& res : fResonances) {
+    std::vector<resonance*> daughs;
+    for (const auto& daughName : res->getDaughters()) {
+      daughs.push_back(getResonance(daughName));
+    }
+    res->setDaughterResonances(daughs);
+    if (res->isFinal()) {
+      fFinals[res->counter()] = res;
+    }
+  }
+}
+
 void decayTree::reset()
 {
   fStatus = 0;
@@ -1061,29 +1077,6 @@ void decayTree::updateChargeState()
   }
 }
 
-std::size_t decayTree::combHash(std::vector<int>& comb)
-{
-  // comb contains indices to tracks
-  // the combination hash is created from a string which is comprised of a sorted list of track indices
-
-  // sort comb
-  std::map<int, int> m_unsorted;
-  for (size_t cnt = 0; cnt < comb.size(); cnt++) {
-    m_unsorted.insert(std::pair<int, int>(comb[cnt], cnt));
-  }
-  std::vector<int> v_sorted(comb.size());
-  partial_sort_copy(begin(comb), end(comb), begin(v_sorted), end(v_sorted));
-
-  // create the hash
-  std::hash<std::string> hasher;
-  std::string hashstr{""};
-  for (size_t cnt = 0; cnt < comb.size(); cnt++) {
-    hashstr += std::to_string(v_sorted[cnt]);
-  }
-
-  return hasher(hashstr);
-}
-
 // find all permutations of n0 elements
 void decayTree::permutations(std::vector<int>& ref, int n0, int np, std::vector<std::vector<int>>& perms)
 {
@@ -1143,79 +1136,47 @@ int decayTree::permutations(int n0, std::vector<std::vector<int>>& perms)
   return perms.size();
 }
 
-void decayTree::combinations(int n0, std::vector<int>& pool, int np, std::vector<int>& inds, int n,
-                             std::vector<std::vector<int>>& combs)
+bool decayTree::isFinalCandidate(std::vector<int> const& comb)
 {
-  // loop over pool
-  for (auto ii = 0; ii < n0 - n; ii++) {
-
-    inds[n] = pool[ii];
-
-    // if all inds are defined then print them out
-    // else get next inds
-    if (np == 1) {
-
-      std::vector<int> comb(n + 1, 0);
-      for (uint ii = 0; ii < inds.size(); ii++) {
-        comb[ii] = inds[ii];
-      }
-      combs.push_back(comb);
-
-    } else {
-
-      auto n0new = n0 - ii;
-      std::vector<int> newpool(n0new, 0);
-      for (auto kk = 0; kk < n0new; kk++) {
-        newpool[kk] = pool[kk + ii + 1];
-      }
-
-      auto npnew = np - 1;
-      auto nnew = n + 1;
-      combinations(n0new, newpool, npnew, inds, nnew, combs);
+  for (auto ind = 0; ind < fnFinals; ind++) {
+    if (fFinalCandidates[ind * fnTracks + comb[ind]].status < 3) {
+      return false;
     }
   }
+  return true;
 }
 
-// find all possible selections of np out of n0
-int decayTree::combinations(int n0, int np, std::vector<std::vector<int>>& combs)
+void decayTree::computeResonance(resonance* res, std::vector<int> const& comb)
 {
-  // initialisations
-  combs.clear();
-  if (n0 < np) {
-    return 0;
-  }
-
-  std::vector<int> pool(n0, 0);
-  for (auto ii = 0; ii < n0; ii++) {
-    pool[ii] = ii;
+  // if status > 0 then return
+  if (res->status() > 0) {
+    return;
   }
-  std::vector<int> inds(np, 0);
-
-  // iterate recursively
-  combinations(n0, pool, np, inds, 0, combs);
-
-  return combs.size();
-}
 
-std::vector<std::vector<int>> decayTree::combinations(int nPool)
-{
-  // all selections of fnFinals items from nPool elements
-  std::vector<std::vector<int>> combs;
-  combinations(nPool, fnFinals, combs);
-
-  // permute the combinations
-  std::vector<std::vector<int>> copes;
-  for (const auto& comb : combs) {
-    for (const auto& perm : fPermutations) {
-      std::vector<int> cope(fnFinals, 0);
-      for (auto jj = 0; jj < fnFinals; jj++) {
-        cope[perm[jj]] = comb[jj];
-      }
-      copes.push_back(cope);
+  // is this a final state or a resonance
+  if (res->isFinal()) {
+    // is a final, IVM and cuts are computed once per event
+    const auto& candidate = fFinalCandidates[res->counter() * fnTracks + comb[res->counter()]];
+    res->setIVM(candidate.ivm);
+    res->setCharge(candidate.charge);
+    res->setStatus(candidate.status);
+  } else {
+    // is a resonance
+    // loop over daughters
+    TLorentzVector ivm{0., 0., 0., 0.};
+    int charge = 0;
+    for (const auto& daugh : res->getDaughterResonances()) {
+      computeResonance(daugh, comb);
+      ivm += daugh->IVM();
+      charge += daugh->charge();
     }
-  }
+    res->setIVM(ivm);
+    res->setCharge(charge);
+    res->setStatus(1);
 
-  return copes;
+    // apply cuts
+    res->updateStatus();
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -253,6 +253,7 @@ class resonance
   void clearParents() { fParents.clear(); }
   void addParent(std::string parent) { fParents.push_back(parent); }
   void setDaughters(std::vector<std::string>& daughters) { fDaughters = daughters; }
+  void setDaughterResonances(std::vector<resonance*> const& daughters) { fDaughterResonances = daughters; }
   void setIVM(TLorentzVector ivm)
   {
     fIVM = ivm;
@@ -319,6 +320,7 @@ class resonance
   std::vector<int> detectorHits() { return fdetectorHits; }
   std::vector<std::string> getParents() { return fParents; }
   std::vector<std::string> getDaughters() { return fDaughters; }
+  std::vector<resonance*> const& getDaughterResonances() { return fDaughterResonances; }
   double massMin() { return fmassMin; }
   double massMax() { return fmassMax; }
   double ptMin() { return fptMin; }
@@ -415,6 +417,7 @@ class resonance
   // name of parents and daughters
   std::vector<std::string> fParents;
   std::vector<std::string> fDaughters;
+  std::vector<resonance*> fDaughterResonances;
   void updateParents();
 
   // mass, pT, , eta range
@@ -491,51 +494,69 @@ class decayTree
       return decayTreeResType{{"ULS", ULSresults}, {"LS", LSresults}};
     }
 
-    // create all possible track combinations including permutations
-    auto combs = combinations(tracks.size());
+    // compute the finals for all tracks, the tracks which are not accepted as any final are not combined
+    computeFinalCandidates(tracks);
+    auto nPool = static_cast<int>(fPool.size());
 
-    // a vector to keep track of successful combinations
-    std::vector<std::size_t> goodCombs;
-
-    // loop over possible combinations
+    // loop over the selections of fnFinals tracks of the pool, in increasing order
+    fSelection.resize(fnFinals);
+    for (auto ii = 0; ii < fnFinals; ii++) {
+      fSelection[ii] = ii;
+    }
+    fComb.resize(fnFinals);
     LOGF(debug, "New event");
-    for (auto& comb : combs) {
-      std::string scomb("");
-      for (const auto& i : comb) {
-        scomb.append(" ").append(std::to_string(i));
-      }
-      LOGF(debug, "  combination:%s", scomb);
+    while (nPool >= fnFinals) {
+      // loop over the permutations of the selection, only the first accepted permutation is kept
+      for (const auto& perm : fPermutations) {
+        for (auto jj = 0; jj < fnFinals; jj++) {
+          fComb[perm[jj]] = fPool[fSelection[jj]];
+        }
+        if (!isFinalCandidate(fComb)) {
+          continue;
+        }
+        std::string scomb("");
+        for (const auto& i : fComb) {
+          scomb.append(" ").append(std::to_string(i));
+        }
+        LOGF(debug, "  combination:%s", scomb);
 
-      // has an equivalent combination been accepted already?
-      auto newHash = combHash(comb);
-      if (std::find(goodCombs.begin(), goodCombs.end(), newHash) != goodCombs.end()) {
-        LOGF(debug, "    Equivalent combination is already accepted!");
-        continue;
-      }
+        // loop over resonances and compute
+        reset();
+        for (auto res : fResonances) {
+          computeResonance(res, fComb);
+        }
 
-      // loop over resonances and compute
-      reset();
-      for (auto res : fResonances) {
-        computeResonance(res, tracks, comb);
-      }
+        // check angles between daughters of all resonances
+        checkAngles();
 
-      // check angles between daughters of all resonances
-      checkAngles();
+        // check status of all resonances
+        updateStatus();
+        if (fStatus >= 2) {
+          std::map<std::string, reconstructedParticle> recResonances;
+          for (const auto& res : fResonances) {
+            recResonances.insert({res->name(), reconstructedParticle(res->name(), res->IVM(), fComb)});
+          }
 
-      // check status of all resonances
-      updateStatus();
-      if (fStatus >= 2) {
-        goodCombs.push_back(newHash);
-        std::map<std::string, reconstructedParticle> recResonances;
-        for (const auto& res : fResonances) {
-          recResonances.insert({res->name(), reconstructedParticle(res->name(), res->IVM(), comb)});
+          if (fStatus == 2) {
+            ULSresults.push_back(recResonances);
+          } else {
+            LSresults.push_back(recResonances);
+          }
+          break;
         }
+      }
 
-        if (fStatus == 2) {
-          ULSresults.push_back(recResonances);
-        } else {
-          LSresults.push_back(recResonances);
-        }
+      // next selection
+      auto ind = fnFinals - 1;
+      while (ind >= 0 && fSelection[ind] == nPool - fnFinals + ind) {
+        ind--;
+      }
+      if (ind < 0) {
+        break;
+      }
+      fSelection[ind]++;
+      for (auto jj = ind + 1; jj < fnFinals; jj++) {
+        fSelection[jj] = fSelection[jj - 1] + 1;
       }
     }
     auto results = decayTreeResType{{"ULS", ULSresults}, {"LS", LSresults}};
@@ -756,8 +777,21 @@ class decayTree
 
   // number of finals
   int fnFinals;
+  std::vector<resonance*> fFinals;
   std::vector<std::vector<int>> fPermutations;
 
+  // finals computed for all tracks of an event, the memory is kept across events
+  struct finalCandidate {
+    TLorentzVector ivm;
+    int charge;
+    int status;
+  };
+  int fnTracks;                                 //!
+  std::vector<finalCandidate> fFinalCandidates; //! final-major, fnFinals x fnTracks
+  std::vector<int> fPool;                       //! tracks accepted as at least one final
+  std::vector<int> fSelection;                  //! positions in fPool of the selected tracks
+  std::vector<int> fComb;                       //! track of each final
+
   // histogram registry
   std::vector<std::string> fccs;
   std::vector<std::string> fdets;
@@ -767,17 +801,19 @@ class decayTree
   // generate parent information for all resonances
   void updateParents();
 
-  // helper functions to compute combinations and permutations
-  //  combination:  selection of n out of N
+  // link the daughters of all resonances and the finals
+  void updateNodes();
+
+  // helper functions to compute permutations
   //  permutation:  order of n selected items
-  // create all permutations of all combinations
-  std::size_t combHash(std::vector<int>& comb);
   void permutations(std::vector<int>& ref, int n0, int np, std::vector<std::vector<int>>& perms);
   int permutations(int n0, std::vector<std::vector<int>>& perms);
-  void combinations(int n0, std::vector<int>& pool, int np, std::vector<int>& inds, int n,
-                    std::vector<std::vector<int>>& combs);
-  int combinations(int n0, int np, std::vector<std::vector<int>>& combs);
-  std::vector<std::vector<int>> combinations(int nPool);
+
+  // are all tracks of a combination accepted as the respective final
+  bool isFinalCandidate(std::vector<int> const& comb);
+
+  // compute a resonance and its daughters for a combination
+  void computeResonance(resonance* res, std::vector<int> const& comb);
 
   // check all angle requirements
   void checkAngles();
@@ -788,45 +824,30 @@ class decayTree
 
   // templated functions
   template <typename TTs>
-  void computeResonance(resonance* res, TTs const& tracks, std::vector<int>& comb)
+  void computeFinalCandidates(TTs const& tracks)
   {
-    // if status > 0 then return
-    if (res->status() > 0) {
-      return;
-    }
-
-    // initialisations
-    TLorentzVector ivm{0., 0., 0., 0.};
-    int charge = 0;
-
-    // is this a final state or a resonance
-    if (res->isFinal()) {
-      // is a final
-      auto pdgparticle = fPDG->GetParticle(res->pid());
-      auto track = (tracks.begin() + comb[res->counter()]);
-      ivm.SetXYZM(track.px(), track.py(), track.pz(), pdgparticle->Mass());
-      res->setIVM(ivm);
-      res->setCharge(track.sign());
-      res->setStatus(1);
-
-      // apply cuts
-      res->updateStatus(track);
-
-    } else {
-      // is a resonance
-      // loop over daughters
-      for (const auto& daughName : res->getDaughters()) {
-        auto daugh = getResonance(daughName);
-        computeResonance(daugh, tracks, comb);
-        ivm += daugh->IVM();
-        charge += daugh->charge();
+    fnTracks = tracks.size();
+    fFinalCandidates.resize(fnFinals * fnTracks);
+    fPool.clear();
+    auto itrack = 0;
+    for (const auto& track : tracks) {
+      bool isCandidate = false;
+      for (const auto& res : fFinals) {
+        TLorentzVector ivm{0., 0., 0., 0.};
+        ivm.SetXYZM(track.px(), track.py(), track.pz(), fPDG->GetParticle(res->pid())->Mass());
+        res->setIVM(ivm);
+        res->setCharge(track.sign());
+        res->setStatus(1);
+
+        // apply cuts
+        res->updateStatus(track);
+        fFinalCandidates[res->counter() * fnTracks + itrack] = finalCandidate{ivm, track.sign(), res->status()};
+        isCandidate = isCandidate || res->status() >= 3;
       }
-      res->setIVM(ivm);
-      res->setCharge(charge);
-      res->setStatus(1);
-
-      // apply cuts
-      res->updateStatus();
+      if (isCandidate) {
+        fPool.push_back(itrack);
+      }
+      itrack++;
     }
   }
 
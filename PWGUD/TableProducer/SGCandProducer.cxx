@@ -74,6 +74,7 @@ struct SGCandProducer {
 
   // get an SGCutparHolder
   SGCutParHolder sameCuts = SGCutParHolder(); // SGCutparHolder
+  udhelpers::FITBCActivity fitBCActivity;      // FIT activity of the BCs of the current data frame
   Configurable<SGCutParHolder> SGCuts{"SGCuts", {}, "SG event cuts"};
   Configurable<bool> verboseInfo{"verboseInfo", false, "Print general info to terminal; default it false."};
   Configurable<bool> saveAllTracks{"saveAllTracks", true, "save only PV contributors or all tracks associated to a collision"};
@@ -277,6 +278,15 @@ struct SGCandProducer {
 
   PROCESS_SWITCH(SGCandProducer, processCountersTrg, "Produce trigger counters and luminosity histograms", true);
 
+  // summarise the FIT activity of all BCs once per data frame, the gap selection of each
+  // collision then works on its range of compatible BCs without re-reading the FIT tables
+  // (process functions are called in the order of declaration, i.e. before processData/processMcData)
+  void processFITBCActivity(BCs const& bcs, aod::FV0As const&, aod::FT0s const&, aod::FDDs const&)
+  {
+    fitBCActivity.fill(bcs, sameCuts.maxFITtime(), sameCuts.FITAmpLimits());
+  }
+  PROCESS_SWITCH(SGCandProducer, processFITBCActivity, "Evaluate the gap selection from the per data frame FIT activity of the BCs", true);
+
   // function to process reconstructed data
   template <typename TCol>
   void processReco(std::string histdir, TCol const& collision, BCs const& bcs,
@@ -345,9 +355,15 @@ struct SGCandProducer {
     }
     auto newbc = bc;
 
-    // obtain slice of compatible BCs
-    auto bcRange = udhelpers::compatibleBCs(collision, sameCuts.NDtcoll(), bcs, sameCuts.minNBCs());
-    auto isSGEvent = sgSelector.IsSelected(sameCuts, collision, bcRange, bc);
+    // gap selection in the range of compatible BCs
+    SelectionResult<BC> isSGEvent;
+    if (doprocessFITBCActivity) {
+      isSGEvent = sgSelector.IsSelected(sameCuts, collision, fitBCActivity, bcs, bc);
+    } else {
+      // obtain slice of compatible BCs
+      auto bcRange = udhelpers::compatibleBCs(collision, sameCuts.NDtcoll(), bcs, sameCuts.minNBCs());
+      isSGEvent = sgSelector.IsSelected(sameCuts, collision, bcRange, bc);
+    }
     // auto isSGEvent = sgSelector.IsSelected(sameCuts, collision, bcRange, tracks);
     int issgevent = isSGEvent.value;
     if (isSGEvent.bc && issgevent < 2) {
@@ -516,6 +532,29 @@ struct McSGCandProducer {
     "registry",
     {}};
 
+  // flat index maps of the data frame, kept across data frames to reuse the memory
+  // {McCollisionId : udMcCollisionId} and {McParticleId : udMcParticleId}, -1 if not yet saved
+  std::vector<int64_t> mcColIsSaved;
+  std::vector<int64_t> mcPartIsSaved;
+  // UDMcParticles index foreseen for the McParticles of the slice being saved, valid where mcPartSliceStamp equals the current stamp
+  std::vector<int64_t> mcPartNewId;
+  std::vector<int64_t> mcPartSliceStamp;
+  int64_t sliceStamp = 0;
+
+  void resetIndexMaps(int64_t nMcCollisions, int64_t nMcParticles)
+  {
+    mcColIsSaved.assign(nMcCollisions, -1);
+    mcPartIsSaved.assign(nMcParticles, -1);
+    mcPartNewId.assign(nMcParticles, -1);
+    mcPartSliceStamp.assign(nMcParticles, -1);
+    sliceStamp = 0;
+  }
+
+  int64_t savedMcParticle(int64_t mcPartId) const
+  {
+    return (mcPartId >= 0 && mcPartId < static_cast<int64_t>(mcPartIsSaved.size())) ? mcPartIsSaved[mcPartId] : -1;
+  }
+
   template <typename TMcCollision>
   void updateUDMcCollisions(TMcCollision const& mccol, uint64_t globBC)
   {
@@ -531,7 +570,7 @@ struct McSGCandProducer {
   }
 
   template <typename TMcParticle>
-  void updateUDMcParticle(TMcParticle const& McPart, int64_t McCollisionId, std::map<int64_t, int64_t>& mcPartIsSaved)
+  void updateUDMcParticle(TMcParticle const& McPart, int64_t McCollisionId)
   {
     // save McPart
     // mother and daughter indices are set to -1
@@ -540,7 +579,7 @@ struct McSGCandProducer {
     int32_t newdids[2] = {-1, -1};
 
     // update UDMcParticles
-    if (mcPartIsSaved.find(McPart.globalIndex()) == mcPartIsSaved.end()) {
+    if (mcPartIsSaved[McPart.globalIndex()] < 0) {
       outputMcParticles(McCollisionId,
                         McPart.pdgCode(),
                         McPart.statusCode(),
@@ -557,7 +596,7 @@ struct McSGCandProducer {
   }
 
   template <typename TMcParticles>
-  void updateUDMcParticles(TMcParticles const& McParts, int64_t McCollisionId, std::map<int64_t, int64_t>& mcPartIsSaved)
+  void updateUDMcParticles(TMcParticles const& McParts, int64_t McCollisionId)
   {
     // save McParts
     // new mother and daughter ids
@@ -568,40 +607,31 @@ struct McSGCandProducer {
     // Determine the particle indices within the UDMcParticles table
     // before filling the table
     // This is needed to be able to assign the new daughter indices
-    std::map<int64_t, int64_t> oldnew;
+    sliceStamp++;
     auto lastId = outputMcParticles.lastIndex();
     for (const auto& mcpart : McParts) {
       auto oldId = mcpart.globalIndex();
-      if (mcPartIsSaved.find(oldId) != mcPartIsSaved.end()) {
-        oldnew[oldId] = mcPartIsSaved[oldId];
-      } else {
-        lastId++;
-        oldnew[oldId] = lastId;
-      }
+      mcPartNewId[oldId] = mcPartIsSaved[oldId] >= 0 ? mcPartIsSaved[oldId] : ++lastId;
+      mcPartSliceStamp[oldId] = sliceStamp;
     }
 
     // all particles of the McCollision are saved
     for (const auto& mcpart : McParts) {
-      if (mcPartIsSaved.find(mcpart.globalIndex()) == mcPartIsSaved.end()) {
+      if (mcPartIsSaved[mcpart.globalIndex()] < 0) {
         // mothers
         newmids.clear();
         auto oldmids = mcpart.mothersIds();
         for (const auto& oldmid : oldmids) {
-          auto m = McParts.rawIteratorAt(oldmid);
           if (verboseInfoMC)
-            LOGF(debug, "    m %d", m.globalIndex());
-          if (mcPartIsSaved.find(oldmid) != mcPartIsSaved.end()) {
-            newval = mcPartIsSaved[oldmid];
-          } else {
-            newval = -1;
-          }
-          newmids.push_back(newval);
+            LOGF(debug, "    m %d", oldmid);
+          newmids.push_back(savedMcParticle(oldmid));
         }
         // daughters
         auto olddids = mcpart.daughtersIds();
         for (uint ii = 0; ii < olddids.size(); ii++) {
-          if (oldnew.find(olddids[ii]) != oldnew.end()) {
-            newval = oldnew[olddids[ii]];
+          const auto oldId = olddids[ii];
+          if (oldId >= 0 && oldId < static_cast<int64_t>(mcPartSliceStamp.size()) && mcPartSliceStamp[oldId] == sliceStamp) {
+            newval = mcPartNewId[oldId];
           } else {
             newval = -1;
           }
@@ -628,7 +658,7 @@ struct McSGCandProducer {
   }
 
   template <typename TTrack>
-  void updateUDMcTrackLabel(TTrack const& udtrack, std::map<int64_t, int64_t>& mcPartIsSaved)
+  void updateUDMcTrackLabel(TTrack const& udtrack)
   {
     // udtrack (UDTCs) -> track (TCs) -> mcTrack (McParticles) -> udMcTrack (UDMcParticles)
     auto trackId = udtrack.trackId();
@@ -636,11 +666,7 @@ struct McSGCandProducer {
       auto track = udtrack.template track_as<TCs>();
       auto mcTrackId = track.mcParticleId();
       if (mcTrackId >= 0) {
-        if (mcPartIsSaved.find(mcTrackId) != mcPartIsSaved.end()) {
-          outputMcTrackLabels(mcPartIsSaved[mcTrackId], track.mcMask());
-        } else {
-          outputMcTrackLabels(-1, track.mcMask());
-        }
+        outputMcTrackLabels(mcPartIsSaved[mcTrackId], track.mcMask());
       } else {
         outputMcTrackLabels(-1, track.mcMask());
       }
@@ -650,7 +676,7 @@ struct McSGCandProducer {
   }
 
   template <typename TTrack>
-  void updateUDMcTrackLabels(TTrack const& udtracks, std::map<int64_t, int64_t>& mcPartIsSaved)
+  void updateUDMcTrackLabels(TTrack const& udtracks)
   {
     // loop over all tracks
     for (const auto& udtrack : udtracks) {
@@ -660,11 +686,7 @@ struct McSGCandProducer {
         auto track = udtrack.template track_as<TCs>();
         auto mcTrackId = track.mcParticleId();
         if (mcTrackId >= 0) {
-          if (mcPartIsSaved.find(mcTrackId) != mcPartIsSaved.end()) {
-            outputMcTrackLabels(mcPartIsSaved[mcTrackId], track.mcMask());
-          } else {
-            outputMcTrackLabels(-1, track.mcMask());
-          }
+          outputMcTrackLabels(mcPartIsSaved[mcTrackId], track.mcMask());
         } else {
           outputMcTrackLabels(-1, track.mcMask());
         }
@@ -678,12 +700,9 @@ struct McSGCandProducer {
   void procWithSgCand(aod::McCollisions const& mccols, aod::McParticles const& mcparts,
                       UDCCs const& sgcands, UDTCs const& udtracks)
   {
-    // use a hash table to keep track of the McCollisions which have been added to the UDMcCollision table
-    // {McCollisionId : udMcCollisionId}
-    // similar for the McParticles which have been added to the UDMcParticle table
-    // {McParticleId : udMcParticleId}
-    std::map<int64_t, int64_t> mcColIsSaved;
-    std::map<int64_t, int64_t> mcPartIsSaved;
+    // keep track of the McCollisions which have been added to the UDMcCollision table
+    // and of the McParticles which have been added to the UDMcParticle table
+    resetIndexMaps(mccols.size(), mcparts.size());
 
     // loop over McCollisions and UDCCs simultaneously
     auto mccol = mccols.iteratorAt(0);
@@ -733,7 +752,7 @@ struct McSGCandProducer {
         // McParticles are saved
         // but only consider generated events of interest
         if (mcsgId >= 0 && mcOfInterest) {
-          if (mcColIsSaved.find(mcsgId) == mcColIsSaved.end()) {
+          if (mcColIsSaved[mcsgId] < 0) {
             if (verboseInfoMC)
               LOGF(info, "  Saving McCollision %d", mcsgId);
             // update UDMcCollisions
@@ -747,10 +766,10 @@ struct McSGCandProducer {
 
           // update UDMcParticles
           auto mcPartsSlice = mcparts.sliceBy(mcPartsPerMcCollision, mcsgId);
-          updateUDMcParticles(mcPartsSlice, mcColIsSaved[mcsgId], mcPartIsSaved);
+          updateUDMcParticles(mcPartsSlice, mcColIsSaved[mcsgId]);
 
           // update UDMcTrackLabels (for each UDTrack -> UDMcParticles)
-          updateUDMcTrackLabels(sgTracks, mcPartIsSaved);
+          updateUDMcTrackLabels(sgTracks);
 
         } else {
           // If the sgcand has no associated McCollision then only the McParticles which are associated
@@ -769,12 +788,12 @@ struct McSGCandProducer {
               if (track.has_mcParticle()) {
                 auto mcPart = track.mcParticle();
                 auto mcCol = mcPart.mcCollision();
-                if (mcColIsSaved.find(mcCol.globalIndex()) == mcColIsSaved.end()) {
+                if (mcColIsSaved[mcCol.globalIndex()] < 0) {
                   updateUDMcCollisions(mcCol, globBC);
                   mcColIsSaved[mcCol.globalIndex()] = outputMcCollisions.lastIndex();
                 }
-                updateUDMcParticle(mcPart, mcColIsSaved[mcCol.globalIndex()], mcPartIsSaved);
-                updateUDMcTrackLabel(sgtrack, mcPartIsSaved);
+                updateUDMcParticle(mcPart, mcColIsSaved[mcCol.globalIndex()]);
+                updateUDMcTrackLabel(sgtrack);
               } else {
                 outputMcTrackLabels(-1, track.mcMask());
               }
@@ -796,7 +815,7 @@ struct McSGCandProducer {
 
         // update UDMcCollisions and UDMcParticles
         // but only consider generated events of interest
-        if (mcOfInterest && mcColIsSaved.find(mccolId) == mcColIsSaved.end()) {
+        if (mcOfInterest && mcColIsSaved[mccolId] < 0) {
           if (verboseInfoMC)
             LOGF(info, "  Saving McCollision %d", mccolId);
           // update UDMcCollisions
@@ -805,7 +824,7 @@ struct McSGCandProducer {
 
           // update UDMcParticles
           auto mcPartsSlice = mcparts.sliceBy(mcPartsPerMcCollision, mccolId);
-          updateUDMcParticles(mcPartsSlice, mcColIsSaved[mccolId], mcPartIsSaved);
+          updateUDMcParticles(mcPartsSlice, mcColIsSaved[mccolId]);
         }
 
         // advance mccol
@@ -827,12 +846,9 @@ struct McSGCandProducer {
   // updating McTruth data only
   void procWithoutSgCand(aod::McCollisions const& mccols, aod::McParticles const& mcparts)
   {
-    // use a hash table to keep track of the McCollisions which have been added to the UDMcCollision table
-    // {McCollisionId : udMcCollisionId}
-    // similar for the McParticles which have been added to the UDMcParticle table
-    // {McParticleId : udMcParticleId}
-    std::map<int64_t, int64_t> mcColIsSaved;
-    std::map<int64_t, int64_t> mcPartIsSaved;
+    // keep track of the McCollisions which have been added to the UDMcCollision table
+    // and of the McParticles which have been added to the UDMcParticle table
+    resetIndexMaps(mccols.size(), mcparts.size());
 
     // loop over McCollisions
     for (auto const& mccol : mccols) {
@@ -840,7 +856,7 @@ struct McSGCandProducer {
       uint64_t globBC = mccol.bc_as<BCs>().globalBC();
 
       // update UDMcCollisions and UDMcParticles
-      if (mcColIsSaved.find(mccolId) == mcColIsSaved.end()) {
+      if (mcColIsSaved[mccolId] < 0) {
         if (verboseInfoMC)
           LOGF(info, "  Saving McCollision %d", mccolId);
 
@@ -850,7 +866,7 @@ struct McSGCandProducer {
 
         // update UDMcParticles
         auto mcPartsSlice = mcparts.sliceBy(mcPartsPerMcCollision, mccolId);
-        updateUDMcParticles(mcPartsSlice, mcColIsSaved[mccolId], mcPartIsSaved);
+        updateUDMcParticles(mcPartsSlice, mcColIsSaved[mccolId]);
       }
     }
   }
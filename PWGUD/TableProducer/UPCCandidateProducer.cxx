@@ -617,14 +617,20 @@ struct UpcCandProducer {
     }
   }
 
-  void addTrack(std::vector<BCTracksPair>& v, uint64_t bc, int64_t trkId)
+  // (global BC, track ID) pairs collected by the track loops, kept across data frames
+  std::vector<std::pair<uint64_t, int64_t>> fBCTrackIds;
+
+  // fills v with one entry per BC, sorted by global BC, track IDs keep the table order within a BC
+  void groupTracksByBC(std::vector<BCTracksPair>& v)
   {
-    auto it = std::find_if(v.begin(), v.end(),
-                           [bc](const BCTracksPair& element) { return element.first == bc; });
-    if (it != v.end())
-      it->second.push_back(trkId);
-    else
-      v.emplace_back(std::make_pair(bc, std::vector<int64_t>({trkId})));
+    std::stable_sort(fBCTrackIds.begin(), fBCTrackIds.end(),
+                     [](const auto& left, const auto& right) { return left.first < right.first; });
+    for (const auto& [bc, trkId] : fBCTrackIds) {
+      if (v.empty() || v.back().first != bc)
+        v.emplace_back(bc, std::vector<int64_t>{});
+      v.back().second.push_back(trkId);
+    }
+    fBCTrackIds.clear();
   }
 
   // trackType == 0 -> hasTOF
@@ -638,6 +644,7 @@ struct UpcCandProducer {
                            o2::aod::AmbiguousTracks const& /*ambBarrelTracks*/,
                            std::unordered_map<int64_t, uint64_t>& ambBarrelTrBCs)
   {
+    fBCTrackIds.reserve(barrelTracks.size());
     for (const auto& trk : barrelTracks) {
       if (!trk.hasTPC())
         continue;
@@ -663,8 +670,9 @@ struct UpcCandProducer {
       uint64_t bc = trackBC + tint;
       if (nContrib > upcCuts.getMaxNContrib())
         continue;
-      addTrack(bcsMatchedTrIds, bc, trkId);
+      fBCTrackIds.emplace_back(bc, trkId);
     }
+    groupTracksByBC(bcsMatchedTrIds);
   }
 
   template <typename TBCs>
@@ -676,6 +684,7 @@ struct UpcCandProducer {
                             o2::aod::AmbiguousFwdTracks const& /*ambFwdTracks*/,
                             std::unordered_map<int64_t, uint64_t>& ambFwdTrBCs)
   {
+    fBCTrackIds.reserve(fwdTracks.size());
     for (const auto& trk : fwdTracks) {
       if (trk.trackType() != typeFilter)
         continue;
@@ -696,8 +705,9 @@ struct UpcCandProducer {
       uint64_t bc = trackBC + tint;
       if (nContrib > upcCuts.getMaxNContrib())
         continue;
-      addTrack(bcsMatchedTrIds, bc, trkId);
+      fBCTrackIds.emplace_back(bc, trkId);
     }
+    groupTracksByBC(bcsMatchedTrIds);
   }
 
   template <typename TBCs>
@@ -709,6 +719,7 @@ struct UpcCandProducer {
                                   o2::aod::AmbiguousFwdTracks const& /*ambFwdTracks*/,
                                   std::unordered_map<int64_t, uint64_t>& ambFwdTrBCs)
   {
+    fBCTrackIds.reserve(fwdTracks.size());
     for (const auto& trk : fwdTracks) {
       if (trk.trackType() != typeFilter)
         continue;
@@ -736,8 +747,9 @@ struct UpcCandProducer {
       uint64_t bc = trackBC + tint;
       if (nContrib > upcCuts.getMaxNContrib())
         continue;
-      addTrack(bcsMatchedTrIds, bc, trkId);
+      fBCTrackIds.emplace_back(bc, trkId);
     }
+    groupTracksByBC(bcsMatchedTrIds);
   }
 
   int32_t searchTracks(uint64_t midbc, uint64_t range, uint32_t tracksToFind,
@@ -812,11 +824,6 @@ struct UpcCandProducer {
                         bcs, collisions,
                         barrelTracks, ambBarrelTracks, ambBarrelTrBCs);
 
-    std::sort(bcsMatchedTrIdsTOF.begin(), bcsMatchedTrIdsTOF.end(),
-              [](const auto& left, const auto& right) { return left.first < right.first; });
-    std::sort(bcsMatchedTrIdsITSTPC.begin(), bcsMatchedTrIdsITSTPC.end(),
-              [](const auto& left, const auto& right) { return left.first < right.first; });
-
     std::map<uint64_t, int32_t> mapGlobalBcWithTOR{};
     std::map<uint64_t, int32_t> mapGlobalBcWithTVX{};
     std::map<uint64_t, int32_t> mapGlobalBcWithTSC{};
@@ -885,21 +892,14 @@ struct UpcCandProducer {
       fitInfo.distClosestBcTSC = 999;
       fitInfo.distClosestBcTVX = 999;
       fitInfo.distClosestBcV0A = 999;
+      // gap vetoes first, the amplitudes are only summed for the BCs passing them
+      uint64_t closestBcTOR = 0;
+      uint64_t closestBcV0A = 0;
       if (nTORs > 0) {
-        uint64_t closestBcTOR = findClosestBC(globalBC, mapGlobalBcWithTOR);
+        closestBcTOR = findClosestBC(globalBC, mapGlobalBcWithTOR);
         fitInfo.distClosestBcTOR = globalBC - static_cast<int64_t>(closestBcTOR);
         if (std::abs(fitInfo.distClosestBcTOR) <= fFilterFT0)
           return false;
-        auto ft0Id = mapGlobalBcWithTOR.at(closestBcTOR);
-        auto ft0 = ft0s.iteratorAt(ft0Id);
-        fitInfo.timeFT0A = ft0.timeA();
-        fitInfo.timeFT0C = ft0.timeC();
-        const auto& t0AmpsA = ft0.amplitudeA();
-        const auto& t0AmpsC = ft0.amplitudeC();
-        for (auto amp : t0AmpsA)
-          fitInfo.ampFT0A += amp;
-        for (auto amp : t0AmpsC)
-          fitInfo.ampFT0C += amp;
       }
       if (nTSCs > 0) {
         uint64_t closestBcTSC = findClosestBC(globalBC, mapGlobalBcWithTSC);
@@ -914,10 +914,24 @@ struct UpcCandProducer {
           return false;
       }
       if (nFV0As > 0) {
-        uint64_t closestBcV0A = findClosestBC(globalBC, mapGlobalBcWithV0A);
+        closestBcV0A = findClosestBC(globalBC, mapGlobalBcWithV0A);
         fitInfo.distClosestBcV0A = globalBC - static_cast<int64_t>(closestBcV0A);
         if (std::abs(fitInfo.distClosestBcV0A) <= fFilterFV0)
           return false;
+      }
+      if (nTORs > 0) {
+        auto ft0Id = mapGlobalBcWithTOR.at(closestBcTOR);
+        auto ft0 = ft0s.iteratorAt(ft0Id);
+        fitInfo.timeFT0A = ft0.timeA();
+        fitInfo.timeFT0C = ft0.timeC();
+        const auto& t0AmpsA = ft0.amplitudeA();
+        const auto& t0AmpsC = ft0.amplitudeC();
+        for (auto amp : t0AmpsA)
+          fitInfo.ampFT0A += amp;
+        for (auto amp : t0AmpsC)
+          fitInfo.ampFT0C += amp;
+      }
+      if (nFV0As > 0) {
         auto fv0aId = mapGlobalBcWithV0A.at(closestBcV0A);
         auto fv0a = fv0as.iteratorAt(fv0aId);
         fitInfo.timeFV0A = fv0a.time();
@@ -1127,15 +1141,12 @@ struct UpcCandProducer {
     uint32_t nBCsWithITSTPC = bcsMatchedTrIdsITSTPC.size();
     uint32_t nBCsWithMID = bcsMatchedTrIdsMID.size();
 
-    std::sort(bcsMatchedTrIdsMID.begin(), bcsMatchedTrIdsMID.end(),
-              [](const auto& left, const auto& right) { return left.first < right.first; });
-
     std::vector<BCTracksPair> bcsMatchedTrIdsTOFTagged(nBCsWithMID);
     for (const auto& pair : bcsMatchedTrIdsTOF) {
       uint64_t bc = pair.first;
-      auto it = std::find_if(bcsMatchedTrIdsMID.begin(), bcsMatchedTrIdsMID.end(),
-                             [bc](const auto& item) { return item.first == bc; });
-      if (it != bcsMatchedTrIdsMID.end()) {
+      auto it = std::lower_bound(bcsMatchedTrIdsMID.begin(), bcsMatchedTrIdsMID.end(), bc,
+                                 [](const auto& item, uint64_t value) { return item.first < value; });
+      if (it != bcsMatchedTrIdsMID.end() && it->first == bc) {
         uint32_t ibc = it - bcsMatchedTrIdsMID.begin();
         bcsMatchedTrIdsTOFTagged[ibc].second = pair.second;
       }
@@ -1143,9 +1154,6 @@ struct UpcCandProducer {
 
     bcsMatchedTrIdsTOF.clear();
 
-    std::sort(bcsMatchedTrIdsITSTPC.begin(), bcsMatchedTrIdsITSTPC.end(),
-              [](const auto& left, const auto& right) { return left.first < right.first; });
-
     if (nBCsWithITSTPC > 0 && fSearchITSTPC == 1) {
       std::unordered_set<int64_t> matchedTracks;
       for (uint32_t ibc = 0; ibc < nBCsWithMID; ++ibc) {
@@ -1313,12 +1321,6 @@ struct UpcCandProducer {
                          bcs, collisions,
                          fwdTracks, ambFwdTracks, ambFwdTrBCs);
 
-    std::sort(bcsMatchedTrIdsMID.begin(), bcsMatchedTrIdsMID.end(),
-              [](const auto& left, const auto& right) { return left.first < right.first; });
-
-    std::sort(bcsMatchedTrIdsMCH.begin(), bcsMatchedTrIdsMCH.end(),
-              [](const auto& left, const auto& right) { return left.first < right.first; });
-
     std::map<uint64_t, int32_t> mapGlobalBcWithT0A{};
     for (const auto& ft0 : ft0s) {
       if (!TESTBIT(ft0.triggerMask(), o2::fit::Triggers::bitVertex))
@@ -1573,15 +1575,6 @@ struct UpcCandProducer {
                                bcs, collisions,
                                fwdTracks, ambFwdTracks, ambFwdTrBCs);
 
-    std::sort(bcsMatchedTrIdsMID.begin(), bcsMatchedTrIdsMID.end(),
-              [](const auto& left, const auto& right) { return left.first < right.first; });
-
-    std::sort(bcsMatchedTrIdsMCH.begin(), bcsMatchedTrIdsMCH.end(),
-              [](const auto& left, const auto& right) { return left.first < right.first; });
-
-    std::sort(bcsMatchedTrIdsGlobal.begin(), bcsMatchedTrIdsGlobal.end(),
-              [](const auto& left, const auto& right) { return left.first < right.first; });
-
     std::map<uint64_t, int32_t> mapGlobalBcWithT0A{};
     for (const auto& ft0 : ft0s) {
       if (!TESTBIT(ft0.triggerMask(), o2::fit::Triggers::bitVertex))
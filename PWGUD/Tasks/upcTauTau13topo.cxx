@@ -180,6 +180,7 @@ struct TauTau13topo {
   Configurable<int> generatorIDMC{"generatorIDMC", -1, "MC generator ID"};
   Configurable<bool> removeNoTOFrunsInData{"removeNoTOFrunsInData", 1, "1-remove or 0-keep no TOF runs"};
   Configurable<float> occupancyCut{"occupancyCut", 10000., "occupancy cut"};
+  Configurable<bool> fillTrackQA{"fillTrackQA", true, "Fill the per PV track and FIT bit QA histograms of all the candidates, the selection counters are always filled"};
 
   // Configurable<bool> DGactive{"DGactive", false, "Switch on DGproducer"};
   // Configurable<bool> SGactive{"SGactive", true, "Switch on SGproducer"};
@@ -2152,13 +2153,17 @@ struct TauTau13topo {
       qtot += trk.sign();
       // p.SetXYZM(trk.px(), trk.py(), trk.pz(), MassPiPlus);
       p.SetXYZT(trk.px(), trk.py(), trk.pz(), RecoDecay::e(trk.px(), trk.py(), trk.pz(), MassPiPlus));
-      registry.get<TH1>(HIST("global/hTrackPtPV"))->Fill(p.Pt());
       if (std::abs(p.Eta()) < trkEtacut)
         nEtaIn15++; // 1.5 is a default
-      registry.get<TH2>(HIST("global/hTrackEtaPhiPV"))->Fill(p.Eta(), p.Phi());
-
       if (trk.pt() > 0.1)
         npT100++;
+      if (trk.hasTOF())
+        nTofTrk++;
+      if (!fillTrackQA)
+        continue;
+
+      registry.get<TH1>(HIST("global/hTrackPtPV"))->Fill(p.Pt());
+      registry.get<TH2>(HIST("global/hTrackEtaPhiPV"))->Fill(p.Eta(), p.Phi());
 
       if (flagGlobalCheck) {
         if (isGlobalTrackCheck(trk)) {
@@ -2192,8 +2197,6 @@ struct TauTau13topo {
       registry.get<TH2>(HIST("global/hITSnbitsVsEtaPVtrk"))->Fill(p.Eta(), nITSbits);
       if (trk.hasTPC())
         registry.get<TH2>(HIST("global/hSignalTPCvsPtPV"))->Fill(p.Pt(), trk.tpcSignal());
-      if (trk.hasTOF())
-        nTofTrk++;
     } // end of loop over PV tracks
     registry.get<TH1>(HIST("global/hNtofTrk"))->Fill(nTofTrk);
 
@@ -2317,23 +2320,25 @@ struct TauTau13topo {
         flagFITveto = true;
     } // end of loop over FIT bits
     // FIT histos
-    for (auto bit = 0; bit <= 32; bit++) {
-      registry.get<TH1>(HIST("fit/bbFT0Abit"))->Fill(bit, TESTBIT(dgcand.bbFT0Apf(), bit));
-      registry.get<TH1>(HIST("fit/bbFT0Cbit"))->Fill(bit, TESTBIT(dgcand.bbFT0Cpf(), bit));
-      registry.get<TH1>(HIST("fit/bbFV0Abit"))->Fill(bit, TESTBIT(dgcand.bbFV0Apf(), bit));
-      registry.get<TH1>(HIST("fit/bbFDDAbit"))->Fill(bit, TESTBIT(dgcand.bbFDDApf(), bit));
-      registry.get<TH1>(HIST("fit/bbFDDCbit"))->Fill(bit, TESTBIT(dgcand.bbFDDCpf(), bit));
+    if (fillTrackQA) {
+      for (auto bit = 0; bit <= 32; bit++) {
+        registry.get<TH1>(HIST("fit/bbFT0Abit"))->Fill(bit, TESTBIT(dgcand.bbFT0Apf(), bit));
+        registry.get<TH1>(HIST("fit/bbFT0Cbit"))->Fill(bit, TESTBIT(dgcand.bbFT0Cpf(), bit));
+        registry.get<TH1>(HIST("fit/bbFV0Abit"))->Fill(bit, TESTBIT(dgcand.bbFV0Apf(), bit));
+        registry.get<TH1>(HIST("fit/bbFDDAbit"))->Fill(bit, TESTBIT(dgcand.bbFDDApf(), bit));
+        registry.get<TH1>(HIST("fit/bbFDDCbit"))->Fill(bit, TESTBIT(dgcand.bbFDDCpf(), bit));
+      }
+      registry.get<TH1>(HIST("fit/bbFT0Aamplitude"))->Fill(dgcand.totalFT0AmplitudeA());
+      registry.get<TH1>(HIST("fit/bbFT0Camplitude"))->Fill(dgcand.totalFT0AmplitudeC());
+      registry.get<TH2>(HIST("fit/bbFT0ACamplitude"))->Fill(dgcand.totalFT0AmplitudeA(), dgcand.totalFT0AmplitudeC());
+      registry.get<TH1>(HIST("fit/bbFV0Aamplitude"))->Fill(dgcand.totalFV0AmplitudeA());
+      registry.get<TH1>(HIST("fit/bbFDDAamplitude"))->Fill(dgcand.totalFDDAmplitudeA());
+      registry.get<TH1>(HIST("fit/bbFDDCamplitude"))->Fill(dgcand.totalFDDAmplitudeC());
+      registry.get<TH2>(HIST("fit/bbFDDACamplitude"))->Fill(dgcand.totalFDDAmplitudeA(), dgcand.totalFDDAmplitudeC());
+
+      registry.get<TH2>(HIST("fit/timeFT0"))->Fill(dgcand.timeFT0A(), dgcand.timeFT0C());
+      registry.get<TH2>(HIST("fit/timeFDD"))->Fill(dgcand.timeFDDA(), dgcand.timeFDDC());
     }
-    registry.get<TH1>(HIST("fit/bbFT0Aamplitude"))->Fill(dgcand.totalFT0AmplitudeA());
-    registry.get<TH1>(HIST("fit/bbFT0Camplitude"))->Fill(dgcand.totalFT0AmplitudeC());
-    registry.get<TH2>(HIST("fit/bbFT0ACamplitude"))->Fill(dgcand.totalFT0AmplitudeA(), dgcand.totalFT0AmplitudeC());
-    registry.get<TH1>(HIST("fit/bbFV0Aamplitude"))->Fill(dgcand.totalFV0AmplitudeA());
-    registry.get<TH1>(HIST("fit/bbFDDAamplitude"))->Fill(dgcand.totalFDDAmplitudeA());
-    registry.get<TH1>(HIST("fit/bbFDDCamplitude"))->Fill(dgcand.totalFDDAmplitudeC());
-    registry.get<TH2>(HIST("fit/bbFDDACamplitude"))->Fill(dgcand.totalFDDAmplitudeA(), dgcand.totalFDDAmplitudeC());
-
-    registry.get<TH2>(HIST("fit/timeFT0"))->Fill(dgcand.timeFT0A(), dgcand.timeFT0C());
-    registry.get<TH2>(HIST("fit/timeFDD"))->Fill(dgcand.timeFDDA(), dgcand.timeFDDC());
 
     // FIT empty
     if (mFITvetoFlag && flagFITveto) {
@@ -2395,35 +2400,41 @@ struct TauTau13topo {
     int counterTmp = 0;
     bool flagIMGam2ePV[4] = {true, true, true, true};
 
+    // four-momenta of the PV tracks in the pion and electron hypotheses, computed once for all the combinations below
+    ROOT::Math::LorentzVector<ROOT::Math::PxPyPzE4D<double>> trkPion[4];
+    ROOT::Math::LorentzVector<ROOT::Math::PxPyPzE4D<double>> trkElectron[4];
+    float trkPt[4];
     for (const auto& trk : PVContributors) {
-      // p.SetXYZM(trk.px(), trk.py(), trk.pz(), MassElectron);
-      p.SetXYZT(trk.px(), trk.py(), trk.pz(), RecoDecay::e(trk.px(), trk.py(), trk.pz(), MassElectron));
-      for (const auto& trk1 : PVContributors) {
-        if (trk.index() >= trk1.index())
-          continue;
-        if (trk1.hasTPC())
-          nPiHasTPC[trk.index()]++;
-        // p1.SetXYZM(trk1.px(), trk1.py(), trk1.pz(), MassElectron);
-        p1.SetXYZT(trk1.px(), trk1.py(), trk1.pz(), RecoDecay::e(trk1.px(), trk1.py(), trk1.pz(), MassElectron));
-        invMass2El[(counterTmp < 3 ? counterTmp : 5 - counterTmp)][(counterTmp < 3 ? 0 : 1)] = (p + p1).mag2();
-        gammaPair[(counterTmp < 3 ? counterTmp : 5 - counterTmp)][(counterTmp < 3 ? 0 : 1)] = (p + p1);
-        registry.get<TH1>(HIST("control/cut0/hInvMass2ElAll"))->Fill((p + p1).mag2());
+      trkPion[counterTmp].SetXYZT(trk.px(), trk.py(), trk.pz(), RecoDecay::e(trk.px(), trk.py(), trk.pz(), MassPiPlus));
+      trkElectron[counterTmp].SetXYZT(trk.px(), trk.py(), trk.pz(), RecoDecay::e(trk.px(), trk.py(), trk.pz(), MassElectron));
+      trkPt[counterTmp] = trk.pt();
+      trkHasTpc[counterTmp] = trk.hasTPC();
+      counterTmp++;
+    } // end of loop over PVContributors
+
+    counterTmp = 0;
+    for (int i = 0; i < 4; i++) {
+      for (int j = i + 1; j < 4; j++) {
+        if (trkHasTpc[j])
+          nPiHasTPC[i]++;
+        const auto pairEl = trkElectron[i] + trkElectron[j];
+        invMass2El[(counterTmp < 3 ? counterTmp : 5 - counterTmp)][(counterTmp < 3 ? 0 : 1)] = pairEl.mag2();
+        gammaPair[(counterTmp < 3 ? counterTmp : 5 - counterTmp)][(counterTmp < 3 ? 0 : 1)] = pairEl;
+        registry.get<TH1>(HIST("control/cut0/hInvMass2ElAll"))->Fill(pairEl.mag2());
         counterTmp++;
-        if ((p + p1).M() < 0.015) {
-          flagIMGam2ePV[trk.index()] = false;
-          flagIMGam2ePV[trk1.index()] = false;
+        if (pairEl.M() < 0.015) {
+          flagIMGam2ePV[i] = false;
+          flagIMGam2ePV[j] = false;
         }
-      } // end of loop over PVContributors
-    } // end of loop over PVContributors
+      } // end of loop over PV track pairs
+    } // end of loop over PV track pairs
 
     // first loop to add all the tracks together
     // p = TLorentzVector(0., 0., 0., 0.);
     p.SetXYZT(0., 0., 0., 0.);
-    for (const auto& trk : PVContributors) {
-      // p1.SetXYZM(trk.px(), trk.py(), trk.pz(), MassPiPlus);
-      p1.SetXYZT(trk.px(), trk.py(), trk.pz(), RecoDecay::e(trk.px(), trk.py(), trk.pz(), MassPiPlus));
-      p += p1;
-      scalarPtsum += trk.pt();
+    for (int i = 0; i < 4; i++) {
+      p += trkPion[i];
+      scalarPtsum += trkPt[i];
     } // end of loop over PVContributors
 
     float pttot = p.Pt();
@@ -2449,17 +2460,15 @@ struct TauTau13topo {
       registry.get<TH1>(HIST("global/hTrkCheck"))->Fill(tmpTrkCheck);
 
       // inv mass of 3pi + 1e
-      // p1.SetXYZM(trk.px(), trk.py(), trk.pz(), MassPiPlus);
-      p1.SetXYZT(trk.px(), trk.py(), trk.pz(), RecoDecay::e(trk.px(), trk.py(), trk.pz(), MassPiPlus));
-      // p2.SetXYZM(trk.px(), trk.py(), trk.pz(), MassElectron);
-      p2.SetXYZT(trk.px(), trk.py(), trk.pz(), RecoDecay::e(trk.px(), trk.py(), trk.pz(), MassElectron));
+      p1 = trkPion[counterTmp];
+      p2 = trkElectron[counterTmp];
       mass3pi1e[counterTmp] = (p - p1 + p2).mag();
 
       v1.SetXYZ(trk.px(), trk.py(), trk.pz());
-      for (const auto& trk1 : PVContributors) {
-        if (trk.index() == trk1.index())
+      for (int j = 0; j < 4; j++) {
+        if (j == counterTmp)
           continue;
-        vtmp.SetXYZ(trk1.px(), trk1.py(), trk1.pz());
+        vtmp.SetXYZ(trkPion[j].Px(), trkPion[j].Py(), trkPion[j].Pz());
         deltaphi = v1.Angle(vtmp);
         registry.get<TH1>(HIST("global/hDeltaAngleTrackPV"))->Fill(deltaphi);
         if (deltaphi < minAnglecut) { // default 0.05
@@ -2496,12 +2505,9 @@ struct TauTau13topo {
       nclTPCcrossedRows[counterTmp] = trk.tpcNClsCrossedRows();
       // trkHasTof[counterTmp] = trk.hasTOF();
       trkHasTof[counterTmp] = isGoodTOFTrackCheck(trk);
-      trkHasTpc[counterTmp] = trk.hasTPC();
       trkTime[counterTmp] = trk.trackTime();
       trkTimeRes[counterTmp] = trk.trackTimeRes();
 
-      // p1.SetXYZM(trk.px(), trk.py(), trk.pz(), MassPiPlus);
-      p1.SetXYZT(trk.px(), trk.py(), trk.pz(), RecoDecay::e(trk.px(), trk.py(), trk.pz(), MassPiPlus));
       tmpMomentum[counterTmp] = p1.P();
       tmpPt[counterTmp] = p1.Pt();
       tmpDedx[counterTmp] = trk.tpcSignal();
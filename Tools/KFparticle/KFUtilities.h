@@ -42,6 +42,7 @@
 #include <cstdint>
 #include <stdexcept>
 #include <utility>
+#include <vector>
 
 constexpr float ArbitrarySmallNumber{1e-8f};
 constexpr float ArbitraryHugeNumber{1e8f};
@@ -145,21 +146,29 @@ KFParticle createKFParticleFromTrackParCov(const o2::track::TrackParametrization
   }
 
   KFParticle kfPart;
-  float mInit{}, sigmaMInit{}, m{}, sigmaM{};
-  kfPart.GetMass(mInit, sigmaMInit);
-  LOG(debug) << "Daughter KFParticle mass before creation: " << mInit << " +- " << sigmaMInit;
-
   try {
     kfPart.Create(xyzpxpypz, cv.data(), charge, mass);
   } catch (std::runtime_error& e) {
     LOG(debug) << "Failed to create KFParticle from daughter TrackParCov" << e.what();
   }
-
-  kfPart.GetMass(m, sigmaM);
-  LOG(debug) << "Daughter KFParticle mass after creation: " << m << " +- " << sigmaM;
   return kfPart;
 }
 
+/// @brief Function to create the KFParticles of a set of AO2D tracks with the same mass hypothesis
+/// @tparam TTracks
+/// @param tracks Tracks from aod::TracksIU/aod::Tracks, aod::TracksCov, or a slice of them
+/// @param mass mass hypothesis
+/// @param kfDaughters output, the i-th particle corresponds to the i-th track. The vector is cleared but its memory is kept, so that it can be reused across collisions
+template <typename TTracks>
+void createKFParticlesFromTracks(const TTracks& tracks, float mass, std::vector<KFParticle>& kfDaughters)
+{
+  kfDaughters.clear();
+  kfDaughters.reserve(tracks.size());
+  for (const auto& track : tracks) {
+    kfDaughters.emplace_back(createKFParticleFromTrackParCov(getTrackParCov(track), track.sign(), mass));
+  }
+}
+
 /// @brief Function to create a o2::track::TrackParametrizationWithError track from a KFParticle
 /// @param kfParticle KFParticle to transform
 /// @param pid PID hypothesis
@@ -192,7 +201,7 @@ o2::track::TrackParCov getTrackParCovFromKFP(const KFParticle& kfParticle, const
 /// @param kfp KFParticle
 /// @param PV KFParticle primary vertex
 /// @return cpa
-float cpaFromKF(KFParticle kfp, KFParticle PV)
+float cpaFromKF(const KFParticle& kfp, const KFParticle& PV)
 {
   float xVtxP{}, yVtxP{}, zVtxP{}, xVtxS{}, yVtxS{}, zVtxS{}, px{}, py{}, pz{};
 
@@ -216,7 +225,7 @@ float cpaFromKF(KFParticle kfp, KFParticle PV)
 /// @param kfp KFParticle
 /// @param PV KFParticle primary vertex
 /// @return cpa in xy
-float cpaXYFromKF(KFParticle kfp, KFParticle PV)
+float cpaXYFromKF(const KFParticle& kfp, const KFParticle& PV)
 {
   float xVtxP{}, yVtxP{}, xVtxS{}, yVtxS{}, px{}, py{};
 
@@ -243,7 +252,7 @@ float cpaXYFromKF(KFParticle kfp, KFParticle PV)
 /// @param kfpprong1 KFParticele Prong 1
 /// @param pdgdb Service PDG data base
 /// @return cos theta star
-float cosThetaStarFromKF(int iProng, int pdgvtx, int pdgprong0, int pdgprong1, KFParticle kfpprong0, KFParticle kfpprong1, const o2::framework::Service<o2::framework::O2DatabasePDG>& pdgdb)
+float cosThetaStarFromKF(int iProng, int pdgvtx, int pdgprong0, int pdgprong1, const KFParticle& kfpprong0, const KFParticle& kfpprong1, const o2::framework::Service<o2::framework::O2DatabasePDG>& pdgdb)
 {
   float px0{}, py0{}, pz0{}, px1{}, py1{}, pz1{};
 
@@ -269,7 +278,7 @@ float cosThetaStarFromKF(int iProng, int pdgvtx, int pdgprong0, int pdgprong1, K
 /// @param kfpParticle KFParticle
 /// @param Vertex KFParticle vertex
 /// @return impact parameter
-float impParXYFromKF(KFParticle kfpParticle, KFParticle Vertex)
+float impParXYFromKF(const KFParticle& kfpParticle, const KFParticle& Vertex)
 {
   float xVtxP{}, yVtxP{}, zVtxP{}, xVtxS{}, yVtxS{}, zVtxS{}, px{}, py{}, pz{};
 
@@ -293,7 +302,7 @@ float impParXYFromKF(KFParticle kfpParticle, KFParticle Vertex)
 /// @param kfpParticle KFParticle
 /// @param PV KFParticle primary vertex
 /// @return l/delta l
-float ldlFromKF(KFParticle kfpParticle, KFParticle PV)
+float ldlFromKF(const KFParticle& kfpParticle, const KFParticle& PV)
 {
   const float dxParticle = PV.GetX() - kfpParticle.GetX();
   const float dyParticle = PV.GetY() - kfpParticle.GetY();
@@ -312,7 +321,7 @@ float ldlFromKF(KFParticle kfpParticle, KFParticle PV)
 /// @param kfpParticle KFParticle
 /// @param PV KFParticle primary vertex
 /// @return l/delta l in xy plane
-float ldlXYFromKF(KFParticle kfpParticle, KFParticle PV)
+float ldlXYFromKF(const KFParticle& kfpParticle, const KFParticle& PV)
 {
   const float dxParticle = PV.GetX() - kfpParticle.GetX();
   const float dyParticle = PV.GetY() - kfpParticle.GetY();
@@ -396,6 +405,33 @@ std::pair<float, float> kfCalculateLdL(KFParticle candidate, const KFParticle& v
   return std::make_pair(l, dl);
 }
 
+/// @brief Topological variables of a decay candidate w.r.t. the primary vertex
+struct KFDecayTopology {
+  float cpa{-2.f};             // cosine of the pointing angle
+  float cpaXY{-2.f};           // cosine of the pointing angle in the xy plane
+  float decayLength{0.f};      // decay length, cm
+  float errorDecayLength{0.f}; // uncertainty of the decay length, cm
+  float chi2OverNdf{-1.f};     // chi2/ndf of the decay vertex fit
+};
+
+/// @brief cosPA, decay length with its uncertainty and chi2/ndf of a decay candidate, with a single copy of the candidate
+/// @param candidate KFParticle decay candidate
+/// @param vtx KFParticle primary vertex
+/// @return KFDecayTopology with the same values as cpaFromKF, cpaXYFromKF, kfCalculateLdL and Chi2()/NDF()
+KFDecayTopology kfCalculateDecayTopology(const KFParticle& candidate, const KFParticle& vtx)
+{
+  KFDecayTopology topology;
+  topology.cpa = cpaFromKF(candidate, vtx);
+  topology.cpaXY = cpaXYFromKF(candidate, vtx);
+  if (candidate.GetNDF() > 0) {
+    topology.chi2OverNdf = candidate.GetChi2() / static_cast<float>(candidate.GetNDF());
+  }
+  KFParticle candidateToPV = candidate;
+  candidateToPV.SetProductionVertex(vtx);
+  candidateToPV.KFParticleBase::GetDecayLength(topology.decayLength, topology.errorDecayLength);
+  return topology;
+}
+
 /// @brief Z projection of the impact parameter from the track to the primary vertex, cm
 /// @param candidate KFParticle prong
 /// @param vtx KFParticle primary vertex
@@ -23,9 +23,11 @@
 #include <Framework/Array2D.h>
 #include <Framework/Logger.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <map>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -195,20 +197,7 @@ class MlResponse
   {
     int nModel = findBin(candVar);
     auto output = getModelOutput(input, nModel);
-    uint8_t iClass{0};
-    for (const auto& outputValue : output) {
-      uint8_t dir = mCutDir.at(iClass);
-      if (dir != o2::cuts_ml::CutDirection::CutNot) {
-        if (dir == o2::cuts_ml::CutDirection::CutGreater && outputValue > mCuts.get(nModel, iClass)) {
-          return false;
-        }
-        if (dir == o2::cuts_ml::CutDirection::CutSmaller && outputValue < mCuts.get(nModel, iClass)) {
-          return false;
-        }
-      }
-      ++iClass;
-    }
-    return true;
+    return isPassingCuts(output.data(), nModel);
   }
 
   /// ML selections
@@ -221,20 +210,7 @@ class MlResponse
   {
     int nModel = findBin(candVar);
     output = getModelOutput(input, nModel);
-    uint8_t iClass{0};
-    for (const auto& outputValue : output) {
-      uint8_t dir = mCutDir.at(iClass);
-      if (dir != o2::cuts_ml::CutDirection::CutNot) {
-        if (dir == o2::cuts_ml::CutDirection::CutGreater && outputValue > mCuts.get(nModel, iClass)) {
-          return false;
-        }
-        if (dir == o2::cuts_ml::CutDirection::CutSmaller && outputValue < mCuts.get(nModel, iClass)) {
-          return false;
-        }
-      }
-      ++iClass;
-    }
-    return true;
+    return isPassingCuts(output.data(), nModel);
   }
 
   /// ML selections
@@ -251,20 +227,138 @@ class MlResponse
     }
     int nModel = findBin2D(candVar1, candVar2);
     output = getModelOutput(input, nModel);
-    uint8_t iClass{0};
-    for (const auto& outputValue : output) {
-      uint8_t dir = mCutDir.at(iClass);
-      if (dir != o2::cuts_ml::CutDirection::CutNot) {
-        if (dir == o2::cuts_ml::CutDirection::CutGreater && outputValue > mCuts.get(nModel, iClass)) {
-          return false;
+    return isPassingCuts(output.data(), nModel);
+  }
+
+  /// ML selections on model predictions already computed for the candidate (e.g. by an upstream task), without evaluating the model
+  /// \param scores is a container with the model output of the candidate
+  /// \param candVar is the variable value (e.g. pT) used to select which cuts to apply
+  /// \return boolean telling if model predictions pass the cuts
+  template <typename T1, typename T2>
+  bool isSelectedMlScores(const T1& scores, const T2& candVar)
+  {
+    int nModel = findBin(candVar);
+    if (nModel < 0 || nModel >= static_cast<int>(mNModels)) {
+      LOG(fatal) << "Model index " << nModel << " is out of range! The number of configured models is " << mNModels << ". Please check your configurables.";
+    }
+    if (scores.size() < mNClasses) {
+      LOG(fatal) << "Got " << scores.size() << " model predictions, while " << static_cast<int>(mNClasses) << " classes are expected!";
+    }
+    return isPassingCuts(scores.data(), nModel);
+  }
+
+  /// Batched ML selections: candidates are grouped per model and each model is evaluated once per group
+  /// \param inputs is a span of rows of input features, one row per candidate
+  /// \param candVars is a span with the variable value (e.g. pT) used to select which model to use, one per candidate
+  /// \param isSelected is a container filled with the selection decision of each candidate
+  /// \param outputs is an optional container to be filled with the model output of each candidate
+  template <typename T1, typename T2>
+  void isSelectedMlBatch(std::span<T1> inputs, std::span<T2> candVars, std::vector<bool>& isSelected, std::vector<std::vector<TypeOutputScore>>* outputs = nullptr)
+  {
+    if (inputs.size() != candVars.size()) {
+      LOG(fatal) << "Number of input rows (" << inputs.size() << ") different from the number of candidate variables (" << candVars.size() << ")!";
+    }
+    groupCandidatesPerModel(candVars, isSelected, outputs);
+
+    // one inference call per model, reusing the input and output buffers
+    for (int nModel{0}; nModel < mNModels; ++nModel) {
+      const auto& rows = mBatchRows[nModel];
+      if (rows.empty()) {
+        continue;
+      }
+      const std::size_t nFeatures = mModels[nModel].getNumInputNodes();
+      mBatchInput.resize(rows.size() * nFeatures);
+      auto itInput = mBatchInput.begin();
+      for (const auto& iCand : rows) {
+        if (inputs[iCand].size() != nFeatures) {
+          LOG(fatal) << "Number of input features (" << inputs[iCand].size() << ") different from the one expected by the model (" << nFeatures << ")!";
         }
-        if (dir == o2::cuts_ml::CutDirection::CutSmaller && outputValue < mCuts.get(nModel, iClass)) {
-          return false;
+        itInput = std::copy(inputs[iCand].begin(), inputs[iCand].end(), itInput);
+      }
+      const int64_t rowSize = mModels[nModel].template evalModelBatch<TypeOutputScore>(mBatchInput.data(), rows.size(), mBatchOutput);
+      fillBatchResults(nModel, rowSize, isSelected, outputs);
+    }
+  }
+
+  /// Batched ML selections for models with several input nodes: candidates are grouped per model and each model is evaluated once per group
+  /// \param inputs is a span with, for each candidate, one vector of input features per input node of the model (e.g. jet, padded tracks and padded vertices)
+  /// \param candVars is a span with the variable value (e.g. pT) used to select which model to use, one per candidate
+  /// \param isSelected is a container filled with the selection decision of each candidate
+  /// \param outputs is an optional container to be filled with the model output of each candidate
+  template <typename T2>
+  void isSelectedMlBatchMultiInput(std::span<std::vector<std::vector<TypeOutputScore>>> inputs, std::span<T2> candVars, std::vector<bool>& isSelected, std::vector<std::vector<TypeOutputScore>>* outputs = nullptr)
+  {
+    if (inputs.size() != candVars.size()) {
+      LOG(fatal) << "Number of input rows (" << inputs.size() << ") different from the number of candidate variables (" << candVars.size() << ")!";
+    }
+    groupCandidatesPerModel(candVars, isSelected, outputs);
+
+    // one inference call per model, the nodes of the candidates of a group are stacked along the batch dimension
+    for (int nModel{0}; nModel < mNModels; ++nModel) {
+      const auto& rows = mBatchRows[nModel];
+      if (rows.empty()) {
+        continue;
+      }
+      const std::size_t nNodes = mModels[nModel].getInputShapes().size();
+      mBatchInputs.resize(nNodes);
+      for (auto& nodeInput : mBatchInputs) {
+        nodeInput.clear();
+      }
+      for (const auto& iCand : rows) {
+        if (inputs[iCand].size() != nNodes) {
+          LOG(fatal) << "Number of input nodes (" << inputs[iCand].size() << ") different from the one expected by the model (" << nNodes << ")!";
+        }
+        for (std::size_t iNode{0}; iNode < nNodes; ++iNode) {
+          mBatchInputs[iNode].insert(mBatchInputs[iNode].end(), inputs[iCand][iNode].begin(), inputs[iCand][iNode].end());
         }
       }
-      ++iClass;
+      const int64_t rowSize = mModels[nModel].template evalModelBatch<TypeOutputScore>(mBatchInputs, rows.size(), mBatchOutput);
+      fillBatchResults(nModel, rowSize, isSelected, outputs);
+    }
+  }
+
+  /// Batched model outputs for tasks choosing the model of each candidate themselves: each model is evaluated once per group
+  /// \param inputs is a span of rows of input features, one row per candidate
+  /// \param nModels is a span with the model index of each candidate
+  /// \param outputs is a container filled with the model output of each candidate
+  template <typename T1>
+  void getModelOutputBatch(std::span<T1> inputs, std::span<const int> nModels, std::vector<std::vector<TypeOutputScore>>& outputs)
+  {
+    if (inputs.size() != nModels.size()) {
+      LOG(fatal) << "Number of input rows (" << inputs.size() << ") different from the number of model indices (" << nModels.size() << ")!";
+    }
+    outputs.resize(inputs.size());
+    mBatchRows.resize(mNModels);
+    for (auto& rows : mBatchRows) {
+      rows.clear();
+    }
+    for (std::size_t iCand{0}; iCand < nModels.size(); ++iCand) {
+      if (nModels[iCand] < 0 || nModels[iCand] >= mNModels) {
+        LOG(fatal) << "Model index " << nModels[iCand] << " is out of range! The number of initialised models is " << mModels.size() << ". Please check your configurables.";
+      }
+      mBatchRows[nModels[iCand]].push_back(iCand);
+    }
+
+    for (int nModel{0}; nModel < mNModels; ++nModel) {
+      const auto& rows = mBatchRows[nModel];
+      if (rows.empty()) {
+        continue;
+      }
+      const std::size_t nFeatures = mModels[nModel].getNumInputNodes();
+      mBatchInput.resize(rows.size() * nFeatures);
+      auto itInput = mBatchInput.begin();
+      for (const auto& iCand : rows) {
+        if (inputs[iCand].size() != nFeatures) {
+          LOG(fatal) << "Number of input features (" << inputs[iCand].size() << ") different from the one expected by the model (" << nFeatures << ")!";
+        }
+        itInput = std::copy(inputs[iCand].begin(), inputs[iCand].end(), itInput);
+      }
+      const int64_t rowSize = mModels[nModel].template evalModelBatch<TypeOutputScore>(mBatchInput.data(), rows.size(), mBatchOutput);
+      for (std::size_t iRow{0}; iRow < rows.size(); ++iRow) {
+        const TypeOutputScore* scores = mBatchOutput.data() + iRow * rowSize;
+        outputs[rows[iRow]].assign(scores, scores + rowSize);
+      }
     }
-    return true;
   }
 
  protected:
@@ -285,6 +379,74 @@ class MlResponse
   virtual void setAvailableInputFeatures() { return; } // method to fill the map of available input features
 
  private:
+  std::vector<std::vector<std::size_t>> mBatchRows;       // candidate indices grouped per model, reused among batched calls
+  std::vector<TypeOutputScore> mBatchInput;               // contiguous input features of one model group, reused among batched calls
+  std::vector<std::vector<TypeOutputScore>> mBatchInputs; // stacked input features of each input node of one model group, reused among batched calls
+  std::vector<TypeOutputScore> mBatchOutput;              // model scores of one model group, reused among batched calls
+
+  /// Groups the candidates of a batch per model in mBatchRows and resets the results
+  /// \param candVars is a span with the variable value (e.g. pT) used to select which model to use, one per candidate
+  /// \param isSelected is a container to be filled with the selection decision of each candidate
+  /// \param outputs is an optional container to be filled with the model output of each candidate
+  template <typename T2>
+  void groupCandidatesPerModel(std::span<T2> candVars, std::vector<bool>& isSelected, std::vector<std::vector<TypeOutputScore>>* outputs)
+  {
+    const std::size_t nCandidates = candVars.size();
+    isSelected.assign(nCandidates, false);
+    if (outputs) {
+      outputs->resize(nCandidates);
+    }
+    mBatchRows.resize(mNModels);
+    for (auto& rows : mBatchRows) {
+      rows.clear();
+    }
+    for (std::size_t iCand{0}; iCand < nCandidates; ++iCand) {
+      int nModel = findBin(candVars[iCand]);
+      if (nModel < 0 || nModel >= mNModels) {
+        LOG(fatal) << "Model index " << nModel << " is out of range! The number of initialised models is " << mModels.size() << ". Please check your configurables.";
+      }
+      mBatchRows[nModel].push_back(iCand);
+    }
+  }
+
+  /// Scatters the scores of a batched inference of one model group back to its candidates
+  /// \param nModel is the model index
+  /// \param rowSize is the number of output values per candidate in mBatchOutput
+  /// \param isSelected is a container filled with the selection decision of each candidate
+  /// \param outputs is an optional container to be filled with the model output of each candidate
+  void fillBatchResults(int nModel, int64_t rowSize, std::vector<bool>& isSelected, std::vector<std::vector<TypeOutputScore>>* outputs)
+  {
+    const auto& rows = mBatchRows[nModel];
+    if (rowSize < mNClasses) {
+      LOG(fatal) << "Batched inference of model " << nModel << " returned " << rowSize << " values per candidate, while " << static_cast<int>(mNClasses) << " classes are expected!";
+    }
+    for (std::size_t iRow{0}; iRow < rows.size(); ++iRow) {
+      const TypeOutputScore* scores = mBatchOutput.data() + iRow * rowSize;
+      isSelected[rows[iRow]] = isPassingCuts(scores, nModel);
+      if (outputs) {
+        (*outputs)[rows[iRow]].assign(scores, scores + mNClasses);
+      }
+    }
+  }
+
+  /// Applies the cuts of a given model on its scores
+  /// \param scores is a pointer to the mNClasses output values of the model
+  /// \param nModel is the model index
+  /// \return boolean telling if model predictions pass the cuts
+  bool isPassingCuts(const TypeOutputScore* scores, int nModel)
+  {
+    for (uint8_t iClass{0}; iClass < mNClasses; ++iClass) {
+      uint8_t dir = mCutDir.at(iClass);
+      if (dir == o2::cuts_ml::CutDirection::CutGreater && scores[iClass] > mCuts.get(nModel, iClass)) {
+        return false;
+      }
+      if (dir == o2::cuts_ml::CutDirection::CutSmaller && scores[iClass] < mCuts.get(nModel, iClass)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
   /// Finds matching bin in mBinsLimits
   /// \param value e.g. pT
   /// \return index of the matching bin, used to access mModels
@@ -28,7 +28,11 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -39,6 +43,36 @@ namespace o2
 namespace ml
 {
 
+namespace
+{
+// Process-wide ONNX state: one environment, whose global thread pool is used by all the sessions,
+// and the sessions of the models loaded so far, keyed by file content and session options.
+// Models of different bins or tasks pointing to the same network share the session.
+std::mutex sharedStateMutex;
+std::shared_ptr<Ort::Env> sharedEnv;
+int sharedEnvThreads = 0;
+std::map<std::string, std::weak_ptr<Ort::Session>> sharedSessions;
+
+// FNV-1a hash of the file content, the path is used instead if the file cannot be read
+std::string hashFile(const std::string& path)
+{
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return path;
+  }
+  uint64_t hash = 14695981039346656037ULL;
+  char buffer[1 << 16];
+  while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0) {
+    for (std::streamsize i = 0; i < file.gcount(); i++) {
+      hash = (hash ^ static_cast<unsigned char>(buffer[i])) * 1099511628211ULL;
+    }
+  }
+  std::stringstream ss;
+  ss << std::hex << hash;
+  return ss.str();
+}
+} // namespace
+
 std::string OnnxModel::printShape(const std::vector<int64_t>& v)
 {
   std::stringstream ss("");
@@ -87,10 +121,39 @@ void OnnxModel::initModel(const std::string& localPath, const bool enableOptimiz
     sessionOptions.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_EXTENDED);
   }
 
-  mEnv = std::make_shared<Ort::Env>(ORT_LOGGING_LEVEL_WARNING, "onnx-model");
-  mSession = std::make_shared<Ort::Session>(*mEnv, modelPath.c_str(), sessionOptions);
+  /// Shared environment and session
+  sessionOptions.DisablePerSessionThreads(); // the global thread pool of the environment is used
+  {
+    std::lock_guard<std::mutex> lock(sharedStateMutex);
+    if (!sharedEnv) {
+      Ort::ThreadingOptions threadingOptions;
+      threadingOptions.SetGlobalIntraOpNumThreads(activeThreads);
+      threadingOptions.SetGlobalInterOpNumThreads(1);
+      sharedEnv = std::make_shared<Ort::Env>(threadingOptions, ORT_LOGGING_LEVEL_WARNING, "onnx-model");
+      sharedEnvThreads = activeThreads;
+    } else if (activeThreads != sharedEnvThreads) {
+      LOGP(info, "Requested {} threads, the thread pool of the shared ONNX environment has {} (0: default).", activeThreads, sharedEnvThreads);
+    }
+    mEnv = sharedEnv;
+
+    const std::string key = hashFile(modelPath) + "_" + std::to_string(enableOptimizations) + "_" + std::to_string(activeThreads);
+    mSession = sharedSessions[key].lock();
+    if (mSession) {
+      LOG(info) << "Sharing the session of an already loaded model with the same content";
+    } else {
+      for (auto it = sharedSessions.begin(); it != sharedSessions.end();) {
+        it = it->second.expired() ? sharedSessions.erase(it) : std::next(it);
+      }
+      mSession = std::make_shared<Ort::Session>(*mEnv, modelPath.c_str(), sessionOptions);
+      sharedSessions[key] = mSession;
+    }
+  }
 
   Ort::AllocatorWithDefaultOptions const tmpAllocator;
+  mInputNames.clear(); // the model can be re-initialised, e.g. when a new network is fetched for another validity range
+  mInputShapes.clear();
+  mOutputNames.clear();
+  mOutputShapes.clear();
   for (std::size_t i = 0; i < mSession->GetInputCount(); ++i) {
     mInputNames.push_back(mSession->GetInputNameAllocated(i, tmpAllocator).get());
   }
@@ -103,6 +166,11 @@ void OnnxModel::initModel(const std::string& localPath, const bool enableOptimiz
   for (std::size_t i = 0; i < mSession->GetOutputCount(); ++i) {
     mOutputShapes.emplace_back(mSession->GetOutputTypeInfo(i).GetTensorTypeAndShapeInfo().GetShape());
   }
+  cacheNodeNames();
+  mMemoryInfo = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
+  mRunOptions = Ort::RunOptions{};
+  mIoBinding.reset();
+
   LOG(info) << "Input Nodes:";
   for (std::size_t i = 0; i < mInputNames.size(); i++) {
     LOG(info) << "\t" << mInputNames[i] << " : " << printShape(mInputShapes[i]);
@@ -121,6 +189,18 @@ void OnnxModel::initModel(const std::string& localPath, const bool enableOptimiz
   LOG(info) << "--- Model initialized! ---";
 }
 
+void OnnxModel::cacheNodeNames()
+{
+  mInputNamesChar.clear();
+  for (const auto& name : mInputNames) {
+    mInputNamesChar.push_back(name.c_str());
+  }
+  mOutputNamesChar.clear();
+  for (const auto& name : mOutputNames) {
+    mOutputNamesChar.push_back(name.c_str());
+  }
+}
+
 void OnnxModel::setActiveThreads(const int threads)
 {
   activeThreads = threads;
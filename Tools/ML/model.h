@@ -25,6 +25,7 @@
 #include <onnxruntime_cxx_api.h>
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
@@ -47,6 +48,8 @@ class OnnxModel
   ~OnnxModel() = default;
 
   // Inferencing
+  // The session is shared by all the models of the process loaded from a file with the same content and the same options,
+  // and all the sessions run on the thread pool of one shared environment
   void initModel(const std::string&, const bool = false, const int = 0, const uint64_t = 0, const uint64_t = 0);
 
   // template methods -- best to define them in header
@@ -57,15 +60,9 @@ class OnnxModel
     // assert(input[0].GetTensorTypeAndShapeInfo().GetShape() == getNumInputNodes()); --> Fails build in debug mode, TODO: assertion should be checked somehow
 
     try {
+      checkNodeNames();
       const Ort::RunOptions runOptions;
-      std::vector<const char*> inputNamesChar(mInputNames.size(), nullptr);
-      std::transform(std::begin(mInputNames), std::end(mInputNames), std::begin(inputNamesChar),
-                     [&](const std::string& str) { return str.c_str(); });
-
-      std::vector<const char*> outputNamesChar(mOutputNames.size(), nullptr);
-      std::transform(std::begin(mOutputNames), std::end(mOutputNames), std::begin(outputNamesChar),
-                     [&](const std::string& str) { return str.c_str(); });
-      auto outputTensors = mSession->Run(runOptions, inputNamesChar.data(), input.data(), input.size(), outputNamesChar.data(), outputNamesChar.size());
+      auto outputTensors = mSession->Run(runOptions, mInputNamesChar.data(), input.data(), input.size(), mOutputNamesChar.data(), mOutputNamesChar.size());
       LOG(debug) << "Number of output tensors: " << outputTensors.size();
       if (outputTensors.size() != mOutputNames.size()) {
         LOG(fatal) << "Number of output tensors: " << outputTensors.size() << " does not agree with the model specified size: " << mOutputNames.size();
@@ -125,9 +122,89 @@ class OnnxModel
     return evalModel<T>(inputTensors);
   }
 
-  // Reset session
+  // Batched inference on a contiguous, row-major block of nRows x getNumInputNodes() input features
+  // The input and output tensors are bound through an IoBinding which is reused among calls; the output
+  // buffer is only reallocated when it needs to grow, so the caller should keep it alive between calls
+  // \return number of output values per row of the last output node (0 in case of failure)
+  template <typename T>
+  int64_t evalModelBatch(T* input, const int64_t nRows, std::vector<T>& output)
+  {
+    if (nRows <= 0) {
+      output.clear();
+      return 0;
+    }
+    try {
+      checkNodeNames();
+      if (!mIoBinding) {
+        mIoBinding = std::make_unique<Ort::IoBinding>(*mSession);
+      }
+      mIoBinding->ClearBoundInputs();
+      mIoBinding->ClearBoundOutputs();
+
+      const int64_t nFeatures = mInputShapes[0][1];
+      const std::array<int64_t, 2> inputShape{nRows, nFeatures};
+      Ort::Value inputTensor = Ort::Value::CreateTensor<T>(mMemoryInfo, input, nRows * nFeatures, inputShape.data(), inputShape.size());
+      mIoBinding->BindInput(mInputNamesChar[0], inputTensor);
+      return runBatch(nRows, output);
+    } catch (const Ort::Exception& exception) {
+      LOG(error) << "Error running batched model inference: " << exception.what();
+    }
+    return 0;
+  }
+
+  // Batched inference for models with several input nodes (e.g. jet, padded tracks and padded vertices)
+  // inputs[i] is a contiguous, row-major block of nRows rows of the i-th input node, whose non-batch dimensions must be fixed by the model
+  // \return number of output values per row of the last output node (0 in case of failure)
+  template <typename T>
+  int64_t evalModelBatch(std::vector<std::vector<T>>& inputs, const int64_t nRows, std::vector<T>& output)
+  {
+    if (nRows <= 0) {
+      output.clear();
+      return 0;
+    }
+    if (inputs.size() != mInputShapes.size()) {
+      LOG(error) << "Number of batched inputs: " << inputs.size() << " does not agree with the number of input nodes of the model: " << mInputShapes.size();
+      return 0;
+    }
+    try {
+      checkNodeNames();
+      if (!mIoBinding) {
+        mIoBinding = std::make_unique<Ort::IoBinding>(*mSession);
+      }
+      mIoBinding->ClearBoundInputs();
+      mIoBinding->ClearBoundOutputs();
+
+      std::vector<Ort::Value> inputTensors; // bound by reference, kept alive until the session has run
+      inputTensors.reserve(inputs.size());
+      for (std::size_t iinput = 0; iinput < inputs.size(); iinput++) {
+        std::vector<int64_t> inputShape{nRows};
+        int64_t rowSize = 1;
+        for (std::size_t idim = 1; idim < mInputShapes[iinput].size(); idim++) {
+          if (mInputShapes[iinput][idim] <= 0) {
+            LOG(error) << "Batched inference needs fixed non-batch dimensions, input " << iinput << " has shape " << printShape(mInputShapes[iinput]);
+            return 0;
+          }
+          inputShape.push_back(mInputShapes[iinput][idim]);
+          rowSize *= mInputShapes[iinput][idim];
+        }
+        if (inputs[iinput].size() != static_cast<std::size_t>(nRows * rowSize)) {
+          LOG(error) << "Size of batched input " << iinput << ": " << inputs[iinput].size() << " does not agree with " << nRows << " rows of shape " << printShape(mInputShapes[iinput]);
+          return 0;
+        }
+        inputTensors.emplace_back(Ort::Value::CreateTensor<T>(mMemoryInfo, inputs[iinput].data(), inputs[iinput].size(), inputShape.data(), inputShape.size()));
+        mIoBinding->BindInput(mInputNamesChar[iinput], inputTensors.back());
+      }
+      return runBatch(nRows, output);
+    } catch (const Ort::Exception& exception) {
+      LOG(error) << "Error running batched model inference: " << exception.what();
+    }
+    return 0;
+  }
+
+  // Reset session, the model gets its own session (e.g. after changing the session options)
   void resetSession()
   {
+    mIoBinding.reset();
     mSession.reset(new Ort::Session{*mEnv, modelPath.c_str(), sessionOptions});
   }
 
@@ -140,6 +217,18 @@ class OnnxModel
   int getNumInputNodes() const { return mInputShapes[0][1]; }
   std::vector<std::vector<int64_t>> getInputShapes() const { return mInputShapes; }
   int getNumOutputNodes() const { return mOutputShapes[0][1]; }
+  // Number of values per row of the last output node, 0 if the shape is not fixed by the model
+  int64_t getOutputRowSize() const
+  {
+    int64_t rowSize = 1;
+    for (std::size_t idim = 1; idim < mOutputShapes.back().size(); idim++) {
+      if (mOutputShapes.back()[idim] <= 0) {
+        return 0;
+      }
+      rowSize *= mOutputShapes.back()[idim];
+    }
+    return rowSize;
+  }
   uint64_t getValidityFrom() const { return validFrom; }
   uint64_t getValidityUntil() const { return validUntil; }
   void setActiveThreads(const int);
@@ -155,6 +244,48 @@ class OnnxModel
   std::vector<std::vector<int64_t>> mInputShapes;
   std::vector<std::string> mOutputNames;
   std::vector<std::vector<int64_t>> mOutputShapes;
+  std::vector<const char*> mInputNamesChar;  // cached C-string views of mInputNames, passed to Session::Run
+  std::vector<const char*> mOutputNamesChar; // cached C-string views of mOutputNames, passed to Session::Run
+
+  // Objects reused by the batched inference
+  Ort::MemoryInfo mMemoryInfo{nullptr};
+  Ort::RunOptions mRunOptions{nullptr};
+  std::unique_ptr<Ort::IoBinding> mIoBinding = nullptr;
+
+  // Binds the outputs of a batched inference on the bound inputs and runs the session
+  // \return number of output values per row of the last output node
+  template <typename T>
+  int64_t runBatch(const int64_t nRows, std::vector<T>& output)
+  {
+    // only the scores of the last output node are used; let ONNX allocate the other outputs (e.g. labels)
+    for (std::size_t i = 0; i + 1 < mOutputNamesChar.size(); i++) {
+      mIoBinding->BindOutput(mOutputNamesChar[i], mMemoryInfo);
+    }
+    int64_t rowSize = getOutputRowSize();
+    if (rowSize > 0) {
+      // static output shape: write the scores directly in the caller buffer
+      if (output.size() < static_cast<std::size_t>(nRows * rowSize)) {
+        output.resize(nRows * rowSize);
+      }
+      const std::array<int64_t, 2> outputShape{nRows, rowSize};
+      Ort::Value outputTensor = Ort::Value::CreateTensor<T>(mMemoryInfo, output.data(), nRows * rowSize, outputShape.data(), outputShape.size());
+      mIoBinding->BindOutput(mOutputNamesChar.back(), outputTensor);
+      mSession->Run(mRunOptions, *mIoBinding);
+    } else {
+      // dynamic output shape: copy the scores from the ONNX-allocated tensor
+      mIoBinding->BindOutput(mOutputNamesChar.back(), mMemoryInfo);
+      mSession->Run(mRunOptions, *mIoBinding);
+      auto outputTensors = mIoBinding->GetOutputValues();
+      const std::size_t nValues = outputTensors.back().GetTensorTypeAndShapeInfo().GetElementCount();
+      rowSize = nValues / nRows;
+      if (output.size() < nValues) {
+        output.resize(nValues);
+      }
+      const T* outputValues = outputTensors.back().GetTensorData<T>();
+      std::copy(outputValues, outputValues + nValues, output.begin());
+    }
+    return rowSize;
+  }
 
   // Environment settings
   std::string modelPath;
@@ -165,6 +296,14 @@ class OnnxModel
   // Internal function for printing the shape of tensors
   std::string printShape(const std::vector<int64_t>&);
   bool checkHyperloop(const bool = true);
+  void cacheNodeNames();
+  // The cached C-strings point into mInputNames/mOutputNames and must be refreshed if the model object was moved
+  void checkNodeNames()
+  {
+    if (!mInputNames.empty() && (mInputNamesChar.empty() || mInputNamesChar[0] != mInputNames[0].c_str())) {
+      cacheNodeNames();
+    }
+  }
 };
 
 } // namespace ml
@@ -104,6 +104,10 @@ struct PidMlBatchEffAndPurProducer {
                                             aod::pidTPCFullPi, aod::pidTPCFullKa, aod::pidTPCFullPr, aod::pidTPCFullEl, aod::pidTPCFullMu,
                                             aod::pidTOFFullPi, aod::pidTOFFullKa, aod::pidTOFFullPr, aod::pidTOFFullEl, aod::pidTOFFullMu>>;
   std::vector<PidONNXModel<BigTracks>> models;
+  int32_t currentRunNumber = CurrentRunNumber;
+
+  std::vector<BigTracks::iterator> selectedTracks;
+  std::vector<std::vector<float>> mlCertainties; // [pid][selected track]
 
   void initHistos()
   {
@@ -222,12 +226,14 @@ struct PidMlBatchEffAndPurProducer {
     effAndPurPIDResult.reserve(mcParticles.size());
 
     auto bc = collisions.iteratorAt(0).bc_as<aod::BCsWithTimestamps>();
-    if (useCcdb && bc.runNumber() != CurrentRunNumber) {
+    if (useCcdb && bc.runNumber() != currentRunNumber) {
       uint64_t timestamp = useFixedTimestamp ? fixedTimestamp.value : bc.timestamp();
+      models.clear();
       for (const int32_t& pid : pdgPids.value)
         models.emplace_back(PidONNXModel<BigTracks>(localPath.value, ccdbPath.value, useCcdb.value,
                                                     ccdbApi, timestamp, pid, 1.1, &detectorMomentumLimits.value[0]));
-    } else {
+      currentRunNumber = bc.runNumber();
+    } else if (!useCcdb && models.empty()) {
       for (const int32_t& pid : pdgPids.value)
         models.emplace_back(PidONNXModel<BigTracks>(localPath.value, ccdbPath.value, useCcdb.value,
                                                     ccdbApi, -1, pid, 1.1, &detectorMomentumLimits.value[0]));
@@ -240,20 +246,30 @@ struct PidMlBatchEffAndPurProducer {
       }
     }
 
+    selectedTracks.clear();
     for (const auto& track : tracks) {
-      if (track.has_mcParticle()) {
-        auto mcPart = track.mcParticle();
-        if (mcPart.isPhysicalPrimary()) {
-          fillTrackedHist(mcPart.pdgCode(), track.pt());
-
-          for (size_t i = 0; i < pdgPids.value.size(); ++i) {
-            float mlCertainty = models[i].applyModel(track);
-            nSigma_t nSigma = getNSigma(track, pdgPids.value[i]);
-            bool isMCPid = mcPart.pdgCode() == pdgPids.value[i];
-
-            effAndPurPIDResult(track.index(), pdgPids.value[i], track.pt(), mlCertainty, nSigma.composed, isMCPid, track.hasTOF(), track.hasTRD());
-          }
-        }
+      if (track.has_mcParticle() && track.mcParticle().isPhysicalPrimary()) {
+        selectedTracks.push_back(track);
+      }
+    }
+
+    // one inference per model and detector configuration for all the selected tracks of the data frame
+    mlCertainties.resize(pdgPids.value.size());
+    for (size_t i = 0; i < pdgPids.value.size(); ++i) {
+      models[i].applyModelBatch(selectedTracks, mlCertainties[i]);
+    }
+
+    for (size_t iTrack = 0; iTrack < selectedTracks.size(); ++iTrack) {
+      const auto& track = selectedTracks[iTrack];
+      auto mcPart = track.mcParticle();
+      fillTrackedHist(mcPart.pdgCode(), track.pt());
+
+      for (size_t i = 0; i < pdgPids.value.size(); ++i) {
+        float mlCertainty = mlCertainties[i][iTrack];
+        nSigma_t nSigma = getNSigma(track, pdgPids.value[i]);
+        bool isMCPid = mcPart.pdgCode() == pdgPids.value[i];
+
+        effAndPurPIDResult(track.index(), pdgPids.value[i], track.pt(), mlCertainty, nSigma.composed, isMCPid, track.hasTOF(), track.hasTRD());
       }
     }
   }
@@ -141,6 +141,49 @@ struct PidONNXModel {
     return getModelOutput(track) >= mMinCertainty;
   }
 
+  /// Certainties of a set of tracks (a table, a slice or a container of T::iterator), one inference per detector configuration.
+  /// The i-th element of certainties corresponds to the i-th track, the feature buffers are kept across calls.
+  template <typename TTracks>
+  void applyModelBatch(const TTracks& tracks, std::vector<float>& certainties)
+  {
+    certainties.assign(tracks.size(), 0.f);
+    for (uint8_t mask = 0; mask < NDetectorMasks; ++mask) {
+      mBatchRows[mask].clear();
+      mBatchValues[mask].clear();
+    }
+
+    size_t iTrack = 0;
+    for (const auto& track : tracks) {
+      const uint8_t mask = getDetectorMask(track);
+      mBatchRows[mask].push_back(iTrack++);
+      fillValues(track, mask, mBatchValues[mask]);
+    }
+
+    // rows with the same detectors have the NaNs in the same columns and can be run together
+    for (uint8_t mask = 0; mask < NDetectorMasks; ++mask) {
+      const auto& rows = mBatchRows[mask];
+      if (rows.empty()) {
+        continue;
+      }
+      mBatchOutput.resize(rows.size());
+      if (runModel(mBatchValues[mask], rows.size(), mBatchOutput.data())) {
+        for (size_t iRow = 0; iRow < rows.size(); ++iRow) {
+          certainties[rows[iRow]] = mBatchOutput[iRow];
+        }
+      }
+    }
+  }
+
+  template <typename TTracks>
+  void applyModelBatchBoolean(const TTracks& tracks, std::vector<bool>& accepted)
+  {
+    applyModelBatch(tracks, mBatchCertainties);
+    accepted.resize(mBatchCertainties.size());
+    for (size_t i = 0; i < mBatchCertainties.size(); ++i) {
+      accepted[i] = mBatchCertainties[i] >= mMinCertainty;
+    }
+  }
+
   int mPid{0};
   double mMinCertainty{0};
 
@@ -207,6 +250,26 @@ struct PidONNXModel {
         mScalingParams[param[0].GetString()] = std::make_pair(param[1].GetFloat(), param[2].GetFloat());
       }
     }
+
+    // resolve once the detector and the scaling of each column, instead of the string lookups per track
+    mColumnDetectors.clear();
+    mColumnScaling.clear();
+    for (const auto& columnLabel : mTrainColumns) {
+      uint8_t detector = 0;
+      if (columnLabel == "fTRDSignal" || columnLabel == "fTRDPattern") {
+        detector = UseTRD;
+      } else if (columnLabel == "fTOFSignal" || columnLabel == "fBeta") {
+        detector = UseTOF;
+      }
+      mColumnDetectors.push_back(detector);
+
+      auto scalingParamsEntry = mScalingParams.find(columnLabel);
+      if (scalingParamsEntry != mScalingParams.end()) {
+        mColumnScaling.emplace_back(scalingParamsEntry->second);
+      } else {
+        mColumnScaling.emplace_back(std::nullopt);
+      }
+    }
   }
 
   static float scale(float value, const std::pair<float, float>& scalingParams)
@@ -214,63 +277,63 @@ struct PidONNXModel {
     return (value - scalingParams.first) / scalingParams.second;
   }
 
-  std::vector<float> getValues(const typename T::iterator& track)
+  uint8_t getDetectorMask(const typename T::iterator& track) const
   {
-    std::vector<float> output;
-    output.reserve(mTrainColumns.size());
-
-    bool useTOF = !pidml::pidutils::tofMissing(track) && pidml::pidutils::inPLimit(track, mPLimits[kTPCTOF]);
-    bool useTRD = !pidml::pidutils::trdMissing(track) && pidml::pidutils::inPLimit(track, mPLimits[kTPCTOFTRD]);
+    uint8_t mask = 0;
+    if (!pidml::pidutils::tofMissing(track) && pidml::pidutils::inPLimit(track, mPLimits[kTPCTOF])) {
+      mask |= UseTOF;
+    }
+    if (!pidml::pidutils::trdMissing(track) && pidml::pidutils::inPLimit(track, mPLimits[kTPCTOFTRD])) {
+      mask |= UseTRD;
+    }
+    return mask;
+  }
 
+  /// Appends the (scaled) model input of the track to output, NaN for the columns of the detectors not in mask
+  void fillValues(const typename T::iterator& track, uint8_t mask, std::vector<float>& output) const
+  {
     for (uint32_t i = 0; i < mTrainColumns.size(); ++i) {
-      auto& columnLabel = mTrainColumns[i];
-
-      if (
-        ((columnLabel == "fTRDSignal" || columnLabel == "fTRDPattern") && !useTRD) ||
-        ((columnLabel == "fTOFSignal" || columnLabel == "fBeta") && !useTOF)) {
+      if ((mColumnDetectors[i] & mask) != mColumnDetectors[i]) {
         output.push_back(std::numeric_limits<float>::quiet_NaN());
         continue;
       }
 
-      std::optional<std::pair<float, float>> scalingParams = std::nullopt;
-
-      auto scalingParamsEntry = mScalingParams.find(columnLabel);
-      if (scalingParamsEntry != mScalingParams.end()) {
-        scalingParams = scalingParamsEntry->second;
-      }
-
       float value = mGetters[i](track);
-
-      if (scalingParams) {
-        value = scale(value, scalingParams.value());
+      if (mColumnScaling[i]) {
+        value = scale(value, mColumnScaling[i].value());
       }
-
       output.push_back(value);
     }
-
-    return output;
   }
 
   float getModelOutput(const typename T::iterator& track)
+  {
+    mValues.clear();
+    fillValues(track, getDetectorMask(track), mValues);
+
+    float certainty = 0.f;
+    runModel(mValues, 1, &certainty);
+    return certainty;
+  }
+
+  /// Runs the model on batchSize rows stored contiguously in inputTensorValues, writes one certainty per row to output
+  bool runModel(std::vector<float>& inputTensorValues, size_t batchSize, float* output)
   {
     // First rank of the expected model input is -1 which means that it is dynamic axis.
-    // Axis is exported as dynamic to make it possible to run model inference with the batch of
-    // tracks at once in the future (batch would need to have the same amount of quiet_NaNs in each row).
-    // For now we hardcode 1.
-    static constexpr int64_t BatchSize = 1;
-    auto inputShape = mInputShapes[0];
-    inputShape[0] = BatchSize;
-
-    std::vector<float> inputTensorValues = getValues(track);
-    std::vector<Ort::Value> inputTensors;
+    // The batch needs to have the same amount of quiet_NaNs in each row.
+    auto& inputShape = mBatchInputShape;
+    inputShape = mInputShapes[0];
+    inputShape[0] = static_cast<int64_t>(batchSize);
 
-    Ort::MemoryInfo memInfo = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
-    inputTensors.emplace_back(Ort::Value::CreateTensor<float>(memInfo, inputTensorValues.data(), inputTensorValues.size(), inputShape.data(), inputShape.size()));
+    if (!mMemInfo) {
+      mMemInfo = std::make_shared<Ort::MemoryInfo>(Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault));
+    }
+    std::vector<Ort::Value> inputTensors;
+    inputTensors.emplace_back(Ort::Value::CreateTensor<float>(*mMemInfo, inputTensorValues.data(), inputTensorValues.size(), inputShape.data(), inputShape.size()));
 
     // Double-check the dimensions of the input tensor
     assert(inputTensors[0].IsTensor() &&
            inputTensors[0].GetTensorTypeAndShapeInfo().GetShape() == inputShape);
-    LOG(debug) << "input tensor shape: " << printShape(inputTensors[0].GetTensorTypeAndShapeInfo().GetShape());
 
     try {
       Ort::RunOptions runOptions;
@@ -286,15 +349,15 @@ struct PidONNXModel {
       // Double-check the dimensions of the output tensors
       // The number of output tensors is equal to the number of output nodes specified in the Run() call
       assert(outputTensors.size() == mOutputNames.size() && outputTensors[0].IsTensor());
-      LOG(debug) << "output tensor shape: " << printShape(outputTensors[0].GetTensorTypeAndShapeInfo().GetShape());
+      assert(outputTensors[0].GetTensorTypeAndShapeInfo().GetElementCount() == batchSize);
 
-      const float* outputValue = outputTensors[0].GetTensorData<float>();
-      float certainty = *outputValue;
-      return certainty;
+      const float* outputValues = outputTensors[0].GetTensorData<float>();
+      std::copy(outputValues, outputValues + batchSize, output);
+      return true;
     } catch (const Ort::Exception& exception) {
       LOG(error) << "Error running model inference: " << exception.what();
     }
-    return false; // unreachable code
+    return false;
   }
 
   // Pretty prints a shape dimension vector
@@ -307,9 +370,24 @@ struct PidONNXModel {
     return ss.str();
   }
 
+  static constexpr uint8_t UseTOF = 0x1;
+  static constexpr uint8_t UseTRD = 0x2;
+  static constexpr uint8_t NDetectorMasks = 4;
+
   std::vector<std::string> mTrainColumns;
   std::vector<float (*)(const typename T::iterator&)> mGetters;
   std::map<std::string, std::pair<float, float>> mScalingParams;
+  std::vector<uint8_t> mColumnDetectors;                              // detector bits required by each column, 0 for the always available ones
+  std::vector<std::optional<std::pair<float, float>>> mColumnScaling; // scaling parameters of each column
+
+  // buffers reused across the calls
+  std::vector<float> mValues;
+  std::array<std::vector<float>, NDetectorMasks> mBatchValues;
+  std::array<std::vector<size_t>, NDetectorMasks> mBatchRows;
+  std::vector<float> mBatchOutput;
+  std::vector<float> mBatchCertainties;
+  std::vector<int64_t> mBatchInputShape;
+  std::shared_ptr<Ort::MemoryInfo> mMemInfo = nullptr;
 
   std::shared_ptr<Ort::Env> mEnv = nullptr;
   // No empty constructors for Session, we need a pointer
@@ -14,9 +14,13 @@
 #include "Framework/AnalysisTask.h"
 #include "Framework/AnalysisDataModel.h"
 #include "Framework/ASoAHelpers.h"
+#include "Common/Core/ProcessTimer.h"
 #include "Common/DataModel/TrackSelectionTables.h"
 #include "DataModel/DerivedExampleTable.h"
 
+#include <cstdint>
+#include <vector>
+
 using namespace o2;
 using namespace o2::framework;
 using namespace o2::framework::expressions;
@@ -32,6 +36,7 @@ struct DerivedBasicProvider {
   Configurable<float> maxDCA{"maxDCA", 0.1, "max DCA"};
   Configurable<float> etaWindow{"etaWindow", 0.8, "eta window"};
   Configurable<bool> skipUninterestingEvents{"skipUninterestingEvents", true, "skip collisions without particle of interest"};
+  Configurable<bool> timeProcessFunctions{"timeProcessFunctions", true, "measure the wall and CPU time spent in each version"};
 
   // This marks that this task produces a standard derived table
   Produces<aod::DrCollisions> outputCollisions;
@@ -44,6 +49,15 @@ struct DerivedBasicProvider {
   using myCompleteTracks = soa::Join<aod::Tracks, aod::TracksExtra, aod::TracksDCA>;
   using myFilteredTracks = soa::Filtered<myCompleteTracks>; // do not forget this!
 
+  // Scratch memory of the bulk version, kept across data frames
+  std::vector<uint8_t> isSelectedTrack;   // column mask of the selected tracks
+  std::vector<int> nSelectedTracks;       // number of selected tracks per collision
+  std::vector<int64_t> newCollisionIndex; // index of each collision in the derived table, -1 if not saved
+
+  // time spent in each version
+  enum ProcessFunction { kRowByRow = 0, kBulk };
+  o2::common::core::ProcessTimer timer;
+
   void init(InitContext const&)
   {
     // define axes you want to use
@@ -51,10 +65,15 @@ struct DerivedBasicProvider {
     const AxisSpec axisPt{nBinsPt, 0, 10, "p_{T}"};
     histos.add("eventCounter", "eventCounter", kTH1F, {axisCounter});
     histos.add("ptHistogram", "ptHistogram", kTH1F, {axisPt});
+    if (timeProcessFunctions) {
+      timer.init(histos, {"row-by-row", "bulk"});
+    }
   }
 
-  void process(aod::Collision const& collision, myFilteredTracks const& tracks)
+  // Row-by-row version: one process call per collision, the rows are written while the tracks are checked
+  void processRowByRow(aod::Collision const& collision, myFilteredTracks const& tracks)
   {
+    auto timerScope = timer.scope(kRowByRow);
     histos.fill(HIST("eventCounter"), 0.5);
     if (tracks.size() < 1 && skipUninterestingEvents)
       return;
@@ -74,6 +93,58 @@ struct DerivedBasicProvider {
       outputTracks(outputCollisions.lastIndex(), track.pt(), track.eta(), track.phi()); // all that I need for posterior analysis!
     }
   }
+  PROCESS_SWITCH(DerivedBasicProvider, processRowByRow, "Write the derived tables collision by collision", true);
+
+  // Bulk version: one process call per data frame with the same output.
+  // The selection is first evaluated on the whole track column into a mask, the output tables are then
+  // reserved with the number of selected rows and filled in a single pass without further checks
+  void processBulk(aod::Collisions const& collisions, myFilteredTracks const& tracks)
+  {
+    auto timerScope = timer.scope(kBulk);
+
+    // selection mask and number of selected tracks per collision
+    isSelectedTrack.resize(tracks.size());
+    nSelectedTracks.assign(collisions.size(), 0);
+    int64_t nTracks = 0;
+    int64_t iTrack = 0;
+    for (const auto& track : tracks) {
+      const bool isSelected = track.has_collision() && track.tpcNClsCrossedRows() >= minTPCNClsCrossedRows;
+      isSelectedTrack[iTrack++] = isSelected;
+      if (isSelected) {
+        nSelectedTracks[track.collisionId()]++;
+        nTracks++;
+      }
+    }
+
+    // collisions to save
+    newCollisionIndex.assign(collisions.size(), -1);
+    int64_t nCollisions = 0;
+    for (int64_t iColl = 0; iColl < collisions.size(); iColl++) {
+      if (nSelectedTracks[iColl] > 0 || !skipUninterestingEvents) {
+        newCollisionIndex[iColl] = nCollisions++;
+      }
+    }
+
+    // write the derived tables
+    outputCollisions.reserve(nCollisions);
+    outputTracks.reserve(nTracks);
+    for (const auto& collision : collisions) {
+      histos.fill(HIST("eventCounter"), 0.5);
+      if (newCollisionIndex[collision.globalIndex()] >= 0) {
+        outputCollisions(collision.posZ());
+      }
+    }
+    const int64_t firstIndex = outputCollisions.lastIndex() + 1 - nCollisions;
+    iTrack = 0;
+    for (const auto& track : tracks) {
+      if (!isSelectedTrack[iTrack++] || newCollisionIndex[track.collisionId()] < 0) {
+        continue;
+      }
+      histos.get<TH1>(HIST("ptHistogram"))->Fill(track.pt());
+      outputTracks(firstIndex + newCollisionIndex[track.collisionId()], track.pt(), track.eta(), track.phi());
+    }
+  }
+  PROCESS_SWITCH(DerivedBasicProvider, processBulk, "Write the derived tables of the whole data frame in bulk", false);
 };
 
 WorkflowSpec defineDataProcessing(ConfigContext const& cfgc)